@@ -1,6 +1,16 @@
 # Set build-directive (used in core to tell which buildtype we used)
 add_definitions(-D_BUILD_DIRECTIVE='"$(CONFIGURATION)"')
 
+if(SIMD_DISPATCH)
+  # target_clones needs clang 14 and the ifunc of ELF
+  if(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|amd64" AND NOT APPLE AND NOT CMAKE_CXX_COMPILER_VERSION VERSION_LESS 14)
+    add_definitions(-DMANGOS_SIMD_DISPATCH)
+    message(STATUS "Clang: AVX2 variants of the math kernels enabled")
+  else()
+    message(STATUS "Clang: SIMD_DISPATCH ignored, needs clang 14+ on x86-64 linux")
+  endif()
+endif()
+
 if(WARNINGS)
   set(WARNING_FLAGS "-W -Wall -Wextra -Winit-self -Wfatal-errors")
   set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${WARNING_FLAGS}")
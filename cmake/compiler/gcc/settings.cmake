@@ -10,6 +10,15 @@ endif()
 add_definitions(-DHAVE_SSE2)
 message(STATUS "GCC: SFMT enabled, SSE2 flags forced")
 
+if(SIMD_DISPATCH)
+  if(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|AMD64|amd64")
+    add_definitions(-DMANGOS_SIMD_DISPATCH)
+    message(STATUS "GCC: AVX2 variants of the math kernels enabled")
+  else()
+    message(STATUS "GCC: SIMD_DISPATCH ignored, no variants for ${CMAKE_SYSTEM_PROCESSOR}")
+  endif()
+endif()
+
 if(WARNINGS)
   set(WARNING_FLAGS "-W -Wall -Wextra -Winit-self -Winvalid-pch -Wfatal-errors")
   set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${WARNING_FLAGS}")
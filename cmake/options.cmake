@@ -12,7 +12,12 @@ option(BUILD_AHBOT          "Build Auction House Bot mod"           OFF)
 option(BUILD_METRICS        "Build Metrics, generate data for Grafana" OFF)
 option(BUILD_RECASTDEMOMOD  "Build map/vmap/mmap viewer"            OFF)
 option(BUILD_GIT_ID         "Build git_id"                          OFF)
+option(BUILD_LOADTEST       "Build load test client"                OFF)
+option(BUILD_BENCHMARKS     "Build micro-benchmarks"                OFF)
 option(BUILD_DOCS           "Build documentation with doxygen"      OFF)
+option(SIMD_DISPATCH        "Build AVX2 variants of the math kernels, picked at runtime" OFF)
+set(ALLOCATOR "default" CACHE STRING "Heap allocator of the servers: default, jemalloc or mimalloc")
+set_property(CACHE ALLOCATOR PROPERTY STRINGS default jemalloc mimalloc)
 
 # TODO: options that should be checked/created:
 #option(CLI                  "With CLI"                              ON)
@@ -39,7 +44,11 @@ message(STATUS
     BUILD_METRICS           Build Metrics, generate data for Grafana
     BUILD_RECASTDEMOMOD     Build map/vmap/mmap viewer
     BUILD_GIT_ID            Build git_id
+    BUILD_LOADTEST          Build loadtest, headless clients for benchmarking the server
+    BUILD_BENCHMARKS        Build benchmarks, micro-benchmarks of the game library (needs BUILD_GAME_SERVER)
     BUILD_DOCS              Build documentation with doxygen
+    SIMD_DISPATCH           Build AVX2 variants of the terrain, vmap and spline math kernels next to the generic ones, picked at runtime (x86-64, GCC or Clang 14+)
+    ALLOCATOR               Heap allocator linked into the servers: default (of the C library), jemalloc or mimalloc (installed library, unix only)
 
   To set an option simply type -D<OPTION>=<VALUE> after 'cmake <srcs>'.
   Also, you can specify the generator with -G. see 'cmake --help' for more details
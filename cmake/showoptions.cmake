@@ -91,6 +91,26 @@ else()
   message(STATUS "Build git_id          : No  (default)")
 endif()
 
+if(BUILD_LOADTEST)
+  message(STATUS "Build loadtest        : Yes")
+else()
+  message(STATUS "Build loadtest        : No  (default)")
+endif()
+
+if(BUILD_BENCHMARKS)
+  message(STATUS "Build benchmarks      : Yes")
+else()
+  message(STATUS "Build benchmarks      : No  (default)")
+endif()
+
+if(SIMD_DISPATCH)
+  message(STATUS "Build SIMD dispatch   : Yes")
+else()
+  message(STATUS "Build SIMD dispatch   : No  (default)")
+endif()
+
+message(STATUS "Allocator             : ${ALLOCATOR}")
+
 if(BUILD_DOCS)
   message(STATUS "Build documentation   : Yes")
 else()
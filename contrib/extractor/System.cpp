@@ -1,8 +1,15 @@
 #define _CRT_SECURE_NO_DEPRECATE
 
 #include <stdio.h>
+#include <algorithm>
+#include <atomic>
 #include <deque>
+#include <map>
+#include <mutex>
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 #include <cstdlib>
 
 #ifdef _WIN32
@@ -53,6 +60,7 @@ uint16* LiqType;
 char output_path[128] = ".";
 char input_path[128] = ".";
 uint32 maxAreaId = 0;
+uint32 maxLiqTypeId = 0;
 
 //**************************************************
 // Extractor options
@@ -78,6 +86,11 @@ float CONF_float_to_int16_limit = 2048.0f;   // Max accuracy = val/65536
 float CONF_flat_height_delta_limit = 0.005f; // If max - min less this value - surface is flat
 float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - liquid surface is flat
 
+// Threads converting the map tiles, 0 for one per core
+int   CONF_threads = 0;
+// Only convert the tiles whose source in the MPQ changed since the last extraction
+bool  CONF_incremental = false;
+
 // List MPQ for extract from
 static char const* CONF_mpq_list[] =
 {
@@ -125,6 +138,8 @@ void Usage(char* prg)
         "-o set output path\n"\
         "-e extract only MAP(1)/DBC(2)/Camera(4) - standard: all(7)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
+        "-t number of threads converting the map tiles, one per core by default\n"\
+        "-u only convert the map tiles changed since the last extraction (1), or all (0) by default\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"", prg, prg);
     exit(1);
 }
@@ -137,6 +152,8 @@ void HandleArgs(int argc, char* arg[])
         // o - output path
         // e - extract only MAP(1)/DBC(2) - standard both(3)
         // f - use float to int conversion
+        // t - map tile conversion threads
+        // u - incremental map extraction
         // h - limit minimum height
         if (arg[c][0] != '-')
             Usage(arg[0]);
@@ -161,6 +178,18 @@ void HandleArgs(int argc, char* arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                           // all ok
+                    CONF_threads = atoi(arg[(c++) + 1]);
+                else
+                    Usage(arg[0]);
+                break;
+            case 'u':
+                if (c + 1 < argc)                           // all ok
+                    CONF_incremental = atoi(arg[(c++) + 1]) != 0;
+                else
+                    Usage(arg[0]);
+                break;
             case 'e':
                 if (c + 1 < argc)                           // all ok
                 {
@@ -276,6 +305,8 @@ void ReadLiquidTypeTableDBC()
     for (uint32 x = 0; x < LiqType_count; ++x)
         LiqType[dbc.getRecord(x).getUInt(0)] = dbc.getRecord(x).getUInt(3);
 
+    maxLiqTypeId = LiqType_maxid;
+
     printf("Done! (%u LiqTypes loaded)\n", uint32(LiqType_count));
 }
 
@@ -299,20 +330,20 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, one per converting thread
+thread_local uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];
 
 bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32 build)
 {
@@ -864,11 +895,87 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     return true;
 }
 
+// hash of everything but the ADT itself that goes into a map file
+uint64 GetConvertParamsHash()
+{
+    uint64 hash = HashBytes(MAP_VERSION_MAGIC, strlen(MAP_VERSION_MAGIC));
+    hash = HashBytes(areas, (maxAreaId + 1) * sizeof(uint16), hash);
+    hash = HashBytes(LiqType, (maxLiqTypeId + 1) * sizeof(uint16), hash);
+    hash = HashBytes(&CONF_allow_height_limit, sizeof(CONF_allow_height_limit), hash);
+    hash = HashBytes(&CONF_use_minHeight, sizeof(CONF_use_minHeight), hash);
+    hash = HashBytes(&CONF_allow_float_to_int, sizeof(CONF_allow_float_to_int), hash);
+    hash = HashBytes(&CONF_float_to_int8_limit, sizeof(CONF_float_to_int8_limit), hash);
+    hash = HashBytes(&CONF_float_to_int16_limit, sizeof(CONF_float_to_int16_limit), hash);
+    hash = HashBytes(&CONF_flat_height_delta_limit, sizeof(CONF_flat_height_delta_limit), hash);
+    return HashBytes(&CONF_flat_liquid_delta_limit, sizeof(CONF_flat_liquid_delta_limit), hash);
+}
+
+typedef std::map<std::string, uint64> TileSourceMap;
+
+// maps/sources.txt, the source hash of every map file of the last extraction
+void LoadTileSources(TileSourceMap& sources)
+{
+    std::string filename = std::string(output_path) + "/maps/sources.txt";
+    FILE* input = fopen(filename.c_str(), "r");
+    if (!input)
+        return;
+
+    char tile[16];
+    unsigned long long hash;
+    while (fscanf(input, "%15s %llx", tile, &hash) == 2)
+        sources[tile] = hash;
+    fclose(input);
+}
+
+void SaveTileSources(TileSourceMap const& sources)
+{
+    std::string filename = std::string(output_path) + "/maps/sources.txt";
+    FILE* output = fopen(filename.c_str(), "w");
+    if (!output)
+    {
+        printf("Can't create the output file '%s'\n", filename.c_str());
+        return;
+    }
+
+    for (TileSourceMap::const_iterator itr = sources.begin(); itr != sources.end(); ++itr)
+        fprintf(output, "%s %016llx\n", itr->first.c_str(), (unsigned long long)itr->second);
+    fclose(output);
+}
+
+// an unchanged tile of a new client build only needs the build in its header
+bool UpdateMapBuild(char const* filename, uint32 build)
+{
+    FILE* file = fopen(filename, "r+b");
+    if (!file)
+        return false;
+
+    GridMapFileHeader header;
+    bool success = fread(&header, sizeof(header), 1, file) == 1 && header.versionMagic == *(uint32 const*)MAP_VERSION_MAGIC;
+    if (success && header.buildMagic != build)
+    {
+        header.buildMagic = build;
+        success = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    fclose(file);
+    return success;
+}
+
+struct TileJob
+{
+    std::string mpqFilename;
+    std::string outputFilename;
+    std::string tile;
+    uint32 x, y;
+    uint64 sourceHash;
+    bool converted;
+};
+
 void ExtractMapsFromMpq(uint32 build)
 {
     char mpq_filename[1024];
     char output_filename[1024];
     char mpq_map_name[1024];
+    char tile[16];
 
     printf("Extracting maps...\n");
 
@@ -881,10 +988,15 @@ void ExtractMapsFromMpq(uint32 build)
     path += "/maps/";
     CreateDir(path);
 
+    TileSourceMap lastSources;
+    if (CONF_incremental)
+        LoadTileSources(lastSources);
+    uint64 const paramsHash = GetConvertParamsHash();
+
     printf("Convert map files\n");
+    std::vector<TileJob> jobs;
     for (uint32 z = 0; z < map_count; ++z)
     {
-        printf("Extract %s (%d/%d)                  \n", map_ids[z].name, z + 1, map_count);
         // Loadup map grid data
         sprintf(mpq_map_name, "World\\Maps\\%s\\%s.wdt", map_ids[z].name, map_ids[z].name);
         WDT_file wdt;
@@ -900,14 +1012,70 @@ void ExtractMapsFromMpq(uint32 build)
             {
                 if (!wdt.main->adt_list[y][x].exist)
                     continue;
+
                 sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
                 sprintf(output_filename, "%s/maps/%03u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, y, x, build);
+                sprintf(tile, "%03u%02u%02u", map_ids[z].id, y, x);
+
+                jobs.push_back(TileJob());
+                TileJob& job = jobs.back();
+                job.mpqFilename = mpq_filename;
+                job.outputFilename = output_filename;
+                job.tile = tile;
+                job.x = x;
+                job.y = y;
+                job.sourceHash = GetFileSourceHash(mpq_filename) ^ paramsHash;
+                job.converted = false;
             }
-            // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
         }
     }
+
+    uint32 threads = CONF_threads > 0 ? CONF_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    printf("Converting %u tiles on %u threads\n", uint32(jobs.size()), threads);
+
+    std::atomic<size_t> nextJob(0);
+    std::atomic<uint32> skipped(0);
+    std::mutex progressLock;
+    uint32 done = 0;
+    auto worker = [&]()
+    {
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            TileJob& job = jobs[i];
+            TileSourceMap::const_iterator last = lastSources.find(job.tile);
+            if (last != lastSources.end() && last->second == job.sourceHash && UpdateMapBuild(job.outputFilename.c_str(), build))
+            {
+                job.converted = true;
+                ++skipped;
+            }
+            else
+                job.converted = ConvertADT(&job.mpqFilename[0], &job.outputFilename[0], job.y, job.x, build);
+
+            // draw progress bar
+            std::lock_guard<std::mutex> guard(progressLock);
+            ++done;
+            if (done % 64 == 0 || done == jobs.size())
+                printf("Processing........................%u%%\r", uint32(100 * done / jobs.size()));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32 i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& thread : workers)
+        thread.join();
+
+    if (CONF_incremental)
+        printf("\n%u unchanged tiles skipped\n", uint32(skipped));
+
+    // tiles that failed are converted again next time
+    TileSourceMap sources;
+    for (std::vector<TileJob>::const_iterator itr = jobs.begin(); itr != jobs.end(); ++itr)
+        if (itr->converted)
+            sources[itr->tile] = itr->sourceHash;
+    SaveTileSources(sources);
+
     delete [] areas;
     delete [] map_ids;
 }
@@ -1,10 +1,14 @@
 #include "mpq_libmpq.h"
 #include <deque>
 #include <cstdio>
+#include <mutex>
 
 ArchiveSet gOpenArchives;
 
-MPQArchive::MPQArchive(const char* filename)
+// libmpq reads an archive through a single file handle, the map tiles are converted on several threads
+static std::mutex gArchiveLock;
+
+MPQArchive::MPQArchive(const char* filename) : name(filename)
 {
     int result = libmpq__archive_open(&mpq_a, filename, -1);
     printf("Opening %s\n", filename);
@@ -48,6 +52,7 @@ MPQFile::MPQFile(const char* filename):
     pointer(0),
     size(0)
 {
+    std::lock_guard<std::mutex> guard(gArchiveLock);
     for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
     {
         mpq_archive* mpq_a = (*i)->mpq_a;
@@ -77,6 +82,33 @@ MPQFile::MPQFile(const char* filename):
     buffer = 0;
 }
 
+uint64 GetFileSourceHash(const char* filename)
+{
+    std::lock_guard<std::mutex> guard(gArchiveLock);
+    for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
+    {
+        mpq_archive* mpq_a = (*i)->mpq_a;
+
+        uint32 filenum;
+        if (libmpq__file_number(mpq_a, filename, &filenum)) continue;
+        libmpq__off_t offset, packedSize, unpackedSize;
+        libmpq__file_offset(mpq_a, filenum, &offset);
+        libmpq__file_packed_size(mpq_a, filenum, &packedSize);
+        libmpq__file_unpacked_size(mpq_a, filenum, &unpackedSize);
+
+        // the archive file name only, moving the client keeps the hashes
+        std::string const& name = (*i)->name;
+        size_t nameStart = name.find_last_of("/\\");
+        nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+
+        uint64 hash = HashBytes(name.c_str() + nameStart, name.size() - nameStart);
+        hash = HashBytes(&offset, sizeof(offset), hash);
+        hash = HashBytes(&packedSize, sizeof(packedSize), hash);
+        return HashBytes(&unpackedSize, sizeof(unpackedSize), hash);
+    }
+    return 0;
+}
+
 size_t MPQFile::read(void* dest, size_t bytes)
 {
     if (eof) return 0;
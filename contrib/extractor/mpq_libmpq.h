@@ -11,6 +11,7 @@
 #include <vector>
 #include <iostream>
 #include <deque>
+#include <string>
 
 using namespace std;
 
@@ -19,6 +20,7 @@ class MPQArchive
 
     public:
         mpq_archive_s* mpq_a;
+        std::string name;
 
         MPQArchive(const char* filename);
         void close();
@@ -79,6 +81,18 @@ class MPQFile
         void close();
 };
 
+// identifies the archive entry the file is read from, it only changes when a patch replaces the file. 0 when not found
+uint64 GetFileSourceHash(const char* filename);
+
+// FNV-1a
+inline uint64 HashBytes(const void* data, size_t size, uint64 hash = 14695981039346656037ULL)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
 inline void flipcc(char* fcc)
 {
     char t;
@@ -25,8 +25,16 @@
 #include "DetourNavMeshBuilder.h"
 #include "DetourCommon.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
 
 using namespace VMAP;
 
@@ -82,11 +90,13 @@ void from_json(const json& j, rcConfig& config)
 namespace MMAP
 {
     MapBuilder::MapBuilder(const char* configInputPath, bool skipLiquid, bool skipContinents, bool skipJunkMaps,
-                           bool skipBattlegrounds, bool debug, const char* offMeshFilePath) :
+                           bool skipBattlegrounds, bool debug, const char* offMeshFilePath, int threads, bool compressTiles) :
         m_debug(debug),
         m_skipContinents(skipContinents),
         m_skipJunkMaps(skipJunkMaps),
         m_skipBattlegrounds(skipBattlegrounds),
+        m_threads(threads),
+        m_compressTiles(compressTiles),
         m_offMeshFilePath(offMeshFilePath)
     {
         std::ifstream jsonConfig(configInputPath);
@@ -192,6 +202,17 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::buildAllMaps()
     {
+        if (m_threads > 1)
+        {
+            std::vector<uint32> mapIds;
+            for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
+                if (!shouldSkipMap((*it).first))
+                    mapIds.push_back((*it).first);
+
+            buildMapsThreaded(mapIds);
+            return;
+        }
+
         for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
         {
             uint32 mapID = (*it).first;
@@ -393,14 +414,11 @@ namespace MMAP
 
         printf("* Writing to file \"%s\" [size=%u]\n", fileName, navDataSize);
 
-        // write header
+        // write header and data
         MmapTileHeader header;
         header.usesLiquids = false;
         header.size = uint32(navDataSize);
-        fwrite(&header, sizeof(MmapTileHeader), 1, file);
-
-        // write data
-        fwrite(navData, sizeof(unsigned char), navDataSize, file);
+        writeTile(file, header, navData);
         fclose(file);
         if (m_debug)
         {
@@ -543,10 +561,8 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
+    std::set<uint32>* MapBuilder::getMapTiles(uint32 mapID)
     {
-        printf("Building map %03u:                                    \n", mapID);
-
         std::set<uint32>* tiles = getTileList(mapID);
 
         // make sure we process maps which don't have tiles
@@ -562,6 +578,21 @@ namespace MMAP
                     tiles->insert(StaticMapTree::packTileID(i, j));
         }
 
+        return tiles;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildMap(uint32 mapID)
+    {
+        if (m_threads > 1)
+        {
+            buildMapsThreaded(std::vector<uint32>(1, mapID));
+            return;
+        }
+
+        printf("Building map %03u:                                    \n", mapID);
+
+        std::set<uint32>* tiles = getMapTiles(mapID);
         if (!tiles->size())
             return;
 
@@ -597,6 +628,124 @@ namespace MMAP
         printf("[Map %03i] Complete!                             \n\n", mapID);
     }
 
+    /**************************************************************************/
+    uint64 MapBuilder::getTileCost(uint32 mapID, uint32 tileX, uint32 tileY)
+    {
+        // the size of the terrain and model data of the tile, a fair guess of its build time
+        char fileName[255];
+        uint64 cost = 0;
+
+        sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY, tileX);
+        if (FILE* file = fopen(fileName, "rb"))
+        {
+            fseek(file, 0, SEEK_END);
+            cost += ftell(file);
+            fclose(file);
+        }
+
+        sprintf(fileName, "vmaps/%03u_%02u_%02u.vmtile", mapID, tileX, tileY);
+        if (FILE* file = fopen(fileName, "rb"))
+        {
+            fseek(file, 0, SEEK_END);
+            cost += ftell(file);
+            fclose(file);
+        }
+
+        return cost;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildMapsThreaded(std::vector<uint32> const& mapIds)
+    {
+        struct TileJob
+        {
+            uint32 mapID;
+            uint32 tileX;
+            uint32 tileY;
+            uint64 cost;
+        };
+
+        std::vector<TileJob> jobs;
+        std::map<uint32, dtNavMeshParams> navMeshParams;
+
+        for (uint32 mapID : mapIds)
+        {
+            std::set<uint32>* tiles = getMapTiles(mapID);
+            if (!tiles->size())
+                continue;
+
+            // the .mmap file is written here, every worker then gets its own navmesh with the same params
+            dtNavMesh* navMesh = nullptr;
+            buildNavMesh(mapID, navMesh);
+            if (!navMesh)
+            {
+                printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
+                continue;
+            }
+
+            navMeshParams[mapID] = *navMesh->getParams();
+            dtFreeNavMesh(navMesh);
+
+            for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
+            {
+                uint32 tileX, tileY;
+                StaticMapTree::unpackTileID((*it), tileX, tileY);
+
+                if (shouldSkipTile(mapID, tileX, tileY))
+                    continue;
+
+                jobs.push_back({ mapID, tileX, tileY, getTileCost(mapID, tileX, tileY) });
+            }
+        }
+
+        // largest tiles first, so that no big tile is left alone at the end
+        std::stable_sort(jobs.begin(), jobs.end(), [](TileJob const& a, TileJob const& b) { return a.cost > b.cost; });
+
+        printf("Building %u tiles of %u maps with %i threads\n", uint32(jobs.size()), uint32(navMeshParams.size()), m_threads);
+
+        std::atomic<uint32> nextJob(0);
+        std::atomic<uint32> doneJobs(0);
+        std::mutex printLock;
+        auto const startTime = std::chrono::steady_clock::now();
+
+        auto worker = [&]()
+        {
+            dtNavMesh* navMesh = nullptr;
+            uint32 navMeshMap = 0;
+
+            for (uint32 i = nextJob++; i < jobs.size(); i = nextJob++)
+            {
+                TileJob const& job = jobs[i];
+                if (!navMesh || navMeshMap != job.mapID)
+                {
+                    dtFreeNavMesh(navMesh);
+                    navMesh = dtAllocNavMesh();
+                    navMesh->init(&navMeshParams.at(job.mapID));
+                    navMeshMap = job.mapID;
+                }
+
+                auto const tileStart = std::chrono::steady_clock::now();
+                buildTile(job.mapID, job.tileX, job.tileY, navMesh, i + 1, uint32(jobs.size()));
+                auto const tileTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tileStart).count();
+
+                std::lock_guard<std::mutex> guard(printLock);
+                printf("[Map %03i] Tile [%02u,%02u] built in %u ms (%u / %u done)          \n",
+                       job.mapID, job.tileX, job.tileY, uint32(tileTime), ++doneJobs, uint32(jobs.size()));
+            }
+
+            dtFreeNavMesh(navMesh);
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < m_threads; ++i)
+            workers.emplace_back(worker);
+        for (std::thread& thread : workers)
+            thread.join();
+
+        auto const totalTime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count();
+        printf("Built %u tiles in %u s                                    \n\n", uint32(jobs.size()), uint32(totalTime));
+    }
+
     /**************************************************************************/
     void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount)
     {
@@ -690,6 +839,8 @@ namespace MMAP
         if (!navMesh->init(&navMeshParams))
         {
             printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
+            dtFreeNavMesh(navMesh);
+            navMesh = nullptr;
             return;
         }
 
@@ -700,6 +851,7 @@ namespace MMAP
         if (!file)
         {
             dtFreeNavMesh(navMesh);
+            navMesh = nullptr;
             char message[1024];
             sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
             perror(message);
@@ -938,14 +1090,11 @@ namespace MMAP
 
             printf("%s Writing to file...                                 \r", tileString);
 
-            // write header
+            // write header and data
             MmapTileHeader header;
             header.size = uint32(navDataSize);
             header.usesLiquids = m_terrainBuilder->usesLiquids() ? 1 : 0;
-            fwrite(&header, sizeof(MmapTileHeader), 1, file);
-
-            // write data
-            fwrite(navData, sizeof(unsigned char), navDataSize, file);
+            writeTile(file, header, navData);
             fclose(file);
 
             // now that tile is written to disk, we can unload it
@@ -1172,6 +1321,32 @@ namespace MMAP
         }
     }
 
+    /**************************************************************************/
+    void MapBuilder::writeTile(FILE* file, MmapTileHeader& header, unsigned char const* navData)
+    {
+        if (m_compressTiles)
+        {
+            // the header keeps the inflated size, the server inflates straight into the tile buffer of that size
+            uLongf compressedSize = compressBound(header.size);
+            std::vector<unsigned char> compressed(compressedSize);
+            if (compress2(&compressed[0], &compressedSize, navData, header.size, Z_BEST_COMPRESSION) == Z_OK)
+            {
+                uint32 size = uint32(compressedSize);
+                header.mmapMagic = MMAP_ZLIB_MAGIC;
+                fwrite(&header, sizeof(MmapTileHeader), 1, file);
+                fwrite(&size, sizeof(uint32), 1, file);
+                fwrite(&compressed[0], sizeof(unsigned char), size, file);
+                return;
+            }
+
+            printf("Failed to compress tile data, writing it uncompressed\n");
+        }
+
+        header.mmapMagic = MMAP_MAGIC;
+        fwrite(&header, sizeof(MmapTileHeader), 1, file);
+        fwrite(navData, sizeof(unsigned char), header.size, file);
+    }
+
     /**************************************************************************/
     bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY)
     {
@@ -1187,7 +1362,7 @@ namespace MMAP
         if (count != 1)
             return false;
 
-        if (header.mmapMagic != MMAP_MAGIC || header.dtVersion != uint32(DT_NAVMESH_VERSION))
+        if ((header.mmapMagic != MMAP_MAGIC && header.mmapMagic != MMAP_ZLIB_MAGIC) || header.dtVersion != uint32(DT_NAVMESH_VERSION))
             return false;
 
         if (header.mmapVersion != MMAP_VERSION)
@@ -81,7 +81,9 @@ namespace MMAP
                        bool skipJunkMaps        = true,
                        bool skipBattlegrounds   = false,
                        bool debug               = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       int threads              = 1,
+                       bool compressTiles       = false);
 
             ~MapBuilder();
 
@@ -102,6 +104,11 @@ namespace MMAP
             // detect maps and tiles
             void discoverTiles();
             std::set<uint32>* getTileList(uint32 mapID);
+            std::set<uint32>* getMapTiles(uint32 mapID);
+
+            // builds the tiles of all given maps on m_threads workers, largest tiles first
+            void buildMapsThreaded(std::vector<uint32> const& mapIds);
+            uint64 getTileCost(uint32 mapID, uint32 tileX, uint32 tileY);
 
             void buildNavMesh(uint32 mapID, dtNavMesh*& navMesh);
 
@@ -118,6 +125,9 @@ namespace MMAP
             bool isTransportMap(uint32 mapID);
             bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
 
+            // writes the header and the tile data, zlib compressed with m_compressTiles
+            void writeTile(FILE* file, MmapTileHeader& header, unsigned char const* navData);
+
             json getDefaultConfig();
             json getMapIdConfig(uint32 mapId);
             json getTileConfig(uint32 mapId, uint32 tileX, uint32 tileY);
@@ -131,6 +141,8 @@ namespace MMAP
             bool m_skipContinents;
             bool m_skipJunkMaps;
             bool m_skipBattlegrounds;
+            int m_threads;
+            bool m_compressTiles;
 
             json m_config;
 
@@ -46,6 +46,9 @@ namespace VMAP
     // declared in src/shared/vmap/WorldModel.h
     void WorldModel::getGroupModels(vector<GroupModel>& outGroupModels)
     {
+        // the models acquired through VMapManager2 read their groups lazily
+        for (uint32 i = 0; i < groupModels.size(); ++i)
+            getGroupModel(i);
         outGroupModels = groupModels;
     }
 
@@ -73,6 +73,8 @@ void printUsage()
     printf("--offMeshInput [file.*] : Path to file containing off mesh connections data.\n\n");
     printf("--configInputPath [file.*] : Path to json configuration file.\n\n");
     printf("--onlyGO : builds only gameobject models for transports\n\n");
+    printf("--threads [#] : Build the tiles on # threads, largest tiles first.\n\n");
+    printf("--compressTiles : Write the tiles zlib compressed, the server loads both kinds.\n\n");
     printf("Example:\nmovemapgen (generate all mmap with default arg\n"
            "movemapgen 0 (generate map 0)\n"
            "movemapgen 0 --tile 34,46 (builds only tile 34,46 of map 0)\n\n");
@@ -91,7 +93,9 @@ bool handleArgs(int argc, char** argv,
                 bool& silent,
                 bool& buildOnlyGameobjectModels,
                 char*& offMeshInputPath,
-                char*& configInputPath)
+                char*& configInputPath,
+                int& threads,
+                bool& compressTiles)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -147,6 +151,10 @@ bool handleArgs(int argc, char** argv,
         {
             buildOnlyGameobjectModels = true;
         }
+        else if (strcmp(argv[i], "--compressTiles") == 0)
+        {
+            compressTiles = true;
+        }
         else if (strcmp(argv[i], "--offMeshInput") == 0)
         {
             param = argv[++i];
@@ -163,6 +171,19 @@ bool handleArgs(int argc, char** argv,
 
             configInputPath = param;
         }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+                return false;
+
+            threads = atoi(param);
+            if (threads < 1)
+            {
+                printf("invalid thread count.\n");
+                return false;
+            }
+        }
         else if ((strcmp(argv[i], "-?") == 0) || (strcmp(argv[i], "/?") == 0) || (strcmp(argv[i], "-h") == 0))
         {
             printUsage();
@@ -203,13 +224,15 @@ int main(int argc, char** argv)
     bool debug = false;
     bool silent = false;
     bool buildOnlyGameobjectModels = false;
+    int threads = 1;
+    bool compressTiles = false;
 
     char* offMeshInputPath = "offmesh.txt";
     char* configInputPath = "config.json";
 
     bool validParam = handleArgs(argc, argv, mapId, tileX, tileY, skipLiquid,
                                  skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debug, silent, buildOnlyGameobjectModels, offMeshInputPath, configInputPath);
+                                 debug, silent, buildOnlyGameobjectModels, offMeshInputPath, configInputPath, threads, compressTiles);
 
     if (!validParam)
         return silent ? -1 : finish("You have specified invalid parameters (use -? for more help)", -1);
@@ -229,7 +252,7 @@ int main(int argc, char** argv)
     if (!checkDirectories(debug))
         return silent ? -3 : finish("Press any key to close...", -3);
 
-    MapBuilder builder(configInputPath, skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds, debug, offMeshInputPath);
+    MapBuilder builder(configInputPath, skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds, debug, offMeshInputPath, threads, compressTiles);
 
     if (buildOnlyGameobjectModels)
         builder.buildTransports();
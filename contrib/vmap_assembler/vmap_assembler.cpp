@@ -16,26 +16,30 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cstdlib>
 #include <string>
 #include <iostream>
+#include <thread>
 
 #include "TileAssembler.h"
 
 //=======================================================
 int main(int argc, char* argv[])
 {
-    if (argc != 3)
+    if (argc != 3 && argc != 4)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
+        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [threads]" << std::endl;
         return 1;
     }
 
     std::string src = argv[1];
     std::string dest = argv[2];
+    unsigned int threads = argc == 4 ? atoi(argv[3]) : std::thread::hardware_concurrency();
 
     std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
 
     VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    ta->setThreadCount(threads);
 
     if (!ta->convertWorld2())
     {
@@ -1,9 +1,13 @@
 #include "mpq_libmpq04.h"
 #include <deque>
 #include <cstdio>
+#include <mutex>
 
 ArchiveSet gOpenArchives;
 
+// libmpq reads an archive through a single file handle, the models are extracted on several threads
+static std::mutex gArchiveLock;
+
 MPQArchive::MPQArchive(const char* filename)
 {
     int result = libmpq__archive_open(&mpq_a, filename, -1);
@@ -48,6 +52,7 @@ MPQFile::MPQFile(const char* filename):
     pointer(0),
     size(0)
 {
+    std::lock_guard<std::mutex> guard(gArchiveLock);
     for (ArchiveSet::iterator i = gOpenArchives.begin(); i != gOpenArchives.end(); ++i)
     {
         mpq_archive* mpq_a = (*i)->mpq_a;
@@ -17,10 +17,15 @@
  */
 
 #define _CRT_SECURE_NO_DEPRECATE
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <iostream>
 #include <vector>
 #include <list>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <errno.h>
 
 #ifdef _WIN32
@@ -70,7 +75,9 @@ char output_path[128] = ".";
 char input_path[1024] = ".";
 bool hasInputPathParam = false;
 bool preciseVectorData = false;
+unsigned int threadCount = 1;
 std::unordered_map<std::string, WMODoodadData> WmoDoodads;
+std::mutex WmoDoodadsLock;
 
 // Constants
 
@@ -130,22 +137,46 @@ void ReadLiquidTypeTableDBC()
 
 bool ExtractWmo()
 {
-    bool success = true;
-
-    //const char* ParsArchiveNames[] = {"patch-2.MPQ", "patch.MPQ", "common.MPQ", "expansion.MPQ"};
+    // the first archive holding a file wins, as it is the one read by MPQFile
+    std::vector<std::string> wmoNames;
+    std::set<std::string> plainNames;
 
-    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end() && success; ++ar_itr)
+    for (ArchiveSet::const_iterator ar_itr = gOpenArchives.begin(); ar_itr != gOpenArchives.end(); ++ar_itr)
     {
         vector<string> filelist;
 
         (*ar_itr)->GetFileListTo(filelist);
-        for (vector<string>::iterator fname = filelist.begin(); fname != filelist.end() && success; ++fname)
+        for (vector<string>::iterator fname = filelist.begin(); fname != filelist.end(); ++fname)
         {
-            if (fname->find(".wmo") != string::npos)
-                success = ExtractSingleWmo(*fname);
+            if (fname->find(".wmo") == string::npos)
+                continue;
+
+            std::string name = *fname;
+            char* plain_name = GetPlainName(&name[0]);
+            fixnamen(plain_name, strlen(plain_name));
+            fixname2(plain_name, strlen(plain_name));
+            if (plainNames.insert(plain_name).second)
+                wmoNames.push_back(*fname);
         }
     }
 
+    // every wmo goes to its own file, so they are extracted in any order
+    std::atomic<size_t> nextWmo(0);
+    std::atomic<bool> success(true);
+    auto worker = [&]()
+    {
+        for (size_t i = nextWmo++; i < wmoNames.size() && success; i = nextWmo++)
+            if (!ExtractSingleWmo(wmoNames[i]))
+                success = false;
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threadCount; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (std::thread& thread : workers)
+        thread.join();
+
     if (success)
         printf("\nExtract wmo complete (No (fatal) errors)\n");
 
@@ -198,7 +229,12 @@ bool ExtractSingleWmo(std::string& fname)
         return false;
     }
     froot.ConvertToVMAPRootWmo(output);
-    WMODoodadData& doodads = WmoDoodads[plain_name];
+    WMODoodadData* doodadData;
+    {
+        std::lock_guard<std::mutex> guard(WmoDoodadsLock);
+        doodadData = &WmoDoodads[plain_name];
+    }
+    WMODoodadData& doodads = *doodadData;
     std::swap(doodads, froot.DoodadData);
     int Wmo_nVertices = 0;
     uint32 RealNbOfGroups = froot.nGroups;
@@ -419,6 +455,7 @@ bool processArgv(int argc, char** argv)
     bool result = true;
     hasInputPathParam = false;
     preciseVectorData = false;
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
 
     for (int i = 1; i < argc; ++i)
     {
@@ -449,6 +486,18 @@ bool processArgv(int argc, char** argv)
         {
             preciseVectorData = true;
         }
+        else if (strcmp("-t", argv[i]) == 0)
+        {
+            if ((i + 1) < argc && atoi(argv[i + 1]) > 0)
+            {
+                threadCount = atoi(argv[i + 1]);
+                ++i;
+            }
+            else
+            {
+                result = false;
+            }
+        }
         else
         {
             result = false;
@@ -458,10 +507,11 @@ bool processArgv(int argc, char** argv)
     if (!result)
     {
         printf("Extract for %s.\n", szRawVMAPMagic);
-        printf("%s [-?][-s][-l][-d <path>]\n", argv[0]);
+        printf("%s [-?][-s][-l][-d <path>][-t <threads>]\n", argv[0]);
         printf("   -s : (default) small size (data size optimization), ~500MB less vmap data.\n");
         printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
         printf("   -d <path>: Path to the vector data source folder.\n");
+        printf("   -t <threads>: Number of threads extracting the wmo files, by default one per core.\n");
         printf("   -? : This message.\n");
     }
     return result;
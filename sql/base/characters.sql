@@ -21,7 +21,7 @@
 
 DROP TABLE IF EXISTS `character_db_version`;
 CREATE TABLE `character_db_version` (
-  `required_14030_01_characters_item_instance_duration_default` bit(1) DEFAULT NULL
+  `required_14035_01_characters_calendar_archive` bit(1) DEFAULT NULL
 ) ENGINE=MyISAM DEFAULT CHARSET=utf8 ROW_FORMAT=DYNAMIC COMMENT='Last applied sql update to DB';
 
 --
@@ -237,7 +237,8 @@ CREATE TABLE `calendar_events` (
   `eventTime` int(10) unsigned NOT NULL DEFAULT '0',
   `title` varchar(128) NOT NULL DEFAULT '',
   `description` varchar(1024) NOT NULL DEFAULT '',
-  PRIMARY KEY (`eventId`)
+  PRIMARY KEY (`eventId`),
+  KEY `idx_eventTime` (`eventTime`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
 --
@@ -262,7 +263,8 @@ CREATE TABLE `calendar_invites` (
   `status` tinyint(10) unsigned NOT NULL DEFAULT '0',
   `lastUpdateTime` int(10) unsigned NOT NULL DEFAULT '0',
   `rank` tinyint(10) unsigned NOT NULL DEFAULT '0',
-  PRIMARY KEY (`inviteId`)
+  PRIMARY KEY (`inviteId`),
+  KEY `idx_eventId` (`eventId`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8;
 
 --
@@ -274,6 +276,59 @@ LOCK TABLES `calendar_invites` WRITE;
 /*!40000 ALTER TABLE `calendar_invites` ENABLE KEYS */;
 UNLOCK TABLES;
 
+--
+-- Table structure for table `calendar_events_archive`
+--
+
+DROP TABLE IF EXISTS `calendar_events_archive`;
+CREATE TABLE `calendar_events_archive` (
+  `eventId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `creatorGuid` int(10) unsigned NOT NULL DEFAULT '0',
+  `guildId` int(10) unsigned NOT NULL DEFAULT '0',
+  `type` tinyint(3) unsigned NOT NULL DEFAULT '4',
+  `flags` int(10) unsigned NOT NULL DEFAULT '0',
+  `dungeonId` int(10) NOT NULL DEFAULT '-1',
+  `eventTime` int(10) unsigned NOT NULL DEFAULT '0',
+  `title` varchar(128) NOT NULL DEFAULT '',
+  `description` varchar(1024) NOT NULL DEFAULT '',
+  PRIMARY KEY (`eventId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COMMENT='Calendar events older than Calendar.KeepDays';
+
+--
+-- Dumping data for table `calendar_events_archive`
+--
+
+LOCK TABLES `calendar_events_archive` WRITE;
+/*!40000 ALTER TABLE `calendar_events_archive` DISABLE KEYS */;
+/*!40000 ALTER TABLE `calendar_events_archive` ENABLE KEYS */;
+UNLOCK TABLES;
+
+--
+-- Table structure for table `calendar_invites_archive`
+--
+
+DROP TABLE IF EXISTS `calendar_invites_archive`;
+CREATE TABLE `calendar_invites_archive` (
+  `inviteId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `eventId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `inviteeGuid` int(10) unsigned NOT NULL DEFAULT '0',
+  `senderGuid` int(3) unsigned NOT NULL DEFAULT '0',
+  `status` tinyint(10) unsigned NOT NULL DEFAULT '0',
+  `lastUpdateTime` int(10) unsigned NOT NULL DEFAULT '0',
+  `rank` tinyint(10) unsigned NOT NULL DEFAULT '0',
+  PRIMARY KEY (`inviteId`),
+  KEY `idx_eventId` (`eventId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COMMENT='Invites of the archived calendar events';
+
+--
+-- Dumping data for table `calendar_invites_archive`
+--
+
+LOCK TABLES `calendar_invites_archive` WRITE;
+/*!40000 ALTER TABLE `calendar_invites_archive` DISABLE KEYS */;
+/*!40000 ALTER TABLE `calendar_invites_archive` ENABLE KEYS */;
+UNLOCK TABLES;
+
 --
 -- Table structure for table `character_account_data`
 --
@@ -0,0 +1,31 @@
+ALTER TABLE character_db_version CHANGE COLUMN required_14030_01_characters_item_instance_duration_default required_14035_01_characters_calendar_archive bit;
+
+ALTER TABLE calendar_events ADD KEY `idx_eventTime` (`eventTime`);
+ALTER TABLE calendar_invites ADD KEY `idx_eventId` (`eventId`);
+
+DROP TABLE IF EXISTS `calendar_events_archive`;
+CREATE TABLE `calendar_events_archive` (
+  `eventId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `creatorGuid` int(10) unsigned NOT NULL DEFAULT '0',
+  `guildId` int(10) unsigned NOT NULL DEFAULT '0',
+  `type` tinyint(3) unsigned NOT NULL DEFAULT '4',
+  `flags` int(10) unsigned NOT NULL DEFAULT '0',
+  `dungeonId` int(10) NOT NULL DEFAULT '-1',
+  `eventTime` int(10) unsigned NOT NULL DEFAULT '0',
+  `title` varchar(128) NOT NULL DEFAULT '',
+  `description` varchar(1024) NOT NULL DEFAULT '',
+  PRIMARY KEY (`eventId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COMMENT='Calendar events older than Calendar.KeepDays';
+
+DROP TABLE IF EXISTS `calendar_invites_archive`;
+CREATE TABLE `calendar_invites_archive` (
+  `inviteId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `eventId` bigint(10) unsigned NOT NULL DEFAULT '0',
+  `inviteeGuid` int(10) unsigned NOT NULL DEFAULT '0',
+  `senderGuid` int(3) unsigned NOT NULL DEFAULT '0',
+  `status` tinyint(10) unsigned NOT NULL DEFAULT '0',
+  `lastUpdateTime` int(10) unsigned NOT NULL DEFAULT '0',
+  `rank` tinyint(10) unsigned NOT NULL DEFAULT '0',
+  PRIMARY KEY (`inviteId`),
+  KEY `idx_eventId` (`eventId`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8 COMMENT='Invites of the archived calendar events';
@@ -0,0 +1,6 @@
+ALTER TABLE db_version CHANGE COLUMN required_14034_01_mangos_column_fix required_14036_01_mangos_pdump_command bit;
+
+DELETE FROM command WHERE name IN ('pdump write');
+
+INSERT INTO `command`(`name`, `security`, `help`) VALUES
+('pdump write',3,'Syntax: .pdump write $filename $playerNameOrGUID [binary]\r\nWrite character dump with name/guid $playerNameOrGUID to file $filename. With binary the dump is written in the compact binary format, .pdump load reads both.');
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Benchmark.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+void const volatile* g_benchmarkSink = nullptr;
+
+BenchmarkState::BenchmarkState(uint64 iterations, int64 arg) :
+    m_iterations(iterations), m_remaining(iterations), m_arg(arg), m_started(false), m_running(false),
+    m_cpuStart(0.0), m_realTime(0.0), m_cpuTime(0.0), m_items(0), m_bytes(0)
+{
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (!m_running)
+        return;
+
+    m_realTime += std::chrono::duration<double>(Clock::now() - m_realStart).count();
+    m_cpuTime += GetThreadCpuTime() - m_cpuStart;
+    m_running = false;
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (m_running)
+        return;
+
+    m_running = true;
+    m_cpuStart = GetThreadCpuTime();
+    m_realStart = Clock::now();
+}
+
+void BenchmarkState::SkipWithError(std::string const& message)
+{
+    m_error = message;
+    m_remaining = 0;
+}
+
+double BenchmarkState::GetThreadCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0.0;
+
+    ULARGE_INTEGER kernelTime, userTime;
+    kernelTime.LowPart = kernel.dwLowDateTime;
+    kernelTime.HighPart = kernel.dwHighDateTime;
+    userTime.LowPart = user.dwLowDateTime;
+    userTime.HighPart = user.dwHighDateTime;
+    return double(kernelTime.QuadPart + userTime.QuadPart) * 1e-7;
+#else
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+        return 0.0;
+
+    return double(now.tv_sec) + double(now.tv_nsec) * 1e-9;
+#endif
+}
+
+static std::vector<std::unique_ptr<BenchmarkCase>>& GetBenchmarks()
+{
+    // function local, the cases register themselves during static initialization of the other files
+    static std::vector<std::unique_ptr<BenchmarkCase>> benchmarks;
+    return benchmarks;
+}
+
+BenchmarkCase* RegisterBenchmark(char const* name, BenchmarkFunction function)
+{
+    GetBenchmarks().emplace_back(new BenchmarkCase(name, function));
+    return GetBenchmarks().back().get();
+}
+
+std::vector<std::unique_ptr<BenchmarkCase>> const& GetRegisteredBenchmarks()
+{
+    return GetBenchmarks();
+}
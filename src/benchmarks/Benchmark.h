@@ -0,0 +1,146 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_BENCHMARK_H
+#define MANGOS_BENCHMARK_H
+
+#include "Common.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// what a case needs besides the libraries, cases whose fixture is not set up are reported as skipped
+enum BenchmarkFixture
+{
+    BENCHMARK_FIXTURE_NONE,                                 // runs everywhere
+    BENCHMARK_FIXTURE_DATA,                                 // vmaps and mmaps of the DataDir of the configuration
+    BENCHMARK_FIXTURE_WORLD,                                // a started world, databases, DBCs and loaded grids
+};
+
+/**
+ * Handed to a case for one run of a given number of iterations, the case times its loop with
+ * while (state.KeepRunning()) { ... } the way Google Benchmark cases do. Setup before the loop is not timed.
+ */
+class BenchmarkState
+{
+    public:
+        BenchmarkState(uint64 iterations, int64 arg);
+
+        bool KeepRunning()
+        {
+            if (m_remaining)
+            {
+                if (!m_started)
+                {
+                    m_started = true;
+                    ResumeTiming();
+                }
+                --m_remaining;
+                return true;
+            }
+
+            if (m_running)
+                PauseTiming();
+            return false;
+        }
+
+        // excludes per iteration setup from the measurement
+        void PauseTiming();
+        void ResumeTiming();
+
+        // the case can not run, the message ends up in the report
+        void SkipWithError(std::string const& message);
+
+        void SetItemsProcessed(uint64 items) { m_items = items; }
+        void SetBytesProcessed(uint64 bytes) { m_bytes = bytes; }
+
+        int64 GetArg() const { return m_arg; }
+        uint64 GetIterations() const { return m_iterations; }
+
+        bool HasError() const { return !m_error.empty(); }
+        std::string const& GetError() const { return m_error; }
+        uint64 GetItemsProcessed() const { return m_items; }
+        uint64 GetBytesProcessed() const { return m_bytes; }
+        double GetRealTime() const { return m_realTime; }   // seconds
+        double GetCpuTime() const { return m_cpuTime; }     // seconds
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        static double GetThreadCpuTime();
+
+        uint64 m_iterations;
+        uint64 m_remaining;
+        int64 m_arg;
+        bool m_started;
+        bool m_running;
+        Clock::time_point m_realStart;
+        double m_cpuStart;
+        double m_realTime;
+        double m_cpuTime;
+        uint64 m_items;
+        uint64 m_bytes;
+        std::string m_error;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+class BenchmarkCase
+{
+    public:
+        BenchmarkCase(char const* name, BenchmarkFunction function) : m_name(name), m_function(function), m_fixture(BENCHMARK_FIXTURE_NONE) {}
+
+        // runs the case once for every argument, named <case>/<arg>
+        BenchmarkCase* Arg(int64 arg) { m_args.push_back(arg); return this; }
+        BenchmarkCase* Needs(BenchmarkFixture fixture) { m_fixture = fixture; return this; }
+
+        std::string const& GetName() const { return m_name; }
+        BenchmarkFunction GetFunction() const { return m_function; }
+        BenchmarkFixture GetFixture() const { return m_fixture; }
+        std::vector<int64> const& GetArgs() const { return m_args; }
+
+    private:
+        std::string m_name;
+        BenchmarkFunction m_function;
+        BenchmarkFixture m_fixture;
+        std::vector<int64> m_args;
+};
+
+BenchmarkCase* RegisterBenchmark(char const* name, BenchmarkFunction function);
+std::vector<std::unique_ptr<BenchmarkCase>> const& GetRegisteredBenchmarks();
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+#define BENCHMARK(function) static BenchmarkCase* BENCHMARK_CONCAT(s_benchmark, __LINE__) = RegisterBenchmark(#function, function)
+
+// keeps the compiler from dropping a result that is not used otherwise
+extern void const volatile* g_benchmarkSink;
+
+template<class T>
+inline void DoNotOptimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    g_benchmarkSink = &value;
+#endif
+}
+
+#endif
@@ -0,0 +1,304 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BenchmarkRunner.h"
+#include "revision.h"
+
+#include <json.hpp>
+
+#include <boost/asio/ip/host_name.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <functional>
+#include <fstream>
+#include <thread>
+
+#define BENCHMARK_MAX_ITERATIONS 1000000000
+
+namespace
+{
+    char const* const s_fixtureNames[] = { "", "--config", "--world" };
+}
+
+BenchmarkRunner::BenchmarkRunner(double minTime, uint32 repetitions, std::string const& filter) :
+    m_minTime(minTime), m_repetitions(std::max(repetitions, 1u)), m_filter(filter.empty() ? "." : filter)
+{
+    for (bool& ready : m_fixtureReady)
+        ready = false;
+    m_fixtureReady[BENCHMARK_FIXTURE_NONE] = true;
+}
+
+void BenchmarkRunner::ListCases() const
+{
+    for (auto const& benchmark : GetRegisteredBenchmarks())
+    {
+        if (benchmark->GetArgs().empty())
+        {
+            if (Matches(benchmark->GetName()))
+                printf("%s\n", benchmark->GetName().c_str());
+            continue;
+        }
+
+        for (int64 arg : benchmark->GetArgs())
+        {
+            std::string const runName = benchmark->GetName() + "/" + std::to_string(arg);
+            if (Matches(runName))
+                printf("%s\n", runName.c_str());
+        }
+    }
+}
+
+void BenchmarkRunner::RunAll()
+{
+    printf("%-48s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    printf("%s\n", std::string(93, '-').c_str());
+
+    for (auto const& benchmark : GetRegisteredBenchmarks())
+    {
+        if (benchmark->GetArgs().empty())
+        {
+            if (Matches(benchmark->GetName()))
+                Run(*benchmark, benchmark->GetName(), 0);
+            continue;
+        }
+
+        for (int64 arg : benchmark->GetArgs())
+        {
+            std::string const runName = benchmark->GetName() + "/" + std::to_string(arg);
+            if (Matches(runName))
+                Run(*benchmark, runName, arg);
+        }
+    }
+}
+
+void BenchmarkRunner::Run(BenchmarkCase const& benchmark, std::string const& runName, int64 arg)
+{
+    BenchmarkResult result;
+    result.name = runName;
+    result.runName = runName;
+    result.aggregate = false;
+    result.repetitions = m_repetitions;
+    result.repetitionIndex = 0;
+    result.iterations = 0;
+    result.realTime = 0.0;
+    result.cpuTime = 0.0;
+    result.itemsPerSecond = 0.0;
+    result.bytesPerSecond = 0.0;
+
+    if (!m_fixtureReady[benchmark.GetFixture()])
+    {
+        result.error = std::string("skipped, needs ") + s_fixtureNames[benchmark.GetFixture()];
+        m_results.push_back(result);
+        Print(result);
+        return;
+    }
+
+    size_t const first = m_results.size();
+    uint64 iterations = 1;
+    for (uint32 repetition = 0; repetition < m_repetitions; ++repetition)
+    {
+        // the first repetition finds the iteration count, the others reuse it to be comparable
+        for (;;)
+        {
+            BenchmarkState state(iterations, arg);
+            benchmark.GetFunction()(state);
+
+            if (state.HasError())
+            {
+                result.error = state.GetError();
+                m_results.push_back(result);
+                Print(result);
+                return;
+            }
+
+            double const seconds = state.GetRealTime();
+            if (repetition == 0 && seconds < m_minTime && iterations < BENCHMARK_MAX_ITERATIONS)
+            {
+                // same growth as Google Benchmark, at most tenfold while far from the goal
+                double multiplier = m_minTime * 1.4 / std::max(seconds, 1e-9);
+                if (seconds / m_minTime <= 0.1)
+                    multiplier = std::min(multiplier, 10.0);
+                if (multiplier <= 1.0)
+                    multiplier = 2.0;
+                iterations = std::min<uint64>(std::max<uint64>(uint64(iterations * multiplier), iterations + 1), BENCHMARK_MAX_ITERATIONS);
+                continue;
+            }
+
+            result.repetitionIndex = repetition;
+            result.iterations = state.GetIterations();
+            result.realTime = seconds * 1e9 / state.GetIterations();
+            result.cpuTime = state.GetCpuTime() * 1e9 / state.GetIterations();
+            result.itemsPerSecond = state.GetItemsProcessed() && seconds > 0.0 ? state.GetItemsProcessed() / seconds : 0.0;
+            result.bytesPerSecond = state.GetBytesProcessed() && seconds > 0.0 ? state.GetBytesProcessed() / seconds : 0.0;
+            m_results.push_back(result);
+            Print(result);
+            break;
+        }
+    }
+
+    if (m_repetitions > 1)
+        AddAggregates(runName, first);
+}
+
+void BenchmarkRunner::AddAggregates(std::string const& runName, size_t first)
+{
+    std::vector<BenchmarkResult> const runs(m_results.begin() + first, m_results.end());
+    size_t const count = runs.size();
+
+    auto aggregate = [&](char const* name, std::function<double(std::vector<double>&)> function)
+    {
+        BenchmarkResult result = runs.front();
+        result.name = runName + "_" + name;
+        result.aggregate = true;
+        result.aggregateName = name;
+
+        std::vector<double> values(count);
+        auto apply = [&](double BenchmarkResult::* field)
+        {
+            for (size_t i = 0; i < count; ++i)
+                values[i] = runs[i].*field;
+            result.*field = function(values);
+        };
+        apply(&BenchmarkResult::realTime);
+        apply(&BenchmarkResult::cpuTime);
+        apply(&BenchmarkResult::itemsPerSecond);
+        apply(&BenchmarkResult::bytesPerSecond);
+
+        m_results.push_back(result);
+        Print(result);
+    };
+
+    auto mean = [](std::vector<double>& values)
+    {
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+        return sum / values.size();
+    };
+
+    aggregate("mean", mean);
+    aggregate("median", [](std::vector<double>& values)
+    {
+        std::sort(values.begin(), values.end());
+        size_t const middle = values.size() / 2;
+        return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    });
+    aggregate("stddev", [mean](std::vector<double>& values)
+    {
+        double const average = mean(values);
+        double sum = 0.0;
+        for (double value : values)
+            sum += (value - average) * (value - average);
+        return std::sqrt(sum / (values.size() - 1));
+    });
+}
+
+void BenchmarkRunner::Print(BenchmarkResult const& result) const
+{
+    if (!result.error.empty())
+    {
+        printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+        return;
+    }
+
+    std::string rates;
+    if (result.itemsPerSecond > 0.0)
+        rates += " items/s=" + std::to_string(uint64(result.itemsPerSecond));
+    if (result.bytesPerSecond > 0.0)
+        rates += " bytes/s=" + std::to_string(uint64(result.bytesPerSecond));
+
+    printf("%-48s %12.1f ns %12.1f ns %12s%s\n", result.name.c_str(), result.realTime, result.cpuTime,
+           result.aggregate ? "" : std::to_string(result.iterations).c_str(), rates.c_str());
+    fflush(stdout);
+}
+
+bool BenchmarkRunner::WriteJson(std::string const& fileName, std::string const& executable) const
+{
+    char date[32];
+    time_t const now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    nlohmann::json context;
+    context["date"] = date;
+    context["host_name"] = boost::asio::ip::host_name();
+    context["executable"] = executable;
+    context["num_cpus"] = std::thread::hardware_concurrency();
+#ifdef NDEBUG
+    context["library_build_type"] = "release";
+#else
+    context["library_build_type"] = "debug";
+#endif
+    // the commit the numbers belong to, for tracking them across merges
+    context["mangos_revision"] = REVISION_ID;
+    context["mangos_revision_date"] = REVISION_DATE;
+
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (BenchmarkResult const& result : m_results)
+    {
+        nlohmann::json entry;
+        entry["name"] = result.name;
+        entry["run_name"] = result.runName;
+        entry["run_type"] = result.aggregate ? "aggregate" : "iteration";
+        entry["repetitions"] = result.repetitions;
+        entry["repetition_index"] = result.repetitionIndex;
+        entry["threads"] = 1;
+        if (result.aggregate)
+            entry["aggregate_name"] = result.aggregateName;
+
+        if (!result.error.empty())
+        {
+            entry["error_occurred"] = true;
+            entry["error_message"] = result.error;
+        }
+        else
+        {
+            entry["iterations"] = result.iterations;
+            entry["real_time"] = result.realTime;
+            entry["cpu_time"] = result.cpuTime;
+            entry["time_unit"] = "ns";
+            if (result.itemsPerSecond > 0.0)
+                entry["items_per_second"] = result.itemsPerSecond;
+            if (result.bytesPerSecond > 0.0)
+                entry["bytes_per_second"] = result.bytesPerSecond;
+        }
+
+        benchmarks.push_back(entry);
+    }
+
+    nlohmann::json report;
+    report["context"] = context;
+    report["benchmarks"] = benchmarks;
+
+    std::ofstream file(fileName);
+    if (!file)
+        return false;
+
+    file << report.dump(2) << std::endl;
+    return file.good();
+}
+
+uint32 BenchmarkRunner::GetErrorCount() const
+{
+    uint32 count = 0;
+    for (BenchmarkResult const& result : m_results)
+        if (!result.error.empty() && result.error.compare(0, 7, "skipped") != 0)
+            ++count;
+    return count;
+}
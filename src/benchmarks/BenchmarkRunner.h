@@ -0,0 +1,74 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_BENCHMARK_RUNNER_H
+#define MANGOS_BENCHMARK_RUNNER_H
+
+#include "Benchmark.h"
+
+#include <regex>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult
+{
+    std::string name;                                       // <case>/<arg>, with the aggregate appended
+    std::string runName;                                    // <case>/<arg>
+    bool aggregate;
+    std::string aggregateName;                              // mean, median or stddev
+    uint32 repetitions;
+    uint32 repetitionIndex;
+    uint64 iterations;
+    double realTime;                                        // nanoseconds per iteration
+    double cpuTime;
+    double itemsPerSecond;                                  // 0 when the case does not count them
+    double bytesPerSecond;
+    std::string error;
+};
+
+/**
+ * Runs the registered cases, each until it took at least the minimal time, and writes the results
+ * in the JSON format of Google Benchmark, so that its compare.py can diff two runs.
+ */
+class BenchmarkRunner
+{
+    public:
+        BenchmarkRunner(double minTime, uint32 repetitions, std::string const& filter);
+
+        void SetFixtureReady(BenchmarkFixture fixture) { m_fixtureReady[fixture] = true; }
+
+        void ListCases() const;
+        void RunAll();
+        bool WriteJson(std::string const& fileName, std::string const& executable) const;
+
+        uint32 GetErrorCount() const;
+
+    private:
+        void Run(BenchmarkCase const& benchmark, std::string const& runName, int64 arg);
+        bool Matches(std::string const& runName) const { return std::regex_search(runName, m_filter); }
+        void AddAggregates(std::string const& runName, size_t first);
+        void Print(BenchmarkResult const& result) const;
+
+        double m_minTime;                                   // seconds
+        uint32 m_repetitions;
+        std::regex m_filter;
+        bool m_fixtureReady[BENCHMARK_FIXTURE_WORLD + 1];
+        std::vector<BenchmarkResult> m_results;
+};
+
+#endif
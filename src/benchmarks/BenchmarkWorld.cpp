@@ -0,0 +1,98 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BenchmarkWorld.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "World/World.h"
+#include "revision_sql.h"
+
+namespace
+{
+    std::vector<DatabaseType*> s_startedDatabases;
+    bool s_worldLoaded = false;
+
+    bool StartDatabase(DatabaseType& database, char const* name, char const* infoKey, char const* connectionsKey, char const* versionTable, char const* version)
+    {
+        std::string const info = sConfig.GetStringDefault(infoKey);
+        if (info.empty())
+        {
+            sLog.outError("%s database not specified in configuration file", name);
+            return false;
+        }
+
+        if (!database.Initialize(info.c_str(), sConfig.GetIntDefault(connectionsKey, 1)))
+        {
+            sLog.outError("Cannot connect to %s database %s", name, info.c_str());
+            return false;
+        }
+
+        s_startedDatabases.push_back(&database);
+        return !versionTable || database.CheckRequiredField(versionTable, version);
+    }
+}
+
+bool BenchmarkWorld::LoadConfig(std::string const& configFile)
+{
+    if (!sConfig.SetSource(configFile))
+    {
+        sLog.outError("Could not find configuration file %s.", configFile.c_str());
+        return false;
+    }
+
+    sWorld.LoadConfigSettings();
+    return true;
+}
+
+bool BenchmarkWorld::Start()
+{
+    // the same databases and checks as mangosd, the loaders of the world expect all of them
+    if (!StartDatabase(WorldDatabase, "World", "WorldDatabaseInfo", "WorldDatabaseConnections", "db_version", REVISION_DB_MANGOS) ||
+            !StartDatabase(CharacterDatabase, "Character", "CharacterDatabaseInfo", "CharacterDatabaseConnections", "character_db_version", REVISION_DB_CHARACTERS) ||
+            !StartDatabase(PlayerbotDatabase, "Playerbot", "PlayerbotDatabaseInfo", "PlayerbotDatabaseConnections", nullptr, nullptr) ||
+            !StartDatabase(LoginDatabase, "Login", "LoginDatabaseInfo", "LoginDatabaseConnections", "realmd_db_version", REVISION_DB_REALMD))
+    {
+        Stop();
+        return false;
+    }
+
+    realmID = sConfig.GetIntDefault("RealmID", 0);
+    if (!realmID)
+    {
+        sLog.outError("Realm ID not defined in configuration file");
+        Stop();
+        return false;
+    }
+
+    sWorld.LoadDBVersion();
+    sWorld.SetInitialWorldSettings();
+    s_worldLoaded = true;
+    return true;
+}
+
+void BenchmarkWorld::Stop()
+{
+    if (s_worldLoaded)
+        sWorld.CleanupsBeforeStop();
+    s_worldLoaded = false;
+
+    for (DatabaseType* database : s_startedDatabases)
+        database->HaltDelayThread();
+    s_startedDatabases.clear();
+}
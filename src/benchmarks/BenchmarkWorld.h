@@ -0,0 +1,39 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_BENCHMARK_WORLD_H
+#define MANGOS_BENCHMARK_WORLD_H
+
+#include "Common.h"
+
+// Stormwind, a crowded city on the first continent, the cases of data and world run there
+#define BENCHMARK_MAP_ID        0
+#define BENCHMARK_AREA_X        -8913.23f
+#define BENCHMARK_AREA_Y        554.633f
+
+namespace BenchmarkWorld
+{
+    // reads the settings of mangosd.conf without touching a database, for the data cases
+    bool LoadConfig(std::string const& configFile);
+
+    // connects the databases and loads the world like mangosd does, for the world cases
+    bool Start();
+    void Stop();
+}
+
+#endif
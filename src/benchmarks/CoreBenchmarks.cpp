@@ -0,0 +1,370 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Cases of the containers and kernels that run without data: packet buffers, update packets,
+ * event queues, the lookups of the SQL storages, the sets of the objects a client knows and the rolls.
+ */
+
+#include "Benchmark.h"
+#include "ByteBuffer.h"
+#include "Database/SQLStorage.h"
+#include "Entities/GuidHashSet.h"
+#include "Entities/UpdateData.h"
+#include "Utilities/EventProcessor.h"
+#include "Util.h"
+#include "WorldPacket.h"
+
+#include <random>
+
+namespace
+{
+    // the fields of a movement update: packed guid, flags, time, position, orientation and fall time
+    void AppendMovement(ByteBuffer& buffer, uint32 index)
+    {
+        buffer.appendPackGUID(0xF130000000000000ULL | (index + 1));
+        buffer << uint32(0x00000001);
+        buffer << uint16(0);
+        buffer << uint32(123456 + index);
+        buffer << float(-8913.23f + index) << float(554.633f) << float(93.7944f) << float(0.6f);
+        buffer << uint32(0);
+    }
+
+    float ReadMovement(ByteBuffer& buffer)
+    {
+        uint64 guid = buffer.readPackGUID();
+        uint32 flags, time, fallTime;
+        uint16 flags2;
+        float x, y, z, o;
+        buffer >> flags >> flags2 >> time >> x >> y >> z >> o >> fallTime;
+        return x + y + z + o + float(guid + flags + flags2 + time + fallTime);
+    }
+
+    // a values update of a creature, about a dozen fields changed
+    void AppendValuesUpdate(ByteBuffer& buffer, uint32 index)
+    {
+        uint32 const maskBlocks = 5;
+        uint32 const mask[maskBlocks] = { 0x00000000, 0x00C00000, 0x00000130, 0x00000000, 0x00E1000C };
+
+        buffer << uint8(UPDATETYPE_VALUES);
+        buffer.appendPackGUID(0xF130000000000000ULL | (index + 1));
+        buffer << uint8(maskBlocks);
+        for (uint32 block : mask)
+            buffer << block;
+        for (uint32 block : mask)
+            for (uint32 bit = block; bit; bit &= bit - 1)
+                buffer << uint32(index * 37 + bit % 1000);
+    }
+
+    class RepeatingEvent : public BasicEvent
+    {
+        public:
+            RepeatingEvent(EventProcessor& events, uint32 interval, uint64& executed) : m_events(events), m_interval(interval), m_executed(executed) {}
+
+            bool Execute(uint64 e_time, uint32 /*p_time*/) override
+            {
+                ++m_executed;
+                m_events.AddEvent(this, e_time + m_interval);
+                return false;                               // added again, not to be deleted
+            }
+
+        private:
+            EventProcessor& m_events;
+            uint32 m_interval;
+            uint64& m_executed;
+    };
+
+    struct StorageRecord
+    {
+        uint32 entry;
+        uint32 modelId;
+        uint32 faction;
+        uint32 flags;
+    };
+
+    // fills the index of the storages the way SQLStorageLoaderBase does, without database
+    template<class StorageClass>
+    class BenchmarkStorage : public StorageClass
+    {
+        public:
+            BenchmarkStorage() : StorageClass("iiii", "entry", "benchmark_template") {}
+
+            void Fill(std::vector<uint32> const& entries)
+            {
+                m_records.resize(entries.size());
+                this->prepareToLoad(entries.back() + 1, entries.size(), sizeof(StorageRecord));
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    m_records[i] = { entries[i], entries[i] * 3, 14, 0 };
+                    this->JustCreatedRecord(entries[i], reinterpret_cast<char*>(&m_records[i]));
+                }
+            }
+
+        private:
+            std::vector<StorageRecord> m_records;
+    };
+
+    template<class StorageClass>
+    void StorageLookup(BenchmarkState& state)
+    {
+        // sparse entries like creature_template, half of the lookups miss
+        std::mt19937 random(1);
+        std::vector<uint32> entries;
+        uint32 const maxEntry = uint32(state.GetArg()) * 2;
+        for (uint32 entry = 1; entry <= maxEntry; ++entry)
+            if (random() & 1)
+                entries.push_back(entry);
+
+        BenchmarkStorage<StorageClass> storage;
+        storage.Fill(entries);
+
+        std::vector<uint32> lookups(4096);
+        for (uint32& entry : lookups)
+            entry = random() % (maxEntry + 1);
+
+        size_t index = 0;
+        while (state.KeepRunning())
+        {
+            DoNotOptimize(storage.template LookupEntry<StorageRecord>(lookups[index]));
+            index = (index + 1) & (lookups.size() - 1);
+        }
+        state.SetItemsProcessed(state.GetIterations());
+    }
+}
+
+static void BM_ByteBufferAppend(BenchmarkState& state)
+{
+    uint32 const records = uint32(state.GetArg());
+    uint64 bytes = 0;
+    while (state.KeepRunning())
+    {
+        ByteBuffer buffer;
+        for (uint32 i = 0; i < records; ++i)
+            AppendMovement(buffer, i);
+        bytes += buffer.wpos();
+        DoNotOptimize(buffer.contents());
+    }
+    state.SetItemsProcessed(state.GetIterations() * records);
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_ByteBufferAppend)->Arg(1)->Arg(64)->Arg(512);
+
+static void BM_ByteBufferRead(BenchmarkState& state)
+{
+    uint32 const records = uint32(state.GetArg());
+    ByteBuffer buffer;
+    for (uint32 i = 0; i < records; ++i)
+        AppendMovement(buffer, i);
+
+    while (state.KeepRunning())
+    {
+        buffer.rpos(0);
+        float sum = 0.0f;
+        for (uint32 i = 0; i < records; ++i)
+            sum += ReadMovement(buffer);
+        DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.GetIterations() * records);
+    state.SetBytesProcessed(state.GetIterations() * buffer.wpos());
+}
+BENCHMARK(BM_ByteBufferRead)->Arg(1)->Arg(64)->Arg(512);
+
+// packets above 100 bytes are compressed, a single block is not
+static void BM_UpdateDataBuildPacket(BenchmarkState& state)
+{
+    UpdateData data;
+    ByteBuffer block;
+    for (uint32 i = 0; i < uint32(state.GetArg()); ++i)
+    {
+        block.clear();
+        AppendValuesUpdate(block, i);
+        data.AddUpdateBlock(block);
+    }
+
+    while (state.KeepRunning())
+    {
+        for (size_t i = 0; i < data.GetPacketCount(); ++i)
+        {
+            WorldPacket packet = data.BuildPacket(i);
+            DoNotOptimize(packet.contents());
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+}
+BENCHMARK(BM_UpdateDataBuildPacket)->Arg(1)->Arg(16)->Arg(128);
+
+// a map update of 100 ms with the given number of timed events, e.g. spell and aura events of the units
+static void BM_EventProcessorUpdate(BenchmarkState& state)
+{
+    std::mt19937 random(1);
+    uint64 executed = 0;
+    EventProcessor events;
+    for (int64 i = 0; i < state.GetArg(); ++i)
+    {
+        uint32 const interval = 100 + random() % 10000;
+        events.AddEvent(new RepeatingEvent(events, interval, executed), events.CalculateTime(random() % interval));
+    }
+
+    while (state.KeepRunning())
+        events.Update(100);
+
+    state.SetItemsProcessed(executed);
+}
+BENCHMARK(BM_EventProcessorUpdate)->Arg(16)->Arg(1024)->Arg(16384);
+
+// adding and aborting an event with the given number of others queued
+static void BM_EventProcessorAddKill(BenchmarkState& state)
+{
+    std::mt19937 random(1);
+    uint64 executed = 0;
+    EventProcessor events;
+    for (int64 i = 0; i < state.GetArg(); ++i)
+    {
+        uint32 const interval = 100 + random() % 10000;
+        events.AddEvent(new RepeatingEvent(events, interval, executed), events.CalculateTime(random() % interval));
+    }
+
+    while (state.KeepRunning())
+    {
+        BasicEvent* event = new BasicEvent;
+        events.AddEvent(event, events.CalculateTime(random() % 10000));
+        events.KillEvent(event);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_EventProcessorAddKill)->Arg(16)->Arg(16384);
+
+static void BM_SQLStorageLookup(BenchmarkState& state)
+{
+    StorageLookup<SQLStorage>(state);
+}
+BENCHMARK(BM_SQLStorageLookup)->Arg(1024)->Arg(65536);
+
+static void BM_SQLHashStorageLookup(BenchmarkState& state)
+{
+    StorageLookup<SQLHashStorage>(state);
+}
+BENCHMARK(BM_SQLHashStorageLookup)->Arg(1024)->Arg(65536);
+
+namespace
+{
+    // the objects around a player in a city: mostly creatures, some game objects and players
+    ObjectGuid MakeClientGuid(uint32 index)
+    {
+        switch (index % 8)
+        {
+            case 0:  return ObjectGuid(HIGHGUID_PLAYER, index + 1);
+            case 1:  return ObjectGuid(HIGHGUID_GAMEOBJECT, uint32(180000 + index % 64), index + 1);
+            default: return ObjectGuid(HIGHGUID_UNIT, uint32(3000 + index % 512), index + 1);
+        }
+    }
+
+    // the visibility checks of a player knowing the given number of objects, half of the checked ones are known
+    template<class SetType>
+    void ClientGuidsLookup(BenchmarkState& state)
+    {
+        uint32 const known = uint32(state.GetArg());
+        SetType guids;
+        for (uint32 i = 0; i < known; ++i)
+            guids.insert(MakeClientGuid(i * 2));
+
+        uint32 index = 0;
+        uint64 found = 0;
+        while (state.KeepRunning())
+        {
+            found += guids.find(MakeClientGuid(index)) != guids.end() ? 1 : 0;
+            index = (index + 1) % (known * 2);
+        }
+        DoNotOptimize(found);
+        state.SetItemsProcessed(state.GetIterations());
+    }
+
+    // objects coming into and going out of sight, with the given number known
+    template<class SetType>
+    void ClientGuidsChurn(BenchmarkState& state)
+    {
+        uint32 const known = uint32(state.GetArg());
+        SetType guids;
+        for (uint32 i = 0; i < known; ++i)
+            guids.insert(MakeClientGuid(i));
+
+        uint32 index = 0;
+        while (state.KeepRunning())
+        {
+            guids.erase(MakeClientGuid(index));
+            guids.insert(MakeClientGuid(index + known));
+            ++index;
+        }
+        DoNotOptimize(guids.size());
+        state.SetItemsProcessed(state.GetIterations());
+    }
+}
+
+static void BM_ClientGuidsLookupGuidSet(BenchmarkState& state)
+{
+    ClientGuidsLookup<GuidSet>(state);
+}
+BENCHMARK(BM_ClientGuidsLookupGuidSet)->Arg(64)->Arg(1024)->Arg(4096);
+
+static void BM_ClientGuidsLookupGuidHashSet(BenchmarkState& state)
+{
+    ClientGuidsLookup<GuidHashSet>(state);
+}
+BENCHMARK(BM_ClientGuidsLookupGuidHashSet)->Arg(64)->Arg(1024)->Arg(4096);
+
+static void BM_ClientGuidsChurnGuidSet(BenchmarkState& state)
+{
+    ClientGuidsChurn<GuidSet>(state);
+}
+BENCHMARK(BM_ClientGuidsChurnGuidSet)->Arg(64)->Arg(1024);
+
+static void BM_ClientGuidsChurnGuidHashSet(BenchmarkState& state)
+{
+    ClientGuidsChurn<GuidHashSet>(state);
+}
+BENCHMARK(BM_ClientGuidsChurnGuidHashSet)->Arg(64)->Arg(1024);
+
+// a batch of chance rolls, e.g. the hit and crit rolls of a spell on its targets
+static void BM_RollChance(BenchmarkState& state)
+{
+    RandomEngine generator(1);
+    RandomGeneratorScope randomScope(&generator);
+    uint32 hits = 0;
+    while (state.KeepRunning())
+    {
+        for (int64 i = 0; i < state.GetArg(); ++i)
+            hits += roll_chance_f(25.0f) ? 1 : 0;
+    }
+    DoNotOptimize(hits);
+    state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+}
+BENCHMARK(BM_RollChance)->Arg(16)->Arg(1024);
+
+static void BM_RollFill(BenchmarkState& state)
+{
+    RandomEngine generator(1);
+    RandomGeneratorScope randomScope(&generator);
+    std::vector<uint32> values(size_t(state.GetArg()));
+    while (state.KeepRunning())
+    {
+        rand_fill(values.data(), values.size());
+        DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+}
+BENCHMARK(BM_RollFill)->Arg(16)->Arg(1024);
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup benchmarks
+/// @{
+/// \file
+
+/*
+ * Micro-benchmarks of the hot paths of the game library. The core cases need nothing, the data cases need
+ * the maps, vmaps and mmaps of the DataDir of a mangosd.conf (--config) and the world cases additionally
+ * load the world from its databases (--world). Cases that cannot run are reported as skipped.
+ * The JSON report (--out) has the format of Google Benchmark, two of them can be diffed with its compare.py.
+ */
+
+#include "Common.h"
+#include "BenchmarkRunner.h"
+#include "BenchmarkWorld.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+DatabaseType WorldDatabase;                                 ///< Accessor to the world database
+DatabaseType CharacterDatabase;                             ///< Accessor to the character database
+DatabaseType LoginDatabase;                                 ///< Accessor to the realm/login database
+DatabaseType PlayerbotDatabase;                             ///< Accessor to the playerbot database
+
+uint32 realmID;                                             ///< Id of the realm
+
+int main(int argc, char* argv[])
+{
+    std::string configFile, filter, outFile;
+    double minTime;
+    uint32 repetitions;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage message")
+    ("config,c", boost::program_options::value<std::string>(&configFile), "mangosd configuration file, enables the cases on the DataDir")
+    ("world", "load the world from the databases of the configuration, enables the cases on the world")
+    ("filter,f", boost::program_options::value<std::string>(&filter), "regular expression the names of the cases have to match")
+    ("min-time", boost::program_options::value<double>(&minTime)->default_value(0.5), "minimal seconds each case runs")
+    ("repetitions,r", boost::program_options::value<uint32>(&repetitions)->default_value(1), "runs of each case, mean, median and stddev are added for more than one")
+    ("out,o", boost::program_options::value<std::string>(&outFile), "file the JSON report is written to")
+    ("list", "print the names of the cases and exit");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    BenchmarkRunner runner(minTime, repetitions, filter);
+    if (vm.count("list"))
+    {
+        runner.ListCases();
+        return 0;
+    }
+
+    bool const world = vm.count("world") > 0;
+    if (world && configFile.empty())
+    {
+        printf("--world needs the configuration of the databases, set it with --config\n");
+        return 1;
+    }
+
+    if (!configFile.empty())
+    {
+        if (!BenchmarkWorld::LoadConfig(configFile))
+            return 1;
+        runner.SetFixtureReady(BENCHMARK_FIXTURE_DATA);
+
+        if (world)
+        {
+            if (!BenchmarkWorld::Start())
+                return 1;
+            runner.SetFixtureReady(BENCHMARK_FIXTURE_WORLD);
+        }
+    }
+    else
+        sWorld.setConfig(CONFIG_UINT32_COMPRESSION, 1);     // as the default of mangosd.conf
+
+    runner.RunAll();
+
+    if (world)
+        BenchmarkWorld::Stop();
+
+    if (!outFile.empty() && !runner.WriteJson(outFile, argv[0]))
+    {
+        printf("Can not write %s\n", outFile.c_str());
+        return 1;
+    }
+
+    return runner.GetErrorCount() ? 1 : 0;
+}
+
+/// @}
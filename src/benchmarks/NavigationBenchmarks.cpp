@@ -0,0 +1,218 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Cases of the queries on the extracted vmaps and mmaps of the DataDir, the tiles around the
+ * benchmark area are loaded once and kept for all runs.
+ */
+
+#include "Benchmark.h"
+#include "BenchmarkWorld.h"
+#include "Maps/GridDefines.h"
+#include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathFinder.h"
+#include "Policies/Singleton.h"
+#include "Vmap/VMapFactory.h"
+#include "World/World.h"
+
+#include <random>
+
+#define NAVIGATION_QUERIES 4096                             // power of two, more than the path cache holds
+
+namespace
+{
+    std::mt19937 s_random(1);
+
+    // [0, 1) for detour, the generator must not return 1
+    float RandomFloat()
+    {
+        return float(s_random() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    template<class F>
+    void ForEachAreaTile(F function)
+    {
+        GridPair const grid = MaNGOS::ComputeGridPair(BENCHMARK_AREA_X, BENCHMARK_AREA_Y);
+        int32 const tileX = (MAX_NUMBER_OF_GRIDS - 1) - grid.x_coord;
+        int32 const tileY = (MAX_NUMBER_OF_GRIDS - 1) - grid.y_coord;
+        for (int32 x = tileX - 1; x <= tileX + 1; ++x)
+            for (int32 y = tileY - 1; y <= tileY + 1; ++y)
+                function(x, y);
+    }
+
+    struct LineOfSightQueries
+    {
+        std::string error;
+        std::vector<float> points;                          // x1, y1, z1, x2, y2, z2 of each query
+    };
+
+    // segments of the given length between points on models, the city consists of WMOs
+    LineOfSightQueries const& GetLineOfSightQueries(int64 length)
+    {
+        static std::map<int64, LineOfSightQueries> queriesByLength;
+        auto itr = queriesByLength.find(length);
+        if (itr != queriesByLength.end())
+            return itr->second;
+
+        LineOfSightQueries& queries = queriesByLength[length];
+
+        VMAP::IVMapManager* vmaps = VMAP::VMapFactory::createOrGetVMapManager();
+        vmaps->setEnableLineOfSightCalc(true);
+        vmaps->setEnableHeightCalc(true);
+
+        uint32 loadedTiles = 0;
+        std::string const path = sWorld.GetDataPath() + "vmaps";
+        ForEachAreaTile([&](int32 x, int32 y)
+        {
+            if (vmaps->IsTileLoaded(BENCHMARK_MAP_ID, x, y) || vmaps->loadMap(path.c_str(), BENCHMARK_MAP_ID, x, y) == VMAP::VMAP_LOAD_RESULT_OK)
+                ++loadedTiles;
+        });
+
+        if (!loadedTiles)
+        {
+            queries.error = "no vmaps of the benchmark area in " + path;
+            return queries;
+        }
+
+        auto groundHeight = [vmaps](float x, float y)
+        {
+            return vmaps->getHeight(BENCHMARK_MAP_ID, x, y, 1000.0f, 2000.0f);
+        };
+
+        uint32 attempts = 0;
+        while (queries.points.size() < NAVIGATION_QUERIES * 6 && ++attempts < NAVIGATION_QUERIES * 100)
+        {
+            float const x1 = BENCHMARK_AREA_X + (RandomFloat() - 0.5f) * 400.0f;
+            float const y1 = BENCHMARK_AREA_Y + (RandomFloat() - 0.5f) * 400.0f;
+            float const angle = RandomFloat() * 2 * M_PI_F;
+            float const x2 = x1 + cos(angle) * length;
+            float const y2 = y1 + sin(angle) * length;
+            float const z1 = groundHeight(x1, y1);
+            float const z2 = groundHeight(x2, y2);
+            if (z1 < VMAP_INVALID_HEIGHT || z2 < VMAP_INVALID_HEIGHT)
+                continue;
+
+            // eye height of a humanoid
+            float const points[] = { x1, y1, z1 + 2.0f, x2, y2, z2 + 2.0f };
+            queries.points.insert(queries.points.end(), std::begin(points), std::end(points));
+        }
+
+        if (queries.points.size() < NAVIGATION_QUERIES * 6)
+            queries.error = "too few model heights in the vmaps of the benchmark area";
+        return queries;
+    }
+
+    struct PathQueries
+    {
+        std::string error;
+        std::vector<Vector3> points;                        // start and end of each query
+    };
+
+    // ends at about the given distance on the mesh from random starts
+    PathQueries const& GetPathQueries(int64 distance)
+    {
+        static std::map<int64, PathQueries> queriesByDistance;
+        auto itr = queriesByDistance.find(distance);
+        if (itr != queriesByDistance.end())
+            return itr->second;
+
+        PathQueries& queries = queriesByDistance[distance];
+
+        if (!MMAP::MMapFactory::IsPathfindingEnabled(BENCHMARK_MAP_ID, nullptr))
+        {
+            queries.error = "mmaps are disabled for the benchmark map";
+            return queries;
+        }
+
+        MMAP::MMapManager* mmaps = MMAP::MMapFactory::createOrGetMMapManager();
+        ForEachAreaTile([mmaps](int32 x, int32 y)
+        {
+            if (!mmaps->IsMMapIsLoaded(BENCHMARK_MAP_ID, x, y))
+                mmaps->loadMap(BENCHMARK_MAP_ID, x, y);
+        });
+
+        MMAP::NavMeshQueryLease query = mmaps->LeaseNavMeshQuery(BENCHMARK_MAP_ID);
+        if (!query)
+        {
+            queries.error = "no mmaps of the benchmark area in " + sWorld.GetDataPath() + "mmaps";
+            return queries;
+        }
+
+        dtQueryFilter filter;
+        uint32 attempts = 0;
+        while (queries.points.size() < NAVIGATION_QUERIES * 2 && ++attempts < NAVIGATION_QUERIES * 100)
+        {
+            dtPolyRef startRef, endRef;
+            float start[VERTEX_SIZE], end[VERTEX_SIZE];
+            if (dtStatusFailed(query->findRandomPoint(&filter, RandomFloat, &startRef, start)) ||
+                    dtStatusFailed(query->findRandomPointAroundCircle(startRef, start, float(distance), &filter, RandomFloat, &endRef, end)))
+                continue;
+
+            // detour keeps y, z, x
+            queries.points.emplace_back(start[2], start[0], start[1]);
+            queries.points.emplace_back(end[2], end[0], end[1]);
+        }
+
+        if (queries.points.size() < NAVIGATION_QUERIES * 2)
+            queries.error = "too few polygons in the mmaps of the benchmark area";
+        return queries;
+    }
+}
+
+static void BM_VMapLineOfSight(BenchmarkState& state)
+{
+    LineOfSightQueries const& queries = GetLineOfSightQueries(state.GetArg());
+    if (!queries.error.empty())
+    {
+        state.SkipWithError(queries.error);
+        return;
+    }
+
+    VMAP::IVMapManager* vmaps = VMAP::VMapFactory::createOrGetVMapManager();
+    float const* points = queries.points.data();
+    uint32 index = 0;
+    while (state.KeepRunning())
+    {
+        float const* query = points + index * 6;
+        DoNotOptimize(vmaps->isInLineOfSight(BENCHMARK_MAP_ID, query[0], query[1], query[2], query[3], query[4], query[5], false));
+        index = (index + 1) & (NAVIGATION_QUERIES - 1);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_VMapLineOfSight)->Arg(10)->Arg(40)->Arg(100)->Needs(BENCHMARK_FIXTURE_DATA);
+
+// the path finder of a chasing or wandering creature, reused for every path like the movement generators do
+static void BM_PathFinderCalculate(BenchmarkState& state)
+{
+    PathQueries const& queries = GetPathQueries(state.GetArg());
+    if (!queries.error.empty())
+    {
+        state.SkipWithError(queries.error);
+        return;
+    }
+
+    PathFinder path(uint32(BENCHMARK_MAP_ID));
+    uint32 index = 0;
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(path.calculate(queries.points[index * 2], queries.points[index * 2 + 1]));
+        index = (index + 1) & (NAVIGATION_QUERIES - 1);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_PathFinderCalculate)->Arg(20)->Arg(60)->Arg(200)->Needs(BENCHMARK_FIXTURE_DATA);
@@ -0,0 +1,261 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Cases of the loaded world: grid searches around the creatures of the benchmark area, threat
+ * lists, loot rolls and the lookups of the creature templates.
+ */
+
+#include "Benchmark.h"
+#include "BenchmarkWorld.h"
+#include "Combat/ThreatManager.h"
+#include "Entities/Creature.h"
+#include "Grids/CellImpl.h"
+#include "Grids/GridNotifiers.h"
+#include "Grids/GridNotifiersImpl.h"
+#include "Loot/LootMgr.h"
+#include "Maps/MapManager.h"
+#include "Server/SQLStorages.h"
+
+#include <random>
+
+namespace
+{
+    struct CreatureCollector
+    {
+        std::vector<Creature*>& i_creatures;
+
+        CreatureCollector(std::vector<Creature*>& creatures) : i_creatures(creatures) {}
+
+        void Visit(CreatureMapType& m)
+        {
+            for (auto& itr : m)
+                i_creatures.push_back(itr.getSource());
+        }
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
+    };
+
+    // the spawns around the benchmark area, their grids stay loaded for all runs
+    std::vector<Creature*> const& GetAreaCreatures()
+    {
+        static std::vector<Creature*> creatures;
+        if (!creatures.empty())
+            return creatures;
+
+        Map* map = sMapMgr.CreateMap(BENCHMARK_MAP_ID, nullptr);
+        for (float x = -SIZE_OF_GRIDS; x <= SIZE_OF_GRIDS; x += SIZE_OF_GRIDS)
+            for (float y = -SIZE_OF_GRIDS; y <= SIZE_OF_GRIDS; y += SIZE_OF_GRIDS)
+                map->ForceLoadGrid(BENCHMARK_AREA_X + x, BENCHMARK_AREA_Y + y);
+
+        CreatureCollector collector(creatures);
+        Cell::VisitGridObjects(BENCHMARK_AREA_X, BENCHMARK_AREA_Y, map, collector, SIZE_OF_GRIDS);
+        return creatures;
+    }
+
+    std::vector<Creature*> const* GetAreaCreaturesOrSkip(BenchmarkState& state)
+    {
+        std::vector<Creature*> const& creatures = GetAreaCreatures();
+        if (creatures.size() < 2)
+        {
+            state.SkipWithError("no creatures spawned in the benchmark area");
+            return nullptr;
+        }
+        return &creatures;
+    }
+}
+
+// the search of the aggro and assistance checks, around each creature in turn
+static void BM_CellVisitAnyUnitInRange(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    float const radius = float(state.GetArg());
+    size_t index = 0;
+    uint64 found = 0;
+    while (state.KeepRunning())
+    {
+        Creature* creature = (*creatures)[index];
+        UnitList targets;
+        MaNGOS::AnyUnitInObjectRangeCheck check(creature, radius);
+        MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, check);
+        Cell::VisitAllObjects(creature, searcher, radius);
+        found += targets.size();
+        index = (index + 1) % creatures->size();
+    }
+    state.SetItemsProcessed(found);
+}
+BENCHMARK(BM_CellVisitAnyUnitInRange)->Arg(10)->Arg(30)->Arg(100)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// the search of scripts for a creature of an entry, misses walk every cell of the radius
+static void BM_CellVisitNearestCreatureEntry(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    float const radius = float(state.GetArg());
+    size_t index = 0;
+    while (state.KeepRunning())
+    {
+        Creature* creature = (*creatures)[index];
+        Creature* other = (*creatures)[(index * 7 + 1) % creatures->size()];
+        Creature* nearest = nullptr;
+        MaNGOS::NearestCreatureEntryWithLiveStateInObjectRangeCheck check(*creature, other->GetEntry(), true, false, radius, true);
+        MaNGOS::CreatureLastSearcher<MaNGOS::NearestCreatureEntryWithLiveStateInObjectRangeCheck> searcher(nearest, check);
+        Cell::VisitGridObjects(creature, searcher, radius);
+        DoNotOptimize(nearest);
+        index = (index + 1) % creatures->size();
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_CellVisitNearestCreatureEntry)->Arg(10)->Arg(30)->Arg(100)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// gameobjects in range of the focus object, callable by the generic and the gameobject searchers
+class GameObjectInObjectRangeCheck
+{
+    public:
+        GameObjectInObjectRangeCheck(WorldObject const& obj, float range) : i_obj(obj), i_range(range) {}
+        WorldObject const& GetFocusObject() const { return i_obj; }
+        bool operator()(WorldObject* obj) const
+        {
+            return obj->GetTypeId() == TYPEID_GAMEOBJECT && i_obj.IsWithinDistInMap(obj, i_range);
+        }
+
+    private:
+        WorldObject const& i_obj;
+        float i_range;
+};
+
+// the generic searcher walks the cells of both containers and tests the type of every object
+static void BM_CellVisitGameObjectsGeneric(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    float const radius = float(state.GetArg());
+    size_t index = 0;
+    uint64 found = 0;
+    while (state.KeepRunning())
+    {
+        Creature* creature = (*creatures)[index];
+        WorldObjectList objects;
+        GameObjectInObjectRangeCheck check(*creature, radius);
+        MaNGOS::WorldObjectListSearcher<GameObjectInObjectRangeCheck> searcher(objects, check);
+        Cell::VisitAllObjects(creature, searcher, radius);
+        found += objects.size();
+        index = (index + 1) % creatures->size();
+    }
+    state.SetItemsProcessed(found);
+}
+BENCHMARK(BM_CellVisitGameObjectsGeneric)->Arg(10)->Arg(30)->Arg(100)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// the same search by the gameobject searcher, only the cells of the grid objects are walked
+static void BM_CellVisitGameObjectsTyped(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    float const radius = float(state.GetArg());
+    size_t index = 0;
+    uint64 found = 0;
+    while (state.KeepRunning())
+    {
+        Creature* creature = (*creatures)[index];
+        GameObjectList objects;
+        GameObjectInObjectRangeCheck check(*creature, radius);
+        MaNGOS::GameObjectListSearcher<GameObjectInObjectRangeCheck> searcher(objects, check);
+        Cell::VisitAllObjects(creature, searcher, radius);
+        found += objects.size();
+        index = (index + 1) % creatures->size();
+    }
+    state.SetItemsProcessed(found);
+}
+BENCHMARK(BM_CellVisitGameObjectsTyped)->Arg(10)->Arg(30)->Arg(100)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// a threat list of the given size, each update changes the threat of one victim and selects again
+static void BM_ThreatManagerSelectVictim(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    size_t const victims = std::min<size_t>(size_t(state.GetArg()), creatures->size() - 1);
+    std::mt19937 random(1);
+    ThreatManager threat((*creatures)[0]);
+    for (size_t i = 1; i <= victims; ++i)
+        threat.addThreatDirectly((*creatures)[i], float(random() % 1000));
+
+    while (state.KeepRunning())
+    {
+        threat.addThreatDirectly((*creatures)[1 + random() % victims], float(random() % 100));
+        DoNotOptimize(threat.getHostileTarget());
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_ThreatManagerSelectVictim)->Arg(1)->Arg(10)->Arg(40)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// the loot of a kill, over all creature loot templates
+static void BM_LootTemplateProcess(BenchmarkState& state)
+{
+    std::vector<LootTemplate const*> templates;
+    for (auto itr = sCreatureStorage.getDataBegin<CreatureInfo>(); itr < sCreatureStorage.getDataEnd<CreatureInfo>(); ++itr)
+        if (itr->LootId && LootTemplates_Creature.HaveLootFor(itr->LootId))
+            templates.push_back(LootTemplates_Creature.GetLootFor(itr->LootId));
+
+    if (templates.empty())
+    {
+        state.SkipWithError("no creature loot templates loaded");
+        return;
+    }
+
+    size_t index = 0;
+    while (state.KeepRunning())
+    {
+        Loot loot(LOOT_CORPSE);
+        templates[index]->Process(loot, nullptr, LootTemplates_Creature, true);
+        DoNotOptimize(&loot);
+        index = (index + 1) % templates.size();
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_LootTemplateProcess)->Needs(BENCHMARK_FIXTURE_WORLD);
+
+// the real entries of creature_template, in the order of the spawns of the benchmark area
+static void BM_SQLStorageCreatureTemplate(BenchmarkState& state)
+{
+    std::vector<Creature*> const* creatures = GetAreaCreaturesOrSkip(state);
+    if (!creatures)
+        return;
+
+    std::vector<uint32> entries;
+    for (Creature* creature : *creatures)
+        entries.push_back(creature->GetEntry());
+
+    size_t index = 0;
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(sCreatureStorage.LookupEntry<CreatureInfo>(entries[index]));
+        index = (index + 1) % entries.size();
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+BENCHMARK(BM_SQLStorageCreatureTemplate)->Needs(BENCHMARK_FIXTURE_WORLD);
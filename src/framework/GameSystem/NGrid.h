@@ -87,7 +87,7 @@ class NGrid
         typedef Grid<ACTIVE_OBJECT, WORLD_OBJECT_TYPES, GRID_OBJECT_TYPES> GridType;
 
         NGrid(uint32 id, uint32 x, uint32 y, time_t expiry, bool unload = true)
-            : i_gridId(id), i_x(x), i_y(y), i_cellstate(GRID_STATE_INVALID), i_GridObjectDataLoaded(false)
+            : i_gridId(id), i_x(x), i_y(y), i_cellstate(GRID_STATE_INVALID), i_GridObjectDataLoaded(false), i_unloadedCells(0)
         {
             i_GridInfo = GridInfo(expiry, unload);
         }
@@ -120,6 +120,10 @@ class NGrid
         bool isGridObjectDataLoaded() const { return i_GridObjectDataLoaded; }
         void setGridObjectDataLoaded(bool pLoaded) { i_GridObjectDataLoaded = pLoaded; }
 
+        // cells already emptied by an unload spread over several updates, in the order x * N + y
+        uint32 GetUnloadedCells() const { return i_unloadedCells; }
+        void SetUnloadedCells(uint32 cells) { i_unloadedCells = cells; }
+
         GridInfo* getGridInfoRef() { return &i_GridInfo; }
         const TimeTracker& getTimeTracker() const { return i_GridInfo.getTimeTracker(); }
         bool getUnloadLock() const { return i_GridInfo.getUnloadLock(); }
@@ -194,6 +198,7 @@ class NGrid
         grid_state_t i_cellstate;
         GridType i_cells[N][N];
         bool i_GridObjectDataLoaded;
+        uint32 i_unloadedCells;
 };
 
 #endif
@@ -31,6 +31,12 @@
 // forward declaration
 template<class T, class Y> class TypeContainerVisitor;
 
+template<class T>
+struct VoidType
+{
+    typedef void type;
+};
+
 // visitor helper
 template<class VISITOR, class TYPE_CONTAINER>
 void VisitorHelper(VISITOR& v, TYPE_CONTAINER& c)
@@ -65,10 +71,49 @@ void VisitorHelper(VISITOR& v, TypeMapContainer<OBJECT_TYPES>& c)
     VisitorHelper(v, c.GetElements());
 }
 
+/*
+ * A visitor only handling some types lists them as VisitedTypes, all others are
+ * expected to visit anything. Walking a container holding none of the listed types
+ * is then known to be a no-op at compile time and is skipped by the callers.
+ */
+template<class VISITOR, class = void>
+struct VisitorTypes
+{
+    template<class OBJECT_TYPES>
+    struct Visits
+    {
+        static const bool value = true;
+    };
+};
+
+template<class VISITOR>
+struct VisitorTypes<VISITOR, typename VoidType<typename VISITOR::VisitedTypes>::type>
+{
+    template<class OBJECT_TYPES>
+    struct Visits
+    {
+        static const bool value = TypeListIntersects<typename VISITOR::VisitedTypes, OBJECT_TYPES>::value;
+    };
+};
+
+template<class VISITOR, class TYPE_CONTAINER>
+struct VisitorNeedsContainer
+{
+    static const bool value = true;
+};
+
+template<class VISITOR, class OBJECT_TYPES>
+struct VisitorNeedsContainer<VISITOR, TypeMapContainer<OBJECT_TYPES> >
+{
+    static const bool value = VisitorTypes<VISITOR>::template Visits<OBJECT_TYPES>::value;
+};
+
 template<class VISITOR, class TYPE_CONTAINER>
 class TypeContainerVisitor
 {
     public:
+        // false if the visitor handles none of the types of the container
+        static const bool IsNeeded = VisitorNeedsContainer<VISITOR, TYPE_CONTAINER>::value;
 
         TypeContainerVisitor(VISITOR& v)
             : i_visitor(v)
@@ -104,6 +104,14 @@ typedef void* MANGOS_LIBRARY_HANDLE;
 #  define ATTR_PRINTF(F,V)
 #endif // COMPILER == COMPILER_GNU
 
+// Built for the baseline and for AVX2 hosts with SIMD_DISPATCH, the loader picks the variant of the cpu once.
+// Only for kernels doing enough math per call to pay for the indirect call.
+#if defined(MANGOS_SIMD_DISPATCH)
+#  define MANGOS_SIMD_KERNEL __attribute__((target_clones("arch=haswell", "default")))
+#else
+#  define MANGOS_SIMD_KERNEL
+#endif
+
 typedef std::int64_t int64;
 typedef std::int32_t int32;
 typedef std::int16_t int16;
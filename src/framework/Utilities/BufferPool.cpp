@@ -0,0 +1,191 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BufferPool.h"
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+std::atomic<uint64> BufferPool::m_allocations(0);
+std::atomic<uint64> BufferPool::m_heapAllocations(0);
+std::atomic<uint64> BufferPool::m_heapBytes(0);
+
+struct BufferPool::Depot
+{
+    std::mutex lock;
+    std::vector<FreeBuffer*> batches[NUM_CLASSES];      // chains of a batch count of buffers
+    std::atomic<uint64> bytes{0};
+};
+
+struct BufferPool::ThreadCache
+{
+    FreeBuffer* buffers[NUM_CLASSES] = {};
+    size_t counts[NUM_CLASSES] = {};
+
+    ~ThreadCache();
+};
+
+// set once the cache of the thread is gone, buffers freed later by its thread locals go back to the heap
+static thread_local bool t_cacheDestroyed = false;
+
+BufferPool::ThreadCache::~ThreadCache()
+{
+    for (size_t i = 0; i < NUM_CLASSES; ++i)
+    {
+        while (FreeBuffer* buffer = buffers[i])
+        {
+            buffers[i] = buffer->next;
+            ::operator delete(buffer);
+        }
+    }
+    t_cacheDestroyed = true;
+}
+
+size_t BufferPool::GetClass(size_t size)
+{
+    size_t sizeClass = 0;
+    while (GetClassSize(sizeClass) < size)
+        ++sizeClass;
+    return sizeClass;
+}
+
+size_t BufferPool::GetBatchCount(size_t sizeClass)
+{
+    return std::max<size_t>(BATCH_BYTES >> (sizeClass + MIN_SIZE_SHIFT), 4);
+}
+
+BufferPool::ThreadCache* BufferPool::GetThreadCache()
+{
+    if (t_cacheDestroyed)
+        return nullptr;
+
+    static thread_local ThreadCache cache;
+    return &cache;
+}
+
+BufferPool::Depot& BufferPool::GetDepot()
+{
+    // never destroyed, buffers may still be freed by static destructors
+    static Depot* depot = new Depot();
+    return *depot;
+}
+
+void* BufferPool::Allocate(size_t size)
+{
+    m_allocations.fetch_add(1, std::memory_order_relaxed);
+    MemoryAccounting::Add(MEMORY_TAG_PACKETS, size);
+
+    if (!size || size > GetClassSize(NUM_CLASSES - 1))
+    {
+        m_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        m_heapBytes.fetch_add(size, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    size_t const sizeClass = GetClass(size);
+    if (ThreadCache* cache = GetThreadCache())
+    {
+        if (!cache->buffers[sizeClass])
+        {
+            Depot& depot = GetDepot();
+            std::lock_guard<std::mutex> lock(depot.lock);
+            if (!depot.batches[sizeClass].empty())
+            {
+                cache->buffers[sizeClass] = depot.batches[sizeClass].back();
+                cache->counts[sizeClass] = GetBatchCount(sizeClass);
+                depot.batches[sizeClass].pop_back();
+                depot.bytes -= GetBatchCount(sizeClass) * GetClassSize(sizeClass);
+            }
+        }
+
+        if (FreeBuffer* buffer = cache->buffers[sizeClass])
+        {
+            cache->buffers[sizeClass] = buffer->next;
+            --cache->counts[sizeClass];
+            return buffer;
+        }
+    }
+
+    m_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    m_heapBytes.fetch_add(GetClassSize(sizeClass), std::memory_order_relaxed);
+    return ::operator new(GetClassSize(sizeClass));
+}
+
+void BufferPool::Deallocate(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    MemoryAccounting::Remove(MEMORY_TAG_PACKETS, size);
+
+    ThreadCache* cache = GetThreadCache();
+    if (!size || size > GetClassSize(NUM_CLASSES - 1) || !cache)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    size_t const sizeClass = GetClass(size);
+    FreeBuffer* buffer = static_cast<FreeBuffer*>(ptr);
+    buffer->next = cache->buffers[sizeClass];
+    cache->buffers[sizeClass] = buffer;
+    ++cache->counts[sizeClass];
+
+    // two batches cached, move one to the depot or free it when the depot is full
+    size_t const batchCount = GetBatchCount(sizeClass);
+    if (cache->counts[sizeClass] < 2 * batchCount)
+        return;
+
+    FreeBuffer* batch = cache->buffers[sizeClass];
+    FreeBuffer* last = batch;
+    for (size_t i = 1; i < batchCount; ++i)
+        last = last->next;
+    cache->buffers[sizeClass] = last->next;
+    cache->counts[sizeClass] -= batchCount;
+    last->next = nullptr;
+
+    size_t const batchBytes = batchCount * GetClassSize(sizeClass);
+    Depot& depot = GetDepot();
+    {
+        std::lock_guard<std::mutex> lock(depot.lock);
+        if (depot.batches[sizeClass].size() * batchBytes < MAX_DEPOT_BYTES)
+        {
+            depot.batches[sizeClass].push_back(batch);
+            depot.bytes += batchBytes;
+            return;
+        }
+    }
+
+    while (batch)
+    {
+        FreeBuffer* next = batch->next;
+        ::operator delete(batch);
+        batch = next;
+    }
+}
+
+void BufferPool::GetStats(Stats& stats)
+{
+    stats.allocations = m_allocations.exchange(0);
+    stats.heapAllocations = m_heapAllocations.exchange(0);
+    stats.heapBytes = m_heapBytes.exchange(0);
+    stats.depotBytes = GetDepot().bytes;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_BUFFERPOOL_H
+#define MANGOS_BUFFERPOOL_H
+
+#include "Platform/Define.h"
+
+#include <atomic>
+#include <cstddef>
+
+// storage of byte buffers, sizes rounded up to a power of two from 64 bytes to 16 kB. every thread keeps
+// a few freed buffers of each size for its next allocations, the surplus goes in batches to a shared depot
+// where the other threads pick it up, so that buffers built on a thread and freed on another still cycle
+class BufferPool
+{
+    public:
+        static void* Allocate(size_t size);
+        static void Deallocate(void* ptr, size_t size);
+
+        struct Stats
+        {
+            uint64 allocations;                             // since the last call
+            uint64 heapAllocations;                         // since the last call, the pools had nothing of that size
+            uint64 heapBytes;                               // since the last call
+            uint64 depotBytes;                              // held by the shared depot now
+        };
+        static void GetStats(Stats& stats);
+
+    private:
+        static size_t const MIN_SIZE_SHIFT = 6;
+        static size_t const MAX_SIZE_SHIFT = 14;            // bigger buffers go to the heap
+        static size_t const NUM_CLASSES = MAX_SIZE_SHIFT - MIN_SIZE_SHIFT + 1;
+        static size_t const BATCH_BYTES = 64 * 1024;        // cached per thread and size, and moved at once to the depot
+        static size_t const MAX_DEPOT_BYTES = 4 * 1024 * 1024; // per size, more is freed
+
+        struct FreeBuffer
+        {
+            FreeBuffer* next;
+        };
+
+        struct ThreadCache;
+        struct Depot;
+
+        static size_t GetClass(size_t size);
+        static size_t GetClassSize(size_t sizeClass) { return size_t(1) << (sizeClass + MIN_SIZE_SHIFT); }
+        static size_t GetBatchCount(size_t sizeClass);
+
+        static ThreadCache* GetThreadCache();
+        static Depot& GetDepot();
+
+        static std::atomic<uint64> m_allocations;
+        static std::atomic<uint64> m_heapAllocations;
+        static std::atomic<uint64> m_heapBytes;
+};
+
+// std allocator on the buffer pool, for the storage of ByteBuffer
+template<class T>
+class BufferAllocator
+{
+    public:
+        typedef T value_type;
+
+        BufferAllocator() = default;
+        template<class U> BufferAllocator(BufferAllocator<U> const&) {}
+
+        T* allocate(size_t n) { return static_cast<T*>(BufferPool::Allocate(n * sizeof(T))); }
+        void deallocate(T* ptr, size_t n) { BufferPool::Deallocate(ptr, n * sizeof(T)); }
+
+        template<class U> bool operator==(BufferAllocator<U> const&) const { return true; }
+        template<class U> bool operator!=(BufferAllocator<U> const&) const { return false; }
+};
+
+#endif
@@ -18,9 +18,35 @@
 
 #include "EventProcessor.h"
 
+#include <cstring>
+#include <limits>
+
+// position of the lowest set bit, mask must not be 0
+static uint32 LowestBit(uint32 mask)
+{
+    uint32 bit = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+// execution order of the events, late events share the slot being executed with the current ones
+bool EventProcessor::ExecutesBefore(BasicEvent const* event, BasicEvent const* other)
+{
+    return event->m_execTime < other->m_execTime || (event->m_execTime == other->m_execTime && event->m_sequence < other->m_sequence);
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_wheelTime = 0;
+    m_nextEventTime = std::numeric_limits<uint64>::max();
+    m_sequence = 0;
+    memset(m_slots, 0, sizeof(m_slots));
+    m_usedSlots = 0;
     m_aborting = false;
 }
 
@@ -34,13 +60,45 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
+    // nothing due yet, the usual case
+    if (m_time < m_nextEventTime)
+        return;
+
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (m_usedSlots)
+    {
+        uint32 const distance = GetSlotDistance(GetSlot(m_wheelTime));
+        uint64 const slotTime = m_wheelTime + (uint64(distance) << SLOT_BITS);
+        if (slotTime > m_time)
+            break;
+
+        uint64 const slotEnd = slotTime + (1 << SLOT_BITS) - 1;
+        ExecuteSlot(GetSlot(slotTime), std::min(slotEnd, m_time), p_time);
+
+        // range of the current time is executed again at next update, with the late events added meanwhile
+        if (slotEnd >= m_time)
+        {
+            m_wheelTime = slotTime;
+            break;
+        }
+
+        m_wheelTime = slotEnd + 1;
+    }
+
+    // skipped slots were empty
+    m_wheelTime = std::max(m_wheelTime, m_time >> SLOT_BITS << SLOT_BITS);
+
+    UpdateNextEventTime();
+}
+
+void EventProcessor::ExecuteSlot(uint32 slot, uint64 until, uint32 p_time)
+{
+    // events added meanwhile until that time are executed too
+    BasicEvent* Event;
+    while ((Event = m_slots[slot]) && Event->m_execTime <= until)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        Unlink(Event);
 
         if (!Event->to_Abort)
         {
@@ -64,38 +122,41 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    for (uint32 slot = 0; slot < WHEEL_SIZE; ++slot)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        for (BasicEvent* event = m_slots[slot]; event;)
         {
-            delete i_old->second;
+            BasicEvent* next = event->m_next;
+
+            event->to_Abort = true;
+            event->Abort(m_time);
+            if (force || event->IsDeletable())
+            {
+                if (!force)                                 // need per-element cleanup
+                    Unlink(event);
+
+                delete event;
+            }
 
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            event = next;
         }
     }
 
     // fast clear event list (in force case)
     if (force)
-        m_events.clear();
+    {
+        memset(m_slots, 0, sizeof(m_slots));
+        m_usedSlots = 0;
+    }
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    if (event->m_owner != this)
+        return;
+
+    Unlink(event);
+    delete event;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,24 +165,117 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Event->m_sequence = ++m_sequence;
+    Schedule(Event);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != Event)
-            continue;
+    if (Event->m_owner != this)
+        return;
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
-    }
+    Unlink(Event);
+    Event->m_execTime = msTime;
+    Event->m_sequence = ++m_sequence;
+    Schedule(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::Schedule(BasicEvent* event)
+{
+    // late events go to the slot being executed, before the others
+    uint32 const slot = GetSlot(std::max(event->m_execTime, m_wheelTime));
+    BasicEvent*& head = m_slots[slot];
+    event->m_owner = this;
+    event->m_slot = slot;
+
+    m_nextEventTime = std::min(m_nextEventTime, event->m_execTime);
+
+    if (!head)
+    {
+        event->m_prev = event;
+        event->m_next = nullptr;
+        head = event;
+        m_usedSlots |= uint32(1) << slot;
+        return;
+    }
+
+    // mostly appended, the slot is sorted by execution order
+    BasicEvent* after = head->m_prev;
+    while (after != head && ExecutesBefore(event, after))
+        after = after->m_prev;
+
+    if (after == head && ExecutesBefore(event, head))
+    {
+        event->m_prev = head->m_prev;
+        event->m_next = head;
+        head->m_prev = event;
+        head = event;
+        return;
+    }
+
+    event->m_prev = after;
+    event->m_next = after->m_next;
+    if (after->m_next)
+        after->m_next->m_prev = event;
+    else
+        head->m_prev = event;
+    after->m_next = event;
+}
+
+void EventProcessor::Unlink(BasicEvent* event)
+{
+    BasicEvent*& head = m_slots[event->m_slot];
+
+    if (event == head)
+    {
+        head = event->m_next;
+        if (head)
+            head->m_prev = event->m_prev;
+        else
+            m_usedSlots &= ~(uint32(1) << event->m_slot);
+    }
+    else
+    {
+        event->m_prev->m_next = event->m_next;
+        if (event->m_next)
+            event->m_next->m_prev = event->m_prev;
+        else
+            head->m_prev = event->m_prev;
+    }
+
+    event->m_owner = nullptr;
+    event->m_prev = nullptr;
+    event->m_next = nullptr;
+}
+
+uint32 EventProcessor::GetSlotDistance(uint32 slot) const
+{
+    uint32 const rotated = slot ? (m_usedSlots >> slot) | (m_usedSlots << (WHEEL_SIZE - slot)) : m_usedSlots;
+    return LowestBit(rotated);
+}
+
+void EventProcessor::UpdateNextEventTime()
+{
+    if (!m_usedSlots)
+    {
+        m_nextEventTime = std::numeric_limits<uint64>::max();
+        return;
+    }
+
+    // the first used slot gives the time of its first event, the others are only known to come after their range starts
+    uint32 const slot = GetSlot(m_wheelTime);
+    uint32 const distance = GetSlotDistance(slot);
+    uint32 const firstSlot = (slot + distance) & WHEEL_MASK;
+    uint64 const firstTime = m_wheelTime + (uint64(distance) << SLOT_BITS);
+
+    uint32 const otherSlots = m_usedSlots & ~(uint32(1) << firstSlot);
+    uint64 next = otherSlots ? firstTime + (uint64(GetSlotDistance((firstSlot + 1) & WHEEL_MASK) + 1) << SLOT_BITS)
+        : firstTime + (uint64(WHEEL_SIZE) << SLOT_BITS);
+
+    m_nextEventTime = std::min(next, std::max(m_slots[firstSlot]->m_execTime, firstTime));
+}
@@ -21,16 +21,18 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <algorithm>
 
 // Note. All times are in milliseconds here.
 
+class EventProcessor;
+
 class BasicEvent
 {
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_addTime(0), m_execTime(0), m_owner(nullptr), m_prev(nullptr), m_next(nullptr), m_sequence(0), m_slot(0)
         {
         }
 
@@ -53,10 +55,21 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
-};
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+    private:
+        friend class EventProcessor;
 
+        // links of the timer wheel slot holding the event, filled by event handler
+        EventProcessor* m_owner;
+        BasicEvent* m_prev;                                 // the first event of a slot points to the last one
+        BasicEvent* m_next;
+        uint64 m_sequence;                                  // keeps events of the same time in insertion order
+        uint32 m_slot;
+};
+
+// events are kept in a timer wheel of 8 slots of 512 ms, a turn every 4 seconds. each slot holds the events
+// of its time range of every turn, sorted by time, so that an update only looks at slots whose range it went
+// through. events are linked into their slot through themselves, adding and removing one does not allocate
 class EventProcessor
 {
     public:
@@ -70,12 +83,45 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* event, uint64 msTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+        bool Empty() const { return !m_usedSlots; }
+
+        // calls func for every queued event, in no particular order
+        template<class F>
+        void ForEachEvent(F func) const
+        {
+            for (BasicEvent* head : m_slots)
+            {
+                for (BasicEvent* event = head; event;)
+                {
+                    BasicEvent* next = event->m_next;
+                    func(event);
+                    event = next;
+                }
+            }
+        }
 
     protected:
 
+        static uint32 const SLOT_BITS = 9;                  // 512 ms per slot
+        static uint32 const WHEEL_BITS = 3;
+        static uint32 const WHEEL_SIZE = 1 << WHEEL_BITS;
+        static uint32 const WHEEL_MASK = WHEEL_SIZE - 1;
+
+        static bool ExecutesBefore(BasicEvent const* event, BasicEvent const* other);
+        static uint32 GetSlot(uint64 time) { return uint32(time >> SLOT_BITS) & WHEEL_MASK; }
+
+        void ExecuteSlot(uint32 slot, uint64 until, uint32 p_time);
+        void Schedule(BasicEvent* event);
+        void Unlink(BasicEvent* event);
+        uint32 GetSlotDistance(uint32 slot) const;          // slots from the given one to the next used one, itself included
+        void UpdateNextEventTime();
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_wheelTime;                                 // start of the first slot range not fully executed
+        uint64 m_nextEventTime;                             // no event is due before this time
+        uint64 m_sequence;
+        BasicEvent* m_slots[WHEEL_SIZE];
+        uint32 m_usedSlots;
         bool m_aborting;
 };
 
@@ -0,0 +1,134 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MemoryAccounting.h"
+
+#include <cstdio>
+#include <new>
+
+#if defined(MANGOS_ALLOCATOR_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(MANGOS_ALLOCATOR_MIMALLOC)
+#include <mimalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if PLATFORM != PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+MemoryAccounting::TagCounters MemoryAccounting::m_counters[MAX_MEMORY_TAG];
+
+void* MemoryAccounting::Allocate(MemoryTag tag, size_t size)
+{
+    void* ptr = ::operator new(size);
+    Add(tag, size);
+    return ptr;
+}
+
+void MemoryAccounting::Deallocate(MemoryTag tag, void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    Remove(tag, size);
+    ::operator delete(ptr);
+}
+
+void MemoryAccounting::GetTagStats(MemoryTag tag, TagStats& stats)
+{
+    int64 bytes = m_counters[tag].bytes.load(std::memory_order_relaxed);
+    int64 allocations = m_counters[tag].allocations.load(std::memory_order_relaxed);
+    stats.bytes = bytes > 0 ? uint64(bytes) : 0;
+    stats.allocations = allocations > 0 ? uint64(allocations) : 0;
+    stats.totalAllocations = m_counters[tag].totalAllocations.load(std::memory_order_relaxed);
+}
+
+char const* MemoryAccounting::GetTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+        case MEMORY_TAG_MAPS:       return "maps";
+        case MEMORY_TAG_GRIDS:      return "grids";
+        case MEMORY_TAG_SPELLS:     return "spells";
+        case MEMORY_TAG_PACKETS:    return "packets";
+        case MEMORY_TAG_DB_RESULTS: return "db_results";
+    }
+    return "unknown";
+}
+
+char const* MemoryAccounting::GetAllocatorName()
+{
+#if defined(MANGOS_ALLOCATOR_JEMALLOC)
+    return "jemalloc";
+#elif defined(MANGOS_ALLOCATOR_MIMALLOC)
+    return "mimalloc";
+#else
+    return "default";
+#endif
+}
+
+bool MemoryAccounting::GetAllocatorStats(AllocatorStats& stats)
+{
+    stats.allocatedBytes = 0;
+    stats.committedBytes = 0;
+    stats.residentBytes = 0;
+
+#if PLATFORM != PLATFORM_WINDOWS && !defined(__APPLE__)
+    // second field is the resident set, in pages
+    if (FILE* statm = fopen("/proc/self/statm", "r"))
+    {
+        unsigned long long size, resident;
+        if (fscanf(statm, "%llu %llu", &size, &resident) == 2)
+            stats.residentBytes = uint64(resident) * sysconf(_SC_PAGESIZE);
+        fclose(statm);
+    }
+#endif
+
+#if defined(MANGOS_ALLOCATOR_JEMALLOC)
+    // the statistics are cached until the epoch is advanced
+    uint64_t epoch = 1;
+    size_t length = sizeof(epoch);
+    mallctl("epoch", &epoch, &length, &epoch, length);
+
+    size_t allocated = 0, active = 0;
+    length = sizeof(size_t);
+    if (mallctl("stats.allocated", &allocated, &length, nullptr, 0) || mallctl("stats.active", &active, &length, nullptr, 0))
+        return false;
+
+    stats.allocatedBytes = allocated;
+    stats.committedBytes = active;
+    return true;
+#elif defined(MANGOS_ALLOCATOR_MIMALLOC)
+    size_t elapsed, user, system, currentRss, peakRss, currentCommit, peakCommit, pageFaults;
+    mi_process_info(&elapsed, &user, &system, &currentRss, &peakRss, &currentCommit, &peakCommit, &pageFaults);
+
+    // mimalloc does not count the bytes given out without its own statistics build
+    stats.allocatedBytes = currentCommit;
+    stats.committedBytes = currentCommit;
+    return true;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    stats.allocatedBytes = info.uordblks + info.hblkhd;
+    stats.committedBytes = info.arena + info.hblkhd;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MEMORYACCOUNTING_H
+#define MANGOS_MEMORYACCOUNTING_H
+
+#include "Platform/Define.h"
+
+#include <atomic>
+#include <cstddef>
+
+enum MemoryTag
+{
+    MEMORY_TAG_MAPS         = 0,                            // map objects
+    MEMORY_TAG_GRIDS        = 1,                            // creatures and gameobjects, loaded and unloaded with their grid
+    MEMORY_TAG_SPELLS       = 2,                            // spell casts
+    MEMORY_TAG_PACKETS      = 3,                            // storage of the byte buffers, mostly packets
+    MEMORY_TAG_DB_RESULTS   = 4,                            // query results
+};
+
+#define MAX_MEMORY_TAG 5
+
+// bytes and allocations of the major subsystems, counted where their objects are allocated. only the
+// objects and buffers themselves are counted, not what they hold in containers of their own
+class MemoryAccounting
+{
+    public:
+        static void Add(MemoryTag tag, size_t size)
+        {
+            TagCounters& counters = m_counters[tag];
+            counters.bytes.fetch_add(int64(size), std::memory_order_relaxed);
+            counters.allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void Remove(MemoryTag tag, size_t size)
+        {
+            TagCounters& counters = m_counters[tag];
+            counters.bytes.fetch_sub(int64(size), std::memory_order_relaxed);
+            counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // plain heap allocation counted under the tag, for class level operator new and delete
+        static void* Allocate(MemoryTag tag, size_t size);
+        static void Deallocate(MemoryTag tag, void* ptr, size_t size);
+
+        struct TagStats
+        {
+            uint64 bytes;                                   // in use now
+            uint64 allocations;                             // in use now
+            uint64 totalAllocations;                        // since the start
+        };
+        static void GetTagStats(MemoryTag tag, TagStats& stats);
+        static char const* GetTagName(MemoryTag tag);
+
+        // whole process, as far as the allocator backend the server was built with tells
+        struct AllocatorStats
+        {
+            uint64 allocatedBytes;                          // given to the program
+            uint64 committedBytes;                          // held by the allocator, free blocks included
+            uint64 residentBytes;                           // of the process, 0 if unknown
+        };
+        static char const* GetAllocatorName();
+        static bool GetAllocatorStats(AllocatorStats& stats);
+
+    private:
+        // a cache line each, the tags are counted from all threads. signed, as a free counted on a thread
+        // may be seen before the allocation counted on another
+        struct alignas(64) TagCounters
+        {
+            std::atomic<int64> bytes;
+            std::atomic<int64> allocations;
+            std::atomic<uint64> totalAllocations;
+        };
+
+        static TagCounters m_counters[MAX_MEMORY_TAG];
+};
+
+#endif
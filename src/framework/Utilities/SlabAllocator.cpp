@@ -0,0 +1,119 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "SlabAllocator.h"
+
+#include <algorithm>
+#include <new>
+
+// chunks of 64 kB, or of a few blocks for big objects
+#define SLAB_CHUNK_SIZE         (64 * 1024)
+#define SLAB_MIN_CHUNK_BLOCKS   8
+
+std::atomic<uint64> SlabAllocator::m_reservedBytes(0);
+std::atomic<uint64> SlabAllocator::m_usedBytes(0);
+
+SlabPool::SlabPool(size_t blockSize) : m_blockSize(blockSize),
+    m_blocksPerChunk(std::max<size_t>(SLAB_CHUNK_SIZE / blockSize, SLAB_MIN_CHUNK_BLOCKS)), m_freeBlocks(nullptr)
+{
+}
+
+void* SlabPool::Allocate()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    if (!m_freeBlocks)
+        AddChunk();
+
+    FreeBlock* block = m_freeBlocks;
+    m_freeBlocks = block->next;
+    return block;
+}
+
+void SlabPool::Deallocate(void* ptr)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = m_freeBlocks;
+    m_freeBlocks = block;
+}
+
+void SlabPool::AddChunk()
+{
+    char* chunk = new char[m_blockSize * m_blocksPerChunk];
+    m_chunks.emplace_back(chunk);
+
+    // chain the blocks in address order, so consecutive allocations stay close in memory
+    for (size_t i = m_blocksPerChunk; i > 0; --i)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+        block->next = m_freeBlocks;
+        m_freeBlocks = block;
+    }
+
+    SlabAllocator::m_reservedBytes += m_blockSize * m_blocksPerChunk;
+}
+
+SlabPool* SlabAllocator::GetPool(size_t size)
+{
+    static std::unique_ptr<SlabPool> pools[MAX_POOLED_SIZE / GRANULARITY];
+    static std::mutex poolsLock;
+
+    size_t index = (size - 1) / GRANULARITY;
+    std::lock_guard<std::mutex> lock(poolsLock);
+    if (!pools[index])
+        pools[index].reset(new SlabPool((index + 1) * GRANULARITY));
+    return pools[index].get();
+}
+
+void* SlabAllocator::Allocate(size_t size, MemoryTag tag)
+{
+    MemoryAccounting::Add(tag, size);
+
+    if (!size || size > MAX_POOLED_SIZE)
+        return ::operator new(size);
+
+    SlabPool* pool = GetPool(size);
+    m_usedBytes += pool->GetBlockSize();
+    return pool->Allocate();
+}
+
+void SlabAllocator::Deallocate(void* ptr, size_t size, MemoryTag tag)
+{
+    if (!ptr)
+        return;
+
+    MemoryAccounting::Remove(tag, size);
+
+    if (!size || size > MAX_POOLED_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    SlabPool* pool = GetPool(size);
+    m_usedBytes -= pool->GetBlockSize();
+    pool->Deallocate(ptr);
+}
+
+void SlabAllocator::GetStats(uint64& reservedBytes, uint64& usedBytes)
+{
+    reservedBytes = m_reservedBytes;
+    usedBytes = m_usedBytes;
+}
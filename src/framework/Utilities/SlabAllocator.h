@@ -0,0 +1,83 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SLABALLOCATOR_H
+#define MANGOS_SLABALLOCATOR_H
+
+#include "Platform/Define.h"
+#include "Utilities/MemoryAccounting.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// equally sized blocks carved from large chunks. freed blocks are kept for the next object of the
+// same size instead of going back to the heap, chunks are only released with the pool
+class SlabPool
+{
+    public:
+        explicit SlabPool(size_t blockSize);
+        SlabPool(SlabPool const&) = delete;
+
+        void* Allocate();
+        void Deallocate(void* ptr);
+
+        size_t GetBlockSize() const { return m_blockSize; }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void AddChunk();
+
+        size_t const m_blockSize;
+        size_t const m_blocksPerChunk;
+
+        std::mutex m_lock;
+        FreeBlock* m_freeBlocks;
+        std::vector<std::unique_ptr<char[]>> m_chunks;
+};
+
+// sized storage for objects spawned and deleted over and over, like creatures and gameobjects loaded
+// and unloaded with their grid, so that a long running server does not fragment its heap with them.
+// meant for class level operator new and delete, sizes are rounded up and each rounded size has its pool
+class SlabAllocator
+{
+    public:
+        static void* Allocate(size_t size, MemoryTag tag);
+        static void Deallocate(void* ptr, size_t size, MemoryTag tag);
+
+        // bytes held by the pools and bytes actually given to objects
+        static void GetStats(uint64& reservedBytes, uint64& usedBytes);
+
+    private:
+        static size_t const GRANULARITY = 64;
+        static size_t const MAX_POOLED_SIZE = 16 * 1024;    // bigger objects go to the heap
+
+        static SlabPool* GetPool(size_t size);
+
+        static std::atomic<uint64> m_reservedBytes;
+        static std::atomic<uint64> m_usedBytes;
+
+        friend class SlabPool;
+};
+
+#endif
@@ -41,4 +41,36 @@ struct TypeList
 #define TYPELIST_4(T1, T2, T3, T4)     TypeList<T1, TYPELIST_3(T2, T3, T4) >
 #define TYPELIST_5(T1, T2, T3, T4, T5) TypeList<T1, TYPELIST_4(T2, T3, T4, T5) >
 
+// true if TYPE is one of the types of LIST
+template<typename LIST, typename TYPE>
+struct TypeListContains
+{
+    static const bool value = false;
+};
+
+template<typename TAIL, typename TYPE>
+struct TypeListContains<TypeList<TYPE, TAIL>, TYPE>
+{
+    static const bool value = true;
+};
+
+template<typename HEAD, typename TAIL, typename TYPE>
+struct TypeListContains<TypeList<HEAD, TAIL>, TYPE>
+{
+    static const bool value = TypeListContains<TAIL, TYPE>::value;
+};
+
+// true if any type of LIST is also one of OTHER
+template<typename LIST, typename OTHER>
+struct TypeListIntersects
+{
+    static const bool value = false;
+};
+
+template<typename HEAD, typename TAIL, typename OTHER>
+struct TypeListIntersects<TypeList<HEAD, TAIL>, OTHER>
+{
+    static const bool value = TypeListContains<OTHER, HEAD>::value || TypeListIntersects<TAIL, OTHER>::value;
+};
+
 #endif
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_UTF8SCAN_H
+#define MANGOS_UTF8SCAN_H
+
+#include "Platform/Define.h"
+
+#include <cstring>
+#include <utf8.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MANGOS_UTF8SCAN_SSE2
+#endif
+
+/**
+ * Scanning of utf8 text by blocks instead of characters. Chat, names and searches are nearly all
+ * ascii, the ascii runs are skipped 16 bytes at a time and only the other characters are decoded.
+ */
+namespace MaNGOS
+{
+    // number of bytes at the start of str below 0x80
+    inline size_t Utf8AsciiPrefix(char const* str, size_t size)
+    {
+        size_t i = 0;
+#ifdef MANGOS_UTF8SCAN_SSE2
+        for (; i + 16 <= size; i += 16)
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(str + i))))
+                break;
+#else
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64 word;
+            memcpy(&word, str + i, sizeof(word));
+            if (word & 0x8080808080808080ULL)
+                break;
+        }
+#endif
+        while (i < size && !(uint8(str[i]) & 0x80))
+            ++i;
+        return i;
+    }
+
+    inline bool Utf8IsAscii(char const* str, size_t size) { return Utf8AsciiPrefix(str, size) == size; }
+
+    // calls visitor(code point) for each character that is not ascii and visitAscii(begin, count) for
+    // the ascii runs; false on an invalid sequence, the visitors may have been called up to it
+    template<class AsciiVisitor, class CodePointVisitor>
+    inline bool Utf8Scan(char const* str, size_t size, AsciiVisitor&& visitAscii, CodePointVisitor&& visitor)
+    {
+        char const* const end = str + size;
+        while (str < end)
+        {
+            size_t ascii = Utf8AsciiPrefix(str, end - str);
+            if (ascii)
+            {
+                visitAscii(str, ascii);
+                str += ascii;
+                if (str == end)
+                    break;
+            }
+
+            uint32_t codePoint;
+            if (utf8::internal::validate_next(str, end, codePoint) != utf8::internal::UTF8_OK)
+                return false;
+            visitor(codePoint);
+        }
+        return true;
+    }
+
+    inline bool Utf8IsValid(char const* str, size_t size)
+    {
+        return Utf8Scan(str, size, [](char const*, size_t) {}, [](uint32_t) {});
+    }
+}
+
+#endif
@@ -32,6 +32,8 @@
 #include "Spells/Spell.h"
 #include "MotionGenerators/MovementGenerator.h"
 
+#include <limits>
+
 bool CreatureEventAIHolder::UpdateRepeatTimer(Creature* creature, uint32 repeatMin, uint32 repeatMax)
 {
     if (repeatMin == repeatMax)
@@ -72,6 +74,9 @@ void CreatureEventAI::GetAIInformation(ChatHandler& reader)
     if (sLog.HasLogFilter(LOG_FILTER_EVENT_AI_DEV))         // Give some more details if in EventAI Dev Mode
         return;
 
+    // timers are decremented lazily while nothing is due
+    DecrementEventTimers();
+
     reader.PSendSysMessage("Current events of this creature:");
     for (CreatureEventAIList::const_iterator itr = m_CreatureEventAIList.begin(); itr != m_CreatureEventAIList.end(); ++itr)
     {
@@ -94,6 +99,9 @@ inline bool IsEventFlagsFitForNormalMap(uint8 eFlags)
 CreatureEventAI::CreatureEventAI(Creature* creature) : CreatureAI(creature),
     m_EventUpdateTime(0),
     m_EventDiff(0),
+    m_nextEventTimer(0),
+    m_nextEventTimerInCombat(false),
+    m_eventTypeMask(0),
     m_depth(0),
     m_Phase(0),
     m_HasOOCLoSEvent(false),
@@ -178,6 +186,7 @@ void CreatureEventAI::InitAI()
                 if (storeEvent)
                 {
                     m_CreatureEventAIList.push_back(CreatureEventAIHolder(i));
+                    m_eventTypeMask |= uint64(1) << i.event_type;
                     // Cache for fast use
                     if (i.event_type == EVENT_T_OOC_LOS)
                         m_HasOOCLoSEvent = true;
@@ -1391,6 +1400,7 @@ void CreatureEventAI::JustRespawned()                       // NOTE that this is
         SetReactState(REACT_AGGRESSIVE);
     m_EventUpdateTime = EVENT_UPDATE_TIME;
     m_EventDiff = 0;
+    m_nextEventTimer = 0;
     m_throwAIEventStep = 0;
     m_LastSpellMaxRange = 0;
 
@@ -1423,7 +1433,7 @@ void CreatureEventAI::JustRespawned()                       // NOTE that this is
 void CreatureEventAI::Reset()
 {
     m_EventUpdateTime = EVENT_UPDATE_TIME;
-    m_EventDiff = 0;
+    DecrementEventTimers();
     m_throwAIEventStep = 0;
     m_LastSpellMaxRange = 0;
     m_currentRangedMode = m_rangedMode;
@@ -1459,13 +1469,17 @@ void CreatureEventAI::Reset()
 
 void CreatureEventAI::JustReachedHome()
 {
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_REACHED_HOME))
     {
-        if (i.event.event_type == EVENT_T_REACHED_HOME)
-            CheckAndReadyEventForExecution(i);
+        DecrementEventTimers();
+        IncreaseDepthIfNecessary();
+        for (auto& i : m_CreatureEventAIList)
+        {
+            if (i.event.event_type == EVENT_T_REACHED_HOME)
+                CheckAndReadyEventForExecution(i);
+        }
+        ProcessEvents();
     }
-    ProcessEvents();
 
     Reset();
 }
@@ -1475,13 +1489,17 @@ void CreatureEventAI::EnterEvadeMode()
     UnitAI::EnterEvadeMode();
 
     // Handle Evade events
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_EVADE))
     {
-        if (i.event.event_type == EVENT_T_EVADE)
-            CheckAndReadyEventForExecution(i);
+        DecrementEventTimers();
+        IncreaseDepthIfNecessary();
+        for (auto& i : m_CreatureEventAIList)
+        {
+            if (i.event.event_type == EVENT_T_EVADE)
+                CheckAndReadyEventForExecution(i);
+        }
+        ProcessEvents();
     }
-    ProcessEvents();
 
     if ((m_despawnAggregationMask & AGGREGATION_EVADE) != 0)
         DespawnGuids(m_despawnGuids);
@@ -1495,13 +1513,17 @@ void CreatureEventAI::JustDied(Unit* killer)
         SendAIEventAround(AI_EVENT_JUST_DIED, killer, 0, AIEVENT_DEFAULT_THROW_RADIUS);
 
     // Handle On Death events
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_DEATH))
     {
-        if (i.event.event_type == EVENT_T_DEATH)
-            CheckAndReadyEventForExecution(i, killer);
+        DecrementEventTimers();
+        IncreaseDepthIfNecessary();
+        for (auto& i : m_CreatureEventAIList)
+        {
+            if (i.event.event_type == EVENT_T_DEATH)
+                CheckAndReadyEventForExecution(i, killer);
+        }
+        ProcessEvents(killer);
     }
-    ProcessEvents(killer);
 
     // reset phase after any death state events
     m_Phase = 0;
@@ -1512,6 +1534,10 @@ void CreatureEventAI::JustDied(Unit* killer)
 
 void CreatureEventAI::KilledUnit(Unit* victim)
 {
+    if (!HasEventType(EVENT_T_KILL))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
     {
@@ -1523,13 +1549,17 @@ void CreatureEventAI::KilledUnit(Unit* victim)
 
 void CreatureEventAI::JustSummoned(Creature* summoned)
 {
-    IncreaseDepthIfNecessary();
-    for (auto& i : m_CreatureEventAIList)
+    if (HasEventType(EVENT_T_SUMMONED_UNIT))
     {
-        if (i.event.event_type == EVENT_T_SUMMONED_UNIT)
-            CheckAndReadyEventForExecution(i, summoned);
+        DecrementEventTimers();
+        IncreaseDepthIfNecessary();
+        for (auto& i : m_CreatureEventAIList)
+        {
+            if (i.event.event_type == EVENT_T_SUMMONED_UNIT)
+                CheckAndReadyEventForExecution(i, summoned);
+        }
+        ProcessEvents(summoned);
     }
-    ProcessEvents(summoned);
     if ((m_despawnAggregationMask & AGGREGATION_ENABLED) != 0)
         if (m_entriesForDespawn.empty() || m_entriesForDespawn.find(summoned->GetEntry()) != m_entriesForDespawn.end())
             m_despawnGuids.push_back(summoned->GetObjectGuid());
@@ -1537,6 +1567,10 @@ void CreatureEventAI::JustSummoned(Creature* summoned)
 
 void CreatureEventAI::SummonedCreatureJustDied(Creature* summoned)
 {
+    if (!HasEventType(EVENT_T_SUMMONED_JUST_DIED))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
     {
@@ -1548,6 +1582,10 @@ void CreatureEventAI::SummonedCreatureJustDied(Creature* summoned)
 
 void CreatureEventAI::SummonedCreatureDespawn(Creature* summoned)
 {
+    if (!HasEventType(EVENT_T_SUMMONED_JUST_DESPAWN))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
     {
@@ -1561,6 +1599,10 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Unit* sender, Unit*
 {
     MANGOS_ASSERT(sender);
 
+    if (!HasEventType(EVENT_T_RECEIVE_AI_EVENT))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& itr : m_CreatureEventAIList)
     {
@@ -1574,6 +1616,7 @@ void CreatureEventAI::ReceiveAIEvent(AIEventType eventType, Unit* sender, Unit*
 void CreatureEventAI::EnterCombat(Unit* enemy)
 {
     // Check for on combat start events
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
     {
@@ -1605,6 +1648,7 @@ void CreatureEventAI::EnterCombat(Unit* enemy)
 
     m_EventUpdateTime = EVENT_UPDATE_TIME;
     m_EventDiff = 0;
+    m_nextEventTimer = 0;
 
     UnitAI::EnterCombat(enemy);
 }
@@ -1612,9 +1656,10 @@ void CreatureEventAI::EnterCombat(Unit* enemy)
 void CreatureEventAI::MoveInLineOfSight(Unit* who)
 {
     // Check for OOC LOS Event
-    IncreaseDepthIfNecessary();
     if (m_HasOOCLoSEvent && !m_creature->GetVictim())
     {
+        DecrementEventTimers();
+        IncreaseDepthIfNecessary();
         for (auto& itr : m_CreatureEventAIList)
         {
             if (itr.event.event_type == EVENT_T_OOC_LOS)
@@ -1644,6 +1689,10 @@ void CreatureEventAI::MoveInLineOfSight(Unit* who)
 
 void CreatureEventAI::SpellHit(Unit* unit, const SpellEntry* spellInfo)
 {
+    if (!HasEventType(EVENT_T_SPELLHIT))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
         if (i.event.event_type == EVENT_T_SPELLHIT)
@@ -1657,6 +1706,10 @@ void CreatureEventAI::SpellHit(Unit* unit, const SpellEntry* spellInfo)
 
 void CreatureEventAI::SpellHitTarget(Unit* target, const SpellEntry* spellInfo)
 {
+    if (!HasEventType(EVENT_T_SPELLHIT_TARGET))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
         if (i.event.event_type == EVENT_T_SPELLHIT_TARGET)
@@ -1855,6 +1908,10 @@ void CreatureEventAI::DoFindFriendlyMissingBuff(CreatureList& list, float range,
 
 void CreatureEventAI::ReceiveEmote(Player* player, uint32 textEmote)
 {
+    if (!HasEventType(EVENT_T_RECEIVE_EMOTE))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& itr : m_CreatureEventAIList)
     {
@@ -1905,6 +1962,10 @@ void CreatureEventAI::DamageTaken(Unit* dealer, uint32& damage, DamageEffectType
 
 void CreatureEventAI::JustPreventedDeath(Unit* attacker)
 {
+    if (!HasEventType(EVENT_T_DEATH_PREVENTED))
+        return;
+
+    DecrementEventTimers();
     IncreaseDepthIfNecessary();
     for (auto& i : m_CreatureEventAIList)
         if (i.event.event_type == EVENT_T_DEATH_PREVENTED)
@@ -1954,41 +2015,99 @@ bool CreatureEventAI::SpawnedEventConditionsCheck(CreatureEventAI_Event const& e
     return false;
 }
 
+void CreatureEventAI::DecrementEventTimers()
+{
+    if (m_EventDiff)
+    {
+        for (auto& i : m_CreatureEventAIList)
+        {
+            // Do not decrement timers if event cannot trigger in this phase
+            if (i.timer && !(i.event.event_inverse_phase_mask & (1 << m_Phase)))
+                i.timer = i.timer > m_EventDiff ? i.timer - m_EventDiff : 0;
+        }
+        m_EventDiff = 0;
+    }
+
+    // events are about to be checked, the next timer has to be found again afterwards
+    m_nextEventTimer = 0;
+}
+
+bool CreatureEventAI::IsTimerExecutedEventIdle(CreatureEventAI_Event const& event, bool inCombat) const
+{
+    switch (event.event_type)
+    {
+        case EVENT_T_TIMER_OOC:
+            return inCombat;
+        case EVENT_T_HP:
+            return !inCombat && !event.percent_range.allowOutOfCombat;
+        case EVENT_T_TIMER_IN_COMBAT:
+        case EVENT_T_MANA:
+        case EVENT_T_RANGE:
+        case EVENT_T_TARGET_HP:
+        case EVENT_T_TARGET_CASTING:
+        case EVENT_T_FRIENDLY_HP:
+        case EVENT_T_FRIENDLY_IS_CC:
+        case EVENT_T_TARGET_MANA:
+        case EVENT_T_TARGET_AURA:
+        case EVENT_T_TARGET_MISSING_AURA:
+        case EVENT_T_ENERGY:
+        case EVENT_T_FACING_TARGET:
+            return !inCombat;
+        default:
+            return false;
+    }
+}
+
+void CreatureEventAI::ScheduleNextEventTimer()
+{
+    bool const inCombat = m_creature->IsInCombat();
+    uint32 next = std::numeric_limits<uint32>::max();
+    for (auto const& i : m_CreatureEventAIList)
+    {
+        // timers of events that cannot trigger in this phase are not running
+        if (i.event.event_inverse_phase_mask & (1 << m_Phase))
+            continue;
+
+        if (i.timer)
+            next = std::min(next, i.timer);
+        else if (i.enabled && IsTimerExecutedEvent(i.event.event_type) && !IsTimerExecutedEventIdle(i.event, inCombat))
+        {
+            next = 0;                                       // checked on every update
+            break;
+        }
+    }
+
+    m_nextEventTimer = next;
+    m_nextEventTimerInCombat = inCombat;
+}
+
 void CreatureEventAI::UpdateEventTimers(const uint32 diff)
 {
     // Events are only updated once every EVENT_UPDATE_TIME ms to prevent lag with large amount of events
     if (m_EventUpdateTime < diff)
     {
         m_EventDiff += diff;
+        m_EventUpdateTime = EVENT_UPDATE_TIME;
+
+        // Nothing can trigger before the next timer expires, events changing that go through a hook that resets it
+        if (m_EventDiff < m_nextEventTimer && m_creature->IsInCombat() == m_nextEventTimerInCombat)
+            return;
 
         // Check for time based events
+        DecrementEventTimers();
         IncreaseDepthIfNecessary();
-        for (CreatureEventAIList::iterator i = m_CreatureEventAIList.begin(); i != m_CreatureEventAIList.end(); ++i)
+        for (auto& i : m_CreatureEventAIList)
         {
-            // Decrement Timers
-            if (i->timer)
-            {
-                // Do not decrement timers if event cannot trigger in this phase
-                if (!(i->event.event_inverse_phase_mask & (1 << m_Phase)))
-                {
-                    if (i->timer > m_EventDiff)
-                        i->timer -= m_EventDiff;
-                    else
-                        i->timer = 0;
-                }
-            }
-
             // Skip processing of events that have time remaining or are disabled
-            if (!(i->enabled) || i->timer)
+            if (!i.enabled || i.timer)
                 continue;
 
-            if (IsTimerExecutedEvent(i->event.event_type))
-                CheckAndReadyEventForExecution(*i);
+            if (IsTimerExecutedEvent(i.event.event_type))
+                CheckAndReadyEventForExecution(i);
         }
         ProcessEvents();
 
-        m_EventDiff = 0;
-        m_EventUpdateTime = EVENT_UPDATE_TIME;
+        ScheduleNextEventTimer();
     }
     else
     {
@@ -855,6 +855,8 @@ class CreatureEventAI : public CreatureAI
         static int Permissible(const Creature* creature);
 
         void UpdateEventTimers(const uint32 diff);
+        void DecrementEventTimers();
+        void ScheduleNextEventTimer();
         void ProcessEvents(Unit* actionInvoker = nullptr, Unit* AIEventSender = nullptr);
         bool CheckEvent(CreatureEventAIHolder& holder, Unit* actionInvoker = nullptr, Unit* AIEventSender = nullptr);
         void ResetEvent(CreatureEventAIHolder& holder);
@@ -894,11 +896,17 @@ class CreatureEventAI : public CreatureAI
         bool IsTimerExecutedEvent(EventAI_Type type) const;
         bool IsRepeatableEvent(EventAI_Type type) const;
         bool IsTimerBasedEvent(EventAI_Type type) const;
+        // Timer executed event that cannot pass its check in this combat state, entering or leaving combat is noticed
+        bool IsTimerExecutedEventIdle(CreatureEventAI_Event const& event, bool inCombat) const;
+        bool HasEventType(EventAI_Type type) const { return (m_eventTypeMask & (uint64(1) << type)) != 0; }
         // Event rules specifiers end
         void DistanceYourself();
 
         uint32 m_EventUpdateTime;                           // Time between event updates
         uint32 m_EventDiff;                                 // Time between the last event call
+        uint32 m_nextEventTimer;                            // Time until the first running timer expires, 0 to check events on every update
+        bool   m_nextEventTimerInCombat;                    // Combat state m_nextEventTimer was computed in
+        uint64 m_eventTypeMask;                             // Bit per EventAI_Type present in m_CreatureEventAIList, hooks of absent types do nothing
 
         // Variables used by Events themselves
         typedef std::vector<CreatureEventAIHolder> CreatureEventAIList;
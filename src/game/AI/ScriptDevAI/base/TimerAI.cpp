@@ -18,108 +18,93 @@
 #include "Chat/Chat.h"
 #include <string>
 
-Timer::Timer(uint32 id, std::function<void()> functor, uint32 timerMin, uint32 timerMax, bool disabled)
-    : id(id), timer(urand(timerMin, timerMax)), disabled(disabled), functor(functor), initialMin(timerMin), initialMax(timerMax), initialDisabled(disabled)
+Timer::Timer(uint32 id, uint32 timerMin, uint32 timerMax, bool disabled)
+    : id(id), dueTime(0), disabled(disabled), initialMin(timerMin), initialMax(timerMax), initialDisabled(disabled)
     {}
 
-bool Timer::UpdateTimer(const uint32 diff)
+void TimerManager::AddTimer(uint32 id, ActionTimer&& timer)
 {
-    if (disabled)
-        return false;
-
-    if (timer <= diff)
-    {
-        timer = 0;
-        disabled = true;
-        return true;
-    }
-    else timer -= diff;
-
-    return false;
+    m_clock.Reset(timer);
+    m_timers.emplace(id, std::move(timer));
 }
 
-void Timer::ResetTimer()
+void TimerManager::AddCustomAction(uint32 id, bool disabled, std::function<void()> functor)
 {
-    timer = urand(initialMin, initialMax);
-    disabled = initialDisabled;
+    AddTimer(id, ActionTimer(id, std::move(functor), 0, 0, disabled));
 }
 
-bool CombatTimer::UpdateTimer(const uint32 diff, bool combat)
-{
-    if (disabled)
-        return false;
-
-    if (this->combat && !combat)
-        return false;
-
-    if (timer <= diff)
-    {
-        timer = 0;
-        disabled = true;
-        return true;
-    }
-    else timer -= diff;
-
-    return false;
-}
-
-void TimerManager::AddTimer(uint32 id, Timer&& timer)
+void TimerManager::AddCustomAction(uint32 id, uint32 timer, std::function<void()> functor)
 {
-    m_timers.emplace(id, timer);
+    AddTimer(id, ActionTimer(id, std::move(functor), timer, timer, false));
 }
 
-void TimerManager::AddCustomAction(uint32 id, bool disabled, std::function<void()> functor)
+void TimerManager::AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, std::function<void()> functor)
 {
-    m_timers.emplace(id, Timer(id, functor, 0, 0, disabled));
+    AddTimer(id, ActionTimer(id, std::move(functor), timerMin, timerMax, false));
 }
 
-void TimerManager::AddCustomAction(uint32 id, uint32 timer, std::function<void()> functor)
+void TimerManager::ResetTimer(uint32 index, uint32 timer)
 {
-    m_timers.emplace(id, Timer(id, functor, timer, timer, false));
+    auto data = m_timers.find(index);
+    m_clock.Start((*data).second, timer);
 }
 
-void TimerManager::AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, std::function<void()> functor)
+void TimerManager::DisableTimer(uint32 index)
 {
-    m_timers.emplace(id, Timer(id, functor, timerMin, timerMax, false));
+    auto data = m_timers.find(index);
+    (*data).second.dueTime = m_clock.now;
+    (*data).second.disabled = true;
 }
 
 void TimerManager::ReduceTimer(uint32 index, uint32 timer)
 {
     auto data = m_timers.find(index);
-    (*data).second.timer = std::min((*data).second.timer, timer);
+    m_clock.Reduce((*data).second, timer);
 }
 
 void TimerManager::DelayTimer(uint32 index, uint32 timer)
 {
     auto data = m_timers.find(index);
     if (!(*data).second.disabled)
-        (*data).second.timer = (*data).second.timer > timer ? (*data).second.timer : timer;
+        (*data).second.dueTime = std::max((*data).second.dueTime, m_clock.now + timer);
 }
 
 void TimerManager::ResetIfNotStarted(uint32 index, uint32 timer)
 {
     auto data = m_timers.find(index);
     if ((*data).second.disabled)
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+        m_clock.Start((*data).second, timer);
 }
 
 void TimerManager::UpdateTimers(const uint32 diff)
 {
+    m_clock.now += diff;
+    if (m_clock.now < m_clock.nextDue)
+        return;
+
+    // the functors may start timers again, which lowers nextDue from here on
+    m_clock.nextDue = std::numeric_limits<uint64>::max();
     for (auto& data : m_timers)
     {
-        Timer& timer = data.second;
-        if (timer.UpdateTimer(diff))
+        ActionTimer& timer = data.second;
+        if (timer.disabled)
+            continue;
+
+        if (timer.dueTime <= m_clock.now)
+        {
+            timer.dueTime = m_clock.now;
+            timer.disabled = true;
             timer.functor();
+        }
+        else
+            m_clock.nextDue = std::min(m_clock.nextDue, timer.dueTime);
     }
 }
 
 void TimerManager::ResetAllTimers()
 {
     for (auto& data : m_timers)
-        data.second.ResetTimer();
+        m_clock.Reset(data.second);
 }
 
 void TimerManager::GetAIInformation(ChatHandler& reader)
@@ -129,7 +114,7 @@ void TimerManager::GetAIInformation(ChatHandler& reader)
     for (auto itr = m_timers.begin(); itr != m_timers.end(); ++itr)
     {
         Timer& timer = (*itr).second;
-        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(timer.timer), +" Disabled: " + std::to_string(timer.disabled) + "\n";
+        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(m_clock.GetRemaining(timer)), +" Disabled: " + std::to_string(timer.disabled) + "\n";
     }
     reader.PSendSysMessage("%s", output.data());
 }
@@ -137,11 +122,29 @@ void TimerManager::GetAIInformation(ChatHandler& reader)
 void CombatActions::UpdateTimers(const uint32 diff, bool combat)
 {
     TimerManager::UpdateTimers(diff);
+
+    if (!combat)
+        return;
+
+    m_combatClock.now += diff;
+    if (m_combatClock.now < m_combatClock.nextDue)
+        return;
+
+    m_combatClock.nextDue = std::numeric_limits<uint64>::max();
     for (auto& data : m_CombatActions)
     {
-        CombatTimer& timer = data.second;
-        if (timer.UpdateTimer(diff, combat))
-            timer.functor();
+        Timer& timer = data.second;
+        if (timer.disabled)
+            continue;
+
+        if (timer.dueTime <= m_combatClock.now)
+        {
+            timer.dueTime = m_combatClock.now;
+            timer.disabled = true;
+            m_actionReadyStatus[timer.id] = true;
+        }
+        else
+            m_combatClock.nextDue = std::min(m_combatClock.nextDue, timer.dueTime);
     }
 }
 
@@ -156,25 +159,31 @@ void CombatActions::ResetAllTimers()
             m_actionReadyStatus[i] = (*itr).second;
     }
     for (auto& data : m_CombatActions)
-        data.second.ResetTimer();
+        m_combatClock.Reset(data.second);
     TimerManager::ResetAllTimers();
 }
 
+void CombatActions::AddCombatTimer(Timer&& timer)
+{
+    m_combatClock.Reset(timer);
+    m_CombatActions.emplace(timer.id, std::move(timer));
+}
+
 void CombatActions::AddCombatAction(uint32 id, bool disabled)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, 0, 0, disabled));
+    AddCombatTimer(Timer(id, 0, 0, disabled));
     m_actionReadyStatus[id] = !disabled;
 }
 
 void CombatActions::AddCombatAction(uint32 id, uint32 timer)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, timer, timer, false));
+    AddCombatTimer(Timer(id, timer, timer, false));
     m_actionReadyStatus[id] = false;
 }
 
 void CombatActions::AddCombatAction(uint32 id, uint32 timerMin, uint32 timerMax)
 {
-    m_CombatActions.emplace(id, CombatTimer(id, [&, id] { m_actionReadyStatus[id] = true; }, true, timerMin, timerMax, false));
+    AddCombatTimer(Timer(id, timerMin, timerMax, false));
     m_actionReadyStatus[id] = false;
 }
 
@@ -190,10 +199,7 @@ void CombatActions::ResetTimer(uint32 index, uint32 timer)
     if (data == m_CombatActions.end())
         TimerManager::ResetTimer(index, timer);
     else
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+        m_combatClock.Start((*data).second, timer);
 }
 
 void CombatActions::DisableTimer(uint32 index)
@@ -203,7 +209,7 @@ void CombatActions::DisableTimer(uint32 index)
         TimerManager::DisableTimer(index);
     else
     {
-        (*data).second.timer = 0;
+        (*data).second.dueTime = m_combatClock.now;
         (*data).second.disabled = true;
     }
 }
@@ -214,7 +220,7 @@ void CombatActions::ReduceTimer(uint32 index, uint32 timer)
     if (data == m_CombatActions.end())
         TimerManager::ReduceTimer(index, timer);
     else
-        (*data).second.timer = std::min((*data).second.timer, timer);
+        m_combatClock.Reduce((*data).second, timer);
 }
 
 void CombatActions::DelayTimer(uint32 index, uint32 timer)
@@ -223,7 +229,7 @@ void CombatActions::DelayTimer(uint32 index, uint32 timer)
     if (data == m_CombatActions.end())
         TimerManager::DelayTimer(index, timer);
     else if (!(*data).second.disabled)
-        (*data).second.timer = (*data).second.timer > timer ? (*data).second.timer : timer;
+        (*data).second.dueTime = std::max((*data).second.dueTime, m_combatClock.now + timer);
 }
 
 void CombatActions::ResetIfNotStarted(uint32 index, uint32 timer)
@@ -232,10 +238,7 @@ void CombatActions::ResetIfNotStarted(uint32 index, uint32 timer)
     if (data == m_CombatActions.end())
         TimerManager::ResetIfNotStarted(index, timer);
     else if ((*data).second.disabled)
-    {
-        (*data).second.timer = timer;
-        (*data).second.disabled = false;
-    }
+        m_combatClock.Start((*data).second, timer);
 }
 
 void CombatActions::DisableCombatAction(uint32 index)
@@ -252,7 +255,7 @@ void CombatActions::GetAIInformation(ChatHandler& reader)
     for (auto itr = m_CombatActions.begin(); itr != m_CombatActions.end(); ++itr)
     {
         Timer& timer = (*itr).second;
-        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(timer.timer), +" Disabled: " + std::to_string(timer.disabled) + "\n";
+        output += "Timer ID: " + std::to_string(timer.id) + " Timer: " + std::to_string(m_combatClock.GetRemaining(timer)), +" Disabled: " + std::to_string(timer.disabled) + "\n";
     }
     reader.PSendSysMessage("%s", output.data());
 }
\ No newline at end of file
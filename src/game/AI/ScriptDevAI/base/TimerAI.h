@@ -20,7 +20,9 @@
 #include "Util.h"
 #include "Platform/Define.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -28,30 +30,55 @@ class ChatHandler;
 
 /*
 Timer data class used for execution of TimerAI events
+The due time is kept on the TimerClock of the owner instead of counting each timer down in every update
 */
 struct Timer
 {
-    Timer(uint32 id, std::function<void()> functor, uint32 timerMin, uint32 timerMax, bool disabled = false);
+    Timer(uint32 id, uint32 timerMin, uint32 timerMax, bool disabled = false);
     uint32 id;
-    uint32 timer;
+    uint64 dueTime;
     bool disabled;
-    std::function<void()> functor;
 
     // initial settings
     uint32 initialMin, initialMax;
     bool initialDisabled;
-
-    virtual bool UpdateTimer(const uint32 diff);
-    void ResetTimer();
 };
 
-struct CombatTimer : public Timer
+struct ActionTimer : public Timer
 {
-    CombatTimer(uint32 id, std::function<void()> functor, bool combat, uint32 timerMin, uint32 timerMax, bool disabled = false) : Timer(id, functor, timerMin, timerMax, disabled), combat(combat) {}
+    ActionTimer(uint32 id, std::function<void()> functor, uint32 timerMin, uint32 timerMax, bool disabled = false) : Timer(id, timerMin, timerMax, disabled), functor(std::move(functor)) {}
 
-    bool combat;
+    std::function<void()> functor;
+};
 
-    virtual bool UpdateTimer(const uint32 diff, bool combat);
+/*
+Time of a set of timers, advanced by the updates of their owner
+An update before nextDue has nothing to do; a stale, too early nextDue only costs one walk over the timers
+*/
+struct TimerClock
+{
+    TimerClock() : now(0), nextDue(std::numeric_limits<uint64>::max()) {}
+
+    uint64 now;
+    uint64 nextDue;
+
+    void Start(Timer& timer, uint32 delay)
+    {
+        timer.dueTime = now + delay;
+        timer.disabled = false;
+        nextDue = std::min(nextDue, timer.dueTime);
+    }
+    void Reset(Timer& timer)
+    {
+        Start(timer, urand(timer.initialMin, timer.initialMax));
+        timer.disabled = timer.initialDisabled;
+    }
+    void Reduce(Timer& timer, uint32 delay)
+    {
+        timer.dueTime = std::min(timer.dueTime, now + delay);
+        nextDue = std::min(nextDue, timer.dueTime);
+    }
+    uint32 GetRemaining(Timer const& timer) const { return timer.dueTime > now ? uint32(timer.dueTime - now) : 0; }
 };
 
 /*
@@ -68,16 +95,8 @@ class TimerManager
         void AddCustomAction(uint32 id, uint32 timer, std::function<void()> functor);
         void AddCustomAction(uint32 id, uint32 timerMin, uint32 timerMax, std::function<void()> functor);
 
-        virtual void ResetTimer(uint32 index, uint32 timer)
-        {
-            auto data = m_timers.find(index);
-            (*data).second.timer = timer; (*data).second.disabled = false;
-        }
-        virtual void DisableTimer(uint32 index)
-        {
-            auto data = m_timers.find(index);
-            (*data).second.timer = 0; (*data).second.disabled = true;
-        }
+        virtual void ResetTimer(uint32 index, uint32 timer);
+        virtual void DisableTimer(uint32 index);
         virtual void ReduceTimer(uint32 index, uint32 timer);
         virtual void DelayTimer(uint32 index, uint32 timer);
         virtual void ResetIfNotStarted(uint32 index, uint32 timer);
@@ -88,9 +107,10 @@ class TimerManager
         virtual void GetAIInformation(ChatHandler& reader);
 
     protected:
-        void AddTimer(uint32 id, Timer&& timer);
+        void AddTimer(uint32 id, ActionTimer&& timer);
     private:
-        std::map<uint32, Timer> m_timers;
+        std::map<uint32, ActionTimer> m_timers;
+        TimerClock m_clock;
 };
 
 class CombatActions : public TimerManager
@@ -145,7 +165,10 @@ class CombatActions : public TimerManager
         size_t GetCombatActionCount() { return m_actionReadyStatus.size(); }
 
     private:
-        std::map<uint32, CombatTimer> m_CombatActions;
+        void AddCombatTimer(Timer&& timer);
+
+        std::map<uint32, Timer> m_CombatActions;        // only count down in combat, make their action ready when due
+        TimerClock m_combatClock;
         std::vector<bool> m_actionReadyStatus;
         std::map<uint32, bool> m_timerlessActionSettings;
         std::map<uint32, uint32> m_spellAction;
@@ -407,6 +407,7 @@ bool AchievementCriteriaRequirementSet::Meets(Player const* source, Unit const*
 AchievementMgr::AchievementMgr(Player* player)
 {
     m_player = player;
+    m_progressSaveTime = time(nullptr);
 }
 
 AchievementMgr::~AchievementMgr()
@@ -525,10 +526,15 @@ void AchievementMgr::ResetAchievementCriteria(AchievementCriteriaTypes type, uin
 
 void AchievementMgr::DeleteFromDB(ObjectGuid guid)
 {
+    static SqlStatementID delAchievements;
+    static SqlStatementID delProgress;
+
     uint32 lowguid = guid.GetCounter();
     CharacterDatabase.BeginTransaction();
-    CharacterDatabase.PExecute("DELETE FROM character_achievement WHERE guid = %u", lowguid);
-    CharacterDatabase.PExecute("DELETE FROM character_achievement_progress WHERE guid = %u", lowguid);
+    SqlStatement stmt = CharacterDatabase.CreateStatement(delAchievements, "DELETE FROM character_achievement WHERE guid = ?");
+    stmt.PExecute(lowguid);
+    stmt = CharacterDatabase.CreateStatement(delProgress, "DELETE FROM character_achievement_progress WHERE guid = ?");
+    stmt.PExecute(lowguid);
     CharacterDatabase.CommitTransaction();
 }
 
@@ -536,8 +542,6 @@ void AchievementMgr::SaveToDB()
 {
     static SqlStatementID delComplAchievements ;
     static SqlStatementID insComplAchievements ;
-    static SqlStatementID delProgress ;
-    static SqlStatementID insProgress ;
 
     if (!m_completedAchievements.empty())
     {
@@ -558,9 +562,36 @@ void AchievementMgr::SaveToDB()
         }
     }
 
+    // counters like damage done change all the time, their rows may wait for later saves, never past the logout
+    uint32 const maxLag = sWorld.getConfig(CONFIG_UINT32_ACHIEVEMENT_PROGRESS_SAVE_MAX_LAG);
+    time_t const now = time(nullptr);
+    if (maxLag && now < m_progressSaveTime + time_t(maxLag) && !GetPlayer()->GetSession()->isLogingOut())
+        return;
+
+    m_progressSaveTime = now;
+
     if (!m_criteriaProgress.empty())
     {
-        // insert achievements
+        // changed rows are deleted and inserted back by batches
+        uint32 const guid = GetPlayer()->GetGUIDLow();
+        std::ostringstream deleted;
+        std::ostringstream inserted;
+        uint32 deletedCount = 0;
+        uint32 insertedCount = 0;
+
+        auto flush = [&]()
+        {
+            if (deletedCount)
+                CharacterDatabase.PExecute("DELETE FROM character_achievement_progress WHERE guid = '%u' AND criteria IN (%s)", guid, deleted.str().c_str());
+            if (insertedCount)
+                CharacterDatabase.PExecute("INSERT INTO character_achievement_progress (guid, criteria, counter, date) VALUES %s", inserted.str().c_str());
+
+            deleted.str("");
+            inserted.str("");
+            deletedCount = 0;
+            insertedCount = 0;
+        };
+
         for (auto& m_criteriaProgres : m_criteriaProgress)
         {
             if (!m_criteriaProgres.second.changed)
@@ -569,9 +600,7 @@ void AchievementMgr::SaveToDB()
             /// mark as updated in db
             m_criteriaProgres.second.changed = false;
 
-            // new/changed record data
-            SqlStatement stmt = CharacterDatabase.CreateStatement(delProgress, "DELETE FROM character_achievement_progress WHERE guid = ? AND criteria = ?");
-            stmt.PExecute(GetPlayer()->GetGUIDLow(), m_criteriaProgres.first);
+            deleted << (deletedCount++ ? "," : "") << m_criteriaProgres.first;
 
             bool needSave = m_criteriaProgres.second.counter != 0;
             if (!needSave)
@@ -581,11 +610,13 @@ void AchievementMgr::SaveToDB()
             }
 
             if (needSave)
-            {
-                stmt = CharacterDatabase.CreateStatement(insProgress, "INSERT INTO character_achievement_progress (guid, criteria, counter, date) VALUES (?, ?, ?, ?)");
-                stmt.PExecute(GetPlayer()->GetGUIDLow(), m_criteriaProgres.first, m_criteriaProgres.second.counter, uint64(m_criteriaProgres.second.date));
-            }
+                inserted << (insertedCount++ ? ",(" : "(") << guid << "," << m_criteriaProgres.first << "," << m_criteriaProgres.second.counter << "," << uint64(m_criteriaProgres.second.date) << ")";
+
+            if (deletedCount >= 256)
+                flush();
         }
+
+        flush();
     }
 }
 
@@ -878,7 +909,7 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
     if (!sWorld.getConfig(CONFIG_BOOL_GM_ALLOW_ACHIEVEMENT_GAINS) && m_player->GetSession()->GetSecurity() > SEC_PLAYER)
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type);
+    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByTypeAndAsset(type, miscvalue1);
     for (auto achievementCriteria : achievementCriteriaList)
     {
         AchievementEntry const* achievement = sAchievementStore.LookupEntry(achievementCriteria->referredAchievement);
@@ -2318,8 +2349,11 @@ void AchievementMgr::IncompletedAchievement(AchievementEntry const* achievement)
     m_player->SendDirectMessage(data);
 
     if (!itr->second.changed)                               // complete state saved
-        CharacterDatabase.PExecute("DELETE FROM character_achievement WHERE guid = %u AND achievement = %u",
-                                   GetPlayer()->GetGUIDLow(), achievement->ID);
+    {
+        static SqlStatementID delComplAchievement;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delComplAchievement, "DELETE FROM character_achievement WHERE guid = ? AND achievement = ?");
+        stmt.PExecute(GetPlayer()->GetGUIDLow(), achievement->ID);
+    }
 
     m_completedAchievements.erase(achievement->ID);
 
@@ -2390,6 +2424,58 @@ AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteria
     return m_AchievementCriteriasByType[type];
 }
 
+// types for which AchievementMgr::UpdateAchievementCriteria skips every criteria whose asset is not a non zero miscvalue1,
+// before doing anything else with it. all these assets are the first field of the criteria data, raw.value
+bool AchievementGlobalMgr::IsCriteriaSelectedByAsset(AchievementCriteriaTypes type)
+{
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE:
+        case ACHIEVEMENT_CRITERIA_TYPE_KILLED_BY_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_HONORABLE_KILL_AT_AREA:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_TEAM_RATING:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_PERSONAL_RATING:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:
+        case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:
+        case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+        case ACHIEVEMENT_CRITERIA_TYPE_FISH_IN_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILLLINE_SPELLS:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_TYPE:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LINE:
+        case ACHIEVEMENT_CRITERIA_TYPE_BG_OBJECTIVE_CAPTURE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByTypeAndAsset(AchievementCriteriaTypes type, uint32 asset) const
+{
+    // 0 is used for the updates of all criterias at login
+    if (!asset || !IsCriteriaSelectedByAsset(type))
+        return m_AchievementCriteriasByType[type];
+
+    static AchievementCriteriaEntryList const emptyList;
+
+    AchievementCriteriaListByAsset::const_iterator itr = m_AchievementCriteriasByAsset[type].find(asset);
+    return itr != m_AchievementCriteriasByAsset[type].end() ? itr->second : emptyList;
+}
+
 AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAchievement(uint32 id)
 {
     AchievementCriteriaListByAchievement::const_iterator itr = m_AchievementCriteriaListByAchievement.find(id);
@@ -2472,6 +2558,8 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
         }
 
         m_AchievementCriteriasByType[criteria->requiredType].push_back(criteria);
+        if (IsCriteriaSelectedByAsset(AchievementCriteriaTypes(criteria->requiredType)))
+            m_AchievementCriteriasByAsset[criteria->requiredType][criteria->raw.value].push_back(criteria);
         m_AchievementCriteriaListByAchievement[criteria->referredAchievement].push_back(criteria);
         ++count;
     }
@@ -33,6 +33,7 @@ typedef std::list<AchievementCriteriaEntry const*> AchievementCriteriaEntryList;
 typedef std::list<AchievementEntry const*>         AchievementEntryList;
 
 typedef std::map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAchievement;
+typedef std::unordered_map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAsset;
 typedef std::map<uint32, AchievementEntryList>         AchievementListByReferencedId;
 typedef std::map<uint32, time_t>                       AchievementCriteriaFailTimeMap;
 
@@ -302,6 +303,7 @@ class AchievementMgr
 
         Player* m_player;
         CriteriaProgressMap m_criteriaProgress;
+        time_t m_progressSaveTime;                          // last time the changed progress was written, see Achievements.ProgressSaveMaxLag
         CompletedAchievementMap m_completedAchievements;
         AchievementCriteriaFailTimeMap m_criteriaFailTimes;
 };
@@ -310,6 +312,8 @@ class AchievementGlobalMgr
 {
     public:
         AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type) const;
+        // criterias an update of the type with this miscvalue1 can progress, all of the type if it is 0 or they are not selected by it
+        AchievementCriteriaEntryList const& GetAchievementCriteriaByTypeAndAsset(AchievementCriteriaTypes type, uint32 asset) const;
         AchievementCriteriaEntryList const* GetAchievementCriteriaByAchievement(uint32 id);
         AchievementEntryList const* GetAchievementByReferencedId(uint32 id) const;
         AchievementReward const* GetAchievementReward(AchievementEntry const* achievement, uint8 gender) const;
@@ -327,10 +331,14 @@ class AchievementGlobalMgr
         void LoadRewardLocales();
 
     private:
+        static bool IsCriteriaSelectedByAsset(AchievementCriteriaTypes type);
+
         AchievementCriteriaRequirementMap m_criteriaRequirementMap;
 
         // store achievement criterias by type to speed up lookup
         AchievementCriteriaEntryList m_AchievementCriteriasByType[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+        // same by their asset (raw.value), only filled for the types IsCriteriaSelectedByAsset() accepts
+        AchievementCriteriaListByAsset m_AchievementCriteriasByAsset[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
         // store achievement criterias by achievement to speed up lookup
         AchievementCriteriaListByAchievement m_AchievementCriteriaListByAchievement;
         // store achievements by referenced achievement id to speed up lookup
@@ -754,6 +754,79 @@ void ArenaTeam::SaveToDB()
     CharacterDatabase.CommitTransaction();
 }
 
+void ArenaTeamSaveBatch::AddTeam(ArenaTeam const* team)
+{
+    ArenaTeamStats const& stats = team->GetStats();
+
+    std::ostringstream ss;
+    ss << "(" << team->GetId() << "," << stats.rating << "," << stats.games_week << "," << stats.wins_week << ","
+       << stats.games_season << "," << stats.wins_season << "," << stats.rank << ")";
+    m_statsRows.push_back(ss.str());
+
+    for (ArenaTeamMember const& member : team->GetMembers())
+    {
+        ss.str("");
+        ss << "(" << team->GetId() << "," << member.guid.GetCounter() << "," << member.games_week << "," << member.wins_week << ","
+           << member.games_season << "," << member.wins_season << "," << member.personal_rating << ")";
+        m_memberRows.push_back(ss.str());
+    }
+}
+
+void ArenaTeamSaveBatch::AddArenaPoints(uint32 playerGuid, uint32 points)
+{
+    if (points)
+        m_arenaPoints[points].push_back(playerGuid);
+}
+
+void ArenaTeamSaveBatch::Flush()
+{
+    // rows per statement
+    uint32 const guidRows = 256;
+    uint32 const insertRows = 200;
+
+    CharacterDatabase.BeginTransaction();
+
+    // all columns are written, replacing a row keeps nothing of the old one
+    auto insertRowList = [insertRows](char const* query, std::vector<std::string> const& rows)
+    {
+        for (size_t i = 0; i < rows.size(); i += insertRows)
+        {
+            std::string sql = query;
+            sql += rows[i];
+            for (size_t j = i + 1; j < rows.size() && j < i + insertRows; ++j)
+            {
+                sql += ",";
+                sql += rows[j];
+            }
+            CharacterDatabase.Execute(sql.c_str());
+        }
+    };
+
+    insertRowList("REPLACE INTO arena_team_stats (arenateamid, rating, games_week, wins_week, games_season, wins_season, `rank`) VALUES ", m_statsRows);
+    insertRowList("REPLACE INTO arena_team_member (arenateamid, guid, played_week, wons_week, played_season, wons_season, personal_rating) VALUES ", m_memberRows);
+
+    // the points only take a few hundred values, the characters getting the same are updated together
+    for (auto const& pointsGuids : m_arenaPoints)
+    {
+        std::vector<uint32> const& guids = pointsGuids.second;
+        for (size_t i = 0; i < guids.size(); i += guidRows)
+        {
+            std::ostringstream ss;
+            ss << "UPDATE characters SET arenaPoints = arenaPoints + " << pointsGuids.first << " WHERE guid IN (" << guids[i];
+            for (size_t j = i + 1; j < guids.size() && j < i + guidRows; ++j)
+                ss << "," << guids[j];
+            ss << ")";
+            CharacterDatabase.Execute(ss.str().c_str());
+        }
+    }
+
+    CharacterDatabase.CommitTransaction();
+
+    m_statsRows.clear();
+    m_memberRows.clear();
+    m_arenaPoints.clear();
+}
+
 void ArenaTeam::FinishWeek()
 {
     m_stats.games_week = 0;                                 // played this week
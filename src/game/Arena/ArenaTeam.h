@@ -113,6 +113,27 @@ struct ArenaTeamStats
 
 #define MAX_ARENA_SLOT 3                                    // 0..2 slots
 
+class ArenaTeam;
+
+/**
+ * The arena_team_stats and arena_team_member rows of many teams and the arena points added to
+ * characters, written by the weekly and season distributions as a few multi-row statements in one
+ * transaction instead of statements per team, member and character.
+ */
+class ArenaTeamSaveBatch
+{
+    public:
+        void AddTeam(ArenaTeam const* team);
+        void AddArenaPoints(uint32 playerGuid, uint32 points);
+
+        void Flush();
+
+    private:
+        std::vector<std::string> m_statsRows;
+        std::vector<std::string> m_memberRows;
+        std::map<uint32, std::vector<uint32>> m_arenaPoints; // characters by the points added to them
+};
+
 class ArenaTeam
 {
     public:
@@ -150,6 +171,7 @@ class ArenaTeam
         size_t GetMaxMembersSize() const      { return size_t(GetType() * 2); }
         bool   Empty() const                  { return m_members.empty(); }
         MemberList& GetMembers()              { return m_members; }
+        MemberList const& GetMembers() const  { return m_members; }
         bool HaveMember(ObjectGuid guid) const;
 
         ArenaTeamMember* GetMember(ObjectGuid guid)
@@ -176,6 +198,8 @@ class ArenaTeam
         bool LoadMembersFromDB(QueryResult* arenaTeamMembersResult);
 
         void SaveToDB();
+        // same as SaveToDB, the rows are written by the batch
+        void SaveToDB(ArenaTeamSaveBatch& batch) const { batch.AddTeam(this); }
 
         void BroadcastPacket(WorldPacket const& packet);
 
@@ -25,10 +25,15 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Player.h"
 #include "AuctionHouse/AuctionHouseMgr.h"
+#include "AuctionHouse/AuctionHouseSearch.h"
 #include "Mails/Mail.h"
 #include "Util.h"
 #include "Chat/Chat.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
 // please DO NOT use iterator++, because it is slower than ++iterator!!!
 // post-incrementation is always slower than pre-incrementation !
 
@@ -225,6 +230,15 @@ AuctionHouseEntry const* WorldSession::GetCheckedAuctionHouseForAuctioneer(Objec
     return AuctionHouseMgr::GetAuctionHouseEntry(auctioneer);
 }
 
+// common part of the list requests answered by the search workers
+static void SetSearchRequestSource(AuctionSearchRequest& request, WorldSession* session, AuctionHouseObject* auctionHouse, AuctionHouseEntry const* auctionHouseEntry, bool currentSnapshot)
+{
+    request.accountId = session->GetAccountId();
+    request.playerGuid = session->GetPlayer()->GetGUIDLow();
+    request.houseId = auctionHouseEntry->houseId;
+    request.snapshot = auctionHouse->GetSnapshot(currentSnapshot);
+}
+
 // this void creates new auction and adds auction to some auctionhouse
 void WorldSession::HandleAuctionSellItem(WorldPacket& recv_data)
 {
@@ -539,6 +553,22 @@ void WorldSession::HandleAuctionListBidderItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
+    AuctionSearchWorkers& searchWorkers = sAuctionMgr.GetSearchWorkers();
+    if (searchWorkers.activated())
+    {
+        AuctionSearchRequest request;
+        request.type = AUCTION_SEARCH_LIST_BIDDER;
+        SetSearchRequestSource(request, this, auctionHouse, auctionHouseEntry, true);
+        request.listfrom = listfrom;
+
+        request.outbidded.resize(outbiddedCount);
+        for (uint32& outbiddedAuctionId : request.outbidded)
+            recv_data >> outbiddedAuctionId;
+
+        searchWorkers.Queue(std::move(request));
+        return;
+    }
+
     WorldPacket data(SMSG_AUCTION_BIDDER_LIST_RESULT, (4 + 4 + 4));
     Player* pl = GetPlayer();
     data << uint32(0);                                      // add 0 as count
@@ -582,6 +612,18 @@ void WorldSession::HandleAuctionListOwnerItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
+    AuctionSearchWorkers& searchWorkers = sAuctionMgr.GetSearchWorkers();
+    if (searchWorkers.activated())
+    {
+        AuctionSearchRequest request;
+        request.type = AUCTION_SEARCH_LIST_OWNER;
+        SetSearchRequestSource(request, this, auctionHouse, auctionHouseEntry, true);
+        request.listfrom = listfrom;
+
+        searchWorkers.Queue(std::move(request));
+        return;
+    }
+
     WorldPacket data(SMSG_AUCTION_OWNER_LIST_RESULT, (4 + 4 + 4));
     data << uint32(0);                                      // amount place holder
 
@@ -639,15 +681,55 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
+    // converting string that we try to find to lower case
+    std::wstring wsearchedname;
+    if (!Utf8toWStr(searchedname, wsearchedname))
+        return;
+
+    wstrToLower(wsearchedname);
+
+    // usable depends on the player, such searches stay on this thread
+    AuctionSearchWorkers& searchWorkers = sAuctionMgr.GetSearchWorkers();
+    if (searchWorkers.activated() && !usable)
+    {
+        AuctionSearchRequest request;
+        request.type = AUCTION_SEARCH_LIST_ITEMS;
+        SetSearchRequestSource(request, this, auctionHouse, auctionHouseEntry, false);
+        request.listfrom = listfrom;
+        request.locale = GetSessionDbLocaleIndex();
+        request.wsearchedname = std::move(wsearchedname);
+        request.levelmin = levelmin;
+        request.levelmax = levelmax;
+        request.inventoryType = auctionSlotID;
+        request.itemClass = auctionMainCategory;
+        request.itemSubClass = auctionSubCategory;
+        request.quality = quality;
+        request.isFull = isFull != 0;
+        memcpy(request.sort, Sort, sizeof(Sort));
+
+        searchWorkers.Queue(std::move(request));
+        return;
+    }
+
+#ifdef BUILD_METRICS
+    std::chrono::steady_clock::time_point searchStart = std::chrono::steady_clock::now();
+#endif
+
     std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
+    if (isFull)
+    {
+        AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
+        auctions.reserve(aucs.size());
 
-    for (const auto& auc : aucs)
-        auctions.push_back(auc.second);
+        for (const auto& auc : aucs)
+            auctions.push_back(auc.second);
+    }
+    else
+        auctionHouse->FindAuctions(auctions, GetSessionDbLocaleIndex(), wsearchedname, levelmin, levelmax,
+                                   auctionSlotID, auctionMainCategory, auctionSubCategory, quality);
 
-    AuctionSorter sorter(Sort, GetPlayer());
+    // Sort, only the matching auctions
+    AuctionSorter sorter(Sort, GetSessionDbLocaleIndex());
     std::sort(auctions.begin(), auctions.end(), sorter);
 
     // DEBUG_LOG("Auctionhouse search %s list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u",
@@ -658,15 +740,17 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     uint32 totalcount = 0;
     data << uint32(0);
 
-    // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if (!Utf8toWStr(searchedname, wsearchedname))
-        return;
-
-    wstrToLower(wsearchedname);
-
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-                          auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull != 0);
+    // item filters were applied by the search index, only the per auction and per player ones are left
+    BuildListAuctionItems(auctions, data, std::wstring(), listfrom, 0, 0, usable,
+                          0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, count, totalcount, isFull != 0);
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("auction.search", { { "house_id", std::to_string(auctionHouseEntry->houseId) } });
+    meas.add_field("duration", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - searchStart).count()));
+    meas.add_field("candidates", std::to_string(auctions.size()));
+    meas.add_field("results", std::to_string(totalcount));
+    meas.add_field("full", std::to_string(isFull != 0));
+#endif
 
     data.put<uint32>(0, count);
     data << uint32(totalcount);
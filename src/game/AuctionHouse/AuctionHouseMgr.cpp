@@ -17,6 +17,7 @@
  */
 
 #include "AuctionHouse/AuctionHouseMgr.h"
+#include "AuctionHouse/AuctionHouseSearch.h"
 #include "Database/DatabaseEnv.h"
 #include "Server/SQLStorages.h"
 #include "Server/DBCStores.h"
@@ -38,12 +39,14 @@
 
 INSTANTIATE_SINGLETON_1(AuctionHouseMgr);
 
-AuctionHouseMgr::AuctionHouseMgr()
+AuctionHouseMgr::AuctionHouseMgr() : m_searchWorkers(std::make_unique<AuctionSearchWorkers>())
 {
 }
 
 AuctionHouseMgr::~AuctionHouseMgr()
 {
+    m_searchWorkers->deactivate();
+
     for (ItemMap::const_iterator itr = mAitems.begin(); itr != mAitems.end(); ++itr)
         delete itr->second;
 }
@@ -560,6 +563,229 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+void AuctionSearchIndex::Add(AuctionEntry* auction)
+{
+    std::vector<AuctionEntry*>& auctions = m_auctionsByTemplate[auction->itemTemplate];
+    auctions.push_back(auction);
+    if (auctions.size() > 1)
+        return;
+
+    // first auction of this item
+    if (ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(auction->itemTemplate))
+        m_templatesByBucket[GetBucket(proto)].insert(auction->itemTemplate);
+
+    for (auto& locale : m_locales)
+        AddName(locale.first, locale.second, auction->itemTemplate);
+}
+
+void AuctionSearchIndex::Remove(AuctionEntry* auction)
+{
+    auto itr = m_auctionsByTemplate.find(auction->itemTemplate);
+    if (itr == m_auctionsByTemplate.end())
+        return;
+
+    std::vector<AuctionEntry*>& auctions = itr->second;
+    auto auctionItr = std::find(auctions.begin(), auctions.end(), auction);
+    if (auctionItr == auctions.end())
+        return;
+
+    *auctionItr = auctions.back();
+    auctions.pop_back();
+    if (!auctions.empty())
+        return;
+
+    // last auction of this item
+    m_auctionsByTemplate.erase(itr);
+
+    if (ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(auction->itemTemplate))
+    {
+        auto bucketItr = m_templatesByBucket.find(GetBucket(proto));
+        if (bucketItr != m_templatesByBucket.end())
+        {
+            bucketItr->second.erase(auction->itemTemplate);
+            if (bucketItr->second.empty())
+                m_templatesByBucket.erase(bucketItr);
+        }
+    }
+
+    for (auto& locale : m_locales)
+        RemoveName(locale.second, auction->itemTemplate);
+}
+
+void AuctionSearchIndex::Find(std::vector<AuctionEntry*>& result, int locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+                              uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality)
+{
+    auto collect = [&](uint32 itemTemplate, ItemPrototype const* proto)
+    {
+        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+            return;
+
+        std::vector<AuctionEntry*> const& auctions = m_auctionsByTemplate[itemTemplate];
+        result.insert(result.end(), auctions.begin(), auctions.end());
+    };
+
+    if (!wsearchedname.empty())
+    {
+        LocaleIndex& index = GetLocaleIndex(locale);
+
+        // names holding the searched one hold all its trigrams, the rarest one gives the fewest names to check
+        TemplateSet const* candidates = nullptr;
+        for (size_t i = 0; i + 3 <= wsearchedname.size(); ++i)
+        {
+            auto itr = index.trigrams.find(GetTrigram(wsearchedname, i));
+            if (itr == index.trigrams.end())
+                return;
+
+            if (!candidates || itr->second.size() < candidates->size())
+                candidates = &itr->second;
+        }
+
+        auto check = [&](uint32 itemTemplate, std::wstring const& name)
+        {
+            if (name.find(wsearchedname) == std::wstring::npos)
+                return;
+
+            ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(itemTemplate);
+            if (proto && BucketMatches(GetBucket(proto), inventoryType, itemClass, itemSubClass, quality))
+                collect(itemTemplate, proto);
+        };
+
+        if (candidates)
+        {
+            for (uint32 itemTemplate : *candidates)
+                check(itemTemplate, index.names[itemTemplate]);
+        }
+        else                                                // shorter than a trigram
+        {
+            for (auto const& name : index.names)
+                check(name.first, name.second);
+        }
+        return;
+    }
+
+    auto begin = m_templatesByBucket.begin();
+    auto end = m_templatesByBucket.end();
+    if (itemClass != 0xffffffff)
+    {
+        if (itemClass >= 0xFF)
+            return;
+
+        begin = m_templatesByBucket.lower_bound(itemClass << 24);
+        end = m_templatesByBucket.lower_bound((itemClass + 1) << 24);
+    }
+
+    for (auto itr = begin; itr != end; ++itr)
+    {
+        if (!BucketMatches(itr->first, inventoryType, itemClass, itemSubClass, quality))
+            continue;
+
+        for (uint32 itemTemplate : itr->second)
+            if (ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(itemTemplate))
+                collect(itemTemplate, proto);
+    }
+}
+
+AuctionSearchIndex::LocaleIndex& AuctionSearchIndex::GetLocaleIndex(int locale)
+{
+    auto itr = m_locales.find(locale);
+    if (itr != m_locales.end())
+        return itr->second;
+
+    LocaleIndex& index = m_locales[locale];
+    for (auto const& auctions : m_auctionsByTemplate)
+        AddName(locale, index, auctions.first);
+    return index;
+}
+
+void AuctionSearchIndex::AddName(int locale, LocaleIndex& index, uint32 itemTemplate)
+{
+    ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(itemTemplate);
+    if (!proto)
+        return;
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, locale, &name);
+
+    // a name that is not valid utf8 is kept empty and never found, as with Utf8FitTo
+    std::wstring& wname = index.names[itemTemplate];
+    if (!Utf8toWStr(name, wname))
+    {
+        wname.clear();
+        return;
+    }
+
+    wstrToLower(wname);
+
+    for (size_t i = 0; i + 3 <= wname.size(); ++i)
+        index.trigrams[GetTrigram(wname, i)].insert(itemTemplate);
+}
+
+void AuctionSearchIndex::RemoveName(LocaleIndex& index, uint32 itemTemplate)
+{
+    auto nameItr = index.names.find(itemTemplate);
+    if (nameItr == index.names.end())
+        return;
+
+    std::wstring const& wname = nameItr->second;
+    for (size_t i = 0; i + 3 <= wname.size(); ++i)
+    {
+        auto itr = index.trigrams.find(GetTrigram(wname, i));
+        if (itr == index.trigrams.end())
+            continue;
+
+        itr->second.erase(itemTemplate);
+        if (itr->second.empty())
+            index.trigrams.erase(itr);
+    }
+
+    index.names.erase(nameItr);
+}
+
+uint32 AuctionSearchIndex::GetBucket(ItemPrototype const* proto)
+{
+    return (proto->Class & 0xFF) << 24 | (proto->SubClass & 0xFF) << 16 | (proto->InventoryType & 0xFF) << 8 | (proto->Quality & 0xFF);
+}
+
+bool AuctionSearchIndex::BucketMatches(uint32 bucket, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality)
+{
+    if (itemClass != 0xffffffff && (bucket >> 24) != itemClass)
+        return false;
+
+    if (itemSubClass != 0xffffffff && ((bucket >> 16) & 0xFF) != itemSubClass)
+        return false;
+
+    uint32 const bucketInventoryType = (bucket >> 8) & 0xFF;
+    if (inventoryType != 0xffffffff && bucketInventoryType != inventoryType)
+    {
+        // if inventory type is chest, we want to return robes too
+        if (inventoryType != INVTYPE_CHEST || bucketInventoryType != INVTYPE_ROBE)
+            return false;
+    }
+
+    if (quality != 0xffffffff && (bucket & 0xFF) < quality)
+        return false;
+
+    return true;
+}
+
+uint64 AuctionSearchIndex::GetTrigram(std::wstring const& name, size_t pos)
+{
+    // code points fit in 21 bits
+    return uint64(name[pos] & 0x1FFFFF) << 42 | uint64(name[pos + 1] & 0x1FFFFF) << 21 | uint64(name[pos + 2] & 0x1FFFFF);
+}
+
+std::shared_ptr<AuctionHouseSnapshot const> AuctionHouseObject::GetSnapshot(bool current)
+{
+    uint32 const now = WorldTimer::getMSTime();
+    if (m_snapshot && (m_snapshot->GetEpoch() == m_epoch ||
+                       (!current && WorldTimer::getMSTimeDiff(m_snapshotTime, now) < sWorld.getConfig(CONFIG_UINT32_AUCTION_SNAPSHOT_MAX_AGE))))
+        return m_snapshot;
+
+    m_snapshot = std::make_shared<AuctionHouseSnapshot const>(*this, m_epoch);
+    m_snapshotTime = now;
+    return m_snapshot;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
@@ -574,6 +800,8 @@ void AuctionHouseObject::Update()
 
                 itr->second->DeleteFromDB();
                 MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
+                m_searchIndex.Remove(itr->second);
+                MarkChanged();
                 delete itr->second;
                 AuctionsMap.erase(itr++);
                 continue;
@@ -592,6 +820,8 @@ void AuctionHouseObject::Update()
                     sAuctionMgr.SendAuctionExpiredMail(itr->second);
 
                     itr->second->DeleteFromDB();
+                    m_searchIndex.Remove(itr->second);
+                    MarkChanged();
                     delete itr->second;
                     AuctionsMap.erase(itr++);
                     continue;
@@ -643,7 +873,7 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
-int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Player* viewPlayer) const
+int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, int loc_idx) const
 {
     switch (column)
     {
@@ -710,8 +940,6 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
             if (!itemProto2 || !itemProto1)
                 return 0;
 
-            int32 loc_idx = viewPlayer->GetSession()->GetSessionDbLocaleIndex();
-
             std::string name1 = itemProto1->Name1;
             sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, loc_idx, &name1);
 
@@ -792,7 +1020,7 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
             return false;
 
-        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
+        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_locale);
         // "equal" by used column
         if (res == 0)
             continue;
@@ -936,7 +1164,10 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
 
     sAuctionMgr.AddAItem(newItem);
 
-    CharacterDatabase.BeginTransaction();
+    // batched callers (AHBot) write many auctions in their own transaction
+    bool const ownTransaction = !CharacterDatabase.IsInTransaction();
+    if (ownTransaction)
+        CharacterDatabase.BeginTransaction();
 
     newItem->SaveToDB();
     AH->SaveToDB();
@@ -944,13 +1175,14 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->SaveInventoryAndGoldToDB();
 
-    CharacterDatabase.CommitTransaction();
+    if (ownTransaction)
+        CharacterDatabase.CommitTransaction();
 
     return AH;
 }
 
 // this function inserts to WorldPacket auction's data
-bool AuctionEntry::BuildAuctionInfo(WorldPacket& data) const
+bool AuctionEntry::BuildAuctionInfo(ByteBuffer& data) const
 {
     Item* pItem = sAuctionMgr.GetAItem(itemGuidLow);
     if (!pItem)
@@ -1014,6 +1246,7 @@ void AuctionEntry::SaveToDB() const
 void AuctionEntry::AuctionBidWinning(Player* newbidder)
 {
     moneyDeliveryTime = time(nullptr) + HOUR;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->MarkChanged();
 
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE auction SET itemguid = 0, moneyTime = '" UI64FMTD "', buyguid = '%u', lastbid = '%u' WHERE id = '%u'", (uint64)moneyDeliveryTime, bidder, bid, Id);
@@ -1047,6 +1280,7 @@ bool AuctionEntry::UpdateBid(uint32 newbid, Player* newbidder /*=nullptr*/)
 
     bidder = newbidder ? newbidder->GetGUIDLow() : 0;
     bid = newbid;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->MarkChanged();
 
     if ((newbid < buyout) || (buyout == 0))                 // bid
     {
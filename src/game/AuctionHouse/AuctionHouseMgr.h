@@ -22,10 +22,19 @@
 #include "Common.h"
 #include "Server/DBCStructure.h"
 
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+class ByteBuffer;
 class Item;
 class Player;
 class Unit;
 class WorldPacket;
+struct ItemPrototype;
+class AuctionHouseSnapshot;
+class AuctionSearchWorkers;
 
 #define MIN_AUCTION_TIME (12*HOUR)
 #define MAX_AUCTION_SORT 12
@@ -76,22 +85,58 @@ struct AuctionEntry
     uint32 GetHouseFaction() const { return auctionHouseEntry->faction; }
     uint32 GetAuctionCut() const;
     uint32 GetAuctionOutBid() const;
-    bool BuildAuctionInfo(WorldPacket& data) const;
+    bool BuildAuctionInfo(ByteBuffer& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
     void AuctionBidWinning(Player* newbidder = nullptr);
 
     // -1,0,+1 order result
-    int CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Player* viewPlayer) const;
+    int CompareAuctionEntry(uint32 column, const AuctionEntry* auc, int loc_idx) const;
 
     bool UpdateBid(uint32 newbid, Player* newbidder = nullptr);// true if normal bid, false if buyout, bidder==nullptr for generated bid
 };
 
+// search index of one auction house, answers the item filters of the browse tab without looking at every auction:
+// auctions are grouped by item template, templates by class, subclass, inventory type and quality, and the lower
+// case names of the templates by their trigrams, per locale. a locale is indexed when first searched in
+class AuctionSearchIndex
+{
+    public:
+        void Add(AuctionEntry* auction);
+        void Remove(AuctionEntry* auction);
+
+        // appends the auctions of the item templates matching the filters, in no particular order. pending
+        // auctions are included, and usable is left to the caller as it depends on the player
+        void Find(std::vector<AuctionEntry*>& result, int locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+                  uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality);
+
+    private:
+        typedef std::unordered_set<uint32> TemplateSet;
+
+        struct LocaleIndex
+        {
+            std::unordered_map<uint32, std::wstring> names; // item template to its lower case name
+            std::unordered_map<uint64, TemplateSet> trigrams;
+        };
+
+        LocaleIndex& GetLocaleIndex(int locale);
+        void AddName(int locale, LocaleIndex& index, uint32 itemTemplate);
+        void RemoveName(LocaleIndex& index, uint32 itemTemplate);
+
+        static uint32 GetBucket(ItemPrototype const* proto);
+        static bool BucketMatches(uint32 bucket, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality);
+        static uint64 GetTrigram(std::wstring const& name, size_t pos);
+
+        std::unordered_map<uint32, std::vector<AuctionEntry*> > m_auctionsByTemplate;
+        std::map<uint32, TemplateSet> m_templatesByBucket;  // ordered by class first, see GetBucket
+        std::map<int, LocaleIndex> m_locales;
+};
+
 // this class is used as auctionhouse instance
 class AuctionHouseObject
 {
     public:
-        AuctionHouseObject() {}
+        AuctionHouseObject() : m_epoch(0), m_snapshotTime(0) {}
         ~AuctionHouseObject()
         {
             for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
@@ -109,7 +154,12 @@ class AuctionHouseObject
         void AddAuction(AuctionEntry* ah)
         {
             MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
+            AuctionEntry*& entry = AuctionsMap[ah->Id];
+            if (entry)
+                m_searchIndex.Remove(entry);
+            entry = ah;
+            m_searchIndex.Add(ah);
+            MarkChanged();
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -120,9 +170,29 @@ class AuctionHouseObject
 
         bool RemoveAuction(uint32 id)
         {
-            return AuctionsMap.erase(id) > 0;
+            AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+            if (itr == AuctionsMap.end())
+                return false;
+
+            m_searchIndex.Remove(itr->second);
+            AuctionsMap.erase(itr);
+            MarkChanged();
+            return true;
+        }
+
+        void FindAuctions(std::vector<AuctionEntry*>& result, int locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+                          uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality)
+        {
+            m_searchIndex.Find(result, locale, wsearchedname, levelmin, levelmax, inventoryType, itemClass, itemSubClass, quality);
         }
 
+        // to call after any change of a listed auction, outdates the snapshot
+        void MarkChanged() { ++m_epoch; }
+
+        // snapshot of the listed auctions for the search workers, taken again when outdated. unless current
+        // is set an outdated one is still returned while younger than AuctionHouse.SnapshotMaxAge
+        std::shared_ptr<AuctionHouseSnapshot const> GetSnapshot(bool current);
+
         void Update();
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
@@ -132,18 +202,23 @@ class AuctionHouseObject
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
         AuctionEntryMap AuctionsMap;
+        AuctionSearchIndex m_searchIndex;
+
+        uint64 m_epoch;                                     // count of changes
+        std::shared_ptr<AuctionHouseSnapshot const> m_snapshot;
+        uint32 m_snapshotTime;
 };
 
 class AuctionSorter
 {
     public:
-        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
-        AuctionSorter(uint8* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
+        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_locale(sorter.m_locale) {}
+        AuctionSorter(uint8 const* sort, int loc_idx) : m_sort(sort), m_locale(loc_idx) {}
         bool operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const;
 
     private:
-        uint8* m_sort;
-        Player* m_viewPlayer;
+        uint8 const* m_sort;
+        int m_locale;                                       // db locale index of the viewer, for sorting by name
 };
 
 enum AuctionHouseType
@@ -195,8 +270,11 @@ class AuctionHouseMgr
 
         void Update();
 
+        AuctionSearchWorkers& GetSearchWorkers() { return *m_searchWorkers; }
+
     private:
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
+        std::unique_ptr<AuctionSearchWorkers> m_searchWorkers;
 
         ItemMap             mAitems;
 };
@@ -0,0 +1,305 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AuctionHouse/AuctionHouseSearch.h"
+#include "Entities/Item.h"
+#include "Entities/Player.h"
+#include "Server/Opcodes.h"
+#include "Server/WorldSession.h"
+#include "World/World.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+// layout written by AuctionEntry::BuildAuctionInfo: id, entry, enchantments, random property, suffix factor, count,
+// charges, flags, owner, start bid, outbid and buyout, then the time left, bidder and bid
+#define AUCTION_INFO_TIME_LEFT_POS  (4 + 4 + MAX_INSPECTED_ENCHANTMENT_SLOT * 3 * 4 + 4 * 5 + 8 + 4 * 3)
+#define AUCTION_INFO_SIZE           (AUCTION_INFO_TIME_LEFT_POS + 4 + 8 + 4)
+
+AuctionHouseSnapshot::AuctionHouseSnapshot(AuctionHouseObject const& auctionHouse, uint64 epoch) :
+    m_epoch(epoch), m_indexed(false)
+{
+    AuctionHouseObject::AuctionEntryMap const& auctions = auctionHouse.GetAuctions();
+    m_auctions.reserve(auctions.size());
+    m_infos.reserve(auctions.size() * AUCTION_INFO_SIZE);
+
+    for (auto const& itr : auctions)
+    {
+        AuctionEntry const* auction = itr.second;
+
+        // pending auctions are never listed, nor those whose item is missing
+        if (auction->moneyDeliveryTime || !sAuctionMgr.GetAItem(auction->itemGuidLow))
+            continue;
+
+        size_t const pos = m_infos.wpos();
+        auction->BuildAuctionInfo(m_infos);
+        MANGOS_ASSERT(m_infos.wpos() - pos == AUCTION_INFO_SIZE);
+
+        m_auctions.push_back(*auction);
+    }
+}
+
+void AuctionHouseSnapshot::Find(std::vector<AuctionEntry*>& result, int locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+                                uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality) const
+{
+    std::lock_guard<std::mutex> lock(m_indexLock);
+
+    if (!m_indexed)
+    {
+        // the entries are never changed, the index only wants them non const
+        for (AuctionEntry const& auction : m_auctions)
+            m_index.Add(const_cast<AuctionEntry*>(&auction));
+        m_indexed = true;
+    }
+
+    m_index.Find(result, locale, wsearchedname, levelmin, levelmax, inventoryType, itemClass, itemSubClass, quality);
+}
+
+void AuctionHouseSnapshot::GetAll(std::vector<AuctionEntry*>& result) const
+{
+    result.reserve(result.size() + m_auctions.size());
+    for (AuctionEntry const& auction : m_auctions)
+        result.push_back(const_cast<AuctionEntry*>(&auction));
+}
+
+AuctionEntry const* AuctionHouseSnapshot::GetAuction(uint32 id) const
+{
+    auto itr = std::lower_bound(m_auctions.begin(), m_auctions.end(), id, [](AuctionEntry const& auction, uint32 id) { return auction.Id < id; });
+    return itr != m_auctions.end() && itr->Id == id ? &*itr : nullptr;
+}
+
+void AuctionHouseSnapshot::BuildAuctionInfo(WorldPacket& data, AuctionEntry const* auction) const
+{
+    size_t const pos = data.wpos();
+    data.append(m_infos.contents() + (auction - m_auctions.data()) * AUCTION_INFO_SIZE, AUCTION_INFO_SIZE);
+    data.put<uint32>(pos + AUCTION_INFO_TIME_LEFT_POS, uint32((auction->expireTime - time(nullptr)) * IN_MILLISECONDS));
+}
+
+void AuctionHouseSnapshot::BuildListOwnerItems(WorldPacket& data, uint32 owner, uint32 listfrom, uint32& count, uint32& totalcount) const
+{
+    for (AuctionEntry const& auction : m_auctions)
+    {
+        if (auction.owner != owner)
+            continue;
+
+        if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
+        {
+            BuildAuctionInfo(data, &auction);
+            ++count;
+        }
+        ++totalcount;
+    }
+}
+
+void AuctionHouseSnapshot::BuildListBidderItems(WorldPacket& data, uint32 bidder, uint32 listfrom, uint32& count, uint32& totalcount) const
+{
+    for (AuctionEntry const& auction : m_auctions)
+    {
+        if (auction.bidder != bidder)
+            continue;
+
+        if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
+        {
+            BuildAuctionInfo(data, &auction);
+            ++count;
+        }
+        ++totalcount;
+    }
+}
+
+void AuctionSearchWorkers::activate(size_t numThreads)
+{
+    if (activated() || !numThreads)
+        return;
+
+    m_cancelationToken = false;
+    for (size_t i = 0; i < numThreads; ++i)
+        m_threads.emplace_back(&AuctionSearchWorkers::WorkerThread, this);
+}
+
+void AuctionSearchWorkers::deactivate()
+{
+    if (!activated())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cancelationToken = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+
+    m_queue.clear();
+    m_results.clear();
+}
+
+void AuctionSearchWorkers::Queue(AuctionSearchRequest&& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto itr = std::find_if(m_queue.begin(), m_queue.end(), [&request](AuctionSearchRequest const& queued)
+        {
+            return queued.accountId == request.accountId && queued.type == request.type;
+        });
+
+        if (itr != m_queue.end())
+        {
+            *itr = std::move(request);
+            return;
+        }
+
+        m_queue.push_back(std::move(request));
+    }
+
+    m_condition.notify_one();
+}
+
+void AuctionSearchWorkers::SendResults()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(m_resultLock);
+        if (m_results.empty())
+            return;
+
+        results.swap(m_results);
+    }
+
+    for (Result& result : results)
+    {
+        WorldSession* session = sWorld.FindSession(result.accountId);
+        if (!session || !session->GetPlayer() || session->GetPlayer()->GetGUIDLow() != result.playerGuid)
+            continue;
+
+        session->SendPacket(result.packet);
+    }
+}
+
+void AuctionSearchWorkers::WorkerThread()
+{
+    while (true)
+    {
+        AuctionSearchRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+            if (m_cancelationToken)
+                return;
+
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        Result result;
+        result.accountId = request.accountId;
+        result.playerGuid = request.playerGuid;
+        Process(request, result.packet);
+
+        std::lock_guard<std::mutex> lock(m_resultLock);
+        m_results.push_back(std::move(result));
+    }
+}
+
+void AuctionSearchWorkers::Process(AuctionSearchRequest const& request, WorldPacket& packet)
+{
+#ifdef BUILD_METRICS
+    std::chrono::steady_clock::time_point searchStart = std::chrono::steady_clock::now();
+#endif
+
+    AuctionHouseSnapshot const& snapshot = *request.snapshot;
+    uint32 count = 0;
+    uint32 totalcount = 0;
+#ifdef BUILD_METRICS
+    size_t candidates = 0;
+#endif
+
+    switch (request.type)
+    {
+        case AUCTION_SEARCH_LIST_ITEMS:
+        {
+            packet.Initialize(SMSG_AUCTION_LIST_RESULT, (4 + 4 + 4));
+            packet << uint32(0);
+
+            std::vector<AuctionEntry*> auctions;
+            if (request.isFull)
+                snapshot.GetAll(auctions);
+            else
+                snapshot.Find(auctions, request.locale, request.wsearchedname, request.levelmin, request.levelmax,
+                              request.inventoryType, request.itemClass, request.itemSubClass, request.quality);
+
+            AuctionSorter sorter(request.sort, request.locale);
+            std::sort(auctions.begin(), auctions.end(), sorter);
+
+            for (AuctionEntry const* auction : auctions)
+            {
+                if (request.isFull || (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= request.listfrom))
+                {
+                    ++count;
+                    snapshot.BuildAuctionInfo(packet, auction);
+                }
+                ++totalcount;
+            }
+
+#ifdef BUILD_METRICS
+            candidates = auctions.size();
+#endif
+            break;
+        }
+        case AUCTION_SEARCH_LIST_OWNER:
+            packet.Initialize(SMSG_AUCTION_OWNER_LIST_RESULT, (4 + 4 + 4));
+            packet << uint32(0);
+            snapshot.BuildListOwnerItems(packet, request.playerGuid, request.listfrom, count, totalcount);
+            break;
+        case AUCTION_SEARCH_LIST_BIDDER:
+            packet.Initialize(SMSG_AUCTION_BIDDER_LIST_RESULT, (4 + 4 + 4));
+            packet << uint32(0);
+            for (uint32 outbiddedAuctionId : request.outbidded)
+            {
+                if (AuctionEntry const* auction = snapshot.GetAuction(outbiddedAuctionId))
+                {
+                    snapshot.BuildAuctionInfo(packet, auction);
+                    ++totalcount;
+                    ++count;
+                }
+            }
+            snapshot.BuildListBidderItems(packet, request.playerGuid, request.listfrom, count, totalcount);
+            break;
+    }
+
+    packet.put<uint32>(0, count);
+    packet << uint32(totalcount);
+    packet << uint32(300);                                  // 2.3.0 delay for next isFull request?
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("auction.search", { { "house_id", std::to_string(request.houseId) }, { "type", std::to_string(request.type) } });
+    meas.add_field("duration", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - searchStart).count()));
+    meas.add_field("candidates", std::to_string(candidates));
+    meas.add_field("results", std::to_string(totalcount));
+    meas.add_field("full", std::to_string(request.type == AUCTION_SEARCH_LIST_ITEMS && request.isFull));
+    meas.add_field("epoch", std::to_string(snapshot.GetEpoch()));
+#endif
+}
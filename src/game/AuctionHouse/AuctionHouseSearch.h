@@ -0,0 +1,143 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_AUCTION_HOUSE_SEARCH_H
+#define MANGOS_AUCTION_HOUSE_SEARCH_H
+
+#include "Common.h"
+#include "AuctionHouse/AuctionHouseMgr.h"
+#include "ByteBuffer.h"
+#include "WorldPacket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// copy of the listable auctions of one auction house, taken on the world thread and only read afterwards.
+// the item part of every auction packet is serialized when taking it, the search index is built by the
+// first search that needs it
+class AuctionHouseSnapshot
+{
+    public:
+        AuctionHouseSnapshot(AuctionHouseObject const& auctionHouse, uint64 epoch);
+        AuctionHouseSnapshot(AuctionHouseSnapshot const&) = delete;
+
+        uint64 GetEpoch() const { return m_epoch; }
+        size_t GetCount() const { return m_auctions.size(); }
+
+        void Find(std::vector<AuctionEntry*>& result, int locale, std::wstring const& wsearchedname, uint32 levelmin, uint32 levelmax,
+                  uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality) const;
+        void GetAll(std::vector<AuctionEntry*>& result) const;
+        AuctionEntry const* GetAuction(uint32 id) const;
+
+        // same packet part as AuctionEntry::BuildAuctionInfo, with the time left taken now
+        void BuildAuctionInfo(WorldPacket& data, AuctionEntry const* auction) const;
+
+        void BuildListOwnerItems(WorldPacket& data, uint32 owner, uint32 listfrom, uint32& count, uint32& totalcount) const;
+        void BuildListBidderItems(WorldPacket& data, uint32 bidder, uint32 listfrom, uint32& count, uint32& totalcount) const;
+
+    private:
+        uint64 const m_epoch;
+        std::vector<AuctionEntry> m_auctions;               // ordered by id, like the auction map
+        ByteBuffer m_infos;                                 // packet part of every auction, in the same order
+
+        mutable std::mutex m_indexLock;
+        mutable bool m_indexed;
+        mutable AuctionSearchIndex m_index;                 // points into m_auctions, locales are added while searching
+};
+
+typedef std::shared_ptr<AuctionHouseSnapshot const> AuctionHouseSnapshotPtr;
+
+enum AuctionSearchType
+{
+    AUCTION_SEARCH_LIST_ITEMS,
+    AUCTION_SEARCH_LIST_OWNER,
+    AUCTION_SEARCH_LIST_BIDDER
+};
+
+// list request decoded by the world thread, answered by a search worker from a snapshot
+struct AuctionSearchRequest
+{
+    AuctionSearchType type;
+    uint32 accountId;
+    uint32 playerGuid;                                      // low guid, the answer is dropped if the session changed character
+    uint32 houseId;
+    AuctionHouseSnapshotPtr snapshot;
+    uint32 listfrom;
+
+    // AUCTION_SEARCH_LIST_ITEMS
+    int locale;
+    std::wstring wsearchedname;
+    uint32 levelmin;
+    uint32 levelmax;
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;
+    bool isFull;
+    uint8 sort[MAX_AUCTION_SORT];
+
+    // AUCTION_SEARCH_LIST_BIDDER
+    std::vector<uint32> outbidded;
+};
+
+// threads answering the auction list requests from snapshots. the finished packets are queued and sent by
+// the world thread, which also checks that the session is still there. a request still queued is replaced
+// by a newer one of the same session and type, the client only shows the last answer anyway
+class AuctionSearchWorkers
+{
+    public:
+        AuctionSearchWorkers() : m_cancelationToken(false) {}
+        AuctionSearchWorkers(const AuctionSearchWorkers&) = delete;
+
+        void activate(size_t numThreads);
+        void deactivate();
+        bool activated() const { return !m_threads.empty(); }
+
+        void Queue(AuctionSearchRequest&& request);
+
+        // world thread, sends the answers finished since the last call
+        void SendResults();
+
+    private:
+        struct Result
+        {
+            uint32 accountId;
+            uint32 playerGuid;
+            WorldPacket packet;
+        };
+
+        void WorkerThread();
+        static void Process(AuctionSearchRequest const& request, WorldPacket& packet);
+
+        std::vector<std::thread> m_threads;
+        std::atomic<bool> m_cancelationToken;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<AuctionSearchRequest> m_queue;
+
+        std::mutex m_resultLock;
+        std::vector<Result> m_results;
+};
+
+#endif
@@ -24,13 +24,16 @@
 #include "SystemConfig.h"
 #include "World/World.h"
 
+#include <algorithm>
+
 // Format is YYYYMMDDRR where RR is the change in the conf file
 // for that day.
 #define AUCTIONHOUSEBOT_CONF_VERSION    2021011201
 
 INSTANTIATE_SINGLETON_1(AuctionHouseBot);
 
-AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1)
+AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1),
+    m_rebuildBudget(0), m_rebuildSellActions(0), m_rebuildStartTime(0)
 {
 }
 
@@ -91,9 +94,10 @@ void AuctionHouseBot::Initialize()
         FillUintVectorFromQuery("SELECT entry FROM item_template WHERE entry IN (SELECT EffectItemType1 FROM spell_template WHERE attributes & 32 AND attributes & 65536)", m_professionItems);
 
         // vendor items (used to prevent items being bought from vendor and sold at ah for profit)
-        std::vector<uint32> tmpVector;
-        FillUintVectorFromQuery("SELECT item FROM npc_vendor", tmpVector);
-        std::copy(tmpVector.begin(), tmpVector.end(), std::inserter(m_vendorItems, m_vendorItems.end()));
+        FillUintVectorFromQuery("SELECT item FROM npc_vendor", m_vendorItems);
+        std::sort(m_vendorItems.begin(), m_vendorItems.end());
+        m_vendorItems.erase(std::unique(m_vendorItems.begin(), m_vendorItems.end()), m_vendorItems.end());
+        m_vendorItems.shrink_to_fit();
 
         // item value
         ParseItemValueConfig("AuctionHouseBot.Value.Poor", m_itemValue[ITEM_QUALITY_POOR]);
@@ -131,6 +135,9 @@ void AuctionHouseBot::Initialize()
         // buy item value
         m_buyValue = GetMinMaxConfig("AuctionHouseBot.Buy.Value", 0, 200, 90);
 
+        // time spent on a rebuild each world tick
+        m_rebuildBudget = GetMinMaxConfig("AuctionHouseBot.Rebuild.Budget", 0, 1000, 10);
+
         // overridden items
         QueryResult* result = CharacterDatabase.PQuery("SELECT item, value, add_chance, min_amount, max_amount FROM ahbot_items");
         if (result)
@@ -161,79 +168,12 @@ void AuctionHouseBot::Update()
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(houseType);
     if (m_houseAction < MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceSell)
     {
-        // Sell items
-        std::unordered_map<uint32, uint32> itemMap;
-
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootNormalConfig, m_creatureLootNormalTemplates, itemMap);       // normal creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootEliteConfig, m_creatureLootEliteTemplates, itemMap);         // elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareEliteConfig, m_creatureLootRareEliteTemplates, itemMap); // rare elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootWorldBossConfig, m_creatureLootWorldBossTemplates, itemMap); // world boss creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareConfig, m_creatureLootRareTemplates, itemMap);           // rare creature loot
-
-        AddLootToItemMap(&LootTemplates_Disenchant, m_disenchantLootConfig, m_disenchantLootTemplates, itemMap);             // disenchant loot
-        AddLootToItemMap(&LootTemplates_Fishing, m_fishingLootConfig, m_fishingLootTemplates, itemMap);                      // fishing loot
-        AddLootToItemMap(&LootTemplates_Gameobject, m_gameobjectLootConfig, m_gameobjectLootTemplates, itemMap);             // gameobject loot
-        AddLootToItemMap(&LootTemplates_Skinning, m_skinningLootConfig, m_skinningLootTemplates, itemMap);                   // skinning loot
-
-        // profession items are a bit different (not looted)
-        if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
-        {
-            int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
-            if (maxTemplates > 0)
-            {
-                for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
-                {
-                    uint32 item = m_professionItems[urand(0, m_professionItems.size() - 1)];
-                    ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(item);
-                    if (!prototype || prototype->Quality == 0 || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
-                        continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
-                    uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
-                    if (count <= 0)
-                        count = 1;
-                    itemMap[item] += count;
-                }
-            }
-        }
-
-        // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
-        for (auto& itemData : m_itemData)
-        {
-            if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
-                itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
-        }
-
-        for (auto& itemEntry : itemMap)
-        {
-            ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
-            if (!prototype || prototype->GetMaxStackSize() == 0)
-                continue; // really shouldn't happen, but better safe than sorry
-            auto iterator = m_itemData.find(prototype->ItemId);
-            if (iterator != m_itemData.end() && iterator->second.Value == 0)
-                continue; // item is blacklisted
-            if (iterator == m_itemData.end() || iterator->second.AddChance == 0)
-            {
-                if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
-                    continue; // no BoP and quest items
-                if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
-                    continue; // nor items containing loot
-                if (m_itemValue[prototype->Quality][prototype->Class] == 0)
-                    continue; // item class is filtered out
-            }
-
-            uint32 itemValue = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
-            for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
-            {
-                uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
-                uint32 buyoutPrice = itemValue * count;
-                Item* item = Item::CreateItem(itemEntry.first, count);
-                if (buyoutPrice == 0 || !item)
-                    continue; // don't put up items we don't know the value of
-                uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
-                if (item)
-                    auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(houseType == AUCTION_HOUSE_ALLIANCE ? 1 : (houseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, bidPrice, buyoutPrice);
-            }
-        }
-    } else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
+        // Sell items, the new auctions and items are written in one transaction
+        CharacterDatabase.BeginTransaction();
+        SellItems(houseType);
+        CharacterDatabase.CommitTransaction();
+    }
+    else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
     {
         // Buy items
         AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
@@ -268,6 +208,83 @@ void AuctionHouseBot::Update()
     }
 }
 
+void AuctionHouseBot::SellItems(AuctionHouseType houseType)
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(houseType);
+
+    std::unordered_map<uint32, uint32> itemMap;
+
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootNormalConfig, m_creatureLootNormalTemplates, itemMap);       // normal creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootEliteConfig, m_creatureLootEliteTemplates, itemMap);         // elite creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareEliteConfig, m_creatureLootRareEliteTemplates, itemMap); // rare elite creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootWorldBossConfig, m_creatureLootWorldBossTemplates, itemMap); // world boss creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareConfig, m_creatureLootRareTemplates, itemMap);           // rare creature loot
+
+    AddLootToItemMap(&LootTemplates_Disenchant, m_disenchantLootConfig, m_disenchantLootTemplates, itemMap);             // disenchant loot
+    AddLootToItemMap(&LootTemplates_Fishing, m_fishingLootConfig, m_fishingLootTemplates, itemMap);                      // fishing loot
+    AddLootToItemMap(&LootTemplates_Gameobject, m_gameobjectLootConfig, m_gameobjectLootTemplates, itemMap);             // gameobject loot
+    AddLootToItemMap(&LootTemplates_Skinning, m_skinningLootConfig, m_skinningLootTemplates, itemMap);                   // skinning loot
+
+    // profession items are a bit different (not looted)
+    if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
+    {
+        int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
+        if (maxTemplates > 0)
+        {
+            for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
+            {
+                uint32 item = m_professionItems[urand(0, m_professionItems.size() - 1)];
+                ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(item);
+                if (!prototype || prototype->Quality == 0 || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
+                    continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
+                uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
+                if (count <= 0)
+                    count = 1;
+                itemMap[item] += count;
+            }
+        }
+    }
+
+    // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
+    for (auto& itemData : m_itemData)
+    {
+        if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
+            itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
+    }
+
+    for (auto& itemEntry : itemMap)
+    {
+        ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
+        if (!prototype || prototype->GetMaxStackSize() == 0)
+            continue; // really shouldn't happen, but better safe than sorry
+        auto iterator = m_itemData.find(prototype->ItemId);
+        if (iterator != m_itemData.end() && iterator->second.Value == 0)
+            continue; // item is blacklisted
+        if (iterator == m_itemData.end() || iterator->second.AddChance == 0)
+        {
+            if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
+                continue; // no BoP and quest items
+            if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
+                continue; // nor items containing loot
+            if (m_itemValue[prototype->Quality][prototype->Class] == 0)
+                continue; // item class is filtered out
+        }
+
+        uint32 itemValue = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
+        for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
+        {
+            uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
+            uint32 buyoutPrice = itemValue * count;
+            Item* item = Item::CreateItem(itemEntry.first, count);
+            if (buyoutPrice == 0 || !item)
+                continue; // don't put up items we don't know the value of
+            uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
+            if (item)
+                auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(houseType == AUCTION_HOUSE_ALLIANCE ? 1 : (houseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, bidPrice, buyoutPrice);
+        }
+    }
+}
+
 bool AuctionHouseBot::ReloadAllConfig()
 {
     Initialize();
@@ -277,28 +294,78 @@ bool AuctionHouseBot::ReloadAllConfig()
 void AuctionHouseBot::Rebuild(bool all)
 {
     sLog.outString("AHBot: Rebuilding auction house items");
+    m_rebuildExpired.clear();
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
             if (!entry->owner)
             {
-                // ahbot auction
-                if (all || entry->bid == 0) // expire auction if no bid or forced
+                // ahbot auction, removed by the rebuild if there is no bid, else expired if forced
+                if (entry->bid == 0)
+                    m_rebuildExpired.push_back(std::make_pair(AuctionHouseType(i), entry->Id));
+                else if (all)
                     entry->expireTime = sWorld.GetGameTime();
             }
         }
+        auctionHouse->MarkChanged();
     }
     // refill auction house with items, simulating typical max amount of items available after some time
-    uint32 updateCounter = ((m_auctionTimeMax - m_auctionTimeMin) / 2 + m_auctionTimeMin) * 90;
-    for (uint32 i = 0; i < updateCounter; ++i)
+    m_rebuildSellActions = ((m_auctionTimeMax - m_auctionTimeMin) / 2 + m_auctionTimeMin) * 90;
+    m_rebuildStartTime = WorldTimer::getMSTime();
+
+    // without budget the whole rebuild is done now, else it goes on in the next world ticks
+    if (!m_rebuildBudget)
+        ContinueRebuild(0);
+}
+
+void AuctionHouseBot::ContinueRebuild(uint32 budget)
+{
+    uint32 const start = WorldTimer::getMSTime();
+    auto outOfTime = [&]()
     {
-        if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE - 1)
-            m_houseAction = -1; // this prevents AHBot from buying items when refilling
-        Update();
+        return budget && WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime()) >= budget;
+    };
+
+    CharacterDatabase.BeginTransaction();
+
+    while (!m_rebuildExpired.empty() && !outOfTime())
+    {
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(m_rebuildExpired.back().first);
+        AuctionEntry* auction = auctionHouse->GetAuction(m_rebuildExpired.back().second);
+        m_rebuildExpired.pop_back();
+
+        // a player may have bid on it since the rebuild started
+        if (!auction || auction->bid || auction->moneyDeliveryTime)
+            continue;
+
+        // what the expiry would do for an auction without owner, minus looking the owner up
+        if (Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow))
+        {
+            CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid='%u'", auction->itemGuidLow);
+            sAuctionMgr.RemoveAItem(auction->itemGuidLow);
+            delete item;
+        }
+
+        auction->DeleteFromDB();
+        auctionHouse->RemoveAuction(auction->Id);
+        delete auction;
+    }
+
+    while (m_rebuildExpired.empty() && m_rebuildSellActions && !outOfTime())
+    {
+        --m_rebuildSellActions;
+        if (urand(0, 99) < m_chanceSell)
+            SellItems(AuctionHouseType(m_rebuildSellActions % MAX_AUCTION_HOUSE_TYPE));
     }
+
+    CharacterDatabase.CommitTransaction();
+
+    if (!IsRebuilding())
+        sLog.outString("AHBot: Rebuild done in %u ms", WorldTimer::getMSTimeDiff(m_rebuildStartTime, WorldTimer::getMSTime()));
 }
 
 void AuctionHouseBot::PrepareStatusInfos(AuctionHouseBotStatusInfo& statusInfo) const
@@ -492,7 +559,7 @@ uint32 AuctionHouseBot::CalculateBuyoutPrice(ItemPrototype const* prototype)
         buyoutPrice = prototype->SellPrice * (prototype->Quality <= ITEM_QUALITY_NORMAL ? 4 : 5);
     // multiply buyoutPrice with item quality price percentage
     // if item is sold by a vendor and vendor value is forced, then multiply by 100 (setting vendor price)
-    buyoutPrice *= (m_vendorValue && m_vendorItems.find(prototype->ItemId) != m_vendorItems.end() ? 100 : m_itemValue[prototype->Quality][prototype->Class]);
+    buyoutPrice *= (m_vendorValue && std::binary_search(m_vendorItems.begin(), m_vendorItems.end(), prototype->ItemId) ? 100 : m_itemValue[prototype->Quality][prototype->Class]);
     buyoutPrice /= 100; // since we multiplied with m_itemValue
     return buyoutPrice;
 }
@@ -51,6 +51,9 @@ class AuctionHouseBot
         void Initialize();
         void SetConfigFileName(const std::string& filename) { m_configFileName = filename; }
         void Update();
+        // called every world tick, goes on with a rebuild for at most AuctionHouseBot.Rebuild.Budget ms
+        void UpdateRebuild() { if (IsRebuilding()) ContinueRebuild(m_rebuildBudget); }
+        bool IsRebuilding() const { return m_rebuildSellActions || !m_rebuildExpired.empty(); }
 
         // Following methods are mainly used by level3.cpp for ingame/console commands
         bool ReloadAllConfig();
@@ -60,6 +63,9 @@ class AuctionHouseBot
         AuctionHouseBotItemData GetItemData(uint32 item);
 
     private:
+        void SellItems(AuctionHouseType houseType);
+        void ContinueRebuild(uint32 budget);
+
         uint32 GetMinMaxConfig(const char* config, uint32 minValue, uint32 maxValue, uint32 defaultValue);
         void ParseLootConfig(char const* fieldname, std::vector<int32>& lootConfig);
         void FillUintVectorFromQuery(char const* query, std::vector<uint32>& lootTemplates);
@@ -107,7 +113,13 @@ class AuctionHouseBot
         std::vector<uint32> m_skinningLootTemplates;
         std::vector<uint32> m_professionItems;
 
-        std::unordered_set<uint32> m_vendorItems;
+        std::vector<uint32> m_vendorItems;                  // sorted
+
+        // rebuild in progress, the bot auctions left to remove first (house and id) then the sell visits left
+        uint32 m_rebuildBudget;
+        std::vector<std::pair<AuctionHouseType, uint32> > m_rebuildExpired;
+        uint32 m_rebuildSellActions;
+        uint32 m_rebuildStartTime;
 
         std::unordered_map<uint32, AuctionHouseBotItemData> m_itemData;
 };
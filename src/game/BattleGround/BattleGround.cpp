@@ -1023,7 +1023,7 @@ void BattleGround::EndBattleGround(Team winner)
 
         BlockMovement(plr);
 
-        sBattleGroundMgr.BuildPvpLogDataPacket(data, this);
+        GetPvpLogData(data);
         plr->GetSession()->SendPacket(data);
 
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BgQueueTypeId(GetTypeId(), GetArenaType());
@@ -1295,6 +1295,7 @@ void BattleGround::RemovePlayerAtLeave(ObjectGuid playerGuid, bool isOnTransport
     {
         delete itr2->second;                                // delete player's score
         m_playerScores.erase(itr2);
+        InvalidatePvpLogData();
     }
 
     Player* player = sObjectMgr.GetPlayer(playerGuid);
@@ -1486,6 +1487,9 @@ void BattleGround::StartTimedAchievement(AchievementCriteriaTypes type, uint32 e
 */
 void BattleGround::AddPlayer(Player* player)
 {
+    // the subclasses add their score after this
+    InvalidatePvpLogData();
+
     // remove afk from player
     if (player->isAFK())
         player->ToggleAFK();
@@ -1732,6 +1736,8 @@ uint32 BattleGround::GetFreeSlotsForTeam(Team team) const
 */
 void BattleGround::UpdatePlayerScore(Player* player, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     // this procedure is called from virtual function implemented in bg subclass
     BattleGroundScoreMap::const_iterator itr = m_playerScores.find(player->GetObjectGuid());
 
@@ -1771,6 +1777,27 @@ void BattleGround::UpdatePlayerScore(Player* player, uint32 type, uint32 value)
     }
 }
 
+/**
+  Function that returns the log of the battleground scores
+
+  @param    packet
+*/
+void BattleGround::GetPvpLogData(WorldPacket& data)
+{
+    std::lock_guard<std::mutex> guard(m_pvpLogData.lock);
+
+    // the version is taken before the build, a change during the build makes the next request rebuild
+    uint32 version = m_pvpLogData.scoreVersion;
+    if (m_pvpLogData.builtVersion != version)
+    {
+        sBattleGroundMgr.BuildPvpLogDataPacket(m_pvpLogData.data, this);
+        m_pvpLogData.builtVersion = version;
+    }
+
+    data.Initialize(MSG_PVP_LOG_DATA, m_pvpLogData.data.wpos());
+    data.append(static_cast<ByteBuffer const&>(m_pvpLogData.data));
+}
+
 /**
   Method that handles door closing
 
@@ -2252,7 +2279,7 @@ void BattleGround::PlayerAddedToBgCheckIfBgIsRunning(Player* player)
 
     BlockMovement(player);
 
-    sBattleGroundMgr.BuildPvpLogDataPacket(data, this);
+    GetPvpLogData(data);
     player->GetSession()->SendPacket(data);
 
     sBattleGroundMgr.BuildBattleGroundStatusPacket(data, this, player->GetBattleGroundQueueIndex(bgQueueTypeId), STATUS_IN_PROGRESS, GetEndTime(), GetStartTime(), GetArenaType(), player->GetBGTeam());
@@ -25,6 +25,9 @@
 #include "ByteBuffer.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
+#include <mutex>
+
 // magic event-numbers
 #define BG_EVENT_NONE 255
 // those generic events should get a high event id
@@ -391,7 +394,7 @@ class BattleGround
         void SetRandomTypeId(BattleGroundTypeId typeId) { m_randomTypeId = typeId; }
         // here we can count minlevel and maxlevel for players
         void SetBracket(PvPDifficultyEntry const* bracketEntry);
-        void SetStatus(BattleGroundStatus status) { m_status = status; }
+        void SetStatus(BattleGroundStatus status) { m_status = status; InvalidatePvpLogData(); }
         void SetClientInstanceId(uint32 instanceId) { m_clientInstanceId = instanceId; }
         void SetStartTime(uint32 time)      { m_startTime = time; }
         void SetEndTime(uint32 time)        { m_endTime = time; }
@@ -401,7 +404,7 @@ class BattleGround
         void SetRated(bool state)           { m_isRated = state; }
         void SetArenaType(ArenaType type)   { m_arenaType = type; }
         void SetArenaorBGType(bool isArena) { m_isArena = isArena; }
-        void SetWinner(BattleGroundWinner winner) { m_winner = winner; }
+        void SetWinner(BattleGroundWinner winner) { m_winner = winner; InvalidatePvpLogData(); }
         void SetRandom(bool isRandom)       { m_isRandom = isRandom; }
 
         void ModifyStartDelayTime(int diff) { m_startDelayTime -= diff; }
@@ -441,6 +444,11 @@ class BattleGround
         BattleGroundScoreMap::const_iterator GetPlayerScoresEnd() const { return m_playerScores.end(); }
         uint32 GetPlayerScoresSize() const { return m_playerScores.size(); }
 
+        // MSG_PVP_LOG_DATA of the current scores, only rebuilt after they changed
+        void GetPvpLogData(WorldPacket& data);
+        // to call on every change of the scores or of anything else shown in the log
+        void InvalidatePvpLogData() { ++m_pvpLogData.scoreVersion; }
+
         // Function which starts the battleground
         void StartBattleGround();
 
@@ -552,9 +560,9 @@ class BattleGround
         }
 
         // Arena specific functions
-        void SetArenaTeamIdForTeam(Team team, uint32 arenaTeamId) { m_arenaTeamIds[GetTeamIndexByTeamId(team)] = arenaTeamId; }
+        void SetArenaTeamIdForTeam(Team team, uint32 arenaTeamId) { m_arenaTeamIds[GetTeamIndexByTeamId(team)] = arenaTeamId; InvalidatePvpLogData(); }
         uint32 GetArenaTeamIdForTeam(Team team) const             { return m_arenaTeamIds[GetTeamIndexByTeamId(team)]; }
-        void SetArenaTeamRatingChangeForTeam(Team team, int32 ratingChange) { m_arenaTeamRatingChanges[GetTeamIndexByTeamId(team)] = ratingChange; }
+        void SetArenaTeamRatingChangeForTeam(Team team, int32 ratingChange) { m_arenaTeamRatingChanges[GetTeamIndexByTeamId(team)] = ratingChange; InvalidatePvpLogData(); }
         int32 GetArenaTeamRatingChangeForTeam(Team team) const    { return m_arenaTeamRatingChanges[GetTeamIndexByTeamId(team)]; }
         void CheckArenaWinConditions();
 
@@ -691,6 +699,19 @@ class BattleGround
 
         /* Scorekeeping */
         BattleGroundScoreMap m_playerScores;                // Player scores
+        struct PvpLogDataCache
+        {
+            PvpLogDataCache() : scoreVersion(1), builtVersion(0) {}
+            // the instances are copied from the templates, which never have scores
+            PvpLogDataCache(PvpLogDataCache const& /*other*/) : PvpLogDataCache() {}
+            PvpLogDataCache& operator=(PvpLogDataCache const&) = delete;
+
+            std::atomic<uint32> scoreVersion;               // changes of the scores, built into the cached log when different
+            uint32 builtVersion;
+            WorldPacket data;
+            std::mutex lock;
+        };
+        PvpLogDataCache m_pvpLogData;
 
         // can be implemented in BG subclass - player can be nullptr
         virtual void RemovePlayer(Player* /*player*/, ObjectGuid /*guid*/);
@@ -496,6 +496,8 @@ void BattleGroundAB::EndBattleGround(Team winner)
 
 void BattleGroundAB::UpdatePlayerScore(Player* source, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(source->GetObjectGuid());
     if (itr == m_playerScores.end())                        // player not found...
         return;
@@ -452,6 +452,8 @@ bool BattleGroundAV::HandleAreaTrigger(Player* source, uint32 trigger)
 
 void BattleGroundAV::UpdatePlayerScore(Player* source, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(source->GetObjectGuid());
     if (itr == m_playerScores.end())                        // player not found...
         return;
@@ -594,6 +594,8 @@ void BattleGroundEY::ProcessPlayerFlagScoreEvent(Player* source, EYNodes node)
 
 void BattleGroundEY::UpdatePlayerScore(Player* source, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(source->GetObjectGuid());
     if (itr == m_playerScores.end())                        // player not found
         return;
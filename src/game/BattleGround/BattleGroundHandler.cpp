@@ -347,7 +347,7 @@ void WorldSession::HandlePVPLogDataOpcode(WorldPacket& /*recv_data*/)
         return;
 
     WorldPacket data;
-    sBattleGroundMgr.BuildPvpLogDataPacket(data, bg);
+    bg->GetPvpLogData(data);
     SendPacket(data);
 
     DEBUG_LOG("WORLD: Sent MSG_PVP_LOG_DATA Message");
@@ -183,6 +183,8 @@ void BattleGroundIC::StartingEventOpenDoors()
 
 void BattleGroundIC::UpdatePlayerScore(Player* source, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(source->GetObjectGuid());
 
     if (itr == m_playerScores.end())                        // player not found...
@@ -1271,7 +1271,7 @@ void BgQueueRemoveEvent::Abort(uint64 /*e_time*/)
 /***            BATTLEGROUND MANAGER                   ***/
 /*********************************************************/
 
-BattleGroundMgr::BattleGroundMgr() : m_nextAutoDistributionTime(0), m_autoDistributionTimeChecker(0), m_arenaTesting(false)
+BattleGroundMgr::BattleGroundMgr() : m_weekendWorldStateCount(0), m_weekendWorldStatesVersion(0), m_nextAutoDistributionTime(0), m_autoDistributionTimeChecker(0), m_arenaTesting(false)
 {
     for (uint8 i = BATTLEGROUND_TYPE_NONE; i < MAX_BATTLEGROUND_TYPE_ID; ++i)
         m_battleGrounds[i].clear();
@@ -1312,17 +1312,24 @@ void BattleGroundMgr::Update(uint32 diff)
     if (!m_queueUpdateScheduler.empty())
     {
         std::vector<uint64> scheduled;
-        {
-            // create mutex
-            // std::lock_guard<std::mutex> guard(SchedulerLock);
-            // copy vector and clear the other
-            scheduled = std::vector<uint64>(m_queueUpdateScheduler);
-            m_queueUpdateScheduler.clear();
-            // release lock
-        }
+        scheduled.swap(m_queueUpdateScheduler);
 
-        for (unsigned long long i : scheduled)
+        uint32 const budget = sWorld.getConfig(CONFIG_UINT32_MATCHMAKING_UPDATE_BUDGET);
+        std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+        for (size_t index = 0; index < scheduled.size(); ++index)
         {
+            // over the budget, the rest is updated first next time
+            if (budget && index && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(budget))
+            {
+                std::vector<uint64> left(scheduled.begin() + index, scheduled.end());
+                for (uint64 scheduleId : m_queueUpdateScheduler)
+                    if (std::find(left.begin(), left.end(), scheduleId) == left.end())
+                        left.push_back(scheduleId);
+                m_queueUpdateScheduler.swap(left);
+                break;
+            }
+
+            uint64 const i = scheduled[index];
             uint32 arenaRating = i >> 32;
             ArenaType arenaType = ArenaType(i >> 24 & 255);
             BattleGroundQueueTypeId bgQueueTypeId = BattleGroundQueueTypeId(i >> 16 & 255);
@@ -2098,14 +2105,17 @@ void BattleGroundMgr::DistributeArenaPoints() const
         }
     }
 
+    // the points and the team rows of the whole week are written as one transaction at the end
+    ArenaTeamSaveBatch batch;
+
     // cycle that gives points to all players
     for (auto& PlayerPoint : PlayerPoints)
     {
-        // update to database
-        CharacterDatabase.PExecute("UPDATE characters SET arenaPoints = arenaPoints + '%u' WHERE guid = '%u'", PlayerPoint.second, PlayerPoint.first);
-        // add points if player is online
-        if (Player* pl = sObjectMgr.GetPlayer(ObjectGuid(HIGHGUID_PLAYER, PlayerPoint.first)))
-            pl->ModifyArenaPoints(PlayerPoint.second);
+        batch.AddArenaPoints(PlayerPoint.first, PlayerPoint.second);
+        // add points if player is online, runs after the map updates
+        if (PlayerPoint.second)
+            if (Player* pl = sObjectMgr.GetPlayer(ObjectGuid(HIGHGUID_PLAYER, PlayerPoint.first)))
+                pl->ModifyArenaPoints(PlayerPoint.second);
     }
 
     PlayerPoints.clear();
@@ -2118,11 +2128,13 @@ void BattleGroundMgr::DistributeArenaPoints() const
         if (ArenaTeam* at = titr->second)
         {
             at->FinishWeek();                              // set played this week etc values to 0 in memory, too
-            at->SaveToDB();                                // save changes
+            at->SaveToDB(batch);                           // save changes
             at->NotifyStatsChanged();                      // notify the players of the changes
         }
     }
 
+    batch.Flush();
+
     sWorld.SendWorldTextToAboveSecurity(SEC_GAMEMASTER, LANG_DIST_ARENA_POINTS_TEAM_END);
 
     sWorld.SendWorldTextToAboveSecurity(SEC_GAMEMASTER, LANG_DIST_ARENA_POINTS_END);
@@ -2346,15 +2358,17 @@ void BattleGroundMgr::RewardArenaSeason(uint32 seasonId)
 */
 void BattleGroundMgr::ResetAllArenaData()
 {
+    ArenaTeamSaveBatch batch;
     for (ObjectMgr::ArenaTeamMap::iterator titr = sObjectMgr.GetArenaTeamMapBegin(); titr != sObjectMgr.GetArenaTeamMapEnd(); ++titr)
     {
         if (ArenaTeam* at = titr->second)
         {
             at->FinishSeason();                            // set all values back to default
-            at->SaveToDB();                                // save changes
+            at->SaveToDB(batch);                           // save changes
             at->NotifyStatsChanged();                      // notify the players of the changes
         }
     }
+    batch.Flush();
 }
 
 /**
@@ -2749,6 +2763,30 @@ bool BattleGroundMgr::IsBgWeekend(BattleGroundTypeId bgTypeId)
     return sGameEventMgr.IsActiveHoliday(BgTypeToWeekendHolidayId(bgTypeId));
 }
 
+void BattleGroundMgr::FillWeekendWorldStates(ByteBuffer& data, uint32& count)
+{
+    uint32 version = sGameEventMgr.GetActiveEventsVersion();
+
+    std::lock_guard<std::mutex> guard(m_weekendWorldStatesLock);
+    if (m_weekendWorldStatesVersion != version)
+    {
+        m_weekendWorldStates.clear();
+        m_weekendWorldStateCount = 0;
+
+        for (uint32 i = 1; i < sBattlemasterListStore.GetNumRows(); ++i)
+        {
+            BattlemasterListEntry const* bl = sBattlemasterListStore.LookupEntry(i);
+            if (bl && bl->HolidayWorldStateId)
+                FillInitialWorldState(m_weekendWorldStates, m_weekendWorldStateCount, bl->HolidayWorldStateId, uint32(IsBgWeekend(BattleGroundTypeId(bl->id)) ? 1 : 0));
+        }
+
+        m_weekendWorldStatesVersion = version;
+    }
+
+    data.append(m_weekendWorldStates);
+    count += m_weekendWorldStateCount;
+}
+
 /**
   Method that loads battleground events used in battleground scripts
 */
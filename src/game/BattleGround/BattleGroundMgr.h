@@ -288,8 +288,16 @@ class BattleGroundMgr
         static BattleGroundTypeId WeekendHolidayIdToBgType(HolidayIds /*holiday*/);
         static bool IsBgWeekend(BattleGroundTypeId /*bgTypeId*/);
 
+        // holiday world states of all battlegrounds, the same in every zone; serialized once per change of the active events
+        void FillWeekendWorldStates(ByteBuffer& data, uint32& count);
+
     private:
         std::mutex schedulerLock;
+
+        std::mutex m_weekendWorldStatesLock;                // filled by the map threads
+        ByteBuffer m_weekendWorldStates;
+        uint32 m_weekendWorldStateCount;
+        uint32 m_weekendWorldStatesVersion;                 // of the active events it was built for, 0 if not built
         BattleMastersMap m_battleMastersMap;
         CreatureBattleEventIndexesMap m_creatureBattleEventIndexMap;
         GameObjectBattleEventIndexesMap m_gameObjectBattleEventIndexMap;
@@ -299,6 +299,8 @@ void BattleGroundSA::SetupGraveyards()
 
 void BattleGroundSA::UpdatePlayerScore(Player* source, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(source->GetObjectGuid());
     if (itr == m_playerScores.end())
         return;
@@ -610,6 +610,8 @@ void BattleGroundWS::HandleKillPlayer(Player* player, Player* killer)
 
 void BattleGroundWS::UpdatePlayerScore(Player* player, uint32 type, uint32 value)
 {
+    InvalidatePvpLogData();
+
     BattleGroundScoreMap::iterator itr = m_playerScores.find(player->GetObjectGuid());
     if (itr == m_playerScores.end())                        // player not found
         return;
@@ -136,7 +136,7 @@ class BattlefieldPlayer
         uint32 removeDelay;
 };
 
-typedef std::map<ObjectGuid /*playerGuid*/, BattlefieldPlayer* /*playerData*/> BattlefieldPlayerDataMap;
+typedef std::unordered_map<ObjectGuid /*playerGuid*/, BattlefieldPlayer* /*playerData*/> BattlefieldPlayerDataMap;
 
 class Battlefield : public OutdoorPvP
 {
@@ -31,6 +31,10 @@ BattlefieldWG::BattlefieldWG() : Battlefield()
     m_zoneId            = ZONE_ID_WINTERGRASP;
     m_battleFieldId     = BATTLEFIELD_WG;
 
+    // no value sent yet, the first update sends all timer states
+    for (uint32& value : m_sentTimerStates)
+        value = uint32(-1);
+
     Reset();
 }
 
@@ -1091,21 +1095,33 @@ void BattlefieldWG::CleanupBattlefield(const WorldObject* objRef, Team winner)
 void BattlefieldWG::SendUpdateGeneralWorldStates()
 {
     // update global states
-    SendUpdateWorldState(WORLD_STATE_WG_SHOW_COOLDOWN, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
-    SendUpdateWorldState(WORLD_STATE_WG_TIME_TO_NEXT_BATTLE, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? uint32(time(nullptr) + m_timer / 1000) : 0);
-
-    SendUpdateWorldState(WORLD_STATE_WG_SHOW_BATTLE, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
-    SendUpdateWorldState(WORLD_STATE_WG_TIME_TO_END, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? uint32(time(nullptr) + m_timer / 1000) : 0);
+    WorldStateValueList states = GetTimerWorldStates();
+    for (size_t i = 0; i < states.size(); ++i)
+        m_sentTimerStates[i] = states[i].second;
 
     // team specific world states
-    SendUpdateWorldState(WORLD_STATE_WG_ALLIANCE_DEFENDER, GetDefender() == ALLIANCE ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
-    SendUpdateWorldState(WORLD_STATE_WG_HORDE_DEFENDER, GetDefender() == HORDE ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
+    states.emplace_back(WORLD_STATE_WG_ALLIANCE_DEFENDER, GetDefender() == ALLIANCE ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
+    states.emplace_back(WORLD_STATE_WG_HORDE_DEFENDER, GetDefender() == HORDE ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
+
+    states.emplace_back(WORLD_STATE_WG_VEHICLE_A, uint32(m_activeVehiclesGuids[TEAM_INDEX_ALLIANCE].size()));
+    states.emplace_back(WORLD_STATE_WG_MAX_VEHICLE_A, m_workshopCount[TEAM_INDEX_ALLIANCE] * 4);
 
-    SendUpdateWorldState(WORLD_STATE_WG_VEHICLE_A, uint32(m_activeVehiclesGuids[TEAM_INDEX_ALLIANCE].size()));
-    SendUpdateWorldState(WORLD_STATE_WG_MAX_VEHICLE_A, m_workshopCount[TEAM_INDEX_ALLIANCE] * 4);
+    states.emplace_back(WORLD_STATE_WG_VEHICLE_H, uint32(m_activeVehiclesGuids[TEAM_INDEX_HORDE].size()));
+    states.emplace_back(WORLD_STATE_WG_MAX_VEHICLE_H, m_workshopCount[TEAM_INDEX_HORDE] * 4);
 
-    SendUpdateWorldState(WORLD_STATE_WG_VEHICLE_H, uint32(m_activeVehiclesGuids[TEAM_INDEX_HORDE].size()));
-    SendUpdateWorldState(WORLD_STATE_WG_MAX_VEHICLE_H, m_workshopCount[TEAM_INDEX_HORDE] * 4);
+    SendUpdateWorldStates(states);
+}
+
+// The world states of the battle and cooldown timers, in the order of m_sentTimerStates
+WorldStateValueList BattlefieldWG::GetTimerWorldStates() const
+{
+    return
+    {
+        { WORLD_STATE_WG_SHOW_COOLDOWN, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? WORLD_STATE_ADD : WORLD_STATE_REMOVE },
+        { WORLD_STATE_WG_TIME_TO_NEXT_BATTLE, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? uint32(time(nullptr) + m_timer / 1000) : 0 },
+        { WORLD_STATE_WG_SHOW_BATTLE, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? WORLD_STATE_ADD : WORLD_STATE_REMOVE },
+        { WORLD_STATE_WG_TIME_TO_END, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? uint32(time(nullptr) + m_timer / 1000) : 0 }
+    };
 }
 
 void BattlefieldWG::HandlePlayerKillInsideArea(Player* player, Unit* victim)
@@ -1417,11 +1433,19 @@ void BattlefieldWG::Update(uint32 diff)
 
 void BattlefieldWG::SendBattlefieldTimerUpdate()
 {
-    SendUpdateWorldState(WORLD_STATE_WG_SHOW_COOLDOWN, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
-    SendUpdateWorldState(WORLD_STATE_WG_TIME_TO_NEXT_BATTLE, GetBattlefieldStatus() == BF_STATUS_COOLDOWN ? uint32(time(nullptr) + m_timer / 1000) : 0);
+    // called each update, only the states changed since the last broadcast are sent; players entering get all of them with the initial states
+    WorldStateValueList changed;
+    WorldStateValueList const states = GetTimerWorldStates();
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        if (m_sentTimerStates[i] == states[i].second)
+            continue;
+
+        m_sentTimerStates[i] = states[i].second;
+        changed.push_back(states[i]);
+    }
 
-    SendUpdateWorldState(WORLD_STATE_WG_SHOW_BATTLE, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? WORLD_STATE_ADD : WORLD_STATE_REMOVE);
-    SendUpdateWorldState(WORLD_STATE_WG_TIME_TO_END, GetBattlefieldStatus() == BF_STATUS_IN_PROGRESS ? uint32(time(nullptr) + m_timer / 1000) : 0);
+    SendUpdateWorldStates(changed);
 }
 
 bool BattlefieldWG::IsConditionFulfilled(Player const* source, uint32 conditionId, WorldObject const* conditionSource, uint32 conditionSourceType)
@@ -33,6 +33,7 @@ enum
     MAX_WG_OFFENSE_TOWERS                       = 3,                // maximum towers available for the attacker team
     MAX_WG_CORPORAL_KILLS                       = 5,                // maximum number of kills required for rank promotion
     MAX_WG_LIEUTENANT_KILLS                     = 15,
+    WG_TIMER_STATES_COUNT                       = 4,                // world states of the battle and cooldown timers
 
     // ***** Spells *****
     // player rank spells
@@ -745,6 +746,7 @@ class BattlefieldWG : public Battlefield
 
         // update all world states
         void SendUpdateGeneralWorldStates();
+        WorldStateValueList GetTimerWorldStates() const;
 
         // send battlefield warning
         void SendWintergraspWarning(int32 messageId, const WorldObject* objRef, uint32 soundId = 0);
@@ -766,6 +768,7 @@ class BattlefieldWG : public Battlefield
 
         // variables
         bool m_sentPrebattleWarning;
+        uint32 m_sentTimerStates[WG_TIMER_STATES_COUNT];    // values of GetTimerWorldStates() last sent to the zone
 
         // counters
         uint32 m_destroyedTowers[PVP_TEAM_COUNT];
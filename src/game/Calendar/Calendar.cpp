@@ -20,10 +20,14 @@
 #include "Calendar/Calendar.h"
 #include "Mails/Mail.h"
 #include "Globals/ObjectMgr.h"
+#include "World/World.h"
 #include "ProgressBar.h"
 
 INSTANTIATE_SINGLETON_1(CalendarMgr);
 
+// events moved to the archive tables by one statement
+#define CALENDAR_ARCHIVE_BATCH 100
+
 //////////////////////////////////////////////////////////////////////////
 // CalendarEvent Class to store single event informations
 //////////////////////////////////////////////////////////////////////////
@@ -39,7 +43,11 @@ bool CalendarEvent::AddInvite(CalendarInvite* invite)
     if (!invite)
         return false;
 
-    return m_Invitee.insert(CalendarInviteMap::value_type(invite->InviteId, invite)).second;
+    if (!m_Invitee.insert(CalendarInviteMap::value_type(invite->InviteId, invite)).second)
+        return false;
+
+    sCalendarMgr.IndexInvite(invite);
+    return true;
 }
 
 CalendarInvite* CalendarEvent::GetInviteById(uint64 inviteId)
@@ -75,6 +83,7 @@ void CalendarEvent::RemoveInviteByItr(CalendarInviteMap::iterator inviteItr)
 
     CharacterDatabase.PExecute("DELETE FROM calendar_invites WHERE inviteId=" UI64FMTD, inviteItr->second->InviteId);
 
+    sCalendarMgr.UnindexInvite(inviteItr->second);
     delete inviteItr->second;
     m_Invitee.erase(inviteItr);
 }
@@ -146,6 +155,17 @@ void CalendarEvent::RemoveAllInvite()
         RemoveInviteByItr(itr++);
 }
 
+// remove all invite from memory, their rows are left to the caller
+void CalendarEvent::UnloadAllInvite()
+{
+    for (auto& itr : m_Invitee)
+    {
+        sCalendarMgr.UnindexInvite(itr.second);
+        delete itr.second;
+    }
+    m_Invitee.clear();
+}
+
 // remove all invite sending ingame mail
 void CalendarEvent::RemoveAllInvite(ObjectGuid const& removerGuid)
 {
@@ -202,44 +222,53 @@ void CalendarMgr::GetPlayerEventsList(ObjectGuid const& guid, CalendarEventsList
     else
         guildId = Player::GetGuildIdFromDB(guid);
 
-    for (auto& itr : m_EventStore)
-    {
-        CalendarEvent* event = &itr.second;
+    // an event can be found by more than one index, the set also keeps them by id
+    CalendarEventIdSet eventIds;
 
-        // add own event and same guild event or announcement
-        if ((event->CreatorGuid == guid) || ((event->IsGuildAnnouncement() || event->IsGuildEvent()) && event->GuildId == guildId))
+    // add own event
+    auto creatorItr = m_CreatorEvents.find(guid);
+    if (creatorItr != m_CreatorEvents.end())
+        eventIds.insert(creatorItr->second.begin(), creatorItr->second.end());
+
+    // add same guild event or announcement
+    if (guildId)
+    {
+        auto guildItr = m_GuildEvents.find(guildId);
+        if (guildItr != m_GuildEvents.end())
         {
-            calEventList.push_back(event);
-            continue;
+            for (uint64 eventId : guildItr->second)
+            {
+                CalendarEvent const* event = GetEventById(eventId);
+                if (event && (event->IsGuildAnnouncement() || event->IsGuildEvent()))
+                    eventIds.insert(eventId);
+            }
         }
+    }
 
-        // add all event where player is invited
-        if (event->GetInviteByGuid(guid))
+    // add all event where player is invited
+    auto inviteItr = m_PlayerInvites.find(guid);
+    if (inviteItr != m_PlayerInvites.end())
+        for (auto const& itr : inviteItr->second)
+            eventIds.insert(itr.first);
+
+    for (uint64 eventId : eventIds)
+        if (CalendarEvent* event = GetEventById(eventId))
             calEventList.push_back(event);
-    }
 }
 
 // fill all player invites in provided CalendarInvitesList
 void CalendarMgr::GetPlayerInvitesList(ObjectGuid const& guid, CalendarInvitesList& calInvList)
 {
-    for (auto& itr : m_EventStore)
-    {
-        CalendarEvent* event = &itr.second;
+    auto inviteItr = m_PlayerInvites.find(guid);
+    if (inviteItr == m_PlayerInvites.end())
+        return;
 
-        if (event->IsGuildAnnouncement())
+    for (auto const& itr : inviteItr->second)
+    {
+        if (itr.second->GetCalendarEvent()->IsGuildAnnouncement())
             continue;
 
-        CalendarInviteMap const* cInvMap = event->GetInviteMap();
-        CalendarInviteMap::const_iterator ci_itr = cInvMap->begin();
-        while (ci_itr != cInvMap->end())
-        {
-            if (ci_itr->second->InviteeGuid == guid)
-            {
-                calInvList.push_back(ci_itr->second);
-                break;
-            }
-            ++ci_itr;
-        }
+        calInvList.push_back(itr.second);
     }
 }
 
@@ -309,6 +338,8 @@ CalendarEvent* CalendarMgr::AddEvent(ObjectGuid const& guid, std::string title,
     newEvent.Flags = flags;
     newEvent.GuildId = guildId;
 
+    IndexEvent(&newEvent);
+
     CharacterDatabase.escape_string(title);
     CharacterDatabase.escape_string(description);
     CharacterDatabase.PExecute("INSERT INTO calendar_events VALUES (" UI64FMTD ", %u, %u, %u, %u, %d, %u, '%s', '%s')",
@@ -348,6 +379,7 @@ void CalendarMgr::RemoveEvent(uint64 eventId, Player* remover)
 
     // explicitly remove all invite and send mail to all invitee
     citr->second.RemoveAllInvite(remover->GetObjectGuid());
+    UnindexEvent(&citr->second);
     m_EventStore.erase(citr);
 }
 
@@ -516,21 +548,31 @@ void CalendarMgr::CopyEvent(uint64 eventId, time_t newTime, ObjectGuid const& gu
 // used when player is deleted
 void CalendarMgr::RemovePlayerCalendar(ObjectGuid const& playerGuid)
 {
-    CalendarEventStore::iterator itr = m_EventStore.begin();
-
-    while (itr != m_EventStore.end())
+    auto creatorItr = m_CreatorEvents.find(playerGuid);
+    if (creatorItr != m_CreatorEvents.end())
     {
-        if (itr->second.CreatorGuid == playerGuid)
+        // copied, removing the events changes the index
+        CalendarEventIdSet eventIds = creatorItr->second;
+        for (uint64 eventId : eventIds)
         {
+            CalendarEventStore::iterator itr = m_EventStore.find(eventId);
+            if (itr == m_EventStore.end())
+                continue;
+
             // all invite will be automaticaly deleted
-            m_EventStore.erase(itr++);
-            // itr already incremented so go recheck event owner
-            continue;
+            UnindexEvent(&itr->second);
+            m_EventStore.erase(itr);
         }
-        // event not owned by playerGuid but an invite can still be found
-        CalendarEvent* event = &itr->second;
-        event->RemoveInviteByGuid(playerGuid);
-        ++itr;
+    }
+
+    // event not owned by playerGuid but an invite can still be found
+    auto inviteItr = m_PlayerInvites.find(playerGuid);
+    if (inviteItr != m_PlayerInvites.end())
+    {
+        CalendarPlayerInviteMap invites = inviteItr->second;
+        for (auto const& itr : invites)
+            if (CalendarEvent* event = GetEventById(itr.first))
+                event->RemoveInviteByGuid(playerGuid);
     }
 }
 
@@ -538,28 +580,35 @@ void CalendarMgr::RemovePlayerCalendar(ObjectGuid const& playerGuid)
 // used when player quit a guild
 void CalendarMgr::RemoveGuildCalendar(ObjectGuid const& playerGuid, uint32 GuildId)
 {
-    CalendarEventStore::iterator itr = m_EventStore.begin();
-
-    while (itr != m_EventStore.end())
+    auto creatorItr = m_CreatorEvents.find(playerGuid);
+    if (creatorItr != m_CreatorEvents.end())
     {
-        CalendarEvent* event = &itr->second;
-        if (event->CreatorGuid == playerGuid && (event->IsGuildEvent() || event->IsGuildAnnouncement()))
+        CalendarEventIdSet eventIds = creatorItr->second;
+        for (uint64 eventId : eventIds)
         {
+            CalendarEventStore::iterator itr = m_EventStore.find(eventId);
+            if (itr == m_EventStore.end() || !(itr->second.IsGuildEvent() || itr->second.IsGuildAnnouncement()))
+                continue;
+
             // all invite will be automaticaly deleted
-            m_EventStore.erase(itr++);
-            // itr already incremented so go recheck event owner
-            continue;
+            UnindexEvent(&itr->second);
+            m_EventStore.erase(itr);
         }
+    }
 
-        // event not owned by playerGuid but an guild invite can still be found
-        if (event->GuildId != GuildId || !(event->IsGuildEvent() || event->IsGuildAnnouncement()))
+    // event not owned by playerGuid but an guild invite can still be found
+    auto inviteItr = m_PlayerInvites.find(playerGuid);
+    if (inviteItr != m_PlayerInvites.end())
+    {
+        CalendarPlayerInviteMap invites = inviteItr->second;
+        for (auto const& itr : invites)
         {
-            ++itr;
-            continue;
-        }
+            CalendarEvent* event = GetEventById(itr.first);
+            if (!event || event->GuildId != GuildId || !(event->IsGuildEvent() || event->IsGuildAnnouncement()))
+                continue;
 
-        event->RemoveInviteByGuid(playerGuid);
-        ++itr;
+            event->RemoveInviteByGuid(playerGuid);
+        }
     }
 }
 
@@ -570,6 +619,34 @@ void CalendarMgr::LoadCalendarsFromDB()
     m_MaxInviteId = 0;
     m_MaxEventId = 0;
     m_EventStore.clear();
+    m_PlayerInvites.clear();
+    m_CreatorEvents.clear();
+    m_GuildEvents.clear();
+
+    // only the events of the kept window are loaded, the older ones are archived first in a few statements
+    if (uint32 keepDays = sWorld.getConfig(CONFIG_UINT32_CALENDAR_KEEP_DAYS))
+    {
+        uint32 oldestTime = uint32(time(nullptr) - time_t(keepDays * DAY));
+
+        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.PExecute("INSERT INTO calendar_invites_archive SELECT * FROM calendar_invites WHERE eventId IN (SELECT eventId FROM calendar_events WHERE eventTime < %u)", oldestTime);
+        CharacterDatabase.PExecute("DELETE FROM calendar_invites WHERE eventId IN (SELECT eventId FROM calendar_events WHERE eventTime < %u)", oldestTime);
+        CharacterDatabase.PExecute("INSERT INTO calendar_events_archive SELECT * FROM calendar_events WHERE eventTime < %u", oldestTime);
+        CharacterDatabase.PExecute("DELETE FROM calendar_events WHERE eventTime < %u", oldestTime);
+        CharacterDatabase.CommitTransactionDirect();
+    }
+
+    // the ids of the archived events and invites are not reused
+    if (QueryResult* result = CharacterDatabase.Query("SELECT MAX(eventId) FROM calendar_events_archive"))
+    {
+        m_MaxEventId = result->Fetch()[0].GetUInt64();
+        delete result;
+    }
+    if (QueryResult* result = CharacterDatabase.Query("SELECT MAX(inviteId) FROM calendar_invites_archive"))
+    {
+        m_MaxInviteId = result->Fetch()[0].GetUInt64();
+        delete result;
+    }
 
     sLog.outString("Loading Calendar Events...");
 
@@ -604,6 +681,7 @@ void CalendarMgr::LoadCalendarsFromDB()
             newEvent.Title         = field[7].GetCppString();
             newEvent.Description   = field[8].GetCppString();
 
+            IndexEvent(&newEvent);
             m_MaxEventId = std::max(eventId, m_MaxEventId);
         }
         while (eventsQuery->NextRow());
@@ -621,11 +699,12 @@ void CalendarMgr::LoadCalendarsFromDB()
         BarGoLink bar(1);
         bar.step();
 
-        if (m_MaxEventId)                                   // An Event was loaded before
+        if (!m_EventStore.empty())                          // An Event was loaded before
         {
             // delete all events (no event exist without at least one invite)
             m_EventStore.clear();
-            m_MaxEventId = 0;
+            m_CreatorEvents.clear();
+            m_GuildEvents.clear();
             CharacterDatabase.DirectExecute("TRUNCATE TABLE calendar_events");
             sLog.outString(">> calendar_invites table is empty, cleared calendar_events table!");
         }
@@ -635,7 +714,7 @@ void CalendarMgr::LoadCalendarsFromDB()
     }
     else
     {
-        if (m_MaxEventId)
+        if (!m_EventStore.empty())
         {
             uint64 totalInvites = 0;
             uint32 deletedInvites = 0;
@@ -682,15 +761,112 @@ void CalendarMgr::LoadCalendarsFromDB()
     sLog.outString();
 }
 
+// move the events older than Calendar.KeepDays and their invites to the archive tables
+void CalendarMgr::ArchiveOldEvents()
+{
+    uint32 keepDays = sWorld.getConfig(CONFIG_UINT32_CALENDAR_KEEP_DAYS);
+    if (!keepDays)
+        return;
+
+    time_t oldestTime = time(nullptr) - time_t(keepDays * DAY);
+
+    std::vector<uint64> eventIds;
+    CalendarEventStore::iterator itr = m_EventStore.begin();
+    while (itr != m_EventStore.end())
+    {
+        if (itr->second.EventTime < oldestTime)
+        {
+            eventIds.push_back(itr->first);
+            UnloadEvent(itr++);
+        }
+        else
+            ++itr;
+    }
+
+    if (eventIds.empty())
+        return;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_CALENDAR, "CalendarMgr::ArchiveOldEvents> archiving %u events", uint32(eventIds.size()));
+
+    CharacterDatabase.BeginTransaction();
+    for (size_t i = 0; i < eventIds.size(); i += CALENDAR_ARCHIVE_BATCH)
+    {
+        std::ostringstream ids;
+        for (size_t j = i; j < eventIds.size() && j < i + CALENDAR_ARCHIVE_BATCH; ++j)
+            ids << (j != i ? "," : "") << eventIds[j];
+
+        std::string idList = ids.str();
+        CharacterDatabase.PExecute("INSERT INTO calendar_invites_archive SELECT * FROM calendar_invites WHERE eventId IN (%s)", idList.c_str());
+        CharacterDatabase.PExecute("DELETE FROM calendar_invites WHERE eventId IN (%s)", idList.c_str());
+        CharacterDatabase.PExecute("INSERT INTO calendar_events_archive SELECT * FROM calendar_events WHERE eventId IN (%s)", idList.c_str());
+        CharacterDatabase.PExecute("DELETE FROM calendar_events WHERE eventId IN (%s)", idList.c_str());
+    }
+    CharacterDatabase.CommitTransaction();
+}
+
+// drop an event and its invites from memory without touching their rows
+void CalendarMgr::UnloadEvent(CalendarEventStore::iterator itr)
+{
+    itr->second.UnloadAllInvite();
+    UnindexEvent(&itr->second);
+    m_EventStore.erase(itr);
+}
+
+void CalendarMgr::IndexEvent(CalendarEvent const* event)
+{
+    m_CreatorEvents[event->CreatorGuid].insert(event->EventId);
+    if (event->GuildId)
+        m_GuildEvents[event->GuildId].insert(event->EventId);
+}
+
+void CalendarMgr::UnindexEvent(CalendarEvent const* event)
+{
+    auto creatorItr = m_CreatorEvents.find(event->CreatorGuid);
+    if (creatorItr != m_CreatorEvents.end())
+    {
+        creatorItr->second.erase(event->EventId);
+        if (creatorItr->second.empty())
+            m_CreatorEvents.erase(creatorItr);
+    }
+
+    if (!event->GuildId)
+        return;
+
+    auto guildItr = m_GuildEvents.find(event->GuildId);
+    if (guildItr != m_GuildEvents.end())
+    {
+        guildItr->second.erase(event->EventId);
+        if (guildItr->second.empty())
+            m_GuildEvents.erase(guildItr);
+    }
+}
+
+void CalendarMgr::IndexInvite(CalendarInvite* invite)
+{
+    m_PlayerInvites[invite->InviteeGuid][invite->GetCalendarEvent()->EventId] = invite;
+}
+
+void CalendarMgr::UnindexInvite(CalendarInvite const* invite)
+{
+    auto inviteItr = m_PlayerInvites.find(invite->InviteeGuid);
+    if (inviteItr == m_PlayerInvites.end())
+        return;
+
+    // a duplicated invite of the player in the same event may have replaced this one
+    CalendarPlayerInviteMap::iterator itr = inviteItr->second.find(invite->GetCalendarEvent()->EventId);
+    if (itr != inviteItr->second.end() && itr->second == invite)
+        inviteItr->second.erase(itr);
+
+    if (inviteItr->second.empty())
+        m_PlayerInvites.erase(inviteItr);
+}
+
 // check if player have not reached event limit
 bool CalendarMgr::CanAddEvent(ObjectGuid const& guid)
 {
-    uint32 totalEvents = 0;
     // count all event created by guid
-    for (auto& itr : m_EventStore)
-        if ((itr.second.CreatorGuid == guid) && (++totalEvents >= CALENDAR_MAX_EVENTS))
-            return false;
-    return true;
+    auto itr = m_CreatorEvents.find(guid);
+    return itr == m_CreatorEvents.end() || itr->second.size() < CALENDAR_MAX_EVENTS;
 }
 
 // check if guild have not reached event limit
@@ -699,34 +875,26 @@ bool CalendarMgr::CanAddGuildEvent(uint32 guildId)
     if (!guildId)
         return false;
 
-    uint32 totalEvents = 0;
     // count all guild events in a guild
-    for (auto& itr : m_EventStore)
-        if ((itr.second.GuildId == guildId) && (++totalEvents >= CALENDAR_MAX_GUILD_EVENTS))
-            return false;
-    return true;
+    auto itr = m_GuildEvents.find(guildId);
+    return itr == m_GuildEvents.end() || itr->second.size() < CALENDAR_MAX_GUILD_EVENTS;
 }
 
 // check if an invitee have not reached invite limit
 bool CalendarMgr::CanAddInviteTo(ObjectGuid const& guid)
 {
-    uint32 totalInvites = 0;
+    auto inviteItr = m_PlayerInvites.find(guid);
+    if (inviteItr == m_PlayerInvites.end())
+        return true;
 
-    for (auto& itr : m_EventStore)
+    uint32 totalInvites = 0;
+    for (auto const& itr : inviteItr->second)
     {
-        CalendarEvent* event = &itr.second;
-
-        if (event->IsGuildAnnouncement())
+        if (itr.second->GetCalendarEvent()->IsGuildAnnouncement())
             continue;
 
-        CalendarInviteMap const* cInvMap = event->GetInviteMap();
-        CalendarInviteMap::const_iterator ci_itr = cInvMap->begin();
-        while (ci_itr != cInvMap->end())
-        {
-            if ((ci_itr->second->InviteeGuid == guid) && (++totalInvites >= CALENDAR_MAX_INVITES))
-                return false;
-            ++ci_itr;
-        }
+        if (++totalInvites >= CALENDAR_MAX_INVITES)
+            return false;
     }
 
     return true;
@@ -134,6 +134,8 @@ class WorldPacket;
 typedef std::map<uint64, CalendarInvite*> CalendarInviteMap;
 typedef std::list<CalendarInvite*> CalendarInvitesList;
 typedef std::list<CalendarEvent*> CalendarEventsList;
+typedef std::map<uint64, CalendarInvite*> CalendarPlayerInviteMap;  // invites of one player by event id
+typedef std::set<uint64> CalendarEventIdSet;
 
 // CalendarEvent class used to store one event
 class CalendarEvent
@@ -178,8 +180,11 @@ class CalendarEvent
         std::string Description;                // description of the event
 
     private:
+        friend class CalendarMgr;
+
         void RemoveInviteByItr(CalendarInviteMap::iterator inviteItr);
         void RemoveAllInvite();
+        void UnloadAllInvite();                 // drop the invites from memory only, on archiving
 
         CalendarInviteMap m_Invitee;
 };
@@ -244,6 +249,7 @@ class CalendarMgr
 
         // sql related
         void LoadCalendarsFromDB();
+        void ArchiveOldEvents();                // move the events older than Calendar.KeepDays to the archive tables
 
         // send data to client function
         void SendCalendarEventInvite(CalendarInvite const* invite) const;
@@ -263,6 +269,8 @@ class CalendarMgr
         void SendPacketToAllEventRelatives(const WorldPacket& packet, CalendarEvent const* event) const;
 
     private:
+        friend class CalendarEvent;
+
         uint64 GetNewEventId() { return ++m_MaxEventId; }
         uint64 GetNewInviteId() { return ++m_MaxInviteId; }
 
@@ -270,6 +278,18 @@ class CalendarMgr
         bool CanAddGuildEvent(uint32 guildId);          // check if guild not reached the event number limit
         bool CanAddEvent(ObjectGuid const& guid);       // check if player not reached the event number limit
 
+        // index maintenance, the events and invites only change through the calendar code
+        void IndexEvent(CalendarEvent const* event);
+        void UnindexEvent(CalendarEvent const* event);
+        void IndexInvite(CalendarInvite* invite);
+        void UnindexInvite(CalendarInvite const* invite);
+        void UnloadEvent(CalendarEventStore::iterator itr);
+
+        // declared before the store, the events unindex themselves when it is destroyed
+        std::unordered_map<ObjectGuid, CalendarPlayerInviteMap> m_PlayerInvites;    // invites by invitee
+        std::unordered_map<ObjectGuid, CalendarEventIdSet> m_CreatorEvents;         // events by creator
+        std::unordered_map<uint32, CalendarEventIdSet> m_GuildEvents;               // guild events and announcements by guild
+
         CalendarEventStore m_EventStore;        // main events storage
         uint64 m_MaxEventId;                    // current max event ID
         uint64 m_MaxInviteId;                   // current max invite ID
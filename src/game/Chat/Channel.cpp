@@ -120,6 +120,7 @@ void Channel::Join(Player* player, const char* password)
     PlayerInfo& pinfo = m_players[guid];
     pinfo.player = guid;
     pinfo.flags = MEMBER_FLAG_NONE;
+    AddMember(pinfo, player);
 
     MakeYouJoined(data, m_name, *this);
     SendToOne(data, guid);
@@ -161,7 +162,7 @@ void Channel::Leave(Player* player, bool send)
 
     bool changeowner = m_players[guid].IsOwner();
 
-    m_players.erase(guid);
+    RemovePlayer(guid);
 
     const uint32 level = sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_CHANNEL_SILENT_JOIN);
     const bool silent = (level && player->GetSession()->GetSecurity() >= level);
@@ -242,7 +243,7 @@ void Channel::KickOrBan(Player* player, const char* targetName, bool ban)
         MakePlayerKicked(data, m_name, targetGuid, guid);
 
     SendToAll(data);
-    m_players.erase(targetGuid);
+    RemovePlayer(targetGuid);
     target->LeftChannel(this);
 
     if (changeowner && !IsPublic())
@@ -518,7 +519,8 @@ void Channel::SendChannelListResponse(Player* player, bool display/*= false*/)
     uint32 count = 0;
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
     {
-        if (Player* member = sObjectMgr.GetPlayer(i->first))
+        Player* member = GetMember(i->second);
+        if (member && member->IsInWorld())
         {
             if (visibilityCheck && (member->GetSession()->GetSecurity() > visibilityThreshold || !member->IsVisibleGloballyFor(player)))
                 continue;
@@ -736,16 +738,18 @@ void Channel::SendToOne(WorldPacket const& data, ObjectGuid receiver) const
 
 void Channel::SendToAll(WorldPacket const& data) const
 {
-    for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
-        SendToOne(data, i->first);
+    SharedWorldPacket packet(data);
+    for (Player* member : m_members)
+        if (member->IsInWorld())
+            member->GetSession()->SendPacket(packet);
 }
 
 void Channel::SendMessage(WorldPacket const& data, ObjectGuid sender) const
 {
-    for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
-        if (Player* plr = sObjectMgr.GetPlayer(i->first))
-            if (!sender || !plr->GetSocial()->HasIgnore(sender))
-                plr->GetSession()->SendPacket(data);
+    SharedWorldPacket packet(data);
+    for (Player* member : m_members)
+        if (member->IsInWorld() && (!sender || !member->GetSocial()->HasIgnore(sender)))
+            member->GetSession()->SendPacket(packet);
 }
 
 void Channel::Voice(ObjectGuid /*guid1*/, ObjectGuid /*guid2*/) const
@@ -1014,6 +1018,31 @@ void Channel::MakeVoiceTrialRestricted(WorldPacket &data, const std::string &cha
     data << guid;
 }
 
+void Channel::AddMember(PlayerInfo& info, Player* player)
+{
+    info.memberIndex = m_members.size();
+    m_members.push_back(player);
+}
+
+void Channel::RemovePlayer(ObjectGuid guid)
+{
+    PlayerList::iterator itr = m_players.find(guid);
+    if (itr == m_players.end())
+        return;
+
+    // move the last member in the hole
+    uint32 const index = itr->second.memberIndex;
+    if (index < m_members.size())
+    {
+        m_members[index] = m_members.back();
+        m_members.pop_back();
+        if (index < m_members.size())
+            m_players[m_members[index]->GetObjectGuid()].memberIndex = index;
+    }
+
+    m_players.erase(itr);
+}
+
 ObjectGuid Channel::SelectNewOwner() const
 {
     // Prioritise moderators for owner appointment
@@ -120,6 +120,9 @@ class Channel
         {
             ObjectGuid player;
             uint8 flags;
+            uint32 memberIndex = INVALID_MEMBER_INDEX;      // in m_members
+
+            static uint32 const INVALID_MEMBER_INDEX = uint32(-1);
 
             inline bool HasFlag(uint8 flag) const { return (flags & flag) != 0; }
             void SetFlag(uint8 flag, bool state) { if (state) flags |= flag; else flags &= ~flag; }
@@ -232,6 +235,10 @@ class Channel
 
         ObjectGuid SelectNewOwner() const;
 
+        void AddMember(PlayerInfo& info, Player* player);
+        void RemovePlayer(ObjectGuid guid);
+        Player* GetMember(PlayerInfo const& info) const { return info.memberIndex < m_members.size() ? m_members[info.memberIndex] : nullptr; }
+
         void SetModeFlags(ObjectGuid guid, ChannelMemberFlags flags, bool set);
         void SetOwner(ObjectGuid guid, bool exclaim = true);
 
@@ -240,6 +247,7 @@ class Channel
         std::string                 m_password;
         ObjectGuid                  m_ownerGuid;
         PlayerList                  m_players;
+        std::vector<Player*>        m_members;              // players of m_players without lookup for broadcasts, they leave at logout
         GuidSet                     m_banned;
         const ChatChannelsEntry*    m_entry = nullptr;
         bool                        m_announcements = false;
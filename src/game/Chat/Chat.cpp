@@ -17,6 +17,7 @@
  */
 
 #include "Chat/Chat.h"
+#include "Chat/ChatCommandWorker.h"
 #include "Tools/Language.h"
 #include "Database/DatabaseEnv.h"
 #include "WorldPacket.h"
@@ -71,6 +72,79 @@
 
 bool ChatHandler::load_command_table = true;
 
+// tries of the command tables, built once with the table
+static std::unordered_map<ChatCommand const*, ChatCommandTrie> commandTries;
+
+ChatCommandTrie::ChatCommandTrie(ChatCommand const* table) : m_nodes(1)
+{
+    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    {
+        if (!*table[i].Name)
+        {
+            m_emptyNames.push_back(i);
+            continue;
+        }
+
+        uint32 node = 0;
+        for (char const* c = table[i].Name; *c; ++c)
+        {
+            char const lower = char(tolower(*c));
+            auto itr = std::find_if(m_nodes[node].children.begin(), m_nodes[node].children.end(), [lower](std::pair<char, uint32> const& child) { return child.first == lower; });
+            if (itr != m_nodes[node].children.end())
+                node = itr->second;
+            else
+            {
+                m_nodes[node].children.emplace_back(lower, uint32(m_nodes.size()));
+                node = uint32(m_nodes.size());
+                m_nodes.emplace_back();
+            }
+
+            m_nodes[node].indexes.push_back(i);             // names are added in table order
+        }
+    }
+}
+
+void ChatCommandTrie::Find(char const* part, std::vector<uint32>& indexes) const
+{
+    indexes.clear();
+
+    // "" part only selects the "" commands, see ChatHandler::hasStringAbbr
+    std::vector<uint32> const* named = nullptr;
+    if (*part)
+    {
+        uint32 node = 0;
+        for (char const* c = part; *c && node != uint32(-1); ++c)
+        {
+            char const lower = char(tolower(*c));
+            auto itr = std::find_if(m_nodes[node].children.begin(), m_nodes[node].children.end(), [lower](std::pair<char, uint32> const& child) { return child.first == lower; });
+            node = itr != m_nodes[node].children.end() ? itr->second : uint32(-1);
+        }
+
+        if (node != uint32(-1))
+            named = &m_nodes[node].indexes;
+    }
+
+    if (!named)
+    {
+        indexes = m_emptyNames;
+        return;
+    }
+
+    indexes.resize(named->size() + m_emptyNames.size());
+    std::merge(named->begin(), named->end(), m_emptyNames.begin(), m_emptyNames.end(), indexes.begin());
+}
+
+void ChatHandler::BuildCommandTries(ChatCommand const* table)
+{
+    if (commandTries.find(table) != commandTries.end())
+        return;
+
+    commandTries.emplace(table, ChatCommandTrie(table));
+    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+        if (table[i].ChildCommands)
+            BuildCommandTries(table[i].ChildCommands);
+}
+
 ChatCommand* ChatHandler::getCommandTable()
 {
     static ChatCommand accountSetCommandTable[] =
@@ -253,6 +327,8 @@ ChatCommand* ChatHandler::getCommandTable()
     {
         { "tempspawn",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleShowTemporarySpawnList,          "", nullptr },
         { "gridsloaded",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleGridsLoadedCount,                "", nullptr },
+        { "idlecreatures",  SEC_ADMINISTRATOR,  false, &ChatHandler::HandleIdleCreaturesCount,              "", nullptr },
+        { "conditions",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleConditionsProfile,               "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -287,6 +363,8 @@ ChatCommand* ChatHandler::getCommandTable()
         { "utf8overflow",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOverflowCommand,            "", nullptr },
         { "chatfreeze",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugChatFreezeCommand,          "", nullptr },
         { "opcodehistory",  SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketHistory,              "", nullptr },
+        { "opcodestats",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeStatsCommand,         "", nullptr },
+        { "playerupdates",  SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPlayerUpdatesCommand,       "", nullptr },
         { "debugflags",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugObjectFlags,                "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
@@ -429,12 +507,12 @@ ChatCommand* ChatHandler::getCommandTable()
         { "account",        SEC_GAMEMASTER,     true,  nullptr,                                           "", lookupAccountCommandTable },
         { "achievement",    SEC_GAMEMASTER,     true,  &ChatHandler::HandleLookupAchievementCommand,   "", nullptr },
         { "area",           SEC_MODERATOR,      true,  &ChatHandler::HandleLookupAreaCommand,          "", nullptr },
-        { "creature",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupCreatureCommand,      "", nullptr },
+        { "creature",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupCreatureCommand,      "", nullptr, true },
         { "event",          SEC_GAMEMASTER,     true,  &ChatHandler::HandleLookupEventCommand,         "", nullptr },
         { "faction",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupFactionCommand,       "", nullptr },
-        { "item",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupItemCommand,          "", nullptr },
-        { "itemset",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupItemSetCommand,       "", nullptr },
-        { "object",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupObjectCommand,        "", nullptr },
+        { "item",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupItemCommand,          "", nullptr, true },
+        { "itemset",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupItemSetCommand,       "", nullptr, true },
+        { "object",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupObjectCommand,        "", nullptr, true },
         { "quest",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleLookupQuestCommand,         "", nullptr },
         { "player",         SEC_GAMEMASTER,     true,  nullptr,                                           "", lookupPlayerCommandTable },
         { "pool",           SEC_GAMEMASTER,     true,  &ChatHandler::HandleLookupPoolCommand,          "", nullptr },
@@ -790,12 +868,15 @@ ChatCommand* ChatHandler::getCommandTable()
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", nullptr },
         { "log",            SEC_CONSOLE,        true,  nullptr,                                           "", serverLogCommandTable },
+        { "memory",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMemoryCommand,        "", nullptr },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", nullptr },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", nullptr },
         { "resetallraid",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerResetAllRaidCommand,  "", nullptr },
         { "restart",        SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverShutdownCommandTable },
         { "set",            SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverSetCommandTable },
+        { "tickprofile",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerTickProfileCommand,   "", nullptr },
+        { "trace",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerTraceCommand,         "", nullptr },
         { nullptr,             0,                  false, nullptr,                                           "", nullptr }
     };
 
@@ -1015,10 +1096,13 @@ ChatCommand* ChatHandler::getCommandTable()
 
     if (load_command_table)
     {
+        // the console lines are looked up off the world thread for the ChatCommandWorker
+        std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
         load_command_table = false;
 
         // check hardcoded part integrity
         CheckIntegrity(commandTable, nullptr);
+        BuildCommandTries(commandTable);
 
         QueryResult* result = WorldDatabase.Query("SELECT name,security,help FROM command");
         if (result)
@@ -1308,16 +1392,25 @@ ChatCommandSearchResult ChatHandler::FindCommand(ChatCommand* table, char const*
 
     while (*text == ' ') ++text;
 
+    // the abbreviation search only visits the matching names of indexed tables, in the same order
+    std::vector<uint32> candidates;
+    auto trie = exactlyName ? commandTries.end() : commandTries.find(table);
+    bool const indexed = trie != commandTries.end();
+    if (indexed)
+        trie->second.Find(cmd.c_str(), candidates);
+
     // search first level command in table
-    for (uint32 i = 0; table[i].Name != nullptr; ++i)
+    for (uint32 n = 0; indexed ? n < candidates.size() : table[n].Name != nullptr; ++n)
     {
+        uint32 const i = indexed ? candidates[n] : n;
+
         if (exactlyName)
         {
             size_t len = strlen(table[i].Name);
             if (strncmp(table[i].Name, cmd.c_str(), len + 1) != 0)
                 continue;
         }
-        else
+        else if (!indexed)
         {
             if (!hasStringAbbr(table[i].Name, cmd.c_str()))
                 continue;
@@ -1419,6 +1512,25 @@ void ChatHandler::ExecuteCommand(const char* text)
         case CHAT_COMMAND_OK:
         {
             SetSentErrorMessage(false);
+
+            // read only commands of sessions run on the worker, their output is sent later by the world thread
+            if (command->AllowAsync && m_session && sWorld.GetChatCommandWorker().activated())
+            {
+                ChatCommandRequest request;
+                request.accountId = m_session->GetAccountId();
+                request.accessLevel = GetAccessLevel();
+                request.dbcLocale = GetSessionDbcLocale();
+                request.dbLocaleIndex = GetSessionDbLocaleIndex();
+                request.handler = command->Handler;
+                request.args = text;
+                request.help = command->Help;
+                sWorld.GetChatCommandWorker().Queue(std::move(request));
+
+                if (command->SecurityLevel > SEC_PLAYER)
+                    LogCommand(fullcmd.c_str());
+                break;
+            }
+
             if ((this->*(command->Handler))((char*)text))   // text content destroyed at call
             {
                 if (command->SecurityLevel > SEC_PLAYER)
@@ -3566,6 +3678,36 @@ int ChatHandler::GetSessionDbLocaleIndex() const
     return m_session->GetSessionDbLocaleIndex();
 }
 
+const char* AsyncChatHandler::GetMangosString(int32 entry) const
+{
+    return sObjectMgr.GetMangosString(entry, m_dbLocaleIndex);
+}
+
+uint32 AsyncChatHandler::GetAccountId() const
+{
+    return m_accountId;
+}
+
+AccountTypes AsyncChatHandler::GetAccessLevel() const
+{
+    return m_accessLevel;
+}
+
+void AsyncChatHandler::SendSysMessage(const char* str)
+{
+    m_output.push_back(str);
+}
+
+LocaleConstant AsyncChatHandler::GetSessionDbcLocale() const
+{
+    return m_dbcLocale;
+}
+
+int AsyncChatHandler::GetSessionDbLocaleIndex() const
+{
+    return m_dbLocaleIndex;
+}
+
 const char* CliHandler::GetMangosString(int32 entry) const
 {
     return sObjectMgr.GetMangosStringForDbcLocale(entry);
@@ -3617,6 +3759,49 @@ int CliHandler::GetSessionDbLocaleIndex() const
     return sObjectMgr.GetDbc2StorageLocaleIndex();
 }
 
+ChatCommand const* CliHandler::FindAsyncCommand(char const*& text)
+{
+    // same prefixes as ParseCommands in console case
+    if ((text[0] == '.' && text[1] == '.') || (text[0] == '!' && text[1] == '!'))
+        return nullptr;
+
+    if (text[0] == '!' || text[0] == '.')
+        ++text;
+
+    // a pending reload of the table is done by the world thread
+    if (IsCommandTableLoadPending())
+        return nullptr;
+
+    char const* fullcmd = text;
+    ChatCommand* command = nullptr;
+    if (FindCommand(getCommandTable(), text, command) != CHAT_COMMAND_OK || !command->AllowAsync)
+        return nullptr;
+
+    // logged when taken, as the commands of sessions queued to the worker
+    if (command->SecurityLevel > SEC_PLAYER)
+        LogCommand(fullcmd);
+
+    return command;
+}
+
+bool CliHandler::ExecuteAsyncCommand(Handler handler, char* args, std::string const& help)
+{
+    SetSentErrorMessage(false);
+
+    // same as ExecuteCommand, the sub command help is not needed for the leaf commands
+    if (!(this->*handler)(args) && !HasSentErrorMessage())
+    {
+        if (!help.empty())
+            SendSysMessage(help.c_str());
+        else
+            SendSysMessage(GetMangosString(LANG_CMD_SYNTAX));
+
+        SetSentErrorMessage(true);
+    }
+
+    return !HasSentErrorMessage();
+}
+
 // Check/ Output if a NPC or GO (by guid) is part of a pool or game event
 template <typename T>
 void ChatHandler::ShowNpcOrGoSpawnInformation(uint32 guid)
@@ -41,6 +41,7 @@ class ChatHandler;
 class WorldSession;
 class WorldPacket;
 class GMTicket;
+class LootStore;
 class MailDraft;
 class Object;
 class GameObject;
@@ -57,6 +58,27 @@ class ChatCommand
         bool (ChatHandler::*Handler)(char* args);
         std::string        Help;
         ChatCommand*       ChildCommands;
+        bool               AllowAsync = false;              // only reads static data, may run on the ChatCommandWorker
+};
+
+// abbreviation index of the names of one command table, see ChatHandler::FindCommand
+class ChatCommandTrie
+{
+    public:
+        explicit ChatCommandTrie(ChatCommand const* table);
+
+        // table indexes of the commands the part is an abbreviation of, and of the "" commands, in table order
+        void Find(char const* part, std::vector<uint32>& indexes) const;
+
+    private:
+        struct Node
+        {
+            std::vector<std::pair<char, uint32>> children;  // lower case char, node index
+            std::vector<uint32> indexes;                    // of all names in the subtree, ascending
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32> m_emptyNames;
 };
 
 enum ChatCommandSearchResult
@@ -183,6 +205,8 @@ class ChatHandler
         virtual bool needReportToTarget(Player* chr) const;
         virtual LocaleConstant GetSessionDbcLocale() const;
         virtual int GetSessionDbLocaleIndex() const;
+        // output with chat links, also for the commands of sessions run on the ChatCommandWorker
+        virtual bool IsChatOutput() const { return m_session != nullptr; }
 
         bool HasLowerSecurity(Player* target, ObjectGuid guid = ObjectGuid(), bool strong = false);
         bool HasLowerSecurityAccount(WorldSession* target, uint32 target_account, bool strong = false);
@@ -199,6 +223,7 @@ class ChatHandler
 
         void CheckIntegrity(ChatCommand* table, ChatCommand* parentCommand) const;
         ChatCommand* getCommandTable();
+        static void BuildCommandTries(ChatCommand const* table);
 
         bool HandleAccountCommand(char* args);
         bool HandleAccountCharactersCommand(char* args);
@@ -296,6 +321,10 @@ class ChatHandler
 
         bool HandleShowTemporarySpawnList(char* args);
         bool HandleGridsLoadedCount(char* args);
+        bool HandleIdleCreaturesCount(char* args);
+        bool HandleConditionsProfile(char* args);
+        bool HandleDebugOpcodeStatsCommand(char* args);
+        bool HandleDebugPlayerUpdatesCommand(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
         bool HandleDebugPlayMovieCommand(char* args);
@@ -580,6 +609,7 @@ class ChatHandler
         bool HandleReloadLootTemplatesReferenceCommand(char* args);
         bool HandleReloadLootTemplatesSkinningCommand(char* args);
         bool HandleReloadLootTemplatesSpellCommand(char* args);
+        bool StartLootTemplatesReload(LootStore& store, void (*checker)());
         bool HandleReloadMailLevelRewardCommand(char* args);
         bool HandleReloadMangosStringCommand(char* args);
         bool HandleReloadNpcGossipCommand(char* args);
@@ -646,6 +676,9 @@ class ChatHandler
         bool HandleServerSetMotdCommand(char* args);
         bool HandleServerShutDownCommand(char* args);
         bool HandleServerShutDownCancelCommand(char* args);
+        bool HandleServerMemoryCommand(char* args);
+        bool HandleServerTickProfileCommand(char* args);
+        bool HandleServerTraceCommand(char* args);
 
         bool HandleTeleCommand(char* args);
         bool HandleTeleAddCommand(char* args);
@@ -866,6 +899,7 @@ class ChatHandler
         void HandleCharacterDeletedRestoreHelper(DeletedInfo const& delInfo);
 
         void SetSentErrorMessage(bool val) { sentErrorMessage = val;};
+        static bool IsCommandTableLoadPending() { return load_command_table; }
     private:
         WorldSession* m_session;                            // != nullptr for chat command call and nullptr for CLI command
 
@@ -883,9 +917,17 @@ class CliHandler : public ChatHandler
         Print m_print;
 
     public:
+        typedef bool (ChatHandler::*Handler)(char* args);
+
         CliHandler(uint32 accountId, AccountTypes accessLevel, Print zprint)
             : m_accountId(accountId), m_loginAccessLevel(accessLevel), m_print(std::move(zprint)) {}
 
+        // the command of a console line if it is marked AllowAsync, text is moved to its arguments and the command logged.
+        // caller holds the data lock of the ChatCommandWorker, the table may be reloaded otherwise
+        ChatCommand const* FindAsyncCommand(char const*& text);
+        // runs a command found by FindAsyncCommand with the error handling of ExecuteCommand
+        bool ExecuteAsyncCommand(Handler handler, char* args, std::string const& help);
+
         // overwrite functions
         const char* GetMangosString(int32 entry) const override;
         uint32 GetAccountId() const override;
@@ -898,4 +940,35 @@ class CliHandler : public ChatHandler
         int GetSessionDbLocaleIndex() const override;
 };
 
+// runs a command marked AllowAsync for a session on the ChatCommandWorker, the output is collected
+// and sent by the world thread. nothing of the session is accessed while the command runs
+class AsyncChatHandler : public ChatHandler
+{
+    public:
+        typedef bool (ChatHandler::*Handler)(char* args);
+
+        AsyncChatHandler(uint32 accountId, AccountTypes accessLevel, LocaleConstant dbcLocale, int dbLocaleIndex)
+            : m_accountId(accountId), m_accessLevel(accessLevel), m_dbcLocale(dbcLocale), m_dbLocaleIndex(dbLocaleIndex) {}
+
+        // same result as the command handler, the output is the one of a failed command too
+        bool Execute(Handler handler, char* args) { return (this->*handler)(args); }
+        std::vector<std::string>& GetOutput() { return m_output; }
+
+        // overwrite functions
+        const char* GetMangosString(int32 entry) const override;
+        uint32 GetAccountId() const override;
+        AccountTypes GetAccessLevel() const override;
+        void SendSysMessage(const char* str) override;
+        LocaleConstant GetSessionDbcLocale() const override;
+        int GetSessionDbLocaleIndex() const override;
+        bool IsChatOutput() const override { return true; }
+
+    private:
+        uint32 m_accountId;
+        AccountTypes m_accessLevel;
+        LocaleConstant m_dbcLocale;
+        int m_dbLocaleIndex;
+        std::vector<std::string> m_output;
+};
+
 #endif
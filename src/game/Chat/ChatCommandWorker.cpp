@@ -0,0 +1,178 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Chat/ChatCommandWorker.h"
+#include "Server/WorldSession.h"
+#include "Tools/Language.h"
+#include "World/World.h"
+
+void ChatCommandWorker::activate()
+{
+    if (activated())
+        return;
+
+    m_cancelationToken = false;
+    m_thread = std::thread(&ChatCommandWorker::WorkerThread, this);
+}
+
+void ChatCommandWorker::deactivate()
+{
+    if (!activated())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cancelationToken = true;
+    }
+    m_condition.notify_all();
+
+    m_thread.join();
+
+    for (ChatCommandRequest const& request : m_queue)
+        delete request.cliCommand;
+    m_queue.clear();
+    m_results.clear();
+}
+
+void ChatCommandWorker::Queue(ChatCommandRequest&& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_queue.push_back(std::move(request));
+    }
+
+    m_condition.notify_one();
+}
+
+bool ChatCommandWorker::QueueCliCommand(CliCommandHolder const* command)
+{
+    ChatCommandRequest request;
+    {
+        std::lock_guard<std::mutex> dataLock(m_dataLock);
+
+        CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
+        char const* args = &command->m_command[0];
+        ChatCommand const* chatCommand = handler.FindAsyncCommand(args);
+        if (!chatCommand)
+            return false;
+
+        request.handler = chatCommand->Handler;
+        request.args = args;
+        request.help = chatCommand->Help;
+    }
+
+    request.cliCommand = command;
+    request.accountId = command->m_cliAccountId;
+    request.accessLevel = command->m_cliAccessLevel;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_cancelationToken)
+            return false;
+
+        m_queue.push_back(std::move(request));
+    }
+
+    m_condition.notify_one();
+    return true;
+}
+
+void ChatCommandWorker::SendResults()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(m_resultLock);
+        if (m_results.empty())
+            return;
+
+        results.swap(m_results);
+    }
+
+    for (Result& result : results)
+    {
+        WorldSession* session = sWorld.FindSession(result.accountId);
+        if (!session)
+            continue;
+
+        ChatHandler handler(session);
+        for (std::string const& line : result.output)
+            handler.SendSysMessage(line.c_str());
+    }
+}
+
+void ChatCommandWorker::WorkerThread()
+{
+    while (true)
+    {
+        ChatCommandRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+            if (m_cancelationToken)
+                return;
+
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        if (request.cliCommand)
+        {
+            ExecuteCliCommand(request);
+            continue;
+        }
+
+        AsyncChatHandler handler(request.accountId, request.accessLevel, request.dbcLocale, request.dbLocaleIndex);
+        {
+            std::lock_guard<std::mutex> dataLock(m_dataLock);
+
+            // same as ChatHandler::ExecuteCommand, the sub command help is not needed for the leaf commands
+            if (!handler.Execute(request.handler, &request.args[0]) && !handler.HasSentErrorMessage())
+            {
+                if (!request.help.empty())
+                    handler.SendSysMessage(request.help.c_str());
+                else
+                    handler.SendSysMessage(handler.GetMangosString(LANG_CMD_SYNTAX));
+            }
+        }
+
+        Result result;
+        result.accountId = request.accountId;
+        result.output = std::move(handler.GetOutput());
+
+        std::lock_guard<std::mutex> lock(m_resultLock);
+        m_results.push_back(std::move(result));
+    }
+}
+
+void ChatCommandWorker::ExecuteCliCommand(ChatCommandRequest& request)
+{
+    CliCommandHolder const* command = request.cliCommand;
+
+    CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
+    bool success;
+    {
+        std::lock_guard<std::mutex> dataLock(m_dataLock);
+        success = handler.ExecuteAsyncCommand(request.handler, &request.args[0], request.help);
+    }
+
+    if (command->m_commandFinished)
+        command->m_commandFinished(success);
+
+    delete command;
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_CHATCOMMANDWORKER_H
+#define MANGOS_CHATCOMMANDWORKER_H
+
+#include "Common.h"
+#include "Chat/Chat.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct CliCommandHolder;
+
+// command of a session marked AllowAsync, taken with everything it needs of the session by the world thread,
+// or of a console line of the console, RA or SOAP taken by their thread
+struct ChatCommandRequest
+{
+    ChatCommandRequest() : cliCommand(nullptr) {}
+
+    CliCommandHolder const* cliCommand;                     // owned by the request, nullptr for session commands
+    uint32 accountId;
+    AccountTypes accessLevel;
+    LocaleConstant dbcLocale;
+    int dbLocaleIndex;
+    AsyncChatHandler::Handler handler;
+    std::string args;
+    std::string help;                                       // shown if the command fails without an error message
+};
+
+// thread running the read only commands, like the lookups scanning whole storages, away from the world
+// thread. the templates of the storages are never reloaded, the world thread holds the data lock while it
+// reloads the locales these commands read. the output is queued and sent by the world thread, which also
+// checks that the session is still there. the console lines are printed and finished by the worker itself,
+// their clients do not wait for a world tick
+class ChatCommandWorker
+{
+    public:
+        ChatCommandWorker() : m_cancelationToken(true) {} // no requests are taken before activate
+        ChatCommandWorker(const ChatCommandWorker&) = delete;
+
+        void activate();
+        void deactivate();
+        bool activated() const { return m_thread.joinable(); }
+
+        void Queue(ChatCommandRequest&& request);
+
+        // any thread, takes the line if it is a command marked AllowAsync, false if the world thread has to run it
+        bool QueueCliCommand(CliCommandHolder const* command);
+
+        // world thread, sends the output of the commands finished since the last call
+        void SendResults();
+
+        std::mutex& GetDataLock() { return m_dataLock; }
+
+    private:
+        struct Result
+        {
+            uint32 accountId;
+            std::vector<std::string> output;
+        };
+
+        void WorkerThread();
+        void ExecuteCliCommand(ChatCommandRequest& request);
+
+        std::thread m_thread;
+        std::atomic<bool> m_cancelationToken;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<ChatCommandRequest> m_queue;
+
+        std::mutex m_resultLock;
+        std::vector<Result> m_results;
+
+        std::mutex m_dataLock;
+};
+
+#endif
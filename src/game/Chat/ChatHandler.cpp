@@ -41,7 +41,7 @@
 #include "RandomPlayerbotMgr.h"
 #endif
 
-bool WorldSession::CheckChatMessage(std::string& msg, bool addon/* = false*/)
+bool WorldSession::CheckChatMessage(std::string& msg, bool addon/* = false*/, bool prepared/* = false*/)
 {
 #ifdef BUILD_PLAYERBOT
     // bot check can be avoided
@@ -49,6 +49,10 @@ bool WorldSession::CheckChatMessage(std::string& msg, bool addon/* = false*/)
         return true;
 #endif
 
+    // already checked by PrepareChatMessage
+    if (prepared)
+        return true;
+
     // check max length: as of 2.3.x+ no longer disconnects, silently truncates to 255 (wowwiki)
     if (msg.length() > 255)
         utf8limit(msg, 255);
@@ -78,10 +82,94 @@ bool WorldSession::CheckChatMessage(std::string& msg, bool addon/* = false*/)
     return true;
 }
 
+bool WorldSession::PrepareChatMessage(WorldPacket& packet) const
+{
+    try
+    {
+        uint32 type;
+        uint32 lang;
+        packet >> type;
+        packet >> lang;
+
+        if (type >= MAX_CHAT_MSG_TYPE)
+        {
+            sLog.outError("CHAT: Wrong message type received: %u", type);
+            return false;
+        }
+
+        if (type == CHAT_MSG_WHISPER || type == CHAT_MSG_CHANNEL)
+        {
+            std::string target;
+            packet >> target;
+        }
+
+        // the types the handler checks as addon messages, the others are checked as said
+        bool addon = false;
+        if (lang == LANG_ADDON)
+        {
+            switch (type)
+            {
+                case CHAT_MSG_WHISPER:
+                case CHAT_MSG_PARTY:
+                case CHAT_MSG_PARTY_LEADER:
+                case CHAT_MSG_GUILD:
+                case CHAT_MSG_OFFICER:
+                case CHAT_MSG_RAID:
+                case CHAT_MSG_BATTLEGROUND:
+                    addon = true;
+                    break;
+            }
+        }
+
+        size_t const msgPos = packet.rpos();
+        std::string msg;
+        packet.read(msg, false);
+
+        // commands are parsed from the message as sent
+        if (msg.empty() || msg[0] == '.' || msg[0] == '!')
+        {
+            packet.rpos(0);
+            return true;
+        }
+
+        if (msg.length() > 255)
+            utf8limit(msg, 255);
+
+        if (!addon && GetSecurity() <= SEC_PLAYER)
+        {
+            if (sWorld.getConfig(CONFIG_BOOL_CHAT_FAKE_MESSAGE_PREVENTING))
+                stripLineInvisibleChars(msg);
+
+            // the strict link check looks up templates that can be reloaded, it stays on the world thread, as does the
+            // handling of a failed check
+            if (uint32 severity = sWorld.getConfig(CONFIG_UINT32_CHAT_STRICT_LINK_CHECKING_SEVERITY))
+            {
+                if (severity >= 3 || !ChatHandler::CheckEscapeSequences(msg.c_str()))
+                {
+                    packet.rpos(0);
+                    return true;
+                }
+            }
+        }
+
+        packet.resize(msgPos);
+        packet << msg;
+        packet.SetPrepared();
+    }
+    catch (ByteBufferException const&)
+    {
+        // left to the handler, which reports it
+    }
+
+    packet.rpos(0);
+    return true;
+}
+
 void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
 {
     uint32 type;
     uint32 lang;
+    bool const prepared = recv_data.IsPrepared();
 
     recv_data >> type;
     recv_data >> lang;
@@ -193,7 +281,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg))
+            if (!CheckChatMessage(msg, false, prepared))
                 return;
 
             if (type == CHAT_MSG_SAY)
@@ -221,7 +309,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             if (!normalizePlayerName(to))
@@ -287,7 +375,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             // if player is in battleground, party chat is sent only to members of normal group
@@ -337,7 +425,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             if (GetPlayer()->GetGuildId())
@@ -374,7 +462,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             if (GetPlayer()->GetGuildId())
@@ -398,7 +486,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             // if player is in battleground, raid chat is sent only to members of normal group
@@ -442,7 +530,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (ChatHandler(this).ParseCommands(msg.c_str()))
                 break;
 
-            if (!CheckChatMessage(msg))
+            if (!CheckChatMessage(msg, false, prepared))
                 return;
 
             // if player is in battleground, raid chat is sent only to members of normal group
@@ -484,7 +572,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (msg.empty())
                 break;
 
-            if (!CheckChatMessage(msg))
+            if (!CheckChatMessage(msg, false, prepared))
                 return;
 
             // if player is in battleground, raid warning is sent only to players in battleground
@@ -531,7 +619,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (msg.empty())
                 break;
 
-            if (!CheckChatMessage(msg, (lang == LANG_ADDON)))
+            if (!CheckChatMessage(msg, (lang == LANG_ADDON), prepared))
                 return;
 
             // battleground chat is sent only to players in battleground
@@ -554,7 +642,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (msg.empty())
                 break;
 
-            if (!CheckChatMessage(msg))
+            if (!CheckChatMessage(msg, false, prepared))
                 return;
 
             // battleground chat is sent only to players in battleground
@@ -578,7 +666,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             if (msg.empty())
                 break;
 
-            if (!CheckChatMessage(msg))
+            if (!CheckChatMessage(msg, false, prepared))
                 return;
 
             if (ChannelMgr* cMgr = channelMgr(_player->GetTeam()))
@@ -615,7 +703,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 }
                 else                                // Update message
                 {
-                    if (!CheckChatMessage(msg))
+                    if (!CheckChatMessage(msg, false, prepared))
                         msg = GetMangosString(type == CHAT_MSG_AFK ? LANG_PLAYER_AFK_DEFAULT : LANG_PLAYER_DND_DEFAULT);
 
                     _player->autoReplyMsg = msg;
@@ -623,7 +711,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             }
             else                                    // New AFK/DND mode
             {
-                if (msg.empty() || !CheckChatMessage(msg))
+                if (msg.empty() || !CheckChatMessage(msg, false, prepared))
                     msg = GetMangosString(type == CHAT_MSG_AFK ? LANG_PLAYER_AFK_DEFAULT : LANG_PLAYER_DND_DEFAULT);
 
                 _player->autoReplyMsg = msg;
@@ -39,6 +39,7 @@
 #include "Spells/SpellMgr.h"
 #include "Maps/MapPersistentStateMgr.h"
 #include "Accounts/AccountMgr.h"
+#include "Globals/CharacterCache.h"
 #include "GMTickets/GMTicketMgr.h"
 #include "MotionGenerators/WaypointManager.h"
 #include "Util.h"
@@ -3614,6 +3615,7 @@ bool ChatHandler::HandleCharacterRenameCommand(char* args)
 
         PSendSysMessage(LANG_RENAME_PLAYER_GUID, oldNameLink.c_str(), target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '1' WHERE guid = '%u'", target_guid.GetCounter());
+        sCharacterCache.InvalidateCharacter(target_guid.GetCounter());
     }
 
     return true;
@@ -3640,6 +3642,7 @@ bool ChatHandler::HandleCharacterCustomizeCommand(char* args)
 
         PSendSysMessage(LANG_CUSTOMIZE_PLAYER_GUID, oldNameLink.c_str(), target_guid.GetCounter());
         CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '8' WHERE guid = '%u'", target_guid.GetCounter());
+        sCharacterCache.InvalidateCharacter(target_guid.GetCounter());
     }
 
     return true;
@@ -3654,11 +3657,14 @@ bool ChatHandler::HandleCharacterReputationCommand(char* args)
     LocaleConstant loc = GetSessionDbcLocale();
 
     FactionStateList const& targetFSL = target->GetReputationMgr().GetStateList();
-    for (const auto& itr : targetFSL)
+    for (FactionState const& state : targetFSL)
     {
-        FactionEntry const* factionEntry = sFactionStore.LookupEntry(itr.second.ID);
+        if (!state.ID)
+            continue;
+
+        FactionEntry const* factionEntry = sFactionStore.LookupEntry(state.ID);
 
-        ShowFactionListHelper(factionEntry, loc, &itr.second, target);
+        ShowFactionListHelper(factionEntry, loc, &state, target);
     }
     return true;
 }
@@ -5122,7 +5128,7 @@ bool ChatHandler::HandleMmapLocCommand(char* /*args*/)
 
     // calculate navmesh tile location
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(player->GetMapId());
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(player->GetMapId(), player->GetInstanceId());
+    MMAP::NavMeshQueryLease navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(player->GetMapId());
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -5167,7 +5173,7 @@ bool ChatHandler::HandleMmapLoadedTilesCommand(char* /*args*/)
     uint32 mapid = m_session->GetPlayer()->GetMapId();
 
     const dtNavMesh* navmesh = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMesh(mapid);
-    const dtNavMeshQuery* navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->GetNavMeshQuery(mapid, m_session->GetPlayer()->GetInstanceId());
+    MMAP::NavMeshQueryLease navmeshquery = MMAP::MMapFactory::createOrGetMMapManager()->LeaseNavMeshQuery(mapid);
     if (!navmesh || !navmeshquery)
     {
         PSendSysMessage("NavMesh not loaded for current map.");
@@ -5196,6 +5202,11 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     MMAP::MMapManager* manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
 
+    uint64 cacheHits, cacheMisses;
+    uint32 cacheSize;
+    manager->getPathCacheStats(cacheHits, cacheMisses, cacheSize);
+    PSendSysMessage(" path cache: %u corridors, " UI64FMTD " hits, " UI64FMTD " misses", cacheSize, cacheHits, cacheMisses);
+
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (!navmesh)
     {
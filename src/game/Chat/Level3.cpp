@@ -22,6 +22,9 @@
 #include "World/World.h"
 #include "Globals/ObjectMgr.h"
 #include "Accounts/AccountMgr.h"
+#include "Globals/CharacterCache.h"
+#include "Globals/QueryResponseCache.h"
+#include "Globals/NameLookupIndex.h"
 #include "Tools/PlayerDump.h"
 #include "Spells/SpellMgr.h"
 #include "Entities/Player.h"
@@ -57,6 +60,9 @@
 #include "Loot/LootMgr.h"
 #include "World/WorldState.h"
 #include "Arena/ArenaTeam.h"
+#include "TraceRecorder.h"
+#include "Utilities/MemoryAccounting.h"
+#include "Entities/NpcListCache.h"
 
 #ifdef BUILD_AHBOT
 #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -216,6 +222,13 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
 {
+    if (IsLootReloadRunning())
+    {
+        SendSysMessage("A loot table is still being reloaded, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading Loot Tables...");
     LoadLootTables();
     SendGlobalSysMessage("DB tables `*_loot_template` reloaded.");
@@ -370,7 +383,10 @@ bool ChatHandler::HandleReloadAreaTriggerTeleportCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadCommandCommand(char* /*args*/)
 {
-    load_command_table = true;
+    {
+        std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
+        load_command_table = true;
+    }
     SendGlobalSysMessage("DB table `command` will be reloaded at next chat command use.");
     return true;
 }
@@ -393,6 +409,14 @@ bool ChatHandler::HandleReloadCreatureQuestInvRelationsCommand(char* /*args*/)
 
 bool ChatHandler::HandleReloadConditionsCommand(char* /*args*/)
 {
+    // the loot tables read in the background check their conditions
+    if (IsLootReloadRunning())
+    {
+        SendSysMessage("A loot table is still being reloaded, try again later.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
     sLog.outString("Re-Loading `conditions`... ");
     sObjectMgr.LoadConditions();
     SendGlobalSysMessage("DB table `conditions` reloaded.");
@@ -402,6 +426,7 @@ bool ChatHandler::HandleReloadConditionsCommand(char* /*args*/)
 bool ChatHandler::HandleReloadGossipMenuCommand(char* /*args*/)
 {
     sObjectMgr.LoadGossipMenus();
+    sObjectMgr.PrecompileGossipMenus();
     SendGlobalSysMessage("DB tables `gossip_menu` and `gossip_menu_option` reloaded.");
     return true;
 }
@@ -464,6 +489,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Quest Templates...");
     sObjectMgr.LoadQuests();
+    sNameLookupIndex.Clear(NAME_LOOKUP_QUEST);
     SendGlobalSysMessage("DB table `quest_template` (quest definitions) reloaded.");
 
     /// dependent also from `gameobject` but this table not reloaded anyway
@@ -473,116 +499,85 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
     return true;
 }
 
-bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
+bool ChatHandler::StartLootTemplatesReload(LootStore& store, void (*checker)())
 {
-    sLog.outString("Re-Loading Loot Tables... (`creature_loot_template`)");
-    LoadLootTemplates_Creature();
-    LootTemplates_Creature.CheckLootRefs();
-    SendGlobalSysMessage("DB table `creature_loot_template` reloaded.");
+    if (!store.StartReload(checker))
+    {
+        PSendSysMessage("DB table `%s` is still being reloaded.", store.GetName());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    // the templates in use are replaced between two ticks once read, not to stop the world while the table loads
+    sLog.outString("Re-Loading Loot Tables... (`%s`)", store.GetName());
+    PSendSysMessage("DB table `%s` is read in the background, it replaces the loaded one when done.", store.GetName());
     return true;
 }
 
+bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
+{
+    return StartLootTemplatesReload(LootTemplates_Creature, &LoadLootTemplates_Creature);
+}
+
 bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`disenchant_loot_template`)");
-    LoadLootTemplates_Disenchant();
-    LootTemplates_Disenchant.CheckLootRefs();
-    SendGlobalSysMessage("DB table `disenchant_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Disenchant, &LoadLootTemplates_Disenchant);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`fishing_loot_template`)");
-    LoadLootTemplates_Fishing();
-    LootTemplates_Fishing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `fishing_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Fishing, &LoadLootTemplates_Fishing);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`gameobject_loot_template`)");
-    LoadLootTemplates_Gameobject();
-    LootTemplates_Gameobject.CheckLootRefs();
-    SendGlobalSysMessage("DB table `gameobject_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Gameobject, &LoadLootTemplates_Gameobject);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`item_loot_template`)");
-    LoadLootTemplates_Item();
-    LootTemplates_Item.CheckLootRefs();
-    SendGlobalSysMessage("DB table `item_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Item, &LoadLootTemplates_Item);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMillingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`milling_loot_template`)");
-    LoadLootTemplates_Milling();
-    LootTemplates_Milling.CheckLootRefs();
-    SendGlobalSysMessage("DB table `milling_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Milling, &LoadLootTemplates_Milling);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`pickpocketing_loot_template`)");
-    LoadLootTemplates_Pickpocketing();
-    LootTemplates_Pickpocketing.CheckLootRefs();
-    SendGlobalSysMessage("DB table `pickpocketing_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Pickpocketing, &LoadLootTemplates_Pickpocketing);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesProspectingCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`prospecting_loot_template`)");
-    LoadLootTemplates_Prospecting();
-    LootTemplates_Prospecting.CheckLootRefs();
-    SendGlobalSysMessage("DB table `prospecting_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Prospecting, &LoadLootTemplates_Prospecting);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`mail_loot_template`)");
-    LoadLootTemplates_Mail();
-    LootTemplates_Mail.CheckLootRefs();
-    SendGlobalSysMessage("DB table `mail_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Mail, &LoadLootTemplates_Mail);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`reference_loot_template`)");
-    LoadLootTemplates_Reference();
-    SendGlobalSysMessage("DB table `reference_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Reference, &LoadLootTemplates_Reference);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`skinning_loot_template`)");
-    LoadLootTemplates_Skinning();
-    LootTemplates_Skinning.CheckLootRefs();
-    SendGlobalSysMessage("DB table `skinning_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Skinning, &LoadLootTemplates_Skinning);
 }
 
 bool ChatHandler::HandleReloadLootTemplatesSpellCommand(char* /*args*/)
 {
-    sLog.outString("Re-Loading Loot Tables... (`spell_loot_template`)");
-    LoadLootTemplates_Spell();
-    LootTemplates_Spell.CheckLootRefs();
-    SendGlobalSysMessage("DB table `spell_loot_template` reloaded.");
-    return true;
+    return StartLootTemplatesReload(LootTemplates_Spell, &LoadLootTemplates_Spell);
 }
 
 bool ChatHandler::HandleReloadMangosStringCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading mangos_string Table!");
+    std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
     sObjectMgr.LoadMangosStrings();
     SendGlobalSysMessage("DB table `mangos_string` reloaded.");
     return true;
@@ -612,6 +607,7 @@ bool ChatHandler::HandleReloadNpcTrainerCommand(char* /*args*/)
 
     sLog.outString("Re-Loading `npc_trainer` Table!");
     sObjectMgr.LoadTrainers();
+    sNpcListCache.Clear();
     SendGlobalSysMessage("DB table `npc_trainer` reloaded.");
     return true;
 }
@@ -625,6 +621,7 @@ bool ChatHandler::HandleReloadNpcVendorCommand(char* /*args*/)
 
     sLog.outString("Re-Loading `npc_vendor` Table!");
     sObjectMgr.LoadVendors();
+    sNpcListCache.Clear();
     SendGlobalSysMessage("DB table `npc_vendor` reloaded.");
     return true;
 }
@@ -721,6 +718,7 @@ bool ChatHandler::HandleReloadSpellChainCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Spell Chain Data... ");
     sSpellMgr.LoadSpellChains();
+    sNpcListCache.Clear();                                  // trainer lists show the previous ranks
     SendGlobalSysMessage("DB table `spell_chain` (spell ranks) reloaded.");
     return true;
 }
@@ -1063,7 +1061,12 @@ bool ChatHandler::HandleReloadLocalesAchievementRewardCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Creature ...");
-    sObjectMgr.LoadCreatureLocales();
+    {
+        std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
+        sObjectMgr.LoadCreatureLocales();
+    }
+    sQueryResponseCache.Clear(QUERY_RESPONSE_CREATURE);
+    sNameLookupIndex.Clear(NAME_LOOKUP_CREATURE);
     SendGlobalSysMessage("DB table `locales_creature` reloaded.");
     return true;
 }
@@ -1071,7 +1074,12 @@ bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLocalesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gameobject ... ");
-    sObjectMgr.LoadGameObjectLocales();
+    {
+        std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
+        sObjectMgr.LoadGameObjectLocales();
+    }
+    sQueryResponseCache.Clear(QUERY_RESPONSE_GAMEOBJECT);
+    sNameLookupIndex.Clear(NAME_LOOKUP_GAMEOBJECT);
     SendGlobalSysMessage("DB table `locales_gameobject` reloaded.");
     return true;
 }
@@ -1080,6 +1088,7 @@ bool ChatHandler::HandleReloadLocalesGossipMenuOptionCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gossip Menu Option ... ");
     sObjectMgr.LoadGossipMenuItemsLocales();
+    sObjectMgr.PrecompileGossipMenus();
     SendGlobalSysMessage("DB table `locales_gossip_menu_option` reloaded.");
     return true;
 }
@@ -1087,7 +1096,12 @@ bool ChatHandler::HandleReloadLocalesGossipMenuOptionCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
-    sObjectMgr.LoadItemLocales();
+    {
+        std::lock_guard<std::mutex> guard(sWorld.GetChatCommandWorker().GetDataLock());
+        sObjectMgr.LoadItemLocales();
+    }
+    sQueryResponseCache.Clear(QUERY_RESPONSE_ITEM);
+    sNameLookupIndex.Clear(NAME_LOOKUP_ITEM);
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -1120,6 +1134,7 @@ bool ChatHandler::HandleReloadLocalesQuestCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Quest ... ");
     sObjectMgr.LoadQuestLocales();
+    sNameLookupIndex.Clear(NAME_LOOKUP_QUEST);
     SendGlobalSysMessage("DB table `locales_quest` reloaded.");
     return true;
 }
@@ -2623,7 +2638,7 @@ void ChatHandler::ShowItemListHelper(uint32 itemId, int loc_idx, Player* target
             usableStr = GetMangosString(LANG_COMMAND_ITEM_USABLE);
     }
 
-    if (m_session)
+    if (IsChatOutput())
         PSendSysMessage(LANG_ITEM_LIST_CHAT, itemId, itemId, name.c_str(), usableStr);
     else
         PSendSysMessage(LANG_ITEM_LIST_CONSOLE, itemId, name.c_str(), usableStr);
@@ -2643,12 +2658,13 @@ bool ChatHandler::HandleLookupItemCommand(char* args)
 
     wstrToLower(wnamepart);
 
+    // the usable marks need the player, not accessible from the ChatCommandWorker
     Player* pl = m_session ? m_session->GetPlayer() : nullptr;
 
     uint32 counter = 0;
 
-    // Search in `item_template`
-    for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+    // Search in `item_template`, the index leaves only the items with a matching name in any locale
+    for (uint32 id : sNameLookupIndex.Search(NAME_LOOKUP_ITEM, wnamepart))
     {
         ItemPrototype const* pProto = sItemStorage.LookupEntry<ItemPrototype >(id);
         if (!pProto)
@@ -2718,7 +2734,7 @@ bool ChatHandler::HandleLookupItemSetCommand(char* args)
             if (loc < MAX_LOCALE)
             {
                 // send item set in "id - [namedlink locale]" format
-                if (m_session)
+                if (IsChatOutput())
                     PSendSysMessage(LANG_ITEMSET_LIST_CHAT, id, id, name.c_str(), localeNames[loc]);
                 else
                     PSendSysMessage(LANG_ITEMSET_LIST_CONSOLE, id, name.c_str(), localeNames[loc]);
@@ -2876,7 +2892,7 @@ bool ChatHandler::HandleLookupSpellCommand(char* args)
     uint32 counter = 0;                                     // Counter for figure out that we found smth.
 
     // Search in Spell.dbc
-    for (uint32 id = 0; id < sSpellTemplate.GetMaxEntry(); ++id)
+    for (uint32 id : sNameLookupIndex.Search(NAME_LOOKUP_SPELL, wnamepart))
     {
         SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(id);
         if (spellInfo)
@@ -2968,10 +2984,11 @@ bool ChatHandler::HandleLookupQuestCommand(char* args)
 
     int loc_idx = GetSessionDbLocaleIndex();
 
-    ObjectMgr::QuestMap const& qTemplates = sObjectMgr.GetQuestTemplates();
-    for (const auto& qTemplate : qTemplates)
+    for (uint32 id : sNameLookupIndex.Search(NAME_LOOKUP_QUEST, wnamepart))
     {
-        Quest* qinfo = qTemplate.second;
+        Quest const* qinfo = sObjectMgr.GetQuestTemplate(id);
+        if (!qinfo)
+            continue;
 
         std::string title;                                  // "" for avoid repeating check default locale
         sObjectMgr.GetQuestLocaleStrings(qinfo->GetQuestId(), loc_idx, &title);
@@ -3005,7 +3022,7 @@ bool ChatHandler::HandleLookupCreatureCommand(char* args)
 
     uint32 counter = 0;
 
-    for (uint32 id = 0; id < sCreatureStorage.GetMaxEntry(); ++id)
+    for (uint32 id : sNameLookupIndex.Search(NAME_LOOKUP_CREATURE, wnamepart))
     {
         CreatureInfo const* cInfo = sCreatureStorage.LookupEntry<CreatureInfo> (id);
         if (!cInfo)
@@ -3022,7 +3039,7 @@ bool ChatHandler::HandleLookupCreatureCommand(char* args)
                 continue;
         }
 
-        if (m_session)
+        if (IsChatOutput())
             PSendSysMessage(LANG_CREATURE_ENTRY_LIST_CHAT, id, id, name);
         else
             PSendSysMessage(LANG_CREATURE_ENTRY_LIST_CONSOLE, id, name);
@@ -3052,12 +3069,16 @@ bool ChatHandler::HandleLookupObjectCommand(char* args)
 
     uint32 counter = 0;
 
-    for (SQLStorageBase::SQLSIterator<GameObjectInfo> itr = sGOStorage.getDataBegin<GameObjectInfo>(); itr < sGOStorage.getDataEnd<GameObjectInfo>(); ++itr)
+    for (uint32 id : sNameLookupIndex.Search(NAME_LOOKUP_GAMEOBJECT, wnamepart))
     {
+        GameObjectInfo const* goInfo = sGOStorage.LookupEntry<GameObjectInfo>(id);
+        if (!goInfo)
+            continue;
+
         int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
-            GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(itr->id);
+            GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(goInfo->id);
             if (gl)
             {
                 if ((int32)gl->Name.size() > loc_idx && !gl->Name[loc_idx].empty())
@@ -3066,10 +3087,10 @@ bool ChatHandler::HandleLookupObjectCommand(char* args)
 
                     if (Utf8FitTo(name, wnamepart))
                     {
-                        if (m_session)
-                            PSendSysMessage(LANG_GO_ENTRY_LIST_CHAT, itr->id, itr->id, name.c_str());
+                        if (IsChatOutput())
+                            PSendSysMessage(LANG_GO_ENTRY_LIST_CHAT, goInfo->id, goInfo->id, name.c_str());
                         else
-                            PSendSysMessage(LANG_GO_ENTRY_LIST_CONSOLE, itr->id, name.c_str());
+                            PSendSysMessage(LANG_GO_ENTRY_LIST_CONSOLE, goInfo->id, name.c_str());
                         ++counter;
                         continue;
                     }
@@ -3077,16 +3098,16 @@ bool ChatHandler::HandleLookupObjectCommand(char* args)
             }
         }
 
-        std::string name = itr->name;
+        std::string name = goInfo->name;
         if (name.empty())
             continue;
 
         if (Utf8FitTo(name, wnamepart))
         {
-            if (m_session)
-                PSendSysMessage(LANG_GO_ENTRY_LIST_CHAT, itr->id, itr->id, name.c_str());
+            if (IsChatOutput())
+                PSendSysMessage(LANG_GO_ENTRY_LIST_CHAT, goInfo->id, goInfo->id, name.c_str());
             else
-                PSendSysMessage(LANG_GO_ENTRY_LIST_CONSOLE, itr->id, name.c_str());
+                PSendSysMessage(LANG_GO_ENTRY_LIST_CONSOLE, goInfo->id, name.c_str());
             ++counter;
         }
     }
@@ -3292,6 +3313,7 @@ bool ChatHandler::HandleGuildRankCommand(char* args)
     else
         slot->ChangeRank(newrank);
 
+    targetGuild->InvalidateRoster();
     return true;
 }
 
@@ -4034,6 +4056,7 @@ void ChatHandler::HandleCharacterLevel(Player* player, ObjectGuid player_guid, u
     {
         // update level and XP at level, all other will be updated at loading
         CharacterDatabase.PExecute("UPDATE characters SET level = '%u', xp = 0 WHERE guid = '%u'", newlevel, player_guid.GetCounter());
+        sCharacterCache.InvalidateCharacter(player_guid.GetCounter());
     }
 }
 
@@ -4880,9 +4903,7 @@ bool ChatHandler::HandleResetAllCommand(char* args)
     }
 
     CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'", atLogin, atLogin);
-    HashMapHolder<Player>::MapType const& plist = sObjectAccessor.GetPlayers();
-    for (const auto& itr : plist)
-        itr.second->SetAtLoginFlag(atLogin);
+    HashMapHolder<Player>::DoForAll([atLogin](Player* player) { player->SetAtLoginFlag(atLogin); });
 
     return true;
 }
@@ -4973,6 +4994,111 @@ bool ChatHandler::HandleServerIdleShutDownCommand(char* args)
     return true;
 }
 
+// .server memory
+bool ChatHandler::HandleServerMemoryCommand(char* /*args*/)
+{
+    MemoryAccounting::AllocatorStats allocatorStats;
+    if (MemoryAccounting::GetAllocatorStats(allocatorStats))
+        PSendSysMessage("Allocator %s: %.1f MB allocated, %.1f MB held, %.1f MB resident.", MemoryAccounting::GetAllocatorName(),
+                        allocatorStats.allocatedBytes / 1048576.0, allocatorStats.committedBytes / 1048576.0, allocatorStats.residentBytes / 1048576.0);
+    else
+        PSendSysMessage("Allocator %s: no statistics available.", MemoryAccounting::GetAllocatorName());
+
+    for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+    {
+        MemoryAccounting::TagStats stats;
+        MemoryAccounting::GetTagStats(MemoryTag(i), stats);
+        PSendSysMessage("  %s: %.1f MB in " UI64FMTD " allocations, " UI64FMTD " since start", MemoryAccounting::GetTagName(MemoryTag(i)),
+                        stats.bytes / 1048576.0, stats.allocations, stats.totalAllocations);
+    }
+    return true;
+}
+
+// .server tickprofile [on|off|#count]
+bool ChatHandler::HandleServerTickProfileCommand(char* args)
+{
+    TickProfiler& profiler = sWorld.GetTickProfiler();
+    if (ExtractLiteralArg(&args, "on"))
+    {
+        profiler.SetEnabled(true);
+        SendSysMessage("Tick profiling enabled.");
+        return true;
+    }
+    if (ExtractLiteralArg(&args, "off"))
+    {
+        profiler.SetEnabled(false);
+        SendSysMessage("Tick profiling disabled.");
+        return true;
+    }
+
+    uint32 maxCount;
+    if (!ExtractOptUInt32(&args, maxCount, 5))
+        return false;
+
+    PSendSysMessage("Tick profiling is %s, ticks of at least %u ms are kept.", profiler.IsEnabled() ? "on" : "off", profiler.GetSlowTickThreshold() / IN_MILLISECONDS);
+
+    std::vector<TickSample> ticks;
+    profiler.GetSlowTicks(ticks, maxCount);
+    if (ticks.empty())
+    {
+        SendSysMessage("No slow tick recorded.");
+        return true;
+    }
+
+    for (TickSample const& tick : ticks)
+    {
+        PSendSysMessage("%s: %.1f ms, %s", tick.owner.c_str(), tick.duration / 1000.0f, TimeToTimestampStr(tick.time).c_str());
+        for (TickPhaseSample const& phase : tick.phases)
+        {
+            // phases under a millisecond only clutter the output
+            if (phase.duration < IN_MILLISECONDS)
+                continue;
+            PSendSysMessage("%*s%s: %.1f ms", int(2 + 2 * phase.depth), "", phase.name, phase.duration / 1000.0f);
+        }
+    }
+    return true;
+}
+
+// .server trace [#seconds|stop]
+bool ChatHandler::HandleServerTraceCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "stop"))
+    {
+        if (!TraceRecorder::IsRecording())
+        {
+            SendSysMessage("No trace is recorded.");
+            return true;
+        }
+
+        sTraceRecorder.Stop();
+        PSendSysMessage("Trace stopped, writing %s.", sTraceRecorder.GetFileName().c_str());
+        return true;
+    }
+
+    uint32 seconds;
+    if (!ExtractOptUInt32(&args, seconds, 10))
+        return false;
+
+    // every span of every thread is kept in memory until the end
+    if (!seconds || seconds > 60)
+    {
+        SendSysMessage("A trace can be recorded for 1 to 60 seconds.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::string fileName = sLog.GetLogsDir() + "trace_" + Log::GetTimestampStr() + ".json";
+    if (!sTraceRecorder.Start(fileName, seconds))
+    {
+        SendSysMessage("A trace is already recorded or still written.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Recording a trace for %u seconds into %s.", seconds, fileName.c_str());
+    return true;
+}
+
 bool ChatHandler::HandleQuestAddCommand(char* args)
 {
     Player* player = getSelectedPlayer();
@@ -5850,7 +5976,16 @@ bool ChatHandler::HandlePDumpWriteCommand(char* args)
         return false;
     }
 
-    switch (PlayerDumpWriter().WriteDump(file, lowguid))
+    DumpFormat format = DUMP_FORMAT_TEXT;
+    if (char* formatStr = ExtractLiteralArg(&args))
+    {
+        if (strncmp(formatStr, "binary", strlen(formatStr)) != 0)
+            return false;
+
+        format = DUMP_FORMAT_BINARY;
+    }
+
+    switch (PlayerDumpWriter().WriteDump(file, lowguid, format))
     {
         case DUMP_SUCCESS:
             PSendSysMessage(LANG_COMMAND_EXPORT_SUCCESS);
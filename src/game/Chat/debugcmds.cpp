@@ -28,6 +28,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include <fstream>
 #include "Maps/MapManager.h"
+#include "World/World.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "Spells/SpellMgr.h"
@@ -1242,6 +1243,9 @@ bool ChatHandler::HandleShowTemporarySpawnList(char* /*args*/)
     for (std::map<uint32, uint32>::iterator it = temp_pet.begin(); it != temp_pet.end(); ++it)
         PSendSysMessage("Entry: %u, Count: %u ", (*it).first, (*it).second);
 
+    if (SummonPool* pool = pPlayer->GetMap()->GetSummonPool())
+        PSendSysMessage("Summon pool: %u hits, %u misses, %u free blocks.", pool->GetHits(), pool->GetMisses(), pool->GetFreeBlocks());
+
     return true;
 }
 
@@ -1255,6 +1259,57 @@ bool ChatHandler::HandleGridsLoadedCount(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleIdleCreaturesCount(char* /*args*/)
+{
+    Player* player = m_session->GetPlayer();
+    if (!player)
+        return false;
+
+    if (!sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL))
+    {
+        SendSysMessage("Idle creatures are updated every tick, CreatureIdleUpdateInterval is 0.");
+        return true;
+    }
+
+    Map* map = player->GetMap();
+    PSendSysMessage("Last update of this map: %u creatures awake, %u asleep.", map->GetAwakeCreaturesCount(), map->GetAsleepCreaturesCount());
+    return true;
+}
+
+// .debug performance conditions [on|off|reset|#count]
+bool ChatHandler::HandleConditionsProfile(char* args)
+{
+    bool enable;
+    if (ExtractOnOff(&args, enable))
+    {
+        SetConditionProfiling(enable);
+        PSendSysMessage("Condition profiling %s.", enable ? "enabled" : "disabled");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        ResetConditionProfile();
+        SendSysMessage("Condition profile reset.");
+        return true;
+    }
+
+    uint32 maxCount;
+    if (!ExtractOptUInt32(&args, maxCount, 20))
+        return false;
+
+    std::vector<std::pair<uint32, uint32>> profile;
+    GetConditionProfile(profile, maxCount);
+
+    PSendSysMessage("Condition profiling is %s, most checked conditions:", IsConditionProfiling() ? "enabled" : "disabled");
+    for (auto const& itr : profile)
+    {
+        ConditionEntry const* condition = sConditionStorage.LookupEntry<ConditionEntry>(itr.first);
+        PSendSysMessage("Condition %u type %i: %u checks", itr.first, condition ? condition->GetConditionType() : 0, itr.second);
+    }
+    return true;
+}
+
 bool ChatHandler::HandleDebugWaypoint(char* args)
 {
     Creature* target = getSelectedCreature();
@@ -1535,6 +1590,86 @@ bool ChatHandler::HandleDebugPacketHistory(char* args)
     return true;
 }
 
+// .debug opcodestats [reset|#count]
+bool ChatHandler::HandleDebugOpcodeStatsCommand(char* args)
+{
+    OpcodeStats& opcodeStats = sWorld.GetOpcodeStats();
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        opcodeStats.Reset();
+        SendSysMessage("Opcode stats reset.");
+        return true;
+    }
+
+    uint32 maxCount;
+    if (!ExtractOptUInt32(&args, maxCount, 20))
+        return false;
+
+    std::vector<OpcodeStat> stats;
+    opcodeStats.GetStats(stats);
+
+    // only the sampled packets are timed, scale their time to every received one
+    auto totalTime = [](OpcodeStat const& stat) { return stat.sampled ? double(stat.handlerTime) * stat.received / stat.sampled : 0.0; };
+    std::sort(stats.begin(), stats.end(), [&](OpcodeStat const& left, OpcodeStat const& right)
+    {
+        double const leftTime = totalTime(left);
+        double const rightTime = totalTime(right);
+        return leftTime != rightTime ? leftTime > rightTime : left.bytesIn + left.bytesOut > right.bytesIn + right.bytesOut;
+    });
+    if (stats.size() > maxCount)
+        stats.resize(maxCount);
+
+    if (uint32 rate = opcodeStats.GetSampleRate())
+        PSendSysMessage("Opcodes by handler time, one out of %u packets timed:", rate);
+    else
+        SendSysMessage("OpcodeStats.SampleRate is 0, only packet counts and sizes are known:");
+
+    for (OpcodeStat const& stat : stats)
+    {
+        PSendSysMessage("%s: in " UI64FMTD " (" UI64FMTD " B) out " UI64FMTD " (" UI64FMTD " B)", LookupOpcodeName(stat.opcode), stat.received, stat.bytesIn, stat.sent, stat.bytesOut);
+        if (stat.sampled)
+            PSendSysMessage("    %.1f ms total, avg " UI64FMTD " us, p99 " UI64FMTD " us, max " UI64FMTD " us, queued avg " UI64FMTD " us",
+                            totalTime(stat) / 1000.0, stat.handlerTime / stat.sampled, stat.GetPercentile(0.99f), stat.maxHandlerTime, stat.waitTime / stat.sampled);
+    }
+    return true;
+}
+
+// .debug playerupdates [on|off|reset]
+bool ChatHandler::HandleDebugPlayerUpdatesCommand(char* args)
+{
+    PlayerUpdateStats& playerUpdateStats = sWorld.GetPlayerUpdateStats();
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        playerUpdateStats.Reset();
+        SendSysMessage("Player update stats reset.");
+        return true;
+    }
+
+    if (*args)
+    {
+        bool value;
+        if (!ExtractOnOff(&args, value))
+            return false;
+
+        playerUpdateStats.SetEnabled(value);
+        PSendSysMessage("Player update stats %s.", value ? "enabled" : "disabled");
+        return true;
+    }
+
+    std::vector<PlayerSubUpdateStat> stats;
+    uint64 updates = playerUpdateStats.GetStats(stats);
+    if (!updates)
+    {
+        SendSysMessage(playerUpdateStats.IsEnabled() ? "No player updated yet." : "Player update stats are disabled, enable them with .debug playerupdates on");
+        return true;
+    }
+
+    PSendSysMessage("Parts run of " UI64FMTD " player updates:", updates);
+    for (PlayerSubUpdateStat const& stat : stats)
+        PSendSysMessage("%s: " UI64FMTD " (%.2f%%)", stat.name, stat.runs, stat.runs * 100.0 / updates);
+    return true;
+}
+
 bool ChatHandler::HandleDebugObjectFlags(char* args)
 {
     char* debugCmd = ExtractLiteralArg(&args);
@@ -235,6 +235,23 @@ void ThreatContainer::clearReferences()
         delete (*i);
     }
     iThreatList.clear();
+    iThreatIndex.clear();
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* ref)
+{
+    iThreatList.remove(ref);
+    iThreatIndex.erase(ref->getUnitGuid());
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* hostileReference)
+{
+    iThreatList.push_back(hostileReference);
+    iThreatIndex[hostileReference->getUnitGuid()] = hostileReference;
 }
 
 //============================================================
@@ -245,13 +262,8 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* victim)
     if (!victim)
         return nullptr;
 
-    ObjectGuid guid = victim->GetObjectGuid();
-
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-        if ((*i)->getUnitGuid() == guid)
-            return (*i);
-
-    return nullptr;
+    auto itr = iThreatIndex.find(victim->GetObjectGuid());
+    return itr != iThreatIndex.end() ? itr->second : nullptr;
 }
 
 //============================================================
@@ -308,31 +320,48 @@ void ThreatContainer::update(bool force, bool isPlayer)
 {
     if ((iDirty || force || isPlayer) && iThreatList.size() > 1)
     {
-        iThreatList.sort([&](const HostileReference* lhs, const HostileReference* rhs)->bool
+        Unit* owner = iThreatList.front()->getSource()->getOwner();
+
+        // melee reach and attackability are costly, look them up once per reference
+        iSortEntries.clear();
+        iSortEntries.reserve(iThreatList.size());
+        for (ThreatList::iterator itr = iThreatList.begin(); itr != iThreatList.end(); ++itr)
+        {
+            HostileReference* ref = *itr;
+            Unit* target = ref->getTarget();
+            iSortEntries.push_back({ itr, ref->getThreat(), ref->GetTauntState(), ref->GetHostileState(),
+                isPlayer && target->IsPlayer(), isPlayer && owner->CanAttack(target), force && owner->CanReachWithMeleeAttack(target) });
+        }
+
+        auto compare = [isPlayer, force](SortEntry const& lhs, SortEntry const& rhs)->bool
         {
-            Unit* owner = lhs->getSource()->getOwner();
             if (isPlayer)
             {
-                Unit* left = lhs->getTarget();
-                Unit* right = rhs->getTarget();
-                if (left->IsPlayer() && !right->IsPlayer())
+                if (lhs.isPlayer && !rhs.isPlayer)
                     return true;
-                if (owner->CanAttack(left) && !owner->CanAttack(right))
+                if (lhs.canAttack && !rhs.canAttack)
                     return true;
             }
-            if (lhs->GetTauntState() != rhs->GetTauntState())
-                return lhs->GetTauntState() > rhs->GetTauntState();
+            if (lhs.tauntState != rhs.tauntState)
+                return lhs.tauntState > rhs.tauntState;
             if (force)
             {
-                bool first = owner->CanReachWithMeleeAttack(lhs->getTarget());
-                bool second = owner->CanReachWithMeleeAttack(rhs->getTarget());
-                if (first != second)
-                    return first > second;
+                if (lhs.inMelee != rhs.inMelee)
+                    return lhs.inMelee > rhs.inMelee;
             }
-            if (lhs->GetHostileState() != rhs->GetHostileState())
-                return lhs->GetHostileState() > rhs->GetHostileState();
-            return lhs->getThreat() > rhs->getThreat(); // reverse sorting
-        });
+            if (lhs.hostileState != rhs.hostileState)
+                return lhs.hostileState > rhs.hostileState;
+            return lhs.threat > rhs.threat; // reverse sorting
+        };
+
+        // usually only a few threat values changed and the order still holds
+        if (!std::is_sorted(iSortEntries.begin(), iSortEntries.end(), compare))
+        {
+            // stable like std::list::sort, references with equal criteria keep their order
+            std::stable_sort(iSortEntries.begin(), iSortEntries.end(), compare);
+            for (SortEntry const& entry : iSortEntries)
+                iThreatList.splice(iThreatList.end(), iThreatList, entry.itr);
+        }
     }
     iDirty = false;
 }
@@ -26,6 +26,8 @@
 #include "Timer.h"
 #include "Entities/ObjectGuid.h"
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 //==============================================================
 
@@ -176,14 +178,28 @@ class ThreatContainer
     protected:
         friend class ThreatManager;
 
-        void remove(HostileReference* ref) { iThreatList.remove(ref); }
-        void addReference(HostileReference* hostileReference) { iThreatList.push_back(hostileReference); }
+        void remove(HostileReference* ref);
+        void addReference(HostileReference* hostileReference);
         void clearReferences();
         // Sort the list if necessary
         void update(bool force, bool isPlayer);
 
         ThreatList iThreatList;
     private:
+        // sort criteria of one reference, gathered once per update instead of at every comparison
+        struct SortEntry
+        {
+            ThreatList::iterator itr;
+            float threat;
+            TauntState tauntState;
+            HostileState hostileState;
+            bool isPlayer;
+            bool canAttack;
+            bool inMelee;
+        };
+
+        std::unordered_map<ObjectGuid, HostileReference*> iThreatIndex;
+        std::vector<SortEntry> iSortEntries;                // kept to reuse its storage
         bool iDirty;
 };
 
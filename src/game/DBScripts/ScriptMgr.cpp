@@ -49,6 +49,12 @@ INSTANTIATE_SINGLETON_1(ScriptMgr);
 ScriptMgr::ScriptMgr()
 {
     m_scheduledScripts = 0;
+
+    for (uint32 i = 0; i < MAX_SCRIPT_COMMAND; ++i)
+    {
+        m_commandCounts[i] = 0;
+        m_commandTimes[i] = 0;
+    }
 }
 
 // /////////////////////////////////////////////////////////
@@ -76,6 +82,24 @@ uint8 GetSpellStartDBScriptPriority(SpellEntry const* spellinfo, SpellEffectInde
 }
 
 // Priorize: SCRIPT_EFFECT before DUMMY before Non-Existing triggered spell, for same priority the first effect with the priority triggers
+void ScriptMgr::AddCommandTime(uint32 command, uint64 time)
+{
+    if (command >= MAX_SCRIPT_COMMAND)
+        return;
+
+    m_commandCounts[command].fetch_add(1, std::memory_order_relaxed);
+    m_commandTimes[command].fetch_add(time, std::memory_order_relaxed);
+}
+
+void ScriptMgr::GetCommandStats(CommandStat (&stats)[MAX_SCRIPT_COMMAND])
+{
+    for (uint32 i = 0; i < MAX_SCRIPT_COMMAND; ++i)
+    {
+        stats[i].count = m_commandCounts[i].exchange(0);
+        stats[i].time = m_commandTimes[i].exchange(0);
+    }
+}
+
 bool ScriptMgr::CanSpellEffectStartDBScript(SpellEntry const* spellinfo, SpellEffectIndex effIdx)
 {
     uint8 priority = GetSpellStartDBScriptPriority(spellinfo, effIdx);
@@ -1344,6 +1368,14 @@ Player* ScriptAction::GetPlayerTargetOrSourceAndLog(WorldObject* pSource, WorldO
 /// Handle one Script Step
 // Return true if and only if further parts of this script shall be skipped
 bool ScriptAction::HandleScriptStep()
+{
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    bool const terminate = ExecuteScriptStep();
+    sScriptMgr.AddCommandTime(m_script->command, uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+    return terminate;
+}
+
+bool ScriptAction::ExecuteScriptStep()
 {
     WorldObject* pSource;
     WorldObject* pTarget;
@@ -132,6 +132,8 @@ enum ScriptCommand                                          // resSource, resTar
     // datalong2:0x00=toggle, 0x01=add, 0x02=remove
 };
 
+#define MAX_SCRIPT_COMMAND 49
+
 #define MAX_TEXT_ID 4                                       // used for SCRIPT_COMMAND_TALK, SCRIPT_COMMAND_EMOTE, SCRIPT_COMMAND_CAST_SPELL, SCRIPT_COMMAND_TERMINATE_SCRIPT
 
 enum ScriptInfoDataFlags
@@ -526,7 +528,7 @@ class ScriptAction
             m_table(_table), m_map(_map), m_sourceGuid(_sourceGuid), m_targetGuid(_targetGuid), m_ownerGuid(_ownerGuid), m_script(_script)
         {}
 
-        bool HandleScriptStep();                            // return true IF AND ONLY IF the script should be terminated
+        bool HandleScriptStep();                            // return true IF AND ONLY IF the script should be terminated, timed per command
 
         const char* GetTableName() const { return m_table; }
         uint32 GetId() const { return m_script->id; }
@@ -550,6 +552,8 @@ class ScriptAction
         ObjectGuid m_ownerGuid;                             // owner of source if source is item
         ScriptInfo const* m_script;                         // pointer to static script data
 
+        bool ExecuteScriptStep();
+
         // Helper functions
         bool GetScriptCommandObject(const ObjectGuid guid, bool includeItem, Object*& resultObject) const;
         bool GetScriptProcessTargets(WorldObject* pOrigSource, WorldObject* pOrigTarget, WorldObject*& pFinalSource, WorldObject*& pFinalTarget) const;
@@ -618,6 +622,16 @@ class ScriptMgr
         uint32 DecreaseScheduledScriptCount() { return (uint32)--m_scheduledScripts; }
         uint32 DecreaseScheduledScriptCount(size_t count) { return (uint32)(m_scheduledScripts -= count); }
         bool IsScriptScheduled() const { return m_scheduledScripts > 0; }
+
+        // steps run and their time in microseconds per command on all maps, since the last call
+        struct CommandStat
+        {
+            uint64 count;
+            uint64 time;
+        };
+        void AddCommandTime(uint32 command, uint64 time);
+        void GetCommandStats(CommandStat (&stats)[MAX_SCRIPT_COMMAND]);
+
         static bool CanSpellEffectStartDBScript(SpellEntry const* spellinfo, SpellEffectIndex effIdx);
 
         static void CollectPossibleEventIds(std::set<uint32>& eventIds);
@@ -641,6 +655,9 @@ class ScriptMgr
 
         // atomic op counter for active scripts amount
         std::atomic_long m_scheduledScripts;
+
+        std::atomic<uint64> m_commandCounts[MAX_SCRIPT_COMMAND];
+        std::atomic<uint64> m_commandTimes[MAX_SCRIPT_COMMAND];
 };
 
 // Starters for events
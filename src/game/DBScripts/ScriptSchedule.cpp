@@ -0,0 +1,150 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "DBScripts/ScriptSchedule.h"
+#include "Policies/Singleton.h"
+
+#include <algorithm>
+
+ScriptSchedule::ScriptSchedule() : m_lastStep(0), m_processedTick(0)
+{
+}
+
+ScriptSchedule::~ScriptSchedule()
+{
+    if (!m_steps.empty())
+        sScriptMgr.DecreaseScheduledScriptCount(m_steps.size());
+}
+
+void ScriptSchedule::Add(TimePoint time, ScriptAction const& action)
+{
+    uint64 const step = ++m_lastStep;
+    m_steps.emplace(step, Step{ time, action });
+    m_slots[std::max(GetTick(time), m_processedTick) % SLOTS].push_back(step);
+    m_scripts[ScriptKey(action.GetTableName(), action.GetId())].push_back(step);
+    sScriptMgr.IncreaseScheduledScriptsCount();
+}
+
+void ScriptSchedule::Remove(uint64 step)
+{
+    auto itr = m_steps.find(step);
+    if (itr == m_steps.end())
+        return;
+
+    auto scriptItr = m_scripts.find(ScriptKey(itr->second.action.GetTableName(), itr->second.action.GetId()));
+    std::vector<uint64>& steps = scriptItr->second;
+    steps.erase(std::find(steps.begin(), steps.end(), step));
+    if (steps.empty())
+        m_scripts.erase(scriptItr);
+
+    m_steps.erase(itr);
+    sScriptMgr.DecreaseScheduledScriptCount();
+}
+
+void ScriptSchedule::Process(TimePoint now)
+{
+    uint64 const nowTick = GetTick(now);
+    if (m_steps.empty())
+    {
+        m_processedTick = nowTick;
+        return;
+    }
+
+    // a full round visits every slot
+    uint64 firstTick = std::max(m_processedTick, nowTick >= SLOTS ? nowTick - SLOTS + 1 : 0);
+
+    std::vector<std::pair<TimePoint, uint64>> due;
+    for (uint64 tick = firstTick; tick <= nowTick; ++tick)
+    {
+        std::vector<uint64>& slot = m_slots[tick % SLOTS];
+        auto kept = slot.begin();
+        for (uint64 step : slot)
+        {
+            auto itr = m_steps.find(step);
+            if (itr == m_steps.end())
+                continue;
+
+            if (itr->second.time <= now)
+                due.emplace_back(itr->second.time, step);
+            else
+                *kept++ = step;
+        }
+        slot.erase(kept, slot.end());
+    }
+    m_processedTick = nowTick;
+
+    std::sort(due.begin(), due.end());
+
+    for (auto const& dueStep : due)
+    {
+        auto itr = m_steps.find(dueStep.second);
+        if (itr == m_steps.end())                           // terminated by an earlier step
+            continue;
+
+        // copied, the step may start scripts and so add steps
+        ScriptAction action = itr->second.action;
+        if (action.HandleScriptStep())
+        {
+            // Terminate following script steps of this script
+            RemoveScript(action.GetTableName(), action.GetId(), action.GetSourceGuid(), action.GetTargetGuid(), action.GetOwnerGuid());
+        }
+        else
+            Remove(dueStep.second);
+    }
+}
+
+bool ScriptSchedule::HasScript(const char* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const
+{
+    auto scriptItr = m_scripts.find(ScriptKey(table, id));
+    if (scriptItr == m_scripts.end())
+        return false;
+
+    for (uint64 step : scriptItr->second)
+        if (m_steps.find(step)->second.action.IsSameScript(table, id, sourceGuid, targetGuid, ownerGuid))
+            return true;
+
+    return false;
+}
+
+void ScriptSchedule::RemoveScript(const char* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid)
+{
+    auto scriptItr = m_scripts.find(ScriptKey(table, id));
+    if (scriptItr == m_scripts.end())
+        return;
+
+    std::vector<uint64>& steps = scriptItr->second;
+    size_t removed = 0;
+    for (auto itr = steps.begin(); itr != steps.end();)
+    {
+        auto stepItr = m_steps.find(*itr);
+        if (stepItr->second.action.IsSameScript(table, id, sourceGuid, targetGuid, ownerGuid))
+        {
+            m_steps.erase(stepItr);
+            itr = steps.erase(itr);
+            ++removed;
+        }
+        else
+            ++itr;
+    }
+
+    if (steps.empty())
+        m_scripts.erase(scriptItr);
+
+    if (removed)
+        sScriptMgr.DecreaseScheduledScriptCount(removed);
+}
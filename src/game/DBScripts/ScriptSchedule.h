@@ -0,0 +1,77 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SCRIPT_SCHEDULE_H
+#define MANGOS_SCRIPT_SCHEDULE_H
+
+#include "Common.h"
+#include "DBScripts/ScriptMgr.h"
+
+#include <unordered_map>
+#include <vector>
+
+// delayed db script steps of a map on a timer wheel: a slot per tick of TICK_MS, going round every SLOTS ticks.
+// steps further away wait for their round in their slot. the steps are also indexed by table and script id
+// for the unique start and the termination of a script, which had to search the whole schedule before
+class ScriptSchedule
+{
+    public:
+        ScriptSchedule();
+        ~ScriptSchedule();
+        ScriptSchedule(const ScriptSchedule&) = delete;
+
+        void Add(TimePoint time, ScriptAction const& action);
+
+        // runs the steps due at now by time, the steps of the same time in the order they were added
+        void Process(TimePoint now);
+
+        // empty guids match any
+        bool HasScript(const char* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid) const;
+        void RemoveScript(const char* table, uint32 id, ObjectGuid sourceGuid, ObjectGuid targetGuid, ObjectGuid ownerGuid);
+
+        size_t size() const { return m_steps.size(); }
+        bool empty() const { return m_steps.empty(); }
+
+    private:
+        static uint32 const TICK_MS = 50;
+        static uint32 const SLOTS = 256;
+
+        struct Step
+        {
+            TimePoint time;
+            ScriptAction action;
+        };
+
+        typedef std::pair<const char*, uint32> ScriptKey;
+        struct ScriptKeyHash
+        {
+            size_t operator()(ScriptKey const& key) const { return std::hash<const char*>()(key.first) ^ (size_t(key.second) * 0x9E3779B1); }
+        };
+
+        static uint64 GetTick(TimePoint time) { return uint64(time.time_since_epoch().count()) / TICK_MS; }
+
+        void Remove(uint64 step);
+
+        uint64 m_lastStep;                                  // steps are numbered in the order they were added
+        uint64 m_processedTick;                             // visited again by the next Process, steps may have been added to it
+        std::unordered_map<uint64, Step> m_steps;
+        std::vector<uint64> m_slots[SLOTS];                 // removed steps are dropped when their slot is visited
+        std::unordered_map<ScriptKey, std::vector<uint64>, ScriptKeyHash> m_scripts;
+};
+
+#endif
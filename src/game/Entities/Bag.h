@@ -60,6 +60,7 @@ class Bag : public Item
         // DB operations
         // overwrite virtual Item::SaveToDB
         void SaveToDB() override;
+        using Item::SaveToDB;
         // overwrite virtual Item::LoadFromDB
         bool LoadFromDB(uint32 guidLow, Field* fields, ObjectGuid ownerGuid = ObjectGuid()) override;
         // overwrite virtual Item::DeleteFromDB
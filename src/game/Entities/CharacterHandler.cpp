@@ -38,11 +38,16 @@
 #include "Tools/Language.h"
 #include "Spells/SpellMgr.h"
 #include "Calendar/Calendar.h"
+#include "Globals/CharacterCache.h"
 
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
 #endif
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
 #ifdef ENABLE_PLAYERBOTS
 #include "playerbot.h"
 #include "PlayerbotAIConfig.h"
@@ -61,11 +66,13 @@ class LoginQueryHolder : public SqlQueryHolder
     private:
         uint32 m_accountId;
         ObjectGuid m_guid;
+        uint32 m_requestTime;                               // the login was requested, for the login metrics
     public:
         LoginQueryHolder(uint32 accountId, ObjectGuid guid)
-            : m_accountId(accountId), m_guid(guid) { }
+            : m_accountId(accountId), m_guid(guid), m_requestTime(WorldTimer::getMSTime()) { }
         ObjectGuid GetGuid() const { return m_guid; }
         uint32 GetAccountId() const { return m_accountId; }
+        uint32 GetRequestTime() const { return m_requestTime; }
         bool Initialize();
 };
 
@@ -207,7 +214,6 @@ bool LoginQueryHolder::Initialize()
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADSKILLS,          "SELECT skill, value, max FROM character_skills WHERE guid = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADGLYPHS,          "SELECT spec, slot, glyph FROM character_glyphs WHERE guid='%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILS,           "SELECT id,messageType,sender,receiver,subject,body,expire_time,deliver_time,money,cod,checked,stationery,mailTemplateId,has_items FROM mail WHERE receiver = '%u' ORDER BY id DESC", m_guid.GetCounter());
-    res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,     "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE receiver = '%u'", m_guid.GetCounter());
     res &= SetPQuery(PLAYER_LOGIN_QUERY_LOADRANDOMBATTLEGROUND, "SELECT guid FROM character_battleground_random WHERE guid = '%u'", m_guid.GetCounter());
 
     return res;
@@ -219,10 +225,12 @@ bool LoginQueryHolder::Initialize()
 class CharacterHandler
 {
     public:
-        void HandleCharEnumCallback(QueryResult* result, uint32 account)
+        void HandleCharEnumCallback(QueryResult* result, uint32 account, uint32 cacheTicket)
         {
             if (WorldSession* session = sWorld.FindSession(account))
-                session->HandleCharEnum(result);
+                session->HandleCharEnum(result, cacheTicket);
+            else
+                delete result;
         }
 
         void HandlePlayerLoginCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
@@ -278,11 +286,12 @@ class CharacterHandler
 #endif
 } chrHandler;
 
-void WorldSession::HandleCharEnum(QueryResult* result)
+void WorldSession::HandleCharEnum(QueryResult* result, uint32 cacheTicket)
 {
     WorldPacket data(SMSG_CHAR_ENUM, 100);                  // we guess size
 
     uint8 num = 0;
+    std::vector<uint32> guids;
 
     data << num;
 
@@ -294,6 +303,7 @@ void WorldSession::HandleCharEnum(QueryResult* result)
             DETAIL_LOG("Build enum data for char guid %u from account %u.", guidlow, GetAccountId());
             if (Player::BuildEnumData(result, data))
                 ++num;
+            guids.push_back(guidlow);
         }
         while (result->NextRow());
 
@@ -302,13 +312,22 @@ void WorldSession::HandleCharEnum(QueryResult* result)
 
     data.put<uint8>(0, num);
 
+    sCharacterCache.StoreCharEnum(GetAccountId(), cacheTicket, data, std::move(guids));
     SendPacket(data);
 }
 
 void WorldSession::HandleCharEnumOpcode(WorldPacket& /*recv_data*/)
 {
+    // the character screen is requested again on each return to it and by reconnecting clients
+    WorldPacket data;
+    if (sCharacterCache.GetCharEnum(GetAccountId(), data))
+    {
+        SendPacket(data);
+        return;
+    }
+
     /// get all the data necessary for loading all characters (along with their pets) on the account
-    CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(),
+    CharacterDatabase.AsyncPQuery(&chrHandler, &CharacterHandler::HandleCharEnumCallback, GetAccountId(), sCharacterCache.GetCharEnumTicket(GetAccountId()),
                                   !sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) ?
                                   //   ------- Query Without Declined Names --------
                                   //           0               1                2                3                 4                  5                       6                        7
@@ -788,6 +807,10 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 {
     ObjectGuid playerGuid = holder->GetGuid();
 
+#ifdef BUILD_METRICS
+    uint32 const loadStartTime = WorldTimer::getMSTime();
+#endif
+
     Player* pCurrChar = new Player(this);
     SetPlayer(pCurrChar, playerGuid);
     m_playerLoading = true;
@@ -884,7 +907,7 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 
             guild->DisplayGuildBankTabsInfo(this);
 
-            guild->BroadcastEvent(GE_SIGNED_ON, pCurrChar->GetObjectGuid(), pCurrChar->GetName());
+            guild->QueueMemberPresence(pCurrChar->GetObjectGuid(), pCurrChar->GetName(), true);
         }
         else
         {
@@ -1067,6 +1090,13 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
     if (pCurrChar->HasAtLoginFlag(AT_LOGIN_FIRST) && ((!pCurrChar->m_cinematicMgr || (pCurrChar->m_cinematicMgr && !pCurrChar->m_cinematicMgr->GetActiveCinematicCamera())) && sWorld.getConfig(CONFIG_BOOL_COLLECTORS_EDITION)))
         pCurrChar->RemoveAtLoginFlag(AT_LOGIN_FIRST);
 
+#ifdef BUILD_METRICS
+    // wait: request until the queries are done, load: building the character in the world thread
+    metric::measurement meas("session.login");
+    meas.add_field("wait", std::to_string(WorldTimer::getMSTimeDiff(holder->GetRequestTime(), loadStartTime)));
+    meas.add_field("load", std::to_string(WorldTimer::getMSTimeDiff(loadStartTime, WorldTimer::getMSTime())));
+#endif
+
     delete holder;
 }
 
@@ -1125,7 +1155,7 @@ void WorldSession::HandlePlayerReconnect()
             SendPacket(data);
             DEBUG_LOG("WORLD: Sent guild-motd (SMSG_GUILD_EVENT)");
 
-            guild->BroadcastEvent(GE_SIGNED_ON, _player->GetObjectGuid(), _player->GetName());
+            guild->QueueMemberPresence(_player->GetObjectGuid(), _player->GetName(), true);
         }
         else
         {
@@ -1352,6 +1382,7 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
     CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_RENAME), guidLow);
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
     CharacterDatabase.CommitTransaction();
+    sCharacterCache.InvalidateCharacter(guidLow);
 
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s", session->GetAccountId(), session->GetRemoteAddress().c_str(), oldname.c_str(), guidLow, newname.c_str());
 
@@ -1444,6 +1475,7 @@ void WorldSession::HandleSetPlayerDeclinedNamesOpcode(WorldPacket& recv_data)
     CharacterDatabase.PExecute("INSERT INTO character_declinedname (guid, genitive, dative, accusative, instrumental, prepositional) VALUES ('%u','%s','%s','%s','%s','%s')",
                                guid.GetCounter(), declinedname.name[0].c_str(), declinedname.name[1].c_str(), declinedname.name[2].c_str(), declinedname.name[3].c_str(), declinedname.name[4].c_str());
     CharacterDatabase.CommitTransaction();
+    sCharacterCache.InvalidateCharacter(guid.GetCounter());
 
     WorldPacket data(SMSG_SET_PLAYER_DECLINED_NAMES_RESULT, 4 + 8);
     data << uint32(0);                                      // OK
@@ -1599,6 +1631,7 @@ void WorldSession::HandleCharCustomizeOpcode(WorldPacket& recv_data)
     Player::Customize(guid, gender, skin, face, hairStyle, hairColor, facialHair);
     CharacterDatabase.PExecute("UPDATE characters set name = '%s', at_login = at_login & ~ %u WHERE guid ='%u'", newname.c_str(), uint32(AT_LOGIN_CUSTOMIZE), guid.GetCounter());
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guid.GetCounter());
+    sCharacterCache.InvalidateCharacter(guid.GetCounter());
 
     sLog.outChar("Account: %d (IP: %s), Character %s customized to: %s", GetAccountId(), GetRemoteAddress().c_str(), guid.GetString().c_str(), newname.c_str());
 
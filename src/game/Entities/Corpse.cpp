@@ -99,10 +99,7 @@ void Corpse::SaveToDB()
     // bones should not be saved to DB (would be deleted on startup anyway)
     MANGOS_ASSERT(GetType() != CORPSE_BONES);
 
-    // prevent DB data inconsistence problems and duplicates
-    CharacterDatabase.BeginTransaction();
-    DeleteFromDB();
-
+    // replaces the old corpse of the owner when the world thread writes the corpse changes
     std::ostringstream ss;
     ss  << "INSERT INTO corpse (guid,player,position_x,position_y,position_z,orientation,map,time,corpse_type,instance,phaseMask) VALUES ("
         << GetGUIDLow() << ", "
@@ -116,8 +113,7 @@ void Corpse::SaveToDB()
         << uint32(GetType()) << ", "
         << int(GetInstanceId()) << ", "
         << uint16(GetPhaseMask()) << ")";           // prevent out of range error
-    CharacterDatabase.Execute(ss.str().c_str());
-    CharacterDatabase.CommitTransaction();
+    sObjectAccessor.QueueCorpseSave(GetOwnerGuid().GetCounter(), ss.str());
 }
 
 void Corpse::DeleteBonesFromWorld()
@@ -140,10 +136,7 @@ void Corpse::DeleteFromDB() const
     MANGOS_ASSERT(GetType() != CORPSE_BONES);
 
     // all corpses (not bones)
-    static SqlStatementID id;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(id, "DELETE FROM corpse WHERE player = ? AND corpse_type <> '0'");
-    stmt.PExecute(GetOwnerGuid().GetCounter());
+    sObjectAccessor.QueueCorpseDelete(GetOwnerGuid().GetCounter());
 }
 
 bool Corpse::LoadFromDB(uint32 lowguid, Field* fields)
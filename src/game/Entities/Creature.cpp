@@ -45,6 +45,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Movement/MoveSplineInit.h"
+#include "Movement/MoveSpline.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Entities/Transports.h"
 
@@ -137,7 +138,7 @@ Creature::Creature(CreatureSubtype subtype) : Unit(),
     m_lootMoney(0), m_lootGroupRecipientId(0),
     m_lootStatus(CREATURE_LOOT_STATUS_NONE),
     m_respawnTime(0), m_respawnDelay(25), m_respawnOverriden(false), m_respawnOverrideOnce(false), m_corpseDelay(60), m_canAggro(false),
-    m_respawnradius(5.0f), m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE),
+    m_respawnradius(5.0f), m_idleUpdateDiff(0), m_subtype(subtype), m_defaultMovementType(IDLE_MOTION_TYPE),
     m_equipmentId(0), m_AlreadyCallAssistance(false),
     m_isDeadByDefault(false),
     m_temporaryFactionFlags(TEMPFACTION_NONE),
@@ -640,8 +641,21 @@ uint32 Creature::ChooseDisplayId(const CreatureInfo* cinfo, const CreatureData*
     return display_id;
 }
 
-void Creature::Update(const uint32 diff)
+void Creature::Update(const uint32 tickDiff)
 {
+    // idle creatures skip ticks, the update after them gets all the time they slept
+    m_idleUpdateDiff += tickDiff;
+    if (uint32 const idleInterval = sWorld.getConfig(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL))
+    {
+        bool const asleep = m_idleUpdateDiff < idleInterval && IsIdleForUpdate();
+        GetMap()->CountCreatureUpdate(asleep);
+        if (asleep)
+            return;
+    }
+
+    uint32 const diff = m_idleUpdateDiff;
+    m_idleUpdateDiff = 0;
+
     switch (m_deathState)
     {
         case JUST_ALIVED:
@@ -738,6 +752,37 @@ void Creature::Update(const uint32 diff)
     }
 }
 
+bool Creature::IsIdleForUpdate() const
+{
+    if (m_deathState != ALIVE || IsInCombat() || GetVictim() || GetCombatManager().IsInEvadeMode())
+        return false;
+
+    // controlled and active creatures are expected to follow their master or the world closely
+    if (GetMasterGuid() || isActiveObject() || IsVehicle())
+        return false;
+
+    if (!movespline->Finalized() || i_motionMaster.GetCurrentMovementGeneratorType() != IDLE_MOTION_TYPE)
+        return false;
+
+    if (IsNonMeleeSpellCasted(false) || !m_events.Empty())
+        return false;
+
+    // auras only tick and expire in updates, a late one would be noticed
+    for (auto const& itr : GetSpellAuraHolderMap())
+    {
+        SpellAuraHolder const* holder = itr.second;
+        if (holder->GetAuraMaxDuration() >= 0)
+            return false;
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+            if (Aura const* aura = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
+                if (aura->IsPeriodic())
+                    return false;
+    }
+
+    return true;
+}
+
 void Creature::RegenerateAll(uint32 update_diff)
 {
     if (m_regenTimer > 0)
@@ -24,6 +24,7 @@
 #include "Globals/SharedDefines.h"
 #include "Server/DBCEnums.h"
 #include "Util.h"
+#include "Utilities/SlabAllocator.h"
 
 #include <list>
 #include <memory>
@@ -613,6 +614,10 @@ class Creature : public Unit
         explicit Creature(CreatureSubtype subtype = CREATURE_SUBTYPE_GENERIC);
         virtual ~Creature();
 
+        // creatures come and go with their grid, keep them out of the general heap
+        static void* operator new(size_t size) { return SlabAllocator::Allocate(size, MEMORY_TAG_GRIDS); }
+        static void operator delete(void* ptr, size_t size) { SlabAllocator::Deallocate(ptr, size, MEMORY_TAG_GRIDS); }
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
         virtual void CleanupsBeforeDelete() override;
@@ -628,7 +633,9 @@ class Creature : public Unit
 
         char const* GetSubName() const { return GetCreatureInfo()->SubName; }
 
-        void Update(const uint32 diff) override;  // overwrite Unit::Update
+        void Update(const uint32 tickDiff) override;  // overwrite Unit::Update
+        // nothing of the creature needs an update every tick, it may sleep for CreatureIdleUpdateInterval
+        bool IsIdleForUpdate() const;
 
         virtual void RegenerateAll(uint32 update_diff);
         uint32 GetEquipmentId() const { return m_equipmentId; }
@@ -937,6 +944,7 @@ class Creature : public Unit
         TimePoint m_pickpocketRestockTime;                  // (msecs) time point of pickpocket restock
         bool m_canAggro;                                    // controls response of creature to attacks
         float m_respawnradius;
+        uint32 m_idleUpdateDiff;                            // (msecs) time slept, given to the next real update
 
         CreatureSubtype m_subtype;                          // set in Creatures subclasses for fast it detect without dynamic_cast use
         void RegeneratePower(float timerMultiplier);
@@ -362,13 +362,22 @@ void CreatureLinkingHolder::AddSlaveToHolder(Creature* pCreature)
         return;
     }
 
+    // Link to the masters already spawned
+    BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
+    for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
+        if (Creature* pMaster = pCreature->GetMap()->GetCreature(itr->second))
+            LinkSlaveToMaster(pMaster, pCreature, pInfo->linkingFlag, pInfo->searchRange);
+
     // First try to find holder with same flag
     HolderMapBounds bounds = m_holderMap.equal_range(pInfo->masterId);
     for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
         if (itr->second.linkingFlag == pInfo->linkingFlag && itr->second.searchRange == pInfo->searchRange)
         {
-            itr->second.linkedGuids.push_back(pCreature->GetObjectGuid());
+            // Grid reloads add the same spawns again
+            GuidList& linkedGuids = itr->second.linkedGuids;
+            if (std::find(linkedGuids.begin(), linkedGuids.end(), pCreature->GetObjectGuid()) == linkedGuids.end())
+                linkedGuids.push_back(pCreature->GetObjectGuid());
             pCreature = nullptr;                               // Store that is was handled
             break;
         }
@@ -395,6 +404,25 @@ void CreatureLinkingHolder::AddMasterToHolder(Creature* pCreature)
     if (!sCreatureLinkingMgr.IsLinkedMaster(pCreature))
         return;
 
+    // Link the slaves already spawned, also when the master is spawned again as they may have been spawned meanwhile
+    HolderMapBounds slaveBounds = m_holderMap.equal_range(pCreature->GetEntry());
+    for (HolderMap::iterator itr = slaveBounds.first; itr != slaveBounds.second; ++itr)
+    {
+        for (GuidList::iterator slave_itr = itr->second.linkedGuids.begin(); slave_itr != itr->second.linkedGuids.end();)
+        {
+            Creature* pSlave = pCreature->GetMap()->GetCreature(*slave_itr);
+            if (!pSlave)
+            {
+                // Remove old guid, added again when spawned again
+                slave_itr = itr->second.linkedGuids.erase(slave_itr);
+                continue;
+            }
+
+            LinkSlaveToMaster(pCreature, pSlave, itr->second.linkingFlag, itr->second.searchRange);
+            ++slave_itr;
+        }
+    }
+
     // Check, if already stored
     BossGuidMapBounds bounds = m_masterGuid.equal_range(pCreature->GetEntry());
     for (BossGuidMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
@@ -404,6 +432,38 @@ void CreatureLinkingHolder::AddMasterToHolder(Creature* pCreature)
     m_masterGuid.insert(BossGuidMap::value_type(pCreature->GetEntry(), pCreature->GetObjectGuid()));
 }
 
+// Helper function, to link a master and a slave of the entry case if the slave belongs to it
+void CreatureLinkingHolder::LinkSlaveToMaster(Creature* pMaster, Creature* pSlave, uint16 linkingFlag, uint16 searchRange)
+{
+    if (pMaster == pSlave || !IsSlaveInRangeOfMaster(pSlave, pMaster, searchRange))
+        return;
+
+    std::vector<LinkedSlave>& slaves = m_masterSlaves[pMaster->GetObjectGuid()].slaves;
+    for (LinkedSlave const& slave : slaves)
+        if (slave.guid == pSlave->GetObjectGuid() && slave.linkingFlag == linkingFlag)
+            return;                                         // Already linked
+
+    slaves.push_back({ pSlave->GetObjectGuid(), linkingFlag });
+
+    GuidVector& masters = m_slaveMasters[pSlave->GetObjectGuid()];
+    if (std::find(masters.begin(), masters.end(), pMaster->GetObjectGuid()) == masters.end())
+        masters.push_back(pMaster->GetObjectGuid());
+}
+
+// Helper function, to find the master of a slave in the entry case
+Creature* CreatureLinkingHolder::GetLinkedMaster(Creature* pSlave) const
+{
+    SlaveMastersMap::const_iterator find = m_slaveMasters.find(pSlave->GetObjectGuid());
+    if (find == m_slaveMasters.end())
+        return nullptr;
+
+    for (ObjectGuid const& masterGuid : find->second)
+        if (Creature* pMaster = pSlave->GetMap()->GetCreature(masterGuid))
+            return pMaster;
+
+    return nullptr;
+}
+
 // Function to process actions for linked NPCs
 void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventType, Creature* pSource, Unit* pEnemy /* = nullptr*/)
 {
@@ -431,19 +491,17 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     }
 
     // Process Slaves (by entry)
-    HolderMapBounds bounds = m_holderMap.equal_range(pSource->GetEntry());
-    for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
+    MasterSlavesMap::iterator linked = m_masterSlaves.find(pSource->GetObjectGuid());
+    if (linked != m_masterSlaves.end() && !linked->second.inUse)
     {
-        if (!itr->second.inUse)
-        {
-            itr->second.inUse = true;
-            ProcessSlaveGuidList(eventType, pSource, itr->second.linkingFlag & eventFlagFilter, itr->second.searchRange, itr->second.linkedGuids, pEnemy);
-            itr->second.inUse = false;
-        }
+        LinkedSlaves& linkedSlaves = linked->second;        // stays valid when the processing links new creatures
+        linkedSlaves.inUse = true;
+        ProcessLinkedSlaves(eventType, pSource, eventFlagFilter, linkedSlaves, pEnemy);
+        linkedSlaves.inUse = false;
     }
 
     // Process Slaves (by guid)
-    bounds = m_holderGuidMap.equal_range(pSource->GetGUIDLow());
+    HolderMapBounds bounds = m_holderGuidMap.equal_range(pSource->GetGUIDLow());
     for (HolderMap::iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
         if (!itr->second.inUse)
@@ -461,18 +519,7 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
         {
             Creature* pMaster = nullptr;
             if (pInfo->mapId != INVALID_MAP_ID)             // entry case
-            { 
-                BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-                for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-                {
-                    Creature* master = pSource->GetMap()->GetCreature(itr->second);
-                    if (master && IsSlaveInRangeOfMaster(pSource, master, pInfo->searchRange))
-                    {
-                        pMaster = master;
-                        break;
-                    }
-                }
-            }
+                pMaster = GetLinkedMaster(pSource);
             else                                            // guid case
             {
                 CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
@@ -515,6 +562,33 @@ void CreatureLinkingHolder::DoCreatureLinkingEvent(CreatureLinkingEvent eventTyp
     }
 }
 
+// Helper function, to process the resolved slaves of a master
+void CreatureLinkingHolder::ProcessLinkedSlaves(CreatureLinkingEvent eventType, Creature* pSource, uint32 eventFlagFilter, LinkedSlaves& linkedSlaves, Unit* pEnemy)
+{
+    // by index, processing a slave can spawn and link new ones
+    for (size_t i = 0; i < linkedSlaves.slaves.size();)
+    {
+        LinkedSlave const slave = linkedSlaves.slaves[i];
+        Creature* pSlave = pSource->GetMap()->GetCreature(slave.guid);
+        if (!pSlave)
+        {
+            // Remove old guid first, linked again when spawned again
+            linkedSlaves.slaves.erase(linkedSlaves.slaves.begin() + i);
+            m_slaveMasters.erase(slave.guid);
+            continue;
+        }
+
+        ++i;
+
+        // Ignore Pets
+        if (pSlave->IsPet())
+            continue;
+
+        if (uint32 flag = slave.linkingFlag & eventFlagFilter)
+            ProcessSlave(eventType, pSource, flag, pSlave, pEnemy);
+    }
+}
+
 // Helper function, to process a slave list
 void CreatureLinkingHolder::ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, GuidList& slaveGuidList, Unit* pEnemy)
 {
@@ -753,15 +827,7 @@ bool CreatureLinkingHolder::TryFollowMaster(Creature* pCreature)
 
     Creature* pMaster = nullptr;
     if (pInfo->mapId != INVALID_MAP_ID)                     // entry case
-    {
-        BossGuidMapBounds finds = m_masterGuid.equal_range(pInfo->masterId);
-        for (BossGuidMap::const_iterator itr = finds.first; itr != finds.second; ++itr)
-        {
-            pMaster = pCreature->GetMap()->GetCreature(itr->second);
-            if (pMaster && IsSlaveInRangeOfMaster(pCreature, pMaster, pInfo->searchRange))
-                break;
-        }
-    }
+        pMaster = GetLinkedMaster(pCreature);
     else                                                    // guid case
     {
         CreatureData const* masterData = sObjectMgr.GetCreatureData(pInfo->masterDBGuid);
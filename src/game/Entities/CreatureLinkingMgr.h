@@ -186,6 +186,26 @@ class CreatureLinkingHolder
         typedef std::multimap < uint32 /*Entry*/, ObjectGuid > BossGuidMap;
         typedef std::pair<BossGuidMap::const_iterator, BossGuidMap::const_iterator> BossGuidMapBounds;
 
+        // Resolved links of the entry case, between the guids of the masters and slaves spawned on this map
+        struct LinkedSlave
+        {
+            ObjectGuid guid;
+            uint16 linkingFlag;
+        };
+        struct LinkedSlaves
+        {
+            std::vector<LinkedSlave> slaves;
+            bool inUse = false;
+        };
+        typedef std::unordered_map < ObjectGuid /*master*/, LinkedSlaves > MasterSlavesMap;
+        typedef std::unordered_map < ObjectGuid /*slave*/, GuidVector /*masters in range*/ > SlaveMastersMap;
+
+        // Helper function, to link a master and a slave of the entry case if the slave belongs to it
+        void LinkSlaveToMaster(Creature* pMaster, Creature* pSlave, uint16 linkingFlag, uint16 searchRange);
+        // Helper function, to find the master of a slave in the entry case
+        Creature* GetLinkedMaster(Creature* pSlave) const;
+        // Helper function, to process the resolved slaves of a master
+        void ProcessLinkedSlaves(CreatureLinkingEvent eventType, Creature* pSource, uint32 eventFlagFilter, LinkedSlaves& linkedSlaves, Unit* pEnemy);
         // Helper function, to process a slave list
         void ProcessSlaveGuidList(CreatureLinkingEvent eventType, Creature* pSource, uint32 flag, uint16 searchRange, GuidList& slaveGuidList, Unit* pEnemy);
         // Helper function, to process a single slave
@@ -204,6 +224,9 @@ class CreatureLinkingHolder
         HolderMap m_holderGuidMap;
         // boss_entry, guid for reverse action triggering and check alive
         BossGuidMap m_masterGuid;
+        // master guid -> slave guids and back, linked when the creatures are created so the events need no search
+        MasterSlavesMap m_masterSlaves;
+        SlaveMastersMap m_slaveMasters;
 };
 
 #define sCreatureLinkingMgr MaNGOS::Singleton<CreatureLinkingMgr>::Instance()
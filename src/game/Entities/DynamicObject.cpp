@@ -42,6 +42,7 @@ void DynamicObject::AddToWorld()
         GetMap()->GetObjectsStore().insert<DynamicObject>(GetObjectGuid(), (DynamicObject*)this);
 
     WorldObject::AddToWorld();
+    UpdateTriggerVolume();
 }
 
 void DynamicObject::RemoveFromWorld()
@@ -50,6 +51,7 @@ void DynamicObject::RemoveFromWorld()
     if (IsInWorld())
     {
         GetMap()->GetObjectsStore().erase<DynamicObject>(GetObjectGuid(), (DynamicObject*)nullptr);
+        GetMap()->GetTriggerVolumes().Unregister(m_triggerVolume);
         GetViewPoint().Event_RemovedFromWorld();
     }
 
@@ -132,10 +134,9 @@ void DynamicObject::Update(const uint32 diff)
     else
         deleteThis = true;
 
-    // have radius and work as persistent effect
-    if (m_radius)
+    // have radius and work as persistent effect, searched again once a unit moved into it
+    if (m_radius && GetMap()->GetTriggerVolumes().ConsumeTriggered(m_triggerVolume))
     {
-        // TODO: make a timer and update this in larger intervals
         MaNGOS::DynamicObjectUpdater notifier(*this, caster, m_positive);
         Cell::VisitAllObjects(this, notifier, m_radius);
     }
@@ -154,6 +155,12 @@ void DynamicObject::Delete()
     AddObjectToRemoveList();
 }
 
+void DynamicObject::UpdateTriggerVolume()
+{
+    if (m_radius && IsInWorld())
+        GetMap()->GetTriggerVolumes().Register(m_triggerVolume, GetPositionX(), GetPositionY(), m_radius);
+}
+
 void DynamicObject::Delay(int32 delaytime)
 {
     m_aliveDuration -= delaytime;
@@ -23,6 +23,7 @@
 #include "Server/DBCEnums.h"
 #include "Spells/SpellTargetDefines.h"
 #include "Entities/Unit.h"
+#include "Maps/TriggerVolumeIndex.h"
 
 enum DynamicObjectType
 {
@@ -61,6 +62,9 @@ class DynamicObject : public WorldObject
         void RemoveAffected(Unit* unit) { m_affected.erase(unit->GetObjectGuid()); }
         void Delay(int32 delaytime);
 
+        // (re)registers the persistent effect at the current position
+        void UpdateTriggerVolume();
+
         ReputationRank GetReactionTo(Unit const* unit) const override;
 
         bool IsEnemy(Unit const* unit) const override;
@@ -89,6 +93,7 @@ class DynamicObject : public WorldObject
         SpellTarget m_target;
         int32 m_damage;
         int32 m_basePoints;
+        TriggerVolumeIndex::Volume m_triggerVolume;
     private:
         GridReference<DynamicObject> m_gridRef;
 };
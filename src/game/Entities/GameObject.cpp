@@ -146,6 +146,37 @@ void GameObject::AddToWorld()
     // Make active if required
     if (GetGOInfo()->ExtraFlags & GAMEOBJECT_EXTRA_FLAG_ACTIVE)
         SetActiveObjectState(true);
+
+    UpdateTriggerVolume();
+}
+
+float GameObject::GetTrapRadius() const
+{
+    GameObjectInfo const* goInfo = GetGOInfo();
+
+    // FIXME: this is activation radius (in different casting radius that must be selected from spell data)
+    float radius = float(goInfo->trap.diameter) / 2.0f;
+
+    // behavior verified on classic
+    // TODO: needs more research
+    if (goInfo->GetLockId() == 12) // 21 objects currently (hunter traps), all with 5 or less for diameter -> use diameter as radius instead
+        radius = float(goInfo->trap.diameter);
+
+    // battlegrounds gameobjects has data2 == 0 && data5 == 3, cast in other case (at some triggering/linked go/etc explicit call)
+    if (!radius && goInfo->trap.cooldown == 3)
+        radius = float(goInfo->trap.cooldown);
+
+    return radius;
+}
+
+void GameObject::UpdateTriggerVolume()
+{
+    if (GetGoType() != GAMEOBJECT_TYPE_TRAP || !IsInWorld())
+        return;
+
+    float radius = GetTrapRadius();
+    if (radius)
+        GetMap()->GetTriggerVolumes().Register(m_triggerVolume, GetPositionX(), GetPositionY(), radius);
 }
 
 void GameObject::RemoveFromWorld()
@@ -173,6 +204,7 @@ void GameObject::RemoveFromWorld()
             GetMap()->RemoveGameObjectModel(*m_model);
 
         GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
+        GetMap()->GetTriggerVolumes().Unregister(m_triggerVolume);
     }
 
     WorldObject::RemoveFromWorld();
@@ -424,70 +456,58 @@ void GameObject::Update(const uint32 diff)
                 {
                     if (m_cooldownTime < time(nullptr))
                     {
-                        // FIXME: this is activation radius (in different casting radius that must be selected from spell data)
                         // TODO: move activated state code (cast itself) to GO_ACTIVATED, in this place only check activating and set state
-                        float radius = float(goInfo->trap.diameter) / 2.0f;
+                        float radius = GetTrapRadius();
 
-                        // behavior verified on classic
-                        // TODO: needs more research
-                        if (goInfo->GetLockId() == 12) // 21 objects currently (hunter traps), all with 5 or less for diameter -> use diameter as radius instead
-                            radius = float(goInfo->trap.diameter);
-
-                        bool valid = true;
-                        if (!radius)
-                        {
-                            if (goInfo->trap.cooldown != 3)     // cast in other case (at some triggering/linked go/etc explicit call)
-                                valid = false;
-                            else
-                            {
-                                if (m_respawnTime > 0)
-                                    valid = false;
-                                else // battlegrounds gameobjects has data2 == 0 && data5 == 3
-                                    radius = float(goInfo->trap.cooldown);
-                            }
-                        }
+                        bool valid = radius != 0.0f;
+                        if (valid && !goInfo->trap.diameter && m_respawnTime > 0)
+                            valid = false;
 
                         if (valid)
                         {
-                            // Should trap trigger?
-                            Unit* target = nullptr;                     // pointer to appropriate target if found any
-
-                            if (std::function<bool(Unit*)>* functor = sScriptDevAIMgr.OnTrapSearch(this))
+                            // nothing to search for until a unit moved into the radius
+                            if (GetMap()->GetTriggerVolumes().ConsumeTriggered(m_triggerVolume))
                             {
-                                MaNGOS::AnyUnitFulfillingConditionInRangeCheck u_check(this, *functor, radius);
-                                MaNGOS::UnitSearcher<MaNGOS::AnyUnitFulfillingConditionInRangeCheck> checker(target, u_check);
-                                Cell::VisitAllObjects(this, checker, radius);
-                            }
-                            else
-                            {
-                                switch (goInfo->trapCustom.triggerOn)
+                                // Should trap trigger?
+                                Unit* target = nullptr;                     // pointer to appropriate target if found any
+
+                                if (std::function<bool(Unit*)>* functor = sScriptDevAIMgr.OnTrapSearch(this))
                                 {
-                                    case 1: // friendly
-                                    {
-                                        MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(this, nullptr, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
-                                        break;
-                                    }
-                                    case 2: // all
-                                    {
-                                        MaNGOS::AnyUnitInObjectRangeCheck u_check(this, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
-                                        break;
-                                    }
-                                    default: // unfriendly
+                                    MaNGOS::AnyUnitFulfillingConditionInRangeCheck u_check(this, *functor, radius);
+                                    MaNGOS::UnitSearcher<MaNGOS::AnyUnitFulfillingConditionInRangeCheck> checker(target, u_check);
+                                    Cell::VisitAllObjects(this, checker, radius);
+                                }
+                                else
+                                {
+                                    switch (goInfo->trapCustom.triggerOn)
                                     {
-                                        MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, radius);
-                                        MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> checker(target, u_check);
-                                        Cell::VisitAllObjects(this, checker, radius);
-                                        break;
+                                        case 1: // friendly
+                                        {
+                                            MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(this, nullptr, radius);
+                                            MaNGOS::UnitSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> checker(target, u_check);
+                                            Cell::VisitAllObjects(this, checker, radius);
+                                            break;
+                                        }
+                                        case 2: // all
+                                        {
+                                            MaNGOS::AnyUnitInObjectRangeCheck u_check(this, radius);
+                                            MaNGOS::UnitSearcher<MaNGOS::AnyUnitInObjectRangeCheck> checker(target, u_check);
+                                            Cell::VisitAllObjects(this, checker, radius);
+                                            break;
+                                        }
+                                        default: // unfriendly
+                                        {
+                                            MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, radius);
+                                            MaNGOS::UnitSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> checker(target, u_check);
+                                            Cell::VisitAllObjects(this, checker, radius);
+                                            break;
+                                        }
                                     }
                                 }
-                            }
 
-                            if (target && (!goInfo->trapCustom.triggerOn || !target->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE))) // do not trigger on hostile traps if not selectable
-                                Use(target);
+                                if (target && (!goInfo->trapCustom.triggerOn || !target->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NOT_SELECTABLE))) // do not trigger on hostile traps if not selectable
+                                    Use(target);
+                            }
                         }
                         else
                         {
@@ -856,6 +876,10 @@ bool GameObject::LoadFromDB(uint32 dbGuid, Map* map, uint32 newGuid, GenericTran
     uint8 animprogress = data->animprogress;
     GOState go_state = data->go_state;
 
+    // a hibernated dungeon resumes with its doors and buttons as they were left
+    if (map->IsDungeon())
+        ((DungeonMap*)map)->GetPersistanceState()->TakeHibernatedGoState(dbGuid, go_state);
+
     m_dbGuid = dbGuid;
 
     if (!Create(newGuid, entry, map, phaseMask, x, y, z, ang, data->rotation, animprogress, go_state))
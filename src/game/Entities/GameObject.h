@@ -23,10 +23,12 @@
 #include "Globals/SharedDefines.h"
 #include "Entities/Object.h"
 #include "Util.h"
+#include "Utilities/SlabAllocator.h"
 #include "AI/BaseAI/GameObjectAI.h"
 #include "Spells/SpellAuras.h"
 #include "Spells/SpellDefines.h"
 #include "Entities/GameObjectDefines.h"
+#include "Maps/TriggerVolumeIndex.h"
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
@@ -710,6 +712,10 @@ class GameObject : public WorldObject
         explicit GameObject();
         ~GameObject();
 
+        // gameobjects come and go with their grid, keep them out of the general heap
+        static void* operator new(size_t size) { return SlabAllocator::Allocate(size, MEMORY_TAG_GRIDS); }
+        static void operator delete(void* ptr, size_t size) { SlabAllocator::Deallocate(ptr, size, MEMORY_TAG_GRIDS); }
+
         static GameObject* CreateGameObject(uint32 entry);
 
         void AddToWorld() override;
@@ -725,6 +731,7 @@ class GameObject : public WorldObject
         bool IsDynTransport() const;
 
         bool HasStaticDBSpawnData() const;                  // listed in `gameobject` table and have fixed in DB guid
+        uint32 GetDbGuid() const { return m_dbGuid; }
 
         // z_rot, y_rot, x_rot - rotation angles around z, y and x axes
         void SetLocalRotationAngles(float z_rot, float y_rot, float x_rot);
@@ -803,6 +810,11 @@ class GameObject : public WorldObject
 
         void Use(Unit* user, SpellEntry const* spellInfo = nullptr);
 
+        // activation radius of a trap, 0 if it is only triggered explicitly
+        float GetTrapRadius() const;
+        // (re)registers a trap with activation radius at the current position
+        void UpdateTriggerVolume();
+
         LootState GetLootState() const { return m_lootState; }
         void SetLootState(LootState state);
 
@@ -921,6 +933,7 @@ class GameObject : public WorldObject
         bool        m_spawnedByDefault;
         time_t      m_cooldownTime;                         // used as internal reaction delay time store (not state change reaction).
         // For traps/goober this: spell casting cooldown, for doors/buttons: reset time.
+        TriggerVolumeIndex::Volume m_triggerVolume;         // of traps with activation radius
 
         uint32      m_captureTimer;                         // (msecs) timer used for capture points
         float       m_captureSlider;                        // capture point slider value in range of [0..100]
@@ -49,6 +49,23 @@ void GossipMenu::AddMenuItem(uint8 Icon, const std::string& Message, uint32 dtSe
     gItem.m_gOptionId   = dtAction;
     gItem.m_gBoxMessage = BoxMessage;
     gItem.m_gBoxMoney   = BoxMoney;
+    gItem.m_gSerialized = nullptr;
+
+    m_gItems.push_back(gItem);
+}
+
+void GossipMenu::AddMenuItem(ByteBuffer const& serialized, uint32 dtAction, uint32 BoxMoney, bool Coded)
+{
+    MANGOS_ASSERT(m_gItems.size() <= GOSSIP_MAX_MENU_ITEMS);
+
+    GossipMenuItem gItem;
+
+    gItem.m_gIcon       = 0;
+    gItem.m_gCoded      = Coded;
+    gItem.m_gSender     = 0;
+    gItem.m_gOptionId   = dtAction;
+    gItem.m_gBoxMoney   = BoxMoney;
+    gItem.m_gSerialized = &serialized;
 
     m_gItems.push_back(gItem);
 }
@@ -163,6 +180,12 @@ void PlayerMenu::SendGossipMenu(uint32 TitleTextId, ObjectGuid objectGuid)
     {
         GossipMenuItem const& gItem = mGossipMenu.GetItem(iI);
         data << uint32(iI);
+        if (gItem.m_gSerialized)
+        {
+            data.append(*gItem.m_gSerialized);
+            continue;
+        }
+
         data << uint8(gItem.m_gIcon);
         data << uint8(gItem.m_gCoded);                      // makes pop up box password
         data << uint32(gItem.m_gBoxMoney);                  // money required to open menu, 2.0.3
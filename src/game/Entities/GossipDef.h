@@ -142,6 +142,7 @@ struct GossipMenuItem
     uint32      m_gOptionId;
     std::string m_gBoxMessage;
     uint32      m_gBoxMoney;
+    ByteBuffer const* m_gSerialized;                        // precompiled icon, coded, money and texts, replaces the fields above in the packet
 };
 
 typedef std::vector<GossipMenuItem> GossipMenuItemList;
@@ -178,6 +179,9 @@ class GossipMenu
 
         void AddMenuItem(uint8 Icon, int32 itemText, uint32 dtSender, uint32 dtAction, int32 boxText, uint32 BoxMoney, bool Coded = false);
 
+        // for the precompiled gossip_menu_option of ObjectMgr, valid until the gossip menus are reloaded
+        void AddMenuItem(ByteBuffer const& serialized, uint32 dtAction, uint32 BoxMoney, bool Coded);
+
         void SetMenuId(uint32 menu_id) { m_gMenuId = menu_id; }
         uint32 GetMenuId() const { return m_gMenuId; }
 
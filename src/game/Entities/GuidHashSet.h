@@ -0,0 +1,193 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GUIDHASHSET_H
+#define MANGOS_GUIDHASHSET_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <iterator>
+
+/**
+ * Set of guids in one flat array with open addressing (linear probing), for the sets that are
+ * queried far more often than changed, like the objects a client knows about.
+ *
+ * The empty guid can not be stored. Erased guids leave a marker behind, so erasing never moves
+ * other guids and iterators stay valid while erasing; inserting may rehash and invalidates them.
+ * The iteration order is unspecified.
+ */
+class GuidHashSet
+{
+    private:
+        static constexpr uint64 EMPTY_SLOT  = 0;
+        static constexpr uint64 ERASED_SLOT = uint64(0xFFFFFFFFFFFFFFFF);
+        static constexpr size_t MIN_CAPACITY = 16;
+
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef ObjectGuid value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef ObjectGuid const* pointer;
+                typedef ObjectGuid const& reference;
+
+                const_iterator() : m_set(nullptr), m_slot(0) {}
+
+                ObjectGuid const& operator*() const { return m_set->m_slots[m_slot]; }
+                ObjectGuid const* operator->() const { return &m_set->m_slots[m_slot]; }
+                const_iterator& operator++() { m_slot = m_set->NextUsedSlot(m_slot + 1); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+                bool operator==(const_iterator const& other) const { return m_slot == other.m_slot; }
+                bool operator!=(const_iterator const& other) const { return m_slot != other.m_slot; }
+
+            private:
+                friend class GuidHashSet;
+                const_iterator(GuidHashSet const* set, size_t slot) : m_set(set), m_slot(slot) {}
+
+                GuidHashSet const* m_set;
+                size_t m_slot;
+        };
+        typedef const_iterator iterator;
+
+        GuidHashSet() : m_size(0), m_used(0) {}
+
+        const_iterator begin() const { return const_iterator(this, NextUsedSlot(0)); }
+        const_iterator end() const { return const_iterator(this, m_slots.size()); }
+
+        bool empty() const { return m_size == 0; }
+        size_t size() const { return m_size; }
+
+        const_iterator find(ObjectGuid guid) const
+        {
+            if (m_slots.empty() || guid.IsEmpty())
+                return end();
+
+            uint64 const raw = guid.GetRawValue();
+            size_t const mask = m_slots.size() - 1;
+            for (size_t slot = Hash(raw) & mask;; slot = (slot + 1) & mask)
+            {
+                if (m_slots[slot].GetRawValue() == raw)
+                    return const_iterator(this, slot);
+                if (m_slots[slot].GetRawValue() == EMPTY_SLOT)
+                    return end();
+            }
+        }
+
+        size_t count(ObjectGuid guid) const { return find(guid) != end() ? 1 : 0; }
+
+        // returns true if the guid was not in the set yet
+        bool insert(ObjectGuid guid)
+        {
+            MANGOS_ASSERT(!guid.IsEmpty());
+
+            if ((m_used + 1) * 4 > m_slots.size() * 3)
+                Rehash(std::max((m_size + 1) * 2, MIN_CAPACITY));
+
+            uint64 const raw = guid.GetRawValue();
+            size_t const mask = m_slots.size() - 1;
+            size_t erasedSlot = m_slots.size();
+            for (size_t slot = Hash(raw) & mask;; slot = (slot + 1) & mask)
+            {
+                if (m_slots[slot].GetRawValue() == raw)
+                    return false;
+
+                if (m_slots[slot].GetRawValue() == ERASED_SLOT)
+                {
+                    if (erasedSlot == m_slots.size())
+                        erasedSlot = slot;
+                    continue;
+                }
+
+                if (m_slots[slot].GetRawValue() == EMPTY_SLOT)
+                {
+                    // reuse the first erased slot of the probe sequence
+                    if (erasedSlot != m_slots.size())
+                        slot = erasedSlot;
+                    else
+                        ++m_used;
+
+                    m_slots[slot] = guid;
+                    ++m_size;
+                    return true;
+                }
+            }
+        }
+
+        size_t erase(ObjectGuid guid)
+        {
+            const_iterator itr = find(guid);
+            if (itr == end())
+                return 0;
+
+            erase(itr);
+            return 1;
+        }
+
+        const_iterator erase(const_iterator itr)
+        {
+            m_slots[itr.m_slot] = ObjectGuid(ERASED_SLOT);
+            --m_size;
+            return ++itr;
+        }
+
+        void clear()
+        {
+            std::fill(m_slots.begin(), m_slots.end(), ObjectGuid());
+            m_size = 0;
+            m_used = 0;
+        }
+
+    private:
+        static size_t Hash(uint64 raw)
+        {
+            // the low guids of one type are mostly consecutive, spread them over the whole table
+            return size_t((raw * uint64(0x9E3779B97F4A7C15)) >> 32);
+        }
+
+        size_t NextUsedSlot(size_t slot) const
+        {
+            while (slot < m_slots.size() && (m_slots[slot].GetRawValue() == EMPTY_SLOT || m_slots[slot].GetRawValue() == ERASED_SLOT))
+                ++slot;
+            return slot;
+        }
+
+        void Rehash(size_t minCapacity)
+        {
+            size_t capacity = MIN_CAPACITY;
+            while (capacity < minCapacity)
+                capacity *= 2;
+
+            std::vector<ObjectGuid> slots(capacity);
+            m_slots.swap(slots);
+            m_size = 0;
+            m_used = 0;
+
+            for (ObjectGuid const& guid : slots)
+                if (guid.GetRawValue() != EMPTY_SLOT && guid.GetRawValue() != ERASED_SLOT)
+                    insert(guid);
+        }
+
+        std::vector<ObjectGuid> m_slots;
+        size_t m_size;                                      // guids in the set
+        size_t m_used;                                      // slots not empty, including the erased ones
+};
+
+#endif
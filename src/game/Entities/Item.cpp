@@ -296,6 +296,11 @@ void Item::UpdateDuration(Player* owner, uint32 diff)
 }
 
 void Item::SaveToDB()
+{
+    DoSaveToDB(nullptr);
+}
+
+void Item::DoSaveToDB(ItemSaveBatch* batch)
 {
     static const char* UPDATE_ITEM = "UPDATE item_instance SET owner_guid = ?, itemEntry = ?, creatorGuid = ?, giftCreatorGuid = ?, count = ?, duration = ?, charges = ?, flags = ?, enchantments = ?, randomPropertyId = ?, durability = ?, playedTime = ?, text = ? WHERE guid = ?";
     static const char* INSERT_ITEM = "REPLACE INTO item_instance (owner_guid, itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, guid) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
@@ -311,60 +316,65 @@ void Item::SaveToDB()
         case ITEM_NEW:
         case ITEM_CHANGED:
         {
-            static SqlStatementID insItem, updItem;
-            std::unique_ptr<SqlStatement> stmt;
-
-            //get thread id
-            //std::hash<std::thread::id> myHashObject{};
-            //uint32 threadID = myHashObject(std::this_thread::get_id());
-
-            if (uState == ITEM_NEW)
-            {
-                stmt.reset(new SqlStatement(CharacterDatabase.CreateStatement(insItem, INSERT_ITEM)));
-                //printf("> Saving new item(%s) for guid[%u]. Thread is [%u]\n", GetProto()->Name1, GetOwnerGuid().GetCounter(), threadID);
-            }
+            if (batch)
+                batch->AddItem(this);
             else
             {
-                stmt.reset(new SqlStatement(CharacterDatabase.CreateStatement(updItem, UPDATE_ITEM)));
-                //printf("> Updating item(%s) for guid[%u]. Thread is [%u]\n", GetProto()->Name1, GetOwnerGuid().GetCounter(), threadID);
-            }
+                static SqlStatementID insItem, updItem;
+                std::unique_ptr<SqlStatement> stmt;
 
-            stmt->addUInt32(GetOwnerGuid().GetCounter());
-            stmt->addUInt32(GetEntry());
-            stmt->addUInt32(GetGuidValue(ITEM_FIELD_CREATOR).GetCounter());
-            stmt->addUInt32(GetGuidValue(ITEM_FIELD_GIFTCREATOR).GetCounter());
-            stmt->addUInt32(GetCount());
-            stmt->addUInt32(GetUInt32Value(ITEM_FIELD_DURATION));
+                //get thread id
+                //std::hash<std::thread::id> myHashObject{};
+                //uint32 threadID = myHashObject(std::this_thread::get_id());
 
-            std::ostringstream ssSpells;
-            for (uint8 i = 0; i < MAX_ITEM_PROTO_SPELLS; ++i)
-                ssSpells << GetSpellCharges(i) << ' ';
-            stmt->addString(ssSpells.str());
+                if (uState == ITEM_NEW)
+                {
+                    stmt.reset(new SqlStatement(CharacterDatabase.CreateStatement(insItem, INSERT_ITEM)));
+                    //printf("> Saving new item(%s) for guid[%u]. Thread is [%u]\n", GetProto()->Name1, GetOwnerGuid().GetCounter(), threadID);
+                }
+                else
+                {
+                    stmt.reset(new SqlStatement(CharacterDatabase.CreateStatement(updItem, UPDATE_ITEM)));
+                    //printf("> Updating item(%s) for guid[%u]. Thread is [%u]\n", GetProto()->Name1, GetOwnerGuid().GetCounter(), threadID);
+                }
 
-            stmt->addUInt32(GetUInt32Value(ITEM_FIELD_FLAGS));
+                stmt->addUInt32(GetOwnerGuid().GetCounter());
+                stmt->addUInt32(GetEntry());
+                stmt->addUInt32(GetGuidValue(ITEM_FIELD_CREATOR).GetCounter());
+                stmt->addUInt32(GetGuidValue(ITEM_FIELD_GIFTCREATOR).GetCounter());
+                stmt->addUInt32(GetCount());
+                stmt->addUInt32(GetUInt32Value(ITEM_FIELD_DURATION));
 
-            std::ostringstream ssEnchants;
-            for (uint8 i = 0; i < MAX_ENCHANTMENT_SLOT; ++i)
-            {
-                ssEnchants << GetEnchantmentId(EnchantmentSlot(i)) << ' ';
-                ssEnchants << GetEnchantmentDuration(EnchantmentSlot(i)) << ' ';
-                ssEnchants << GetEnchantmentCharges(EnchantmentSlot(i)) << ' ';
-            }
-            stmt->addString(ssEnchants.str());
+                std::ostringstream ssSpells;
+                for (uint8 i = 0; i < MAX_ITEM_PROTO_SPELLS; ++i)
+                    ssSpells << GetSpellCharges(i) << ' ';
+                stmt->addString(ssSpells.str());
 
-            stmt->addInt16(GetItemRandomPropertyId());
-            stmt->addUInt16(GetUInt32Value(ITEM_FIELD_DURABILITY));
-            stmt->addUInt32(GetUInt32Value(ITEM_FIELD_CREATE_PLAYED_TIME));
-            stmt->addString(GetText());
-            stmt->addUInt32(guid);
+                stmt->addUInt32(GetUInt32Value(ITEM_FIELD_FLAGS));
 
-            stmt->Execute();
+                std::ostringstream ssEnchants;
+                for (uint8 i = 0; i < MAX_ENCHANTMENT_SLOT; ++i)
+                {
+                    ssEnchants << GetEnchantmentId(EnchantmentSlot(i)) << ' ';
+                    ssEnchants << GetEnchantmentDuration(EnchantmentSlot(i)) << ' ';
+                    ssEnchants << GetEnchantmentCharges(EnchantmentSlot(i)) << ' ';
+                }
+                stmt->addString(ssEnchants.str());
+
+                stmt->addInt16(GetItemRandomPropertyId());
+                stmt->addUInt16(GetUInt32Value(ITEM_FIELD_DURABILITY));
+                stmt->addUInt32(GetUInt32Value(ITEM_FIELD_CREATE_PLAYED_TIME));
+                stmt->addString(GetText());
+                stmt->addUInt32(guid);
+
+                stmt->Execute();
+            }
 
             if (uState == ITEM_CHANGED && HasFlag(ITEM_FIELD_FLAGS, ITEM_DYNFLAG_WRAPPED))
             {
                 static SqlStatementID updGifts;
-                stmt.reset(new SqlStatement(CharacterDatabase.CreateStatement(updGifts, UPDATE_GIFT)));
-                stmt->PExecute(GetOwnerGuid().GetCounter(), GetGUIDLow());
+                SqlStatement stmt = CharacterDatabase.CreateStatement(updGifts, UPDATE_GIFT);
+                stmt.PExecute(GetOwnerGuid().GetCounter(), GetGUIDLow());
             }
 
             break;
@@ -376,7 +386,10 @@ void Item::SaveToDB()
             static SqlStatementID delLoot;
 
             SqlStatement stmt = CharacterDatabase.CreateStatement(delInst, DELETE_ITEM);
-            stmt.PExecute(guid);
+            if (batch)
+                batch->RemoveItem(guid);
+            else
+                stmt.PExecute(guid);
 
             if (HasFlag(ITEM_FIELD_FLAGS, ITEM_DYNFLAG_WRAPPED))
             {
@@ -445,6 +458,96 @@ void Item::SaveToDB()
     SetState(ITEM_UNCHANGED);
 }
 
+void ItemSaveBatch::AddItem(Item const* item)
+{
+    std::string text = item->GetText();
+    CharacterDatabase.escape_string(text);
+
+    std::ostringstream ss;
+    ss << "(" << item->GetOwnerGuid().GetCounter() << "," << item->GetEntry() << ","
+       << item->GetGuidValue(ITEM_FIELD_CREATOR).GetCounter() << "," << item->GetGuidValue(ITEM_FIELD_GIFTCREATOR).GetCounter() << ","
+       << item->GetCount() << "," << item->GetUInt32Value(ITEM_FIELD_DURATION) << ",'";
+    for (uint8 i = 0; i < MAX_ITEM_PROTO_SPELLS; ++i)
+        ss << item->GetSpellCharges(i) << ' ';
+    ss << "'," << item->GetUInt32Value(ITEM_FIELD_FLAGS) << ",'";
+    for (uint8 i = 0; i < MAX_ENCHANTMENT_SLOT; ++i)
+    {
+        ss << item->GetEnchantmentId(EnchantmentSlot(i)) << ' ';
+        ss << item->GetEnchantmentDuration(EnchantmentSlot(i)) << ' ';
+        ss << item->GetEnchantmentCharges(EnchantmentSlot(i)) << ' ';
+    }
+    ss << "'," << int16(item->GetItemRandomPropertyId()) << "," << uint16(item->GetUInt32Value(ITEM_FIELD_DURABILITY)) << ","
+       << item->GetUInt32Value(ITEM_FIELD_CREATE_PLAYED_TIME) << ",'" << text << "'," << item->GetGUIDLow() << ")";
+
+    m_itemRows.push_back(ss.str());
+    ++m_itemCount;
+}
+
+void ItemSaveBatch::RemoveItem(uint32 itemGuid)
+{
+    m_removedItems.push_back(itemGuid);
+    ++m_itemCount;
+}
+
+void ItemSaveBatch::AddInventory(uint32 ownerGuid, uint32 bagGuid, uint8 slot, Item const* item)
+{
+    std::ostringstream ss;
+    ss << "(" << ownerGuid << "," << bagGuid << "," << uint32(slot) << "," << item->GetGUIDLow() << "," << item->GetEntry() << ")";
+    m_inventoryRows.push_back(ss.str());
+}
+
+void ItemSaveBatch::RemoveInventory(uint32 itemGuid)
+{
+    m_removedInventory.push_back(itemGuid);
+}
+
+void ItemSaveBatch::Flush()
+{
+    // rows per statement, the item rows are a few hundred bytes each
+    uint32 const deleteRows = 256;
+    uint32 const insertRows = 100;
+
+    auto deleteGuids = [deleteRows](char const* query, std::vector<uint32> const& guids)
+    {
+        for (size_t i = 0; i < guids.size(); i += deleteRows)
+        {
+            std::ostringstream ss;
+            ss << query << " IN (" << guids[i];
+            for (size_t j = i + 1; j < guids.size() && j < i + deleteRows; ++j)
+                ss << "," << guids[j];
+            ss << ")";
+            CharacterDatabase.Execute(ss.str().c_str());
+        }
+    };
+
+    auto insertRowList = [insertRows](char const* query, std::vector<std::string> const& rows)
+    {
+        for (size_t i = 0; i < rows.size(); i += insertRows)
+        {
+            std::string sql = query;
+            sql += rows[i];
+            for (size_t j = i + 1; j < rows.size() && j < i + insertRows; ++j)
+            {
+                sql += ",";
+                sql += rows[j];
+            }
+            CharacterDatabase.Execute(sql.c_str());
+        }
+    };
+
+    deleteGuids("DELETE FROM character_inventory WHERE item", m_removedInventory);
+    deleteGuids("DELETE FROM item_instance WHERE guid", m_removedItems);
+
+    // new and changed rows alike, replacing keeps a changed row and inserts a new one
+    insertRowList("REPLACE INTO character_inventory (guid,bag,slot,item,item_template) VALUES ", m_inventoryRows);
+    insertRowList("REPLACE INTO item_instance (owner_guid, itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, guid) VALUES ", m_itemRows);
+
+    m_itemRows.clear();
+    m_removedItems.clear();
+    m_inventoryRows.clear();
+    m_removedInventory.clear();
+}
+
 bool Item::LoadFromDB(uint32 guidLow, Field* fields, ObjectGuid ownerGuid)
 {
     // 0          1            2                3      4         5        6      7             8                 9           10          11
@@ -581,7 +684,9 @@ void Item::LoadLootFromDB(Field* fields)
 
     if (!proto)
     {
-        CharacterDatabase.PExecute("DELETE FROM item_loot WHERE guid = '%u' AND itemid = '%u'", GetGUIDLow(), item_id);
+        static SqlStatementID delLootItem;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delLootItem, "DELETE FROM item_loot WHERE guid = ? AND itemid = ?");
+        stmt.PExecute(GetGUIDLow(), item_id);
         sLog.outError("Item::LoadLootFromDB: %s has an unknown item (id: #%u) in item_loot, deleted.", GetOwnerGuid().GetString().c_str(), item_id);
         return;
     }
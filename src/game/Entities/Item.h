@@ -25,6 +25,7 @@
 
 struct SpellEntry;
 class Bag;
+class Item;
 class Field;
 class QueryResult;
 class Unit;
@@ -269,6 +270,33 @@ struct ItemRequiredTarget
 
 bool ItemCanGoIntoBag(ItemPrototype const* pProto, ItemPrototype const* pBagProto);
 
+/**
+ * The item_instance and character_inventory rows of one character save, written as a few
+ * multi-row statements instead of one statement per item. Flush has to run in the transaction
+ * of the save; the deletes go first, so a row removed and written again ends up written.
+ */
+class ItemSaveBatch
+{
+    public:
+        ItemSaveBatch() : m_itemCount(0) {}
+
+        void AddItem(Item const* item);                     // new or changed item_instance row
+        void RemoveItem(uint32 itemGuid);
+        void AddInventory(uint32 ownerGuid, uint32 bagGuid, uint8 slot, Item const* item);
+        void RemoveInventory(uint32 itemGuid);
+
+        void Flush();
+
+        uint32 GetItemCount() const { return m_itemCount; } // items added or removed
+
+    private:
+        std::vector<std::string> m_itemRows;
+        std::vector<uint32> m_removedItems;
+        std::vector<std::string> m_inventoryRows;
+        std::vector<uint32> m_removedInventory;
+        uint32 m_itemCount;
+};
+
 class Item : public Object
 {
     public:
@@ -291,6 +319,8 @@ class Item : public Object
         bool IsBindedNotWith(Player const* player) const;
         bool IsBoundByEnchant() const;
         virtual void SaveToDB();
+        // same as SaveToDB, only the item_instance row is written or deleted by the batch
+        void SaveToDB(ItemSaveBatch& batch) { DoSaveToDB(&batch); }
         virtual bool LoadFromDB(uint32 guidLow, Field* fields, ObjectGuid ownerGuid = ObjectGuid());
         virtual void DeleteFromDB();
         void DeleteFromInventoryDB() const;
@@ -385,6 +415,8 @@ class Item : public Object
         bool IsUsedInSpell() const { return m_usedInSpell; }
         void SetUsedInSpell(bool state) { m_usedInSpell = state; }
     private:
+        void DoSaveToDB(ItemSaveBatch* batch);
+
         std::string m_text;
         uint8 m_slot;
         Bag* m_container;
@@ -39,10 +39,94 @@ struct EnchStoreItem
 };
 
 typedef std::vector<EnchStoreItem> EnchStoreList;
-typedef std::unordered_map<uint32, EnchStoreList> EnchantmentStore;
+
+// Walker alias table of the enchantments of one entry: a roll picks a column and then
+// either its own enchantment or its alias, with a single random number
+struct EnchAliasTable
+{
+    std::vector<uint32> enchs;
+    std::vector<uint32> thresholds;                         // chance of the column's own enchantment, scaled to 2^32
+    std::vector<uint32> aliases;                            // column of the enchantment picked above the threshold
+
+    void Build(EnchStoreList const& list);
+    uint32 Roll() const;
+};
+
+typedef std::unordered_map<uint32, EnchAliasTable> EnchantmentStore;
 
 static EnchantmentStore RandomItemEnch;
 
+void EnchAliasTable::Build(EnchStoreList const& list)
+{
+    // chances past 100% in table order can never be rolled, a total below 100% is scaled up to it
+    std::vector<double> weights;
+    double total = 0.0;
+    for (EnchStoreItem const& item : list)
+    {
+        double weight = std::min(double(item.chance), 100.0 - total);
+        if (weight <= 0.0)
+            break;
+
+        enchs.push_back(item.ench);
+        weights.push_back(weight);
+        total += weight;
+    }
+
+    uint32 const count = uint32(enchs.size());
+    thresholds.assign(count, 0);
+    aliases.assign(count, 0);
+
+    std::vector<double> scaled(count);
+    std::vector<uint32> small, large;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        scaled[i] = weights[i] * count / total;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        small.pop_back();
+        uint32 more = large.back();
+
+        thresholds[less] = uint32(scaled[less] * 4294967296.0);
+        aliases[less] = more;
+
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    // full columns, also the ones left by rounding errors, always keep their own enchantment
+    for (uint32 i : large)
+    {
+        thresholds[i] = uint32(-1);
+        aliases[i] = i;
+    }
+    for (uint32 i : small)
+    {
+        thresholds[i] = uint32(-1);
+        aliases[i] = i;
+    }
+}
+
+uint32 EnchAliasTable::Roll() const
+{
+    if (enchs.empty())
+        return 0;
+
+    // the high part of the scaled number is the column, the low part is uniform within it
+    uint64 scaled = uint64(uint32((*GetRandomGenerator())())) * enchs.size();
+    uint32 column = uint32(scaled >> 32);
+    uint32 fraction = uint32(scaled);
+
+    return enchs[fraction < thresholds[column] ? column : aliases[column]];
+}
+
 void LoadRandomEnchantmentsTable()
 {
     RandomItemEnch.clear();                                 // for reload case
@@ -52,6 +136,8 @@ void LoadRandomEnchantmentsTable()
 
     if (result)
     {
+        std::unordered_map<uint32, EnchStoreList> enchantLists;
+
         BarGoLink bar(result->GetRowCount());
 
         do
@@ -64,7 +150,7 @@ void LoadRandomEnchantmentsTable()
             float chance = fields[2].GetFloat();
 
             if (chance > 0.000001f && chance <= 100.0f)
-                RandomItemEnch[entry].push_back(EnchStoreItem(ench, chance));
+                enchantLists[entry].push_back(EnchStoreItem(ench, chance));
 
             ++count;
         }
@@ -72,6 +158,9 @@ void LoadRandomEnchantmentsTable()
 
         delete result;
 
+        for (auto const& enchantList : enchantLists)
+            RandomItemEnch[enchantList.first].Build(enchantList.second);
+
         sLog.outString(">> Loaded %u Item Enchantment definitions", count);
     }
     else
@@ -92,29 +181,7 @@ uint32 GetItemEnchantMod(uint32 entry)
         return 0;
     }
 
-    double dRoll = rand_chance();
-    float fCount = 0;
-
-    const EnchStoreList& enchantList = tab->second;
-    for (auto ench_iter : enchantList)
-    {
-        fCount += ench_iter.chance;
-
-        if (fCount > dRoll) return ench_iter.ench;
-    }
-
-    // we could get here only if sum of all enchantment chances is lower than 100%
-    dRoll = (irand(0, (int)floor(fCount * 100) + 1)) / 100;
-    fCount = 0;
-
-    for (auto ench_iter : enchantList)
-    {
-        fCount += ench_iter.chance;
-
-        if (fCount > dRoll) return ench_iter.ench;
-    }
-
-    return 0;
+    return tab->second.Roll();
 }
 
 uint32 GenerateEnchSuffixFactor(uint32 item_id)
@@ -22,8 +22,10 @@
 #include "Server/Opcodes.h"
 #include "Log.h"
 #include "Globals/ObjectMgr.h"
+#include "Globals/QueryResponseCache.h"
 #include "Entities/Player.h"
 #include "Entities/Item.h"
+#include "Entities/NpcListCache.h"
 #include "Entities/UpdateData.h"
 #include "Chat/Chat.h"
 
@@ -291,6 +293,13 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        uint32 ticket = 0;
+        if (std::shared_ptr<WorldPacket const> response = sQueryResponseCache.Get(QUERY_RESPONSE_ITEM, item, loc_idx, ticket))
+        {
+            SendPacket(SharedWorldPacket(response));
+            return;
+        }
+
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
         sObjectMgr.GetItemLocaleStrings(pProto->ItemId, loc_idx, &name, &description);
@@ -422,7 +431,7 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << uint32(pProto->Duration);                   // added in 2.4.2.8209, duration (seconds)
         data << uint32(pProto->ItemLimitCategory);          // WotLK, ItemLimitCategory
         data << uint32(pProto->HolidayId);                  // Holiday.dbc?
-        SendPacket(data);
+        SendPacket(SharedWorldPacket(sQueryResponseCache.Store(QUERY_RESPONSE_ITEM, item, loc_idx, ticket, data)));
     }
     else
     {
@@ -751,12 +760,12 @@ void WorldSession::SendListInventory(ObjectGuid vendorguid) const
         return;
     }
 
-    uint8 customitems = vItems ? vItems->GetItemCount() : 0;
-    uint8 numitems = customitems + (tItems ? tItems->GetItemCount() : 0);
+    // the items the player can see are serialized already, only the stock and the price are per player
+    std::shared_ptr<NpcListCache::VendorList const> items = sNpcListCache.GetVendorList(vItems, tItems, _player);
 
     uint8 count = 0;
 
-    WorldPacket data(SMSG_LIST_INVENTORY, (8 + 1 + numitems * 8 * 4));
+    WorldPacket data(SMSG_LIST_INVENTORY, (8 + 1 + items->entries.size() * VENDOR_LIST_ENTRY_SIZE));
     data << ObjectGuid(vendorguid);
 
     size_t count_pos = data.wpos();
@@ -764,63 +773,45 @@ void WorldSession::SendListInventory(ObjectGuid vendorguid) const
 
     float discountMod = _player->GetReputationPriceDiscount(pCreature);
 
-    for (uint8 vendorslot = 0; vendorslot < numitems; ++vendorslot)
+    for (size_t i = 0; i < items->entries.size(); ++i)
     {
-        VendorItem const* crItem = vendorslot < customitems ? vItems->GetItem(vendorslot) : tItems->GetItem(vendorslot - customitems);
+        NpcListCache::VendorEntry const& entry = items->entries[i];
+        VendorItem const* crItem = entry.item;
+        ItemPrototype const* pProto = entry.proto;
 
-        if (crItem)
-        {
-            uint32 itemId = crItem->item;
-            ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(itemId);
-            if (pProto)
-            {
-                if (!_player->IsGameMaster())
-                {
-                    // class wrong item skip only for bindable case
-                    if ((pProto->AllowableClass & _player->getClassMask()) == 0 && pProto->Bonding == BIND_WHEN_PICKED_UP)
-                        continue;
-
-                    // race wrong item skip always
-                    if ((pProto->Flags2 & ITEM_FLAG2_FACTION_HORDE) && _player->GetTeam() != HORDE)
-                        continue;
-
-                    if ((pProto->Flags2 & ITEM_FLAG2_FACTION_ALLIANCE) && _player->GetTeam() != ALLIANCE)
-                        continue;
+        if (!_player->IsGameMaster() && crItem->conditionId && !sObjectMgr.IsConditionSatisfied(crItem->conditionId, _player, pCreature->GetMap(), pCreature, CONDITION_FROM_VENDOR))
+            continue;
 
-                    if ((pProto->AllowableRace & _player->getRaceMask()) == 0)
-                        continue;
+        size_t entryPos = data.wpos();
 
-                    if (crItem->conditionId && !sObjectMgr.IsConditionSatisfied(crItem->conditionId, _player, pCreature->GetMap(), pCreature, CONDITION_FROM_VENDOR))
-                        continue;
-                }
+        // possible item coverting for BoA case
+        ItemPrototype const* newProto = nullptr;
+        if (pProto->Flags & ITEM_FLAG_IS_BOUND_TO_ACCOUNT)
+        {
+            // convert if can use and then buy
+            if (pProto->RequiredReputationFaction && uint32(_player->GetReputationRank(pProto->RequiredReputationFaction)) >= pProto->RequiredReputationRank)
+            {
+                // checked at convert data loading as existed
+                if (uint32 newItemId = sObjectMgr.GetItemConvert(pProto->ItemId, _player->getRaceMask()))
+                    newProto = ObjectMgr::GetItemPrototype(newItemId);
+            }
+        }
 
-                // possible item coverting for BoA case
-                if (pProto->Flags & ITEM_FLAG_IS_BOUND_TO_ACCOUNT)
-                {
-                    // convert if can use and then buy
-                    if (pProto->RequiredReputationFaction && uint32(_player->GetReputationRank(pProto->RequiredReputationFaction)) >= pProto->RequiredReputationRank)
-                    {
-                        // checked at convert data loading as existed
-                        if (uint32 newItemId = sObjectMgr.GetItemConvert(itemId, _player->getRaceMask()))
-                            pProto = ObjectMgr::GetItemPrototype(newItemId);
-                    }
-                }
+        if (newProto)
+        {
+            pProto = newProto;
+            NpcListCache::WriteVendorEntry(data, entry.slot, crItem, pProto);
+        }
+        else
+            data.append(items->data.contents() + i * VENDOR_LIST_ENTRY_SIZE, VENDOR_LIST_ENTRY_SIZE);
 
-                ++count;
+        ++count;
 
-                // reputation discount
-                uint32 price = (crItem->ExtendedCost == 0 || pProto->Flags2 & ITEM_FLAG2_DONT_IGNORE_BUY_PRICE) ? uint32(floor(pProto->BuyPrice * discountMod)) : 0;
+        // reputation discount
+        uint32 price = (crItem->ExtendedCost == 0 || pProto->Flags2 & ITEM_FLAG2_DONT_IGNORE_BUY_PRICE) ? uint32(floor(pProto->BuyPrice * discountMod)) : 0;
 
-                data << uint32(vendorslot + 1);             // client size expected counting from 1
-                data << uint32(pProto->ItemId);
-                data << uint32(pProto->DisplayInfoID);
-                data << uint32(crItem->maxcount <= 0 ? 0xFFFFFFFF : pCreature->GetVendorItemCurrentCount(crItem));
-                data << uint32(price);
-                data << uint32(pProto->MaxDurability);
-                data << uint32(pProto->BuyCount);
-                data << uint32(crItem->ExtendedCost);
-            }
-        }
+        data.put<uint32>(entryPos + NpcListCache::VENDOR_COUNT_OFFSET, uint32(crItem->maxcount <= 0 ? 0xFFFFFFFF : pCreature->GetVendorItemCurrentCount(crItem)));
+        data.put<uint32>(entryPos + NpcListCache::VENDOR_PRICE_OFFSET, price);
     }
 
     if (count == 0)
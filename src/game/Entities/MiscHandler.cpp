@@ -151,11 +151,10 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     data << uint32(matchcount);                             // placeholder, count of players matching criteria
     data << uint32(displaycount);                           // placeholder, count of players displayed
 
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    std::vector<Player*> players;
+    HashMapHolder<Player>::GetAll(players);
+    for (Player* pl : players)
     {
-        Player* pl = itr->second;
 
         if (security == SEC_PLAYER)
         {
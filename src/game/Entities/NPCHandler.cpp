@@ -29,6 +29,7 @@
 #include "Entities/GossipDef.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "Entities/Creature.h"
+#include "Entities/NpcListCache.h"
 #include "Entities/Pet.h"
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
@@ -104,26 +105,6 @@ void WorldSession::HandleTrainerListOpcode(WorldPacket& recv_data)
 }
 
 
-static void SendTrainerSpellHelper(WorldPacket& data, TrainerSpell const* tSpell, TrainerSpellState state, float fDiscountMod, bool /*can_learn_primary_prof*/, uint32 reqLevel)
-{
-    bool primary_prof_first_rank = sSpellMgr.IsPrimaryProfessionFirstRankSpell(tSpell->learnedSpell);
-
-    SpellChainNode const* chain_node = sSpellMgr.GetSpellChainNode(tSpell->learnedSpell);
-
-    data << uint32(tSpell->spell);                      // learned spell (or cast-spell in profession case)
-    data << uint8(state == TRAINER_SPELL_GREEN_DISABLED ? TRAINER_SPELL_GREEN : state);
-    data << uint32(floor(tSpell->spellCost * fDiscountMod));
-
-    data << uint32(0); // spells don't cost talent points
-    data << uint32(primary_prof_first_rank ? 1 : 0);    // must be equal prev. field to have learn button in enabled state
-    data << uint8(reqLevel);
-    data << uint32(tSpell->reqSkill);
-    data << uint32(tSpell->reqSkillValue);
-    data << uint32(!tSpell->IsCastable() && chain_node ? (chain_node->prev ? chain_node->prev : chain_node->req) : 0);
-    data << uint32(!tSpell->IsCastable() && chain_node && chain_node->prev ? chain_node->req : 0);
-    data << uint32(0);
-}
-
 void WorldSession::SendTrainerList(ObjectGuid guid) const
 {
     DEBUG_LOG("WORLD: SendTrainerList");
@@ -152,7 +133,9 @@ void WorldSession::SendTrainerList(ObjectGuid guid) const
         return;
     }
 
-    uint32 maxcount = (cSpells ? cSpells->spellList.size() : 0) + (tSpells ? tSpells->spellList.size() : 0);
+    std::shared_ptr<NpcListCache::TrainerList const> spells = sNpcListCache.GetTrainerList(cSpells, tSpells, _player);
+
+    uint32 maxcount = spells->entries.size();
     uint32 trainer_type = cSpells && cSpells->trainerType ? cSpells->trainerType : (tSpells ? tSpells->trainerType : 0);
 
     std::string strTitle;
@@ -174,54 +157,26 @@ void WorldSession::SendTrainerList(ObjectGuid guid) const
 
     // reputation discount
     float fDiscountMod = _player->GetReputationPriceDiscount(unit);
-    bool can_learn_primary_prof = GetPlayer()->GetFreePrimaryProfessionPoints() > 0;
 
     uint32 count = 0;
 
-    if (cSpells)
+    // the spells fitting race and class are serialized already, only the state and the cost are per player
+    for (size_t i = 0; i < spells->entries.size(); ++i)
     {
-        for (const auto& itr : cSpells->spellList)
-        {
-            TrainerSpell const* tSpell = &itr.second;
+        NpcListCache::TrainerEntry const& entry = spells->entries[i];
+        TrainerSpell const* tSpell = entry.spell;
 
-            uint32 reqLevel = 0;
-            if (!_player->IsSpellFitByClassAndRace(tSpell->learnedSpell, &reqLevel))
-                continue;
+        if (tSpell->conditionId && !sObjectMgr.IsConditionSatisfied(tSpell->conditionId, GetPlayer(), unit->GetMap(), unit, CONDITION_FROM_TRAINER))
+            continue;
 
-            if (tSpell->conditionId && !sObjectMgr.IsConditionSatisfied(tSpell->conditionId, GetPlayer(), unit->GetMap(), unit, CONDITION_FROM_TRAINER))
-                continue;
+        TrainerSpellState state = _player->GetTrainerSpellState(tSpell, entry.reqLevel);
 
-            reqLevel = tSpell->isProvidedReqLevel ? tSpell->reqLevel : std::max(reqLevel, tSpell->reqLevel);
-
-            TrainerSpellState state = _player->GetTrainerSpellState(tSpell, reqLevel);
-
-            SendTrainerSpellHelper(data, tSpell, state, fDiscountMod, can_learn_primary_prof, reqLevel);
-
-            ++count;
-        }
-    }
+        size_t entryPos = data.wpos();
+        data.append(spells->data.contents() + i * TRAINER_LIST_ENTRY_SIZE, TRAINER_LIST_ENTRY_SIZE);
+        data.put<uint8>(entryPos + NpcListCache::TRAINER_STATE_OFFSET, uint8(state == TRAINER_SPELL_GREEN_DISABLED ? TRAINER_SPELL_GREEN : state));
+        data.put<uint32>(entryPos + NpcListCache::TRAINER_COST_OFFSET, uint32(floor(tSpell->spellCost * fDiscountMod)));
 
-    if (tSpells)
-    {
-        for (const auto& itr : tSpells->spellList)
-        {
-            TrainerSpell const* tSpell = &itr.second;
-
-            uint32 reqLevel = 0;
-            if (!_player->IsSpellFitByClassAndRace(tSpell->learnedSpell, &reqLevel))
-                continue;
-
-            if (tSpell->conditionId && !sObjectMgr.IsConditionSatisfied(tSpell->conditionId, GetPlayer(), unit->GetMap(), unit, CONDITION_FROM_TRAINER))
-                continue;
-
-            reqLevel = tSpell->isProvidedReqLevel ? tSpell->reqLevel : std::max(reqLevel, tSpell->reqLevel);
-
-            TrainerSpellState state = _player->GetTrainerSpellState(tSpell, reqLevel);
-
-            SendTrainerSpellHelper(data, tSpell, state, fDiscountMod, can_learn_primary_prof, reqLevel);
-
-            ++count;
-        }
+        ++count;
     }
 
     data << strTitle;
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Entities/NpcListCache.h"
+#include "Entities/Creature.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectMgr.h"
+#include "Spells/SpellMgr.h"
+
+INSTANTIATE_SINGLETON_1(NpcListCache);
+
+std::shared_ptr<NpcListCache::TrainerList const> NpcListCache::GetTrainerList(TrainerSpellData const* cSpells, TrainerSpellData const* tSpells, Player const* player)
+{
+    ListKey key(cSpells, tSpells, player->getRace() | (player->getClass() << 8));
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::shared_ptr<TrainerList const>& list = m_trainerLists[key];
+    if (!list)
+        list = BuildTrainerList(cSpells, tSpells, player);
+    return list;
+}
+
+std::shared_ptr<NpcListCache::VendorList const> NpcListCache::GetVendorList(VendorItemData const* vItems, VendorItemData const* tItems, Player const* player)
+{
+    // game masters see the unfiltered list
+    ListKey key(vItems, tItems, player->IsGameMaster() ? 0 : player->getRace() | (player->getClass() << 8) | (player->GetTeam() << 16));
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    std::shared_ptr<VendorList const>& list = m_vendorLists[key];
+    if (!list)
+        list = BuildVendorList(vItems, tItems, player);
+    return list;
+}
+
+void NpcListCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_trainerLists.clear();
+    m_vendorLists.clear();
+}
+
+std::shared_ptr<NpcListCache::TrainerList const> NpcListCache::BuildTrainerList(TrainerSpellData const* cSpells, TrainerSpellData const* tSpells, Player const* player)
+{
+    std::shared_ptr<TrainerList> list = std::make_shared<TrainerList>();
+
+    for (TrainerSpellData const* spells : { cSpells, tSpells })
+    {
+        if (!spells)
+            continue;
+
+        for (auto const& itr : spells->spellList)
+        {
+            TrainerSpell const* tSpell = &itr.second;
+
+            // only depends on race and class with the required level asked for
+            uint32 reqLevel = 0;
+            if (!player->IsSpellFitByClassAndRace(tSpell->learnedSpell, &reqLevel))
+                continue;
+
+            reqLevel = tSpell->isProvidedReqLevel ? tSpell->reqLevel : std::max(reqLevel, tSpell->reqLevel);
+
+            bool primary_prof_first_rank = sSpellMgr.IsPrimaryProfessionFirstRankSpell(tSpell->learnedSpell);
+            SpellChainNode const* chain_node = sSpellMgr.GetSpellChainNode(tSpell->learnedSpell);
+
+            list->data << uint32(tSpell->spell);            // learned spell (or cast-spell in profession case)
+            list->data << uint8(0);                         // state, patched per player
+            list->data << uint32(0);                        // cost, patched per player
+            list->data << uint32(0);                        // spells don't cost talent points
+            list->data << uint32(primary_prof_first_rank ? 1 : 0); // must be equal prev. field to have learn button in enabled state
+            list->data << uint8(reqLevel);
+            list->data << uint32(tSpell->reqSkill);
+            list->data << uint32(tSpell->reqSkillValue);
+            list->data << uint32(!tSpell->IsCastable() && chain_node ? (chain_node->prev ? chain_node->prev : chain_node->req) : 0);
+            list->data << uint32(!tSpell->IsCastable() && chain_node && chain_node->prev ? chain_node->req : 0);
+            list->data << uint32(0);
+
+            list->entries.push_back({ tSpell, reqLevel });
+        }
+    }
+
+    return list;
+}
+
+std::shared_ptr<NpcListCache::VendorList const> NpcListCache::BuildVendorList(VendorItemData const* vItems, VendorItemData const* tItems, Player const* player)
+{
+    std::shared_ptr<VendorList> list = std::make_shared<VendorList>();
+
+    uint8 customitems = vItems ? vItems->GetItemCount() : 0;
+    uint8 numitems = customitems + (tItems ? tItems->GetItemCount() : 0);
+
+    for (uint8 vendorslot = 0; vendorslot < numitems; ++vendorslot)
+    {
+        VendorItem const* crItem = vendorslot < customitems ? vItems->GetItem(vendorslot) : tItems->GetItem(vendorslot - customitems);
+        if (!crItem)
+            continue;
+
+        ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(crItem->item);
+        if (!pProto)
+            continue;
+
+        if (!player->IsGameMaster())
+        {
+            // class wrong item skip only for bindable case
+            if ((pProto->AllowableClass & player->getClassMask()) == 0 && pProto->Bonding == BIND_WHEN_PICKED_UP)
+                continue;
+
+            // race wrong item skip always
+            if ((pProto->Flags2 & ITEM_FLAG2_FACTION_HORDE) && player->GetTeam() != HORDE)
+                continue;
+
+            if ((pProto->Flags2 & ITEM_FLAG2_FACTION_ALLIANCE) && player->GetTeam() != ALLIANCE)
+                continue;
+
+            if ((pProto->AllowableRace & player->getRaceMask()) == 0)
+                continue;
+        }
+
+        WriteVendorEntry(list->data, vendorslot + 1, crItem, pProto);
+        list->entries.push_back({ uint32(vendorslot + 1), crItem, pProto });
+    }
+
+    return list;
+}
+
+void NpcListCache::WriteVendorEntry(ByteBuffer& data, uint32 slot, VendorItem const* item, ItemPrototype const* proto)
+{
+    data << uint32(slot);
+    data << uint32(proto->ItemId);
+    data << uint32(proto->DisplayInfoID);
+    data << uint32(0);                                      // stock, patched per player
+    data << uint32(0);                                      // price, patched per player
+    data << uint32(proto->MaxDurability);
+    data << uint32(proto->BuyCount);
+    data << uint32(item->ExtendedCost);
+}
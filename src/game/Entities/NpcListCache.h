@@ -0,0 +1,108 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_NPCLISTCACHE_H
+#define MANGOS_NPCLISTCACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "ByteBuffer.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+class Player;
+struct TrainerSpell;
+struct TrainerSpellData;
+struct VendorItem;
+struct VendorItemData;
+struct ItemPrototype;
+
+#define TRAINER_LIST_ENTRY_SIZE 38                          // one spell of SMSG_TRAINER_LIST
+#define VENDOR_LIST_ENTRY_SIZE  32                          // one item of SMSG_LIST_INVENTORY
+
+/**
+ * The trainer and vendor lists filtered by race and class, with the fields of each entry that are
+ * the same for all players already serialized. Opening a list only checks the conditions, copies
+ * the entries and patches in the per player fields: spell state, prices and vendor stock.
+ *
+ * A list is built at the first open by a player of its race and class and dropped by Clear after
+ * the trainer, vendor or spell chain data changed. Safe to use from all threads.
+ */
+class NpcListCache
+{
+    public:
+        struct TrainerEntry
+        {
+            TrainerSpell const* spell;
+            uint32 reqLevel;
+        };
+
+        struct TrainerList
+        {
+            std::vector<TrainerEntry> entries;
+            ByteBuffer data;                                // TRAINER_LIST_ENTRY_SIZE bytes per entry
+        };
+
+        // patched per player
+        static size_t const TRAINER_STATE_OFFSET = 4;       // uint8
+        static size_t const TRAINER_COST_OFFSET  = 5;       // uint32
+
+        struct VendorEntry
+        {
+            uint32 slot;                                    // in the combined list, the client counts from 1
+            VendorItem const* item;
+            ItemPrototype const* proto;
+        };
+
+        struct VendorList
+        {
+            std::vector<VendorEntry> entries;
+            ByteBuffer data;                                // VENDOR_LIST_ENTRY_SIZE bytes per entry
+        };
+
+        // patched per player
+        static size_t const VENDOR_COUNT_OFFSET = 12;       // uint32
+        static size_t const VENDOR_PRICE_OFFSET = 16;       // uint32
+
+        // spells of both lists that fit the race and class of the player, in the order they are sent
+        std::shared_ptr<TrainerList const> GetTrainerList(TrainerSpellData const* cSpells, TrainerSpellData const* tSpells, Player const* player);
+        // items of both lists the player can see, all of them for game masters
+        std::shared_ptr<VendorList const> GetVendorList(VendorItemData const* vItems, VendorItemData const* tItems, Player const* player);
+
+        // after a change of the trainer, vendor or spell chain data
+        void Clear();
+
+        static void WriteVendorEntry(ByteBuffer& data, uint32 slot, VendorItem const* item, ItemPrototype const* proto);
+
+    private:
+        typedef std::tuple<void const*, void const*, uint32> ListKey; // both lists and the player filter
+
+        static std::shared_ptr<TrainerList const> BuildTrainerList(TrainerSpellData const* cSpells, TrainerSpellData const* tSpells, Player const* player);
+        static std::shared_ptr<VendorList const> BuildVendorList(VendorItemData const* vItems, VendorItemData const* tItems, Player const* player);
+
+        std::mutex m_lock;
+        std::map<ListKey, std::shared_ptr<TrainerList const>> m_trainerLists;
+        std::map<ListKey, std::shared_ptr<VendorList const>> m_vendorLists;
+};
+
+#define sNpcListCache MaNGOS::Singleton<NpcListCache>::Instance()
+
+#endif
@@ -38,6 +38,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Maps/GridDefines.h"
 #include "Maps/MapManager.h"
+#include "Maps/CombatLogBatch.h"
 #include "Maps/ObjectPosSelector.h"
 #include "Entities/TemporarySpawn.h"
 #include "Movement/packet_builder.h"
@@ -47,7 +48,45 @@
 #include "Spells/SpellMgr.h"
 #include "MotionGenerators/PathFinder.h"
 
-Object::Object(): m_updateFlag(0), m_itsNewObject(false)
+// values update blocks of one object built while sending one tick of its changes
+// targets of the same visibility class get the same mask, so unless some changed field is serialized
+// depending on the target itself, they can all get a copy of the block built for the first of them
+struct ValuesUpdateCache
+{
+    enum
+    {
+        VISIBILITY_CLASS_SELF       = 0x01,                 // object is the target
+        VISIBILITY_CLASS_GAMEMASTER = 0x02,                 // target sees gamemaster values
+        VISIBILITY_CLASS_COALESCED  = 0x04,                 // far target, coalescable fields are held back
+        MAX_VISIBILITY_CLASSES      = 8
+    };
+
+    struct Entry
+    {
+        Entry() : built(false), shared(false), empty(false) {}
+
+        bool built;
+        bool shared;
+        bool empty;                                         // nothing left once coalescable fields are removed
+        UpdateMask mask;
+        ByteBuffer block;
+    };
+
+    static uint8 GetClass(Object const* object, Player const* target)
+    {
+        return (object == target ? VISIBILITY_CLASS_SELF : 0) | (target->IsGameMaster() ? VISIBILITY_CLASS_GAMEMASTER : 0);
+    }
+
+    Entry entries[MAX_VISIBILITY_CLASSES];
+};
+
+ValuesUpdateCacheStats& Object::GetValuesUpdateCacheStats()
+{
+    static thread_local ValuesUpdateCacheStats stats;
+    return stats;
+}
+
+Object::Object(): m_updateFlag(0), m_coalescedSince(0), m_hasCoalescedValues(false), m_itsNewObject(false)
 {
     m_objectTypeId      = TYPEID_OBJECT;
     m_objectType        = TYPEMASK_OBJECT;
@@ -115,6 +154,8 @@ void Object::SendForcedObjectUpdate()
 
     BuildUpdateData(update_players);
     RemoveFromClientUpdateList();
+    if (m_hasCoalescedValues)
+        MarkForClientUpdate();
 
     // here we allocate a std::vector with a size of 0x10000
     for (auto& update_player : update_players)
@@ -204,8 +245,62 @@ void Object::SendCreateUpdateToPlayer(Player* player) const
     }
 }
 
-void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache /*= nullptr*/, bool coalesce /*= false*/) const
 {
+    if (cache)
+    {
+        ValuesUpdateCache::Entry& entry = cache->entries[ValuesUpdateCache::GetClass(this, target) | (coalesce ? ValuesUpdateCache::VISIBILITY_CLASS_COALESCED : 0)];
+        ValuesUpdateCacheStats& stats = GetValuesUpdateCacheStats();
+        if (!entry.built)
+        {
+            entry.mask.SetCount(m_valuesCount);
+            _SetUpdateBits(&entry.mask, target);
+            entry.empty = coalesce && !RemoveCoalescableValues(entry.mask);
+            entry.shared = !entry.empty && !HasTargetDependentValues(entry.mask);
+            entry.built = true;
+
+            if (entry.shared)
+            {
+                entry.block.reserve(500);
+                entry.block << uint8(UPDATETYPE_VALUES);
+                entry.block << GetPackGUID();
+
+                UpdateMask updateMask(entry.mask);
+                BuildValuesUpdate(UPDATETYPE_VALUES, &entry.block, &updateMask, target);
+                ++stats.misses;
+            }
+        }
+        else if (entry.shared)
+        {
+            ++stats.hits;
+            stats.savedBytes += entry.block.size();
+        }
+
+        if (entry.empty)
+        {
+            ++stats.coalesced;
+            return;
+        }
+
+        if (entry.shared)
+        {
+            data->AddUpdateBlock(entry.block);
+            return;
+        }
+
+        ByteBuffer buf(500);
+
+        buf << uint8(UPDATETYPE_VALUES);
+        buf << GetPackGUID();
+
+        UpdateMask updateMask(entry.mask);
+        BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+        ++stats.misses;
+
+        data->AddUpdateBlock(buf);
+        return;
+    }
+
     ByteBuffer buf(500);
 
     buf << uint8(UPDATETYPE_VALUES);
@@ -215,11 +310,41 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     updateMask.SetCount(m_valuesCount);
 
     _SetUpdateBits(&updateMask, target);
+    if (coalesce && !RemoveCoalescableValues(updateMask))
+        return;
+
     BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
 
     data->AddUpdateBlock(buf);
 }
 
+bool Object::IsCoalescableValue(uint16 index) const
+{
+    if (!isType(TYPEMASK_UNIT))
+        return false;
+
+    // auras themselves go through SMSG_AURA_UPDATE, only the aura state is a field
+    return (index >= UNIT_FIELD_POWER1 && index <= UNIT_FIELD_MAXPOWER7) ||
+           (index >= UNIT_FIELD_POWER_REGEN_FLAT_MODIFIER && index < UNIT_FIELD_POWER_REGEN_INTERRUPTED_FLAT_MODIFIER + MAX_POWERS) ||
+           index == UNIT_FIELD_AURASTATE || index == UNIT_FIELD_BYTES_1;
+}
+
+bool Object::RemoveCoalescableValues(UpdateMask& updateMask) const
+{
+    bool remaining = false;
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+    {
+        if (!updateMask.GetBit(index))
+            continue;
+
+        if (IsCoalescableValue(index))
+            updateMask.UnsetBit(index);
+        else
+            remaining = true;
+    }
+    return remaining;
+}
+
 void Object::BuildForcedValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const
 {
     ByteBuffer buf(500);
@@ -448,6 +573,20 @@ void Object::BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const
     }
 }
 
+// unit stat fields hidden by Fog of War
+static inline bool IsFogOfWarStatsIndex(uint16 index)
+{
+    return index == UNIT_FIELD_RANGEDATTACKTIME ||
+           index == UNIT_FIELD_MINDAMAGE || index == UNIT_FIELD_MAXDAMAGE ||
+           index == UNIT_FIELD_MINOFFHANDDAMAGE || index == UNIT_FIELD_MAXOFFHANDDAMAGE ||
+           (index >= UNIT_FIELD_STAT0 && index < UNIT_FIELD_BASE_MANA) ||
+           index == UNIT_FIELD_BASE_HEALTH || index == UNIT_FIELD_ATTACK_POWER ||
+           index == UNIT_FIELD_ATTACK_POWER_MODS || index == UNIT_FIELD_ATTACK_POWER_MULTIPLIER ||
+           index == UNIT_FIELD_RANGED_ATTACK_POWER || index == UNIT_FIELD_RANGED_ATTACK_POWER_MODS ||
+           index == UNIT_FIELD_RANGED_ATTACK_POWER_MULTIPLIER || index == UNIT_FIELD_MINRANGEDDAMAGE ||
+           index == UNIT_FIELD_MAXRANGEDDAMAGE || (index >= UNIT_FIELD_POWER_COST_MODIFIER && index <= UNIT_FIELD_MAXHEALTHMODIFIER);
+}
+
 void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
 {
     if (!target)
@@ -600,16 +739,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
                     *data << value;
                 }
                 // Fog of War: hide stat values for non-allied units according to settings
-                else if ((index == UNIT_FIELD_RANGEDATTACKTIME ||
-                          index == UNIT_FIELD_MINDAMAGE || index == UNIT_FIELD_MAXDAMAGE ||
-                          index == UNIT_FIELD_MINOFFHANDDAMAGE || index == UNIT_FIELD_MAXOFFHANDDAMAGE ||
-                          (index >= UNIT_FIELD_STAT0 && index < UNIT_FIELD_BASE_MANA) ||
-                          index == UNIT_FIELD_BASE_HEALTH || index == UNIT_FIELD_ATTACK_POWER ||
-                          index == UNIT_FIELD_ATTACK_POWER_MODS || index == UNIT_FIELD_ATTACK_POWER_MULTIPLIER ||
-                          index == UNIT_FIELD_RANGED_ATTACK_POWER || index == UNIT_FIELD_RANGED_ATTACK_POWER_MODS ||
-                          index == UNIT_FIELD_RANGED_ATTACK_POWER_MULTIPLIER || index == UNIT_FIELD_MINRANGEDDAMAGE ||
-                          index == UNIT_FIELD_MAXRANGEDDAMAGE || (index >= UNIT_FIELD_POWER_COST_MODIFIER && index <= UNIT_FIELD_MAXHEALTHMODIFIER)) &&
-                          !static_cast<const Unit*>(this)->IsFogOfWarVisibleStats(target))
+                else if (IsFogOfWarStatsIndex(index) && !static_cast<const Unit*>(this)->IsFogOfWarVisibleStats(target))
                 {
                     *data << uint32(0);
                 }
@@ -886,6 +1016,10 @@ void Object::ClearUpdateMask(bool remove)
             RemoveFromClientUpdateList();
         m_objectUpdated = false;
     }
+
+    // out of world, clients forget about the object anyway
+    if (remove)
+        m_hasCoalescedValues = false;
 }
 
 void Object::_LoadIntoDataField(const char* data, uint32 startOffset, uint32 count)
@@ -1159,7 +1293,46 @@ bool Object::PrintEntryError(char const* descr) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const
+bool Object::HasTargetDependentValues(UpdateMask const& updateMask) const
+{
+    if (isType(TYPEMASK_UNIT))
+    {
+        Unit const* unit = static_cast<Unit const*>(this);
+
+        // aura state is always sent per caster while this state is on
+        if (unit->HasAuraState(AURA_STATE_CONFLAGRATE))
+            return true;
+
+        if (updateMask.GetBit(UNIT_NPC_FLAGS) || updateMask.GetBit(UNIT_DYNAMIC_FLAGS))
+            return true;
+
+        if (sWorld.getConfig(CONFIG_UINT32_FOGOFWAR_HEALTH) < 2 && (updateMask.GetBit(UNIT_FIELD_HEALTH) || updateMask.GetBit(UNIT_FIELD_MAXHEALTH)))
+            return true;
+
+        if (GetTypeId() == TYPEID_PLAYER && sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && updateMask.GetBit(UNIT_FIELD_FACTIONTEMPLATE))
+            return true;
+
+        if (sWorld.getConfig(CONFIG_UINT32_FOGOFWAR_STATS) != 2)
+        {
+            for (uint16 index = UNIT_FIELD_MINDAMAGE; index <= UNIT_FIELD_MAXHEALTHMODIFIER && index < m_valuesCount; ++index)
+                if (updateMask.GetBit(index) && IsFogOfWarStatsIndex(index))
+                    return true;
+        }
+
+        return false;
+    }
+
+    if (isType(TYPEMASK_CORPSE))
+        return sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && updateMask.GetBit(CORPSE_FIELD_BYTES_1);
+
+    // quest activation is always checked for the target
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return !static_cast<GameObject const*>(this)->IsDynTransport();
+
+    return false;
+}
+
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache /*= nullptr*/, bool coalesce /*= false*/) const
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1170,7 +1343,7 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache, coalesce);
 }
 
 void Object::AddToClientUpdateList()
@@ -1263,17 +1436,19 @@ void WorldObject::SetOrientation(float orientation)
 
 uint32 WorldObject::GetZoneId() const
 {
-    return GetTerrain()->GetZoneId(m_position.x, m_position.y, m_position.z);
+    return GetMap()->GetTerrainCache().GetAreaInfo(m_position.x, m_position.y, m_position.z, &m_areaHint).zoneId;
 }
 
 uint32 WorldObject::GetAreaId() const
 {
-    return GetTerrain()->GetAreaId(m_position.x, m_position.y, m_position.z);
+    return GetMap()->GetTerrainCache().GetAreaInfo(m_position.x, m_position.y, m_position.z, &m_areaHint).areaId;
 }
 
 void WorldObject::GetZoneAndAreaId(uint32& zoneid, uint32& areaid) const
 {
-    GetTerrain()->GetZoneAndAreaId(zoneid, areaid, m_position.x, m_position.y, m_position.z);
+    TerrainCache::AreaInfo info = GetMap()->GetTerrainCache().GetAreaInfo(m_position.x, m_position.y, m_position.z, &m_areaHint);
+    zoneid = info.zoneId;
+    areaid = info.areaId;
 }
 
 InstanceData* WorldObject::GetInstanceData() const
@@ -1921,6 +2096,9 @@ void WorldObject::SendMessageToSetExcept(WorldPacket const& data, Player const*
     // if object is in world, map for it already created!
     if (IsInWorld())
     {
+        GetMap()->FlushMovementRelayOf(this);
+        CombatLogBatch::FlushOfCurrent(this);
+
         MaNGOS::MessageDelivererExcept notifier(this, data, skipped_receiver);
         Cell::VisitWorldObjects(this, notifier, GetMap()->GetVisibilityDistance());
     }
@@ -2007,9 +2185,9 @@ Creature* WorldObject::SummonCreature(TempSpawnSettings settings, Map* map, uint
 
     TemporarySpawn* creature;
     if (!settings.tempSpawnMovegen)
-        creature = new TemporarySpawn(settings.spawner ? settings.spawner->GetObjectGuid() : ObjectGuid());
+        creature = new (map) TemporarySpawn(settings.spawner ? settings.spawner->GetObjectGuid() : ObjectGuid());
     else
-        creature = new TemporarySpawnWaypoint(settings.spawner ? settings.spawner->GetObjectGuid() : ObjectGuid(), settings.waypointId, settings.spawnPathId, settings.pathOrigin);
+        creature = new (map) TemporarySpawnWaypoint(settings.spawner ? settings.spawner->GetObjectGuid() : ObjectGuid(), settings.waypointId, settings.spawnPathId, settings.pathOrigin);
 
     GenericTransport* transport = nullptr;
     if (settings.spawner)
@@ -2461,12 +2639,16 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
-    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
+    ValuesUpdateCache i_cache;                              // values block shared by observers of the same class
+    float i_coalesceDistSq;                                 // observers farther than this get coalescable fields late, 0 to send them to all
+    bool i_coalesced;                                       // some observer did not get the coalescable fields
+    WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d, float coalesceDist) : i_updateDatas(d), i_object(obj),
+        i_coalesceDistSq(coalesceDist * coalesceDist), i_coalesced(false)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, &i_cache);
     }
 
     void Visit(CameraMapType& m)
@@ -2475,18 +2657,72 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter.getSource()->GetOwner();
             if (owner != &i_object && owner->HaveAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+            {
+                bool coalesce = IsFarObserver(owner);
+                i_coalesced |= coalesce;
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_cache, coalesce);
+            }
         }
     }
 
+    // near observers and those fighting or grouped with the unit keep getting every change at once
+    bool IsFarObserver(Player const* owner) const
+    {
+        if (i_coalesceDistSq <= 0.0f)
+            return false;
+
+        if (i_object.GetDistance(owner, false, DIST_CALC_NONE) <= i_coalesceDistSq)
+            return false;
+
+        return !static_cast<Unit&>(i_object).IsImportantForVisibilityOf(owner);
+    }
+
     template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
 };
 
 void WorldObject::BuildUpdateData(UpdateDataMapType& update_players)
 {
-    WorldObjectChangeAccumulator notifier(*this, update_players);
+    float coalesceDist = 0.0f;
+    if (isType(TYPEMASK_UNIT) && sWorld.getConfig(CONFIG_UINT32_UPDATE_COALESCE_INTERVAL))
+    {
+        if (m_hasCoalescedValues && WorldTimer::getMSTimeDiff(m_coalescedSince, WorldTimer::getMSTime()) >= sWorld.getConfig(CONFIG_UINT32_UPDATE_COALESCE_INTERVAL))
+        {
+            // held back fields are due, send them to every observer along with this tick changes
+            for (uint16 index = 0; index < m_valuesCount; ++index)
+                if (m_coalescedValues.GetBit(index))
+                    m_changedValues[index] = true;
+            m_hasCoalescedValues = false;
+        }
+        else
+        {
+            // only waiting for held back fields to be due, no need to walk the observers
+            if (m_hasCoalescedValues && std::find(m_changedValues.begin(), m_changedValues.end(), true) == m_changedValues.end())
+            {
+                ClearUpdateMask(false);
+                return;
+            }
+
+            coalesceDist = sWorld.getConfig(CONFIG_FLOAT_UPDATE_COALESCE_DISTANCE);
+        }
+    }
+
+    WorldObjectChangeAccumulator notifier(*this, update_players, coalesceDist);
     Cell::VisitWorldObjects(this, notifier, GetVisibilityData().GetVisibilityDistance());
 
+    if (notifier.i_coalesced)
+    {
+        if (!m_hasCoalescedValues)
+        {
+            m_coalescedValues.SetCount(m_valuesCount);
+            m_coalescedSince = WorldTimer::getMSTime();
+            m_hasCoalescedValues = true;
+        }
+
+        for (uint16 index = 0; index < m_valuesCount; ++index)
+            if (m_changedValues[index] && IsCoalescableValue(index))
+                m_coalescedValues.SetBit(index);
+    }
+
     ClearUpdateMask(false);
 }
 
@@ -2578,6 +2814,27 @@ TimePoint WorldObject::GetGCD(SpellEntry const* spellEntry) const
     return GetMap()->GetCurrentClockTime();
 }
 
+bool CooldownContainer::BuildSpellCooldownPacket(WorldPacket& data, ObjectGuid const& guid, TimePoint const& now) const
+{
+    data.Initialize(SMSG_SPELL_COOLDOWN, 8 + 1 + m_spellIdMap.size() * 8);
+    data << guid;
+    data << uint8(0x0);                                     // flags (0x1, 0x2)
+
+    uint32 count = 0;
+    for (auto const& cdItr : m_spellIdMap)
+    {
+        CooldownData const& cdData = *cdItr.second;
+        if (cdData.IsPermanent() || cdData.m_expireTime <= now)
+            continue;
+
+        data << uint32(cdData.GetSpellId());
+        data << uint32(std::chrono::duration_cast<std::chrono::milliseconds>(cdData.m_expireTime - now).count());
+        ++count;
+    }
+
+    return count != 0;
+}
+
 void WorldObject::AddCooldown(SpellEntry const& spellEntry, ItemPrototype const* /*itemProto = nullptr*/, bool /*permanent = false*/, uint32 forcedDuration /*= 0*/)
 {
     uint32 recTimeDuration = forcedDuration ? forcedDuration : spellEntry.RecoveryTime;
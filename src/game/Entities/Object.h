@@ -24,6 +24,7 @@
 #include "ByteBuffer.h"
 #include "Entities/UpdateFields.h"
 #include "Entities/UpdateData.h"
+#include "Entities/UpdateMask.h"
 #include "Entities/ObjectGuid.h"
 #include "Entities/EntitiesMgr.h"
 #include "Globals/SharedDefines.h"
@@ -32,6 +33,7 @@
 #include "PlayerDefines.h"
 #include "Entities/ObjectVisibility.h"
 #include "Grids/Cell.h"
+#include "Maps/TerrainCache.h"
 
 #include <set>
 
@@ -106,7 +108,6 @@ class Player;
 class Unit;
 class Group;
 class Map;
-class UpdateMask;
 class InstanceData;
 class TerrainInfo;
 class TransportInfo;
@@ -120,6 +121,19 @@ class GenericTransport;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+struct ValuesUpdateCache;
+
+// per thread statistics of values update blocks shared between targets
+struct ValuesUpdateCacheStats
+{
+    ValuesUpdateCacheStats() : hits(0), misses(0), coalesced(0), savedBytes(0) {}
+
+    uint32 hits;                                            // block copied from an already built one
+    uint32 misses;                                          // block built for a target
+    uint32 coalesced;                                       // block not sent to a far target, only coalescable fields changed
+    uint64 savedBytes;                                      // bytes not serialized again thanks to hits
+};
+
 class CooldownData
 {
         friend class CooldownContainer;
@@ -202,13 +216,20 @@ typedef std::map<SpellSchools, TimePoint> LockoutMap;
 class CooldownContainer
 {
     public:
-        typedef std::map<uint32, CooldownDataUPTR> spellIdMap;
+        typedef std::unordered_map<uint32, CooldownDataUPTR> spellIdMap;
         typedef spellIdMap::const_iterator ConstIterator;
         typedef spellIdMap::iterator Iterator;
-        typedef std::map<uint32, ConstIterator> categoryMap;
+        typedef std::unordered_map<uint32, uint32> categoryMap;   // category to the spell id holding it
+
+        CooldownContainer() : m_nextExpireTime(TimePoint::max()) {}
 
         void Update(TimePoint const& now)
         {
+            // nothing to expire before the earliest expire time of all entries
+            if (now < m_nextExpireTime)
+                return;
+
+            m_nextExpireTime = TimePoint::max();
             auto spellCDItr = m_spellIdMap.begin();
             while (spellCDItr != m_spellIdMap.end())
             {
@@ -222,6 +243,7 @@ class CooldownContainer
                         m_categoryMap.erase(cd->m_category);
                         cd->m_category = 0;
                     }
+                    UpdateNextExpireTime(*cd, now);
                     ++spellCDItr;
                 }
             }
@@ -234,9 +256,12 @@ class CooldownContainer
             if (resultItr.second && spellCategory && categoryDuration)
             {
                 RemoveByCategory(spellCategory);
-                m_categoryMap.emplace(spellCategory, resultItr.first);
+                m_categoryMap.emplace(spellCategory, spellId);
             }
 
+            if (resultItr.second)
+                UpdateNextExpireTime(*resultItr.first->second, clockNow);
+
             return resultItr.second;
         }
 
@@ -244,25 +269,18 @@ class CooldownContainer
         {
             auto spellCDItr = m_spellIdMap.find(spellId);
             if (spellCDItr != m_spellIdMap.end())
-            {
-                auto& cdData = spellCDItr->second;
-                if (cdData->m_category)
-                {
-                    auto catCDItr = m_categoryMap.find(cdData->m_category);
-                    if (catCDItr != m_categoryMap.end())
-                        m_categoryMap.erase(catCDItr);
-                }
-                m_spellIdMap.erase(spellCDItr);
-            }
+                erase(spellCDItr);
         }
 
         void RemoveByCategory(uint32 category)
         {
-            auto spellCDItr = m_categoryMap.find(category);
-            if (spellCDItr != m_categoryMap.end())
+            auto catCDItr = m_categoryMap.find(category);
+            if (catCDItr != m_categoryMap.end())
             {
-                spellCDItr->second->second->m_category = 0;
-                m_categoryMap.erase(spellCDItr);
+                auto spellCDItr = m_spellIdMap.find(catCDItr->second);
+                if (spellCDItr != m_spellIdMap.end())
+                    spellCDItr->second->m_category = 0;
+                m_categoryMap.erase(catCDItr);
             }
         }
 
@@ -270,11 +288,7 @@ class CooldownContainer
         {
             auto& cdData = spellCDItr->second;
             if (cdData->m_category)
-            {
-                auto catCDItr = m_categoryMap.find(cdData->m_category);
-                if (catCDItr != m_categoryMap.end())
-                    m_categoryMap.erase(catCDItr);
-            }
+                m_categoryMap.erase(cdData->m_category);
             return m_spellIdMap.erase(spellCDItr);
         }
 
@@ -283,10 +297,13 @@ class CooldownContainer
         ConstIterator FindByCategory(uint32 category) const
         {
             auto itr = m_categoryMap.find(category);
-            return itr != m_categoryMap.end() ? itr->second : end();
+            return itr != m_categoryMap.end() ? m_spellIdMap.find(itr->second) : end();
         }
 
-        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); }
+        // the running spell cooldowns of all entries as one SMSG_SPELL_COOLDOWN, false if there is none
+        bool BuildSpellCooldownPacket(WorldPacket& data, ObjectGuid const& guid, TimePoint const& now) const;
+
+        void clear() { m_spellIdMap.clear(); m_categoryMap.clear(); m_nextExpireTime = TimePoint::max(); }
 
         ConstIterator begin() const { return m_spellIdMap.begin(); }
         ConstIterator end() const { return m_spellIdMap.end(); }
@@ -294,8 +311,20 @@ class CooldownContainer
         size_t size() const { return m_spellIdMap.size(); }
 
     private:
+        void UpdateNextExpireTime(CooldownData const& cd, TimePoint const& now)
+        {
+            if (cd.m_typePermanent)
+                return;
+
+            if (cd.m_expireTime > now && cd.m_expireTime < m_nextExpireTime)
+                m_nextExpireTime = cd.m_expireTime;
+            if (cd.m_category && cd.m_catExpireTime > now && cd.m_catExpireTime < m_nextExpireTime)
+                m_nextExpireTime = cd.m_catExpireTime;
+        }
+
         spellIdMap m_spellIdMap;
         categoryMap m_categoryMap;
+        TimePoint m_nextExpireTime;                         // earliest expire time of a spell or category cooldown
 };
 
 struct Position
@@ -402,7 +431,7 @@ class Object
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
-        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache* cache = nullptr, bool coalesce = false) const;
         void BuildForcedValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
         void BuildMovementUpdateBlock(UpdateData* data, uint16 flags = 0) const;
@@ -584,6 +613,7 @@ class Object
         }
 
         void ClearUpdateMask(bool remove);
+        bool HasCoalescedValues() const { return m_hasCoalescedValues; }
 
         void _LoadIntoDataField(const char* data, uint32 startOffset, uint32 count);
 
@@ -613,7 +643,18 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache = nullptr, bool coalesce = false) const;
+        // true if some changed field of the mask has to be serialized differently for targets of the same visibility class
+        bool HasTargetDependentValues(UpdateMask const& updateMask) const;
+        // fields far observers can get a few ticks late, like power and stand state changes
+        bool IsCoalescableValue(uint16 index) const;
+        // unsets the coalescable fields of the mask, false if nothing is left to send
+        bool RemoveCoalescableValues(UpdateMask& updateMask) const;
+
+    public:
+        static ValuesUpdateCacheStats& GetValuesUpdateCacheStats();
+
+    protected:
 
         uint16 m_objectType;
 
@@ -633,6 +674,10 @@ class Object
 
         bool m_objectUpdated;
 
+        UpdateMask m_coalescedValues;                       // changed fields held back from far observers
+        uint32 m_coalescedSince;
+        bool m_hasCoalescedValues;
+
     private:
         bool m_inWorld;
         bool m_itsNewObject;
@@ -1217,6 +1262,7 @@ class WorldObject : public Object
 
     private:
         Map* m_currMap;                                     // current object's Map location
+        mutable TerrainCache::AreaHint m_areaHint;          // last zone and area result of the position
 
         uint32 m_mapId;                                     // object at map with map_id
         uint32 m_InstanceId;                                // in map copy with instance id
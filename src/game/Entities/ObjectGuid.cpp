@@ -74,6 +74,87 @@ uint32 ObjectGuidGenerator<high>::Generate()
     return m_nextGuid++;
 }
 
+template<HighGuid high>
+uint32 ObjectGuidGenerator<high>::GenerateBlock(uint32 count)
+{
+    uint32 first = m_nextGuid.fetch_add(count);
+    if (first >= ObjectGuid::GetMaxCounter(high) - count)
+    {
+        sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
+        World::StopNow(ERROR_EXIT_CODE);
+    }
+    return first;
+}
+
+namespace
+{
+    // guids a thread takes from a leased generator at once
+    uint32 const GUID_LEASE_SIZE = 16;
+    // thread leases kept, by generator id; a generator mapping to a taken slot only drops the rest of that lease
+    uint32 const GUID_LEASE_SLOTS = 64;
+    // freed guids kept per generator, the later ones are dropped
+    size_t const GUID_FREED_LIMIT = 1 << 18;
+
+    struct GuidLease
+    {
+        uint32 generatorId;
+        uint32 next;
+        uint32 end;
+    };
+
+    thread_local GuidLease t_guidLeases[GUID_LEASE_SLOTS] = {};
+
+    std::atomic<uint32> s_nextLeasedGeneratorId(1);
+}
+
+template<HighGuid high>
+LeasedObjectGuidGenerator<high>::LeasedObjectGuidGenerator(uint32 start) : m_generator(start),
+    m_id(s_nextLeasedGeneratorId++), m_recycleFrom(ObjectGuid::GetMaxCounter(high) - ObjectGuid::GetMaxCounter(high) / 4)
+{
+}
+
+template<HighGuid high>
+void LeasedObjectGuidGenerator<high>::Set(uint32 val)
+{
+    m_generator.Set(val);
+    m_id = s_nextLeasedGeneratorId++;                       // leases taken before are of the old counter
+
+    std::lock_guard<std::mutex> guard(m_freedLock);
+    m_freed.clear();
+}
+
+template<HighGuid high>
+uint32 LeasedObjectGuidGenerator<high>::Generate()
+{
+    if (m_generator.GetNextAfterMaxUsed() >= m_recycleFrom)
+    {
+        std::lock_guard<std::mutex> guard(m_freedLock);
+        if (!m_freed.empty())
+        {
+            uint32 guid = m_freed.front();
+            m_freed.pop_front();
+            return guid;
+        }
+    }
+
+    GuidLease& lease = t_guidLeases[m_id % GUID_LEASE_SLOTS];
+    if (lease.generatorId != m_id || lease.next == lease.end)
+    {
+        lease.generatorId = m_id;
+        lease.next = m_generator.GenerateBlock(GUID_LEASE_SIZE);
+        lease.end = lease.next + GUID_LEASE_SIZE;
+    }
+    return lease.next++;
+}
+
+template<HighGuid high>
+void LeasedObjectGuidGenerator<high>::Release(uint32 guid)
+{
+    std::lock_guard<std::mutex> guard(m_freedLock);
+    if (m_freed.size() < GUID_FREED_LIMIT)
+        m_freed.push_back(guid);
+}
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
 {
     buf << uint64(guid.GetRawValue());
@@ -109,3 +190,17 @@ template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_CORPSE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_INSTANCE>::Generate();
 template uint32 ObjectGuidGenerator<HIGHGUID_GROUP>::Generate();
+
+template uint32 ObjectGuidGenerator<HIGHGUID_ITEM>::GenerateBlock(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_GAMEOBJECT>::GenerateBlock(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_UNIT>::GenerateBlock(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_PET>::GenerateBlock(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_VEHICLE>::GenerateBlock(uint32 count);
+template uint32 ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>::GenerateBlock(uint32 count);
+
+template class LeasedObjectGuidGenerator<HIGHGUID_ITEM>;
+template class LeasedObjectGuidGenerator<HIGHGUID_GAMEOBJECT>;
+template class LeasedObjectGuidGenerator<HIGHGUID_UNIT>;
+template class LeasedObjectGuidGenerator<HIGHGUID_PET>;
+template class LeasedObjectGuidGenerator<HIGHGUID_VEHICLE>;
+template class LeasedObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT>;
@@ -22,6 +22,8 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 #include <atomic>
+#include <deque>
+#include <mutex>
 
 enum TypeID
 {
@@ -242,6 +244,7 @@ class ObjectGuidGenerator
     public:                                                 // modifiers
         void Set(uint32 val) { m_nextGuid = val; }
         uint32 Generate();
+        uint32 GenerateBlock(uint32 count);                 // first of count consecutive guids
 
     public:                                                 // accessors
         uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
@@ -250,6 +253,37 @@ class ObjectGuidGenerator
         std::atomic<uint32> m_nextGuid;
 };
 
+/**
+ * Generator for guids handed out from many threads at once. Each thread takes small blocks of the
+ * shared counter and generates from its own block, so the counter is touched once per block.
+ *
+ * Guids given back with Release are reused once the counter has used up three quarters of its range,
+ * the oldest first, so a freed guid is only seen again long after its object is gone.
+ * Only guids of objects nothing persists may be released.
+ */
+template<HighGuid high>
+class LeasedObjectGuidGenerator
+{
+    public:                                                 // constructors
+        explicit LeasedObjectGuidGenerator(uint32 start = 1);
+
+    public:                                                 // modifiers
+        void Set(uint32 val);
+        uint32 Generate();
+        void Release(uint32 guid);
+
+    public:                                                 // accessors
+        uint32 GetNextAfterMaxUsed() const { return m_generator.GetNextAfterMaxUsed(); }
+
+    private:                                                // fields
+        ObjectGuidGenerator<high> m_generator;
+        uint32 m_id;                                        // of the thread leases of the current counter
+        uint32 m_recycleFrom;
+
+        std::mutex m_freedLock;
+        std::deque<uint32> m_freed;
+};
+
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
 ByteBuffer& operator>> (ByteBuffer& buf, ObjectGuid&       guid);
 
@@ -182,4 +182,50 @@ float VisibilityData::GetStealthVisibilityDistance(Unit const* target, bool aler
         visibilityRange += (visibilityRange * 0.08f) + 1.5f;
 
     return std::max(target->GetCombatReach(), visibilityRange);
-}
\ No newline at end of file
+}
+
+StealthDetectionCache::Key::Key(WorldObject const* target, WorldObject const* viewPoint, float distance) :
+    targetX(int32(std::floor(target->GetPositionX() / STEALTH_DETECTION_BUCKET_SIZE))),
+    targetY(int32(std::floor(target->GetPositionY() / STEALTH_DETECTION_BUCKET_SIZE))),
+    targetZ(int32(std::floor(target->GetPositionZ() / STEALTH_DETECTION_BUCKET_SIZE))),
+    viewX(int32(std::floor(viewPoint->GetPositionX() / STEALTH_DETECTION_BUCKET_SIZE))),
+    viewY(int32(std::floor(viewPoint->GetPositionY() / STEALTH_DETECTION_BUCKET_SIZE))),
+    viewZ(int32(std::floor(viewPoint->GetPositionZ() / STEALTH_DETECTION_BUCKET_SIZE))),
+    detectDistance(distance)
+{
+}
+
+bool StealthDetectionCache::Find(ObjectGuid target, ObjectGuid observer, Key const& key, bool& visible)
+{
+    Shard& shard = GetShard(target, observer);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto itr = shard.entries.find(std::make_pair(target, observer));
+    if (itr == shard.entries.end() || !(itr->second.key == key))
+        return false;
+
+    visible = itr->second.visible;
+    return true;
+}
+
+void StealthDetectionCache::Store(ObjectGuid target, ObjectGuid observer, Key const& key, bool visible)
+{
+    Shard& shard = GetShard(target, observer);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    // a bucket crossing or a changed detection distance replaces the result
+    auto itr = shard.entries.find(std::make_pair(target, observer));
+    if (itr != shard.entries.end())
+        itr->second = Entry{ key, visible };
+    else
+        shard.entries.emplace(std::make_pair(target, observer), Entry{ key, visible });
+}
+
+void StealthDetectionCache::Clear()
+{
+    for (Shard& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.entries.clear();
+    }
+}
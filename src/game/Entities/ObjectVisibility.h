@@ -20,6 +20,9 @@
 #define __OBJECT_VISIBILITY_H
 
 #include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <mutex>
 
 class WorldObject;
 class Unit;
@@ -97,4 +100,67 @@ class VisibilityData
         WorldObject* m_owner;
 };
 
+#define STEALTH_DETECTION_BUCKET_SIZE   1.0f                // yards, positions in the same bucket share a result
+#define STEALTH_DETECTION_CACHE_SHARDS  16
+
+/**
+ * Results of the stealth distance and line of sight checks of a map, per stealthed unit and observer.
+ * A result is reused while both stay in the same position bucket and the detection distance, which covers
+ * the stealth and detection strengths and levels, is unchanged. So a stealthed unit among idle observers is
+ * not traced again on each visibility update. Facing is not cached, it is checked before.
+ *
+ * Used from the cell threads too, the pairs are spread over locked shards. The map clears it now and then.
+ */
+class StealthDetectionCache
+{
+    public:
+        struct Key
+        {
+            int32 targetX, targetY, targetZ;
+            int32 viewX, viewY, viewZ;
+            float detectDistance;                           // negative if the observer detects any stealth
+
+            Key(WorldObject const* target, WorldObject const* viewPoint, float distance);
+
+            bool operator==(Key const& other) const
+            {
+                return targetX == other.targetX && targetY == other.targetY && targetZ == other.targetZ &&
+                       viewX == other.viewX && viewY == other.viewY && viewZ == other.viewZ && detectDistance == other.detectDistance;
+            }
+        };
+
+        // false if the pair has no result for the key
+        bool Find(ObjectGuid target, ObjectGuid observer, Key const& key, bool& visible);
+        void Store(ObjectGuid target, ObjectGuid observer, Key const& key, bool visible);
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            Key key;
+            bool visible;
+        };
+
+        struct PairHash
+        {
+            size_t operator()(std::pair<ObjectGuid, ObjectGuid> const& pair) const
+            {
+                return std::hash<uint64>()((pair.first.GetRawValue() * 0x9E3779B97F4A7C15ULL) ^ pair.second.GetRawValue());
+            }
+        };
+
+        struct Shard
+        {
+            std::mutex lock;
+            std::unordered_map<std::pair<ObjectGuid, ObjectGuid>, Entry, PairHash> entries;
+        };
+
+        Shard& GetShard(ObjectGuid target, ObjectGuid observer)
+        {
+            return m_shards[(target.GetCounter() ^ observer.GetCounter()) % STEALTH_DETECTION_CACHE_SHARDS];
+        }
+
+        Shard m_shards[STEALTH_DETECTION_CACHE_SHARDS];
+};
+
 #endif
\ No newline at end of file
@@ -32,7 +32,8 @@ Pet::Pet(PetType type) :
     m_resetTalentsCost(0), m_resetTalentsTime(0), m_usedTalentCount(0),
     m_removed(false), m_happinessTimer(7500), m_petType(type), m_duration(0),
     m_loading(false),
-    m_declinedname(nullptr), m_petModeFlags(PET_MODE_DEFAULT), m_originalCharminfo(nullptr), m_inStatsUpdate(false)
+    m_declinedname(nullptr), m_rowInDB(false), m_aurasInDB(true), m_cooldownsInDB(true), m_keepStoredAuras(false), m_auraSaveTime(0),
+    m_petModeFlags(PET_MODE_DEFAULT), m_originalCharminfo(nullptr), m_inStatsUpdate(false)
 {
     m_name = "Pet";
     m_regenTimer = 4000;
@@ -312,6 +313,25 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry /*= 0*/, uint32 petnumber
     m_resetTalentsCost = fields[15].GetUInt32();
     m_resetTalentsTime = fields[16].GetUInt64();
 
+    m_savedRow.entry = petentry;
+    m_savedRow.modelId = fields[3].GetUInt32();
+    m_savedRow.level = petlevel;
+    m_savedRow.exp = fields[5].GetUInt32();
+    m_savedRow.reactState = fields[6].GetUInt32();
+    m_savedRow.slot = fields[7].GetUInt32();
+    m_savedRow.name = fields[8].GetCppString();
+    m_savedRow.renamed = fields[9].GetBool();
+    m_savedRow.health = savedhealth;
+    m_savedRow.power = savedpower;
+    m_savedRow.happiness = fields[12].GetUInt32();
+    m_savedRow.actionBar = fields[13].GetCppString();
+    m_savedRow.resetTalentsCost = m_resetTalentsCost;
+    m_savedRow.resetTalentsTime = uint64(m_resetTalentsTime);
+    m_savedRow.createdBySpell = summon_spell_id;
+    m_savedRow.petType = uint32(pet_type);
+    m_rowInDB = true;
+    m_auraSaveTime = fields[14].GetUInt64();
+
     // load spells/cooldowns/auras
     _LoadAuras(timediff);
 
@@ -390,6 +410,8 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry /*= 0*/, uint32 petnumber
 
     SynchronizeLevelWithOwner();
 
+    // only the slot or the clamped values may differ from the DB here, the arena auras are the exception
+    m_keepStoredAuras = !map->IsBattleArena();
     SavePetToDB(PET_SAVE_AS_CURRENT, owner);
 
     if (owner)
@@ -407,6 +429,9 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry /*= 0*/, uint32 petnumber
 
 void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
 {
+    bool keepStoredAuras = m_keepStoredAuras;
+    m_keepStoredAuras = false;
+
     if (!GetEntry())
         return;
 
@@ -449,14 +474,64 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
         else
         {
             if (getPetType() != HUNTER_PET)
+            {
                 RemoveAllAuras();
+                keepStoredAuras = false;
+            }
         }
 
+        PetSavedRow row;
+        row.entry = GetEntry();
+        row.modelId = GetNativeDisplayId();
+        row.level = getLevel();
+        row.exp = GetUInt32Value(UNIT_FIELD_PETEXPERIENCE);
+        row.reactState = uint32(AI()->GetReactState());
+        row.slot = uint32(mode);
+        row.name = m_name;
+        row.renamed = !HasByteFlag(UNIT_FIELD_BYTES_2, 2, UNIT_CAN_BE_RENAMED);
+        row.health = curhealth;
+        row.power = curpower;
+        row.happiness = GetPower(POWER_HAPPINESS);
+
+        std::ostringstream ss;
+        for (uint32 i = ACTION_BAR_INDEX_START; i < ACTION_BAR_INDEX_END; ++i)
+        {
+            ss << uint32(m_charmInfo->GetActionBarEntry(i)->GetType()) << " "
+               << uint32(m_charmInfo->GetActionBarEntry(i)->GetAction()) << " ";
+        }
+        row.actionBar = ss.str();
+
+        row.resetTalentsCost = m_resetTalentsCost;
+        row.resetTalentsTime = uint64(m_resetTalentsTime);
+        row.createdBySpell = GetUInt32Value(UNIT_CREATED_BY_SPELL);
+        row.petType = uint32(getPetType());
+
         // save pet's data as one single transaction
         CharacterDatabase.BeginTransaction();
         _SaveSpells();
-        _SaveSpellCooldowns();
-        _SaveAuras();
+
+        bool aurasWritten = false;
+        if (!keepStoredAuras)
+        {
+            _SaveSpellCooldowns();
+            aurasWritten = _SaveAuras();
+        }
+
+        // the stored aura durations count from savetime, it only moves with them
+        if (aurasWritten || !m_aurasInDB)
+            m_auraSaveTime = uint64(time(nullptr));
+
+        if (m_rowInDB && !aurasWritten && row == m_savedRow)
+        {
+            // an unchanged pet does not queue an empty transaction
+            size_t statements, bytes;
+            CharacterDatabase.GetTransactionStats(statements, bytes);
+            if (statements)
+                CharacterDatabase.CommitTransaction();
+            else
+                CharacterDatabase.RollbackTransaction();
+            return;
+        }
 
         uint32 ownerLow = GetOwnerGuid().GetCounter();
         // remove current data
@@ -490,40 +565,36 @@ void Pet::SavePetToDB(PetSaveMode mode, Player* owner)
                                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
 
         savePet.addUInt32(m_charmInfo->GetPetNumber());
-        savePet.addUInt32(GetEntry());
+        savePet.addUInt32(row.entry);
         savePet.addUInt32(ownerLow);
-        savePet.addUInt32(GetNativeDisplayId());
-        savePet.addUInt32(getLevel());
-        savePet.addUInt32(GetUInt32Value(UNIT_FIELD_PETEXPERIENCE));
-        savePet.addUInt32(uint32(AI()->GetReactState()));
-        savePet.addUInt32(uint32(mode));
-        savePet.addString(m_name);
-        savePet.addUInt32(uint32(HasByteFlag(UNIT_FIELD_BYTES_2, 2, UNIT_CAN_BE_RENAMED) ? 0 : 1));
-        savePet.addUInt32(curhealth);
-        savePet.addUInt32(curpower);
-        savePet.addUInt32(GetPower(POWER_HAPPINESS));
-
-        std::ostringstream ss;
-        for (uint32 i = ACTION_BAR_INDEX_START; i < ACTION_BAR_INDEX_END; ++i)
-        {
-            ss << uint32(m_charmInfo->GetActionBarEntry(i)->GetType()) << " "
-               << uint32(m_charmInfo->GetActionBarEntry(i)->GetAction()) << " ";
-        }
-        savePet.addString(ss);
-
-        savePet.addUInt64(uint64(time(nullptr)));
-        savePet.addUInt32(uint32(m_resetTalentsCost));
-        savePet.addUInt64(uint64(m_resetTalentsTime));
-        savePet.addUInt32(GetUInt32Value(UNIT_CREATED_BY_SPELL));
-        savePet.addUInt32(uint32(getPetType()));
+        savePet.addUInt32(row.modelId);
+        savePet.addUInt32(row.level);
+        savePet.addUInt32(row.exp);
+        savePet.addUInt32(row.reactState);
+        savePet.addUInt32(row.slot);
+        savePet.addString(row.name);
+        savePet.addUInt32(uint32(row.renamed ? 1 : 0));
+        savePet.addUInt32(row.health);
+        savePet.addUInt32(row.power);
+        savePet.addUInt32(row.happiness);
+        savePet.addString(row.actionBar);
+        savePet.addUInt64(m_auraSaveTime);
+        savePet.addUInt32(row.resetTalentsCost);
+        savePet.addUInt64(row.resetTalentsTime);
+        savePet.addUInt32(row.createdBySpell);
+        savePet.addUInt32(row.petType);
 
         savePet.Execute();
         CharacterDatabase.CommitTransaction();
+
+        m_savedRow = row;
+        m_rowInDB = true;
     }
     else
     {
         RemoveAllAuras(AURA_REMOVE_BY_DELETE);
         DeleteFromDB(m_charmInfo->GetPetNumber());
+        m_rowInDB = false;
     }
 }
 
@@ -1298,8 +1369,8 @@ uint32 Pet::GetCurrentFoodBenefitLevel(uint32 itemlevel) const
 void Pet::_LoadSpellCooldowns()
 {
     QueryResult* result = CharacterDatabase.PQuery("SELECT spell,time FROM pet_spell_cooldown WHERE guid = '%u'", m_charmInfo->GetPetNumber());
-    ByteBuffer cdData;
-    uint32 cdCount = 0;
+
+    m_cooldownsInDB = result != nullptr;
 
     if (result)
     {
@@ -1327,10 +1398,6 @@ void Pet::_LoadSpellCooldowns()
             if (spellRecTime == std::chrono::milliseconds::zero())
                 continue;
 
-            cdData << uint32(spell_id);
-            cdData << uint32(uint32(spellRecTime.count()));
-            ++cdCount;
-
             m_cooldownMap.AddCooldown(GetMap()->GetCurrentClockTime(), spell_id, uint32(spellRecTime.count()));
 #ifdef _DEBUG
             uint32 spellCDDuration = std::chrono::duration_cast<std::chrono::seconds>(spellRecTime).count();
@@ -1341,14 +1408,9 @@ void Pet::_LoadSpellCooldowns()
 
         delete result;
 
-        if (cdCount && GetOwner() && GetOwner()->GetTypeId() == TYPEID_PLAYER)
-        {
-            WorldPacket data(SMSG_SPELL_COOLDOWN, 8 + 1 + cdData.size());
-            data << GetObjectGuid();
-            data << uint8(0x0);                                     // flags (0x1, 0x2)
-            data.append(cdData);
+        WorldPacket data;
+        if (GetOwner() && GetOwner()->GetTypeId() == TYPEID_PLAYER && m_cooldownMap.BuildSpellCooldownPacket(data, GetObjectGuid(), GetMap()->GetCurrentClockTime()))
             static_cast<Player*>(GetOwner())->GetSession()->SendPacket(data);
-        }
     }
 }
 
@@ -1357,9 +1419,15 @@ void Pet::_SaveSpellCooldowns()
     static SqlStatementID delSpellCD ;
     static SqlStatementID insSpellCD ;
 
+    // nothing stored and nothing to store
+    if (!m_cooldownsInDB && m_cooldownMap.IsEmpty())
+        return;
+
     SqlStatement stmt = CharacterDatabase.CreateStatement(delSpellCD, "DELETE FROM pet_spell_cooldown WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
+    m_cooldownsInDB = false;
+
     TimePoint currTime = GetMap()->GetCurrentClockTime();
 
     for (auto& cdItr : m_cooldownMap)
@@ -1373,6 +1441,8 @@ void Pet::_SaveSpellCooldowns()
 
             stmt = CharacterDatabase.CreateStatement(insSpellCD, "INSERT INTO pet_spell_cooldown (guid,spell,time) VALUES (?, ?, ?)");
             stmt.PExecute(m_charmInfo->GetPetNumber(), cdItr.first, spellExpireTime);
+
+            m_cooldownsInDB = true;
         }
     }
 }
@@ -1446,6 +1516,8 @@ void Pet::_LoadAuras(uint32 timediff)
 
     QueryResult* result = CharacterDatabase.PQuery("SELECT caster_guid,item_guid,spell,stackcount,remaincharges,basepoints0,basepoints1,basepoints2,periodictime0,periodictime1,periodictime2,maxduration,remaintime,effIndexMask FROM pet_aura WHERE guid = '%u'", m_charmInfo->GetPetNumber());
 
+    m_aurasInDB = result != nullptr;
+
     if (result)
     {
         do
@@ -1539,18 +1611,24 @@ void Pet::_LoadAuras(uint32 timediff)
     }
 }
 
-void Pet::_SaveAuras()
+bool Pet::_SaveAuras()
 {
     static SqlStatementID delAuras ;
     static SqlStatementID insAuras ;
 
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+
+    // nothing stored and nothing to store, passive and channeled holders are never saved
+    if (!m_aurasInDB && std::none_of(auraHolders.begin(), auraHolders.end(), [](SpellAuraHolderMap::value_type const& holder) { return holder.second->IsSaveToDbHolder(); }))
+        return false;
+
     SqlStatement stmt = CharacterDatabase.CreateStatement(delAuras, "DELETE FROM pet_aura WHERE guid = ?");
     stmt.PExecute(m_charmInfo->GetPetNumber());
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+    m_aurasInDB = false;
 
     if (auraHolders.empty())
-        return;
+        return false;
 
     stmt = CharacterDatabase.CreateStatement(insAuras, "INSERT INTO pet_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
             "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
@@ -1618,8 +1696,12 @@ void Pet::_SaveAuras()
             stmt.addInt32(holder->GetAuraDuration());
             stmt.addUInt32(effIndexMask);
             stmt.Execute();
+
+            m_aurasInDB = true;
         }
     }
+
+    return m_aurasInDB;
 }
 
 bool Pet::addSpell(uint32 spell_id, ActiveStates active /*= ACT_DECIDE*/, PetSpellState state /*= PETSPELL_NEW*/, PetSpellType type /*= PETSPELL_NORMAL*/)
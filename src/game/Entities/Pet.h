@@ -23,6 +23,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Creature.h"
 #include "Entities/Unit.h"
+#include "Maps/SummonPool.h"
 
 enum PetType
 {
@@ -134,6 +135,36 @@ typedef std::vector<uint32> AutoSpellList;
 
 #define ACTIVE_SPELLS_MAX           4
 
+// character_pet row without savetime, as last stored
+struct PetSavedRow
+{
+    uint32 entry;
+    uint32 modelId;
+    uint32 level;
+    uint32 exp;
+    uint32 reactState;
+    uint32 slot;
+    std::string name;
+    bool renamed;
+    uint32 health;
+    uint32 power;
+    uint32 happiness;
+    std::string actionBar;
+    uint32 resetTalentsCost;
+    uint64 resetTalentsTime;
+    uint32 createdBySpell;
+    uint32 petType;
+
+    bool operator==(PetSavedRow const& other) const
+    {
+        return entry == other.entry && modelId == other.modelId && level == other.level && exp == other.exp &&
+               reactState == other.reactState && slot == other.slot && name == other.name && renamed == other.renamed &&
+               health == other.health && power == other.power && happiness == other.happiness && actionBar == other.actionBar &&
+               resetTalentsCost == other.resetTalentsCost && resetTalentsTime == other.resetTalentsTime &&
+               createdBySpell == other.createdBySpell && petType == other.petType;
+    }
+};
+
 class Player;
 
 class Pet : public Creature
@@ -142,6 +173,8 @@ class Pet : public Creature
         explicit Pet(PetType type = MAX_PET_TYPE);
         virtual ~Pet();
 
+        SUMMON_POOL_OPERATORS
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -226,7 +259,7 @@ class Pet : public Creature
         void _LoadSpellCooldowns();
         void _SaveSpellCooldowns();
         void _LoadAuras(uint32 timediff);
-        void _SaveAuras();
+        bool _SaveAuras();                                  // true if pet_aura rows were written
         void _LoadSpells();
         void _SaveSpells();
 
@@ -289,6 +322,14 @@ class Pet : public Creature
 
         DeclinedName* m_declinedname;
 
+        // parts of the save skipped while their DB state is known to be current
+        PetSavedRow m_savedRow;
+        bool    m_rowInDB;                                  // m_savedRow is the stored character_pet row
+        bool    m_aurasInDB;                                // pet_aura may hold rows for this pet
+        bool    m_cooldownsInDB;                            // pet_spell_cooldown may hold rows for this pet
+        bool    m_keepStoredAuras;                          // auras and cooldowns were just loaded, the next save leaves them
+        uint64  m_auraSaveTime;                             // savetime the stored pet_aura remaintime counts from
+
     private:
         PetModeFlags m_petModeFlags;
         CharmInfo*   m_originalCharminfo;
@@ -68,6 +68,7 @@
 #include "Loot/LootMgr.h"
 #include "World/WorldStateDefines.h"
 #include "World/WorldState.h"
+#include "Globals/CharacterCache.h"
 
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotAI.h"
@@ -80,6 +81,10 @@
 #include "PlayerbotAIConfig.h"
 #endif
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
 #include <cmath>
 
 #define ZONE_UPDATE_INTERVAL (1*IN_MILLISECONDS)
@@ -513,6 +518,9 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_usedTalentCount = 0;
     m_questRewardTalentCount = 0;
 
+    m_dialogStatusCacheVersion = 0;
+    m_dialogStatusCacheTime = 0;
+
     m_regenTimer = 0;
     m_weaponChangeTimer = 0;
 
@@ -537,6 +545,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     // group is initialized in the reference constructor
     SetGroupInvite(nullptr);
     m_groupUpdateMask = 0;
+    m_groupUpdateTimer = 0;
 
     duel = nullptr;
 
@@ -566,6 +575,10 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     m_DailyQuestChanged = false;
     m_WeeklyQuestChanged = false;
 
+    m_aurasInDB = true;
+    m_cooldownsInDB = true;
+    m_enteredInstancesChanged = false;
+
     m_lastLiquid = nullptr;
 
     m_drunkTimer = 0;
@@ -1466,26 +1479,24 @@ void Player::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 
+    // nothing iterates the spell mods here, drop the holes left by removed auras
+    for (AuraList& spellMods : m_spellMods)
+        spellMods.Compact();
+
     // Remove failed timed Achievements
     GetAchievementMgr().DoFailedTimedAchievementCriterias();
 
+    // reputation gained since the last update, e.g. by the kills of an aoe pull
+    m_reputationMgr.SendPendingStates();
+
     // Update ticket squelch timer
     if (WorldSession* session = GetSession())
         session->m_ticketSquelchTimer.Update(diff);
 
-    // Undelivered mail
-    if (m_nextMailDelivereTime && m_nextMailDelivereTime <= time(nullptr))
-    {
-        SendNewMail();
-        ++unReadMails;
-
-        // It will be recalculate at mailbox open (for unReadMails important non-0 until mailbox open, it also will be recalculated)
-        m_nextMailDelivereTime = 0;
-    }
-
     // Update cinematic location
     if (m_cinematicMgr)
     {
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_CINEMATIC);
         m_cinematicMgr->m_cinematicDiff += diff;
         // update only if CINEMATIC_UPDATEDIFF have passed
         if (WorldTimer::getMSTimeDiff(m_cinematicMgr->m_lastCinematicCheck, WorldTimer::getMSTime()) > CINEMATIC_UPDATEDIFF)
@@ -1505,43 +1516,27 @@ void Player::Update(const uint32 diff)
 
     time_t now = time(nullptr);
 
-    UpdatePvPFlagTimer(diff);
-
-    UpdatePvPContestedFlagTimer(diff);
+    // the parts on a coarse interval, most ticks none of them is due
+    if (m_updateSchedule.Advance(diff))
+        UpdateScheduled(now);
 
-    UpdateDuelFlag(now);
-
-    CheckDuelDistance(now);
-
-    UpdateAfkReport(now);
+    if (duel)
+    {
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_DUEL);
+        UpdateDuelFlag(now);
+        CheckDuelDistance(now);
+    }
 
     // Update items that have just a limited lifetime
     if (now > m_Last_tick)
-        UpdateItemDuration(uint32(now - m_Last_tick));
-
-    if (!m_timedquests.empty())
     {
-        QuestSet::iterator iter = m_timedquests.begin();
-        while (iter != m_timedquests.end())
-        {
-            QuestStatusData& q_status = mQuestStatus[*iter];
-            if (q_status.m_timer <= diff)
-            {
-                uint32 quest_id  = *iter;
-                ++iter;                                     // Current iter will be removed in FailQuest
-                FailQuest(quest_id);
-            }
-            else
-            {
-                q_status.m_timer -= diff;
-                if (q_status.uState != QUEST_NEW) q_status.uState = QUEST_CHANGED;
-                ++iter;
-            }
-        }
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_ITEM_DURATION);
+        UpdateItemDuration(uint32(now - m_Last_tick));
     }
 
     if (hasUnitState(UNIT_STAT_MELEE_ATTACKING))
     {
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_MELEE_STATE);
         UpdateMeleeAttackingState();
 
         Unit* pVictim = GetVictim();
@@ -1556,19 +1551,6 @@ void Player::Update(const uint32 diff)
         }
     }
 
-    if (HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING))
-    {
-        if (GetTimeInnEnter() > 0)                          // Freeze update
-        {
-            time_t time_inn = now - GetTimeInnEnter();
-            if (time_inn >= 10)                             // Freeze update
-            {
-                SetRestBonus(GetRestBonus() + ComputeRest(time_inn));
-                UpdateInnerTime(now);
-            }
-        }
-    }
-
     if (m_regenTimer)
     {
         if (diff >= m_regenTimer)
@@ -1597,6 +1579,7 @@ void Player::Update(const uint32 diff)
     {
         if (diff >= m_zoneUpdateTimer)
         {
+            m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_ZONE);
             uint32 newzone, newarea;
             GetZoneAndAreaId(newzone, newarea);
 
@@ -1623,7 +1606,10 @@ void Player::Update(const uint32 diff)
             SetFlag(UNIT_FIELD_FLAGS_2, UNIT_FLAG2_REGENERATE_POWER);
 
         if (m_regenTimer == 0)
+        {
+            m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_REGEN);
             RegenerateAll();
+        }
     }
 
     if (m_deathState == JUST_DIED)
@@ -1634,6 +1620,7 @@ void Player::Update(const uint32 diff)
         if (diff >= m_nextSave)
         {
             // m_nextSave reseted in SaveToDB call
+            m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_SAVE);
             SaveToDB();
             DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
         }
@@ -1646,6 +1633,7 @@ void Player::Update(const uint32 diff)
     {
         if (diff >= m_DetectInvTimer)
         {
+            m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_STEALTH_DETECTION);
 #ifdef ENABLE_PLAYERBOTS
             if (!this->GetPlayerbotAI() || GetPlayerbotAI()->AllowActivity())
                 HandleStealthedUnitsDetection();
@@ -1672,7 +1660,10 @@ void Player::Update(const uint32 diff)
         m_drunkTimer += diff;
 
         if (m_drunkTimer > 9 * IN_MILLISECONDS)
+        {
+            m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_SOBERING);
             HandleSobering();
+        }
     }
 
     // Not auto-free ghost from body in instances; also check for resurrection prevention
@@ -1688,19 +1679,24 @@ void Player::Update(const uint32 diff)
             m_deathTimer -= diff;
     }
 
-    UpdateEnchantTime(diff);
-    UpdateHomebindTime(diff);
-
     if (m_createdInstanceClearTimer < diff)
     {
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_INSTANCE_IDS);
         m_createdInstanceClearTimer = MINUTE * IN_MILLISECONDS;
         UpdateNewInstanceIdTimers(std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now()));
     }
     else
         m_createdInstanceClearTimer -= diff;
 
-    // Group update
-    SendUpdateToOutOfRangeGroupMembers();
+    // Group update, the changes of the interval go out in one packet per member
+    if (m_groupUpdateTimer <= diff)
+    {
+        m_groupUpdateTimer = sWorld.getConfig(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL);
+        m_updateSchedule.SetRan(PLAYER_SUB_UPDATE_GROUP);
+        SendUpdateToOutOfRangeGroupMembers();
+    }
+    else
+        m_groupUpdateTimer -= diff;
 
     Pet* pet = GetPet();
     if (pet && !pet->IsWithinDistInMap(this, GetMap()->GetVisibilityDistance()) && (GetCharmGuid() && (pet->GetObjectGuid() != GetCharmGuid())))
@@ -1727,6 +1723,72 @@ void Player::Update(const uint32 diff)
     else if (m_playerbotMgr)
         m_playerbotMgr->UpdateAI(diff);
 #endif
+
+    sWorld.GetPlayerUpdateStats().AddUpdate(m_updateSchedule.TakeRanMask());
+}
+
+void Player::UpdateScheduled(time_t now)
+{
+    uint32 elapsed;
+
+    // Undelivered mail
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_MAIL) && m_nextMailDelivereTime && m_nextMailDelivereTime <= now)
+    {
+        SendNewMail();
+        ++unReadMails;
+
+        // It will be recalculate at mailbox open (for unReadMails important non-0 until mailbox open, it also will be recalculated)
+        m_nextMailDelivereTime = 0;
+    }
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_PVP_FLAG, elapsed))
+    {
+        UpdatePvPFlagTimer(elapsed);
+        UpdatePvPContestedFlagTimer(elapsed);
+    }
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_AFK_REPORT))
+        UpdateAfkReport(now);
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_TIMED_QUESTS, elapsed) && !m_timedquests.empty())
+    {
+        QuestSet::iterator iter = m_timedquests.begin();
+        while (iter != m_timedquests.end())
+        {
+            QuestStatusData& q_status = mQuestStatus[*iter];
+            if (q_status.m_timer <= elapsed)
+            {
+                uint32 quest_id  = *iter;
+                ++iter;                                     // Current iter will be removed in FailQuest
+                FailQuest(quest_id);
+            }
+            else
+            {
+                q_status.m_timer -= elapsed;
+                if (q_status.uState != QUEST_NEW) q_status.uState = QUEST_CHANGED;
+                ++iter;
+            }
+        }
+    }
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_REST) && HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING))
+    {
+        if (GetTimeInnEnter() > 0)                          // Freeze update
+        {
+            time_t time_inn = now - GetTimeInnEnter();
+            if (time_inn >= 10)                             // Freeze update
+            {
+                SetRestBonus(GetRestBonus() + ComputeRest(time_inn));
+                UpdateInnerTime(now);
+            }
+        }
+    }
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_ENCHANTS, elapsed))
+        UpdateEnchantTime(elapsed);
+
+    if (m_updateSchedule.IsDue(PLAYER_SUB_UPDATE_HOMEBIND, elapsed))
+        UpdateHomebindTime(elapsed);
 }
 
 #ifdef ENABLE_PLAYERBOTS
@@ -2970,6 +3032,7 @@ void Player::GiveLevel(uint32 level)
 #endif
     // resend quests status directly
     GetSession()->SetCurrentPlayerLevel(level);
+    InvalidateDialogStatusCache();
     SendQuestGiverStatusMultiple();
 }
 
@@ -3181,31 +3244,36 @@ void Player::OnExpansionChange()
 
 void Player::SendInitialSpells() const
 {
-    uint16 spellCount = 0;
+    // the spell list is sent again at every map change, kept serialized until the spells change
+    if (m_initialSpellsBlock.empty())
+    {
+        uint16 spellCount = 0;
 
-    WorldPacket data(SMSG_INITIAL_SPELLS, (1 + 2 + 6 * m_spells.size() + 2 + m_cooldownMap.size() * (2 + 2 + 2 + 4 + 4)));
-    data << uint8(0);
+        m_initialSpellsBlock.reserve(2 + 6 * m_spells.size());
+        m_initialSpellsBlock << uint16(spellCount);         // spell count placeholder
 
-    const size_t countPos = data.wpos();
-    data << uint16(spellCount);                             // spell count placeholder
+        for (const auto& m_spell : m_spells)
+        {
+            PlayerSpell const& playerSpell = m_spell.second;
 
-    for (const auto& m_spell : m_spells)
-    {
-        PlayerSpell const& playerSpell = m_spell.second;
+            if (playerSpell.state == PLAYERSPELL_REMOVED)
+                continue;
 
-        if (playerSpell.state == PLAYERSPELL_REMOVED)
-            continue;
+            if (!playerSpell.active || playerSpell.disabled)
+                continue;
 
-        if (!playerSpell.active || playerSpell.disabled)
-            continue;
+            m_initialSpellsBlock << uint32(m_spell.first);
+            m_initialSpellsBlock << uint16(0);              // it's not slot id
 
-        data << uint32(m_spell.first);
-        data << uint16(0);                                  // it's not slot id
+            spellCount += 1;
+        }
 
-        spellCount += 1;
+        m_initialSpellsBlock.put<uint16>(0, spellCount);    // write real count value
     }
 
-    data.put<uint16>(countPos, spellCount);                 // write real count value
+    WorldPacket data(SMSG_INITIAL_SPELLS, (1 + m_initialSpellsBlock.size() + 2 + m_cooldownMap.size() * (2 + 2 + 2 + 4 + 4)));
+    data << uint8(0);
+    data.append(m_initialSpellsBlock);
 
     // write cooldown data
     uint32 cdCount = 0;
@@ -3390,6 +3458,8 @@ static inline bool IsUnlearnSpellsPacketNeededForSpell(uint32 spellId)
 
 bool Player::addSpell(uint32 spell_id, bool active, bool learning, bool dependent, bool disabled)
 {
+    m_initialSpellsBlock.clear();
+
     SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(spell_id);
     if (!spellInfo)
     {
@@ -3781,8 +3851,8 @@ void Player::learnSpell(uint32 spell_id, bool dependent, bool talent)
     // learn all disabled higher ranks (recursive) - skip for talent spells
     if (disabled || talent)
     {
-        SpellChainMapNext const& nextMap = sSpellMgr.GetSpellChainNext();
-        for (SpellChainMapNext::const_iterator i = nextMap.lower_bound(spell_id); i != nextMap.upper_bound(spell_id); ++i)
+        SpellChainMapNext::Bounds bounds = sSpellMgr.GetSpellChainNext().equal_range(spell_id);
+        for (SpellChainMapNext::const_iterator i = bounds.first; i != bounds.second; ++i)
         {
             PlayerSpellMap::iterator iter = m_spells.find(i->second);
             if (iter != m_spells.end() && iter->second.disabled)
@@ -3797,6 +3867,8 @@ void Player::removeSpell(uint32 spell_id, bool disabled, bool learn_low_rank, bo
     if (itr == m_spells.end())
         return;
 
+    m_initialSpellsBlock.clear();
+
 #ifndef ENABLE_PLAYERBOTS
     // Always try to remove all dependent spells if present (needed to reset some talents properly)
     SpellLearnSpellMapBounds spell_bounds = sSpellMgr.GetSpellLearnSpellMapBounds(spell_id);
@@ -3817,8 +3889,8 @@ void Player::removeSpell(uint32 spell_id, bool disabled, bool learn_low_rank, bo
         disabled = false; // talents should never be marked as disabled
 
     // unlearn non talent higher ranks (recursive)
-    SpellChainMapNext const& nextMap = sSpellMgr.GetSpellChainNext();
-    for (SpellChainMapNext::const_iterator itr2 = nextMap.lower_bound(spell_id); itr2 != nextMap.upper_bound(spell_id); ++itr2)
+    SpellChainMapNext::Bounds nextBounds = sSpellMgr.GetSpellChainNext().equal_range(spell_id);
+    for (SpellChainMapNext::const_iterator itr2 = nextBounds.first; itr2 != nextBounds.second; ++itr2)
         if (HasSpell(itr2->second) && !GetTalentSpellPos(itr2->second))
             removeSpell(itr2->second, !IsPassiveSpell(itr2->second), false, sendUpdate);
 
@@ -4041,10 +4113,16 @@ void Player::_SaveSpellCooldowns()
 {
     static SqlStatementID deleteSpellCooldown;
 
+    // nothing stored and nothing to store
+    if (!m_cooldownsInDB && m_cooldownMap.IsEmpty())
+        return;
+
     // delete all old cooldown
     SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
 
+    m_cooldownsInDB = false;
+
     static SqlStatementID insertSpellCooldown;
 
     for (auto& cdItr : m_cooldownMap)
@@ -4067,6 +4145,8 @@ void Player::_SaveSpellCooldowns()
             stmt.addUInt64(catExpireTime);
             stmt.addUInt32(cdData->GetItemId());
             stmt.Execute();
+
+            m_cooldownsInDB = true;
         }
     }
 }
@@ -4100,6 +4180,8 @@ uint32 Player::resetTalentsCost() const
 
 bool Player::resetTalents(bool no_cost, bool all_specs)
 {
+    m_initialSpellsBlock.clear();
+
     // not need after this call
     if (HasAtLoginFlag(AT_LOGIN_RESET_TALENTS) && all_specs)
         RemoveAtLoginFlag(AT_LOGIN_RESET_TALENTS, true);
@@ -4222,11 +4304,32 @@ Mail* Player::GetMail(uint32 id)
     return nullptr;
 }
 
-void Player::SaveItemToInventory(Item* item)
+void Player::SaveItemToInventory(Item* item, ItemSaveBatch* batch /*= nullptr*/)
 {
     Bag* container = item->GetContainer();
     uint32 bag_guid = container ? container->GetGUIDLow() : 0;
 
+    if (batch)
+    {
+        switch (item->GetState())
+        {
+            case ITEM_NEW:
+            case ITEM_CHANGED:
+                batch->AddInventory(GetGUIDLow(), bag_guid, item->GetSlot(), item);
+                break;
+            case ITEM_REMOVED:
+                batch->RemoveInventory(item->GetGUIDLow());
+                break;
+            case ITEM_UNCHANGED:
+                break;
+            default:
+                throw std::domain_error("Unrecognized item state");
+        }
+
+        item->SaveToDB(*batch);
+        return;
+    }
+
     static SqlStatementID insertInventory;
     static SqlStatementID updateInventory;
     static SqlStatementID deleteInventory;
@@ -4757,6 +4860,8 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             sLog.outError("Player::DeleteFromDB: Unsupported delete method: %u.", charDelete_method);
     }
 
+    sCharacterCache.InvalidateCharacter(lowguid);
+
     if (updateRealmChars)
         sWorld.UpdateRealmCharCount(accountId);
 }
@@ -6615,18 +6720,25 @@ void Player::SendInitialActionButtons() const
 {
     DETAIL_LOG("Initializing Action Buttons for '%u' spec '%u'", GetGUIDLow(), m_activeSpec);
 
-    WorldPacket data(SMSG_ACTION_BUTTONS, 1 + (MAX_ACTION_BUTTONS * 4));
-    data << uint8(1);                                       // talent spec amount (in packet)
-    ActionButtonList const& currentActionButtonList = m_actionButtons[m_activeSpec];
-    for (uint8 button = 0; button < MAX_ACTION_BUTTONS; ++button)
+    ByteBuffer& block = m_actionButtonsBlock[m_activeSpec];
+    if (block.empty())
     {
-        ActionButtonList::const_iterator itr = currentActionButtonList.find(button);
-        if (itr != currentActionButtonList.end() && itr->second.uState != ACTIONBUTTON_DELETED)
-            data << uint32(itr->second.packedData);
-        else
-            data << uint32(0);
+        block.reserve(MAX_ACTION_BUTTONS * 4);
+        ActionButtonList const& currentActionButtonList = m_actionButtons[m_activeSpec];
+        for (uint8 button = 0; button < MAX_ACTION_BUTTONS; ++button)
+        {
+            ActionButtonList::const_iterator itr = currentActionButtonList.find(button);
+            if (itr != currentActionButtonList.end() && itr->second.uState != ACTIONBUTTON_DELETED)
+                block << uint32(itr->second.packedData);
+            else
+                block << uint32(0);
+        }
     }
 
+    WorldPacket data(SMSG_ACTION_BUTTONS, 1 + (MAX_ACTION_BUTTONS * 4));
+    data << uint8(1);                                       // talent spec amount (in packet)
+    data.append(block);
+
     GetSession()->SendPacket(data);
     DETAIL_LOG("Action Buttons for '%u' spec '%u' Initialized", GetGUIDLow(), m_activeSpec);
 }
@@ -6739,6 +6851,7 @@ ActionButton* Player::addActionButton(uint8 spec, uint8 button, uint32 action, u
 
     // it create new button (NEW state) if need or return existing
     ActionButton& ab = m_actionButtons[spec][button];
+    m_actionButtonsBlock[spec].clear();
 
     // set data and update to CHANGED if not NEW
     ab.SetActionAndType(action, ActionButtonType(type));
@@ -6758,6 +6871,7 @@ void Player::removeActionButton(uint8 spec, uint8 button)
         currentActionButtonList.erase(buttonItr);           // new and not saved
     else
         buttonItr->second.uState = ACTIONBUTTON_DELETED;    // saved, will deleted at next save
+    m_actionButtonsBlock[spec].clear();
 
     DETAIL_LOG("Action Button '%u' Removed from Player '%u' for spec %u", button, GetGUIDLow(), spec);
 }
@@ -6911,8 +7025,9 @@ void Player::CheckAreaExploreAndOutdoor()
     if (IsTaxiFlying())
         return;
 
-    bool isOutdoor;
-    uint16 areaFlag = GetTerrain()->GetAreaFlag(GetPositionX(), GetPositionY(), GetPositionZ(), &isOutdoor);
+    TerrainCache::AreaInfo areaInfo = GetMap()->GetTerrainCache().GetAreaInfo(GetPositionX(), GetPositionY(), GetPositionZ());
+    bool isOutdoor = areaInfo.outdoors;
+    uint16 areaFlag = areaInfo.areaFlag;
 
     if (isOutdoor)
     {
@@ -7827,6 +7942,9 @@ void Player::_ApplyItemMods(Item* item, uint8 slot, bool apply)
 
     DETAIL_LOG("applying mods for item %u ", item->GetGUIDLow());
 
+    // an item touches up to ten stats and ratings, recalculate each of them once
+    DeferStatUpdates();
+
     uint32 attacktype = Player::GetAttackBySlot(slot);
     if (attacktype < MAX_ATTACK)
         _ApplyWeaponDependentAuraMods(item, WeaponAttackType(attacktype), apply);
@@ -7836,6 +7954,9 @@ void Player::_ApplyItemMods(Item* item, uint8 slot, bool apply)
     if (slot == EQUIPMENT_SLOT_RANGED)
         _ApplyAmmoBonuses();
 
+    // the equip spells and enchantments are auras, their handlers read the recalculated values
+    ApplyDeferredStatUpdates();
+
     ApplyItemEquipSpell(item, apply);
     ApplyEnchantment(item, apply);
 
@@ -8713,6 +8834,7 @@ void Player::_RemoveAllItemMods()
         }
     }
 
+    DeferStatUpdates();
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
         if (m_items[i])
@@ -8733,6 +8855,7 @@ void Player::_RemoveAllItemMods()
                 _ApplyAmmoBonuses();
         }
     }
+    ApplyDeferredStatUpdates();
 
     DEBUG_LOG("_RemoveAllItemMods complete.");
 }
@@ -8741,6 +8864,7 @@ void Player::_ApplyAllItemMods()
 {
     DEBUG_LOG("_ApplyAllItemMods start.");
 
+    DeferStatUpdates();
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
         if (m_items[i])
@@ -8762,6 +8886,7 @@ void Player::_ApplyAllItemMods()
                 _ApplyAmmoBonuses();
         }
     }
+    ApplyDeferredStatUpdates();
 
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
@@ -8788,6 +8913,7 @@ void Player::_ApplyAllItemMods()
 
 void Player::_ApplyAllLevelScaleItemMods(bool apply)
 {
+    DeferStatUpdates();
     for (int i = 0; i < INVENTORY_SLOT_BAG_END; ++i)
     {
         if (m_items[i])
@@ -8802,6 +8928,7 @@ void Player::_ApplyAllLevelScaleItemMods(bool apply)
             _ApplyItemBonuses(proto, i, apply, true);
         }
     }
+    ApplyDeferredStatUpdates();
 }
 
 void Player::_ApplyAmmoBonuses()
@@ -9015,17 +9142,7 @@ void Player::SendInitWorldStates(uint32 zoneid, uint32 areaid) const
 
 void Player::FillBGWeekendWorldStates(WorldPacket& data, uint32& count) const
 {
-    for (uint32 i = 1; i < sBattlemasterListStore.GetNumRows(); ++i)
-    {
-        BattlemasterListEntry const* bl = sBattlemasterListStore.LookupEntry(i);
-        if (bl && bl->HolidayWorldStateId)
-        {
-            if (BattleGroundMgr::IsBgWeekend(BattleGroundTypeId(bl->id)))
-                FillInitialWorldState(data, count, bl->HolidayWorldStateId, 1);
-            else
-                FillInitialWorldState(data, count, bl->HolidayWorldStateId, 0);
-        }
-    }
+    sBattleGroundMgr.FillWeekendWorldStates(data, count);
 }
 
 uint32 Player::GetXPRestBonus(uint32 xp)
@@ -11531,6 +11648,11 @@ Item* Player::_StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool
 
     DEBUG_LOG("STORAGE: StoreItem bag = %u, slot = %u, item = %u, count = %u", bag, slot, pItem->GetEntry(), count);
 
+#ifdef BUILD_PLAYERBOT
+    if (m_playerbotAI)
+        m_playerbotAI->InventoryChanged();
+#endif
+
     Item* pItem2 = GetItemByPos(bag, slot);
 
     if (!pItem2)
@@ -11800,6 +11922,11 @@ void Player::VisualizeItem(uint8 slot, Item* pItem)
 
     DEBUG_LOG("STORAGE: EquipItem slot = %u, item = %u", slot, pItem->GetEntry());
 
+#ifdef BUILD_PLAYERBOT
+    if (m_playerbotAI)
+        m_playerbotAI->InventoryChanged();
+#endif
+
     m_items[slot] = pItem;
     SetGuidValue(PLAYER_FIELD_INV_SLOT_HEAD + (slot * 2), pItem->GetObjectGuid());
     pItem->SetGuidValue(ITEM_FIELD_CONTAINED, GetObjectGuid());
@@ -11824,6 +11951,11 @@ void Player::RemoveItem(uint8 bag, uint8 slot, bool update)
     {
         DEBUG_LOG("STORAGE: RemoveItem bag = %u, slot = %u, item = %u", bag, slot, pItem->GetEntry());
 
+#ifdef BUILD_PLAYERBOT
+        if (m_playerbotAI)
+            m_playerbotAI->InventoryChanged();
+#endif
+
         RemoveEnchantmentDurations(pItem);
         RemoveItemDurations(pItem);
 
@@ -11951,6 +12083,11 @@ void Player::DestroyItem(uint8 bag, uint8 slot, bool update)
     {
         DEBUG_LOG("STORAGE: DestroyItem bag = %u, slot = %u, item = %u", bag, slot, pItem->GetEntry());
 
+#ifdef BUILD_PLAYERBOT
+        if (m_playerbotAI)
+            m_playerbotAI->InventoryChanged();
+#endif
+
         // start from destroy contained items (only equipped bag can have its)
         if (pItem->IsBag() && pItem->IsEquipped())          // this also prevent infinity loop if empty bag stored in bag==slot
         {
@@ -13424,7 +13561,7 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId)
 
     m_playerMenu->GetGossipMenu().SetMenuId(menuId);
 
-    GossipMenuItemsMapBounds pMenuItemBounds = sObjectMgr.GetGossipMenuItemsMapBounds(menuId);
+    GossipMenuCompiled const* compiledMenu = sObjectMgr.GetCompiledGossipMenu(menuId);
 
     Gender gender = GENDER_MALE;
 
@@ -13432,16 +13569,33 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId)
     bool canSeeQuests = menuId == GetDefaultGossipMenuForSource(pSource);
 
     // if canSeeQuests (the default, top level menu) and no menu options exist for this, use options from default options
-    if (pMenuItemBounds.first == pMenuItemBounds.second && canSeeQuests)
-        pMenuItemBounds = sObjectMgr.GetGossipMenuItemsMapBounds(0);
+    if (!compiledMenu && canSeeQuests)
+        compiledMenu = sObjectMgr.GetCompiledGossipMenu(0);
 
-    for (GossipMenuItemsMap::const_iterator itr = pMenuItemBounds.first; itr != pMenuItemBounds.second; ++itr)
+    static GossipMenuCompiled const emptyMenu;
+    if (!compiledMenu)
+        compiledMenu = &emptyMenu;
+
+    // results of the conditions of the menu, each one checked at its first use
+    enum { CONDITION_UNCHECKED, CONDITION_FAILED, CONDITION_SATISFIED };
+    std::vector<uint8> conditionResults(compiledMenu->conditionIds.size(), CONDITION_UNCHECKED);
+
+    for (GossipMenuOptionCompiled const& option : compiledMenu->options)
     {
-        GossipMenuItems const& gossipMenu = itr->second;
+        GossipMenuItems const& gossipMenu = option.item;
         bool hasMenuItem = true;
         bool isGMSkipConditionCheck = false;
 
-        if (gossipMenu.conditionId && !sObjectMgr.IsConditionSatisfied(gossipMenu.conditionId, this, GetMap(), pSource, CONDITION_FROM_GOSSIP_OPTION))
+        bool conditionSatisfied = true;
+        if (option.conditionIndex >= 0)
+        {
+            uint8& result = conditionResults[option.conditionIndex];
+            if (result == CONDITION_UNCHECKED)
+                result = sObjectMgr.IsConditionSatisfied(gossipMenu.conditionId, this, GetMap(), pSource, CONDITION_FROM_GOSSIP_OPTION) ? CONDITION_SATISFIED : CONDITION_FAILED;
+            conditionSatisfied = result == CONDITION_SATISFIED;
+        }
+
+        if (!conditionSatisfied)
         {
             if (IsGameMaster())                             // Let GM always see menu items regardless of conditions
                 isGMSkipConditionCheck = true;
@@ -13587,49 +13741,23 @@ void Player::PrepareGossipMenu(WorldObject* pSource, uint32 menuId)
 
         if (hasMenuItem)
         {
-            std::string strOptionText = gossipMenu.option_text;
-            std::string strBoxText = gossipMenu.box_text;
-
             int loc_idx = GetSession()->GetSessionDbLocaleIndex();
 
-            if (gossipMenu.option_broadcast_text || gossipMenu.box_broadcast_text)
-            {
-                if (gossipMenu.option_broadcast_text)
-                {
-                    BroadcastText const* bct = sObjectMgr.GetBroadcastText(gossipMenu.option_broadcast_text);
-                    strOptionText = bct->GetText(loc_idx, gender);
-                }
-                if (gossipMenu.box_broadcast_text)
-                {
-                    BroadcastText const* bct = sObjectMgr.GetBroadcastText(gossipMenu.box_broadcast_text);
-                    strBoxText = bct->GetText(loc_idx, gender);
-                }
-            }
-            else
-            {
-                if (loc_idx >= 0)
-                {
-                    uint32 idxEntry = MAKE_PAIR32(menuId, gossipMenu.id);
-
-                    if (GossipMenuItemsLocale const* no = sObjectMgr.GetGossipMenuItemsLocale(idxEntry))
-                    {
-                        if (no->OptionText.size() > (size_t)loc_idx && !no->OptionText[loc_idx].empty())
-                            strOptionText = no->OptionText[loc_idx];
-
-                        if (no->BoxText.size() > (size_t)loc_idx && !no->BoxText[loc_idx].empty())
-                            strBoxText = no->BoxText[loc_idx];
-                    }
-                }
-            }
-
+            // the texts are precompiled, only the marked options of game masters are built here
             if (isGMSkipConditionCheck)
             {
+                std::string strOptionText, strBoxText;
+                sObjectMgr.GetGossipMenuItemTexts(gossipMenu, loc_idx, gender, strOptionText, strBoxText);
+
                 strOptionText.append(" (");
                 strOptionText.append(GetSession()->GetMangosString(LANG_GM_ON));
                 strOptionText.append(")");
+
+                m_playerMenu->GetGossipMenu().AddMenuItem(gossipMenu.option_icon, strOptionText, 0, gossipMenu.option_id, strBoxText, gossipMenu.box_money, gossipMenu.box_coded);
             }
+            else
+                m_playerMenu->GetGossipMenu().AddMenuItem(option.GetSerialized(loc_idx, gender), gossipMenu.option_id, gossipMenu.box_money, gossipMenu.box_coded);
 
-            m_playerMenu->GetGossipMenu().AddMenuItem(gossipMenu.option_icon, strOptionText, 0, gossipMenu.option_id, strBoxText, gossipMenu.box_money, gossipMenu.box_coded);
             m_playerMenu->GetGossipMenu().AddGossipMenuItemData(gossipMenu.action_menu_id, gossipMenu.action_poi_id, gossipMenu.action_script_id);
         }
     }
@@ -14412,6 +14540,8 @@ void Player::AddQuest(Quest const* pQuest, Object* questGiver)
     questStatusData.m_status = QUEST_STATUS_INCOMPLETE;
     questStatusData.m_explored = false;
 
+    InvalidateDialogStatusCache();
+
     if (pQuest->HasSpecialFlag(QUEST_SPECIAL_FLAG_DELIVER))
     {
         for (unsigned int& i : questStatusData.m_itemcount)
@@ -14688,6 +14818,8 @@ void Player::RewardQuest(Quest const* pQuest, uint32 reward, Object* questGiver,
     if (q_status.uState != QUEST_NEW)
         q_status.uState = QUEST_CHANGED;
 
+    InvalidateDialogStatusCache();
+
     if (announce)
         SendQuestReward(pQuest, xp, honor);
 
@@ -15339,6 +15471,8 @@ void Player::SetQuestStatus(uint32 quest_id, QuestStatus status)
 
         if (q_status.uState != QUEST_NEW)
             q_status.uState = QUEST_CHANGED;
+
+        InvalidateDialogStatusCache();
     }
 
     UpdateForQuestWorldObjects();
@@ -15429,87 +15563,78 @@ void Player::RewardPlayerAndGroupAtEventExplored(uint32 questId, WorldObject con
 
 void Player::ItemAddedQuestCheck(uint32 entry, uint32 count)
 {
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_ITEM, entry, refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (questid == 0)
+        // completing an earlier objective may have rewarded the quest already
+        if (GetQuestSlotQuestId(ref.slot) != ref.questId)
             continue;
 
-        QuestStatusData& q_status = mQuestStatus[questid];
+        QuestStatusData& q_status = mQuestStatus[ref.questId];
 
         if (q_status.m_status != QUEST_STATUS_INCOMPLETE)
             continue;
 
-        Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(ref.questId);
         if (!qInfo || !qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_DELIVER))
             continue;
 
-        for (int j = 0; j < QUEST_ITEM_OBJECTIVES_COUNT; ++j)
-        {
-            uint32 reqitem = qInfo->ReqItemId[j];
-            if (reqitem == entry)
-            {
-                uint32 reqitemcount = qInfo->ReqItemCount[j];
-                uint32 curitemcount = q_status.m_itemcount[j];
+        uint32 j = ref.objective;
+        uint32 reqitemcount = qInfo->ReqItemCount[j];
+        uint32 curitemcount = q_status.m_itemcount[j];
 
-                if (curitemcount < reqitemcount)
-                {
-                    uint32 additemcount = (curitemcount + count <= reqitemcount ? count : reqitemcount - curitemcount);
-                    q_status.m_itemcount[j] += additemcount;
-                    if (q_status.uState != QUEST_NEW)
-                        q_status.uState = QUEST_CHANGED;
-
-                    SendQuestUpdateAddItem(qInfo, j, curitemcount, additemcount);
-                }
+        if (curitemcount < reqitemcount)
+        {
+            uint32 additemcount = (curitemcount + count <= reqitemcount ? count : reqitemcount - curitemcount);
+            q_status.m_itemcount[j] += additemcount;
+            if (q_status.uState != QUEST_NEW)
+                q_status.uState = QUEST_CHANGED;
 
-                if (CanCompleteQuest(questid))
-                    CompleteQuest(questid); // will call UpdateForQuestWorldObjects to clean sparkles for this quest on client
-                else if (q_status.m_itemcount[j] == reqitemcount)
-                    UpdateForQuestWorldObjects(); // call UpdateForQuestWorldObjects to remove sparkles from finished objective on client
-            }
+            SendQuestUpdateAddItem(qInfo, j, curitemcount, additemcount);
         }
+
+        if (CanCompleteQuest(ref.questId))
+            CompleteQuest(ref.questId); // will call UpdateForQuestWorldObjects to clean sparkles for this quest on client
+        else if (q_status.m_itemcount[j] == reqitemcount)
+            UpdateForQuestWorldObjects(); // call UpdateForQuestWorldObjects to remove sparkles from finished objective on client
     }
 }
 
 void Player::ItemRemovedQuestCheck(uint32 entry, uint32 count)
 {
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_ITEM, entry, refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (!questid)
+        if (GetQuestSlotQuestId(ref.slot) != ref.questId)
             continue;
-        Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(ref.questId);
         if (!qInfo)
             continue;
         if (!qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_DELIVER))
             continue;
 
-        for (int j = 0; j < QUEST_ITEM_OBJECTIVES_COUNT; ++j)
-        {
-            uint32 reqitem = qInfo->ReqItemId[j];
-            if (reqitem == entry)
-            {
-                QuestStatusData& q_status = mQuestStatus[questid];
+        uint32 j = ref.objective;
+        QuestStatusData& q_status = mQuestStatus[ref.questId];
 
-                uint32 reqitemcount = qInfo->ReqItemCount[j];
-                uint32 curitemcount;
+        uint32 reqitemcount = qInfo->ReqItemCount[j];
+        uint32 curitemcount;
 
-                if (q_status.m_status != QUEST_STATUS_COMPLETE)
-                    curitemcount = q_status.m_itemcount[j];
-                else
-                    curitemcount = GetItemCount(entry, true);
+        if (q_status.m_status != QUEST_STATUS_COMPLETE)
+            curitemcount = q_status.m_itemcount[j];
+        else
+            curitemcount = GetItemCount(entry, true);
 
-                if (curitemcount < reqitemcount + count)
-                {
-                    uint32 remitemcount = (curitemcount <= reqitemcount ? count : count + reqitemcount - curitemcount);
-                    q_status.m_itemcount[j] = curitemcount - remitemcount;
-                    if (q_status.uState != QUEST_NEW)
-                        q_status.uState = QUEST_CHANGED;
+        if (curitemcount < reqitemcount + count)
+        {
+            uint32 remitemcount = (curitemcount <= reqitemcount ? count : count + reqitemcount - curitemcount);
+            q_status.m_itemcount[j] = curitemcount - remitemcount;
+            if (q_status.uState != QUEST_NEW)
+                q_status.uState = QUEST_CHANGED;
 
-                    IncompleteQuest(questid);
-                    UpdateForQuestWorldObjects();
-                }
-            }
+            IncompleteQuest(ref.questId);
+            UpdateForQuestWorldObjects();
         }
     }
 }
@@ -15532,51 +15657,42 @@ void Player::KilledMonsterCredit(uint32 entry, ObjectGuid guid)
     uint32 addkillcount = 1;
     GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE, entry, addkillcount);
 
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_CREATURE, entry, refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (!questid)
+        if (GetQuestSlotQuestId(ref.slot) != ref.questId)
             continue;
 
-        Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(ref.questId);
         if (!qInfo)
             continue;
+
+        if (!qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_KILL_OR_CAST))
+            continue;
+
+        // skip Cast at creature objective
+        uint32 j = ref.objective;
+        if (qInfo->ReqSpell[j] != 0)
+            continue;
+
         // just if !ingroup || !noraidgroup || raidgroup
-        QuestStatusData& q_status = mQuestStatus[questid];
+        QuestStatusData& q_status = mQuestStatus[ref.questId];
         if (q_status.m_status == QUEST_STATUS_INCOMPLETE && (!GetGroup() || !GetGroup()->isRaidGroup() || qInfo->IsAllowedInRaid()))
         {
-            if (qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_KILL_OR_CAST))
+            uint32 reqkillcount = qInfo->ReqCreatureOrGOCount[j];
+            uint32 curkillcount = q_status.m_creatureOrGOcount[j];
+            if (curkillcount < reqkillcount)
             {
-                for (int j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
-                {
-                    // skip GO activate objective or none
-                    if (qInfo->ReqCreatureOrGOId[j] <= 0)
-                        continue;
-
-                    // skip Cast at creature objective
-                    if (qInfo->ReqSpell[j] != 0)
-                        continue;
-
-                    uint32 reqkill = qInfo->ReqCreatureOrGOId[j];
-
-                    if (reqkill == entry)
-                    {
-                        uint32 reqkillcount = qInfo->ReqCreatureOrGOCount[j];
-                        uint32 curkillcount = q_status.m_creatureOrGOcount[j];
-                        if (curkillcount < reqkillcount)
-                        {
-                            q_status.m_creatureOrGOcount[j] = curkillcount + addkillcount;
-                            if (q_status.uState != QUEST_NEW)
-                                q_status.uState = QUEST_CHANGED;
-
-                            SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
-                        }
+                q_status.m_creatureOrGOcount[j] = curkillcount + addkillcount;
+                if (q_status.uState != QUEST_NEW)
+                    q_status.uState = QUEST_CHANGED;
 
-                        if (CanCompleteQuest(questid))
-                            CompleteQuest(questid);
-                    }
-                }
+                SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
             }
+
+            if (CanCompleteQuest(ref.questId))
+                CompleteQuest(ref.questId);
         }
     }
 }
@@ -15637,13 +15753,20 @@ void Player::CastedCreatureOrGO(uint32 entry, ObjectGuid guid, uint32 spell_id,
     bool isCreature = guid.IsCreatureOrVehicle();
 
     uint32 addCastCount = 1;
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    uint16 creditedSlot = MAX_QUEST_LOG_SIZE;
+
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(isCreature ? QUEST_OBJECTIVE_CREATURE : QUEST_OBJECTIVE_GAMEOBJECT, entry, refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (!questid)
+        // same objective target can be in many active quests, but not in 2 objectives for single quest (code optimization).
+        if (ref.slot == creditedSlot)
             continue;
 
-        Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
+        if (GetQuestSlotQuestId(ref.slot) != ref.questId)
+            continue;
+
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(ref.questId);
         if (!qInfo)
             continue;
 
@@ -15653,102 +15776,71 @@ void Player::CastedCreatureOrGO(uint32 entry, ObjectGuid guid, uint32 spell_id,
         if (!qInfo->HasSpecialFlag(QUEST_SPECIAL_FLAG_KILL_OR_CAST))
             continue;
 
-        QuestStatusData& q_status = mQuestStatus[questid];
+        QuestStatusData& q_status = mQuestStatus[ref.questId];
 
         if (q_status.m_status != QUEST_STATUS_INCOMPLETE)
             continue;
 
-        for (int j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
-        {
-            // skip kill creature objective (0) or wrong spell casts
-            if (qInfo->ReqSpell[j] != spell_id)
-                continue;
-
-            uint32 reqTarget = 0;
-
-            if (isCreature)
-            {
-                // creature activate objectives
-                if (qInfo->ReqCreatureOrGOId[j] > 0)
-                    // checked at quest_template loading
-                    reqTarget = qInfo->ReqCreatureOrGOId[j];
-            }
-            else
-            {
-                // GO activate objective
-                if (qInfo->ReqCreatureOrGOId[j] < 0)
-                    // checked at quest_template loading
-                    reqTarget = - qInfo->ReqCreatureOrGOId[j];
-            }
-
-            // other not this creature/GO related objectives
-            if (reqTarget != entry)
-                continue;
+        // skip kill creature objective (0) or wrong spell casts
+        uint32 j = ref.objective;
+        if (qInfo->ReqSpell[j] != spell_id)
+            continue;
 
-            uint32 reqCastCount = qInfo->ReqCreatureOrGOCount[j];
-            uint32 curCastCount = q_status.m_creatureOrGOcount[j];
-            if (curCastCount < reqCastCount)
-            {
-                q_status.m_creatureOrGOcount[j] = curCastCount + addCastCount;
-                if (q_status.uState != QUEST_NEW)
-                    q_status.uState = QUEST_CHANGED;
+        uint32 reqCastCount = qInfo->ReqCreatureOrGOCount[j];
+        uint32 curCastCount = q_status.m_creatureOrGOcount[j];
+        if (curCastCount < reqCastCount)
+        {
+            q_status.m_creatureOrGOcount[j] = curCastCount + addCastCount;
+            if (q_status.uState != QUEST_NEW)
+                q_status.uState = QUEST_CHANGED;
 
-                SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
-            }
+            SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
+        }
 
-            if (CanCompleteQuest(questid))
-                CompleteQuest(questid);
+        if (CanCompleteQuest(ref.questId))
+            CompleteQuest(ref.questId);
 
-            // same objective target can be in many active quests, but not in 2 objectives for single quest (code optimization).
-            break;
-        }
+        creditedSlot = ref.slot;
     }
 }
 
 void Player::TalkedToCreature(uint32 entry, ObjectGuid guid)
 {
     uint32 addTalkCount = 1;
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_CREATURE, entry, refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (!questid)
+        if (GetQuestSlotQuestId(ref.slot) != ref.questId)
             continue;
 
-        Quest const* qInfo = sObjectMgr.GetQuestTemplate(questid);
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(ref.questId);
         if (!qInfo)
             continue;
 
-        QuestStatusData& q_status = mQuestStatus[questid];
+        QuestStatusData& q_status = mQuestStatus[ref.questId];
 
         if (q_status.m_status == QUEST_STATUS_INCOMPLETE)
         {
             if (qInfo->HasSpecialFlag(QuestSpecialFlags(QUEST_SPECIAL_FLAG_KILL_OR_CAST | QUEST_SPECIAL_FLAG_SPEAKTO)))
             {
-                for (int j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
-                {
-                    // skip spell casts and Gameobject objectives
-                    if (qInfo->ReqSpell[j] > 0 || qInfo->ReqCreatureOrGOId[j] < 0)
-                        continue;
-
-                    uint32 reqTarget = qInfo->ReqCreatureOrGOId[j];
-                    if (reqTarget <= 0)    // creature activate objectives
-                        continue;
+                // skip spell casts
+                uint32 j = ref.objective;
+                if (qInfo->ReqSpell[j] > 0)
+                    continue;
 
-                    if (reqTarget == entry)
-                    {
-                        uint32 reqTalkCount = qInfo->ReqCreatureOrGOCount[j];
-                        uint32 curTalkCount = q_status.m_creatureOrGOcount[j];
-                        if (curTalkCount < reqTalkCount)
-                        {
-                            q_status.m_creatureOrGOcount[j] = curTalkCount + addTalkCount;
-                            if (q_status.uState != QUEST_NEW) q_status.uState = QUEST_CHANGED;
+                uint32 reqTalkCount = qInfo->ReqCreatureOrGOCount[j];
+                uint32 curTalkCount = q_status.m_creatureOrGOcount[j];
+                if (curTalkCount < reqTalkCount)
+                {
+                    q_status.m_creatureOrGOcount[j] = curTalkCount + addTalkCount;
+                    if (q_status.uState != QUEST_NEW) q_status.uState = QUEST_CHANGED;
 
-                            SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
-                        }
-                        if (CanCompleteQuest(questid))
-                            CompleteQuest(questid);
-                    }
+                    SendQuestUpdateAddCreatureOrGo(qInfo, guid, j, q_status.m_creatureOrGOcount[j]);
                 }
+                if (CanCompleteQuest(ref.questId))
+                    CompleteQuest(ref.questId);
             }
         }
     }
@@ -15800,6 +15892,8 @@ enum TitleFactions
 
 void Player::ReputationChanged(FactionEntry const* factionEntry)
 {
+    InvalidateDialogStatusCache();
+
     ReputationMgr const& repMgr = GetReputationMgr();
     for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
     {
@@ -15859,58 +15953,58 @@ void Player::ReputationChanged(FactionEntry const* factionEntry)
 
 bool Player::HasQuestForItem(uint32 itemid) const
 {
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    // incomplete and not hidden by the group, of the quest in the slot
+    auto getIncompleteQuest = [this](QuestObjectiveRef const& ref, QuestStatusData const*& q_status) -> Quest const*
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (questid == 0)
-            continue;
+        QuestStatusMap::const_iterator qs_itr = mQuestStatus.find(ref.questId);
+        if (qs_itr == mQuestStatus.end() || qs_itr->second.m_status != QUEST_STATUS_INCOMPLETE)
+            return nullptr;
 
-        QuestStatusMap::const_iterator qs_itr = mQuestStatus.find(questid);
-        if (qs_itr == mQuestStatus.end())
-            continue;
+        Quest const* qinfo = sObjectMgr.GetQuestTemplate(ref.questId);
+        if (!qinfo)
+            return nullptr;
 
-        QuestStatusData const& q_status = qs_itr->second;
+        // hide quest if player is in raid-group and quest is no raid quest
+        if (GetGroup() && GetGroup()->isRaidGroup() && !qinfo->IsAllowedInRaid() && !InBattleGround())
+            return nullptr;
 
-        if (q_status.m_status == QUEST_STATUS_INCOMPLETE)
-        {
-            Quest const* qinfo = sObjectMgr.GetQuestTemplate(questid);
-            if (!qinfo)
-                continue;
+        q_status = &qs_itr->second;
+        return qinfo;
+    };
 
-            // hide quest if player is in raid-group and quest is no raid quest
-            if (GetGroup() && GetGroup()->isRaidGroup() && !qinfo->IsAllowedInRaid() && !InBattleGround())
-                continue;
+    QuestObjectiveRefs refs;
+    QuestStatusData const* q_status = nullptr;
 
-            // There should be no mixed ReqItem/ReqSource drop
-            // This part for ReqItem drop
-            for (int j = 0; j < QUEST_ITEM_OBJECTIVES_COUNT; ++j)
-            {
-                if (itemid == qinfo->ReqItemId[j] && q_status.m_itemcount[j] < qinfo->ReqItemCount[j])
-                    return true;
-            }
-            // This part - for ReqSource
-            for (int j = 0; j < QUEST_SOURCE_ITEM_IDS_COUNT; ++j)
-            {
-                // examined item is a source item
-                if (qinfo->ReqSourceId[j] == itemid)
-                {
-                    ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(itemid);
+    // There should be no mixed ReqItem/ReqSource drop
+    // This part for ReqItem drop
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_ITEM, itemid, refs);
+    for (QuestObjectiveRef const& ref : refs)
+        if (Quest const* qinfo = getIncompleteQuest(ref, q_status))
+            if (q_status->m_itemcount[ref.objective] < qinfo->ReqItemCount[ref.objective])
+                return true;
 
-                    // 'unique' item
-                    if (pProto->MaxCount && (int32)GetItemCount(itemid, true) < pProto->MaxCount)
-                        return true;
+    // This part - for ReqSource
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_SOURCE_ITEM, itemid, refs);
+    for (QuestObjectiveRef const& ref : refs)
+    {
+        Quest const* qinfo = getIncompleteQuest(ref, q_status);
+        if (!qinfo)
+            continue;
 
-                    // allows custom amount drop when not 0
-                    if (qinfo->ReqSourceCount[j])
-                    {
-                        if (GetItemCount(itemid, true) < qinfo->ReqSourceCount[j])
-                            return true;
-                    }
-                    else if ((int32)GetItemCount(itemid, true) < pProto->Stackable)
-                        return true;
-                }
-            }
+        ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(itemid);
+
+        // 'unique' item
+        if (pProto->MaxCount && (int32)GetItemCount(itemid, true) < pProto->MaxCount)
+            return true;
+
+        // allows custom amount drop when not 0
+        if (qinfo->ReqSourceCount[ref.objective])
+        {
+            if (GetItemCount(itemid, true) < qinfo->ReqSourceCount[ref.objective])
+                return true;
         }
+        else if ((int32)GetItemCount(itemid, true) < pProto->Stackable)
+            return true;
     }
     return false;
 }
@@ -16063,6 +16157,32 @@ void Player::SendQuestUpdateAddPlayer(Quest const* quest, uint32 count)
         SetQuestSlotCounter(slot, QUEST_PVP_KILL_SLOT, count);
 }
 
+bool Player::GetCachedDialogStatus(Object const* questgiver, uint32& dialogStatus) const
+{
+    uint32 const now = WorldTimer::getMSTime();
+    uint32 const version = sObjectMgr.GetQuestStateVersion();
+    if (m_dialogStatusCacheVersion != version || WorldTimer::getMSTimeDiff(m_dialogStatusCacheTime, now) > DIALOG_STATUS_CACHE_TIME)
+    {
+        // taken before the status is computed, a change of the version meanwhile drops it on the next lookup
+        m_dialogStatusCache.clear();
+        m_dialogStatusCacheVersion = version;
+        m_dialogStatusCacheTime = now;
+        return false;
+    }
+
+    auto itr = m_dialogStatusCache.find((questgiver->GetEntry() << 1) | (questgiver->GetTypeId() == TYPEID_GAMEOBJECT ? 1 : 0));
+    if (itr == m_dialogStatusCache.end())
+        return false;
+
+    dialogStatus = itr->second;
+    return true;
+}
+
+void Player::CacheDialogStatus(Object const* questgiver, uint32 dialogStatus) const
+{
+    m_dialogStatusCache[(questgiver->GetEntry() << 1) | (questgiver->GetTypeId() == TYPEID_GAMEOBJECT ? 1 : 0)] = uint8(dialogStatus);
+}
+
 void Player::SendQuestGiverStatusMultiple() const
 {
     uint32 count = 0;
@@ -16744,7 +16864,6 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
 
     // Mail
     _LoadMails(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILS));
-    _LoadMailedItems(holder->GetResult(PLAYER_LOGIN_QUERY_LOADMAILEDITEMS));
     UpdateNextMailTimeAndUnreads();
 
     m_specsCount = fields[58].GetUInt8();
@@ -16957,6 +17076,8 @@ void Player::_LoadActions(QueryResult* result)
 {
     for (auto& m_actionButton : m_actionButtons)
         m_actionButton.clear();
+    for (auto& block : m_actionButtonsBlock)
+        block.clear();
 
     // QueryResult *result = CharacterDatabase.PQuery("SELECT spec, button,action,type FROM character_action WHERE guid = '%u' ORDER BY button",GetGUIDLow());
 
@@ -16979,6 +17100,7 @@ void Player::_LoadActions(QueryResult* result)
 
                 // Will deleted in DB at next save (it can create data until save but marked as deleted)
                 m_actionButtons[spec][button].uState = ACTIONBUTTON_DELETED;
+                m_actionButtonsBlock[spec].clear();
             }
         }
         while (result->NextRow());
@@ -17402,6 +17524,27 @@ void Player::_LoadMailedItems(QueryResult* result)
     delete result;
 }
 
+void Player::LoadMailedItems(std::vector<Mail*> const& mails)
+{
+    std::ostringstream mailIds;
+    for (Mail* mail : mails)
+    {
+        if (mail->itemsLoaded)
+            continue;
+
+        if (mailIds.tellp() > 0)
+            mailIds << ',';
+        mailIds << mail->messageID;
+        mail->itemsLoaded = true;
+    }
+
+    if (mailIds.tellp() == 0)
+        return;
+
+    //                                                           0          1            2                3      4         5        6      7             8                 9           10          11    12       13         14
+    _LoadMailedItems(CharacterDatabase.PQuery("SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, mail_id, item_guid, item_template FROM mail_items JOIN item_instance ON item_guid = guid WHERE mail_id IN (%s)", mailIds.str().c_str()));
+}
+
 void Player::_LoadMails(QueryResult* result)
 {
     m_mail.clear();
@@ -17436,6 +17579,7 @@ void Player::_LoadMails(QueryResult* result)
         }
 
         m->state = MAIL_STATE_UNCHANGED;
+        m->itemsLoaded = !m->has_items;                     // template items generated below are created in memory
 
         m_mail.push_back(m);
 
@@ -18352,8 +18496,15 @@ void Player::SaveToDB()
     _SaveGlyphs();
     _SaveTalents();
 
+    size_t saveStatements, saveBytes;
+    CharacterDatabase.GetTransactionStats(saveStatements, saveBytes);
     CharacterDatabase.CommitTransaction();
 
+    // the character screen has to show the saved state
+    sCharacterCache.InvalidateCharEnum(m_session->GetAccountId());
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "Player::SaveToDB: %s saved with " SIZEFMTD " statements (" SIZEFMTD " bytes)", m_name.c_str(), saveStatements, saveBytes);
+
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
@@ -18532,10 +18683,16 @@ void Player::_SaveAuras()
     static SqlStatementID deleteAuras ;
     static SqlStatementID insertAuras ;
 
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+
+    // nothing stored and nothing to store, passive and channeled holders are never saved
+    if (!m_aurasInDB && std::none_of(auraHolders.begin(), auraHolders.end(), [](SpellAuraHolderMap::value_type const& holder) { return holder.second->IsSaveToDbHolder(); }))
+        return;
+
     SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
     stmt.PExecute(GetGUIDLow());
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+    m_aurasInDB = false;
 
     if (auraHolders.empty())
         return;
@@ -18592,6 +18749,8 @@ void Player::_SaveAuras()
             stmt.addInt32(holder->GetAuraDuration());
             stmt.addUInt32(effIndexMask);
             stmt.Execute();
+
+            m_aurasInDB = true;
         }
     }
 }
@@ -18638,6 +18797,9 @@ void Player::_SaveGlyphs()
 
 void Player::_SaveInventory()
 {
+    // all rows of the save go out as a few multi-row statements when the batch is flushed
+    ItemSaveBatch batch;
+
     // force items in buyback slots to new state
     // and remove those that aren't already
     for (uint8 i = BUYBACK_SLOT_START; i < BUYBACK_SLOT_END; ++i)
@@ -18645,14 +18807,8 @@ void Player::_SaveInventory()
         Item* item = m_items[i];
         if (!item || item->GetState() == ITEM_NEW) continue;
 
-        static SqlStatementID delInv ;
-        static SqlStatementID delItemInst ;
-
-        SqlStatement stmt = CharacterDatabase.CreateStatement(delInv, "DELETE FROM character_inventory WHERE item = ?");
-        stmt.PExecute(item->GetGUIDLow());
-
-        stmt = CharacterDatabase.CreateStatement(delItemInst, "DELETE FROM item_instance WHERE guid = ?");
-        stmt.PExecute(item->GetGUIDLow());
+        batch.RemoveInventory(item->GetGUIDLow());
+        batch.RemoveItem(item->GetGUIDLow());
 
         m_items[i]->FSetState(ITEM_NEW);
     }
@@ -18671,7 +18827,11 @@ void Player::_SaveInventory()
 #endif
 
     // if no changes
-    if (m_itemUpdateQueue.empty()) return;
+    if (m_itemUpdateQueue.empty())
+    {
+        batch.Flush();
+        return;
+    }
 
     // do not save if the update queue is corrupt
     bool error = false;
@@ -18696,6 +18856,7 @@ void Player::_SaveInventory()
     {
         sLog.outError("Player::_SaveInventory - one or more errors occurred save aborted!");
         ChatHandler(this).SendSysMessage(LANG_ITEM_SAVE_FAILED);
+        batch.Flush();
         return;
     }
 
@@ -18703,9 +18864,16 @@ void Player::_SaveInventory()
     {
         if (!item) continue;
 
-        SaveItemToInventory(item);
+        SaveItemToInventory(item, &batch);
     }
     m_itemUpdateQueue.clear();
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("player.save_items");
+    meas.add_field("items", std::to_string(batch.GetItemCount()));
+#endif
+
+    batch.Flush();
 }
 
 void Player::_SaveMail()
@@ -20121,6 +20289,13 @@ const Taxi::Map& Player::GetTaxiPathSpline() const
     return m_taxiTracker.GetMap();
 }
 
+Taxi::Spline const& Player::GetTaxiPathSplinePoints() const
+{
+    // Bugcheck: container continuity error
+    MANGOS_ASSERT(!m_taxiTracker.GetAtlas().empty());
+    return m_taxiTracker.GetSpline();
+}
+
 int32 Player::GetTaxiPathSplineOffset() const
 {
     return int32(m_taxiTracker.GetResumeWaypointIndex());
@@ -21179,13 +21354,13 @@ void Player::UpdateVisibilityOf(WorldObject const* viewPoint, WorldObject* targe
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(GuidSet& s64, T* target)
+inline void UpdateVisibilityOf_helper(GuidHashSet& s64, T* target)
 {
     s64.insert(target->GetObjectGuid());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(GuidSet& s64, GameObject* target)
+inline void UpdateVisibilityOf_helper(GuidHashSet& s64, GameObject* target)
 {
     if (!target->IsMoTransport())
         s64.insert(target->GetObjectGuid());
@@ -21652,6 +21827,7 @@ void Player::SetDailyQuestStatus(uint32 quest_id)
         {
             SetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx, quest_id);
             m_DailyQuestChanged = true;
+            InvalidateDialogStatusCache();
             break;
         }
     }
@@ -21661,12 +21837,14 @@ void Player::SetWeeklyQuestStatus(uint32 quest_id)
 {
     m_weeklyquests.insert(quest_id);
     m_WeeklyQuestChanged = true;
+    InvalidateDialogStatusCache();
 }
 
 void Player::SetMonthlyQuestStatus(uint32 quest_id)
 {
     m_monthlyquests.insert(quest_id);
     m_MonthlyQuestChanged = true;
+    InvalidateDialogStatusCache();
 }
 
 void Player::ResetDailyQuestStatus()
@@ -21806,13 +21984,11 @@ bool Player::IsSpellFitByClassAndRace(uint32 spell_id, uint32* pReqlevel /*= nul
 
 bool Player::HasQuestForGO(int32 GOId) const
 {
-    for (int i = 0; i < MAX_QUEST_LOG_SIZE; ++i)
+    QuestObjectiveRefs refs;
+    m_questObjectiveIndex.Find(QUEST_OBJECTIVE_GAMEOBJECT, uint32(GOId), refs);
+    for (QuestObjectiveRef const& ref : refs)
     {
-        uint32 questid = GetQuestSlotQuestId(i);
-        if (questid == 0)
-            continue;
-
-        QuestStatusMap::const_iterator qs_itr = mQuestStatus.find(questid);
+        QuestStatusMap::const_iterator qs_itr = mQuestStatus.find(ref.questId);
         if (qs_itr == mQuestStatus.end())
             continue;
 
@@ -21820,21 +21996,15 @@ bool Player::HasQuestForGO(int32 GOId) const
 
         if (qs.m_status == QUEST_STATUS_INCOMPLETE)
         {
-            Quest const* qinfo = sObjectMgr.GetQuestTemplate(questid);
+            Quest const* qinfo = sObjectMgr.GetQuestTemplate(ref.questId);
             if (!qinfo)
                 continue;
 
             if (GetGroup() && GetGroup()->isRaidGroup() && !qinfo->IsAllowedInRaid())
                 continue;
 
-            for (int j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
-            {
-                if (qinfo->ReqCreatureOrGOId[j] >= 0)       // skip non GO case
-                    continue;
-
-                if ((-1)*GOId == qinfo->ReqCreatureOrGOId[j] && qs.m_creatureOrGOcount[j] < qinfo->ReqCreatureOrGOCount[j])
-                    return true;
-            }
+            if (qs.m_creatureOrGOcount[ref.objective] < qinfo->ReqCreatureOrGOCount[ref.objective])
+                return true;
         }
     }
     return false;
@@ -22596,7 +22766,7 @@ void Player::SetOriginalGroup(Group* group, int8 subgroup)
 void Player::UpdateTerainEnvironmentFlags(Map* m, float x, float y, float z)
 {
     GridMapLiquidData liquid_status;
-    GridMapLiquidStatus res = m->GetTerrain()->getLiquidStatus(x, y, z, MAP_ALL_LIQUIDS, &liquid_status);
+    GridMapLiquidStatus res = m->GetTerrainCache().GetLiquidStatus(x, y, z, &liquid_status);
     if (!res)
     {
         SetEnvironmentFlags(ENVIRONMENT_MASK_LIQUID_FLAGS, false);
@@ -24083,6 +24253,8 @@ void Player::ActivateSpec(uint8 specNum)
     if (GetActiveSpec() == specNum)
         return;
 
+    m_initialSpellsBlock.clear();
+
     if (specNum >= GetSpecsCount())
         return;
 
@@ -25050,7 +25222,10 @@ bool Player::CanEnterNewInstance(uint32 instanceId)
 void Player::AddNewInstanceId(uint32 instanceId)
 {
     if (m_enteredInstances.find(instanceId) == m_enteredInstances.end())
+    {
         m_enteredInstances.emplace(instanceId, std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now() + std::chrono::hours(1)));
+        m_enteredInstancesChanged = true;
+    }
 }
 
 void Player::_LoadCreatedInstanceTimers()
@@ -25077,7 +25252,14 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
-    CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
+    if (!m_enteredInstancesChanged)
+        return;
+
+    m_enteredInstancesChanged = false;
+
+    static SqlStatementID deleteInstanceTimers;
+    SqlStatement delStmt = CharacterDatabase.CreateStatement(deleteInstanceTimers, "DELETE FROM account_instances_entered WHERE AccountId = ?");
+    delStmt.PExecute(m_session->GetAccountId());
 
     if (m_enteredInstances.empty())
         return;
@@ -25101,7 +25283,10 @@ void Player::UpdateNewInstanceIdTimers(TimePoint const& now)
     for (auto iter = m_enteredInstances.begin(); iter != m_enteredInstances.end();)
     {
         if ((*iter).second < now)
+        {
             iter = m_enteredInstances.erase(iter);
+            m_enteredInstancesChanged = true;
+        }
         else
             ++iter;
     }
@@ -26,9 +26,12 @@
 
 #include "Database/DatabaseEnv.h"
 #include "Quests/QuestDef.h"
+#include "Quests/QuestObjectiveIndex.h"
+#include "Entities/PlayerUpdateSchedule.h"
 #include "Groups/Group.h"
 #include "Entities/Bag.h"
 #include "Entities/Taxi.h"
+#include "Entities/GuidHashSet.h"
 #include "Server/WorldSession.h"
 #include "Entities/Pet.h"
 #include "Maps/MapReference.h"
@@ -57,6 +60,7 @@ class PlayerSocial;
 class DungeonPersistentState;
 class Spell;
 class Item;
+class ItemSaveBatch;
 struct FactionTemplateEntry;
 
 #ifdef BUILD_PLAYERBOT
@@ -586,6 +590,8 @@ enum QuestSlotOffsets
 
 #define MAX_QUEST_OFFSET 5
 
+#define DIALOG_STATUS_CACHE_TIME    (5*IN_MILLISECONDS)     // msec, for the quest conditions changed without invalidation (items, auras, skills)
+
 enum QuestSlotStateMask
 {
     QUEST_STATE_NONE            = 0x0000,
@@ -849,7 +855,6 @@ enum PlayerLoginQueryIndex
     PLAYER_LOGIN_QUERY_LOADSKILLS,
     PLAYER_LOGIN_QUERY_LOADGLYPHS,
     PLAYER_LOGIN_QUERY_LOADMAILS,
-    PLAYER_LOGIN_QUERY_LOADMAILEDITEMS,
     PLAYER_LOGIN_QUERY_LOADTALENTS,
     PLAYER_LOGIN_QUERY_LOADWEEKLYQUESTSTATUS,
     PLAYER_LOGIN_QUERY_LOADMONTHLYQUESTSTATUS,
@@ -1205,6 +1210,7 @@ class Player : public Unit
         void ToggleTaxiDebug() { m_taxiTracker.m_debug = !m_taxiTracker.m_debug; }
 
         Taxi::Map const& GetTaxiPathSpline() const;
+        Taxi::Spline const& GetTaxiPathSplinePoints() const;
         int32 GetTaxiPathSplineOffset() const;
 
         void OnTaxiFlightStart(const TaxiPathEntry* path);
@@ -1464,6 +1470,7 @@ class Player : public Unit
             SetUInt32Value(PLAYER_QUEST_LOG_1_1 + slot * MAX_QUEST_OFFSET + QUEST_COUNTS_OFFSET, 0);
             SetUInt32Value(PLAYER_QUEST_LOG_1_1 + slot * MAX_QUEST_OFFSET + QUEST_COUNTS_OFFSET + 1, 0);
             SetUInt32Value(PLAYER_QUEST_LOG_1_1 + slot * MAX_QUEST_OFFSET + QUEST_TIME_OFFSET, timer);
+            m_questObjectiveIndex.SetSlot(slot, quest_id);
         }
         void SetQuestSlotCounter(uint16 slot, uint8 counter, uint16 count)
         {
@@ -1485,6 +1492,7 @@ class Player : public Unit
                 SetUInt32Value(PLAYER_QUEST_LOG_1_1 + MAX_QUEST_OFFSET * slot1 + i, temp2);
                 SetUInt32Value(PLAYER_QUEST_LOG_1_1 + MAX_QUEST_OFFSET * slot2 + i, temp1);
             }
+            m_questObjectiveIndex.SwapSlots(slot1, slot2);
         }
         uint32 GetReqKillOrCastCurrentCount(uint32 quest_id, int32 entry);
         void AreaExploredOrEventHappens(uint32 questId);
@@ -1515,6 +1523,11 @@ class Player : public Unit
         void SendQuestUpdateAddPlayer(Quest const* quest, uint32 count);
         void SendQuestGiverStatusMultiple() const;
 
+        // dialog statuses of the quest giver entries, see WorldSession::getDialogStatus
+        bool GetCachedDialogStatus(Object const* questgiver, uint32& dialogStatus) const;
+        void CacheDialogStatus(Object const* questgiver, uint32 dialogStatus) const;
+        void InvalidateDialogStatusCache() { m_dialogStatusCache.clear(); }
+
         ObjectGuid GetDividerGuid() const { return m_dividerGuid; }
         void SetDividerGuid(ObjectGuid guid) { m_dividerGuid = guid; }
         void ClearDividerGuid() { m_dividerGuid.Clear(); }
@@ -1616,6 +1629,9 @@ class Player : public Unit
         void AddNewMailDeliverTime(time_t deliver_time);
 
         void RemoveMail(uint32 id);
+        // the items of the mails are loaded when the mailbox shows or handles the mail, not at login
+        void LoadMailedItems(std::vector<Mail*> const& mails);
+        void LoadMailedItems(Mail* mail) { LoadMailedItems(std::vector<Mail*>(1, mail)); }
 
         void AddMail(Mail* mail) { m_mail.push_front(mail);}// for call from WorldSession::SendMailTo
         size_t GetMailSize() const { return m_mail.size(); }
@@ -2320,8 +2336,8 @@ class Player : public Unit
 
         Object* GetObjectByTypeMask(ObjectGuid guid, TypeMask typemask);
 
-        // currently visible objects at player client
-        GuidSet m_clientGUIDs;
+        // currently visible objects at player client, queried on every visibility check
+        GuidHashSet m_clientGUIDs;
 
         bool HaveAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.find(u->GetObjectGuid()) != m_clientGUIDs.end(); }
 
@@ -2520,7 +2536,7 @@ class Player : public Unit
         void UpdateEverything();
 
         // Public Save system functions
-        void SaveItemToInventory(Item* item); // optimization for gift wrapping
+        void SaveItemToInventory(Item* item, ItemSaveBatch* batch = nullptr); // optimization for gift wrapping
         void SaveTitles(); // optimization for arena rewards
 
         void SetQueuedSpell(Spell* spell);
@@ -2661,6 +2677,12 @@ class Player : public Unit
         ObjectGuid m_curSelectionGuid;
 
         QuestStatusMap mQuestStatus;
+        QuestObjectiveIndex m_questObjectiveIndex;      // by the entries the quest log objectives need
+
+        // dialog statuses by (entry << 1 | gameobject), valid for one quest state version and a short time
+        mutable std::unordered_map<uint32, uint8> m_dialogStatusCache;
+        mutable uint32 m_dialogStatusCacheVersion;
+        mutable uint32 m_dialogStatusCacheTime;
 
         SkillStatusMap mSkillStatus;
 
@@ -2669,6 +2691,7 @@ class Player : public Unit
 
         PlayerMails m_mail;
         PlayerSpellMap m_spells;
+        mutable ByteBuffer m_initialSpellsBlock;            // spell list of SMSG_INITIAL_SPELLS, empty until built after a change of the spells
         PlayerTalentMap m_talents[MAX_TALENT_SPEC_COUNT];
         uint32 m_lastPotionId;                              // last used health/mana potion in combat, that block next potion use
 
@@ -2676,6 +2699,7 @@ class Player : public Unit
         uint8 m_specsCount;
 
         ActionButtonList m_actionButtons[MAX_TALENT_SPEC_COUNT];
+        mutable ByteBuffer m_actionButtonsBlock[MAX_TALENT_SPEC_COUNT]; // buttons of SMSG_ACTION_BUTTONS, empty until built after a change of the spec's buttons
 
         Glyph m_glyphs[MAX_TALENT_SPEC_COUNT][MAX_GLYPH_SLOT_INDEX];
 
@@ -2713,8 +2737,13 @@ class Player : public Unit
         bool   m_WeeklyQuestChanged;
         bool   m_MonthlyQuestChanged;
 
+        // sections rewritten as a whole on save, skipped while their DB state is known to be current
+        bool   m_aurasInDB;                                 // character_aura may hold rows for this character
+        bool   m_cooldownsInDB;                             // character_spell_cooldown may hold rows for this character
+
         uint32 m_drunkTimer;
         uint32 m_weaponChangeTimer;
+        PlayerUpdateSchedule m_updateSchedule;              // due times of the coarse parts of Update
 
         uint32 m_zoneUpdateId;
         uint32 m_zoneUpdateTimer;
@@ -2752,6 +2781,7 @@ class Player : public Unit
         GroupReference m_originalGroup;
         Group* m_groupInvite;
         uint32 m_groupUpdateMask;
+        uint32 m_groupUpdateTimer;
 
         // Player summoning
         time_t m_summon_expire;
@@ -2774,6 +2804,9 @@ class Player : public Unit
 
         void UpdateKnownCurrencies(uint32 itemId, bool apply);
 
+        // the parts of Update due on m_updateSchedule
+        void UpdateScheduled(time_t now);
+
         void AdjustQuestReqItemCount(Quest const* pQuest, QuestStatusData& questStatusData);
 
         void SetCanDelayTeleport(bool setting) { m_bCanDelayTeleport = setting; }
@@ -2873,6 +2906,7 @@ class Player : public Unit
         std::unique_ptr<Spell> m_queuedSpell;
 
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
+        bool m_enteredInstancesChanged;
         uint32 m_createdInstanceClearTimer;
 };
 
@@ -0,0 +1,112 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Entities/PlayerUpdateSchedule.h"
+
+namespace
+{
+    // milliseconds between the runs of the scheduled parts
+    uint32 const SubUpdateIntervals[MAX_SCHEDULED_PLAYER_SUB_UPDATE] =
+    {
+        1 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_MAIL, delivery times are in seconds
+        1 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_PVP_FLAG
+        5 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_AFK_REPORT, reset every 5 minutes
+        1 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_TIMED_QUESTS
+        10 * IN_MILLISECONDS,                               // PLAYER_SUB_UPDATE_REST, bonus only computed every 10 seconds anyway
+        1 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_ENCHANTS
+        1 * IN_MILLISECONDS,                                // PLAYER_SUB_UPDATE_HOMEBIND
+    };
+
+    char const* const SubUpdateNames[MAX_PLAYER_SUB_UPDATE] =
+    {
+        "mail",
+        "pvp flag",
+        "afk report",
+        "timed quests",
+        "rest",
+        "enchants",
+        "homebind",
+        "cinematic",
+        "duel",
+        "item duration",
+        "melee state",
+        "zone",
+        "regen",
+        "save",
+        "stealth detection",
+        "sobering",
+        "instance ids",
+        "group",
+    };
+}
+
+PlayerUpdateSchedule::PlayerUpdateSchedule() : m_clock(0), m_nextDue(0), m_ranMask(0)
+{
+    // all parts run at the first tick
+    m_dueTimes.fill(0);
+    m_lastRuns.fill(0);
+}
+
+bool PlayerUpdateSchedule::IsDue(PlayerSubUpdate subUpdate, uint32& elapsed)
+{
+    // the differences keep working when the clock wraps
+    if (int32(m_clock - m_dueTimes[subUpdate]) < 0)
+        return false;
+
+    elapsed = m_clock - m_lastRuns[subUpdate];
+    m_lastRuns[subUpdate] = m_clock;
+    m_dueTimes[subUpdate] = m_clock + SubUpdateIntervals[subUpdate];
+
+    m_nextDue = m_dueTimes[0];
+    for (uint32 dueTime : m_dueTimes)
+        if (int32(dueTime - m_nextDue) < 0)
+            m_nextDue = dueTime;
+
+    SetRan(subUpdate);
+    return true;
+}
+
+PlayerUpdateStats::PlayerUpdateStats() : m_enabled(false), m_updates(0)
+{
+    for (std::atomic<uint64>& runs : m_runs)
+        runs = 0;
+}
+
+void PlayerUpdateStats::Add(uint32 ranMask)
+{
+    m_updates.fetch_add(1, std::memory_order_relaxed);
+    for (uint32 i = 0; i < MAX_PLAYER_SUB_UPDATE; ++i)
+        if (ranMask & (1 << i))
+            m_runs[i].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64 PlayerUpdateStats::GetStats(std::vector<PlayerSubUpdateStat>& result) const
+{
+    result.clear();
+    for (uint32 i = 0; i < MAX_PLAYER_SUB_UPDATE; ++i)
+        result.push_back({ SubUpdateNames[i], m_runs[i].load(std::memory_order_relaxed) });
+
+    return m_updates.load(std::memory_order_relaxed);
+}
+
+void PlayerUpdateStats::Reset()
+{
+    m_updates = 0;
+    for (std::atomic<uint64>& runs : m_runs)
+        runs = 0;
+}
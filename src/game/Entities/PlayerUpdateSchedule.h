@@ -0,0 +1,120 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PLAYER_UPDATE_SCHEDULE_H
+#define MANGOS_PLAYER_UPDATE_SCHEDULE_H
+
+#include "Common.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+// the parts of Player::Update, the first ones up to MAX_SCHEDULED_PLAYER_SUB_UPDATE only run when their interval passed
+enum PlayerSubUpdate
+{
+    PLAYER_SUB_UPDATE_MAIL              = 0,                // undelivered mail
+    PLAYER_SUB_UPDATE_PVP_FLAG          = 1,                // pvp and contested flag timers
+    PLAYER_SUB_UPDATE_AFK_REPORT        = 2,                // battleground afk report reset
+    PLAYER_SUB_UPDATE_TIMED_QUESTS      = 3,
+    PLAYER_SUB_UPDATE_REST              = 4,                // rest bonus in inns and cities
+    PLAYER_SUB_UPDATE_ENCHANTS          = 5,                // temporary enchantment durations
+    PLAYER_SUB_UPDATE_HOMEBIND          = 6,                // homebind timer in instances without a valid bind
+    MAX_SCHEDULED_PLAYER_SUB_UPDATE     = 7,
+
+    // own timers or conditions, only counted
+    PLAYER_SUB_UPDATE_CINEMATIC         = 7,
+    PLAYER_SUB_UPDATE_DUEL              = 8,
+    PLAYER_SUB_UPDATE_ITEM_DURATION     = 9,
+    PLAYER_SUB_UPDATE_MELEE_STATE       = 10,
+    PLAYER_SUB_UPDATE_ZONE              = 11,
+    PLAYER_SUB_UPDATE_REGEN             = 12,
+    PLAYER_SUB_UPDATE_SAVE              = 13,
+    PLAYER_SUB_UPDATE_STEALTH_DETECTION = 14,
+    PLAYER_SUB_UPDATE_SOBERING          = 15,
+    PLAYER_SUB_UPDATE_INSTANCE_IDS      = 16,
+    PLAYER_SUB_UPDATE_GROUP             = 17,
+    MAX_PLAYER_SUB_UPDATE               = 18,
+};
+
+/**
+ * Due times of the scheduled parts of Player::Update on the own clock of the player. A tick where none
+ * of them is due costs a single compare; otherwise only the due ones run, with the time since their
+ * last run instead of the tick diff.
+ *
+ * Also collects which parts ran in the tick for the world wide PlayerUpdateStats.
+ */
+class PlayerUpdateSchedule
+{
+    public:
+        PlayerUpdateSchedule();
+
+        // true if any scheduled part is due after the tick
+        bool Advance(uint32 diff) { m_clock += diff; return int32(m_clock - m_nextDue) >= 0; }
+
+        // true once per interval of the part, elapsed is the time since it ran last
+        bool IsDue(PlayerSubUpdate subUpdate, uint32& elapsed);
+        bool IsDue(PlayerSubUpdate subUpdate) { uint32 elapsed; return IsDue(subUpdate, elapsed); }
+
+        void SetRan(PlayerSubUpdate subUpdate) { m_ranMask |= 1 << subUpdate; }
+        // parts ran since the last call
+        uint32 TakeRanMask() { uint32 mask = m_ranMask; m_ranMask = 0; return mask; }
+
+    private:
+        uint32 m_clock;                                     // milliseconds since the player was created, wraps
+        uint32 m_nextDue;                                   // earliest due time of the parts
+        std::array<uint32, MAX_SCHEDULED_PLAYER_SUB_UPDATE> m_dueTimes;
+        std::array<uint32, MAX_SCHEDULED_PLAYER_SUB_UPDATE> m_lastRuns;
+        uint32 m_ranMask;
+};
+
+struct PlayerSubUpdateStat
+{
+    char const* name;
+    uint64 runs;
+};
+
+// how often each part of Player::Update ran, collected from the map threads while enabled
+class PlayerUpdateStats
+{
+    public:
+        PlayerUpdateStats();
+        PlayerUpdateStats(const PlayerUpdateStats&) = delete;
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+
+        void AddUpdate(uint32 ranMask)
+        {
+            if (m_enabled)
+                Add(ranMask);
+        }
+
+        // player updates counted since enabled or the last reset
+        uint64 GetStats(std::vector<PlayerSubUpdateStat>& result) const;
+        void Reset();
+
+    private:
+        void Add(uint32 ranMask);
+
+        std::atomic<bool> m_enabled;
+        std::atomic<uint64> m_updates;
+        std::array<std::atomic<uint64>, MAX_PLAYER_SUB_UPDATE> m_runs;
+};
+
+#endif
@@ -29,20 +29,21 @@
 #include "Entities/ObjectGuid.h"
 #include "Entities/Player.h"
 #include "Entities/NPCHandler.h"
+#include "Globals/CharacterCache.h"
+#include "Globals/QueryResponseCache.h"
 #include "Server/SQLStorages.h"
 #include "Maps/GridDefines.h"
 
-void WorldSession::SendNameQueryResponse(CharacterNameQueryResponse& response) const
+void WorldSession::BuildNameQueryResponse(CharacterNameQueryResponse const& response, WorldPacket& data)
 {
     // guess size
-    WorldPacket data(SMSG_NAME_QUERY_RESPONSE, (8 + 1 + 1 + 1 + 1 + 1 + 10));
+    data.Initialize(SMSG_NAME_QUERY_RESPONSE, (8 + 1 + 1 + 1 + 1 + 1 + 10));
     data << response.guid.WriteAsPacked();
 
     // Added in 3.1: non-existent character short packet response
     if (response.name.empty())
     {
         data << uint8(1);
-        SendPacket(data);
         return;
     }
     else
@@ -69,13 +70,19 @@ void WorldSession::SendNameQueryResponse(CharacterNameQueryResponse& response) c
         for (const auto& i : response.declined.name)
             data << i;
     }
+}
 
-    SendPacket(data);
+void WorldSession::SendNameQueryResponse(WorldPacket const& data)
+{
+    if (m_sessionState != WORLD_SESSION_STATE_READY)
+        m_offlineNameResponses.push_back(data);
+    else
+        SendPacket(data);
 }
 
 void WorldSession::SendNameQueryResponseFromDB(ObjectGuid guid) const
 {
-    CharacterDatabase.AsyncPQuery(&WorldSession::SendNameQueryResponseFromDBCallBack, GetAccountId(),
+    CharacterDatabase.AsyncPQuery(&WorldSession::SendNameQueryResponseFromDBCallBack, GetAccountId(), sCharacterCache.GetNameQueryTicket(guid.GetCounter()),
                                   !sWorld.getConfig(CONFIG_BOOL_DECLINED_NAMES_USED) ?
                                   //   ------- Query Without Declined Names --------
                                   //          0     1     2     3       4
@@ -91,7 +98,7 @@ void WorldSession::SendNameQueryResponseFromDB(ObjectGuid guid) const
                                   guid.GetCounter());
 }
 
-void WorldSession::SendNameQueryResponseFromDBCallBack(QueryResult* result, uint32 accountId)
+void WorldSession::SendNameQueryResponseFromDBCallBack(QueryResult* result, uint32 accountId, uint32 cacheTicket)
 {
     if (!result)
         return;
@@ -125,10 +132,10 @@ void WorldSession::SendNameQueryResponseFromDBCallBack(QueryResult* result, uint
             response.declined.name[i] = fields[(5 + i)].GetCppString();
     }
 
-    if (session->m_sessionState != WORLD_SESSION_STATE_READY)
-        session->m_offlineNameResponses.push_back(response);
-    else
-        session->SendNameQueryResponse(response);
+    WorldPacket data;
+    BuildNameQueryResponse(response, data);
+    sCharacterCache.StoreNameQueryResponse(response.guid.GetCounter(), cacheTicket, data);
+    session->SendNameQueryResponse(data);
 
     delete result;
 }
@@ -167,13 +174,19 @@ void WorldSession::HandleNameQueryOpcode(WorldPacket& recv_data)
                response.declined.name[i] = declined->name[i];
         }
 
-        if (m_sessionState != WORLD_SESSION_STATE_READY)
-            m_offlineNameResponses.push_back(response);
-        else
-            SendNameQueryResponse(response);
+        WorldPacket data;
+        BuildNameQueryResponse(response, data);
+        SendNameQueryResponse(data);
     }
     else
-        SendNameQueryResponseFromDB(guid);
+    {
+        // offline characters change only through invalidated paths, answer the repeated queries from the cache
+        WorldPacket data;
+        if (sCharacterCache.GetNameQueryResponse(guid.GetCounter(), data))
+            SendNameQueryResponse(data);
+        else
+            SendNameQueryResponseFromDB(guid);
+    }
 }
 
 void WorldSession::HandleQueryTimeOpcode(WorldPacket& /*recv_data*/)
@@ -194,6 +207,13 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     {
         int loc_idx = GetSessionDbLocaleIndex();
 
+        uint32 ticket = 0;
+        if (std::shared_ptr<WorldPacket const> response = sQueryResponseCache.Get(QUERY_RESPONSE_CREATURE, entry, loc_idx, ticket))
+        {
+            SendPacket(SharedWorldPacket(response));
+            return;
+        }
+
         char const* name = ci->Name;
         char const* subName = ci->SubName;
         sObjectMgr.GetCreatureLocaleStrings(entry, loc_idx, &name, &subName);
@@ -222,7 +242,7 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
         for (unsigned int QuestItem : ci->QuestItems)
             data << uint32(QuestItem);              // itemId[6], quest drop
         data << uint32(ci->MovementTemplateId);             // CreatureMovementInfo.dbc
-        SendPacket(data);
+        SendPacket(SharedWorldPacket(sQueryResponseCache.Store(QUERY_RESPONSE_CREATURE, entry, loc_idx, ticket, data)));
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
     else
@@ -247,11 +267,19 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+
+        uint32 ticket = 0;
+        if (std::shared_ptr<WorldPacket const> response = sQueryResponseCache.Get(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, ticket))
+        {
+            SendPacket(SharedWorldPacket(response));
+            return;
+        }
+
         std::string Name = info->name;
         std::string IconName = info->IconName;
         std::string CastBarCaption = info->castBarCaption;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -277,7 +305,7 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << float(info->size);                          // go size
         for (unsigned int questItem : info->questItems)
             data << uint32(questItem);            // itemId[6], quest drop
-        SendPacket(data);
+        SendPacket(SharedWorldPacket(sQueryResponseCache.Store(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, ticket, data)));
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
     else
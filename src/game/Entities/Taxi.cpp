@@ -21,6 +21,8 @@
 #include "Globals/ObjectMgr.h"
 #include "World/World.h"
 
+#include <limits>
+#include <mutex>
 #include <sstream>
 
 /////////////////////////////////////////////////
@@ -31,6 +33,95 @@
 
 using namespace Taxi;
 
+#define TAXI_SPLINE_CACHE_SIZE 4096                         // joined or resumed splines kept besides the prebuilt ones
+
+namespace
+{
+    struct SharedSpline
+    {
+        std::vector<Waypoint> waypoints;
+        Spline points;
+    };
+
+    std::mutex s_splinesLock;
+    std::unordered_multimap<size_t, SharedSpline> s_splines;
+    size_t s_prebuiltSplines = 0;
+
+    size_t HashWaypoints(Taxi::Map const& map)
+    {
+        size_t hash = map.size();
+        for (Waypoint waypoint : map)
+            hash = hash * 31 + std::hash<Waypoint>()(waypoint);
+        return hash;
+    }
+
+    Spline BuildSpline(Taxi::Map const& map)
+    {
+        std::shared_ptr<Movement::PointsArray> points = std::make_shared<Movement::PointsArray>();
+        points->reserve(map.size());
+        for (Waypoint waypoint : map)
+            points->push_back({ waypoint->x, waypoint->y, waypoint->z });
+        return points;
+    }
+
+    // s_splinesLock held
+    Spline FindSpline(size_t hash, Taxi::Map const& map)
+    {
+        auto bounds = s_splines.equal_range(hash);
+        for (auto itr = bounds.first; itr != bounds.second; ++itr)
+            if (itr->second.waypoints.size() == map.size() && std::equal(map.begin(), map.end(), itr->second.waypoints.begin()))
+                return itr->second.points;
+        return nullptr;
+    }
+}
+
+void Taxi::LoadSplines()
+{
+    std::lock_guard<std::mutex> guard(s_splinesLock);
+    s_splines.clear();
+
+    for (uint32 pathID = 0; pathID < sTaxiPathStore.GetNumRows(); ++pathID)
+    {
+        TaxiPathEntry const* entry = sTaxiPathStore.LookupEntry(pathID);
+        // only flights between two flight masters, not the paths of transports
+        if (!entry || !entry->from || !entry->to || pathID >= sTaxiPathNodesByPath.size() || sTaxiPathNodesByPath[pathID].empty())
+            continue;
+
+        TaxiPathNodeList const& nodes = sTaxiPathNodesByPath[pathID];
+        Roadmap routes;
+        routes.push_back(Route(pathID, entry->from, entry->to, nodes.front()->index, nodes.back()->index, 0));
+
+        Atlas atlas;
+        if (!Tracker::BuildAtlas(routes, pathID, 0, atlas))
+            continue;
+
+        for (Map const& map : atlas)
+        {
+            size_t const hash = HashWaypoints(map);
+            if (!FindSpline(hash, map))
+                s_splines.emplace(hash, SharedSpline{ std::vector<Waypoint>(map.begin(), map.end()), BuildSpline(map) });
+        }
+    }
+
+    s_prebuiltSplines = s_splines.size();
+    sLog.outString(">> Built %u taxi flight splines", uint32(s_prebuiltSplines));
+    sLog.outString();
+}
+
+Spline Taxi::GetSpline(Taxi::Map const& map)
+{
+    size_t const hash = HashWaypoints(map);
+
+    std::lock_guard<std::mutex> guard(s_splinesLock);
+    if (Spline spline = FindSpline(hash, map))
+        return spline;
+
+    Spline spline = BuildSpline(map);
+    if (s_splines.size() < s_prebuiltSplines + TAXI_SPLINE_CACHE_SIZE)
+        s_splines.emplace(hash, SharedSpline{ std::vector<Waypoint>(map.begin(), map.end()), spline });
+    return spline;
+}
+
 std::string Tracker::Save()
 {
     // Writes in modified format.
@@ -240,11 +331,33 @@ bool Tracker::Prepare(Index nodeResume /*= 0*/)
     nodeResume = std::min(nodeResume, current.nodeEnd);
 
     m_atlas.clear();
+    m_splines.clear();
+
+    size_t resumeIndex = std::numeric_limits<size_t>::max();
+    const bool built = BuildAtlas(m_routes, current.pathID, nodeResume, m_atlas, &resumeIndex);
+    // Bugcheck: a finished map spline is suspiciously short
+    MANGOS_ASSERT(built);
+
+    if (resumeIndex != std::numeric_limits<size_t>::max())
+    {
+        m_resumeIndex = resumeIndex;
+        m_locationIndex = m_resumeIndex;
+    }
+
+    for (const Map& map : m_atlas)
+        m_splines.push_back(Taxi::GetSpline(map));
+
+    m_state = TRACKER_STANDBY;
+    return true;
+}
+
+bool Tracker::BuildAtlas(Roadmap const& routes, PathID resumePath, Index nodeResume, Atlas& atlas, size_t* resumeIndex /*= nullptr*/)
+{
     // Open a new map in the atlas
-    m_atlas.push_back(Map());
+    atlas.push_back(Map());
     // Start populating map(s)
     const TaxiPathNodeEntry* prev = nullptr;
-    for (auto i = m_routes.begin(); i != m_routes.end(); ++i)
+    for (auto i = routes.begin(); i != routes.end(); ++i)
     {
         const TaxiPathNodeList& nodes = sTaxiPathNodesByPath[(*i).pathID];
         for (auto j = nodes.begin(); j != nodes.end(); ++j)
@@ -254,18 +367,15 @@ bool Tracker::Prepare(Index nodeResume /*= 0*/)
                 continue;
 
             // Resume node defined: we are loading, additional care is required
-            if (nodeResume && (*i).pathID == current.pathID)
+            if (nodeResume && (*i).pathID == resumePath)
             {
                 // Internal algorithm sanity check: make sure resume node for current route will end up on the same map
                 // Dont build spline for preceding nodes which are located on another map
                 if ((*j)->index < nodes[nodeResume]->index && (*j)->mapid != nodes[nodeResume]->mapid)
                     continue;
                 // When resume node reached on the route: calculate resume location index on the spline (which will be equal to the current size on push)
-                if ((*j)->index == nodeResume)
-                {
-                    m_resumeIndex = m_atlas.back().size();
-                    m_locationIndex = m_resumeIndex;
-                }
+                if ((*j)->index == nodeResume && resumeIndex)
+                    *resumeIndex = atlas.back().size();
             }
             // Detect level change and insert a new map
             if ((*j)->index >= (*i).nodeStart && (*j)->index <= (*i).nodeEnd)
@@ -275,9 +385,10 @@ bool Tracker::Prepare(Index nodeResume /*= 0*/)
                     // Detect map change and advance atlas by adding a new map
                     if (sMapStore.LookupEntry((*j)->mapid))
                     {
-                        // Bugcheck: latest finished map spline is suspiciously short
-                        MANGOS_ASSERT(m_atlas.back().size() > 2);
-                        m_atlas.push_back(Map());
+                        // Latest finished map spline is suspiciously short
+                        if (atlas.back().size() <= 2)
+                            return false;
+                        atlas.push_back(Map());
                     }
                     else
                     {
@@ -288,16 +399,14 @@ bool Tracker::Prepare(Index nodeResume /*= 0*/)
                 }
             }
             // Add entry to the latest Map
-            m_atlas.back().push_back((*j));
+            atlas.back().push_back((*j));
             if ((*j)->index > (*i).nodeStart)
                 prev = (*j);
         }
     }
-    // Bugcheck: latest finished map spline is suspiciously short
-    MANGOS_ASSERT(m_atlas.back().size() > 2);
 
-    m_state = TRACKER_STANDBY;
-    return true;
+    // Latest finished map spline is suspiciously short
+    return atlas.back().size() > 2;
 }
 
 bool Tracker::Clear(bool forced)
@@ -309,6 +418,7 @@ bool Tracker::Clear(bool forced)
     m_cost = 0;
     m_displayId = 0;
     m_atlas.clear();
+    m_splines.clear();
     m_location = nullptr;
     m_locationIndex = 0;
     m_resumeIndex = 0;
@@ -347,6 +457,7 @@ bool Tracker::UpdateRoute(const TaxiPathNodeEntry* entry, PathID& start, PathID&
         // Acknowledge spline end: nuke current map in the atlas, reset location index
         // That does not mean, however, that taxi ride was completed right away, as it can be a multimap flight route
         m_atlas.pop_front();
+        m_splines.pop_front();
         m_location = nullptr;
         m_locationIndex = 0;
         m_resumeIndex = 0;
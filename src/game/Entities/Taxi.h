@@ -20,9 +20,11 @@
 #define _TAXI_H
 
 #include "Server/DBCStores.h"
+#include "Movement/MoveSplineInitArgs.h"
 
 #include <string>
 #include <deque>
+#include <memory>
 
 /////////////////////////////////////////////////
 /// @file       Taxi.h
@@ -61,6 +63,13 @@ namespace Taxi
     typedef std::deque<Waypoint> Map;
     /// Atlas contains one or more Maps in a sequential order
     typedef std::deque<Map> Atlas;
+    /// Spline is the immutable points array of a Map, shared by all rides along the same waypoints
+    typedef std::shared_ptr<Movement::PointsArray const> Spline;
+
+    /// Build the shared splines of all full flight paths (startup, after the DBC stores are loaded)
+    void LoadSplines();
+    /// Get the shared spline of a Map: full flight paths are prebuilt, joined or resumed ones are added on first use
+    Spline GetSpline(Map const& map);
 
     enum TrackerState
     {
@@ -101,6 +110,8 @@ namespace Taxi
             const Map& GetMap() const { return m_atlas.front(); }
             /// Get a collection of splines for the entire ride
             const Atlas& GetAtlas() const { return m_atlas; }
+            /// Get the shared points of the current spline for the map
+            const Spline& GetSpline() const { return m_splines.front(); }
 
             /// Get cost of the current route
             uint32 GetCost() const { return (!m_routes.empty() ? m_routes.front().cost : 0); }
@@ -137,6 +148,8 @@ namespace Taxi
 
             /// Try to join two routes together by determining junction points. Returns true on success.
             static bool Trim(Route& first, Route& second);
+            /// Split routes into the Maps of an atlas, the resume index is set if the resume node of the resume route is reached. Returns false on malformed routes.
+            static bool BuildAtlas(Roadmap const& routes, PathID resumePath, Index nodeResume, Atlas& atlas, size_t* resumeIndex = nullptr);
 
         private:
             Player& m_owner;
@@ -148,6 +161,7 @@ namespace Taxi
             size_t m_resumeIndex;
             Roadmap m_routes;
             Atlas m_atlas;
+            std::deque<Spline> m_splines;                   // Shared points of each Map in m_atlas
 
         public:
             bool m_debug;
@@ -21,6 +21,7 @@
 
 #include "Entities/Creature.h"
 #include "Globals/ObjectAccessor.h"
+#include "Maps/SummonPool.h"
 
 class TemporarySpawn : public Creature
 {
@@ -28,6 +29,8 @@ class TemporarySpawn : public Creature
         explicit TemporarySpawn(ObjectGuid summoner = ObjectGuid());
         virtual ~TemporarySpawn() {};
 
+        SUMMON_POOL_OPERATORS
+
         void Update(const uint32 diff) override;
         void SetSummonProperties(TempSpawnType type, uint32 lifetime);
         void Summon(TempSpawnType type, uint32 lifetime);
@@ -20,6 +20,7 @@
 #define MANGOSSERVER_TOTEM_H
 
 #include "Entities/Creature.h"
+#include "Maps/SummonPool.h"
 
 enum TotemType
 {
@@ -33,6 +34,8 @@ class Totem : public Creature
     public:
         explicit Totem();
         virtual ~Totem() {}
+
+        SUMMON_POOL_OPERATORS
         bool Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo const* cinfo, Unit* owner);
         void Update(const uint32 diff) override;
         void Summon(Unit* owner);
@@ -20,6 +20,7 @@
 
 #include "Entities/Transports.h"
 #include "Maps/MapManager.h"
+#include "World/World.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/ObjectGuid.h"
 #include "MotionGenerators/Path.h"
@@ -402,6 +403,9 @@ bool GenericTransport::RemovePassenger(WorldObject* passenger)
     if (erased)
     {
         DETAIL_LOG("Unit %s removed from transport %s.", passenger->GetName(), GetName());
+        // players bring their own position, anything else leaves from where the transport carried it to
+        if (m_passengerPositionsPending && passenger->IsInWorld() && passenger->GetTypeId() != TYPEID_PLAYER)
+            UpdatePassengerPosition(passenger);
         passenger->SetTransport(nullptr);
         passenger->m_movementInfo.SetTransportData(ObjectGuid(), 0, 0, 0, 0, 0, -1);
 
@@ -439,6 +443,7 @@ void Transport::Update(const uint32 diff)
 {
     uint32 const positionUpdateDelay = 50;
     uint32 const dynChangeTimer = 1000;
+    uint32 const passengerRelocationDelay = sWorld.getConfig(CONFIG_UINT32_TRANSPORT_PASSENGER_RELOCATION_INTERVAL);
 
     if (GetKeyFrames().size() <= 1)
         return;
@@ -476,6 +481,8 @@ void Transport::Update(const uint32 diff)
             SetUInt16Value(GAMEOBJECT_DYNAMIC, 0, GO_DYNFLAG_LO_STOPPED);
             SetUInt16Value(GAMEOBJECT_DYNAMIC, 1, pathProgress % GetPeriod());
             m_dynamicChangeTimer.Reset(dynChangeTimer);
+            if (m_passengerPositionsPending)
+                UpdatePassengerPositions(m_passengers);
             GameObject::SetGoState(GO_STATE_READY);
             if (AI())
                 AI()->JustReachedStopPoint();
@@ -526,10 +533,18 @@ void Transport::Update(const uint32 diff)
             G3D::Vector3 pos, dir;
             m_currentFrame->Spline->evaluate_percent(m_currentFrame->Index, t, pos);
             m_currentFrame->Spline->evaluate_derivative(m_currentFrame->Index, t, dir);
-            UpdatePosition(pos.x, pos.y, pos.z, atan2(dir.y, dir.x) + M_PI);
+            UpdatePosition(pos.x, pos.y, pos.z, atan2(dir.y, dir.x) + M_PI, passengerRelocationDelay == 0);
         }
     }
 
+    // passengers keep their offsets in between, their world positions are only needed for grids and visibility
+    m_passengerRelocationTimer.Update(diff);
+    if (m_passengerPositionsPending && m_passengerRelocationTimer.Passed())
+    {
+        m_passengerRelocationTimer.Reset(passengerRelocationDelay);
+        UpdatePassengerPositions(m_passengers);
+    }
+
     m_dynamicChangeTimer.Update(transportDiff);
     if ((GetUInt16Value(GAMEOBJECT_DYNAMIC, 0) & GO_DYNFLAG_LO_STOPPED) == 0 && m_dynamicChangeTimer.Passed())
     {
@@ -687,12 +702,15 @@ void ElevatorTransport::Update(const uint32 diff)
         AI()->UpdateAI(diff);
 }
 
-void GenericTransport::UpdatePosition(float x, float y, float z, float o)
+void GenericTransport::UpdatePosition(float x, float y, float z, float o, bool movePassengers)
 {
     Relocate(x, y, z, o);
     UpdateModelPosition();
 
-    UpdatePassengerPositions(m_passengers);
+    if (movePassengers)
+        UpdatePassengerPositions(m_passengers);
+    else
+        m_passengerPositionsPending = true;
 }
 
 void GenericTransport::SetGoState(GOState state)
@@ -714,6 +732,7 @@ void GenericTransport::UpdatePassengerPositions(PassengerSet& passengers)
 {
     for (const auto passenger : passengers)
         UpdatePassengerPosition(passenger);
+    m_passengerPositionsPending = false;
 }
 
 void GenericTransport::UpdatePassengerPosition(WorldObject* passenger)
@@ -767,6 +786,15 @@ void GenericTransport::UpdatePassengerPosition(WorldObject* passenger)
         default:
             break;
     }
+
+    // vehicles on board (gunship cannons) leave the relocation of their passengers to this pass while the
+    // transport moves, so they are moved from the new position of the vehicle once per timer of the vehicle
+    if (passenger->IsInWorld() && (passenger->GetTypeId() == TYPEID_UNIT || passenger->GetTypeId() == TYPEID_PLAYER))
+    {
+        Unit* unit = static_cast<Unit*>(passenger);
+        if (unit->IsVehicle())
+            unit->GetVehicleInfo()->UpdateGlobalPositionsIfDue();
+    }
 }
 
 void GenericTransport::CalculatePassengerOrientation(float& o) const
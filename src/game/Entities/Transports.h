@@ -30,12 +30,12 @@ typedef std::set<WorldObject*> PassengerSet;
 class GenericTransport : public GameObject
 {
     public:
-        GenericTransport() : m_passengerTeleportIterator(m_passengers.end()), m_pathProgress(0), m_movementStarted(0), m_stopped(false){}
+        GenericTransport() : m_passengerTeleportIterator(m_passengers.end()), m_pathProgress(0), m_movementStarted(0), m_stopped(false), m_passengerPositionsPending(false) {}
         bool AddPassenger(WorldObject* passenger, bool adjustCoords = true);
         bool RemovePassenger(WorldObject* passenger);
         bool AddPetToTransport(Unit* passenger, Pet* pet);
 
-        void UpdatePosition(float x, float y, float z, float o);
+        void UpdatePosition(float x, float y, float z, float o, bool movePassengers = true);
         void UpdatePassengerPosition(WorldObject* object);
 
         typedef std::set<Player*> PlayerSet;
@@ -70,6 +70,7 @@ class GenericTransport : public GameObject
         uint32 m_pathProgress; // for MO transport its full time since start for normal time in cycle
         uint32 m_movementStarted;
         bool m_stopped;
+        bool m_passengerPositionsPending;                   // moved without its passengers, they still stand where it was
 };
 
 class ElevatorTransport : public GenericTransport
@@ -102,6 +103,8 @@ class Transport : public GenericTransport
         KeyFrameVec const& GetKeyFrames() const { return m_transportTemplate.keyFrames; }
 
         void SpawnPassengers();
+
+        bool IsMoving() const { return m_isMoving; }
     private:
         void TeleportTransport(uint32 newMapid, float x, float y, float z, float o);
         void UpdateForMap(Map const* targetMap, bool newMap);
@@ -109,11 +112,11 @@ class Transport : public GenericTransport
         void MoveToNextWayPoint();                          // move m_next/m_cur to next points
         float CalculateSegmentPos(float perc);
 
-        bool IsMoving() const { return m_isMoving; }
         void SetMoving(bool val) { m_isMoving = val; }
 
         ShortTimeTracker m_positionChangeTimer;
         ShortTimeTracker m_dynamicChangeTimer;
+        ShortTimeTracker m_passengerRelocationTimer;
         bool m_isMoving;
 
         KeyFrameVec::const_iterator m_currentFrame;
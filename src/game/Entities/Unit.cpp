@@ -44,6 +44,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Grids/CellImpl.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "Maps/CombatLogBatch.h"
 #include "MotionGenerators/MovementGenerator.h"
 #include "Movement/MoveSplineInit.h"
 #include "Movement/MoveSpline.h"
@@ -296,6 +297,12 @@ Unit::Unit() :
     // m_AurasCheck = 2000;
     // m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procCandidateFlags = 0;
+
+    m_periodicAuraLogCountPos = 0;
+    m_periodicAuraLogCount = 0;
+    m_periodicAuraLogSpellId = 0;
+    m_periodicAuraLogBatching = false;
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -303,6 +310,8 @@ Unit::Unit() :
 
     m_transform = 0;
     m_canModifyStats = false;
+    m_deferStatUpdates = 0;
+    m_dirtyStatMods = 0;
 
     for (auto& i : m_spellImmune)
         i.clear();
@@ -5503,6 +5512,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     if (m_spellUpdateHappening)
         holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    AddProcCandidate(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -6125,6 +6135,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            RemoveProcCandidate(holder);
             break;
         }
     }
@@ -6175,7 +6186,10 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        AuraList& auras = m_modAuras[Aur->GetModifier()->m_auraname];
+        if (!auras.HasHoles())
+            m_fragmentedAuraTypes.push_back(Aur->GetModifier()->m_auraname);
+        auras.remove(Aur);
     }
 
     // Set remove mode
@@ -6667,16 +6681,29 @@ void Unit::SendSpellNonMeleeDamageLog(Unit* target, uint32 spellID, uint32 damag
     SendSpellNonMeleeDamageLog(&log);
 }
 
-void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo) const
+void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
 {
     Aura* aura = pInfo->aura;
     Modifier* mod = aura->GetModifier();
 
-    WorldPacket data(SMSG_PERIODICAURALOG, 30);
-    data << aura->GetTarget()->GetPackGUID();
-    data << aura->GetCasterGuid().WriteAsPacked();
-    data << uint32(aura->GetId());                          // spellId
-    data << uint32(1);                                      // count
+    // the packet is for one caster and spell, a tick of another one closes it
+    if (m_periodicAuraLogCount && (m_periodicAuraLogCaster != aura->GetCasterGuid() || m_periodicAuraLogSpellId != aura->GetId()))
+        SendPeriodicAuraLogBatch();
+
+    WorldPacket& data = m_periodicAuraLog;
+    if (!m_periodicAuraLogCount)
+    {
+        data.Initialize(SMSG_PERIODICAURALOG, 30);
+        data << aura->GetTarget()->GetPackGUID();
+        data << aura->GetCasterGuid().WriteAsPacked();
+        data << uint32(aura->GetId());                      // spellId
+        m_periodicAuraLogCountPos = data.wpos();
+        data << uint32(0);                                  // count, set when sent
+        m_periodicAuraLogCaster = aura->GetCasterGuid();
+        m_periodicAuraLogSpellId = aura->GetId();
+    }
+
+    size_t const entryPos = data.wpos();
     data << uint32(mod->m_auraname);                        // auraId
     switch (mod->m_auraname)
     {
@@ -6708,10 +6735,23 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo) const
             break;
         default:
             sLog.outError("Unit::SendPeriodicAuraLog: unknown aura %u", uint32(mod->m_auraname));
+            data.resize(entryPos);
             return;
     }
+    ++m_periodicAuraLogCount;
+
+    if (!m_periodicAuraLogBatching)
+        SendPeriodicAuraLogBatch();
+}
+
+void Unit::SendPeriodicAuraLogBatch()
+{
+    if (!m_periodicAuraLogCount)
+        return;
 
-    aura->GetTarget()->SendMessageToSet(data, true);
+    m_periodicAuraLog.put<uint32>(m_periodicAuraLogCountPos, m_periodicAuraLogCount);
+    m_periodicAuraLogCount = 0;
+    SendMessageToSet(m_periodicAuraLog, true);
 }
 
 void Unit::SendSpellMiss(Unit* target, uint32 spellID, SpellMissInfo missInfo) const
@@ -6917,7 +6957,10 @@ void Unit::SendAttackStateUpdate(CalcDamageInfo* calcDamageInfo) const
         data << uint32(0);
     }
 
-    SendMessageToSet(data, true);
+    if (CombatLogBatch* combatLog = CombatLogBatch::Current())
+        combatLog->Add(this, data);
+    else
+        SendMessageToSet(data, true);
 }
 
 void Unit::SendAttackStateUpdate(uint32 HitInfo, Unit* target, SpellSchoolMask damageSchoolMask, uint32 Damage,
@@ -9618,7 +9661,22 @@ int32 Unit::ModifyPower(Powers power, int32 dVal)
     return gain;
 }
 
-bool Unit::IsVisibleForOrDetect(Unit const* u, WorldObject const* viewPoint, bool detect, bool /*inVisibleList*/, bool is3dDistance, bool spell) const
+bool Unit::IsImportantForVisibilityOf(Player const* viewer) const
+{
+    if (GetMasterGuid() == viewer->GetObjectGuid() || Unit::IsInGroup(viewer))
+        return true;
+
+    if (viewer->GetSelectionGuid() == GetObjectGuid() || GetTargetGuid() == viewer->GetObjectGuid())
+        return true;
+
+    if (GetVictim() == viewer || viewer->GetVictim() == this)
+        return true;
+
+    // creatures fighting the viewer without targeting it
+    return IsInCombat() && CanHaveThreatList() && const_cast<Unit*>(this)->getThreatManager().HasThreat(const_cast<Player*>(viewer));
+}
+
+bool Unit::IsVisibleForOrDetect(Unit const* u, WorldObject const* viewPoint, bool detect, bool inVisibleList, bool is3dDistance, bool spell) const
 {
     if (!u || !IsInMap(u))
         return false;
@@ -9663,6 +9721,19 @@ bool Unit::IsVisibleForOrDetect(Unit const* u, WorldObject const* viewPoint, boo
     {
         if (!IsWithinDistInMap(viewPoint, u->GetVisibilityData().GetVisibilityDistanceFor((WorldObject *)this), is3dDistance))
             return false;
+
+        // crowded zone, only what matters to the player is seen from the full distance
+        if (u->GetTypeId() == TYPEID_PLAYER && !GetVisibilityData().IsVisibilityOverridden())
+        {
+            if (float crowdDistance = _map.GetCrowdVisibilityDistance(u->GetZoneId()))
+            {
+                // units already seen get a few more yards, so they don't flicker at the edge
+                if (inVisibleList)
+                    crowdDistance += 5.0f;
+                if (!IsWithinDistInMap(viewPoint, crowdDistance, is3dDistance) && !IsImportantForVisibilityOf(static_cast<Player const*>(u)))
+                    return false;
+            }
+        }
     }
 
     // always seen by owner
@@ -9766,19 +9837,32 @@ bool Unit::IsVisibleForOrDetect(Unit const* u, WorldObject const* viewPoint, boo
         return false;
 
     // if doesn't have stealth detection (Shadow Sight), then check how stealthy the unit is, otherwise just check los
-    if (!u->HasAuraType(SPELL_AURA_DETECT_STEALTH))
+    bool detectAll = u->HasAuraType(SPELL_AURA_DETECT_STEALTH);
+    float stealthDistance = -1.0f;
+    if (!detectAll)
+        stealthDistance = std::max(0.0f, GetVisibilityData().GetStealthVisibilityDistance(u, HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED)));
+
+    // the range and LoS result holds while both stay in place, the cache key covers the distance too
+    StealthDetectionCache* cache = sWorld.getConfig(CONFIG_BOOL_STEALTH_DETECTION_CACHE) && IsInWorld() ? &GetMap()->GetStealthDetectionCache() : nullptr;
+    StealthDetectionCache::Key key(this, viewPoint, stealthDistance);
+    bool visible;
+    if (cache && cache->Find(GetObjectGuid(), u->GetObjectGuid(), key, visible))
+        return visible;
+
+    // recheck new distance
+    if (!detectAll && (stealthDistance <= 0.0f || GetDistance(viewPoint, true, DIST_CALC_NONE) > stealthDistance * stealthDistance))
+        visible = false;
+    else
     {
-        visibleDistance = GetVisibilityData().GetStealthVisibilityDistance(u, HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED));
-
-        // recheck new distance
-        if (visibleDistance <= 0 || GetDistance(viewPoint, true, DIST_CALC_NONE) > visibleDistance * visibleDistance)
-            return false;
+        // Now check is target visible with LoS
+        float x, y, z;
+        viewPoint->GetPosition(x, y, z);
+        visible = IsWithinLOS(x, y, z + viewPoint->GetCollisionHeight());
     }
 
-    // Now check is target visible with LoS
-    float x, y, z;
-    viewPoint->GetPosition(x, y, z);
-    return IsWithinLOS(x, y, z + viewPoint->GetCollisionHeight());
+    if (cache)
+        cache->Store(GetObjectGuid(), u->GetObjectGuid(), key, visible);
+    return visible;
 }
 
 void Unit::UpdateVisibilityAndView()
@@ -9797,7 +9881,6 @@ void Unit::UpdateVisibilityAndView()
 
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -10567,6 +10650,19 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
     if (!CanModifyStats())
         return false;
 
+    // a batch of changes recalculates each touched group once in ApplyDeferredStatUpdates
+    if (m_deferStatUpdates)
+    {
+        m_dirtyStatMods |= uint64(1) << unitMod;
+        return true;
+    }
+
+    UpdateModifierGroup(unitMod);
+    return true;
+}
+
+void Unit::UpdateModifierGroup(UnitMods unitMod)
+{
     switch (unitMod)
     {
         case UNIT_MOD_STAT_STRENGTH:
@@ -10603,8 +10699,31 @@ bool Unit::HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, f
         default:
             break;
     }
+}
 
-    return true;
+void Unit::ApplyDeferredStatUpdates()
+{
+    MANGOS_ASSERT(m_deferStatUpdates);
+    if (--m_deferStatUpdates)
+        return;
+
+    uint64 dirtyMods = m_dirtyStatMods;
+    m_dirtyStatMods = 0;
+    if (!dirtyMods || !CanModifyStats())
+        return;
+
+    // every primary stat update already recalculates its dependents, past one of them a full update is cheaper
+    uint64 const primaryStatMods = ((uint64(1) << (UNIT_MOD_STAT_END - UNIT_MOD_STAT_START)) - 1) << UNIT_MOD_STAT_START;
+    uint64 const dirtyPrimaryStats = dirtyMods & primaryStatMods;
+    if (dirtyPrimaryStats && (dirtyPrimaryStats & (dirtyPrimaryStats - 1)))
+    {
+        UpdateAllStats();
+        return;
+    }
+
+    for (uint32 unitMod = 0; unitMod < UNIT_MOD_END; ++unitMod)
+        if (dirtyMods & (uint64(1) << unitMod))
+            UpdateModifierGroup(UnitMods(unitMod));
 }
 
 float Unit::GetModifierValue(UnitMods unitMod, UnitModifierType modifierType) const
@@ -10954,6 +11073,7 @@ uint32 Unit::GetCreatePowers(Powers power) const
 void Unit::AddToWorld()
 {
     WorldObject::AddToWorld();
+    GetMap()->GetTriggerVolumes().OnUnitMoved(GetPositionX(), GetPositionY(), GetCombatReach());
     ScheduleAINotify(GetTypeId() == TYPEID_UNIT && !HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? sWorld.getConfig(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY) : 0);
 }
 
@@ -12540,6 +12660,11 @@ void Unit::CleanupDeletedAuras()
     for (AuraList::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
         delete *itr;
     m_deletedAuras.clear();
+
+    // nothing iterates the aura lists here, drop the holes left by removed auras
+    for (uint32 auraType : m_fragmentedAuraTypes)
+        m_modAuras[auraType].Compact();
+    m_fragmentedAuraTypes.clear();
 }
 
 bool Unit::CheckAndIncreaseCastCounter()
@@ -12616,20 +12741,19 @@ class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
 
         bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
         {
-            float radius = MAX_CREATURE_ATTACK_RADIUS * sWorld.getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO);
-            if (m_owner.GetTypeId() == TYPEID_PLAYER)
-            {
-                MaNGOS::PlayerVisitObjectsNotifier notify(static_cast<Player&>(m_owner));
-                Cell::VisitAllObjects(&m_owner, notify, radius);
-            }
-            else // if(m_owner.GetTypeId() == TYPEID_UNIT)
+            if (m_owner.GetTypeId() == TYPEID_UNIT)
             {
                 Creature& creature = static_cast<Creature&>(m_owner);
                 //since visitor was called we override can aggro with true if creature is alive
                 creature.SetCanAggro(creature.IsAlive());
-                MaNGOS::CreatureVisitObjectsNotifier notify(creature);
-                Cell::VisitAllObjects(&m_owner, notify, radius);
             }
+
+            // gathered by the map and walked together after its object updates
+            if (sWorld.getConfig(CONFIG_BOOL_AI_NOTIFY_BATCH))
+                m_owner.GetMap()->AddAINotifyUnit(&m_owner);
+            else
+                m_owner.VisitObjectsInRangeForAI();
+
             m_owner.FinalizeAINotifyEvent();
             return true;
         }
@@ -12643,6 +12767,21 @@ class UnitVisitObjectsInRangeNotifyEvent : public BasicEvent
         Unit & m_owner;
 };
 
+void Unit::VisitObjectsInRangeForAI(GuidHashSet const* notified)
+{
+    float radius = MAX_CREATURE_ATTACK_RADIUS * sWorld.getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO);
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        MaNGOS::PlayerVisitObjectsNotifier notify(static_cast<Player&>(*this), notified);
+        Cell::VisitAllObjects(this, notify, radius);
+    }
+    else // if(GetTypeId() == TYPEID_UNIT)
+    {
+        MaNGOS::CreatureVisitObjectsNotifier notify(static_cast<Creature&>(*this), notified);
+        Cell::VisitAllObjects(this, notify, radius);
+    }
+}
+
 void Unit::ScheduleAINotify(uint32 delay, bool forced)
 {
     if (!IsAINotifyScheduled())
@@ -12676,14 +12815,24 @@ void Unit::OnRelocated()
     float distsq = dx * dx + dy * dy + dz * dz;
     if (distsq > World::GetRelocationLowerLimitSq())
     {
-        m_last_notified_position.x = GetPositionX();
-        m_last_notified_position.y = GetPositionY();
-        m_last_notified_position.z = GetPositionZ();
-
-        GetViewPoint().Call_UpdateVisibilityForOwner();
-        UpdateObjectVisibility();
+        // gathered by the map and done after its object updates
+        if (sWorld.getConfig(CONFIG_BOOL_RELOCATION_BATCH))
+            GetMap()->AddRelocatedUnit(this);
+        else
+            UpdateVisibilityAfterRelocation();
     }
     ScheduleAINotify(World::GetRelocationAINotifyDelay());
+    GetMap()->GetTriggerVolumes().OnUnitMoved(GetPositionX(), GetPositionY(), GetCombatReach());
+}
+
+void Unit::UpdateVisibilityAfterRelocation()
+{
+    m_last_notified_position.x = GetPositionX();
+    m_last_notified_position.y = GetPositionY();
+    m_last_notified_position.z = GetPositionZ();
+
+    GetViewPoint().Call_UpdateVisibilityForOwner();
+    UpdateObjectVisibility();
 }
 
 /**
@@ -12879,7 +13028,7 @@ Unit* Unit::TakePossessOf(SpellEntry const* spellEntry, SummonPropertiesEntry co
         return nullptr;
     }
 
-    TemporarySpawn* possessed = new TemporarySpawn(GetObjectGuid());
+    TemporarySpawn* possessed = new (GetMap()) TemporarySpawn(GetObjectGuid());
 
     CreatureCreatePos pos(GetMap(), x, y, z, ang, GetPhaseMask());
 
@@ -13540,11 +13689,13 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed, bool interruptPositiveSpe
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
-                if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
+        target->m_events.ForEachEvent([this](BasicEvent* basicEvent)
+        {
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(basicEvent))
+                if (event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
+        });
     }
 }
 
@@ -46,9 +46,11 @@
 #include "AI/BaseAI/UnitAI.h"
 #include "PlayerDefines.h"
 #include "Spells/SpellDefines.h"
+#include "Spells/AuraPtrList.h"
 
 #include <list>
 #include <array>
+#include <atomic>
 
 enum SpellInterruptFlags
 {
@@ -269,6 +271,7 @@ class Item;
 class Pet;
 class PetAura;
 class Totem;
+class GuidHashSet;
 class SpellCastTargets;
 class VehicleInfo;
 
@@ -1100,7 +1103,7 @@ class Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef AuraPtrList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<uint8 /*slot*/, uint32 /*spellId*/> VisibleAuraMap;
@@ -1484,6 +1487,10 @@ class Unit : public WorldObject
 
         static void ProcDamageAndSpell(ProcSystemArguments&& data);
         void ProcDamageAndSpellFor(ProcSystemArguments& data, bool isVictim);
+#ifdef BUILD_METRICS
+        // holders on the procing units, holders walked by the proc system and holders that procced, since the last call
+        static void GetProcIndexStats(uint64& holders, uint64& candidates, uint64& triggered);
+#endif
         void ProcSkillsAndReactives(bool isVictim, Unit* target, uint32 procFlags, uint32 procEx, WeaponAttackType attType);
 
         void HandleEmote(uint32 emote_id);                  // auto-select command/state
@@ -1742,7 +1749,10 @@ class Unit : public WorldObject
         void SendHealSpellLog(Unit* pVictim, uint32 SpellID, uint32 Damage, uint32 OverHeal, bool critical = false, uint32 absorb = 0) const;
         void SendSpellNonMeleeDamageLog(SpellNonMeleeDamage* log) const;
         void SendSpellNonMeleeDamageLog(Unit* target, uint32 spellID, uint32 damage, SpellSchoolMask damageSchoolMask, uint32 absorbedDamage, int32 resist, bool isPeriodic, uint32 blocked, bool criticalHit = false, bool split = false);
-        void SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo) const;
+        void SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo);
+        // the logs of the effects of a holder ticking in one update are sent as one SMSG_PERIODICAURALOG
+        void StartPeriodicAuraLogBatch() { m_periodicAuraLogBatching = true; }
+        void FinishPeriodicAuraLogBatch() { m_periodicAuraLogBatching = false; SendPeriodicAuraLogBatch(); }
         void SendSpellMiss(Unit* target, uint32 spellID, SpellMissInfo missInfo) const;
         void SendSpellDamageResist(Unit* target, uint32 spellId) const;
         static void SendSpellOrDamageImmune(ObjectGuid casterGuid, Unit* target, uint32 spellId);
@@ -2014,6 +2024,7 @@ class Unit : public WorldObject
 
         // stat system
         bool HandleStatModifier(UnitMods unitMod, UnitModifierType modifierType, float amount, bool apply);
+        void UpdateModifierGroup(UnitMods unitMod);
         void SetModifierValue(UnitMods unitMod, UnitModifierType modifierType, float value) { m_auraModifiersGroup[unitMod][modifierType] = value; }
         float GetModifierValue(UnitMods unitMod, UnitModifierType modifierType) const;
         float GetTotalStatValue(Stats stat) const;
@@ -2024,6 +2035,9 @@ class Unit : public WorldObject
         Powers GetPowerTypeByAuraGroup(UnitMods unitMod) const;
         bool CanModifyStats() const { return m_canModifyStats; }
         void SetCanModifyStats(bool modifyStats) { m_canModifyStats = modifyStats; }
+        // between the two only the modifier groups are changed, the touched groups are recalculated once at the end
+        void DeferStatUpdates() { ++m_deferStatUpdates; }
+        void ApplyDeferredStatUpdates();
         virtual bool UpdateStats(Stats stat) = 0;
         virtual bool UpdateAllStats() = 0;
         virtual void UpdateResistances(uint32 school) = 0;
@@ -2061,6 +2075,8 @@ class Unit : public WorldObject
 
         // common function for visibility checks for player/creatures with detection code
         bool IsVisibleForOrDetect(Unit const* u, WorldObject const* viewPoint, bool detect, bool inVisibleList = false, bool is3dDistance = true, bool spell = false) const;
+        // group members, targets and combat opponents are kept visible in crowded zones
+        bool IsImportantForVisibilityOf(Player const* viewer) const;
         void SetPhaseMask(uint32 newPhaseMask, bool update) override; // overwrite WorldObject::SetPhaseMask
 
         // virtual functions for all world objects types
@@ -2350,7 +2366,10 @@ class Unit : public WorldObject
         bool IsAINotifyScheduled() const { return m_AINotifyEvent != nullptr;}
         void FinalizeAINotifyEvent() { m_AINotifyEvent = nullptr; }
         void AbortAINotifyEvent();
+        // MoveInLineOfSight between this unit and the units around it, except the ones in notified
+        void VisitObjectsInRangeForAI(GuidHashSet const* notified = nullptr);
         void OnRelocated();
+        void UpdateVisibilityAfterRelocation();
 
 
         bool IsLinkingEventTrigger() const { return m_isCreatureLinkingTrigger; }
@@ -2475,6 +2494,30 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+
+        // holders the proc system has to look at, kept in m_spellAuraHolders order with the proc flags each one reacts to
+        struct ProcCandidate
+        {
+            SpellAuraHolder* holder;
+            uint32 procFlags;
+        };
+        void AddProcCandidate(SpellAuraHolder* holder);
+        void RemoveProcCandidate(SpellAuraHolder* holder);
+        std::vector<ProcCandidate> m_procCandidates;
+        uint32 m_procCandidateFlags;                        // proc flags of all candidates, checked before walking them
+
+        void SendPeriodicAuraLogBatch();
+        WorldPacket m_periodicAuraLog;                      // reused, a tick does not allocate its log
+        size_t m_periodicAuraLogCountPos;
+        uint32 m_periodicAuraLogCount;
+        ObjectGuid m_periodicAuraLogCaster;
+        uint32 m_periodicAuraLogSpellId;
+        bool m_periodicAuraLogBatching;
+#ifdef BUILD_METRICS
+        static std::atomic<uint64> m_procHolders;
+        static std::atomic<uint64> m_procCandidatesVisited;
+        static std::atomic<uint64> m_procTriggered;
+#endif
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
@@ -2493,11 +2536,15 @@ class Unit : public WorldObject
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+        std::vector<uint32> m_fragmentedAuraTypes;          // aura types with removed auras left in m_modAuras until CleanupDeletedAuras
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
 
         bool m_canModifyStats;
+        uint32 m_deferStatUpdates;
+        uint64 m_dirtyStatMods;                             // bits of the UnitMods changed while stat updates are deferred
+        static_assert(UNIT_MOD_END <= 64, "m_dirtyStatMods has a bit per UnitMods");
         // std::list< spellEffectPair > AuraSpells[TOTAL_AURAS];  // TODO: use this if ok for mem
         VisibleAuraMap m_visibleAuras;
 
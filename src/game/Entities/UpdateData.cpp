@@ -32,7 +32,7 @@ UpdateData::UpdateData() : m_data(1), m_currentIndex(0)
     m_data[0].m_buffer = 0;
 }
 
-void UpdateData::AddOutOfRangeGUID(GuidSet& guids)
+void UpdateData::AddOutOfRangeGUID(GuidHashSet const& guids)
 {
     m_outOfRangeGUIDs.insert(guids.begin(), guids.end());
 }
@@ -60,29 +60,78 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     }
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+// deflate stream kept alive for the whole life of a thread, setting up zlib state for every
+// update packet costs more than compressing most of them
+class UpdateDataDeflateStream
 {
-    z_stream c_stream;
+    public:
+        UpdateDataDeflateStream() : m_initialized(false), m_level(0)
+        {
+            m_stream.zalloc = (alloc_func)nullptr;
+            m_stream.zfree = (free_func)nullptr;
+            m_stream.opaque = (voidpf)nullptr;
+        }
+
+        ~UpdateDataDeflateStream()
+        {
+            if (m_initialized)
+                deflateEnd(&m_stream);
+        }
+
+        // get stream ready for a new packet compressed with provided level, nullptr on failure
+        z_stream* Prepare(int level)
+        {
+            if (m_initialized && m_level == level)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return &m_stream;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+
+            if (m_initialized)
+            {
+                deflateEnd(&m_stream);
+                m_initialized = false;
+            }
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return nullptr;
+            }
+
+            m_initialized = true;
+            m_level = level;
+            return &m_stream;
+        }
+
+    private:
+        z_stream m_stream;
+        bool m_initialized;
+        int m_level;
+};
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+{
+    static thread_local UpdateDataDeflateStream deflateStream;
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = deflateStream.Prepare(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -90,14 +139,14 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -105,15 +154,7 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 WorldPacket UpdateData::BuildPacket(size_t index)
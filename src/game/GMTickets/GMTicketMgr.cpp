@@ -35,22 +35,13 @@
 template <typename T>
 static inline T clamp(T v, T lo, T hi) { return std::min(std::max(v, lo), hi); }
 
-bool GMTicket::Compare(GMTicket* a, GMTicket* b)
+GMTicketQueueKey GMTicket::GetQueueKey() const
 {
-    // 1) Open over closed (abandoned are stored in memory for recycling and should never appear in listings)
-    if (a->IsOpen() && !b->IsOpen())
-        return true;
-
-    // 2) Escalated over normal: should be picked up by another GM asap
-    if (a->IsEscalated() && !b->IsEscalated())
-        return true;
-
-    // 3) Read over unread: should be dealt with asap
-    if (a->IsSeen() && !b->IsSeen())
-        return true;
-
-    // Final: FIFO - older tickets over newer ones
-    return (a->GetCreatedAt() < b->GetCreatedAt());
+    // Only open tickets are queued (closed and abandoned are stored in memory for surveys and recycling and should never appear in listings)
+    // 1) Escalated over normal: should be picked up by another GM asap
+    // 2) Read over unread: should be dealt with asap
+    // Final: FIFO - older tickets over newer ones, the id keeps the key unique
+    return GMTicketQueueKey(!IsEscalated(), !IsSeen(), m_created, m_id);
 }
 
 GMTicket::GMTicket(Player* player, std::string message, uint8 category, time_t when/* = time(nullptr)*/)
@@ -154,6 +145,11 @@ void GMTicketMgr::Save(const GMTicket* ticket)
 {
     CharacterDatabase.PExecute("DELETE FROM gm_tickets WHERE id=%u", ticket->GetId());
 
+    Insert(ticket);
+}
+
+void GMTicketMgr::Insert(const GMTicket* ticket)
+{
     static SqlStatementID id;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(id,
@@ -363,12 +359,40 @@ void GMTicketMgr::LoadGMTickets()
 
     delete result;
 
-    m_list.sort(GMTicket::Compare);
-
     sLog.outString(">> Loaded " SIZEFMTD " GM tickets", GetTicketCount());
     sLog.outString();
 }
 
+void GMTicketMgr::SaveTicketChanges()
+{
+    if (m_changed.empty())
+        return;
+
+    // Every change rewrites the whole row
+    CharacterDatabase.BeginTransaction();
+    auto itr = m_changed.begin();
+    while (itr != m_changed.end())
+    {
+        std::ostringstream ss;
+        ss << "DELETE FROM gm_tickets WHERE id IN (" << *itr;
+        ++itr;
+        for (uint32 count = 1; count < 256 && itr != m_changed.end(); ++count, ++itr)
+            ss << "," << *itr;
+        ss << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+
+    for (uint32 id : m_changed)
+    {
+        auto ticket = m_tickets.find(id);
+        if (ticket != m_tickets.end())
+            Insert(ticket->second);
+    }
+    CharacterDatabase.CommitTransaction();
+
+    m_changed.clear();
+}
+
 void GMTicketMgr::Print(GMTicket const& ticket, WorldSession* session, time_t now/* = time(nullptr)*/)
 {
     const LocaleConstant locale = session->GetSessionDbcLocale();
@@ -554,16 +578,25 @@ void GMTicketMgr::PrintTicketList(WorldSession* session, std::ostringstream& out
     size_t count = 0;
     std::ostringstream tickets;
 
-    for (auto itr = m_list.begin(); (itr != m_list.end() && count < max); ++itr)
+    const GMTicketQueue* queue = &m_queue;
+
+    if (category)
     {
-        if ((*itr)->IsOpen() && (!category || (*itr)->GetCategory() == category->ID))
-        {
-            if (online && !sObjectMgr.GetPlayer((*itr)->GetAuthorGuid()))
-                continue;
+        auto itr = m_queueByCategory.find(uint8(category->ID));
 
-            tickets << "|" << PrintTicketSummaryLine(*(*itr), session->GetSessionDbcLocale());
-            ++count;
-        }
+        if (itr == m_queueByCategory.end())
+            return;
+
+        queue = &itr->second;
+    }
+
+    for (auto itr = queue->begin(); (itr != queue->end() && count < max); ++itr)
+    {
+        if (online && !sObjectMgr.GetPlayer(itr->second->GetAuthorGuid()))
+            continue;
+
+        tickets << "|" << PrintTicketSummaryLine(*itr->second, session->GetSessionDbcLocale());
+        ++count;
     }
 
     // No tickets found
@@ -731,20 +764,22 @@ void GMTicketMgr::ShowMOTD(Player &gm) const
         uint32 assignedCount = 0, escalatedCount = 0;
         std::deque<GMTicket*> assignedOnline;
 
-        for (auto itr = m_list.begin(); itr != m_list.end(); ++itr)
+        // Escalated tickets are at the front of the queue
+        for (auto itr = m_queue.begin(); itr != m_queue.end() && itr->second->IsEscalated(); ++itr)
+            ++escalatedCount;
+
+        auto assigned = m_assigned.find(guid);
+
+        if (assigned != m_assigned.end())
         {
-            if ((*itr)->IsOpen())
+            for (uint32 id : assigned->second)
             {
-                if ((*itr)->IsEscalated())
-                    ++escalatedCount;
+                GMTicket* ticket = m_tickets.find(id)->second;
 
-                if ((*itr)->GetAssigneeGuid() == guid)
-                {
-                    ++assignedCount;
+                ++assignedCount;
 
-                    if (const Player* player = sObjectMgr.GetPlayer((*itr)->GetAuthorGuid()))
-                        assignedOnline.push_back((*itr));
-                }
+                if (const Player* player = sObjectMgr.GetPlayer(ticket->GetAuthorGuid()))
+                    assignedOnline.push_back(ticket);
             }
         }
 
@@ -857,12 +892,14 @@ GMTicket* GMTicketMgr::GetTicketByPlayer(ObjectGuid playerGuid, GMTicketState st
 {
     if (playerGuid.IsPlayer())
     {
-        GMTicket* ticket;
+        auto author = m_byAuthor.find(playerGuid);
+
+        if (author == m_byAuthor.end())
+            return nullptr;
 
-        for (auto itr = m_tickets.begin(); itr != m_tickets.end(); ++itr)
+        for (GMTicket* ticket : author->second)
         {
-            ticket = itr->second;
-            if (ticket && ticket->GetState() == state && ticket->GetAuthorGuid() == playerGuid && (!assigneeGuid.IsPlayer() || (ticket->IsAssigned() && ticket->IsAssignedTo(assigneeGuid))))
+            if (ticket->GetState() == state && ticket->GetAuthorGuid() == playerGuid && (!assigneeGuid.IsPlayer() || (ticket->IsAssigned() && ticket->IsAssignedTo(assigneeGuid))))
                 return ticket;
         }
     }
@@ -903,14 +940,14 @@ bool GMTicketMgr::Add(GMTicket* ticket, bool loading/* = false*/)
     if (!m_tickets.insert({ticket->GetId(), ticket}).second)
         return true;
 
-    m_list.push_back(ticket);
+    Index(ticket);
 
     if (ticket->IsOpen())
         ++m_currentTicketCountOpen;
 
     if (!loading)
     {
-        Save(ticket);
+        m_changed.insert(ticket->GetId());
 
         sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_NEW, ticket->GetIdTag().c_str(), ticket->GetAuthorName());
     }
@@ -930,9 +967,7 @@ bool GMTicketMgr::Recycle(GMTicket* ticket)
 
     ticket->SetState(GMTICKET_STATE_OPEN);
 
-    Save(ticket);
-
-    m_list.sort(GMTicket::Compare);
+    Changed(ticket);
 
     sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_NEW, ticket->GetIdTag().c_str(), ticket->GetAuthorName());
 
@@ -965,7 +1000,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Abandon(GMTicket* ticket)
 
     ticket->SetState(GMTICKET_STATE_ABANDONED);
 
-    Save(ticket);
+    Changed(ticket);
 
     sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_ABANDONED, ticket->GetIdTag().c_str());
 
@@ -1008,12 +1043,10 @@ GMTicketMgr::CommandResult GMTicketMgr::Escalate(GMTicket* ticket, WorldSession*
 
     ticket->SetAssignee(level);
 
-    Save(ticket);
+    Changed(ticket);
 
     if (initial)
     {
-        m_list.sort(GMTicket::Compare);
-
         if (Player* character = sObjectMgr.GetPlayer(ticket->GetAuthorGuid()))
             character->GetSession()->SendGMTicketResult(SMSG_GM_TICKET_STATUS_UPDATE, GMTICKET_STATUS_UPDATED);
     }
@@ -1039,7 +1072,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Comment(GMTicket* ticket, WorldSession*
         ticket->AddNote(output.str());
     }
 
-    Save(ticket);
+    Changed(ticket);
 
     sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_COMMENTARY, ticket->GetIdTag().c_str(), session->GetPlayerName());
 
@@ -1058,12 +1091,10 @@ GMTicketMgr::CommandResult GMTicketMgr::Read(GMTicket* ticket)
 
     ticket->SetSeen(time(nullptr));
 
-    Save(ticket);
+    Changed(ticket);
 
     if (unread)
     {
-        m_list.sort(GMTicket::Compare);
-
         if (Player* character = sObjectMgr.GetPlayer(ticket->GetAuthorGuid()))
             character->GetSession()->SendGMTicketResult(SMSG_GM_TICKET_STATUS_UPDATE, GMTICKET_STATUS_UPDATED);
     }
@@ -1082,7 +1113,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Sort(GMTicket* ticket, const GMTicketCat
     {
         ticket->SetCategory(uint8(category.ID));
 
-        Save(ticket);
+        Changed(ticket);
 
         sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_CATEGORY, ticket->GetIdTag().c_str(), PrintTicketCategory(*ticket, sWorld.GetDefaultDbcLocale()), category.ID, session->GetPlayerName());
 
@@ -1107,9 +1138,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Update(GMTicket* ticket, const std::stri
 
     ticket->SetUpdated(text);
 
-    Save(ticket);
-
-    m_list.sort(GMTicket::Compare);
+    Changed(ticket);
 
     if (deescalation)
          sWorld.SendWorldTextToAcceptingTickets(LANG_TICKET_BROADCAST_DEESCALATION, ticket->GetIdTag().c_str());
@@ -1139,7 +1168,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Whisper(GMTicket *ticket, const std::str
         ticket->SetAssignee(session->GetSecurity(), session);
         ticket->SetAnswered(time(nullptr));
 
-        Save(ticket);
+        Changed(ticket);
 
         if (assignment)
         {
@@ -1167,15 +1196,10 @@ bool GMTicketMgr::SetSystemStatus(bool status)
     sWorld.SendGlobalMessage(data);
 
     // Do loop over open tickets, poke online clients to initiate ticket update
-    for (auto itr = m_tickets.begin(); itr != m_tickets.end(); ++itr)
+    for (auto itr = m_queue.begin(); itr != m_queue.end(); ++itr)
     {
-        GMTicket* t = itr->second;
-
-        if (t && t->IsOpen())
-        {
-            if (Player* character = sObjectMgr.GetPlayer(t->GetAuthorGuid()))
-                character->GetSession()->SendGMTicketResult(SMSG_GM_TICKET_STATUS_UPDATE, GMTICKET_STATUS_UPDATED);
-        }
+        if (Player* character = sObjectMgr.GetPlayer(itr->second->GetAuthorGuid()))
+            character->GetSession()->SendGMTicketResult(SMSG_GM_TICKET_STATUS_UPDATE, GMTICKET_STATUS_UPDATED);
     }
 
     return true;
@@ -1248,12 +1272,16 @@ GMTicketMgr::CommandResult GMTicketMgr::CanWhisper(const GMTicket* ticket, World
 
 bool GMTicketMgr::Remove(GMTicket& ticket)
 {
-    m_list.remove(&ticket);
-
     auto itr = m_tickets.find(ticket.GetId());
 
     if (itr != m_tickets.end())
     {
+        // Last change was not written yet
+        if (m_changed.erase(ticket.GetId()))
+            Save(&ticket);
+
+        Unindex(&ticket);
+
         m_tickets.erase(itr);
 
         if (ticket.IsOpen())
@@ -1268,11 +1296,17 @@ bool GMTicketMgr::Remove(GMTicket& ticket)
 
 void GMTicketMgr::RemoveAll()
 {
+    SaveTicketChanges();
+
     for (auto itr = m_tickets.begin(); itr != m_tickets.end(); ++itr)
         delete itr->second;
 
     m_tickets.clear();
-    m_list.clear();
+    m_queue.clear();
+    m_queueByCategory.clear();
+    m_assigned.clear();
+    m_byAuthor.clear();
+    m_indexed.clear();
 
     m_currentTicketCountOpen = 0;
 }
@@ -1305,7 +1339,7 @@ GMTicketMgr::CommandResult GMTicketMgr::Close(GMTicket* ticket, const std::strin
 
     ticket->SetConclusion(conclusion);
 
-    Save(ticket);
+    Changed(ticket);
 
     Player* character = sObjectMgr.GetPlayer(ticket->GetAuthorGuid());
 
@@ -1349,14 +1383,14 @@ void GMTicketMgr::UpdateTicketQueueStats(GMTicket& closed, time_t when)
     m_statsCurrentTotalResolutionDays += GetDaysPassed(when, closed.GetCreatedAt());
     m_statsAverageResolutionDays = (m_statsCurrentTotalResolutionDays / m_currentTicketCountClosed);
 
-    // Order of the list is the FIFO queue's order, declared in GMTicket::Compare
+    // Order of the queue is the FIFO queue's order, declared in GMTicket::GetQueueKey
     // Do loop over queued tickets, record first (oldest) new non-escalated queued ticket's time since creation
-    for (auto itr = m_list.begin(); itr != m_list.end(); ++itr)
+    for (auto itr = m_queue.begin(); itr != m_queue.end(); ++itr)
     {
-        if ((*itr) && (*itr)->IsOpen() && !(*itr)->IsEscalated() && !(*itr)->IsSeen())
+        if (!itr->second->IsEscalated() && !itr->second->IsSeen())
         {
             m_statsOldestTicketAgeLastUpdate = when;
-            m_statsOldestTicketAgeDays = GetTicketAgeDays(when, (*itr)->GetCreatedAt());
+            m_statsOldestTicketAgeDays = GetTicketAgeDays(when, itr->second->GetCreatedAt());
             UpdateTicketQueueTimers(&closed);
             break;
         }
@@ -1366,14 +1400,91 @@ void GMTicketMgr::UpdateTicketQueueStats(GMTicket& closed, time_t when)
 void GMTicketMgr::UpdateTicketQueueTimers(GMTicket* except/* = nullptr*/) const
 {
     // Do loop over open tickets, poke online clients to initiate ticket waiting time update
-    for (auto itr = m_tickets.begin(); itr != m_tickets.end(); ++itr)
+    for (auto itr = m_queue.begin(); itr != m_queue.end(); ++itr)
     {
         GMTicket* t = itr->second;
 
-        if (t && t != except && t->IsOpen() && !t->IsSeen() && !t->IsEscalated())
+        if (t != except && !t->IsSeen() && !t->IsEscalated())
         {
             if (Player* character = sObjectMgr.GetPlayer(t->GetAuthorGuid()))
                 character->GetSession()->SendGMTicketResult(SMSG_GM_TICKET_STATUS_UPDATE, GMTICKET_STATUS_UPDATED);
         }
     }
 }
+
+void GMTicketMgr::Changed(GMTicket* ticket)
+{
+    Unindex(ticket);
+    Index(ticket);
+
+    m_changed.insert(ticket->GetId());
+}
+
+void GMTicketMgr::Index(GMTicket* ticket)
+{
+    IndexedTicket& indexed = m_indexed[ticket->GetId()];
+    indexed.queued = ticket->IsOpen();
+    indexed.key = ticket->GetQueueKey();
+    indexed.category = ticket->GetCategory();
+    indexed.assigneeGuid = (indexed.queued ? ticket->GetAssigneeGuid() : ObjectGuid());
+    indexed.authorGuid = ticket->GetAuthorGuid();
+
+    if (indexed.queued)
+    {
+        m_queue[indexed.key] = ticket;
+        m_queueByCategory[indexed.category][indexed.key] = ticket;
+
+        // Escalated tickets keep their last assignee
+        if (!indexed.assigneeGuid.IsEmpty())
+            m_assigned[indexed.assigneeGuid].insert(ticket->GetId());
+    }
+
+    m_byAuthor[indexed.authorGuid].push_back(ticket);
+}
+
+void GMTicketMgr::Unindex(GMTicket* ticket)
+{
+    auto itr = m_indexed.find(ticket->GetId());
+
+    if (itr == m_indexed.end())
+        return;
+
+    const IndexedTicket& indexed = itr->second;
+
+    if (indexed.queued)
+    {
+        m_queue.erase(indexed.key);
+
+        auto category = m_queueByCategory.find(indexed.category);
+
+        if (category != m_queueByCategory.end())
+        {
+            category->second.erase(indexed.key);
+
+            if (category->second.empty())
+                m_queueByCategory.erase(category);
+        }
+
+        auto assigned = m_assigned.find(indexed.assigneeGuid);
+
+        if (assigned != m_assigned.end())
+        {
+            assigned->second.erase(ticket->GetId());
+
+            if (assigned->second.empty())
+                m_assigned.erase(assigned);
+        }
+    }
+
+    auto author = m_byAuthor.find(indexed.authorGuid);
+
+    if (author != m_byAuthor.end())
+    {
+        author->second.remove(ticket);
+
+        if (author->second.empty())
+            m_byAuthor.erase(author);
+    }
+
+    m_indexed.erase(itr);
+}
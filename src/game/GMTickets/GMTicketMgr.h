@@ -26,6 +26,9 @@
 #include <string>
 #include <map>
 #include <list>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <time.h>
 
 enum GMTicketSystemStatus : uint8
@@ -90,13 +93,16 @@ enum GMTicketMgrChatAlert : uint8
     GMTICKETMGR_CHAT_ESCALATED  = 4,
 };
 
+// Order of the open tickets queue, see GMTicket::GetQueueKey
+typedef std::tuple<bool, bool, time_t, uint32> GMTicketQueueKey;
+
 class GMTicket
 {
     public:
         explicit GMTicket(Player* player, std::string message, uint8 category, time_t when = time(nullptr));
         explicit GMTicket(Field* fields) { Load(fields); }
 
-        static bool Compare(GMTicket* a, GMTicket* b);
+        GMTicketQueueKey GetQueueKey() const;
 
         void Load(Field* fields);
         inline void Save(SqlStatement& stmt) const;
@@ -190,6 +196,7 @@ class GMTicket
 
 typedef std::map<uint32, GMTicket*> GMTicketMap;
 typedef std::list<GMTicket*> GMTicketList;
+typedef std::map<GMTicketQueueKey, GMTicket*> GMTicketQueue;
 
 class GMSurveyResult
 {
@@ -230,6 +237,9 @@ class GMTicketMgr
 
         void LoadGMTickets();
 
+        // Writes the tickets changed since the last call, in one transaction
+        void SaveTicketChanges();
+
         static void Save(const GMTicket* ticket);
         static void Save(const GMSurveyResult* survey);
 
@@ -293,6 +303,12 @@ class GMTicketMgr
         bool Remove(GMTicket& ticket);
         void RemoveAll();
 
+        // Indexes are refreshed and the ticket is queued for saving after every change
+        void Changed(GMTicket* ticket);
+        void Index(GMTicket* ticket);
+        void Unindex(GMTicket* ticket);
+        static void Insert(const GMTicket* ticket);
+
         CommandResult Close(GMTicket* ticket, const std::string& commentary, bool resolved, WorldSession* session = nullptr);
 
         void UpdateTicketQueueStats(GMTicket& closed, time_t when);
@@ -304,8 +320,23 @@ class GMTicketMgr
     private:
         GMTicketSystemStatus m_status;
 
-        GMTicketMap m_tickets;
-        GMTicketList m_list;
+        // Where a ticket was indexed, its fields may have changed since
+        struct IndexedTicket
+        {
+            bool queued;
+            GMTicketQueueKey key;
+            uint8 category;
+            ObjectGuid assigneeGuid;
+            ObjectGuid authorGuid;
+        };
+
+        GMTicketMap m_tickets;                                              // All tickets in memory by id
+        GMTicketQueue m_queue;                                              // Open tickets in queue order
+        std::map<uint8, GMTicketQueue> m_queueByCategory;                   // Open tickets in queue order by category
+        std::unordered_map<ObjectGuid, std::set<uint32>> m_assigned;        // Open assigned tickets by assignee
+        std::unordered_map<ObjectGuid, GMTicketList> m_byAuthor;            // All tickets in memory by author
+        std::unordered_map<uint32, IndexedTicket> m_indexed;
+        std::set<uint32> m_changed;                                         // Tickets not saved since their last change
 
         uint32 m_lastTicketId                   = 0;
         uint32 m_currentTicketCountOpen         = 0;
@@ -25,6 +25,9 @@
 #include "Tools/Language.h"
 #include "Log.h"
 #include "Maps/MapManager.h"
+#include "Maps/GridDefines.h"
+#include "Entities/Creature.h"
+#include "Entities/GameObject.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Mails/MassMailMgr.h"
 #include "Server/SQLStorages.h"
@@ -716,6 +719,7 @@ uint32 GameEventMgr::Update(ActiveEvents const* activeAtShutdown /*= nullptr*/)
 void GameEventMgr::UnApplyEvent(uint16 event_id)
 {
     m_activeEvents.erase(event_id);
+    ++m_activeEventsVersion;
     CharacterDatabase.PExecute("DELETE FROM game_event_status WHERE event = %u", event_id);
 
     sLog.outString("GameEvent %u \"%s\" removed.", event_id, m_gameEvents[event_id].description.c_str());
@@ -737,6 +741,7 @@ void GameEventMgr::UnApplyEvent(uint16 event_id)
 void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
 {
     m_activeEvents.insert(event_id);
+    ++m_activeEventsVersion;
 
     if (event_id == 987) //weekly server restart event
     {
@@ -768,6 +773,12 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
     OnEventHappened(event_id, true, resume);
 }
 
+static uint32 GetSpawnGridId(float x, float y)
+{
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    return p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord;
+}
+
 void GameEventMgr::GameEventSpawn(int16 event_id)
 {
     int32 internal_event_id = m_gameEvents.size() + event_id - 1;
@@ -778,6 +789,8 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
         return;
     }
 
+    std::map<uint32, PendingSpawnList> spawns;
+
     for (uint32& itr : m_gameEventCreatureGuids[internal_event_id])
     {
         // Add to correct cell
@@ -796,9 +809,10 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
                 }
             }
 
+            // grids loaded from now on spawn it themselves, the loaded ones get it queued
             sObjectMgr.AddCreatureToGrid(itr, data);
 
-            Creature::SpawnInMaps(itr, data);
+            spawns[data->mapid].push_back({ PENDING_SPAWN_CREATURE, itr, GetSpawnGridId(data->posX, data->posY), nullptr });
         }
     }
 
@@ -828,10 +842,13 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddGameobjectToGrid(itr, data);
 
-            GameObject::SpawnInMaps(itr, data);
+            spawns[data->mapid].push_back({ PENDING_SPAWN_GAMEOBJECT, itr, GetSpawnGridId(data->posX, data->posY), nullptr });
         }
     }
 
+    for (auto& itr : spawns)
+        QueuePendingSpawns(itr.first, itr.second);
+
     if (event_id > 0)
     {
         if ((size_t)event_id >= m_gameEventSpawnPoolIds.size())
@@ -855,6 +872,8 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
         return;
     }
 
+    std::map<uint32, PendingSpawnList> unspawns;
+
     for (uint32& itr : m_gameEventCreatureGuids[internal_event_id])
     {
         // Remove the creature from grid
@@ -875,7 +894,7 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveCreatureFromGrid(itr, data);
 
             // Remove spawned cases
-            Creature::AddToRemoveListInMaps(itr, data);
+            unspawns[data->mapid].push_back({ PENDING_UNSPAWN_CREATURE, itr, GetSpawnGridId(data->posX, data->posY), nullptr });
         }
     }
 
@@ -905,10 +924,13 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
             sObjectMgr.RemoveGameobjectFromGrid(itr, data);
 
             // Remove spawned cases
-            GameObject::AddToRemoveListInMaps(itr, data);
+            unspawns[data->mapid].push_back({ PENDING_UNSPAWN_GAMEOBJECT, itr, GetSpawnGridId(data->posX, data->posY), nullptr });
         }
     }
 
+    for (auto& itr : unspawns)
+        QueuePendingSpawns(itr.first, itr.second);
+
     if (event_id > 0)
     {
         if ((size_t)event_id >= m_gameEventSpawnPoolIds.size())
@@ -924,6 +946,116 @@ void GameEventMgr::GameEventUnspawn(int16 event_id)
     }
 }
 
+void GameEventMgr::QueuePendingSpawns(uint32 mapId, PendingSpawnList& spawns)
+{
+    // one event change is applied grid by grid, the order between the changes is kept
+    std::stable_sort(spawns.begin(), spawns.end(), [](PendingSpawn const& a, PendingSpawn const& b) { return a.gridId < b.gridId; });
+
+    std::deque<PendingSpawn>& queue = m_pendingSpawns[mapId];
+    queue.insert(queue.end(), spawns.begin(), spawns.end());
+}
+
+void GameEventMgr::UpdatePendingSpawns()
+{
+    uint32 budget = GAME_EVENT_SPAWNS_PER_UPDATE;
+    for (auto itr = m_pendingSpawns.begin(); itr != m_pendingSpawns.end() && budget;)
+    {
+        std::deque<PendingSpawn>& queue = itr->second;
+
+        // the rest of the grid of the last spawn goes along, a grid is never split between two updates
+        size_t count = std::min<size_t>(budget, queue.size());
+        while (count < queue.size() && queue[count].gridId == queue[count - 1].gridId)
+            ++count;
+
+        auto spawns = std::make_shared<PendingSpawnList>(queue.begin(), queue.begin() + count);
+        queue.erase(queue.begin(), queue.begin() + count);
+        budget = count < budget ? budget - count : 0;
+
+        // the map threads apply them at the start of their next update
+        sMapMgr.DoForAllMapsWithMapId(itr->first, [spawns](Map* map)
+        {
+            map->GetMessager().AddMessage([spawns](Map* map)
+            {
+                ApplyPendingSpawns(map, *spawns);
+            });
+        });
+
+        if (queue.empty())
+            itr = m_pendingSpawns.erase(itr);
+        else
+            ++itr;
+    }
+}
+
+void GameEventMgr::ApplyPendingSpawns(Map* map, PendingSpawnList const& spawns)
+{
+    for (PendingSpawn const& spawn : spawns)
+    {
+        switch (spawn.action)
+        {
+            case PENDING_SPAWN_CREATURE:
+            {
+                CreatureData const* data = sObjectMgr.GetCreatureData(spawn.dbGuid);
+                // We use spawn coords to spawn, the grid may have been loaded with it since queued
+                if (!data || !map->IsLoaded(data->posX, data->posY) || map->GetCreature(data->GetObjectGuid(spawn.dbGuid)))
+                    break;
+
+                Creature* pCreature = new Creature;
+                if (!pCreature->LoadFromDB(spawn.dbGuid, map, spawn.dbGuid))
+                    delete pCreature;
+                break;
+            }
+            case PENDING_SPAWN_GAMEOBJECT:
+            {
+                GameObjectData const* data = sObjectMgr.GetGOData(spawn.dbGuid);
+                // Spawn if necessary (loaded grids only)
+                if (!data || !map->IsLoaded(data->posX, data->posY) || map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, spawn.dbGuid)))
+                    break;
+
+                GameObject* pGameobject = GameObject::CreateGameObject(data->id);
+                if (!pGameobject->LoadFromDB(spawn.dbGuid, map, spawn.dbGuid))
+                    delete pGameobject;
+                else
+                    map->Add(pGameobject);
+                break;
+            }
+            case PENDING_UNSPAWN_CREATURE:
+            {
+                if (CreatureData const* data = sObjectMgr.GetCreatureData(spawn.dbGuid))
+                    if (Creature* pCreature = map->GetCreature(data->GetObjectGuid(spawn.dbGuid)))
+                        pCreature->AddObjectToRemoveList();
+                break;
+            }
+            case PENDING_UNSPAWN_GAMEOBJECT:
+            {
+                if (GameObjectData const* data = sObjectMgr.GetGOData(spawn.dbGuid))
+                    if (GameObject* pGameobject = map->GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, spawn.dbGuid)))
+                        pGameobject->AddObjectToRemoveList();
+                break;
+            }
+            case PENDING_UPDATE_CREATURE:
+            case PENDING_RESTORE_CREATURE:
+            {
+                CreatureData const* data = sObjectMgr.GetCreatureData(spawn.dbGuid);
+                if (!data)
+                    break;
+
+                // Update if spawned
+                if (Creature* pCreature = map->GetCreature(data->GetObjectGuid(spawn.dbGuid)))
+                {
+                    bool activate = spawn.action == PENDING_UPDATE_CREATURE;
+                    pCreature->UpdateEntry(data->id, data, activate ? spawn.eventData : nullptr);
+
+                    // spells not casted for event remove case (sent nullptr into update), do it
+                    if (!activate)
+                        pCreature->ApplyGameEventSpells(spawn.eventData, false);
+                }
+                break;
+            }
+        }
+    }
+}
+
 GameEventCreatureData const* GameEventMgr::GetCreatureUpdateDataForActiveEvent(uint32 lowguid) const
 {
     // only for active event, creature can be listed for many so search all
@@ -948,42 +1080,21 @@ GameEventCreatureData const* GameEventMgr::GetCreatureUpdateDataForActiveEvent(u
     return nullptr;
 }
 
-struct GameEventUpdateCreatureDataInMapsWorker
-{
-    GameEventUpdateCreatureDataInMapsWorker(ObjectGuid guid, CreatureData const* data, GameEventCreatureData* event_data, bool activate)
-        : i_guid(guid), i_data(data), i_event_data(event_data), i_activate(activate) {}
-
-    void operator()(Map* map)
-    {
-        if (Creature* pCreature = map->GetCreature(i_guid))
-        {
-            pCreature->UpdateEntry(i_data->id, i_data, i_activate ? i_event_data : nullptr);
-
-            // spells not casted for event remove case (sent nullptr into update), do it
-            if (!i_activate)
-                pCreature->ApplyGameEventSpells(i_event_data, false);
-        }
-    }
-
-    ObjectGuid i_guid;
-    CreatureData const* i_data;
-    GameEventCreatureData* i_event_data;
-    bool i_activate;
-};
-
 void GameEventMgr::UpdateCreatureData(int16 event_id, bool activate)
 {
+    std::map<uint32, PendingSpawnList> updates;
+
     for (auto& itr : m_gameEventCreatureData[event_id])
     {
-        // Remove the creature from grid
         CreatureData const* data = sObjectMgr.GetCreatureData(itr.first);
         if (!data)
             continue;
 
-        // Update if spawned
-        GameEventUpdateCreatureDataInMapsWorker worker(data->GetObjectGuid(itr.first), data, &itr.second, activate);
-        sMapMgr.DoForAllMapsWithMapId(data->mapid, worker);
+        updates[data->mapid].push_back({ activate ? PENDING_UPDATE_CREATURE : PENDING_RESTORE_CREATURE, itr.first, GetSpawnGridId(data->posX, data->posY), &itr.second });
     }
+
+    for (auto& itr : updates)
+        QueuePendingSpawns(itr.first, itr.second);
 }
 
 void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
@@ -999,6 +1110,9 @@ void GameEventMgr::UpdateEventQuests(uint16 event_id, bool Activate)
 
         const_cast<Quest*>(pQuest)->SetQuestActiveState(Activate);
     }
+
+    if (!m_gameEventQuests[event_id].empty())
+        sObjectMgr.IncreaseQuestStateVersion();
 }
 
 void GameEventMgr::UpdateWorldStates(uint16 event_id, bool Activate)
@@ -1078,7 +1192,7 @@ int16 GameEventMgr::GetGameEventId<Pool>(uint32 guid_or_poolid)
     return 0;
 }
 
-GameEventMgr::GameEventMgr()
+GameEventMgr::GameEventMgr() : m_activeEventsVersion(1)
 {
     m_isGameEventsInit = false;
 }
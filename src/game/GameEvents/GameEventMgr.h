@@ -23,12 +23,17 @@
 #include "Globals/SharedDefines.h"
 #include "Platform/Define.h"
 
+#include <atomic>
+#include <deque>
+
 #define max_ge_check_delay 86400                            // 1 day in seconds
 #define FAR_FUTURE 4102444800                               // 2100, January 1st
+#define GAME_EVENT_SPAWNS_PER_UPDATE 500                    // objects (un)spawned in the maps per world update when events change
 
 class Creature;
 class GameObject;
 class MapPersistentState;
+class Map;
 
 enum GameEventScheduleType
 {
@@ -104,6 +109,8 @@ class GameEventMgr
         bool IsValidEvent(uint16 event_id) const { return event_id < m_gameEvents.size() && m_gameEvents[event_id].isValid(); }
         bool IsActiveEvent(uint16 event_id) const { return (m_activeEvents.find(event_id) != m_activeEvents.end()); }
         bool IsActiveHoliday(HolidayIds id) const; // TODO: Make thread safe
+        // increased whenever an event starts or stops, for data derived from the active events
+        uint32 GetActiveEventsVersion() const { return m_activeEventsVersion; }
         uint32 Initialize();
         void StartEvent(uint16 event_id, bool overwrite = false, bool resume = false);
         void StopEvent(uint16 event_id, bool overwrite = false);
@@ -115,6 +122,9 @@ class GameEventMgr
         GameEventCreatureData const* GetCreatureUpdateDataForActiveEvent(uint32 lowguid) const;
 
         void WeeklyEventTimerRecalculation();
+
+        // hands the next batch of the queued (un)spawns to the map threads, called every world update
+        void UpdatePendingSpawns();
     private:
         void ApplyNewEvent(uint16 event_id, bool resume);
         void UnApplyEvent(uint16 event_id);
@@ -126,6 +136,28 @@ class GameEventMgr
         void SendEventMails(int16 event_id);
         void OnEventHappened(uint16 event_id, bool activate, bool resume);
         void ComputeEventStartAndEndTime(GameEventData& data);
+
+        enum PendingSpawnAction
+        {
+            PENDING_SPAWN_CREATURE,
+            PENDING_SPAWN_GAMEOBJECT,
+            PENDING_UNSPAWN_CREATURE,
+            PENDING_UNSPAWN_GAMEOBJECT,
+            PENDING_UPDATE_CREATURE,
+            PENDING_RESTORE_CREATURE,
+        };
+
+        struct PendingSpawn
+        {
+            PendingSpawnAction action;
+            uint32 dbGuid;
+            uint32 gridId;                                  // spawns of one grid are applied together
+            GameEventCreatureData* eventData;               // only for PENDING_UPDATE_CREATURE and PENDING_RESTORE_CREATURE
+        };
+        typedef std::vector<PendingSpawn> PendingSpawnList;
+
+        void QueuePendingSpawns(uint32 mapId, PendingSpawnList& spawns);
+        static void ApplyPendingSpawns(Map* map, PendingSpawnList const& spawns);
     protected:
         typedef std::list<uint32> GuidList;
         typedef std::list<uint16> IdList;
@@ -153,9 +185,12 @@ class GameEventMgr
         GameEventIdMap    m_gameEventSpawnPoolIds;          // events size, only positive event case
         GameEventDataMap  m_gameEvents;
         ActiveEvents m_activeEvents;
+        std::atomic<uint32> m_activeEventsVersion;
         bool m_isGameEventsInit;
 
         std::unordered_map<uint32, std::vector<uint32>> m_gameEventGroups; // events size
+
+        std::map<uint32, std::deque<PendingSpawn>> m_pendingSpawns; // per map id, in the order the events changed
 };
 
 #define sGameEventMgr MaNGOS::Singleton<GameEventMgr>::Instance()
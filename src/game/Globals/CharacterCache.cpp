@@ -0,0 +1,139 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Globals/CharacterCache.h"
+#include "World/World.h"
+
+INSTANTIATE_SINGLETON_1(CharacterCache);
+
+uint32 CharacterCache::GetCharEnumTicket(uint32 accountId) const
+{
+    Shard const& shard = GetShard(accountId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.enumVersion;
+}
+
+bool CharacterCache::GetCharEnum(uint32 accountId, WorldPacket& packet) const
+{
+    Shard const& shard = GetShard(accountId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto itr = shard.charEnums.find(accountId);
+    if (itr == shard.charEnums.end() || itr->second.expireTime <= sWorld.GetGameTime())
+        return false;
+
+    packet = itr->second.packet;
+    return true;
+}
+
+void CharacterCache::StoreCharEnum(uint32 accountId, uint32 ticket, WorldPacket const& packet, std::vector<uint32>&& guids)
+{
+    Shard& shard = GetShard(accountId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    if (shard.enumVersion != ticket)
+        return;
+
+    // expired enums are only replaced, the accounts logging in again are the ones that matter
+    CharEnumEntry& entry = shard.charEnums[accountId];
+    entry.packet = packet;
+    entry.guids = std::move(guids);
+    entry.expireTime = sWorld.GetGameTime() + CHAR_ENUM_CACHE_TIME;
+}
+
+void CharacterCache::InvalidateCharEnum(uint32 accountId)
+{
+    Shard& shard = GetShard(accountId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    ++shard.enumVersion;
+    shard.charEnums.erase(accountId);
+}
+
+uint32 CharacterCache::GetNameQueryTicket(uint32 guidLow) const
+{
+    Shard const& shard = GetShard(guidLow);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.nameVersion;
+}
+
+bool CharacterCache::GetNameQueryResponse(uint32 guidLow, WorldPacket& packet) const
+{
+    Shard const& shard = GetShard(guidLow);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto itr = shard.nameResponses.find(guidLow);
+    if (itr == shard.nameResponses.end())
+        return false;
+
+    packet = itr->second;
+    return true;
+}
+
+void CharacterCache::StoreNameQueryResponse(uint32 guidLow, uint32 ticket, WorldPacket const& packet)
+{
+    Shard& shard = GetShard(guidLow);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    if (shard.nameVersion != ticket)
+        return;
+
+    if (shard.nameResponses.size() >= NAME_CACHE_SHARD_SIZE)
+        shard.nameResponses.clear();
+
+    shard.nameResponses[guidLow] = packet;
+}
+
+void CharacterCache::InvalidateCharacter(uint32 guidLow)
+{
+    {
+        Shard& shard = GetShard(guidLow);
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        ++shard.nameVersion;
+        shard.nameResponses.erase(guidLow);
+    }
+
+    // the account is not known here, drop the enums listing the character and the pending ones of all accounts
+    for (Shard& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        ++shard.enumVersion;
+        for (auto itr = shard.charEnums.begin(); itr != shard.charEnums.end();)
+        {
+            if (std::find(itr->second.guids.begin(), itr->second.guids.end(), guidLow) != itr->second.guids.end())
+                itr = shard.charEnums.erase(itr);
+            else
+                ++itr;
+        }
+    }
+}
+
+void CharacterCache::Clear()
+{
+    for (Shard& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        ++shard.enumVersion;
+        ++shard.nameVersion;
+        shard.charEnums.clear();
+        shard.nameResponses.clear();
+    }
+}
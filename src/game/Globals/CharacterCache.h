@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_CHARACTERCACHE_H
+#define MANGOS_CHARACTERCACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+#include <mutex>
+
+#define CHARACTER_CACHE_SHARDS      16
+#define CHAR_ENUM_CACHE_TIME        60                      // seconds, for the fields changed offline without invalidation (guild, titles)
+#define NAME_CACHE_SHARD_SIZE       8192                    // name responses per shard before the shard is emptied
+
+/**
+ * Serialized SMSG_CHAR_ENUM packets per account and SMSG_NAME_QUERY_RESPONSE packets of offline
+ * characters per guid, so that repeated requests do not query the character database.
+ *
+ * Safe to use from all threads, the packets are split over shards with a lock each.
+ * A miss takes a ticket before its query is sent; the result is only stored if nothing of the
+ * shard was invalidated while the query was pending, so no stale result outlives an invalidation.
+ */
+class CharacterCache
+{
+    public:
+        CharacterCache() {}
+
+        uint32 GetCharEnumTicket(uint32 accountId) const;
+        bool GetCharEnum(uint32 accountId, WorldPacket& packet) const;
+        void StoreCharEnum(uint32 accountId, uint32 ticket, WorldPacket const& packet, std::vector<uint32>&& guids);
+        void InvalidateCharEnum(uint32 accountId);
+
+        uint32 GetNameQueryTicket(uint32 guidLow) const;
+        bool GetNameQueryResponse(uint32 guidLow, WorldPacket& packet) const;
+        void StoreNameQueryResponse(uint32 guidLow, uint32 ticket, WorldPacket const& packet);
+
+        // after a change of the name, appearance or existence of a character of unknown account
+        void InvalidateCharacter(uint32 guidLow);
+        void Clear();
+
+    private:
+        struct CharEnumEntry
+        {
+            WorldPacket packet;
+            std::vector<uint32> guids;
+            time_t expireTime;
+        };
+
+        struct Shard
+        {
+            Shard() : enumVersion(0), nameVersion(0) {}
+
+            mutable std::mutex lock;
+            uint32 enumVersion;                             // increased by each invalidation of an enum
+            uint32 nameVersion;                             // increased by each invalidation of a name
+            std::unordered_map<uint32, CharEnumEntry> charEnums;
+            std::unordered_map<uint32, WorldPacket> nameResponses;
+        };
+
+        Shard& GetShard(uint32 key) { return m_shards[key % CHARACTER_CACHE_SHARDS]; }
+        Shard const& GetShard(uint32 key) const { return m_shards[key % CHARACTER_CACHE_SHARDS]; }
+
+        Shard m_shards[CHARACTER_CACHE_SHARDS];
+};
+
+#define sCharacterCache MaNGOS::Singleton<CharacterCache>::Instance()
+
+#endif
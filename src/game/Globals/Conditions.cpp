@@ -29,6 +29,10 @@
 #include "Grids/CellImpl.h"
 #include "Spells/SpellMgr.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 // Attention: make sure to keep this list in sync with ConditionSource to avoid array
 //            out of bounds access! It is accessed with ConditionSource as index!
 char const* conditionSourceToStr[] =
@@ -102,12 +106,67 @@ uint8 const ConditionTargetsInternal[] =
 // Starts from 4th element so that -3 will return first element.
 uint8 const* ConditionTargets = &ConditionTargetsInternal[3];
 
+// Composite conditions flattened by CompileConditions(), indexed by entry. Empty for the other conditions
+// and for trees too big to be flattened, those are evaluated through Evaluate()
+static std::vector<ConditionProgram> s_conditionPrograms;
+
+// Flattened trees beyond this many steps are evaluated recursively, shared sub trees are copied for each use
+#define MAX_CONDITION_PROGRAM_SIZE 256
+
+static std::atomic<bool> s_conditionProfiling(false);
+static std::unique_ptr<std::atomic<uint32>[]> s_conditionChecks;
+static uint32 s_conditionChecksSize = 0;
+
+static bool RunConditionProgram(ConditionProgram const& program, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType)
+{
+    bool result = true;
+    for (size_t i = 0; i < program.size();)
+    {
+        ConditionOp const& op = program[i];
+        switch (op.type)
+        {
+            case ConditionOp::LEAF:
+                result = op.swapTargets ? op.leaf->Meets(source, map, target, conditionSourceType) : op.leaf->Meets(target, map, source, conditionSourceType);
+                break;
+            case ConditionOp::CONSTANT:
+                result = op.value;
+                break;
+            case ConditionOp::NOT:
+                result = !result;
+                break;
+            case ConditionOp::JUMP_IF_FALSE:
+                if (!result)
+                {
+                    i = op.jump;
+                    continue;
+                }
+                break;
+            case ConditionOp::JUMP_IF_TRUE:
+                if (result)
+                {
+                    i = op.jump;
+                    continue;
+                }
+                break;
+        }
+        ++i;
+    }
+    return result;
+}
+
 // Checks if player meets the condition
 bool ConditionEntry::Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const
 {
     DEBUG_LOG("Condition-System: Check condition %u, type %i - called from %s with params target: %s, map %i, source %s",
               m_entry, m_condition, conditionSourceToStr[conditionSourceType], target ? target->GetGuidStr().c_str() : "<nullptr>", map ? map->GetId() : -1, source ? source->GetGuidStr().c_str() : "<nullptr>");
 
+    if (s_conditionProfiling.load(std::memory_order_relaxed) && m_entry < s_conditionChecksSize)
+        s_conditionChecks[m_entry].fetch_add(1, std::memory_order_relaxed);
+
+    // composite conditions have no parameter requirements, their flags are part of the program
+    if (m_condition < CONDITION_NONE && m_entry < s_conditionPrograms.size() && !s_conditionPrograms[m_entry].empty())
+        return RunConditionProgram(s_conditionPrograms[m_entry], target, map, source, conditionSourceType);
+
     if (m_flags & CONDITION_FLAG_SWAP_TARGETS)
         std::swap(source, target);
 
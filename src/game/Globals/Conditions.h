@@ -21,6 +21,8 @@
 
 #include "Globals/SharedDefines.h"
 
+#include <vector>
+
 class Map;
 class WorldObject;
 
@@ -124,6 +126,29 @@ enum ConditionRequirement
     CONDITION_REQ_BOTH_PLAYERS,
 };
 
+class ConditionEntry;
+
+// one step of a flattened AND/OR/NOT condition tree, all steps write the same result
+struct ConditionOp
+{
+    enum Type : uint8
+    {
+        LEAF,                                               // result = leaf->Meets(), target and source swapped if swapTargets
+        CONSTANT,                                           // result = value, for CONDITION_NONE leaves
+        NOT,                                                // result = !result
+        JUMP_IF_FALSE,                                      // continue at jump if !result
+        JUMP_IF_TRUE                                        // continue at jump if result
+    };
+
+    Type type;
+    bool swapTargets;                                       // LEAF: swapped by the composite conditions above it
+    bool value;                                             // CONSTANT
+    uint16 jump;                                            // JUMP_IF_*
+    ConditionEntry const* leaf;                             // LEAF
+};
+
+typedef std::vector<ConditionOp> ConditionProgram;
+
 class ConditionEntry
 {
     public:
@@ -139,6 +164,12 @@ class ConditionEntry
 
         // Checks if the condition is met
         bool Meets(WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType) const;
+
+        uint32 GetEntry() const { return m_entry; }
+        ConditionType GetConditionType() const { return m_condition; }
+
+        // Appends the steps evaluating this condition, returns false if the tree grows too big to be flattened
+        bool Compile(bool swapTargets, ConditionProgram& program) const;
     private:
         void DisableCondition() { m_condition = CONDITION_NONE; m_flags ^= CONDITION_FLAG_REVERSE_RESULT; }
         bool CheckParamRequirements(WorldObject const* target, Map const* map, WorldObject const* source) const;
@@ -155,4 +186,14 @@ class ConditionEntry
 // Check if a player meets condition conditionId
 bool IsConditionSatisfied(uint32 conditionId, WorldObject const* target, Map const* map, WorldObject const* source, ConditionSource conditionSourceType);
 
+// Flattens the composite conditions of sConditionStorage, to be called once they are loaded and checked
+void CompileConditions();
+
+// Counts how often every condition is checked, used by .debug performance conditions
+void SetConditionProfiling(bool enable);
+bool IsConditionProfiling();
+void ResetConditionProfile();
+// Fills the most checked conditions as entry and count, most checked first
+void GetConditionProfile(std::vector<std::pair<uint32, uint32>>& result, size_t maxCount);
+
 #endif
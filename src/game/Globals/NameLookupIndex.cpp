@@ -0,0 +1,190 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Globals/NameLookupIndex.h"
+#include "Globals/ObjectMgr.h"
+#include "Server/SQLStorages.h"
+#include "Util.h"
+
+INSTANTIATE_SINGLETON_1(NameLookupIndex);
+
+namespace
+{
+    // 21 bits per character are enough for all of unicode
+    uint64 MakeTrigram(wchar_t const* chars)
+    {
+        return (uint64(chars[0] & 0x1FFFFF) << 42) | (uint64(chars[1] & 0x1FFFFF) << 21) | uint64(chars[2] & 0x1FFFFF);
+    }
+
+    struct IndexBuilder
+    {
+        std::vector<uint32>& ids;
+        std::vector<std::wstring>& names;
+
+        void Add(uint32 id, char const* name)
+        {
+            if (!name || !*name)
+                return;
+
+            std::wstring wname;
+            if (!Utf8toWStr(name, wname))
+                return;
+
+            wstrToLower(wname);
+            ids.push_back(id);
+            names.push_back(std::move(wname));
+        }
+
+        void Add(uint32 id, std::vector<std::string> const& localeNames)
+        {
+            for (std::string const& name : localeNames)
+                Add(id, name.c_str());
+        }
+    };
+}
+
+std::shared_ptr<NameLookupIndex::Index const> NameLookupIndex::Build(NameLookupType type)
+{
+    std::shared_ptr<Index> index = std::make_shared<Index>();
+    IndexBuilder builder = { index->ids, index->names };
+
+    switch (type)
+    {
+        case NAME_LOOKUP_ITEM:
+            for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+            {
+                if (ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(id))
+                {
+                    builder.Add(id, proto->Name1);
+                    if (ItemLocale const* locale = sObjectMgr.GetItemLocale(id))
+                        builder.Add(id, locale->Name);
+                }
+            }
+            break;
+        case NAME_LOOKUP_CREATURE:
+            for (uint32 id = 0; id < sCreatureStorage.GetMaxEntry(); ++id)
+            {
+                if (CreatureInfo const* cInfo = sCreatureStorage.LookupEntry<CreatureInfo>(id))
+                {
+                    builder.Add(id, cInfo->Name);
+                    if (CreatureLocale const* locale = sObjectMgr.GetCreatureLocale(id))
+                        builder.Add(id, locale->Name);
+                }
+            }
+            break;
+        case NAME_LOOKUP_GAMEOBJECT:
+            for (SQLStorageBase::SQLSIterator<GameObjectInfo> itr = sGOStorage.getDataBegin<GameObjectInfo>(); itr < sGOStorage.getDataEnd<GameObjectInfo>(); ++itr)
+            {
+                builder.Add(itr->id, itr->name);
+                if (GameObjectLocale const* locale = sObjectMgr.GetGameObjectLocale(itr->id))
+                    builder.Add(itr->id, locale->Name);
+            }
+            break;
+        case NAME_LOOKUP_QUEST:
+        {
+            // the quest map is unordered, the names are added by id to keep the results ascending
+            std::vector<uint32> questIds;
+            for (auto const& quest : sObjectMgr.GetQuestTemplates())
+                questIds.push_back(quest.first);
+            std::sort(questIds.begin(), questIds.end());
+
+            for (uint32 id : questIds)
+            {
+                builder.Add(id, sObjectMgr.GetQuestTemplate(id)->GetTitle().c_str());
+                if (QuestLocale const* locale = sObjectMgr.GetQuestLocale(id))
+                    builder.Add(id, locale->Title);
+            }
+            break;
+        }
+        case NAME_LOOKUP_SPELL:
+            for (uint32 id = 0; id < sSpellTemplate.GetMaxEntry(); ++id)
+            {
+                if (SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(id))
+                    for (int loc = 0; loc < MAX_LOCALE; ++loc)
+                        builder.Add(id, spellInfo->SpellName[loc]);
+            }
+            break;
+    }
+
+    for (uint32 i = 0; i < index->names.size(); ++i)
+    {
+        std::wstring const& name = index->names[i];
+        for (size_t pos = 0; pos + 3 <= name.size(); ++pos)
+        {
+            std::vector<uint32>& list = index->trigrams[MakeTrigram(&name[pos])];
+            if (list.empty() || list.back() != i)           // a trigram repeated in the same name
+                list.push_back(i);
+        }
+    }
+
+    return index;
+}
+
+std::vector<uint32> NameLookupIndex::Search(NameLookupType type, std::wstring const& lowerPart)
+{
+    std::shared_ptr<Index const> index;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_indexes[type])
+            m_indexes[type] = Build(type);
+        index = m_indexes[type];
+    }
+
+    std::vector<uint32> result;
+    auto addMatch = [&](uint32 nameIdx)
+    {
+        if (index->names[nameIdx].find(lowerPart) == std::wstring::npos)
+            return;
+
+        // the names of a template are consecutive, so are the duplicates
+        uint32 id = index->ids[nameIdx];
+        if (result.empty() || result.back() != id)
+            result.push_back(id);
+    };
+
+    if (lowerPart.size() < 3)
+    {
+        // no trigram to narrow the search, still no conversion of the names
+        for (uint32 i = 0; i < index->names.size(); ++i)
+            addMatch(i);
+        return result;
+    }
+
+    // all trigrams of the part have to be in a name, only the names with the rarest one are compared
+    std::vector<uint32> const* rarest = nullptr;
+    for (size_t pos = 0; pos + 3 <= lowerPart.size(); ++pos)
+    {
+        auto itr = index->trigrams.find(MakeTrigram(&lowerPart[pos]));
+        if (itr == index->trigrams.end())
+            return result;
+
+        if (!rarest || itr->second.size() < rarest->size())
+            rarest = &itr->second;
+    }
+
+    for (uint32 nameIdx : *rarest)
+        addMatch(nameIdx);
+
+    return result;
+}
+
+void NameLookupIndex::Clear(NameLookupType type)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_indexes[type].reset();
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_NAMELOOKUPINDEX_H
+#define MANGOS_NAMELOOKUPINDEX_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <memory>
+#include <mutex>
+
+enum NameLookupType
+{
+    NAME_LOOKUP_ITEM        = 0,                            // item_template and locales_item
+    NAME_LOOKUP_CREATURE    = 1,                            // creature_template and locales_creature
+    NAME_LOOKUP_GAMEOBJECT  = 2,                            // gameobject_template and locales_gameobject
+    NAME_LOOKUP_QUEST       = 3,                            // quest_template and locales_quest
+    NAME_LOOKUP_SPELL       = 4,                            // Spell.dbc, all dbc locales
+};
+
+#define MAX_NAME_LOOKUP_TYPE 5
+
+/**
+ * Lower case names of the templates the .lookup commands search, in all locales, with a trigram index
+ * over them. A search only compares the names sharing the rarest trigram of the searched part.
+ *
+ * The index of a type is built on its first search and dropped by Clear after a reload of its names.
+ * Safe to use from all threads, a search keeps the index it started with even if it is dropped meanwhile.
+ */
+class NameLookupIndex
+{
+    public:
+        NameLookupIndex() {}
+
+        // ids of the templates with a name containing the lower case part in any locale, ascending and
+        // without duplicates; the caller still checks the locales it shows, this only drops the others
+        std::vector<uint32> Search(NameLookupType type, std::wstring const& lowerPart);
+
+        void Clear(NameLookupType type);
+
+    private:
+        struct Index
+        {
+            std::vector<uint32> ids;                        // template of each name
+            std::vector<std::wstring> names;
+            std::unordered_map<uint64, std::vector<uint32>> trigrams; // names containing the trigram, ascending
+        };
+
+        static std::shared_ptr<Index const> Build(NameLookupType type);
+
+        std::mutex m_lock;
+        std::shared_ptr<Index const> m_indexes[MAX_NAME_LOOKUP_TYPE];
+};
+
+#define sNameLookupIndex MaNGOS::Singleton<NameLookupIndex>::Instance()
+
+#endif
@@ -38,30 +38,59 @@ INSTANTIATE_CLASS_MUTEX(ObjectAccessor, std::mutex);
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap[o->GetObjectGuid()] = o;
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock);
+    T*& object = shard.objects[o->GetObjectGuid()];
+    if (object && object != o)
+        ++m_removals;
+    object = o;
 }
 
 template<class T>
 void HashMapHolder<T>::Remove(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap.erase(o->GetObjectGuid());
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock);
+    shard.objects.erase(o->GetObjectGuid());
+    // after the erase, a lookup racing with it caches the object under the old count
+    ++m_removals;
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    ReadGuard guard(i_lock);
-    typename MapType::iterator itr = m_objectMap.find(guid);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
-}
+    // the same few guids are looked up again and again by a map thread, found objects are remembered
+    // per thread until any object is removed
+    struct CacheEntry
+    {
+        ObjectGuid guid;
+        T* object = nullptr;
+        uint32 removals = 0;
+    };
+    static thread_local CacheEntry cache[CACHE_SIZE];
+
+    uint32 const removals = m_removals.load(std::memory_order_acquire);
+    CacheEntry& entry = cache[guid.GetCounter() % CACHE_SIZE];
+    if (entry.object && entry.guid == guid && entry.removals == removals)
+        return entry.object;
+
+    Shard& shard = GetShard(guid);
+    ReadGuard guard(shard.lock);
+    typename MapType::iterator itr = shard.objects.find(guid);
+    if (itr == shard.objects.end())
+        return nullptr;
 
-template<class T>
-typename HashMapHolder<T>::MapType& HashMapHolder<T>::GetContainer() { return m_objectMap; }
+    entry.guid = guid;
+    entry.object = itr->second;
+    entry.removals = removals;
+    return itr->second;
+}
 
 template<class T>
-typename HashMapHolder<T>::LockType& HashMapHolder<T>::GetLock() { return i_lock; }
+void HashMapHolder<T>::GetAll(std::vector<T*>& result)
+{
+    DoForAll([&result](T* object) { result.push_back(object); });
+}
 
 ObjectAccessor::ObjectAccessor() {}
 ObjectAccessor::~ObjectAccessor()
@@ -122,18 +151,12 @@ Player* ObjectAccessor::FindPlayerByName(char const* name, bool inWorld /*=true*
 
 void ObjectAccessor::SaveAllPlayers() const
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (auto& itr : m)
-        itr.second->SaveToDB();
+    HashMapHolder<Player>::DoForAll([](Player* player) { player->SaveToDB(); });
 }
 
 void ObjectAccessor::ExecuteOnAllPlayers(std::function<void(Player*)> executor)
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        executor(itr->second);
+    HashMapHolder<Player>::DoForAll(executor);
 }
 
 void ObjectAccessor::KickPlayer(ObjectGuid guid)
@@ -286,17 +309,70 @@ ObjectAccessor::ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia)
 void ObjectAccessor::RemoveOldCorpses()
 {
     time_t now = time(nullptr);
-    Player2CorpsesMapType::iterator next;
-    for (Player2CorpsesMapType::iterator itr = i_player2corpse.begin(); itr != i_player2corpse.end(); itr = next)
+
+    Guard guard(i_corpseGuard);
+    i_expiredCorpses.clear();
+    for (auto& itr : i_player2corpse)
+        if (itr.second->IsExpired(now))
+            i_expiredCorpses.push_back(itr.first);
+}
+
+void ObjectAccessor::ConvertExpiredCorpses(uint32 maxCount)
+{
+    time_t now = time(nullptr);
+    for (uint32 count = 0; count < maxCount && !i_expiredCorpses.empty(); ++count)
+    {
+        ObjectGuid ownerGuid = i_expiredCorpses.back();
+        i_expiredCorpses.pop_back();
+
+        // the owner may have been resurrected or died again since the sweep
+        Corpse* corpse = GetCorpseForPlayerGUID(ownerGuid);
+        if (corpse && corpse->IsExpired(now))
+            ConvertCorpseForPlayer(ownerGuid);
+    }
+}
+
+void ObjectAccessor::QueueCorpseSave(uint32 ownerLow, std::string&& insertSql)
+{
+    Guard guard(i_corpseChangesGuard);
+    i_corpseChanges[ownerLow] = std::move(insertSql);
+}
+
+void ObjectAccessor::QueueCorpseDelete(uint32 ownerLow)
+{
+    Guard guard(i_corpseChangesGuard);
+    i_corpseChanges[ownerLow].clear();
+}
+
+void ObjectAccessor::SaveCorpseChanges()
+{
+    std::map<uint32, std::string> changes;
     {
-        next = itr;
-        ++next;
+        Guard guard(i_corpseChangesGuard);
+        changes.swap(i_corpseChanges);
+    }
 
-        if (!itr->second->IsExpired(now))
-            continue;
+    if (changes.empty())
+        return;
 
-        ConvertCorpseForPlayer(itr->first);
+    // every change drops the old corpse of the owner, bones are never saved
+    CharacterDatabase.BeginTransaction();
+    auto itr = changes.begin();
+    while (itr != changes.end())
+    {
+        std::ostringstream ss;
+        ss << "DELETE FROM corpse WHERE corpse_type <> '0' AND player IN (" << itr->first;
+        ++itr;
+        for (uint32 count = 1; count < 256 && itr != changes.end(); ++count, ++itr)
+            ss << "," << itr->first;
+        ss << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
     }
+
+    for (auto const& change : changes)
+        if (!change.second.empty())
+            CharacterDatabase.Execute(change.second.c_str());
+    CharacterDatabase.CommitTransaction();
 }
 
 void ObjectAccessor::AddObject(Player* player)
@@ -313,8 +389,8 @@ void ObjectAccessor::RemoveObject(Player* player)
 
 /// Define the static member of HashMapHolder
 
-template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::Shard HashMapHolder<T>::m_shards[HashMapHolder<T>::SHARDS];
+template <class T> std::atomic<uint32> HashMapHolder<T>::m_removals(0);
 
 /// Global definitions for the hashmap storage
 
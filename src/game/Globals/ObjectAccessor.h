@@ -31,22 +31,27 @@
 #include "Entities/Player.h"
 #include "Entities/Corpse.h"
 
+#include <atomic>
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 class Unit;
 class WorldObject;
 class Map;
 
+// guid registry of the objects reachable from any map, split in shards with a reader-writer lock each so
+// that the map threads looking up players do not queue behind one another or behind logins and logouts
 template <class T>
 class HashMapHolder
 {
     public:
 
         typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
+        typedef std::shared_timed_mutex LockType;
+        typedef std::shared_lock<LockType> ReadGuard;
+        typedef std::unique_lock<LockType> WriteGuard;
 
         static void Insert(T* o);
 
@@ -54,17 +59,38 @@ class HashMapHolder
 
         static T* Find(ObjectGuid guid);
 
-        static MapType& GetContainer();
+        // calls func for every object, holding the read lock of one shard at a time
+        template<class F>
+        static void DoForAll(F&& func)
+        {
+            for (Shard& shard : m_shards)
+            {
+                ReadGuard guard(shard.lock);
+                for (auto& itr : shard.objects)
+                    func(itr.second);
+            }
+        }
 
-        static LockType& GetLock();
+        static void GetAll(std::vector<T*>& result);
 
     private:
 
         // Non instanceable only static
         HashMapHolder() {}
 
-        static LockType i_lock;
-        static MapType  m_objectMap;
+        static uint32 const SHARDS = 16;
+        static uint32 const CACHE_SIZE = 64;                // per thread, see Find
+
+        struct Shard
+        {
+            LockType lock;
+            MapType objects;
+        };
+
+        static Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() % SHARDS]; }
+
+        static Shard m_shards[SHARDS];
+        static std::atomic<uint32> m_removals;              // invalidates the lookup caches of the threads
 };
 
 class PlayerNameMapHolder
@@ -84,6 +110,9 @@ class PlayerNameMapHolder
         static MapType m_objectMap;
 };
 
+// expired corpses turned into bones per world update, a sweep after a big battle is spread over several updates
+#define CORPSE_CONVERSIONS_PER_UPDATE 50
+
 class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLevelLockable<ObjectAccessor, std::mutex> >
 {
         friend class MaNGOS::OperatorNew<ObjectAccessor>;
@@ -105,11 +134,6 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         static Player* FindPlayerByName(char const* name, bool inWorld = true);
         static void KickPlayer(ObjectGuid guid);
 
-        HashMapHolder<Player>::MapType& GetPlayers() const
-        {
-            return HashMapHolder<Player>::GetContainer();
-        }
-
         void SaveAllPlayers() const;
         void ExecuteOnAllPlayers(std::function<void(Player*)> executor);
 
@@ -120,7 +144,13 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         void AddCorpse(Corpse* corpse);
         void AddCorpsesToGrid(GridPair const& gridpair, GridType& grid, Map* map);
         Corpse* ConvertCorpseForPlayer(ObjectGuid player_guid, bool insignia = false);
-        void RemoveOldCorpses();
+        void RemoveOldCorpses();                            // only queues the expired corpses, see ConvertExpiredCorpses
+        void ConvertExpiredCorpses(uint32 maxCount);
+
+        // Corpse DB changes of all threads, written together by the world thread; the last change of an owner wins
+        void QueueCorpseSave(uint32 ownerLow, std::string&& insertSql);
+        void QueueCorpseDelete(uint32 ownerLow);
+        void SaveCorpseChanges();
 
         // For call from Player/Corpse AddToWorld/RemoveFromWorld only
         void AddObject(Corpse* object) { HashMapHolder<Corpse>::Insert(object); }
@@ -131,12 +161,15 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
     private:
 
         Player2CorpsesMapType   i_player2corpse;
+        std::vector<ObjectGuid> i_expiredCorpses;           // owners, world thread only
+        std::map<uint32, std::string> i_corpseChanges;      // owner -> insert after the delete, empty to only delete
 
         typedef std::mutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
         LockType i_playerGuard;
         LockType i_corpseGuard;
+        LockType i_corpseChangesGuard;
 };
 
 #define sObjectAccessor ObjectAccessor::Instance()
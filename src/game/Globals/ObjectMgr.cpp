@@ -50,6 +50,7 @@
 
 #include <limits>
 #include "Entities/ItemEnchantmentMgr.h"
+#include "Entities/NpcListCache.h"
 #include "Loot/LootMgr.h"
 
 INSTANTIATE_SINGLETON_1(ObjectMgr);
@@ -153,7 +154,13 @@ ObjectMgr::ObjectMgr() :
     m_PetNumbers("Pet numbers"),
     m_FirstTemporaryCreatureGuid(1),
     m_FirstTemporaryGameObjectGuid(1),
-    m_Dbc2StorageLocaleIndex(DEFAULT_LOCALE)
+    m_Dbc2StorageLocaleIndex(DEFAULT_LOCALE),
+    m_oldMailsTime(0),
+    m_oldMailsLastId(0),
+    m_oldMailsCount(0),
+    m_oldMailsPending(false),
+    m_questStateVersion(0),
+    m_questTemplatesVersion(0)
 {
 }
 
@@ -1438,8 +1445,8 @@ void ObjectMgr::LoadCreatureSpawnEntry()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    //                                                        0                       1   2    3
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9             10                   11           12
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecsmin, spawntimesecsmax, spawndist, currentwaypoint,"
                           //   13         14       15          16            17         18         19
@@ -1688,6 +1695,9 @@ void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            if (m_spawnCellTable.SetRemoved(data->mapid, i, cell_id, false, guid, false))
+                continue;
+
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
             cell_guids.creatures.insert(guid);
         }
@@ -1704,6 +1714,9 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            if (m_spawnCellTable.SetRemoved(data->mapid, i, cell_id, false, guid, true))
+                continue;
+
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
             cell_guids.creatures.erase(guid);
         }
@@ -1714,8 +1727,8 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 count = 0;
 
-    //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+    //                                                        0                           1   2    3           4           5           6
+    QueryResult* result = WorldDatabase.QueryStreamed("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
                           //   7          8          9          10         11                 12               13         14       15         16      17
                           "rotation0, rotation1, rotation2, rotation3, spawntimesecsmin, spawntimesecsmax, animprogress, state, spawnMask, phaseMask, event,"
                           //   18                          19
@@ -1936,6 +1949,9 @@ void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            if (m_spawnCellTable.SetRemoved(data->mapid, i, cell_id, true, guid, false))
+                continue;
+
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
             cell_guids.gameobjects.insert(guid);
         }
@@ -1952,12 +1968,59 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
+            if (m_spawnCellTable.SetRemoved(data->mapid, i, cell_id, true, guid, true))
+                continue;
+
             CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
             cell_guids.gameobjects.erase(guid);
         }
     }
 }
 
+void ObjectMgr::BuildSpawnCellTable()
+{
+    std::vector<SpawnCellTable::Spawn> spawns;
+    for (auto& mapGuids : mMapObjectGuids)
+    {
+        uint32 mapId = PAIR32_LOPART(mapGuids.first);
+        uint8 spawnMode = uint8(PAIR32_HIPART(mapGuids.first));
+
+        for (auto& cellGuids : mapGuids.second)
+        {
+            uint64 cellKey = SpawnCellTable::MakeCellKey(mapId, spawnMode, cellGuids.first);
+            for (uint32 guid : cellGuids.second.creatures)
+                spawns.push_back({ cellKey, false, guid, 0 });
+            for (uint32 guid : cellGuids.second.gameobjects)
+                spawns.push_back({ cellKey, true, guid, GetGOData(guid)->id });
+
+            cellGuids.second.creatures.clear();
+            cellGuids.second.gameobjects.clear();
+        }
+    }
+
+    // only the corpses are left in the sets
+    for (auto mapItr = mMapObjectGuids.begin(); mapItr != mMapObjectGuids.end();)
+    {
+        for (auto cellItr = mapItr->second.begin(); cellItr != mapItr->second.end();)
+        {
+            if (cellItr->second.corpses.empty())
+                cellItr = mapItr->second.erase(cellItr);
+            else
+                ++cellItr;
+        }
+
+        if (mapItr->second.empty())
+            mapItr = mMapObjectGuids.erase(mapItr);
+        else
+            ++mapItr;
+    }
+
+    m_spawnCellTable.Build(spawns);
+
+    sLog.outString(">> Packed " SIZEFMTD " static spawns in " SIZEFMTD " cells", m_spawnCellTable.GetSpawnCount(), m_spawnCellTable.GetCellCount());
+    sLog.outString();
+}
+
 // Get player map id of offline player. Return -1 if not found!
 int32 ObjectMgr::GetPlayerMapIdByGUID(ObjectGuid const& guid) const
 {
@@ -4109,6 +4172,7 @@ void ObjectMgr::LoadQuests()
         delete itr->second;
 
     mQuestTemplates.clear();
+    ++m_questTemplatesVersion;
 
     m_ExclusiveQuestGroups.clear();
 
@@ -5238,6 +5302,7 @@ void ObjectMgr::LoadConditions()
     }
 
     sLog.outString(">> Loaded %u Condition definitions", sConditionStorage.GetRecordCount());
+    CompileConditions();
     sLog.outString();
 }
 
@@ -5706,78 +5771,112 @@ void ObjectMgr::LoadTrainerGreetingLocales()
 
 // not very fast function but it is called only once a day, or on starting-up
 /// @param serverUp true if the server is already running, false when the server is started
+// expired mails handled in one transaction, a running server handles one batch per world update
+#define OLD_MAILS_BATCH_SIZE 500
+
 void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
 {
-    time_t basetime = time(nullptr);
-    DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&basetime)->tm_hour, localtime(&basetime)->tm_min, localtime(&basetime)->tm_sec);
-    // delete all old mails without item and without body immediately, if starting server
-    if (!serverUp)
-        CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND body = ''", (uint64)basetime);
-    //                                                     0  1           2      3        4         5           6   7       8
-    QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "'", (uint64)basetime);
-    if (!result)
+    m_oldMailsTime = time(nullptr);
+    m_oldMailsLastId = 0;
+    m_oldMailsCount = 0;
+    DEBUG_LOG("Returning mails current time: hour: %d, minute: %d, second: %d ", localtime(&m_oldMailsTime)->tm_hour, localtime(&m_oldMailsTime)->tm_min, localtime(&m_oldMailsTime)->tm_sec);
+
+    // the batches follow in UpdateOldMails
+    if (serverUp)
     {
-        BarGoLink bar(1);
-        bar.step();
-        sLog.outString(">> Only expired mails (need to be return or delete) or DB table `mail` is empty.");
-        sLog.outString();
-        return;                                             // any mails need to be returned or deleted
+        m_oldMailsPending = true;
+        return;
     }
 
-    // std::ostringstream delitems, delmails; // will be here for optimization
-    // bool deletemail = false, deleteitem = false;
-    // delitems << "DELETE FROM item_instance WHERE guid IN ( ";
-    // delmails << "DELETE FROM mail WHERE id IN ( "
+    // delete all old mails without item and without body immediately, if starting server
+    CharacterDatabase.PExecute("DELETE FROM mail WHERE expire_time < '" UI64FMTD "' AND has_items = '0' AND body = ''", (uint64)m_oldMailsTime);
 
-    BarGoLink bar(result->GetRowCount());
-    uint32 count = 0;
+    BarGoLink bar(1);
+    while (ReturnOrDeleteOldMailsBatch(false)) {}
+    bar.step();
+
+    sLog.outString(">> Loaded %u mails", m_oldMailsCount);
+    sLog.outString();
+}
 
+void ObjectMgr::UpdateOldMails()
+{
+    if (m_oldMailsPending)
+        m_oldMailsPending = ReturnOrDeleteOldMailsBatch(true);
+}
+
+// returns true while more expired mails can follow
+bool ObjectMgr::ReturnOrDeleteOldMailsBatch(bool serverUp)
+{
+    //                                                     0  1           2      3        4         5           6   7       8
+    QueryResult* result = CharacterDatabase.PQuery("SELECT id,messageType,sender,receiver,has_items,expire_time,cod,checked,mailTemplateId FROM mail WHERE expire_time < '" UI64FMTD "' AND id > '%u' ORDER BY id LIMIT %u",
+                          (uint64)m_oldMailsTime, m_oldMailsLastId, OLD_MAILS_BATCH_SIZE);
+    if (!result)
+        return false;
+
+    bool const more = result->GetRowCount() >= OLD_MAILS_BATCH_SIZE;
+
+    std::vector<Mail*> mails;
+    std::unordered_map<uint32, Mail*> mailsWithItems;
+    std::ostringstream mailIds;
     do
     {
-        bar.step();
-
         Field* fields = result->Fetch();
         Mail* m = new Mail;
         m->messageID = fields[0].GetUInt32();
         m->messageType = fields[1].GetUInt8();
         m->sender = fields[2].GetUInt32();
         m->receiverGuid = ObjectGuid(HIGHGUID_PLAYER, fields[3].GetUInt32());
-        bool has_items = fields[4].GetBool();
+        m->has_items = fields[4].GetBool();
         m->expire_time = (time_t)fields[5].GetUInt64();
         m->deliver_time = 0;
         m->COD = fields[6].GetUInt32();
         m->checked = fields[7].GetUInt32();
         m->mailTemplateId = fields[8].GetInt16();
 
-        Player* pl = nullptr;
-        if (serverUp)
-            pl = GetPlayer(m->receiverGuid);
-        if (pl)
+        m_oldMailsLastId = m->messageID;
+
+        // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
+        // his in mailbox and he has already listed his mails )
+        if (serverUp && GetPlayer(m->receiverGuid))
         {
-            // this code will run very improbably (the time is between 4 and 5 am, in game is online a player, who has old mail
-            // his in mailbox and he has already listed his mails )
             delete m;
             continue;
         }
-        // delete or return mail:
-        if (has_items)
-        {
-            QueryResult* resultItems = CharacterDatabase.PQuery("SELECT item_guid,item_template FROM mail_items WHERE mail_id='%u'", m->messageID);
-            if (resultItems)
-            {
-                do
-                {
-                    Field* fields2 = resultItems->Fetch();
 
-                    uint32 item_guid_low = fields2[0].GetUInt32();
-                    uint32 item_template = fields2[1].GetUInt32();
-
-                    m->AddItem(item_guid_low, item_template);
-                }
-                while (resultItems->NextRow());
+        if (m->has_items)
+        {
+            if (!mailsWithItems.empty())
+                mailIds << ',';
+            mailIds << m->messageID;
+            mailsWithItems[m->messageID] = m;
+        }
+        mails.push_back(m);
+    }
+    while (result->NextRow());
+    delete result;
 
-                delete resultItems;
+    // the items of all mails of the batch at once
+    if (!mailsWithItems.empty())
+    {
+        if (QueryResult* resultItems = CharacterDatabase.PQuery("SELECT mail_id,item_guid,item_template FROM mail_items WHERE mail_id IN (%s)", mailIds.str().c_str()))
+        {
+            do
+            {
+                Field* fields = resultItems->Fetch();
+                mailsWithItems[fields[0].GetUInt32()]->AddItem(fields[1].GetUInt32(), fields[2].GetUInt32());
             }
+            while (resultItems->NextRow());
+            delete resultItems;
+        }
+    }
+
+    CharacterDatabase.BeginTransaction();
+    for (Mail* m : mails)
+    {
+        // delete or return mail:
+        if (m->has_items)
+        {
             // if it is mail from non-player, or if it's already return mail, it shouldn't be returned, but deleted
             if (m->messageType != MAIL_NORMAL || (m->checked & (MAIL_CHECK_MASK_COD_PAYMENT | MAIL_CHECK_MASK_RETURNED)))
             {
@@ -5789,7 +5888,7 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
             {
                 // mail will be returned:
                 CharacterDatabase.PExecute("UPDATE mail SET sender = '%u', receiver = '%u', expire_time = '" UI64FMTD "', deliver_time = '" UI64FMTD "',cod = '0', checked = '%u' WHERE id = '%u'",
-                                           m->receiverGuid.GetCounter(), m->sender, (uint64)basetime + 30 * DAY, (uint64)basetime, MAIL_CHECK_MASK_RETURNED, m->messageID);
+                                           m->receiverGuid.GetCounter(), m->sender, (uint64)m_oldMailsTime + 30 * DAY, (uint64)m_oldMailsTime, MAIL_CHECK_MASK_RETURNED, m->messageID);
                 for (MailItemInfoVec::iterator itr2 = m->items.begin(); itr2 != m->items.end(); ++itr2)
                 {
                     // update receiver in mail items for its proper delivery, and in instance_item for avoid lost item at sender delete
@@ -5801,17 +5900,13 @@ void ObjectMgr::ReturnOrDeleteOldMails(bool serverUp)
             }
         }
 
-        // deletemail = true;
-        // delmails << m->messageID << ", ";
         CharacterDatabase.PExecute("DELETE FROM mail WHERE id = '%u'", m->messageID);
         delete m;
-        ++count;
+        ++m_oldMailsCount;
     }
-    while (result->NextRow());
-    delete result;
+    CharacterDatabase.CommitTransaction();
 
-    sLog.outString(">> Loaded %u mails", count);
-    sLog.outString();
+    return more;
 }
 
 void ObjectMgr::LoadQuestAreaTriggers()
@@ -8080,6 +8175,7 @@ void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_
 void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table)
 {
     map.clear();                                            // need for reload case
+    IncreaseQuestStateVersion();
 
     uint32 count = 0;
 
@@ -9676,10 +9772,93 @@ void ObjectMgr::LoadGossipMenus()
     sLog.outErrorDb("Table `dbscripts_on_gossip` contains unused script, id %u.", itr);
 }
 
+void ObjectMgr::GetGossipMenuItemTexts(GossipMenuItems const& item, int32 locIdx, uint8 gender, std::string& optionText, std::string& boxText) const
+{
+    optionText = item.option_text;
+    boxText = item.box_text;
+
+    if (item.option_broadcast_text || item.box_broadcast_text)
+    {
+        if (item.option_broadcast_text)
+            optionText = GetBroadcastText(item.option_broadcast_text)->GetText(locIdx, gender);
+        if (item.box_broadcast_text)
+            boxText = GetBroadcastText(item.box_broadcast_text)->GetText(locIdx, gender);
+    }
+    else if (locIdx >= 0)
+    {
+        if (GossipMenuItemsLocale const* no = GetGossipMenuItemsLocale(MAKE_PAIR32(item.menu_id, item.id)))
+        {
+            if (no->OptionText.size() > size_t(locIdx) && !no->OptionText[locIdx].empty())
+                optionText = no->OptionText[locIdx];
+
+            if (no->BoxText.size() > size_t(locIdx) && !no->BoxText[locIdx].empty())
+                boxText = no->BoxText[locIdx];
+        }
+    }
+}
+
+void ObjectMgr::PrecompileGossipMenus()
+{
+    m_gossipMenusCompiled.clear();                          // need for reload case
+
+    uint32 count = 0;
+    for (GossipMenuItemsMap::const_iterator itr = m_mGossipMenuItemsMap.begin(); itr != m_mGossipMenuItemsMap.end(); ++itr)
+    {
+        GossipMenuItems const& item = itr->second;
+        GossipMenuCompiled& menu = m_gossipMenusCompiled[itr->first];
+
+        menu.options.push_back(GossipMenuOptionCompiled());
+        GossipMenuOptionCompiled& option = menu.options.back();
+        option.item = item;
+        option.conditionIndex = -1;
+
+        if (item.conditionId)
+        {
+            std::vector<uint16>::const_iterator condItr = std::find(menu.conditionIds.begin(), menu.conditionIds.end(), item.conditionId);
+            option.conditionIndex = int32(condItr - menu.conditionIds.begin());
+            if (condItr == menu.conditionIds.end())
+                menu.conditionIds.push_back(item.conditionId);
+        }
+
+        for (int32 locIdx = -1; locIdx < MAX_LOCALE - 1; ++locIdx)
+        {
+            for (uint8 female = 0; female < 2; ++female)
+            {
+                std::string optionText, boxText;
+                GetGossipMenuItemTexts(item, locIdx, female ? GENDER_FEMALE : GENDER_MALE, optionText, boxText);
+
+                ByteBuffer serialized(1 + 1 + 4 + optionText.size() + 1 + boxText.size() + 1);
+                serialized << uint8(item.option_icon);
+                serialized << uint8(item.box_coded);
+                serialized << uint32(item.box_money);
+                serialized << optionText;
+                serialized << boxText;
+
+                // most options have the same text for all locales and both genders
+                size_t index = 0;
+                while (index < option.variants.size() && (option.variants[index].size() != serialized.size() ||
+                        memcmp(option.variants[index].contents(), serialized.contents(), serialized.size()) != 0))
+                    ++index;
+
+                if (index == option.variants.size())
+                    option.variants.push_back(serialized);
+
+                option.variantIndex[locIdx + 1][female] = uint8(index);
+            }
+        }
+
+        ++count;
+    }
+
+    sLog.outString(">> Precompiled %u gossip menu options of " SIZEFMTD " gossip menus", count, m_gossipMenusCompiled.size());
+    sLog.outString();
+}
+
 void ObjectMgr::AddVendorItem(uint32 entry, uint32 item, uint32 maxcount, uint32 incrtime, uint32 extendedcost)
 {
     VendorItemData& vList = m_mCacheVendorItemMap[entry];
     vList.AddItem(item, maxcount, incrtime, extendedcost, 0);
+    sNpcListCache.Clear();
 
     WorldDatabase.PExecuteLog("INSERT INTO npc_vendor (entry,item,maxcount,incrtime,extendedcost) VALUES('%u','%u','%u','%u','%u')", entry, item, maxcount, incrtime, extendedcost);
 }
@@ -9692,6 +9871,7 @@ bool ObjectMgr::RemoveVendorItem(uint32 entry, uint32 item)
 
     if (!iter->second.RemoveItem(item))
         return false;
+    sNpcListCache.Clear();
 
     WorldDatabase.PExecuteLog("DELETE FROM npc_vendor WHERE entry='%u' AND item='%u'", entry, item);
     return true;
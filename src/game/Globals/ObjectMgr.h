@@ -34,7 +34,9 @@
 #include "Globals/ObjectAccessor.h"
 #include "Entities/ObjectGuid.h"
 #include "Globals/Conditions.h"
+#include "Globals/SpawnCellTable.h"
 
+#include <atomic>
 #include <map>
 #include <climits>
 
@@ -331,6 +333,31 @@ typedef std::pair<GossipMenusMap::const_iterator, GossipMenusMap::const_iterator
 typedef std::multimap<uint32, GossipMenuItems> GossipMenuItemsMap;
 typedef std::pair<GossipMenuItemsMap::const_iterator, GossipMenuItemsMap::const_iterator> GossipMenuItemsMapBounds;
 
+// gossip_menu_option prepared for SMSG_GOSSIP_MESSAGE, its static part serialized once per distinct text
+struct GossipMenuOptionCompiled
+{
+    GossipMenuItems item;
+    int32 conditionIndex;                                   // in GossipMenuCompiled::conditionIds, -1 without condition
+    std::vector<ByteBuffer> variants;                       // icon, coded, money, option text and box text
+    uint8 variantIndex[MAX_LOCALE][2];                      // by db locale index + 1 and female gender
+
+    ByteBuffer const& GetSerialized(int32 locIdx, uint8 gender) const
+    {
+        if (locIdx + 1 < 0 || locIdx + 1 >= MAX_LOCALE)
+            locIdx = -1;
+        return variants[variantIndex[locIdx + 1][gender == GENDER_FEMALE || gender == GENDER_NONE ? 1 : 0]];
+    }
+};
+
+// options of one gossip menu in their order, a condition used by several options is checked once
+struct GossipMenuCompiled
+{
+    std::vector<uint16> conditionIds;
+    std::vector<GossipMenuOptionCompiled> options;
+};
+
+typedef std::unordered_map<uint32, GossipMenuCompiled> GossipMenuCompiledMap;
+
 struct QuestPOIPoint
 {
     int32 x;
@@ -738,6 +765,7 @@ class ObjectMgr
         void LoadTrainerGreetingLocales();
         void LoadPageTextLocales();
         void LoadGossipMenuItemsLocales();
+        void PrecompileGossipMenus();                       // after the gossip menu options and all their locales
         void LoadPointOfInterestLocales();
         void LoadInstanceEncounters();
         void LoadInstanceTemplate();
@@ -811,7 +839,9 @@ class ObjectMgr
             return itr != mFishingBaseForArea.end() ? itr->second : 0;
         }
 
+        // at startup all expired mails are handled at once, on a running server one batch per call of UpdateOldMails
         void ReturnOrDeleteOldMails(bool serverUp);
+        void UpdateOldMails();
 
         void SetHighestGuids();
 
@@ -1027,10 +1057,22 @@ class ObjectMgr
         int GetOrNewStorageLocaleIndexFor(LocaleConstant loc);
 
         // global grid objects state (static DB spawns, global spawn mods from gameevent system)
-        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
+        // the static spawns are in the spawn cell table once it is built, the sets only keep the others
+        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id) const
         {
-            return mMapObjectGuids[MAKE_PAIR32(mapid, spawnMode)][cell_id];
+            static CellObjectGuids const emptyCell;
+
+            auto mapItr = mMapObjectGuids.find(MAKE_PAIR32(mapid, spawnMode));
+            if (mapItr == mMapObjectGuids.end())
+                return emptyCell;
+
+            auto cellItr = mapItr->second.find(cell_id);
+            return cellItr != mapItr->second.end() ? cellItr->second : emptyCell;
         }
+        SpawnCellTable const& GetSpawnCellTable() const { return m_spawnCellTable; }
+
+        // moves the static spawns from the per-cell sets into the spawn cell table (startup, after the spawns are loaded)
+        void BuildSpawnCellTable();
 
         // modifiers for global grid objects state (static DB spawns, global spawn mods from gameevent system)
         // Don't must be used for modify instance specific spawn state modifications
@@ -1167,6 +1209,14 @@ class ObjectMgr
             return m_mGossipMenuItemsMap.equal_range(uiMenuId);
         }
 
+        GossipMenuCompiled const* GetCompiledGossipMenu(uint32 menuId) const
+        {
+            GossipMenuCompiledMap::const_iterator itr = m_gossipMenusCompiled.find(menuId);
+            return itr != m_gossipMenusCompiled.end() ? &itr->second : nullptr;
+        }
+
+        void GetGossipMenuItemTexts(GossipMenuItems const& item, int32 locIdx, uint8 gender, std::string& optionText, std::string& boxText) const;
+
         ExclusiveQuestGroupsMapBounds GetExclusiveQuestGroupsMapBounds(int32 groupId) const
         {
             return m_ExclusiveQuestGroups.equal_range(groupId);
@@ -1194,6 +1244,13 @@ class ObjectMgr
 
         QuestRelationsMap& GetCreatureQuestRelationsMap() { return m_CreatureQuestRelations; }
 
+        // increased whenever the quests a quest giver offers may have changed for all players (events, resets, reloads)
+        uint32 GetQuestStateVersion() const { return m_questStateVersion; }
+        void IncreaseQuestStateVersion() { ++m_questStateVersion; }
+
+        // increased whenever the quest templates are (re)loaded
+        uint32 GetQuestTemplatesVersion() const { return m_questTemplatesVersion; }
+
         uint32 GetCreatureCooldown(uint32 entry, uint32 spellId)
         {
             auto itrEntry = m_creatureCooldownMap.find(entry);
@@ -1247,7 +1304,7 @@ class ObjectMgr
 
         // first free low guid for selected guid type
         ObjectGuidGenerator<HIGHGUID_PLAYER>     m_CharGuids;
-        ObjectGuidGenerator<HIGHGUID_ITEM>       m_ItemGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_ITEM> m_ItemGuids;
         ObjectGuidGenerator<HIGHGUID_CORPSE>     m_CorpseGuids;
         ObjectGuidGenerator<HIGHGUID_INSTANCE>   m_InstanceGuids;
         ObjectGuidGenerator<HIGHGUID_GROUP>      m_GroupGuids;
@@ -1277,6 +1334,7 @@ class ObjectMgr
 
         GossipMenusMap      m_mGossipMenusMap;
         GossipMenuItemsMap  m_mGossipMenuItemsMap;
+        GossipMenuCompiledMap m_gossipMenusCompiled;
 
         std::unordered_map<uint32, std::vector<uint32>> mCreatureSpawnEntryMap;
 		
@@ -1322,6 +1380,17 @@ class ObjectMgr
 
         MailLevelRewardMap m_mailLevelRewardMap;
 
+        bool ReturnOrDeleteOldMailsBatch(bool serverUp);
+
+        // progress of the expired mails, by mail id
+        time_t m_oldMailsTime;
+        uint32 m_oldMailsLastId;
+        uint32 m_oldMailsCount;
+        bool m_oldMailsPending;
+
+        std::atomic<uint32> m_questStateVersion;
+        std::atomic<uint32> m_questTemplatesVersion;
+
         WorldSafeLocsEntry const* GetClosestGraveyardHelper(
                 GraveYardMapBounds bounds, float x, float y, float z,
                 uint32 mapId, Team team) const;
@@ -1354,6 +1423,7 @@ class ObjectMgr
         CreatureClassLvlStats m_creatureClassLvlStats[DEFAULT_MAX_CREATURE_LEVEL + 1][MAX_CREATURE_CLASS][MAX_EXPANSION + 1];
 
         MapObjectGuids mMapObjectGuids;
+        SpawnCellTable m_spawnCellTable;
         ActiveObjectGuidsOnMap m_activeCreatures;
         ActiveObjectGuidsOnMap m_activeGameObjects;
         CreatureSpawnTemplateMap m_creatureSpawnTemplateMap;
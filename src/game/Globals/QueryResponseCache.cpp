@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Globals/QueryResponseCache.h"
+#include "Policies/Singleton.h"
+
+INSTANTIATE_SINGLETON_1(QueryResponseCache);
+
+QueryResponseCache::QueryResponseCache()
+{
+    for (std::atomic<uint32>& version : m_versions)
+        version = 0;
+}
+
+std::shared_ptr<WorldPacket const> QueryResponseCache::Get(QueryResponseType type, uint32 entry, int32 locIdx, uint32& ticket) const
+{
+    Shard const& shard = GetShard(entry);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto itr = shard.responses.find(MakeKey(type, entry, locIdx));
+    if (itr != shard.responses.end())
+        return itr->second;
+
+    ticket = m_versions[type];
+    return nullptr;
+}
+
+std::shared_ptr<WorldPacket const> QueryResponseCache::Store(QueryResponseType type, uint32 entry, int32 locIdx, uint32 ticket, WorldPacket const& packet)
+{
+    std::shared_ptr<WorldPacket const> response = std::make_shared<WorldPacket const>(packet);
+
+    Shard& shard = GetShard(entry);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    if (m_versions[type] != ticket)
+        return response;
+
+    if (shard.responses.size() >= QUERY_RESPONSE_CACHE_SHARD_SIZE)
+        shard.responses.clear();
+
+    shard.responses[MakeKey(type, entry, locIdx)] = response;
+    return response;
+}
+
+void QueryResponseCache::Clear(QueryResponseType type)
+{
+    ++m_versions[type];
+
+    for (Shard& shard : m_shards)
+    {
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        for (auto itr = shard.responses.begin(); itr != shard.responses.end();)
+        {
+            if ((itr->first >> 40) == uint64(type))
+                itr = shard.responses.erase(itr);
+            else
+                ++itr;
+        }
+    }
+}
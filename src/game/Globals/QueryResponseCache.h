@@ -0,0 +1,79 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_QUERYRESPONSECACHE_H
+#define MANGOS_QUERYRESPONSECACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#define QUERY_RESPONSE_CACHE_SHARDS     16
+#define QUERY_RESPONSE_CACHE_SHARD_SIZE 32768               // responses per shard before the shard is emptied
+
+enum QueryResponseType
+{
+    QUERY_RESPONSE_CREATURE     = 0,                        // SMSG_CREATURE_QUERY_RESPONSE
+    QUERY_RESPONSE_GAMEOBJECT   = 1,                        // SMSG_GAMEOBJECT_QUERY_RESPONSE
+    QUERY_RESPONSE_ITEM         = 2,                        // SMSG_ITEM_QUERY_SINGLE_RESPONSE
+};
+
+#define MAX_QUERY_RESPONSE_TYPE 3
+
+/**
+ * Serialized responses to the template queries of the clients per entry and db locale, built at
+ * the first query and then sent as shared packets without being serialized again.
+ *
+ * Safe to use from all threads, the responses are split over shards with a lock each.
+ * A miss takes a ticket before the response is built; it is only stored if the responses of its
+ * type were not cleared meanwhile, so no response built from reloaded data outlives the reload.
+ */
+class QueryResponseCache
+{
+    public:
+        QueryResponseCache();
+
+        std::shared_ptr<WorldPacket const> Get(QueryResponseType type, uint32 entry, int32 locIdx, uint32& ticket) const;
+        std::shared_ptr<WorldPacket const> Store(QueryResponseType type, uint32 entry, int32 locIdx, uint32 ticket, WorldPacket const& packet);
+
+        // after a (re)load of the templates or locales of the type
+        void Clear(QueryResponseType type);
+
+    private:
+        struct Shard
+        {
+            mutable std::mutex lock;
+            std::unordered_map<uint64, std::shared_ptr<WorldPacket const>> responses;
+        };
+
+        static uint64 MakeKey(QueryResponseType type, uint32 entry, int32 locIdx) { return (uint64(type) << 40) | (uint64(uint8(locIdx + 1)) << 32) | entry; }
+
+        Shard& GetShard(uint32 entry) { return m_shards[entry % QUERY_RESPONSE_CACHE_SHARDS]; }
+        Shard const& GetShard(uint32 entry) const { return m_shards[entry % QUERY_RESPONSE_CACHE_SHARDS]; }
+
+        Shard m_shards[QUERY_RESPONSE_CACHE_SHARDS];
+        std::atomic<uint32> m_versions[MAX_QUERY_RESPONSE_TYPE]; // increased by each clear of the type
+};
+
+#define sQueryResponseCache MaNGOS::Singleton<QueryResponseCache>::Instance()
+
+#endif
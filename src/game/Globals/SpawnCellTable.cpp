@@ -0,0 +1,86 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Globals/SpawnCellTable.h"
+
+#include <algorithm>
+
+void SpawnCellTable::Build(std::vector<Spawn>& spawns)
+{
+    std::sort(spawns.begin(), spawns.end(), [](Spawn const& left, Spawn const& right)
+    {
+        if (left.cellKey != right.cellKey)
+            return left.cellKey < right.cellKey;
+        if (left.gameObject != right.gameObject)
+            return !left.gameObject;
+        return left.guid < right.guid;
+    });
+
+    m_cellKeys.clear();
+    m_cellRanges.clear();
+    m_guids.clear();
+    m_entries.clear();
+
+    m_guids.reserve(spawns.size());
+    m_entries.reserve(spawns.size());
+    m_removed.assign(spawns.size(), 0);
+
+    for (Spawn const& spawn : spawns)
+    {
+        uint32 idx = uint32(m_guids.size());
+        if (m_cellKeys.empty() || m_cellKeys.back() != spawn.cellKey)
+        {
+            m_cellKeys.push_back(spawn.cellKey);
+            m_cellRanges.emplace_back();
+            m_cellRanges.back().begin = idx;
+            m_cellRanges.back().creaturesEnd = idx;
+        }
+
+        CellRange& range = m_cellRanges.back();
+        if (!spawn.gameObject)
+            range.creaturesEnd = idx + 1;
+        range.end = idx + 1;
+
+        m_guids.push_back(spawn.guid);
+        m_entries.push_back(spawn.entry);
+    }
+}
+
+SpawnCellTable::CellRange SpawnCellTable::GetCell(uint32 mapId, uint8 spawnMode, uint32 cellId) const
+{
+    uint64 key = MakeCellKey(mapId, spawnMode, cellId);
+    auto itr = std::lower_bound(m_cellKeys.begin(), m_cellKeys.end(), key);
+    if (itr == m_cellKeys.end() || *itr != key)
+        return CellRange();
+
+    return m_cellRanges[itr - m_cellKeys.begin()];
+}
+
+bool SpawnCellTable::SetRemoved(uint32 mapId, uint8 spawnMode, uint32 cellId, bool gameObject, uint32 guid, bool removed)
+{
+    CellRange range = GetCell(mapId, spawnMode, cellId);
+    uint32 begin = gameObject ? range.creaturesEnd : range.begin;
+    uint32 end = gameObject ? range.end : range.creaturesEnd;
+
+    auto itr = std::lower_bound(m_guids.begin() + begin, m_guids.begin() + end, guid);
+    if (itr == m_guids.begin() + end || *itr != guid)
+        return false;
+
+    m_removed[itr - m_guids.begin()] = removed ? 1 : 0;
+    return true;
+}
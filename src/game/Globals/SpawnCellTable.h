@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SPAWNCELLTABLE_H
+#define MANGOS_SPAWNCELLTABLE_H
+
+#include "Common.h"
+
+/**
+ * The static DB spawns of all maps, packed in parallel arrays sorted by (map, spawn mode, cell).
+ * The spawns of a cell are one contiguous range, the creatures first, so a grid load scans them
+ * linearly instead of walking a set per cell.
+ *
+ * Built once after the spawns are loaded. Spawns removed later are only flagged and come back by
+ * unflagging them; spawns that are not in the table are kept in the per-cell sets of ObjectMgr.
+ * Reading never changes the table, the flags are only changed by the world thread.
+ */
+class SpawnCellTable
+{
+    public:
+        struct Spawn
+        {
+            uint64 cellKey;
+            bool gameObject;
+            uint32 guid;
+            uint32 entry;                                   // of gameobjects, 0 for creatures
+        };
+
+        struct CellRange
+        {
+            CellRange() : begin(0), creaturesEnd(0), end(0) {}
+
+            uint32 begin;
+            uint32 creaturesEnd;                            // first gameobject
+            uint32 end;
+        };
+
+        static uint64 MakeCellKey(uint32 mapId, uint8 spawnMode, uint32 cellId)
+        {
+            return (uint64(mapId) << 40) | (uint64(spawnMode) << 32) | cellId;
+        }
+
+        void Build(std::vector<Spawn>& spawns);
+
+        // empty range if the cell has no spawns in the table
+        CellRange GetCell(uint32 mapId, uint8 spawnMode, uint32 cellId) const;
+
+        uint32 GetGuid(uint32 idx) const { return m_guids[idx]; }
+        uint32 GetEntry(uint32 idx) const { return m_entries[idx]; }
+        bool IsRemoved(uint32 idx) const { return m_removed[idx] != 0; }
+
+        // returns false if the spawn is not in the table
+        bool SetRemoved(uint32 mapId, uint8 spawnMode, uint32 cellId, bool gameObject, uint32 guid, bool removed);
+
+        size_t GetSpawnCount() const { return m_guids.size(); }
+        size_t GetCellCount() const { return m_cellKeys.size(); }
+
+    private:
+        std::vector<uint64> m_cellKeys;                     // ascending
+        std::vector<CellRange> m_cellRanges;                // of the cell with the same index
+        std::vector<uint32> m_guids;
+        std::vector<uint32> m_entries;
+        std::vector<uint8> m_removed;
+};
+
+#endif
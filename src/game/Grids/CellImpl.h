@@ -61,6 +61,10 @@ template<class T, class CONTAINER>
 inline void
 Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, float x, float y, float radius) const
 {
+    // the visitor handles no type of this container, e.g. players in the grid objects, no need to walk the cells
+    if (!TypeContainerVisitor<T, CONTAINER>::IsNeeded)
+        return;
+
     if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
         return;
 
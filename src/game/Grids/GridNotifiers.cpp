@@ -57,9 +57,9 @@ void VisibleNotifier::Notify()
     }
 
     // Far objects update on player notify
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
     {
-        GuidSet::iterator current = itr++;
+        GuidHashSet::iterator current = itr++;
         if (WorldObject* obj = player.GetMap()->GetWorldObject(*current))
         {
             if (!obj->GetVisibilityData().IsVisibilityOverridden())
@@ -70,7 +70,7 @@ void VisibleNotifier::Notify()
         }
     }
 
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
     {
         if ((*itr).IsMOTransport())
         {
@@ -82,7 +82,7 @@ void VisibleNotifier::Notify()
 
     // generate outOfRange for not iterate objects
     i_data.AddOutOfRangeGUID(i_clientGUIDs);
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
+    for (GuidHashSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
     {
         if (WorldObject* target = player.GetMap()->GetWorldObject(*itr))
             if (target->GetTypeId() == TYPEID_UNIT)
@@ -156,6 +156,48 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
     }
 }
 
+void MovementRelayDeliverer::Visit(CameraMapType& m)
+{
+    for (auto& iter : m)
+    {
+        Player* owner = iter.getSource()->GetOwner();
+
+        if (!owner->InSamePhase(i_phaseMask) || owner->GetObjectGuid() == i_skipped_receiver)
+            continue;
+
+        if (WorldSession* session = owner->GetSession())
+            for (auto const& message : i_messages)
+                session->SendPacket(SharedWorldPacket(message));
+    }
+}
+
+void CombatLogDeliverer::Visit(CameraMapType& m)
+{
+    for (auto& iter : m)
+    {
+        Player* owner = iter.getSource()->GetOwner();
+        WorldSession* session = owner->GetSession();
+        if (!session)
+            continue;
+
+        WorldObject const* body = iter.getSource()->GetBody();
+        for (Source const& source : i_sources)
+        {
+            // a player source has already sent its own combat log
+            if (source.unit == owner || !owner->InSamePhase(source.phaseMask))
+                continue;
+
+            float dx = body->GetPositionX() - source.unit->GetPositionX();
+            float dy = body->GetPositionY() - source.unit->GetPositionY();
+            if (dx * dx + dy * dy > source.rangeSq)
+                continue;
+
+            for (auto const& packet : *source.packets)
+                session->SendPacket(SharedWorldPacket(packet));
+        }
+    }
+}
+
 void ObjectMessageDeliverer::Visit(CameraMapType& m)
 {
     for (auto& iter : m)
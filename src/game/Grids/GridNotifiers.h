@@ -27,6 +27,7 @@
 #include "Entities/GameObject.h"
 #include "Entities/Player.h"
 #include "Entities/Unit.h"
+#include "Entities/GuidHashSet.h"
 
 #include <functional>
 #include <memory>
@@ -37,7 +38,7 @@ namespace MaNGOS
     {
         Camera& i_camera;
         UpdateData i_data;
-        GuidSet i_clientGUIDs;
+        GuidHashSet i_clientGUIDs;
         WorldObjectSet i_visibleNow;
 
         explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->m_clientGUIDs) {}
@@ -58,7 +59,7 @@ namespace MaNGOS
     struct MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
@@ -68,7 +69,7 @@ namespace MaNGOS
     struct MessageDelivererExcept
     {
         uint32        i_phaseMask;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldObject const* obj, WorldPacket const& msg, Player const* skipped)
@@ -78,10 +79,47 @@ namespace MaNGOS
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
+    // several packets of one mover, each receiver gets them in order
+    struct MovementRelayDeliverer
+    {
+        typedef TYPELIST_1(Camera) VisitedTypes;
+
+        uint32 i_phaseMask;
+        std::vector<std::shared_ptr<WorldPacket const>> const& i_messages;
+        ObjectGuid i_skipped_receiver;
+
+        MovementRelayDeliverer(WorldObject const* obj, std::vector<std::shared_ptr<WorldPacket const>> const& msgs, ObjectGuid skipped)
+            : i_phaseMask(obj->GetPhaseMask()), i_messages(msgs), i_skipped_receiver(skipped) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
+    // combat log packets of several sources, each receiver gets those of the sources it is in range of
+    struct CombatLogDeliverer
+    {
+        typedef TYPELIST_1(Camera) VisitedTypes;
+
+        struct Source
+        {
+            Unit const* unit;
+            uint32 phaseMask;
+            float rangeSq;                                  // 2d, around the source
+            std::vector<std::shared_ptr<WorldPacket const>> const* packets;
+        };
+
+        std::vector<Source> const& i_sources;
+
+        explicit CombatLogDeliverer(std::vector<Source> const& sources) : i_sources(sources) {}
+
+        void Visit(CameraMapType& m);
+        template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
+    };
+
     struct ObjectMessageDeliverer
     {
         uint32 i_phaseMask;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         explicit ObjectMessageDeliverer(WorldObject const& obj, WorldPacket const& msg)
             : i_phaseMask(obj.GetPhaseMask()), i_message(msg) {}
         void Visit(CameraMapType& m);
@@ -91,7 +129,7 @@ namespace MaNGOS
     struct MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -105,7 +143,7 @@ namespace MaNGOS
     struct ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
@@ -115,7 +153,7 @@ namespace MaNGOS
     struct SpellMessageDestLocDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        SharedWorldPacket i_message;
         bool i_accumulate;
         GuidSet i_guids;
         SpellMessageDestLocDeliverer(WorldObject const& obj, WorldPacket const& msg) : i_object(obj), i_message(msg), i_accumulate(true) {}
@@ -138,10 +176,13 @@ namespace MaNGOS
             uint32 m_timeDiff;
     };
 
+    // notified holds the units whose walk already ran in the same AI notify batch, their pairs with
+    // this unit were evaluated then. pairs of two players are not symmetric and always evaluated
     struct PlayerVisitObjectsNotifier
     {
         Player& i_player;
-        PlayerVisitObjectsNotifier(Player& pl) : i_player(pl) {}
+        GuidHashSet const* i_notified;
+        PlayerVisitObjectsNotifier(Player& pl, GuidHashSet const* notified = nullptr) : i_player(pl), i_notified(notified) {}
         template<class T> void Visit(GridRefManager<T>&) {}
 #ifdef _MSC_VER
         template<> void Visit(PlayerMapType&);
@@ -152,7 +193,8 @@ namespace MaNGOS
     struct CreatureVisitObjectsNotifier
     {
         Creature& i_creature;
-        CreatureVisitObjectsNotifier(Creature& c) : i_creature(c) {}
+        GuidHashSet const* i_notified;
+        CreatureVisitObjectsNotifier(Creature& c, GuidHashSet const* notified = nullptr) : i_creature(c), i_notified(notified) {}
         template<class T> void Visit(GridRefManager<T>&) {}
 #ifdef _MSC_VER
         template<> void Visit(PlayerMapType&);
@@ -305,6 +347,8 @@ namespace MaNGOS
     template<class Check>
     struct GameObjectSearcher
     {
+        typedef TYPELIST_1(GameObject) VisitedTypes;
+
         uint32 i_phaseMask;
         GameObject*& i_object;
         Check& i_check;
@@ -321,6 +365,8 @@ namespace MaNGOS
     template<class Check>
     struct GameObjectLastSearcher
     {
+        typedef TYPELIST_1(GameObject) VisitedTypes;
+
         uint32 i_phaseMask;
         GameObject*& i_object;
         Check& i_check;
@@ -336,6 +382,8 @@ namespace MaNGOS
     template<class Check>
     struct GameObjectListSearcher
     {
+        typedef TYPELIST_1(GameObject) VisitedTypes;
+
         uint32 i_phaseMask;
         GameObjectList& i_objects;
         Check& i_check;
@@ -354,6 +402,8 @@ namespace MaNGOS
     template<class Check>
     struct UnitSearcher
     {
+        typedef TYPELIST_2(Player, Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         Unit*& i_object;
         Check& i_check;
@@ -371,6 +421,8 @@ namespace MaNGOS
     template<class Check>
     struct UnitLastSearcher
     {
+        typedef TYPELIST_2(Player, Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         Unit*& i_object;
         Check& i_check;
@@ -388,6 +440,8 @@ namespace MaNGOS
     template<class Check>
     struct UnitListSearcher
     {
+        typedef TYPELIST_2(Player, Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         UnitList& i_objects;
         Check& i_check;
@@ -406,6 +460,8 @@ namespace MaNGOS
     template<class Check>
     struct CreatureSearcher
     {
+        typedef TYPELIST_1(Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         Creature*& i_object;
         Check& i_check;
@@ -422,6 +478,8 @@ namespace MaNGOS
     template<class Check>
     struct CreatureLastSearcher
     {
+        typedef TYPELIST_1(Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         Creature*& i_object;
         Check& i_check;
@@ -437,6 +495,8 @@ namespace MaNGOS
     template<class Check>
     struct CreatureListSearcher
     {
+        typedef TYPELIST_1(Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         CreatureList& i_objects;
         Check& i_check;
@@ -452,6 +512,8 @@ namespace MaNGOS
     template<class Do>
     struct CreatureWorker
     {
+        typedef TYPELIST_1(Creature) VisitedTypes;
+
         uint32 i_phaseMask;
         Do& i_do;
 
@@ -473,6 +535,8 @@ namespace MaNGOS
     template<class Check>
     struct PlayerSearcher
     {
+        typedef TYPELIST_1(Player) VisitedTypes;
+
         uint32 i_phaseMask;
         Player*& i_object;
         Check& i_check;
@@ -488,6 +552,8 @@ namespace MaNGOS
     template<class Check>
     struct PlayerListSearcher
     {
+        typedef TYPELIST_1(Player) VisitedTypes;
+
         uint32 i_phaseMask;
         PlayerList& i_objects;
         Check& i_check;
@@ -503,6 +569,8 @@ namespace MaNGOS
     template<class Do>
     struct PlayerWorker
     {
+        typedef TYPELIST_1(Player) VisitedTypes;
+
         uint32 i_phaseMask;
         Do& i_do;
 
@@ -522,6 +590,8 @@ namespace MaNGOS
     template<class Do>
     struct CameraDistWorker
     {
+        typedef TYPELIST_1(Camera) VisitedTypes;
+
         WorldObject const* i_searcher;
         float i_dist;
         Do& i_do;
@@ -543,6 +613,8 @@ namespace MaNGOS
 
     struct CameraDistLambdaWorker
     {
+        typedef TYPELIST_1(Camera) VisitedTypes;
+
         WorldObject const* i_searcher;
         float i_dist;
         std::function<void(Player*)> const& i_do;
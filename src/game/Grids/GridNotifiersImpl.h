@@ -111,7 +111,7 @@ inline void MaNGOS::PlayerVisitObjectsNotifier::Visit(CreatureMapType& m)
     for (auto& iter : m)
     {
         Creature* creature = iter.getSource();
-        if (!creature->IsAlive())
+        if (!creature->IsAlive() || (i_notified && i_notified->count(creature->GetObjectGuid())))
             continue;
 
         UnitVisitObjectsNotifierWorker(creature, &i_player);
@@ -152,7 +152,7 @@ inline void MaNGOS::CreatureVisitObjectsNotifier::Visit(PlayerMapType& m)
     for (auto& iter : m)
     {
         Player* player = iter.getSource();
-        if (!player->IsAlive() || player->IsTaxiFlying())
+        if (!player->IsAlive() || player->IsTaxiFlying() || (i_notified && i_notified->count(player->GetObjectGuid())))
             continue;
 
         if (player->AI())
@@ -171,7 +171,7 @@ inline void MaNGOS::CreatureVisitObjectsNotifier::Visit(CreatureMapType& m)
     for (auto& iter : m)
     {
         Creature* creature = iter.getSource();
-        if (creature == &i_creature || !creature->IsAlive())
+        if (creature == &i_creature || !creature->IsAlive() || (i_notified && i_notified->count(creature->GetObjectGuid())))
             continue;
 
         UnitVisitObjectsNotifierWorker(creature, &i_creature);
@@ -59,7 +59,8 @@ RemovalState::Update(Map& m, NGridType& grid, GridInfo& info, const uint32& x, c
     if (!info.getUnloadLock())
     {
         info.UpdateTimeTracker(t_diff);
-        if (info.getTimeTracker().Passed())
+        // a started unload goes on in each update until the grid is gone
+        if (grid.GetUnloadedCells() || info.getTimeTracker().Passed())
         {
             if (!m.UnloadGrid(x, y, false))
             {
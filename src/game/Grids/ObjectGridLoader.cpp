@@ -27,6 +27,15 @@
 #include "Grids/CellImpl.h"
 #include "Maps/GridDefines.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <future>
+
+// below this many spawns in a grid, starting threads costs more than building the instances
+#define GRID_LOAD_PARALLEL_MIN_OBJECTS  64
+
 class ObjectGridRespawnMover
 {
     public:
@@ -112,23 +121,16 @@ template<> void addUnitState(Creature* obj, CellPair const& cell_pair)
 }
 
 template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+void LoadHelper(std::vector<ObjectGridLoader::PreparedObject<T>>& prepared, CellPair& cell, uint32& count, Map* map, GridType& grid)
 {
     BattleGround* bg = map->IsBattleGroundOrArena() ? ((BattleGroundMap*)map)->GetBG() : nullptr;
 
-    for (uint32 guid : guid_set)
+    for (ObjectGridLoader::PreparedObject<T>& preparedObj : prepared)
     {
-        T* obj;
-        if (std::is_same<T, GameObject>::value) // TODO: When c++17 is added change to constexpr
-        {
-            GameObjectData const* data = sObjectMgr.GetGOData(guid);
-            MANGOS_ASSERT(data);
-            obj = (T*)GameObject::CreateGameObject(data->id);
-        }
-        else
-            obj = new T;
+        T* obj = preparedObj.object;
+        preparedObj.object = nullptr;
         // sLog.outString("DEBUG: LoadHelper from table: %s for (guid: %u) Loading",table,guid);
-        if (!obj->LoadFromDB(guid, map, guid))
+        if (!obj->LoadFromDB(preparedObj.guid, map, preparedObj.guid))
         {
             delete obj;
             continue;
@@ -184,33 +186,25 @@ void LoadHelper(CellCorpseSet const& cell_corpses, CellPair& cell, CorpseMapType
 }
 
 void
-ObjectGridLoader::Visit(GameObjectMapType& m)
+ObjectGridLoader::Visit(GameObjectMapType& /*m*/)
 {
     uint32 x = (i_cell.GridX() * MAX_NUMBER_OF_CELLS) + i_cell.CellX();
     uint32 y = (i_cell.GridY() * MAX_NUMBER_OF_CELLS) + i_cell.CellY();
     CellPair cell_pair(x, y);
-    uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
-
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
+    LoadHelper(i_prepared[i_cell.CellX()][i_cell.CellY()].gameObjects, cell_pair, i_gameObjects, i_map, grid);
 }
 
 void
-ObjectGridLoader::Visit(CreatureMapType& m)
+ObjectGridLoader::Visit(CreatureMapType& /*m*/)
 {
     uint32 x = (i_cell.GridX() * MAX_NUMBER_OF_CELLS) + i_cell.CellX();
     uint32 y = (i_cell.GridY() * MAX_NUMBER_OF_CELLS) + i_cell.CellY();
     CellPair cell_pair(x, y);
-    uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
-
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).creatures, cell_pair, m, i_creatures, i_map, grid);
+    LoadHelper(i_prepared[i_cell.CellX()][i_cell.CellY()].creatures, cell_pair, i_creatures, i_map, grid);
 }
 
 void
@@ -235,6 +229,7 @@ ObjectGridLoader::Load(GridType& grid)
         grid.Visit(loader);
     }
 
+    if (i_cells == MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS)
     {
         ObjectWorldLoader wloader(*this);
         TypeContainerVisitor<ObjectWorldLoader, WorldTypeMapContainer > loader(wloader);
@@ -243,21 +238,125 @@ ObjectGridLoader::Load(GridType& grid)
     }
 }
 
-void ObjectGridLoader::LoadN(void)
+void ObjectGridLoader::PrepareN()
+{
+    SpawnCellTable const& spawnTable = sObjectMgr.GetSpawnCellTable();
+
+    uint32 total = 0;
+    for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
+    {
+        for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
+        {
+            if (x * MAX_NUMBER_OF_CELLS + y >= i_cells)
+                continue;
+
+            CellPair cell_pair(i_cell.GridX() * MAX_NUMBER_OF_CELLS + x, i_cell.GridY() * MAX_NUMBER_OF_CELLS + y);
+            uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
+
+            CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
+            MapCellObjectGuids const& state_guids = i_map->GetPersistentState()->GetCellObjectGuids(cell_id);
+
+            PreparedCell& prepared = i_prepared[x][y];
+
+            // the static spawns of the cell, creatures then gameobjects
+            SpawnCellTable::CellRange range = spawnTable.GetCell(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
+            for (uint32 idx = range.begin; idx < range.creaturesEnd; ++idx)
+                if (!spawnTable.IsRemoved(idx))
+                    prepared.creatures.emplace_back(spawnTable.GetGuid(idx), 0);
+            for (uint32 idx = range.creaturesEnd; idx < range.end; ++idx)
+                if (!spawnTable.IsRemoved(idx))
+                    prepared.gameObjects.emplace_back(spawnTable.GetGuid(idx), spawnTable.GetEntry(idx));
+
+            for (CellGuidSet const* guids : { &cell_guids.creatures, &state_guids.creatures })
+                for (uint32 guid : *guids)
+                    prepared.creatures.emplace_back(guid, 0);
+
+            for (CellGuidSet const* guids : { &cell_guids.gameobjects, &state_guids.gameobjects })
+            {
+                for (uint32 guid : *guids)
+                {
+                    GameObjectData const* data = sObjectMgr.GetGOData(guid);
+                    MANGOS_ASSERT(data);
+                    prepared.gameObjects.emplace_back(guid, data->id);
+                }
+            }
+
+            total += prepared.creatures.size() + prepared.gameObjects.size();
+        }
+    }
+
+    uint32 threads = std::min<uint32>(sWorld.getConfig(CONFIG_UINT32_GRID_LOAD_THREADS), MAX_NUMBER_OF_CELLS);
+    if (threads <= 1 || total < GRID_LOAD_PARALLEL_MIN_OBJECTS)
+    {
+        for (auto& row : i_prepared)
+            for (PreparedCell& prepared : row)
+                BuildPrepared(prepared);
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    for (uint32 thread = 0; thread < threads; ++thread)
+    {
+        futures.push_back(std::async(std::launch::async, [this, thread, threads]()
+        {
+            for (uint32 x = thread; x < MAX_NUMBER_OF_CELLS; x += threads)
+                for (PreparedCell& prepared : i_prepared[x])
+                    BuildPrepared(prepared);
+        }));
+    }
+
+    for (auto& future : futures)
+        future.wait();
+}
+
+void ObjectGridLoader::BuildPrepared(PreparedCell& prepared)
+{
+    // only construction here, loading the instances does touch the map
+    for (PreparedObject<Creature>& creature : prepared.creatures)
+        creature.object = new Creature;
+
+    for (PreparedObject<GameObject>& gameObject : prepared.gameObjects)
+        gameObject.object = GameObject::CreateGameObject(gameObject.entry);
+}
+
+void ObjectGridLoader::LoadN(uint32 cells)
 {
     i_gameObjects = 0; i_creatures = 0; i_corpses = 0;
+    i_cells = cells;
+
+    uint32 const startTime = WorldTimer::getMSTime();
+    PrepareN();
+    uint32 const prepareTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+
     i_cell.data.Part.cell_y = 0;
     for (unsigned int x = 0; x < MAX_NUMBER_OF_CELLS; ++x)
     {
         i_cell.data.Part.cell_x = x;
         for (unsigned int y = 0; y < MAX_NUMBER_OF_CELLS; ++y)
         {
+            if (x * MAX_NUMBER_OF_CELLS + y >= i_cells)
+                break;
+
             i_cell.data.Part.cell_y = y;
             GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
             loader.Load(i_grid(x, y), *this);
         }
     }
-    DETAIL_FILTER_LOG(LOG_FILTER_MAP_LOADING, "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u", i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId());
+    uint32 const loadTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+    DETAIL_FILTER_LOG(LOG_FILTER_MAP_LOADING, "%u GameObjects, %u Creatures, and %u Corpses/Bones loaded for grid %u on map %u in %u ms (%u ms building instances)",
+        i_gameObjects, i_creatures, i_corpses, i_grid.GetGridId(), i_map->GetId(), loadTime, prepareTime);
+
+#ifdef BUILD_METRICS
+    metric::measurement meas("map.grid_load", {
+        { "map_id", std::to_string(i_map->GetId()) },
+        { "instance_id", std::to_string(i_map->GetInstanceId()) }
+    });
+    meas.add_field("grid_id", std::to_string(i_grid.GetGridId()));
+    meas.add_field("creatures", std::to_string(i_creatures));
+    meas.add_field("gameobjects", std::to_string(i_gameObjects));
+    meas.add_field("prepare_time", std::to_string(prepareTime));
+    meas.add_field("link_time", std::to_string(loadTime - prepareTime));
+#endif
 }
 
 void ObjectGridUnloader::MoveToRespawnN()
@@ -291,6 +390,7 @@ ObjectGridUnloader::Visit(GridRefManager<T>& m)
             obj->SaveRespawnTime();
         ///- object must be out of world before delete
         obj->RemoveFromWorld();
+        obj->GetMap()->ReleaseLocalLowGuid(obj->GetObjectGuid());
         ///- object will get delinked from the manager when deleted
         delete obj;
     }
@@ -25,7 +25,11 @@
 #include "Maps/GridDefines.h"
 #include "Grids/Cell.h"
 
+#include <vector>
+
 class ObjectWorldLoader;
+class Creature;
+class GameObject;
 
 class ObjectGridLoader
 {
@@ -33,7 +37,7 @@ class ObjectGridLoader
 
     public:
         ObjectGridLoader(NGridType& grid, Map* map, const Cell& cell)
-            : i_cell(cell), i_grid(grid), i_map(map), i_gameObjects(0), i_creatures(0), i_corpses(0)
+            : i_cell(cell), i_grid(grid), i_map(map), i_cells(MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS), i_gameObjects(0), i_creatures(0), i_corpses(0)
         {}
 
         void Load(GridType& grid);
@@ -43,15 +47,40 @@ class ObjectGridLoader
 
         void Visit(DynamicObjectMapType&) { }
 
-        void LoadN(void);
+        // loads the first cells in the order x * MAX_NUMBER_OF_CELLS + y, all by default.
+        // the corpses are only loaded with the whole grid, the unload of cells does not remove them
+        void LoadN(uint32 cells = MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS);
+
+        // instance built by PrepareN for a db spawn, before it is loaded and linked into the grid
+        template<class T>
+        struct PreparedObject
+        {
+            PreparedObject(uint32 _guid, uint32 _entry) : guid(_guid), entry(_entry), object(nullptr) {}
+
+            uint32 guid;
+            uint32 entry;
+            T* object;
+        };
+
+        struct PreparedCell
+        {
+            std::vector<PreparedObject<Creature>> creatures;
+            std::vector<PreparedObject<GameObject>> gameObjects;
+        };
 
     private:
+        // collects the spawns of every cell, then builds their instances from worker threads
+        void PrepareN();
+        void BuildPrepared(PreparedCell& prepared);
+
         Cell i_cell;
         NGridType& i_grid;
         Map* i_map;
+        uint32 i_cells;
         uint32 i_gameObjects;
         uint32 i_creatures;
         uint32 i_corpses;
+        PreparedCell i_prepared[MAX_NUMBER_OF_CELLS][MAX_NUMBER_OF_CELLS];
 };
 
 class ObjectGridUnloader
@@ -72,6 +101,13 @@ class ObjectGridUnloader
             }
         }
 
+        // the cells are numbered x * MAX_NUMBER_OF_CELLS + y
+        void UnloadCell(uint32 cell)
+        {
+            GridLoader<Player, AllWorldObjectTypes, AllGridObjectTypes> loader;
+            loader.Unload(i_grid(cell / MAX_NUMBER_OF_CELLS, cell % MAX_NUMBER_OF_CELLS), *this);
+        }
+
         void Unload(GridType& grid);
         template<class T> void Visit(GridRefManager<T>& m);
     private:
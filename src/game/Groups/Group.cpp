@@ -30,6 +30,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "Maps/MapManager.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "Maps/PlayerSnapshot.h"
 #include "Spells/SpellAuras.h"
 #include "LFG.h"
 #include "LFGMgr.h"
@@ -44,20 +45,23 @@ GroupMemberStatus GetGroupMemberStatus(const Player* member = nullptr)
     if (!member || (!member->IsInWorld() && !member->IsBeingTeleportedFar()))
         return MEMBER_STATUS_OFFLINE;
 
+    // the member may be updated by its map meanwhile
+    PlayerSnapshot const snapshot = PlayerSnapshot::Get(member);
+
     uint8 flags = MEMBER_STATUS_ONLINE;
-    if (member->IsPvP())
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_PVP))
         flags |= MEMBER_STATUS_PVP;
-    if (member->IsDead())
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_DEAD))
         flags |= MEMBER_STATUS_DEAD;
-    if (member->HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_GHOST))
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_GHOST))
         flags |= MEMBER_STATUS_GHOST;
-    if (member->IsPvPFreeForAll())
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_PVP_FFA))
         flags |= MEMBER_STATUS_PVP_FFA;
     if (!member->IsInWorld())
         flags |= MEMBER_STATUS_ZONE_OUT;
-    if (member->isAFK())
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_AFK))
         flags |= MEMBER_STATUS_AFK;
-    if (member->isDND())
+    if (snapshot.HasFlag(PLAYER_SNAPSHOT_DND))
         flags |= MEMBER_STATUS_DND;
     return GroupMemberStatus(flags);
 }
@@ -687,13 +691,24 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
     if (pPlayer->GetGroupUpdateFlag() == GROUP_UPDATE_FLAG_NONE)
         return;
 
+    // built once for all members, and not at all if every member sees the player
     WorldPacket data;
-    WorldSession::BuildPartyMemberStatsChangedPacket(pPlayer, data);
-
+    bool built = false;
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
+    {
         if (Player* player = itr->getSource())
+        {
             if (player != pPlayer && !player->HaveAtClient(pPlayer))
+            {
+                if (!built)
+                {
+                    WorldSession::BuildPartyMemberStatsChangedPacket(pPlayer, data);
+                    built = true;
+                }
                 player->GetSession()->SendPacket(data);
+            }
+        }
+    }
 }
 
 void Group::UpdatePlayerOnlineStatus(Player* player, bool online /*= true*/)
@@ -737,8 +752,9 @@ void Group::UpdateOfflineLeader(time_t time, uint32 delay)
     _chooseLeader(true);
 }
 
-void Group::BroadcastPacket(WorldPacket const& packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
+void Group::BroadcastPacket(WorldPacket const& data, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    SharedWorldPacket packet(data);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* pl = itr->getSource();
@@ -24,6 +24,7 @@
 #include "Globals/ObjectMgr.h"
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
+#include "Maps/PlayerSnapshot.h"
 #include "Chat/Chat.h"
 #include "Social/SocialMgr.h"
 #include "Util.h"
@@ -99,6 +100,17 @@ Guild::Guild()
     m_GuildBankEventLogNextGuid_Money = 0;
     for (unsigned int& i : m_GuildBankEventLogNextGuid_Item)
         i = 0;
+
+    m_guildEventLogLoaded = false;
+    m_guildBankEventLogLoaded = false;
+    m_guildBankItemsLoaded = false;
+
+    m_rosterVersion = 1;
+    for (RosterCache& cache : m_rosterCache)
+    {
+        cache.version = 0;
+        cache.buildTime = 0;
+    }
 }
 
 Guild::~Guild()
@@ -123,6 +135,11 @@ bool Guild::Create(Player* leader, std::string gname)
     m_Id = sObjectMgr.GenerateGuildId();
     m_CreatedDate = time(nullptr);
 
+    // a new guild has no logs and bank items to load
+    m_guildEventLogLoaded = true;
+    m_guildBankEventLogLoaded = true;
+    m_guildBankItemsLoaded = true;
+
     DEBUG_LOG("GUILD: creating guild %s to leader: %s", gname.c_str(), m_LeaderGuid.GetString().c_str());
 
     // gname already assigned to Guild::name, use it to encode string for DB
@@ -244,6 +261,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
     }
 
     UpdateAccountsNumber();
+    InvalidateRoster();
 
     return true;
 }
@@ -251,6 +269,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
 void Guild::SetMOTD(std::string motd)
 {
     MOTD = motd;
+    InvalidateRoster();
 
     // motd now can be used for encoding to DB
     CharacterDatabase.escape_string(motd);
@@ -260,6 +279,7 @@ void Guild::SetMOTD(std::string motd)
 void Guild::SetGINFO(std::string ginfo)
 {
     GINFO = ginfo;
+    InvalidateRoster();
 
     // ginfo now can be used for encoding to DB
     CharacterDatabase.escape_string(ginfo);
@@ -492,6 +512,7 @@ void Guild::SetLeader(ObjectGuid guid)
 
     m_LeaderGuid = guid;
     slot->ChangeRank(GR_GUILDMASTER);
+    InvalidateRoster();
 
     CharacterDatabase.PExecute("UPDATE guild SET leaderguid='%u' WHERE guildid='%u'", guid.GetCounter(), m_Id);
 }
@@ -548,6 +569,7 @@ bool Guild::DelMember(ObjectGuid guid, bool isDisbanding)
     }
 
     members.erase(lowguid);
+    InvalidateRoster();
 
     Player* player = sObjectMgr.GetPlayer(guid);
     // If player not online data in data field will be loaded from guild tabs no need to update it !!
@@ -688,6 +710,7 @@ void Guild::CreateRank(std::string name_, uint32 rights)
 void Guild::AddRank(const std::string& name_, uint32 rights, uint32 money)
 {
     m_Ranks.push_back(RankInfo(name_, rights, money));
+    InvalidateRoster();
 }
 
 void Guild::DelRank()
@@ -702,6 +725,7 @@ void Guild::DelRank()
     CharacterDatabase.PExecute("DELETE FROM guild_bank_right WHERE rid>='%u' AND guildid='%u'", rank, m_Id);
 
     m_Ranks.pop_back();
+    InvalidateRoster();
 }
 
 std::string Guild::GetRankName(uint32 rankId)
@@ -726,6 +750,7 @@ void Guild::SetRankName(uint32 rankId, std::string name_)
         return;
 
     m_Ranks[rankId].Name = name_;
+    InvalidateRoster();
 
     // name now can be used for encoding to DB
     CharacterDatabase.escape_string(name_);
@@ -738,6 +763,7 @@ void Guild::SetRankRights(uint32 rankId, uint32 rights)
         return;
 
     m_Ranks[rankId].Rights = rights;
+    InvalidateRoster();
 
     CharacterDatabase.PExecute("UPDATE guild_rank SET rights='%u' WHERE rid='%u' AND guildid='%u'", rights, rankId, m_Id);
 }
@@ -763,6 +789,7 @@ void Guild::Disband()
     CharacterDatabase.PExecute("DELETE FROM guild_bank_tab WHERE guildid = '%u'", m_Id);
 
     // Free bank tab used memory and delete items stored in them
+    LoadGuildBankItemsFromDB();
     DeleteGuildBankItems(true);
 
     CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE guildid = '%u'", m_Id);
@@ -774,9 +801,30 @@ void Guild::Disband()
 }
 
 void Guild::Roster(WorldSession* session /*= nullptr*/)
+{
+    bool const officerNotes = session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE);
+
+    // the roster is requested by every member with an open guild frame, build it once per change or cache time
+    RosterCache& cache = m_rosterCache[officerNotes ? 1 : 0];
+    time_t const now = time(nullptr);
+    if (cache.version != m_rosterVersion || now >= cache.buildTime + GUILD_ROSTER_CACHE_TIME)
+    {
+        BuildRoster(cache.packet, officerNotes);
+        cache.version = m_rosterVersion;
+        cache.buildTime = now;
+    }
+
+    if (session)
+        session->SendPacket(cache.packet);
+    else
+        BroadcastPacket(cache.packet);
+    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
+}
+
+void Guild::BuildRoster(WorldPacket& data, bool officerNotes)
 {
     // we can only guess size
-    WorldPacket data(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * (4 + 4 + GUILD_BANK_MAX_TABS * (4 + 4)) + members.size() * 50));
+    data.Initialize(SMSG_GUILD_ROSTER, (4 + MOTD.length() + 1 + GINFO.length() + 1 + 4 + m_Ranks.size() * (4 + 4 + GUILD_BANK_MAX_TABS * (4 + 4)) + members.size() * 50));
     data << uint32(members.size());
     data << MOTD;
     data << GINFO;
@@ -796,16 +844,17 @@ void Guild::Roster(WorldSession* session /*= nullptr*/)
     {
         if (Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first)))
         {
+            PlayerSnapshot const snapshot = PlayerSnapshot::Get(pl);
             data << pl->GetObjectGuid();
             data << uint8(1);
             data << pl->GetName();
             data << uint32(itr->second.RankId);
-            data << uint8(pl->getLevel());
-            data << uint8(pl->getClass());
-            data << uint8(pl->getGender());                                     // new 2.4.0
-            data << uint32(pl->GetZoneId());
+            data << uint8(snapshot.level);
+            data << uint8(snapshot.playerClass);
+            data << uint8(snapshot.gender);                                     // new 2.4.0
+            data << uint32(snapshot.zoneId);
             data << itr->second.Pnote;
-            data << ((session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE)) ? itr->second.OFFnote : "");
+            data << (officerNotes ? itr->second.OFFnote : "");
         }
         else
         {
@@ -819,14 +868,9 @@ void Guild::Roster(WorldSession* session /*= nullptr*/)
             data << uint32(itr->second.ZoneId);
             data << float(float(time(nullptr) - itr->second.LogoutTime) / DAY);
             data << itr->second.Pnote;
-            data << ((session && HasRankRight(session->GetPlayer()->GetRank(), GR_RIGHT_VIEWOFFNOTE)) ? itr->second.OFFnote : "");
+            data << (officerNotes ? itr->second.OFFnote : "");
         }
     }
-    if (session)
-        session->SendPacket(data);
-    else
-        BroadcastPacket(data);
-    DEBUG_LOG("WORLD: Sent (SMSG_GUILD_ROSTER)");
 }
 
 void Guild::Query(WorldSession* session)
@@ -892,6 +936,8 @@ uint32 Guild::GetAccountsNumber()
 // Display guild eventlog
 void Guild::DisplayGuildEventLog(WorldSession* session)
 {
+    LoadGuildEventLogFromDB();
+
     // Sending result
     WorldPacket data(MSG_GUILD_EVENT_LOG_QUERY, 0);
     // count, max count == 100
@@ -918,6 +964,10 @@ void Guild::DisplayGuildEventLog(WorldSession* session)
 // Load guild eventlog from DB
 void Guild::LoadGuildEventLogFromDB()
 {
+    if (m_guildEventLogLoaded)
+        return;
+    m_guildEventLogLoaded = true;
+
     //                                                     0        1          2            3            4        5
     QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, GUILD_EVENTLOG_MAX_RECORDS);
     if (!result)
@@ -955,6 +1005,9 @@ void Guild::LoadGuildEventLogFromDB()
 // Add entry to guild eventlog
 void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2, uint8 newRank)
 {
+    // the next LogGuid continues the loaded log
+    LoadGuildEventLogFromDB();
+
     GuildEventLogEntry NewEvent;
     // Create event
     NewEvent.EventType = EventType;
@@ -981,6 +1034,8 @@ void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid pl
 // Bank content related
 void Guild::DisplayGuildBankContent(WorldSession* session, uint8 TabId)
 {
+    LoadGuildBankItemsFromDB();
+
     GuildBankTab const* tab = m_TabListMap[TabId];
 
     if (!IsMemberHaveRights(session->GetPlayer()->GetGUIDLow(), TabId, GUILD_BANK_RIGHT_VIEW_TAB))
@@ -1102,6 +1157,9 @@ void Guild::DisplayGuildBankContentUpdate(uint8 TabId, GuildItemPosCountVec cons
 
 Item* Guild::GetItem(uint8 TabId, uint8 SlotId)
 {
+    // the first access of the Swap/Move functions, before any slot of the bank is checked
+    LoadGuildBankItemsFromDB();
+
     if (TabId >= GetPurchasedTabs() || SlotId >= GUILD_BANK_MAX_SLOTS)
         return nullptr;
     return m_TabListMap[TabId]->Slots[SlotId];
@@ -1202,10 +1260,21 @@ void Guild::LoadGuildBankFromDB()
     while (result->NextRow());
 
     delete result;
+}
+
+void Guild::LoadGuildBankItemsFromDB()
+{
+    if (m_guildBankItemsLoaded)
+        return;
+    m_guildBankItemsLoaded = true;
+
+    // no purchased tab, no item to load
+    if (m_TabListMap.empty())
+        return;
 
     // data needs to be at first place for Item::LoadFromDB
     //                                        0          1            2                3      4         5        6      7             8                 9           10          11    12     13      14         15
-    result = CharacterDatabase.PQuery("SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId", m_Id);
+    QueryResult* result = CharacterDatabase.PQuery("SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, playedTime, text, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId", m_Id);
     if (!result)
         return;
 
@@ -1219,13 +1288,13 @@ void Guild::LoadGuildBankFromDB()
 
         if (TabId >= GetPurchasedTabs())
         {
-            sLog.outError("Guild::LoadGuildBankFromDB: Invalid tab for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
+            sLog.outError("Guild::LoadGuildBankItemsFromDB: Invalid tab for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
             continue;
         }
 
         if (SlotId >= GUILD_BANK_MAX_SLOTS)
         {
-            sLog.outError("Guild::LoadGuildBankFromDB: Invalid slot for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
+            sLog.outError("Guild::LoadGuildBankItemsFromDB: Invalid slot for item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
             continue;
         }
 
@@ -1233,7 +1302,7 @@ void Guild::LoadGuildBankFromDB()
 
         if (!proto)
         {
-            sLog.outError("Guild::LoadGuildBankFromDB: Unknown item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
+            sLog.outError("Guild::LoadGuildBankItemsFromDB: Unknown item (GUID: %u id: #%u) in guild bank, skipped.", ItemGuid, ItemEntry);
             continue;
         }
 
@@ -1384,6 +1453,7 @@ void Guild::SetBankMoneyPerDay(uint32 rankId, uint32 money)
         money = WITHDRAW_MONEY_UNLIMITED;
 
     m_Ranks[rankId].BankMoneyPerDay = money;
+    InvalidateRoster();
 
     for (auto& itr : members)
     {
@@ -1413,6 +1483,7 @@ void Guild::SetBankRightsAndSlots(uint32 rankId, uint8 TabId, uint32 right, uint
 
     m_Ranks[rankId].TabSlotPerDay[TabId] = nbSlots;
     m_Ranks[rankId].TabRight[TabId] = right;
+    InvalidateRoster();
 
     if (db)
     {
@@ -1494,6 +1565,10 @@ bool Guild::LoadBankRightsFromDB(QueryResult* guildBankTabRightsResult)
 
 void Guild::LoadGuildBankEventLogFromDB()
 {
+    if (m_guildBankEventLogLoaded)
+        return;
+    m_guildBankEventLogLoaded = true;
+
     // Money log is in TabId = GUILD_BANK_MONEY_LOGS_TAB
 
     // uint32 configCount = sWorld.getConfig(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT);
@@ -1583,6 +1658,8 @@ void Guild::DisplayGuildBankLogs(WorldSession* session, uint8 TabId)
     if (TabId > GUILD_BANK_MAX_TABS)
         return;
 
+    LoadGuildBankEventLogFromDB();
+
     if (TabId == GUILD_BANK_MAX_TABS)
     {
         // Here we display money logs
@@ -1647,6 +1724,8 @@ void Guild::DisplayGuildBankLogs(WorldSession* session, uint8 TabId)
 
 void Guild::LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uint32 ItemOrMoney, uint8 ItemStackCount, uint8 DestTabId)
 {
+    LoadGuildBankEventLogFromDB();
+
     // create Event
     GuildBankEventLogEntry NewEvent;
     NewEvent.EventType = EventType;
@@ -2443,6 +2522,54 @@ void Guild::BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1
     DEBUG_LOG("WORLD: Sent SMSG_GUILD_EVENT");
 }
 
+void Guild::QueueMemberPresence(ObjectGuid guid, std::string const& name, bool online)
+{
+    InvalidateRoster();
+
+    // a relog within one world update is not announced at all
+    for (auto itr = m_pendingPresence.begin(); itr != m_pendingPresence.end(); ++itr)
+    {
+        if (itr->guid == guid)
+        {
+            if (itr->online != online)
+                m_pendingPresence.erase(itr);
+            return;
+        }
+    }
+
+    if (m_pendingPresence.empty())
+        sGuildMgr.AddGuildWithPendingEvents(m_Id);
+
+    m_pendingPresence.push_back({ guid, name, online });
+}
+
+void Guild::SendPendingEvents()
+{
+    if (m_pendingPresence.empty())
+        return;
+
+    std::vector<WorldPacket> packets;
+    packets.reserve(m_pendingPresence.size());
+    for (PendingPresence const& presence : m_pendingPresence)
+    {
+        packets.emplace_back(SMSG_GUILD_EVENT, 1 + 1 + presence.name.size() + 1 + 8);
+        WorldPacket& data = packets.back();
+        data << uint8(presence.online ? GE_SIGNED_ON : GE_SIGNED_OFF);
+        data << uint8(1);
+        data << presence.name;
+        data << presence.guid;
+    }
+    m_pendingPresence.clear();
+
+    // one pass over the members for all sign on/off of the update, instead of one per event
+    for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
+        if (Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first)))
+            for (WorldPacket const& data : packets)
+                player->GetSession()->SendPacket(data);
+
+    DEBUG_LOG("WORLD: Sent %u SMSG_GUILD_EVENT of sign on/off", uint32(packets.size()));
+}
+
 void Guild::DeleteGuildBankItems(bool alsoInDB /*= false*/)
 {
     for (auto& i : m_TabListMap)
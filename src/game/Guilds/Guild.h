@@ -26,12 +26,16 @@
 #include "Entities/Item.h"
 #include "Globals/ObjectAccessor.h"
 #include "Globals/SharedDefines.h"
+#include "WorldPacket.h"
 
 class Item;
 
 #define GUILD_RANKS_MIN_COUNT   5
 #define GUILD_RANKS_MAX_COUNT   10
 
+// seconds a built roster is sent again, online members change level and zone without telling their guild
+#define GUILD_ROSTER_CACHE_TIME 10
+
 enum GuildDefaultRanks
 {
     // these ranks can be modified, but they cannot be deleted
@@ -348,6 +352,9 @@ class Guild
         void MassInviteToEvent(WorldSession* session, uint32 minLevel, uint32 maxLevel, uint32 minRank);
 
         void BroadcastEvent(GuildEvents event, ObjectGuid guid, char const* str1 = nullptr, char const* str2 = nullptr, char const* str3 = nullptr);
+        // sign on/off of members, sent together once per world update by GuildMgr
+        void QueueMemberPresence(ObjectGuid guid, std::string const& name, bool online);
+        void SendPendingEvents();
         void BroadcastEvent(GuildEvents event, char const* str1 = nullptr, char const* str2 = nullptr, char const* str3 = nullptr)
         {
             BroadcastEvent(event, ObjectGuid(), str1, str2, str3);
@@ -397,9 +404,10 @@ class Guild
         }
 
         void Roster(WorldSession* session = nullptr);          // nullptr = broadcast
+        void InvalidateRoster() { ++m_rosterVersion; }
         void Query(WorldSession* session);
 
-        // Guild EventLog
+        // Guild EventLog, loaded at first use
         void   LoadGuildEventLogFromDB();
         void   DisplayGuildEventLog(WorldSession* session);
         void   LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2 = ObjectGuid(), uint8 newRank = 0);
@@ -422,8 +430,9 @@ class Guild
         uint8  GetPurchasedTabs() const { return m_TabListMap.size(); }
         uint32 GetBankRights(uint32 rankId, uint8 TabId) const;
         bool   IsMemberHaveRights(uint32 LowGuid, uint8 TabId, uint32 rights) const;
-        // Load
+        // Load, the items of the tabs at first use
         void   LoadGuildBankFromDB();
+        void   LoadGuildBankItemsFromDB();
         // Money deposit/withdraw
         void   SendMoneyInfo(WorldSession* session, uint32 LowGuid);
         bool   MemberMoneyWithdraw(uint32 amount, uint32 LowGuid);
@@ -482,7 +491,30 @@ class Guild
 
         uint64 m_GuildBankMoney;
 
+        bool m_guildEventLogLoaded;
+        bool m_guildBankEventLogLoaded;
+        bool m_guildBankItemsLoaded;
+
+        struct PendingPresence
+        {
+            ObjectGuid guid;
+            std::string name;
+            bool online;
+        };
+        std::vector<PendingPresence> m_pendingPresence;
+
+        // [0] without, [1] with the officer notes
+        struct RosterCache
+        {
+            WorldPacket packet;
+            uint32 version;
+            time_t buildTime;
+        };
+        RosterCache m_rosterCache[2];
+        uint32 m_rosterVersion;
+
     private:
+        void BuildRoster(WorldPacket& data, bool officerNotes);
         void UpdateAccountsNumber() { m_accountsNumber = 0;}// mark for lazy calculation at request in GetAccountsNumber
 
         // used only from high level Swap/Move functions
@@ -295,6 +295,7 @@ void WorldSession::HandleGuildPromoteOpcode(WorldPacket& recvPacket)
     uint32 newRankId = slot->RankId - 1;                    // when promoting player, rank is decreased
 
     slot->ChangeRank(newRankId);
+    guild->InvalidateRoster();
     // Put record into guild log
     guild->LogGuildEvent(GUILD_EVENT_LOG_PROMOTE_PLAYER, GetPlayer()->GetObjectGuid(), slot->guid, newRankId);
 
@@ -356,6 +357,7 @@ void WorldSession::HandleGuildDemoteOpcode(WorldPacket& recvPacket)
     uint32 newRankId = slot->RankId + 1;                    // when demoting player, rank is increased
 
     slot->ChangeRank(newRankId);
+    guild->InvalidateRoster();
     // Put record into guild log
     guild->LogGuildEvent(GUILD_EVENT_LOG_DEMOTE_PLAYER, GetPlayer()->GetObjectGuid(), slot->guid, newRankId);
 
@@ -468,6 +470,7 @@ void WorldSession::HandleGuildLeaderOpcode(WorldPacket& recvPacket)
 
     guild->SetLeader(slot->guid);
     oldSlot->ChangeRank(GR_OFFICER);
+    guild->InvalidateRoster();
 
     guild->BroadcastEvent(GE_LEADER_CHANGED, oldLeader->GetName(), name.c_str());
 }
@@ -534,6 +537,7 @@ void WorldSession::HandleGuildSetPublicNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> PNOTE;
 
     slot->SetPNOTE(PNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
@@ -571,6 +575,7 @@ void WorldSession::HandleGuildSetOfficerNoteOpcode(WorldPacket& recvPacket)
     recvPacket >> OFFNOTE;
 
     slot->SetOFFNOTE(OFFNOTE);
+    guild->InvalidateRoster();
 
     guild->Roster(this);
 }
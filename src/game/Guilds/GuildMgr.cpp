@@ -45,6 +45,7 @@ void GuildMgr::AddGuild(Guild* guild)
 void GuildMgr::RemoveGuild(uint32 guildId)
 {
     m_GuildMap.erase(guildId);
+    m_guildsWithPendingEvents.erase(std::remove(m_guildsWithPendingEvents.begin(), m_guildsWithPendingEvents.end(), guildId), m_guildsWithPendingEvents.end());
 }
 
 Guild* GuildMgr::GetGuildById(uint32 guildId) const
@@ -83,6 +84,15 @@ std::string GuildMgr::GetGuildNameById(uint32 guildId) const
     return "";
 }
 
+void GuildMgr::Update()
+{
+    for (uint32 guildId : m_guildsWithPendingEvents)
+        if (Guild* guild = GetGuildById(guildId))
+            guild->SendPendingEvents();
+
+    m_guildsWithPendingEvents.clear();
+}
+
 void GuildMgr::LoadGuilds()
 {
     uint32 count = 0;
@@ -143,8 +153,7 @@ void GuildMgr::LoadGuilds()
             continue;
         }
 
-        newGuild->LoadGuildEventLogFromDB();
-        newGuild->LoadGuildBankEventLogFromDB();
+        // the items of the bank and the logs are loaded the first time they are used
         newGuild->LoadGuildBankFromDB();
         AddGuild(newGuild);
     }
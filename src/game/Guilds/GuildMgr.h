@@ -29,6 +29,7 @@ class GuildMgr
         typedef std::unordered_map<uint32, Guild*> GuildMap;
 
         GuildMap m_GuildMap;
+        std::vector<uint32> m_guildsWithPendingEvents;
     public:
         GuildMgr();
         ~GuildMgr();
@@ -42,6 +43,10 @@ class GuildMgr
         std::string GetGuildNameById(uint32 guildId) const;
 
         void LoadGuilds();
+
+        // the guilds with queued member events, sent once per world update
+        void AddGuildWithPendingEvents(uint32 guildId) { m_guildsWithPendingEvents.push_back(guildId); }
+        void Update();
 };
 
 #define sGuildMgr MaNGOS::Singleton<GuildMgr>::Instance()
@@ -26,7 +26,9 @@
 #include "World.h"
 #include "Group.h"
 #include "Player.h"
+#include "Maps/PlayerSnapshot.h"
 #include "GameEventMgr.h"
+#include "Metric/Metric.h"
 
 #include <limits>
 
@@ -44,6 +46,8 @@ LFGMgr::LFGMgr()
 
     m_proposalID = 1;
     m_queueID = 1;
+    for (uint8 i = LFG_TYPE_NONE; i < LFG_TYPE_MAX; ++i)
+        m_queueChanged[i] = false;
     m_LFGupdateTimer.SetInterval(LFG_UPDATE_INTERVAL);
     m_LFGupdateTimer.Reset();
     m_LFRupdateTimer.SetInterval(LFR_UPDATE_INTERVAL);
@@ -111,6 +115,9 @@ void LFGMgr::Update(uint32 uiDiff)
         CleanupSearchMatrix();
     }
 
+    uint32 const budget = sWorld.getConfig(CONFIG_UINT32_MATCHMAKING_UPDATE_BUDGET);
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+
     for (uint8 i = LFG_TYPE_NONE; i < LFG_TYPE_MAX; ++i)
     {
 
@@ -127,8 +134,24 @@ void LFGMgr::Update(uint32 uiDiff)
         case LFG_TYPE_HEROIC_DUNGEON:
         case LFG_TYPE_RANDOM_DUNGEON:
         {
-            TryCompleteGroups(type);
-            TryCreateGroup(type);
+            // between the full updates only queues that changed can make a new match
+            if (m_queueChanged[type] || isFullUpdate)
+            {
+                // over the budget, matched next update
+                if (budget && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(budget))
+                    m_queueChanged[type] = true;
+                else
+                {
+#ifdef BUILD_METRICS
+                    metric::duration<std::chrono::microseconds> meas("lfg.matching", { { "type", std::to_string(type) } });
+#endif
+                    m_queueChanged[type] = false;
+                    // one group is made per call, more may follow next update
+                    bool const groupCompleted = TryCompleteGroups(type);
+                    if (TryCreateGroup(type) || groupCompleted)
+                        m_queueChanged[type] = true;
+                }
+            }
             if (isFullUpdate)
             {
                 CleanupProposals(type);
@@ -571,6 +594,7 @@ void LFGMgr::AddToQueue(ObjectGuid guid, LFGType type, bool inBegin)
 
         m_playerQueue[type].insert((inBegin ? m_playerQueue[type].begin() : m_playerQueue[type].end()), pqInfo);
     }
+    m_queueChanged[type] = true;
     DEBUG_LOG("LFGMgr::AddToQueue: %s %u joined, type %u", (guid.IsGroup() ? "group" : "player"), guid.GetCounter(), type);
 }
 
@@ -581,6 +605,7 @@ void LFGMgr::RemoveFromQueue(ObjectGuid guid)
         LFGType type = pqInfo->GetDungeonType();
 
         DEBUG_LOG("LFGMgr::RemoveFromQueue: %s %u removed, type %u", (guid.IsGroup() ? "group" : "player"), guid.GetCounter(), type);
+        m_queueChanged[type] = true;
 
         if (guid.IsGroup())
         {
@@ -707,10 +732,11 @@ LFGLockStatusType LFGMgr::GetPlayerLockStatus(Player* pPlayer, LFGDungeonEntry c
     if (dungeon->difficulty > DUNGEON_DIFFICULTY_NORMAL && isSaved)
         return  LFG_LOCKSTATUS_RAID_LOCKED;
 
-    if (dungeon->minlevel > pPlayer->getLevel())
+    uint8 const level = PlayerSnapshot::Get(pPlayer).level;
+    if (dungeon->minlevel > level)
         return  LFG_LOCKSTATUS_TOO_LOW_LEVEL;
 
-    if (dungeon->maxlevel < pPlayer->getLevel())
+    if (dungeon->maxlevel < level)
         return LFG_LOCKSTATUS_TOO_HIGH_LEVEL;
 
     uint32 miscRequirement = 0;
@@ -800,10 +826,11 @@ LFGLockStatusType LFGMgr::GetPlayerExpansionLockStatus(Player* pPlayer, LFGDunge
     if (!dungeonExpansion)
         return LFG_LOCKSTATUS_OK;
 
-    if (dungeonExpansion->minlevelHard > pPlayer->getLevel())
+    uint8 const level = PlayerSnapshot::Get(pPlayer).level;
+    if (dungeonExpansion->minlevelHard > level)
         return  LFG_LOCKSTATUS_TOO_LOW_LEVEL;
 
-    if (dungeonExpansion->maxlevelHard < pPlayer->getLevel())
+    if (dungeonExpansion->maxlevelHard < level)
         return LFG_LOCKSTATUS_TOO_HIGH_LEVEL;
 
     /*
@@ -1536,6 +1563,7 @@ void LFGMgr::RemoveProposal(uint32 ID, bool success)
                 {
                     pPlayer->RemoveAurasDueToSpell(LFG_SPELL_DUNGEON_COOLDOWN);
                     AddToQueue(pPlayer->GetObjectGuid(), LFGType(pProposal->GetDungeon()->type), true);
+                    AddToSearchMatrix(pPlayer->GetObjectGuid(), true);
                     GetLFGPlayerState(pPlayer->GetObjectGuid())->SetState(LFG_STATE_QUEUED);
                     pPlayer->GetSession()->SendLfgJoinResult(ERR_LFG_OK, LFG_ROLECHECK_NONE);
                     pPlayer->GetSession()->SendLfgUpdatePlayer(LFG_UPDATETYPE_JOIN_PROPOSAL, LFGType(pProposal->GetDungeon()->type));
@@ -2143,7 +2171,11 @@ bool LFGMgr::RoleChanged(Player* pPlayer, LFGRoleMask roles)
         pPlayer->GetSession()->SendLfgRoleChosen(pPlayer->GetObjectGuid(), roles);
 
     if (oldRoles != GetLFGPlayerState(pPlayer->GetObjectGuid())->GetRoles())
+    {
+        if (LFGQueueInfo* pqInfo = GetQueueInfo(pPlayer->GetObjectGuid()))
+            m_queueChanged[pqInfo->GetDungeonType()] = true;
         return true;
+    }
 
     return false;
 }
@@ -2350,11 +2382,11 @@ void LFGMgr::SetGroupRoles(Group* pGroup, GuidSet* players)
     SetRoles(rolesMap);
 }
 
-void LFGMgr::TryCompleteGroups(LFGType type)
+bool LFGMgr::TryCompleteGroups(LFGType type)
 {
 
     if (m_groupQueue[type].empty())
-        return;
+        return false;
 
     bool isGroupCompleted = false;  // we make only one group for iterations! not more!
 
@@ -2378,9 +2410,22 @@ void LFGMgr::TryCompleteGroups(LFGType type)
         }
         GuidSet applicants;
 
-        for (LFGQueue::iterator itr2 = m_playerQueue[type].begin(); itr2 != m_playerQueue[type].end(); ++itr2)
+        // only players searching for one of the dungeons of the group can join it
+        GuidSet candidates;
+        LFGDungeonSet const* groupDungeons = GetLFGGroupState(pGroup->GetObjectGuid())->GetDungeons();
+        for (LFGDungeonSet::const_iterator dungeonItr = groupDungeons->begin(); dungeonItr != groupDungeons->end(); ++dungeonItr)
+        {
+            if (GuidSet const* players = GetPlayersForDungeon(*dungeonItr))
+                candidates.insert(players->begin(), players->end());
+        }
+
+        for (GuidSet::const_iterator itr2 = candidates.begin(); itr2 != candidates.end(); ++itr2)
         {
-            Player* pPlayer = sObjectMgr.GetPlayer((*itr2)->guid);
+            LFGQueueInfo* pqInfo = GetQueueInfo(*itr2);
+            if (!pqInfo || pqInfo->GetDungeonType() != type)
+                continue;
+
+            Player* pPlayer = sObjectMgr.GetPlayer(*itr2);
             if (!pPlayer)
                 continue;
 
@@ -2397,7 +2442,7 @@ void LFGMgr::TryCompleteGroups(LFGType type)
             case LFG_TYPE_HEROIC_DUNGEON:
             case LFG_TYPE_RANDOM_DUNGEON:
             {
-                applicants.insert((*itr2)->guid);
+                applicants.insert(*itr2);
                 if (TryAddMembersToGroup(pGroup, &applicants))
                 {
                     if (IsGroupCompleted(pGroup, applicants.size()))
@@ -2407,7 +2452,7 @@ void LFGMgr::TryCompleteGroups(LFGType type)
                     }
                 }
                 else
-                    applicants.erase((*itr2)->guid);
+                    applicants.erase(*itr2);
 
                 break;
             }
@@ -2422,6 +2467,7 @@ void LFGMgr::TryCompleteGroups(LFGType type)
             break;
         applicants.clear();
     }
+    return isGroupCompleted;
 }
 
 bool LFGMgr::TryAddMembersToGroup(Group* pGroup, GuidSet* players)
@@ -2764,6 +2810,9 @@ void LFGMgr::AddToSearchMatrix(ObjectGuid guid, bool inBegin)
         if (!dungeon)
             continue;
 
+        if (dungeon->type < LFG_TYPE_MAX)
+            m_queueChanged[dungeon->type] = true;
+
         GuidSet* players = GetPlayersForDungeon(dungeon);
         if (!players || players->empty())
         {
@@ -153,7 +153,7 @@ public:
     // Update system
     void Update(uint32 diff);
 
-    void TryCompleteGroups(LFGType type);
+    bool TryCompleteGroups(LFGType type);
     bool TryAddMembersToGroup(Group* pGroup, GuidSet* players);
     void CompleteGroup(Group* pGroup, GuidSet* players);
     bool TryCreateGroup(LFGType type);
@@ -291,6 +291,7 @@ private:
     LFGSearchMap    m_searchMatrix;                     // Search matrix
     LFGEventList    m_eventList;                        // events storage
     LFGStatesMap    m_statesMap;                        // LFG states storage (for players or groups)
+    bool            m_queueChanged[LFG_TYPE_MAX];       // joins, leaves or role changes since the last matching
 
     IntervalTimer   m_LFGupdateTimer;                   // update timer for cleanup/statistic
     IntervalTimer   m_LFRupdateTimer;                   // update timer for LFR extend system
@@ -18,6 +18,7 @@
 
 #include "Loot/LootMgr.h"
 #include "Log.h"
+#include "Chat/Chat.h"
 #include "Globals/ObjectMgr.h"
 #include "ProgressBar.h"
 #include "World/World.h"
@@ -27,9 +28,13 @@
 #include "Server/DBCStores.h"
 #include "Server/SQLStorages.h"
 #include "Entities/ItemEnchantmentMgr.h"
+#include "Database/DatabaseEnv.h"
+#include "Timer.h"
 #include "Tools/Language.h"
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <future>
 
 INSTANTIATE_SINGLETON_1(LootMgr);
 
@@ -74,9 +79,21 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // Running sum of the ExplicitlyChanced chances, rolled by binary search while no condition can skip an entry
+        std::vector<float> CumulativeChances;
+        bool ExplicitlyChancedConditions = false;
+        bool EqualChancedConditions = false;
+
         LootStoreItem const* Roll(Loot const& loot, Player const* lootOwner) const; // Rolls an item from the group, returns NULL if all miss their chances
 };
 
+LootStore::~LootStore()
+{
+    if (m_reload.valid())
+        delete m_reload.get();
+    Clear();
+}
+
 // Remove all data and free all memory
 void LootStore::Clear()
 {
@@ -97,14 +114,31 @@ void LootStore::Verify() const
 // All checks of the loaded template are called from here, no error reports at loot generation required
 void LootStore::LoadLootTable()
 {
-    LootTemplateMap::const_iterator tab;
     uint32 count = 0;
 
     // Clearing store (for reloading case)
     Clear();
 
-    //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    ReadLootTable(m_LootTemplates, count);
+    if (!count)
+    {
+        sLog.outString();
+        sLog.outErrorDb(">> Loaded 0 loot definitions. DB table `%s` is empty.", GetName());
+        return;
+    }
+
+    ResolveReferences();
+
+    sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
+    sLog.outString();
+}
+
+void LootStore::ReadLootTable(LootTemplateMap& templates, uint32& count) const
+{
+    LootTemplateMap::const_iterator tab;
+
+    //                                                         0      1     2                    3        4              5         6
+    QueryResult* result = WorldDatabase.PQueryStreamed("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
 
     if (result)
     {
@@ -152,13 +186,13 @@ void LootStore::LoadLootTable()
 
             // Looking for the template of the entry
             // often entries are put together
-            if (m_LootTemplates.empty() || tab->first != entry)
+            if (templates.empty() || tab->first != entry)
             {
                 // Searching the template (in case template Id changed)
-                tab = m_LootTemplates.find(entry);
-                if (tab == m_LootTemplates.end())
+                tab = templates.find(entry);
+                if (tab == templates.end())
                 {
-                    std::pair< LootTemplateMap::iterator, bool > pr = m_LootTemplates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
+                    std::pair< LootTemplateMap::iterator, bool > pr = templates.insert(LootTemplateMap::value_type(entry, new LootTemplate));
                     tab = pr.first;
                 }
             }
@@ -173,16 +207,49 @@ void LootStore::LoadLootTable()
 
         delete result;
 
-        Verify();                                           // Checks validity of the loot store
-
-        sLog.outString(">> Loaded %u loot definitions (" SIZEFMTD " templates) from table %s", count, m_LootTemplates.size(), GetName());
-        sLog.outString();
+        // Checks validity of the loot store
+        for (auto const& lootTemplate : templates)
+            lootTemplate.second->Verify(*this, lootTemplate.first);
     }
-    else
+}
+
+bool LootStore::StartReload(void (*checker)())
+{
+    if (m_reload.valid())
+        return false;
+
+    m_reloadChecker = checker;
+    m_reload = std::async(std::launch::async, [this]()
     {
-        sLog.outString();
-        sLog.outErrorDb(">> Loaded 0 loot definitions. DB table `%s` is empty.", GetName());
-    }
+        WorldDatabase.ThreadStart();
+        LootTemplateMap* templates = new LootTemplateMap;
+        uint32 count = 0;
+        ReadLootTable(*templates, count);
+        WorldDatabase.ThreadEnd();
+        return templates;
+    });
+    return true;
+}
+
+bool LootStore::PublishReload()
+{
+    if (!m_reload.valid() || m_reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    // no thread runs that could roll the old templates, and none keeps one past its roll
+    LootTemplateMap* templates = m_reload.get();
+    Clear();
+    m_LootTemplates.swap(*templates);
+    delete templates;
+
+    ResolveReferences();
+
+    m_reloadPublished = true;
+    m_reloadChecker();
+    m_reloadPublished = false;
+
+    sLog.outString(">> Reloaded " SIZEFMTD " loot templates from table %s", m_LootTemplates.size(), GetName());
+    return true;
 }
 
 bool LootStore::HaveQuestLootFor(uint32 loot_id) const
@@ -217,12 +284,19 @@ LootTemplate const* LootStore::GetLootFor(uint32 loot_id) const
 
 void LootStore::LoadAndCollectLootIds(LootIdSet& ids_set)
 {
-    LoadLootTable();
+    if (!m_reloadPublished)
+        LoadLootTable();
 
     for (LootTemplateMap::const_iterator tab = m_LootTemplates.begin(); tab != m_LootTemplates.end(); ++tab)
         ids_set.insert(tab->first);
 }
 
+void LootStore::ResolveReferences()
+{
+    for (const auto& m_LootTemplate : m_LootTemplates)
+        m_LootTemplate.second->ResolveReferences();
+}
+
 void LootStore::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (const auto& m_LootTemplate : m_LootTemplates)
@@ -561,7 +635,7 @@ void GroupLootRoll::SendStartRoll()
     size_t voteMaskPos = data.wpos();
     data << uint8(0);                                       // roll type mask, allowed choices (placeholder)
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -580,17 +654,11 @@ void GroupLootRoll::SendStartRoll()
     }
 }
 
-// Send all passed message
-void GroupLootRoll::SendAllPassed()
+// Sessions of the players taking part in the roll, resolved once for all packets of a broadcast
+void GroupLootRoll::GetVoterSessions(std::vector<WorldSession*>& sessions) const
 {
-    WorldPacket data(SMSG_LOOT_ALL_PASSED, (8 + 4 + 4 + 4 + 4));
-    data << m_loot->GetLootGuid();                          // creature guid what we're looting
-    data << uint32(m_itemSlot);                             // item slot in loot
-    data << uint32(m_lootItem->itemId);                     // the itemEntryId for the item that shall be rolled for
-    data << uint32(m_lootItem->randomSuffix);               // randomSuffix
-    data << uint32(m_lootItem->randomPropertyId);           // item random property ID
-
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    sessions.clear();
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         if (itr->second.vote == ROLL_NOT_VALID)
             continue;
@@ -599,58 +667,73 @@ void GroupLootRoll::SendAllPassed()
         if (!plr || !plr->GetSession())
             continue;
 
-        plr->GetSession()->SendPacket(data);
+        sessions.push_back(plr->GetSession());
     }
 }
 
-// Send roll 'value' of the whole group and the winner to the whole group
-void GroupLootRoll::SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNumber, RollVote rollType)
+// Send all passed message
+void GroupLootRoll::SendAllPassed()
 {
-    WorldPacket data(SMSG_LOOT_ROLL_WON, (8 + 4 + 4 + 4 + 4 + 8 + 1 + 1));
+    WorldPacket data(SMSG_LOOT_ALL_PASSED, (8 + 4 + 4 + 4 + 4));
     data << m_loot->GetLootGuid();                          // creature guid what we're looting
     data << uint32(m_itemSlot);                             // item slot in loot
     data << uint32(m_lootItem->itemId);                     // the itemEntryId for the item that shall be rolled for
     data << uint32(m_lootItem->randomSuffix);               // randomSuffix
     data << uint32(m_lootItem->randomPropertyId);           // item random property ID
-    data << targetGuid;                                     // guid of the player who won.
-    data << uint8(rollNumber);                              // rollnumber related to SMSG_LOOT_ROLL
-    data << uint8(rollType);                                // Rolltype related to SMSG_LOOT_ROLL
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    std::vector<WorldSession*> sessions;
+    GetVoterSessions(sessions);
+    for (WorldSession* session : sessions)
+        session->SendPacket(data);
+}
+
+// Send roll 'value' of the whole group and the winner to the whole group
+void GroupLootRoll::SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNumber, RollVote rollType)
+{
+    std::vector<WorldSession*> sessions;
+    GetVoterSessions(sessions);
+
+    WorldPacket data(SMSG_LOOT_ROLL, (8 + 4 + 8 + 4 + 4 + 4 + 1 + 1 + 1));
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         switch (itr->second.vote)
         {
             case ROLL_PASS:
-                break;
+                continue;
             case ROLL_NOT_EMITED_YET:
             case ROLL_NOT_VALID:
-                SendRoll(itr->first, 128, 128);
+                BuildRoll(data, itr->first, 128, 128);
                 break;
             case ROLL_GREED:
                 if (rollType == ROLL_NEED)
-                    break;
+                    continue;
             default:
-                SendRoll(itr->first, itr->second.number, itr->second.vote);
+                BuildRoll(data, itr->first, itr->second.number, itr->second.vote);
                 break;
         }
+
+        for (WorldSession* session : sessions)
+            session->SendPacket(data);
     }
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
-    {
-        if (itr->second.vote == ROLL_NOT_VALID)
-            continue;
+    data.Initialize(SMSG_LOOT_ROLL_WON, (8 + 4 + 4 + 4 + 4 + 8 + 1 + 1));
+    data << m_loot->GetLootGuid();                          // creature guid what we're looting
+    data << uint32(m_itemSlot);                             // item slot in loot
+    data << uint32(m_lootItem->itemId);                     // the itemEntryId for the item that shall be rolled for
+    data << uint32(m_lootItem->randomSuffix);               // randomSuffix
+    data << uint32(m_lootItem->randomPropertyId);           // item random property ID
+    data << targetGuid;                                     // guid of the player who won.
+    data << uint8(rollNumber);                              // rollnumber related to SMSG_LOOT_ROLL
+    data << uint8(rollType);                                // Rolltype related to SMSG_LOOT_ROLL
 
-        Player* plr = sObjectMgr.GetPlayer(itr->first);
-        if (!plr || !plr->GetSession())
-            continue;
-        plr->GetSession()->SendPacket(data);
-    }
+    for (WorldSession* session : sessions)
+        session->SendPacket(data);
 }
 
-// Send roll of targetGuid to the whole group (included targuetGuid)
-void GroupLootRoll::SendRoll(ObjectGuid const& targetGuid, uint32 rollNumber, uint32 rollType)
+// Build the roll of targetGuid, sent to the whole group (included targetGuid)
+void GroupLootRoll::BuildRoll(WorldPacket& data, ObjectGuid const& targetGuid, uint32 rollNumber, uint32 rollType) const
 {
-    WorldPacket data(SMSG_LOOT_ROLL, (8 + 4 + 8 + 4 + 4 + 4 + 1 + 1 + 1));
+    data.Initialize(SMSG_LOOT_ROLL, (8 + 4 + 8 + 4 + 4 + 4 + 1 + 1 + 1));
     data << m_loot->GetLootGuid();                          // creature guid what we're looting
     data << uint32(m_itemSlot);                             // item slot in loot
     data << targetGuid;
@@ -660,28 +743,33 @@ void GroupLootRoll::SendRoll(ObjectGuid const& targetGuid, uint32 rollNumber, ui
     data << uint8(rollNumber);                              // 0: "Need for: [item name]" > 127: "you passed on: [item name]"      Roll number
     data << uint8(rollType);                                // 0: "Need for: [item name]" 0: "You have selected need for [item name] 1: need roll 2: greed roll
     data << uint8(0);                                       // auto pass on loot
+}
 
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+// Send the votes received since the last loot update
+void GroupLootRoll::SendPendingRolls(std::vector<WorldSession*> const& sessions)
+{
+    WorldPacket data(SMSG_LOOT_ROLL, (8 + 4 + 8 + 4 + 4 + 4 + 1 + 1 + 1));
+    for (PendingRoll const& roll : m_pendingRolls)
     {
-        if (itr->second.vote == ROLL_NOT_VALID)
-            continue;
-
-        Player* plr = sObjectMgr.GetPlayer(itr->first);
-        if (!plr || !plr->GetSession())
-            continue;
-
-        plr->GetSession()->SendPacket(data);
+        BuildRoll(data, roll.playerGuid, roll.rollNumber, roll.rollType);
+        for (WorldSession* session : sessions)
+            session->SendPacket(data);
     }
+    m_pendingRolls.clear();
 }
 
-GroupLootRoll::~GroupLootRoll()
+void GroupLootRoll::Abort()
 {
-    if (m_isStarted)
-        SendAllPassed();
+    if (!m_isStarted)
+        return;
+
+    SendAllPassed();
+    m_pendingRolls.clear();
+    m_isStarted = false;
 }
 
 // Try to start the group roll for the specified item (it may fail for quest item or any condition
-// If this method return false the roll have to be removed from the container to avoid any problem
+// If this method return false the roll stays unused in the pool of the loot
 bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
 {
     if (!m_isStarted)
@@ -698,17 +786,20 @@ bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
         m_loot = &loot;
         m_itemSlot = itemSlot;
         m_lootItem->isBlocked = true;                           // block the item while rolling
+        m_rollVotes.clear();
+        m_pendingRolls.clear();
 
         uint32 playerCount = 0;
         for (auto itr : m_loot->m_ownerSet)
         {
+            m_rollVotes.emplace_back(itr, PlayerRollVote());
             Player* plr = sObjectMgr.GetPlayer(itr);
             if (!plr || !m_lootItem->IsAllowed(plr, m_loot))    // check if player meet the condition to be able to roll this item
             {
-                m_rollVoteMap[itr].vote = ROLL_NOT_VALID;
+                m_rollVotes.back().second.vote = ROLL_NOT_VALID;
                 continue;
             }
-            m_rollVoteMap[itr].vote = ROLL_NOT_EMITED_YET;      // initialize player vote map
+            m_rollVotes.back().second.vote = ROLL_NOT_EMITED_YET; // initialize player vote map
             ++playerCount;
         }
 
@@ -734,12 +825,14 @@ bool GroupLootRoll::TryToStart(Loot& loot, uint32 itemSlot)
     return false;
 }
 
-// Add vote from playerGuid
+// Add vote from playerGuid, sent to the group with the other votes at the next loot update
 bool GroupLootRoll::PlayerVote(Player* player, RollVote vote)
 {
     ObjectGuid const& playerGuid = player->GetObjectGuid();
-    RollVoteMap::iterator voterItr = m_rollVoteMap.find(playerGuid);
-    if (voterItr == m_rollVoteMap.end())
+    RollVoteList::iterator voterItr = m_rollVotes.begin();
+    while (voterItr != m_rollVotes.end() && voterItr->first != playerGuid)
+        ++voterItr;
+    if (voterItr == m_rollVotes.end())
         return false;
 
     voterItr->second.vote = vote;
@@ -747,43 +840,58 @@ bool GroupLootRoll::PlayerVote(Player* player, RollVote vote)
     if (vote != ROLL_PASS && vote != ROLL_NOT_VALID)
         voterItr->second.number = urand(1, 100);
 
+    PendingRoll pending;
+    pending.playerGuid = playerGuid;
     switch (vote)
     {
         case ROLL_PASS:                                     // Player choose pass
         {
-            SendRoll(playerGuid, 128, 128);
+            pending.rollNumber = 128;
+            pending.rollType = 128;
             break;
         }
         case ROLL_NEED:                                     // player choose Need
         {
-            SendRoll(playerGuid, 0, 0);
+            pending.rollNumber = 0;
+            pending.rollType = 0;
             player->GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_ROLL_NEED, 1);
             break;
         }
         case ROLL_GREED:                                    // player choose Greed
         {
-            SendRoll(playerGuid, 128, 2);
+            pending.rollNumber = 128;
+            pending.rollType = 2;
             player->GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_ROLL_GREED, 1);
             break;
         }
         case ROLL_DISENCHANT:                               // player choose Disenchant
         {
-            SendRoll(playerGuid, 128, 3);
+            pending.rollNumber = 128;
+            pending.rollType = 3;
             player->GetAchievementMgr().UpdateAchievementCriteria(ACHIEVEMENT_CRITERIA_TYPE_ROLL_GREED, 1);
             break;
         }
         default:                                            // Roll removed case
             return false;
     }
+    m_pendingRolls.push_back(pending);
+    m_loot->m_nextRollCheck = 0;                            // the vote may end the roll
     return true;
 }
 
-// check if we can found a winner for this roll or if timer is expired
-bool GroupLootRoll::UpdateRoll()
+// send the pending votes and check if we can found a winner for this roll or if timer is expired
+bool GroupLootRoll::UpdateRoll(time_t now)
 {
-    RollVoteMap::const_iterator winnerItr = m_rollVoteMap.end();
+    if (!m_pendingRolls.empty())
+    {
+        std::vector<WorldSession*> sessions;
+        GetVoterSessions(sessions);
+        SendPendingRolls(sessions);
+    }
+
+    RollVoteList::const_iterator winnerItr = m_rollVotes.end();
 
-    if (AllPlayerVoted(winnerItr) || m_endTime <= time(nullptr))
+    if (AllPlayerVoted(winnerItr) || m_endTime <= now)
     {
         Finish(winnerItr);
         return true;
@@ -793,21 +901,21 @@ bool GroupLootRoll::UpdateRoll()
 
 /**
 * \brief: Check if all player have voted and return true in that case. Also return current winner.
-* \param: RollVoteMap::const_iterator& winnerItr > will be different than m_rollCoteMap.end() if winner exist. (Someone voted greed or need)
+* \param: RollVoteList::const_iterator& winnerItr > will be different than m_rollVotes.end() if winner exist. (Someone voted greed or need)
 * \returns: bool > true if all players voted
 **/
-bool GroupLootRoll::AllPlayerVoted(RollVoteMap::const_iterator& winnerItr)
+bool GroupLootRoll::AllPlayerVoted(RollVoteList::const_iterator& winnerItr)
 {
     uint32 notVoted = 0;
     bool isSomeoneNeed = false;
 
-    winnerItr = m_rollVoteMap.end();
-    for (RollVoteMap::const_iterator itr = m_rollVoteMap.begin(); itr != m_rollVoteMap.end(); ++itr)
+    winnerItr = m_rollVotes.end();
+    for (RollVoteList::const_iterator itr = m_rollVotes.begin(); itr != m_rollVotes.end(); ++itr)
     {
         switch (itr->second.vote)
         {
             case ROLL_NEED:
-                if (!isSomeoneNeed || winnerItr == m_rollVoteMap.end() || itr->second.number > winnerItr->second.number)
+                if (!isSomeoneNeed || winnerItr == m_rollVotes.end() || itr->second.number > winnerItr->second.number)
                 {
                     isSomeoneNeed = true;                                               // first passage will force to set winner because need is prioritized
                     winnerItr = itr;
@@ -817,7 +925,7 @@ bool GroupLootRoll::AllPlayerVoted(RollVoteMap::const_iterator& winnerItr)
             case ROLL_DISENCHANT:
                 if (!isSomeoneNeed)                                                      // if at least one need is detected then winner can't be a greed
                 {
-                    if (winnerItr == m_rollVoteMap.end() || itr->second.number > winnerItr->second.number)
+                    if (winnerItr == m_rollVotes.end() || itr->second.number > winnerItr->second.number)
                         winnerItr = itr;
                 }
                 break;
@@ -836,10 +944,10 @@ bool GroupLootRoll::AllPlayerVoted(RollVoteMap::const_iterator& winnerItr)
 }
 
 // terminate the roll
-void GroupLootRoll::Finish(RollVoteMap::const_iterator& winnerItr)
+void GroupLootRoll::Finish(RollVoteList::const_iterator winnerItr)
 {
     m_lootItem->isBlocked = false;
-    if (winnerItr == m_rollVoteMap.end())
+    if (winnerItr == m_rollVotes.end())
     {
         SendAllPassed();
         m_lootItem->isReleased = true;
@@ -909,10 +1017,52 @@ void GroupLootRoll::Finish(RollVoteMap::const_iterator& winnerItr)
 
 GroupLootRoll* Loot::GetRollForSlot(uint32 itemSlot)
 {
-    GroupLootRollMap::iterator rollItr = m_roll.find(itemSlot);
-    if (rollItr == m_roll.end())
-        return nullptr;
-    return &rollItr->second;
+    FillDeferredLoot();
+
+    return FindRoll(itemSlot);
+}
+
+GroupLootRoll* Loot::FindRoll(uint32 itemSlot)
+{
+    for (GroupLootRoll& roll : m_roll)
+        if (roll.IsStarted() && roll.GetItemSlot() == itemSlot)
+            return &roll;
+    return nullptr;
+}
+
+// Start the roll of an item with a free roll of the pool
+bool Loot::StartRoll(uint32 itemSlot)
+{
+    GroupLootRoll* roll = nullptr;
+    for (GroupLootRoll& pooled : m_roll)
+    {
+        if (!pooled.IsStarted())
+        {
+            roll = &pooled;
+            break;
+        }
+    }
+
+    if (!roll)
+    {
+        m_roll.emplace_back();
+        roll = &m_roll.back();
+    }
+
+    if (!roll->TryToStart(*this, itemSlot))
+        return false;
+
+    if (!m_activeRolls || roll->GetEndTime() < m_nextRollCheck)
+        m_nextRollCheck = roll->GetEndTime();
+    ++m_activeRolls;
+    return true;
+}
+
+void Loot::AbortRolls()
+{
+    for (GroupLootRoll& roll : m_roll)
+        roll.Abort();
+    m_activeRolls = 0;
 }
 
 //
@@ -1033,6 +1183,29 @@ bool Loot::FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, b
     return true;
 }
 
+// Rolls the items of a loot created with Corpse.DeferredLoot. Such a loot holds money, so it sparkles
+// and can be looted by all its owners until then whatever the items
+void Loot::FillDeferredLoot()
+{
+    if (!m_deferredLootId)
+        return;
+
+    uint32 const lootId = m_deferredLootId;
+    m_deferredLootId = 0;
+
+    Player* lootOwner = ObjectAccessor::FindPlayer(m_deferredOwnerGuid);
+    for (GuidSet::const_iterator itr = m_ownerSet.begin(); !lootOwner && itr != m_ownerSet.end(); ++itr)
+        lootOwner = ObjectAccessor::FindPlayer(*itr);
+
+    if (!lootOwner)
+        return;
+
+    // same rolls whoever opens it and whenever
+    RandomEngine generator(m_deferredSeed);
+    RandomGeneratorScope randomScope(&generator);
+    FillLoot(lootId, LootTemplates_Creature, lootOwner, false);
+}
+
 // Get loot status for a specified player
 uint32 Loot::GetLootStatusFor(Player const* player) const
 {
@@ -1493,6 +1666,8 @@ void Loot::Release(Player* player)
 // Popup windows with loot content
 void Loot::ShowContentTo(Player* plr)
 {
+    FillDeferredLoot();
+
     if (!m_isChest)
     {
         // for item loot that might be empty we should not display error but instead send empty loot window
@@ -1563,11 +1738,8 @@ void Loot::GroupCheck()
 
             uint32 itemSlot = lootItem->lootSlot;
 
-            if (m_roll.find(itemSlot) == m_roll.end() && lootItem->IsAllowed(player, this))
-            {
-                if (!m_roll[itemSlot].TryToStart(*this, itemSlot))      // Create and try to start a roll
-                    m_roll.erase(m_roll.find(itemSlot));                // Cannot start roll so we have to delete it (find will not fail as the item was just created)
-            }
+            if (!FindRoll(itemSlot) && lootItem->IsAllowed(player, this))
+                StartRoll(itemSlot);
         }
     }
 
@@ -1699,7 +1871,7 @@ void Loot::SetGroupLootRight(Player* player)
 Loot::Loot(Player* player, Creature* creature, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1726,6 +1898,21 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
             SetGroupLootRight(player);
             m_clientLootType = CLIENT_LOOT_CORPSE;
 
+            // with money in it the corpse sparkles whatever the items, they can wait until it is opened
+            if (creatureInfo->LootId && creatureInfo->MinLootGold > 0 && sWorld.getConfig(CONFIG_BOOL_CORPSE_DEFERRED_LOOT))
+            {
+                GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
+                if (m_gold)
+                {
+                    m_deferredLootId = creatureInfo->LootId;
+                    m_deferredSeed = urand();
+                    m_deferredOwnerGuid = player->GetObjectGuid();
+                    creature->SetFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE);
+                    ForceLootAnimationClientUpdate();
+                    break;
+                }
+            }
+
             if ((creatureInfo->LootId && FillLoot(creatureInfo->LootId, LootTemplates_Creature, player, false)) || creatureInfo->MaxLootGold > 0)
             {
                 GenerateMoneyLoot(creatureInfo->MinLootGold, creatureInfo->MaxLootGold);
@@ -1798,7 +1985,7 @@ Loot::Loot(Player* player, Creature* creature, LootType type) :
 Loot::Loot(Player* player, GameObject* gameObject, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1886,7 +2073,7 @@ Loot::Loot(Player* player, GameObject* gameObject, LootType type) :
 Loot::Loot(Player* player, Corpse* corpse, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1933,7 +2120,7 @@ Loot::Loot(Player* player, Corpse* corpse, LootType type) :
 Loot::Loot(Player* player, Item* item, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     // the player whose group may loot the corpse
     if (!player)
@@ -1980,7 +2167,7 @@ Loot::Loot(Player* player, Item* item, LootType type) :
 Loot::Loot(Unit* unit, Item* item) :
     m_lootTarget(nullptr), m_itemTarget(item), m_gold(0), m_maxSlot(0),
     m_lootType(LOOT_SKINNING), m_clientLootType(CLIENT_LOOT_PICKPOCKETING), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0),
-    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_haveItemOverThreshold(false), m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     m_ownerSet.insert(unit->GetObjectGuid());
     m_guidTarget = item->GetObjectGuid();
@@ -1989,7 +2176,7 @@ Loot::Loot(Unit* unit, Item* item) :
 Loot::Loot(Player* player, uint32 id, LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
     m_ownerSet.insert(player->GetObjectGuid());
     switch (type)
@@ -2019,7 +2206,7 @@ Loot::Loot(Player* player, uint32 id, LootType type) :
 Loot::Loot(LootType type) :
     m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(type),
     m_clientLootType(CLIENT_LOOT_CORPSE), m_lootMethod(NOT_GROUP_TYPE_LOOT), m_threshold(ITEM_QUALITY_UNCOMMON), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_createTime(World::GetCurrentClockTime())
+    m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0), m_createTime(World::GetCurrentClockTime()), m_deferredLootId(0), m_deferredSeed(0)
 {
 
 }
@@ -2142,6 +2329,8 @@ InventoryResult Loot::SendItem(Player* target, LootItem* lootItem, bool sendErro
 
 bool Loot::AutoStore(Player* player, bool broadcast /*= false*/, uint32 bag /*= NULL_BAG*/, uint32 slot /*= NULL_SLOT*/)
 {
+    FillDeferredLoot();
+
     bool result = true;
     for (LootItemList::const_iterator lootItemItr = m_lootItems.begin(); lootItemItr != m_lootItems.end(); ++lootItemItr)
     {
@@ -2179,13 +2368,26 @@ bool Loot::AutoStore(Player* player, bool broadcast /*= false*/, uint32 bag /*=
 void Loot::Update()
 {
     m_isChanged = false;
-    GroupLootRollMap::iterator itr = m_roll.begin();
-    while (itr != m_roll.end())
+    if (!m_activeRolls)
+        return;
+
+    // no vote since the last check and no roll ended
+    time_t now = time(nullptr);
+    if (m_nextRollCheck > now)
+        return;
+
+    // by index, a finished roll may add items and start new rolls
+    m_nextRollCheck = 0;
+    for (size_t i = 0; i < m_roll.size(); ++i)
     {
-        if (itr->second.UpdateRoll())
-            m_roll.erase(itr++);
-        else
-            ++itr;
+        GroupLootRoll& roll = m_roll[i];
+        if (!roll.IsStarted())
+            continue;
+
+        if (roll.UpdateRoll(now))
+            --m_activeRolls;
+        else if (!m_nextRollCheck || roll.GetEndTime() < m_nextRollCheck)
+            m_nextRollCheck = roll.GetEndTime();
     }
 }
 
@@ -2211,6 +2413,8 @@ void Loot::ForceLootAnimationClientUpdate() const
 // will return the pointer of item in loot slot provided without any right check
 LootItem* Loot::GetLootItemInSlot(uint32 itemSlot)
 {
+    FillDeferredLoot();
+
     for (auto lootItem : m_lootItems)
     {
         if (lootItem->lootSlot == itemSlot)
@@ -2222,6 +2426,8 @@ LootItem* Loot::GetLootItemInSlot(uint32 itemSlot)
 // Will return available loot item for specific player. Use only for own loot like loot in item and mail
 void Loot::GetLootItemsListFor(Player* player, LootItemList& lootList)
 {
+    FillDeferredLoot();
+
     for (LootItemList::const_iterator lootItemItr = m_lootItems.begin(); lootItemItr != m_lootItems.end(); ++lootItemItr)
     {
         LootItem* lootItem = *lootItemItr;
@@ -2235,12 +2441,14 @@ void Loot::GetLootItemsListFor(Player* player, LootItemList& lootList)
 Loot::~Loot()
 {
     SendReleaseForAll();
+    AbortRolls();                                           // before the items they refer to are deleted
     for (auto& m_lootItem : m_lootItems)
         delete m_lootItem;
 }
 
 void Loot::Clear()
 {
+    AbortRolls();
     for (auto& m_lootItem : m_lootItems)
         delete m_lootItem;
     m_lootItems.clear();
@@ -2249,7 +2457,6 @@ void Loot::Clear()
     m_ownerSet.clear();
     m_masterOwnerGuid.Clear();
     m_currentLooterGuid.Clear();
-    m_roll.clear();
     m_maxEnchantSkill = 0;
     m_haveItemOverThreshold = false;
     m_isChecked = false;
@@ -2327,8 +2534,10 @@ bool Loot::IsItemAlreadyIn(uint32 itemId) const
 }
 
 // fill in the bytebuffer with loot content for specified player (return false if no items/gold filled)
-void Loot::PrintLootList(ChatHandler& chat, WorldSession* session) const
+void Loot::PrintLootList(ChatHandler& chat, WorldSession* session)
 {
+    FillDeferredLoot();
+
     if (!session)
     {
         chat.SendSysMessage("Error you have to be in game for this command.");
@@ -2413,15 +2622,30 @@ ByteBuffer& operator<<(ByteBuffer& b, LootItem const& li)
 void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 {
     if (item.chance != 0)
+    {
         ExplicitlyChanced.push_back(item);
+        CumulativeChances.push_back((CumulativeChances.empty() ? 0.0f : CumulativeChances.back()) + item.chance);
+        ExplicitlyChancedConditions = ExplicitlyChancedConditions || item.conditionId;
+    }
     else
+    {
         EqualChanced.push_back(item);
+        EqualChancedConditions = EqualChancedConditions || item.conditionId;
+    }
 }
 
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player const* lootOwner) const
 {
-    if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
+    // Without conditions and with at most 100% in total, the shuffled walk below takes every entry with its own chance,
+    // whatever the order, which is what a roll in the running sum does
+    if (!ExplicitlyChanced.empty() && (!ExplicitlyChancedConditions || !lootOwner) && CumulativeChances.back() <= 100.0f)
+    {
+        auto itr = std::upper_bound(CumulativeChances.begin(), CumulativeChances.end(), rand_chance_f());
+        if (itr != CumulativeChances.end())
+            return &ExplicitlyChanced[itr - CumulativeChances.begin()];
+    }
+    else if (!ExplicitlyChanced.empty())                    // First explicitly chanced entries are checked
     {
         std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
 
@@ -2454,7 +2678,27 @@ LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player cons
         }
     }
 
-    if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
+    if (EqualChanced.empty())
+        return nullptr;
+
+    // Same as the first entry of the shuffle below when none can be passed
+    if (!EqualChancedConditions || !lootOwner)
+    {
+        bool alreadyIn = false;
+        for (auto const& itr : EqualChanced)
+        {
+            if (loot.IsItemAlreadyIn(itr.itemid))
+            {
+                alreadyIn = true;
+                break;
+            }
+        }
+
+        if (!alreadyIn)
+            return &EqualChanced[urand(0, EqualChanced.size() - 1)];
+    }
+
+    // If nothing selected yet - an item is taken from equal-chanced part
     {
         std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
 
@@ -2593,6 +2837,8 @@ void LootTemplate::LootGroup::CheckLootRefs(LootIdSet* ref_set) const
 // Adds an entry to the group (at loading stage)
 void LootTemplate::AddEntry(LootStoreItem& item)
 {
+    References.clear();                                     // resolved again once the store is loaded
+
     if (item.group > 0 && item.mincountOrRef > 0)           // Group
     {
         if (item.group >= Groups.size())
@@ -2616,8 +2862,10 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
     }
 
     // Rolling non-grouped items
-    for (auto Entrie : Entries)
+    for (size_t i = 0; i < Entries.size(); ++i)
     {
+        LootStoreItem const& Entrie = Entries[i];
+
         // Check condition
         if (Entrie.conditionId && lootOwner && !PlayerOrGroupFulfilsCondition(loot, lootOwner, Entrie.conditionId))
             continue;
@@ -2627,7 +2875,7 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
 
         if (Entrie.mincountOrRef < 0)                           // References processing
         {
-            LootTemplate const* Referenced = LootTemplates_Reference.GetLootFor(-Entrie.mincountOrRef);
+            LootTemplate const* Referenced = i < References.size() ? References[i] : LootTemplates_Reference.GetLootFor(-Entrie.mincountOrRef);
 
             if (!Referenced)
                 continue;                                   // Error message already printed at loading stage
@@ -2735,6 +2983,14 @@ void LootTemplate::Verify(LootStore const& lootstore, uint32 id) const
     // TODO: References validity checks
 }
 
+void LootTemplate::ResolveReferences()
+{
+    References.assign(Entries.size(), nullptr);
+    for (size_t i = 0; i < Entries.size(); ++i)
+        if (Entries[i].mincountOrRef < 0)
+            References[i] = LootTemplates_Reference.GetLootFor(-Entries[i].mincountOrRef);
+}
+
 void LootTemplate::CheckLootRefs(LootIdSet* ref_set) const
 {
     for (auto Entrie : Entries)
@@ -3044,10 +3300,104 @@ void LoadLootTemplates_Reference()
     LootTemplates_Reference.CheckLootRefs(&ids_set);
     LootTemplates_Spell.CheckLootRefs(&ids_set);
 
+    // the referenced templates were replaced, pointers kept by every store are renewed
+    LootTemplates_Creature.ResolveReferences();
+    LootTemplates_Fishing.ResolveReferences();
+    LootTemplates_Gameobject.ResolveReferences();
+    LootTemplates_Item.ResolveReferences();
+    LootTemplates_Milling.ResolveReferences();
+    LootTemplates_Pickpocketing.ResolveReferences();
+    LootTemplates_Skinning.ResolveReferences();
+    LootTemplates_Disenchant.ResolveReferences();
+    LootTemplates_Prospecting.ResolveReferences();
+    LootTemplates_Mail.ResolveReferences();
+    LootTemplates_Reference.ResolveReferences();
+    LootTemplates_Spell.ResolveReferences();
+
     // output error for any still listed ids (not referenced from any loot table)
     LootTemplates_Reference.ReportUnusedIds(ids_set);
 }
 
+void LoadLootTables()
+{
+    typedef void (*LootLoader)();
+    static std::pair<char const*, LootLoader> const loaders[] =
+    {
+        { "creature",      &LoadLootTemplates_Creature      },
+        { "fishing",       &LoadLootTemplates_Fishing       },
+        { "gameobject",    &LoadLootTemplates_Gameobject    },
+        { "item",          &LoadLootTemplates_Item          },
+        { "mail",          &LoadLootTemplates_Mail          },
+        { "milling",       &LoadLootTemplates_Milling       },
+        { "pickpocketing", &LoadLootTemplates_Pickpocketing },
+        { "skinning",      &LoadLootTemplates_Skinning      },
+        { "disenchant",    &LoadLootTemplates_Disenchant    },
+        { "prospecting",   &LoadLootTemplates_Prospecting   },
+        { "spell",         &LoadLootTemplates_Spell         },
+    };
+
+    // every store only reads already loaded item/creature/condition data and fills its own container,
+    // so they can be loaded side by side; reference checks need all of them and are done afterwards
+    uint32 startTime = WorldTimer::getMSTime();
+    bool showBars = BarGoLink::GetOutputState();
+    BarGoLink::SetOutputState(false);                       // concurrent bars would mix up on console
+
+    std::vector<std::future<uint32>> futures;
+    for (auto const& loader : loaders)
+    {
+        futures.push_back(std::async(std::launch::async, [](LootLoader load)
+        {
+            WorldDatabase.ThreadStart();
+            uint32 loadStart = WorldTimer::getMSTime();
+            load();
+            WorldDatabase.ThreadEnd();
+            return WorldTimer::getMSTimeDiff(loadStart, WorldTimer::getMSTime());
+        }, loader.second));
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i)
+        sLog.outDetail("Loot templates (%s) loaded in %u ms", loaders[i].first, futures[i].get());
+
+    BarGoLink::SetOutputState(showBars);
+
+    LoadLootTemplates_Reference();
+
+    sLog.outString(">> Loot tables loaded in %u ms", WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
+static LootStore* const allLootStores[] =
+{
+    &LootTemplates_Creature, &LootTemplates_Disenchant, &LootTemplates_Fishing, &LootTemplates_Gameobject,
+    &LootTemplates_Item, &LootTemplates_Mail, &LootTemplates_Milling, &LootTemplates_Pickpocketing,
+    &LootTemplates_Prospecting, &LootTemplates_Reference, &LootTemplates_Skinning, &LootTemplates_Spell,
+};
+
+void PublishLootReloads()
+{
+    for (LootStore* store : allLootStores)
+    {
+        if (!store->PublishReload())
+            continue;
+
+        // the reference store checks the references of all stores itself
+        if (store != &LootTemplates_Reference)
+            store->CheckLootRefs();
+
+        std::string message = "DB table `" + std::string(store->GetName()) + "` reloaded.";
+        WorldPacket data;
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, message.c_str());
+        sWorld.SendGlobalMessage(data);
+    }
+}
+
+bool IsLootReloadRunning()
+{
+    for (LootStore const* store : allLootStores)
+        if (store->IsReloading())
+            return true;
+    return false;
+}
+
 // Vote for an ongoing roll
 void LootMgr::PlayerVote(Player* player, ObjectGuid const& lootTargetGuid, uint32 itemSlot, RollVote vote)
 {
@@ -23,6 +23,8 @@
 #include "Entities/ObjectGuid.h"
 #include "Globals/SharedDefines.h"
 
+#include <deque>
+#include <future>
 #include <vector>
 #include "Entities/Bag.h"
 
@@ -35,6 +37,7 @@ class WorldObject;
 class LootTemplate;
 class Loot;
 class WorldSession;
+class WorldPacket;
 struct LootItem;
 struct ItemPrototype;
 
@@ -134,24 +137,37 @@ struct PlayerRollVote
 class GroupLootRoll
 {
     public:
-        typedef std::unordered_map<ObjectGuid, PlayerRollVote> RollVoteMap;
+        typedef std::vector<std::pair<ObjectGuid, PlayerRollVote> > RollVoteList;
 
-        GroupLootRoll() : m_rollVoteMap(ROLL_VOTE_MASK_ALL), m_isStarted(false), m_lootItem(nullptr), m_loot(nullptr), m_itemSlot(0), m_voteMask(), m_endTime(0)
+        GroupLootRoll() : m_isStarted(false), m_lootItem(nullptr), m_loot(nullptr), m_itemSlot(0), m_voteMask(), m_endTime(0)
         {}
-        ~GroupLootRoll();
 
         bool TryToStart(Loot& loot, uint32 itemSlot);
         bool PlayerVote(Player* player, RollVote vote);
-        bool UpdateRoll();
+        bool UpdateRoll(time_t now);
+        void Abort();                                       // the item is gone, everyone passed
+        bool IsStarted() const { return m_isStarted; }
+        uint32 GetItemSlot() const { return m_itemSlot; }
+        time_t GetEndTime() const { return m_endTime; }
 
     private:
+        struct PendingRoll
+        {
+            ObjectGuid playerGuid;
+            uint8 rollNumber;
+            uint8 rollType;
+        };
+
         void SendStartRoll();
         void SendAllPassed();
-        void SendRoll(ObjectGuid const& targetGuid, uint32 rollNumber, uint32 rollType);
+        void SendPendingRolls(std::vector<WorldSession*> const& sessions);
         void SendLootRollWon(ObjectGuid const& targetGuid, uint32 rollNumber, RollVote rollType);
-        void Finish(RollVoteMap::const_iterator& winnerItr);
-        bool AllPlayerVoted(RollVoteMap::const_iterator& winnerItr);
-        RollVoteMap           m_rollVoteMap;
+        void BuildRoll(WorldPacket& data, ObjectGuid const& targetGuid, uint32 rollNumber, uint32 rollType) const;
+        void GetVoterSessions(std::vector<WorldSession*>& sessions) const;
+        void Finish(RollVoteList::const_iterator winnerItr);
+        bool AllPlayerVoted(RollVoteList::const_iterator& winnerItr);
+        RollVoteList          m_rollVotes;                  // few players, searched linearly; kept allocated when the roll is reused
+        std::vector<PendingRoll> m_pendingRolls;            // votes not sent yet, sent together at the next loot update
         bool                  m_isStarted;
         LootItem*             m_lootItem;
         Loot*                 m_loot;
@@ -159,7 +175,8 @@ class GroupLootRoll
         RollVoteMask          m_voteMask;
         time_t                m_endTime;
 };
-typedef std::unordered_map<uint32, GroupLootRoll> GroupLootRollMap;
+// pooled rolls of a loot, the finished ones are reused by the next item; a deque never moves the rolls
+typedef std::deque<GroupLootRoll> GroupLootRollPool;
 
 struct LootStoreItem
 {
@@ -224,13 +241,14 @@ class LootStore
 {
     public:
         explicit LootStore(char const* name, char const* entryName, bool ratesAllowed)
-            : m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed) {}
-        virtual ~LootStore() { Clear(); }
+            : m_name(name), m_entryName(entryName), m_ratesAllowed(ratesAllowed), m_reloadChecker(nullptr), m_reloadPublished(false) {}
+        virtual ~LootStore();
 
         void Verify() const;
 
         void LoadAndCollectLootIds(LootIdSet& ids_set);
         void CheckLootRefs(LootIdSet* ref_set = nullptr) const; // check existence reference and remove it from ref_set
+        void ResolveReferences();                           // to be called again when the reference store is reloaded
         void ReportUnusedIds(LootIdSet const& ids_set) const;
         void ReportNotExistedId(uint32 id) const;
 
@@ -243,14 +261,29 @@ class LootStore
         char const* GetName() const { return m_name; }
         char const* GetEntryName() const { return m_entryName; }
         bool IsRatesAllowed() const { return m_ratesAllowed; }
+
+        // .reload: reads the table on a thread of its own into a new generation, the templates in use stay as they are
+        // meanwhile. false if the previous reload of the store is not published yet
+        bool StartReload(void (*checker)());
+        bool IsReloading() const { return m_reload.valid(); }
+        // world thread, between two ticks while no map or session thread runs: swaps in the generation read by
+        // StartReload if done and runs the checker of the reload on it, which takes it instead of reading the table
+        bool PublishReload();
     protected:
         void LoadLootTable();
         void Clear();
     private:
+        // any thread, only reads the item, condition and reference data, not the templates of the store
+        void ReadLootTable(LootTemplateMap& templates, uint32& count) const;
+
         LootTemplateMap m_LootTemplates;
         char const* m_name;
         char const* m_entryName;
         bool m_ratesAllowed;
+
+        std::future<LootTemplateMap*> m_reload;
+        void (*m_reloadChecker)();
+        bool m_reloadPublished;                             // the checker runs, LoadAndCollectLootIds keeps the templates
 };
 
 class LootTemplate
@@ -274,9 +307,12 @@ class LootTemplate
         // Checks integrity of the template
         void Verify(LootStore const& lootstore, uint32 id) const;
         void CheckLootRefs(LootIdSet* ref_set) const;
+        // Looks up the reference templates once instead of at every loot
+        void ResolveReferences();
     private:
         LootStoreItemList Entries;                          // not grouped only
         LootGroups        Groups;                           // groups have own (optimized) processing, grouped entries go there
+        std::vector<LootTemplate const*> References;        // referenced template of each entry of Entries, if resolved
 };
 
 //=====================================================
@@ -314,7 +350,7 @@ class Loot
         void SendGold(Player* player);
         void SendReleaseFor(Player* plr);
         bool IsItemAlreadyIn(uint32 itemId) const;
-        void PrintLootList(ChatHandler& chat, WorldSession* session) const;
+        void PrintLootList(ChatHandler& chat, WorldSession* session);
         bool HasLoot() const;
         uint32 GetGoldAmount() const { return m_gold; }
         LootType GetLootType() const { return m_lootType; }
@@ -331,9 +367,13 @@ class Loot
     private:
         Loot(): m_lootTarget(nullptr), m_itemTarget(nullptr), m_gold(0), m_maxSlot(0), m_lootType(),
             m_clientLootType(), m_lootMethod(), m_threshold(), m_maxEnchantSkill(0), m_haveItemOverThreshold(false),
-            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false)
+            m_isChecked(false), m_isChest(false), m_isChanged(false), m_isFakeLoot(false), m_activeRolls(0), m_nextRollCheck(0),
+            m_deferredLootId(0), m_deferredSeed(0)
         {}
         void Clear();
+        GroupLootRoll* FindRoll(uint32 itemSlot);
+        bool StartRoll(uint32 itemSlot);
+        void AbortRolls();
         bool IsLootedFor(Player const* player) const;
         bool IsLootedForAll() const;
         void SendReleaseFor(ObjectGuid const& guid);
@@ -347,6 +387,7 @@ class Loot
         void SetGroupLootRight(Player* player);
         void GenerateMoneyLoot(uint32 minAmount, uint32 maxAmount);
         bool FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, bool personal, bool noEmptyError = false);
+        void FillDeferredLoot();
         void ForceLootAnimationClientUpdate() const;
         void SetPlayerIsLooting(Player* player);
         void SetPlayerIsNotLooting(Player* player);
@@ -375,10 +416,15 @@ class Loot
         bool             m_isChest;                       // chest type object have special loot right
         bool             m_isChanged;                     // true if at least one item is looted
         bool             m_isFakeLoot;                    // nothing to loot but will sparkle for empty windows
-        GroupLootRollMap m_roll;                          // used if an item is under rolling
+        GroupLootRollPool m_roll;                         // used if an item is under rolling
+        uint32           m_activeRolls;
+        time_t           m_nextRollCheck;                 // one timer for all rolls: earliest end, or now after a vote
         GuidSet          m_playersLooting;                // player who opened loot windows
         GuidSet          m_playersOpened;                 // players that have released the corpse
         TimePoint        m_createTime;                    // create time (used to refill loot if need)
+        uint32           m_deferredLootId;                // creature loot id to be rolled when first needed, see Corpse.DeferredLoot
+        uint32           m_deferredSeed;                  // taken at death, the rolls do not depend on when the corpse is opened
+        ObjectGuid       m_deferredOwnerGuid;             // killer, used for the conditions of the rolls
 };
 
 extern LootStore LootTemplates_Creature;
@@ -392,6 +438,7 @@ extern LootStore LootTemplates_Skinning;
 extern LootStore LootTemplates_Disenchant;
 extern LootStore LootTemplates_Prospecting;
 extern LootStore LootTemplates_Spell;
+extern LootStore LootTemplates_Reference;
 
 void LoadLootTemplates_Creature();
 void LoadLootTemplates_Fishing();
@@ -407,22 +454,10 @@ void LoadLootTemplates_Prospecting();
 void LoadLootTemplates_Spell();
 void LoadLootTemplates_Reference();
 
-inline void LoadLootTables()
-{
-    LoadLootTemplates_Creature();
-    LoadLootTemplates_Fishing();
-    LoadLootTemplates_Gameobject();
-    LoadLootTemplates_Item();
-    LoadLootTemplates_Mail();
-    LoadLootTemplates_Milling();
-    LoadLootTemplates_Pickpocketing();
-    LoadLootTemplates_Skinning();
-    LoadLootTemplates_Disenchant();
-    LoadLootTemplates_Prospecting();
-    LoadLootTemplates_Spell();
-
-    LoadLootTemplates_Reference();
-}
+void LoadLootTables();
+// world thread at a tick start, swaps in the templates of the finished .reload of every store
+void PublishLootReloads();
+bool IsLootReloadRunning();
 
 class LootMgr
 {
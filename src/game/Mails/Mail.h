@@ -319,6 +319,8 @@ struct Mail
     uint32 checked;
     /// The state of this mail.
     MailState state;
+    /// false while the items of a mail loaded from DB are not loaded yet, see Player::LoadMailedItems
+    bool itemsLoaded = true;
 
     /**
      * Adds an item to the mail.
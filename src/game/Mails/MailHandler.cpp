@@ -400,6 +400,8 @@ void WorldSession::HandleMailDelete(WorldPacket& recv_data)
             return;
         }
 
+        // the items are deleted with the mail at save
+        pl->LoadMailedItems(m);
         m->state = MAIL_STATE_DELETED;
     }
     pl->SendMailResult(mailId, MAIL_DELETED, MAIL_OK);
@@ -432,6 +434,8 @@ void WorldSession::HandleMailReturnToSender(WorldPacket& recv_data)
         return;
     }
 
+    pl->LoadMailedItems(m);
+
     // we can return mail now
     // so firstly delete the old one
     CharacterDatabase.BeginTransaction();
@@ -499,6 +503,7 @@ void WorldSession::HandleMailTakeItem(WorldPacket& recv_data)
         return;
     }
 
+    pl->LoadMailedItems(m);
     Item* it = pl->GetMItem(itemId);
 
     ItemPosCountVec dest;
@@ -622,6 +627,13 @@ void WorldSession::HandleGetMailList(WorldPacket& recv_data)
     data << uint8(0);                                       // mail's count
     time_t cur_time = time(nullptr);
 
+    // only the mails the client can show need their items
+    std::vector<Mail*> shownMails;
+    for (PlayerMails::iterator itr = _player->GetMailBegin(); itr != _player->GetMailEnd() && shownMails.size() < MAX_INBOX_CLIENT_UI_CAPACITY; ++itr)
+        if ((*itr)->state != MAIL_STATE_DELETED && cur_time >= (*itr)->deliver_time)
+            shownMails.push_back(*itr);
+    _player->LoadMailedItems(shownMails);
+
     for (PlayerMails::iterator itr = _player->GetMailBegin(); itr != _player->GetMailEnd(); ++itr)
     {
         // prevent client storage overflow
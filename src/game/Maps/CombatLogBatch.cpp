@@ -0,0 +1,136 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Maps/CombatLogBatch.h"
+#include "Maps/Map.h"
+#include "Entities/Player.h"
+#include "Grids/CellImpl.h"
+#include "Grids/GridNotifiers.h"
+#include "Grids/GridNotifiersImpl.h"
+
+#include <algorithm>
+
+thread_local CombatLogBatch* CombatLogBatch::s_current = nullptr;
+
+CombatLogBatch::Scope::~Scope()
+{
+    s_current = m_previous;
+    m_batch.Flush();
+}
+
+void CombatLogBatch::Add(Unit const* source, WorldPacket const& msg)
+{
+    auto itr = m_index.find(source->GetObjectGuid());
+    if (itr == m_index.end())
+    {
+        itr = m_index.emplace(source->GetObjectGuid(), m_sources.size()).first;
+        m_sources.emplace_back();
+        m_sources.back().guid = source->GetObjectGuid();
+    }
+
+    m_sources[itr->second].packets.push_back(std::make_shared<WorldPacket const>(msg));
+}
+
+void CombatLogBatch::FlushOf(WorldObject const* source)
+{
+    auto itr = m_index.find(source->GetObjectGuid());
+    if (itr == m_index.end())
+        return;
+
+    Source& gathered = m_sources[itr->second];
+    m_index.erase(itr);
+
+    // the source keeps its empty slot until the batch is sent
+    if (Unit* unit = m_map.GetUnit(gathered.guid))
+        if (unit->IsInWorld() && unit->GetMap() == &m_map)
+            Send({ std::make_pair(unit, &gathered) });
+
+    gathered.packets.clear();
+}
+
+void CombatLogBatch::Flush()
+{
+    // sources gone from the map meanwhile were already removed at the clients
+    std::vector<std::pair<uint32, std::pair<Unit*, Source*>>> byCell;
+    for (Source& gathered : m_sources)
+    {
+        if (gathered.packets.empty())
+            continue;
+
+        Unit* unit = m_map.GetUnit(gathered.guid);
+        if (!unit || !unit->IsInWorld() || unit->GetMap() != &m_map)
+            continue;
+
+        CellPair p = MaNGOS::ComputeCellPair(unit->GetPositionX(), unit->GetPositionY());
+        if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+            continue;
+
+        byCell.emplace_back(p.x_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + p.y_coord, std::make_pair(unit, &gathered));
+    }
+
+    std::stable_sort(byCell.begin(), byCell.end(), [](auto const& left, auto const& right) { return left.first < right.first; });
+
+    std::vector<std::pair<Unit*, Source*>> cellSources;
+    for (size_t i = 0; i < byCell.size(); ++i)
+    {
+        cellSources.push_back(byCell[i].second);
+        if (i + 1 == byCell.size() || byCell[i + 1].first != byCell[i].first)
+        {
+            Send(cellSources);
+            cellSources.clear();
+        }
+    }
+
+    m_sources.clear();
+    m_index.clear();
+}
+
+void CombatLogBatch::Send(std::vector<std::pair<Unit*, Source*>> const& sources)
+{
+    // one search covering the ranges of all sources, each receiver is then checked against the range of each source
+    float minX = sources.front().first->GetPositionX(), maxX = minX;
+    float minY = sources.front().first->GetPositionY(), maxY = minY;
+    float maxRange = 0.0f;
+
+    std::vector<MaNGOS::CombatLogDeliverer::Source> delivered;
+    delivered.reserve(sources.size());
+    for (auto const& source : sources)
+    {
+        Unit* unit = source.first;
+        minX = std::min(minX, unit->GetPositionX());
+        maxX = std::max(maxX, unit->GetPositionX());
+        minY = std::min(minY, unit->GetPositionY());
+        maxY = std::max(maxY, unit->GetPositionY());
+
+        // the cell search of a single broadcast reaches up to a cell further than its range
+        float range = unit->GetVisibilityData().GetVisibilityDistance() + unit->GetObjectBoundingRadius() + SIZE_OF_GRID_CELL;
+        maxRange = std::max(maxRange, range);
+        delivered.push_back({ unit, unit->GetPhaseMask(), range * range, &source.second->packets });
+
+        // players get their own combat log even when their camera is elsewhere
+        if (unit->GetTypeId() == TYPEID_PLAYER)
+            if (WorldSession* session = static_cast<Player*>(unit)->GetSession())
+                for (auto const& packet : source.second->packets)
+                    session->SendPacket(SharedWorldPacket(packet));
+    }
+
+    float halfDiagonal = 0.5f * std::sqrt((maxX - minX) * (maxX - minX) + (maxY - minY) * (maxY - minY));
+    MaNGOS::CombatLogDeliverer notifier(delivered);
+    Cell::VisitWorldObjects((minX + maxX) * 0.5f, (minY + maxY) * 0.5f, &m_map, notifier, maxRange + halfDiagonal);
+}
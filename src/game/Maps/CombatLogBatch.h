@@ -0,0 +1,93 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_COMBATLOGBATCH_H
+#define MANGOS_COMBATLOGBATCH_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <memory>
+
+class Map;
+class Unit;
+class WorldObject;
+class WorldPacket;
+
+/**
+ * Melee combat log packets gathered while the objects of a map update. They are sent when the gathering
+ * ends, with one cell search per standing cell of their sources instead of one per packet, so a crowd
+ * fighting in a few cells costs a few searches per tick.
+ *
+ * A batch belongs to the thread filling it: the map thread during the player and object updates, or a
+ * cell thread for the cells it crawls. Any other message about a source sends its gathered packets first,
+ * so the order the clients see stays unchanged.
+ */
+class CombatLogBatch
+{
+    public:
+        class Scope;
+
+        // the batch of this thread, nullptr when the packets are sent at once
+        static CombatLogBatch* Current() { return s_current; }
+
+        static void FlushOfCurrent(WorldObject const* source)
+        {
+            if (s_current && !s_current->m_sources.empty())
+                s_current->FlushOf(source);
+        }
+
+        void Add(Unit const* source, WorldPacket const& msg);
+
+    private:
+        struct Source
+        {
+            ObjectGuid guid;
+            std::vector<std::shared_ptr<WorldPacket const>> packets;
+        };
+
+        explicit CombatLogBatch(Map& map) : m_map(map) {}
+
+        void FlushOf(WorldObject const* source);
+        void Flush();
+        void Send(std::vector<std::pair<Unit*, Source*>> const& sources);
+
+        Map& m_map;
+        std::vector<Source> m_sources;                      // in order of their first packet
+        std::unordered_map<ObjectGuid, size_t> m_index;     // of m_sources
+
+        static thread_local CombatLogBatch* s_current;
+};
+
+// gathers the combat log of this thread until destroyed, then sends it
+class CombatLogBatch::Scope
+{
+    public:
+        explicit Scope(Map& map) : m_batch(map), m_previous(s_current) { s_current = &m_batch; }
+        ~Scope();
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+    private:
+        CombatLogBatch m_batch;
+        CombatLogBatch* m_previous;
+};
+
+#endif
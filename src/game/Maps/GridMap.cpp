@@ -20,6 +20,7 @@
 #include "Grids/CellImpl.h"
 #include "GridDefines.h"
 #include "Maps/Map.h"
+#include "Maps/MapManager.h"
 #include "Server/DBCEnums.h"
 #include "Server/DBCStores.h"
 #include "Maps/GridMap.h"
@@ -29,8 +30,17 @@
 #include "Policies/Singleton.h"
 #include "Util.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
 #include <mutex>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "v1.4";
 char const* MAP_AREA_MAGIC    = "AREA";
@@ -70,6 +80,9 @@ GridMap::GridMap() : m_gridIntHeightMultiplier(0.0f)
     m_holes = nullptr;
 
     m_fullyLoaded = false;
+
+    m_mapping = nullptr;
+    m_mappingSize = 0;
 }
 
 GridMap::~GridMap()
@@ -92,6 +105,24 @@ bool GridMap::loadData(char const* filename)
         return true;
     }
 
+#ifndef _WIN32
+    if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_MEMORY_MAPPED))
+    {
+        struct stat fileStat;
+        if (fstat(fileno(in), &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fileno(in), 0);
+            if (mapping != MAP_FAILED)
+            {
+                m_mapping = mapping;
+                m_mappingSize = fileStat.st_size;
+            }
+            else
+                sLog.outError("Failed to map %s, it is copied to memory instead", filename);
+        }
+    }
+#endif
+
     if (fread(&header, sizeof(header), 1, in) != 1)
     {
         sLog.outError("Error loading GridMapFileHeader\n");
@@ -146,17 +177,52 @@ bool GridMap::loadData(char const* filename)
 
 void GridMap::unloadData()
 {
-    if (m_area_map)    { delete[] m_area_map;    m_area_map = nullptr; }
-    if (m_V9)          { delete[] m_V9;          m_V9 = nullptr; }
-    if (m_V8)          { delete[] m_V8;          m_V8 = nullptr; }
-    if (m_liquidEntry) { delete[] m_liquidEntry; m_liquidEntry = nullptr; }
-    if (m_liquidFlags) { delete[] m_liquidFlags; m_liquidFlags = nullptr; }
-    if (m_liquid_map)  { delete[] m_liquid_map;  m_liquid_map = nullptr; }
-    if (m_holes)       { delete[] m_holes;       m_holes = nullptr; }
+    unloadArray(m_area_map);
+    unloadArray(m_V9);
+    unloadArray(m_V8);
+    unloadArray(m_liquidEntry);
+    unloadArray(m_liquidFlags);
+    unloadArray(m_liquid_map);
+    unloadArray(m_holes);
+
+#ifndef _WIN32
+    if (m_mapping)
+        munmap(m_mapping, m_mappingSize);
+#endif
+    m_mapping = nullptr;
+    m_mappingSize = 0;
 
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
+// points into the mapping when the file has one and the array is aligned in it, else reads a copy
+template<typename T>
+bool GridMap::loadArray(FILE* in, T*& data, size_t count)
+{
+    if (m_mapping)
+    {
+        long offset = ftell(in);
+        if (offset >= 0 && offset % alignof(T) == 0 && size_t(offset) + count * sizeof(T) <= m_mappingSize)
+        {
+            data = reinterpret_cast<T*>(static_cast<char*>(m_mapping) + offset);
+            return fseek(in, long(count * sizeof(T)), SEEK_CUR) == 0;
+        }
+    }
+
+    data = new T[count];
+    return fread(data, sizeof(T), count, in) == count;
+}
+
+template<typename T>
+void GridMap::unloadArray(T*& data)
+{
+    char const* address = reinterpret_cast<char const*>(data);
+    char const* mapping = static_cast<char const*>(m_mapping);
+    if (!mapping || address < mapping || address >= mapping + m_mappingSize)
+        delete[] data;
+    data = nullptr;
+}
+
 bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
@@ -170,8 +236,7 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        if (fread(m_area_map, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        if (!loadArray(in, m_area_map, 16 * 16))
             return false;
     }
 
@@ -193,30 +258,21 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16[129 * 129];
-            m_uint16_V8 = new uint16[128 * 128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint16_V8, sizeof(uint16), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_uint16_V9, 129 * 129) || !loadArray(in, m_uint16_V8, 128 * 128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8[129 * 129];
-            m_uint8_V8 = new uint8[128 * 128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint8_V8, sizeof(uint8), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_uint8_V9, 129 * 129) || !loadArray(in, m_uint8_V8, 128 * 128))
                 return false;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float[129 * 129];
-            m_V8 = new float[128 * 128];
-            if (fread(m_V9, sizeof(float), 129 * 129, in) != 129 * 129 ||
-                    fread(m_V8, sizeof(float), 128 * 128, in) != 128 * 128)
+            if (!loadArray(in, m_V9, 129 * 129) || !loadArray(in, m_V8, 128 * 128))
                 return false;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -231,8 +287,7 @@ bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
 {
     if (fseek(in, offset, SEEK_SET) != 0)
         return false;
-    m_holes = new uint16[16 * 16];
-    return fread(m_holes, sizeof(uint16), 16 * 16, in) == 16 * 16;
+    return loadArray(in, m_holes, 16 * 16);
 }
 
 bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
@@ -255,19 +310,16 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        if (fread(m_liquidEntry, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        if (!loadArray(in, m_liquidEntry, 16 * 16))
             return false;
 
-        m_liquidFlags = new uint8[16 * 16];
-        if (fread(m_liquidFlags, sizeof(uint8), 16 * 16, in) != 16 * 16)
+        if (!loadArray(in, m_liquidFlags, 16 * 16))
             return false;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float[m_liquid_width * m_liquid_height];
-        if (fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in) != size_t(m_liquid_width * m_liquid_height))
+        if (!loadArray(in, m_liquid_map, m_liquid_width * m_liquid_height))
             return false;
     }
 
@@ -291,6 +343,25 @@ float GridMap::getHeightFromFlat(float /*x*/, float /*y*/) const
     return m_gridHeight;
 }
 
+template<float(GridMap::*GetHeight)(float x, float y) const>
+void GridMap::getHeightsFrom(float const* x, float const* y, float* heights, uint32 count) const
+{
+    for (uint32 i = 0; i < count; ++i)
+        heights[i] = (this->*GetHeight)(x[i], y[i]);
+}
+
+void GridMap::getHeights(float const* x, float const* y, float* heights, uint32 count) const
+{
+    if (m_gridGetHeight == &GridMap::getHeightFromFloat)
+        getHeightsFrom<&GridMap::getHeightFromFloat>(x, y, heights, count);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint16)
+        getHeightsFrom<&GridMap::getHeightFromUint16>(x, y, heights, count);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint8)
+        getHeightsFrom<&GridMap::getHeightFromUint8>(x, y, heights, count);
+    else
+        getHeightsFrom<&GridMap::getHeightFromFlat>(x, y, heights, count);
+}
+
 bool GridMap::isHole(int row, int col) const
 {
     if (!m_holes)
@@ -306,7 +377,7 @@ bool GridMap::isHole(int row, int col) const
     return (hole & holetab_h[holeCol] & holetab_v[holeRow]) != 0;
 }
 
-float GridMap::getHeightFromFloat(float x, float y) const
+MANGOS_SIMD_KERNEL float GridMap::getHeightFromFloat(float x, float y) const
 {
     if (!m_V8 || !m_V9)
         return INVALID_HEIGHT_VALUE;
@@ -391,7 +462,7 @@ float GridMap::getHeightFromFloat(float x, float y) const
     return a * x + b * y + c;
 }
 
-float GridMap::getHeightFromUint8(float x, float y) const
+MANGOS_SIMD_KERNEL float GridMap::getHeightFromUint8(float x, float y) const
 {
     if (!m_uint8_V8 || !m_uint8_V9)
         return m_gridHeight;
@@ -459,7 +530,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     return (float)((a * x) + (b * y) + c) * m_gridIntHeightMultiplier + m_gridHeight;
 }
 
-float GridMap::getHeightFromUint16(float x, float y) const
+MANGOS_SIMD_KERNEL float GridMap::getHeightFromUint16(float x, float y) const
 {
     if (!m_uint16_V8 || !m_uint16_V9)
         return m_gridHeight;
@@ -710,7 +781,7 @@ bool GridMap::ExistVMap(uint32 mapid, int gx, int gy)
 }
 
 //////////////////////////////////////////////////////////////////////////
-TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
+TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid), m_keepLoaded(false)
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
     {
@@ -732,9 +803,8 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
 
 TerrainInfo::~TerrainInfo()
 {
-    for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
-        for (auto& m_GridMap : m_GridMaps)
-            delete m_GridMap[k];
+    for (uint32 grid : m_loadedGridMaps)
+        delete m_GridMaps[grid / MAX_NUMBER_OF_GRIDS][grid % MAX_NUMBER_OF_GRIDS];
 
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
@@ -775,32 +845,42 @@ void TerrainInfo::Unload(const uint32 x, const uint32 y)
 // call this method only
 void TerrainInfo::CleanUpGrids(const uint32 diff)
 {
+    if (m_keepLoaded)
+        return;
+
     i_timer.Update(diff);
     if (!i_timer.Passed())
         return;
 
-    for (int y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
+    // only the created GridMap objects are checked, most maps use a few of the 64x64 grids
+    LOCK_GUARD lock(m_mutex);
+    for (size_t i = 0; i < m_loadedGridMaps.size();)
     {
-        for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+        uint32 x = m_loadedGridMaps[i] / MAX_NUMBER_OF_GRIDS;
+        uint32 y = m_loadedGridMaps[i] % MAX_NUMBER_OF_GRIDS;
+        const int16& iRef = m_GridRef[x][y];
+        GridMap* pMap = m_GridMaps[x][y];
+
+        // delete those GridMap objects which have refcount = 0
+        if (iRef != 0)
         {
-            const int16& iRef = m_GridRef[x][y];
-            GridMap* pMap = m_GridMaps[x][y];
+            ++i;
+            continue;
+        }
 
-            // delete those GridMap objects which have refcount = 0
-            if (pMap && iRef == 0)
-            {
-                m_GridMaps[x][y] = nullptr;
-                // delete grid data if reference count == 0
-                pMap->unloadData();
-                delete pMap;
+        m_GridMaps[x][y] = nullptr;
+        m_loadedGridMaps[i] = m_loadedGridMaps.back();
+        m_loadedGridMaps.pop_back();
 
-                // unload VMAPS...
-                VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+        // delete grid data if reference count == 0
+        pMap->unloadData();
+        delete pMap;
 
-                // unload mmap...
-                MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
-            }
-        }
+        // unload VMAPS...
+        VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+
+        // unload mmap...
+        MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
     }
 
     i_timer.Reset();
@@ -832,40 +912,67 @@ int TerrainInfo::UnrefGrid(const uint32& x, const uint32& y)
 float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;            // Store Height obtained by maps
-    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
 
     // find raw .map surface under Z coordinates (or well-defined above)
     if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x, y))
         mapHeight = gmap->getHeight(x, y);
 
+    return useVmaps ? SelectStaticHeight(x, y, z, mapHeight, maxSearchDist) : mapHeight;
+}
+
+void TerrainInfo::GetHeightsStatic(float const* x, float const* y, float const* z, float* heights, uint32 count, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
+{
+    for (uint32 i = 0; i < count;)
+    {
+        int gx = (int)(32 - x[i] / SIZE_OF_GRIDS);
+        int gy = (int)(32 - y[i] / SIZE_OF_GRIDS);
+        uint32 end = i + 1;
+        while (end < count && (int)(32 - x[end] / SIZE_OF_GRIDS) == gx && (int)(32 - y[end] / SIZE_OF_GRIDS) == gy)
+            ++end;
+
+        if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x[i], y[i]))
+            gmap->getHeights(x + i, y + i, heights + i, end - i);
+        else
+            std::fill(heights + i, heights + end, VMAP_INVALID_HEIGHT_VALUE);
+
+        i = end;
+    }
+
     if (useVmaps)
+        for (uint32 i = 0; i < count; ++i)
+            heights[i] = SelectStaticHeight(x[i], y[i], z[i], heights[i], maxSearchDist);
+}
+
+// the vmap height near z when there is one and it suits better than the map height
+float TerrainInfo::SelectStaticHeight(float x, float y, float z, float mapHeight, float maxSearchDist) const
+{
+    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (vmgr && vmgr->isHeightCalcEnabled())
     {
-        VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
-        if (vmgr && vmgr->isHeightCalcEnabled())
-        {
-            float z2 = z + 2.0f;
+        float z2 = z + 2.0f;
 
-            // if mapHeight has been found search vmap height at least until mapHeight point
-            // this prevent case when original Z "too high above ground and vmap height search fail"
-            // this will not affect most normal cases (no map in instance, or stay at ground at continent)
-            if (mapHeight > INVALID_HEIGHT && z2 - mapHeight > maxSearchDist)
-                maxSearchDist = z2 - mapHeight + 1.0f;      // 1.0 make sure that we not fail for case when map height near but above for vamp height
+        // if mapHeight has been found search vmap height at least until mapHeight point
+        // this prevent case when original Z "too high above ground and vmap height search fail"
+        // this will not affect most normal cases (no map in instance, or stay at ground at continent)
+        if (mapHeight > INVALID_HEIGHT && z2 - mapHeight > maxSearchDist)
+            maxSearchDist = z2 - mapHeight + 1.0f;      // 1.0 make sure that we not fail for case when map height near but above for vamp height
 
-            // look from a bit higher pos to find the floor
-            vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, maxSearchDist);
+        // look from a bit higher pos to find the floor
+        vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, maxSearchDist);
 
-            // if not found in expected range, look for infinity range (case of far above floor, but below terrain-height)
-            if (vmapHeight <= INVALID_HEIGHT)
-                vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, 10000.0f);
+        // if not found in expected range, look for infinity range (case of far above floor, but below terrain-height)
+        if (vmapHeight <= INVALID_HEIGHT)
+            vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, 10000.0f);
 
-            // look upwards
-            if (vmapHeight <= INVALID_HEIGHT && mapHeight > z2 && std::abs(z2 - mapHeight) > 30.f)
-                vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, -maxSearchDist);
+        // look upwards
+        if (vmapHeight <= INVALID_HEIGHT && mapHeight > z2 && std::abs(z2 - mapHeight) > 30.f)
+            vmapHeight = vmgr->getHeight(GetMapId(), x, y, z2, -maxSearchDist);
 
-            // still not found, look near terrain height
-            if (vmapHeight <= INVALID_HEIGHT && mapHeight > INVALID_HEIGHT && z2 < mapHeight)
-                vmapHeight = vmgr->getHeight(GetMapId(), x, y, mapHeight + 2.0f, DEFAULT_HEIGHT_SEARCH);
-        }
+        // still not found, look near terrain height
+        if (vmapHeight <= INVALID_HEIGHT && mapHeight > INVALID_HEIGHT && z2 < mapHeight)
+            vmapHeight = vmgr->getHeight(GetMapId(), x, y, mapHeight + 2.0f, DEFAULT_HEIGHT_SEARCH);
     }
 
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
@@ -1252,6 +1359,10 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
         return m_GridMaps[x][y];
     }
 
+#ifdef BUILD_METRICS
+    std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+#endif
+
     {
         LOCK_GUARD lock(m_mutex);
         // double checked lock pattern
@@ -1273,6 +1384,7 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
 
             delete[] tmp;
             m_GridMaps[x][y] = map;
+            m_loadedGridMaps.push_back(x * MAX_NUMBER_OF_GRIDS + y);
         }
     }
 
@@ -1310,6 +1422,15 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
     if (m_GridMaps[x][y])
         m_GridMaps[x][y]->SetFullyLoaded();
 
+#ifdef BUILD_METRICS
+    // compare load times of read ahead grids with the others to see the stall avoided
+    metric::measurement meas("terrain.grid_load", {
+        { "map_id", std::to_string(m_mapId) },
+        { "prefetched", sMapMgr.GetTerrainPrefetcher().ConsumePrefetched(m_mapId, x, y) ? "1" : "0" }
+    });
+    meas.add_field("duration", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count()));
+#endif
+
     return  m_GridMaps[x][y];
 }
 
@@ -1358,6 +1479,12 @@ TerrainInfo* TerrainManager::LoadTerrain(const uint32 mapId)
     if (iter == i_TerrainMap.end())
     {
         TerrainInfo* info = new TerrainInfo(mapId);
+
+        // a battleground or arena map is loaded again for every match
+        MapEntry const* mapEntry = sMapStore.LookupEntry(mapId);
+        if (mapEntry && mapEntry->IsBattleGroundOrArena() && sWorld.getConfig(CONFIG_BOOL_BATTLEGROUND_KEEP_TERRAIN_LOADED))
+            info->SetKeepLoaded(true);
+
         i_TerrainMap[mapId] = info;
         return info;
     }
@@ -1376,7 +1503,7 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
     {
         TerrainInfo* ptr = (*iter).second;
         // lets check if this object can be actually freed
-        if (!ptr->IsReferenced())
+        if (!ptr->IsReferenced() && !ptr->IsKeptLoaded())
         {
             i_TerrainMap.erase(iter);
             delete ptr;
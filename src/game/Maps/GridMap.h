@@ -28,6 +28,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 class Creature;
 class Unit;
@@ -79,6 +80,12 @@ class GridMap
         // For fast check
         bool m_fullyLoaded;
 
+        // read-only mapping of the whole file when Terrain.MemoryMapped is set, the data arrays point into it
+        void* m_mapping;
+        size_t m_mappingSize;
+
+        template<typename T> bool loadArray(FILE* in, T*& data, size_t count);
+        template<typename T> void unloadArray(T*& data);
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -92,6 +99,8 @@ class GridMap
         float getHeightFromUint16(float x, float y) const;
         float getHeightFromUint8(float x, float y) const;
         float getHeightFromFlat(float x, float y) const;
+        template<float(GridMap::*GetHeight)(float x, float y) const>
+        void getHeightsFrom(float const* x, float const* y, float* heights, uint32 count) const;
 
     public:
 
@@ -108,6 +117,8 @@ class GridMap
 
         uint16 getArea(float x, float y) const;
         inline float getHeight(float x, float y) const { return (this->*m_gridGetHeight)(x, y); }
+        // same as getHeight for every point, the height format is only dispatched once
+        void getHeights(float const* x, float const* y, float* heights, uint32 count) const;
         float getLiquidLevel(float x, float y) const;
         uint8 getTerrainType(float x, float y) const;
         GridMapLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, GridMapLiquidData* data = nullptr);
@@ -142,6 +153,8 @@ class TerrainInfo : public Referencable<std::atomic_long>
         // TODO: move all terrain/vmaps data info query functions
         // from 'Map' class into this class
         float GetHeightStatic(float x, float y, float z, bool useVmaps = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
+        // GetHeightStatic of count points, consecutive points in the same grid get their map heights in one go
+        void GetHeightsStatic(float const* x, float const* y, float const* z, float* heights, uint32 count, bool useVmaps = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         float GetWaterLevel(float x, float y, float z, float* pGround = nullptr) const;
         float GetWaterOrGroundLevel(float x, float y, float z, float& groundZ, bool swim = false, float minWaterDeep = DEFAULT_COLLISION_HEIGHT) const;
         bool IsInWater(float x, float y, float z, GridMapLiquidData* data = nullptr, float min_depth = 2.0f) const;
@@ -161,6 +174,13 @@ class TerrainInfo : public Referencable<std::atomic_long>
         bool GetAreaInfo(float x, float y, float z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // map, vmap and mmap data of the grid are loaded
+        bool IsGridLoaded(uint32 x, uint32 y) const { return m_GridMaps[x][y] && m_GridMaps[x][y]->IsFullyLoaded(); }
+
+        // grids without references are kept, for the maps whose instances come and go all the time
+        void SetKeepLoaded(bool keep) { m_keepLoaded = keep; }
+        bool IsKeptLoaded() const { return m_keepLoaded; }
+
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
@@ -169,6 +189,7 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
     protected:
         friend class Map;
+        friend class MapManager;
         friend class ObjectMgr;
         // load/unload terrain data
         GridMap* Load(const uint32 x, const uint32 y, bool mapOnly = false);
@@ -179,6 +200,7 @@ class TerrainInfo : public Referencable<std::atomic_long>
         TerrainInfo& operator=(const TerrainInfo&);
 
         GridMap* GetGrid(const float x, const float y, bool loadOnlyMap = false);
+        float SelectStaticHeight(float x, float y, float z, float mapHeight, float maxSearchDist) const;
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnly = false);
 
         int RefGrid(const uint32& x, const uint32& y);
@@ -188,6 +210,8 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        std::vector<uint32> m_loadedGridMaps;               // x * MAX_NUMBER_OF_GRIDS + y of the created GridMap objects, guarded by m_mutex
+        bool m_keepLoaded;
 
         // global garbage collection timer
         ShortIntervalTimer i_timer;
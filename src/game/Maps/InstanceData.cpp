@@ -22,16 +22,141 @@
 #include "Log.h"
 #include "WorldPacket.h"
 
+// Encounter states record: "E<version>:" and the hex of the varint encoded count and states
+#define ENCOUNTER_STATES_RECORD_VERSION 1
+
+namespace
+{
+    char const hexDigits[] = "0123456789abcdef";
+
+    void AppendVarint(std::string& out, uint32 value)
+    {
+        do
+        {
+            uint8 byte = value & 0x7F;
+            value >>= 7;
+            if (value)
+                byte |= 0x80;
+            out += hexDigits[byte >> 4];
+            out += hexDigits[byte & 0x0F];
+        }
+        while (value);
+    }
+
+    int HexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        return -1;
+    }
+
+    bool ReadVarint(char const*& data, uint32& value)
+    {
+        value = 0;
+        for (uint32 shift = 0; shift < 35; shift += 7)
+        {
+            int high = HexValue(data[0]);
+            int low = high < 0 ? -1 : HexValue(data[1]);
+            if (low < 0)
+                return false;
+
+            data += 2;
+            uint8 byte = uint8((high << 4) | low);
+            value |= uint32(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+}
+
+void InstanceData::SetEncounterState(uint32 index, uint32 state)
+{
+    if (index >= m_encounterStates.size() || m_encounterStates[index] == state)
+        return;
+
+    m_encounterStates[index] = state;
+    SaveToDB();
+}
+
+std::string InstanceData::GetSaveData() const
+{
+    if (m_encounterStates.empty())
+    {
+        char const* data = Save();
+        return data ? data : "";
+    }
+
+    std::string data = "E" + std::to_string(ENCOUNTER_STATES_RECORD_VERSION) + ":";
+    AppendVarint(data, uint32(m_encounterStates.size()));
+    for (uint32 state : m_encounterStates)
+        AppendVarint(data, state);
+    return data;
+}
+
+void InstanceData::LoadData(char const* data)
+{
+    m_lastSavedData = data;
+
+    std::string const prefix = "E" + std::to_string(ENCOUNTER_STATES_RECORD_VERSION) + ":";
+    if (m_encounterStates.empty() || strncmp(data, prefix.c_str(), prefix.size()) != 0)
+    {
+        Load(data);
+        return;
+    }
+
+    // a record with more states than the script knows was saved by a newer script, the extra states are dropped
+    char const* itr = data + prefix.size();
+    uint32 count;
+    if (!ReadVarint(itr, count))
+    {
+        sLog.outError("InstanceData::LoadData: broken encounter states record for map %u instance %u", instance->GetId(), instance->GetInstanceId());
+        return;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 state;
+        if (!ReadVarint(itr, state))
+        {
+            sLog.outError("InstanceData::LoadData: broken encounter states record for map %u instance %u", instance->GetId(), instance->GetInstanceId());
+            break;
+        }
+
+        if (i < m_encounterStates.size())
+            m_encounterStates[i] = state;
+    }
+
+    OnEncounterStatesLoaded();
+}
+
 void InstanceData::SaveToDB() const
 {
     // no reason to save BGs/Arenas
     if (instance->IsBattleGroundOrArena())
         return;
 
-    if (!Save())
+    m_saveRequested = true;
+}
+
+void InstanceData::SaveIfRequested()
+{
+    if (!m_saveRequested)
+        return;
+
+    m_saveRequested = false;
+
+    if (m_encounterStates.empty() && !Save())
+        return;
+
+    // several state changes of one update are written once, unchanged data not at all
+    std::string data = GetSaveData();
+    if (data == m_lastSavedData)
         return;
 
-    std::string data = Save();
+    m_lastSavedData = data;
     CharacterDatabase.escape_string(data);
 
     if (instance->Instanceable())
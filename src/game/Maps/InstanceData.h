@@ -105,7 +105,7 @@ class InstanceData
 {
     public:
 
-        explicit InstanceData(Map* map) : instance(map) {}
+        explicit InstanceData(Map* map) : instance(map), m_saveRequested(false) {}
         virtual ~InstanceData() {}
 
         Map* instance;
@@ -119,7 +119,13 @@ class InstanceData
         // When save is needed, this function generates the data
         virtual const char* Save() const { return ""; }
 
+        // Saved data of either kind: the encounter states record if the script keeps its states here, Save() otherwise
+        std::string GetSaveData() const;
+        void LoadData(const char* data);
+
+        // Only requests the save, the data is written after the instance data update if it changed since the last write
         void SaveToDB() const;
+        void SaveIfRequested();
 
         // Called every map update
         virtual void Update(const uint32 /*diff*/) {}
@@ -210,6 +216,22 @@ class InstanceData
         // Wotlk only
         // Special UI unit frame - sent mostly for raid bosses
         void SendEncounterFrame(uint32 type, ObjectGuid sourceGuid = ObjectGuid(), uint8 param1 = 0, uint8 param2 = 0) const;
+
+    protected:
+        // Encounter states kept by the core instead of the script's Save() text, saved as a small versioned binary record.
+        // A script sets the count on creation and before loading, Load() then only receives data saved by an older version of the script.
+        void SetEncounterCount(uint32 count) { m_encounterStates.resize(count, 0); }
+        uint32 GetEncounterCount() const { return uint32(m_encounterStates.size()); }
+        uint32 GetEncounterState(uint32 index) const { return index < m_encounterStates.size() ? m_encounterStates[index] : 0; }
+        void SetEncounterState(uint32 index, uint32 state);
+
+        // Called after LoadData read an encounter states record, e.g. to reset the states in progress
+        virtual void OnEncounterStatesLoaded() {}
+
+    private:
+        std::vector<uint32> m_encounterStates;
+        mutable bool m_saveRequested;
+        std::string m_lastSavedData;                        // as written to or read from the DB
 };
 
 #endif
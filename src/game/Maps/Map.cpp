@@ -35,15 +35,43 @@
 #include "MapRefManager.h"
 #include "Server/DBCEnums.h"
 #include "Maps/MapPersistentStateMgr.h"
+#include "Maps/MapWorkers.h"
+#include "Maps/CombatLogBatch.h"
+#include "Maps/SummonPool.h"
 #include "Vmap/VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathRequestQueue.h"
 #include "Calendar/Calendar.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
+#include "Database/DatabaseEnv.h"
 
 #ifdef BUILD_METRICS
 #include "Metric/Metric.h"
+
+struct MapMetrics
+{
+    MapMetrics(std::map<std::string, std::string> const& tags) :
+        update("map.update", tags), updatedObjects("map.update.objects", tags), sessionUpdate("map.update.session", tags),
+        sessions("map.sessions", tags), creaturesAwake("map.creatures_awake", tags), creaturesAsleep("map.creatures_asleep", tags),
+        summonPoolHits("map.summon_pool.hits", tags), summonPoolMisses("map.summon_pool.misses", tags)
+    {
+    }
+
+    metric::histogram update;                               // microseconds
+    metric::histogram updatedObjects;
+    metric::histogram sessionUpdate;                        // microseconds
+    metric::gauge sessions;
+    metric::gauge creaturesAwake;
+    metric::gauge creaturesAsleep;
+    metric::gauge summonPoolHits;                           // since the map was created
+    metric::gauge summonPoolMisses;
+};
+#endif
+
+#ifdef BUILD_PLAYERBOT
+#include "PlayerBot/Base/PlayerbotAI.h"
 #endif
 
 #ifdef ENABLE_PLAYERBOTS
@@ -54,18 +82,18 @@ Map::~Map()
 {
     UnloadAll(true);
 
-    if (!m_scriptSchedule.empty())
-        sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
+    // queries still running for this map are delivered to the world thread from now on
+    m_resultQueue->Forward(CharacterDatabase.GetDefaultResultQueue());
 
     if (m_persistentState)
         m_persistentState->SetUsedByMapState(nullptr);         // field pointer can be deleted after this
 
+    if (i_data)
+        i_data->SaveIfRequested();
+
     delete i_data;
     i_data = nullptr;
 
-    // unload instance specific navigation data
-    MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(m_TerrainData->GetMapId(), GetInstanceId());
-
     // release reference count
     if (m_TerrainData->Release())
         sTerrainMgr.UnloadTerrain(m_TerrainData->GetMapId());
@@ -160,10 +188,27 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
-      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), i_defaultLight(GetDefaultMapLight(id)), m_activeAreasTimer(0), hasRealPlayers(false)
+      i_gridExpiry(expiry), m_gridUnloadTime(0), m_TerrainData(sTerrainMgr.LoadTerrain(id)), m_terrainCache(m_TerrainData),
+      i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), i_defaultLight(GetDefaultMapLight(id)), m_activeAreasTimer(0), m_awakeCreatures(0), m_asleepCreatures(0), m_lastAwakeCreatures(0), m_lastAsleepCreatures(0), m_relocationCount(0), m_gatherMovementRelays(false), m_lastUpdateDuration(0), m_lastUpdateThread(MapUpdater::NO_WORKER_THREAD), m_pendingUpdateDiff(0),
+      m_tickProfile("map " + std::to_string(id) + "/" + std::to_string(InstanceId)), hasRealPlayers(false)
 {
     m_weatherSystem = new WeatherSystem(this);
+    m_resultQueue = std::make_shared<SqlResultQueue>();
+    m_pathRequestQueue = std::make_unique<PathRequestQueue>();
+    if (uint32 summonPoolSize = sWorld.getConfig(CONFIG_UINT32_SUMMON_POOL_SIZE))
+        m_summonPool = std::make_shared<SummonPool>(summonPoolSize);
+    m_terrainPrefetchTimer.SetInterval(1000);
+    m_relocationTimer.SetInterval(sWorld.getConfig(CONFIG_UINT32_RELOCATION_BATCH_INTERVAL));
+    m_crowdVisibilityTimer.SetInterval(5 * IN_MILLISECONDS);
+    m_stealthDetectionCacheTimer.SetInterval(10 * IN_MILLISECONDS);
+    if (uint64 seed = sWorld.getConfig(CONFIG_UINT32_DEBUG_RANDOM_SEED))
+        m_random = std::make_unique<RandomEngine>(seed ^ (((uint64(id) << 32) | InstanceId) * 0x9E3779B97F4A7C15ULL));
+#ifdef BUILD_METRICS
+    m_metrics = std::make_unique<MapMetrics>(std::map<std::string, std::string>{
+        { "map_id", std::to_string(i_id) },
+        { "instance_id", std::to_string(i_InstanceId) }
+    });
+#endif
 }
 
 void Map::Initialize(bool loadInstanceData /*= true*/)
@@ -306,6 +351,9 @@ void Map::DeleteFromWorld(Player* pl)
 
 void Map::EnsureGridCreated(const GridPair& p)
 {
+    // grids are shared by all cells, creating or loading one from a cell thread stops the others
+    SharedContainersGuard guard(*this);
+
     if (!getNGrid(p.x_coord, p.y_coord))
     {
         setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
@@ -327,6 +375,7 @@ void Map::EnsureGridCreated(const GridPair& p)
 
 void Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 {
+    SharedContainersGuard guard(*this);
     NGridType* grid;
 
     if (EnsureGridLoaded(cell))
@@ -354,6 +403,7 @@ void Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    SharedContainersGuard guard(*this);
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -374,16 +424,33 @@ bool Map::EnsureGridLoaded(const Cell& cell)
         return true;
     }
 
+    if (grid->GetUnloadedCells())
+    {
+        LoadUnloadedCells(*grid);
+        return true;
+    }
+
     return false;
 }
 
+void Map::LoadUnloadedCells(NGridType& grid)
+{
+    SharedContainersGuard guard(*this);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Unloading grid[%u,%u] for map %u cancelled, loading its %u emptied cells again", grid.getX(), grid.getY(), i_id, grid.GetUnloadedCells());
+
+    // the corpses are world objects, they stayed in the grid
+    Cell cell(CellPair(grid.getX() * MAX_NUMBER_OF_CELLS, grid.getY() * MAX_NUMBER_OF_CELLS));
+    ObjectGridLoader loader(grid, this, cell);
+    loader.LoadN(grid.GetUnloadedCells());
+    grid.SetUnloadedCells(0);
+}
+
 uint32 Map::GetLoadedGridsCount()
 {
     uint32 count = 0;
-    for (uint32 i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
-        for (uint32 k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
-            if (i_grids[i][k] && i_grids[i][k]->GetGridState() == GRID_STATE_ACTIVE)
-                ++count;
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+        if (i->getSource()->GetGridState() == GRID_STATE_ACTIVE)
+            ++count;
     return count;
 }
 
@@ -421,6 +488,7 @@ bool Map::Add(Player* player)
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
     Cell cell(p);
     EnsureGridLoadedAtEnter(cell, player);
+    m_playerSnapshots.Add(player);
     player->AddToWorld();
 
     SendInitSelf(player);
@@ -453,6 +521,9 @@ Map::Add(T* obj)
         return;
     }
 
+    // summons are added by the cell thread of their summoner
+    SharedContainersGuard guard(*this);
+
     obj->SetMap(this);
 
     Cell cell(p);
@@ -480,6 +551,9 @@ Map::Add(T* obj)
 
 void Map::MessageBroadcast(Player const* player, WorldPacket const& msg, bool to_self)
 {
+    FlushMovementRelayOf(player);
+    CombatLogBatch::FlushOfCurrent(player);
+
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
 
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
@@ -501,6 +575,9 @@ void Map::MessageBroadcast(Player const* player, WorldPacket const& msg, bool to
 
 void Map::MessageBroadcast(WorldObject const* obj, WorldPacket const& msg)
 {
+    FlushMovementRelayOf(obj);
+    CombatLogBatch::FlushOfCurrent(obj);
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
 
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
@@ -524,6 +601,9 @@ void Map::MessageBroadcast(WorldObject const* obj, WorldPacket const& msg)
 
 void Map::MessageDistBroadcast(Player const* player, WorldPacket const& msg, float dist, bool to_self, bool own_team_only)
 {
+    FlushMovementRelayOf(player);
+    CombatLogBatch::FlushOfCurrent(player);
+
     CellPair p = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
 
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
@@ -545,6 +625,9 @@ void Map::MessageDistBroadcast(Player const* player, WorldPacket const& msg, flo
 
 void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket const& msg, float dist)
 {
+    FlushMovementRelayOf(obj);
+    CombatLogBatch::FlushOfCurrent(obj);
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
 
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
@@ -564,6 +647,63 @@ void Map::MessageDistBroadcast(WorldObject const* obj, WorldPacket const& msg, f
     cell.Visit(p, message, *this, *obj, dist);
 }
 
+void Map::RelayMovement(WorldObject const* mover, Player const* skipped, WorldPacket const& msg)
+{
+    if (!m_gatherMovementRelays)
+    {
+        mover->SendMessageToSetExcept(msg, skipped);
+        return;
+    }
+
+    auto itr = m_movementRelayIndex.find(mover->GetObjectGuid());
+    if (itr == m_movementRelayIndex.end())
+    {
+        itr = m_movementRelayIndex.emplace(mover->GetObjectGuid(), m_movementRelays.size()).first;
+        m_movementRelays.emplace_back();
+        m_movementRelays.back().mover = mover->GetObjectGuid();
+    }
+
+    MovementRelay& relay = m_movementRelays[itr->second];
+    relay.skipped = skipped ? skipped->GetObjectGuid() : ObjectGuid();
+    relay.packets.push_back(std::make_shared<WorldPacket const>(msg));
+}
+
+void Map::FlushMovementRelay(ObjectGuid const& moverGuid)
+{
+    auto itr = m_movementRelayIndex.find(moverGuid);
+    if (itr == m_movementRelayIndex.end())
+        return;
+
+    MovementRelay& relay = m_movementRelays[itr->second];
+    m_movementRelayIndex.erase(itr);
+    SendMovementRelay(relay);
+}
+
+void Map::FlushMovementRelays()
+{
+    // a mover flushed alone before keeps its empty slot until here
+    for (MovementRelay& relay : m_movementRelays)
+        if (!relay.packets.empty())
+            SendMovementRelay(relay);
+
+    m_movementRelays.clear();
+    m_movementRelayIndex.clear();
+}
+
+void Map::SendMovementRelay(MovementRelay& relay)
+{
+    std::vector<std::shared_ptr<WorldPacket const>> packets;
+    std::swap(packets, relay.packets);
+
+    // a mover gone from the map meanwhile was already removed at the clients
+    WorldObject* mover = GetWorldObject(relay.mover);
+    if (!mover || !mover->IsInWorld() || mover->GetMap() != this)
+        return;
+
+    MaNGOS::MovementRelayDeliverer notifier(mover, packets, relay.skipped);
+    Cell::VisitWorldObjects(mover, notifier, GetVisibilityDistance());
+}
+
 void Map::MessageMapBroadcast(WorldObject const* /*obj*/, WorldPacket const& msg)
 {
     Map::PlayerList const& pList = GetPlayers();
@@ -633,12 +773,14 @@ void Map::ExecuteMapWorkerArea(uint32 areaId, std::function<void(Player*)> const
 
 bool Map::loaded(const GridPair& p) const
 {
-    return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
+    // a grid being unloaded does not take objects any more, those entering it load its emptied cells again
+    NGridType const* grid = getNGrid(p.x_coord, p.y_coord);
+    return grid && grid->isGridObjectDataLoaded() && !grid->GetUnloadedCells();
 }
 
 #define MAP_METRICS
 
-void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor, std::vector<Cell>* cellsToCrawl /*= nullptr*/)
 {
     // lets update mobs/objects in ALL visible cells around player!
     CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
@@ -656,6 +798,12 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
                 CellPair pair(x, y);
                 Cell cell(pair);
                 cell.SetNoCreate();
+                // cells to crawl are visited later, possibly split between cell threads
+                if (cellsToCrawl)
+                {
+                    cellsToCrawl->push_back(cell);
+                    continue;
+                }
                 Visit(cell, gridVisitor);
                 Visit(cell, worldVisitor);
             }
@@ -663,22 +811,188 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
     }
 }
 
+thread_local Map* Map::s_cellThreadMap = nullptr;
+thread_local uint32 Map::s_exclusiveDepth = 0;
+
+Map::SharedContainersGuard::SharedContainersGuard(Map& map) : m_map(nullptr)
+{
+    if (s_cellThreadMap != &map)
+        return;
+
+    m_map = &map;
+    if (s_exclusiveDepth++ == 0)
+    {
+        // the shared hold of the object update is given up first, two threads upgrading it would deadlock
+        map.m_sharedContainersLock.unlock_shared();
+        map.m_sharedContainersLock.lock();
+    }
+}
+
+Map::SharedContainersGuard::~SharedContainersGuard()
+{
+    if (m_map && --s_exclusiveDepth == 0)
+    {
+        m_map->m_sharedContainersLock.unlock();
+        m_map->m_sharedContainersLock.lock_shared();
+    }
+}
+
+bool Map::ReachesBeyond(WorldObject const* object, float reach) const
+{
+    // game objects and dynamic objects only act around themselves
+    if (!object->isType(TYPEMASK_UNIT))
+        return false;
+
+    Unit const* unit = static_cast<Unit const*>(object);
+    auto isFar = [unit, reach](Unit const* other) { return other && !unit->IsWithinDist(other, reach, false); };
+
+    if (isFar(unit->GetVictim()) || isFar(unit->GetCharm()) || isFar(unit->GetCharmer()) || isFar(unit->GetOwner()) || isFar(unit->GetSpawner()))
+        return true;
+
+    for (Unit* attacker : unit->getAttackers())
+        if (isFar(attacker))
+            return true;
+
+    for (HostileReference* ref : unit->getThreatManager().getThreatList())
+        if (isFar(ref->getTarget()))
+            return true;
+
+    return false;
+}
+
+uint64 Map::UpdateCellsInParallel(std::vector<Cell> const& cells, uint32 diff)
+{
+    MapUpdater& cellUpdater = sMapMgr.GetCellUpdater();
+    uint32 const numThreads = sMapMgr.GetNumCellThreads();
+
+    // an object acts on units up to the visibility distance around it (targets, area spells, summons), so
+    // cells are grouped in square blocks wider than twice that and the blocks colored as a checkerboard.
+    // blocks of the same color are at least one block apart, what their objects touch never overlaps
+    float const reach = GetVisibilityDistance();
+    uint32 const blockSize = uint32(2 * reach / SIZE_OF_GRID_CELL) + 1;
+
+    std::map<uint32, std::vector<Cell>> blocks[4];
+    for (auto& cell : cells)
+    {
+        CellPair pair = cell.cellPair();
+        uint32 blockX = pair.x_coord / blockSize;
+        uint32 blockY = pair.y_coord / blockSize;
+        blocks[(blockX & 1) | ((blockY & 1) << 1)][blockY * TOTAL_NUMBER_OF_CELLS_PER_MAP + blockX].push_back(cell);
+    }
+
+    // all crawlers are created (and so collect their objects) before the first one is executed
+    // a block is never split, its cells are close enough to interact
+    std::vector<GridCrawler*> crawlers[4];
+    WorldObjectUnSet deferred;
+    for (uint32 color = 0; color < 4; ++color)
+    {
+        auto const& colorBlocks = blocks[color];
+        if (colorBlocks.empty())
+            continue;
+
+        size_t chunkSize = (colorBlocks.size() + numThreads - 1) / numThreads;
+        std::vector<Cell> chunk;
+        size_t chunkBlocks = 0;
+        for (auto const& block : colorBlocks)
+        {
+            chunk.insert(chunk.end(), block.second.begin(), block.second.end());
+            if (++chunkBlocks == chunkSize)
+            {
+                crawlers[color].push_back(new GridCrawler(*this, chunk, diff, reach, deferred, cellUpdater));
+                chunk.clear();
+                chunkBlocks = 0;
+            }
+        }
+
+        if (!chunk.empty())
+            crawlers[color].push_back(new GridCrawler(*this, chunk, diff, reach, deferred, cellUpdater));
+    }
+
+    uint64 count = 0;
+    for (auto& colorCrawlers : crawlers)
+    {
+        bool scheduled = false;
+        for (GridCrawler* crawler : colorCrawlers)
+        {
+            if (!crawler->GetObjectsCount())
+            {
+                delete crawler;
+                continue;
+            }
+
+            count += crawler->GetObjectsCount();
+            cellUpdater.schedule_update(crawler);
+            scheduled = true;
+        }
+
+        // next color may only start when all cells of this one are done
+        if (scheduled)
+            cellUpdater.wait();
+    }
+
+    // objects tied to units out of reach could touch another block, they are updated by the map thread
+    for (WorldObject* object : deferred)
+        object->Update(diff);
+    count += deferred.size();
+
+    return count;
+}
+
+uint32 Map::GetUpdateInterval(uint32 baseInterval, uint32 idleInterval) const
+{
+    // maps with players are always updated at full rate
+    if (HavePlayers() || idleInterval <= baseInterval)
+        return baseInterval;
+
+    // only active objects (escorts, transports, ...) around, back off halfway
+    uint32 interval = m_activeNonPlayers.empty() ? idleInterval : (baseInterval + idleInterval) / 2;
+
+    // expensive maps without players may not use more than 10% of their interval
+    return std::max(interval, m_lastUpdateDuration / 100);
+}
+
+bool Map::AddPendingUpdateDiff(uint32 diff, uint32 baseInterval, uint32 idleInterval)
+{
+    m_pendingUpdateDiff += diff;
+    return m_pendingUpdateDiff >= GetUpdateInterval(baseInterval, idleInterval);
+}
+
 void Map::Update(const uint32& t_diff)
 {
+    RandomGeneratorScope randomScope(m_random.get());
+    PlayerSnapshotTable::UpdateScope snapshotScope(*this);
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
-});
+    metric::histogram::timer<std::chrono::microseconds> meas(m_metrics->update);
 #endif
 
 
+    m_tickProfile.BeginTick();
+    TickPhase phase(m_tickProfile, "dynamic_tree");
+
     uint64 count = 0;
 
     m_dyn_tree.update(t_diff);
 
+#ifdef BUILD_METRICS
+    DynamicMapTree::BalanceStats treeStats;
+    m_dyn_tree.getBalanceStats(treeStats);
+    if (treeStats.rebuilds || treeStats.refits)
+    {
+        metric::measurement treeMeas("map.dynamic_tree", {
+            { "map_id", std::to_string(i_id) },
+            { "instance_id", std::to_string(i_InstanceId) }
+        });
+        treeMeas.add_field("rebuilds", std::to_string(treeStats.rebuilds));
+        treeMeas.add_field("refits", std::to_string(treeStats.refits));
+        treeMeas.add_field("time", std::to_string(treeStats.balanceTime));
+    }
+#endif
+
+    phase.Next("messager");
     GetMessager().Execute(this);
+    phase.Next("result_queue");
+    m_resultQueue->Update();
 
     /// update active cells around players and active objects
     resetMarkedCells();
@@ -688,6 +1002,7 @@ void Map::Update(const uint32& t_diff)
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
+    phase.Next("transports");
     for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
     {
         Transport* transport = *m_transportsIterator;
@@ -695,15 +1010,14 @@ void Map::Update(const uint32& t_diff)
         transport->Update(t_diff);
     }
 
+    phase.Next("sessions");
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     {
+        m_gatherMovementRelays = true;
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
-        metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
-            { "map_id", std::to_string(i_id) },
-            { "instance_id", std::to_string(i_InstanceId) },
-            });
+        metric::histogram::timer<std::chrono::microseconds> sessions_meas(m_metrics->sessionUpdate);
 #endif
 
         for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -720,10 +1034,25 @@ void Map::Update(const uint32& t_diff)
 #endif
         }
 #ifdef BUILD_METRICS
-        sessions_meas.add_field("count", std::to_string(static_cast<int32>(updatedSessions)));
+        m_metrics->sessions.set(updatedSessions);
 #endif
     }
 
+    phase.Next("movement_relay");
+    m_gatherMovementRelays = false;
+    FlushMovementRelays();
+
+    phase.Next("players");
+    // melee combat log of the player and object updates, sent per standing cell of the attackers
+    std::unique_ptr<CombatLogBatch::Scope> combatLog;
+    if (sWorld.getConfig(CONFIG_BOOL_COMBAT_LOG_BATCH))
+        combatLog.reset(new CombatLogBatch::Scope(*this));
+
+#ifdef BUILD_PLAYERBOT
+    // the bots of this map think on this thread, within a budget per tick
+    PlayerbotAI::ResetTickBudget();
+#endif
+
     // active areas timer
     m_activeAreasTimer += t_diff;
     if (m_activeAreasTimer >= 10000)
@@ -819,19 +1148,50 @@ void Map::Update(const uint32& t_diff)
         sLog.outBasic("Map %u: Active Areas Chars - %u of %u", GetId(), activeChars, m_mapRefManager.getSize());
     }
 
+    // busy maps may split the update of their active cells between cell threads
+    uint32 cellThreshold = sMapMgr.GetCellUpdater().activated() ? sWorld.GetCellUpdateThreshold(GetId()) : 0;
+    std::vector<Cell> activeCells;
+    std::vector<Cell>* cellsToCrawl = cellThreshold ? &activeCells : nullptr;
+
+    phase.Next("crowd_visibility");
+    m_crowdVisibilityTimer.Update(t_diff);
+    if (m_crowdVisibilityTimer.Passed())
+    {
+        m_crowdVisibilityTimer.Reset();
+        UpdateCrowdVisibility();
+    }
+
+    // drops the results of units gone or no more stealthed
+    m_stealthDetectionCacheTimer.Update(t_diff);
+    if (m_stealthDetectionCacheTimer.Passed())
+    {
+        m_stealthDetectionCacheTimer.Reset();
+        m_stealthDetectionCache.Clear();
+    }
+
+    phase.Next("active_cells");
+    // read ahead the terrain of grids players are heading to
+    m_terrainPrefetchTimer.Update(t_diff);
+    bool prefetchTerrain = m_terrainPrefetchTimer.Passed() && sMapMgr.GetTerrainPrefetcher().activated();
+    m_terrainPrefetchTimer.Reset();
+
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* player = m_mapRefIter->getSource();
         if (!player || !player->IsInWorld() || !player->IsPositionValid())
             continue;
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        if (prefetchTerrain)
+            sMapMgr.GetTerrainPrefetcher().PrefetchAhead(*player);
+
+        VisitNearbyCellsOf(player, grid_object_update, world_object_update, cellsToCrawl);
 
         // If player is using far sight, visit that object too
         if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update, cellsToCrawl);
     }
 
+    phase.Next("active_objects");
     // non-player active objects
     bool updateObj = urand(0, (HasRealPlayers() ? maxDiff : (maxDiff * 3))) < 10;
     if (!m_activeNonPlayers.empty())
@@ -869,28 +1229,26 @@ void Map::Update(const uint32& t_diff)
                     continue;
             }
 
-            objToUpdate.insert(obj);
+            // crawled cells always contain the object itself
+            if (!cellsToCrawl)
+                objToUpdate.insert(obj);
 
             // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update, cellsToCrawl);
+        }
+    }
 
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    phase.Next("objects");
+    if (cellsToCrawl)
+    {
+        if (activeCells.size() >= cellThreshold)
+            count += UpdateCellsInParallel(activeCells, t_diff);
+        else
+        {
+            for (auto& cell : activeCells)
             {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
+                Visit(cell, grid_object_update);
+                Visit(cell, world_object_update);
             }
         }
     }
@@ -902,13 +1260,42 @@ void Map::Update(const uint32& t_diff)
         ++count;
     }
 
+    m_lastAwakeCreatures = m_awakeCreatures.exchange(0);
+    m_lastAsleepCreatures = m_asleepCreatures.exchange(0);
+
+    phase.Next("combat_log");
+    combatLog.reset();
+
+    phase.Next("path_requests");
+    // solve paths requested during the object updates, results are picked up next update
+    m_pathRequestQueue->Solve(*this);
+
+    phase.Next("relocations");
+    UpdateRelocatedUnits(t_diff);
+
+    phase.Next("ai_notify");
+    UpdateAINotifyUnits();
+
 #ifdef BUILD_METRICS
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    m_metrics->updatedObjects.sample(count);
+    m_metrics->creaturesAwake.set(m_lastAwakeCreatures);
+    m_metrics->creaturesAsleep.set(m_lastAsleepCreatures);
+    if (m_summonPool)
+    {
+        m_metrics->summonPoolHits.set(m_summonPool->GetHits());
+        m_metrics->summonPoolMisses.set(m_summonPool->GetMisses());
+    }
 #endif
 
     // Send world objects and item update field changes
+    phase.Next("send_updates");
     SendObjectUpdates();
 
+    phase.Next("player_snapshots");
+    m_playerSnapshots.Publish(*this);
+
+    phase.Next("grids");
+    m_gridUnloadTime = 0;
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
@@ -924,13 +1311,25 @@ void Map::Update(const uint32& t_diff)
     }
 
     ///- Process necessary scripts
+    phase.Next("scripts");
     if (!m_scriptSchedule.empty())
         ScriptsProcess();
 
+    phase.Next("instance_data");
     if (i_data)
+    {
         i_data->Update(t_diff);
+        i_data->SaveIfRequested();
+    }
 
+    phase.Next("weather");
     m_weatherSystem->UpdateWeathers(t_diff);
+
+    ///- Expire the due respawn times and write the changed ones
+    phase.Next("respawn_times");
+    m_persistentState->Update(sWorld.GetGameTime());
+
+    m_tickProfile.EndTick();
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -1005,6 +1404,8 @@ Map::Remove(T* obj, bool remove)
         return;
     }
 
+    SharedContainersGuard guard(*this);
+
     Cell cell(p);
     if (!loaded(GridPair(cell.data.Part.grid_x, cell.data.Part.grid_y)))
         return;
@@ -1031,6 +1432,8 @@ Map::Remove(T* obj, bool remove)
         if (!sWorld.getConfig(CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY))
             obj->SaveRespawnTime();
 
+        ReleaseLocalLowGuid(obj->GetObjectGuid());
+
         // Note: In case resurrectable corpse and pet its removed from global lists in own destructor
         delete obj;
     }
@@ -1122,6 +1525,7 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
     // delay creature move for grid/cell to grid/cell moves
     if (old_cell.DiffCell(new_cell) || old_cell.DiffGrid(new_cell))
     {
+        SharedContainersGuard guard(*this);
         NGridType* oldGrid = getNGrid(old_cell.GridX(), old_cell.GridY());
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         RemoveFromGrid(go, oldGrid, old_cell);
@@ -1135,6 +1539,8 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
         go->UpdateModelPosition();
         go->UpdateObjectVisibility();
     }
+
+    go->UpdateTriggerVolume();
 }
 
 void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float z, float orientation)
@@ -1158,6 +1564,7 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
     // delay creature move for grid/cell to grid/cell moves
     if (old_cell.DiffCell(new_cell) || old_cell.DiffGrid(new_cell))
     {
+        SharedContainersGuard guard(*this);
         NGridType* oldGrid = getNGrid(old_cell.GridX(), old_cell.GridY());
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         RemoveFromGrid(dynObj, oldGrid, old_cell);
@@ -1169,6 +1576,8 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
         dynObj->Relocate(x, y, z, orientation);
         dynObj->UpdateObjectVisibility();
     }
+
+    dynObj->UpdateTriggerVolume();
 }
 
 bool Map::CreatureCellRelocation(Creature* c, const Cell& new_cell)
@@ -1186,6 +1595,8 @@ bool Map::CreatureCellRelocation(Creature* c, const Cell& new_cell)
 
     if (old_cell != new_cell)
     {
+        // the cells of both grids are shared with the other cell threads
+        SharedContainersGuard guard(*this);
         DEBUG_FILTER_LOG(LOG_FILTER_CREATURE_MOVES, "Creature (GUID: %u Entry: %u) moved in grid[%u,%u] from cell[%u,%u] to cell[%u,%u].", c->GetGUIDLow(), c->GetEntry(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.CellX(), new_cell.CellY());
         NGridType* oldGrid = getNGrid(old_cell.GridX(), old_cell.GridY());
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
@@ -1227,21 +1638,49 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
 
     {
         if (!pForce && ActiveObjectsNearGrid(x, y))
+        {
+            // players came back before the teardown finished, only what is already gone has to be loaded
+            if (grid->GetUnloadedCells())
+                LoadUnloadedCells(*grid);
             return false;
+        }
 
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Unloading grid[%u,%u] for map %u", x, y, i_id);
         ObjectGridUnloader unloader(*grid);
 
-        // Finish remove and delete all creatures with delayed remove before moving to respawn grids
-        // Must know real mob position before move
-        RemoveAllObjectsInRemoveList();
+        if (!grid->GetUnloadedCells())
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Unloading grid[%u,%u] for map %u", x, y, i_id);
 
-        // move creatures to respawn grids if this is diff.grid or to remove list
-        unloader.MoveToRespawnN();
+            // Finish remove and delete all creatures with delayed remove before moving to respawn grids
+            // Must know real mob position before move
+            RemoveAllObjectsInRemoveList();
+
+            // move creatures to respawn grids if this is diff.grid or to remove list
+            unloader.MoveToRespawnN();
+        }
 
         // Finish remove and delete all creatures with delayed remove before unload
         RemoveAllObjectsInRemoveList();
 
+        // spread the teardown of big grids over the next updates of the map, the grid stays until its last cell is empty
+        uint32 const budget = sWorld.getConfig(CONFIG_UINT32_GRID_UNLOAD_BUDGET);
+        if (!pForce && budget)
+        {
+            uint32 const startTime = WorldTimer::getMSTime();
+            uint32 nextCell = grid->GetUnloadedCells();
+            do
+                unloader.UnloadCell(nextCell++);
+            while (nextCell < MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS && m_gridUnloadTime + WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) < budget);
+            m_gridUnloadTime += WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+
+            if (nextCell < MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS)
+            {
+                grid->SetUnloadedCells(nextCell);
+                return true;
+            }
+        }
+
+        // also catches what was moved into the already emptied cells
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(nullptr, x, y);
@@ -1257,6 +1696,7 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         m_bLoadedGrids[gx][gy] = false;
         m_TerrainData->Unload(gx, gy);
     }
+    m_terrainCache.InvalidateGrid(gx, gy);
 
     DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Unloading grid[%u,%u] for map %u finished", x, y, i_id);
     return true;
@@ -1429,6 +1869,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    std::lock_guard<std::mutex> guard(m_objectsLock);
     i_objectsToRemove.insert(obj);
     // DEBUG_LOG("Object (GUID: %u TypeId: %u ) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -1542,6 +1983,7 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    SharedContainersGuard guard(*this);
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1570,6 +2012,7 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    SharedContainersGuard guard(*this);
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -1646,6 +2089,19 @@ void Map::CreateInstanceData(bool load)
 
     if (load)
     {
+        // a hibernated dungeon resumes with the data it had in memory
+        if (IsDungeon())
+        {
+            std::string data;
+            DungeonPersistentState* state = (DungeonPersistentState*)sMapPersistentStateMgr.GetPersistentState(GetId(), i_InstanceId);
+            if (state && state->TakeHibernatedInstanceData(data))
+            {
+                DEBUG_LOG("Resuming hibernated instance data for `%s` (Map: %u Instance: %u)", sScriptDevAIMgr.GetScriptName(i_script_id), GetId(), i_InstanceId);
+                i_data->LoadData(data.c_str());
+                return;
+            }
+        }
+
         // TODO: make a global storage for this
         QueryResult* result;
 
@@ -1661,7 +2117,7 @@ void Map::CreateInstanceData(bool load)
             if (data)
             {
                 DEBUG_LOG("Loading instance data for `%s` (Map: %u Instance: %u)", sScriptDevAIMgr.GetScriptName(i_script_id), GetId(), i_InstanceId);
-                i_data->Load(data);
+                i_data->LoadData(data);
             }
             delete result;
         }
@@ -1738,7 +2194,7 @@ DungeonMap::DungeonMap(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnM
 
     // the timer is started by default, and stopped when the first player joins
     // this make sure it gets unloaded if for some reason no player joins
-    m_unloadTimer = std::max(sWorld.getConfig(CONFIG_UINT32_INSTANCE_UNLOAD_DELAY), (uint32)MIN_UNLOAD_DELAY);
+    m_unloadTimer = GetEmptyUnloadDelay();
 }
 
 DungeonMap::~DungeonMap()
@@ -1883,7 +2339,7 @@ void DungeonMap::Remove(Player* player, bool remove)
 
     // if last player set unload timer
     if (!m_unloadTimer && m_mapRefManager.getSize() == 1)
-        m_unloadTimer = m_unloadWhenEmpty ? MIN_UNLOAD_DELAY : std::max(sWorld.getConfig(CONFIG_UINT32_INSTANCE_UNLOAD_DELAY), (uint32)MIN_UNLOAD_DELAY);
+        m_unloadTimer = m_unloadWhenEmpty ? MIN_UNLOAD_DELAY : GetEmptyUnloadDelay();
 
     Map::Remove(player, remove);
 
@@ -1963,10 +2419,56 @@ void DungeonMap::UnloadAll(bool pForce)
 
     if (m_resetAfterUnload)
         GetPersistanceState()->DeleteRespawnTimes();
+    else
+        Hibernate();
 
     Map::UnloadAll(pForce);
 }
 
+uint32 DungeonMap::GetEmptyUnloadDelay()
+{
+    uint32 delay = sWorld.getConfig(CONFIG_UINT32_INSTANCE_UNLOAD_DELAY);
+    if (uint32 hibernateDelay = sWorld.getConfig(CONFIG_UINT32_INSTANCE_HIBERNATE_DELAY))
+        delay = delay ? std::min(delay, hibernateDelay) : hibernateDelay;
+
+    return std::max(delay, (uint32)MIN_UNLOAD_DELAY);
+}
+
+// the gameobjects not in their spawn state, the others are created as they were left anyway
+struct HibernatedGoStateCollector
+{
+    DungeonPersistentState& i_state;
+
+    explicit HibernatedGoStateCollector(DungeonPersistentState& state) : i_state(state) {}
+
+    void Visit(GameObjectMapType& m)
+    {
+        for (auto& itr : m)
+        {
+            GameObject* go = itr.getSource();
+            GameObjectData const* data = sObjectMgr.GetGOData(go->GetDbGuid());
+            if (data && go->GetGoState() != data->go_state)
+                i_state.SetHibernatedGoState(go->GetDbGuid(), go->GetGoState());
+        }
+    }
+    template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
+};
+
+void DungeonMap::Hibernate()
+{
+    DungeonPersistentState* state = GetPersistanceState();
+
+    if (InstanceData* data = GetInstanceData())
+        state->SetHibernatedInstanceData(data->GetSaveData());
+
+    HibernatedGoStateCollector collector(*state);
+    TypeContainerVisitor<HibernatedGoStateCollector, GridTypeMapContainer> visitor(collector);
+    for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end(); ++i)
+        i->getSource()->Visit(visitor);
+
+    DETAIL_LOG("MAP: Hibernating instance '%u' of map '%s'", GetInstanceId(), GetMapName());
+}
+
 void DungeonMap::SendResetWarnings(uint32 timeLeft) const
 {
     for (const auto& itr : m_mapRefManager)
@@ -2098,15 +2600,12 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 
     if (execParams)                                         // Check if the execution should be uniquely
     {
-        for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
+        if (m_scriptSchedule.HasScript(scripts.first, id,
+                                       execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
+                                       execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid(), ownerGuid))
         {
-            if (searchItr->second.IsSameScript(scripts.first, id,
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid(), ownerGuid))
-            {
-                DETAIL_FILTER_LOG(LOG_FILTER_DB_SCRIPT, "DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
-                return true;
-            }
+            DETAIL_FILTER_LOG(LOG_FILTER_DB_SCRIPT, "DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
+            return true;
         }
     }
 
@@ -2134,8 +2633,7 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
     {
         auto const& scriptInfo = scriptInfoItr->second;
         ScriptAction sa(scripts.first, this, sourceGuid, targetGuid, ownerGuid, &scriptInfo);
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(scriptInfoItr->first), sa);
-        sScriptMgr.IncreaseScheduledScriptsCount();
+        m_scriptSchedule.Add(GetCurrentClockTime() + std::chrono::milliseconds(scriptInfoItr->first), sa);
     }
 
     return true;
@@ -2154,8 +2652,7 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 
     if (delay)
     {
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
-        sScriptMgr.IncreaseScheduledScriptsCount();
+        m_scriptSchedule.Add(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
     }
     else
         sa.HandleScriptStep();
@@ -2164,42 +2661,7 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
 /// Process queued scripts
 void Map::ScriptsProcess()
 {
-    if (m_scriptSchedule.empty())
-        return;
-
-    ///- Process overdue queued scripts
-    ScriptScheduleMap::iterator iter = m_scriptSchedule.begin();
-    // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= GetCurrentClockTime()))
-    {
-        if (iter->second.HandleScriptStep())
-        {
-            // Terminate following script steps of this script
-            const char* tableName = iter->second.GetTableName();
-            uint32 id = iter->second.GetId();
-            ObjectGuid sourceGuid = iter->second.GetSourceGuid();
-            ObjectGuid targetGuid = iter->second.GetTargetGuid();
-            ObjectGuid ownerGuid = iter->second.GetOwnerGuid();
-
-            for (ScriptScheduleMap::iterator rmItr = m_scriptSchedule.begin(); rmItr != m_scriptSchedule.end();)
-            {
-                if (rmItr->second.IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
-                {
-                    m_scriptSchedule.erase(rmItr++);
-                    sScriptMgr.DecreaseScheduledScriptCount();
-                }
-                else
-                    ++rmItr;
-            }
-        }
-        else
-        {
-            m_scriptSchedule.erase(iter);
-
-            sScriptMgr.DecreaseScheduledScriptCount();
-        }
-        iter = m_scriptSchedule.begin();
-    }
+    m_scriptSchedule.Process(GetCurrentClockTime());
 }
 
 /**
@@ -2295,6 +2757,177 @@ DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
  *
  * @param guid must be unit guid (HIGHGUID_PLAYER HIGHGUID_PET HIGHGUID_UNIT HIGHGUID_VEHICLE)
  */
+float Map::GetCrowdVisibilityDistance(uint32 zoneId) const
+{
+    if (m_crowdVisibilityDistance.empty())
+        return 0.0f;
+
+    auto itr = m_crowdVisibilityDistance.find(zoneId);
+    return itr != m_crowdVisibilityDistance.end() ? itr->second : 0.0f;
+}
+
+void Map::UpdateCrowdVisibility()
+{
+    if (!sWorld.HasCrowdVisibilityZones())
+    {
+        m_crowdVisibilityDistance.clear();
+        return;
+    }
+
+    std::unordered_map<uint32, uint32> zonePlayers;
+    for (auto& ref : m_mapRefManager)
+    {
+        Player* player = ref.getSource();
+        if (player && player->IsInWorld())
+            ++zonePlayers[player->GetZoneId()];
+    }
+
+    float const minDistance = std::min(sWorld.getConfig(CONFIG_FLOAT_CROWD_VISIBILITY_MIN_DISTANCE), GetVisibilityDistance());
+
+    // drop zones that emptied below their threshold
+    for (auto itr = m_crowdVisibilityDistance.begin(); itr != m_crowdVisibilityDistance.end();)
+    {
+        if (zonePlayers.find(itr->first) == zonePlayers.end())
+            itr = m_crowdVisibilityDistance.erase(itr);
+        else
+            ++itr;
+    }
+
+    for (auto const& zone : zonePlayers)
+    {
+        uint32 threshold = sWorld.GetCrowdVisibilityThreshold(zone.first);
+        if (!threshold)
+            continue;
+
+        auto current = m_crowdVisibilityDistance.find(zone.first);
+        float distance;
+        if (zone.second > threshold)
+        {
+            // the count of units seen grows with the square of the distance
+            distance = std::max(minDistance, GetVisibilityDistance() * sqrt(float(threshold) / float(zone.second)));
+
+            // skip small changes, every change makes clients create or destroy objects at the edge
+            if (current != m_crowdVisibilityDistance.end() && fabs(current->second - distance) < current->second * 0.1f)
+                continue;
+        }
+        // hysteresis, a reduced zone gets its full distance back only well under the threshold
+        else if (current == m_crowdVisibilityDistance.end() || zone.second * 5 > threshold * 4)
+            continue;
+        else
+            distance = 0.0f;
+
+        DETAIL_LOG("Map %u: visibility distance in crowded zone %u with %u players is now %.1f", GetId(), zone.first, zone.second, distance ? distance : GetVisibilityDistance());
+
+#ifdef BUILD_METRICS
+        metric::measurement meas("map.crowd_visibility", {
+            { "map_id", std::to_string(i_id) },
+            { "zone_id", std::to_string(zone.first) }
+        });
+        meas.add_field("players", std::to_string(zone.second));
+        meas.add_field("distance", std::to_string(distance ? distance : GetVisibilityDistance()));
+#endif
+
+        if (distance)
+            m_crowdVisibilityDistance[zone.first] = distance;
+        else
+            m_crowdVisibilityDistance.erase(current);
+    }
+}
+
+void Map::AddRelocatedUnit(Unit* unit)
+{
+    std::lock_guard<std::mutex> guard(m_relocatedUnitsLock);
+    m_relocatedUnits.push_back(unit->GetObjectGuid());
+    ++m_relocationCount;
+}
+
+void Map::UpdateRelocatedUnits(uint32 diff)
+{
+    m_relocationTimer.Update(diff);
+    if (!m_relocationTimer.Passed())
+        return;
+    m_relocationTimer.Reset();
+
+    GuidVector relocated;
+    uint32 relocationCount;
+    {
+        std::lock_guard<std::mutex> guard(m_relocatedUnitsLock);
+        relocated.swap(m_relocatedUnits);
+        relocationCount = m_relocationCount;
+        m_relocationCount = 0;
+    }
+
+    // a unit moving several times since the last batch gets a single visibility update
+    std::sort(relocated.begin(), relocated.end());
+    relocated.erase(std::unique(relocated.begin(), relocated.end()), relocated.end());
+
+    for (ObjectGuid const& guid : relocated)
+    {
+        // removed from the map since
+        Unit* unit = GetUnit(guid);
+        if (!unit || !unit->IsInWorld() || unit->GetMap() != this)
+            continue;
+
+        unit->UpdateVisibilityAfterRelocation();
+    }
+
+#ifdef BUILD_METRICS
+    if (relocationCount)
+    {
+        metric::measurement meas("map.relocations", {
+            { "map_id", std::to_string(i_id) },
+            { "instance_id", std::to_string(i_InstanceId) }
+        });
+        meas.add_field("queued", std::to_string(relocationCount));
+        meas.add_field("updated", std::to_string(relocated.size()));
+    }
+#endif
+}
+
+void Map::AddAINotifyUnit(Unit* unit)
+{
+    std::lock_guard<std::mutex> guard(m_aiNotifyUnitsLock);
+    m_aiNotifyUnits.push_back(unit->GetObjectGuid());
+}
+
+void Map::UpdateAINotifyUnits()
+{
+    GuidVector pending;
+    {
+        std::lock_guard<std::mutex> guard(m_aiNotifyUnitsLock);
+        pending.swap(m_aiNotifyUnits);
+    }
+
+    if (pending.empty())
+        return;
+
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    // in cell order, so that the walks of a crowded spot follow each other over the same cells
+    std::vector<std::pair<uint32, Unit*>> units;
+    units.reserve(pending.size());
+    for (ObjectGuid const& guid : pending)
+    {
+        // removed from the map since
+        Unit* unit = GetUnit(guid);
+        if (!unit || !unit->IsInWorld() || unit->GetMap() != this)
+            continue;
+
+        CellPair cell = MaNGOS::ComputeCellPair(unit->GetPositionX(), unit->GetPositionY());
+        units.emplace_back(cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cell.x_coord, unit);
+    }
+    std::stable_sort(units.begin(), units.end(), [](std::pair<uint32, Unit*> const& a, std::pair<uint32, Unit*> const& b) { return a.first < b.first; });
+
+    // a pair of units both due is evaluated by the walk of the first one only
+    GuidHashSet notified;
+    for (auto const& unit : units)
+    {
+        unit.second->VisitObjectsInRangeForAI(&notified);
+        notified.insert(unit.second->GetObjectGuid());
+    }
+}
+
 Unit* Map::GetUnit(ObjectGuid guid)
 {
     if (guid.IsPlayer())
@@ -2333,6 +2966,7 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
 void Map::SendObjectUpdates()
 {
     UpdateDataMapType update_players;
+    std::vector<Object*> coalescedObjects;
 
     while (!i_objectsToClientUpdate.empty())
     {
@@ -2343,8 +2977,30 @@ void Map::SendObjectUpdates()
         i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
 
         obj->BuildUpdateData(update_players);
+        if (obj->HasCoalescedValues())
+            coalescedObjects.push_back(obj);
     }
 
+    // held back fields still have to reach far observers once due, even if nothing changes meanwhile
+    for (Object* obj : coalescedObjects)
+        obj->MarkForClientUpdate();
+
+#ifdef BUILD_METRICS
+    ValuesUpdateCacheStats& cacheStats = Object::GetValuesUpdateCacheStats();
+    if (cacheStats.hits || cacheStats.misses)
+    {
+        metric::measurement meas("map.update.values_cache", {
+            { "map_id", std::to_string(i_id) },
+            { "instance_id", std::to_string(i_InstanceId) }
+        });
+        meas.add_field("hits", std::to_string(cacheStats.hits));
+        meas.add_field("misses", std::to_string(cacheStats.misses));
+        meas.add_field("saved_bytes", std::to_string(cacheStats.savedBytes));
+        meas.add_field("coalesced", std::to_string(cacheStats.coalesced));
+    }
+    cacheStats = ValuesUpdateCacheStats();
+#endif
+
     for (auto& update_player : update_players)
     {
 #ifdef ENABLE_PLAYERBOTS
@@ -2365,6 +3021,7 @@ void Map::SendObjectUpdates()
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
+    SharedContainersGuard guard(*this);
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
     switch (guidhigh)
     {
@@ -2385,6 +3042,34 @@ uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
     }
 }
 
+void Map::ReleaseLocalLowGuid(ObjectGuid const& guid)
+{
+    SharedContainersGuard guard(*this);
+    // static spawns keep their db guid, transports may still be referenced by their passengers
+    switch (guid.GetHigh())
+    {
+        case HIGHGUID_UNIT:
+            if (guid.GetCounter() >= sObjectMgr.GetFirstTemporaryCreatureLowGuid())
+                m_CreatureGuids.Release(guid.GetCounter());
+            break;
+        case HIGHGUID_GAMEOBJECT:
+            if (guid.GetCounter() >= sObjectMgr.GetFirstTemporaryGameObjectLowGuid())
+                m_GameObjectGuids.Release(guid.GetCounter());
+            break;
+        case HIGHGUID_DYNAMICOBJECT:
+            m_DynObjectGuids.Release(guid.GetCounter());
+            break;
+        case HIGHGUID_PET:
+            m_PetGuids.Release(guid.GetCounter());
+            break;
+        case HIGHGUID_VEHICLE:
+            m_VehicleGuids.Release(guid.GetCounter());
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * Helper structure for building static chat information
  *
@@ -2491,6 +3176,19 @@ bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float
            && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
 }
 
+void Map::IsInLineOfSightBatch(VMAP::LineOfSightQuery* queries, uint32 count, uint32 phasemask, bool ignoreM2Model) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSightBatch(GetId(), queries, count, ignoreM2Model);
+
+    // dynamic objects only for the segments not already blocked by the static ones
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery& query = queries[i];
+        if (query.result)
+            query.result = m_dyn_tree.isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, phasemask, ignoreM2Model);
+    }
+}
+
 /**
  * get the hit position and return true if we hit something (in this case the dest position will hold the hit-position)
  * otherwise the result pos will be the dest pos
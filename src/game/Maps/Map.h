@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "Platform/Define.h"
+#include "Util.h"
 #include "Policies/ThreadingModel.h"
 
 #include "Server/DBCStructure.h"
@@ -29,16 +30,25 @@
 #include "Entities/Object.h"
 #include "Globals/SharedDefines.h"
 #include "Maps/GridMap.h"
+#include "Maps/TerrainCache.h"
+#include "Maps/TriggerVolumeIndex.h"
 #include "GameSystem/GridRefManager.h"
+#include "Utilities/MemoryAccounting.h"
 #include "MapRefManager.h"
 #include "DBScripts/ScriptMgr.h"
+#include "DBScripts/ScriptSchedule.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Vmap/DynamicTree.h"
 #include "Multithreading/Messager.h"
+#include "World/TickProfiler.h"
+#include "Maps/PlayerSnapshot.h"
 
+#include <atomic>
 #include <bitset>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <shared_mutex>
 
 struct CreatureInfo;
 class Creature;
@@ -56,7 +66,12 @@ class GridMap;
 class GameObjectModel;
 class WeatherSystem;
 class GenericTransport;
+class SqlResultQueue;
+class PathRequestQueue;
+class SummonPool;
+struct MapMetrics;
 namespace MaNGOS { struct ObjectUpdater; }
+namespace VMAP { struct LineOfSightQuery; }
 class Transport;
 
 enum ContinentArea
@@ -157,6 +172,7 @@ class Map : public GridRefManager<NGridType>
         friend class MapReference;
         friend class ObjectGridLoader;
         friend class ObjectWorldLoader;
+        friend class GridCrawler;
 
     protected:
         Map(uint32 id, time_t, uint32 InstanceId, uint8 SpawnMode);
@@ -164,6 +180,9 @@ class Map : public GridRefManager<NGridType>
     public:
         virtual ~Map();
 
+        static void* operator new(size_t size) { return MemoryAccounting::Allocate(MEMORY_TAG_MAPS, size); }
+        static void operator delete(void* ptr, size_t size) { MemoryAccounting::Deallocate(MEMORY_TAG_MAPS, ptr, size); }
+
         // currently unused for normal maps
         bool CanUnload(uint32 diff)
         {
@@ -182,7 +201,7 @@ class Map : public GridRefManager<NGridType>
 
         static void DeleteFromWorld(Player* pl);        // player object will deleted at call
 
-        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor, std::vector<Cell>* cellsToCrawl = nullptr);
         virtual void Update(const uint32&);
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
@@ -193,6 +212,16 @@ class Map : public GridRefManager<NGridType>
         void MessageMapBroadcastZone(WorldObject const* obj, WorldPacket const& msg, uint32 zoneId);
         void MessageMapBroadcastArea(WorldObject const* obj, WorldPacket const& msg, uint32 areaId);
 
+        // movement packets of a mover are gathered during the session updates and sent to the players
+        // around it with one search per mover; other messages about the mover flush its packets first
+        void RelayMovement(WorldObject const* mover, Player const* skipped, WorldPacket const& msg);
+        void FlushMovementRelayOf(WorldObject const* mover)
+        {
+            if (!m_movementRelayIndex.empty())
+                FlushMovementRelay(mover->GetObjectGuid());
+        }
+        void FlushMovementRelays();
+
         void ExecuteDistWorker(WorldObject const* obj, float dist, std::function<void(Player*)> const& worker);
         void ExecuteMapWorker(std::function<void(Player*)> const& worker);
         void ExecuteMapWorkerZone(uint32 zoneId, std::function<void(Player*)> const& worker);
@@ -201,6 +230,10 @@ class Map : public GridRefManager<NGridType>
         float GetVisibilityDistance() const { return m_VisibleDistance; }
         // function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
+        // reduced visibility distance of crowded zones for units unimportant to the viewer, 0 when not reduced
+        float GetCrowdVisibilityDistance(uint32 zoneId) const;
+
+        StealthDetectionCache& GetStealthDetectionCache() { return m_stealthDetectionCache; }
 
         void PlayerRelocation(Player*, float x, float y, float z, float orientation);
         void CreatureRelocation(Creature* creature, float x, float y, float z, float ang);
@@ -334,21 +367,30 @@ class Map : public GridRefManager<NGridType>
         std::map<uint32, uint32>& GetTempCreatures() { return m_tempCreatures; }
         std::map<uint32, uint32>& GetTempPets() { return m_tempPets; }
 
+        // can be called from cell threads
         void AddUpdateObject(Object* obj)
         {
+            std::lock_guard<std::mutex> guard(m_objectsLock);
             i_objectsToClientUpdate.insert(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
+            std::lock_guard<std::mutex> guard(m_objectsLock);
             i_objectsToClientUpdate.erase(obj);
         }
 
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
+        // gives the low guid of a deleted temporary object back for late reuse
+        void ReleaseLocalLowGuid(ObjectGuid const& guid);
 
         // get corresponding TerrainData object for this particular map
         const TerrainInfo* GetTerrain() const { return m_TerrainData; }
+        // cached area and liquid queries of the terrain, map thread only
+        TerrainCache& GetTerrainCache() { return m_terrainCache; }
+        // traps and persistent area effects waiting for units to move into them
+        TriggerVolumeIndex& GetTriggerVolumes() { return m_triggerVolumes; }
 
         void CreateInstanceData(bool load);
         InstanceData* GetInstanceData() const { return i_data; }
@@ -362,6 +404,7 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool swim = false) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const;
+        void IsInLineOfSightBatch(VMAP::LineOfSightQuery* queries, uint32 count, uint32 phasemask, bool ignoreM2Model) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
@@ -407,8 +450,47 @@ class Map : public GridRefManager<NGridType>
 
         uint32 GetLoadedGridsCount();
 
+        // creatures updated and put asleep by CreatureIdleUpdateInterval, the counts are of the last update
+        void CountCreatureUpdate(bool asleep) { ++(asleep ? m_asleepCreatures : m_awakeCreatures); }
+        uint32 GetAwakeCreaturesCount() const { return m_lastAwakeCreatures; }
+        uint32 GetAsleepCreaturesCount() const { return m_lastAsleepCreatures; }
+
         Messager<Map>& GetMessager() { return m_messager; }
 
+        // async DB results for this map, processed at the start of each map update. queries started inside
+        // a SqlResultQueueScope on this queue call back from the map thread instead of the world thread
+        std::shared_ptr<SqlResultQueue> const& GetResultQueue() const { return m_resultQueue; }
+
+        // paths requested by movement generators during the update, solved together at its end
+        PathRequestQueue& GetPathRequestQueue() { return *m_pathRequestQueue; }
+
+        // memory of the deleted temporary summons, nullptr if not pooled
+        SummonPool* GetSummonPool() const { return m_summonPool.get(); }
+
+        // fields of the players of this map as of the end of its last update, readable from any thread
+        PlayerSnapshotTable const& GetPlayerSnapshots() const { return m_playerSnapshots; }
+
+        // units that moved past the relocation limit, their visibility is updated once after the object updates
+        void AddRelocatedUnit(Unit* unit);
+
+        // units whose AI notify is due, their grid walks are done together after the object updates
+        void AddAINotifyUnit(Unit* unit);
+
+        // duration of the last update of this map in microseconds, used to schedule the most expensive maps first
+        uint32 GetLastUpdateDuration() const { return m_lastUpdateDuration; }
+        void SetLastUpdateDuration(uint32 duration) { m_lastUpdateDuration = duration; }
+
+        // map updater thread of the last update, the next one is queued to it first so the map data stays in its caches
+        size_t GetLastUpdateThread() const { return m_lastUpdateThread; }
+        void SetLastUpdateThread(size_t thread) { m_lastUpdateThread = thread; }
+
+        // each map has its own update period, see MapUpdate.IdleInterval
+        uint32 GetUpdateInterval(uint32 baseInterval, uint32 idleInterval) const;
+        // add the manager tick time to the time elapsed since the last update of this map, return true if the map must be updated
+        bool AddPendingUpdateDiff(uint32 diff, uint32 baseInterval, uint32 idleInterval);
+        // time elapsed since the last update of this map, reset for the next update
+        uint32 TakePendingUpdateDiff() { uint32 diff = m_pendingUpdateDiff; m_pendingUpdateDiff = 0; return diff; }
+
         GenericTransport* GetTransport(ObjectGuid guid);
 
         void AddTransport(Transport* transport);
@@ -437,6 +519,8 @@ class Map : public GridRefManager<NGridType>
         void EnsureGridCreated(const GridPair&);
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
+        // loads the cells an unfinished unload of the grid already emptied, the grid is whole again
+        void LoadUnloadedCells(NGridType& grid);
 
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
@@ -456,6 +540,50 @@ class Map : public GridRefManager<NGridType>
         void SendObjectUpdates();
         std::set<Object*> i_objectsToClientUpdate;
 
+        // update objects of the given cells using cell threads, returns count of updated objects
+        uint64 UpdateCellsInParallel(std::vector<Cell> const& cells, uint32 diff);
+        // guards containers that can be filled by objects updated in cell threads
+        std::mutex m_objectsLock;
+
+        // true if updating the object may act on a unit farther than reach from it, such objects
+        // are updated by the map thread after the cell threads
+        bool ReachesBeyond(WorldObject const* object, float reach) const;
+
+        // marks the current thread as a cell thread of the map while in scope
+        class CellThreadScope
+        {
+            public:
+                explicit CellThreadScope(Map& map) : m_previous(s_cellThreadMap) { s_cellThreadMap = &map; }
+                ~CellThreadScope() { s_cellThreadMap = m_previous; }
+
+                CellThreadScope(CellThreadScope const&) = delete;
+                CellThreadScope& operator=(CellThreadScope const&) = delete;
+
+            private:
+                Map* m_previous;
+        };
+
+        // changes to containers shared by all cells (grids, objects store, active objects, guid
+        // generators) are made with the map held exclusively when called from a cell thread,
+        // no-op on the map thread which never runs alongside the cell threads
+        class SharedContainersGuard
+        {
+            public:
+                explicit SharedContainersGuard(Map& map);
+                ~SharedContainersGuard();
+
+                SharedContainersGuard(SharedContainersGuard const&) = delete;
+                SharedContainersGuard& operator=(SharedContainersGuard const&) = delete;
+
+            private:
+                Map* m_map;                                 // set when constructed on a cell thread of the map
+        };
+
+        // cell threads hold it shared while they update an object
+        std::shared_timed_mutex m_sharedContainersLock;
+        static thread_local Map* s_cellThreadMap;
+        static thread_local uint32 s_exclusiveDepth;       // nested guards of the current cell thread
+
     protected:
         MapEntry const* i_mapEntry;
         uint8 i_spawnMode;
@@ -479,32 +607,41 @@ class Map : public GridRefManager<NGridType>
         WorldObjectSet::iterator m_onEventNotifiedIter;
 
         Messager<Map> m_messager;
+        std::shared_ptr<SqlResultQueue> m_resultQueue;
+        std::unique_ptr<PathRequestQueue> m_pathRequestQueue;
+        std::shared_ptr<SummonPool> m_summonPool;           // shared with the summons allocated from it
+        PlayerSnapshotTable m_playerSnapshots;
+#ifdef BUILD_METRICS
+        std::unique_ptr<MapMetrics> m_metrics;              // registered once, sampled every update
+#endif
     private:
         time_t i_gridExpiry;
+        uint32 m_gridUnloadTime;                            // ms spent on emptying grid cells in the current update
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         // Shared geodata object with map coord info...
         TerrainInfo* const m_TerrainData;
+        TerrainCache m_terrainCache;
+        TriggerVolumeIndex m_triggerVolumes;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
 
         WorldObjectSet i_objectsToRemove;
 
-        typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
-        ScriptScheduleMap m_scriptSchedule;
+        ScriptSchedule m_scriptSchedule;
 
         InstanceData* i_data;
         uint32 i_script_id;
 
         // Map local low guid counters
-        ObjectGuidGenerator<HIGHGUID_UNIT> m_CreatureGuids;
-        ObjectGuidGenerator<HIGHGUID_GAMEOBJECT> m_GameObjectGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_UNIT> m_CreatureGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_GAMEOBJECT> m_GameObjectGuids;
         ObjectGuidGenerator<HIGHGUID_TRANSPORT> m_transportGuids;
-        ObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT> m_DynObjectGuids;
-        ObjectGuidGenerator<HIGHGUID_PET> m_PetGuids;
-        ObjectGuidGenerator<HIGHGUID_VEHICLE> m_VehicleGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_DYNAMICOBJECT> m_DynObjectGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_PET> m_PetGuids;
+        LeasedObjectGuidGenerator<HIGHGUID_VEHICLE> m_VehicleGuids;
 
         // Type specific code for add/remove to/from grid
         template<class T>
@@ -533,6 +670,51 @@ class Map : public GridRefManager<NGridType>
 
         std::vector<ContinentArea> m_activeAreas;
         uint32 m_activeAreasTimer;
+        ShortIntervalTimer m_terrainPrefetchTimer;
+
+        void UpdateRelocatedUnits(uint32 diff);
+        void UpdateAINotifyUnits();
+        void UpdateCrowdVisibility();
+
+        std::unordered_map<uint32, float> m_crowdVisibilityDistance;    // zone id to reduced distance
+        ShortIntervalTimer m_crowdVisibilityTimer;
+
+        StealthDetectionCache m_stealthDetectionCache;
+        ShortIntervalTimer m_stealthDetectionCacheTimer;
+
+        std::atomic<uint32> m_awakeCreatures;               // counted during the update, also by the cell threads
+        std::atomic<uint32> m_asleepCreatures;
+        uint32 m_lastAwakeCreatures;
+        uint32 m_lastAsleepCreatures;
+
+        std::mutex m_relocatedUnitsLock;                    // object updates may run on the cell threads
+        GuidVector m_relocatedUnits;
+        uint32 m_relocationCount;                           // relocations queued since the last batch
+        ShortIntervalTimer m_relocationTimer;
+
+        std::mutex m_aiNotifyUnitsLock;                     // object updates may run on the cell threads
+        GuidVector m_aiNotifyUnits;
+
+        struct MovementRelay
+        {
+            ObjectGuid mover;
+            ObjectGuid skipped;
+            std::vector<std::shared_ptr<WorldPacket const>> packets;
+        };
+
+        void FlushMovementRelay(ObjectGuid const& moverGuid);
+        void SendMovementRelay(MovementRelay& relay);
+
+        bool m_gatherMovementRelays;                        // only during the session updates, sent at once otherwise
+        std::vector<MovementRelay> m_movementRelays;
+        std::unordered_map<ObjectGuid, size_t> m_movementRelayIndex;
+
+        uint32 m_lastUpdateDuration;
+        size_t m_lastUpdateThread;
+        uint32 m_pendingUpdateDiff;
+
+        TickProfile m_tickProfile;                          // phases of Update while TickProfile.Enable is set
+        std::unique_ptr<RandomEngine> m_random;             // rolls of Update while Debug.RandomSeed is set
 
 #ifdef ENABLE_PLAYERBOTS
         bool hasRealPlayers;
@@ -575,6 +757,11 @@ class DungeonMap : public Map
 
         virtual void InitVisibilityDistance() override;
     private:
+        // delay of the unload once the last player left, hibernating maps go earlier
+        static uint32 GetEmptyUnloadDelay();
+        // keeps the dynamic state in the persistent state for a fast resume after the unload
+        void Hibernate();
+
         bool m_resetAfterUnload;
         bool m_unloadWhenEmpty;
         Team m_team;
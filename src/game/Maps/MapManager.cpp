@@ -27,14 +27,18 @@
 #include "Grids/CellImpl.h"
 #include "Globals/ObjectMgr.h"
 #include "Maps/MapWorkers.h"
+#include <algorithm>
 #include <future>
 
+// percent of an even share of the tick a map update thread may get before its maps are moved to another
+#define MAP_AFFINITY_MAX_IMBALANCE 125
+
 #define CLASS_LOCK MaNGOS::ClassLevelLockable<MapManager, std::recursive_mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), m_numCellThreads(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -55,6 +59,15 @@ void MapManager::Initialize()
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS));
     if (num_threads > 0)
         m_updater.activate(num_threads);
+
+    m_numCellThreads = sWorld.getConfig(CONFIG_UINT32_NUM_CELL_THREADS);
+    if (m_numCellThreads > 0)
+        m_cellUpdater.activate(m_numCellThreads);
+
+    if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_PREFETCH))
+        m_terrainPrefetcher.activate();
+
+    PrewarmDungeons();
 }
 
 void MapManager::InitStateMachine()
@@ -82,6 +95,54 @@ void MapManager::UpdateGridState(grid_state_t state, Map& map, NGridType& ngrid,
     si_GridStates[state]->Update(map, ngrid, ginfo, x, y, t_diff);
 }
 
+void MapManager::PrewarmDungeons()
+{
+    std::vector<TerrainInfo*> terrains;
+    for (uint32 mapId : sWorld.GetPrewarmDungeonIds())
+    {
+        MapEntry const* entry = sMapStore.LookupEntry(mapId);
+        if (!entry || !entry->IsDungeon() || !ObjectMgr::GetInstanceTemplate(mapId))
+        {
+            sLog.outError("Instance.PrewarmMaps: map %u is not a dungeon with an instance template, skipped", mapId);
+            continue;
+        }
+
+        // the reference is never released, so the terrain outlives the last instance of the map
+        TerrainInfo* terrain = sTerrainMgr.LoadTerrain(mapId);
+        terrain->AddRef();
+        terrains.push_back(terrain);
+    }
+
+    if (terrains.empty())
+        return;
+
+    // no map uses these grids yet, the instances created meanwhile load them as usual
+    m_prewarmTask = std::async(std::launch::async, [terrains]()
+    {
+        for (TerrainInfo* terrain : terrains)
+        {
+            uint32 loaded = 0;
+            for (uint32 x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
+            {
+                for (uint32 y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
+                {
+                    char mapFile[32];
+                    snprintf(mapFile, sizeof(mapFile), "maps/%03u%02u%02u.map", terrain->GetMapId(), x, y);
+                    std::string const fileName = sWorld.GetDataPath() + mapFile;
+                    if (FILE* file = fopen(fileName.c_str(), "rb"))
+                    {
+                        fclose(file);
+                        // the grid reference is kept as well, GridMap objects without one are cleaned up
+                        terrain->Load(x, y);
+                        ++loaded;
+                    }
+                }
+            }
+            DETAIL_LOG("MapManager::PrewarmDungeons: %u grids of map %u loaded", loaded, terrain->GetMapId());
+        }
+    });
+}
+
 void MapManager::InitializeVisibilityDistanceInfo()
 {
     for (auto& i_map : i_maps)
@@ -109,8 +170,6 @@ void MapManager::CreateContinents()
 /// @param id - MapId of the to be created map. @param obj WorldObject for which the map is to be created. Must be player for Instancable maps.
 Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
 {
-    Guard _guard(*this);
-
     Map* m = nullptr;
 
     const MapEntry* entry = sMapStore.LookupEntry(id);
@@ -120,11 +179,13 @@ Map* MapManager::CreateMap(uint32 id, const WorldObject* obj)
     if (entry->Instanceable())
     {
         MANGOS_ASSERT(obj && obj->GetTypeId() == TYPEID_PLAYER);
-        // create DungeonMap object
+        // create DungeonMap object, locks only what is shared
         m = CreateInstance(id, (Player*)obj);
     }
     else
     {
+        Guard _guard(*this);
+
         // create regular non-instanceable map
         m = FindMap(id);
         if (m == nullptr)
@@ -192,16 +253,52 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    // select maps whose own update interval has passed
+    uint32 const baseInterval = uint32(i_timer.GetInterval());
+    uint32 const idleInterval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE);
+    std::vector<Map*> maps;
+    maps.reserve(i_maps.size());
     for (auto& map : i_maps)
-    {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
-            map.second->Update((uint32)i_timer.GetCurrent());
-    }
+        if (map.second->AddPendingUpdateDiff((uint32)i_timer.GetCurrent(), baseInterval, idleInterval))
+            maps.push_back(map.second);
 
     if (m_updater.activated())
+    {
+        // schedule the most expensive maps first so they don't end up starting last on a busy thread
+
+        std::stable_sort(maps.begin(), maps.end(), [](Map const* left, Map const* right)
+        {
+            return left->GetLastUpdateDuration() > right->GetLastUpdateDuration();
+        });
+
+        // a map stays on the thread of its last update, so its data is still in that core's caches, unless the
+        // thread would get too far above an even share of the tick; then it goes to the least loaded thread.
+        // the first map of a thread always stays, a map heavier than a share can't be helped by moving it.
+        // durations are counted from 1 so that maps never updated yet are spread too
+        uint64 totalLoad = 0;
+        for (Map const* map : maps)
+            totalLoad += map->GetLastUpdateDuration() + 1;
+        uint64 const maxLoad = totalLoad * MAP_AFFINITY_MAX_IMBALANCE / (100 * m_updater.GetThreadCount());
+
+        std::vector<uint64> threadLoads(m_updater.GetThreadCount(), 0);
+        for (Map* map : maps)
+        {
+            uint64 const load = map->GetLastUpdateDuration() + 1;
+            size_t thread = map->GetLastUpdateThread();
+            if (thread >= threadLoads.size() || (threadLoads[thread] && threadLoads[thread] + load > maxLoad))
+                thread = std::min_element(threadLoads.begin(), threadLoads.end()) - threadLoads.begin();
+            threadLoads[thread] += load;
+
+            m_updater.schedule_update(new MapUpdateWorker(*map, map->TakePendingUpdateDiff(), m_updater), thread);
+        }
+
         m_updater.wait();
+    }
+    else
+    {
+        for (Map* map : maps)
+            map->Update(map->TakePendingUpdateDiff());
+    }
 
     // remove all maps which can be unloaded
     MapMapType::iterator iter = i_maps.begin();
@@ -260,6 +357,14 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (m_cellUpdater.activated())
+        m_cellUpdater.deactivate();
+
+    m_terrainPrefetcher.deactivate();
+
+    if (m_prewarmTask.valid())
+        m_prewarmTask.wait();
+
     TerrainManager::Instance().UnloadAll();
 }
 
@@ -295,7 +400,6 @@ uint32 MapManager::GetNumPlayersInInstances()
 Map* MapManager::CreateInstance(uint32 id, Player* player)
 {
     Map* map = nullptr;
-    Map* pNewMap = nullptr;
     uint32 NewInstanceId = 0;                               // instanceId of the resulting map
     const MapEntry* entry = sMapStore.LookupEntry(id);
 
@@ -309,12 +413,17 @@ Map* MapManager::CreateInstance(uint32 id, Player* player)
     }
     else if (DungeonPersistentState* pSave = player->GetBoundInstanceSaveForSelfOrGroup(id))
     {
-        // solo/perm/group
+        // solo/perm/group, other players bound to the save may ask for the same map
+        Guard _guard(*this);
+
         NewInstanceId = pSave->GetInstanceId();
         map = FindMap(id, NewInstanceId);
         // it is possible that the save exists but the map doesn't
         if (!map)
-            pNewMap = CreateDungeonMap(id, NewInstanceId, pSave->GetDifficulty(), pSave, player->GetTeam());
+        {
+            map = CreateDungeonMap(id, NewInstanceId, pSave->GetDifficulty(), pSave, player->GetTeam());
+            i_maps[MapID(id, NewInstanceId)] = map;
+        }
     }
     else
     {
@@ -322,15 +431,12 @@ Map* MapManager::CreateInstance(uint32 id, Player* player)
         // the instance will be created for the first time
         NewInstanceId = sObjectMgr.GenerateInstanceLowGuid();
 
+        // nobody else knows the new instance id, so the map is built unlocked and only its registration is locked
         Difficulty diff = player->GetGroup() ? player->GetGroup()->GetDifficulty(entry->IsRaid()) : player->GetDifficulty(entry->IsRaid());
-        pNewMap = CreateDungeonMap(id, NewInstanceId, diff, nullptr, player->GetTeam());
-    }
+        map = CreateDungeonMap(id, NewInstanceId, diff, nullptr, player->GetTeam());
 
-    // add a new map object into the registry
-    if (pNewMap)
-    {
-        i_maps[MapID(id, NewInstanceId)] = pNewMap;
-        map = pNewMap;
+        Guard _guard(*this);
+        i_maps[MapID(id, NewInstanceId)] = map;
     }
 
     return map;
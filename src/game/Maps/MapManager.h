@@ -26,8 +26,10 @@
 #include "Maps/Map.h"
 #include "Grids/GridStates.h"
 #include "Maps/MapUpdater.h"
+#include "Maps/TerrainPrefetcher.h"
 
 #include <functional>
+#include <future>
 
 class Transport;
 class BattleGround;
@@ -155,6 +157,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void DoForAllMaps(const std::function<void(Map*)>& worker);
         void DoForAllMapsWithMapId(uint32 mapId, std::function<void(Map*)> worker);
 
+        // threads used to split the update of a single map between its active cells (see MapUpdate.CellThreads)
+        MapUpdater& GetCellUpdater() { return m_cellUpdater; }
+        MapUpdater& GetMapUpdater() { return m_updater; }
+        uint32 GetNumCellThreads() const { return m_numCellThreads; }
+        TerrainPrefetcher& GetTerrainPrefetcher() { return m_terrainPrefetcher; }
+
     private:
 
         // debugging code, should be deleted some day
@@ -171,6 +179,7 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void InitStateMachine();
         void DeleteStateMachine();
+        void PrewarmDungeons();
 
         Map* CreateInstance(uint32 id, Player* player);
         DungeonMap* CreateDungeonMap(uint32 id, uint32 InstanceId, Difficulty difficulty, DungeonPersistentState* save, Team ownerTeam);
@@ -182,6 +191,10 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         IntervalTimer i_timer;
 
         MapUpdater m_updater;
+        MapUpdater m_cellUpdater;
+        TerrainPrefetcher m_terrainPrefetcher;
+        uint32 m_numCellThreads;
+        std::future<void> m_prewarmTask;                    // loads the terrain of Instance.PrewarmMaps
 };
 
 template<typename Do>
@@ -45,7 +45,7 @@ static uint32 resetEventTypeDelay[MAX_RESET_EVENT_TYPE] = { 0,
 //== MapPersistentState functions ==========================
 MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId, Difficulty difficulty)
     : m_instanceid(InstanceId), m_mapid(MapId),
-      m_difficulty(difficulty), m_usedByMap(nullptr)
+      m_difficulty(difficulty), m_usedByMap(nullptr), m_nextRespawnTimesSave(0)
 {
 }
 
@@ -77,21 +77,11 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
-    CharacterDatabase.BeginTransaction();
-
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM creature_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
+    m_creatureRespawnTimesToSave[loguid] = t;
 
-    if (t > sWorld.GetGameTime())
-    {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO creature_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
-    }
-
-    CharacterDatabase.CommitTransaction();
+    // without a map no update writes them later
+    if (!m_usedByMap)
+        SaveRespawnTimesToDB();
 }
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
@@ -102,27 +92,89 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
+    m_goRespawnTimesToSave[loguid] = t;
+
+    // without a map no update writes them later
+    if (!m_usedByMap)
+        SaveRespawnTimesToDB();
+}
+
+void MapPersistentState::SaveRespawnTimesToDB()
+{
+    if (m_creatureRespawnTimesToSave.empty() && m_goRespawnTimesToSave.empty())
+        return;
+
+    static SqlStatementID delCreatureSpawnTime;
+    static SqlStatementID insCreatureSpawnTime;
+    static SqlStatementID delGOSpawnTime;
+    static SqlStatementID insGOSpawnTime;
+
+    time_t const now = sWorld.GetGameTime();
+
     CharacterDatabase.BeginTransaction();
 
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
+    for (auto& itr : m_creatureRespawnTimesToSave)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delCreatureSpawnTime, "DELETE FROM creature_respawn WHERE guid = ? AND instance = ?");
+        stmt.PExecute(itr.first, m_instanceid);
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM gameobject_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
+        if (itr.second > now)
+        {
+            stmt = CharacterDatabase.CreateStatement(insCreatureSpawnTime, "INSERT INTO creature_respawn VALUES ( ?, ?, ? )");
+            stmt.PExecute(itr.first, uint64(itr.second), m_instanceid);
+        }
+    }
 
-    if (t > sWorld.GetGameTime())
+    for (auto& itr : m_goRespawnTimesToSave)
     {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO gameobject_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delGOSpawnTime, "DELETE FROM gameobject_respawn WHERE guid = ? AND instance = ?");
+        stmt.PExecute(itr.first, m_instanceid);
+
+        if (itr.second > now)
+        {
+            stmt = CharacterDatabase.CreateStatement(insGOSpawnTime, "INSERT INTO gameobject_respawn VALUES ( ?, ?, ? )");
+            stmt.PExecute(itr.first, uint64(itr.second), m_instanceid);
+        }
     }
 
     CharacterDatabase.CommitTransaction();
+
+    m_creatureRespawnTimesToSave.clear();
+    m_goRespawnTimesToSave.clear();
+}
+
+void MapPersistentState::Update(time_t now)
+{
+    // only the due respawn times, also of the objects in unloaded grids; the loaded objects keep their own timers
+    while (!m_respawnQueue.empty() && m_respawnQueue.top().respawnTime <= now)
+    {
+        RespawnQueueEntry const entry = m_respawnQueue.top();
+        m_respawnQueue.pop();
+
+        RespawnTimes& respawnTimes = entry.isGameObject ? m_goRespawnTimes : m_creatureRespawnTimes;
+        RespawnTimes::iterator itr = respawnTimes.find(entry.loguid);
+        if (itr == respawnTimes.end() || itr->second != entry.respawnTime)
+            continue;                                       // respawned or died again since
+
+        respawnTimes.erase(itr);
+        if (!GetMapEntry()->IsBattleGroundOrArena())
+            (entry.isGameObject ? m_goRespawnTimesToSave : m_creatureRespawnTimesToSave)[entry.loguid] = 0;
+    }
+
+    if (now >= m_nextRespawnTimesSave)
+    {
+        SaveRespawnTimesToDB();
+        m_nextRespawnTimesSave = now + RESPAWN_TIMES_SAVE_INTERVAL;
+    }
 }
 
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
+    {
         m_creatureRespawnTimes[loguid] = t;
+        m_respawnQueue.push({ t, loguid, false });
+    }
     else
     {
         m_creatureRespawnTimes.erase(loguid);
@@ -133,7 +185,10 @@ void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 void MapPersistentState::SetGORespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
+    {
         m_goRespawnTimes[loguid] = t;
+        m_respawnQueue.push({ t, loguid, true });
+    }
     else
     {
         m_goRespawnTimes.erase(loguid);
@@ -145,6 +200,9 @@ void MapPersistentState::ClearRespawnTimes()
 {
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
+    m_respawnQueue = RespawnQueue();
+    m_creatureRespawnTimesToSave.clear();
+    m_goRespawnTimesToSave.clear();
 
     UnloadIfEmpty();
 }
@@ -205,7 +263,8 @@ bool WorldPersistentState::CanBeUnload() const
 //== DungeonPersistentState functions =====================
 
 DungeonPersistentState::DungeonPersistentState(uint16 MapId, uint32 InstanceId, Difficulty difficulty, time_t resetTime, bool canReset, uint32 completedEncountersMask)
-    : MapPersistentState(MapId, InstanceId, difficulty), m_resetTime(resetTime), m_canReset(canReset), m_completedEncountersMask(completedEncountersMask)
+    : MapPersistentState(MapId, InstanceId, difficulty), m_resetTime(resetTime), m_canReset(canReset), m_completedEncountersMask(completedEncountersMask),
+      m_hasHibernatedInstanceData(false)
 {
 }
 
@@ -245,10 +304,9 @@ void DungeonPersistentState::SaveToDB()
 
     if (Map* map = GetMap())
     {
-        InstanceData* iData = map->GetInstanceData();
-        if (iData && iData->Save())
+        if (InstanceData* iData = map->GetInstanceData())
         {
-            data = iData->Save();
+            data = iData->GetSaveData();
             CharacterDatabase.escape_string(data);
         }
     }
@@ -256,8 +314,39 @@ void DungeonPersistentState::SaveToDB()
     CharacterDatabase.PExecute("INSERT INTO instance VALUES ('%u', '%u', '" UI64FMTD "', '%u', '%u', '%s')", GetInstanceId(), GetMapId(), (uint64)GetResetTimeForDB(), GetDifficulty(), GetCompletedEncountersMask(), data.c_str());
 }
 
+bool DungeonPersistentState::TakeHibernatedInstanceData(std::string& data)
+{
+    if (!m_hasHibernatedInstanceData)
+        return false;
+
+    data.swap(m_hibernatedInstanceData);
+    m_hibernatedInstanceData.clear();
+    m_hasHibernatedInstanceData = false;
+    return true;
+}
+
+bool DungeonPersistentState::TakeHibernatedGoState(uint32 dbGuid, GOState& state)
+{
+    auto itr = m_hibernatedGoStates.find(dbGuid);
+    if (itr == m_hibernatedGoStates.end())
+        return false;
+
+    state = GOState(itr->second);
+    m_hibernatedGoStates.erase(itr);
+    return true;
+}
+
+void DungeonPersistentState::ClearHibernation()
+{
+    m_hasHibernatedInstanceData = false;
+    m_hibernatedInstanceData.clear();
+    m_hibernatedGoStates.clear();
+}
+
 void DungeonPersistentState::DeleteRespawnTimes()
 {
+    ClearHibernation();
+
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", GetInstanceId());
     CharacterDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", GetInstanceId());
@@ -425,6 +514,7 @@ void DungeonResetScheduler::LoadResetTimes()
         result = CharacterDatabase.Query("SELECT MAX(respawntime), instance FROM creature_respawn WHERE instance > 0 GROUP BY instance");
         if (result)
         {
+            bool changed = false;
             do
             {
                 Field* fields = result->Fetch();
@@ -435,12 +525,17 @@ void DungeonResetScheduler::LoadResetTimes()
                 InstResetTimeMapDiffType::iterator itr = instResetTime.find(instance);
                 if (itr != instResetTime.end() && itr->second.second != resettime)
                 {
-                    CharacterDatabase.DirectPExecute("UPDATE instance SET resettime = '" UI64FMTD "' WHERE id = '%u'", uint64(resettime), instance);
                     itr->second.second = resettime;
+                    changed = true;
                 }
             }
             while (result->NextRow());
             delete result;
+
+            // the same times for all changed rows at once
+            if (changed)
+                CharacterDatabase.DirectPExecute("UPDATE instance JOIN (SELECT instance, MAX(respawntime) + %u AS resettime FROM creature_respawn WHERE instance > 0 GROUP BY instance) AS respawn "
+                                                 "ON instance.id = respawn.instance SET instance.resettime = respawn.resettime WHERE instance.resettime > 0", uint32(2 * HOUR));
         }
 
         // schedule the reset times
@@ -772,37 +867,6 @@ void MapPersistentStateManager::RemovePersistentState(uint32 mapId, uint32 insta
     }
 }
 
-void MapPersistentStateManager::_DelHelper(DatabaseType& db, const char* fields, const char* table, const char* queryTail, ...) const
-{
-    Tokens fieldTokens = StrSplit(fields, ", ");
-    MANGOS_ASSERT(!fieldTokens.empty());
-
-    va_list ap;
-    char szQueryTail [MAX_QUERY_LEN];
-    va_start(ap, queryTail);
-    vsnprintf(szQueryTail, MAX_QUERY_LEN, queryTail, ap);
-    va_end(ap);
-
-    QueryResult* result = db.PQuery("SELECT %s FROM %s %s", fields, table, szQueryTail);
-    if (result)
-    {
-        do
-        {
-            Field* resultFields = result->Fetch();
-            std::ostringstream ss;
-            for (size_t i = 0; i < fieldTokens.size(); ++i)
-            {
-                std::string fieldValue = resultFields[i].GetCppString();
-                db.escape_string(fieldValue);
-                ss << (i != 0 ? " AND " : "") << fieldTokens[i] << " = '" << fieldValue << "'";
-            }
-            db.PExecute("DELETE FROM %s WHERE %s", table, ss.str().c_str());
-        }
-        while (result->NextRow());
-        delete result;
-    }
-}
-
 void MapPersistentStateManager::CleanupInstances()
 {
     BarGoLink bar(2);
@@ -811,21 +875,22 @@ void MapPersistentStateManager::CleanupInstances()
     // load reset times and clean expired instances
     m_Scheduler.LoadResetTimes();
 
+    // every cleanup is one multi-table delete, the rows are not fetched to the server
     CharacterDatabase.BeginTransaction();
     // clean character/group - instance binds with invalid group/characters
-    _DelHelper(CharacterDatabase, "character_instance.guid, instance", "character_instance", "LEFT JOIN characters ON character_instance.guid = characters.guid WHERE characters.guid IS NULL");
-    _DelHelper(CharacterDatabase, "group_instance.leaderGuid, instance", "group_instance", "LEFT JOIN characters ON group_instance.leaderGuid = characters.guid LEFT JOIN `groups` ON group_instance.leaderGuid = `groups`.leaderGuid WHERE characters.guid IS NULL OR `groups`.leaderGuid IS NULL");
+    CharacterDatabase.Execute("DELETE character_instance FROM character_instance LEFT JOIN characters ON character_instance.guid = characters.guid WHERE characters.guid IS NULL");
+    CharacterDatabase.Execute("DELETE group_instance FROM group_instance LEFT JOIN characters ON group_instance.leaderGuid = characters.guid LEFT JOIN `groups` ON group_instance.leaderGuid = `groups`.leaderGuid WHERE characters.guid IS NULL OR `groups`.leaderGuid IS NULL");
 
     // clean instances that do not have any players or groups bound to them
-    _DelHelper(CharacterDatabase, "id, map, difficulty", "instance", "LEFT JOIN character_instance ON character_instance.instance = id LEFT JOIN group_instance ON group_instance.instance = id WHERE character_instance.instance IS NULL AND group_instance.instance IS NULL");
+    CharacterDatabase.Execute("DELETE instance FROM instance LEFT JOIN character_instance ON character_instance.instance = instance.id LEFT JOIN group_instance ON group_instance.instance = instance.id WHERE character_instance.instance IS NULL AND group_instance.instance IS NULL");
 
     // clean invalid instance references in other tables
-    _DelHelper(CharacterDatabase, "character_instance.guid, instance", "character_instance", "LEFT JOIN instance ON character_instance.instance = instance.id WHERE instance.id IS NULL");
-    _DelHelper(CharacterDatabase, "group_instance.leaderGuid, instance", "group_instance", "LEFT JOIN instance ON group_instance.instance = instance.id WHERE instance.id IS NULL");
+    CharacterDatabase.Execute("DELETE character_instance FROM character_instance LEFT JOIN instance ON character_instance.instance = instance.id WHERE instance.id IS NULL");
+    CharacterDatabase.Execute("DELETE group_instance FROM group_instance LEFT JOIN instance ON group_instance.instance = instance.id WHERE instance.id IS NULL");
 
     // clean unused respawn data
-    CharacterDatabase.Execute("DELETE FROM creature_respawn WHERE instance <> 0 AND instance NOT IN (SELECT id FROM instance)");
-    CharacterDatabase.Execute("DELETE FROM gameobject_respawn WHERE instance <> 0 AND instance NOT IN (SELECT id FROM instance)");
+    CharacterDatabase.Execute("DELETE creature_respawn FROM creature_respawn LEFT JOIN instance ON creature_respawn.instance = instance.id WHERE creature_respawn.instance <> 0 AND instance.id IS NULL");
+    CharacterDatabase.Execute("DELETE gameobject_respawn FROM gameobject_respawn LEFT JOIN instance ON gameobject_respawn.instance = instance.id WHERE gameobject_respawn.instance <> 0 AND instance.id IS NULL");
     // execute transaction directly
     CharacterDatabase.CommitTransaction();
 
@@ -838,52 +903,78 @@ void MapPersistentStateManager::CleanupInstances()
 void MapPersistentStateManager::PackInstances() const
 {
     // this routine renumbers player instance associations in such a way so they start from 1 and go up
-    // TODO: this can be done a LOT more efficiently
-
-    // obtain set of all associations
-    std::set<uint32> InstanceSet;
 
     // all valid ids are in the instance table
     // any associations to ids not in this table are assumed to be
     // cleaned already in CleanupInstances
-    QueryResult* result = CharacterDatabase.Query("SELECT id FROM instance");
+    std::vector<uint32> instanceIds;
+    QueryResult* result = CharacterDatabase.Query("SELECT id FROM instance ORDER BY id");
     if (result)
     {
+        instanceIds.reserve(result->GetRowCount());
         do
         {
             Field* fields = result->Fetch();
-            InstanceSet.insert(fields[0].GetUInt32());
+            instanceIds.push_back(fields[0].GetUInt32());
         }
         while (result->NextRow());
         delete result;
     }
 
-    BarGoLink bar(InstanceSet.size() + 1);
+    BarGoLink bar(1);
     bar.step();
 
-    uint32 InstanceNumber = 1;
-    // we do assume std::set is sorted properly on integer value
-    for (uint32 i : InstanceSet)
+    // the ids keep their order, so once one id moves all following ones do
+    size_t firstMoved = 0;
+    while (firstMoved < instanceIds.size() && instanceIds[firstMoved] == firstMoved + 1)
+        ++firstMoved;
+
+    uint32 nextInstanceId = uint32(instanceIds.size()) + 1;
+    if (firstMoved == instanceIds.size())
     {
-        if (i != InstanceNumber)
-        {
-            CharacterDatabase.BeginTransaction();
-            // remap instance id
-            CharacterDatabase.PExecute("UPDATE creature_respawn SET instance = '%u' WHERE instance = '%u'", InstanceNumber, i);
-            CharacterDatabase.PExecute("UPDATE gameobject_respawn SET instance = '%u' WHERE instance = '%u'", InstanceNumber, i);
-            CharacterDatabase.PExecute("UPDATE corpse SET instance = '%u' WHERE instance = '%u'", InstanceNumber, i);
-            CharacterDatabase.PExecute("UPDATE character_instance SET instance = '%u' WHERE instance = '%u'", InstanceNumber, i);
-            CharacterDatabase.PExecute("UPDATE instance SET id = '%u' WHERE id = '%u'", InstanceNumber, i);
-            CharacterDatabase.PExecute("UPDATE group_instance SET instance = '%u' WHERE instance = '%u'", InstanceNumber, i);
-            // execute transaction synchronously
-            CharacterDatabase.CommitTransaction();
-        }
+        sLog.outString(">> Instance numbers are packed, next instance id is %u", nextInstanceId);
+        sLog.outString();
+        return;
+    }
 
-        ++InstanceNumber;
-        bar.step();
+    // the remap rows go to a temporary table of the transaction connection and every table is updated
+    // by one join; a new id can still be the old id of another moved row of the same key, so the ids
+    // are first moved above all old ids and then down by the same offset
+    uint32 const offset = instanceIds.back();
+    uint32 const insertRows = 1000;
+
+    static char const* const instanceColumns[][2] =
+    {
+        { "creature_respawn",   "instance" },
+        { "gameobject_respawn", "instance" },
+        { "corpse",             "instance" },
+        { "character_instance", "instance" },
+        { "group_instance",     "instance" },
+        { "instance",           "id"       },
+    };
+
+    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.Execute("CREATE TEMPORARY TABLE instance_remap (old_id INT UNSIGNED NOT NULL PRIMARY KEY, new_id INT UNSIGNED NOT NULL) ENGINE=MEMORY");
+    for (size_t i = firstMoved; i < instanceIds.size(); i += insertRows)
+    {
+        std::ostringstream ss;
+        ss << "INSERT INTO instance_remap (old_id, new_id) VALUES ";
+        for (size_t j = i; j < instanceIds.size() && j < i + insertRows; ++j)
+            ss << (j != i ? "," : "") << "(" << instanceIds[j] << "," << (j + 1) << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
     }
 
-    sLog.outString(">> Instance numbers remapped, next instance id is %u", InstanceNumber);
+    for (auto const& column : instanceColumns)
+    {
+        CharacterDatabase.PExecute("UPDATE %s JOIN instance_remap ON %s.%s = instance_remap.old_id SET %s.%s = instance_remap.new_id + %u",
+                                   column[0], column[0], column[1], column[0], column[1], offset);
+        CharacterDatabase.PExecute("UPDATE %s SET %s = %s - %u WHERE %s > %u", column[0], column[1], column[1], offset, column[1], offset);
+    }
+    CharacterDatabase.Execute("DROP TEMPORARY TABLE instance_remap");
+    // execute transaction synchronously
+    CharacterDatabase.CommitTransaction();
+
+    sLog.outString(">> %u instance numbers remapped, next instance id is %u", uint32(instanceIds.size() - firstMoved), nextInstanceId);
     sLog.outString();
 }
 
@@ -1015,7 +1106,7 @@ void MapPersistentStateManager::GetStatistics(uint32& numStates, uint32& numBoun
 
 void MapPersistentStateManager::_CleanupExpiredInstancesAtTime(time_t t)
 {
-    _DelHelper(CharacterDatabase, "id, map, instance.difficulty", "instance", "LEFT JOIN instance_reset ON mapid = map AND instance.difficulty =  instance_reset.difficulty WHERE (instance.resettime < '" UI64FMTD "' AND instance.resettime > '0') OR (NOT instance_reset.resettime IS NULL AND instance_reset.resettime < '" UI64FMTD "')", (uint64)t, (uint64)t);
+    CharacterDatabase.DirectPExecute("DELETE instance FROM instance LEFT JOIN instance_reset ON mapid = map AND instance.difficulty = instance_reset.difficulty WHERE (instance.resettime < '" UI64FMTD "' AND instance.resettime > '0') OR (NOT instance_reset.resettime IS NULL AND instance_reset.resettime < '" UI64FMTD "')", (uint64)t, (uint64)t);
 }
 
 void MapPersistentStateManager::InitWorldMaps()
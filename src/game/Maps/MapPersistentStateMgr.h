@@ -25,11 +25,13 @@
 #include "Server/DBCEnums.h"
 #include "Server/DBCStores.h"
 #include "Entities/ObjectGuid.h"
+#include "Entities/GameObjectDefines.h"
 #include "Pools/PoolManager.h"
 
 #include <list>
 #include <map>
 #include <mutex>
+#include <queue>
 
 struct InstanceTemplate;
 struct MapEntry;
@@ -43,6 +45,9 @@ class Map;
 
 #define NORMAL_INSTANCE_RESET_TIME 30 * MINUTE
 
+// seconds the respawn times of a loaded map are collected before they are written in one transaction
+#define RESPAWN_TIMES_SAVE_INTERVAL 10
+
 typedef std::set<uint32> CellGuidSet;
 
 struct MapCellObjectGuids
@@ -84,11 +89,17 @@ class MapPersistentState
         Map* GetMap() const { return m_usedByMap; }         // Can be nullptr if map not loaded for persistent state
         void SetUsedByMapState(Map* map)
         {
+            if (!map)
+                SaveRespawnTimesToDB();
+
             m_usedByMap = map;
             if (!map)
                 UnloadIfEmpty();
         }
 
+        // called by the map using the state, expires the due respawn times and writes the changed ones periodically
+        void Update(time_t now);
+
         time_t GetCreatureRespawnTime(uint32 loguid) const
         {
             RespawnTimes::const_iterator itr = m_creatureRespawnTimes.find(loguid);
@@ -125,10 +136,22 @@ class MapPersistentState
     private:
         void SetCreatureRespawnTime(uint32 loguid, time_t t);
         void SetGORespawnTime(uint32 loguid, time_t t);
+        void SaveRespawnTimesToDB();
 
     private:
         typedef std::unordered_map<uint32, time_t> RespawnTimes;
 
+        struct RespawnQueueEntry
+        {
+            time_t respawnTime;
+            uint32 loguid;
+            bool isGameObject;
+
+            // earliest on top of the queue
+            bool operator<(RespawnQueueEntry const& other) const { return respawnTime > other.respawnTime; }
+        };
+        typedef std::priority_queue<RespawnQueueEntry> RespawnQueue;
+
         uint32 m_instanceid;
         uint32 m_mapid;
         Difficulty m_difficulty;
@@ -139,6 +162,11 @@ class MapPersistentState
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 
+        RespawnQueue m_respawnQueue;                        // respawn times in time order, entries changed later are skipped when due
+        RespawnTimes m_creatureRespawnTimesToSave;          // changed respawn times of a loaded map not yet written to DB
+        RespawnTimes m_goRespawnTimesToSave;
+        time_t m_nextRespawnTimesSave;
+
         SpawnedPoolData m_spawnedPoolData;                  // Pools spawns state for map copy
 };
 
@@ -223,6 +251,15 @@ class DungeonPersistentState : public MapPersistentState
         /* Remove players bind to this state */
         void UnbindThisState();
 
+        /* Dynamic state of the map kept while it is hibernated (unloaded without reset), each part
+           is taken back when the map or the object is created again. The dead creatures are already
+           kept by the respawn times. */
+        void SetHibernatedInstanceData(std::string const& data) { m_hibernatedInstanceData = data; m_hasHibernatedInstanceData = true; }
+        bool TakeHibernatedInstanceData(std::string& data);
+        void SetHibernatedGoState(uint32 dbGuid, GOState state) { m_hibernatedGoStates[dbGuid] = uint8(state); }
+        bool TakeHibernatedGoState(uint32 dbGuid, GOState& state);
+        void ClearHibernation();
+
     protected:
         bool CanBeUnload() const override;                  // overwrite MapPersistentState::CanBeUnload
         bool HasBounds() const { return !m_playerList.empty() || !m_groupList.empty(); }
@@ -241,6 +278,10 @@ class DungeonPersistentState : public MapPersistentState
         GroupListType m_groupList;                          // lock MapPersistentState from unload
 
         uint32 m_completedEncountersMask;                   // completed encounter mask, bit indexes are DungeonEncounter.dbc boss numbers, used for packets
+
+        bool m_hasHibernatedInstanceData;
+        std::string m_hibernatedInstanceData;               // InstanceData::Save() of the hibernated map
+        std::unordered_map<uint32, uint8> m_hibernatedGoStates; // by db guid, only those not in their spawn state
 };
 
 class BattleGroundPersistentState : public MapPersistentState
@@ -370,7 +411,6 @@ class MapPersistentStateManager : public MaNGOS::Singleton<MapPersistentStateMan
         void _CleanupExpiredInstancesAtTime(time_t t);
 
         void _ResetSave(PersistentStateMap& holder, PersistentStateMap::iterator& itr);
-        void _DelHelper(DatabaseType& db, const char* fields, const char* table, const char* queryTail, ...) const;
 
         // used during global instance resets
         bool lock_instLists;
@@ -18,30 +18,52 @@
 
 #include "MapUpdater.h"
 #include "MapWorkers.h"
+#include "TraceRecorder.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+static thread_local size_t t_workerThreadIndex = MapUpdater::NO_WORKER_THREAD;
+
+MapUpdater::MapUpdater(size_t num_threads, ThreadClass threadClass) : _threadClass(threadClass), _cancelationToken(false), pending_requests(0), queued_requests(0), next_queue(0),
+    _keptThread(0), _movedThread(0), _stolen(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    activate(num_threads, threadClass);
 }
 
-void MapUpdater::activate(size_t num_threads)
+void MapUpdater::activate(size_t num_threads, ThreadClass threadClass)
 {
     if (activated())
         return;
 
+    _threadClass = threadClass;
+    _cancelationToken = false;
+
+    // queues must all exist before the first thread starts stealing
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        _cancelationToken = true;
+    }
+    _queueCondition.notify_all();
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    for (auto& queue : _queues)
+    {
+        for (Worker* worker : queue->jobs)
+            delete worker;
+    }
+
+    _workerThreads.clear();
+    _queues.clear();
+    queued_requests = 0;
 }
 
 void MapUpdater::wait()
@@ -73,19 +95,102 @@ void MapUpdater::update_finished()
 
 void MapUpdater::schedule_update(Worker* worker)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    schedule_update(worker, NO_WORKER_THREAD);
+}
+
+void MapUpdater::schedule_update(Worker* worker, size_t preferredThread)
+{
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        ++pending_requests;
+        if (preferredThread < _queues.size())
+            index = preferredThread;
+        else
+            index = next_queue++ % _queues.size();
+    }
+
+    {
+        WorkerQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        queue.jobs.push_back(worker);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        ++queued_requests;
+    }
+    _queueCondition.notify_one();
+}
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+void MapUpdater::GetAffinityStats(AffinityStats& stats)
+{
+    stats.kept = _keptThread.exchange(0, std::memory_order_relaxed);
+    stats.moved = _movedThread.exchange(0, std::memory_order_relaxed);
+    stats.stolen = _stolen.exchange(0, std::memory_order_relaxed);
 }
 
-void MapUpdater::WorkerThread()
+size_t MapUpdater::GetCurrentThreadIndex()
 {
+    return t_workerThreadIndex;
+}
+
+Worker* MapUpdater::PopWorker(size_t index)
+{
+    // own work first, in scheduling order
+    {
+        WorkerQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (!queue.jobs.empty())
+        {
+            Worker* worker = queue.jobs.front();
+            queue.jobs.pop_front();
+            --queued_requests;
+            return worker;
+        }
+    }
+
+    // then steal the last scheduled (cheapest) work of the other threads
+    for (size_t i = 1; i < _queues.size(); ++i)
+    {
+        WorkerQueue& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.lock);
+        if (!queue.jobs.empty())
+        {
+            Worker* worker = queue.jobs.back();
+            queue.jobs.pop_back();
+            --queued_requests;
+            _stolen.fetch_add(1, std::memory_order_relaxed);
+            return worker;
+        }
+    }
+
+    return nullptr;
+}
+
+void MapUpdater::WorkerThread(size_t index)
+{
+    TraceRecorder::SetThreadName(("map updater " + std::to_string(index)).c_str());
+    ThreadAffinity::PinCurrentThread(_threadClass);
+    t_workerThreadIndex = index;
+
     while (true)
     {
-        Worker* request = nullptr;
+        Worker* request = PopWorker(index);
 
-        _queue.WaitAndPop(request);
+        if (!request)
+        {
+            std::unique_lock<std::mutex> lock(_queueLock);
+
+            while (queued_requests == 0 && !_cancelationToken)
+                _queueCondition.wait(lock);
+
+            if (_cancelationToken)
+                return;
+
+            continue;
+        }
 
         if (_cancelationToken)
         {
@@ -97,4 +202,4 @@ void MapUpdater::WorkerThread()
 
         delete request;
     }
-}
\ No newline at end of file
+}
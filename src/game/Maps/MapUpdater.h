@@ -20,11 +20,13 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "ProducerConsumerQueue.h"
+#include "ThreadAffinity.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
@@ -33,29 +35,66 @@ class Worker;
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
-        MapUpdater(size_t num_threads);
+        MapUpdater() : _threadClass(THREAD_CLASS_MAP), _cancelationToken(false), pending_requests(0), queued_requests(0), next_queue(0),
+            _keptThread(0), _movedThread(0), _stolen(0) {}
+        MapUpdater(size_t num_threads, ThreadClass threadClass = THREAD_CLASS_MAP);
         MapUpdater(const MapUpdater&) = delete;
         
-        void activate(size_t num_threads);
+        void activate(size_t num_threads, ThreadClass threadClass = THREAD_CLASS_MAP);
         void deactivate();
         void wait();
         void join();
         bool activated();
         void update_finished();
         void schedule_update(Worker* worker);
+        // queued first for the given worker thread, work repeated every tick keeps its thread and caches
+        void schedule_update(Worker* worker, size_t preferredThread);
+
+        size_t GetThreadCount() const { return _workerThreads.size(); }
+        // index of the calling worker thread in its updater, NO_WORKER_THREAD for other threads
+        static size_t GetCurrentThreadIndex();
+        static size_t const NO_WORKER_THREAD = size_t(-1);
+
+        // work repeated every tick that ran on the same thread as the previous time or on another one
+        void CountThreadAffinity(bool kept) { (kept ? _keptThread : _movedThread).fetch_add(1, std::memory_order_relaxed); }
+
+        struct AffinityStats
+        {
+            uint64 kept;                                    // since the last call
+            uint64 moved;                                   // since the last call
+            uint64 stolen;                                  // since the last call, taken from the queue of another thread
+        };
+        void GetAffinityStats(AffinityStats& stats);
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        // every worker thread owns a queue, it pops from its front and steals from the back of the others when empty
+        struct WorkerQueue
+        {
+            std::mutex lock;
+            std::deque<Worker*> jobs;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
+        ThreadClass _threadClass;
         std::atomic<bool> _cancelationToken;
 
         std::mutex _lock;
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void WorkerThread();
+        std::mutex _queueLock;
+        std::condition_variable _queueCondition;
+        std::atomic<size_t> queued_requests;
+        size_t next_queue;
+
+        std::atomic<uint64> _keptThread;
+        std::atomic<uint64> _movedThread;
+        std::atomic<uint64> _stolen;
+
+        Worker* PopWorker(size_t index);
+        void WorkerThread(size_t index);
 };
 
-#endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
+#endif //_MAP_UPDATER_H_INCLUDED
@@ -22,9 +22,16 @@
 #include "Grids/Cell.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "MapUpdater.h"
+#include "Maps/CombatLogBatch.h"
+#include "Maps/PlayerSnapshot.h"
+#include "World/World.h"
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/Object.h"
 #include "Platform/Define.h"
+#include "TraceRecorder.h"
+
+#include <chrono>
+#include <shared_mutex>
 
 class Worker
 {
@@ -49,7 +56,18 @@ class MapUpdateWorker : public Worker
 
         void execute() override
         {
+            TraceScope trace("map", "Map::Update");
+            if (trace.IsActive())
+                trace.SetDetail("map " + std::to_string(m_map.GetId()) + "/" + std::to_string(m_map.GetInstanceId()));
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
             m_map.Update(m_diff);
+            m_map.SetLastUpdateDuration(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+
+            size_t const thread = MapUpdater::GetCurrentThreadIndex();
+            if (m_map.GetLastUpdateThread() != MapUpdater::NO_WORKER_THREAD)
+                GetWorker().CountThreadAffinity(m_map.GetLastUpdateThread() == thread);
+            m_map.SetLastUpdateThread(thread);
             GetWorker().update_finished();
         }
 
@@ -61,29 +79,61 @@ class MapUpdateWorker : public Worker
 class GridCrawler : public Worker
 {
     public:
-        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_cells(cells), m_diff(diff)
-        {}
-
-        void execute() override
+        // objects are collected at construction, on the map thread, before any crawler of the tick is executed
+        // so an object relocated into a cell of another crawler is never updated twice
+        // objects that may act on units farther than reach go to deferred, for the map thread
+        GridCrawler(Map& map, std::vector<Cell> const& cells, uint32 diff, float reach, WorldObjectUnSet& deferred, MapUpdater& updater) :
+            Worker(updater), m_map(map), m_diff(diff)
         {
-            WorldObjectUnSet objToUpdate;
-            MaNGOS::ObjectUpdater obj_updater(objToUpdate, m_diff);
+            MaNGOS::ObjectUpdater obj_updater(m_objects, m_diff);
             TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
             TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
-            for (auto &cell : m_cells)
+            for (auto& cell : cells)
             {
-                m_map.Visit(cell, grid_object_update);
-                m_map.Visit(cell, world_object_update);
+                map.Visit(cell, grid_object_update);
+                map.Visit(cell, world_object_update);
+            }
+
+            for (auto itr = m_objects.begin(); itr != m_objects.end();)
+            {
+                if (map.ReachesBeyond(*itr, reach))
+                {
+                    deferred.insert(*itr);
+                    itr = m_objects.erase(itr);
+                }
+                else
+                    ++itr;
+            }
+        }
+
+        void execute() override
+        {
+            {
+                PlayerSnapshotTable::UpdateScope snapshotScope(m_map);
+
+                // the combat log of the crawled cells is sent by this thread when they are done
+                std::unique_ptr<CombatLogBatch::Scope> combatLog;
+                if (sWorld.getConfig(CONFIG_BOOL_COMBAT_LOG_BATCH))
+                    combatLog.reset(new CombatLogBatch::Scope(m_map));
+
+                for (WorldObject* const& object : m_objects)
+                {
+                    // held shared so other cell threads can change the shared map containers between objects
+                    std::shared_lock<std::shared_timed_mutex> shared(m_map.m_sharedContainersLock);
+                    Map::CellThreadScope cellScope(m_map);
+                    object->Update(m_diff);
+                }
             }
 
             GetWorker().update_finished();
         }
 
+        size_t GetObjectsCount() const { return m_objects.size(); }
+
     private:
         Map& m_map;
-        std::vector<Cell> &m_cells;
+        WorldObjectUnSet m_objects;
         uint32 m_diff;
 };
 
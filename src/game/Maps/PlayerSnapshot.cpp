@@ -0,0 +1,109 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Maps/PlayerSnapshot.h"
+#include "Maps/Map.h"
+#include "Entities/Player.h"
+
+PlayerSnapshot PlayerSnapshot::Make(Player const* player)
+{
+    PlayerSnapshot snapshot;
+    snapshot.level = uint8(player->getLevel());
+    snapshot.playerClass = player->getClass();
+    snapshot.gender = player->getGender();
+    snapshot.flags = 0;
+    if (player->isAFK())
+        snapshot.flags |= PLAYER_SNAPSHOT_AFK;
+    if (player->isDND())
+        snapshot.flags |= PLAYER_SNAPSHOT_DND;
+    if (player->IsDead())
+        snapshot.flags |= PLAYER_SNAPSHOT_DEAD;
+    if (player->HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_GHOST))
+        snapshot.flags |= PLAYER_SNAPSHOT_GHOST;
+    if (player->IsPvP())
+        snapshot.flags |= PLAYER_SNAPSHOT_PVP;
+    if (player->IsPvPFreeForAll())
+        snapshot.flags |= PLAYER_SNAPSHOT_PVP_FFA;
+    snapshot.zoneId = player->GetZoneId();
+    snapshot.areaId = player->GetAreaId();
+    snapshot.health = player->GetHealth();
+    snapshot.maxHealth = player->GetMaxHealth();
+    player->GetPosition(snapshot.x, snapshot.y, snapshot.z);
+    return snapshot;
+}
+
+PlayerSnapshot PlayerSnapshot::Get(Player const* player)
+{
+    if (!player->IsInWorld() || PlayerSnapshotTable::IsUpdatedByThisThread(player->GetMap()))
+        return Make(player);
+
+    PlayerSnapshot snapshot;
+    if (player->GetMap()->GetPlayerSnapshots().Find(player->GetObjectGuid(), snapshot))
+        return snapshot;
+
+    // not expected, Map::Add publishes the player before putting it in the world
+    return Make(player);
+}
+
+thread_local Map const* PlayerSnapshotTable::s_updatedMap = nullptr;
+
+void PlayerSnapshotTable::Publish(Map& map)
+{
+    std::lock_guard<std::mutex> guard(m_publishLock);
+
+    // the buffer published before the last one, unless a reader still has it
+    if (!m_back || m_back.use_count() > 1)
+        m_back = std::make_shared<Snapshots>();
+    else
+        m_back->clear();
+
+    for (auto const& ref : map.GetPlayers())
+        if (Player const* player = ref.getSource())
+            if (player->IsInWorld())
+                m_back->emplace(player->GetObjectGuid(), PlayerSnapshot::Make(player));
+
+    std::shared_ptr<Snapshots const> published = m_back;
+    m_back = std::const_pointer_cast<Snapshots>(std::atomic_exchange(&m_front, published));
+}
+
+void PlayerSnapshotTable::Add(Player const* player)
+{
+    std::lock_guard<std::mutex> guard(m_publishLock);
+
+    // rare enough to copy the published table, the buffers are only reused by Publish
+    std::shared_ptr<Snapshots const> current = std::atomic_load(&m_front);
+    std::shared_ptr<Snapshots> snapshots = current ? std::make_shared<Snapshots>(*current) : std::make_shared<Snapshots>();
+    (*snapshots)[player->GetObjectGuid()] = PlayerSnapshot::Make(player);
+
+    std::atomic_store(&m_front, std::shared_ptr<Snapshots const>(snapshots));
+}
+
+bool PlayerSnapshotTable::Find(ObjectGuid guid, PlayerSnapshot& snapshot) const
+{
+    std::shared_ptr<Snapshots const> snapshots = std::atomic_load(&m_front);
+    if (!snapshots)
+        return false;
+
+    auto itr = snapshots->find(guid);
+    if (itr == snapshots->end())
+        return false;
+
+    snapshot = itr->second;
+    return true;
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_PLAYERSNAPSHOT_H
+#define MANGOS_PLAYERSNAPSHOT_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+
+#include <memory>
+#include <mutex>
+
+class Map;
+class Player;
+
+enum PlayerSnapshotFlags
+{
+    PLAYER_SNAPSHOT_AFK         = 0x01,
+    PLAYER_SNAPSHOT_DND         = 0x02,
+    PLAYER_SNAPSHOT_DEAD        = 0x04,
+    PLAYER_SNAPSHOT_GHOST       = 0x08,
+    PLAYER_SNAPSHOT_PVP         = 0x10,
+    PLAYER_SNAPSHOT_PVP_FFA     = 0x20,
+};
+
+// the player fields the group, guild, social and LFG code of the world thread reads
+struct PlayerSnapshot
+{
+    uint8 level;
+    uint8 playerClass;
+    uint8 gender;
+    uint8 flags;                                            // PlayerSnapshotFlags
+    uint32 zoneId;
+    uint32 areaId;
+    uint32 health;
+    uint32 maxHealth;
+    float x, y, z;
+
+    bool HasFlag(PlayerSnapshotFlags flag) const { return (flags & flag) != 0; }
+
+    static PlayerSnapshot Make(Player const* player);
+
+    // the live fields for the threads updating the map of the player, which must see their own changes at
+    // once, and for a player out of the maps, which only its caller touches; the one its map published last
+    // for all other threads
+    static PlayerSnapshot Get(Player const* player);
+};
+
+/**
+ * The snapshots of the players of a map, published by the map thread at the end of each update and read
+ * by the other threads without locking the map or the players. A player added to the map is published at
+ * once, so every player in the map has a snapshot before its first update.
+ *
+ * Double buffered: readers keep the buffer they got for as long as they need it, and the map refills the
+ * other one unless a late reader still holds it, in which case it starts a new one.
+ */
+class PlayerSnapshotTable
+{
+    public:
+        // marks the calling thread as updating the map while it exists
+        class UpdateScope
+        {
+            public:
+                explicit UpdateScope(Map const& map) : m_previous(s_updatedMap) { s_updatedMap = &map; }
+                ~UpdateScope() { s_updatedMap = m_previous; }
+
+                UpdateScope(UpdateScope const&) = delete;
+                UpdateScope& operator=(UpdateScope const&) = delete;
+
+            private:
+                Map const* m_previous;
+        };
+
+        static bool IsUpdatedByThisThread(Map const* map) { return s_updatedMap == map; }
+
+        // map thread, at the end of its update
+        void Publish(Map& map);
+        // the thread adding the player to the map, before it is in the world
+        void Add(Player const* player);
+
+        // any thread, false if the player is not in the map
+        bool Find(ObjectGuid guid, PlayerSnapshot& snapshot) const;
+
+    private:
+        typedef std::unordered_map<ObjectGuid, PlayerSnapshot> Snapshots;
+
+        static thread_local Map const* s_updatedMap;
+
+        std::mutex m_publishLock;                           // Add may run on another thread than the map
+
+        std::shared_ptr<Snapshots const> m_front;           // only accessed with the atomic shared_ptr functions
+        std::shared_ptr<Snapshots> m_back;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Maps/SummonPool.h"
+#include "Maps/Map.h"
+
+SummonPool::~SummonPool()
+{
+    for (auto& freeBlocks : m_freeBlocks)
+        for (void* block : freeBlocks.second)
+            ::operator delete(block);
+}
+
+void* SummonPool::Allocate(size_t size, Map* map)
+{
+    SummonPool* pool = map ? map->GetSummonPool() : nullptr;
+
+    void* block = pool ? pool->Take(size) : nullptr;
+    if (!block)
+        block = ::operator new(HEADER_SIZE + size);
+
+    BlockHeader* header = new (block) BlockHeader();
+    header->size = size;
+    if (pool)
+        header->pool = pool->shared_from_this();
+
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void SummonPool::Release(void* object)
+{
+    if (!object)
+        return;
+
+    void* block = static_cast<char*>(object) - HEADER_SIZE;
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+
+    // the pool may go with its last block, so it is only dropped after the block is kept or freed
+    std::shared_ptr<SummonPool> pool = std::move(header->pool);
+    size_t size = header->size;
+    header->~BlockHeader();
+
+    if (!pool || !pool->Keep(block, size))
+        ::operator delete(block);
+}
+
+void* SummonPool::Take(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (auto& freeBlocks : m_freeBlocks)
+        {
+            if (freeBlocks.first != size || freeBlocks.second.empty())
+                continue;
+
+            void* block = freeBlocks.second.back();
+            freeBlocks.second.pop_back();
+            ++m_hits;
+            return block;
+        }
+    }
+
+    ++m_misses;
+    return nullptr;
+}
+
+bool SummonPool::Keep(void* block, size_t size)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto& freeBlocks : m_freeBlocks)
+    {
+        if (freeBlocks.first != size)
+            continue;
+
+        if (freeBlocks.second.size() >= m_maxFreeBlocks)
+            return false;
+
+        freeBlocks.second.push_back(block);
+        return true;
+    }
+
+    if (!m_maxFreeBlocks)
+        return false;
+
+    m_freeBlocks.emplace_back(size, std::vector<void*>());
+    m_freeBlocks.back().second.push_back(block);
+    return true;
+}
+
+uint32 SummonPool::GetFreeBlocks() const
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    uint32 count = 0;
+    for (auto const& freeBlocks : m_freeBlocks)
+        count += freeBlocks.second.size();
+    return count;
+}
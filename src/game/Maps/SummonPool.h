@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_SUMMONPOOL_H
+#define MANGOS_SUMMONPOOL_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+class Map;
+
+/**
+ * Memory of the temporary summons of a map: summoned creatures, totems, guardians and critters. A summon
+ * deleted gives its memory back to the pool of the map it was allocated for, and the next summon of the
+ * same size is constructed in it instead of going to the heap again.
+ *
+ * Only the allocation is reused, the summons are still fully constructed and destroyed. Each block keeps its
+ * pool alive, so a summon deleted after its map, or from another thread, is still released right.
+ */
+class SummonPool : public std::enable_shared_from_this<SummonPool>
+{
+    public:
+        explicit SummonPool(uint32 maxFreeBlocks) : m_maxFreeBlocks(maxFreeBlocks), m_hits(0), m_misses(0) {}
+        ~SummonPool();
+
+        // map may be nullptr, the block then comes from the heap and goes back to it
+        static void* Allocate(size_t size, Map* map);
+        static void Release(void* object);
+
+        uint32 GetHits() const { return m_hits; }
+        uint32 GetMisses() const { return m_misses; }
+        uint32 GetFreeBlocks() const;
+
+    private:
+        struct BlockHeader
+        {
+            std::shared_ptr<SummonPool> pool;               // empty for heap blocks
+            size_t size;
+        };
+
+        // keeps the objects aligned as the heap would
+        static constexpr size_t HEADER_SIZE = (sizeof(BlockHeader) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        void* Take(size_t size);
+        bool Keep(void* block, size_t size);
+
+        mutable std::mutex m_lock;
+        std::vector<std::pair<size_t, std::vector<void*>>> m_freeBlocks;   // few sizes, one per summon class
+        uint32 m_maxFreeBlocks;                             // per size
+        std::atomic<uint32> m_hits;
+        std::atomic<uint32> m_misses;
+};
+
+// class operators of a pooled summon type, `new (map) Type(...)` takes the memory from the pool of the map
+#define SUMMON_POOL_OPERATORS \
+    static void* operator new(size_t size) { return SummonPool::Allocate(size, nullptr); } \
+    static void* operator new(size_t size, Map* map) { return SummonPool::Allocate(size, map); } \
+    static void operator delete(void* object) { SummonPool::Release(object); } \
+    static void operator delete(void* object, Map* /*map*/) { SummonPool::Release(object); }
+
+#endif
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/TerrainCache.h"
+#include "Maps/GridMap.h"
+
+#include <cmath>
+
+// tiles kept per grid before they are all dropped, bounds the cache of grids crossed by many units
+#define MAX_TERRAIN_CACHE_TILES_PER_GRID 8192
+
+namespace
+{
+    std::atomic<uint32> s_terrainCacheGeneration(0);
+
+    GridMapLiquidStatus GetLiquidStatusAt(GridMapLiquidData const& data, float z)
+    {
+        // same deltas as TerrainInfo::getLiquidStatus
+        int delta = int((data.level - z) * 10);
+
+        if (delta > 20)                                     // Under water
+            return LIQUID_MAP_UNDER_WATER;
+        if (delta > 0)                                      // In water
+            return LIQUID_MAP_IN_WATER;
+        if (delta > -1)                                     // Walk on water
+            return LIQUID_MAP_WATER_WALK;
+        return LIQUID_MAP_ABOVE_WATER;
+    }
+}
+
+TerrainCache::TerrainCache(TerrainInfo const* terrain) : m_terrain(terrain), m_generation(++s_terrainCacheGeneration)
+{
+}
+
+bool TerrainCache::GetTileKey(float x, float y, float z, uint32& gridKey, uint64& tileKey) const
+{
+    int gx = int(32 - x / SIZE_OF_GRIDS);
+    int gy = int(32 - y / SIZE_OF_GRIDS);
+    if (gx < 0 || gy < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy >= MAX_NUMBER_OF_GRIDS)
+        return false;
+
+    // the height has no bounds of its own, tiles far off the terrain are not cached
+    float tileZ = std::floor(z);
+    if (!(tileZ > -30000.0f && tileZ < 30000.0f))
+        return false;
+
+    if (!m_terrain->IsGridLoaded(gx, gy))
+        return false;
+
+    gridKey = uint32(gx) << 8 | uint32(gy);
+    tileKey = uint64(int32(std::floor(x)) + 0x8000) << 32 | uint64(int32(std::floor(y)) + 0x8000) << 16 | uint64(int32(tileZ) + 0x8000);
+    return true;
+}
+
+TerrainCache::AreaInfo TerrainCache::ComputeAreaInfo(float x, float y, float z) const
+{
+    AreaInfo info;
+    info.areaFlag = m_terrain->GetAreaFlag(x, y, z, &info.outdoors);
+    TerrainManager::GetZoneAndAreaIdByAreaFlag(info.zoneId, info.areaId, info.areaFlag, m_terrain->GetMapId());
+    return info;
+}
+
+TerrainCache::AreaInfo TerrainCache::GetAreaInfo(float x, float y, float z, AreaHint* hint)
+{
+    uint32 gridKey;
+    uint64 tileKey;
+    if (!GetTileKey(x, y, z, gridKey, tileKey))
+        return ComputeAreaInfo(x, y, z);
+
+    uint32 generation = m_generation;
+    if (hint && hint->key == tileKey && hint->generation == generation)
+        return hint->info;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    GridTiles& tiles = m_grids[gridKey];
+    auto itr = tiles.areas.find(tileKey);
+    if (itr == tiles.areas.end())
+    {
+        if (tiles.areas.size() >= MAX_TERRAIN_CACHE_TILES_PER_GRID)
+            tiles.areas.clear();
+
+        itr = tiles.areas.emplace(tileKey, ComputeAreaInfo(x, y, z)).first;
+    }
+
+    if (hint)
+    {
+        hint->key = tileKey;
+        hint->generation = generation;
+        hint->info = itr->second;
+    }
+    return itr->second;
+}
+
+GridMapLiquidStatus TerrainCache::GetLiquidStatus(float x, float y, float z, GridMapLiquidData* data)
+{
+    uint32 gridKey;
+    uint64 tileKey;
+    if (!GetTileKey(x, y, z, gridKey, tileKey))
+        return m_terrain->getLiquidStatus(x, y, z, MAP_ALL_LIQUIDS, data);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    GridTiles& tiles = m_grids[gridKey];
+    auto itr = tiles.liquids.find(tileKey);
+    if (itr == tiles.liquids.end())
+    {
+        if (tiles.liquids.size() >= MAX_TERRAIN_CACHE_TILES_PER_GRID)
+            tiles.liquids.clear();
+
+        LiquidTile tile;
+        GridMapLiquidStatus status = m_terrain->getLiquidStatus(x, y, z, MAP_ALL_LIQUIDS, &tile.data);
+        tile.hasLiquid = status != LIQUID_MAP_NO_WATER;
+        itr = tiles.liquids.emplace(tileKey, tile).first;
+
+        if (tile.hasLiquid && data)
+            *data = tile.data;
+        return status;
+    }
+
+    LiquidTile const& tile = itr->second;
+    if (!tile.hasLiquid)
+        return LIQUID_MAP_NO_WATER;
+
+    if (data)
+        *data = tile.data;
+    return GetLiquidStatusAt(tile.data, z);
+}
+
+void TerrainCache::InvalidateGrid(uint32 gx, uint32 gy)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_grids.erase(gx << 8 | gy))
+        m_generation = ++s_terrainCacheGeneration;
+}
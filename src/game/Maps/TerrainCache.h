@@ -0,0 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TERRAIN_CACHE_H
+#define MANGOS_TERRAIN_CACHE_H
+
+#include "Common.h"
+#include "Maps/GridMapDefines.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+class TerrainInfo;
+
+// area and liquid results of a map instance, quantized to tiles of a yard so units moving around or
+// standing in the same spot do not query the map grid and the vmap tree again. the tiles of a grid are
+// dropped when the map unloads the grid, and only grids fully loaded in the terrain are cached at all so
+// a result never stems from missing terrain data. the liquid level is cached, the status is still derived
+// from the exact height of the query. mostly used by the map thread, the lock covers the rare queries
+// of objects from other threads
+class TerrainCache
+{
+    public:
+        struct AreaInfo
+        {
+            uint16 areaFlag;
+            bool outdoors;
+            uint32 zoneId;
+            uint32 areaId;
+        };
+
+        // last area result of an object, skips even the tile lookup while the object stays in the tile;
+        // owned by the object, so only touched by the thread updating it
+        struct AreaHint
+        {
+            AreaHint() : key(0), generation(0) {}
+
+            uint64 key;
+            uint32 generation;
+            AreaInfo info;
+        };
+
+        explicit TerrainCache(TerrainInfo const* terrain);
+
+        AreaInfo GetAreaInfo(float x, float y, float z, AreaHint* hint = nullptr);
+
+        // TerrainInfo::getLiquidStatus for all liquid types
+        GridMapLiquidStatus GetLiquidStatus(float x, float y, float z, GridMapLiquidData* data = nullptr);
+
+        void InvalidateGrid(uint32 gx, uint32 gy);
+
+    private:
+        struct LiquidTile
+        {
+            bool hasLiquid;
+            GridMapLiquidData data;
+        };
+
+        struct GridTiles
+        {
+            std::unordered_map<uint64, AreaInfo> areas;
+            std::unordered_map<uint64, LiquidTile> liquids;
+        };
+
+        // false if the position is outside of the grids or its grid is not fully loaded
+        bool GetTileKey(float x, float y, float z, uint32& gridKey, uint64& tileKey) const;
+        AreaInfo ComputeAreaInfo(float x, float y, float z) const;
+
+        TerrainInfo const* m_terrain;
+        std::mutex m_lock;
+        std::unordered_map<uint32, GridTiles> m_grids;      // by gx << 8 | gy
+        std::atomic<uint32> m_generation;                   // unique among all caches, changes with every invalidation
+};
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/TerrainPrefetcher.h"
+#include "Maps/GridMap.h"
+#include "Maps/Map.h"
+#include "Entities/Player.h"
+#include "Movement/MoveSpline.h"
+#include "Vmap/MapTree.h"
+#include "World/World.h"
+#include "Timer.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <cstdio>
+
+// a grid is not queued again before this delay, its files are expected to still be cached by then
+#define TERRAIN_PREFETCH_REPEAT_DELAY   (5 * MINUTE * IN_MILLISECONDS)
+// walking players only look this far ahead, prefetch distance is meant for taxis and fast mounts
+#define TERRAIN_PREFETCH_SECONDS        30.0f
+
+void TerrainPrefetcher::activate()
+{
+    if (activated())
+        return;
+
+    m_cancelationToken = false;
+    m_thread = std::thread(&TerrainPrefetcher::PrefetchThread, this);
+}
+
+void TerrainPrefetcher::deactivate()
+{
+    if (!activated())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_cancelationToken = true;
+    }
+    m_condition.notify_all();
+
+    m_thread.join();
+
+    m_queue.clear();
+    m_requested.clear();
+    m_prefetched.clear();
+}
+
+void TerrainPrefetcher::PrefetchAhead(Player const& player)
+{
+    float const distance = float(sWorld.getConfig(CONFIG_UINT32_TERRAIN_PREFETCH_DISTANCE));
+    uint32 const mapId = player.GetMapId();
+    TerrainInfo const* terrain = player.GetTerrain();
+
+    uint32 lastGrid = PackGrid(mapId, MAX_NUMBER_OF_GRIDS, MAX_NUMBER_OF_GRIDS);
+    auto queueAt = [&](float x, float y)
+    {
+        int gx = int(32 - x / SIZE_OF_GRIDS);
+        int gy = int(32 - y / SIZE_OF_GRIDS);
+        if (gx < 0 || gy < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy >= MAX_NUMBER_OF_GRIDS)
+            return;
+
+        uint32 grid = PackGrid(mapId, gx, gy);
+        if (grid == lastGrid || terrain->IsGridLoaded(gx, gy))
+            return;
+
+        lastGrid = grid;
+        Queue(mapId, gx, gy);
+    };
+
+    if (player.IsTaxiFlying() && !player.movespline->Finalized())
+    {
+        // follow the remaining flight path
+        Movement::MoveSpline::MySpline::ControlArray const& path = player.movespline->_Spline().getPoints();
+        float travelled = 0.0f;
+        for (size_t i = std::max(player.movespline->_currentSplineIdx(), 0) + 1; i < path.size() && travelled < distance; ++i)
+        {
+            travelled += (path[i] - path[i - 1]).length();
+            queueAt(path[i].x, path[i].y);
+        }
+    }
+    else if (player.IsMovingForward())
+    {
+        float const speed = player.GetSpeed(player.IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+        float const ahead = std::min(distance, speed * TERRAIN_PREFETCH_SECONDS);
+        float const orientation = player.GetOrientation();
+        for (float travelled = SIZE_OF_GRIDS / 2; travelled <= ahead; travelled += SIZE_OF_GRIDS / 2)
+            queueAt(player.GetPositionX() + travelled * cos(orientation), player.GetPositionY() + travelled * sin(orientation));
+    }
+}
+
+bool TerrainPrefetcher::ConsumePrefetched(uint32 mapId, uint32 x, uint32 y)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_prefetched.erase(PackGrid(mapId, x, y)) != 0;
+}
+
+void TerrainPrefetcher::Queue(uint32 mapId, uint32 x, uint32 y)
+{
+    uint32 const now = WorldTimer::getMSTime();
+    uint32 const grid = PackGrid(mapId, x, y);
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto itr = m_requested.find(grid);
+        if (itr != m_requested.end() && WorldTimer::getMSTimeDiff(itr->second, now) < TERRAIN_PREFETCH_REPEAT_DELAY)
+            return;
+
+        // forget old requests now and then
+        if (m_requested.size() > 4096)
+        {
+            for (auto oldItr = m_requested.begin(); oldItr != m_requested.end();)
+            {
+                if (WorldTimer::getMSTimeDiff(oldItr->second, now) >= TERRAIN_PREFETCH_REPEAT_DELAY)
+                {
+                    m_prefetched.erase(oldItr->first);
+                    oldItr = m_requested.erase(oldItr);
+                }
+                else
+                    ++oldItr;
+            }
+        }
+
+        m_requested[grid] = now;
+        m_queue.push_back(grid);
+    }
+
+    m_condition.notify_one();
+}
+
+void TerrainPrefetcher::PrefetchThread()
+{
+    std::vector<char> buffer(64 * 1024);
+
+    while (true)
+    {
+        uint32 grid;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] { return m_cancelationToken || !m_queue.empty(); });
+
+            if (m_cancelationToken)
+                return;
+
+            grid = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        uint32 const mapId = grid >> 12;
+        uint32 const x = (grid >> 6) & 0x3F;
+        uint32 const y = grid & 0x3F;
+
+        char mapFile[32];
+        snprintf(mapFile, sizeof(mapFile), "maps/%03u%02u%02u.map", mapId, x, y);
+        char mmapFile[32];
+        snprintf(mmapFile, sizeof(mmapFile), "mmaps/%03u%02u%02u.mmtile", mapId, x, y);
+
+        std::string const files[] =
+        {
+            sWorld.GetDataPath() + mapFile,
+            sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, x, y),
+            sWorld.GetDataPath() + mmapFile
+        };
+
+#ifdef BUILD_METRICS
+        uint32 const start = WorldTimer::getMSTime();
+#endif
+        uint64 bytes = 0;
+        for (std::string const& fileName : files)
+        {
+            // only reading matters, the data ends up in the OS file cache
+            FILE* file = fopen(fileName.c_str(), "rb");
+            if (!file)
+                continue;
+
+            size_t read;
+            while ((read = fread(buffer.data(), 1, buffer.size(), file)) > 0)
+                bytes += read;
+
+            fclose(file);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_prefetched.insert(grid);
+        }
+
+#ifdef BUILD_METRICS
+        metric::measurement meas("terrain.prefetch", { { "map_id", std::to_string(mapId) } });
+        meas.add_field("bytes", std::to_string(bytes));
+        meas.add_field("duration", std::to_string(WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime())));
+#endif
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TERRAIN_PREFETCHER_H
+#define MANGOS_TERRAIN_PREFETCHER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+class Player;
+
+// reads the .map, .vmtile and .mmtile files of grids players are heading to from a background thread,
+// so that the grid load done later by the map thread finds them in the OS file cache instead of waiting
+// for the disk. nothing is handed to the terrain, vmap or mmap managers, their synchronous load stays the
+// only loader and works as before when a grid was not predicted
+class TerrainPrefetcher
+{
+    public:
+        TerrainPrefetcher() : m_cancelationToken(false) {}
+        TerrainPrefetcher(const TerrainPrefetcher&) = delete;
+
+        void activate();
+        void deactivate();
+        bool activated() const { return m_thread.joinable(); }
+
+        // queues the grids ahead of the player, along its taxi path or its movement direction
+        void PrefetchAhead(Player const& player);
+
+        // true once for a grid whose files were read ahead, used to split the grid load metrics
+        bool ConsumePrefetched(uint32 mapId, uint32 x, uint32 y);
+
+    private:
+        void Queue(uint32 mapId, uint32 x, uint32 y);
+        void PrefetchThread();
+
+        static uint32 PackGrid(uint32 mapId, uint32 x, uint32 y) { return mapId << 12 | x << 6 | y; }
+
+        std::thread m_thread;
+        std::atomic<bool> m_cancelationToken;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<uint32> m_queue;
+        std::unordered_map<uint32, uint32> m_requested;     // grid to time of the request, not queued again for a while
+        std::unordered_set<uint32> m_prefetched;            // read ahead and not loaded yet
+};
+
+#endif
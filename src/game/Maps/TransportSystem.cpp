@@ -30,6 +30,7 @@
 #include "Maps/TransportSystem.h"
 #include "Entities/Unit.h"
 #include "Entities/Vehicle.h"
+#include "Entities/Transports.h"
 #include "Maps/MapManager.h"
 
 /* **************************************** TransportBase ****************************************/
@@ -39,7 +40,8 @@ TransportBase::TransportBase(WorldObject* owner) :
     m_lastPosition(owner->GetPositionX(), owner->GetPositionY(), owner->GetPositionZ(), owner->GetOrientation()),
     m_sinO(sin(m_lastPosition.o)),
     m_cosO(cos(m_lastPosition.o)),
-    m_updatePositionsTimer(500)
+    m_updatePositionsTimer(500),
+    m_updatePositionsDue(false)
 {
     MANGOS_ASSERT(m_owner);
 }
@@ -55,11 +57,12 @@ void TransportBase::Update(uint32 diff)
 {
     if (m_updatePositionsTimer < diff)
     {
-        if (fabs(m_owner->GetPositionX() - m_lastPosition.x) +
-                fabs(m_owner->GetPositionY() - m_lastPosition.y) +
-                fabs(m_owner->GetPositionZ() - m_lastPosition.z) > 1.0f ||
-                MapManager::NormalizeOrientation(m_owner->GetOrientation() - m_lastPosition.o) > 0.01f)
-            UpdateGlobalPositions();
+        // On a moving ship the owner is relocated by the ship, the passengers follow in the same pass
+        GenericTransport* transport = m_owner->GetTransport();
+        if (transport && transport->GetGoType() == GAMEOBJECT_TYPE_MO_TRANSPORT && static_cast<Transport*>(transport)->IsMoving())
+            m_updatePositionsDue = true;
+        else
+            UpdateGlobalPositionsIfMoved();
 
         m_updatePositionsTimer = 500;
     }
@@ -67,6 +70,23 @@ void TransportBase::Update(uint32 diff)
         m_updatePositionsTimer -= diff;
 }
 
+void TransportBase::UpdateGlobalPositionsIfDue()
+{
+    if (m_updatePositionsDue)
+        UpdateGlobalPositionsIfMoved();
+}
+
+void TransportBase::UpdateGlobalPositionsIfMoved()
+{
+    if (fabs(m_owner->GetPositionX() - m_lastPosition.x) +
+            fabs(m_owner->GetPositionY() - m_lastPosition.y) +
+            fabs(m_owner->GetPositionZ() - m_lastPosition.z) > 1.0f ||
+            MapManager::NormalizeOrientation(m_owner->GetOrientation() - m_lastPosition.o) > 0.01f)
+        UpdateGlobalPositions();
+
+    m_updatePositionsDue = false;
+}
+
 // Update the global positions of all passengers
 void TransportBase::UpdateGlobalPositions()
 {
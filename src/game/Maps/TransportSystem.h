@@ -57,6 +57,8 @@ class TransportBase
 
         void Update(uint32 diff);
         void UpdateGlobalPositions();
+        // Called by a moving transport right after it relocated the owner, does the pass left over by Update
+        void UpdateGlobalPositionsIfDue();
         void UpdateGlobalPositionOf(WorldObject* passenger, float lx, float ly, float lz, float lo) const;
 
         WorldObject* GetOwner() const { return m_owner; }
@@ -75,6 +77,8 @@ class TransportBase
         void BoardPassenger(WorldObject* passenger, float lx, float ly, float lz, float lo, uint8 seat);
         void UnBoardPassenger(WorldObject* passenger);
 
+        void UpdateGlobalPositionsIfMoved();
+
         WorldObject* m_owner;                               ///< The transporting unit
         PassengerMap m_passengers;                          ///< List of passengers and their transport-information
 
@@ -82,6 +86,7 @@ class TransportBase
         Position m_lastPosition;
         float m_sinO, m_cosO;
         uint32 m_updatePositionsTimer;                      ///< Timer that is used to trigger updates for global coordinate calculations
+        bool m_updatePositionsDue;                          ///< Timer passed while the owner is carried by a moving transport
 };
 
 /**
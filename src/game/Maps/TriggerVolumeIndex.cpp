@@ -0,0 +1,127 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/TriggerVolumeIndex.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// size of the index cells, about the radius of the larger area effects
+#define TRIGGER_VOLUME_CELL_SIZE 32.0f
+// volumes are linked this far beyond their radius, covers the combat reach of most units
+#define TRIGGER_VOLUME_REACH_MARGIN 10.0f
+// searches of volumes no unit moved into, for state changes of units standing inside
+#define TRIGGER_VOLUME_POLL_INTERVAL 1000
+
+template<typename F>
+void TriggerVolumeIndex::ForEachCell(float x, float y, float radius, F&& func)
+{
+    // the coords of the map grids fit into 11 bits of cells
+    int32 minX = int32(std::floor((x - radius) / TRIGGER_VOLUME_CELL_SIZE)) + 1024;
+    int32 maxX = int32(std::floor((x + radius) / TRIGGER_VOLUME_CELL_SIZE)) + 1024;
+    int32 minY = int32(std::floor((y - radius) / TRIGGER_VOLUME_CELL_SIZE)) + 1024;
+    int32 maxY = int32(std::floor((y + radius) / TRIGGER_VOLUME_CELL_SIZE)) + 1024;
+
+    for (int32 cx = std::max(minX, 0); cx <= std::min(maxX, 2047); ++cx)
+        for (int32 cy = std::max(minY, 0); cy <= std::min(maxY, 2047); ++cy)
+            func(uint32(cx) << 11 | uint32(cy));
+}
+
+void TriggerVolumeIndex::Link(Volume& volume)
+{
+    ForEachCell(volume.x, volume.y, volume.radius + TRIGGER_VOLUME_REACH_MARGIN, [&](uint32 cell)
+    {
+        m_cells[cell].push_back(&volume);
+    });
+}
+
+void TriggerVolumeIndex::Unlink(Volume& volume)
+{
+    ForEachCell(volume.x, volume.y, volume.radius + TRIGGER_VOLUME_REACH_MARGIN, [&](uint32 cell)
+    {
+        auto itr = m_cells.find(cell);
+        if (itr == m_cells.end())
+            return;
+
+        std::vector<Volume*>& volumes = itr->second;
+        volumes.erase(std::remove(volumes.begin(), volumes.end(), &volume), volumes.end());
+        if (volumes.empty())
+            m_cells.erase(itr);
+    });
+}
+
+void TriggerVolumeIndex::Register(Volume& volume, float x, float y, float radius)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (volume.registered)
+        Unlink(volume);
+
+    volume.x = x;
+    volume.y = y;
+    volume.radius = radius;
+    volume.registered = true;
+    volume.triggered = true;
+    Link(volume);
+}
+
+void TriggerVolumeIndex::Unregister(Volume& volume)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (!volume.registered)
+        return;
+
+    Unlink(volume);
+    volume.registered = false;
+}
+
+void TriggerVolumeIndex::OnUnitMoved(float x, float y, float reach)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_cells.empty())
+        return;
+
+    ForEachCell(x, y, 0.0f, [&](uint32 cell)
+    {
+        auto itr = m_cells.find(cell);
+        if (itr == m_cells.end())
+            return;
+
+        for (Volume* volume : itr->second)
+        {
+            float dx = volume->x - x;
+            float dy = volume->y - y;
+            float range = volume->radius + reach + 1.0f;
+            if (dx * dx + dy * dy <= range * range)
+                volume->triggered = true;
+        }
+    });
+}
+
+bool TriggerVolumeIndex::ConsumeTriggered(Volume& volume)
+{
+    uint32 now = WorldTimer::getMSTime();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (volume.registered && !volume.triggered && WorldTimer::getMSTimeDiff(volume.lastSearch, now) < TRIGGER_VOLUME_POLL_INTERVAL)
+        return false;
+
+    volume.triggered = false;
+    volume.lastSearch = now;
+    return true;
+}
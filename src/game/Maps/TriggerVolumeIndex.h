@@ -0,0 +1,68 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TRIGGER_VOLUME_INDEX_H
+#define MANGOS_TRIGGER_VOLUME_INDEX_H
+
+#include "Common.h"
+
+#include <mutex>
+#include <unordered_map>
+
+// traps and persistent area effects of a map by the ground they cover, so they search for units in
+// range only after a unit moved into their volume instead of every update. a unit leaving needs no
+// search, persistent area auras drop themselves out of range. state changes without movement (revive,
+// faction, dispelled aura) are still caught by a slow poll of every volume.
+// relocations may come from the cell threads, the index is guarded by its own lock
+class TriggerVolumeIndex
+{
+    public:
+        // owned by the trigger object, registered while it is in the world
+        struct Volume
+        {
+            Volume() : x(0.0f), y(0.0f), radius(0.0f), registered(false), triggered(false), lastSearch(0) {}
+
+            float x;
+            float y;
+            float radius;
+            bool registered;
+            bool triggered;                                 // a unit moved into the volume since the last search
+            uint32 lastSearch;                              // ms time
+        };
+
+        // also moves a registered volume, the first search is done on the next update
+        void Register(Volume& volume, float x, float y, float radius);
+        void Unregister(Volume& volume);
+
+        // unit with the combat reach moved to or appeared at the position
+        void OnUnitMoved(float x, float y, float reach);
+
+        // true if the trigger has to search for units now, always for volumes not registered
+        bool ConsumeTriggered(Volume& volume);
+
+    private:
+        void Link(Volume& volume);
+        void Unlink(Volume& volume);
+
+        template<typename F> static void ForEachCell(float x, float y, float radius, F&& func);
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, std::vector<Volume*>> m_cells;
+};
+
+#endif
@@ -22,8 +22,55 @@
 #include "MotionGenerators/MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include <zlib.h>
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#include <chrono>
+#endif
+
 namespace MMAP
 {
+    // reads the tile data following the header into a buffer allocated for detour, compressed tiles are
+    // inflated straight into it; bytesRead is what was read from the file after the header
+    static unsigned char* ReadTileData(FILE* file, MmapTileHeader const& fileHeader, uint32& bytesRead)
+    {
+        bytesRead = 0;
+        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+        MANGOS_ASSERT(data);
+
+        if (fileHeader.mmapMagic == MMAP_MAGIC)
+        {
+            if (fread(data, fileHeader.size, 1, file) != 1)
+            {
+                dtFree(data);
+                return nullptr;
+            }
+
+            bytesRead = fileHeader.size;
+            return data;
+        }
+
+        uint32 compressedSize = 0;
+        if (fread(&compressedSize, sizeof(uint32), 1, file) != 1 || !compressedSize)
+        {
+            dtFree(data);
+            return nullptr;
+        }
+
+        std::vector<unsigned char> compressed(compressedSize);
+        uLongf size = fileHeader.size;
+        if (fread(&compressed[0], compressedSize, 1, file) != 1 ||
+            uncompress(data, &size, &compressed[0], compressedSize) != Z_OK || size != fileHeader.size)
+        {
+            dtFree(data);
+            return nullptr;
+        }
+
+        bytesRead = sizeof(uint32) + compressedSize;
+        return data;
+    }
+
     // ######################## MMapFactory ########################
     // our global singelton copy
     MMapManager* g_MMapManager = nullptr;
@@ -212,6 +259,10 @@ namespace MMAP
             return false;
         }
 
+#ifdef BUILD_METRICS
+        std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+#endif
+
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
@@ -230,7 +281,7 @@ namespace MMAP
         MmapTileHeader fileHeader;
         fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
 
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        if (fileHeader.mmapMagic != MMAP_MAGIC && fileHeader.mmapMagic != MMAP_ZLIB_MAGIC)
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
@@ -245,11 +296,9 @@ namespace MMAP
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        uint32 bytesRead = 0;
+        unsigned char* data = ReadTileData(file, fileHeader, bytesRead);
+        if (!data)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
@@ -272,6 +321,17 @@ namespace MMAP
 
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
         ++loadedTiles;
+        mmap->pathCache.Clear();
+
+#ifdef BUILD_METRICS
+        metric::measurement meas("mmap.tile_load", {
+            { "map_id", std::to_string(mapId) },
+            { "compressed", fileHeader.mmapMagic == MMAP_ZLIB_MAGIC ? "1" : "0" }
+        });
+        meas.add_field("duration", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count()));
+        meas.add_field("bytes_read", std::to_string(sizeof(MmapTileHeader) + bytesRead));
+#endif
+
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
         return true;
     }
@@ -304,7 +364,7 @@ namespace MMAP
         MmapTileHeader fileHeader;
         fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
 
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        if (fileHeader.mmapMagic != MMAP_MAGIC && fileHeader.mmapMagic != MMAP_ZLIB_MAGIC)
         {
             sLog.outError("MMAP:loadGameObject: Bad header in mmap %s", fileName);
             fclose(file);
@@ -318,11 +378,9 @@ namespace MMAP
             fclose(file);
             return false;
         }
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        uint32 bytesRead = 0;
+        unsigned char* data = ReadTileData(file, fileHeader, bytesRead);
+        if (!data)
         {
             sLog.outError("MMAP:loadGameObject: Bad header or data in mmap %s", fileName);
             fclose(file);
@@ -386,6 +444,7 @@ namespace MMAP
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
             --loadedTiles;
+            mmap->pathCache.Clear();
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
         }
@@ -425,32 +484,6 @@ namespace MMAP
         return true;
     }
 
-    bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
-    {
-        // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-        {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
-        }
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-            return false;
-        }
-
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
-        return true;
-    }
-
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
@@ -467,30 +500,13 @@ namespace MMAP
         return m_loadedModels[mapId]->navMesh;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    NavMeshQueryLease MMapManager::LeaseNavMeshQuery(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return nullptr;
-
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            dtStatus dtResult = query->init(mmap->navMesh, 1024);
-            if (dtStatusFailed(dtResult))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-                return nullptr;
-            }
-
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
-        }
+        auto itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return NavMeshQueryLease();
 
-        return mmap->navMeshQueries[instanceId];
+        return NavMeshQueryLease(&itr->second->navMeshQueries);
     }
 
     dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
@@ -524,4 +540,124 @@ namespace MMAP
 
         return mmap->navMeshGOQueries[threadId];
     }
+
+    // ######################## NavMeshQueryPool ########################
+    NavPathCache* MMapManager::GetPathCache(uint32 mapId)
+    {
+        if (!sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_SIZE))
+            return nullptr;
+
+        auto itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return &itr->second->pathCache;
+    }
+
+    void MMapManager::InvalidatePathCache(uint32 mapId)
+    {
+        auto itr = loadedMMaps.find(mapId);
+        if (itr != loadedMMaps.end())
+            itr->second->pathCache.Clear();
+    }
+
+    void MMapManager::getPathCacheStats(uint64& hits, uint64& misses, uint32& size) const
+    {
+        hits = NavPathCache::GetHits();
+        misses = NavPathCache::GetMisses();
+        size = NavPathCache::GetSize();
+    }
+
+    std::atomic<uint64> NavPathCache::m_hits(0);
+    std::atomic<uint64> NavPathCache::m_misses(0);
+    std::atomic<uint32> NavPathCache::m_size(0);
+
+    uint32 NavPathCache::Find(NavPathCacheKey const& key, dtPolyRef* path, uint32& tilesVersion)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        tilesVersion = m_tilesVersion;
+
+        auto itr = m_index.find(key);
+        if (itr == m_index.end())
+        {
+            ++m_misses;
+            return 0;
+        }
+
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, itr->second);
+
+        std::vector<dtPolyRef> const& polys = itr->second->second;
+        memcpy(path, polys.data(), polys.size() * sizeof(dtPolyRef));
+        return polys.size();
+    }
+
+    void NavPathCache::Store(NavPathCacheKey const& key, uint32 tilesVersion, dtPolyRef const* path, uint32 length)
+    {
+        uint32 const capacity = sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_SIZE);
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        // mesh changed while the corridor was searched
+        if (tilesVersion != m_tilesVersion || m_index.find(key) != m_index.end())
+            return;
+
+        while (!m_entries.empty() && m_entries.size() >= capacity)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+            --m_size;
+        }
+
+        m_entries.emplace_front(key, std::vector<dtPolyRef>(path, path + length));
+        m_index[key] = m_entries.begin();
+        ++m_size;
+    }
+
+    void NavPathCache::Clear()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_tilesVersion;
+        m_size -= m_entries.size();
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    NavMeshQueryPool::~NavMeshQueryPool()
+    {
+        for (dtNavMeshQuery* query : m_freeQueries)
+            dtFreeNavMeshQuery(query);
+    }
+
+    dtNavMeshQuery* NavMeshQueryPool::Acquire()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if (!m_freeQueries.empty())
+            {
+                dtNavMeshQuery* query = m_freeQueries.back();
+                m_freeQueries.pop_back();
+                return query;
+            }
+        }
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(m_navMesh, sWorld.getConfig(CONFIG_UINT32_MMAP_QUERY_NODES))))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:NavMeshQueryPool: Failed to initialize dtNavMeshQuery");
+            return nullptr;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:NavMeshQueryPool: created dtNavMeshQuery");
+        return query;
+    }
+
+    void NavMeshQueryPool::Release(dtNavMeshQuery* query)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_freeQueries.push_back(query);
+    }
 }
@@ -23,6 +23,8 @@
 #include <Detour/Include/DetourAlloc.h>
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
+#include <atomic>
+#include <list>
 #include <mutex>
 
 class Unit;
@@ -42,26 +44,137 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
     typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
 
+    // dtNavMeshQuery is not thread safe, so queries on a map mesh are handed out one user at a time
+    // free queries are reused, a new one is only allocated when all existing ones are leased
+    class NavMeshQueryPool
+    {
+        public:
+            NavMeshQueryPool(dtNavMesh const* mesh) : m_navMesh(mesh) {}
+            ~NavMeshQueryPool();
+
+            dtNavMeshQuery* Acquire();
+            void Release(dtNavMeshQuery* query);
+
+        private:
+            dtNavMesh const* m_navMesh;
+            std::vector<dtNavMeshQuery*> m_freeQueries;
+            std::mutex m_mutex;
+    };
+
+    // exclusive use of a pooled query, returned to its pool at destruction
+    class NavMeshQueryLease
+    {
+        public:
+            NavMeshQueryLease() : m_pool(nullptr), m_query(nullptr) {}
+            NavMeshQueryLease(NavMeshQueryPool* pool) : m_pool(pool), m_query(pool->Acquire()) {}
+            NavMeshQueryLease(NavMeshQueryLease&& other) noexcept : m_pool(other.m_pool), m_query(other.m_query) { other.m_query = nullptr; }
+            ~NavMeshQueryLease() { Reset(); }
+
+            NavMeshQueryLease& operator=(NavMeshQueryLease&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    Reset();
+                    m_pool = other.m_pool;
+                    m_query = other.m_query;
+                    other.m_query = nullptr;
+                }
+                return *this;
+            }
+
+            NavMeshQueryLease(NavMeshQueryLease const&) = delete;
+            NavMeshQueryLease& operator=(NavMeshQueryLease const&) = delete;
+
+            dtNavMeshQuery const* get() const { return m_query; }
+            dtNavMeshQuery const* operator->() const { return m_query; }
+            explicit operator bool() const { return m_query != nullptr; }
+
+            void Reset()
+            {
+                if (m_query)
+                    m_pool->Release(m_query);
+                m_query = nullptr;
+            }
+
+        private:
+            NavMeshQueryPool* m_pool;
+            dtNavMeshQuery* m_query;
+    };
+
+    // poly corridor found between two polys of a map mesh with a given filter
+    struct NavPathCacheKey
+    {
+        dtPolyRef startPoly;
+        dtPolyRef endPoly;
+        uint16 includeFlags;
+        uint16 excludeFlags;
+        uint32 areaCostHash;
+        uint32 maxPolys;
+
+        bool operator==(NavPathCacheKey const& other) const
+        {
+            return startPoly == other.startPoly && endPoly == other.endPoly && includeFlags == other.includeFlags &&
+                   excludeFlags == other.excludeFlags && areaCostHash == other.areaCostHash && maxPolys == other.maxPolys;
+        }
+    };
+
+    struct NavPathCacheKeyHash
+    {
+        size_t operator()(NavPathCacheKey const& key) const
+        {
+            return std::hash<uint64>()(key.startPoly ^ (uint64(key.endPoly) << 1)) ^
+                   std::hash<uint64>()(uint64(key.includeFlags) | uint64(key.excludeFlags) << 16 | uint64(key.areaCostHash) << 32) ^ key.maxPolys;
+        }
+    };
+
+    // least recently used poly corridors of a map mesh, shared by all instances of the map
+    // emptied whenever a tile of the mesh is added or removed, a corridor found before the change is not stored
+    class NavPathCache
+    {
+        public:
+            NavPathCache() : m_tilesVersion(0) {}
+            ~NavPathCache() { Clear(); }
+
+            // copies the corridor into path and returns its length, 0 on miss. tilesVersion is to pass to Store
+            uint32 Find(NavPathCacheKey const& key, dtPolyRef* path, uint32& tilesVersion);
+            void Store(NavPathCacheKey const& key, uint32 tilesVersion, dtPolyRef const* path, uint32 length);
+            void Clear();
+
+            // totals over the caches of all maps
+            static uint64 GetHits() { return m_hits; }
+            static uint64 GetMisses() { return m_misses; }
+            static uint32 GetSize() { return m_size; }
+
+        private:
+            typedef std::pair<NavPathCacheKey, std::vector<dtPolyRef>> Entry;
+            typedef std::list<Entry> EntryList;
+
+            EntryList m_entries;                // most recently used first
+            std::unordered_map<NavPathCacheKey, EntryList::iterator, NavPathCacheKeyHash> m_index;
+            uint32 m_tilesVersion;
+            std::mutex m_mutex;
+
+            static std::atomic<uint64> m_hits;
+            static std::atomic<uint64> m_misses;
+            static std::atomic<uint32> m_size;
+    };
+
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), navMeshQueries(mesh) {}
         ~MMapData()
         {
-            for (auto& navMeshQuerie : navMeshQueries)
-                dtFreeNavMeshQuery(navMeshQuerie.second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        NavMeshQueryPool navMeshQueries;    // shared by all instances of the map
+        NavPathCache pathCache;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
     };
 
@@ -99,17 +212,20 @@ namespace MMAP
             bool loadGameObject(uint32 displayId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
-            bool unloadMapInstance(uint32 mapId, uint32 instanceId);
             bool IsMMapIsLoaded(uint32 mapId, uint32 x, uint32 y) const;
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the query is owned by the caller until the lease is destroyed, empty lease if map mesh isn't loaded
+            NavMeshQueryLease LeaseNavMeshQuery(uint32 mapId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
             dtNavMesh const* GetGONavMesh(uint32 displayId);
+            NavPathCache* GetPathCache(uint32 mapId);
+            // setting poly areas changes the cost of cached corridors
+            void InvalidatePathCache(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            void getPathCacheStats(uint64& hits, uint64& misses, uint32& size) const;
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y) const;
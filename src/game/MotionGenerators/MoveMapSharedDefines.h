@@ -23,6 +23,7 @@
 #include <Detour/Include/DetourNavMesh.h>
 
 #define MMAP_MAGIC 0x4d4d4150   // 'MMAP'
+#define MMAP_ZLIB_MAGIC 0x4d4d415a  // 'MMAZ', the header is followed by the uint32 size of the zlib compressed tile data and the data
 #define MMAP_VERSION 7
 
 struct MmapTileHeader
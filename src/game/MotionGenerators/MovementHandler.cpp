@@ -29,6 +29,7 @@
 #include "Maps/MapPersistentStateMgr.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/Vehicle.h"
+#include "World/World.h"
 
 #include <boost/accumulators/statistics/variance.hpp>
 #include <boost/accumulators/accumulators.hpp>
@@ -341,7 +342,10 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     WorldPacket data(opcode, recv_data.size());
     data << mover->GetPackGUID();             // write guid
     movementInfo.Write(data);                               // write data
-    mover->SendMessageToSetExcept(data, _player);
+    if (sWorld.getConfig(CONFIG_BOOL_MOVEMENT_RELAY_BATCH) && mover->IsInWorld())
+        mover->GetMap()->RelayMovement(mover, _player, data);
+    else
+        mover->SendMessageToSetExcept(data, _player);
 }
 
 void WorldSession::HandleForceSpeedChangeAckOpcodes(WorldPacket& recv_data)
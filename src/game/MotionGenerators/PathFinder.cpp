@@ -36,38 +36,26 @@
 PathFinder::PathFinder() :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(nullptr), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(0)
+    m_sourceUnit(nullptr), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(0)
 {
-    //MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-    //m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
-
     //createFilter();
 }
 
-PathFinder::PathFinder(uint32 mapId, uint32 instanceId) :
+PathFinder::PathFinder(uint32 mapId, uint32 /*instanceId*/) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(nullptr), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(mapId)
+    m_sourceUnit(nullptr), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(mapId)
 {
-    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-    m_defaultNavMeshQuery = mmap->GetNavMeshQuery(mapId, instanceId);
-
     createFilter();
 }
 
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_straightLine(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH), // TODO: Fix legitimate long paths
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId())
+    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr), m_cachedPoints(m_pointPathLimit* VERTEX_SIZE), m_pathPolyRefs(m_pointPathLimit), m_smoothPathPolyRefs(m_pointPathLimit), m_defaultMapId(m_sourceUnit->GetMapId())
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
-    if (MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
-    {
-        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
-    }
-
     createFilter();
 }
 
@@ -77,8 +65,12 @@ PathFinder::~PathFinder()
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
 }
 
-void PathFinder::SetCurrentNavMesh()
+void PathFinder::SetCurrentNavMesh(MMAP::NavMeshQueryLease& queryLease)
 {
+    m_navMesh = nullptr;
+    m_navMeshQuery = nullptr;
+    m_pathCache = nullptr;
+
     if (m_sourceUnit && MMAP::MMapFactory::IsPathfindingEnabled(m_sourceUnit->GetMapId(), m_sourceUnit))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
@@ -86,10 +78,9 @@ void PathFinder::SetCurrentNavMesh()
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
         else
         {
-            if (m_defaultMapId != m_sourceUnit->GetMapId())
-                m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
-
-            m_navMeshQuery = m_defaultNavMeshQuery;
+            queryLease = mmap->LeaseNavMeshQuery(m_sourceUnit->GetMapId());
+            m_navMeshQuery = queryLease.get();
+            m_pathCache = mmap->GetPathCache(m_sourceUnit->GetMapId());
         }
 
         if (m_navMeshQuery)
@@ -99,7 +90,9 @@ void PathFinder::SetCurrentNavMesh()
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
 
-        m_navMeshQuery = m_defaultNavMeshQuery;
+        queryLease = mmap->LeaseNavMeshQuery(m_defaultMapId);
+        m_navMeshQuery = queryLease.get();
+        m_pathCache = mmap->GetPathCache(m_defaultMapId);
 
         if (m_navMeshQuery)
             m_navMesh = m_navMeshQuery->getAttachedNavMesh();
@@ -145,7 +138,9 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
     m_forceDestination = forceDest;
     m_straightLine = straightLine;
 
-    SetCurrentNavMesh();
+    // query is only ours until we return
+    MMAP::NavMeshQueryLease queryLease;
+    SetCurrentNavMesh(queryLease);
 
     if (m_sourceUnit)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
@@ -173,7 +168,7 @@ void PathFinder::setArea(uint32 mapId, float x, float y, float z, uint32 area, f
 
     MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
 
-    dtNavMeshQuery const* query = mmap->GetNavMeshQuery(mapId, 0);
+    MMAP::NavMeshQueryLease query = mmap->LeaseNavMeshQuery(mapId);
     dtNavMesh const* cnavMesh = mmap->GetNavMesh(mapId);
     dtNavMesh* navMesh = const_cast<dtNavMesh*> (cnavMesh);
     dtQueryFilter m_filter;
@@ -220,6 +215,8 @@ void PathFinder::setArea(uint32 mapId, float x, float y, float z, uint32 area, f
         if (curArea != 8 && curArea < area)
             dtStatus status = navMesh->setPolyArea(m_polys[i], area);
     }
+
+    mmap->InvalidatePathCache(mapId);
 }
 
 uint32 PathFinder::getArea(uint32 mapId, float x, float y, float z)
@@ -229,7 +226,7 @@ uint32 PathFinder::getArea(uint32 mapId, float x, float y, float z)
 
     MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
 
-    dtNavMeshQuery const* query = mmap->GetNavMeshQuery(mapId, 0);
+    MMAP::NavMeshQueryLease query = mmap->LeaseNavMeshQuery(mapId);
     dtNavMesh const* cnavMesh = mmap->GetNavMesh(mapId);
     dtNavMesh* navMesh = const_cast<dtNavMesh*> (cnavMesh);
     dtQueryFilter m_filter;
@@ -259,7 +256,7 @@ unsigned short PathFinder::getFlags(uint32 mapId, float x, float y, float z)
 
     MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
 
-    dtNavMeshQuery const* query = mmap->GetNavMeshQuery(mapId, 0);
+    MMAP::NavMeshQueryLease query = mmap->LeaseNavMeshQuery(mapId);
     dtNavMesh const* cnavMesh = mmap->GetNavMesh(mapId);
     dtNavMesh* navMesh = const_cast<dtNavMesh*> (cnavMesh);
     dtQueryFilter m_filter;
@@ -614,15 +611,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         if (!m_straightLine)
         {
-            dtResult = m_navMeshQuery->findPath(
-                startPoly,          // start polygon
-                endPoly,            // end polygon
-                startPoint,         // start position
-                endPoint,           // end position
-                &m_filter,          // polygon search filter
-                m_pathPolyRefs.data(), // [out] path
-                (int*)&m_polyLength,
-                m_pointPathLimit / 2);   // max number of polygons in output path
+            dtResult = findPolyPath(startPoly, endPoly, startPoint, endPoint);
         }
         else
         {
@@ -678,6 +667,47 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+dtStatus PathFinder::findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint)
+{
+    uint32 const maxPolys = m_pointPathLimit / 2;
+
+    MMAP::NavPathCacheKey key;
+    uint32 tilesVersion = 0;
+    if (m_pathCache)
+    {
+        uint32 areaCostHash = 2166136261u;
+        for (int32 i = 0; i < DT_MAX_AREAS; ++i)
+        {
+            float cost = m_filter.getAreaCost(i);
+            uint32 bits;
+            memcpy(&bits, &cost, sizeof(bits));
+            areaCostHash = (areaCostHash ^ bits) * 16777619u;
+        }
+
+        key = { startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags(), areaCostHash, maxPolys };
+
+        m_polyLength = m_pathCache->Find(key, m_pathPolyRefs.data(), tilesVersion);
+        if (m_polyLength)
+            return DT_SUCCESS;
+    }
+
+    dtStatus dtResult = m_navMeshQuery->findPath(
+        startPoly,          // start polygon
+        endPoly,            // end polygon
+        startPoint,         // start position
+        endPoint,           // end position
+        &m_filter,          // polygon search filter
+        m_pathPolyRefs.data(), // [out] path
+        (int*)&m_polyLength,
+        maxPolys);          // max number of polygons in output path
+
+    // only complete corridors, partial ones depend on the exact positions
+    if (m_pathCache && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) && m_polyLength)
+        m_pathCache->Store(key, tilesVersion, m_pathPolyRefs.data(), m_polyLength);
+
+    return dtResult;
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     if (m_pointPathLimit * VERTEX_SIZE > m_cachedPoints.size())
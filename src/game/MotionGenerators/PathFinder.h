@@ -35,6 +35,12 @@ using Movement::PointsArray;
 
 class Unit;
 
+namespace MMAP
+{
+    class NavMeshQueryLease;
+    class NavPathCache;
+}
+
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
@@ -117,9 +123,9 @@ private:
 
     const Unit* const       m_sourceUnit;       // the unit that is moving
     const dtNavMesh* m_navMesh;          // the nav mesh
-    const dtNavMeshQuery* m_navMeshQuery;     // the nav mesh query used to find the path
+    const dtNavMeshQuery* m_navMeshQuery;     // the nav mesh query used to find the path, valid only inside calculate()
+    MMAP::NavPathCache*   m_pathCache;        // corridors of the map mesh in use, null on transports or when disabled
 
-    const dtNavMeshQuery* m_defaultNavMeshQuery;     // the nav mesh query used to find the path
     uint32                  m_defaultMapId;
 
     dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
@@ -128,7 +134,7 @@ private:
     void setEndPosition(const Vector3& point) { m_actualEndPosition = point; m_endPosition = point; }
     void setActualEndPosition(const Vector3& point) { m_actualEndPosition = point; }
     void NormalizePath();
-    void SetCurrentNavMesh();
+    void SetCurrentNavMesh(MMAP::NavMeshQueryLease& queryLease);
 
     void clear()
     {
@@ -145,6 +151,7 @@ private:
     bool HaveTile(const Vector3& p) const;
 
     void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+    dtStatus findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPoint, const float* endPoint);
     void BuildPointPath(const float* startPoint, const float* endPoint);
     void BuildShortcut();
 
@@ -324,7 +324,19 @@ void FixedPathMovementGenerator::AddToPathPauseTime(int32 waitTimeDiff, bool for
 
 void TaxiMovementGenerator::Initialize(Unit& unit)
 {
-    AbstractPathMovementGenerator::Initialize(unit);
+    // the flight of a player is taken from its taxi tracker on Resume, the parent path stays empty
+    if (unit.GetTypeId() == TYPEID_PLAYER)
+    {
+        if (!unit.movespline->Finalized())
+        {
+            if (unit.IsClientControlled())
+                unit.StopMoving(true);
+            else
+                unit.InterruptMoving();
+        }
+    }
+    else
+        AbstractPathMovementGenerator::Initialize(unit);
 
     // Client-controlled unit should have control removed
     if (const Player* controllingClientPlayer = unit.GetClientControlling())
@@ -379,9 +391,10 @@ bool TaxiMovementGenerator::Update(Unit& unit, const uint32& diff)
 
 bool TaxiMovementGenerator::Move(Unit& unit)
 {
+    Movement::PointsArray const& points = m_taxiSpline ? *m_taxiSpline : m_spline;
+
     Movement::MoveSplineInit init(unit);
-    Movement::PointsArray& spline = init.Path();
-    std::copy((m_spline.begin() + m_pathIndex), m_spline.end(), back_inserter(spline));
+    init.Path().assign(points.begin() + m_pathIndex, points.end());
     init.SetFirstPointId(m_pathIndex);
     init.SetFly();
     init.SetVelocity(TAXI_FLIGHT_SPEED);
@@ -400,20 +413,8 @@ bool TaxiMovementGenerator::Resume(Unit& unit)
         if (!player.OnTaxiFlightSplineUpdate())
             return false;
 
-        // Load and execute the spline (transitional populating the parent movegen: to be reworked in the future)
-
-        auto nodes = player.GetTaxiPathSpline();
-        m_path.clear();
-        m_spline.clear();
-        m_spline.reserve(nodes.size());
-
-        uint32 i = 0;
-        for (auto itr = nodes.begin(); itr != nodes.end(); ++itr, ++i)
-        {
-            m_path.emplace(i, WaypointNode((*itr)->x, (*itr)->y, (*itr)->z , 0, 0, 0));
-            m_spline.push_back({ (*itr)->x, (*itr)->y, (*itr)->z });
-        }
-
+        // Execute the shared spline of the current map of the flight
+        m_taxiSpline = player.GetTaxiPathSplinePoints();
         m_pathIndex = player.GetTaxiPathSplineOffset();
     }
 
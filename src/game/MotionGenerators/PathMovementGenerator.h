@@ -23,6 +23,7 @@
 #include "MotionGenerators/WaypointManager.h"
 #include "Movement/MoveSplineInit.h"
 #include "Entities/ObjectGuid.h"
+#include "Entities/Taxi.h"
 
 #include <vector>
 
@@ -104,6 +105,8 @@ class TaxiMovementGenerator : public AbstractPathMovementGenerator
 
     protected:
         virtual bool Move(Unit& unit);
+
+        Taxi::Spline m_taxiSpline;                          // shared points of the flight of a player, m_spline is used otherwise
 };
 
 #endif
@@ -0,0 +1,202 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MotionGenerators/PathRequestQueue.h"
+#include "Maps/Map.h"
+#include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
+#include "Entities/Unit.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+// requests starting and ending in the same cells of this size share a path
+#define PATH_REQUEST_MERGE_SIZE 1.0f
+
+namespace
+{
+    struct PathJob
+    {
+        Unit const* unit;
+        Vector3 destination;
+        float pathLengthLimit;
+        std::vector<PathRequestPtr> requests;
+
+        PathType type;
+        PointsArray path;
+        uint32 solveTime;                                   // microseconds
+    };
+
+    // start cell, end cell, type id, entry (guid for players), in water, transport, path length limit
+    typedef std::tuple<int32, int32, int32, int32, int32, int32, uint32, uint32, bool, GenericTransport const*, float> PathJobKey;
+
+    int32 MergeCell(float coord)
+    {
+        return int32(std::floor(coord / PATH_REQUEST_MERGE_SIZE));
+    }
+
+    void SolvePathJob(PathJob& job)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        PathFinder pf(job.unit);
+        if (job.pathLengthLimit != 0.0f)
+            pf.setPathLengthLimit(job.pathLengthLimit);
+
+        pf.calculate(job.destination.x, job.destination.y, job.destination.z);
+
+        job.type = pf.getPathType();
+        job.path = pf.getPath();
+        job.solveTime = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    class PathSolveWorker : public Worker
+    {
+        public:
+            PathSolveWorker(PathJob* jobs, size_t count, MapUpdater& updater) :
+                Worker(updater), m_jobs(jobs), m_count(count)
+            {}
+
+            void execute() override
+            {
+                for (size_t i = 0; i < m_count; ++i)
+                    SolvePathJob(m_jobs[i]);
+
+                GetWorker().update_finished();
+            }
+
+        private:
+            PathJob* m_jobs;
+            size_t m_count;
+    };
+}
+
+PathRequestPtr PathRequestQueue::Submit(Unit const& owner, float x, float y, float z, float pathLength /*= 0.0f*/)
+{
+    PathRequestPtr request = std::make_shared<PathRequest>(owner.GetObjectGuid(), Vector3(x, y, z), pathLength);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_requests.push_back(request);
+    return request;
+}
+
+void PathRequestQueue::Solve(Map& map)
+{
+    std::vector<PathRequestPtr> requests;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        requests.swap(m_requests);
+    }
+
+    if (requests.empty())
+        return;
+
+    std::map<PathJobKey, size_t> jobIndex;
+    std::vector<PathJob> jobs;
+    for (PathRequestPtr const& request : requests)
+    {
+        // generator reset or deleted meanwhile
+        if (request.use_count() == 1)
+            continue;
+
+        Unit* unit = map.GetUnit(request->owner);
+        if (!unit || !unit->IsInWorld())
+        {
+            request->type = PATHFIND_NOPATH;
+            request->solved = true;
+            continue;
+        }
+
+        GenericTransport const* transport = unit->GetTransport();
+        float x, y, z;
+        unit->GetPosition(x, y, z, unit->GetTransport());
+
+        PathJobKey key(MergeCell(x), MergeCell(y), MergeCell(z),
+                       MergeCell(request->destination.x), MergeCell(request->destination.y), MergeCell(request->destination.z),
+                       unit->GetTypeId(), unit->GetTypeId() == TYPEID_PLAYER ? unit->GetGUIDLow() : unit->GetEntry(),
+                       unit->IsInWater(), transport, request->pathLengthLimit);
+
+        auto itr = jobIndex.find(key);
+        if (itr != jobIndex.end())
+        {
+            jobs[itr->second].requests.push_back(request);
+            continue;
+        }
+
+        jobIndex.emplace(key, jobs.size());
+        jobs.push_back({ unit, request->destination, request->pathLengthLimit, { request }, PATHFIND_BLANK, PointsArray(), 0 });
+    }
+
+    // units are only read while solving, nothing else of this map runs until all jobs are done
+    MapUpdater& cellUpdater = sMapMgr.GetCellUpdater();
+    uint32 const numThreads = sMapMgr.GetNumCellThreads();
+    if (cellUpdater.activated() && numThreads > 1 && jobs.size() > 1)
+    {
+        size_t chunkSize = (jobs.size() + numThreads - 1) / numThreads;
+        for (size_t i = 0; i < jobs.size(); i += chunkSize)
+            cellUpdater.schedule_update(new PathSolveWorker(&jobs[i], std::min(chunkSize, jobs.size() - i), cellUpdater));
+
+        cellUpdater.wait();
+    }
+    else
+    {
+        for (PathJob& job : jobs)
+            SolvePathJob(job);
+    }
+
+    for (PathJob& job : jobs)
+    {
+        for (PathRequestPtr const& request : job.requests)
+        {
+            request->type = job.type;
+            request->path = job.path;
+            request->solved = true;
+        }
+    }
+
+#ifdef BUILD_METRICS
+    if (!jobs.empty())
+    {
+        std::vector<uint32> solveTimes;
+        solveTimes.reserve(jobs.size());
+        for (PathJob const& job : jobs)
+            solveTimes.push_back(job.solveTime);
+        std::sort(solveTimes.begin(), solveTimes.end());
+
+        auto percentile = [&solveTimes](uint32 pct) { return solveTimes[(solveTimes.size() - 1) * pct / 100]; };
+
+        metric::measurement meas("map.pathfinding", {
+            { "map_id", std::to_string(map.GetId()) },
+            { "instance_id", std::to_string(map.GetInstanceId()) }
+        });
+        meas.add_field("requests", std::to_string(static_cast<int32>(requests.size())));
+        meas.add_field("solved", std::to_string(static_cast<int32>(jobs.size())));
+        meas.add_field("p50", std::to_string(percentile(50)));
+        meas.add_field("p95", std::to_string(percentile(95)));
+        meas.add_field("p99", std::to_string(percentile(99)));
+        meas.add_field("max", std::to_string(solveTimes.back()));
+    }
+#endif
+}
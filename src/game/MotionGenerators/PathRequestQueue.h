@@ -0,0 +1,65 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATH_REQUEST_QUEUE_H
+#define MANGOS_PATH_REQUEST_QUEUE_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "MotionGenerators/PathFinder.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Map;
+class Unit;
+
+// path requested by a movement generator, solved at the end of the update of the owner's map
+struct PathRequest
+{
+    PathRequest(ObjectGuid guid, Vector3 const& dest, float pathLength) :
+        owner(guid), destination(dest), pathLengthLimit(pathLength), type(PATHFIND_BLANK), solved(false) {}
+
+    ObjectGuid const owner;
+    Vector3 const destination;
+    float const pathLengthLimit;
+
+    // result, only valid once solved is set
+    PathType type;
+    PointsArray path;
+    bool solved;
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+// collects the path requests of one map during its update and solves them together, split between the
+// cell threads when those are enabled. units with the same movement abilities going between (almost) the
+// same points share one solve. a request dropped by its generator before the solve is skipped
+class PathRequestQueue
+{
+    public:
+        PathRequestPtr Submit(Unit const& owner, float x, float y, float z, float pathLength = 0.0f);
+        void Solve(Map& map);
+
+    private:
+        std::mutex m_lock;                                  // generators may run in cell threads
+        std::vector<PathRequestPtr> m_requests;
+};
+
+#endif
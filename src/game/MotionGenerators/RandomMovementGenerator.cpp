@@ -21,10 +21,14 @@
 #include "Movement/MoveSplineInit.h"
 #include "Movement/MoveSpline.h"
 #include "MotionGenerators/RandomMovementGenerator.h"
+#include "MotionGenerators/PathRequestQueue.h"
+#include "Maps/Map.h"
+#include "World/World.h"
 
 void AbstractRandomMovementGenerator::Initialize(Unit& owner)
 {
     owner.addUnitState(i_stateActive);
+    i_pathRequest.reset();
 
     // Client-controlled unit should have control removed
     if (const Player* controllingClientPlayer = owner.GetClientControlling())
@@ -49,6 +53,7 @@ void AbstractRandomMovementGenerator::Initialize(Unit& owner)
 void AbstractRandomMovementGenerator::Finalize(Unit& owner)
 {
     owner.clearUnitState(i_stateActive | i_stateMotion);
+    i_pathRequest.reset();
 
     // Client-controlled unit should have control restored
     if (const Player* controllingClientPlayer = owner.GetClientControlling())
@@ -69,6 +74,7 @@ void AbstractRandomMovementGenerator::Interrupt(Unit& owner)
     owner.InterruptMoving();
 
     owner.clearUnitState(i_stateMotion);
+    i_pathRequest.reset();
 }
 
 void AbstractRandomMovementGenerator::Reset(Unit& owner)
@@ -92,28 +98,50 @@ bool AbstractRandomMovementGenerator::Update(Unit& owner, const uint32& diff)
 
     if (owner.movespline->Finalized())
     {
+        // path requested from the map in a previous update
+        if (i_pathRequest)
+        {
+            if (!i_pathRequest->solved)
+                return true;
+
+            int32 duration = 0;
+            if (!(i_pathRequest->type & PATHFIND_NOPATH))
+                duration = _launchPath(owner, i_pathRequest->path);
+
+            i_pathRequest.reset();
+            _scheduleNextMove(owner, duration != 0);
+            return true;
+        }
+
         i_nextMoveTimer.Update(diff);
 
         if (i_nextMoveTimer.Passed())
         {
-            if (_setLocation(owner))
-            {
-                if (i_nextMoveCount > 1)
-                    --i_nextMoveCount;
-                else
-                {
-                    i_nextMoveCount = urand(1, i_nextMoveCountMax);
-                    i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
-                }
-            }
-            else
-                i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+            int32 duration = _setLocation(owner);
+            if (!i_pathRequest)
+                _scheduleNextMove(owner, duration != 0);
         }
     }
 
     return true;
 }
 
+void AbstractRandomMovementGenerator::_scheduleNextMove(Unit& owner, bool moved)
+{
+    if (moved)
+    {
+        if (i_nextMoveCount > 1)
+            --i_nextMoveCount;
+        else
+        {
+            i_nextMoveCount = urand(1, i_nextMoveCountMax);
+            i_nextMoveTimer.Reset(urand(i_nextMoveDelayMin, i_nextMoveDelayMax));
+        }
+    }
+    else
+        i_nextMoveTimer.Reset(owner.HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED) ? 100 : 500);
+}
+
 bool AbstractRandomMovementGenerator::_getLocation(Unit& owner, float& x, float& y, float& z)
 {
     return owner.GetMap()->GetReachableRandomPosition(&owner, x, y, z, i_radius);
@@ -127,6 +155,13 @@ int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
     if (!_getLocation(owner, x, y, z))
         return 0;
 
+    // creatures leave the path to the map, the move is launched once it is solved
+    if (owner.GetTypeId() == TYPEID_UNIT && sWorld.getConfig(CONFIG_BOOL_PATH_FIND_ASYNC))
+    {
+        i_pathRequest = owner.GetMap()->GetPathRequestQueue().Submit(owner, x, y, z, i_pathLength);
+        return 0;
+    }
+
     PathFinder pf(&owner);
 
     if (i_pathLength != 0.0f)
@@ -137,8 +172,13 @@ int32 AbstractRandomMovementGenerator::_setLocation(Unit& owner)
     if (pf.getPathType() & PATHFIND_NOPATH)
         return 0;
 
+    return _launchPath(owner, pf.getPath());
+}
+
+int32 AbstractRandomMovementGenerator::_launchPath(Unit& owner, PointsArray const& path)
+{
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(pf.getPath());
+    init.MovebyPath(path);
     init.SetWalk(i_walk);
 
     int32 duration = init.Launch();
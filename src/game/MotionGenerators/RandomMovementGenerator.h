@@ -22,6 +22,10 @@
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/ObjectGuid.h"
 
+#include <memory>
+
+struct PathRequest;
+
 class AbstractRandomMovementGenerator : public MovementGenerator
 {
     public:
@@ -43,6 +47,9 @@ class AbstractRandomMovementGenerator : public MovementGenerator
         virtual bool _getLocation(Unit& owner, float& x, float& y, float& z);
         virtual int32 _setLocation(Unit& owner);
 
+        int32 _launchPath(Unit& owner, PointsArray const& path);
+        void _scheduleNextMove(Unit& owner, bool moved);
+
         float i_x, i_y, i_z;
         float i_radius;
         float i_verticalZ;
@@ -52,6 +59,7 @@ class AbstractRandomMovementGenerator : public MovementGenerator
         uint32 i_nextMoveCount, i_nextMoveCountMax;
         uint32 i_nextMoveDelayMin, i_nextMoveDelayMax;
         uint32 i_stateActive, i_stateMotion;
+        std::shared_ptr<PathRequest> i_pathRequest;         // path being solved by the map, when async path finding is enabled
 };
 
 class ConfusedMovementGenerator : public AbstractRandomMovementGenerator
@@ -897,6 +897,72 @@ bool FollowMovementGenerator::Move(Unit& owner, float x, float y, float z)
     return true;
 }
 
+bool FollowMovementGenerator::MoveAlongLeaderPath(Unit& owner)
+{
+    if (!sWorld.getConfig(CONFIG_BOOL_FOLLOW_LEADER_PATH))
+        return false;
+
+    Unit* leader = i_target.getTarget();
+    if (owner.GetTypeId() != TYPEID_UNIT || owner.GetTransport() || leader->GetTransport())
+        return false;
+
+    // only a server controlled spline is known ahead, and only a linear one is walked as its points
+    if (leader->HasFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_PLAYER_CONTROLLED))
+        return false;
+
+    Movement::MoveSpline const& leaderSpline = *leader->movespline;
+    if (!leaderSpline.Initialized() || leaderSpline.Finalized() || leaderSpline.isCyclic() ||
+        leaderSpline._Spline().mode() != Movement::SplineBase::ModeLinear)
+        return false;
+
+    int32 const next = leaderSpline._currentSplineIdx() + 1;
+    int32 const last = leaderSpline._Spline().last();
+    if (next > last)
+        return false;
+
+    if (!owner.movespline->Finalized())
+        owner.UpdateSplinePosition(true);
+
+    Map const* map = owner.GetMap();
+    float const height = owner.GetCollisionHeight();
+    float const range = GetDynamicTargetDistance(owner, false);
+
+    PointsArray path;
+    path.push_back(G3D::Vector3(owner.GetPositionX(), owner.GetPositionY(), owner.GetPositionZ()));
+
+    // the leader faces along the segment it walks, the follower keeps its place relative to that facing
+    G3D::Vector3 from(leader->GetPositionX(), leader->GetPositionY(), leader->GetPositionZ());
+    float o = leader->GetOrientation();
+    for (int32 i = next; i <= last; ++i)
+    {
+        G3D::Vector3 const& point = leaderSpline._Spline().getPoint(i);
+        if ((point - from).xy().squaredLength() > 0.01f)
+            o = atan2(point.y - from.y, point.x - from.x);
+        from = point;
+
+        G3D::Vector3 shifted(point.x + range * cos(o + GetAngle()), point.y + range * sin(o + GetAngle()), point.z);
+        owner.UpdateAllowedPositionZ(shifted.x, shifted.y, shifted.z);
+
+        // a shifted point behind a wall or below a ledge needs a path of its own
+        G3D::Vector3 const& previous = path.back();
+        if (!map->IsInLineOfSight(point.x, point.y, point.z + height, shifted.x, shifted.y, shifted.z + height, owner.GetPhaseMask(), true) ||
+            !map->IsInLineOfSight(previous.x, previous.y, previous.z + height, shifted.x, shifted.y, shifted.z + height, owner.GetPhaseMask(), true))
+            return false;
+
+        path.push_back(shifted);
+    }
+
+    _addUnitStateMove(owner);
+
+    Movement::MoveSplineInit init(owner);
+    init.MovebyPath(path);
+    init.SetWalk(EnableWalking());
+    init.SetVelocity(GetSpeed(owner));
+    init.Launch();
+
+    return true;
+}
+
 bool FollowMovementGenerator::_getOrientation(Unit& owner, float& o) const
 {
     if (!i_target.isValid())
@@ -981,9 +1047,14 @@ void FollowMovementGenerator::_setLocation(Unit& owner, bool movingNow)
 
     float x, y, z;
 
-    _getLocation(owner, x, y, z, movingNow);
+    if (movingNow && MoveAlongLeaderPath(owner))
+        i_targetReached = false;
+    else
+    {
+        _getLocation(owner, x, y, z, movingNow);
+        i_targetReached = !Move(owner, x, y, z);
+    }
 
-    i_targetReached = !Move(owner, x, y, z);
     i_speedChanged = false;
     m_targetFaced = false;
 }
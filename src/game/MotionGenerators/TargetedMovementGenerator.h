@@ -217,6 +217,8 @@ class FollowMovementGenerator : public TargetedMovementGeneratorMedium<Unit, Fol
         virtual bool IsUnstuckAllowed(Unit& owner) const;
 
         virtual bool Move(Unit& owner, float x, float y, float z);
+        // launches the rest of a moving creature leader's spline shifted by the follow offset, without a path search
+        bool MoveAlongLeaderPath(Unit& owner);
 
     private:
         virtual bool _getOrientation(Unit& owner, float& o) const;
@@ -186,8 +186,8 @@ void WaypointManager::Load()
         while (result->NextRow());
         delete result;
 
-        //                                   0   1      2           3           4           5            6         7
-        result = WorldDatabase.Query("SELECT id, point, position_x, position_y, position_z, orientation, waittime, script_id FROM creature_movement");
+        //                                           0   1      2           3           4           5            6         7
+        result = WorldDatabase.QueryStreamed("SELECT id, point, position_x, position_y, position_z, orientation, waittime, script_id FROM creature_movement");
 
         BarGoLink bar(result->GetRowCount());
 
@@ -314,8 +314,8 @@ void WaypointManager::Load()
         while (result->NextRow());
         delete result;
 
-        //                                   0      1       2      3           4           5           6            7
-        result = WorldDatabase.Query("SELECT entry, pathId, point, position_x, position_y, position_z, orientation, waittime, script_id FROM creature_movement_template");
+        //                                           0      1       2      3           4           5           6            7
+        result = WorldDatabase.QueryStreamed("SELECT entry, pathId, point, position_x, position_y, position_z, orientation, waittime, script_id FROM creature_movement_template");
 
         BarGoLink bar(result->GetRowCount());
         std::set<uint32> blacklistWaypoints;
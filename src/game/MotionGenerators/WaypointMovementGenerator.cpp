@@ -264,6 +264,9 @@ uint32 WaypointMovementGenerator<Creature>::BuildIntPath(PointsArray& path, Crea
 static const uint32 MinimumPathTime = 6000;
 // client need to receive new path before the end of previous path (much higher value have been seen in sniff)
 static const uint32 PreSendTime     = 1500;
+// past the minimum time the path goes on through the nodes without delay nor script, up to these limits
+static const uint32 MaximumPathTime   = 60000;
+static const uint32 MaximumPathPoints = 200;
 
 // build and send path to next node
 void WaypointMovementGenerator<Creature>::SendNextWayPointPath(Creature& creature)
@@ -319,8 +322,10 @@ void WaypointMovementGenerator<Creature>::SendNextWayPointPath(Creature& creatur
     uint32 travelTime = BuildIntPath(genPath, creature, Vector3(nextNode->x, nextNode->y, nextNode->z));
 
     auto currPointItr = m_currentWaypointNode;
-    // add more node until travel time is big enough
-    while (!nextNode->delay && travelTime < MinimumPathTime)
+    // add more node until travel time is big enough, then keep adding the plain nodes so that a patrol
+    // is sent in one spline per stretch between stops and scripts instead of one every few nodes
+    while (!nextNode->delay && (travelTime < MinimumPathTime ||
+        (!nextNode->script_id && travelTime < MaximumPathTime && genPath.size() < MaximumPathPoints)))
     {
         // we'll add path to node after this one too to make animation more smoother
         auto nodeAfterItr = currPointItr;
@@ -166,6 +166,7 @@ namespace Movement
         splineflags = args.flags;
         facing = args.facing;
         m_Id = args.splineId;
+        m_createCache.clear();
         point_Idx_offset = args.path_Idx_offset;
         initialOrientation = args.initialOrientation;
 
@@ -196,7 +197,8 @@ namespace Movement
     }
 
     MoveSpline::MoveSpline() : m_Id(0), speed(0), time_passed(0),
-        vertical_acceleration(0.f), initialOrientation(0.f), effect_start_time(0), point_Idx(0), point_Idx_offset(0)
+        vertical_acceleration(0.f), initialOrientation(0.f), effect_start_time(0), point_Idx(0), point_Idx_offset(0),
+        m_createCache(0), m_createCacheFlags(0), m_createCacheTimePos(0)
     {
         splineflags.done = true;
     }
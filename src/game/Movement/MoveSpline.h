@@ -21,6 +21,7 @@
 
 #include "spline.h"
 #include "MoveSplineInitArgs.h"
+#include "ByteBuffer.h"
 
 namespace Movement
 {
@@ -81,6 +82,12 @@ namespace Movement
             int32           point_Idx;
             int32           point_Idx_offset;
 
+            // spline part of the create block without the time passed, written by PacketBuilder::WriteCreate
+            // for every player the unit becomes visible to and rebuilt when the spline or its flags change
+            mutable ByteBuffer m_createCache;
+            mutable uint32     m_createCacheFlags;
+            mutable size_t     m_createCacheTimePos;
+
             void init_spline(const MoveSplineInitArgs& args);
         protected:
 
@@ -120,6 +127,13 @@ namespace Movement
             void updateState(uint32 difftime)
             {
                 MANGOS_ASSERT(Initialized());
+                // nearly every update stays within the current segment, only a point reached needs _updateState
+                if (!Finalized() && difftime < segment_time_elapsed())
+                {
+                    time_passed += difftime;
+                    return;
+                }
+
                 do _updateState(difftime);
                 while (difftime > 0);
             }
@@ -141,36 +141,50 @@ namespace Movement
         {
             MoveSplineFlag splineFlags = move_spline.splineflags;
 
-            data << splineFlags.raw();
-
-            if (splineFlags.final_angle)
-            {
-                data << move_spline.facing.angle;
-            }
-            else if (splineFlags.final_target)
+            // flags change in place when the spline finishes or enters its cycle
+            ByteBuffer& cache = move_spline.m_createCache;
+            if (cache.empty() || move_spline.m_createCacheFlags != splineFlags.raw())
             {
-                data << move_spline.facing.target;
-            }
-            else if (splineFlags.final_point)
-            {
-                data << move_spline.facing.f.x << move_spline.facing.f.y << move_spline.facing.f.z;
+                cache.clear();
+                cache << splineFlags.raw();
+
+                if (splineFlags.final_angle)
+                {
+                    cache << move_spline.facing.angle;
+                }
+                else if (splineFlags.final_target)
+                {
+                    cache << move_spline.facing.target;
+                }
+                else if (splineFlags.final_point)
+                {
+                    cache << move_spline.facing.f.x << move_spline.facing.f.y << move_spline.facing.f.z;
+                }
+
+                move_spline.m_createCacheTimePos = cache.size();
+
+                cache << move_spline.Duration();
+                cache << move_spline.GetId();
+
+                cache << float(1.f);                        // splineInfo.duration_mod; added in 3.1
+                cache << float(1.f);                        // splineInfo.duration_mod_next; added in 3.1
+
+                cache << move_spline.vertical_acceleration; // added in 3.1
+                cache << move_spline.effect_start_time;     // added in 3.1
+
+                uint32 nodes = move_spline.getPath().size();
+                cache << nodes;
+                cache.append<Vector3>(&move_spline.getPath()[0], nodes);
+                cache << uint8(move_spline.spline.mode());  // added in 3.1
+                cache << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+
+                move_spline.m_createCacheFlags = splineFlags.raw();
             }
 
+            size_t const timePos = move_spline.m_createCacheTimePos;
+            data.append(cache.contents(), timePos);
             data << move_spline.timePassed();
-            data << move_spline.Duration();
-            data << move_spline.GetId();
-
-            data << float(1.f);                             // splineInfo.duration_mod; added in 3.1
-            data << float(1.f);                             // splineInfo.duration_mod_next; added in 3.1
-
-            data << move_spline.vertical_acceleration;      // added in 3.1
-            data << move_spline.effect_start_time;          // added in 3.1
-
-            uint32 nodes = move_spline.getPath().size();
-            data << nodes;
-            data.append<Vector3>(&move_spline.getPath()[0], nodes);
-            data << uint8(move_spline.spline.mode());       // added in 3.1
-            data << (move_spline.isCyclic() ? Vector3::zero() : move_spline.FinalDestination());
+            data.append(cache.contents() + timePos, cache.size() - timePos);
         }
     }
 }
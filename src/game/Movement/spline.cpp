@@ -157,7 +157,7 @@ namespace Movement
         return (points[index] - points[index + 1]).length();
     }
 
-    float SplineBase::SegLengthCatmullRom(index_type index) const
+    MANGOS_SIMD_KERNEL float SplineBase::SegLengthCatmullRom(index_type index) const
     {
         MANGOS_ASSERT(index >= index_lo && index < index_hi);
 
@@ -177,7 +177,7 @@ namespace Movement
         return length;
     }
 
-    float SplineBase::SegLengthBezier3(index_type index) const
+    MANGOS_SIMD_KERNEL float SplineBase::SegLengthBezier3(index_type index) const
     {
         index *= 3u;
         MANGOS_ASSERT(index >= index_lo && index < index_hi);
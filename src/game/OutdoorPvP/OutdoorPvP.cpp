@@ -21,6 +21,10 @@
 #include "Entities/GameObject.h"
 #include "Entities/Player.h"
 #include "Globals/ObjectMgr.h"
+#include "Server/WorldSession.h"
+#include "WorldPacket.h"
+
+#include <deque>
 
 /**
    Function that adds a player to the players of the affected outdoor pvp zones
@@ -31,6 +35,10 @@
 void OutdoorPvP::HandlePlayerEnterZone(Player* player, bool isMainZone)
 {
     m_zonePlayers[player->GetObjectGuid()] = isMainZone;
+
+    RemoveMainZonePlayer(player->GetObjectGuid());
+    if (isMainZone)
+        m_mainZonePlayers[GetTeamIndexByTeamId(player->GetTeam())].emplace_back(player->GetObjectGuid(), player->GetSession());
 }
 
 /**
@@ -43,6 +51,8 @@ void OutdoorPvP::HandlePlayerLeaveZone(Player* player, bool isMainZone)
 {
     if (m_zonePlayers.erase(player->GetObjectGuid()))
     {
+        RemoveMainZonePlayer(player->GetObjectGuid());
+
         // remove the world state information from the player
         if (isMainZone && !player->GetSession()->PlayerLogout())
             SendRemoveWorldStates(player);
@@ -59,14 +69,58 @@ void OutdoorPvP::HandlePlayerLeaveZone(Player* player, bool isMainZone)
  */
 void OutdoorPvP::SendUpdateWorldState(uint32 field, uint32 value)
 {
-    for (GuidZoneMap::const_iterator itr = m_zonePlayers.begin(); itr != m_zonePlayers.end(); ++itr)
+    // only send world state update to main zone
+    WorldPacket data(SMSG_UPDATE_WORLD_STATE, 8);
+    data << field;
+    data << value;
+
+    SharedWorldPacket packet(data);
+    for (ZonePlayerList const& players : m_mainZonePlayers)
+        for (OutdoorPvPZonePlayer const& zonePlayer : players)
+            zonePlayer.session->SendPacket(packet);
+}
+
+/**
+   Function that updates several world states for all the players of the outdoor pvp zone
+
+   @param   world states to update with their new values
+ */
+void OutdoorPvP::SendUpdateWorldStates(WorldStateValueList const& states)
+{
+    if (states.empty())
+        return;
+
+    // the client has no packet for several states, each one is built once and queued to each session in turn
+    std::deque<WorldPacket> packets;
+    std::deque<SharedWorldPacket> sharedPackets;
+    for (auto const& state : states)
+    {
+        packets.emplace_back(SMSG_UPDATE_WORLD_STATE, 8);
+        packets.back() << state.first;
+        packets.back() << state.second;
+        sharedPackets.emplace_back(packets.back());
+    }
+
+    for (ZonePlayerList const& players : m_mainZonePlayers)
+        for (OutdoorPvPZonePlayer const& zonePlayer : players)
+            for (SharedWorldPacket const& packet : sharedPackets)
+                zonePlayer.session->SendPacket(packet);
+}
+
+void OutdoorPvP::RemoveMainZonePlayer(ObjectGuid guid)
+{
+    for (ZonePlayerList& players : m_mainZonePlayers)
     {
-        // only send world state update to main zone
-        if (!itr->second)
-            continue;
+        for (size_t i = 0; i < players.size(); ++i)
+        {
+            if (players[i].guid != guid)
+                continue;
 
-        if (Player* player = sObjectMgr.GetPlayer(itr->first))
-            player->SendUpdateWorldState(field, value);
+            // the order does not matter, fill the gap with the last player
+            players[i] = players.back();
+            players.pop_back();
+            return;
+        }
     }
 }
 
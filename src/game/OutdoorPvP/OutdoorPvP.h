@@ -26,6 +26,7 @@
 #include "OutdoorPvPMgr.h"
 
 class WorldPacket;
+class WorldSession;
 
 enum CapturePointArtKits
 {
@@ -43,6 +44,18 @@ enum CapturePointAnimations
 
 typedef std::map<ObjectGuid /*playerGuid*/, bool /*isMainZone*/> GuidZoneMap;
 
+// player of the main zone, with the session the zone broadcasts are sent to
+struct OutdoorPvPZonePlayer
+{
+    OutdoorPvPZonePlayer(ObjectGuid _guid, WorldSession* _session) : guid(_guid), session(_session) {}
+
+    ObjectGuid guid;
+    WorldSession* session;
+};
+
+typedef std::vector<OutdoorPvPZonePlayer> ZonePlayerList;
+typedef std::vector<std::pair<uint32 /*field*/, uint32 /*value*/> > WorldStateValueList;
+
 class OutdoorPvP
 {
         friend class OutdoorPvPMgr;
@@ -91,6 +104,9 @@ class OutdoorPvP
         // send world state update to all players present
         void SendUpdateWorldState(uint32 field, uint32 value);
 
+        // send several world state updates to all players present in one pass
+        void SendUpdateWorldStates(WorldStateValueList const& states);
+
         // set banner visual
         void SetBannerVisual(const WorldObject* objRef, ObjectGuid goGuid, uint32 artKit, uint32 animId);
         void SetBannerVisual(GameObject* go, uint32 artKit, uint32 animId);
@@ -124,12 +140,18 @@ class OutdoorPvP
         // get banner artkit based on controlling team
         uint32 GetBannerArtKit(Team team, uint32 artKitAlliance = CAPTURE_ARTKIT_ALLIANCE, uint32 artKitHorde = CAPTURE_ARTKIT_HORDE, uint32 artKitNeutral = CAPTURE_ARTKIT_NEUTRAL) const;
 
+        // drop the player from the main zone players
+        void RemoveMainZonePlayer(ObjectGuid guid);
+
         // Handle gameobject spawn / despawn
         void RespawnGO(const WorldObject* objRef, ObjectGuid goGuid, bool respawn);
 
         // store the players inside the area
         GuidZoneMap m_zonePlayers;
 
+        // the players of m_zonePlayers inside the main zone, by team
+        ZonePlayerList m_mainZonePlayers[PVP_TEAM_COUNT];
+
         bool m_isBattlefield;
 };
 
@@ -59,6 +59,7 @@
 #include "../AI/PlayerbotWarlockAI.h"
 #include "../AI/PlayerbotWarriorAI.h"
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 
@@ -74,6 +75,34 @@ enum NPCFlags VENDOR_MASK = (enum NPCFlags)(UNIT_NPC_FLAG_VENDOR
                             | UNIT_NPC_FLAG_VENDOR_POISON
                             | UNIT_NPC_FLAG_VENDOR_REAGENT);
 
+// microseconds the bots spent thinking in the current map tick, the maps update on their own threads
+static thread_local uint32 s_tickThinkTime = 0;
+
+// scope of a full decision: invalidates the views of the previous one and adds its time
+// to the think time of the map tick, whatever way it returns
+class PlayerbotDecision
+{
+    public:
+        PlayerbotDecision(PlayerbotAI& ai) : m_ai(ai), m_start(std::chrono::steady_clock::now())
+        {
+            ++m_ai.m_decisionCount;
+            m_ai.m_deciding = true;
+            m_ai.m_unreadySpells.clear();
+        }
+
+        ~PlayerbotDecision()
+        {
+            m_ai.m_deciding = false;
+            uint32 elapsed = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count());
+            s_tickThinkTime += elapsed;
+            m_ai.m_thinkTime += elapsed;
+        }
+
+    private:
+        PlayerbotAI& m_ai;
+        std::chrono::steady_clock::time_point m_start;
+};
+
 // ChatHandler already implements some useful commands the master can call on bots
 // These commands are protected inside the ChatHandler class so this class provides access to the commands
 // we'd like to call on our bots
@@ -89,6 +118,9 @@ class PlayerbotChatHandler : protected ChatHandler
 
 PlayerbotAI::PlayerbotAI(PlayerbotMgr &mgr, Player* const bot, bool debugWhisper) :
     m_mgr(mgr), m_bot(bot), m_classAI(0), m_ignoreAIUpdatesUntilTime(CurrentTime()),
+    m_thinkTimer(urand(0, mgr.m_confThinkInterval)),        // spread the decisions of bots summoned together
+    m_thinkOverdue(0), m_decisionCount(0), m_deciding(false), m_attackerInfoDecision(0), m_thinkTime(0),
+    m_inventoryIndexValid(false), m_inventoryIndexBuilds(0),
     m_combatOrder(ORDERS_NONE), m_ScenarioType(SCENARIO_PVE),
     m_CurrentlyCastingSpellId(0), m_CraftSpellId(0), m_spellIdCommand(0),
     m_targetGuidCommand(ObjectGuid()),
@@ -347,8 +379,8 @@ uint32 PlayerbotAI::initSpell(uint32 spellId)
         return 0;
 
     uint32 next = 0;
-    SpellChainMapNext const& nextMap = sSpellMgr.GetSpellChainNext();
-    for (SpellChainMapNext::const_iterator itr = nextMap.lower_bound(spellId); itr != nextMap.upper_bound(spellId); ++itr)
+    SpellChainMapNext::Bounds bounds = sSpellMgr.GetSpellChainNext().equal_range(spellId);
+    for (SpellChainMapNext::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
         SpellChainNode const* node = sSpellMgr.GetSpellChainNode(itr->second);
         // If next spell is a requirement for this one then skip it
@@ -2883,224 +2915,112 @@ Item* PlayerbotAI::FindMount(uint32 matchingRidingSkill) const
     return partialMatch;
 }
 
-Item* PlayerbotAI::FindFood() const
-{
-    // list out items in main backpack
-    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
-    {
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
-        if (pItem)
-        {
-            const ItemPrototype* const pItemProto = pItem->GetProto();
-            if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                continue;
-
-            if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_FOOD)
-                // if is FOOD
-                // this enum is no longer defined in mangos. Is it no longer valid?
-                // according to google it was 11
-                if (pItemProto->Spells[0].SpellCategory == 11)
-                    return pItem;
-        }
-    }
-    // list out items in other removable backpacks
-    for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)
-    {
-        const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);
-        if (pBag)
-            for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                Item* const pItem = m_bot->GetItemByPos(bag, slot);
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
-
-                    if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                        continue;
+static uint32 ItemClassKey(uint32 itemClass, uint32 itemSubClass) { return (itemClass << 8) | itemSubClass; }
 
-                    // this enum is no longer defined in mangos. Is it no longer valid?
-                    // according to google it was 11
-                    if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_FOOD)
-                        // if is FOOD
-                        // this enum is no longer defined in mangos. Is it no longer valid?
-                        // according to google it was 11
-                        // if (pItemProto->Spells[0].SpellCategory == SPELL_CATEGORY_FOOD)
-                        if (pItemProto->Spells[0].SpellCategory == 11)
-                            return pItem;
-                }
-            }
-    }
-    return nullptr;
+static std::vector<Item*> const* GetIndexedItems(PlayerbotAI::ItemIndex const& index, uint32 key)
+{
+    auto itr = index.find(key);
+    return itr != index.end() ? &itr->second : nullptr;
 }
 
-Item* PlayerbotAI::FindDrink() const
+// indexes the items of the main backpack and the other removable backpacks, in the order the searches used to walk them
+void PlayerbotAI::BuildInventoryIndex() const
 {
-    // list out items in main backpack
-    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
+    m_itemsByEntry.clear();
+    m_itemsByClass.clear();
+
+    auto addItem = [this](Item* pItem)
     {
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
-        if (pItem)
-        {
-            const ItemPrototype* const pItemProto = pItem->GetProto();
+        const ItemPrototype* const pItemProto = pItem->GetProto();
+        if (!pItemProto)
+            return;
 
-            if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                continue;
+        m_itemsByEntry[pItemProto->ItemId].push_back(pItem);
+        m_itemsByClass[ItemClassKey(pItemProto->Class, pItemProto->SubClass)].push_back(pItem);
+    };
 
-            if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_FOOD)
-                // if (pItemProto->Spells[0].SpellCategory == SPELL_CATEGORY_DRINK)
+    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
+        if (Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot))
+            addItem(pItem);
 
-                // this enum is no longer defined in mangos. Is it no longer valid?
-                // according to google it was 59
-                // if (pItemProto->Spells[0].SpellCategory == 59)
-                if (pItemProto->Spells[0].SpellCategory == 59)
-                    return pItem;
-        }
-    }
-    // list out items in other removable backpacks
     for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)
     {
         const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);
         if (pBag)
             for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                Item* const pItem = m_bot->GetItemByPos(bag, slot);
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
-
-                    if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                        continue;
-
-                    if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_FOOD)
-                        // if is WATER
-                        // SPELL_CATEGORY_DRINK is no longer defined in an enum in mangos
-                        // google says the valus is 59. Is this still valid?
-                        // if (pItemProto->Spells[0].SpellCategory == SPELL_CATEGORY_DRINK)
-                        if (pItemProto->Spells[0].SpellCategory == 59)
-                            return pItem;
-                }
-            }
+                if (Item* const pItem = m_bot->GetItemByPos(bag, slot))
+                    addItem(pItem);
     }
-    return nullptr;
+
+    m_inventoryIndexValid = true;
+    ++m_inventoryIndexBuilds;
 }
 
-Item* PlayerbotAI::FindBandage() const
+Item* PlayerbotAI::FindUsableItem(uint32 itemClass, uint32 itemSubClass, uint32 spellCategory) const
 {
-    // list out items in main backpack
-    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
-    {
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
-        if (pItem)
-        {
-            const ItemPrototype* const pItemProto = pItem->GetProto();
+    if (!m_inventoryIndexValid)
+        BuildInventoryIndex();
 
-            if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                continue;
+    std::vector<Item*> const* items = GetIndexedItems(m_itemsByClass, ItemClassKey(itemClass, itemSubClass));
+    if (!items)
+        return nullptr;
 
-            if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_BANDAGE)
-                return pItem;
-        }
-    }
-    // list out items in other removable backpacks
-    for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)
+    for (Item* pItem : *items)
     {
-        const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);
-        if (pBag)
-            for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                Item* const pItem = m_bot->GetItemByPos(bag, slot);
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
-
-                    if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                        continue;
+        const ItemPrototype* const pItemProto = pItem->GetProto();
+        if (m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
+            continue;
 
-                    if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == ITEM_SUBCLASS_BANDAGE)
-                        return pItem;
-                }
-            }
+        if (!spellCategory || pItemProto->Spells[0].SpellCategory == spellCategory)
+            return pItem;
     }
     return nullptr;
 }
-//Find Poison ...Natsukawa
-Item* PlayerbotAI::FindPoison() const
-{
-    // list out items in main backpack
-    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
-    {
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
-        if (pItem)
-        {
-            const ItemPrototype* const pItemProto = pItem->GetProto();
 
-            if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                continue;
-
-            if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == 6)
-                return pItem;
-        }
-    }
-    // list out items in other removable backpacks
-    for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)
-    {
-        const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);
-        if (pBag)
-            for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                Item* const pItem = m_bot->GetItemByPos(bag, slot);
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
+Item* PlayerbotAI::FindFood() const
+{
+    // this enum is no longer defined in mangos. Is it no longer valid?
+    // according to google it was 11
+    // if (pItemProto->Spells[0].SpellCategory == SPELL_CATEGORY_FOOD)
+    return FindUsableItem(ITEM_CLASS_CONSUMABLE, ITEM_SUBCLASS_FOOD, 11);
+}
 
-                    if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                        continue;
+Item* PlayerbotAI::FindDrink() const
+{
+    // SPELL_CATEGORY_DRINK is no longer defined in an enum in mangos
+    // google says the valus is 59. Is this still valid?
+    // if (pItemProto->Spells[0].SpellCategory == SPELL_CATEGORY_DRINK)
+    return FindUsableItem(ITEM_CLASS_CONSUMABLE, ITEM_SUBCLASS_FOOD, 59);
+}
 
-                    if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->SubClass == 6)
-                        return pItem;
-                }
-            }
-    }
-    return nullptr;
+Item* PlayerbotAI::FindBandage() const
+{
+    return FindUsableItem(ITEM_CLASS_CONSUMABLE, ITEM_SUBCLASS_BANDAGE);
+}
+//Find Poison ...Natsukawa
+Item* PlayerbotAI::FindPoison() const
+{
+    return FindUsableItem(ITEM_CLASS_CONSUMABLE, ITEM_SUBCLASS_ITEM_ENHANCEMENT);
 }
 
 Item* PlayerbotAI::FindConsumable(uint32 displayId) const
 {
-    // list out items in main backpack
-    for (uint8 slot = INVENTORY_SLOT_ITEM_START; slot < INVENTORY_SLOT_ITEM_END; slot++)
+    if (!m_inventoryIndexValid)
+        BuildInventoryIndex();
+
+    for (uint32 subClass = 0; subClass < MAX_ITEM_SUBCLASS_CONSUMABLE; ++subClass)
     {
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
-        if (pItem)
+        std::vector<Item*> const* items = GetIndexedItems(m_itemsByClass, ItemClassKey(ITEM_CLASS_CONSUMABLE, subClass));
+        if (!items)
+            continue;
+
+        for (Item* pItem : *items)
         {
             const ItemPrototype* const pItemProto = pItem->GetProto();
-
-            if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                continue;
-
-            if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->DisplayInfoID == displayId)
+            if (pItemProto->DisplayInfoID == displayId && m_bot->CanUseItem(pItemProto) == EQUIP_ERR_OK)
                 return pItem;
         }
     }
-    // list out items in other removable backpacks
-    for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)
-    {
-        const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);
-        if (pBag)
-            for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                Item* const pItem = m_bot->GetItemByPos(bag, slot);
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
-
-                    if (!pItemProto || m_bot->CanUseItem(pItemProto) != EQUIP_ERR_OK)
-                        continue;
-
-                    if (pItemProto->Class == ITEM_CLASS_CONSUMABLE && pItemProto->DisplayInfoID == displayId)
-                        return pItem;
-                }
-            }
-    }
     return nullptr;
 }
 
@@ -4455,18 +4375,23 @@ void PlayerbotAI::UpdateAttackersForTarget(Unit* victim)
     while (ref)
     {
         ThreatManager* target = ref->getSource();
-        ObjectGuid guid = target->getOwner()->GetObjectGuid();
-        m_attackerInfo[guid].attacker = target->getOwner();
-        m_attackerInfo[guid].victim = target->getOwner()->GetVictim();
-        m_attackerInfo[guid].threat = target->getThreat(victim);
-        m_attackerInfo[guid].count = 1;
-        //m_attackerInfo[guid].source = 1; // source is not used so far.
+        AttackerInfo& info = m_attackerInfo[target->getOwner()->GetObjectGuid()];
+        info.attacker = target->getOwner();
+        info.victim = target->getOwner()->GetVictim();
+        info.threat = target->getThreat(victim);
+        info.count = 1;
+        //info.source = 1; // source is not used so far.
         ref = ref->next();
     }
 }
 
 void PlayerbotAI::UpdateAttackerInfo()
 {
+    // the threat lists do not change while the bot decides, one list serves all of its lookups
+    if (m_deciding && m_attackerInfoDecision == m_decisionCount)
+        return;
+    m_attackerInfoDecision = m_decisionCount;
+
     // clear old list
     m_attackerInfo.clear();
 
@@ -4508,15 +4433,14 @@ void PlayerbotAI::UpdateAttackerInfo()
     {
         if (!itr->second.attacker)
             continue;
-        Unit* a = itr->second.attacker;
+        ThreatList const& threatList = itr->second.attacker->getThreatManager().getThreatList();
         float t = 0.00;
-        std::list<HostileReference*>::const_iterator i = a->getThreatManager().getThreatList().begin();
-        for (; i != a->getThreatManager().getThreatList().end(); ++i)
+        for (ThreatList::const_iterator i = threatList.begin(); i != threatList.end(); ++i)
         {
             if ((*i)->getThreat() > t && (*i)->getTarget() != m_bot)
                 t = (*i)->getThreat();
         }
-        m_attackerInfo[itr->first].threat2 = t;
+        itr->second.threat2 = t;
     }
 
     // DEBUG: output attacker info
@@ -5118,17 +5042,51 @@ void PlayerbotAI::Announce(AnnounceFlags msg)
 // hasUnitState(FLAG) FLAG like: UNIT_STAT_ROOT, UNIT_STAT_CONFUSED, UNIT_STAT_STUNNED
 // hasAuraType
 
-void PlayerbotAI::UpdateAI(const uint32 /*p_time*/)
+void PlayerbotAI::ResetTickBudget()
+{
+    s_tickThinkTime = 0;
+}
+
+void PlayerbotAI::UpdateAI(const uint32 p_time)
 {
+    // maintenance, every tick
     if (GetClassAI()->GetWaitUntil() <= CurrentTime())
         GetClassAI()->ClearWait();
 
+    // If bot is in water, allow it to swim instead of being stuck above water or at the floor until it drowns itself
+    if (m_bot->IsInWater() && m_bot->GetMap()->GetTerrain()->IsSwimmable(m_bot->GetPositionX(), m_bot->GetPositionY(), m_bot->GetPositionZ(), m_bot->GetCollisionHeight()))
+    {
+        if (!m_bot->IsSwimming())
+            m_bot->m_movementInfo.AddMovementFlag(MOVEFLAG_SWIMMING);
+    }
+    else if (m_bot->IsSwimming())   // Clear swimming when going out of water
+        m_bot->m_movementInfo.RemoveMovementFlag(MOVEFLAG_SWIMMING);
+
+    if (m_thinkTimer > p_time)
+    {
+        m_thinkTimer -= p_time;
+        return;
+    }
+
     if (CurrentTime() < m_ignoreAIUpdatesUntilTime)
+    {
+        m_thinkTimer = 0;
+        return;
+    }
+
+    // full decisions, every think interval while the map tick has budget left;
+    // a bot that waited a whole interval for it thinks anyway, so none of them starves
+    if (m_mgr.m_confThinkBudget && s_tickThinkTime >= m_mgr.m_confThinkBudget && m_thinkOverdue < m_mgr.m_confThinkInterval)
+    {
+        m_thinkTimer = 0;
+        m_thinkOverdue += p_time;
         return;
+    }
+
+    m_thinkTimer = m_mgr.m_confThinkInterval;
+    m_thinkOverdue = 0;
+    PlayerbotDecision decision(*this);
 
-    // default updates occur every two seconds
-    SetIgnoreUpdateTime(2);
-    
     if (m_botState == BOTSTATE_LOADING)
     {
         if (m_bot->IsBeingTeleported())
@@ -5236,15 +5194,6 @@ void PlayerbotAI::UpdateAI(const uint32 /*p_time*/)
         return;
     }
 
-    // If bot is in water, allow it to swim instead of being stuck above water or at the floor until it drowns itself
-    if (m_bot->IsInWater() && m_bot->GetMap()->GetTerrain()->IsSwimmable(m_bot->GetPositionX(), m_bot->GetPositionY(), m_bot->GetPositionZ(), m_bot->GetCollisionHeight()))
-    {
-        if (!m_bot->IsSwimming())
-            m_bot->m_movementInfo.AddMovementFlag(MOVEFLAG_SWIMMING);
-    }
-    else if (m_bot->IsSwimming())   // Clear swimming when going out of water
-        m_bot->m_movementInfo.RemoveMovementFlag(MOVEFLAG_SWIMMING);
-    
     // bot still alive
     if (!m_findNPC.empty())
         findNearbyCreature();
@@ -5564,9 +5513,21 @@ SpellCastResult PlayerbotAI::CastSpell(uint32 spellId)
         return SPELL_NOT_FOUND;
     }
 
+    // a spell on cooldown or without power stays so for the rest of the decision, the class AIs try many of them
+    if (m_deciding)
+    {
+        for (auto const& unready : m_unreadySpells)
+            if (unready.first == spellId)
+                return unready.second;
+    }
+
     // check spell cooldown
     if (!m_bot->IsSpellReady(*pSpellInfo))
+    {
+        if (m_deciding)
+            m_unreadySpells.emplace_back(spellId, SPELL_FAILED_NOT_READY);
         return SPELL_FAILED_NOT_READY;
+    }
 
     // for AI debug purpose: uncomment the following line and bot will tell Master of every spell they attempt to cast
     // TellMaster("I'm trying to cast %s (spellID %u)", pSpellInfo->SpellName[0], spellId);
@@ -5575,8 +5536,13 @@ SpellCastResult PlayerbotAI::CastSpell(uint32 spellId)
     // We use Spell::CheckPower() instead of UnitAI::CanCastSpell() because bots are players and have more requirements than mere units
     Spell* tmp_spell = new Spell(m_bot, pSpellInfo, false);
     SpellCastResult res = tmp_spell->CheckPower(true);
+    delete tmp_spell;
     if (res != SPELL_CAST_OK)
+    {
+        if (m_deciding)
+            m_unreadySpells.emplace_back(spellId, res);
         return res;
+    }
 
     // set target
     ObjectGuid targetGUID = m_bot->GetSelectionGuid();
@@ -5867,52 +5833,25 @@ uint8 PlayerbotAI::_findItemSlot(Item* target)
 
 Item* PlayerbotAI::FindItem(uint32 ItemId, bool Equipped_too /* default = false */)
 {
-    uint8 first_slot;
-    Equipped_too ? first_slot = EQUIPMENT_SLOT_START : first_slot = INVENTORY_SLOT_ITEM_START;
-
-    // list out items equipped &/OR in main backpack
+    // list out items equipped, they are not indexed
     //EQUIPMENT_SLOT_START = 0
     //INVENTORY_SLOT_ITEM_START = 23
-    //INVENTORY_SLOT_ITEM_END = 39
-
-    for (uint8 slot = first_slot; slot < INVENTORY_SLOT_ITEM_END; slot++)
+    if (Equipped_too)
     {
-        // DEBUG_LOG ("[PlayerbotAI]: FindItem - [%s's]backpack slot = %u",m_bot->GetName(),slot); // 23 to 38 = 16
-        Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);  // 255, 23 to 38
-        if (pItem)
+        for (uint8 slot = EQUIPMENT_SLOT_START; slot < INVENTORY_SLOT_ITEM_START; slot++)
         {
-            const ItemPrototype* const pItemProto = pItem->GetProto();
-            if (!pItemProto)
-                continue;
-
-            if (pItemProto->ItemId == ItemId)   // have required item
+            Item* const pItem = m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
+            if (pItem && pItem->GetEntry() == ItemId)
                 return pItem;
         }
     }
-    // list out items in other removable backpacks
-    //INVENTORY_SLOT_BAG_START = 19
-    //INVENTORY_SLOT_BAG_END = 23
 
-    for (uint8 bag = INVENTORY_SLOT_BAG_START; bag < INVENTORY_SLOT_BAG_END; ++bag)  // 20 to 23 = 4
-    {
-        const Bag* const pBag = (Bag*) m_bot->GetItemByPos(INVENTORY_SLOT_BAG_0, bag);    // 255, 20 to 23
-        if (pBag)
-            for (uint8 slot = 0; slot < pBag->GetBagSize(); ++slot)
-            {
-                // DEBUG_LOG ("[PlayerbotAI]: FindItem - [%s's]bag[%u] slot = %u", m_bot->GetName(), bag, slot);  // 1 to bagsize = ?
-                Item* const pItem = m_bot->GetItemByPos(bag, slot); // 20 to 23, 1 to bagsize
-                if (pItem)
-                {
-                    const ItemPrototype* const pItemProto = pItem->GetProto();
-                    if (!pItemProto)
-                        continue;
+    // items in main backpack and other removable backpacks
+    if (!m_inventoryIndexValid)
+        BuildInventoryIndex();
 
-                    if (pItemProto->ItemId == ItemId)        // have required item
-                        return pItem;
-                }
-            }
-    }
-    return nullptr;
+    std::vector<Item*> const* items = GetIndexedItems(m_itemsByEntry, ItemId);
+    return items ? items->front() : nullptr;
 }
 
 Item* PlayerbotAI::FindItemInBank(uint32 ItemId)
@@ -10005,6 +9944,8 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
 
         TellMaster("Inbox:\n");
 
+        m_bot->LoadMailedItems(std::vector<Mail*>(m_bot->GetMailBegin(), m_bot->GetMailEnd()));
+
         for (PlayerMails::reverse_iterator itr = m_bot->GetMailRBegin(); itr != m_bot->GetMailREnd(); ++itr)
         {
             std::ostringstream msg;
@@ -10129,6 +10070,7 @@ void PlayerbotAI::_HandleCommandMail(std::string& text, Player& fromPlayer)
                 return;
             }
 
+            m_bot->LoadMailedItems(m);
             if (m->HasItems())
             {
                 bool has_items = true;
@@ -11940,9 +11882,23 @@ bool PlayerbotAI::_HandleCommandSkillLearnHelper(TrainerSpell const* tSpell, uin
 
 void PlayerbotAI::_HandleCommandStats(std::string& text, Player& fromPlayer)
 {
+    if (ExtractCommand("ai", text))
+    {
+        // what the AI of the bot has cost the server so far
+        std::ostringstream out;
+        out << "|cffffffff[|h|cff00ffff" << m_bot->GetName() << "|h|cffffffff] made |cff00ff00" << m_decisionCount
+            << "|cffffffff decisions in |cff00ff00" << m_thinkTime / IN_MILLISECONDS << "|cffffffff ms";
+        if (m_decisionCount)
+            out << " (|cff00ff00" << m_thinkTime / m_decisionCount << "|cffffffff us each)";
+        out << ", indexed its bags |cff00ff00" << m_inventoryIndexBuilds << "|cffffffff times";
+        ChatHandler ch(&fromPlayer);
+        ch.SendSysMessage(out.str().c_str());
+        return;
+    }
+
     if (!text.empty())
     {
-        SendWhisper("'stats' does not have subcommands", fromPlayer);
+        SendWhisper("'stats' only has the subcommand 'ai'", fromPlayer);
         return;
     }
 
@@ -12320,6 +12276,10 @@ void PlayerbotAI::_HandleCommandHelp(std::string& text, Player& fromPlayer)
 
         if (!bMainHelp)
         {
+            ch.SendSysMessage(_HandleCommandHelpHelper("stats ai", "This will inform you of how many decisions I made and how long they took.").c_str());
+
+            if (ExtractCommand("ai", text)) {}
+
             if (!text.empty())
                 ch.SendSysMessage(sInvalidSubcommand.c_str());
             return;
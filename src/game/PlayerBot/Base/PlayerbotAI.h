@@ -1724,9 +1724,18 @@ class PlayerbotAI
         PlayerbotAI(PlayerbotMgr& mgr, Player* const bot, bool debugWhisper);
         virtual ~PlayerbotAI();
 
-        // This is called from Unit.cpp and is called every second (I think)
+        // This is called from Player::Update on the thread of the bot's map, every map tick.
+        // The full decisions run every PlayerbotAI.ThinkInterval, staggered between the bots
+        // and limited by the think budget of the map tick, the ticks between are maintenance only.
         void UpdateAI(const uint32 p_time);
 
+        // Called by Map::Update before its players are updated
+        static void ResetTickBudget();
+
+        // Views built for a decision are reused until it ends, outside of decisions they are built on each call
+        bool IsDeciding() const { return m_deciding; }
+        uint32 GetDecisionCount() const { return m_decisionCount; }
+
         // This is called from ChatHandler.cpp when there is an incoming message to the bot
         // from a whisper or from the party channel
         void HandleCommand(const std::string& text, Player& fromPlayer);
@@ -1793,6 +1802,10 @@ class PlayerbotAI
 
         void GiveLevel(uint32 level);
 
+        // Called by Player when an item is stored, moved or removed, the item index is rebuilt on its next search
+        void InventoryChanged() { m_inventoryIndexValid = false; }
+        typedef std::unordered_map<uint32, std::vector<Item*>> ItemIndex;
+
         // Error check the TS DB. Should only be used when admins want to verify their new TS input
         uint32 TalentSpecDBContainsError();
 
@@ -1856,6 +1869,7 @@ class PlayerbotAI
         Item* FindKeyForLockValue(uint32 reqSkillValue);
         Item* FindBombForLockValue(uint32 reqSkillValue);
         Item* FindConsumable(uint32 displayId) const;
+        Item* FindUsableItem(uint32 itemClass, uint32 itemSubClass, uint32 spellCategory = 0) const;
         Item* FindManaRegenItem() const;
         bool  FindAmmo() const;
         uint8 _findItemSlot(Item* target);
@@ -1919,7 +1933,8 @@ class PlayerbotAI
         Unit* GetCurrentTarget() { return m_targetCombat; };
         void DoNextCombatManeuver();
         void DoCombatMovement();
-        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; };
+        // 0 decides again at the next tick, without waiting for the think interval
+        void SetIgnoreUpdateTime(uint8 t = 0) { m_ignoreAIUpdatesUntilTime = time(nullptr) + t; if (!t) m_thinkTimer = 0; };
         time_t CurrentTime() { return time(nullptr); };
 
         Player* GetPlayerBot() const { return m_bot; }
@@ -2084,6 +2099,25 @@ class PlayerbotAI
         // no need to waste CPU cycles during casting etc
         time_t m_ignoreAIUpdatesUntilTime;
 
+        // milliseconds until the next full decision and how long it waited for the think budget
+        uint32 m_thinkTimer;
+        uint32 m_thinkOverdue;
+
+        // the decision in progress, the attacker list and the failed spell checks belong to it
+        friend class PlayerbotDecision;
+        uint32 m_decisionCount;
+        bool m_deciding;
+        uint32 m_attackerInfoDecision;
+        std::vector<std::pair<uint32, SpellCastResult>> m_unreadySpells;
+        uint64 m_thinkTime;
+
+        // the items of the main backpack and the other removable backpacks by entry and by class and subclass
+        void BuildInventoryIndex() const;
+        mutable ItemIndex m_itemsByEntry;
+        mutable ItemIndex m_itemsByClass;
+        mutable bool m_inventoryIndexValid;
+        mutable uint32 m_inventoryIndexBuilds;
+
         CombatStyle m_combatStyle;
         CombatOrderType m_combatOrder;
         MovementOrderType m_movementOrder;
@@ -25,7 +25,7 @@
 #include "Grids/GridNotifiersImpl.h"
 
 PlayerbotClassAI::PlayerbotClassAI(Player& master, Player& bot, PlayerbotAI& ai)
-    : m_master(master), m_bot(bot), m_ai(ai)
+    : m_groupViewDecision(0), m_master(master), m_bot(bot), m_ai(ai)
 {
 
     m_MinHealthPercentTank   = 80;
@@ -37,6 +37,34 @@ PlayerbotClassAI::PlayerbotClassAI(Player& master, Player& bot, PlayerbotAI& ai)
 }
 PlayerbotClassAI::~PlayerbotClassAI() {}
 
+std::vector<GroupMemberView> const& PlayerbotClassAI::GetGroupView()
+{
+    if (m_ai.IsDeciding() && m_groupViewDecision == m_ai.GetDecisionCount())
+        return m_groupView;
+    m_groupViewDecision = m_ai.GetDecisionCount();
+
+    m_groupView.clear();
+    if (!m_bot.GetGroup())
+        return m_groupView;
+
+    // looking up the members and the talent spec of human players is what makes the group checks expensive
+    Group::MemberSlotList const& groupSlot = m_bot.GetGroup()->GetMemberSlots();
+    for (const auto& memberItr : groupSlot)
+    {
+        Player* member = sObjectMgr.GetPlayer(memberItr.guid);
+        if (!member)
+            continue;
+
+        GroupMemberView view;
+        view.player = member;
+        view.job = GetTargetJob(member);
+        view.healthPercent = member->GetMaxHealth() ? uint8(member->GetHealth() * 100 / member->GetMaxHealth()) : 0;
+        view.manaPercent = member->GetMaxPower(POWER_MANA) ? uint8(member->GetPower(POWER_MANA) * 100 / member->GetMaxPower(POWER_MANA)) : 0;
+        m_groupView.push_back(view);
+    }
+    return m_groupView;
+}
+
 CombatManeuverReturns PlayerbotClassAI::DoFirstCombatManeuver(Unit*) { return RETURN_NO_ACTION_OK; }
 CombatManeuverReturns PlayerbotClassAI::DoNextCombatManeuver(Unit*) { return RETURN_NO_ACTION_OK; }
 
@@ -189,11 +217,10 @@ bool PlayerbotClassAI::NeedGroupBuff(uint32 groupBuffSpellId, uint32 singleBuffS
     // when only two players or less need it
     if (m_bot.GetGroup())
     {
-        Group::MemberSlotList const& groupSlot = m_bot.GetGroup()->GetMemberSlots();
-        for (const auto& memberItr : groupSlot)
+        for (const auto& memberView : GetGroupView())
         {
-            Player* member = sObjectMgr.GetPlayer(memberItr.guid);
-            if (!member || !member->IsAlive())
+            Player* member = memberView.player;
+            if (!member->IsAlive())
                 continue;
             // Check if group member needs buff
             if (!member->HasAura(groupBuffSpellId, EFFECT_INDEX_0) && !member->HasAura(singleBuffSpellId, EFFECT_INDEX_0))
@@ -262,19 +289,14 @@ Player* PlayerbotClassAI::GetHealTarget(JOB_TYPE type, bool onlyPickFromSameGrou
     // First, fill the list of targets
     if (m_bot.GetGroup())
     {
-        Group::MemberSlotList const& groupSlot = m_bot.GetGroup()->GetMemberSlots();
-        for (Group::member_citerator itr = groupSlot.begin(); itr != groupSlot.end(); itr++)
+        for (const auto& memberView : GetGroupView())
         {
-            Player* groupMember = sObjectMgr.GetPlayer(itr->guid);
-            if (!groupMember || !groupMember->IsAlive() || groupMember->IsInDuel()
+            Player* groupMember = memberView.player;
+            if (!groupMember->IsAlive() || groupMember->IsInDuel()
                 || (!m_bot.GetGroup()->SameSubGroup(&m_bot, groupMember) && onlyPickFromSameGroup))
                 continue;
-            JOB_TYPE job = GetTargetJob(groupMember);
-            if (job & type)
-            {
-                uiHealthPercentage = int(groupMember->GetMaxHealth() != 0 ? groupMember->GetHealth() * 100 / groupMember->GetMaxHealth() : 0);
-                targets.push_back(heal_priority(groupMember, uiHealthPercentage, job));
-            }
+            if (memberView.job & type)
+                targets.push_back(heal_priority(groupMember, memberView.healthPercent, memberView.job));
         }
     }
     else
@@ -584,13 +606,12 @@ Player* PlayerbotClassAI::GetDispelTarget(DispelType dispelType, JOB_TYPE type,
         // define seperately for sorting purposes - DO NOT CHANGE ORDER!
         std::vector<heal_priority> targets;
 
-        Group::MemberSlotList const& groupSlot = m_bot.GetGroup()->GetMemberSlots();
-        for (Group::member_citerator itr = groupSlot.begin(); itr != groupSlot.end(); itr++)
+        for (const auto& memberView : GetGroupView())
         {
-            Player* groupMember = sObjectMgr.GetPlayer(itr->guid);
-            if (!groupMember || !groupMember->IsAlive())
+            Player* groupMember = memberView.player;
+            if (!groupMember->IsAlive())
                 continue;
-            JOB_TYPE job = GetTargetJob(groupMember);
+            JOB_TYPE job = memberView.job;
             if (job & type)
             {
                 uint32 dispelMask  = GetDispellMask(dispelType);
@@ -629,15 +650,12 @@ Player* PlayerbotClassAI::GetResurrectionTarget(JOB_TYPE type, bool bMustBeOOC)
         // define seperately for sorting purposes - DO NOT CHANGE ORDER!
         std::vector<heal_priority> targets;
 
-        Group::MemberSlotList const& groupSlot = m_bot.GetGroup()->GetMemberSlots();
-        for (Group::member_citerator itr = groupSlot.begin(); itr != groupSlot.end(); itr++)
+        for (const auto& memberView : GetGroupView())
         {
-            Player* groupMember = sObjectMgr.GetPlayer(itr->guid);
-            if (!groupMember || groupMember->IsAlive())
+            if (memberView.player->IsAlive())
                 continue;
-            JOB_TYPE job = GetTargetJob(groupMember);
-            if (job & type)
-                targets.push_back(heal_priority(groupMember, 0, job));
+            if (memberView.job & type)
+                targets.push_back(heal_priority(memberView.player, 0, memberView.job));
         }
 
         // Sorts according to type: Main tank first, healers second, then regular tanks, then master followed by DPS, thanks to the order of the TYPE enum
@@ -58,6 +58,15 @@ struct heal_priority
     bool operator<(const heal_priority& a) const { return type < a.type; }
 };
 
+// a member of the bot's group as seen by its decision
+struct GroupMemberView
+{
+    Player* player;
+    JOB_TYPE job;
+    uint8 healthPercent;
+    uint8 manaPercent;
+};
+
 class PlayerbotClassAI
 {
     public:
@@ -84,6 +93,9 @@ class PlayerbotClassAI
         void ClearWait() { m_WaitUntil = 0; }
         //void SetWaitUntil(time_t t) { m_WaitUntil = t; }
 
+        // the online members of the bot's group, resolved once per decision
+        std::vector<GroupMemberView> const& GetGroupView();
+
     protected:
         virtual CombatManeuverReturns DoFirstCombatManeuverPVE(Unit*);
         virtual CombatManeuverReturns DoNextCombatManeuverPVE(Unit*);
@@ -115,6 +127,9 @@ class PlayerbotClassAI
 
         time_t m_WaitUntil;
 
+        std::vector<GroupMemberView> m_groupView;
+        uint32 m_groupViewDecision;
+
         Player& m_master;
         Player& m_bot;
         PlayerbotAI& m_ai;
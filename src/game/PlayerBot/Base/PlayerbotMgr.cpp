@@ -76,6 +76,8 @@ PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master)
         sLog.outError("Playerbot: PlayerbotAI.Collect.Distance higher than PlayerbotAI.Collect.DistanceMax. Using DistanceMax value");
         m_confCollectDistance = m_confCollectDistanceMax;
     }
+    m_confThinkInterval = std::max(botConfig.GetIntDefault("PlayerbotAI.ThinkInterval", 2000), 100);
+    m_confThinkBudget = botConfig.GetIntDefault("PlayerbotAI.ThinkBudget", 5000);
 }
 
 PlayerbotMgr::~PlayerbotMgr()
@@ -700,6 +700,11 @@ uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questg
             return DIALOG_STATUS_NONE;
     }
 
+    // the status only depends on the entry, the cache is invalidated by the changes of the quests, level and reputation of the player
+    bool const cacheable = defstatus == DIALOG_STATUS_NONE;
+    if (cacheable && pPlayer->GetCachedDialogStatus(questgiver, dialogStatus))
+        return dialogStatus;
+
     // Check markings for quest-finisher
     for (QuestRelationsMap::const_iterator itr = irbounds.first; itr != irbounds.second; ++itr)
     {
@@ -766,6 +771,9 @@ uint32 WorldSession::getDialogStatus(const Player* pPlayer, const Object* questg
             dialogStatus = dialogStatusNew;
     }
 
+    if (cacheable)
+        pPlayer->CacheDialogStatus(questgiver, dialogStatus);
+
     return dialogStatus;
 }
 
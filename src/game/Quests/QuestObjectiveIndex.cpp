@@ -0,0 +1,107 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Quests/QuestObjectiveIndex.h"
+#include "Globals/ObjectMgr.h"
+
+#include <algorithm>
+
+QuestObjectiveIndex::QuestObjectiveIndex() : m_dirty(false), m_templatesVersion(0)
+{
+    memset(m_questIds, 0, sizeof(m_questIds));
+}
+
+void QuestObjectiveIndex::SetSlot(uint16 slot, uint32 questId)
+{
+    if (m_questIds[slot] == questId)
+        return;
+
+    m_questIds[slot] = questId;
+    m_dirty = true;
+}
+
+void QuestObjectiveIndex::SwapSlots(uint16 slot1, uint16 slot2)
+{
+    std::swap(m_questIds[slot1], m_questIds[slot2]);
+    m_dirty = true;
+}
+
+void QuestObjectiveIndex::Rebuild() const
+{
+    m_entries.clear();
+    m_dirty = false;
+    m_templatesVersion = sObjectMgr.GetQuestTemplatesVersion();
+
+    for (uint16 slot = 0; slot < MAX_QUEST_LOG_SIZE; ++slot)
+    {
+        if (!m_questIds[slot])
+            continue;
+
+        Quest const* qInfo = sObjectMgr.GetQuestTemplate(m_questIds[slot]);
+        if (!qInfo)
+            continue;
+
+        for (uint8 j = 0; j < QUEST_OBJECTIVES_COUNT; ++j)
+        {
+            int32 reqTarget = qInfo->ReqCreatureOrGOId[j];
+            if (reqTarget > 0)
+                m_entries.push_back({ MakeKey(QUEST_OBJECTIVE_CREATURE, uint32(reqTarget)), slot, j });
+            else if (reqTarget < 0)
+                m_entries.push_back({ MakeKey(QUEST_OBJECTIVE_GAMEOBJECT, uint32(-reqTarget)), slot, j });
+        }
+
+        for (uint8 j = 0; j < QUEST_ITEM_OBJECTIVES_COUNT; ++j)
+            if (qInfo->ReqItemId[j])
+                m_entries.push_back({ MakeKey(QUEST_OBJECTIVE_ITEM, qInfo->ReqItemId[j]), slot, j });
+
+        for (uint8 j = 0; j < QUEST_SOURCE_ITEM_IDS_COUNT; ++j)
+            if (qInfo->ReqSourceId[j])
+                m_entries.push_back({ MakeKey(QUEST_OBJECTIVE_SOURCE_ITEM, qInfo->ReqSourceId[j]), slot, j });
+    }
+
+    std::sort(m_entries.begin(), m_entries.end());
+}
+
+std::pair<std::vector<QuestObjectiveIndex::Entry>::const_iterator, std::vector<QuestObjectiveIndex::Entry>::const_iterator>
+QuestObjectiveIndex::Lookup(QuestObjectiveType type, uint32 entry) const
+{
+    if (m_dirty || m_templatesVersion != sObjectMgr.GetQuestTemplatesVersion())
+        Rebuild();
+
+    uint64 key = MakeKey(type, entry);
+    auto first = std::lower_bound(m_entries.begin(), m_entries.end(), key, [](Entry const& left, uint64 right) { return left.key < right; });
+    auto last = first;
+    while (last != m_entries.end() && last->key == key)
+        ++last;
+
+    return { first, last };
+}
+
+void QuestObjectiveIndex::Find(QuestObjectiveType type, uint32 entry, QuestObjectiveRefs& refs) const
+{
+    refs.m_count = 0;
+
+    auto bounds = Lookup(type, entry);
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
+    {
+        QuestObjectiveRef& ref = refs.m_refs[refs.m_count++];
+        ref.questId = m_questIds[itr->slot];
+        ref.slot = itr->slot;
+        ref.objective = itr->objective;
+    }
+}
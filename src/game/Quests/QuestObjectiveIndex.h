@@ -0,0 +1,104 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_QUESTOBJECTIVEINDEX_H
+#define MANGOS_QUESTOBJECTIVEINDEX_H
+
+#include "Common.h"
+#include "Quests/QuestDef.h"
+
+enum QuestObjectiveType
+{
+    QUEST_OBJECTIVE_CREATURE    = 0,                        // ReqCreatureOrGOId > 0
+    QUEST_OBJECTIVE_GAMEOBJECT  = 1,                        // ReqCreatureOrGOId < 0, by the positive entry
+    QUEST_OBJECTIVE_ITEM        = 2,                        // ReqItemId
+    QUEST_OBJECTIVE_SOURCE_ITEM = 3,                        // ReqSourceId
+};
+
+struct QuestObjectiveRef
+{
+    uint32 questId;
+    uint16 slot;
+    uint8 objective;                                        // index into the objective arrays of its type
+};
+
+// matches of one lookup, copied out since completing a quest may change the quest log while they are credited
+class QuestObjectiveRefs
+{
+    public:
+        QuestObjectiveRefs() : m_count(0) {}
+
+        QuestObjectiveRef const* begin() const { return m_refs; }
+        QuestObjectiveRef const* end() const { return m_refs + m_count; }
+        bool empty() const { return m_count == 0; }
+
+    private:
+        friend class QuestObjectiveIndex;
+
+        QuestObjectiveRef m_refs[MAX_QUEST_LOG_SIZE * QUEST_ITEM_OBJECTIVES_COUNT];
+        uint32 m_count;
+};
+
+/**
+ * Objectives of the quests in a player's quest log by the creature, gameobject or item entry they need,
+ * so a kill, cast or looted item only visits the objectives it can credit instead of the whole log.
+ *
+ * Slots are kept in sync with the quest log fields; the entries are rebuilt on the next lookup after a
+ * slot changed or the quest templates were reloaded. The matches come ordered by slot, then objective,
+ * as the loops over the quest log found them. Only the status checks remain for the caller.
+ */
+class QuestObjectiveIndex
+{
+    public:
+        QuestObjectiveIndex();
+
+        void SetSlot(uint16 slot, uint32 questId);
+        void SwapSlots(uint16 slot1, uint16 slot2);
+
+        void Find(QuestObjectiveType type, uint32 entry, QuestObjectiveRefs& refs) const;
+
+    private:
+        struct Entry
+        {
+            uint64 key;                                     // type << 32 | entry
+            uint16 slot;
+            uint8 objective;
+
+            bool operator<(Entry const& other) const
+            {
+                if (key != other.key)
+                    return key < other.key;
+                if (slot != other.slot)
+                    return slot < other.slot;
+                return objective < other.objective;
+            }
+        };
+
+        static uint64 MakeKey(QuestObjectiveType type, uint32 entry) { return (uint64(type) << 32) | entry; }
+
+        void Rebuild() const;
+        std::pair<std::vector<Entry>::const_iterator, std::vector<Entry>::const_iterator> Lookup(QuestObjectiveType type, uint32 entry) const;
+
+        uint32 m_questIds[MAX_QUEST_LOG_SIZE];
+
+        mutable std::vector<Entry> m_entries;               // ascending
+        mutable bool m_dirty;
+        mutable uint32 m_templatesVersion;                  // of ObjectMgr the entries were built with
+};
+
+#endif
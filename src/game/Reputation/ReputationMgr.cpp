@@ -43,8 +43,22 @@ FactionState const* ReputationMgr::GetState(FactionEntry const* factionEntry) co
 
 FactionState const* ReputationMgr::GetState(RepListID id) const
 {
-    FactionStateList::const_iterator repItr = m_factions.find(id);
-    return repItr != m_factions.end() ? &repItr->second : nullptr;
+    return id < m_factions.size() && m_factions[id].ID ? &m_factions[id] : nullptr;
+}
+
+FactionState* ReputationMgr::GetState(RepListID id)
+{
+    return id < m_factions.size() && m_factions[id].ID ? &m_factions[id] : nullptr;
+}
+
+void ReputationMgr::MarkChanged(FactionState* faction)
+{
+    if (!faction->needSend && !faction->needSave)
+        m_changedFactions.push_back(faction->ReputationListID);
+
+    faction->needSend = true;
+    faction->needSave = true;
+    m_initialBlock.clear();
 }
 
 int32 ReputationMgr::GetReputation(uint32 faction_id) const
@@ -163,35 +177,39 @@ void ReputationMgr::SendForceReactions()
     m_player->SendDirectMessage(data);
 }
 
-void ReputationMgr::SendState(FactionState const* faction, bool anyRankIncreased)
+void ReputationMgr::SendPendingStates()
 {
-    uint32 count = 1;
+    if (!m_pendingSend)
+        return;
+
+    m_pendingSend = false;
 
     WorldPacket data(SMSG_SET_FACTION_STANDING, 17);
     data << float(0);                                       // refer-a-friend bonus reputation
-    data << uint8(anyRankIncreased ? 1 : 0);                // display visual effect
+    data << uint8(m_pendingRankIncrease ? 1 : 0);           // display visual effect
+    m_pendingRankIncrease = false;
 
+    uint32 count = 0;
     size_t p_count = data.wpos();
     data << uint32(count);                                  // placeholder
 
-    data << uint32(faction->ReputationListID);
-    data << uint32(faction->Standing);
-
-    for (auto& m_faction : m_factions)
+    size_t kept = 0;
+    for (RepListID id : m_changedFactions)
     {
-        FactionState& subFaction = m_faction.second;
-        if (subFaction.needSend)
+        FactionState& faction = m_factions[id];
+        if (faction.needSend)
         {
-            subFaction.needSend = false;
-            if (subFaction.ReputationListID != faction->ReputationListID)
-            {
-                data << uint32(subFaction.ReputationListID);
-                data << uint32(subFaction.Standing);
+            faction.needSend = false;
+            data << uint32(faction.ReputationListID);
+            data << uint32(faction.Standing);
 
-                ++count;
-            }
+            ++count;
         }
+
+        if (faction.needSave)
+            m_changedFactions[kept++] = id;
     }
+    m_changedFactions.resize(kept);
 
     data.put<uint32>(p_count, count);
     m_player->SendDirectMessage(data);
@@ -199,35 +217,42 @@ void ReputationMgr::SendState(FactionState const* faction, bool anyRankIncreased
 
 void ReputationMgr::SendInitialReputations()
 {
-    WorldPacket data(SMSG_INITIALIZE_FACTIONS, (4 + 128 * 5));
-    data << uint32(0x00000080);
-
-    RepListID a = 0;
-
-    for (auto& m_faction : m_factions)
+    // sent again at every map change, kept serialized until a faction changes
+    if (m_initialBlock.empty())
     {
-        // fill in absent fields
-        for (; a != m_faction.first; ++a)
+        m_initialBlock.reserve(MAX_REPUTATION_LIST_ID * 5);
+        for (RepListID id = 0; id < MAX_REPUTATION_LIST_ID; ++id)
         {
-            data << uint8(0x00);
-            data << uint32(0x00000000);
+            if (FactionState* faction = GetState(id))
+            {
+                m_initialBlock << uint8(faction->Flags);
+                m_initialBlock << uint32(faction->Standing);
+            }
+            else
+            {
+                m_initialBlock << uint8(0x00);
+                m_initialBlock << uint32(0x00000000);
+            }
         }
-
-        // fill in encountered data
-        data << uint8(m_faction.second.Flags);
-        data << uint32(m_faction.second.Standing);
-
-        m_faction.second.needSend = false;
-
-        ++a;
     }
 
-    // fill in absent fields
-    for (; a != 128; ++a)
+    WorldPacket data(SMSG_INITIALIZE_FACTIONS, (4 + 128 * 5));
+    data << uint32(0x00000080);
+    data.append(m_initialBlock);
+
+    // all standings are sent with it, only the changed factions can still have needSend set
+    size_t kept = 0;
+    for (RepListID id : m_changedFactions)
     {
-        data << uint8(0x00);
-        data << uint32(0x00000000);
+        FactionState& faction = m_factions[id];
+        faction.needSend = false;
+        if (faction.needSave)
+            m_changedFactions[kept++] = id;
     }
+    m_changedFactions.resize(kept);
+
+    m_pendingSend = false;
+    m_pendingRankIncrease = false;
 
     m_player->SendDirectMessage(data);
 }
@@ -246,6 +271,10 @@ void ReputationMgr::SendVisible(FactionState const* faction) const
 void ReputationMgr::Initialize()
 {
     m_factions.clear();
+    m_changedFactions.clear();
+    m_initialBlock.clear();
+    m_pendingSend = false;
+    m_pendingRankIncrease = false;
     m_visibleFactionCount = 0;
     m_honoredFactionCount = 0;
     m_reveredFactionCount = 0;
@@ -270,7 +299,10 @@ void ReputationMgr::Initialize()
 
             UpdateRankCounters(REP_HOSTILE, GetBaseRank(factionEntry));
 
+            if (newFaction.ReputationListID >= m_factions.size())
+                m_factions.resize(newFaction.ReputationListID + 1);
             m_factions[newFaction.ReputationListID] = newFaction;
+            m_changedFactions.push_back(newFaction.ReputationListID);
         }
     }
 }
@@ -309,9 +341,9 @@ void ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
             spillOverRepOut *= factionEntry->spilloverRateOut;
             if (FactionEntry const* parent = sFactionStore.LookupEntry(factionEntry->team))
             {
-                FactionStateList::iterator parentState = m_factions.find(parent->reputationListID);
+                FactionState const* parentState = GetState(RepListID(parent->reputationListID));
                 // some team factions have own reputation standing, in this case do not spill to other sub-factions
-                if (parentState != m_factions.end() && (parentState->second.Flags & FACTION_FLAG_TEAM_REPUTATION))
+                if (parentState && (parentState->Flags & FACTION_FLAG_TEAM_REPUTATION))
                 {
                     if (SetOneFactionReputation(parent, int32(spillOverRepOut), incremental))
                         anyRankIncreased = true;
@@ -341,14 +373,15 @@ void ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standi
         }
     }
     // spillover done, update faction itself
-    FactionStateList::iterator faction = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (faction != m_factions.end())
+    if (GetState(RepListID(factionEntry->reputationListID)))
     {
         if (SetOneFactionReputation(factionEntry, standing, incremental))
             anyRankIncreased = true;
 
-        // only this faction gets reported to client, even if it has no own visible standing
-        SendState(&faction->second, anyRankIncreased);
+        // reported to client with the other changes of the tick, even if it has no own visible standing
+        m_pendingSend = true;
+        if (anyRankIncreased)
+            m_pendingRankIncrease = true;
     }
 }
 
@@ -357,10 +390,9 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
     if (!factionEntry)
         return false;
 
-    FactionStateList::iterator itr = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (itr != m_factions.end())
+    if (FactionState* state = GetState(RepListID(factionEntry->reputationListID)))
     {
-        FactionState& faction = itr->second;
+        FactionState& faction = *state;
         int32 BaseRep = GetBaseReputation(factionEntry);
 
         if (incremental)
@@ -375,8 +407,7 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
         ReputationRank rankNew = ReputationToRank(standing);
 
         faction.Standing = standing - BaseRep;
-        faction.needSend = true;
-        faction.needSave = true;
+        MarkChanged(&faction);
 
         SetVisible(&faction);
 
@@ -385,7 +416,7 @@ bool ReputationMgr::SetOneFactionReputation(FactionEntry const* factionEntry, in
             // Server alters "At war" flag on two occasions:
             // * When reputation dips to "Hostile": forced tick and now locked for manual changes
             if (rankNew < REP_UNFRIENDLY && rankNew < rankOld && rankOld > REP_HOSTILE)
-                SetAtWar(&itr->second, true);
+                SetAtWar(&faction, true);
             // * When reputation improves to "Neutral": untick by id, can be manually overriden for eligible factions
             else if (rankNew > REP_UNFRIENDLY && rankNew > rankOld && rankOld < REP_NEUTRAL)
                 SetAtWar(RepListID(factionEntry->reputationListID), false);
@@ -422,11 +453,7 @@ void ReputationMgr::SetVisible(FactionEntry const* factionEntry)
     if (!factionEntry || !factionEntry->HasReputation())
         return;
 
-    FactionStateList::iterator itr = m_factions.find(RepListID(factionEntry->reputationListID));
-    if (itr == m_factions.end())
-        return;
-
-    SetVisible(&itr->second);
+    SetVisible(GetState(RepListID(factionEntry->reputationListID)));
 }
 
 void ReputationMgr::SetVisible(FactionState* faction)
@@ -443,8 +470,7 @@ void ReputationMgr::SetVisible(FactionState* faction)
         return;
 
     faction->Flags |= FACTION_FLAG_VISIBLE;
-    faction->needSend = true;
-    faction->needSave = true;
+    MarkChanged(faction);
 
     ++m_visibleFactionCount;
 
@@ -453,15 +479,15 @@ void ReputationMgr::SetVisible(FactionState* faction)
 
 void ReputationMgr::SetAtWar(RepListID repListID, bool on)
 {
-    FactionStateList::iterator itr = m_factions.find(repListID);
-    if (itr == m_factions.end())
+    FactionState* faction = GetState(repListID);
+    if (!faction)
         return;
 
     // always invisible or hidden faction can't change war state
-    if (itr->second.Flags & (FACTION_FLAG_INVISIBLE_FORCED | FACTION_FLAG_HIDDEN))
+    if (faction->Flags & (FACTION_FLAG_INVISIBLE_FORCED | FACTION_FLAG_HIDDEN))
         return;
 
-    SetAtWar(&itr->second, on);
+    SetAtWar(faction, on);
 }
 
 void ReputationMgr::SetAtWar(FactionState* faction, bool atWar)
@@ -482,17 +508,12 @@ void ReputationMgr::SetAtWar(FactionState* faction, bool atWar)
     else
         faction->Flags &= ~uint32(FACTION_FLAG_AT_WAR);
 
-    faction->needSend = true;
-    faction->needSave = true;
+    MarkChanged(faction);
 }
 
 void ReputationMgr::SetInactive(RepListID repListID, bool on)
 {
-    FactionStateList::iterator itr = m_factions.find(repListID);
-    if (itr == m_factions.end())
-        return;
-
-    SetInactive(&itr->second, on);
+    SetInactive(GetState(repListID), on);
 }
 
 void ReputationMgr::SetInactive(FactionState* faction, bool inactive)
@@ -513,8 +534,7 @@ void ReputationMgr::SetInactive(FactionState* faction, bool inactive)
     else
         faction->Flags &= ~FACTION_FLAG_INACTIVE;
 
-    faction->needSend = true;
-    faction->needSave = true;
+    MarkChanged(faction);
 }
 
 void ReputationMgr::LoadFromDB(QueryResult* result)
@@ -533,7 +553,7 @@ void ReputationMgr::LoadFromDB(QueryResult* result)
             FactionEntry const* factionEntry = sFactionStore.LookupEntry(fields[0].GetUInt32());
             if (factionEntry && factionEntry->HasReputation())
             {
-                FactionState* faction = &m_factions[factionEntry->reputationListID];
+                FactionState* faction = GetState(RepListID(factionEntry->reputationListID));
 
                 // update standing to current
                 faction->Standing = int32(fields[1].GetUInt32());
@@ -583,6 +603,9 @@ void ReputationMgr::LoadFromDB(QueryResult* result)
 
         delete result;
     }
+
+    // the standings are set without MarkChanged
+    m_initialBlock.clear();
 }
 
 void ReputationMgr::SaveToDB()
@@ -593,16 +616,22 @@ void ReputationMgr::SaveToDB()
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delRep, "DELETE FROM character_reputation WHERE guid = ? AND faction=?");
     SqlStatement stmtIns = CharacterDatabase.CreateStatement(insRep, "INSERT INTO character_reputation (guid,faction,standing,flags) VALUES (?, ?, ?, ?)");
 
-    for (auto& m_faction : m_factions)
+    // only the factions changed since the last save are looked at, the list is kept for those still to send
+    size_t kept = 0;
+    for (RepListID id : m_changedFactions)
     {
-        FactionState& faction = m_faction.second;
+        FactionState& faction = m_factions[id];
         if (faction.needSave)
         {
             stmtDel.PExecute(m_player->GetGUIDLow(), faction.ID);
             stmtIns.PExecute(m_player->GetGUIDLow(), faction.ID, faction.Standing, faction.Flags);
             faction.needSave = false;
         }
+
+        if (faction.needSend)
+            m_changedFactions[kept++] = id;
     }
+    m_changedFactions.resize(kept);
 }
 
 void ReputationMgr::UpdateRankCounters(ReputationRank old_rank, ReputationRank new_rank)
@@ -22,7 +22,9 @@
 #include "Common.h"
 #include "Globals/SharedDefines.h"
 #include "Server/DBCStructure.h"
+#include "ByteBuffer.h"
 #include <map>
+#include <vector>
 
 enum FactionFlags
 {
@@ -47,8 +49,10 @@ struct FactionState
     bool needSave;
 };
 
-typedef std::map<RepListID, FactionState> FactionStateList;
-typedef std::pair<FactionStateList::const_iterator, FactionStateList::const_iterator> FactionStateListPair;
+// indexed by RepListID, the slots of the ids without a reputation faction have ID 0
+typedef std::vector<FactionState> FactionStateList;
+
+#define MAX_REPUTATION_LIST_ID 128                          // slots sent by SMSG_INITIALIZE_FACTIONS
 
 typedef std::map<uint32, ReputationRank> ForcedReactions;
 
@@ -58,7 +62,7 @@ class QueryResult;
 class ReputationMgr
 {
     public:                                                 // constructors and global modifiers
-        explicit ReputationMgr(Player* owner) : m_player(owner),
+        explicit ReputationMgr(Player* owner) : m_player(owner), m_pendingSend(false), m_pendingRankIncrease(false),
             m_visibleFactionCount(0), m_honoredFactionCount(0), m_reveredFactionCount(0), m_exaltedFactionCount(0) {}
         ~ReputationMgr() {}
 
@@ -113,12 +117,16 @@ class ReputationMgr
     public:                                                 // senders
         void SendInitialReputations();
         void SendForceReactions();
-        void SendState(FactionState const* faction, bool anyRankIncreased);
+        // once per player update: the standings changed since the last call in a single SMSG_SET_FACTION_STANDING,
+        // so the spillover of all kills of a tick is sent once
+        void SendPendingStates();
 
     private:                                                // internal helper functions
         void Initialize();
         uint32 GetDefaultStateFlags(const FactionEntry* factionEntry) const;
+        FactionState* GetState(RepListID id);
         void SetReputation(FactionEntry const* factionEntry, int32 standing, bool incremental);
+        void MarkChanged(FactionState* faction);
         bool SetOneFactionReputation(FactionEntry const* factionEntry, int32 standing, bool incremental);
         void SetVisible(FactionState* faction);
         void SetAtWar(FactionState* faction, bool atWar);
@@ -128,6 +136,10 @@ class ReputationMgr
     private:
         Player* m_player;
         FactionStateList m_factions;
+        std::vector<RepListID> m_changedFactions;           // with needSend or needSave set
+        ByteBuffer m_initialBlock;                          // factions of SMSG_INITIALIZE_FACTIONS, empty until built after a change
+        bool m_pendingSend;                                 // a standing changed since the last SendPendingStates
+        bool m_pendingRankIncrease;
         ForcedReactions m_forcedReactions;
         uint8 m_visibleFactionCount : 8;
         uint8 m_honoredFactionCount : 8;
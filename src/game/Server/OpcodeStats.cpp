@@ -0,0 +1,111 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeStats.h"
+#include "Server/Opcodes.h"
+
+uint64 OpcodeStat::GetPercentile(float part) const
+{
+    uint64 const wanted = uint64(sampled * part);
+    uint64 count = 0;
+    for (uint32 i = 0; i < OPCODE_STATS_BUCKETS; ++i)
+    {
+        count += histogram[i];
+        if (count > wanted)
+            return i + 1 < OPCODE_STATS_BUCKETS ? uint64(1) << i : maxHandlerTime;
+    }
+    return maxHandlerTime;
+}
+
+OpcodeStats::OpcodeStats() : m_sampleRate(0), m_counters(NUM_MSG_TYPES)
+{
+}
+
+bool OpcodeStats::AddReceived(uint32 opcode, size_t bytes)
+{
+    Counters& counters = m_counters[opcode];
+    uint64 const received = counters.received.fetch_add(1, std::memory_order_relaxed);
+    counters.bytesIn.fetch_add(bytes, std::memory_order_relaxed);
+
+    uint32 const rate = m_sampleRate.load(std::memory_order_relaxed);
+    return rate && received % rate == 0;
+}
+
+void OpcodeStats::AddSent(uint32 opcode, size_t bytes)
+{
+    Counters& counters = m_counters[opcode];
+    counters.sent.fetch_add(1, std::memory_order_relaxed);
+    counters.bytesOut.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void OpcodeStats::AddHandled(uint32 opcode, uint64 waitTime, uint64 handlerTime)
+{
+    Counters& counters = m_counters[opcode];
+    counters.sampled.fetch_add(1, std::memory_order_relaxed);
+    counters.waitTime.fetch_add(waitTime, std::memory_order_relaxed);
+    counters.handlerTime.fetch_add(handlerTime, std::memory_order_relaxed);
+
+    uint64 maxTime = counters.maxHandlerTime.load(std::memory_order_relaxed);
+    while (handlerTime > maxTime && !counters.maxHandlerTime.compare_exchange_weak(maxTime, handlerTime, std::memory_order_relaxed));
+
+    uint32 bucket = 0;
+    while (bucket + 1 < OPCODE_STATS_BUCKETS && handlerTime >= (uint64(1) << bucket))
+        ++bucket;
+    counters.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void OpcodeStats::GetStats(std::vector<OpcodeStat>& result) const
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        Counters const& counters = m_counters[i];
+        if (!counters.received && !counters.sent)
+            continue;
+
+        OpcodeStat stat;
+        stat.opcode = i;
+        stat.received = counters.received;
+        stat.bytesIn = counters.bytesIn;
+        stat.sent = counters.sent;
+        stat.bytesOut = counters.bytesOut;
+        stat.sampled = counters.sampled;
+        stat.waitTime = counters.waitTime;
+        stat.handlerTime = counters.handlerTime;
+        stat.maxHandlerTime = counters.maxHandlerTime;
+        for (uint32 j = 0; j < OPCODE_STATS_BUCKETS; ++j)
+            stat.histogram[j] = counters.histogram[j];
+        result.push_back(stat);
+    }
+}
+
+void OpcodeStats::Reset()
+{
+    for (Counters& counters : m_counters)
+    {
+        counters.received = 0;
+        counters.bytesIn = 0;
+        counters.sent = 0;
+        counters.bytesOut = 0;
+        counters.sampled = 0;
+        counters.waitTime = 0;
+        counters.handlerTime = 0;
+        counters.maxHandlerTime = 0;
+        for (std::atomic<uint32>& bucket : counters.histogram)
+            bucket = 0;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODE_STATS_H
+#define MANGOS_OPCODE_STATS_H
+
+#include "Common.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+// handler time histogram, bucket i counts the handlers that took less than 2^i microseconds, the last one the rest
+#define OPCODE_STATS_BUCKETS    20
+
+// per opcode cost of the packets, filled from any thread. every packet is counted with its size, one out
+// of sample rate received packets is also timed: the wait in the session queues and the handler time
+struct OpcodeStat
+{
+    uint32 opcode;
+    uint64 received;
+    uint64 bytesIn;
+    uint64 sent;
+    uint64 bytesOut;
+    uint64 sampled;
+    uint64 waitTime;                                        // microseconds, sampled packets only
+    uint64 handlerTime;                                     // microseconds, sampled packets only
+    uint64 maxHandlerTime;
+    std::array<uint32, OPCODE_STATS_BUCKETS> histogram;
+
+    // upper bound in microseconds of the handler time of the given part of the sampled packets
+    uint64 GetPercentile(float part) const;
+};
+
+class OpcodeStats
+{
+    public:
+        OpcodeStats();
+        OpcodeStats(const OpcodeStats&) = delete;
+
+        // 0 disables the timing, 1 times every packet
+        void SetSampleRate(uint32 rate) { m_sampleRate = rate; }
+        uint32 GetSampleRate() const { return m_sampleRate; }
+
+        // true when the packet is to be timed
+        bool AddReceived(uint32 opcode, size_t bytes);
+        void AddSent(uint32 opcode, size_t bytes);
+        void AddHandled(uint32 opcode, uint64 waitTime, uint64 handlerTime);
+
+        // values since start or the last reset, only opcodes seen at all
+        void GetStats(std::vector<OpcodeStat>& result) const;
+        void Reset();
+
+    private:
+        struct Counters
+        {
+            std::atomic<uint64> received;
+            std::atomic<uint64> bytesIn;
+            std::atomic<uint64> sent;
+            std::atomic<uint64> bytesOut;
+            std::atomic<uint64> sampled;
+            std::atomic<uint64> waitTime;
+            std::atomic<uint64> handlerTime;
+            std::atomic<uint64> maxHandlerTime;
+            std::array<std::atomic<uint32>, OPCODE_STATS_BUCKETS> histogram;
+        };
+
+        std::atomic<uint32> m_sampleRate;
+        std::vector<Counters> m_counters;
+};
+
+#endif
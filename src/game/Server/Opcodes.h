@@ -25,6 +25,8 @@
 
 #include "Common.h"
 
+#include <atomic>
+
 // Note: this include need for be sure have full definition of class WorldSession
 //       if this class definition not complite then VS for x64 release use different size for
 //       struct OpcodeHandler in this header and Opcode.cpp and get totally wrong data from
@@ -1366,6 +1368,7 @@ enum PacketProcessing
     PROCESS_THREADSAFE,                                     // packet is thread-safe - process it in Map::Update()
     PROCESS_MAP_THREAD,                                     // packet is map thread safe
     PROCESS_IMMEDIATE,                                      // packet is network thread safe
+    PROCESS_PARALLEL,                                       // packet only touches its session, player or static data - process it on the session threads
 };
 
 class WorldPacket;
@@ -1380,6 +1383,9 @@ struct OpcodeHandler
 
 extern OpcodeHandler opcodeTable[NUM_MSG_TYPES];
 
+/// Typical size of the packets built for each opcode, reserved by WorldPacket beforehand
+extern std::atomic<uint16> opcodeSizeHints[NUM_MSG_TYPES];
+
 /// Lookup opcode name for human understandable logging
 inline const char* LookupOpcodeName(uint16 id)
 {
@@ -20,6 +20,11 @@
 #include "WorldPacket.h"
 #include "Config/Config.h"
 #include "Globals/SharedDefines.h"
+#include "Log.h"
+#include "Util.h"
+#include "Server/Opcodes.h"
+
+#include <algorithm>
 
 #pragma pack(push, 1)
 
@@ -57,13 +62,23 @@ struct PacketHeader
 
 #pragma pack(pop)
 
-PacketLog::PacketLog() : _file(nullptr)
+PacketLog::PacketLog() : _enabled(false), _file(nullptr), _fileIndex(0), _fileSize(0), _maxFileSize(0), _maxPending(0), _dropped(0), _reportedDropped(0), _stop(false)
 {
     std::call_once(_initializeFlag, &PacketLog::Initialize, this);
 }
 
 PacketLog::~PacketLog()
 {
+    if (_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_logPacketLock);
+            _stop = true;
+        }
+        _wakeUp.notify_one();
+        _writer.join();
+    }
+
     if (_file)
         fclose(_file);
 
@@ -78,7 +93,6 @@ PacketLog* PacketLog::instance()
 
 void PacketLog::Initialize()
 {
-    static uint32 buildVersion[] = EXPECTED_MANGOSD_CLIENT_BUILD;
     std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
 
     if (!logsDir.empty())
@@ -86,29 +100,83 @@ void PacketLog::Initialize()
             logsDir.push_back('/');
 
     std::string logname = sConfig.GetStringDefault("PacketLogFile", "");
-    if (!logname.empty())
+    if (logname.empty())
+        return;
+
+    _fileName = logsDir + logname;
+    _maxFileSize = uint64(sConfig.GetIntDefault("PacketLog.MaxFileSize", 0)) * 1024 * 1024;
+    _maxPending = std::max(sConfig.GetIntDefault("PacketLog.BufferSize", 16), 1) * size_t(1024 * 1024);
+
+    for (std::string const& token : StrSplit(sConfig.GetStringDefault("PacketLog.Accounts", ""), ", "))
+        if (uint32 accountId = strtoul(token.c_str(), nullptr, 0))
+            _accounts.insert(accountId);
+
+    Tokens opcodes = StrSplit(sConfig.GetStringDefault("PacketLog.Opcodes", ""), ", ");
+    if (!opcodes.empty())
+    {
+        _opcodes.resize(NUM_MSG_TYPES, false);
+        for (std::string const& token : opcodes)
+        {
+            uint32 opcode = strtoul(token.c_str(), nullptr, 0);
+            if (opcode < NUM_MSG_TYPES)
+                _opcodes[opcode] = true;
+        }
+    }
+
+    if (!OpenFile())
+        return;
+
+    _pending.reserve(PACKET_LOG_WRITE_SIZE * 2);
+    _writing.reserve(PACKET_LOG_WRITE_SIZE * 2);
+    _enabled = true;
+    _writer = std::thread(&PacketLog::WriteThread, this);
+}
+
+bool PacketLog::OpenFile()
+{
+    static uint32 buildVersion[] = EXPECTED_MANGOSD_CLIENT_BUILD;
+
+    std::string fileName = _fileName;
+    if (_fileIndex)
+    {
+        // World.pkt is continued in World_1.pkt, World_2.pkt, ...
+        size_t extension = fileName.find_last_of('.');
+        size_t directory = fileName.find_last_of("/\\");
+        if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+            extension = fileName.length();
+        fileName.insert(extension, "_" + std::to_string(_fileIndex));
+    }
+
+    _file = fopen(fileName.c_str(), "wb");
+    if (!_file)
     {
-        _file = fopen((logsDir + logname).c_str(), "wb");
-
-        LogHeader header;
-        header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
-        header.FormatVersion = 0x0301;
-        header.SnifferId = 'T';
-        header.Build = buildVersion[0];
-        header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
-        std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
-        header.SniffStartUnixtime = time(nullptr);
-        header.SniffStartTicks = WorldTimer::getMSTime();
-        header.OptionalDataSize = 0;
-
-        if (CanLogPacket())
-            fwrite(&header, sizeof(header), 1, _file);
+        sLog.outError("PacketLog: can not open %s for writing", fileName.c_str());
+        return false;
     }
+
+    LogHeader header;
+    header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
+    header.FormatVersion = 0x0301;
+    header.SnifferId = 'T';
+    header.Build = buildVersion[0];
+    header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
+    std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
+    header.SniffStartUnixtime = time(nullptr);
+    header.SniffStartTicks = WorldTimer::getMSTime();
+    header.OptionalDataSize = 0;
+
+    fwrite(&header, sizeof(header), 1, _file);
+    _fileSize = sizeof(header);
+    return true;
 }
 
-void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
+void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 accountId)
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
+    if (!_accounts.empty() && _accounts.find(accountId) == _accounts.end())
+        return;
+
+    if (!_opcodes.empty() && (packet.GetOpcode() >= _opcodes.size() || !_opcodes[packet.GetOpcode()]))
+        return;
 
     PacketHeader header;
     header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
@@ -132,9 +200,71 @@ void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost:
     header.Length = packet.size() + sizeof(header.Opcode);
     header.Opcode = packet.GetOpcode();
 
-    fwrite(&header, sizeof(header), 1, _file);
-    if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+    size_t const size = sizeof(header) + packet.size();
+    bool wakeUp;
+    {
+        std::lock_guard<std::mutex> lock(_logPacketLock);
+        // a stalled disk must not grow the memory without end, the packet is counted instead
+        if (_pending.size() + size > _maxPending)
+        {
+            ++_dropped;
+            return;
+        }
+
+        uint8 const* headerBytes = reinterpret_cast<uint8 const*>(&header);
+        _pending.insert(_pending.end(), headerBytes, headerBytes + sizeof(header));
+        if (!packet.empty())
+            _pending.insert(_pending.end(), packet.contents(), packet.contents() + packet.size());
+
+        // only the packet crossing the size wakes the writer
+        wakeUp = _pending.size() >= PACKET_LOG_WRITE_SIZE && _pending.size() - size < PACKET_LOG_WRITE_SIZE;
+    }
+
+    if (wakeUp)
+        _wakeUp.notify_one();
+}
+
+void PacketLog::WriteThread()
+{
+    std::unique_lock<std::mutex> lock(_logPacketLock);
+    while (true)
+    {
+        _wakeUp.wait_for(lock, std::chrono::milliseconds(PACKET_LOG_WRITE_INTERVAL), [this]() { return _stop || _pending.size() >= PACKET_LOG_WRITE_SIZE; });
+
+        if (_pending.empty())
+        {
+            if (_stop)
+                break;
+            continue;
+        }
 
-    fflush(_file);
+        _writing.swap(_pending);
+        lock.unlock();
+
+        // the batch stays in one file, so a file ends at most one batch after the limit
+        if (_maxFileSize && _fileSize > sizeof(LogHeader) && _fileSize + _writing.size() > _maxFileSize)
+        {
+            fclose(_file);
+            _file = nullptr;
+            ++_fileIndex;
+            OpenFile();
+        }
+
+        if (_file)
+        {
+            fwrite(_writing.data(), 1, _writing.size(), _file);
+            fflush(_file);
+            _fileSize += _writing.size();
+        }
+        _writing.clear();
+
+        uint64 const dropped = _dropped;
+        if (dropped != _reportedDropped)
+        {
+            sLog.outError("PacketLog: " UI64FMTD " packets dropped, the writer can not keep up (PacketLog.BufferSize)", dropped - _reportedDropped);
+            _reportedDropped = dropped;
+        }
+
+        lock.lock();
+    }
 }
@@ -21,7 +21,16 @@
 #include "Common.h"
 
 #include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+// the writer thread is woken once this much is pending, otherwise it writes every PACKET_LOG_WRITE_INTERVAL ms
+#define PACKET_LOG_WRITE_SIZE       (64 * 1024)
+#define PACKET_LOG_WRITE_INTERVAL   100
 
 enum Direction
 {
@@ -31,23 +40,52 @@ enum Direction
 
 class WorldPacket;
 
+/**
+ * Writes the packets in PKT 3.1 format. The socket threads only copy the packet into a pending
+ * buffer, a background thread writes it out in large chunks and rotates the file by size.
+ */
 class PacketLog
 {
     private:
         PacketLog();
         ~PacketLog();
-        std::mutex _logPacketLock;
+        std::mutex _logPacketLock;                          // guards _pending and _stop
         std::once_flag _initializeFlag;
 
     public:
         static PacketLog* instance();
 
         void Initialize();
-        bool CanLogPacket() const { return (_file != nullptr); }
-        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port);
+        bool CanLogPacket() const { return _enabled; }
+        // accountId is 0 before the socket is authenticated
+        void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port, uint32 accountId);
+
+        // packets not logged because the pending buffer was full
+        uint64 GetDroppedPackets() const { return _dropped; }
 
     private:
-        FILE* _file;
+        bool OpenFile();
+        void WriteThread();
+
+        bool _enabled;
+        FILE* _file;                                        // only used by the writer thread once it runs
+        std::string _fileName;                              // name of the first file, the rotated ones get _<n> appended
+        uint32 _fileIndex;
+        uint64 _fileSize;
+        uint64 _maxFileSize;                                // 0 for no rotation
+
+        std::set<uint32> _accounts;                         // empty for all accounts
+        std::vector<bool> _opcodes;                         // empty for all opcodes
+
+        std::vector<uint8> _pending;
+        std::vector<uint8> _writing;                        // only used by the writer thread
+        size_t _maxPending;
+        std::atomic<uint64> _dropped;
+        uint64 _reportedDropped;
+
+        std::condition_variable _wakeUp;
+        std::thread _writer;
+        bool _stop;
 };
 
 #define sPacketLog PacketLog::instance()
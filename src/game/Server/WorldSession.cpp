@@ -40,9 +40,11 @@
 #include "Auth/HMACSHA1.h"
 #include "GMTickets/GMTicketMgr.h"
 #include "Loot/LootMgr.h"
+#include "TraceRecorder.h"
 
 #include <boost/asio/ip/address_v4.hpp>
 
+#include <chrono>
 #include <mutex>
 #include <deque>
 #include <cstdarg>
@@ -194,6 +196,18 @@ void WorldSession::SetExpansion(uint8 expansion)
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet) const
+{
+    if (PrepareSendPacket(packet))
+        m_Socket->SendPacket(packet);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket const& packet) const
+{
+    if (PrepareSendPacket(packet.GetPacket()))
+        m_Socket->SendPacket(packet.Get());
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet) const
 {
 #ifdef BUILD_PLAYERBOT
     // Send packet to bot AI
@@ -216,7 +230,9 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 #endif
 
     if (!m_Socket || m_Socket->IsClosed())
-        return;
+        return false;
+
+    sWorld.GetOpcodeStats().AddSent(packet.GetOpcode(), packet.size());
 
 #ifdef MANGOS_DEBUG
 
@@ -254,54 +270,123 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
+}
+
+// processed packets kept per session for the socket to read the next ones into, bigger ones are freed
+#define MAX_SPARE_PACKETS           16
+#define MAX_SPARE_PACKET_CAPACITY   1024
+
+// heartbeat and facing packets are superseded by the next movement packet, they go first when a queue is full
+static void EraseMovementPackets(std::deque<std::unique_ptr<WorldPacket>>& queue)
+{
+    for (auto itr = queue.begin(); itr != queue.end();)
+    {
+        switch ((*itr)->GetOpcode())
+        {
+            case MSG_MOVE_SET_FACING:
+            case MSG_MOVE_HEARTBEAT:
+            {
+                itr = queue.erase(itr);
+                break;
+            }
+            default:
+                ++itr;
+                break;
+        }
+    }
 }
 
 /// Add an incoming packet to the queue
-void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
+bool WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet, std::unique_ptr<WorldPacket>* spare)
 {
     sWorld.IncrementOpcodeCounter(new_packet->GetOpcode());
+    if (sWorld.GetOpcodeStats().AddReceived(new_packet->GetOpcode(), new_packet->size()) && new_packet->GetReceivedTime() == std::chrono::steady_clock::time_point())
+        new_packet->SetReceivedTime(std::chrono::steady_clock::now());
     OpcodeHandler const& opHandle = opcodeTable[new_packet->GetOpcode()];
     if (opHandle.packetProcessing == PROCESS_IMMEDIATE)
     {
-        (this->*opHandle.handler)(*new_packet);
+        CallHandler(opHandle, *new_packet);
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
-        return;
+        if (spare)
+            *spare = std::move(new_packet);
+        return true;
     }
 
+#if !defined(BUILD_PLAYERBOT) && !defined(ENABLE_PLAYERBOTS)
+    // the checks of a chat message needing nothing of the world are done here, the world thread only routes it
+    if (new_packet->GetOpcode() == CMSG_MESSAGECHAT && !PrepareChatMessage(*new_packet))
+    {
+        if (spare)
+            *spare = std::move(new_packet);
+        return true;
+    }
+#endif
+
+    uint32 const maxQueued = sWorld.getConfig(CONFIG_UINT32_MAX_QUEUED_PACKETS);
     if (opHandle.packetProcessing == PROCESS_MAP_THREAD)
     {
         std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+        if (maxQueued && m_recvQueueMap.size() >= maxQueued)
+        {
+            EraseMovementPackets(m_recvQueueMap);
+            if (m_recvQueueMap.size() >= maxQueued)
+            {
+                sLog.outError("WorldSession::QueuePacket: account %u has " SIZEFMTD " packets waiting for the map, closing the connection", GetAccountId(), m_recvQueueMap.size());
+                return false;
+            }
+        }
         m_recvQueueMap.push_back(std::move(new_packet));
+        return true;
     }
-    else
+
+    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    if (maxQueued && m_recvQueue.size() + m_recvQueueParallel.size() >= maxQueued)
     {
-        std::lock_guard<std::mutex> guard(m_recvQueueLock);
+        EraseMovementPackets(m_recvQueue);
+        if (m_recvQueue.size() + m_recvQueueParallel.size() >= maxQueued)
+        {
+            sLog.outError("WorldSession::QueuePacket: account %u has " SIZEFMTD " packets waiting for the world, closing the connection", GetAccountId(), m_recvQueue.size() + m_recvQueueParallel.size());
+            return false;
+        }
+    }
+
+#if !defined(BUILD_PLAYERBOT) && !defined(ENABLE_PLAYERBOTS)
+    // the bot managers also look at the packets of their master, they are not thread safe
+    if (opHandle.packetProcessing == PROCESS_PARALLEL)
+        m_recvQueueParallel.push_back(std::move(new_packet));
+    else
+#endif
         m_recvQueue.push_back(std::move(new_packet));
+
+    if (spare && !m_sparePackets.empty())
+    {
+        *spare = std::move(m_sparePackets.back());
+        m_sparePackets.pop_back();
     }
+    return true;
 }
 
-void WorldSession::DeleteMovementPackets()
+void WorldSession::RecyclePackets(std::deque<std::unique_ptr<WorldPacket>>& packets)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
-    for (auto itr = m_recvQueueMap.begin(); itr != m_recvQueueMap.end();)
+    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    for (std::unique_ptr<WorldPacket>& packet : packets)
     {
-        switch ((*itr)->GetOpcode())
-        {
-            case MSG_MOVE_SET_FACING:
-            case MSG_MOVE_HEARTBEAT:
-            {
-                itr = m_recvQueueMap.erase(itr);
-                break;
-            }
-            default:
-                ++itr;
-                break;
-        }
+        if (m_sparePackets.size() >= MAX_SPARE_PACKETS)
+            break;
+
+        if (packet && packet->capacity() <= MAX_SPARE_PACKET_CAPACITY)
+            m_sparePackets.push_back(std::move(packet));
     }
 }
 
+void WorldSession::DeleteMovementPackets()
+{
+    std::lock_guard<std::mutex> guard(m_recvQueueMapLock);
+    EraseMovementPackets(m_recvQueueMap);
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const
 {
@@ -342,9 +427,115 @@ void WorldSession::ProcessByteBufferException(WorldPacket const& packet)
     }
 }
 
+/// Check the packet is expected in the current session state and call its handler
+void WorldSession::ProcessPacket(WorldPacket& packet)
+{
+    OpcodeHandler const& opHandle = opcodeTable[packet.GetOpcode()];
+    try
+    {
+        switch (opHandle.status)
+        {
+            case STATUS_LOGGEDIN:
+                if (!_player)
+                {
+                    // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                    if (!m_playerRecentlyLogout)
+                        LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                }
+                else if (_player->IsInWorld())
+                    ExecuteOpcode(opHandle, packet);
+
+                // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+
+#ifdef BUILD_PLAYERBOT
+                if (_player && _player->GetPlayerbotMgr())
+                    _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(packet);
+#endif
+#ifdef ENABLE_PLAYERBOTS
+                if (_player && _player->GetPlayerbotMgr())
+                    _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(packet);
+#endif
+                break;
+            case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
+                if (!_player && !m_playerRecentlyLogout)
+                {
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet and not recently logout");
+                }
+                else
+                    // not expected _player or must checked in packet hanlder
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_TRANSFER:
+                if (!_player)
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                else if (_player->IsInWorld())
+                    LogUnexpectedOpcode(packet, "the player is still in world");
+                else
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_AUTHED:
+                // prevent cheating with skip queue wait
+                if (m_inQueue)
+                {
+                    LogUnexpectedOpcode(packet, "the player not pass queue yet");
+                    break;
+                }
+
+                // single from authed time opcodes send in to after logout time
+                // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
+                if (packet.GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
+                    m_playerRecentlyLogout = false;
+
+                ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_NEVER:
+                sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                              packet.GetOpcodeName(),
+                              packet.GetOpcode());
+                break;
+            case STATUS_UNHANDLED:
+                DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
+                          packet.GetOpcodeName(),
+                          packet.GetOpcode());
+                break;
+            default:
+                sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
+                              packet.GetOpcodeName(),
+                              packet.GetOpcode());
+                break;
+        }
+    }
+    catch (ByteBufferException&)
+    {
+        ProcessByteBufferException(packet);
+    }
+}
+
+/// Handle the PROCESS_PARALLEL packets, may run on a session thread while other sessions do the same
+void WorldSession::UpdateParallel()
+{
+    std::deque<std::unique_ptr<WorldPacket>> recvQueueCopy;
+    {
+        std::lock_guard<std::mutex> guard(m_recvQueueLock);
+        std::swap(recvQueueCopy, m_recvQueueParallel);
+    }
+
+    if (recvQueueCopy.empty())
+        return;
+
+    for (size_t i = 0; m_Socket && !m_Socket->IsClosed() && i < recvQueueCopy.size(); ++i)
+        ProcessPacket(*recvQueueCopy[i]);
+
+    RecyclePackets(recvQueueCopy);
+}
+
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 diff)
 {
+    TraceScope trace("session", "WorldSession::Update");
+    if (trace.IsActive())
+        trace.SetDetail("account " + std::to_string(GetAccountId()));
+
     GetMessager().Execute(this);
 
     std::deque<std::unique_ptr<WorldPacket>> recvQueueCopy;
@@ -355,93 +546,11 @@ bool WorldSession::Update(uint32 diff)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !recvQueueCopy.empty())
-    {
-        // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
-
-        auto const packet = std::move(recvQueueCopy.front());
-        recvQueueCopy.pop_front();
-
-        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        try
-        {
-            switch (opHandle.status)
-            {
-                case STATUS_LOGGEDIN:
-                    if (!_player)
-                    {
-                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                        if (!m_playerRecentlyLogout)
-                            LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    }
-                    else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, *packet);
-
-                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+    for (size_t i = 0; m_Socket && !m_Socket->IsClosed() && i < recvQueueCopy.size(); ++i)
+        ProcessPacket(*recvQueueCopy[i]);
 
-#ifdef BUILD_PLAYERBOT
-                    if (_player && _player->GetPlayerbotMgr())
-                        _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*packet);
-#endif
-#ifdef ENABLE_PLAYERBOTS
-                    if (_player && _player->GetPlayerbotMgr())
-                        _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*packet);
-#endif
-                    break;
-                case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
-                    if (!_player && !m_playerRecentlyLogout)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet and not recently logout");
-                    }
-                    else
-                        // not expected _player or must checked in packet hanlder
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_TRANSFER:
-                    if (!_player)
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    else if (_player->IsInWorld())
-                        LogUnexpectedOpcode(*packet, "the player is still in world");
-                    else
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_AUTHED:
-                    // prevent cheating with skip queue wait
-                    if (m_inQueue)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player not pass queue yet");
-                        break;
-                    }
-
-                    // single from authed time opcodes send in to after logout time
-                    // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
-                    if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
-                        m_playerRecentlyLogout = false;
-
-                    ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_NEVER:
-                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-                case STATUS_UNHANDLED:
-                    DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
-                              packet->GetOpcodeName(),
-                              packet->GetOpcode());
-                    break;
-                default:
-                    sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-            }
-        }
-        catch (ByteBufferException&)
-        {
-            ProcessByteBufferException(*packet);
-        }
-    }
+    if (!recvQueueCopy.empty())
+        RecyclePackets(recvQueueCopy);
 
 #ifdef BUILD_PLAYERBOT
     // Process player bot packets
@@ -693,7 +802,7 @@ void WorldSession::LogoutPlayer()
                 slot->UpdateLogoutTime();
             }
 
-            guild->BroadcastEvent(GE_SIGNED_OFF, _player->GetObjectGuid(), _player->GetName());
+            guild->QueueMemberPresence(_player->GetObjectGuid(), _player->GetName(), false);
         }
 
         ///- Remove pet
@@ -868,7 +977,7 @@ void WorldSession::SendOfflineNameQueryResponses()
     m_offlineNameQueries.clear();
 
     for (auto& response : m_offlineNameResponses)
-        SendNameQueryResponse(response);
+        SendPacket(response);
 
     m_offlineNameResponses.clear();
 }
@@ -1309,6 +1418,24 @@ void WorldSession::SendRedirectClient(std::string& ip, uint16 port) const
     SendPacket(pkt);
 }
 
+void WorldSession::CallHandler(OpcodeHandler const& opHandle, WorldPacket& packet)
+{
+    // sampled packets got their received time when queued, time sync responses always have one
+    std::chrono::steady_clock::time_point const receivedTime = packet.GetReceivedTime();
+    if (receivedTime == std::chrono::steady_clock::time_point() || !sWorld.GetOpcodeStats().GetSampleRate())
+    {
+        (this->*opHandle.handler)(packet);
+        return;
+    }
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    (this->*opHandle.handler)(packet);
+    std::chrono::steady_clock::time_point const end = std::chrono::steady_clock::now();
+
+    sWorld.GetOpcodeStats().AddHandled(packet.GetOpcode(), uint64(std::chrono::duration_cast<std::chrono::microseconds>(start - receivedTime).count()),
+                                       uint64(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()));
+}
+
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
     // need prevent do internal far teleports in handlers because some handlers do lot steps
@@ -1316,7 +1443,7 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
-    (this->*opHandle.handler)(packet);
+    CallHandler(opHandle, packet);
 
     if (_player)
     {
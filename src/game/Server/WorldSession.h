@@ -54,6 +54,7 @@ class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedWorldPacket;
 class QueryResult;
 class LoginQueryHolder;
 class CharacterHandler;
@@ -261,6 +262,7 @@ class WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const& packet) const;
+        void SendPacket(SharedWorldPacket const& packet) const;
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -324,19 +326,23 @@ class WorldSession
         void LogoutPlayer();
         void KickPlayer(bool save = false, bool inPlace = false); // inplace variable needed for shutdown
 
-        void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        // false when the session has more packets waiting than Network.MaxQueuedPackets, the connection is to be closed.
+        // a processed packet is handed back in spare when there is one, for the next received packet
+        bool QueuePacket(std::unique_ptr<WorldPacket> new_packet, std::unique_ptr<WorldPacket>* spare = nullptr);
 
         void DeleteMovementPackets();
 
         bool Update(uint32 diff);
         void UpdateMap(uint32 diff);
+        void UpdateParallel();
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position) const;
 
-        void SendNameQueryResponse(CharacterNameQueryResponse& response) const;
+        static void BuildNameQueryResponse(CharacterNameQueryResponse const& response, WorldPacket& data);
+        void SendNameQueryResponse(WorldPacket const& data);
         void SendNameQueryResponseFromDB(ObjectGuid guid) const;
-        static void SendNameQueryResponseFromDBCallBack(QueryResult* result, uint32 accountId);
+        static void SendNameQueryResponseFromDBCallBack(QueryResult* result, uint32 accountId, uint32 cacheTicket);
 
         void SendTrainerList(ObjectGuid guid) const;
 
@@ -469,7 +475,7 @@ class WorldSession
         void HandleCharDeleteOpcode(WorldPacket& recvPacket);
         void HandleCharCreateOpcode(WorldPacket& recvPacket);
         void HandlePlayerLoginOpcode(WorldPacket& recvPacket);
-        void HandleCharEnum(QueryResult* result);
+        void HandleCharEnum(QueryResult* result, uint32 cacheTicket);
         void HandlePlayerLogin(LoginQueryHolder* holder);
         void HandlePlayerReconnect();
 
@@ -752,7 +758,10 @@ class WorldSession
         void HandlePushQuestToParty(WorldPacket& recvPacket);
         void HandleQuestPushResult(WorldPacket& recvPacket);
 
-        bool CheckChatMessage(std::string&, bool addon = false);
+        bool CheckChatMessage(std::string&, bool addon = false, bool prepared = false);
+        // network thread, before the message is queued: limits, strips and checks the message of a CMSG_MESSAGECHAT
+        // as CheckChatMessage does, writes it back and marks the packet prepared. false if the packet is to drop
+        bool PrepareChatMessage(WorldPacket& packet) const;
         void SendPlayerNotFoundNotice(const std::string& name) const;
         void SendPlayerAmbiguousNotice(const std::string& name) const;
         void SendWrongFactionNotice() const;
@@ -994,7 +1003,12 @@ class WorldSession
         bool VerifyMovementInfo(MovementInfo const& movementInfo, ObjectGuid const& guid) const;
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
+        void ProcessPacket(WorldPacket& packet);
+        // bot hooks and send statistics, false when there is no socket to send to
+        bool PrepareSendPacket(WorldPacket const& packet) const;
+        void RecyclePackets(std::deque<std::unique_ptr<WorldPacket>>& packets);
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        void CallHandler(OpcodeHandler const& opHandle, WorldPacket& packet); // times the sampled packets for the opcode stats
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -1032,7 +1046,7 @@ class WorldSession
         AddonsList m_addonsList;
 
         std::set<ObjectGuid> m_offlineNameQueries; // for name queires made when not logged in (character selection screen)
-        std::deque<CharacterNameQueryResponse> m_offlineNameResponses; // for responses to name queries made when not logged in
+        std::deque<WorldPacket> m_offlineNameResponses; // for responses to name queries made when not logged in
 
         bool m_initialZoneUpdated = false;
 
@@ -1049,6 +1063,8 @@ class WorldSession
         std::mutex m_recvQueueMapLock;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        std::deque<std::unique_ptr<WorldPacket>> m_recvQueueParallel; // guarded by m_recvQueueLock
+        std::vector<std::unique_ptr<WorldPacket>> m_sparePackets; // guarded by m_recvQueueLock, processed packets kept for reuse by the socket
 
         Messager<WorldSession> m_messager;
 
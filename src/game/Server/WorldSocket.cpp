@@ -86,26 +86,44 @@ struct ServerPktHeader
 #pragma pack(pop)
 #endif
 
-std::vector<uint32> InitOpcodeCooldowns()
+struct OpcodeThrottle
 {
-    std::vector<uint32> data(NUM_MSG_TYPES, 0);
+    Opcodes opcode;
+    uint32 cooldown;                                        // in ms
+};
 
-    data[CMSG_WHO] = 5000;
-    data[CMSG_WHOIS] = 5000;
-    data[CMSG_INSPECT] = 5000;
+static OpcodeThrottle const throttledOpcodes[MAX_THROTTLED_OPCODES] =
+{
+    { CMSG_WHO,     5000 },
+    { CMSG_WHOIS,   5000 },
+    { CMSG_INSPECT, 5000 },
+};
 
-    return data;
+// slot + 1 of each throttled opcode, 0 for all others
+static std::vector<uint8> InitOpcodeThrottleSlots()
+{
+    std::vector<uint8> slots(NUM_MSG_TYPES, 0);
+    for (uint32 i = 0; i < MAX_THROTTLED_OPCODES; ++i)
+        slots[throttledOpcodes[i].opcode] = uint8(i + 1);
+    return slots;
 }
 
-std::vector<uint32> WorldSocket::m_packetCooldowns = InitOpcodeCooldowns();
+static std::vector<uint8> const opcodeThrottleSlots = InitOpcodeThrottleSlots();
 
 std::deque<uint32> WorldSocket::GetOpcodeHistory()
 {
-    return m_opcodeHistory;
+    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+
+    std::deque<uint32> history;
+    uint32 count = std::min(m_opcodeHistoryCount, uint32(OPCODE_HISTORY_SIZE));
+    for (uint32 i = 1; i <= count; ++i)
+        history.push_back(m_opcodeHistory[(m_opcodeHistoryCount - i) % OPCODE_HISTORY_SIZE]);
+    return history;
 }
 
 WorldSocket::WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler) : Socket(service, std::move(closeHandler)), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0), m_existingHeader(),
-    m_useExistingHeader(false), m_session(nullptr), m_seed(urand())
+    m_useExistingHeader(false), m_session(nullptr), m_accountId(0), m_seed(urand()), m_opcodeHistoryCount(0), m_throttledUntil(),
+    m_floodTokens(sWorld.getConfig(CONFIG_UINT32_PACKET_FLOOD_BURST) * 1000), m_floodRefillTime(std::chrono::steady_clock::now()), m_floodDropped(0)
 {
 }
 
@@ -114,8 +132,22 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     if (IsClosed())
         return;
 
+    // the socket keeps its own reference to the payload until it is sent, no further copies are made
+    WritePacket(pct, pct.empty() ? nullptr : std::make_shared<const WorldPacket>(pct), immediate);
+}
+
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
+    WritePacket(*pct, pct, immediate);
+}
+
+void WorldSocket::WritePacket(WorldPacket const& pct, std::shared_ptr<WorldPacket const> const& payload, bool immediate)
+{
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(pct, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), m_accountId);
 
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
@@ -127,16 +159,62 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
     if (!pct.empty())
-        Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), reinterpret_cast<const char*>(pct.contents()), pct.size());
+        Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), payload);
     else
         Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength());
 
     if (immediate)
         ForceFlushOut();
 
-    m_opcodeHistory.push_front(uint32(pct.GetOpcode()));
-    if (m_opcodeHistory.size() > 50)
-        m_opcodeHistory.resize(20);
+    m_opcodeHistory[m_opcodeHistoryCount++ % OPCODE_HISTORY_SIZE] = uint32(pct.GetOpcode());
+}
+
+bool WorldSocket::IsThrottled(uint32 opcode)
+{
+    uint8 slot = opcodeThrottleSlots[opcode];
+    if (!slot)
+        return false;
+
+    auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+    TimePoint& throttledUntil = m_throttledUntil[slot - 1];
+    if (now < throttledUntil)                               // packet on cooldown
+        return true;
+
+    // start cooldown and allow execution
+    throttledUntil = now + std::chrono::milliseconds(throttledOpcodes[slot - 1].cooldown);
+    return false;
+}
+
+bool WorldSocket::ConsumeFloodToken()
+{
+    uint32 const rate = sWorld.getConfig(CONFIG_UINT32_PACKET_FLOOD_RATE);
+    if (!rate)
+        return true;
+
+    uint32 const maxTokens = sWorld.getConfig(CONFIG_UINT32_PACKET_FLOOD_BURST) * 1000;
+
+    // a token per packet, rate tokens per second are thousandths per ms
+    auto now = std::chrono::steady_clock::now();
+    uint64 elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_floodRefillTime).count();
+    if (elapsed)
+    {
+        m_floodTokens = uint32(std::min(uint64(maxTokens), m_floodTokens + elapsed * rate));
+        m_floodRefillTime = now;
+    }
+
+    if (m_floodTokens >= 1000)
+    {
+        m_floodTokens -= 1000;
+        if (m_floodDropped)
+        {
+            sLog.outError("WorldSocket: account %u at %s dropped %u packets of a flood", uint32(m_accountId), GetRemoteAddress().c_str(), m_floodDropped);
+            m_floodDropped = 0;
+        }
+        return true;
+    }
+
+    ++m_floodDropped;
+    return false;
 }
 
 bool WorldSocket::Open()
@@ -221,7 +299,14 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    std::unique_ptr<WorldPacket> pct;
+    if (m_sparePacket)
+    {
+        pct = std::move(m_sparePacket);
+        pct->Initialize(opcode, validBytesRemaining);
+    }
+    else
+        pct.reset(new WorldPacket(opcode, validBytesRemaining));
 
     if (validBytesRemaining)
     {
@@ -230,18 +315,12 @@ bool WorldSocket::ProcessIncomingData()
     }
 
     if (sPacketLog->CanLogPacket())
-        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
+        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort(), m_accountId);
 
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
 
-    if (WorldSocket::m_packetCooldowns[opcode])
-    {
-        auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
-        if (now < m_lastPacket[opcode]) // packet on cooldown
-            return true;
-        else // start cooldown and allow execution
-            m_lastPacket[opcode] = now + std::chrono::milliseconds(WorldSocket::m_packetCooldowns[opcode]);
-    }
+    if (IsThrottled(opcode))
+        return true;
 
     try
     {
@@ -274,9 +353,11 @@ bool WorldSocket::ProcessIncomingData()
                     return false;
                 }
 
-                m_session->QueuePacket(std::move(pct));
+                // flooded packets never reach the session queue
+                if (!ConsumeFloodToken())
+                    return true;
 
-                return true;
+                return m_session->QueuePacket(std::move(pct), &m_sparePacket);
             }
         }
     }
@@ -503,6 +584,7 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     stmt.PExecute(id, address.c_str(), std::to_string(LOGIN_TYPE_MANGOSD).c_str());
 
     m_crypt.Init(&K);
+    m_accountId = id;
 
     m_session = sWorld.FindSession(id);
     if (m_session)
@@ -30,10 +30,15 @@
 #include "Auth/BigNumber.h"
 #include "Network/Socket.hpp"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <deque>
 
+#define MAX_THROTTLED_OPCODES   3                           // client opcodes with a per socket cooldown
+#define OPCODE_HISTORY_SIZE     50                          // last sent opcodes kept for .debug packethistory
+
 class WorldPacket;
 class WorldSession;
 
@@ -108,6 +113,12 @@ class WorldSocket : public MaNGOS::Socket
         /// Session to which received packets are routed
         WorldSession* m_session;
 
+        /// Account of the socket once authenticated, read by the threads sending packets
+        std::atomic<uint32> m_accountId;
+
+        /// Processed packet handed back by the session, the next one is read into it
+        std::unique_ptr<WorldPacket> m_sparePacket;
+
         const uint32 m_seed;
 
         BigNumber m_s;
@@ -121,14 +132,35 @@ class WorldSocket : public MaNGOS::Socket
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket& recvPacket);
 
-        std::deque<uint32> m_opcodeHistory;
+        /// Encrypts the header and queues it with the payload, which is null for empty packets.
+        void WritePacket(WorldPacket const& pct, std::shared_ptr<WorldPacket const> const& payload, bool immediate);
+
+        /// Drops the packet of a throttled opcode sent again within its cooldown.
+        bool IsThrottled(uint32 opcode);
+
+        /// Token bucket over the packets queued to the session, false once a flood used it up.
+        bool ConsumeFloodToken();
+
+        /// Ring of the last sent opcodes, written under m_worldSocketMutex
+        std::array<uint32, OPCODE_HISTORY_SIZE> m_opcodeHistory;
+        uint32 m_opcodeHistoryCount;
         std::mutex m_worldSocketMutex;
 
+        /// End of the cooldown of each throttled opcode slot
+        std::array<TimePoint, MAX_THROTTLED_OPCODES> m_throttledUntil;
+
+        /// Flood control tokens in thousandths of a packet, refilled by Network.PacketFloodRate per second
+        uint32 m_floodTokens;
+        std::chrono::steady_clock::time_point m_floodRefillTime;
+        uint32 m_floodDropped;
+
     public:
         WorldSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // the payload is queued as is, it must not change anymore
+        void SendPacket(std::shared_ptr<WorldPacket const> const& pct, bool immediate = false);
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -137,10 +169,8 @@ class WorldSocket : public MaNGOS::Socket
         /// Return the session key
         BigNumber& GetSessionKey() { return m_s; }
 
+        /// Last sent opcodes, newest first
         std::deque<uint32> GetOpcodeHistory();
-
-        static std::vector<uint32> m_packetCooldowns;
-        std::map<uint32, TimePoint> m_lastPacket;
 };
 
 #endif  /* _WORLDSOCKET_H */
@@ -23,6 +23,7 @@
 #include "WorldPacket.h"
 #include "Entities/Player.h"
 #include "Globals/ObjectMgr.h"
+#include "Maps/PlayerSnapshot.h"
 #include "World/World.h"
 #include "Util.h"
 
@@ -66,6 +67,9 @@ bool PlayerSocial::AddToSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
+    if (!ignore)
+        sSocialMgr.AddFriendOf(friend_guid.GetCounter(), m_playerLowGuid);
+
     PlayerSocialMap::const_iterator itr = m_playerSocialMap.find(friend_guid.GetCounter());
     if (itr != m_playerSocialMap.end())
     {
@@ -92,6 +96,9 @@ void PlayerSocial::RemoveFromSocialList(ObjectGuid friend_guid, bool ignore)
     if (ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
+    if (!ignore && (itr->second.Flags & SOCIAL_FLAG_FRIEND))
+        sSocialMgr.RemoveFriendOf(friend_guid.GetCounter(), m_playerLowGuid);
+
     itr->second.Flags &= ~flag;
     if (itr->second.Flags == 0)
     {
@@ -176,6 +183,30 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+        return;
+
+    for (PlayerSocialMap::const_iterator itr2 = itr->second.m_playerSocialMap.begin(); itr2 != itr->second.m_playerSocialMap.end(); ++itr2)
+        if (itr2->second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendOf(itr2->first, guid);
+
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::RemoveFriendOf(uint32 friendLowGuid, uint32 listerLowGuid)
+{
+    FriendOfMap::iterator itr = m_friendOfMap.find(friendLowGuid);
+    if (itr == m_friendOfMap.end())
+        return;
+
+    itr->second.erase(listerLowGuid);
+    if (itr->second.empty())
+        m_friendOfMap.erase(itr);
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const
 {
     if (!player)
@@ -199,14 +230,15 @@ void SocialMgr::GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo&
              ((pFriend->GetTeam() == team || allowTwoSideWhoList) && (pFriend->GetSession()->GetSecurity() <= gmLevelInWhoList))) &&
             pFriend->IsVisibleGloballyFor(player))
     {
+        PlayerSnapshot const snapshot = PlayerSnapshot::Get(pFriend);
         friendInfo.Status = FRIEND_STATUS_ONLINE;
-        if (pFriend->isAFK())
+        if (snapshot.HasFlag(PLAYER_SNAPSHOT_AFK))
             friendInfo.Status = FRIEND_STATUS_AFK;
-        if (pFriend->isDND())
+        if (snapshot.HasFlag(PLAYER_SNAPSHOT_DND))
             friendInfo.Status = FRIEND_STATUS_DND;
-        friendInfo.Area = pFriend->GetZoneId();
-        friendInfo.Level = pFriend->getLevel();
-        friendInfo.Class = pFriend->getClass();
+        friendInfo.Area = snapshot.zoneId;
+        friendInfo.Level = snapshot.level;
+        friendInfo.Class = snapshot.playerClass;
     }
     else
     {
@@ -273,22 +305,23 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket const& pack
     AccountTypes gmLevelInWhoList = AccountTypes(sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST));
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (const auto& itr : m_socialMap)
+    // only the loaded lists of the players online can have the player as friend
+    FriendOfMap::const_iterator listers = m_friendOfMap.find(guid);
+    if (listers == m_friendOfMap.end())
+        return;
+
+    for (uint32 listerGuid : listers->second)
     {
-        PlayerSocialMap::const_iterator itr2 = itr.second.m_playerSocialMap.find(guid);
-        if (itr2 != itr.second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
+        Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, listerGuid));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
+                player->IsVisibleGloballyFor(pFriend))
         {
-            Player* pFriend = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr.first));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                    (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                     ((pFriend->GetTeam() == team || allowTwoSideWhoList) && security <= gmLevelInWhoList)) &&
-                    player->IsVisibleGloballyFor(pFriend))
-            {
-                pFriend->GetSession()->SendPacket(packet);
-            }
+            pFriend->GetSession()->SendPacket(packet);
         }
     }
 }
@@ -318,6 +351,8 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult* result, ObjectGuid guid)
             continue;
 
         social->m_playerSocialMap[friend_guid] = FriendInfo(flags, note);
+        if (flags & SOCIAL_FLAG_FRIEND)
+            AddFriendOf(friend_guid, guid.GetCounter());
 
         if (flags & SOCIAL_FLAG_IGNORED)
             ++ignoreCounter;
@@ -73,6 +73,7 @@ struct FriendInfo
 
 typedef std::map<uint32, FriendInfo> PlayerSocialMap;
 typedef std::map<uint32, PlayerSocial> SocialMap;
+typedef std::unordered_map<uint32, std::unordered_set<uint32>> FriendOfMap;
 
 /// Results of friend related commands
 enum FriendsResult
@@ -137,7 +138,10 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid) { m_socialMap.erase(guid); }
+        void RemovePlayerSocial(uint32 guid);
+        // reverse index of the loaded friend lists, the players that have a player as friend
+        void AddFriendOf(uint32 friendLowGuid, uint32 listerLowGuid) { m_friendOfMap[friendLowGuid].insert(listerLowGuid); }
+        void RemoveFriendOf(uint32 friendLowGuid, uint32 listerLowGuid);
 
         void GetFriendInfo(Player* player, uint32 friend_lowguid, FriendInfo& friendInfo) const;
         // Packet management
@@ -148,6 +152,7 @@ class SocialMgr
         PlayerSocial* LoadFromDB(QueryResult* result, ObjectGuid guid);
     private:
         SocialMap m_socialMap;
+        FriendOfMap m_friendOfMap;
 };
 
 #define sSocialMgr MaNGOS::Singleton<SocialMgr>::Instance()
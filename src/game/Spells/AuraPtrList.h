@@ -0,0 +1,144 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_AURAPTRLIST_H
+#define MANGOS_AURAPTRLIST_H
+
+#include "Common.h"
+
+#include <iterator>
+#include <vector>
+
+class Aura;
+
+// contiguous replacement of the std::list<Aura*> kept per aura type, keeping its iteration rules:
+// auras may be added or removed while the list is walked, removed ones are skipped and added ones
+// are still visited. removal only leaves a hole, holes are squeezed out by Compact() which must be
+// called where no walk of the list can be in progress
+class AuraPtrList
+{
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_auras(nullptr), m_index(END) {}
+                const_iterator(std::vector<Aura*> const* auras, size_t index) : m_auras(auras), m_index(index) { SkipForward(); }
+
+                reference operator*() const { return (*m_auras)[m_index]; }
+                pointer operator->() const { return &(*m_auras)[m_index]; }
+
+                const_iterator& operator++() { ++m_index; SkipForward(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+                const_iterator& operator--()
+                {
+                    if (m_index == END || m_index > m_auras->size())
+                        m_index = m_auras->size();
+                    do
+                        --m_index;
+                    while (!(*m_auras)[m_index]);
+                    return *this;
+                }
+                const_iterator operator--(int) { const_iterator tmp = *this; --*this; return tmp; }
+
+                // end() stays the end while the list grows, like std::list::end()
+                bool operator==(const_iterator const& other) const { return AtEnd() ? other.AtEnd() : m_index == other.m_index; }
+                bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+            private:
+                friend class AuraPtrList;
+                static size_t const END = size_t(-1);
+
+                bool AtEnd() const { return m_index == END || m_index >= m_auras->size(); }
+                void SkipForward()
+                {
+                    if (m_index == END)
+                        return;
+                    while (m_index < m_auras->size() && !(*m_auras)[m_index])
+                        ++m_index;
+                }
+
+                std::vector<Aura*> const* m_auras;
+                size_t m_index;
+        };
+
+        typedef const_iterator iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef const_reverse_iterator reverse_iterator;
+        typedef Aura* value_type;
+
+        AuraPtrList() : m_count(0) {}
+
+        const_iterator begin() const { return const_iterator(&m_auras, 0); }
+        const_iterator end() const { return const_iterator(&m_auras, const_iterator::END); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return m_count == 0; }
+        size_t size() const { return m_count; }
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *rbegin(); }
+        bool HasHoles() const { return m_count != m_auras.size(); }
+
+        void push_back(Aura* aura) { m_auras.push_back(aura); ++m_count; }
+
+        void remove(Aura* aura)
+        {
+            for (Aura*& slot : m_auras)
+            {
+                if (slot == aura)
+                {
+                    slot = nullptr;
+                    --m_count;
+                }
+            }
+        }
+
+        const_iterator erase(const_iterator itr)
+        {
+            m_auras[itr.m_index] = nullptr;
+            --m_count;
+            return ++itr;
+        }
+
+        void clear() { m_auras.clear(); m_count = 0; }
+
+        // drops the holes left by removals, invalidates every iterator
+        void Compact()
+        {
+            if (!HasHoles())
+                return;
+
+            size_t last = 0;
+            for (Aura* aura : m_auras)
+                if (aura)
+                    m_auras[last++] = aura;
+            m_auras.resize(last);
+        }
+
+    private:
+        std::vector<Aura*> m_auras;
+        size_t m_count;                                     // auras in the list, holes excluded
+};
+
+#endif
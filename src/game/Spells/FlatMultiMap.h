@@ -0,0 +1,96 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FLATMULTIMAP_H
+#define MANGOS_FLATMULTIMAP_H
+
+#include "Common.h"
+
+#include <utility>
+#include <vector>
+
+/**
+ * A multimap with small integer keys like spell or skill ids, flattened once after loading: the pairs of all
+ * keys in one array ordered by key, found through the offset of their key (compressed sparse rows). A lookup
+ * is an index instead of a tree walk and the values of a key are adjacent in memory.
+ *
+ * Built from a std::multimap, which keeps the order of equal keys, and not changed afterwards. Has the part of
+ * the std::multimap interface the lookups use, its iterators are pointers to the pairs.
+ */
+template<typename T>
+class FlatMultiMap
+{
+    public:
+        typedef std::pair<uint32, T> value_type;
+        typedef value_type const* const_iterator;
+        typedef std::pair<const_iterator, const_iterator> Bounds;
+
+        template<typename Map>
+        void Build(Map const& map)
+        {
+            m_values.assign(map.begin(), map.end());
+
+            m_offsets.assign(m_values.empty() ? 1 : m_values.back().first + 2, 0);
+            for (value_type const& value : m_values)
+                ++m_offsets[value.first + 1];
+            for (size_t i = 1; i < m_offsets.size(); ++i)
+                m_offsets[i] += m_offsets[i - 1];
+        }
+
+        void clear()
+        {
+            m_values.clear();
+            m_offsets.assign(1, 0);
+        }
+
+        const_iterator begin() const { return m_values.data(); }
+        const_iterator end() const { return m_values.data() + m_values.size(); }
+
+        bool empty() const { return m_values.empty(); }
+        size_t size() const { return m_values.size(); }
+
+        Bounds equal_range(uint32 key) const { return Bounds(lower_bound(key), upper_bound(key)); }
+
+        const_iterator lower_bound(uint32 key) const
+        {
+            return size_t(key) + 1 < m_offsets.size() ? begin() + m_offsets[key] : end();
+        }
+
+        const_iterator upper_bound(uint32 key) const
+        {
+            return size_t(key) + 1 < m_offsets.size() ? begin() + m_offsets[key + 1] : end();
+        }
+
+        const_iterator find(uint32 key) const
+        {
+            Bounds bounds = equal_range(key);
+            return bounds.first != bounds.second ? bounds.first : end();
+        }
+
+        size_t count(uint32 key) const
+        {
+            Bounds bounds = equal_range(key);
+            return bounds.second - bounds.first;
+        }
+
+    private:
+        std::vector<value_type> m_values;
+        std::vector<uint32> m_offsets;                      // of the first pair of each key, one more than keys
+};
+
+#endif
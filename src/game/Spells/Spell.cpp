@@ -418,6 +418,10 @@ Spell::Spell(Unit* caster, SpellEntry const* info, uint32 triggeredFlags, Object
     MANGOS_ASSERT(caster != nullptr && info != nullptr);
     MANGOS_ASSERT(info == sSpellTemplate.LookupEntry<SpellEntry>(info->Id) && "`info` must be pointer to sSpellTemplate element");
 
+#ifdef BUILD_METRICS
+    m_spellsCreated.fetch_add(1, std::memory_order_relaxed);
+#endif
+
     if (info->SpellDifficultyId && caster->IsInWorld() && caster->GetMap()->IsDungeon())
     {
         if (SpellEntry const* spellEntry = GetSpellEntryByDifficulty(info->SpellDifficultyId, caster->GetMap()->GetDifficulty(), caster->GetMap()->IsRaid()))
@@ -525,7 +529,23 @@ Spell::~Spell()
 {
     if (m_CastItem)
         m_CastItem->SetUsedInSpell(false);
+
+#ifdef BUILD_METRICS
+    if (m_UniqueTargetInfo.capacity() > INLINE_UNIT_TARGETS)
+        m_spilledTargetLists.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
+
+#ifdef BUILD_METRICS
+std::atomic<uint64> Spell::m_spellsCreated(0);
+std::atomic<uint64> Spell::m_spilledTargetLists(0);
+
+void Spell::GetAllocationStats(uint64& spells, uint64& spilledTargetLists)
+{
+    spells = m_spellsCreated.exchange(0);
+    spilledTargetLists = m_spilledTargetLists.exchange(0);
 }
+#endif
 
 template<typename T>
 WorldObject* Spell::FindCorpseUsing()
@@ -648,14 +668,24 @@ void Spell::FillTargetMap()
                     SpellTargetFilterScheme scheme = filterScheme[rightTarget];
                     if (!unitTargetList.empty()) // Unit case
                     {
+                        // line of sight of area targets is checked for all of them at once
+                        std::vector<Unit*> losTargets;
                         for (auto itr = unitTargetList.begin(); itr != unitTargetList.end();)
                         {
-                            if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet)))
+                            bool losDeferred = false;
+                            if (!CheckTarget(*itr, SpellEffectIndex(i), bool(rightTarget), CheckException(targetingData.magnet), &losDeferred))
                                 itr = unitTargetList.erase(itr);
                             else
+                            {
+                                if (losDeferred)
+                                    losTargets.push_back(*itr);
                                 ++itr;
+                            }
                         }
 
+                        if (!losTargets.empty())
+                            FilterTargetsInLos(unitTargetList, losTargets);
+
                         // Special target filter before adding targets to list
                         FilterTargetMap(unitTargetList, scheme, targetingData.chainTargetCount[i]);
 
@@ -6803,6 +6833,62 @@ SpellCastResult Spell::CheckCasterAuras() const
     return SPELL_CAST_OK;
 }
 
+void Spell::FilterTargetsInLos(UnitList& targetList, std::vector<Unit*> const& losTargets) const
+{
+    WorldObject* caster = GetCastingObject();
+    if (!caster)
+        return;
+
+    // same segments as target->IsWithinLOSInMap(caster, true), queried in one batch for the targets sharing a phase mask
+    uint32 const phaseMask = losTargets.front()->GetPhaseMask();
+    float casterX, casterY, casterZ;
+    caster->GetPosition(casterX, casterY, casterZ);
+    casterZ += caster->GetCollisionHeight();
+
+    std::vector<VMAP::LineOfSightQuery> queries;
+    queries.reserve(losTargets.size());
+    for (Unit* target : losTargets)
+    {
+        if (!target->IsInMap(caster) || target->GetPhaseMask() != phaseMask)
+            continue;
+
+        VMAP::LineOfSightQuery query;
+        target->GetPosition(query.x1, query.y1, query.z1);
+        query.z1 += target->GetCollisionHeight();
+        query.x2 = casterX;
+        query.y2 = casterY;
+        query.z2 = casterZ;
+        queries.push_back(query);
+    }
+
+    caster->GetMap()->IsInLineOfSightBatch(queries.data(), queries.size(), phaseMask, true);
+
+    auto query = queries.begin();
+    auto losTarget = losTargets.begin();
+    for (auto itr = targetList.begin(); itr != targetList.end() && losTarget != losTargets.end();)
+    {
+        if (*itr != *losTarget)
+        {
+            ++itr;
+            continue;
+        }
+
+        bool inLos;
+        if (!(*itr)->IsInMap(caster))
+            inLos = false;
+        else if ((*itr)->GetPhaseMask() != phaseMask)
+            inLos = (*itr)->IsWithinLOSInMap(caster, true);
+        else
+            inLos = (query++)->result;
+
+        ++losTarget;
+        if (inLos)
+            ++itr;
+        else
+            itr = targetList.erase(itr);
+    }
+}
+
 bool Spell::CanAutoCast(Unit* target)
 {
     ObjectGuid targetguid = target->GetObjectGuid();
@@ -7728,7 +7814,7 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return (CURRENT_GENERIC_SPELL);
 }
 
-bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception) const
+bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception, bool* losDeferred) const
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
     if (exception != EXCEPTION_MAGNET && m_spellInfo->EffectImplicitTargetA[eff] != TARGET_UNIT_CASTER)
@@ -7823,8 +7909,12 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckE
                                     return false;
                         }
                         else if (WorldObject* caster = GetCastingObject())
-                            if (!target->IsWithinLOSInMap(caster, true))
+                        {
+                            if (losDeferred)
+                                *losDeferred = true;
+                            else if (!target->IsWithinLOSInMap(caster, true))
                                 return false;
+                        }
                     }
                 }
                 break;
@@ -28,6 +28,9 @@
 #include "Entities/Player.h"
 #include "Server/SQLStorages.h"
 #include "Spells/SpellEffectDefines.h"
+#include "Utilities/SlabAllocator.h"
+
+#include <boost/container/small_vector.hpp>
 
 class WorldSession;
 class WorldPacket;
@@ -461,6 +464,14 @@ class Spell
         Spell(Unit* caster, SpellEntry const* info, uint32 triggeredFlags, ObjectGuid originalCasterGUID = ObjectGuid(), SpellEntry const* triggeredBy = nullptr);
         ~Spell();
 
+        // a spell lives for one cast, keep the churn of casts out of the general heap
+        static void* operator new(size_t size) { return SlabAllocator::Allocate(size, MEMORY_TAG_SPELLS); }
+        static void operator delete(void* ptr, size_t size) { SlabAllocator::Deallocate(ptr, size, MEMORY_TAG_SPELLS); }
+#ifdef BUILD_METRICS
+        // spells created and unit target lists that outgrew their inline storage, since the last call
+        static void GetAllocationStats(uint64& spells, uint64& spilledTargetLists);
+#endif
+
         SpellCastResult SpellStart(SpellCastTargets const* targets, Aura* triggeredByAura = nullptr);
 
         void cancel();
@@ -531,7 +542,10 @@ class Spell
 
         template<typename T> WorldObject* FindCorpseUsing();
 
-        bool CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception = EXCEPTION_NONE) const;
+        // with losDeferred, the line of sight to the casting object is not checked and losDeferred is set when it should be
+        bool CheckTarget(Unit* target, SpellEffectIndex eff, bool targetB, CheckException exception = EXCEPTION_NONE, bool* losDeferred = nullptr) const;
+        // removes from targetList the losTargets (in list order) out of line of sight of the casting object
+        void FilterTargetsInLos(UnitList& targetList, std::vector<Unit*> const& losTargets) const;
         bool CanAutoCast(Unit* target);
 
         static void SendCastResult(Player const* caster, SpellEntry const* spellInfo, uint8 cast_count, SpellCastResult result, bool isPetCastResult = false);
@@ -707,10 +721,12 @@ class Spell
             DestTargetInfo() : effectMask(0), timeDelay(0), processed(false) {}
         };
 
-        typedef std::list<TargetInfo>     TargetList;
-        typedef std::list<GOTargetInfo>   GOTargetList;
-        typedef std::list<ItemTargetInfo> ItemTargetList;
-        typedef std::list<CorpseTargetInfo> CorpseTargetList;
+        // most casts hit a handful of targets, those are stored inside the spell
+        static size_t const INLINE_UNIT_TARGETS = 5;
+        typedef boost::container::small_vector<TargetInfo, INLINE_UNIT_TARGETS> TargetList;
+        typedef boost::container::small_vector<GOTargetInfo, 1> GOTargetList;
+        typedef boost::container::small_vector<ItemTargetInfo, 1> ItemTargetList;
+        typedef boost::container::small_vector<CorpseTargetInfo, 1> CorpseTargetList;
 
         struct TempTargetData
         {
@@ -946,6 +962,11 @@ class Spell
 
         // GO casting preparations
         WorldObject* m_trueCaster;
+
+#ifdef BUILD_METRICS
+        static std::atomic<uint64> m_spellsCreated;
+        static std::atomic<uint64> m_spilledTargetLists;
+#endif
 };
 
 enum ReplenishType
@@ -1065,6 +1086,37 @@ namespace MaNGOS
                 if (!itr->getSource()->IsInMap(i_originalCaster) || itr->getSource()->IsTaxiFlying())
                     continue;
 
+                // area check first, the visited cells hold many units outside the radius
+                // and the attack/assist checks below are far more costly than a distance
+                // we don't need to check InMap here, it's already done some lines above
+                switch (i_push_type)
+                {
+                    case PUSH_CONE:
+                        if (i_cone >= 0.f)
+                        {
+                            if (!i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, i_cone))
+                                continue;
+                        }
+                        else
+                        {
+                            if (!i_castingObject->isInBack((Unit*)(itr->getSource()), i_radius, -i_cone))
+                                continue;
+                        }
+                        break;
+                    case PUSH_SELF_CENTER:
+                        if (itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) > i_radius)
+                            continue;
+                        break;
+                    case PUSH_SRC_CENTER:
+                    case PUSH_DEST_CENTER:
+                    case PUSH_TARGET_CENTER:
+                        if (itr->getSource()->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_COMBAT_REACH) > i_radius)
+                            continue;
+                        break;
+                    default:
+                        continue;
+                }
+
                 switch (i_TargetType)
                 {
                     case SPELL_TARGETS_ASSISTABLE:
@@ -1088,32 +1140,7 @@ namespace MaNGOS
                     default: continue;
                 }
 
-                // we don't need to check InMap here, it's already done some lines above
-                switch (i_push_type)
-                {
-                    case PUSH_CONE:
-                        if (i_cone >= 0.f)
-                        {
-                            if (i_castingObject->isInFront((Unit*)(itr->getSource()), i_radius, i_cone))
-                                i_data.push_back(itr->getSource());
-                        }
-                        else
-                        {
-                            if (i_castingObject->isInBack((Unit*)(itr->getSource()), i_radius, -i_cone))
-                                i_data.push_back(itr->getSource());
-                        }
-                        break;
-                    case PUSH_SELF_CENTER:
-                        if (itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) <= i_radius)
-                            i_data.push_back(itr->getSource());
-                        break;
-                    case PUSH_SRC_CENTER:
-                    case PUSH_DEST_CENTER:
-                    case PUSH_TARGET_CENTER:
-                        if (itr->getSource()->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_COMBAT_REACH) <= i_radius)
-                            i_data.push_back(itr->getSource());
-                        break;
-                }
+                i_data.push_back(itr->getSource());
             }
         }
 
@@ -586,296 +586,348 @@ void Aura::Update(uint32 diff)
 
 void AreaAura::Update(uint32 diff)
 {
+    // the caster searches and applies to its targets, the targets check whether they still are in range,
+    // both only at an interval, positions barely change in between
+    bool checkTargets = m_targetUpdateTimer <= diff;
+    if (checkTargets)
+        m_targetUpdateTimer = AREA_AURA_UPDATE_INTERVAL;
+    else
+        m_targetUpdateTimer -= diff;
+
     // update for the caster of the aura
     if (GetCasterGuid() == GetTarget()->GetObjectGuid())
     {
-        Unit* caster = GetTarget();
-
-        if (!caster->hasUnitState(UNIT_STAT_ISOLATED))
-        {
-            Unit* owner = caster->GetMaster();
-            if (!owner)
-                owner = caster;
-            UnitList targets;
+        if (checkTargets)
+            UpdateTargets(GetTarget());
+        Aura::Update(diff);
+    }
+    else                                                    // aura at non-caster
+    {
+        Unit* caster = GetCaster();
+        Unit* target = GetTarget();
 
-            switch (m_areaAuraType)
-            {
-                case AREA_AURA_PARTY:
-                {
-                    Group* pGroup = nullptr;
+        Aura::Update(diff);
 
-                    // Handle aura party for players
-                    if (owner->GetTypeId() == TYPEID_PLAYER)
-                    {
-                        pGroup = ((Player*)owner)->GetGroup();
+        if (checkTargets)
+            CheckTarget(caster, target);
+    }
+}
 
-                        if (pGroup)
-                        {
-                            uint8 subgroup = ((Player*)owner)->GetSubGroup();
-                            for (GroupReference* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
-                            {
-                                Player* Target = itr->getSource();
-                                if (Target && Target->IsAlive() && Target->GetSubGroup() == subgroup && caster->CanAssistSpell(Target, GetSpellProto()))
-                                {
-                                    if (caster->IsWithinDistInMap(Target, m_radius))
-                                        targets.push_back(Target);
-                                    Pet* pet = Target->GetPet();
-                                    if (pet && pet->IsAlive() && caster->IsWithinDistInMap(pet, m_radius))
-                                        targets.push_back(pet);
-                                }
-                            }
-                            break;
-                        }
-                    }
-                    else    // handle aura party for creatures
-                    {
-                        // Get all creatures in spell radius
-                        std::list<Creature*> nearbyTargets;
-                        MaNGOS::AnyUnitInObjectRangeCheck u_check(owner, m_radius);
-                        MaNGOS::CreatureListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(nearbyTargets, u_check);
-                        Cell::VisitGridObjects(owner, searcher, m_radius);
+bool AreaAura::HasAppliedAura(Unit* target, uint32 spellId) const
+{
+    SpellAuraHolder* holder = target->GetSpellAuraHolder(spellId, GetCasterGuid());
+    return holder && !holder->IsDeleted() && holder->GetAuraByEffectIndex(m_effIndex);
+}
 
-                        for (auto target : nearbyTargets)
-                        {
-                            // Due to the lack of support for NPC groups or formations, are considered of the same party NPCs with same faction than caster
-                            if (target != owner && target->IsAlive() && target->getFaction() == ((Creature*)owner)->getFaction())
-                                targets.push_back(target);
-                        }
-                    }
+void AreaAura::UpdateTargets(Unit* caster)
+{
+    if (caster->hasUnitState(UNIT_STAT_ISOLATED))
+    {
+        m_appliedTargets.clear();
+        return;
+    }
 
-                    // add owner
-                    if (owner != caster && caster->IsWithinDistInMap(owner, m_radius))
-                        targets.push_back(owner);
-                    // add caster's pet
-                    Unit* pet = caster->GetPet();
-                    if (pet && caster->IsWithinDistInMap(pet, m_radius))
-                        targets.push_back(pet);
+    Unit* owner = caster->GetMaster();
+    if (!owner)
+        owner = caster;
+    UnitList targets;
 
-                    break;
-                }
-                case AREA_AURA_RAID:
-                {
-                    Group* pGroup = nullptr;
+    // group members are taken from the group, only the auras of creatures and the friend and enemy auras search the grid
+    switch (m_areaAuraType)
+    {
+        case AREA_AURA_PARTY:
+        {
+            Group* pGroup = nullptr;
 
-                    if (owner->GetTypeId() == TYPEID_PLAYER)
-                        pGroup = ((Player*)owner)->GetGroup();
+            // Handle aura party for players
+            if (owner->GetTypeId() == TYPEID_PLAYER)
+            {
+                pGroup = ((Player*)owner)->GetGroup();
 
-                    if (pGroup)
+                if (pGroup)
+                {
+                    uint8 subgroup = ((Player*)owner)->GetSubGroup();
+                    for (GroupReference* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
                     {
-                        for (GroupReference* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
+                        Player* Target = itr->getSource();
+                        if (Target && Target->IsAlive() && Target->GetSubGroup() == subgroup && caster->CanAssistSpell(Target, GetSpellProto()))
                         {
-                            Player* Target = itr->getSource();
-                            if (Target && Target->IsAlive() && caster->CanAssistSpell(Target, GetSpellProto()))
-                            {
-                                if (caster->IsWithinDistInMap(Target, m_radius))
-                                    targets.push_back(Target);
-                                Pet* pet = Target->GetPet();
-                                if (pet && pet->IsAlive() && caster->IsWithinDistInMap(pet, m_radius))
-                                    targets.push_back(pet);
-                            }
+                            if (caster->IsWithinDistInMap(Target, m_radius))
+                                targets.push_back(Target);
+                            Pet* pet = Target->GetPet();
+                            if (pet && pet->IsAlive() && caster->IsWithinDistInMap(pet, m_radius))
+                                targets.push_back(pet);
                         }
                     }
-                    else
-                    {
-                        // add owner
-                        if (owner != caster && caster->IsWithinDistInMap(owner, m_radius))
-                            targets.push_back(owner);
-                        // add caster's pet
-                        Unit* pet = caster->GetPet();
-                        if (pet && caster->IsWithinDistInMap(pet, m_radius))
-                            targets.push_back(pet);
-                    }
-                    break;
-                }
-                case AREA_AURA_FRIEND:
-                {
-                    MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(caster, nullptr, m_radius);
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-                    Cell::VisitAllObjects(caster, searcher, m_radius);
                     break;
                 }
-                case AREA_AURA_ENEMY:
+            }
+            else    // handle aura party for creatures
+            {
+                // Get all creatures in spell radius
+                std::list<Creature*> nearbyTargets;
+                MaNGOS::AnyUnitInObjectRangeCheck u_check(owner, m_radius);
+                MaNGOS::CreatureListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(nearbyTargets, u_check);
+                Cell::VisitGridObjects(owner, searcher, m_radius);
+
+                for (auto target : nearbyTargets)
                 {
-                    MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(caster, nullptr, m_radius); // No GetCharmer in searcher
-                    MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(targets, u_check);
-                    Cell::VisitAllObjects(caster, searcher, m_radius);
-                    break;
+                    // Due to the lack of support for NPC groups or formations, are considered of the same party NPCs with same faction than caster
+                    if (target != owner && target->IsAlive() && target->getFaction() == ((Creature*)owner)->getFaction())
+                        targets.push_back(target);
                 }
-                case AREA_AURA_OWNER:
-                case AREA_AURA_PET:
+            }
+
+            // add owner
+            if (owner != caster && caster->IsWithinDistInMap(owner, m_radius))
+                targets.push_back(owner);
+            // add caster's pet
+            Unit* pet = caster->GetPet();
+            if (pet && caster->IsWithinDistInMap(pet, m_radius))
+                targets.push_back(pet);
+
+            break;
+        }
+        case AREA_AURA_RAID:
+        {
+            Group* pGroup = nullptr;
+
+            if (owner->GetTypeId() == TYPEID_PLAYER)
+                pGroup = ((Player*)owner)->GetGroup();
+
+            if (pGroup)
+            {
+                for (GroupReference* itr = pGroup->GetFirstMember(); itr != nullptr; itr = itr->next())
                 {
-                    if (owner != caster && caster->IsWithinDistInMap(owner, m_radius) && caster->CanAssistSpell(owner, GetSpellProto()))
-                        targets.push_back(owner);
-                    break;
+                    Player* Target = itr->getSource();
+                    if (Target && Target->IsAlive() && caster->CanAssistSpell(Target, GetSpellProto()))
+                    {
+                        if (caster->IsWithinDistInMap(Target, m_radius))
+                            targets.push_back(Target);
+                        Pet* pet = Target->GetPet();
+                        if (pet && pet->IsAlive() && caster->IsWithinDistInMap(pet, m_radius))
+                            targets.push_back(pet);
+                    }
                 }
             }
-
-            for (auto& target : targets)
+            else
             {
-                // flag for selection is need apply aura to current iteration target
-                bool apply = true;
+                // add owner
+                if (owner != caster && caster->IsWithinDistInMap(owner, m_radius))
+                    targets.push_back(owner);
+                // add caster's pet
+                Unit* pet = caster->GetPet();
+                if (pet && caster->IsWithinDistInMap(pet, m_radius))
+                    targets.push_back(pet);
+            }
+            break;
+        }
+        case AREA_AURA_FRIEND:
+        {
+            MaNGOS::AnyFriendlyUnitInObjectRangeCheck u_check(caster, nullptr, m_radius);
+            MaNGOS::UnitListSearcher<MaNGOS::AnyFriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
+            Cell::VisitAllObjects(caster, searcher, m_radius);
+            break;
+        }
+        case AREA_AURA_ENEMY:
+        {
+            MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(caster, nullptr, m_radius); // No GetCharmer in searcher
+            MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(targets, u_check);
+            Cell::VisitAllObjects(caster, searcher, m_radius);
+            break;
+        }
+        case AREA_AURA_OWNER:
+        case AREA_AURA_PET:
+        {
+            if (owner != caster && caster->IsWithinDistInMap(owner, m_radius) && caster->CanAssistSpell(owner, GetSpellProto()))
+                targets.push_back(owner);
+            break;
+        }
+    }
 
-                SpellEntry const* actualSpellInfo;
-                if (GetCasterGuid() == target->GetObjectGuid()) // if caster is same as target then no need to change rank of the spell
-                    actualSpellInfo = GetSpellProto();
-                else
-                    actualSpellInfo = sSpellMgr.SelectAuraRankForLevel(GetSpellProto(), target->getLevel()); // use spell id according level of the target
-                if (!actualSpellInfo)
-                    continue;
+    // targets which keep the aura skip the rank and stacking checks, those out of range drop out of the list
+    std::unordered_map<ObjectGuid, uint32> appliedTargets;
+    for (auto& target : targets)
+    {
+        auto applied = m_appliedTargets.find(target->GetObjectGuid());
+        if (applied != m_appliedTargets.end() && HasAppliedAura(target, applied->second))
+        {
+            appliedTargets.emplace(applied->first, applied->second);
+            continue;
+        }
 
-                Unit::SpellAuraHolderBounds spair = target->GetSpellAuraHolderBounds(actualSpellInfo->Id);
-                // we need ignore present caster self applied are auras sometime
-                // in cases if this only auras applied for spell effect
-                for (Unit::SpellAuraHolderMap::const_iterator i = spair.first; i != spair.second; ++i)
-                {
-                    if (i->second->IsDeleted())
-                        continue;
+        // flag for selection is need apply aura to current iteration target
+        bool apply = true;
+
+        SpellEntry const* actualSpellInfo;
+        if (GetCasterGuid() == target->GetObjectGuid()) // if caster is same as target then no need to change rank of the spell
+            actualSpellInfo = GetSpellProto();
+        else
+            actualSpellInfo = sSpellMgr.SelectAuraRankForLevel(GetSpellProto(), target->getLevel()); // use spell id according level of the target
+        if (!actualSpellInfo)
+            continue;
+
+        // already holds an aura of this caster, the stacking rules were checked when it was applied
+        if (HasAppliedAura(target, actualSpellInfo->Id))
+        {
+            appliedTargets.emplace(target->GetObjectGuid(), actualSpellInfo->Id);
+            continue;
+        }
 
-                    Aura* aur = i->second->GetAuraByEffectIndex(m_effIndex);
+        Unit::SpellAuraHolderBounds spair = target->GetSpellAuraHolderBounds(actualSpellInfo->Id);
+        // we need ignore present caster self applied are auras sometime
+        // in cases if this only auras applied for spell effect
+        for (Unit::SpellAuraHolderMap::const_iterator i = spair.first; i != spair.second; ++i)
+        {
+            if (i->second->IsDeleted())
+                continue;
+
+            Aura* aur = i->second->GetAuraByEffectIndex(m_effIndex);
 
-                    if (!aur)
-                        continue;
+            if (!aur)
+                continue;
 
-                    switch (m_areaAuraType)
+            switch (m_areaAuraType)
+            {
+                case AREA_AURA_ENEMY:
+                    // non caster self-casted auras (non stacked)
+                    if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE)
+                        apply = false;
+                    break;
+                case AREA_AURA_PARTY:
+                case AREA_AURA_RAID:
+                    // non caster self-casted auras (stacked from diff. casters)
+                    if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE && i->second->GetCasterGuid() != GetCasterGuid())
                     {
-                        case AREA_AURA_ENEMY:
-                            // non caster self-casted auras (non stacked)
-                            if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE)
-                                apply = false;
-                            break;
-                        case AREA_AURA_PARTY:
-                        case AREA_AURA_RAID:
-                            // non caster self-casted auras (stacked from diff. casters)
-                            if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE && i->second->GetCasterGuid() != GetCasterGuid())
-                            {
-                                apply = IsStackableSpell(actualSpellInfo, i->second->GetSpellProto(), target);
-                                break;
-                            }
-                            if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE || i->second->GetCasterGuid() == GetCasterGuid())
-                                apply = false;
-                            break;
-                        default:
-                            // in generic case not allow stacking area auras
-                            apply = false;
-                            break;
+                        apply = IsStackableSpell(actualSpellInfo, i->second->GetSpellProto(), target);
+                        break;
                     }
+                    if (aur->GetModifier()->m_auraname != SPELL_AURA_NONE || i->second->GetCasterGuid() == GetCasterGuid())
+                        apply = false;
+                    break;
+                default:
+                    // in generic case not allow stacking area auras
+                    apply = false;
+                    break;
+            }
 
-                    if (!apply)
-                        break;
-                }
+            if (!apply)
+                break;
+        }
 
-                if (!apply)
-                    continue;
+        if (!apply)
+            continue;
 
-                // Skip some targets (TODO: Might require better checks, also unclear how the actual caster must/can be handled)
-                if (actualSpellInfo->HasAttribute(SPELL_ATTR_EX3_TARGET_ONLY_PLAYER) && target->GetTypeId() != TYPEID_PLAYER)
-                    continue;
+        // Skip some targets (TODO: Might require better checks, also unclear how the actual caster must/can be handled)
+        if (actualSpellInfo->HasAttribute(SPELL_ATTR_EX3_TARGET_ONLY_PLAYER) && target->GetTypeId() != TYPEID_PLAYER)
+            continue;
 
-                int32 actualBasePoints = m_currentBasePoints;
-                int32 actualDamage = m_modifier.m_baseAmount;
-                // recalculate basepoints for lower rank (all AreaAura spell not use custom basepoints?)
-                if (actualSpellInfo != GetSpellProto())
-                {
-                    actualBasePoints = actualSpellInfo->CalculateSimpleValue(m_effIndex);
-                    actualDamage = caster->CalculateSpellEffectValue(target, actualSpellInfo, m_effIndex, &actualBasePoints);
-                }
+        int32 actualBasePoints = m_currentBasePoints;
+        int32 actualDamage = m_modifier.m_baseAmount;
+        // recalculate basepoints for lower rank (all AreaAura spell not use custom basepoints?)
+        if (actualSpellInfo != GetSpellProto())
+        {
+            actualBasePoints = actualSpellInfo->CalculateSimpleValue(m_effIndex);
+            actualDamage = caster->CalculateSpellEffectValue(target, actualSpellInfo, m_effIndex, &actualBasePoints);
+        }
 
-                SpellAuraHolder* holder = target->GetSpellAuraHolder(actualSpellInfo->Id, GetCasterGuid());
+        SpellAuraHolder* holder = target->GetSpellAuraHolder(actualSpellInfo->Id, GetCasterGuid());
 
-                bool addedToExisting = true;
-                if (!holder)
-                {
-                    holder = CreateSpellAuraHolder(actualSpellInfo, target, caster);
-                    addedToExisting = false;
-                }
+        bool addedToExisting = true;
+        if (!holder)
+        {
+            holder = CreateSpellAuraHolder(actualSpellInfo, target, caster);
+            addedToExisting = false;
+        }
 
-                holder->SetAuraDuration(GetAuraDuration());
+        holder->SetAuraDuration(GetAuraDuration());
 
-                AreaAura* aur = new AreaAura(actualSpellInfo, m_effIndex, &actualDamage, &actualBasePoints, holder, target, caster, nullptr, GetSpellProto()->Id);
-                holder->AddAura(aur, m_effIndex);
+        AreaAura* aur = new AreaAura(actualSpellInfo, m_effIndex, &actualDamage, &actualBasePoints, holder, target, caster, nullptr, GetSpellProto()->Id);
+        holder->AddAura(aur, m_effIndex);
 
-                if (addedToExisting)
-                {
-                    target->AddAuraToModList(aur);
-                    aur->ApplyModifier(true, true);
-                }
-                else
-                {
-                    if (target->AddSpellAuraHolder(holder))
-                        holder->SetState(SPELLAURAHOLDER_STATE_READY);
-                    else
-                        delete holder;
-                }
+        if (addedToExisting)
+        {
+            target->AddAuraToModList(aur);
+            aur->ApplyModifier(true, true);
+        }
+        else
+        {
+            if (target->AddSpellAuraHolder(holder))
+                holder->SetState(SPELLAURAHOLDER_STATE_READY);
+            else
+            {
+                delete holder;
+                continue;
             }
         }
-        Aura::Update(diff);
+
+        appliedTargets.emplace(target->GetObjectGuid(), actualSpellInfo->Id);
     }
-    else                                                    // aura at non-caster
-    {
-        Unit* caster = GetCaster();
-        Unit* target = GetTarget();
-        uint32 originalRankSpellId = m_originalRankSpellId ? m_originalRankSpellId : GetId(); // caster may have different spell id if target has lower level
 
-        Aura::Update(diff);
+    std::swap(m_appliedTargets, appliedTargets);
+}
 
-        // remove aura if out-of-range from caster (after teleport for example)
-        // or caster is isolated or caster no longer has the aura
-        // or caster is (no longer) friendly
-        bool needFriendly = (m_areaAuraType != AREA_AURA_ENEMY);
-        if (!caster ||
-                caster->hasUnitState(UNIT_STAT_ISOLATED)               ||
-                !caster->HasAura(originalRankSpellId, GetEffIndex())   ||
-                !caster->IsWithinDistInMap(target, m_radius)           ||
-                caster->CanAssistSpell(target, GetSpellProto()) != needFriendly
-           )
-        {
-            target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
-        }
-        else if (m_areaAuraType == AREA_AURA_PARTY)         // check if in same sub group
+void AreaAura::CheckTarget(Unit* caster, Unit* target)
+{
+    uint32 originalRankSpellId = m_originalRankSpellId ? m_originalRankSpellId : GetId(); // caster may have different spell id if target has lower level
+
+    // remove aura if out-of-range from caster (after teleport for example)
+    // or caster is isolated or caster no longer has the aura
+    // or caster is (no longer) friendly
+    bool needFriendly = (m_areaAuraType != AREA_AURA_ENEMY);
+    if (!caster ||
+            caster->hasUnitState(UNIT_STAT_ISOLATED)               ||
+            !caster->HasAura(originalRankSpellId, GetEffIndex())   ||
+            !caster->IsWithinDistInMap(target, m_radius)           ||
+            caster->CanAssistSpell(target, GetSpellProto()) != needFriendly
+       )
+    {
+        target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
+    }
+    else if (m_areaAuraType == AREA_AURA_PARTY)         // check if in same sub group
+    {
+        // Do not check group if target == owner or target == pet
+        // or if caster is a not player (as NPCs do not support group so aura is only removed by moving out of range)
+        if (caster->GetMasterGuid() != target->GetObjectGuid()  &&
+            caster->GetObjectGuid() != target->GetMasterGuid()  &&
+            caster->GetTypeId() == TYPEID_PLAYER)
         {
-            // Do not check group if target == owner or target == pet
-            // or if caster is a not player (as NPCs do not support group so aura is only removed by moving out of range)
-            if (caster->GetMasterGuid() != target->GetObjectGuid()  &&
-                caster->GetObjectGuid() != target->GetMasterGuid()  &&
-                caster->GetTypeId() == TYPEID_PLAYER)
-            {
-                Player* check = caster->GetBeneficiaryPlayer();
+            Player* check = caster->GetBeneficiaryPlayer();
 
-                Group* pGroup = check ? check->GetGroup() : nullptr;
-                if (pGroup)
-                {
-                    Player* checkTarget = target->GetBeneficiaryPlayer();
-                    if (!checkTarget || !pGroup->SameSubGroup(check, checkTarget))
-                        target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
-                }
-                else
+            Group* pGroup = check ? check->GetGroup() : nullptr;
+            if (pGroup)
+            {
+                Player* checkTarget = target->GetBeneficiaryPlayer();
+                if (!checkTarget || !pGroup->SameSubGroup(check, checkTarget))
                     target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
             }
+            else
+                target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
         }
-        else if (m_areaAuraType == AREA_AURA_RAID)          // Check if on same raid group
+    }
+    else if (m_areaAuraType == AREA_AURA_RAID)          // Check if on same raid group
+    {
+        // not check group if target == owner or target == pet
+        if (caster->GetMasterGuid() != target->GetObjectGuid() && caster->GetObjectGuid() != target->GetMasterGuid())
         {
-            // not check group if target == owner or target == pet
-            if (caster->GetMasterGuid() != target->GetObjectGuid() && caster->GetObjectGuid() != target->GetMasterGuid())
-            {
-                Player* check = caster->GetBeneficiaryPlayer();
+            Player* check = caster->GetBeneficiaryPlayer();
 
-                Group* pGroup = check ? check->GetGroup() : nullptr;
-                if (pGroup)
-                {
-                    Player* checkTarget = target->GetBeneficiaryPlayer();
-                    if (!checkTarget || !checkTarget->GetGroup() || checkTarget->GetGroup()->GetId() != pGroup->GetId())
-                        target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
-                }
-                else
+            Group* pGroup = check ? check->GetGroup() : nullptr;
+            if (pGroup)
+            {
+                Player* checkTarget = target->GetBeneficiaryPlayer();
+                if (!checkTarget || !checkTarget->GetGroup() || checkTarget->GetGroup()->GetId() != pGroup->GetId())
                     target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
             }
-        }
-        else if (m_areaAuraType == AREA_AURA_PET || m_areaAuraType == AREA_AURA_OWNER)
-        {
-            if (target->GetObjectGuid() != caster->GetMasterGuid())
+            else
                 target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
         }
     }
+    else if (m_areaAuraType == AREA_AURA_PET || m_areaAuraType == AREA_AURA_OWNER)
+    {
+        if (target->GetObjectGuid() != caster->GetMasterGuid())
+            target->RemoveSingleAuraFromSpellAuraHolder(GetId(), GetEffIndex(), GetCasterGuid());
+    }
 }
 
 void PersistentAreaAura::Update(uint32 diff)
@@ -11460,9 +11512,11 @@ void SpellAuraHolder::Update(uint32 diff)
         return;
     }
 
+    m_target->StartPeriodicAuraLogBatch();
     for (auto aura : m_auras)
         if (aura)
             aura->UpdateAura(diff);
+    m_target->FinishPeriodicAuraLogBatch();
 
     if (m_duration > 0)
     {
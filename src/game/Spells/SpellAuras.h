@@ -581,6 +581,8 @@ class Aura
         void ReapplyAffectedPassiveAuras(Unit* target, bool owner_mode);
 };
 
+#define AREA_AURA_UPDATE_INTERVAL 500                       // ms between the target updates of an area aura
+
 class AreaAura : public Aura
 {
     public:
@@ -589,9 +591,15 @@ class AreaAura : public Aura
     protected:
         void Update(uint32 diff) override;
     private:
+        void UpdateTargets(Unit* caster);
+        void CheckTarget(Unit* caster, Unit* target);
+        bool HasAppliedAura(Unit* target, uint32 spellId) const;
+
         float m_radius;
         AreaAuraType m_areaAuraType;
         uint32       m_originalRankSpellId;
+        uint32       m_targetUpdateTimer;                   // targets are searched and checked at this interval
+        std::unordered_map<ObjectGuid, uint32> m_appliedTargets; // of the caster aura, spell id of the rank applied
 };
 
 class PersistentAreaAura : public Aura
@@ -6539,7 +6539,7 @@ bool Spell::DoSummonCritter(CreatureSummonPositions& list, SummonPropertiesEntry
     CreatureCreatePos pos(m_caster->GetMap(), list[0].x, list[0].y, list[0].z, m_caster->GetOrientation(), m_caster->GetPhaseMask());
 
     // summon new pet
-    Pet* critter = new Pet(MINI_PET);
+    Pet* critter = new (m_caster->GetMap()) Pet(MINI_PET);
 
 
     if (!critter->Create(m_caster->GetMap()->GenerateLocalLowGuid(HIGHGUID_PET), pos, cInfo, pet_entry))
@@ -6623,7 +6623,7 @@ bool Spell::DoSummonGuardian(CreatureSummonPositions& list, SummonPropertiesEntr
     // in another case summon new
     for (auto& itr : list)
     {
-        Pet* spawnCreature = new Pet(petType);
+        Pet* spawnCreature = new (m_caster->GetMap()) Pet(petType);
 
         CreatureCreatePos pos(m_caster->GetMap(), itr.x, itr.y, itr.z, -m_caster->GetOrientation(), m_caster->GetPhaseMask());
 
@@ -6709,7 +6709,7 @@ bool Spell::DoSummonTotem(CreatureSummonPositions& list, SpellEffectIndex eff_id
         return false;
     }
 
-    Totem* pTotem = new Totem;
+    Totem* pTotem = new (m_caster->GetMap()) Totem;
     list[0].creature = pTotem;
 
     if (!pTotem->Create(m_caster->GetMap()->GenerateLocalLowGuid(HIGHGUID_UNIT), pos, cinfo, m_caster))
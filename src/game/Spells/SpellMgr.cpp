@@ -30,6 +30,8 @@
 #include "World/World.h"
 #include "Maps/Map.h"
 
+std::vector<SpellInfoExtra> sSpellInfoExtra;
+
 bool IsPrimaryProfessionSkill(uint32 skill)
 {
     SkillLineEntry const* pSkill = sSkillLineStore.LookupEntry(skill);
@@ -1537,6 +1539,72 @@ void SpellMgr::LoadSpellThreats()
     sLog.outString();
 }
 
+static DiminishingGroup CalculateDiminishingReturnsGroupForSpell(SpellEntry const* spellproto, bool triggered);
+
+// true when IsPositiveEffectTargetMode ends up in IsNeutralEffectTargetPositive for a unit target, the only part that looks at caster and target
+static bool IsEffectTargetModeContextual(SpellEntry const* entry, SpellEffectIndex effIndex, bool recursive = false)
+{
+    if (IsSpellEffectTriggerSpell(entry, effIndex))
+    {
+        uint32 const spellid = entry->EffectTriggerSpell[effIndex];
+        if (!recursive && spellid && (spellid != entry->Id))
+            if (SpellEntry const* triggered = sSpellTemplate.LookupEntry<SpellEntry>(spellid))
+                for (uint32 i = EFFECT_INDEX_0; i < MAX_EFFECT_INDEX; ++i)
+                    if (IsEffectTargetModeContextual(triggered, SpellEffectIndex(i), true))
+                        return true;
+        return false;
+    }
+
+    uint32 const a = entry->EffectImplicitTargetA[effIndex];
+    uint32 const b = entry->EffectImplicitTargetB[effIndex];
+
+    if ((!a && !b) || IsEffectTargetPositive(a, b) || IsEffectTargetScript(a, b) || IsEffectTargetNegative(a, b) || !IsEffectTargetNeutral(a, b))
+        return false;
+
+    uint32 const etarget = b ? b : a;
+    return !IsPointEffectTarget(SpellTarget(etarget)) && (etarget >= MAX_SPELL_TARGETS || SpellTargetInfoTable[etarget].type == TARGET_TYPE_UNIT);
+}
+
+void SpellMgr::LoadSpellInfoExtra()
+{
+    // the checks below read sSpellInfoExtra, they have to derive everything from the templates while it is built
+    sSpellInfoExtra.clear();
+
+    std::vector<SpellInfoExtra> spellInfoExtra(sSpellTemplate.GetMaxEntry());
+    uint32 count = 0;
+
+    BarGoLink bar(sSpellTemplate.GetMaxEntry());
+    for (uint32 i = 1; i < sSpellTemplate.GetMaxEntry(); ++i)
+    {
+        bar.step();
+
+        SpellEntry const* spellInfo = sSpellTemplate.LookupEntry<SpellEntry>(i);
+        if (!spellInfo)
+            continue;
+
+        SpellInfoExtra& extra = spellInfoExtra[i];
+        for (uint32 j = EFFECT_INDEX_0; j < MAX_EFFECT_INDEX; ++j)
+        {
+            SpellEffectIndex const effIndex = SpellEffectIndex(j);
+            if (IsPositiveEffect(spellInfo, effIndex))
+                extra.positiveEffectMask |= (1 << j);
+            if (IsPositiveEffectTargetMode(spellInfo, effIndex))
+                extra.positiveTargetModeMask |= (1 << j);
+            if (IsEffectTargetModeContextual(spellInfo, effIndex))
+                extra.contextualEffectMask |= (1 << j);
+        }
+
+        extra.diminishingGroup[0] = CalculateDiminishingReturnsGroupForSpell(spellInfo, false);
+        extra.diminishingGroup[1] = CalculateDiminishingReturnsGroupForSpell(spellInfo, true);
+        ++count;
+    }
+
+    sSpellInfoExtra.swap(spellInfoExtra);
+
+    sLog.outString(">> Derived extra data of %u spells", count);
+    sLog.outString();
+}
+
 bool SpellMgr::IsSpellCanAffectSpell(SpellEntry const* spellInfo_1, SpellEntry const* spellInfo_2) const
 {
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
@@ -2105,17 +2173,19 @@ void SpellMgr::LoadSpellChains()
     }
 
     // fill next rank cache
+    std::multimap<uint32, uint32> spellChainsNext;
     for (SpellChainMap::const_iterator i = mSpellChains.begin(); i != mSpellChains.end(); ++i)
     {
         uint32 spell_id = i->first;
         SpellChainNode const& node = i->second;
 
         if (node.prev)
-            mSpellChainsNext.insert(SpellChainMapNext::value_type(node.prev, spell_id));
+            spellChainsNext.insert(std::make_pair(node.prev, spell_id));
 
         if (node.req)
-            mSpellChainsNext.insert(SpellChainMapNext::value_type(node.req, spell_id));
+            spellChainsNext.insert(std::make_pair(node.req, spell_id));
     }
+    mSpellChainsNext.Build(spellChainsNext);
 
     // check single rank redundant cases (single rank talents/spell abilities not added by default so this can be only custom cases)
     for (SpellChainMap::const_iterator i = mSpellChains.begin(); i != mSpellChains.end(); ++i)
@@ -2191,6 +2261,7 @@ void SpellMgr::LoadSpellLearnSpells()
     }
 
     uint32 count = 0;
+    std::multimap<uint32, SpellLearnSpellNode> spellLearnSpells;
 
     BarGoLink bar(result->GetRowCount());
     do
@@ -2223,7 +2294,7 @@ void SpellMgr::LoadSpellLearnSpells()
             continue;
         }
 
-        mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell_id, node));
+        spellLearnSpells.insert(std::make_pair(spell_id, node));
 
         ++count;
     }
@@ -2257,10 +2328,10 @@ void SpellMgr::LoadSpellLearnSpells()
                 // other required explicit dependent learning
                 dbc_node.autoLearned = entry->EffectImplicitTargetA[i] == TARGET_UNIT_CASTER_PET || GetTalentSpellCost(spell) > 0 || IsPassiveSpell(entry) || IsSpellHaveEffect(entry, SPELL_EFFECT_SKILL_STEP);
 
-                SpellLearnSpellMapBounds db_node_bounds = GetSpellLearnSpellMapBounds(spell);
+                auto db_node_bounds = spellLearnSpells.equal_range(spell);
 
                 bool found = false;
-                for (SpellLearnSpellMap::const_iterator itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
+                for (auto itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
                 {
                     if (itr->second.spell == dbc_node.spell)
                     {
@@ -2273,13 +2344,15 @@ void SpellMgr::LoadSpellLearnSpells()
 
                 if (!found)                                 // add new spell-spell pair if not found
                 {
-                    mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell, dbc_node));
+                    spellLearnSpells.insert(std::make_pair(spell, dbc_node));
                     ++dbc_count;
                 }
             }
         }
     }
 
+    mSpellLearnSpells.Build(spellLearnSpells);
+
     sLog.outString(">> Loaded %u spell learn spells + %u found in DBC", count, dbc_count);
     sLog.outString();
 }
@@ -2511,6 +2584,8 @@ void SpellMgr::LoadSpellPetAuras()
 
 void SpellMgr::LoadPetLevelupSpellMap()
 {
+    mPetLevelupSpellMap.clear();                            // need for reload case
+
     uint32 count = 0;
     uint32 family_count = 0;
 
@@ -2541,11 +2616,17 @@ void SpellMgr::LoadPetLevelupSpellMap()
             if (spellSet.empty())
                 ++family_count;
 
-            spellSet.insert(PetLevelupSpellSet::value_type(spell->spellLevel, spell->Id));
+            spellSet.push_back(PetLevelupSpellSet::value_type(spell->spellLevel, spell->Id));
             ++count;
         }
     }
 
+    for (auto& spellSet : mPetLevelupSpellMap)
+        std::stable_sort(spellSet.second.begin(), spellSet.second.end(), [](PetLevelupSpellSet::value_type const& left, PetLevelupSpellSet::value_type const& right)
+        {
+            return left.first < right.first;
+        });
+
     sLog.outString(">> Loaded %u pet levelup and default spells for %u families", count, family_count);
     sLog.outString();
 }
@@ -3119,6 +3200,8 @@ void SpellMgr::LoadSkillLineAbilityMaps()
 
     const uint32 rows = sSkillLineAbilityStore.GetNumRows();
     uint32 count = 0;
+    std::multimap<uint32, SkillLineAbilityEntry const*> bySpellId;
+    std::multimap<uint32, SkillLineAbilityEntry const*> bySkillId;
 
     BarGoLink bar(rows);
     for (uint32 row = 0; row < rows; ++row)
@@ -3126,12 +3209,15 @@ void SpellMgr::LoadSkillLineAbilityMaps()
         bar.step();
         if (SkillLineAbilityEntry const* entry = sSkillLineAbilityStore.LookupEntry(row))
         {
-            mSkillLineAbilityMapBySpellId.insert(SkillLineAbilityMap::value_type(entry->spellId, entry));
-            mSkillLineAbilityMapBySkillId.insert(SkillLineAbilityMap::value_type(entry->skillId, entry));
+            bySpellId.insert(std::make_pair(entry->spellId, entry));
+            bySkillId.insert(std::make_pair(entry->skillId, entry));
             ++count;
         }
     }
 
+    mSkillLineAbilityMapBySpellId.Build(bySpellId);
+    mSkillLineAbilityMapBySkillId.Build(bySkillId);
+
     sLog.outString(">> Loaded %u SkillLineAbility MultiMaps Data", count);
     sLog.outString();
 }
@@ -3142,6 +3228,7 @@ void SpellMgr::LoadSkillRaceClassInfoMap()
 
     BarGoLink bar(sSkillRaceClassInfoStore.GetNumRows());
     uint32 count = 0;
+    std::multimap<uint32, SkillRaceClassInfoEntry const*> skillRaceClassInfo;
 
     for (uint32 i = 0; i < sSkillRaceClassInfoStore.GetNumRows(); ++i)
     {
@@ -3154,11 +3241,13 @@ void SpellMgr::LoadSkillRaceClassInfoMap()
         if (!sSkillLineStore.LookupEntry(skillRCInfo->skillId))
             continue;
 
-        mSkillRaceClassInfoMap.insert(SkillRaceClassInfoMap::value_type(skillRCInfo->skillId, skillRCInfo));
+        skillRaceClassInfo.insert(std::make_pair(skillRCInfo->skillId, skillRCInfo));
 
         ++count;
     }
 
+    mSkillRaceClassInfoMap.Build(skillRaceClassInfo);
+
     sLog.outString(">> Loaded %u SkillRaceClassInfo MultiMap Data", count);
     sLog.outString();
 }
@@ -3412,7 +3501,7 @@ void SpellMgr::CheckUsedSpells(char const* table) const
     sLog.outString(">> Checked %u spells and %u spell masks", countSpells, countMasks);
 }
 
-DiminishingGroup GetDiminishingReturnsGroupForSpell(SpellEntry const* spellproto, bool triggered)
+static DiminishingGroup CalculateDiminishingReturnsGroupForSpell(SpellEntry const* spellproto, bool triggered)
 {
     // Explicit Diminishing Groups
     switch (spellproto->SpellFamilyName)
@@ -3526,6 +3615,14 @@ DiminishingGroup GetDiminishingReturnsGroupForSpell(SpellEntry const* spellproto
     return DIMINISHING_NONE;
 }
 
+DiminishingGroup GetDiminishingReturnsGroupForSpell(SpellEntry const* spellproto, bool triggered)
+{
+    if (SpellInfoExtra const* extra = GetSpellInfoExtra(spellproto->Id))
+        return extra->diminishingGroup[triggered ? 1 : 0];
+
+    return CalculateDiminishingReturnsGroupForSpell(spellproto, triggered);
+}
+
 int32 GetDiminishingReturnsLimitDuration(DiminishingGroup group, SpellEntry const* spellproto)
 {
     if (!IsDiminishingReturnsGroupDurationLimited(group))
@@ -26,6 +26,7 @@
 #include "Globals/SharedDefines.h"
 #include "Spells/SpellAuraDefines.h"
 #include "Spells/SpellTargets.h"
+#include "Spells/FlatMultiMap.h"
 #include "Server/DBCStructure.h"
 #include "Server/DBCStores.h"
 #include "Entities/DynamicObject.h"
@@ -1058,6 +1059,23 @@ inline bool IsEffectTargetNegative(uint32 targetA, uint32 targetB)
     return (IsHostileTarget(targetA) || IsHostileTarget(targetB));
 }
 
+// Values derived from the spell template once at load, see SpellMgr::LoadSpellInfoExtra
+struct SpellInfoExtra
+{
+    uint8 positiveEffectMask;                               // effects IsPositiveEffect finds positive without caster and target
+    uint8 positiveTargetModeMask;                           // effects IsPositiveEffectTargetMode finds positive without caster and target
+    uint8 contextualEffectMask;                             // effects with neutral unit targets, their positivity depends on caster and target
+    DiminishingGroup diminishingGroup[2];                   // GetDiminishingReturnsGroupForSpell, not triggered and triggered
+};
+
+// indexed by spell id, empty until the spell templates are loaded
+extern std::vector<SpellInfoExtra> sSpellInfoExtra;
+
+inline SpellInfoExtra const* GetSpellInfoExtra(uint32 spellId)
+{
+    return spellId < sSpellInfoExtra.size() ? &sSpellInfoExtra[spellId] : nullptr;
+}
+
 inline bool IsNeutralEffectTargetPositive(uint32 etarget, const WorldObject* caster = nullptr, const WorldObject* target = nullptr)
 {
     if (etarget < MAX_SPELL_TARGETS && SpellTargetInfoTable[etarget].type != TARGET_TYPE_UNIT)
@@ -1080,6 +1098,10 @@ inline bool IsPositiveEffectTargetMode(const SpellEntry* entry, SpellEffectIndex
     if (!entry)
         return false;
 
+    if (SpellInfoExtra const* extra = GetSpellInfoExtra(entry->Id))
+        if (!recursive && !(extra->contextualEffectMask & (1 << effIndex)))
+            return (extra->positiveTargetModeMask & (1 << effIndex)) != 0;
+
     // Triggered spells case: prefer child spell via IsPositiveSpell()-like scan for triggered spell
     if (IsSpellEffectTriggerSpell(entry, effIndex))
     {
@@ -1127,6 +1149,10 @@ inline bool IsPositiveEffect(const SpellEntry* spellproto, SpellEffectIndex effI
     if (!spellproto)
         return false;
 
+    if (SpellInfoExtra const* extra = GetSpellInfoExtra(spellproto->Id))
+        if (!(extra->contextualEffectMask & (1 << effIndex)))
+            return (extra->positiveEffectMask & (1 << effIndex)) != 0;
+
     switch (spellproto->Id) // Spells whose effects are always positive
     {
         case 24742: // Magic Wings
@@ -2308,7 +2334,7 @@ struct SpellChainNode
 };
 
 typedef std::unordered_map<uint32, SpellChainNode> SpellChainMap;
-typedef std::multimap<uint32, uint32> SpellChainMapNext;
+typedef FlatMultiMap<uint32> SpellChainMapNext;
 
 // Spell learning properties (accessed using SpellMgr functions)
 struct SpellLearnSkillNode
@@ -2327,17 +2353,17 @@ struct SpellLearnSpellNode
     bool autoLearned;
 };
 
-typedef std::multimap<uint32, SpellLearnSpellNode> SpellLearnSpellMap;
-typedef std::pair<SpellLearnSpellMap::const_iterator, SpellLearnSpellMap::const_iterator> SpellLearnSpellMapBounds;
+typedef FlatMultiMap<SpellLearnSpellNode> SpellLearnSpellMap;
+typedef SpellLearnSpellMap::Bounds SpellLearnSpellMapBounds;
 
-typedef std::multimap<uint32, SkillLineAbilityEntry const*> SkillLineAbilityMap;
-typedef std::pair<SkillLineAbilityMap::const_iterator, SkillLineAbilityMap::const_iterator> SkillLineAbilityMapBounds;
+typedef FlatMultiMap<SkillLineAbilityEntry const*> SkillLineAbilityMap;
+typedef SkillLineAbilityMap::Bounds SkillLineAbilityMapBounds;
 
-typedef std::multimap<uint32, SkillRaceClassInfoEntry const*> SkillRaceClassInfoMap;
-typedef std::pair<SkillRaceClassInfoMap::const_iterator, SkillRaceClassInfoMap::const_iterator> SkillRaceClassInfoMapBounds;
+typedef FlatMultiMap<SkillRaceClassInfoEntry const*> SkillRaceClassInfoMap;
+typedef SkillRaceClassInfoMap::Bounds SkillRaceClassInfoMapBounds;
 
-typedef std::multimap<uint32, uint32> PetLevelupSpellSet;
-typedef std::map<uint32, PetLevelupSpellSet> PetLevelupSpellMap;
+typedef std::vector<std::pair<uint32, uint32> > PetLevelupSpellSet;  // level, spell; ordered by level
+typedef std::unordered_map<uint32, PetLevelupSpellSet> PetLevelupSpellMap;
 
 struct PetDefaultSpellsEntry
 {
@@ -2675,9 +2701,8 @@ class SpellMgr
 
         uint32 GetNextSpellInChain(uint32 spell_id) const
         {
-            SpellChainMapNext const& nextMap = GetSpellChainNext();
-
-            for (SpellChainMapNext::const_iterator itr = nextMap.lower_bound(spell_id); itr != nextMap.upper_bound(spell_id); ++itr)
+            SpellChainMapNext::Bounds bounds = GetSpellChainNext().equal_range(spell_id);
+            for (SpellChainMapNext::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
             {
                 SpellChainNode const* node = GetSpellChainNode(itr->second);
 
@@ -2697,8 +2722,8 @@ class SpellMgr
         template<typename Worker>
         void doForHighRanks(uint32 spellid, Worker& worker)
         {
-            SpellChainMapNext const& nextMap = GetSpellChainNext();
-            for (SpellChainMapNext::const_iterator itr = nextMap.lower_bound(spellid); itr != nextMap.upper_bound(spellid); ++itr)
+            SpellChainMapNext::Bounds bounds = GetSpellChainNext().equal_range(spellid);
+            for (SpellChainMapNext::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
             {
                 worker(itr->second);
                 doForHighRanks(itr->second, worker);
@@ -2953,6 +2978,7 @@ class SpellMgr
         void LoadPetLevelupSpellMap();
         void LoadPetDefaultSpells();
         void LoadSpellAreas();
+        void LoadSpellInfoExtra();
 
     private:
         bool LoadPetDefaultSpells_helper(CreatureInfo const* cInfo, PetDefaultSpellsEntry& petDefSpells);
@@ -525,21 +525,88 @@ ProcExecutionData::ProcExecutionData(ProcSystemArguments& data, bool isVictim) :
     }
 }
 
+#ifdef BUILD_METRICS
+std::atomic<uint64> Unit::m_procHolders(0);
+std::atomic<uint64> Unit::m_procCandidatesVisited(0);
+std::atomic<uint64> Unit::m_procTriggered(0);
+
+void Unit::GetProcIndexStats(uint64& holders, uint64& candidates, uint64& triggered)
+{
+    holders = m_procHolders.exchange(0);
+    candidates = m_procCandidatesVisited.exchange(0);
+    triggered = m_procTriggered.exchange(0);
+}
+#endif
+
+void Unit::AddProcCandidate(SpellAuraHolder* holder)
+{
+    SpellEntry const* spellProto = holder->GetSpellProto();
+
+    // same flags as checked by IsTriggeredAtSpellProcEvent
+    uint32 procFlags = spellProto->procFlags;
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
+    if (spellProcEvent && spellProcEvent->procFlags)
+        procFlags = spellProcEvent->procFlags;
+
+    // removed by damage taken even when not procing
+    if (spellProto->AuraInterruptFlags & AURA_INTERRUPT_FLAG_DAMAGE)
+        procFlags |= PROC_FLAG_TAKEN_ANY_DAMAGE;
+
+    if (!procFlags)
+        return;
+
+    // insert after holders of the same spell, as the holder map does
+    auto itr = std::upper_bound(m_procCandidates.begin(), m_procCandidates.end(), holder->GetId(),
+        [](uint32 spellId, ProcCandidate const& candidate) { return spellId < candidate.holder->GetId(); });
+    m_procCandidates.insert(itr, { holder, procFlags });
+    m_procCandidateFlags |= procFlags;
+}
+
+void Unit::RemoveProcCandidate(SpellAuraHolder* holder)
+{
+    auto itr = std::find_if(m_procCandidates.begin(), m_procCandidates.end(), [holder](ProcCandidate const& candidate) { return candidate.holder == holder; });
+    if (itr == m_procCandidates.end())
+        return;
+
+    m_procCandidates.erase(itr);
+
+    m_procCandidateFlags = 0;
+    for (ProcCandidate const& candidate : m_procCandidates)
+        m_procCandidateFlags |= candidate.procFlags;
+}
+
 void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 {
     ProcExecutionData execData(argData, isVictim);
 
+#ifdef BUILD_METRICS
+    m_procHolders.fetch_add(m_spellAuraHolders.size(), std::memory_order_relaxed);
+#endif
+
+    // no holder reacts to any of these flags
+    if ((execData.procFlags & m_procCandidateFlags) == 0)
+        return;
+
     ProcTriggeredList procTriggered;
     std::vector<SpellAuraHolder*> removedHolders;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    // Fill procTriggered list, only holders reacting to the flags need a look
+    for (size_t i = 0; i < m_procCandidates.size(); ++i)
     {
+        if ((m_procCandidates[i].procFlags & execData.procFlags) == 0)
+            continue;
+
+        SpellAuraHolder* holder = m_procCandidates[i].holder;
+
+#ifdef BUILD_METRICS
+        m_procCandidatesVisited.fetch_add(1, std::memory_order_relaxed);
+#endif
+
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->GetState() != SPELLAURAHOLDER_STATE_READY || itr->second->IsDeleted())
+        if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
             continue;
 
         SpellProcEventEntry const* spellProcEvent = nullptr;
-        if (!IsTriggeredAtSpellProcEvent(execData, itr->second, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(execData, holder, spellProcEvent))
         {
             // spell seem not managed by proc system, although some case need to be handled
 
@@ -547,20 +614,24 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
             if (!isVictim || !(execData.procFlags & PROC_FLAG_TAKEN_ANY_DAMAGE) || (execData.procSpell && execData.procSpell->HasAttribute(SPELL_ATTR_EX4_DAMAGE_DOESNT_BREAK_AURAS)))
                 continue;
 
-            const SpellEntry* se = itr->second->GetSpellProto();
+            const SpellEntry* se = holder->GetSpellProto();
 
             // check if the aura is interruptible by damage and if its not just added by this spell (spell who is responsible for this damage is procSpell)
             if (se->AuraInterruptFlags & AURA_INTERRUPT_FLAG_DAMAGE && (!execData.procSpell || execData.procSpell->Id != se->Id))
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_SPELL_CAST, "ProcDamageAndSpell: Added Spell %u to 'remove aura due to spell' list! Reason: Damage received.", se->Id);
-                removedHolders.push_back(itr->second);
+                removedHolders.push_back(holder);
             }
             continue;
         }
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, holder));
     }
 
+#ifdef BUILD_METRICS
+    m_procTriggered.fetch_add(procTriggered.size(), std::memory_order_relaxed);
+#endif
+
     for (auto holder : removedHolders)
         if (!holder->IsDeleted())
             RemoveSpellAuraHolder(holder);
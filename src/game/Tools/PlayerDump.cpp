@@ -67,107 +67,503 @@ static DumpTable dumpTables[] =
 };
 
 // Low level functions
-static bool findtoknth(std::string& str, int n, std::string::size_type& s, std::string::size_type& e)
-{
-    int i; s = e = 0;
-    std::string::size_type size = str.size();
-    for (i = 1; s < size && i < n; ++s) if (str[s] == ' ') ++i;
-    if (i < n)
-        return false;
+#define DUMP_BINARY_MAGIC "MPDB"
+#define DUMP_BINARY_VERSION 1
+#define DUMP_FLUSH_SIZE (64 * 1024)
 
-    e = str.find(' ', s);
+// records of the binary format
+enum DumpBinaryRecord
+{
+    DUMP_RECORD_END     = 'E',
+    DUMP_RECORD_GUARD   = 'G',                              // <- revision field name
+    DUMP_RECORD_TABLE   = 'T',                              // <- table name, field count; the rows up to the next table record are of it
+    DUMP_RECORD_ROW     = 'R',                              // <- field count values, each its length + 1 or 0 for NULL, then its bytes
+};
 
-    return e != std::string::npos;
+static void AppendVarint(std::string& out, uint32 value)
+{
+    while (value >= 0x80)
+    {
+        out += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
 }
 
-std::string gettoknth(std::string& str, int n)
+static bool ReadVarint(FILE* fin, uint32& value)
 {
-    std::string::size_type s = 0, e = 0;
-    if (!findtoknth(str, n, s, e))
-        return "";
+    value = 0;
+    for (uint32 shift = 0; shift < 35; shift += 7)
+    {
+        int c = fgetc(fin);
+        if (c == EOF)
+            return false;
 
-    return str.substr(s, e - s);
+        value |= uint32(c & 0x7F) << shift;
+        if (!(c & 0x80))
+            return true;
+    }
+    return false;
 }
 
-bool findnth(std::string& str, int n, std::string::size_type& s, std::string::size_type& e)
+static bool ReadBytes(FILE* fin, std::string& str, uint32 length)
 {
-    s = str.find("VALUES ('") + 9;
-    if (s == std::string::npos)
+    str.resize(length);
+    return !length || fread(&str[0], 1, length, fin) == length;
+}
+
+static bool IsValidRevisionField(std::string const& field)
+{
+    if (field.compare(0, 9, "required_") != 0)
         return false;
 
-    do
-    {
-        e = str.find('\'', s);
-        if (e == std::string::npos)
+    for (char c : field)
+        if (!isalnum(uint8(c)) && c != '_')
             return false;
-    }
-    while (str[e - 1] == '\\');
 
-    for (int i = 1; i < n; ++i)
-    {
-        do
-        {
-            s = e + 4;
-            e = str.find('\'', s);
-            if (e == std::string::npos)
-                return false;
-        }
-        while (str[e - 1] == '\\');
-    }
     return true;
 }
 
-std::string gettablename(std::string& str)
+// where the rows of the writer go
+class DumpOutput
 {
-    std::string::size_type s = 13;
-    std::string::size_type e = str.find(_TABLE_SIM_, s);
-    if (e == std::string::npos)
-        return "";
+    public:
+        explicit DumpOutput(FILE* file) : m_file(file) {}
+        virtual ~DumpOutput() {}
 
-    return str.substr(s, e - s);
-}
+        virtual void WriteNote(char const* /*text*/) {}
+        virtual void WriteRevisionGuard(std::string const& field) = 0;
+        virtual void WriteRow(char const* table, QueryResult* result) = 0;
 
-bool changenth(std::string& str, int n, const char* with, bool insert = false, bool nonzero = false)
+        // writes what is left to the file, false on a write error
+        virtual bool Finish() { return Flush(); }
+
+        std::string& GetBuffer() { return m_buffer; }
+
+    protected:
+        bool Flush()
+        {
+            if (!m_file || m_buffer.empty())
+                return true;
+
+            bool written = fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+            m_buffer.clear();
+            return written;
+        }
+
+        void FlushIfFull()
+        {
+            if (m_buffer.size() >= DUMP_FLUSH_SIZE && !Flush())
+                m_writeError = true;
+        }
+
+        FILE* m_file;                                       // nullptr to keep all in the buffer
+        std::string m_buffer;
+        bool m_writeError = false;
+};
+
+class TextDumpOutput : public DumpOutput
 {
-    std::string::size_type s, e;
-    if (!findnth(str, n, s, e))
-        return false;
+    public:
+        explicit TextDumpOutput(FILE* file = nullptr) : DumpOutput(file) {}
 
-    if (nonzero && str.substr(s, e - s) == "0")
-        return true;                                        // not an error
-    if (!insert)
-        str.replace(s, e - s, with);
-    else
-        str.insert(s, with);
+        void WriteNote(char const* text) override { m_buffer += text; }
 
-    return true;
-}
+        void WriteRevisionGuard(std::string const& field) override
+        {
+            // this will fail at wrong character DB version
+            m_buffer += "UPDATE character_db_version SET " + field + " = 1 WHERE FALSE;\n\n";
+        }
+
+        void WriteRow(char const* table, QueryResult* result) override
+        {
+            m_buffer += "INSERT INTO ";
+            m_buffer += _TABLE_SIM_;
+            m_buffer += table;
+            m_buffer += _TABLE_SIM_;
+            m_buffer += " VALUES (";
+
+            Field* fields = result->Fetch();
+            for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+            {
+                if (i != 0)
+                    m_buffer += ", ";
+
+                if (fields[i].IsNULL())
+                    m_buffer += "NULL";
+                else
+                {
+                    std::string s = fields[i].GetCppString();
+                    CharacterDatabase.escape_string(s);
+
+                    m_buffer += '\'';
+                    m_buffer += s;
+                    m_buffer += '\'';
+                }
+            }
+            m_buffer += ");\n";
+
+            FlushIfFull();
+        }
+
+        bool Finish() override
+        {
+            m_buffer += "\n";
+            return Flush() && !m_writeError;
+        }
+};
+
+class BinaryDumpOutput : public DumpOutput
+{
+    public:
+        explicit BinaryDumpOutput(FILE* file) : DumpOutput(file)
+        {
+            m_buffer += DUMP_BINARY_MAGIC;
+            m_buffer += char(DUMP_BINARY_VERSION);
+        }
+
+        void WriteRevisionGuard(std::string const& field) override
+        {
+            m_buffer += char(DUMP_RECORD_GUARD);
+            AppendVarint(m_buffer, uint32(field.size()));
+            m_buffer += field;
+        }
+
+        void WriteRow(char const* table, QueryResult* result) override
+        {
+            if (m_table != table)
+            {
+                m_table = table;
+                m_buffer += char(DUMP_RECORD_TABLE);
+                AppendVarint(m_buffer, uint32(m_table.size()));
+                m_buffer += m_table;
+                AppendVarint(m_buffer, result->GetFieldCount());
+            }
+
+            m_buffer += char(DUMP_RECORD_ROW);
+            Field* fields = result->Fetch();
+            for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+            {
+                if (fields[i].IsNULL())
+                {
+                    AppendVarint(m_buffer, 0);
+                    continue;
+                }
+
+                std::string s = fields[i].GetCppString();
+                AppendVarint(m_buffer, uint32(s.size()) + 1);
+                m_buffer += s;
+            }
 
-std::string getnth(std::string& str, int n)
+            FlushIfFull();
+        }
+
+        bool Finish() override
+        {
+            m_buffer += char(DUMP_RECORD_END);
+            return Flush() && !m_writeError;
+        }
+
+    private:
+        std::string m_table;                                // of the last table record
+};
+
+// a row read back, the values escaped for sql whatever the format
+struct DumpField
 {
-    std::string::size_type s, e;
-    if (!findnth(str, n, s, e))
-        return "";
+    DumpField() : isNull(false) {}
 
-    return str.substr(s, e - s);
-}
+    std::string value;
+    bool isNull;
+};
 
-bool changetoknth(std::string& str, int n, const char* with, bool insert = false, bool nonzero = false)
+enum DumpRowType
 {
-    std::string::size_type s = 0, e = 0;
-    if (!findtoknth(str, n, s, e))
-        return false;
-    if (nonzero && str.substr(s, e - s) == "0")
-        return true;                                        // not an error
-    if (!insert)
-        str.replace(s, e - s, with);
-    else
-        str.insert(s, with);
+    DUMP_ROW_DATA,
+    DUMP_ROW_GUARD,                                         // table is the revision field name
+    DUMP_ROW_END,
+};
 
-    return true;
-}
+struct DumpRow
+{
+    DumpRowType type;
+    std::string table;
+    std::vector<DumpField> fields;
+
+    // 1-based as the columns of the old text functions, nullptr past the last field
+    DumpField* GetField(uint32 n) { return n && n <= fields.size() ? &fields[n - 1] : nullptr; }
+};
+
+class DumpInput
+{
+    public:
+        explicit DumpInput(FILE* file) : m_file(file) {}
+        virtual ~DumpInput() {}
+
+        // the next row, a guard or the end
+        virtual DumpReturn Read(DumpRow& row) = 0;
+
+    protected:
+        FILE* m_file;
+};
+
+class TextDumpInput : public DumpInput
+{
+    public:
+        explicit TextDumpInput(FILE* file) : DumpInput(file) {}
+
+        DumpReturn Read(DumpRow& row) override
+        {
+            while (ReadLine())
+            {
+                // skip empty strings
+                size_t pos = m_line.find_first_not_of(" \t\n\r\7");
+                if (pos == std::string::npos)
+                    continue;
+
+                // skip NOTE
+                if (m_line.compare(pos, 15, "IMPORTANT NOTE:") == 0)
+                    continue;
+
+                if (m_line.compare(pos, 32, "UPDATE character_db_version SET ") == 0)
+                {
+                    pos += 32;
+                    row.type = DUMP_ROW_GUARD;
+                    row.table = m_line.substr(pos, m_line.find(' ', pos) - pos);
+                    if (!IsValidRevisionField(row.table))
+                        return DUMP_FILE_BROKEN;
+                    return DUMP_SUCCESS;
+                }
+
+                row.type = DUMP_ROW_DATA;
+                if (!ParseInsert(pos, row))
+                {
+                    sLog.outError("LoadPlayerDump: Can't parse line: '%s'!", m_line.c_str());
+                    return DUMP_FILE_BROKEN;
+                }
+                return DUMP_SUCCESS;
+            }
+
+            if (ferror(m_file))
+                return DUMP_FILE_BROKEN;
+
+            row.type = DUMP_ROW_END;
+            return DUMP_SUCCESS;
+        }
+
+    private:
+        bool ReadLine()
+        {
+            m_line.clear();
+            char buf[4096];
+            while (fgets(buf, sizeof(buf), m_file))
+            {
+                m_line += buf;
+                if (!m_line.empty() && m_line.back() == '\n')
+                    return true;
+            }
+            return !m_line.empty();
+        }
 
-uint32 registerNewGuid(uint32 oldGuid, std::map<uint32, uint32>& guidMap, uint32 hiGuid)
+        // INSERT INTO `table` VALUES ('value', NULL, ...);
+        bool ParseInsert(size_t pos, DumpRow& row)
+        {
+            if (m_line.compare(pos, 12, "INSERT INTO ") != 0)
+                return false;
+
+            pos += 12;
+            char const quote = m_line[pos];
+            size_t nameEnd = m_line.find(quote, pos + 1);
+            if (nameEnd == std::string::npos)
+                return false;
+
+            row.table = m_line.substr(pos + 1, nameEnd - pos - 1);
+
+            pos = m_line.find('(', nameEnd);
+            if (pos == std::string::npos)
+                return false;
+
+            row.fields.clear();
+            ++pos;
+            while (true)
+            {
+                pos = m_line.find_first_not_of(' ', pos);
+                if (pos == std::string::npos)
+                    return false;
+
+                row.fields.emplace_back();
+                DumpField& field = row.fields.back();
+                if (m_line.compare(pos, 4, "NULL") == 0)
+                {
+                    field.isNull = true;
+                    pos += 4;
+                }
+                else if (m_line[pos] == '\'')
+                {
+                    size_t start = ++pos;
+                    for (; pos < m_line.size(); ++pos)
+                    {
+                        if (m_line[pos] == '\\')            // escaped character
+                            ++pos;
+                        else if (m_line[pos] == '\'')
+                        {
+                            if (pos + 1 < m_line.size() && m_line[pos + 1] == '\'')
+                                ++pos;                      // doubled quote
+                            else
+                                break;
+                        }
+                    }
+
+                    if (pos >= m_line.size())
+                        return false;
+
+                    field.value.assign(m_line, start, pos - start);
+                    ++pos;
+                }
+                else
+                    return false;
+
+                pos = m_line.find_first_not_of(' ', pos);
+                if (pos == std::string::npos)
+                    return false;
+
+                if (m_line[pos] == ')')
+                    return true;
+
+                if (m_line[pos] != ',')
+                    return false;
+
+                ++pos;
+            }
+        }
+
+        std::string m_line;
+};
+
+class BinaryDumpInput : public DumpInput
+{
+    public:
+        explicit BinaryDumpInput(FILE* file) : DumpInput(file), m_fieldCount(0) {}
+
+        DumpReturn Read(DumpRow& row) override
+        {
+            while (true)
+            {
+                int record = fgetc(m_file);
+                uint32 length;
+                switch (record)
+                {
+                    case DUMP_RECORD_END:
+                        row.type = DUMP_ROW_END;
+                        return DUMP_SUCCESS;
+                    case DUMP_RECORD_GUARD:
+                        row.type = DUMP_ROW_GUARD;
+                        if (!ReadVarint(m_file, length) || !ReadBytes(m_file, row.table, length) || !IsValidRevisionField(row.table))
+                            return DUMP_FILE_BROKEN;
+                        return DUMP_SUCCESS;
+                    case DUMP_RECORD_TABLE:
+                        if (!ReadVarint(m_file, length) || !ReadBytes(m_file, m_table, length) || !ReadVarint(m_file, m_fieldCount))
+                            return DUMP_FILE_BROKEN;
+                        continue;
+                    case DUMP_RECORD_ROW:
+                        if (m_table.empty())
+                            return DUMP_FILE_BROKEN;
+
+                        row.type = DUMP_ROW_DATA;
+                        row.table = m_table;
+                        row.fields.resize(m_fieldCount);
+                        for (DumpField& field : row.fields)
+                        {
+                            if (!ReadVarint(m_file, length))
+                                return DUMP_UNEXPECTED_END;
+
+                            field.isNull = length == 0;
+                            if (field.isNull)
+                            {
+                                field.value.clear();
+                                continue;
+                            }
+
+                            if (!ReadBytes(m_file, field.value, length - 1))
+                                return DUMP_UNEXPECTED_END;
+
+                            CharacterDatabase.escape_string(field.value);
+                        }
+                        return DUMP_SUCCESS;
+                    case EOF:
+                        return DUMP_UNEXPECTED_END;         // no end record, the file was cut
+                    default:
+                        return DUMP_FILE_BROKEN;
+                }
+            }
+        }
+
+    private:
+        std::string m_table;
+        uint32 m_fieldCount;
+};
+
+// consecutive rows of a table inserted by one statement, up to the query length limit
+class DumpInsertBatch
+{
+    public:
+        bool Add(DumpRow const& row)
+        {
+            m_values.clear();
+            m_values += '(';
+            for (size_t i = 0; i < row.fields.size(); ++i)
+            {
+                if (i != 0)
+                    m_values += ", ";
+
+                if (row.fields[i].isNull)
+                    m_values += "NULL";
+                else
+                {
+                    m_values += '\'';
+                    m_values += row.fields[i].value;
+                    m_values += '\'';
+                }
+            }
+            m_values += ')';
+
+            if (!m_query.empty() && (m_table != row.table || m_query.size() + m_values.size() + 1 > MAX_QUERY_LEN))
+                if (!Flush())
+                    return false;
+
+            if (m_query.empty())
+            {
+                m_table = row.table;
+                m_query = "INSERT INTO ";
+                m_query += _TABLE_SIM_;
+                m_query += m_table;
+                m_query += _TABLE_SIM_;
+                m_query += " VALUES ";
+            }
+            else
+                m_query += ',';
+
+            m_query += m_values;
+            return true;
+        }
+
+        bool Flush()
+        {
+            if (m_query.empty())
+                return true;
+
+            bool executed = CharacterDatabase.Execute(m_query.c_str());
+            m_query.clear();
+            return executed;
+        }
+
+    private:
+        std::string m_table;
+        std::string m_query;
+        std::string m_values;
+};
+
+static uint32 registerNewGuid(uint32 oldGuid, std::map<uint32, uint32>& guidMap, uint32 hiGuid)
 {
     std::map<uint32, uint32>::const_iterator itr = guidMap.find(oldGuid);
     if (itr != guidMap.end())
@@ -178,57 +574,36 @@ uint32 registerNewGuid(uint32 oldGuid, std::map<uint32, uint32>& guidMap, uint32
     return newguid;
 }
 
-bool changeGuid(std::string& str, int n, std::map<uint32, uint32>& guidMap, uint32 hiGuid, bool nonzero = false)
+static bool changenth(DumpRow& row, uint32 n, char const* with)
 {
-    char chritem[20];
-    uint32 oldGuid = atoi(getnth(str, n).c_str());
-    if (nonzero && oldGuid == 0)
-        return true;                                        // not an error
-
-    uint32 newGuid = registerNewGuid(oldGuid, guidMap, hiGuid);
-    snprintf(chritem, 20, "%u", newGuid);
+    DumpField* field = row.GetField(n);
+    if (!field)
+        return false;
 
-    return changenth(str, n, chritem, false, nonzero);
+    field->value = with;
+    field->isNull = false;
+    return true;
 }
 
-bool changetokGuid(std::string& str, int n, std::map<uint32, uint32>& guidMap, uint32 hiGuid, bool nonzero = false)
+static std::string getnth(DumpRow& row, uint32 n)
 {
-    char chritem[20];
-    uint32 oldGuid = atoi(gettoknth(str, n).c_str());
-    if (nonzero && oldGuid == 0)
-        return true;                                        // not an error
-
-    uint32 newGuid = registerNewGuid(oldGuid, guidMap, hiGuid);
-    snprintf(chritem, 20, "%u", newGuid);
-
-    return changetoknth(str, n, chritem, false, nonzero);
+    DumpField* field = row.GetField(n);
+    return field ? field->value : "";
 }
 
-std::string CreateDumpString(char const* tableName, QueryResult* result)
+static bool changeGuid(DumpRow& row, uint32 n, std::map<uint32, uint32>& guidMap, uint32 hiGuid, bool nonzero = false)
 {
-    if (!tableName || !result)
-        return "";
-
-    std::ostringstream ss;
-    ss << "INSERT INTO " << _TABLE_SIM_ << tableName << _TABLE_SIM_ << " VALUES (";
-    Field* fields = result->Fetch();
-    for (uint32 i = 0; i < result->GetFieldCount(); ++i)
-    {
-        if (i != 0)
-            ss << ", ";
+    DumpField* field = row.GetField(n);
+    if (!field)
+        return false;
 
-        if (fields[i].IsNULL())
-            ss << "NULL";
-        else
-        {
-            std::string s =  fields[i].GetCppString();
-            CharacterDatabase.escape_string(s);
+    uint32 oldGuid = atoi(field->value.c_str());
+    if (nonzero && oldGuid == 0)
+        return true;                                        // not an error
 
-            ss << "'" << s << "'";
-        }
-    }
-    ss << ");";
-    return ss.str();
+    field->value = std::to_string(registerNewGuid(oldGuid, guidMap, hiGuid));
+    field->isNull = false;
+    return true;
 }
 
 std::string PlayerDumpWriter::GenerateWhereStr(char const* field, uint32 guid)
@@ -268,17 +643,8 @@ void StoreGUID(QueryResult* result, uint32 field, std::set<uint32>& guids)
         guids.insert(guid);
 }
 
-void StoreGUID(QueryResult* result, uint32 data, uint32 field, std::set<uint32>& guids)
-{
-    Field* fields = result->Fetch();
-    std::string dataStr = fields[data].GetCppString();
-    uint32 guid = atoi(gettoknth(dataStr, field).c_str());
-    if (guid)
-        guids.insert(guid);
-}
-
 // Writing - High-level functions
-void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type)
+void PlayerDumpWriter::DumpTableContent(DumpOutput& output, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type)
 {
     GUIDs const* guids = nullptr;
     char const* fieldname;
@@ -334,8 +700,7 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
                 default:                       break;
             }
 
-            dump += CreateDumpString(tableTo, result);
-            dump += "\n";
+            output.WriteRow(tableTo, result);
         }
         while (result->NextRow());
 
@@ -344,12 +709,10 @@ void PlayerDumpWriter::DumpTableContent(std::string& dump, uint32 guid, char con
     while (guids && guids_itr != guids->end());             // not set case iterate single time, set case iterate for all guids
 }
 
-std::string PlayerDumpWriter::GetDump(uint32 guid)
+void PlayerDumpWriter::Dump(DumpOutput& output, uint32 guid)
 {
-    std::string dump;
-
-    dump += "IMPORTANT NOTE: This sql queries not created for apply directly, use '.pdump load' command in console or client chat instead.\n";
-    dump += "IMPORTANT NOTE: NOT APPLY ITS DIRECTLY to character DB or you will DAMAGE and CORRUPT character DB\n\n";
+    output.WriteNote("IMPORTANT NOTE: This sql queries not created for apply directly, use '.pdump load' command in console or client chat instead.\n");
+    output.WriteNote("IMPORTANT NOTE: NOT APPLY ITS DIRECTLY to character DB or you will DAMAGE and CORRUPT character DB\n\n");
 
     // revision check guard
     QueryNamedResult* result = CharacterDatabase.QueryNamed("SELECT * FROM character_db_version LIMIT 1");
@@ -367,10 +730,7 @@ std::string PlayerDumpWriter::GetDump(uint32 guid)
         }
 
         if (!reqName.empty())
-        {
-            // this will fail at wrong character DB version
-            dump += "UPDATE character_db_version SET " + reqName + " = 1 WHERE FALSE;\n\n";
-        }
+            output.WriteRevisionGuard(reqName);
         else
             sLog.outError("Table 'character_db_version' not have revision guard field, revision guard query not added to pdump.");
 
@@ -380,25 +740,35 @@ std::string PlayerDumpWriter::GetDump(uint32 guid)
         sLog.outError("Character DB not have 'character_db_version' table, revision guard query not added to pdump.");
 
     for (DumpTable* itr = &dumpTables[0]; itr->isValid(); ++itr)
-        DumpTableContent(dump, guid, itr->name, itr->name, itr->type);
+        DumpTableContent(output, guid, itr->name, itr->name, itr->type);
 
     // TODO: Add instance/group..
     // TODO: Add a dump level option to skip some non-important tables
+}
 
-    return dump;
+std::string PlayerDumpWriter::GetDump(uint32 guid)
+{
+    TextDumpOutput output;
+    Dump(output, guid);
+    return std::move(output.GetBuffer());
 }
 
-DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid)
+DumpReturn PlayerDumpWriter::WriteDump(const std::string& file, uint32 guid, DumpFormat format)
 {
-    FILE* fout = fopen(file.c_str(), "w");
+    FILE* fout = fopen(file.c_str(), format == DUMP_FORMAT_BINARY ? "wb" : "w");
     if (!fout)
         return DUMP_FILE_OPEN_ERROR;
 
-    std::string dump = GetDump(guid);
+    std::unique_ptr<DumpOutput> output;
+    if (format == DUMP_FORMAT_BINARY)
+        output = std::make_unique<BinaryDumpOutput>(fout);
+    else
+        output = std::make_unique<TextDumpOutput>(fout);
 
-    fprintf(fout, "%s\n", dump.c_str());
+    Dump(*output, guid);
+    bool written = output->Finish();
     fclose(fout);
-    return DUMP_SUCCESS;
+    return written ? DUMP_SUCCESS : DUMP_FILE_BROKEN;
 }
 
 // Reading - High-level functions
@@ -413,10 +783,28 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     if (charcount >= 10)
         return DUMP_TOO_MANY_CHARS;
 
-    FILE* fin = fopen(file.c_str(), "r");
+    FILE* fin = fopen(file.c_str(), "rb");
     if (!fin)
         return DUMP_FILE_OPEN_ERROR;
 
+    // binary dumps start with their magic and version, anything else is read as text
+    std::unique_ptr<DumpInput> input;
+    char magic[5];
+    if (fread(magic, 1, 5, fin) == 5 && memcmp(magic, DUMP_BINARY_MAGIC, 4) == 0)
+    {
+        if (magic[4] != DUMP_BINARY_VERSION)
+        {
+            fclose(fin);
+            return DUMP_FILE_BROKEN;
+        }
+        input = std::make_unique<BinaryDumpInput>(fin);
+    }
+    else
+    {
+        rewind(fin);
+        input = std::make_unique<TextDumpInput>(fin);
+    }
+
     QueryResult* result;
     char newguid[20], chraccount[20], newpetid[20], currpetid[20], lastpetid[20];
 
@@ -462,49 +850,35 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     std::map<uint32, uint32> items;
     std::map<uint32, uint32> mails;
     std::map<uint32, uint32> eqsets;
-    char buf[32000] = "";
 
     typedef std::map<uint32, uint32> PetIds;                // old->new petid relation
     typedef PetIds::value_type PetIdsPair;
     PetIds petids;
 
+    DumpRow line;
+    DumpInsertBatch batch;
+
     CharacterDatabase.BeginTransaction();
-    while (!feof(fin))
+    while (true)
     {
-        if (!fgets(buf, 32000, fin))
-        {
-            if (feof(fin)) break;
-            ROLLBACK(DUMP_FILE_BROKEN);
-        }
-
-        std::string line; line.assign(buf);
-
-        // skip empty strings
-        size_t nw_pos = line.find_first_not_of(" \t\n\r\7");
-        if (nw_pos == std::string::npos)
-            continue;
+        DumpReturn readResult = input->Read(line);
+        if (readResult != DUMP_SUCCESS)
+            ROLLBACK(readResult);
 
-        // skip NOTE
-        if (line.substr(nw_pos, 15) == "IMPORTANT NOTE:")
-            continue;
+        if (line.type == DUMP_ROW_END)
+            break;
 
         // add required_ check
-        if (line.substr(nw_pos, 41) == "UPDATE character_db_version SET required_")
+        if (line.type == DUMP_ROW_GUARD)
         {
-            if (!CharacterDatabase.Execute(line.c_str()))
+            if (!batch.Flush() || !CharacterDatabase.PExecute("UPDATE character_db_version SET %s = 1 WHERE FALSE", line.table.c_str()))
                 ROLLBACK(DUMP_FILE_BROKEN);
 
             continue;
         }
 
-        // determine table name and load type
-        std::string tn = gettablename(line);
-        if (tn.empty())
-        {
-            sLog.outError("LoadPlayerDump: Can't extract table name from line: '%s'!", line.c_str());
-            ROLLBACK(DUMP_FILE_BROKEN);
-        }
-
+        // determine load type
+        std::string const& tn = line.table;
         DumpTableType type = DTT_CHARACTER;                 // Fixed: Using uninitialized memory 'type'
         DumpTable* dTable = &dumpTables[0];
         for (; dTable->isValid(); ++dTable)
@@ -554,8 +928,7 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 if (name.empty())
                 {
                     // check if the original name already exists
-                    name = getnth(line, 3);                 // characters.name
-                    CharacterDatabase.escape_string(name);
+                    name = getnth(line, 3);                 // characters.name, already escaped
 
                     result = CharacterDatabase.PQuery("SELECT * FROM characters WHERE name = '%s'", name.c_str());
                     if (result)
@@ -711,10 +1084,13 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
                 break;
         }
 
-        if (execute_ok && !CharacterDatabase.Execute(line.c_str()))
+        if (execute_ok && !batch.Add(line))
             ROLLBACK(DUMP_FILE_BROKEN);
     }
 
+    if (!batch.Flush())
+        ROLLBACK(DUMP_FILE_BROKEN);
+
     CharacterDatabase.CommitTransaction();
 
     // FIXME: current code with post-updating guids not safe for future per-map threads
@@ -64,6 +64,14 @@ enum DumpReturn
     DUMP_FILE_BROKEN,
 };
 
+enum DumpFormat
+{
+    DUMP_FORMAT_TEXT,                                       // sql inserts, one row per line
+    DUMP_FORMAT_BINARY,                                     // length prefixed values, the table named once per run of rows
+};
+
+class DumpOutput;
+
 class PlayerDump
 {
     protected:
@@ -76,11 +84,13 @@ class PlayerDumpWriter : public PlayerDump
         PlayerDumpWriter() {}
 
         std::string GetDump(uint32 guid);
-        DumpReturn WriteDump(const std::string& file, uint32 guid);
+        // streams the rows to the file as they are read, the dump is never held whole
+        DumpReturn WriteDump(const std::string& file, uint32 guid, DumpFormat format = DUMP_FORMAT_TEXT);
     private:
         typedef std::set<uint32> GUIDs;
 
-        void DumpTableContent(std::string& dump, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type);
+        void Dump(DumpOutput& output, uint32 guid);
+        void DumpTableContent(DumpOutput& output, uint32 guid, char const* tableFrom, char const* tableTo, DumpTableType type);
         static std::string GenerateWhereStr(char const* field, GUIDs const& guids, GUIDs::const_iterator& itr);
         static std::string GenerateWhereStr(char const* field, uint32 guid);
 
@@ -94,6 +104,7 @@ class PlayerDumpReader : public PlayerDump
     public:
         PlayerDumpReader() {}
 
+        // reads both formats, the rows of a table are inserted in multi row statements of one transaction
         static DumpReturn LoadDump(const std::string& file, uint32 account, std::string name, uint32 guid);
 };
 
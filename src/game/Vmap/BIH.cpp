@@ -277,12 +277,23 @@ bool BIH::readFromFile(FILE* rf)
     check += fread(&treeSize, sizeof(uint32), 1, rf);
     tree.resize(treeSize);
     check += fread(&tree[0], sizeof(uint32), treeSize, rf);
+    children.clear();
     check += fread(&count, sizeof(uint32), 1, rf);
     objects.resize(count); // = new uint32[nObjects];
     check += fread(&objects[0], sizeof(uint32), count, rf);
     return check == (3 + 3 + 2 + treeSize + count);
 }
 
+bool BIH::skipInFile(FILE* rf)
+{
+    uint32 treeSize = 0, count = 0;
+    if (fseek(rf, 6 * sizeof(float), SEEK_CUR) != 0 || fread(&treeSize, sizeof(uint32), 1, rf) != 1)
+        return false;
+    if (fseek(rf, treeSize * sizeof(uint32), SEEK_CUR) != 0 || fread(&count, sizeof(uint32), 1, rf) != 1)
+        return false;
+    return fseek(rf, count * sizeof(uint32), SEEK_CUR) == 0;
+}
+
 void BIH::BuildStats::updateLeaf(int depth, int n)
 {
     ++numLeaves;
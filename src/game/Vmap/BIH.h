@@ -78,6 +78,57 @@ class BIH
             // create space for the first node
             tree.push_back(static_cast<uint32>(3 << 30)); // dummy leaf
             tree.insert(tree.end(), 2, 0);
+            children.clear();
+        }
+
+        template<class BoundsFunc>
+        bool refitNode(uint32 node, BoundsFunc& getBounds, AABox& nodeBounds, float& leafArea)
+        {
+            uint32 tn = tree[node];
+            uint32 axis = (tn & (3 << 30)) >> 30;
+            const bool BVH2 = (tn & (1 << 29)) != 0;
+            int offset = tn & ~(7 << 29);
+            if (!BVH2 && axis == 3)
+            {
+                bool found = false;
+                for (uint32 i = 0; i < tree[node + 1]; ++i)
+                {
+                    AABox primBounds;
+                    if (!getBounds(objects[offset + i], primBounds))
+                        continue;
+                    if (found)
+                        nodeBounds.merge(primBounds);
+                    else
+                        nodeBounds = primBounds;
+                    found = true;
+                }
+                if (found)
+                    leafArea += nodeBounds.area();
+                return found;
+            }
+
+            if (BVH2)
+            {
+                bool found = refitNode(offset, getBounds, nodeBounds, leafArea);
+                // an empty interval is never entered
+                tree[node + 1] = floatToRawIntBits(found ? nodeBounds.low()[axis] : G3D::inf());
+                tree[node + 2] = floatToRawIntBits(found ? nodeBounds.high()[axis] : -G3D::inf());
+                return found;
+            }
+
+            AABox leftBounds, rightBounds;
+            bool left = (children[node / 3] & 1) && refitNode(offset, getBounds, leftBounds, leafArea);
+            bool right = (children[node / 3] & 2) && refitNode(offset + 3, getBounds, rightBounds, leafArea);
+            tree[node + 1] = floatToRawIntBits(left ? leftBounds.high()[axis] : -G3D::inf());
+            tree[node + 2] = floatToRawIntBits(right ? rightBounds.low()[axis] : G3D::inf());
+            if (left && right)
+            {
+                nodeBounds = leftBounds;
+                nodeBounds.merge(rightBounds);
+            }
+            else if (left || right)
+                nodeBounds = left ? leftBounds : rightBounds;
+            return left || right;
         }
 
     public:
@@ -113,11 +164,41 @@ class BIH
                 objects[i] = dat.indices[i];
             // nObjects = dat.numPrims;
             tree = tempTree;
+            children.clear();
             delete[] dat.primBound;
             delete[] dat.indices;
         }
         size_t primCount() const { return objects.size(); }
 
+        /** Moves the clip planes to the current bounds of the primitives, keeping the hierarchy. Primitives
+            for which getBounds returns false are left out. Returns the summed surface of the leaf boxes, which
+            grows as the primitives move away from where the tree was built. */
+        template<class BoundsFunc>
+        float refit(BoundsFunc& getBounds)
+        {
+            // which children the interior nodes have can only be read from the clip planes written by build
+            if (children.empty())
+            {
+                children.resize(tree.size() / 3, 0);
+                for (uint32 node = 0; node < tree.size(); node += 3)
+                {
+                    uint32 tn = tree[node];
+                    if ((tn >> 30) == 3 && !(tn & (1 << 29)))
+                        continue;
+                    if (tn & (1 << 29))
+                        children[node / 3] = 1;
+                    else
+                        children[node / 3] = (intBitsToFloat(tree[node + 1]) != -G3D::inf() ? 1 : 0) | (intBitsToFloat(tree[node + 2]) != G3D::inf() ? 2 : 0);
+                }
+            }
+
+            float leafArea = 0.f;
+            AABox rootBounds;
+            if (refitNode(0, getBounds, rootBounds, leafArea))
+                bounds = rootBounds;
+            return leafArea;
+        }
+
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false, bool ignoreM2Model = false) const
         {
@@ -341,11 +422,13 @@ class BIH
 
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
+        static bool skipInFile(FILE* rf);                   // moves past a tree written by writeToFile
 
     protected:
         std::vector<uint32> tree;
         std::vector<uint32> objects;
         AABox bounds;
+        std::vector<uint8> children;                        // per interior node, 1 left and 2 right child, filled by refit
 
         struct buildData
         {
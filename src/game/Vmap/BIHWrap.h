@@ -23,6 +23,8 @@
 #include <G3D/Set.h>
 #include "BIH.h"
 
+#include <chrono>
+
 template<class T, class BoundsFunc = BoundsTrait<T> >
 class BIHWrap
 {
@@ -57,20 +59,74 @@ class BIHWrap
 
         typedef G3D::Array<const T*> ObjArray;
 
+        struct RefitBounds
+        {
+            const T* const* objects;
+
+            bool operator()(uint32 Idx, G3D::AABox& out) const
+            {
+                if (!objects[Idx])
+                    return false;
+                BoundsFunc::getBounds2(objects[Idx], out);
+                return true;
+            }
+        };
+
         BIH m_tree;
         ObjArray m_objects;
         G3D::Table<const T*, uint32> m_obj2Idx;
+        G3D::Table<const T*, uint32> m_removed;     // taken out of m_objects since the last balance, a reinsert gets the slot back
         G3D::Set<const T*> m_objects_to_push;
         int unbalanced_times;
+        float m_builtArea;                          // leaf surface right after the last build
+
+        void build()
+        {
+            m_objects.fastClear();
+            m_obj2Idx.getKeys(m_objects);
+            // getMembers empties the array it fills, the objects already in the tree would be lost
+            ObjArray pushed;
+            m_objects_to_push.getMembers(pushed);
+            m_objects.append(pushed);
+
+            m_tree.build(m_objects, BoundsFunc::getBounds2);
+
+            m_obj2Idx.clear();
+            for (int i = 0; i < m_objects.size(); ++i)
+                m_obj2Idx.set(m_objects[i], i);
+            m_objects_to_push.clear();
+            m_removed.clear();
+
+            RefitBounds refitBounds = { m_objects.getCArray() };
+            m_builtArea = m_tree.refit(refitBounds);
+            ++rebuilds;
+        }
 
     public:
 
-        BIHWrap() : unbalanced_times(0) {}
+        BIHWrap() : unbalanced_times(0), m_builtArea(0.f), rebuilds(0), refits(0), balanceTime(0) {}
+
+        // growth of the leaf surface over the built tree from which a refit is followed by a full build, 0 always builds
+        static float rebuildLimit;
+
+        // since the owner last reset them, balanceTime in microseconds
+        uint32 rebuilds;
+        uint32 refits;
+        uint64 balanceTime;
 
         void insert(const T& obj)
         {
             ++unbalanced_times;
-            m_objects_to_push.insert(&obj);
+            uint32 Idx = 0;
+            const T* temp;
+            if (m_removed.getRemove(&obj, temp, Idx))
+            {
+                // moved in place, the refit of the next balance keeps it in its old leaf
+                m_objects[Idx] = &obj;
+                m_obj2Idx.set(&obj, Idx);
+            }
+            else
+                m_objects_to_push.insert(&obj);
         }
 
         void remove(const T& obj)
@@ -79,7 +135,10 @@ class BIHWrap
             uint32 Idx = 0;
             const T* temp;
             if (m_obj2Idx.getRemove(&obj, temp, Idx))
+            {
                 m_objects[Idx] = nullptr;
+                m_removed.set(&obj, Idx);
+            }
             else
                 m_objects_to_push.remove(&obj);
         }
@@ -90,11 +149,22 @@ class BIHWrap
                 return;
 
             unbalanced_times = 0;
-            m_objects.fastClear();
-            m_obj2Idx.getKeys(m_objects);
-            m_objects_to_push.getMembers(m_objects);
+            auto const start = std::chrono::steady_clock::now();
 
-            m_tree.build(m_objects, BoundsFunc::getBounds2);
+            // new objects, or more empty slots than objects, cannot be handled by a refit
+            if (rebuildLimit <= 0.f || m_objects_to_push.size() || uint32(m_objects.size()) > 2 * m_obj2Idx.size())
+                build();
+            else
+            {
+                m_removed.clear();
+                RefitBounds refitBounds = { m_objects.getCArray() };
+                if (m_tree.refit(refitBounds) > m_builtArea * rebuildLimit)
+                    build();
+                else
+                    ++refits;
+            }
+
+            balanceTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
         }
 
         template<typename RayCallback>
@@ -113,3 +183,6 @@ class BIHWrap
             m_tree.intersectPoint(p, temp_cb);
         }
 };
+
+template<class T, class BoundsFunc>
+float BIHWrap<T, BoundsFunc>::rebuildLimit = 0.f;
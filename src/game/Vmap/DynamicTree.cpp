@@ -59,7 +59,8 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     DynTreeImpl() :
         rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
+        unbalanced_times(0),
+        stats()
     {
     }
 
@@ -77,7 +78,23 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     void balance()
     {
-        base::balance();
+        // cells also balance themselves when queried, their counters are collected here
+        for (int x = 0; x < CELL_NUMBER; ++x)
+        {
+            for (int y = 0; y < CELL_NUMBER; ++y)
+            {
+                if (BIHWrap<Model>* n = nodes[x][y])
+                {
+                    n->balance();
+                    stats.rebuilds += n->rebuilds;
+                    stats.refits += n->refits;
+                    stats.balanceTime += n->balanceTime;
+                    n->rebuilds = 0;
+                    n->refits = 0;
+                    n->balanceTime = 0;
+                }
+            }
+        }
         unbalanced_times = 0;
     }
 
@@ -97,6 +114,7 @@ struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 
     ShortTimeTracker rebalance_timer;
     int unbalanced_times;
+    DynamicMapTree::BalanceStats stats;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(*new DynTreeImpl())
@@ -138,6 +156,17 @@ void DynamicMapTree::update(uint32 t_diff)
     impl.update(t_diff);
 }
 
+void DynamicMapTree::getBalanceStats(BalanceStats& stats)
+{
+    stats = impl.stats;
+    impl.stats = BalanceStats();
+}
+
+void DynamicMapTree::setRebuildLimit(float limit)
+{
+    BIHWrap<GameObjectModel>::rebuildLimit = limit;
+}
+
 struct DynamicTreeIntersectionCallback
 {
     bool did_hit;
@@ -47,6 +47,19 @@ class DynamicMapTree
 
         void balance();
         void update(uint32 t_diff);
+
+        struct BalanceStats
+        {
+            uint32 rebuilds;                                // cells whose tree was built again
+            uint32 refits;                                  // cells whose tree was only moved to the new bounds
+            uint64 balanceTime;                             // microseconds
+        };
+        // since the last call
+        void getBalanceStats(BalanceStats& stats);
+
+        // moved models refit the tree of their cell until its leaves cover this many times the surface they
+        // covered when built, then it is built again. 0 builds it again at every change
+        static void setRebuildLimit(float limit);
     private:
         struct DynTreeImpl& impl;
 };
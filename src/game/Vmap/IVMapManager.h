@@ -40,6 +40,14 @@ namespace VMAP
 #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
 #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    // one segment of a line of sight batch, result is set by the query
+    struct LineOfSightQuery
+    {
+        float x1, y1, z1;
+        float x2, y2, z2;
+        bool result;
+    };
+
     //===========================================================
     class IVMapManager
     {
@@ -60,6 +68,8 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, bool ignoreM2Model) = 0;
+            // same as isInLineOfSight for every query, the map tree is looked up once for all of them
+            virtual void isInLineOfSightBatch(unsigned int pMapId, LineOfSightQuery* queries, uint32 count, bool ignoreM2Model) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -21,9 +21,13 @@
 #include "BIH.h"
 #include "VMapDefinitions.h"
 
+#include <atomic>
+#include <functional>
 #include <set>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -43,6 +47,28 @@ namespace VMAP
         return memcmp(dest, compare, len) == 0;
     }
 
+    // runs job(0) to job(count - 1) on the given number of threads, no new job is started after one failed
+    static bool runJobs(uint32 count, uint32 threads, std::function<bool(uint32)> const& job)
+    {
+        std::atomic<uint32> nextJob(0);
+        std::atomic<bool> success(true);
+        auto worker = [&]()
+        {
+            for (uint32 i = nextJob++; i < count && success; i = nextJob++)
+                if (!job(i))
+                    success = false;
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32 i = 1; i < threads && i < count; ++i)
+            workers.emplace_back(worker);
+        worker();
+        for (std::thread& thread : workers)
+            thread.join();
+
+        return success;
+    }
+
     Vector3 ModelPosition::transform(const Vector3& pIn) const
     {
         Vector3 out = pIn * iScale;
@@ -56,6 +82,7 @@ namespace VMAP
     {
         iCurrentUniqueNameId = 0;
         iFilterMethod = nullptr;
+        iThreads = 1;
         iSrcDir = pSrcDirName;
         iDestDir = pDestDirName;
         // mkdir(iDestDir);
@@ -73,136 +100,154 @@ namespace VMAP
         if (!success)
             return false;
 
-        // export Map data
-        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end() && success; ++map_iter)
+        // export Map data, every map writes its own files
+        std::vector<std::pair<uint32, MapSpawns*>> maps(mapData.begin(), mapData.end());
+        std::vector<std::set<std::string>> mapModelFiles(maps.size());
+        success = runJobs(uint32(maps.size()), iThreads, [&](uint32 i)
+        {
+            return convertMap(maps[i].first, *maps[i].second, mapModelFiles[i]);
+        });
+
+        for (std::set<std::string> const& modelFiles : mapModelFiles)
+            spawnedModelFiles.insert(modelFiles.begin(), modelFiles.end());
+
+        // add an object models, listed in temp_gameobject_models file
+        exportGameobjectModels();
+
+        // export objects
+        std::cout << "\nConverting Model Files" << std::endl;
+        std::vector<std::string> modelFiles(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        std::mutex printLock;
+        if (!runJobs(uint32(modelFiles.size()), iThreads, [&](uint32 i)
         {
-            // build global map tree
-            std::vector<ModelSpawn*> mapSpawns;
-            UniqueEntryMap::iterator entry;
-            printf("Calculating model bounds for map %u...\n", map_iter->first);
-            for (entry = map_iter->second->UniqueEntries.begin(); entry != map_iter->second->UniqueEntries.end(); ++entry)
             {
-                // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
-                if (entry->second.flags & MOD_M2)
-                {
-                    if (!calculateTransformedBound(entry->second))
-                        break;
-                }
-                else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
-                {
-                    // TODO: remove extractor hack and uncomment below line:
-                    // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
-                    entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
-                }
-                mapSpawns.push_back(&(entry->second));
-                spawnedModelFiles.insert(entry->second.name);
+                std::lock_guard<std::mutex> guard(printLock);
+                std::cout << "Converting " << modelFiles[i] << std::endl;
             }
+            if (convertRawFile(modelFiles[i]))
+                return true;
 
-            printf("Creating map tree...\n");
-            BIH pTree;
-            pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
+            std::lock_guard<std::mutex> guard(printLock);
+            std::cout << "error converting " << modelFiles[i] << std::endl;
+            return false;
+        }))
+            success = false;
+
+        // cleanup:
+        for (auto& map_iter : mapData)
+        {
+            delete map_iter.second;
+        }
+        return success;
+    }
 
-            // ===> possibly move this code to StaticMapTree class
-            std::map<uint32, uint32> modelNodeIdx;
-            for (uint32 i = 0; i < mapSpawns.size(); ++i)
-                modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
+    bool TileAssembler::convertMap(uint32 mapID, MapSpawns& spawns, std::set<std::string>& modelFiles)
+    {
+        bool success = true;
 
-            // write map tree file
-            std::stringstream mapfilename;
-            mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << map_iter->first << ".vmtree";
-            FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
-            if (!mapfile)
+        // build global map tree
+        std::vector<ModelSpawn*> mapSpawns;
+        UniqueEntryMap::iterator entry;
+        printf("Calculating model bounds for map %u...\n", mapID);
+        for (entry = spawns.UniqueEntries.begin(); entry != spawns.UniqueEntries.end(); ++entry)
+        {
+            // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
+            if (entry->second.flags & MOD_M2)
             {
-                success = false;
-                printf("Cannot open %s\n", mapfilename.str().c_str());
-                break;
+                if (!calculateTransformedBound(entry->second))
+                    break;
             }
-
-            // general info
-            if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
-            uint32 globalTileID = StaticMapTree::packTileID(65, 65);
-            pair<TileMap::iterator, TileMap::iterator> globalRange = map_iter->second->TileEntries.equal_range(globalTileID);
-            char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
-            if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
-            // Nodes
-            if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
-            if (success) success = pTree.writeToFile(mapfile);
-            // global map spawns (WDT), if any (most instances)
-            if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
-
-            uint32 i = 0;
-            for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob, ++i)
+            else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
             {
-                ModelSpawn& globSpawn = map_iter->second->UniqueEntries[glob->second];
-                success = ModelSpawn::writeToFile(mapfile, map_iter->second->UniqueEntries[glob->second]);
-                // MapTree nodes to update when loading tile:
-                std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(globSpawn.ID);
-                if (success && fwrite(&nIdx->second, sizeof(uint32), 1, mapfile) != 1) success = false;
+                // TODO: remove extractor hack and uncomment below line:
+                // entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
+                entry->second.iBound = entry->second.iBound + Vector3(533.33333f * 32, 533.33333f * 32, 0.f);
             }
+            mapSpawns.push_back(&(entry->second));
+            modelFiles.insert(entry->second.name);
+        }
 
-            printf("Map %u global objects %u", map_iter->first, i);
+        printf("Creating map tree...\n");
+        BIH pTree;
+        pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
 
-            fclose(mapfile);
+        // ===> possibly move this code to StaticMapTree class
+        std::map<uint32, uint32> modelNodeIdx;
+        for (uint32 i = 0; i < mapSpawns.size(); ++i)
+            modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
 
-            // <====
+        // write map tree file
+        std::stringstream mapfilename;
+        mapfilename << iDestDir << "/" << std::setfill('0') << std::setw(3) << mapID << ".vmtree";
+        FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
+        if (!mapfile)
+        {
+            printf("Cannot open %s\n", mapfilename.str().c_str());
+            return false;
+        }
 
-            // write map tile files, similar to ADT files, only with extra BSP tree node info
-            TileMap& tileEntries = map_iter->second->TileEntries;
-            TileMap::iterator tile;
-            for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
-            {
-                const ModelSpawn& spawn = map_iter->second->UniqueEntries[tile->second];
-                if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
-                    continue;
-                uint32 nSpawns = tileEntries.count(tile->first);
-                std::stringstream tilefilename;
-                tilefilename.fill('0');
-                tilefilename << iDestDir << "/" << std::setw(3) << map_iter->first << "_";
-                uint32 x, y;
-                StaticMapTree::unpackTileID(tile->first, x, y);
-                tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
-                FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
-                // file header
-                if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
-                // write number of tile spawns
-                if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
-                // write tile spawns
-                for (uint32 s = 0; s < nSpawns; ++s)
-                {
-                    if (s)
-                        ++tile;
-                    ModelSpawn& spawn2 = map_iter->second->UniqueEntries[tile->second];
-                    success = success && ModelSpawn::writeToFile(tilefile, spawn2);
-                    // MapTree nodes to update when loading tile:
-                    std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
-                    if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
-                }
-                fclose(tilefile);
-            }
-            // break; // test, extract only first map; TODO: remvoe this line
+        // general info
+        if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
+        uint32 globalTileID = StaticMapTree::packTileID(65, 65);
+        pair<TileMap::iterator, TileMap::iterator> globalRange = spawns.TileEntries.equal_range(globalTileID);
+        char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
+        if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
+        // Nodes
+        if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
+        if (success) success = pTree.writeToFile(mapfile);
+        // global map spawns (WDT), if any (most instances)
+        if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
+
+        uint32 i = 0;
+        for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob, ++i)
+        {
+            ModelSpawn& globSpawn = spawns.UniqueEntries[glob->second];
+            success = ModelSpawn::writeToFile(mapfile, spawns.UniqueEntries[glob->second]);
+            // MapTree nodes to update when loading tile:
+            std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(globSpawn.ID);
+            if (success && fwrite(&nIdx->second, sizeof(uint32), 1, mapfile) != 1) success = false;
         }
 
-        // add an object models, listed in temp_gameobject_models file
-        exportGameobjectModels();
+        printf("Map %u global objects %u", mapID, i);
 
-        // export objects
-        std::cout << "\nConverting Model Files" << std::endl;
-        for (const auto& spawnedModelFile : spawnedModelFiles)
+        fclose(mapfile);
+
+        // <====
+
+        // write map tile files, similar to ADT files, only with extra BSP tree node info
+        TileMap& tileEntries = spawns.TileEntries;
+        TileMap::iterator tile;
+        for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
         {
-            std::cout << "Converting " << spawnedModelFile << std::endl;
-            if (!convertRawFile(spawnedModelFile))
+            const ModelSpawn& spawn = spawns.UniqueEntries[tile->second];
+            if (spawn.flags & MOD_WORLDSPAWN)           // WDT spawn, saved as tile 65/65 currently...
+                continue;
+            uint32 nSpawns = tileEntries.count(tile->first);
+            std::stringstream tilefilename;
+            tilefilename.fill('0');
+            tilefilename << iDestDir << "/" << std::setw(3) << mapID << "_";
+            uint32 x, y;
+            StaticMapTree::unpackTileID(tile->first, x, y);
+            tilefilename << std::setw(2) << x << "_" << std::setw(2) << y << ".vmtile";
+            FILE* tilefile = fopen(tilefilename.str().c_str(), "wb");
+            // file header
+            if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
+            // write number of tile spawns
+            if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
+            // write tile spawns
+            for (uint32 s = 0; s < nSpawns; ++s)
             {
-                std::cout << "error converting " << spawnedModelFile << std::endl;
-                success = false;
-                break;
+                if (s)
+                    ++tile;
+                ModelSpawn& spawn2 = spawns.UniqueEntries[tile->second];
+                success = success && ModelSpawn::writeToFile(tilefile, spawn2);
+                // MapTree nodes to update when loading tile:
+                std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
+                if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
             }
+            fclose(tilefile);
         }
 
-        // cleanup:
-        for (auto& map_iter : mapData)
-        {
-            delete map_iter.second;
-        }
         return success;
     }
 
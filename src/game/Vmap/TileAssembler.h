@@ -21,6 +21,7 @@
 
 #include <G3D/Vector3.h>
 #include <G3D/Matrix3.h>
+#include <algorithm>
 #include <map>
 #include <set>
 
@@ -98,6 +99,7 @@ namespace VMAP
             unsigned int iCurrentUniqueNameId;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            uint32 iThreads;
 
         public:
             TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
@@ -105,11 +107,14 @@ namespace VMAP
 
             bool convertWorld2();
             bool readMapSpawns();
+            bool convertMap(uint32 mapID, MapSpawns& spawns, std::set<std::string>& modelFiles);
             bool calculateTransformedBound(ModelSpawn& spawn);
 
             void exportGameobjectModels();
             bool convertRawFile(const std::string& pModelFilename);
             void setModelNameFilterMethod(bool (*pFilterMethod)(char* pName)) { iFilterMethod = pFilterMethod; }
+            // maps and models are converted on that many threads, the output does not depend on it
+            void setThreadCount(uint32 threads) { iThreads = std::max(threads, 1u); }
     };
 }                                                           // VMAP
 
@@ -171,6 +171,28 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSightBatch(unsigned int pMapId, LineOfSightQuery* queries, uint32 count, bool ignoreM2Model)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = true;
+
+        if (!isLineOfSightCalcEnabled())
+            return;
+
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            LineOfSightQuery& query = queries[i];
+            Vector3 pos1 = convertPositionToInternalRep(query.x1, query.y1, query.z1);
+            Vector3 pos2 = convertPositionToInternalRep(query.x2, query.y2, query.z2);
+            if (pos1 != pos2)
+                query.result = instanceTree->second->isInLineOfSight(pos1, pos2, ignoreM2Model);
+        }
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -269,7 +291,7 @@ namespace VMAP
         if (model == iLoadedModelFiles.end())
         {
             WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            if (!worldmodel->readFile(basepath + filename + ".vmo", true))
             {
                 ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
                 delete worldmodel;
@@ -287,6 +309,7 @@ namespace VMAP
 
     void VMapManager2::releaseModelInstance(const std::string& filename)
     {
+        std::lock_guard<std::mutex> lock(m_vmModelMutex);
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
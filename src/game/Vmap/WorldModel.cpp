@@ -261,6 +261,16 @@ namespace VMAP
         return result;
     }
 
+    bool WmoLiquid::skipInFile(FILE* rf)
+    {
+        // the chunk size written before the liquid misses iType, so the size is taken from the tiles
+        uint32 tilesX = 0, tilesY = 0;
+        if (fread(&tilesX, sizeof(uint32), 1, rf) != 1 || fread(&tilesY, sizeof(uint32), 1, rf) != 1)
+            return false;
+        long size = sizeof(Vector3) + sizeof(uint32) + (tilesX + 1) * (tilesY + 1) * sizeof(float) + tilesX * tilesY;
+        return fseek(rf, size, SEEK_CUR) == 0;
+    }
+
     // ===================== GroupModel ==================================
 
     GroupModel::GroupModel(GroupModel const& other):
@@ -325,20 +335,62 @@ namespace VMAP
     }
 
     bool GroupModel::readFromFile(FILE* rf)
+    {
+        bool result = true;
+
+        if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1) result = false;
+        if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1) result = false;
+
+        if (result) result = readDataFromFile(rf);
+        return result;
+    }
+
+    bool GroupModel::readHeaderFromFile(FILE* rf, long& dataOffset)
     {
         char chunk[8];
         bool result = true;
         uint32 chunkSize = 0;
         uint32 count = 0;
-        triangles.clear();
-        vertices.clear();
-        delete iLiquid;
-        iLiquid = nullptr;
+        dataOffset = 0;
 
         if (result && fread(&iBound, sizeof(G3D::AABox), 1, rf) != 1) result = false;
         if (result && fread(&iMogpFlags, sizeof(uint32), 1, rf) != 1) result = false;
         if (result && fread(&iGroupWMOID, sizeof(uint32), 1, rf) != 1) result = false;
 
+        long offset = ftell(rf);
+        if (result && !readChunk(rf, chunk, "VERT", 4)) result = false;
+        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
+        if (!result || !count)
+            return result;
+
+        // the same chunks readDataFromFile reads, only passed over
+        dataOffset = offset;
+        if (fseek(rf, count * sizeof(Vector3), SEEK_CUR) != 0) result = false;
+        if (result && !readChunk(rf, chunk, "TRIM", 4)) result = false;
+        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && fseek(rf, chunkSize, SEEK_CUR) != 0) result = false;
+        if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
+        if (result) result = BIH::skipInFile(rf);
+        if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
+        if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
+        if (result && chunkSize > 0)
+            result = WmoLiquid::skipInFile(rf);
+        return result;
+    }
+
+    bool GroupModel::readDataFromFile(FILE* rf)
+    {
+        char chunk[8];
+        bool result = true;
+        uint32 chunkSize = 0;
+        uint32 count = 0;
+        triangles.clear();
+        vertices.clear();
+        delete iLiquid;
+        iLiquid = nullptr;
+
         // read vertices
         if (result && !readChunk(rf, chunk, "VERT", 4)) result = false;
         if (result && fread(&chunkSize, sizeof(uint32), 1, rf) != 1) result = false;
@@ -386,7 +438,7 @@ namespace VMAP
         bool hit;
     };
 
-    bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool ignoreM2Model) const
+    MANGOS_SIMD_KERNEL bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool ignoreM2Model) const
     {
         if (triangles.empty())
             return false;
@@ -396,7 +448,7 @@ namespace VMAP
         return callback.hit;
     }
 
-    bool GroupModel::IsInsideObject(Vector3 const& pos, Vector3 const& down, float& z_dist) const
+    MANGOS_SIMD_KERNEL bool GroupModel::IsInsideObject(Vector3 const& pos, Vector3 const& down, float& z_dist) const
     {
         if (triangles.empty() || !iBound.contains(pos))
             return false;
@@ -434,14 +486,14 @@ namespace VMAP
 
     struct WModelRayCallBack
     {
-        WModelRayCallBack(const std::vector<GroupModel>& mod): models(mod.begin()), hit(false) {}
+        WModelRayCallBack(WorldModel const& mod): model(mod), hit(false) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit, bool ignoreM2Model)
         {
-            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit, ignoreM2Model);
+            bool result = model.getGroupModel(entry).IntersectRay(ray, distance, pStopAtFirstHit, ignoreM2Model);
             if (result) hit = true;
             return hit;
         }
-        std::vector<GroupModel>::const_iterator models;
+        WorldModel const& model;
         bool hit;
     };
 
@@ -453,9 +505,9 @@ namespace VMAP
         // small M2 workaround, maybe better make separate class with virtual intersection funcs
         // in any case, there's no need to use a bound tree if we only have one submodel
         if (groupModels.size() == 1)
-            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit, ignoreM2Model);
+            return getGroupModel(0).IntersectRay(ray, distance, stopAtFirstHit, ignoreM2Model);
 
-        WModelRayCallBack isc(groupModels);
+        WModelRayCallBack isc(*this);
         groupTree.intersectRay(ray, isc, distance, stopAtFirstHit, ignoreM2Model);
         return isc.hit;
     }
@@ -463,8 +515,9 @@ namespace VMAP
     class WModelAreaCallback
     {
         public:
-            WModelAreaCallback(std::vector<GroupModel> const& vals, Vector3 const& down):
-                prims(vals.begin()), hit(vals.end()), minVol(G3D::inf()), zDist(G3D::inf()), zVec(down) {}
+            WModelAreaCallback(WorldModel const& mod, std::vector<GroupModel> const& vals, Vector3 const& down):
+                model(mod), prims(vals.begin()), hit(vals.end()), minVol(G3D::inf()), zDist(G3D::inf()), zVec(down) {}
+            WorldModel const& model;
             std::vector<GroupModel>::const_iterator prims;
             std::vector<GroupModel>::const_iterator hit;
             float minVol;
@@ -478,7 +531,10 @@ namespace VMAP
                 // if(pVol < minVol)
                 //{
                 /* if (prims[entry].iBound.contains(point)) */
-                if (prims[entry].IsInsideObject(point, zVec, group_Z))
+                // the bound is known without the geometry, a group outside is not loaded for the check
+                if (!prims[entry].GetBound().contains(point))
+                    return;
+                if (model.getGroupModel(entry).IsInsideObject(point, zVec, group_Z))
                 {
                     // minVol = pVol;
                     // hit = prims + entry;
@@ -504,7 +560,7 @@ namespace VMAP
         if (groupModels.empty())
             return false;
 
-        WModelAreaCallback callback(groupModels, down);
+        WModelAreaCallback callback(*this, groupModels, down);
         groupTree.intersectPoint(p, callback);
         if (callback.hit != groupModels.end())
         {
@@ -523,7 +579,7 @@ namespace VMAP
         if (groupModels.empty())
             return false;
 
-        WModelAreaCallback callback(groupModels, down);
+        WModelAreaCallback callback(*this, groupModels, down);
         groupTree.intersectPoint(p, callback);
         if (callback.hit != groupModels.end())
         {
@@ -567,7 +623,7 @@ namespace VMAP
         return result;
     }
 
-    bool WorldModel::readFile(std::string const& filename)
+    bool WorldModel::readFile(std::string const& filename, bool lazyGroups /*= false*/)
     {
         FILE* rf = fopen(filename.c_str(), "rb");
         if (!rf)
@@ -591,8 +647,23 @@ namespace VMAP
             if (result && fread(&count, sizeof(uint32), 1, rf) != 1) result = false;
             if (result) groupModels.resize(count);
             // if (result && fread(&groupModels[0], sizeof(GroupModel), count, rf) != count) result = false;
-            for (uint32 i = 0; i < count && result; ++i)
-                result = groupModels[i].readFromFile(rf);
+            if (lazyGroups)
+            {
+                // most queries into huge WMOs touch a few groups, the others never get their geometry read
+                fileName = filename;
+                groupDataOffsets.resize(count);
+                groupLoaded.reset(new std::atomic<bool>[count]);
+                for (uint32 i = 0; i < count && result; ++i)
+                {
+                    result = groupModels[i].readHeaderFromFile(rf, groupDataOffsets[i]);
+                    groupLoaded[i].store(groupDataOffsets[i] == 0, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                for (uint32 i = 0; i < count && result; ++i)
+                    result = groupModels[i].readFromFile(rf);
+            }
 
             // read group BIH
             if (result && !readChunk(rf, chunk, "GBIH", 4)) result = false;
@@ -602,4 +673,21 @@ namespace VMAP
         fclose(rf);
         return result;
     }
+
+    void WorldModel::loadGroupData(uint32 idx) const
+    {
+        std::lock_guard<std::mutex> lock(groupLoadLock);
+        if (groupLoaded[idx].load(std::memory_order_relaxed))
+            return;
+
+        // a group failing to read stays without geometry, as it would have failed the whole model before
+        if (FILE* rf = fopen(fileName.c_str(), "rb"))
+        {
+            if (fseek(rf, groupDataOffsets[idx], SEEK_SET) == 0)
+                const_cast<GroupModel&>(groupModels[idx]).readDataFromFile(rf);
+            fclose(rf);
+        }
+
+        groupLoaded[idx].store(true, std::memory_order_release);
+    }
 }
@@ -27,6 +27,11 @@
 
 #include "Platform/Define.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace VMAP
 {
     class TreeNode;
@@ -58,6 +63,7 @@ namespace VMAP
             uint32 GetFileSize() const;
             bool writeToFile(FILE* wf);
             static bool readFromFile(FILE* rf, WmoLiquid*& out);
+            static bool skipInFile(FILE* rf);
         private:
             WmoLiquid() : iTilesX(0), iTilesY(0), iType(0), iHeight(nullptr), iFlags(nullptr) {};
             uint32 iTilesX;  //!< number of tiles in x direction, each
@@ -91,6 +97,9 @@ namespace VMAP
             uint32 GetLiquidType() const;
             bool writeToFile(FILE* wf);
             bool readFromFile(FILE* rf);
+            //! reads the bound and flags only; dataOffset is where readDataFromFile reads the geometry, 0 if there is none
+            bool readHeaderFromFile(FILE* rf, long& dataOffset);
+            bool readDataFromFile(FILE* rf);
             const G3D::AABox& GetBound() const { return iBound; }
             uint32 GetMogpFlags() const { return iMogpFlags; }
             uint32 GetWmoID() const { return iGroupWMOID; }
@@ -121,15 +130,32 @@ namespace VMAP
             bool IntersectPoint(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, AreaInfo& info) const;
             bool GetLocationInfo(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, LocationInfo& info) const;
             bool writeFile(const std::string& filename);
-            bool readFile(const std::string& filename);
+            //! with lazyGroups the geometry of a group is read from the file when a query first reaches the group
+            bool readFile(const std::string& filename, bool lazyGroups = false);
             void setModelFlags(uint32 newFlags) { modelFlags = newFlags; }
             uint32 getModelFlags() const { return modelFlags; }
+
+            //! the group with its geometry, safe to call from all threads
+            GroupModel const& getGroupModel(uint32 idx) const
+            {
+                if (groupLoaded && !groupLoaded[idx].load(std::memory_order_acquire))
+                    loadGroupData(idx);
+                return groupModels[idx];
+            }
         protected:
+            void loadGroupData(uint32 idx) const;
+
             uint32 RootWMOID;
             std::vector<GroupModel> groupModels;
             BIH groupTree;
             uint32 modelFlags;
 
+            // lazily read groups only, groupLoaded is null when all groups were read with the file
+            std::string fileName;
+            std::vector<long> groupDataOffsets;
+            std::unique_ptr<std::atomic<bool>[]> groupLoaded;
+            mutable std::mutex groupLoadLock;
+
 #ifdef MMAP_GENERATOR
         public:
             void getGroupModels(std::vector<GroupModel>& outGroupModels);
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/TickProfiler.h"
+#include "Policies/Singleton.h"
+#include "World/World.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <algorithm>
+#include <limits>
+
+void TickProfiler::AddSlowTick(TickSample const& sample)
+{
+    std::lock_guard<std::mutex> guard(m_slowTicksLock);
+    if (m_slowTicks.size() >= TICK_PROFILER_SLOW_TICKS)
+        m_slowTicks.pop_front();
+    m_slowTicks.push_back(sample);
+}
+
+void TickProfiler::GetSlowTicks(std::vector<TickSample>& result, uint32 maxCount) const
+{
+    std::lock_guard<std::mutex> guard(m_slowTicksLock);
+    for (auto itr = m_slowTicks.rbegin(); itr != m_slowTicks.rend() && result.size() < maxCount; ++itr)
+        result.push_back(*itr);
+}
+
+TickProfile::TickProfile(std::string owner) : m_active(false), m_depth(0)
+{
+    m_sample.owner = std::move(owner);
+    m_sample.time = 0;
+    m_sample.duration = 0;
+#ifdef BUILD_METRICS
+    m_metricOwner = m_sample.owner;
+    std::replace(m_metricOwner.begin(), m_metricOwner.end(), ' ', '_');
+#endif
+}
+
+TickProfile::~TickProfile()
+{
+}
+
+void TickProfile::BeginTick()
+{
+    // the setting is only looked at here, a tick is always profiled as a whole
+    m_active = sWorld.GetTickProfiler().IsEnabled();
+    if (!m_active)
+        return;
+
+    m_depth = 0;
+    m_sample.phases.clear();
+    m_phaseStarts.clear();
+    m_tickStart = Clock::now();
+}
+
+uint32 TickProfile::BeginPhase(char const* name)
+{
+    if (!m_active)
+        return std::numeric_limits<uint32>::max();
+
+    m_sample.phases.push_back({ name, m_depth, 0 });
+    m_phaseStarts.push_back(Clock::now());
+    ++m_depth;
+    return m_sample.phases.size() - 1;
+}
+
+void TickProfile::EndPhase(uint32 index)
+{
+    if (!m_active || index >= m_sample.phases.size() || m_phaseStarts[index] == Clock::time_point())
+        return;
+
+    TickPhaseSample& phase = m_sample.phases[index];
+    phase.duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_phaseStarts[index]).count();
+    m_phaseStarts[index] = Clock::time_point();
+    m_depth = phase.depth;
+}
+
+void TickProfile::EndTick()
+{
+    if (!m_active)
+        return;
+
+    // phases still open end with the tick
+    Clock::time_point const now = Clock::now();
+    for (uint32 i = 0; i < m_sample.phases.size(); ++i)
+        if (m_phaseStarts[i] != Clock::time_point())
+            m_sample.phases[i].duration = std::chrono::duration_cast<std::chrono::microseconds>(now - m_phaseStarts[i]).count();
+
+    m_sample.duration = std::chrono::duration_cast<std::chrono::microseconds>(now - m_tickStart).count();
+    m_sample.time = time(nullptr);
+    m_active = false;
+
+#ifdef BUILD_METRICS
+    if (!m_tickMetric)
+        m_tickMetric = std::make_unique<metric::histogram>("tick", std::map<std::string, std::string>{ { "owner", m_metricOwner } });
+    m_tickMetric->sample(m_sample.duration);
+
+    for (TickPhaseSample const& phase : m_sample.phases)
+    {
+        std::unique_ptr<metric::histogram>& phaseMetric = m_phaseMetrics[phase.name];
+        if (!phaseMetric)
+            phaseMetric = std::make_unique<metric::histogram>("tick.phase", std::map<std::string, std::string>{ { "owner", m_metricOwner }, { "phase", phase.name } });
+        phaseMetric->sample(phase.duration);
+    }
+#endif
+
+    TickProfiler& profiler = sWorld.GetTickProfiler();
+    if (profiler.GetSlowTickThreshold() && m_sample.duration >= profiler.GetSlowTickThreshold())
+        profiler.AddSlowTick(m_sample);
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICK_PROFILER_H
+#define MANGOS_TICK_PROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef BUILD_METRICS
+namespace metric
+{
+    class histogram;
+}
+#endif
+
+// ticks kept for .server tickprofile, the oldest slow tick is dropped first
+#define TICK_PROFILER_SLOW_TICKS    32
+
+struct TickPhaseSample
+{
+    char const* name;                                       // string literal given to TickPhase
+    uint32 depth;                                           // 0 for the phases directly in the tick
+    uint32 duration;                                        // microseconds
+};
+
+struct TickSample
+{
+    std::string owner;                                      // "world" or "map <id>/<instance>"
+    time_t time;
+    uint32 duration;                                        // microseconds
+    std::vector<TickPhaseSample> phases;                    // in the order they started, children after their parent
+};
+
+// collects the slow ticks of the world and the maps, filled from the world and the map update threads
+class TickProfiler
+{
+    public:
+        TickProfiler() : m_enabled(false), m_slowTickThreshold(0) {}
+        TickProfiler(const TickProfiler&) = delete;
+
+        void SetEnabled(bool enabled) { m_enabled = enabled; }
+        bool IsEnabled() const { return m_enabled; }
+
+        // microseconds, ticks taking at least this long are kept with their phases
+        void SetSlowTickThreshold(uint32 threshold) { m_slowTickThreshold = threshold; }
+        uint32 GetSlowTickThreshold() const { return m_slowTickThreshold; }
+
+        void AddSlowTick(TickSample const& sample);
+        // newest first
+        void GetSlowTicks(std::vector<TickSample>& result, uint32 maxCount) const;
+
+    private:
+        std::atomic<bool> m_enabled;
+        std::atomic<uint32> m_slowTickThreshold;
+
+        mutable std::mutex m_slowTicksLock;
+        std::deque<TickSample> m_slowTicks;
+};
+
+// phase timing of one ticking owner, only used by the thread updating it
+class TickProfile
+{
+    public:
+        explicit TickProfile(std::string owner);
+        ~TickProfile();
+        TickProfile(const TickProfile&) = delete;
+
+        void BeginTick();
+        void EndTick();
+
+        // index of the started phase, to be given back to EndPhase
+        uint32 BeginPhase(char const* name);
+        void EndPhase(uint32 index);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        bool m_active;                                      // profiler was enabled when the tick began
+        Clock::time_point m_tickStart;
+        uint32 m_depth;
+        TickSample m_sample;                                // reused from tick to tick
+        std::vector<Clock::time_point> m_phaseStarts;
+#ifdef BUILD_METRICS
+        std::string m_metricOwner;                          // owner without blanks, as tag value
+        std::map<char const*, std::unique_ptr<metric::histogram>> m_phaseMetrics;
+        std::unique_ptr<metric::histogram> m_tickMetric;
+#endif
+};
+
+// times the phase until it goes out of scope or the next phase of the same level begins
+class TickPhase
+{
+    public:
+        TickPhase(TickProfile& profile, char const* name) : m_profile(profile), m_index(profile.BeginPhase(name)) {}
+        ~TickPhase() { m_profile.EndPhase(m_index); }
+        TickPhase(const TickPhase&) = delete;
+
+        void Next(char const* name)
+        {
+            m_profile.EndPhase(m_index);
+            m_index = m_profile.BeginPhase(name);
+        }
+
+    private:
+        TickProfile& m_profile;
+        uint32 m_index;
+};
+
+#endif
@@ -35,16 +35,19 @@
 #include "Accounts/AccountMgr.h"
 #include "Achievements/AchievementMgr.h"
 #include "AuctionHouse/AuctionHouseMgr.h"
+#include "AuctionHouse/AuctionHouseSearch.h"
 #include "Globals/ObjectMgr.h"
 #include "AI/EventAI/CreatureEventAIMgr.h"
 #include "Guilds/GuildMgr.h"
 #include "Spells/SpellMgr.h"
+#include "Spells/Spell.h"
 #include "Chat/Chat.h"
 #include "Server/DBCStores.h"
 #include "Mails/MassMailMgr.h"
 #include "Loot/LootMgr.h"
 #include "Entities/ItemEnchantmentMgr.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "DBScripts/ScriptMgr.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "AI/CreatureAIRegistry.h"
@@ -52,6 +55,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "Vmap/VMapFactory.h"
+#include "Vmap/DynamicTree.h"
 #include "MotionGenerators/MoveMap.h"
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
@@ -69,6 +73,7 @@
 #include "World/WorldState.h"
 #include "Cinematics/CinematicMgr.h"
 #include "Maps/TransportMgr.h"
+#include "TraceRecorder.h"
 
 #ifdef BUILD_AHBOT
  #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -85,7 +90,10 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include <mutex>
+#include <thread>
 
 INSTANTIATE_SINGLETON_1(World);
 
@@ -111,7 +119,7 @@ uint32 World::m_averageDiff = 0;
 uint32 World::m_maxDiff = 0;
 
 /// World constructor
-World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0), m_NextWeeklyQuestReset(0), m_NextMonthlyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES)
+World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0), m_NextWeeklyQuestReset(0), m_NextMonthlyQuestReset(0), m_opcodeCounters(NUM_MSG_TYPES), m_tickProfile("world")
 {
     m_playerLimit = 0;
     m_allowMovement = true;
@@ -160,10 +168,16 @@ World::~World()
 /// Cleanups before world stop
 void World::CleanupsBeforeStop()
 {
+    SaveAllPlayersParallel();                        // the bulk of the saves, the kick only writes what the logout changes
     KickAll(true);                                   // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
+    m_sessionUpdater.deactivate();
+    m_chatCommandWorker.deactivate();
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
+    sObjectAccessor.SaveCorpseChanges();             // corpses of the players kicked above
+    sAuctionMgr.GetSearchWorkers().deactivate();     // workers hold snapshots of the auction houses
+    sTicketMgr.SaveTicketChanges();
 }
 
 /// Find a session by its id
@@ -472,6 +486,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_RATE_AUCTION_DEPOSIT, "Rate.Auction.Deposit", 1.0f);
     setConfig(CONFIG_FLOAT_RATE_AUCTION_CUT,     "Rate.Auction.Cut", 1.0f);
     setConfig(CONFIG_UINT32_AUCTION_DEPOSIT_MIN, "Auction.Deposit.Min", SILVER);
+    setConfigMinMax(CONFIG_UINT32_AUCTION_SEARCH_THREADS, "Auction.SearchThreads", 2, 0, 8);
+    setConfigMinMax(CONFIG_UINT32_AUCTION_SNAPSHOT_MAX_AGE, "Auction.SnapshotMaxAge", 1000, 0, 10 * IN_MILLISECONDS);
     setConfig(CONFIG_FLOAT_RATE_HONOR, "Rate.Honor", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_AMOUNT, "Rate.Mining.Amount", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_NEXT,   "Rate.Mining.Next", 1.0f);
@@ -512,11 +528,29 @@ void World::LoadConfigSettings(bool reload)
             m_configForceLoadMapIds.insert(id);
     }
 
+    m_configPrewarmDungeonIds.clear();
+    std::string prewarmMaps = sConfig.GetStringDefault("Instance.PrewarmMaps");
+    if (!prewarmMaps.empty())
+    {
+        unsigned int pos = 0;
+        unsigned int id;
+        VMAP::VMapFactory::chompAndTrim(prewarmMaps);
+        while (VMAP::VMapFactory::getNextId(prewarmMaps, pos, id))
+            m_configPrewarmDungeonIds.insert(id);
+    }
+
+    setConfig(CONFIG_BOOL_TERRAIN_PREFETCH, "Terrain.Prefetch", true);
+    setConfig(CONFIG_BOOL_TERRAIN_MEMORY_MAPPED, "Terrain.MemoryMapped", false);
+    setConfigMinMax(CONFIG_UINT32_TERRAIN_PREFETCH_DISTANCE, "Terrain.PrefetchDistance", 1000, 533, 2133);
+    setConfigMinMax(CONFIG_UINT32_GRID_LOAD_THREADS, "GridLoadThreads", 4, 0, MAX_NUMBER_OF_CELLS);
+    setConfig(CONFIG_UINT32_GRID_UNLOAD_BUDGET, "GridUnloadBudget", 5);
+
     setConfig(CONFIG_BOOL_AUTOLOAD_ACTIVE, "Autoload.Active", true);
 
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
+    setConfig(CONFIG_UINT32_ACHIEVEMENT_PROGRESS_SAVE_MAX_LAG, "PlayerSave.AchievementProgressMaxLag", 0);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
     if (reload)
@@ -526,6 +560,8 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    setConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE, "MapUpdate.IdleInterval", 1000);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -602,6 +638,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_UINT32_INSTANCE_RESET_TIME_HOUR, "Instance.ResetTimeHour", 4);
     setConfig(CONFIG_UINT32_INSTANCE_UNLOAD_DELAY,    "Instance.UnloadDelay", 30 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_INSTANCE_HIBERNATE_DELAY, "Instance.HibernateDelay", 5 * MINUTE * IN_MILLISECONDS);
 
     setConfigMinMax(CONFIG_UINT32_MAX_PRIMARY_TRADE_SKILL, "MaxPrimaryTradeSkill", 2, 0, 10);
 
@@ -647,6 +684,38 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    if (configNoReload(reload, CONFIG_UINT32_NUM_CELL_THREADS, "MapUpdate.CellThreads", 0))
+        setConfig(CONFIG_UINT32_NUM_CELL_THREADS, "MapUpdate.CellThreads", 0);
+    setConfigMin(CONFIG_UINT32_CELL_UPDATE_MIN_CELLS, "MapUpdate.CellMinCount", 64, 4);
+    if (configNoReload(reload, CONFIG_UINT32_NUM_SESSION_THREADS, "SessionUpdate.Threads", 0))
+        setConfig(CONFIG_UINT32_NUM_SESSION_THREADS, "SessionUpdate.Threads", 0);
+    setConfig(CONFIG_UINT32_OPCODE_STATS_SAMPLE_RATE, "OpcodeStats.SampleRate", 0);
+    m_opcodeStats.SetSampleRate(getConfig(CONFIG_UINT32_OPCODE_STATS_SAMPLE_RATE));
+    setConfig(CONFIG_BOOL_TICK_PROFILE, "TickProfile.Enable", false);
+    setConfig(CONFIG_UINT32_TICK_PROFILE_SLOW_TICK, "TickProfile.SlowTickThreshold", 100);
+    m_tickProfiler.SetEnabled(getConfig(CONFIG_BOOL_TICK_PROFILE));
+    m_tickProfiler.SetSlowTickThreshold(getConfig(CONFIG_UINT32_TICK_PROFILE_SLOW_TICK) * IN_MILLISECONDS);
+    if (configNoReload(reload, CONFIG_UINT32_DEBUG_RANDOM_SEED, "Debug.RandomSeed", 0))
+    {
+        setConfig(CONFIG_UINT32_DEBUG_RANDOM_SEED, "Debug.RandomSeed", 0);
+        if (uint32 seed = getConfig(CONFIG_UINT32_DEBUG_RANDOM_SEED))
+            m_random = std::make_unique<RandomEngine>(seed);
+    }
+
+    m_configCellUpdateMaps.clear();
+    std::string cellUpdateMaps = sConfig.GetStringDefault("MapUpdate.CellMaps", "0,1,530,571");
+    VMAP::VMapFactory::chompAndTrim(cellUpdateMaps);
+    for (auto& token : StrSplit(cellUpdateMaps, ","))
+    {
+        Tokens mapData = StrSplit(token, ":");
+        if (mapData.empty())
+            continue;
+
+        uint32 mapId = uint32(atoi(mapData[0].c_str()));
+        uint32 threshold = mapData.size() > 1 ? uint32(atoi(mapData[1].c_str())) : getConfig(CONFIG_UINT32_CELL_UPDATE_MIN_CELLS);
+        m_configCellUpdateMaps[mapId] = std::max(threshold, uint32(4));
+    }
+
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -717,6 +786,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,                     "Corpse.EmptyLootShow",                  true);
     setConfig(CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT, "Corpse.AllowAllItemsShowInMasterLoot", false);
+    setConfig(CONFIG_BOOL_CORPSE_DEFERRED_LOOT,                       "Corpse.DeferredLoot",                   false);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_NORMAL,                      "Corpse.Decay.NORMAL",                    300);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_RARE,                        "Corpse.Decay.RARE",                      900);
     setConfig(CONFIG_UINT32_CORPSE_DECAY_ELITE,                       "Corpse.Decay.ELITE",                     600);
@@ -734,6 +804,8 @@ void World::LoadConfigSettings(bool reload)
 
     setConfigMin(CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY, "CreatureRespawnAggroDelay", 5000, 0);
     setConfig(CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY, "CreaturePickpocketRestockDelay", 600);
+    setConfigMinMax(CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL, "CreatureIdleUpdateInterval", 0, 0, 10000);
+    setConfigMinMax(CONFIG_UINT32_SUMMON_POOL_SIZE, "SummonPoolSize", 64, 0, 1024);
 
     // always use declined names in the russian client
     if (getConfig(CONFIG_UINT32_REALM_ZONE) == REALM_ZONE_RUSSIAN)
@@ -745,6 +817,7 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN,   "Battleground.QueueAnnouncer.Join", 0, 0, 2);
     setConfig(CONFIG_BOOL_BATTLEGROUND_QUEUE_ANNOUNCER_START,          "Battleground.QueueAnnouncer.Start", false);
     setConfig(CONFIG_BOOL_BATTLEGROUND_SCORE_STATISTICS,               "Battleground.ScoreStatistics", false);
+    setConfig(CONFIG_BOOL_BATTLEGROUND_KEEP_TERRAIN_LOADED,            "Battleground.KeepTerrainLoaded", true);
     setConfig(CONFIG_UINT32_BATTLEGROUND_INVITATION_TYPE,              "Battleground.InvitationType", 0);
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMATURE_FINISH_TIMER,       "BattleGround.PrematureFinishTimer", 5 * MINUTE * IN_MILLISECONDS);
     setConfig(CONFIG_UINT32_BATTLEGROUND_PREMADE_GROUP_WAIT_FOR_MATCH, "BattleGround.PremadeGroupWaitForMatch", 30 * MINUTE * IN_MILLISECONDS);
@@ -779,6 +852,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_LFR_EXTEND, "LFR.Extend", false);
     setConfig(CONFIG_BOOL_LFG_ONLYLASTENCOUNTER, "LFG.OnlyLastEncounter", false);
     setConfigMinMax(CONFIG_UINT32_LFG_MAXKICKS, "LFG.MaxKicks", 5, 1, 10);
+    setConfig(CONFIG_UINT32_MATCHMAKING_UPDATE_BUDGET, "Matchmaking.UpdateBudget", 0);
     std::string disabledMapIdForLFG = sConfig.GetStringDefault("LFG.DisableDungeonMapIds", "");
     setDisabledMapIdForDungeonFinder(disabledMapIdForLFG.c_str());
 
@@ -788,8 +862,14 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_MAX_QUEUED_PACKETS, "Network.MaxQueuedPackets", 0);
+    setConfig(CONFIG_UINT32_PACKET_FLOOD_RATE, "Network.PacketFloodRate", 0);
+    setConfig(CONFIG_UINT32_PACKET_FLOOD_BURST, "Network.PacketFloodBurst", 0);
+    if (!getConfig(CONFIG_UINT32_PACKET_FLOOD_BURST))
+        setConfig(CONFIG_UINT32_PACKET_FLOOD_BURST, getConfig(CONFIG_UINT32_PACKET_FLOOD_RATE));
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
+    setConfig(CONFIG_BOOL_ASYNC_COMMANDS, "Command.Async", true);
 
     if (int clientCacheId = sConfig.GetIntDefault("ClientCacheVersion", 0))
     {
@@ -806,6 +886,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_INSTANT_LOGOUT, "InstantLogout", SEC_MODERATOR);
 
     setConfigMin(CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY, "Group.OfflineLeaderDelay", 300, 0);
+    setConfigMinMax(CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL, "Group.MemberStatsInterval", 500, 0, 2000);
 
     setConfigMin(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT, "Guild.EventLogRecordsCount", GUILD_EVENTLOG_MAX_RECORDS, GUILD_EVENTLOG_MAX_RECORDS);
     setConfigMin(CONFIG_UINT32_GUILD_BANK_EVENT_LOG_COUNT, "Guild.BankEventLogRecordsCount", GUILD_BANK_MAX_LOGS, GUILD_BANK_MAX_LOGS);
@@ -822,6 +903,32 @@ void World::LoadConfigSettings(bool reload)
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
     m_relocation_lower_limit_sq = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
 
+    setConfigMin(CONFIG_UINT32_CROWD_VISIBILITY_PLAYERS, "Visibility.Crowd.PlayerCount", 100, 10);
+    setConfigMin(CONFIG_FLOAT_CROWD_VISIBILITY_MIN_DISTANCE, "Visibility.Crowd.MinDistance", 50.0f, 20.0f);
+    setConfigMinMax(CONFIG_UINT32_UPDATE_COALESCE_INTERVAL, "Visibility.UpdateCoalesceInterval", 400, 0, 2000);
+    setConfigMin(CONFIG_FLOAT_UPDATE_COALESCE_DISTANCE, "Visibility.UpdateCoalesceDistance", 40.0f, 5.0f);
+    m_configCrowdVisibilityZones.clear();
+    std::string crowdZones = sConfig.GetStringDefault("Visibility.Crowd.Zones", "4395");
+    VMAP::VMapFactory::chompAndTrim(crowdZones);
+    for (auto& token : StrSplit(crowdZones, ","))
+    {
+        Tokens zoneData = StrSplit(token, ":");
+        if (zoneData.empty())
+            continue;
+
+        uint32 zoneId = uint32(atoi(zoneData[0].c_str()));
+        uint32 threshold = zoneData.size() > 1 ? uint32(atoi(zoneData[1].c_str())) : getConfig(CONFIG_UINT32_CROWD_VISIBILITY_PLAYERS);
+        if (zoneId)
+            m_configCrowdVisibilityZones[zoneId] = std::max(threshold, uint32(10));
+    }
+    setConfig(CONFIG_BOOL_RELOCATION_BATCH, "Visibility.RelocationBatch", true);
+    setConfig(CONFIG_BOOL_AI_NOTIFY_BATCH, "Visibility.AINotifyBatch", true);
+    setConfig(CONFIG_BOOL_MOVEMENT_RELAY_BATCH, "Visibility.MovementRelayBatch", true);
+    setConfig(CONFIG_BOOL_COMBAT_LOG_BATCH, "Visibility.CombatLogBatch", true);
+    setConfig(CONFIG_BOOL_STEALTH_DETECTION_CACHE, "Visibility.StealthDetectionCache", true);
+    setConfigMinMax(CONFIG_UINT32_RELOCATION_BATCH_INTERVAL, "Visibility.RelocationBatchInterval", 0, 0, 1000);
+    setConfigMinMax(CONFIG_UINT32_TRANSPORT_PASSENGER_RELOCATION_INTERVAL, "Visibility.TransportPassengerInterval", 0, 0, 1000);
+
     // Visibility on Continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
     if (m_MaxVisibleDistanceOnContinents < 45 * getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO))
@@ -866,6 +973,8 @@ void World::LoadConfigSettings(bool reload)
     setConfigMinMax(CONFIG_UINT32_CHARDELETE_MIN_LEVEL, "CharDelete.MinLevel", 0, 0, getConfig(CONFIG_UINT32_MAX_PLAYER_LEVEL));
     setConfig(CONFIG_UINT32_CHARDELETE_KEEP_DAYS, "CharDelete.KeepDays", 30);
 
+    setConfig(CONFIG_UINT32_CALENDAR_KEEP_DAYS, "Calendar.KeepDays", 90);
+
     if (configNoReload(reload, CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE, "GuidReserveSize.Creature", 100))
         setConfig(CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,   "GuidReserveSize.Creature",   100);
     if (configNoReload(reload, CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT, "GuidReserveSize.GameObject", 100))
@@ -894,6 +1003,12 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    ///- Directory for world table snapshots, empty disables them
+    std::string cacheDir = sConfig.GetStringDefault("WorldCacheDir", "");
+    if (!cacheDir.empty() && cacheDir.at(cacheDir.length() - 1) != '/' && cacheDir.at(cacheDir.length() - 1) != '\\')
+        cacheDir.append("/");
+    SQLStorageBase::SetCacheDirectory(cacheDir);
+
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
@@ -909,18 +1024,40 @@ void World::LoadConfigSettings(bool reload)
                    enableLOS, enableHeight, getConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK) ? 1 : 0);
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
 
+    setConfigMin(CONFIG_FLOAT_VMAP_DYNAMIC_TREE_REBUILD_LIMIT, "vmap.dynamicTreeRebuildLimit", 1.5f, 0.0f);
+    DynamicMapTree::setRebuildLimit(getConfig(CONFIG_FLOAT_VMAP_DYNAMIC_TREE_REBUILD_LIMIT));
+
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
+    setConfigMinMax(CONFIG_UINT32_MMAP_QUERY_NODES, "mmap.queryNodes", 1024, 128, 65535);
+    setConfig(CONFIG_UINT32_MMAP_PATH_CACHE_SIZE, "mmap.pathCacheSize", 1024);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    setConfig(CONFIG_BOOL_PATH_FIND_ASYNC, "PathFinder.Async", true);
+    setConfig(CONFIG_BOOL_FOLLOW_LEADER_PATH, "PathFinder.FollowLeaderPath", true);
 
     sLog.outString();
 }
 
 /// Initialize the World
+uint32 World::GetCellUpdateThreshold(uint32 mapId) const
+{
+    if (!getConfig(CONFIG_UINT32_NUM_CELL_THREADS))
+        return 0;
+
+    auto itr = m_configCellUpdateMaps.find(mapId);
+    return itr != m_configCellUpdateMaps.end() ? itr->second : 0;
+}
+
+uint32 World::GetCrowdVisibilityThreshold(uint32 zoneId) const
+{
+    auto itr = m_configCrowdVisibilityZones.find(zoneId);
+    return itr != m_configCrowdVisibilityZones.end() ? itr->second : 0;
+}
+
 void World::SetInitialWorldSettings()
 {
     ///- Initialize the random number generator
@@ -1008,18 +1145,23 @@ void World::SetInitialWorldSettings()
     sSpellMgr.LoadSkillRaceClassInfoMap();
 
     ///- Clean up and pack instances
-    sLog.outString("Cleaning up instances...");
-    sMapPersistentStateMgr.CleanupInstances();              // must be called before `creature_respawn`/`gameobject_respawn` tables
-
-    sLog.outString("Packing instances...");
-    sMapPersistentStateMgr.PackInstances();
+    // only the character database is used for it, so it runs beside the template and spell loads below
+    // and is waited for before the guids are set up
+    bool showBars = BarGoLink::GetOutputState();
+    BarGoLink::SetOutputState(false);                       // concurrent bars would mix up on console
+    std::future<void> instanceCleanup = std::async(std::launch::async, []()
+    {
+        CharacterDatabase.ThreadStart();
+        sLog.outString("Cleaning up instances...");
+        sMapPersistentStateMgr.CleanupInstances();          // must be called before `creature_respawn`/`gameobject_respawn` tables
 
-    sLog.outString("Packing groups...");
-    sObjectMgr.PackGroupIds();                              // must be after CleanupInstances
+        sLog.outString("Packing instances...");
+        sMapPersistentStateMgr.PackInstances();
 
-    ///- Init highest guids before any guid using table loading to prevent using not initialized guids in some code.
-    sObjectMgr.SetHighestGuids();                           // must be after PackInstances() and PackGroupIds()
-    sLog.outString();
+        sLog.outString("Packing groups...");
+        sObjectMgr.PackGroupIds();                          // must be after CleanupInstances
+        CharacterDatabase.ThreadEnd();
+    });
 
     sLog.outString("Loading Page Texts...");
     sObjectMgr.LoadPageTexts();
@@ -1038,6 +1180,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Spell Chain Data...");
     sSpellMgr.LoadSpellChains();
 
+    sLog.outString("Deriving Spell Extra Data...");
+    sSpellMgr.LoadSpellInfoExtra();
+
     sLog.outString("Checking Spell Cone Data...");
     sObjectMgr.CheckSpellCones();
 
@@ -1062,6 +1207,13 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Aggro Spells Definitions...");
     sSpellMgr.LoadSpellThreats();
 
+    instanceCleanup.get();
+    BarGoLink::SetOutputState(showBars);
+
+    ///- Init highest guids before any guid using table loading to prevent using not initialized guids in some code.
+    sObjectMgr.SetHighestGuids();                           // must be after PackInstances() and PackGroupIds()
+    sLog.outString();
+
     sLog.outString("Loading NPC Texts...");
     sObjectMgr.LoadGossipText();
 
@@ -1131,6 +1283,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Gameobject Data...");
     sObjectMgr.LoadGameObjects();
 
+    sLog.outString("Packing static spawns by cell...");
+    sObjectMgr.BuildSpawnCellTable();                       // must be after LoadCreatures() and LoadGameObjects()
+
     sLog.outString("Loading SpellsScriptTarget...");
     sSpellMgr.LoadSpellScriptTarget();                      // must be after LoadCreatureTemplates, LoadCreatures and LoadGameobjectInfo
 
@@ -1220,6 +1375,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading taxi flight shortcuts...");
     sObjectMgr.LoadTaxiShortcuts();
 
+    sLog.outString("Building taxi flight splines...");
+    Taxi::LoadSplines();
+
     sLog.outString("Loading spell target destination coordinates...");
     sSpellMgr.LoadSpellTargetPositions();
 
@@ -1254,7 +1412,6 @@ void World::SetInitialWorldSettings()
 
     sLog.outString("Loading Loot Tables...");
     LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
     sLog.outString();
 
     sLog.outString("Loading Skill Discovery Table...");
@@ -1352,6 +1509,7 @@ void World::SetInitialWorldSettings()
     sObjectMgr.LoadQuestgiverGreetingLocales();
     sObjectMgr.LoadTrainerGreetingLocales();                // must be after CreatureInfo loading
     sObjectMgr.LoadBroadcastTextLocales();
+    sObjectMgr.PrecompileGossipMenus();                     // must be after all gossip menu option texts
     sLog.outString(">>> Localization strings loaded");
     sLog.outString();
 
@@ -1362,6 +1520,7 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Auctions...");
     sAuctionMgr.LoadAuctionItems();
     sAuctionMgr.LoadAuctions();
+    sAuctionMgr.GetSearchWorkers().activate(getConfig(CONFIG_UINT32_AUCTION_SEARCH_THREADS));
     sLog.outString(">>> Auctions loaded");
     sLog.outString();
 
@@ -1421,6 +1580,7 @@ void World::SetInitialWorldSettings()
     // Update "uptime" table based on configuration entry in minutes.
     m_timers[WUPDATE_CORPSES].SetInterval(20 * MINUTE * IN_MILLISECONDS);
     m_timers[WUPDATE_DELETECHARS].SetInterval(DAY * IN_MILLISECONDS); // check for chars to delete every day
+    m_timers[WUPDATE_CALENDAR].SetInterval(HOUR * IN_MILLISECONDS);
 
 #ifdef BUILD_AHBOT
     // for AhBot
@@ -1451,6 +1611,12 @@ void World::SetInitialWorldSettings()
     sMapMgr.Initialize();
     sLog.outString();
 
+    if (uint32 sessionThreads = getConfig(CONFIG_UINT32_NUM_SESSION_THREADS))
+        m_sessionUpdater.activate(sessionThreads, THREAD_CLASS_WORLD);
+
+    if (getConfig(CONFIG_BOOL_ASYNC_COMMANDS))
+        m_chatCommandWorker.activate();
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1575,6 +1741,7 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    RandomGeneratorScope randomScope(m_random.get());
     m_currentMSTime = WorldTimer::getMSTime();
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
@@ -1615,6 +1782,14 @@ void World::Update(uint32 diff)
         }
     }
 
+    // ends a running .server trace once its time is over
+    if (TraceRecorder::IsRecording())
+        sTraceRecorder.Update();
+    TraceScope trace("world", "World::Update");
+
+    m_tickProfile.BeginTick();
+    TickPhase phase(m_tickProfile, "timers");
+
     ///- Update the different timers
     for (auto& m_timer : m_timers)
     {
@@ -1627,11 +1802,22 @@ void World::Update(uint32 diff)
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
 
+    ///- Swap in the loot tables reloaded in the background, no map or session thread runs yet
+    phase.Next("reloads");
+    PublishLootReloads();
+
+    phase.Next("messager");
     GetMessager().Execute(this);
 
+    phase.Next("mass_mail");
     ///-Update mass mailer tasks if any
     sMassMailMgr.Update();
 
+    phase.Next("guilds");
+    ///- Send the member events the guilds queued in this update
+    sGuildMgr.Update();
+
+    phase.Next("quest_resets");
     /// Handle daily quests reset time
     if (m_gameTime > m_NextDailyQuestReset)
         ResetDailyQuests();
@@ -1648,6 +1834,7 @@ void World::Update(uint32 diff)
     if (m_gameTime > m_NextRandomBattlegroundReset)
         ResetRandomBattleground();
 
+    phase.Next("auctions");
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
@@ -1665,16 +1852,22 @@ void World::Update(uint32 diff)
         sAuctionMgr.Update();
     }
 
+    ///- Continue the return of old mails started above, one batch per update
+    sObjectMgr.UpdateOldMails();
+
 #ifdef BUILD_AHBOT
+    phase.Next("ahbot");
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
     {
         sAuctionHouseBot.Update();
         m_timers[WUPDATE_AHBOT].Reset();
     }
+    sAuctionHouseBot.UpdateRebuild();
 #endif
 
 #ifdef ENABLE_PLAYERBOTS
+    phase.Next("playerbots");
 #ifndef BUILD_AHBOT
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
@@ -1688,9 +1881,13 @@ void World::Update(uint32 diff)
 #endif
 
     /// <li> Handle session updates
+    phase.Next("sessions");
     auto preSessionTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+    sAuctionMgr.GetSearchWorkers().SendResults();
+    m_chatCommandWorker.SendResults();
     UpdateSessions(diff);
 
+    phase.Next("uptime");
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
@@ -1703,12 +1900,17 @@ void World::Update(uint32 diff)
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
+    phase.Next("maps");
     sMapMgr.Update(diff);
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+    phase.Next("battlegrounds");
     sBattleGroundMgr.Update(diff);
+    phase.Next("outdoor_pvp");
     sOutdoorPvPMgr.Update(diff);
+    phase.Next("world_state");
     sWorldState.Update(diff);
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+    phase.Next("groups");
     ///- Update groups with offline leaders
     if (m_timers[WUPDATE_GROUPS].Passed())
     {
@@ -1720,6 +1922,7 @@ void World::Update(uint32 diff)
         }
     }
 
+    phase.Next("delete_chars");
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
@@ -1727,12 +1930,23 @@ void World::Update(uint32 diff)
         Player::DeleteOldCharacters();
     }
 
+    phase.Next("calendar");
+    ///- Archive the calendar events which have passed the kept window
+    if (m_timers[WUPDATE_CALENDAR].Passed())
+    {
+        m_timers[WUPDATE_CALENDAR].Reset();
+        sCalendarMgr.ArchiveOldEvents();
+    }
+
+    phase.Next("lfg");
     // Check if any group can be created by dungeon finder
     sLFGMgr.Update(diff);
 
+    phase.Next("result_queue");
     // execute callbacks from sql queries that were queued recently
     UpdateResultQueue();
 
+    phase.Next("corpses");
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
@@ -1740,7 +1954,13 @@ void World::Update(uint32 diff)
 
         sObjectAccessor.RemoveOldCorpses();
     }
+    sObjectAccessor.ConvertExpiredCorpses(CORPSE_CONVERSIONS_PER_UPDATE);
+    sObjectAccessor.SaveCorpseChanges();
 
+    phase.Next("tickets");
+    sTicketMgr.SaveTicketChanges();
+
+    phase.Next("game_events");
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
@@ -1750,26 +1970,39 @@ void World::Update(uint32 diff)
         m_timers[WUPDATE_EVENTS].Reset();
     }
 
+    ///- Hand the next batch of the (un)spawns of changed events to the maps
+    sGameEventMgr.UpdatePendingSpawns();
+
 #ifdef BUILD_METRICS
+    phase.Next("metrics");
     if (m_timers[WUPDATE_METRICS].Passed())
     {
         m_timers[WUPDATE_METRICS].Reset();
         GeneratePacketMetrics();
+
+        metric::measurement logMeas("log");
+        logMeas.add_field("dropped", std::to_string(sLog.GetDroppedLines()));
     }
 #endif
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
+    phase.Next("remove_list");
     sMapMgr.RemoveAllObjectsInRemoveList();
 
     // update the instance reset times
+    phase.Next("persistent_states");
     sMapPersistentStateMgr.Update();
 
     // And last, but not least handle the issued cli commands
+    phase.Next("cli");
     ProcessCliCommands();
 
     // cleanup unused GridMap objects as well as VMaps
+    phase.Next("terrain");
     sTerrainMgr.Update(diff);
+    m_tickProfile.EndTick();
+
 #ifdef BUILD_METRICS
     auto updateEndTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     long long total = (updateEndTime - m_currentTime).count();
@@ -1900,8 +2133,9 @@ void World::SendWorldTextToAcceptingTickets(int32 string_id, ...)
 }
 
 /// Sends a packet to all players with optional team and instance restrictions
-void World::SendGlobalMessage(WorldPacket const& packet, uint32 team) const
+void World::SendGlobalMessage(WorldPacket const& data, uint32 team) const
 {
+    SharedWorldPacket packet(data);
     for (const auto& m_session : m_sessions)
     {
         if (WorldSession* session = m_session.second)
@@ -1999,6 +2233,94 @@ void World::KickAll(bool save)
         itr->second->KickPlayer(save, true);
 }
 
+class PlayerSaveWorker : public Worker
+{
+    public:
+        PlayerSaveWorker(std::vector<Player*>&& players, std::atomic<uint32>& saved, MapUpdater& updater) :
+            Worker(updater), m_players(std::move(players)), m_saved(saved)
+        {}
+
+        void execute() override
+        {
+            for (Player* player : m_players)
+            {
+                player->SaveToDB();
+                ++m_saved;
+            }
+            GetWorker().update_finished();
+        }
+
+    private:
+        std::vector<Player*> m_players;
+        std::atomic<uint32>& m_saved;
+};
+
+void World::SaveAllPlayersParallel()
+{
+    // players on their way to another map are saved by their logout, after the transfer
+    std::unordered_map<Map*, std::vector<Player*>> playersByMap;
+    uint32 total = 0;
+    for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+    {
+        Player* player = itr->second->GetPlayer();
+        if (player && player->IsInWorld() && !player->IsBeingTeleportedFar())
+        {
+            playersByMap[player->GetMap()].push_back(player);
+            ++total;
+        }
+    }
+
+    if (!total)
+        return;
+
+    uint32 const startTime = WorldTimer::getMSTime();
+    sLog.outString("Saving %u players...", total);
+
+    // the players of different maps share no rows, their transactions are written side by side
+    CharacterDatabase.BeginParallelCommits();
+
+    std::atomic<uint32> saved(0);
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    if (updater.activated())
+    {
+        for (auto& mapPlayers : playersByMap)
+            updater.schedule_update(new PlayerSaveWorker(std::move(mapPlayers.second), saved, updater));
+
+        uint32 reportTime = WorldTimer::getMSTime();
+        while (saved < total)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (WorldTimer::getMSTimeDiff(reportTime, WorldTimer::getMSTime()) >= IN_MILLISECONDS)
+            {
+                reportTime = WorldTimer::getMSTime();
+                sLog.outString("%u of %u players saved, %u transactions left to write", uint32(saved), total, uint32(CharacterDatabase.GetHolderQueueSize()));
+            }
+        }
+        updater.wait();
+    }
+    else
+    {
+        for (auto& mapPlayers : playersByMap)
+            for (Player* player : mapPlayers.second)
+                player->SaveToDB();
+    }
+
+    // the kick writes through the async connection again, after all saves are in
+    CharacterDatabase.EndParallelCommits();
+    uint32 reportTime = WorldTimer::getMSTime();
+    while (size_t pending = CharacterDatabase.GetHolderQueueSize())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (WorldTimer::getMSTimeDiff(reportTime, WorldTimer::getMSTime()) >= IN_MILLISECONDS)
+        {
+            reportTime = WorldTimer::getMSTime();
+            sLog.outString("%u player transactions left to write", uint32(pending));
+        }
+    }
+
+    sLog.outString("Saved %u players in %u ms", total, WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
 /// Kick (and save) all players with security level less `sec`
 void World::KickAllLess(AccountTypes sec)
 {
@@ -2220,6 +2542,24 @@ void World::ShutdownCancel()
     DEBUG_LOG("Server %s cancelled.", (m_ShutdownMask & SHUTDOWN_MASK_RESTART ? "restart" : "shutdown"));
 }
 
+class SessionUpdateWorker : public Worker
+{
+    public:
+        SessionUpdateWorker(std::vector<WorldSession*>&& sessions, MapUpdater& updater) :
+            Worker(updater), m_sessions(std::move(sessions))
+        {}
+
+        void execute() override
+        {
+            for (WorldSession* session : m_sessions)
+                session->UpdateParallel();
+            GetWorker().update_finished();
+        }
+
+    private:
+        std::vector<WorldSession*> m_sessions;
+};
+
 void World::UpdateSessions(uint32 diff)
 {
     ///- Add new sessions
@@ -2235,12 +2575,35 @@ void World::UpdateSessions(uint32 diff)
 
     }
 
+    ///- Answer the packets needing nothing but their session, spread over the session threads
+    bool const parallel = m_sessionUpdater.activated();
+    if (parallel)
+    {
+        size_t const chunkSize = m_sessions.size() / (getConfig(CONFIG_UINT32_NUM_SESSION_THREADS) * 4) + 1;
+        std::vector<WorldSession*> chunk;
+        for (auto const& itr : m_sessions)
+        {
+            chunk.push_back(itr.second);
+            if (chunk.size() >= chunkSize)
+            {
+                m_sessionUpdater.schedule_update(new SessionUpdateWorker(std::move(chunk), m_sessionUpdater));
+                chunk.clear();
+            }
+        }
+        if (!chunk.empty())
+            m_sessionUpdater.schedule_update(new SessionUpdateWorker(std::move(chunk), m_sessionUpdater));
+        m_sessionUpdater.wait();
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end();)
     {
         ///- and remove not active sessions from the list
         WorldSession* pSession = itr->second;
 
+        if (!parallel)
+            pSession->UpdateParallel();
+
         if (!pSession->Update(diff))
         {
             RemoveQueuedSession(pSession);
@@ -2252,16 +2615,28 @@ void World::UpdateSessions(uint32 diff)
     }
 }
 
-// This handles the issued and queued CLI/RA commands
-void World::ProcessCliCommands()
+void World::QueueCliCommand(const CliCommandHolder* commandHolder)
 {
+    // read only commands run on the worker at once, without waiting for the next world tick
+    if (m_chatCommandWorker.QueueCliCommand(commandHolder))
+        return;
+
     std::lock_guard<std::mutex> guard(m_cliCommandQueueLock);
+    m_cliCommandQueue.push_back(commandHolder);
+}
 
-    while (!m_cliCommandQueue.empty())
+// This handles the issued and queued CLI/RA commands
+void World::ProcessCliCommands()
+{
+    // take the whole batch of the tick, the console, RA and SOAP threads are not blocked while it runs
+    std::deque<const CliCommandHolder*> commands;
     {
-        auto const command = m_cliCommandQueue.front();
-        m_cliCommandQueue.pop_front();
+        std::lock_guard<std::mutex> guard(m_cliCommandQueueLock);
+        commands.swap(m_cliCommandQueue);
+    }
 
+    for (auto const command : commands)
+    {
         DEBUG_LOG("CLI command under processing...");
 
         CliHandler handler(command->m_cliAccountId, command->m_cliAccessLevel, command->m_print);
@@ -2533,6 +2908,7 @@ void World::ResetDailyQuests()
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         if (itr->second->GetPlayer())
             itr->second->GetPlayer()->ResetDailyQuestStatus();
+    sObjectMgr.IncreaseQuestStateVersion();
 
     m_NextDailyQuestReset = time_t(m_NextDailyQuestReset + DAY);
     CharacterDatabase.PExecute("UPDATE saved_variables SET NextDailyQuestResetTime = '" UI64FMTD "'", uint64(m_NextDailyQuestReset));
@@ -2547,6 +2923,7 @@ void World::ResetWeeklyQuests()
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         if (itr->second->GetPlayer())
             itr->second->GetPlayer()->ResetWeeklyQuestStatus();
+    sObjectMgr.IncreaseQuestStateVersion();
 
     m_NextWeeklyQuestReset = time_t(m_NextWeeklyQuestReset + WEEK);
     CharacterDatabase.PExecute("UPDATE saved_variables SET NextWeeklyQuestResetTime = '" UI64FMTD "'", uint64(m_NextWeeklyQuestReset));
@@ -2563,6 +2940,7 @@ void World::ResetMonthlyQuests()
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
         if (itr->second->GetPlayer())
             itr->second->GetPlayer()->ResetMonthlyQuestStatus();
+    sObjectMgr.IncreaseQuestStateVersion();
 
     SetMonthlyQuestResetTime(false);
 }
@@ -2830,18 +3208,62 @@ void World::IncrementOpcodeCounter(uint32 opcodeId)
 #ifdef BUILD_METRICS
 void World::GeneratePacketMetrics()
 {
+    static char const* const processingNames[] = { "inplace", "threadunsafe", "threadsafe", "map_thread", "immediate", "parallel" };
+
     for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
     {
         if (m_opcodeCounters[i] == 0)
             continue;
 
-        metric::measurement meas("world.metrics.packets.received", { {"opcode", opcodeTable[i].name} });
+        metric::measurement meas("world.metrics.packets.received", { {"opcode", opcodeTable[i].name}, {"processing", processingNames[opcodeTable[i].packetProcessing]} });
         meas.add_field("count", std::to_string(static_cast<uint32>(m_opcodeCounters[i])));
 
         // Reset counter
         m_opcodeCounters[i] = 0;
     }
 
+    // opcode costs since the last report, the stats themselves keep counting for .debug opcodestats
+    if (m_reportedOpcodeStats.empty())
+        m_reportedOpcodeStats.resize(NUM_MSG_TYPES);
+
+    std::vector<OpcodeStat> opcodeStats;
+    m_opcodeStats.GetStats(opcodeStats);
+    for (OpcodeStat& stat : opcodeStats)
+    {
+        OpcodeStat& reported = m_reportedOpcodeStats[stat.opcode];
+        if (stat.received < reported.received || stat.sent < reported.sent)
+            reported = OpcodeStat();                        // reset by the command
+
+        OpcodeStat delta = stat;
+        delta.received -= reported.received;
+        delta.bytesIn -= reported.bytesIn;
+        delta.sent -= reported.sent;
+        delta.bytesOut -= reported.bytesOut;
+        delta.sampled -= reported.sampled;
+        delta.waitTime -= reported.waitTime;
+        delta.handlerTime -= reported.handlerTime;
+        for (uint32 j = 0; j < OPCODE_STATS_BUCKETS; ++j)
+            delta.histogram[j] -= reported.histogram[j];
+        reported = stat;
+
+        if (!delta.received && !delta.sent)
+            continue;
+
+        metric::measurement meas("world.metrics.opcodes", { {"opcode", opcodeTable[stat.opcode].name} });
+        meas.add_field("received", std::to_string(delta.received));
+        meas.add_field("bytes_in", std::to_string(delta.bytesIn));
+        meas.add_field("sent", std::to_string(delta.sent));
+        meas.add_field("bytes_out", std::to_string(delta.bytesOut));
+        if (delta.sampled)
+        {
+            meas.add_field("sampled", std::to_string(delta.sampled));
+            meas.add_field("wait", std::to_string(delta.waitTime));
+            meas.add_field("duration", std::to_string(delta.handlerTime));
+            meas.add_field("p50", std::to_string(delta.GetPercentile(0.5f)));
+            meas.add_field("p99", std::to_string(delta.GetPercentile(0.99f)));
+        }
+    }
+
     metric::measurement meas_players("world.metrics.players");
     meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
     meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
@@ -2872,5 +3294,88 @@ void World::GeneratePacketMetrics()
     meas_players.add_field("warlock", std::to_string(GetOnlineClassPlayers(CLASS_WARLOCK)));
     meas_players.add_field("druid", std::to_string(GetOnlineClassPlayers(CLASS_DRUID)));
     meas_players.add_field("deathknight", std::to_string(GetOnlineClassPlayers(CLASS_DEATH_KNIGHT)));
+
+    // async statement backlog of each database
+    std::pair<char const*, Database*> const databases[] = { {"world", &WorldDatabase}, {"character", &CharacterDatabase}, {"login", &LoginDatabase} };
+    for (auto const& database : databases)
+    {
+        metric::measurement meas_db("world.metrics.db.async", { {"database", database.first} });
+        meas_db.add_field("queue", std::to_string(database.second->GetAsyncQueueSize()));
+        meas_db.add_field("lag", std::to_string(database.second->GetAsyncQueueLag()));
+        meas_db.add_field("holders", std::to_string(database.second->GetHolderQueueSize()));
+    }
+
+    MapUpdater::AffinityStats affinityStats;
+    sMapMgr.GetMapUpdater().GetAffinityStats(affinityStats);
+    metric::measurement meas_affinity("world.metrics.map_affinity");
+    meas_affinity.add_field("kept", std::to_string(affinityStats.kept));
+    meas_affinity.add_field("moved", std::to_string(affinityStats.moved));
+    meas_affinity.add_field("stolen", std::to_string(affinityStats.stolen));
+
+    uint64 cacheHits, cacheMisses;
+    uint32 cacheSize;
+    MMAP::MMapFactory::createOrGetMMapManager()->getPathCacheStats(cacheHits, cacheMisses, cacheSize);
+    metric::measurement meas_path_cache("world.metrics.mmap.path_cache");
+    meas_path_cache.add_field("hits", std::to_string(cacheHits));
+    meas_path_cache.add_field("misses", std::to_string(cacheMisses));
+    meas_path_cache.add_field("size", std::to_string(cacheSize));
+
+    uint64 procHolders, procCandidates, procTriggered;
+    Unit::GetProcIndexStats(procHolders, procCandidates, procTriggered);
+    metric::measurement meas_procs("world.metrics.procs");
+    meas_procs.add_field("holders", std::to_string(procHolders));
+    meas_procs.add_field("candidates", std::to_string(procCandidates));
+    meas_procs.add_field("triggered", std::to_string(procTriggered));
+
+    uint64 slabReserved, slabUsed;
+    SlabAllocator::GetStats(slabReserved, slabUsed);
+    metric::measurement meas_slab("world.metrics.slab_allocator");
+    meas_slab.add_field("reserved_bytes", std::to_string(slabReserved));
+    meas_slab.add_field("used_bytes", std::to_string(slabUsed));
+
+    uint64 spellsCreated, spellsSpilledTargets;
+    Spell::GetAllocationStats(spellsCreated, spellsSpilledTargets);
+    metric::measurement meas_spells("world.metrics.spells");
+    meas_spells.add_field("created", std::to_string(spellsCreated));
+    meas_spells.add_field("spilled_target_lists", std::to_string(spellsSpilledTargets));
+
+    for (uint32 i = 0; i < MAX_MEMORY_TAG; ++i)
+    {
+        MemoryAccounting::TagStats tagStats;
+        MemoryAccounting::GetTagStats(MemoryTag(i), tagStats);
+        metric::measurement meas_memory("world.metrics.memory", { {"tag", MemoryAccounting::GetTagName(MemoryTag(i))} });
+        meas_memory.add_field("bytes", std::to_string(tagStats.bytes));
+        meas_memory.add_field("allocations", std::to_string(tagStats.allocations));
+        meas_memory.add_field("total_allocations", std::to_string(tagStats.totalAllocations));
+    }
+
+    MemoryAccounting::AllocatorStats allocatorStats;
+    if (MemoryAccounting::GetAllocatorStats(allocatorStats))
+    {
+        metric::measurement meas_allocator("world.metrics.allocator", { {"backend", MemoryAccounting::GetAllocatorName()} });
+        meas_allocator.add_field("allocated_bytes", std::to_string(allocatorStats.allocatedBytes));
+        meas_allocator.add_field("committed_bytes", std::to_string(allocatorStats.committedBytes));
+        meas_allocator.add_field("resident_bytes", std::to_string(allocatorStats.residentBytes));
+    }
+
+    BufferPool::Stats bufferStats;
+    BufferPool::GetStats(bufferStats);
+    metric::measurement meas_buffers("world.metrics.buffer_pool");
+    meas_buffers.add_field("allocations", std::to_string(bufferStats.allocations));
+    meas_buffers.add_field("heap_allocations", std::to_string(bufferStats.heapAllocations));
+    meas_buffers.add_field("heap_bytes", std::to_string(bufferStats.heapBytes));
+    meas_buffers.add_field("depot_bytes", std::to_string(bufferStats.depotBytes));
+
+    ScriptMgr::CommandStat commandStats[MAX_SCRIPT_COMMAND];
+    sScriptMgr.GetCommandStats(commandStats);
+    for (uint32 i = 0; i < MAX_SCRIPT_COMMAND; ++i)
+    {
+        if (!commandStats[i].count)
+            continue;
+
+        metric::measurement meas("world.metrics.dbscripts", { {"command", std::to_string(i)} });
+        meas.add_field("count", std::to_string(commandStats[i].count));
+        meas.add_field("duration", std::to_string(commandStats[i].time));
+    }
 }
 #endif
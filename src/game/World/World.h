@@ -25,10 +25,16 @@
 
 #include "Common.h"
 #include "Timer.h"
+#include "Util.h"
 #include "Globals/Locales.h"
 #include "Globals/SharedDefines.h"
 #include "Entities/Object.h"
 #include "Multithreading/Messager.h"
+#include "Maps/MapUpdater.h"
+#include "Chat/ChatCommandWorker.h"
+#include "Server/OpcodeStats.h"
+#include "World/TickProfiler.h"
+#include "Entities/PlayerUpdateSchedule.h"
 
 #include <set>
 #include <list>
@@ -86,7 +92,8 @@ enum WorldTimers
     WUPDATE_GROUPS      = 6,
     WUPDATE_WARDEN      = 7, // This is here for headache merge error issues
     WUPDATE_METRICS     = 8, // not used if BUILD_METRICS is not set
-    WUPDATE_COUNT       = 9
+    WUPDATE_CALENDAR    = 9,
+    WUPDATE_COUNT       = 10
 };
 
 /// Configuration elements
@@ -95,7 +102,15 @@ enum eConfigUInt32Values
     CONFIG_UINT32_COMPRESSION = 0,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
+    CONFIG_UINT32_TERRAIN_PREFETCH_DISTANCE,
+    CONFIG_UINT32_GRID_LOAD_THREADS,
+    CONFIG_UINT32_GRID_UNLOAD_BUDGET,
+    CONFIG_UINT32_RELOCATION_BATCH_INTERVAL,
+    CONFIG_UINT32_CROWD_VISIBILITY_PLAYERS,
+    CONFIG_UINT32_UPDATE_COALESCE_INTERVAL,
+    CONFIG_UINT32_TRANSPORT_PASSENGER_RELOCATION_INTERVAL,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -122,6 +137,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_START_ARENA_POINTS,
     CONFIG_UINT32_INSTANCE_RESET_TIME_HOUR,
     CONFIG_UINT32_INSTANCE_UNLOAD_DELAY,
+    CONFIG_UINT32_INSTANCE_HIBERNATE_DELAY,
     CONFIG_UINT32_MAX_SPELL_CASTS_IN_CHAIN,
     CONFIG_UINT32_BIRTHDAY_TIME,
     CONFIG_UINT32_RABBIT_DAY,
@@ -147,7 +163,13 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_NUM_CELL_THREADS,
+    CONFIG_UINT32_NUM_SESSION_THREADS,
+    CONFIG_UINT32_OPCODE_STATS_SAMPLE_RATE,
+    CONFIG_UINT32_CELL_UPDATE_MIN_CELLS,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
+    CONFIG_UINT32_AUCTION_SEARCH_THREADS,
+    CONFIG_UINT32_AUCTION_SNAPSHOT_MAX_AGE,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
     CONFIG_UINT32_SKILL_CHANCE_GREEN,
@@ -159,6 +181,9 @@ enum eConfigUInt32Values
     CONFIG_UINT32_SKILL_GAIN_GATHERING,
     CONFIG_UINT32_SKILL_GAIN_WEAPON,
     CONFIG_UINT32_MAX_OVERSPEED_PINGS,
+    CONFIG_UINT32_MAX_QUEUED_PACKETS,
+    CONFIG_UINT32_PACKET_FLOOD_RATE,
+    CONFIG_UINT32_PACKET_FLOOD_BURST,
     CONFIG_UINT32_EXPANSION,
     CONFIG_UINT32_CHATFLOOD_MESSAGE_COUNT,
     CONFIG_UINT32_CHATFLOOD_MESSAGE_DELAY,
@@ -190,6 +215,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_ARENA_FIRST_RESET_DAY,
     CONFIG_UINT32_ARENA_SEASON_PREVIOUS_ID,
     CONFIG_UINT32_GROUP_OFFLINE_LEADER_DELAY,
+    CONFIG_UINT32_GROUP_MEMBER_STATS_INTERVAL,
     CONFIG_UINT32_BATTLEFIELD_COOLDOWN_DURATION,
     CONFIG_UINT32_BATTLEFIELD_BATTLE_DURATION,
     CONFIG_UINT32_BATTLEFIELD_MAX_PLAYERS_PER_TEAM,
@@ -200,9 +226,11 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,
     CONFIG_UINT32_MIRRORTIMER_ENVIRONMENTAL_MAX,
     CONFIG_UINT32_MIN_LEVEL_STAT_SAVE,
+    CONFIG_UINT32_ACHIEVEMENT_PROGRESS_SAVE_MAX_LAG,
     CONFIG_UINT32_CHARDELETE_KEEP_DAYS,
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
+    CONFIG_UINT32_CALENDAR_KEEP_DAYS,
     CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_MIN_LEVEL_FOR_RAID,
@@ -212,8 +240,15 @@ enum eConfigUInt32Values
     CONFIG_UINT32_FOGOFWAR_HEALTH,
     CONFIG_UINT32_FOGOFWAR_STATS,
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
+    CONFIG_UINT32_CREATURE_IDLE_UPDATE_INTERVAL,
+    CONFIG_UINT32_SUMMON_POOL_SIZE,
     CONFIG_UINT32_CHANNEL_STATIC_AUTO_TRESHOLD,
     CONFIG_UINT32_LFG_MAXKICKS,
+    CONFIG_UINT32_MATCHMAKING_UPDATE_BUDGET,
+    CONFIG_UINT32_MMAP_QUERY_NODES,
+    CONFIG_UINT32_MMAP_PATH_CACHE_SIZE,
+    CONFIG_UINT32_TICK_PROFILE_SLOW_TICK,
+    CONFIG_UINT32_DEBUG_RANDOM_SEED,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -300,6 +335,9 @@ enum eConfigFloatValues
     CONFIG_FLOAT_GROUP_XP_DISTANCE,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_CROWD_VISIBILITY_MIN_DISTANCE,
+    CONFIG_FLOAT_UPDATE_COALESCE_DISTANCE,
+    CONFIG_FLOAT_VMAP_DYNAMIC_TREE_REBUILD_LIMIT,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -307,6 +345,13 @@ enum eConfigFloatValues
 enum eConfigBoolValues
 {
     CONFIG_BOOL_GRID_UNLOAD = 0,
+    CONFIG_BOOL_TERRAIN_PREFETCH,
+    CONFIG_BOOL_TERRAIN_MEMORY_MAPPED,
+    CONFIG_BOOL_RELOCATION_BATCH,
+    CONFIG_BOOL_AI_NOTIFY_BATCH,
+    CONFIG_BOOL_MOVEMENT_RELAY_BATCH,
+    CONFIG_BOOL_COMBAT_LOG_BATCH,
+    CONFIG_BOOL_STEALTH_DETECTION_CACHE,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
@@ -342,6 +387,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_ADDON_CHANNEL,
     CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,
     CONFIG_BOOL_CORPSE_ALLOW_ALL_ITEMS_SHOW_IN_MASTER_LOOT,
+    CONFIG_BOOL_CORPSE_DEFERRED_LOOT,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVP,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVE,
     CONFIG_BOOL_DEATH_BONES_WORLD,
@@ -359,6 +405,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_BATTLEGROUND_CAST_DESERTER,
     CONFIG_BOOL_BATTLEGROUND_QUEUE_ANNOUNCER_START,
     CONFIG_BOOL_BATTLEGROUND_SCORE_STATISTICS,
+    CONFIG_BOOL_BATTLEGROUND_KEEP_TERRAIN_LOADED,
     CONFIG_BOOL_ARENA_AUTO_DISTRIBUTE_POINTS,
     CONFIG_BOOL_ARENA_QUEUE_ANNOUNCER_JOIN,
     CONFIG_BOOL_ARENA_QUEUE_ANNOUNCER_EXIT,
@@ -379,9 +426,12 @@ enum eConfigBoolValues
     CONFIG_BOOL_AUTO_DOWNRANK,
     CONFIG_BOOL_MMAP_ENABLED,
     CONFIG_BOOL_PLAYER_COMMANDS,
+    CONFIG_BOOL_ASYNC_COMMANDS,
     CONFIG_BOOL_AUTOLOAD_ACTIVE,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_PATH_FIND_ASYNC,
+    CONFIG_BOOL_FOLLOW_LEADER_PATH,
     CONFIG_BOOL_LFG_ENABLE,
     CONFIG_BOOL_LFR_ENABLE,
     CONFIG_BOOL_LFG_DEBUG_ENABLE,
@@ -389,6 +439,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_LFG_ONLYLASTENCOUNTER,
     CONFIG_BOOL_RAID_FLAGS_UNIQUE,
     CONFIG_BOOL_COLLECTORS_EDITION,
+    CONFIG_BOOL_TICK_PROFILE,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -605,12 +656,21 @@ class World
 
         /// Get configuration about force-loaded maps
         bool isForceLoadMap(uint32 id) const { return m_configForceLoadMapIds.find(id) != m_configForceLoadMapIds.end(); }
+        /// Get configuration about dungeon maps whose terrain is kept loaded for their instances
+        std::set<uint32> const& GetPrewarmDungeonIds() const { return m_configPrewarmDungeonIds; }
+        /// Get minimal count of active cells required to split the update of this map between cell threads (0 if not allowed)
+        uint32 GetCellUpdateThreshold(uint32 mapId) const;
+        /// Get player count above which the visibility distance of this zone shrinks (0 if not allowed)
+        uint32 GetCrowdVisibilityThreshold(uint32 zoneId) const;
+        bool HasCrowdVisibilityZones() const { return !m_configCrowdVisibilityZones.empty(); }
 
         /// Are we on a "Player versus Player" server?
         bool IsPvPRealm() const { return (getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_PVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_RPPVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP); }
         bool IsFFAPvPRealm() const { return getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP; }
 
         void KickAll(bool save);
+        /// Save the players in world on the map threads, the saves of each map on one thread, before a shutdown kicks them
+        void SaveAllPlayersParallel();
         void KickAllLess(AccountTypes sec);
         void WarnAccount(uint32 accountId, std::string from, std::string reason, const char* type = "WARNING");
         BanReturn BanAccount(BanMode mode, std::string nameOrIP, uint32 duration_secs, std::string reason, const std::string& author);
@@ -626,7 +686,7 @@ class World
         static uint32 GetRelocationAINotifyDelay() { return m_relocation_ai_notify_delay; }
 
         void ProcessCliCommands();
-        void QueueCliCommand(const CliCommandHolder* commandHolder) { std::lock_guard<std::mutex> guard(m_cliCommandQueueLock); m_cliCommandQueue.push_back(commandHolder); }
+        void QueueCliCommand(const CliCommandHolder* commandHolder);
 
         void UpdateResultQueue();
         void InitResultQueue();
@@ -677,6 +737,10 @@ class World
         bool IsDungeonMapIdDisable(uint32 mapId);
 
         void IncrementOpcodeCounter(uint32 opcodeId); // thread safe due to atomics
+        OpcodeStats& GetOpcodeStats() { return m_opcodeStats; } // thread safe due to atomics
+        ChatCommandWorker& GetChatCommandWorker() { return m_chatCommandWorker; }
+        TickProfiler& GetTickProfiler() { return m_tickProfiler; } // thread safe, the slow ticks are locked
+        PlayerUpdateStats& GetPlayerUpdateStats() { return m_playerUpdateStats; } // thread safe due to atomics
     protected:
         void _UpdateGameTime();
         // callback for UpdateRealmCharacters
@@ -784,6 +848,15 @@ class World
         // List of Maps that should be force-loaded on startup
         std::set<uint32> m_configForceLoadMapIds;
 
+        // List of dungeon Maps prewarmed on startup
+        std::set<uint32> m_configPrewarmDungeonIds;
+
+        // List of Maps allowed to update their cells in parallel, with their own active cells threshold
+        std::map<uint32, uint32> m_configCellUpdateMaps;
+
+        // List of zones allowed to shrink their visibility distance when crowded, with their own player threshold
+        std::map<uint32, uint32> m_configCrowdVisibilityZones;
+
         // Vector of quests that were chosen for given group
         std::vector<uint32> m_eventGroupChosen;
 
@@ -799,8 +872,25 @@ class World
 
         Messager<World> m_messager;
 
+        // answers the PROCESS_PARALLEL packets of the sessions (see SessionUpdate.Threads)
+        MapUpdater m_sessionUpdater;
+
+        // runs the read only commands of the sessions (see Command.Async)
+        ChatCommandWorker m_chatCommandWorker;
+
         // Opcode logging
         std::vector<std::atomic<uint32>> m_opcodeCounters;
+        OpcodeStats m_opcodeStats;
+#ifdef BUILD_METRICS
+        std::vector<OpcodeStat> m_reportedOpcodeStats;      // values at the last report, indexed by opcode
+#endif
+        // tick phase timing (see TickProfile.Enable)
+        TickProfiler m_tickProfiler;
+        TickProfile m_tickProfile;
+        // parts of the player updates that ran (see .debug playerupdates)
+        PlayerUpdateStats m_playerUpdateStats;
+
+        std::unique_ptr<RandomEngine> m_random;             // of the world thread while Debug.RandomSeed is set
         // online count logging
         std::array<std::atomic<uint32>, 2> m_onlineTeams;
         std::array<std::atomic<uint32>, MAX_RACES> m_onlineRaces;
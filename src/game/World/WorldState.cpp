@@ -21,10 +21,17 @@
 #include "Maps/MapManager.h"
 #include "Entities/Object.h"
 #include "GameEvents/GameEventMgr.h"
+#include "Server/WorldSession.h"
+#include "Server/Opcodes.h"
+#include "WorldPacket.h"
 #include <algorithm>
 #include <map>
 #include <World/WorldStateDefines.h>
 
+// the zones showing the world states of the events, as filled in FillInitialWorldStates
+static std::vector<uint32> const capitalZoneIds = { ZONEID_STORMWIND_CITY, ZONEID_DARNASSUS, ZONEID_IRONFORGE, ZONEID_ORGRIMMAR, ZONEID_THUNDER_BLUFF, ZONEID_UNDERCITY };
+static std::vector<uint32> const sunsReachZoneIds = { ZONEID_ISLE_OF_QUEL_DANAS, ZONEID_MAGISTERS_TERRACE, ZONEID_SUNWELL_PLATEAU, ZONEID_SHATTRATH };
+
 enum
 {
     GROMGOLUC_EVENT_1   = 15312,
@@ -49,7 +56,6 @@ WorldState::WorldState() : m_emeraldDragonsState(0xF), m_emeraldDragonsTimer(0),
     m_transportStates[GROMGOL_UNDERCITY]    = GROMGOLUC_EVENT_1;
     m_transportStates[GROMGOL_ORGRIMMAR]    = OGUC_EVENT_1;
     m_transportStates[ORGRIMMAR_UNDERCITY]  = GROMGOLOG_EVENT_1;
-    memset(m_loveIsInTheAirData.counters, 0, sizeof(LoveIsInTheAir));
 }
 
 
@@ -98,19 +104,25 @@ void WorldState::Load()
                         uint64 time;
                         try
                         {
-                            loadStream >> m_aqData.m_phase >> time;
+                            uint32 phase;
+                            loadStream >> phase >> time;
+                            m_aqData.m_phase = phase;
                             if (time)
                             {
                                 TimePoint timePoint = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::from_time_t(time));
                                 m_aqData.m_timer = std::chrono::duration_cast<std::chrono::milliseconds>(timePoint - curTime).count();
                             }
                             for (uint32 i = 0; i < RESOURCE_MAX; ++i)
-                                loadStream >> m_aqData.m_WarEffortCounters[i];
+                            {
+                                uint32 counter;
+                                loadStream >> counter;
+                                m_aqData.m_WarEffortCounters[i] = counter;
+                            }
                         }
                         catch (std::exception& e)
                         {
                             sLog.outError("%s", e.what());
-                            memset(m_loveIsInTheAirData.counters, 0, sizeof(LoveIsInTheAir));
+                            m_loveIsInTheAirData.Reset();
                         }
                     }
                     break;
@@ -121,14 +133,21 @@ void WorldState::Load()
                     {
                         try
                         {
-                            loadStream >> m_sunsReachData.m_phase >> m_sunsReachData.m_subphaseMask;
+                            uint32 phase, subphaseMask;
+                            loadStream >> phase >> subphaseMask;
+                            m_sunsReachData.m_phase = phase;
+                            m_sunsReachData.m_subphaseMask = subphaseMask;
                             for (uint32 i = 0; i < COUNTERS_MAX; ++i)
-                                loadStream >> m_sunsReachData.m_sunsReachReclamationCounters[i];
+                            {
+                                uint32 counter;
+                                loadStream >> counter;
+                                m_sunsReachData.m_sunsReachReclamationCounters[i] = counter;
+                            }
                         }
                         catch (std::exception& e)
                         {
                             sLog.outError("%s", e.what());
-                            memset(m_loveIsInTheAirData.counters, 0, sizeof(LoveIsInTheAir));
+                            m_loveIsInTheAirData.Reset();
                         }
                     }
                     break;
@@ -171,16 +190,20 @@ void WorldState::Load()
                         try
                         {
                             for (uint32 i = 0; i < LOVE_LEADER_MAX; ++i)
-                                loadStream >> m_loveIsInTheAirData.counters[i];
+                            {
+                                uint32 counter;
+                                loadStream >> counter;
+                                m_loveIsInTheAirData.counters[i] = counter;
+                            }
                         }
                         catch (std::exception & e)
                         {
                             sLog.outError("%s", e.what());
-                            memset(m_loveIsInTheAirData.counters, 0, sizeof(LoveIsInTheAir));
+                            m_loveIsInTheAirData.Reset();
                         }
                     }
                     else
-                        memset(m_loveIsInTheAirData.counters, 0, sizeof(LoveIsInTheAir));
+                        m_loveIsInTheAirData.Reset();
                     break;
             }
         }
@@ -281,49 +304,49 @@ void WorldState::HandleGameObjectUse(GameObject* go, Unit* user)
         case OBJECT_EVENT_TRAP_THRALL:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_THRALL);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_THRALL), WORLD_STATE_LOVE_IS_IN_THE_AIR_THRALL);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_THRALL), WORLD_STATE_LOVE_IS_IN_THE_AIR_THRALL);
             uint32 hordeSum = GetLoveIsInTheAirCounter(LOVE_LEADER_CAIRNE) + GetLoveIsInTheAirCounter(LOVE_LEADER_THRALL) + GetLoveIsInTheAirCounter(LOVE_LEADER_SYLVANAS);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
+            SendWorldstateUpdate(capitalZoneIds, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
             break;
         }
         case OBJECT_EVENT_TRAP_CAIRNE:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_CAIRNE);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_CAIRNE), WORLD_STATE_LOVE_IS_IN_THE_AIR_CAIRNE);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_CAIRNE), WORLD_STATE_LOVE_IS_IN_THE_AIR_CAIRNE);
             uint32 hordeSum = GetLoveIsInTheAirCounter(LOVE_LEADER_CAIRNE) + GetLoveIsInTheAirCounter(LOVE_LEADER_THRALL) + GetLoveIsInTheAirCounter(LOVE_LEADER_SYLVANAS);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
+            SendWorldstateUpdate(capitalZoneIds, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
             break;
         }
         case OBJECT_EVENT_TRAP_SYLVANAS:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_SYLVANAS);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_SYLVANAS), WORLD_STATE_LOVE_IS_IN_THE_AIR_SYLVANAS);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_SYLVANAS), WORLD_STATE_LOVE_IS_IN_THE_AIR_SYLVANAS);
             uint32 hordeSum = GetLoveIsInTheAirCounter(LOVE_LEADER_CAIRNE) + GetLoveIsInTheAirCounter(LOVE_LEADER_THRALL) + GetLoveIsInTheAirCounter(LOVE_LEADER_SYLVANAS);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
+            SendWorldstateUpdate(capitalZoneIds, hordeSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_HORDE);
             break;
         }
         case OBJECT_EVENT_TRAP_BOLVAR:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_BOLVAR);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_BOLVAR), WORLD_STATE_LOVE_IS_IN_THE_AIR_BOLVAR);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_BOLVAR), WORLD_STATE_LOVE_IS_IN_THE_AIR_BOLVAR);
             uint32 allianceSum = GetLoveIsInTheAirCounter(LOVE_LEADER_BOLVAR) + GetLoveIsInTheAirCounter(LOVE_LEADER_TYRANDE) + GetLoveIsInTheAirCounter(LOVE_LEADER_MAGNI);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
+            SendWorldstateUpdate(capitalZoneIds, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
             break;
         }
         case OBJECT_EVENT_TRAP_MAGNI:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_MAGNI);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_MAGNI), WORLD_STATE_LOVE_IS_IN_THE_AIR_MAGNI);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_MAGNI), WORLD_STATE_LOVE_IS_IN_THE_AIR_MAGNI);
             uint32 allianceSum = GetLoveIsInTheAirCounter(LOVE_LEADER_BOLVAR) + GetLoveIsInTheAirCounter(LOVE_LEADER_TYRANDE) + GetLoveIsInTheAirCounter(LOVE_LEADER_MAGNI);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
+            SendWorldstateUpdate(capitalZoneIds, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
             break;
         }
         case OBJECT_EVENT_TRAP_TYRANDE:
         {
             HandleExternalEvent(CUSTOM_EVENT_LOVE_IS_IN_THE_AIR_LEADER, LOVE_LEADER_TYRANDE);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, GetLoveIsInTheAirCounter(LOVE_LEADER_TYRANDE), WORLD_STATE_LOVE_IS_IN_THE_AIR_TYRANDE);
+            SendWorldstateUpdate(capitalZoneIds, GetLoveIsInTheAirCounter(LOVE_LEADER_TYRANDE), WORLD_STATE_LOVE_IS_IN_THE_AIR_TYRANDE);
             uint32 allianceSum = GetLoveIsInTheAirCounter(LOVE_LEADER_BOLVAR) + GetLoveIsInTheAirCounter(LOVE_LEADER_TYRANDE) + GetLoveIsInTheAirCounter(LOVE_LEADER_MAGNI);
-            SendWorldstateUpdate(m_loveIsInTheAirMutex, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
+            SendWorldstateUpdate(capitalZoneIds, allianceSum, WORLD_STATE_LOVE_IS_IN_THE_AIR_TOTAL_ALLIANCE);
             break;
         }
         default:
@@ -359,25 +382,13 @@ void WorldState::HandleGameObjectRevertState(GameObject* go)
 
 void WorldState::HandlePlayerEnterZone(Player* player, uint32 zoneId)
 {
+    {
+        std::lock_guard<std::mutex> guard(m_subscriberMutex);
+        AddSubscriber(m_zoneSubscribers, zoneId, player);
+    }
+
     switch (zoneId)
     {
-        case ZONEID_STORMWIND_CITY:
-        case ZONEID_DARNASSUS:
-        case ZONEID_IRONFORGE:
-        case ZONEID_ORGRIMMAR:
-        case ZONEID_THUNDER_BLUFF:
-        case ZONEID_UNDERCITY:
-        {
-            {
-                std::lock_guard<std::mutex> guard(m_loveIsInTheAirMutex);
-                m_loveIsInTheAirCapitalsPlayers.push_back(player->GetObjectGuid());
-            }
-            {
-                std::lock_guard<std::mutex> guard(m_aqData.m_warEffortMutex);
-                m_aqData.m_warEffortWorldstatesPlayers.push_back(player->GetObjectGuid());
-            }
-            break;
-        }
         case ZONEID_HELLFIRE_PENINSULA:
         case ZONEID_HELLFIRE_RAMPARTS:
         case ZONEID_HELLFIRE_CITADEL:
@@ -408,8 +419,6 @@ void WorldState::HandlePlayerEnterZone(Player* player, uint32 zoneId)
         case ZONEID_MAGISTERS_TERRACE:
         case ZONEID_SUNWELL_PLATEAU:
         {
-            std::lock_guard<std::mutex> guard(m_sunsReachData.m_sunsReachReclamationMutex);
-            m_sunsReachData.m_sunsReachReclamationPlayers.push_back(player->GetObjectGuid());
             if (zoneId != ZONEID_SUNWELL_PLATEAU && m_sunsReachData.m_subphaseMask == SUBPHASE_ALL)
                 player->CastSpell(nullptr, SPELL_KIRU_SONG_OF_VICTORY, TRIGGERED_OLD_TRIGGERED);
             break;
@@ -421,29 +430,13 @@ void WorldState::HandlePlayerEnterZone(Player* player, uint32 zoneId)
 
 void WorldState::HandlePlayerLeaveZone(Player* player, uint32 zoneId)
 {
+    {
+        std::lock_guard<std::mutex> guard(m_subscriberMutex);
+        RemoveSubscriber(m_zoneSubscribers, zoneId, player->GetObjectGuid());
+    }
+
     switch (zoneId)
     {
-        case ZONEID_STORMWIND_CITY:
-        case ZONEID_DARNASSUS:
-        case ZONEID_IRONFORGE:
-        case ZONEID_ORGRIMMAR:
-        case ZONEID_THUNDER_BLUFF:
-        case ZONEID_UNDERCITY:
-        {
-            {
-                std::lock_guard<std::mutex> guard(m_loveIsInTheAirMutex);
-                auto position = std::find(m_loveIsInTheAirCapitalsPlayers.begin(), m_loveIsInTheAirCapitalsPlayers.end(), player->GetObjectGuid());
-                if (position != m_loveIsInTheAirCapitalsPlayers.end())
-                    m_loveIsInTheAirCapitalsPlayers.erase(position);
-            }
-            {
-                std::lock_guard<std::mutex> guard(m_aqData.m_warEffortMutex);
-                auto position = std::find(m_aqData.m_warEffortWorldstatesPlayers.begin(), m_aqData.m_warEffortWorldstatesPlayers.end(), player->GetObjectGuid());
-                if (position != m_aqData.m_warEffortWorldstatesPlayers.end())
-                    m_aqData.m_warEffortWorldstatesPlayers.erase(position);
-            }
-            break;
-        }
         case ZONEID_HELLFIRE_PENINSULA:
         case ZONEID_HELLFIRE_RAMPARTS:
         case ZONEID_HELLFIRE_CITADEL:
@@ -477,11 +470,7 @@ void WorldState::HandlePlayerLeaveZone(Player* player, uint32 zoneId)
         case ZONEID_MAGISTERS_TERRACE:
         case ZONEID_SUNWELL_PLATEAU:
         {
-            std::lock_guard<std::mutex> guard(m_sunsReachData.m_sunsReachReclamationMutex);
             player->RemoveAurasDueToSpell(SPELL_KIRU_SONG_OF_VICTORY);
-            auto position = std::find(m_sunsReachData.m_sunsReachReclamationPlayers.begin(), m_sunsReachData.m_sunsReachReclamationPlayers.end(), player->GetObjectGuid());
-            if (position != m_sunsReachData.m_sunsReachReclamationPlayers.end())
-                m_sunsReachData.m_sunsReachReclamationPlayers.erase(position);
             break;
         }
         default:
@@ -491,37 +480,42 @@ void WorldState::HandlePlayerLeaveZone(Player* player, uint32 zoneId)
 
 void WorldState::HandlePlayerEnterArea(Player* player, uint32 areaId)
 {
-    switch (areaId)
-    {
-        case AREAID_SKYGUARD_OUTPOST:
-        case AREAID_SHARTUUL_TRANSPORTER:
-        case AREAID_DEATHS_DOOR:
-        case AREAID_THERAMORE_ISLE:
-        {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            m_areaPlayers[areaId].push_back(player->GetObjectGuid());
-            break;
-        }
-        default: break;
-    }
+    std::lock_guard<std::mutex> guard(m_subscriberMutex);
+    AddSubscriber(m_areaSubscribers, areaId, player);
 }
 
 void WorldState::HandlePlayerLeaveArea(Player* player, uint32 areaId)
 {
-    switch (areaId)
+    std::lock_guard<std::mutex> guard(m_subscriberMutex);
+    RemoveSubscriber(m_areaSubscribers, areaId, player->GetObjectGuid());
+}
+
+void WorldState::AddSubscriber(WorldStateSubscriberMap& subscribers, uint32 id, Player* player)
+{
+    std::vector<WorldStateSubscriber>& list = subscribers[id];
+    for (WorldStateSubscriber const& subscriber : list)
+        if (subscriber.guid == player->GetObjectGuid())
+            return;
+
+    list.emplace_back(player->GetObjectGuid(), player->GetSession());
+}
+
+void WorldState::RemoveSubscriber(WorldStateSubscriberMap& subscribers, uint32 id, ObjectGuid guid)
+{
+    auto itr = subscribers.find(id);
+    if (itr == subscribers.end())
+        return;
+
+    std::vector<WorldStateSubscriber>& list = itr->second;
+    for (size_t i = 0; i < list.size(); ++i)
     {
-        case AREAID_SKYGUARD_OUTPOST:
-        case AREAID_SHARTUUL_TRANSPORTER:
-        case AREAID_DEATHS_DOOR:
-        case AREAID_THERAMORE_ISLE:
-        {
-            std::lock_guard<std::mutex> guard(m_mutex);
-            auto position = std::find(m_areaPlayers[areaId].begin(), m_areaPlayers[areaId].end(), player->GetObjectGuid());
-            if (position != m_areaPlayers[areaId].end()) // == myVector.end() means the element was not found
-                m_areaPlayers[areaId].erase(position);
-            break;
-        }
-        default: break;
+        if (list[i].guid != guid)
+            continue;
+
+        // the order does not matter, fill the gap with the last subscriber
+        list[i] = list.back();
+        list.pop_back();
+        return;
     }
 }
 
@@ -635,6 +629,8 @@ void WorldState::HandleExternalEvent(uint32 eventId, uint32 param)
 
 void WorldState::Update(const uint32 diff)
 {
+    SendPendingWorldstateUpdates();
+
     std::lock_guard<std::mutex> guard(m_mutex);
 
     if (m_adalSongOfBattleTimer)
@@ -668,12 +664,35 @@ void WorldState::Update(const uint32 diff)
     }
 }
 
-void WorldState::SendWorldstateUpdate(std::mutex& mutex, uint32 value, uint32 worldStateId)
+void WorldState::SendWorldstateUpdate(std::vector<uint32> const& zoneIds, uint32 value, uint32 worldStateId)
 {
-    std::lock_guard<std::mutex> guard(mutex);
-    for (ObjectGuid& guid : m_loveIsInTheAirCapitalsPlayers)
-        if (Player* player = sObjectMgr.GetPlayer(guid))
-            player->SendUpdateWorldState(worldStateId, value);
+    std::lock_guard<std::mutex> guard(m_subscriberMutex);
+    PendingWorldstateUpdate& update = m_pendingWorldstateUpdates[worldStateId];
+    update.value = value;
+    update.zoneIds = zoneIds;
+}
+
+void WorldState::SendPendingWorldstateUpdates()
+{
+    std::lock_guard<std::mutex> guard(m_subscriberMutex);
+    for (auto const& pending : m_pendingWorldstateUpdates)
+    {
+        WorldPacket data(SMSG_UPDATE_WORLD_STATE, 8);
+        data << uint32(pending.first);
+        data << uint32(pending.second.value);
+
+        SharedWorldPacket packet(data);
+        for (uint32 zoneId : pending.second.zoneIds)
+        {
+            auto itr = m_zoneSubscribers.find(zoneId);
+            if (itr == m_zoneSubscribers.end())
+                continue;
+
+            for (WorldStateSubscriber const& subscriber : itr->second)
+                subscriber.session->SendPacket(packet);
+        }
+    }
+    m_pendingWorldstateUpdates.clear();
 }
 
 void WorldState::BuffAdalsSongOfBattle()
@@ -708,8 +727,20 @@ void WorldState::DispelAdalsSongOfBattle()
 
 void WorldState::ExecuteOnAreaPlayers(uint32 areaId, std::function<void(Player*)> executor)
 {
-    std::lock_guard<std::mutex> guard(m_mutex);
-    for (ObjectGuid guid : m_areaPlayers[areaId])
+    // the executor runs unlocked, it may move players between areas
+    GuidVector guids;
+    {
+        std::lock_guard<std::mutex> guard(m_subscriberMutex);
+        auto itr = m_areaSubscribers.find(areaId);
+        if (itr == m_areaSubscribers.end())
+            return;
+
+        guids.reserve(itr->second.size());
+        for (WorldStateSubscriber const& subscriber : itr->second)
+            guids.push_back(subscriber.guid);
+    }
+
+    for (ObjectGuid guid : guids)
         if (Player* player = sObjectMgr.GetPlayer(guid))
             executor(player);
 }
@@ -846,9 +877,7 @@ void WorldState::AddWarEffortProgress(AQResources resource, uint32 count)
         return;
     m_aqData.m_WarEffortCounters[resource] += count;
     Save(SAVE_ID_AHN_QIRAJ);
-    for (ObjectGuid& guid : m_aqData.m_warEffortWorldstatesPlayers)
-        if (Player* player = sObjectMgr.GetPlayer(guid))
-            player->SendUpdateWorldState(aqWorldstateMap[resource], m_aqData.m_WarEffortCounters[resource]);
+    SendWorldstateUpdate(capitalZoneIds, m_aqData.m_WarEffortCounters[resource], aqWorldstateMap[resource]);
     uint32 id = uint32(resource);
     if (id >= aqWorldStateTotalsMap.size())
         id -= 5;
@@ -1042,7 +1071,7 @@ void WorldState::AddSunsReachProgress(uint32 questId)
     else
         newValue = m_sunsReachData.GetSubPhasePercentage(subPhaseMask);
     if (previousValue != newValue)
-        SendWorldstateUpdate(m_sunsReachData.m_sunsReachReclamationMutex, newValue, worldState);
+        SendWorldstateUpdate(sunsReachZoneIds, newValue, worldState);
 
     bool save = true;
     if (m_sunsReachData.m_sunsReachReclamationCounters[counter] >= COUNTER_MAX_VAL_REQ)
@@ -1133,7 +1162,7 @@ void WorldState::HandleSunsReachPhaseTransition(uint32 newPhase)
             break;
         default: break;
     }
-    SendWorldstateUpdate(m_sunsReachData.m_sunsReachReclamationMutex, m_sunsReachData.m_phase, WORLD_STATE_QUEL_DANAS_MUSIC);
+    SendWorldstateUpdate(sunsReachZoneIds, m_sunsReachData.m_phase, WORLD_STATE_QUEL_DANAS_MUSIC);
 }
 
 void WorldState::HandleSunsReachSubPhaseTransition(int32 subPhaseMask, bool initial)
@@ -1236,14 +1265,23 @@ void WorldState::HandleSunsReachSubPhaseTransition(int32 subPhaseMask, bool init
 
         if (!initial)
         {
-            std::lock_guard<std::mutex> guard(m_sunsReachData.m_sunsReachReclamationMutex);
-            for (ObjectGuid& guid : m_sunsReachData.m_sunsReachReclamationPlayers)
+            std::lock_guard<std::mutex> guard(m_subscriberMutex);
+            for (uint32 zoneId : sunsReachZoneIds)
             {
-                if (Player* player = sObjectMgr.GetPlayer(guid))
+                if (zoneId == ZONEID_SUNWELL_PLATEAU)
+                    continue;
+
+                auto itr = m_zoneSubscribers.find(zoneId);
+                if (itr == m_zoneSubscribers.end())
+                    continue;
+
+                for (WorldStateSubscriber const& subscriber : itr->second)
                 {
-                    if (player->GetZoneId() == ZONEID_SUNWELL_PLATEAU)
+                    Player* player = subscriber.session->GetPlayer();
+                    if (!player)
                         continue;
 
+                    ObjectGuid guid = subscriber.guid;
                     if (start)
                     {
                         player->GetMap()->GetMessager().AddMessage([guid](Map* map) -> void
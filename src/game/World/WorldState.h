@@ -27,6 +27,7 @@
 #include <atomic>
 #include <functional>
 #include <string>
+#include <unordered_map>
 
 enum ZoneIds
 {
@@ -223,14 +224,14 @@ enum AQPhase
 // To be used
 struct AhnQirajData
 {
-    uint32 m_phase;
+    std::atomic<uint32> m_phase;                            // atomics are read without the mutex by the initial world states
     uint64 m_timer;
-    uint32 m_WarEffortCounters[RESOURCE_MAX];
-    GuidVector m_warEffortWorldstatesPlayers;
-    std::mutex m_warEffortMutex;
+    std::atomic<uint32> m_WarEffortCounters[RESOURCE_MAX];
+    std::mutex m_warEffortMutex;                            // guards changes of the progress
     AhnQirajData() : m_phase(PHASE_0_DISABLED), m_timer(0)
     {
-        memset(m_WarEffortCounters, 0, sizeof(m_WarEffortCounters));
+        for (auto& counter : m_WarEffortCounters)
+            counter = 0;
     }
     std::string GetData();
 };
@@ -269,14 +270,14 @@ enum SunsReachCounters
 
 struct SunsReachReclamationData
 {
-    uint32 m_phase;
-    uint32 m_subphaseMask;
-    uint32 m_sunsReachReclamationCounters[COUNTERS_MAX];
-    GuidVector m_sunsReachReclamationPlayers;
-    std::mutex m_sunsReachReclamationMutex;
+    std::atomic<uint32> m_phase;                            // atomics are read without the mutex by the initial world states
+    std::atomic<uint32> m_subphaseMask;
+    std::atomic<uint32> m_sunsReachReclamationCounters[COUNTERS_MAX];
+    std::mutex m_sunsReachReclamationMutex;                 // guards changes of the progress
     SunsReachReclamationData() : m_phase(SUNS_REACH_PHASE_1_STAGING_AREA), m_subphaseMask(0)
     {
-        memset(m_sunsReachReclamationCounters, 0, sizeof(m_sunsReachReclamationCounters));
+        for (auto& counter : m_sunsReachReclamationCounters)
+            counter = 0;
     }
     std::string GetData();
     uint32 GetPhasePercentage(uint32 phase);
@@ -298,9 +299,27 @@ enum LoveIsInTheAirLeaders
 
 struct LoveIsInTheAir
 {
-    uint32 counters[LOVE_LEADER_MAX]; // potential race condition which wont cause anything critical
+    LoveIsInTheAir() { Reset(); }
+    void Reset()
+    {
+        for (auto& counter : counters)
+            counter = 0;
+    }
+
+    std::atomic<uint32> counters[LOVE_LEADER_MAX];
+};
+
+// player subscribed to the world states of its zone or area, with the session the updates are sent to
+struct WorldStateSubscriber
+{
+    WorldStateSubscriber(ObjectGuid _guid, WorldSession* _session) : guid(_guid), session(_session) {}
+
+    ObjectGuid guid;
+    WorldSession* session;
 };
 
+typedef std::unordered_map<uint32 /*zoneId or areaId*/, std::vector<WorldStateSubscriber> > WorldStateSubscriberMap;
+
 // Intended for implementing server wide scripts, note: all behaviour must be safeguarded towards multithreading
 class WorldState
 {
@@ -330,7 +349,8 @@ class WorldState
 
         void Update(const uint32 diff);
 
-        void SendWorldstateUpdate(std::mutex& mutex, uint32 value, uint32 worldStateId);
+        // queues a world state update for the players of the zones, sent on the next Update with the last value queued
+        void SendWorldstateUpdate(std::vector<uint32> const& zoneIds, uint32 value, uint32 worldStateId);
 
         // vanilla section
 
@@ -379,7 +399,22 @@ class WorldState
             ++count;
         }
     private:
-        std::map<uint32, GuidVector> m_areaPlayers;
+        static void AddSubscriber(WorldStateSubscriberMap& subscribers, uint32 id, Player* player);
+        static void RemoveSubscriber(WorldStateSubscriberMap& subscribers, uint32 id, ObjectGuid guid);
+        void SendPendingWorldstateUpdates();
+
+        struct PendingWorldstateUpdate
+        {
+            uint32 value;
+            std::vector<uint32> zoneIds;
+        };
+
+        // players by zone and area, changed on each zone and area change of a player
+        WorldStateSubscriberMap m_zoneSubscribers;
+        WorldStateSubscriberMap m_areaSubscribers;
+        std::map<uint32 /*worldStateId*/, PendingWorldstateUpdate> m_pendingWorldstateUpdates;
+        std::mutex m_subscriberMutex;                       // guards the subscribers and the pending updates only
+
         std::map<uint32, std::atomic<uint32>> m_transportStates; // atomic to avoid having to lock
 
         std::mutex m_mutex; // all World State operations are thread unsafe
@@ -395,9 +430,6 @@ class WorldState
         AhnQirajData m_aqData;
 
         LoveIsInTheAir m_loveIsInTheAirData;
-        GuidVector m_loveIsInTheAirCapitalsPlayers;
-
-        std::mutex m_loveIsInTheAirMutex; // capital cities optimization
 
         // tbc section
         bool m_isMagtheridonHeadSpawnedHorde;
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADTEST_OPCODES_H
+#define MANGOS_LOADTEST_OPCODES_H
+
+// the opcodes the load test speaks, same values as game/Server/Opcodes.h which can not be used without the game library
+enum LoadTestOpcodes
+{
+    CMSG_CHAR_CREATE                    = 0x036,
+    CMSG_CHAR_ENUM                      = 0x037,
+    SMSG_CHAR_CREATE                    = 0x03A,
+    SMSG_CHAR_ENUM                      = 0x03B,
+    CMSG_PLAYER_LOGIN                   = 0x03D,
+    SMSG_NEW_WORLD                      = 0x03E,
+    SMSG_CHARACTER_LOGIN_FAILED         = 0x041,
+    CMSG_LOGOUT_REQUEST                 = 0x04B,
+    MSG_MOVE_START_FORWARD              = 0x0B5,
+    MSG_MOVE_STOP                       = 0x0B7,
+    MSG_MOVE_TELEPORT_ACK               = 0x0C7,
+    MSG_MOVE_WORLDPORT_ACK              = 0x0DC,
+    MSG_MOVE_HEARTBEAT                  = 0x0EE,
+    CMSG_QUERY_TIME                     = 0x1CE,
+    SMSG_QUERY_TIME_RESPONSE            = 0x1CF,
+    CMSG_PING                           = 0x1DC,
+    SMSG_PONG                           = 0x1DD,
+    SMSG_AUTH_CHALLENGE                 = 0x1EC,
+    CMSG_AUTH_SESSION                   = 0x1ED,
+    SMSG_AUTH_RESPONSE                  = 0x1EE,
+    SMSG_LOGIN_VERIFY_WORLD             = 0x236,
+    SMSG_TIME_SYNC_REQ                  = 0x390,
+    CMSG_TIME_SYNC_RESP                 = 0x391,
+    CMSG_KEEP_ALIVE                     = 0x407,
+};
+
+// SMSG_AUTH_RESPONSE, SMSG_CHAR_CREATE
+#define LOADTEST_AUTH_OK                0x0C
+#define LOADTEST_AUTH_WAIT_QUEUE        0x1B
+#define LOADTEST_CHAR_CREATE_SUCCESS    0x2F
+
+#define LOADTEST_CLIENT_BUILD           12340
+#define LOADTEST_MOVEFLAG_FORWARD       0x00000001
+
+#endif
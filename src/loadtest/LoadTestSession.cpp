@@ -0,0 +1,869 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadTestSession.h"
+#include "LoadTestOpcodes.h"
+#include "LoadTestStats.h"
+#include "PacketCapture.h"
+#include "Auth/HMACSHA1.h"
+#include "Auth/Sha1.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// in milliseconds
+#define LOADTEST_UPDATE_INTERVAL    50
+#define LOADTEST_MOVE_INTERVAL      500
+
+#define LOADTEST_WALK_RADIUS        10.0f
+#define LOADTEST_WALK_SPEED         7.0f                    // run speed of a player, yards per second
+
+#define LOADTEST_READ_SIZE          4096
+
+namespace
+{
+    // realm server commands, see realmd/AuthCodes.h
+    enum
+    {
+        CMD_AUTH_LOGON_CHALLENGE    = 0x00,
+        CMD_AUTH_LOGON_PROOF        = 0x01,
+    };
+
+    // B, g, N, s, version challenge and security flags following the result of the challenge
+    size_t const LOGON_CHALLENGE_SIZE = 32 + 1 + 1 + 1 + 32 + 32 + 16 + 1;
+    // after command and error of a successful proof
+    size_t const LOGON_PROOF_SIZE = 20 + 4 + 4 + 2;
+
+    // replaces the guid of the captured character, as packed or plain guid at the start of the packet
+    void ReplaceGuid(ByteBuffer& data, uint64 capturedGuid, uint64 guid)
+    {
+        if (data.empty())
+            return;
+
+        uint8 const mask = data.contents()[0];
+        size_t packedSize = 1;
+        uint64 packedGuid = 0;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            if (!(mask & (1 << i)))
+                continue;
+
+            if (packedSize >= data.size())
+                return;
+
+            packedGuid |= uint64(data.contents()[packedSize++]) << (i * 8);
+        }
+
+        if (packedGuid == capturedGuid)
+        {
+            ByteBuffer replaced;
+            replaced.appendPackGUID(guid);
+            replaced.append(data.contents() + packedSize, data.size() - packedSize);
+            data = replaced;
+        }
+        else if (data.size() >= sizeof(uint64) && data.read<uint64>(0) == capturedGuid)
+            data.put<uint64>(0, guid);
+    }
+}
+
+LoadTestCrypt::LoadTestCrypt() : m_decrypt(SHA_DIGEST_LENGTH), m_encrypt(SHA_DIGEST_LENGTH), m_initialized(false)
+{
+}
+
+void LoadTestCrypt::Init(BigNumber* K)
+{
+    // the keys of game/Server/AuthCrypt.cpp the other way round
+    uint8 serverEncryptionKey[SEED_KEY_SIZE] = { 0xCC, 0x98, 0xAE, 0x04, 0xE8, 0x97, 0xEA, 0xCA, 0x12, 0xDD, 0xC0, 0x93, 0x42, 0x91, 0x53, 0x57 };
+    uint8 serverDecryptionKey[SEED_KEY_SIZE] = { 0xC2, 0xB3, 0x72, 0x3C, 0xC6, 0xAE, 0xD9, 0xB5, 0x34, 0x3C, 0x53, 0xEE, 0x2F, 0x43, 0x67, 0xCE };
+
+    HMACSHA1 decryptHmac(SEED_KEY_SIZE, serverEncryptionKey);
+    m_decrypt.Init(decryptHmac.ComputeHash(K));
+
+    HMACSHA1 encryptHmac(SEED_KEY_SIZE, serverDecryptionKey);
+    m_encrypt.Init(encryptHmac.ComputeHash(K));
+
+    uint8 syncBuf[1024];
+    memset(syncBuf, 0, sizeof(syncBuf));
+    m_decrypt.UpdateData(sizeof(syncBuf), syncBuf);
+    memset(syncBuf, 0, sizeof(syncBuf));
+    m_encrypt.UpdateData(sizeof(syncBuf), syncBuf);
+
+    m_initialized = true;
+}
+
+void LoadTestCrypt::DecryptRecv(uint8* data, size_t len)
+{
+    if (m_initialized)
+        m_decrypt.UpdateData(len, data);
+}
+
+void LoadTestCrypt::EncryptSend(uint8* data, size_t len)
+{
+    if (m_initialized)
+        m_encrypt.UpdateData(len, data);
+}
+
+LoadTestSession::LoadTestSession(boost::asio::io_service& service, LoadTestConfig const& config, LoadTestStats& stats, uint32 index) :
+    m_service(service), m_socket(service), m_timer(service), m_config(config), m_stats(stats), m_index(index), m_state(STATE_REALM_CHALLENGE),
+    m_random(config.seed + index), m_inPos(0), m_headerSize(0), m_headerFirstByte(false), m_packetSize(0), m_packetOpcode(0), m_writePending(false),
+    m_pingPending(false), m_pingCount(0), m_nextPing(0), m_queryPending(false), m_nextQuery(0),
+    m_guid(0), m_mapId(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_o(0.0f), m_startX(0.0f), m_startY(0.0f), m_angle(0.0f), m_nextMove(0), m_lastMove(0),
+    m_stream(nullptr), m_streamIndex(0), m_streamStart(0)
+{
+    m_account = config.accountPrefix + std::to_string(index);
+    std::transform(m_account.begin(), m_account.end(), m_account.begin(), ::toupper);
+}
+
+void LoadTestSession::Start()
+{
+    m_started = Clock::now();
+    m_stats.AddConnecting();
+    ConnectRealm();
+}
+
+void LoadTestSession::Close()
+{
+    if (m_state == STATE_CLOSED)
+        return;
+
+    m_state = STATE_CLOSED;
+    m_timer.cancel();
+
+    boost::system::error_code error;
+    m_socket.close(error);
+}
+
+void LoadTestSession::Fail(char const* reason)
+{
+    if (m_state == STATE_CLOSED)
+        return;
+
+    printf("%s: %s\n", m_account.c_str(), reason);
+    m_stats.AddFailed(m_state == STATE_IN_WORLD);
+    Close();
+}
+
+uint32 LoadTestSession::GetMSTime() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_started).count();
+}
+
+uint32 LoadTestSession::GetElapsed(Clock::time_point since) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count();
+}
+
+void LoadTestSession::ConnectRealm()
+{
+    auto self(shared_from_this());
+    m_socket.async_connect(m_config.realmEndpoint, [this, self](boost::system::error_code const& error)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("can not connect to the realm server");
+
+        SendLogonChallenge();
+    });
+}
+
+void LoadTestSession::SendLogonChallenge()
+{
+    ByteBuffer packet;
+    packet << uint8(CMD_AUTH_LOGON_CHALLENGE);
+    packet << uint8(3);
+    packet << uint16(30 + m_account.length());
+    packet.append("WoW", 4);
+    packet << uint8(3) << uint8(3) << uint8(5);
+    packet << uint16(LOADTEST_CLIENT_BUILD);
+    // the client sends these as reversed four character codes
+    packet.append("68x", 4);
+    packet.append("niW", 4);
+    packet.append("SUne", 4);
+    packet << uint32(0);                                    // timezone
+    packet << uint32(0x0100007F);                           // 127.0.0.1
+    packet << uint8(m_account.length());
+    packet.append(m_account.c_str(), m_account.length());
+
+    m_requestSent = Clock::now();
+    m_out.assign(packet.contents(), packet.contents() + packet.size());
+
+    auto self(shared_from_this());
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_out), [this, self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("realm server closed the connection");
+
+        ReadLogonChallenge();
+    });
+}
+
+void LoadTestSession::ReadLogonChallenge()
+{
+    m_in.resize(3 + LOGON_CHALLENGE_SIZE);
+
+    auto self(shared_from_this());
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_in.data(), 3), [this, self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("realm server closed the connection");
+
+        if (m_in[0] != CMD_AUTH_LOGON_CHALLENGE || m_in[2] != 0)
+            return Fail("logon challenge refused, does the account exist?");
+
+        boost::asio::async_read(m_socket, boost::asio::buffer(m_in.data() + 3, LOGON_CHALLENGE_SIZE), [this, self](boost::system::error_code const& error, size_t /*length*/)
+        {
+            if (m_state == STATE_CLOSED)
+                return;
+
+            if (error)
+                return Fail("realm server closed the connection");
+
+            // pin, matrix and authenticator input are not supported
+            if (m_in[3 + LOGON_CHALLENGE_SIZE - 1] != 0)
+                return Fail("account requires an authenticator");
+
+            SendLogonProof(m_in.data() + 3);
+        });
+    });
+}
+
+void LoadTestSession::SendLogonProof(uint8 const* data)
+{
+    m_state = STATE_REALM_PROOF;
+
+    BigNumber B, g, N, s;
+    B.SetBinary(data, 32);
+    g.SetBinary(data + 33, 1);
+    N.SetBinary(data + 35, 32);
+    s.SetBinary(data + 67, 32);
+
+    BigNumber a;
+    a.SetRand(19 * 8);
+    BigNumber A = g.ModExp(a, N);
+
+    std::string password = m_config.password.empty() ? m_account : m_config.password;
+    std::transform(password.begin(), password.end(), password.begin(), ::toupper);
+
+    // the same verifier as AccountMgr::CreateAccount and SRP6::CalculateVerifier
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData(":");
+    sha.UpdateData(password);
+    sha.Finalize();
+    uint8 passwordHash[SHA_DIGEST_LENGTH];
+    memcpy(passwordHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(passwordHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &B, nullptr);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    // S = (B - 3 * g^x) ^ (a + u * x) % N, B is below N so adding N keeps the base positive
+    BigNumber three;
+    three.SetDword(3);
+    BigNumber kgx = (three * g.ModExp(x, N)) % N;
+    BigNumber base = (B + N) - kgx;
+    BigNumber S = base.ModExp(a + u * x, N);
+
+    // strong session key, see SRP6::HashSessionKey
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+    m_K.SetBinary(vK, 40);
+
+    // proof, see SRP6::CalculateProof
+    uint8 hash[SHA_DIGEST_LENGTH];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, nullptr);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, nullptr);
+    sha.Finalize();
+    for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+    BigNumber t3;
+    t3.SetBinary(hash, SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(m_account);
+    sha.Finalize();
+    uint8 accountHash[SHA_DIGEST_LENGTH];
+    memcpy(accountHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, nullptr);
+    sha.UpdateData(accountHash, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &m_K, nullptr);
+    sha.Finalize();
+
+    ByteBuffer packet;
+    packet << uint8(CMD_AUTH_LOGON_PROOF);
+    packet.append(A.AsByteArray(32), 32);
+    packet.append(sha.GetDigest(), SHA_DIGEST_LENGTH);
+    uint8 const crcHash[SHA_DIGEST_LENGTH] = {};
+    packet.append(crcHash, SHA_DIGEST_LENGTH);
+    packet << uint8(0);                                     // number of keys
+    packet << uint8(0);                                     // security flags
+
+    m_out.assign(packet.contents(), packet.contents() + packet.size());
+
+    auto self(shared_from_this());
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_out), [this, self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("realm server closed the connection");
+
+        ReadLogonProof();
+    });
+}
+
+void LoadTestSession::ReadLogonProof()
+{
+    m_in.resize(2 + LOGON_PROOF_SIZE);
+
+    auto self(shared_from_this());
+    boost::asio::async_read(m_socket, boost::asio::buffer(m_in.data(), 2), [this, self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("realm server closed the connection");
+
+        if (m_in[0] != CMD_AUTH_LOGON_PROOF || m_in[1] != 0)
+            return Fail("wrong password");
+
+        boost::asio::async_read(m_socket, boost::asio::buffer(m_in.data() + 2, LOGON_PROOF_SIZE), [this, self](boost::system::error_code const& error, size_t /*length*/)
+        {
+            if (m_state == STATE_CLOSED)
+                return;
+
+            if (error)
+                return Fail("realm server closed the connection");
+
+            m_stats.AddLatency(LATENCY_REALM_LOGON, GetElapsed(m_requestSent));
+
+            // the realm list is skipped, the world server is given on the command line
+            boost::system::error_code closeError;
+            m_socket.close(closeError);
+            m_in.clear();
+            m_out.clear();
+            ConnectWorld();
+        });
+    });
+}
+
+void LoadTestSession::ConnectWorld()
+{
+    m_state = STATE_WORLD_AUTH;
+
+    auto self(shared_from_this());
+    m_socket.async_connect(m_config.worldEndpoint, [this, self](boost::system::error_code const& error)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("can not connect to the world server");
+
+        boost::asio::ip::tcp::no_delay option(true);
+        boost::system::error_code optionError;
+        m_socket.set_option(option, optionError);
+
+        Read();
+    });
+}
+
+void LoadTestSession::Read()
+{
+    size_t const used = m_in.size();
+    m_in.resize(used + LOADTEST_READ_SIZE);
+
+    auto self(shared_from_this());
+    m_socket.async_read_some(boost::asio::buffer(m_in.data() + used, LOADTEST_READ_SIZE), [this, self, used](boost::system::error_code const& error, size_t length)
+    {
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("world server closed the connection");
+
+        m_in.resize(used + length);
+        if (!ProcessIncoming())
+            return;
+
+        Read();
+    });
+}
+
+bool LoadTestSession::ProcessIncoming()
+{
+    while (true)
+    {
+        size_t const available = m_in.size() - m_inPos;
+        uint8* header = m_in.data() + m_inPos;
+
+        if (!m_headerSize)
+        {
+            // the header is decrypted in place, only once
+            if (available < 4)
+                break;
+
+            if (!m_headerFirstByte)
+            {
+                m_crypt.DecryptRecv(header, 1);
+                m_headerFirstByte = true;
+            }
+
+            uint32 const headerSize = (header[0] & 0x80) ? 5 : 4;
+            if (available < headerSize)
+                break;
+
+            m_crypt.DecryptRecv(header + 1, headerSize - 1);
+            m_headerFirstByte = false;
+
+            uint32 const size = headerSize == 5 ? (uint32(header[0] & 0x7F) << 16) | (uint32(header[1]) << 8) | header[2] : (uint32(header[0]) << 8) | header[1];
+            if (size < 2)
+            {
+                Fail("world server sent a malformed packet");
+                return false;
+            }
+
+            m_headerSize = headerSize;
+            m_packetSize = size - 2;
+            m_packetOpcode = header[headerSize - 2] | (header[headerSize - 1] << 8);
+        }
+
+        if (available < m_headerSize + m_packetSize)
+            break;
+
+        ByteBuffer packet(m_packetSize);
+        if (m_packetSize)
+            packet.append(header + m_headerSize, m_packetSize);
+
+        m_stats.AddReceived(m_headerSize + m_packetSize);
+        m_inPos += m_headerSize + m_packetSize;
+        m_headerSize = 0;
+
+        if (!HandlePacket(m_packetOpcode, packet))
+            return false;
+    }
+
+    m_in.erase(m_in.begin(), m_in.begin() + m_inPos);
+    m_inPos = 0;
+    return true;
+}
+
+void LoadTestSession::SendPacket(uint16 opcode, ByteBuffer const& payload)
+{
+    uint8 header[6];
+    uint16 const size = payload.size() + 4;
+    header[0] = size >> 8;
+    header[1] = size & 0xFF;
+    header[2] = opcode & 0xFF;
+    header[3] = opcode >> 8;
+    header[4] = 0;
+    header[5] = 0;
+    m_crypt.EncryptSend(header, sizeof(header));
+
+    m_out.insert(m_out.end(), header, header + sizeof(header));
+    if (!payload.empty())
+        m_out.insert(m_out.end(), payload.contents(), payload.contents() + payload.size());
+
+    m_stats.AddSent(sizeof(header) + payload.size());
+    Flush();
+}
+
+void LoadTestSession::Flush()
+{
+    if (m_writePending || m_out.empty())
+        return;
+
+    m_writing.swap(m_out);
+    m_writePending = true;
+
+    auto self(shared_from_this());
+    boost::asio::async_write(m_socket, boost::asio::buffer(m_writing), [this, self](boost::system::error_code const& error, size_t /*length*/)
+    {
+        m_writePending = false;
+        m_writing.clear();
+
+        if (m_state == STATE_CLOSED)
+            return;
+
+        if (error)
+            return Fail("world server closed the connection");
+
+        Flush();
+    });
+}
+
+bool LoadTestSession::HandlePacket(uint16 opcode, ByteBuffer& packet)
+{
+    try
+    {
+        switch (opcode)
+        {
+            case SMSG_AUTH_CHALLENGE:
+                HandleAuthChallenge(packet);
+                break;
+            case SMSG_AUTH_RESPONSE:
+            {
+                uint8 result;
+                packet >> result;
+                if (result == LOADTEST_AUTH_WAIT_QUEUE)
+                    break;
+
+                if (result != LOADTEST_AUTH_OK)
+                {
+                    Fail("world server refused the session");
+                    return false;
+                }
+
+                m_stats.AddLatency(LATENCY_WORLD_AUTH, GetElapsed(m_requestSent));
+                m_state = STATE_CHARACTERS;
+                m_requestSent = Clock::now();
+                SendPacket(CMSG_CHAR_ENUM, ByteBuffer());
+                break;
+            }
+            case SMSG_CHAR_ENUM:
+                return HandleCharEnum(packet);
+            case SMSG_CHAR_CREATE:
+            {
+                uint8 result;
+                packet >> result;
+                if (result != LOADTEST_CHAR_CREATE_SUCCESS)
+                {
+                    Fail("character creation failed");
+                    return false;
+                }
+
+                m_requestSent = Clock::now();
+                SendPacket(CMSG_CHAR_ENUM, ByteBuffer());
+                break;
+            }
+            case SMSG_LOGIN_VERIFY_WORLD:
+                EnterWorld(packet);
+                break;
+            case SMSG_CHARACTER_LOGIN_FAILED:
+                Fail("character login failed");
+                return false;
+            case SMSG_NEW_WORLD:
+                packet >> m_mapId >> m_x >> m_y >> m_z >> m_o;
+                SendPacket(MSG_MOVE_WORLDPORT_ACK, ByteBuffer());
+                break;
+            case MSG_MOVE_TELEPORT_ACK:
+            {
+                uint64 guid = packet.readPackGUID();
+                uint32 counter, moveFlags, time;
+                uint16 moveFlags2;
+                packet >> counter >> moveFlags >> moveFlags2 >> time >> m_x >> m_y >> m_z >> m_o;
+
+                ByteBuffer data;
+                data.appendPackGUID(guid);
+                data << counter;
+                data << GetMSTime();
+                SendPacket(MSG_MOVE_TELEPORT_ACK, data);
+                break;
+            }
+            case SMSG_TIME_SYNC_REQ:
+            {
+                uint32 counter;
+                packet >> counter;
+
+                ByteBuffer data;
+                data << counter;
+                data << GetMSTime();
+                SendPacket(CMSG_TIME_SYNC_RESP, data);
+                break;
+            }
+            case SMSG_PONG:
+                if (m_pingPending)
+                {
+                    m_stats.AddLatency(LATENCY_PING, GetElapsed(m_pingSent));
+                    m_pingPending = false;
+                }
+                break;
+            case SMSG_QUERY_TIME_RESPONSE:
+                if (m_queryPending)
+                {
+                    m_stats.AddLatency(LATENCY_QUERY_TIME, GetElapsed(m_querySent));
+                    m_queryPending = false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    catch (ByteBufferException const&)
+    {
+        Fail("world server sent a packet shorter than expected");
+        return false;
+    }
+
+    return true;
+}
+
+void LoadTestSession::HandleAuthChallenge(ByteBuffer& packet)
+{
+    uint32 serverSeed;
+    packet.read_skip<uint32>();
+    packet >> serverSeed;
+
+    uint32 clientSeed = m_random();
+    uint32 zero = 0;
+
+    // see WorldSocket::HandleAuthSession
+    Sha1Hash sha;
+    sha.UpdateData(m_account);
+    sha.UpdateData((uint8*)&zero, 4);
+    sha.UpdateData((uint8*)&clientSeed, 4);
+    sha.UpdateData((uint8*)&serverSeed, 4);
+    sha.UpdateBigNumbers(&m_K, nullptr);
+    sha.Finalize();
+
+    ByteBuffer data;
+    data << uint32(LOADTEST_CLIENT_BUILD);
+    data << uint32(0);
+    data << m_account;
+    data << uint32(0);
+    data << clientSeed;
+    data << uint32(0);                                      // region
+    data << uint32(0);                                      // battlegroup
+    data << uint32(m_config.realmId);
+    data << uint64(0);                                      // dos response
+    data.append(sha.GetDigest(), SHA_DIGEST_LENGTH);
+    data << uint32(0);                                      // no addon info
+
+    m_requestSent = Clock::now();
+    SendPacket(CMSG_AUTH_SESSION, data);
+
+    // the session packet itself goes out unencrypted
+    m_crypt.Init(&m_K);
+}
+
+bool LoadTestSession::HandleCharEnum(ByteBuffer& packet)
+{
+    uint8 count;
+    packet >> count;
+    if (!count)
+    {
+        if (!m_config.createCharacters)
+        {
+            Fail("account has no character");
+            return false;
+        }
+
+        // letters only, unique per account index
+        std::string name = "Lt";
+        for (uint32 i = 0, index = m_index; i < 5; ++i, index /= 26)
+            name.push_back('a' + index % 26);
+
+        ByteBuffer data;
+        data << name;
+        data << uint8(1);                                   // human
+        data << uint8(1);                                   // warrior
+        data << uint8(0);                                   // gender
+        data << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0);
+        data << uint8(0);                                   // outfit
+        SendPacket(CMSG_CHAR_CREATE, data);
+        return true;
+    }
+
+    m_stats.AddLatency(LATENCY_CHAR_ENUM, GetElapsed(m_requestSent));
+
+    packet >> m_guid;
+
+    ByteBuffer data;
+    data << m_guid;
+    m_state = STATE_LOGIN;
+    m_requestSent = Clock::now();
+    SendPacket(CMSG_PLAYER_LOGIN, data);
+    return true;
+}
+
+void LoadTestSession::EnterWorld(ByteBuffer& packet)
+{
+    packet >> m_mapId >> m_x >> m_y >> m_z >> m_o;
+
+    if (m_state != STATE_LOGIN)
+        return;
+
+    m_stats.AddLatency(LATENCY_PLAYER_LOGIN, GetElapsed(m_requestSent));
+    m_stats.AddOnline();
+    m_state = STATE_IN_WORLD;
+
+    // spread the requests of the sessions, the same way in every run
+    uint32 const now = GetMSTime();
+    m_nextQuery = now + (m_config.queryInterval ? m_random() % m_config.queryInterval : 0);
+    m_nextPing = now + (m_config.pingInterval ? m_random() % m_config.pingInterval : 0);
+
+    m_startX = m_x - LOADTEST_WALK_RADIUS;
+    m_startY = m_y;
+    m_angle = 0.0f;
+    m_nextMove = now;
+    m_lastMove = now;
+
+    if (m_config.script == LOADTEST_SCRIPT_REPLAY)
+    {
+        m_stream = &(*m_config.streams)[m_index % m_config.streams->size()];
+        m_streamIndex = 0;
+        m_streamStart = now;
+    }
+    else if (m_config.script == LOADTEST_SCRIPT_WALK)
+        SendMovement(MSG_MOVE_START_FORWARD, now);
+
+    ScheduleUpdate();
+}
+
+void LoadTestSession::ScheduleUpdate()
+{
+    m_timer.expires_from_now(boost::posix_time::milliseconds(LOADTEST_UPDATE_INTERVAL));
+
+    auto self(shared_from_this());
+    m_timer.async_wait([this, self](boost::system::error_code const& error)
+    {
+        if (error || m_state == STATE_CLOSED)
+            return;
+
+        Update();
+        ScheduleUpdate();
+    });
+}
+
+void LoadTestSession::Update()
+{
+    uint32 const now = GetMSTime();
+
+    if (m_config.pingInterval && !m_pingPending && now >= m_nextPing)
+    {
+        ByteBuffer data;
+        data << ++m_pingCount;
+        data << uint32(0);                                  // latency
+        m_pingSent = Clock::now();
+        m_pingPending = true;
+        m_nextPing = now + m_config.pingInterval;
+        SendPacket(CMSG_PING, data);
+    }
+
+    if (m_config.queryInterval && !m_queryPending && now >= m_nextQuery)
+    {
+        m_querySent = Clock::now();
+        m_queryPending = true;
+        m_nextQuery = now + m_config.queryInterval;
+        SendPacket(CMSG_QUERY_TIME, ByteBuffer());
+    }
+
+    switch (m_config.script)
+    {
+        case LOADTEST_SCRIPT_WALK:
+            UpdateWalk(now);
+            break;
+        case LOADTEST_SCRIPT_REPLAY:
+            UpdateReplay(now);
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadTestSession::UpdateWalk(uint32 now)
+{
+    if (now < m_nextMove)
+        return;
+
+    float const seconds = (now - m_lastMove) / 1000.0f;
+    m_angle = std::fmod(m_angle + LOADTEST_WALK_SPEED * seconds / LOADTEST_WALK_RADIUS, 2.0f * M_PI_F);
+    m_x = m_startX + LOADTEST_WALK_RADIUS * std::cos(m_angle);
+    m_y = m_startY + LOADTEST_WALK_RADIUS * std::sin(m_angle);
+    m_o = std::fmod(m_angle + M_PI_F / 2.0f, 2.0f * M_PI_F);
+
+    m_lastMove = now;
+    m_nextMove = now + LOADTEST_MOVE_INTERVAL;
+    SendMovement(MSG_MOVE_HEARTBEAT, now);
+}
+
+void LoadTestSession::UpdateReplay(uint32 now)
+{
+    std::vector<CapturedPacket> const& packets = m_stream->packets;
+    while (packets[m_streamIndex].time <= now - m_streamStart)
+    {
+        CapturedPacket const& captured = packets[m_streamIndex];
+        ByteBuffer data(captured.data.size());
+        if (!captured.data.empty())
+            data.append(captured.data.data(), captured.data.size());
+        ReplaceGuid(data, m_stream->playerGuid, m_guid);
+        SendPacket(captured.opcode, data);
+
+        // the capture is looped for as long as the test runs
+        if (++m_streamIndex == packets.size())
+        {
+            m_streamIndex = 0;
+            m_streamStart = now;
+            break;
+        }
+    }
+}
+
+void LoadTestSession::SendMovement(uint16 opcode, uint32 now)
+{
+    ByteBuffer data;
+    data.appendPackGUID(m_guid);
+    data << uint32(opcode == MSG_MOVE_STOP ? 0 : LOADTEST_MOVEFLAG_FORWARD);
+    data << uint16(0);
+    data << now;
+    data << m_x << m_y << m_z << m_o;
+    data << uint32(0);                                      // fall time
+    SendPacket(opcode, data);
+}
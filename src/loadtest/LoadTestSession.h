@@ -0,0 +1,177 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADTEST_SESSION_H
+#define MANGOS_LOADTEST_SESSION_H
+
+#include "Common.h"
+#include "ByteBuffer.h"
+#include "Auth/BigNumber.h"
+#include "Auth/SARC4.h"
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+class LoadTestStats;
+struct CapturedStream;
+
+enum LoadTestScript
+{
+    LOADTEST_SCRIPT_IDLE,                                   // stays in place, only the periodic requests
+    LOADTEST_SCRIPT_WALK,                                   // runs circles around the login position
+    LOADTEST_SCRIPT_REPLAY,                                 // sends the packets of a captured character
+};
+
+struct LoadTestConfig
+{
+    boost::asio::ip::tcp::endpoint realmEndpoint;
+    boost::asio::ip::tcp::endpoint worldEndpoint;
+    std::string accountPrefix;                              // accounts are <prefix><index>, upper case
+    std::string password;                                   // empty for the account name as password
+    uint32 realmId;
+    bool createCharacters;                                  // creates a human warrior on accounts without character
+    LoadTestScript script;
+    std::vector<CapturedStream> const* streams;             // LOADTEST_SCRIPT_REPLAY only
+    uint32 queryInterval;                                   // milliseconds between CMSG_QUERY_TIME
+    uint32 pingInterval;                                    // milliseconds between CMSG_PING
+    uint32 seed;
+};
+
+// crypts the world packet headers the way the client does
+class LoadTestCrypt
+{
+    public:
+        LoadTestCrypt();
+
+        void Init(BigNumber* K);
+        void DecryptRecv(uint8* data, size_t len);
+        void EncryptSend(uint8* data, size_t len);
+
+    private:
+        SARC4 m_decrypt;
+        SARC4 m_encrypt;
+        bool m_initialized;
+};
+
+/**
+ * One client: logs on at the realm server, enters the world with the first character of its account
+ * and runs the script until it is closed. All handlers run on the io_service of its worker thread.
+ */
+class LoadTestSession : public std::enable_shared_from_this<LoadTestSession>
+{
+    public:
+        LoadTestSession(boost::asio::io_service& service, LoadTestConfig const& config, LoadTestStats& stats, uint32 index);
+
+        void Start();
+        void Close();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        enum State
+        {
+            STATE_REALM_CHALLENGE,
+            STATE_REALM_PROOF,
+            STATE_WORLD_AUTH,
+            STATE_CHARACTERS,
+            STATE_LOGIN,
+            STATE_IN_WORLD,
+            STATE_CLOSED,
+        };
+
+        // realm server
+        void ConnectRealm();
+        void SendLogonChallenge();
+        void ReadLogonChallenge();
+        void SendLogonProof(uint8 const* data);
+        void ReadLogonProof();
+
+        // world server
+        void ConnectWorld();
+        void Read();
+        bool ProcessIncoming();
+        bool HandlePacket(uint16 opcode, ByteBuffer& packet);
+        void SendPacket(uint16 opcode, ByteBuffer const& payload);
+        void Flush();
+
+        void HandleAuthChallenge(ByteBuffer& packet);
+        bool HandleCharEnum(ByteBuffer& packet);
+        void EnterWorld(ByteBuffer& packet);
+
+        void ScheduleUpdate();
+        void Update();
+        void UpdateWalk(uint32 now);
+        void UpdateReplay(uint32 now);
+        void SendMovement(uint16 opcode, uint32 now);
+
+        void Fail(char const* reason);
+        uint32 GetMSTime() const;                           // milliseconds since the session started
+        uint32 GetElapsed(Clock::time_point since) const;   // microseconds
+
+        boost::asio::io_service& m_service;
+        boost::asio::ip::tcp::socket m_socket;
+        boost::asio::deadline_timer m_timer;
+        LoadTestConfig const& m_config;
+        LoadTestStats& m_stats;
+        uint32 m_index;
+        std::string m_account;
+        State m_state;
+        Clock::time_point m_started;
+        std::mt19937 m_random;
+
+        BigNumber m_K;
+        LoadTestCrypt m_crypt;
+
+        std::vector<uint8> m_in;
+        size_t m_inPos;
+        uint32 m_headerSize;                                // of the packet being received, 0 until its header is complete
+        bool m_headerFirstByte;                             // first header byte already decrypted
+        uint32 m_packetSize;
+        uint16 m_packetOpcode;
+
+        std::vector<uint8> m_out;
+        std::vector<uint8> m_writing;
+        bool m_writePending;
+
+        Clock::time_point m_requestSent;                    // realm logon, world auth, char enum or login
+        Clock::time_point m_pingSent;
+        bool m_pingPending;
+        uint32 m_pingCount;
+        uint32 m_nextPing;
+        Clock::time_point m_querySent;
+        bool m_queryPending;
+        uint32 m_nextQuery;
+
+        uint64 m_guid;
+        uint32 m_mapId;
+        float m_x, m_y, m_z, m_o;
+        float m_startX, m_startY;
+        float m_angle;                                      // walk position on the circle
+        uint32 m_nextMove;
+        uint32 m_lastMove;
+
+        CapturedStream const* m_stream;
+        size_t m_streamIndex;
+        uint32 m_streamStart;
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LoadTestStats.h"
+
+#include <algorithm>
+
+LoadTestStats::LoadTestStats() : m_bytesIn(0), m_bytesOut(0), m_packetsIn(0), m_packetsOut(0), m_connecting(0), m_online(0), m_failed(0)
+{
+    for (size_t& start : m_intervalStart)
+        start = 0;
+}
+
+void LoadTestStats::AddLatency(LoadTestLatency type, uint32 microseconds)
+{
+    std::lock_guard<std::mutex> guard(m_samplesLock);
+    m_samples[type].push_back(microseconds);
+}
+
+LatencySummary LoadTestStats::GetLatency(LoadTestLatency type, bool interval)
+{
+    std::vector<uint32> samples;
+    {
+        std::lock_guard<std::mutex> guard(m_samplesLock);
+        std::vector<uint32> const& all = m_samples[type];
+        samples.assign(all.begin() + (interval ? m_intervalStart[type] : 0), all.end());
+    }
+
+    LatencySummary summary = { uint32(samples.size()), 0, 0, 0, 0, 0 };
+    if (samples.empty())
+        return summary;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](uint32 permille) { return samples[std::min(samples.size() - 1, samples.size() * permille / 1000)]; };
+    summary.p50 = percentile(500);
+    summary.p90 = percentile(900);
+    summary.p99 = percentile(990);
+    summary.p999 = percentile(999);
+    summary.max = samples.back();
+    return summary;
+}
+
+void LoadTestStats::StartInterval()
+{
+    std::lock_guard<std::mutex> guard(m_samplesLock);
+    for (uint32 i = 0; i < MAX_LOADTEST_LATENCY; ++i)
+        m_intervalStart[i] = m_samples[i].size();
+}
+
+char const* LoadTestStats::GetLatencyName(LoadTestLatency type)
+{
+    switch (type)
+    {
+        case LATENCY_REALM_LOGON:  return "realm logon";
+        case LATENCY_WORLD_AUTH:   return "world auth";
+        case LATENCY_CHAR_ENUM:    return "char enum";
+        case LATENCY_PLAYER_LOGIN: return "player login";
+        case LATENCY_PING:         return "ping";
+        case LATENCY_QUERY_TIME:   return "query time";
+        default:                   return "unknown";
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADTEST_STATS_H
+#define MANGOS_LOADTEST_STATS_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+enum LoadTestLatency
+{
+    LATENCY_REALM_LOGON,                                    // challenge sent until the realm proof arrived
+    LATENCY_WORLD_AUTH,                                     // CMSG_AUTH_SESSION until SMSG_AUTH_RESPONSE
+    LATENCY_CHAR_ENUM,
+    LATENCY_PLAYER_LOGIN,                                   // CMSG_PLAYER_LOGIN until SMSG_LOGIN_VERIFY_WORLD
+    LATENCY_PING,                                           // answered by the network thread
+    LATENCY_QUERY_TIME,                                     // answered by the thread updating the session, waits for its tick
+    MAX_LOADTEST_LATENCY
+};
+
+struct LatencySummary
+{
+    uint32 count;
+    uint32 p50;                                             // microseconds
+    uint32 p90;
+    uint32 p99;
+    uint32 p999;
+    uint32 max;
+};
+
+// shared by all sessions of all worker threads
+class LoadTestStats
+{
+    public:
+        LoadTestStats();
+
+        void AddLatency(LoadTestLatency type, uint32 microseconds);
+
+        void AddReceived(uint32 bytes) { m_bytesIn += bytes; ++m_packetsIn; }
+        void AddSent(uint32 bytes) { m_bytesOut += bytes; ++m_packetsOut; }
+
+        void AddConnecting() { ++m_connecting; }
+        void AddOnline() { --m_connecting; ++m_online; }
+        void AddFailed(bool wasOnline) { wasOnline ? --m_online : --m_connecting; ++m_failed; }
+
+        // summary of the samples since the previous interval, or of the whole run
+        LatencySummary GetLatency(LoadTestLatency type, bool interval);
+        void StartInterval();
+
+        uint64 GetBytesIn() const { return m_bytesIn; }
+        uint64 GetBytesOut() const { return m_bytesOut; }
+        uint64 GetPacketsIn() const { return m_packetsIn; }
+        uint64 GetPacketsOut() const { return m_packetsOut; }
+        uint32 GetConnecting() const { return m_connecting; }
+        uint32 GetOnline() const { return m_online; }
+        uint32 GetFailed() const { return m_failed; }
+
+        static char const* GetLatencyName(LoadTestLatency type);
+
+    private:
+        std::mutex m_samplesLock;
+        std::vector<uint32> m_samples[MAX_LOADTEST_LATENCY];
+        size_t m_intervalStart[MAX_LOADTEST_LATENCY];
+
+        std::atomic<uint64> m_bytesIn;
+        std::atomic<uint64> m_bytesOut;
+        std::atomic<uint64> m_packetsIn;
+        std::atomic<uint64> m_packetsOut;
+        std::atomic<uint32> m_connecting;
+        std::atomic<uint32> m_online;
+        std::atomic<uint32> m_failed;
+};
+
+#endif
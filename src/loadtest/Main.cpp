@@ -0,0 +1,259 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup loadtest
+/// @{
+/// \file
+
+/*
+ * Headless clients for benchmarking mangosd. The sessions log on at realmd, enter the world with the first
+ * character of their account (LOADTEST1, LOADTEST2, ... by default, password same as the name) and run a
+ * script: idle, walking circles or replaying the client packets of a PacketLogFile capture.
+ * The run is deterministic for the same options, apart from the timing of the server.
+ */
+
+#include "Common.h"
+#include "LoadTestSession.h"
+#include "LoadTestStats.h"
+#include "PacketCapture.h"
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Worker
+    {
+        boost::asio::io_service service;
+        std::unique_ptr<boost::asio::io_service::work> work;
+        std::thread thread;
+    };
+
+    bool Resolve(std::string const& address, uint16 defaultPort, boost::asio::ip::tcp::endpoint& endpoint)
+    {
+        std::string host = address;
+        std::string port = std::to_string(defaultPort);
+        size_t colon = address.find_last_of(':');
+        if (colon != std::string::npos)
+        {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+
+        boost::asio::io_service service;
+        boost::asio::ip::tcp::resolver resolver(service);
+        boost::system::error_code error;
+        auto itr = resolver.resolve(boost::asio::ip::tcp::resolver::query(host, port), error);
+        if (error || itr == boost::asio::ip::tcp::resolver::iterator())
+        {
+            printf("Can not resolve %s\n", address.c_str());
+            return false;
+        }
+
+        endpoint = *itr;
+        return true;
+    }
+
+    void PrintLatency(LoadTestStats& stats, LoadTestLatency type, bool interval)
+    {
+        LatencySummary summary = stats.GetLatency(type, interval);
+        if (!summary.count)
+            return;
+
+        printf("  %-13s %8u  p50 %9.2f  p90 %9.2f  p99 %9.2f  p99.9 %9.2f  max %9.2f ms\n", LoadTestStats::GetLatencyName(type), summary.count,
+               summary.p50 / 1000.0, summary.p90 / 1000.0, summary.p99 / 1000.0, summary.p999 / 1000.0, summary.max / 1000.0);
+    }
+
+    void PrintTraffic(LoadTestStats& stats, uint64 bytesIn, uint64 bytesOut, uint64 packetsIn, uint64 packetsOut, double seconds)
+    {
+        printf("  traffic       in %9.1f KB/s %8.0f packets/s, out %9.1f KB/s %8.0f packets/s\n",
+               bytesIn / 1024.0 / seconds, packetsIn / seconds, bytesOut / 1024.0 / seconds, packetsOut / seconds);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string realmAddress, worldAddress, script, captureFile;
+    uint32 sessions, firstAccount, rampUp, duration, threads, reportInterval;
+    LoadTestConfig config;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage message")
+    ("realm", boost::program_options::value<std::string>(&realmAddress)->default_value("127.0.0.1:3724"), "realmd address")
+    ("world", boost::program_options::value<std::string>(&worldAddress)->default_value("127.0.0.1:8085"), "mangosd address, the realm list is not asked")
+    ("realm-id", boost::program_options::value<uint32>(&config.realmId)->default_value(1), "id of the realm of mangosd")
+    ("accounts", boost::program_options::value<std::string>(&config.accountPrefix)->default_value("LOADTEST"), "account name prefix, the index is appended")
+    ("first", boost::program_options::value<uint32>(&firstAccount)->default_value(1), "index of the first account")
+    ("password", boost::program_options::value<std::string>(&config.password)->default_value(""), "password of all accounts, the account name when empty")
+    ("sessions,n", boost::program_options::value<uint32>(&sessions)->default_value(100), "number of concurrent sessions")
+    ("ramp-up", boost::program_options::value<uint32>(&rampUp)->default_value(50), "sessions started per second")
+    ("duration,d", boost::program_options::value<uint32>(&duration)->default_value(60), "seconds from the first session start until the end of the test")
+    ("script,s", boost::program_options::value<std::string>(&script)->default_value("idle"), "idle, walk or replay")
+    ("capture", boost::program_options::value<std::string>(&captureFile), "PKT file replayed by the replay script, session n replays character n of the capture")
+    ("create-characters", "create a character on accounts without one")
+    ("query-interval", boost::program_options::value<uint32>(&config.queryInterval)->default_value(1000), "milliseconds between CMSG_QUERY_TIME, 0 for none")
+    ("ping-interval", boost::program_options::value<uint32>(&config.pingInterval)->default_value(30000), "milliseconds between CMSG_PING, 0 for none")
+    ("threads,t", boost::program_options::value<uint32>(&threads)->default_value(std::max(std::thread::hardware_concurrency(), 1u)), "network threads")
+    ("report", boost::program_options::value<uint32>(&reportInterval)->default_value(10), "seconds between the interval reports")
+    ("seed", boost::program_options::value<uint32>(&config.seed)->default_value(1), "seed of the random numbers of the sessions");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    config.createCharacters = vm.count("create-characters") > 0;
+    config.streams = nullptr;
+
+    PacketCapture capture;
+    if (script == "idle")
+        config.script = LOADTEST_SCRIPT_IDLE;
+    else if (script == "walk")
+        config.script = LOADTEST_SCRIPT_WALK;
+    else if (script == "replay")
+    {
+        config.script = LOADTEST_SCRIPT_REPLAY;
+
+        std::string error;
+        if (captureFile.empty() || !capture.Load(captureFile, error))
+        {
+            printf("The replay script needs a capture: %s\n", captureFile.empty() ? "--capture is missing" : error.c_str());
+            return 1;
+        }
+        config.streams = &capture.GetStreams();
+        printf("Loaded %u characters from %s\n", uint32(config.streams->size()), captureFile.c_str());
+    }
+    else
+    {
+        printf("Unknown script %s\n", script.c_str());
+        return 1;
+    }
+
+    if (!Resolve(realmAddress, 3724, config.realmEndpoint) || !Resolve(worldAddress, 8085, config.worldEndpoint))
+        return 1;
+
+    threads = std::max(threads, 1u);
+    rampUp = std::max(rampUp, 1u);
+    reportInterval = std::max(reportInterval, 1u);
+
+    LoadTestStats stats;
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (uint32 i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(new Worker);
+        Worker& worker = *workers.back();
+        worker.work.reset(new boost::asio::io_service::work(worker.service));
+        worker.thread = std::thread([&worker]() { worker.service.run(); });
+    }
+
+    printf("Starting %u sessions, %u per second, script %s, for %u seconds\n", sessions, rampUp, script.c_str(), duration);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point const start = Clock::now();
+    Clock::time_point const end = start + std::chrono::seconds(duration);
+    Clock::time_point nextReport = start + std::chrono::seconds(reportInterval);
+    Clock::time_point lastReport = start;
+    uint64 lastBytesIn = 0, lastBytesOut = 0, lastPacketsIn = 0, lastPacketsOut = 0;
+
+    std::vector<std::shared_ptr<LoadTestSession>> started;
+    started.reserve(sessions);
+
+    while (Clock::now() < end)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        Clock::time_point const now = Clock::now();
+
+        uint32 const due = std::min<uint64>(sessions, std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() * rampUp / 1000 + 1);
+        while (started.size() < due)
+        {
+            uint32 const index = started.size();
+            Worker& worker = *workers[index % workers.size()];
+            std::shared_ptr<LoadTestSession> session = std::make_shared<LoadTestSession>(worker.service, config, stats, firstAccount + index);
+            worker.service.post([session]() { session->Start(); });
+            started.push_back(std::move(session));
+        }
+
+        if (now >= nextReport)
+        {
+            double const seconds = std::chrono::duration<double>(now - lastReport).count();
+            uint64 const bytesIn = stats.GetBytesIn(), bytesOut = stats.GetBytesOut(), packetsIn = stats.GetPacketsIn(), packetsOut = stats.GetPacketsOut();
+
+            printf("[%4us] %u online, %u connecting, %u failed\n", uint32(std::chrono::duration_cast<std::chrono::seconds>(now - start).count()),
+                   stats.GetOnline(), stats.GetConnecting(), stats.GetFailed());
+            PrintTraffic(stats, bytesIn - lastBytesIn, bytesOut - lastBytesOut, packetsIn - lastPacketsIn, packetsOut - lastPacketsOut, seconds);
+            PrintLatency(stats, LATENCY_PING, true);
+            PrintLatency(stats, LATENCY_QUERY_TIME, true);
+            stats.StartInterval();
+
+            lastBytesIn = bytesIn;
+            lastBytesOut = bytesOut;
+            lastPacketsIn = packetsIn;
+            lastPacketsOut = packetsOut;
+            lastReport = now;
+            nextReport += std::chrono::seconds(reportInterval);
+        }
+    }
+
+    for (std::shared_ptr<LoadTestSession>& session : started)
+    {
+        Worker& worker = *workers[(&session - started.data()) % workers.size()];
+        worker.service.post([session]() { session->Close(); });
+    }
+
+    for (std::unique_ptr<Worker>& worker : workers)
+    {
+        worker->work.reset();
+        worker->thread.join();
+    }
+
+    double const seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    printf("\nSummary of %u sessions over %.0f seconds: %u online at the end, %u failed\n", uint32(started.size()), seconds, stats.GetOnline(), stats.GetFailed());
+    PrintTraffic(stats, stats.GetBytesIn(), stats.GetBytesOut(), stats.GetPacketsIn(), stats.GetPacketsOut(), seconds);
+    for (uint32 i = 0; i < MAX_LOADTEST_LATENCY; ++i)
+        PrintLatency(stats, LoadTestLatency(i), false);
+
+    // the query waits in the session queue for the next update of the world or the map of the character
+    LatencySummary query = stats.GetLatency(LATENCY_QUERY_TIME, false);
+    if (query.count)
+        printf("  query time is bounded by the server tick: p50 %.2f ms suggests ticks of about %.2f ms\n", query.p50 / 1000.0, query.p50 * 2 / 1000.0);
+
+    return 0;
+}
+
+/// @}
@@ -0,0 +1,172 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PacketCapture.h"
+#include "LoadTestOpcodes.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+
+#pragma pack(push, 1)
+
+// see game/Server/PacketLog.cpp
+struct CaptureLogHeader
+{
+    char Signature[3];
+    uint16 FormatVersion;
+    uint8 SnifferId;
+    uint32 Build;
+    char Locale[4];
+    uint8 SessionKey[40];
+    uint32 SniffStartUnixtime;
+    uint32 SniffStartTicks;
+    uint32 OptionalDataSize;
+};
+
+struct CapturePacketHeader
+{
+    uint32 Direction;
+    uint32 ConnectionId;
+    uint32 ArrivalTicks;
+    uint32 OptionalDataSize;
+    uint32 Length;                                          // opcode and payload
+};
+
+#pragma pack(pop)
+
+#define CAPTURE_CLIENT_TO_SERVER    0x47534d43
+
+namespace
+{
+    struct Connection
+    {
+        int32 stream;                                       // -1 until the character logs in
+        uint32 loginTicks;
+    };
+
+    // answered by the load test itself or ending the stream
+    bool IsReplayed(uint32 opcode)
+    {
+        switch (opcode)
+        {
+            case CMSG_AUTH_SESSION:
+            case CMSG_PING:
+            case CMSG_KEEP_ALIVE:
+            case CMSG_TIME_SYNC_RESP:
+            case CMSG_CHAR_ENUM:
+            case CMSG_CHAR_CREATE:
+            case CMSG_LOGOUT_REQUEST:
+            case MSG_MOVE_WORLDPORT_ACK:
+            case MSG_MOVE_TELEPORT_ACK:
+                return false;
+            default:
+                return true;
+        }
+    }
+}
+
+bool PacketCapture::Load(std::string const& fileName, std::string& error)
+{
+    std::unique_ptr<FILE, int(*)(FILE*)> file(fopen(fileName.c_str(), "rb"), &fclose);
+    if (!file)
+    {
+        error = "can not open " + fileName;
+        return false;
+    }
+
+    CaptureLogHeader header;
+    if (fread(&header, sizeof(header), 1, file.get()) != 1 || memcmp(header.Signature, "PKT", 3) != 0 || header.FormatVersion != 0x0301)
+    {
+        error = fileName + " is no PKT 3.1 capture";
+        return false;
+    }
+
+    if (header.Build != LOADTEST_CLIENT_BUILD)
+        printf("Warning: %s was captured with client build %u\n", fileName.c_str(), header.Build);
+
+    fseek(file.get(), header.OptionalDataSize, SEEK_CUR);
+
+    // connections are told apart by their address, ConnectionId is not filled by the core
+    std::map<std::vector<uint8>, Connection> connections;
+    std::vector<uint8> key;
+    std::vector<uint8> payload;
+
+    CapturePacketHeader packetHeader;
+    while (fread(&packetHeader, sizeof(packetHeader), 1, file.get()) == 1)
+    {
+        if (packetHeader.Length < sizeof(uint32))
+        {
+            error = fileName + " is damaged";
+            return false;
+        }
+
+        key.resize(packetHeader.OptionalDataSize + sizeof(packetHeader.ConnectionId));
+        memcpy(key.data(), &packetHeader.ConnectionId, sizeof(packetHeader.ConnectionId));
+        uint32 opcode;
+        payload.resize(packetHeader.Length - sizeof(opcode));
+        if ((packetHeader.OptionalDataSize && fread(key.data() + sizeof(packetHeader.ConnectionId), packetHeader.OptionalDataSize, 1, file.get()) != 1) ||
+                fread(&opcode, sizeof(opcode), 1, file.get()) != 1 ||
+                (!payload.empty() && fread(payload.data(), payload.size(), 1, file.get()) != 1))
+        {
+            error = fileName + " ends within a packet";
+            return false;
+        }
+
+        if (packetHeader.Direction != CAPTURE_CLIENT_TO_SERVER)
+            continue;
+
+        Connection& connection = connections.emplace(key, Connection{ -1, 0 }).first->second;
+        if (opcode == CMSG_PLAYER_LOGIN)
+        {
+            if (payload.size() < sizeof(uint64))
+                continue;
+
+            // a relog on the same connection is a stream of its own
+            CapturedStream stream;
+            memcpy(&stream.playerGuid, payload.data(), sizeof(uint64));
+            m_streams.push_back(std::move(stream));
+            connection.stream = m_streams.size() - 1;
+            connection.loginTicks = packetHeader.ArrivalTicks;
+            continue;
+        }
+
+        if (connection.stream < 0 || !IsReplayed(opcode))
+            continue;
+
+        // the ticks wrap around after 49 days, the difference stays right
+        m_streams[connection.stream].packets.push_back({ packetHeader.ArrivalTicks - connection.loginTicks, uint16(opcode), payload });
+    }
+
+    for (auto itr = m_streams.begin(); itr != m_streams.end();)
+    {
+        if (itr->packets.empty())
+            itr = m_streams.erase(itr);
+        else
+            ++itr;
+    }
+
+    if (m_streams.empty())
+    {
+        error = fileName + " holds no client packets after a CMSG_PLAYER_LOGIN";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADTEST_PACKETCAPTURE_H
+#define MANGOS_LOADTEST_PACKETCAPTURE_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+struct CapturedPacket
+{
+    uint32 time;                                            // milliseconds since the character entered the world
+    uint16 opcode;
+    std::vector<uint8> data;
+};
+
+// client packets of one character from its CMSG_PLAYER_LOGIN on
+struct CapturedStream
+{
+    uint64 playerGuid;
+    std::vector<CapturedPacket> packets;
+};
+
+/**
+ * Reads the client packets of a PKT 3.1 capture, as written by PacketLogFile, split by connection and login.
+ */
+class PacketCapture
+{
+    public:
+        bool Load(std::string const& fileName, std::string& error);
+
+        std::vector<CapturedStream> const& GetStreams() const { return m_streams; }
+
+    private:
+        std::vector<CapturedStream> m_streams;
+};
+
+#endif
@@ -18,14 +18,36 @@
 
 #include "MaNGOSsoap.h"
 
+#include <atomic>
 #include <string>
 
-SOAPThread::SOAPThread(const std::string& host, int port) : m_host(host), m_port(port), m_workerThread(&SOAPThread::Work, this) {}
+SOAPThread::SOAPThread(const std::string& host, int port) : m_host(host), m_port(port), m_stopping(false), m_workerThread(&SOAPThread::Work, this)
+{
+    for (int i = 0; i < WorkerThreads; ++i)
+        m_serveThreads.emplace_back(&SOAPThread::Serve, this);
+}
 
 SOAPThread::~SOAPThread()
 {
     sLog.outError("SOAP shutting down");
     m_workerThread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_serveThreads)
+        thread.join();
+
+    // connections not served before the shutdown
+    for (soap* copy : m_connections)
+    {
+        soap_destroy(copy);
+        soap_end(copy);
+        soap_free(copy);
+    }
 }
 
 void SOAPThread::Work()
@@ -59,14 +81,46 @@ void SOAPThread::Work()
         DEBUG_LOG("MaNGOSsoap: accepted connection from IP=%d.%d.%d.%d", (int)(soap.ip >> 24) & 0xFF, (int)(soap.ip >> 16) & 0xFF, (int)(soap.ip >> 8) & 0xFF, (int)soap.ip & 0xFF);
 
         auto copy = soap_copy(&soap);
-        soap_serve(copy);
-        soap_destroy(copy);
+        if (!copy)
+        {
+            soap_closesock(&soap);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_connections.push_back(copy);
+        }
+        m_condition.notify_one();
     }
 
     soap_end(&soap);
     soap_done(&soap);
 }
 
+void SOAPThread::Serve()
+{
+    while (true)
+    {
+        soap* copy;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] { return m_stopping || !m_connections.empty(); });
+
+            if (m_stopping)
+                return;
+
+            copy = m_connections.front();
+            m_connections.pop_front();
+        }
+
+        soap_serve(copy);
+        soap_destroy(copy);
+        soap_end(copy);
+        soap_free(copy);
+    }
+}
+
 /*
 Code used for generating stubs:
 
@@ -105,11 +159,12 @@ int ns1__executeCommand(soap* soap, char* command, char** result)
 
     DEBUG_LOG("MaNGOSsoap: got command '%s'", command);
 
-    bool commandExecuted = false, commandSucceeded = false;
+    std::atomic<bool> commandExecuted(false);
+    bool commandSucceeded = false;
     std::vector<char> buffer;
     buffer.reserve(SOAPThread::CommandOutputBufferSize);
 
-    // commands are executed in the world thread. We have to wait for them to be completed
+    // commands are executed in the world thread or the ChatCommandWorker. We have to wait for them to be completed
     sWorld.QueueCliCommand(new CliCommandHolder(accountId, SEC_CONSOLE, command,
                            [&buffer](const char* output)
     {
@@ -120,8 +175,8 @@ int ns1__executeCommand(soap* soap, char* command, char** result)
     },
     [soap, &commandExecuted, &commandSucceeded](bool success)
     {
-        commandExecuted = true;
         commandSucceeded = success;
+        commandExecuted = true;
     }));
 
     while (!commandExecuted)
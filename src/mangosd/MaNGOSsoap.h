@@ -27,8 +27,12 @@
 #include "soapH.h"
 #include "soapStub.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 class SOAPThread
 {
@@ -41,9 +45,18 @@ class SOAPThread
         const std::string m_host;
         const int m_port;
 
+        // the accepted connections are served by the workers, a command waiting for the world tick
+        // does not hold back the other clients
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        std::deque<soap*> m_connections;
+        bool m_stopping;
+
         std::thread m_workerThread;
+        std::vector<std::thread> m_serveThreads;
 
         void Work();
+        void Serve();
 
     public:
         static const AccountTypes MinLevel = AccountTypes::SEC_ADMINISTRATOR;
@@ -222,7 +222,8 @@ int Master::Run()
             sLog.outError("Invalid network tread workers setting in mangosd.conf. (%d) should be > 0", networkThreadWorker);
             networkThreadWorker = 1;
         }
-        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker);
+        MaNGOS::Listener<WorldSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), int32(sWorld.getConfig(CONFIG_UINT32_PORT_WORLD)), networkThreadWorker,
+                                               sConfig.GetBoolDefault("Network.ReusePort", false));
 
         std::unique_ptr<MaNGOS::Listener<RASocket>> raListener;
         if (sConfig.GetBoolDefault("Ra.Enable", false))
@@ -353,6 +354,7 @@ bool Master::_StartDB()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    int nHolderConnections = sConfig.GetIntDefault("CharacterDatabaseHolderConnections", 2);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -361,10 +363,10 @@ bool Master::_StartDB()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
+    sLog.outString("Character Database total connections: %i", nConnections + 1 + std::max(nHolderConnections, 0));
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nHolderConnections))
     {
         sLog.outError("Cannot connect to Character database %s", dbstring.c_str());
 
@@ -25,6 +25,8 @@
 #include "WorldRunnable.h"
 #include "Timer.h"
 #include "Maps/MapManager.h"
+#include "ThreadAffinity.h"
+#include "TraceRecorder.h"
 
 #include "Database/DatabaseEnv.h"
 
@@ -40,6 +42,8 @@ void WorldRunnable::run()
 {
     ///- Init new SQL thread for the world database
     WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+    TraceRecorder::SetThreadName("world");
+    ThreadAffinity::PinCurrentThread(THREAD_CLASS_WORLD);
     sWorld.InitResultQueue();
 
     uint32 realCurrTime = 0;
@@ -28,6 +28,7 @@
 #include "Log.h"
 #include "RealmList.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "AuthCodes.h"
 #include "SRP6/SRP6.h"
 #include "CommonDefines.h"
@@ -178,7 +179,8 @@ std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B,
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(service)
+    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), m_deferredStatus(STATUS_CLOSED), m_deferredClose(false),
+      _build(0), _accountSecurityLevel(SEC_PLAYER), m_service(service), m_timeoutTimer(service)
 {
     m_timeoutTimer.expires_from_now(boost::posix_time::seconds(30));
     m_timeoutTimer.async_wait([&] (const boost::system::error_code& error)
@@ -258,6 +260,38 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
+void AuthSocket::Defer(std::function<void()> work)
+{
+    m_deferredReply.clear();
+    m_deferredStatus = STATUS_CLOSED;
+    m_deferredClose = false;
+
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Post([self, work]()
+    {
+        work();
+        self->m_service.post([self]() { self->FinishDeferred(); });
+    });
+}
+
+void AuthSocket::FinishDeferred()
+{
+    if (IsClosed())
+        return;
+
+    if (m_deferredClose)
+    {
+        Close();
+        return;
+    }
+
+    // the status first, the client answers as soon as it has the reply
+    _status = m_deferredStatus;
+    if (!m_deferredReply.empty())
+        Write((const char*)m_deferredReply.contents(), m_deferredReply.size());
+    m_deferredReply.clear();
+}
+
 void AuthSocket::SendProof(Sha1Hash sha)
 {
     switch (_build)
@@ -272,7 +306,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.error = 0;
             proof.LoginFlags = 0x00;
 
-            Write((const char*)&proof, sizeof(proof));
+            m_deferredReply.append((uint8 const*)&proof, sizeof(proof));
             break;
         }
         case 8606:                                          // 2.4.3
@@ -291,7 +325,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.surveyId = 0x00000000;
             proof.unkFlags = 0x0000;
 
-            Write((const char*)&proof, sizeof(proof));
+            m_deferredReply.append((uint8 const*)&proof, sizeof(proof));
             break;
         }
     }
@@ -341,8 +375,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -365,138 +397,141 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelocale = m_locale;
     LoginDatabase.escape_string(_safelocale);
 
-    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
-    pkt << uint8(0x00);
-
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
-
-    if (ip_banned_result)
-    {
-        pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
-        BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
-    }
-    else
+    ///- Look up the account on the auth worker pool, the reply is sent once done
+    Defer([this]()
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
-        {
-            Field* fields = result->Fetch();
-
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if (fields[1].GetUInt8() == 1)               // if ip is locked
-            {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
-                if (strcmp(fields[2].GetString(), m_address.c_str()))
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
-                    locked = true;
-                }
-                else
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
-            }
-            else
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+        ByteBuffer& pkt = m_deferredReply;
+        pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+        pkt << uint8(0x00);
 
-            std::string databaseV = fields[4].GetCppString();
-            std::string databaseS = fields[5].GetCppString();
-            bool broken = false;
+        ///- Verify that this IP is not in the ip_banned table
+        // No SQL injection possible (paste the IP address as passed by the socket)
+        std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+                "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
 
-            if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        if (ip_banned_result)
+        {
+            pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
+            BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
+        }
+        else
+        {
+            ///- Get the account details from the account table
+            // No SQL injection (escaped user name)
+            QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
+            if (result)
             {
-                pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
-                DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
-                broken = true;
-            }
+                Field* fields = result->Fetch();
 
-            if (!locked && !broken)
-            {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[1].GetUInt32());
-                if (banresult)
+                ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+                bool locked = false;
+                if (fields[1].GetUInt8() == 1)               // if ip is locked
                 {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << uint8(AUTH_LOGON_FAILED_BANNED);
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
-                    }
-                    else
+                    DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
+                    DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
+                    if (strcmp(fields[2].GetString(), m_address.c_str()))
                     {
+                        DEBUG_LOG("[AuthChallenge] Account IP differs");
                         pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
+                        locked = true;
                     }
-
-                    delete banresult;
+                    else
+                        DEBUG_LOG("[AuthChallenge] Account IP matches");
                 }
                 else
-                {
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
-
-                    BigNumber s;
-                    s.SetHexStr(databaseS.c_str());
+                    DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
 
-                    srp.CalculateHostPublicEphemeral();
+                std::string databaseV = fields[4].GetCppString();
+                std::string databaseS = fields[5].GetCppString();
+                bool broken = false;
 
-                    ///- Fill the response packet with the result
-                    pkt << uint8(AUTH_LOGON_SUCCESS);
-
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(srp.GetPrime().AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-                    uint8 securityFlags = 0;
-
-                    _token = fields[6].GetCppString();
-                    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
-                        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
-
-                    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+                if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+                {
+                    pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
+                    DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
+                    broken = true;
+                }
 
-                    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
+                if (!locked && !broken)
+                {
+                    ///- If the account is banned, reject the logon attempt
+                    QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
+                                             "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[1].GetUInt32());
+                    if (banresult)
                     {
-                        pkt << uint32(0);
-                        pkt << uint64(0);
-                        pkt << uint64(0);
+                        if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+                        {
+                            pkt << uint8(AUTH_LOGON_FAILED_BANNED);
+                            BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
+                        }
+                        else
+                        {
+                            pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
+                            BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
+                        }
+
+                        delete banresult;
                     }
-
-                    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
+                    else
                     {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
+                        DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
 
-                    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
-                        pkt << uint8(1);
+                        BigNumber s;
+                        s.SetHexStr(databaseS.c_str());
 
-                    uint8 secLevel = fields[3].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+                        srp.CalculateHostPublicEphemeral();
 
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
+                        ///- Fill the response packet with the result
+                        pkt << uint8(AUTH_LOGON_SUCCESS);
+
+                        // B may be calculated < 32B so we force minimal length to 32B
+                        pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
+                        pkt << uint8(1);
+                        pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
+                        pkt << uint8(32);
+                        pkt.append(srp.GetPrime().AsByteArray(32), 32);
+                        pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
+                        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+                        uint8 securityFlags = 0;
+
+                        _token = fields[6].GetCppString();
+                        if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
+                            securityFlags = SECURITY_FLAG_AUTHENTICATOR;
+
+                        pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+
+                        if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
+                        {
+                            pkt << uint32(0);
+                            pkt << uint64(0);
+                            pkt << uint64(0);
+                        }
+
+                        if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
+                        {
+                            pkt << uint8(0);
+                            pkt << uint8(0);
+                            pkt << uint8(0);
+                            pkt << uint8(0);
+                            pkt << uint64(0);
+                        }
+
+                        if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
+                            pkt << uint8(1);
+
+                        uint8 secLevel = fields[3].GetUInt8();
+                        _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+
+                        ///- All good, await client's proof
+                        m_deferredStatus = STATUS_LOGON_PROOF;
+                    }
                 }
+                delete result;
             }
-            delete result;
+            else                                                // no account
+                pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
         }
-        else                                                // no account
-            pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
-    }
-
-    Write((const char*)pkt.contents(), pkt.size());
+    });
     return true;
 }
 
@@ -527,132 +562,141 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
-    ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
+    ///- Authenticator pin, read here as the socket buffer belongs to the network thread
+    bool pinReceived = false;
+    std::vector<uint8> keys;
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
     {
-        BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
-        return false;
+        uint8 pinCount;
+        if (Read((char*)&pinCount, sizeof(uint8)))
+        {
+            keys.resize(pinCount + 1);
+            pinReceived = Read((char*)keys.data(), sizeof(uint8) * pinCount);
+            keys[pinCount] = '\0';
+        }
     }
 
-    srp.HashSessionKey();
-    srp.CalculateProof(_login);
-
-    ///- Check if SRP6 results match (password is correct), else send an error
-    if (!srp.Proof(lp.M1, 20))
+    ///- Continue the SRP6 calculation on the auth worker pool, the reply is sent once done
+    Defer([this, lp, pinReceived, keys]() mutable
     {
-        if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+        if(!srp.CalculateSessionKey(lp.A, 32))
         {
-            uint8 pinCount;
-            if (!Read((char*)&pinCount, sizeof(uint8)))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
-            std::vector<uint8> keys(pinCount + 1);
-            if (!Read((char*)keys.data(), sizeof(uint8) * pinCount))
-            {
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
-                Write(data, sizeof(data));
-                return true;
-            }
+            BASIC_LOG("[AuthChallenge] Session calculation failed for account %s!", _login.c_str());
+            m_deferredClose = true;
+            return;
+        }
 
-            keys[pinCount] = '\0';
-            auto ServerToken = generateToken(_token.c_str());
-            auto clientToken = atoi((const char*)keys.data());
-            if (ServerToken != clientToken)
+        srp.HashSessionKey();
+        srp.CalculateProof(_login);
+
+        ///- Check if SRP6 results match (password is correct), else send an error
+        if (!srp.Proof(lp.M1, 20))
+        {
+            if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
             {
-                BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, pinCount);
+                if (!pinReceived)
+                {
+                    const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 3, 0 };
+                    m_deferredReply.append(data, sizeof(data));
+                    return;
+                }
 
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
-                Write(data, sizeof(data));
-                return true;
+                auto ServerToken = generateToken(_token.c_str());
+                auto clientToken = atoi((const char*)keys.data());
+                if (ServerToken != clientToken)
+                {
+                    BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u Pin Count: %u", _login.c_str(), clientToken, ServerToken, uint32(keys.size() - 1));
+
+                    const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
+                    m_deferredReply.append(data, sizeof(data));
+                    return;
+                }
             }
-        }
 
-        if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
-        {
-            BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
+            if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
+            {
+                BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
 
-            const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
-            Write(data, sizeof(data));
-            return true;
-        }
+                const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_VERSION_INVALID };
+                m_deferredReply.append(data, sizeof(data));
+                return;
+            }
 
-        BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
+            BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
 
-        ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
-        // No SQL injection (escaped user input) and IP address as received by socket
-        const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0 WHERE username = '%s'", K_hex, _safelocale.c_str(), _safelogin.c_str());
-        if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
-        OPENSSL_free((void*)K_hex);
+            ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
+            // No SQL injection (escaped user input) and IP address as received by socket
+            const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
+            LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0 WHERE username = '%s'", K_hex, _safelocale.c_str(), _safelogin.c_str());
+            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()))
+                LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+            OPENSSL_free((void*)K_hex);
 
-        ///- Finish SRP6 and send the final result to the client
-        Sha1Hash sha;
-        srp.Finalize(sha);
+            ///- Finish SRP6 and send the final result to the client
+            Sha1Hash sha;
+            srp.Finalize(sha);
 
-        SendProof(sha);
+            SendProof(sha);
 
-        ///- Set _status to authed!
-        _status = STATUS_AUTHED;
-    }
-    else
-    {
-        if (_build > 6005)                                  // > 1.12.2
-        {
-            const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
-            Write(data, sizeof(data));
+            ///- Set _status to authed!
+            m_deferredStatus = STATUS_AUTHED;
         }
         else
         {
-            // 1.x not react incorrectly at 4-byte message use 3 as real error
-            const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT };
-            Write(data, sizeof(data));
-        }
-
-        BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
+            if (_build > 6005)                                  // > 1.12.2
+            {
+                const char data[4] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT, 0, 0 };
+                m_deferredReply.append(data, sizeof(data));
+            }
+            else
+            {
+                // 1.x not react incorrectly at 4-byte message use 3 as real error
+                const char data[2] = { CMD_AUTH_LOGON_PROOF, AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT };
+                m_deferredReply.append(data, sizeof(data));
+            }
 
-        uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
-        if (MaxWrongPassCount > 0)
-        {
-            // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
+            BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
 
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
+            if (MaxWrongPassCount > 0)
             {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+                // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+                LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
 
-                if (failed_logins >= MaxWrongPassCount)
+                if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
                 {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+                    Field* fields = loginfail->Fetch();
+                    uint32 failed_logins = fields[1].GetUInt32();
 
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                               "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
+                    if (failed_logins >= MaxWrongPassCount)
                     {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
+                        uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+                        bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+
+                        if (WrongPassBanType)
+                        {
+                            uint32 acc_id = fields[0].GetUInt32();
+                            LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
+                                                   "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                                   acc_id, WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                                      _login.c_str(), WrongPassBanTime, failed_logins);
+                        }
+                        else
+                        {
+                            std::string current_ip = m_address;
+                            LoginDatabase.escape_string(current_ip);
+                            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                                   current_ip.c_str(), WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                                      current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
+                        }
                     }
+                    delete loginfail;
                 }
-                delete loginfail;
             }
         }
-    }
+    });
     return true;
 }
 
@@ -820,130 +864,29 @@ bool AuthSocket::_HandleRealmList()
 
 void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 {
-    switch (_build)
+    std::shared_ptr<RealmListBody const> body = sRealmList.GetRealmListBody(_build, _accountSecurityLevel);
+
+    ///- The character counts of all realms in one query, the rest of the list is the same for all accounts
+    std::map<uint32, uint8> characterCounts;
+    // No SQL injection. id of the account is controlled by the database.
+    if (QueryResult* result = LoginDatabase.PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", acctid))
     {
-        case 5875:                                          // 1.12.1
-        case 6005:                                          // 1.12.2
-        case 6141:                                          // 1.12.3
+        do
         {
-            pkt << uint32(0);                               // unused value
-            pkt << uint8(sRealmList.size());
-
-            for (const auto& i : sRealmList)
-            {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
-                bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
-
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
-                if (!buildInfo)
-                    buildInfo = &i.second.realmBuildInfo;
-
-                RealmFlags realmflags = i.second.realmflags;
-
-                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
-                std::string name = i.first;
-                if (realmflags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    char buf[20];
-                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
-                    name += buf;
-                }
-
-                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
-                if (!ok_build || (i.second.allowedSecurityLevel > _accountSecurityLevel))
-                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
-
-                pkt << uint32(i.second.icon);              // realm type
-                pkt << uint8(realmflags);                   // realmflags
-                pkt << name;                                // name
-                pkt << i.second.address;                   // address
-                pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8(i.second.timezone);           // realm category
-                pkt << uint8(0x00);                         // unk, may be realm number/id?
-            }
-
-            pkt << uint16(0x0002);                          // unused value (why 2?)
-            break;
+            Field* fields = result->Fetch();
+            characterCounts[fields[0].GetUInt32()] = fields[1].GetUInt8();
         }
+        while (result->NextRow());
+        delete result;
+    }
 
-        case 8606:                                          // 2.4.3
-        case 10505:                                         // 3.2.2a
-        case 11159:                                         // 3.3.0a
-        case 11403:                                         // 3.3.2
-        case 11723:                                         // 3.3.3a
-        case 12340:                                         // 3.3.5a
-        default:                                            // and later
-        {
-            pkt << uint32(0);                               // unused value
-            pkt << uint16(sRealmList.size());
-
-            for (const auto& i : sRealmList)
-            {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
-
-                bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
-
-                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(_build) : nullptr;
-                if (!buildInfo)
-                    buildInfo = &i.second.realmBuildInfo;
-
-                uint8 lock = (i.second.allowedSecurityLevel > _accountSecurityLevel) ? 1 : 0;
-
-                RealmFlags realmFlags = i.second.realmflags;
-
-                // Show offline state for unsupported client builds
-                if (!ok_build)
-                    realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE);
-
-                //if (!buildInfo) // always false since updated 10 lines above if null. ToDo: fix
-                //    realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD);
-
-                pkt << uint8(i.second.icon);               // realm type (this is second column in Cfg_Configs.dbc)
-                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
-                pkt << uint8(realmFlags);                   // see enum RealmFlags
-                pkt << i.first;                            // name
-                pkt << i.second.address;                   // address
-                pkt << float(i.second.populationLevel);
-                pkt << uint8(AmountOfCharacters);
-                pkt << uint8(i.second.timezone);           // realm category (Cfg_Categories.dbc)
-                pkt << uint8(0x2C);                         // unk, may be realm number/id?
-
-                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
-                {
-                    pkt << uint8(buildInfo->major_version);
-                    pkt << uint8(buildInfo->minor_version);
-                    pkt << uint8(buildInfo->bugfix_version);
-                    pkt << uint16(_build);
-                }
-            }
-
-            pkt << uint16(0x0010);                          // unused value (why 10?)
-            break;
-        }
+    size_t const start = pkt.wpos();
+    pkt.append(body->packet);
+    for (auto const& position : body->characterCountPositions)
+    {
+        auto itr = characterCounts.find(position.first);
+        if (itr != characterCounts.end())
+            pkt.put<uint8>(start + position.second, itr->second);
     }
 }
 
@@ -76,6 +76,15 @@ class AuthSocket : public MaNGOS::Socket
 
         eStatus _status;
 
+        // a logon handler running on the auth worker pool fills these, the network thread of the socket
+        // sends the reply and switches the status; no further command is handled before that
+        ByteBuffer m_deferredReply;
+        eStatus m_deferredStatus;
+        bool m_deferredClose;
+
+        void Defer(std::function<void()> work);
+        void FinishDeferred();
+
         std::string _login;
         std::string _safelogin;
         std::string _token;
@@ -85,6 +94,7 @@ class AuthSocket : public MaNGOS::Socket
         uint16 _build;
         AccountTypes _accountSecurityLevel;
 
+        boost::asio::io_service& m_service;
         boost::asio::deadline_timer m_timeoutTimer;
 
         virtual bool ProcessIncomingData() override;
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+
+extern DatabaseType LoginDatabase;
+
+AuthWorkerPool sAuthWorkerPool;
+
+void AuthWorkerPool::Start(uint32 threads)
+{
+    m_work.reset(new boost::asio::io_service::work(m_service));
+
+    m_threads.reserve(threads);
+    for (uint32 i = 0; i < threads; ++i)
+    {
+        m_threads.emplace_back([this]()
+        {
+            LoginDatabase.ThreadStart();
+            m_service.run();
+            LoginDatabase.ThreadEnd();
+        });
+    }
+}
+
+void AuthWorkerPool::Stop()
+{
+    // the queued logons are still finished, their sockets are closed by then anyway
+    m_work.reset();
+    for (std::thread& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+void AuthWorkerPool::Post(std::function<void()> work)
+{
+    if (m_threads.empty())
+        work();
+    else
+        m_service.post(std::move(work));
+}
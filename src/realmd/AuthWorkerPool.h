@@ -0,0 +1,56 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+
+#include <boost/asio.hpp>
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Threads running the account queries and the SRP6 math of the logons, off the network threads
+class AuthWorkerPool
+{
+    public:
+        AuthWorkerPool() {}
+
+        // without threads the work runs right away on the calling thread
+        void Start(uint32 threads);
+        void Stop();
+
+        void Post(std::function<void()> work);
+
+    private:
+        boost::asio::io_service m_service;
+        std::unique_ptr<boost::asio::io_service::work> m_work;
+        std::vector<std::thread> m_threads;
+};
+
+extern AuthWorkerPool sAuthWorkerPool;
+
+#endif
+/// @}
@@ -32,6 +32,7 @@
 #include "revision_sql.h"
 #include "Util.h"
 #include "Network/Listener.hpp"
+#include "AuthWorkerPool.h"
 
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -217,11 +218,13 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=UNIX_TIMESTAMP() AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
-    // FIXME - more intelligent selection of thread count is needed here.  config option?
+    sAuthWorkerPool.Start(std::max(0, sConfig.GetIntDefault("AuthWorkerThreads", 2)));
+
     MaNGOS::Listener<AuthSocket> listener(
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
             sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT),
-            sConfig.GetIntDefault("ListenerThreads", 1)
+            std::max(1, sConfig.GetIntDefault("ListenerThreads", 2)),
+            sConfig.GetBoolDefault("ListenerReusePort", false)
     );
 
     ///- Catch termination signals
@@ -296,6 +299,9 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    ///- Finish the logons still queued, they may write to the database
+    sAuthWorkerPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -336,9 +342,11 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // a query connection per auth worker and one more for the realm lists sent by the network threads
+    int const queryConnections = std::max(0, sConfig.GetIntDefault("AuthWorkerThreads", 2)) + 1;
+    sLog.outString("Login Database total connections: %i", queryConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), queryConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
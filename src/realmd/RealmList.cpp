@@ -88,6 +88,8 @@ RealmList& sRealmList
 /// Load the realm list from the database
 void RealmList::Initialize(uint32 updateInterval)
 {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
     m_UpdateInterval = updateInterval;
 
     ///- Get the content of the realmlist table in the database
@@ -135,6 +137,8 @@ void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::strin
 
 void RealmList::UpdateIfNeed()
 {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
     // maybe disabled or updated recently
     if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
         return;
@@ -152,6 +156,8 @@ void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
 
+    m_realmListBodies.clear();
+
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
@@ -186,3 +192,123 @@ void RealmList::UpdateRealms(bool init)
         delete result;
     }
 }
+
+std::shared_ptr<RealmListBody const> RealmList::GetRealmListBody(uint16 build, AccountTypes security)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    std::shared_ptr<RealmListBody const>& cached = m_realmListBodies[(uint32(build) << 8) | uint32(security)];
+    if (!cached)
+        cached = BuildRealmListBody(build, security);
+    return cached;
+}
+
+std::shared_ptr<RealmListBody const> RealmList::BuildRealmListBody(uint16 build, AccountTypes security) const
+{
+    std::shared_ptr<RealmListBody> body = std::make_shared<RealmListBody>();
+    ByteBuffer& pkt = body->packet;
+
+    switch (build)
+    {
+        case 5875:                                          // 1.12.1
+        case 6005:                                          // 1.12.2
+        case 6141:                                          // 1.12.3
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint8(m_realms.size());
+
+            for (const auto& i : m_realms)
+            {
+                bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), build) != i.second.realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : nullptr;
+                if (!buildInfo)
+                    buildInfo = &i.second.realmBuildInfo;
+
+                RealmFlags realmflags = i.second.realmflags;
+
+                // 1.x clients not support explicitly REALM_FLAG_SPECIFYBUILD, so manually form similar name as show in more recent clients
+                std::string name = i.first;
+                if (realmflags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    char buf[20];
+                    snprintf(buf, 20, " (%u,%u,%u)", buildInfo->major_version, buildInfo->minor_version, buildInfo->bugfix_version);
+                    name += buf;
+                }
+
+                // Show offline state for unsupported client builds and locked realms (1.x clients not support locked state show)
+                if (!ok_build || (i.second.allowedSecurityLevel > security))
+                    realmflags = RealmFlags(realmflags | REALM_FLAG_OFFLINE);
+
+                pkt << uint32(i.second.icon);              // realm type
+                pkt << uint8(realmflags);                   // realmflags
+                pkt << name;                                // name
+                pkt << i.second.address;                   // address
+                pkt << float(i.second.populationLevel);
+                body->characterCountPositions.emplace_back(i.second.m_ID, pkt.wpos());
+                pkt << uint8(0);                            // characters of the account, filled per request
+                pkt << uint8(i.second.timezone);           // realm category
+                pkt << uint8(0x00);                         // unk, may be realm number/id?
+            }
+
+            pkt << uint16(0x0002);                          // unused value (why 2?)
+            break;
+        }
+
+        case 8606:                                          // 2.4.3
+        case 10505:                                         // 3.2.2a
+        case 11159:                                         // 3.3.0a
+        case 11403:                                         // 3.3.2
+        case 11723:                                         // 3.3.3a
+        case 12340:                                         // 3.3.5a
+        default:                                            // and later
+        {
+            pkt << uint32(0);                               // unused value
+            pkt << uint16(m_realms.size());
+
+            for (const auto& i : m_realms)
+            {
+                bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), build) != i.second.realmbuilds.end();
+
+                RealmBuildInfo const* buildInfo = ok_build ? FindBuildInfo(build) : nullptr;
+                if (!buildInfo)
+                    buildInfo = &i.second.realmBuildInfo;
+
+                uint8 lock = (i.second.allowedSecurityLevel > security) ? 1 : 0;
+
+                RealmFlags realmFlags = i.second.realmflags;
+
+                // Show offline state for unsupported client builds
+                if (!ok_build)
+                    realmFlags = RealmFlags(realmFlags | REALM_FLAG_OFFLINE);
+
+                //if (!buildInfo) // always false since updated 10 lines above if null. ToDo: fix
+                //    realmFlags = RealmFlags(realmFlags & ~REALM_FLAG_SPECIFYBUILD);
+
+                pkt << uint8(i.second.icon);               // realm type (this is second column in Cfg_Configs.dbc)
+                pkt << uint8(lock);                         // flags, if 0x01, then realm locked
+                pkt << uint8(realmFlags);                   // see enum RealmFlags
+                pkt << i.first;                            // name
+                pkt << i.second.address;                   // address
+                pkt << float(i.second.populationLevel);
+                body->characterCountPositions.emplace_back(i.second.m_ID, pkt.wpos());
+                pkt << uint8(0);                            // characters of the account, filled per request
+                pkt << uint8(i.second.timezone);           // realm category (Cfg_Categories.dbc)
+                pkt << uint8(0x2C);                         // unk, may be realm number/id?
+
+                if (realmFlags & REALM_FLAG_SPECIFYBUILD)
+                {
+                    pkt << uint8(buildInfo->major_version);
+                    pkt << uint8(buildInfo->minor_version);
+                    pkt << uint8(buildInfo->bugfix_version);
+                    pkt << uint16(build);
+                }
+            }
+
+            pkt << uint16(0x0010);                          // unused value (why 10?)
+            break;
+        }
+    }
+
+    return body;
+}
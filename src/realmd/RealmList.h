@@ -24,7 +24,12 @@
 #define _REALMLIST_H
 
 #include "Common.h"
+#include "ByteBuffer.h"
+
 #include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 struct RealmBuildInfo
 {
@@ -55,6 +60,13 @@ struct Realm
     RealmBuildInfo realmBuildInfo;                          // build info for show version in list
 };
 
+/// Serialized realm list of a client build and account security level, without the character counts of the account
+struct RealmListBody
+{
+    ByteBuffer packet;
+    std::vector<std::pair<uint32, size_t>> characterCountPositions;     // realm id, position of its character count in packet
+};
+
 /// Storage object for the list of realms on the server
 class RealmList
 {
@@ -70,16 +82,23 @@ class RealmList
 
         void UpdateIfNeed();
 
+        // built once per client build and security level until the realms are updated from the database
+        std::shared_ptr<RealmListBody const> GetRealmListBody(uint16 build, AccountTypes security);
+
         RealmMap::const_iterator begin() const { return m_realms.begin(); }
         RealmMap::const_iterator end() const { return m_realms.end(); }
         uint32 size() const { return m_realms.size(); }
     private:
         void UpdateRealms(bool init);
+        std::shared_ptr<RealmListBody const> BuildRealmListBody(uint16 build, AccountTypes security) const;
         void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
         RealmMap m_realms;                                  ///< Internal map of realms
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
+
+        std::mutex m_mutex;                                 ///< the network threads request and update the realms concurrently
+        std::unordered_map<uint32, std::shared_ptr<RealmListBody const>> m_realmListBodies;
 };
 
 #define sRealmList RealmList::Instance()
@@ -20,8 +20,9 @@
 #define _BYTEBUFFER_H
 
 #include "Common.h"
+#include "Utilities/BufferPool.h"
 #include "Utilities/ByteConverter.h"
-#include <utf8.h>
+#include "Utilities/Utf8Scan.h"
 
 class ByteBufferException
 {
@@ -298,16 +299,18 @@ class ByteBuffer
         void read(std::string& value, bool utf8)
         {
             value.clear();
-            while (rpos() < size())
+            if (rpos() < size())
             {
-                char c = read<char>();
-                if (c == 0)
-                    break;
-                value += c;
+                char const* str = reinterpret_cast<char const*>(&_storage[_rpos]);
+                size_t const left = size() - _rpos;
+                char const* terminator = static_cast<char const*>(memchr(str, 0, left));
+                size_t const length = terminator ? size_t(terminator - str) : left;
+                value.assign(str, length);
+                _rpos += terminator ? length + 1 : length;
             }
 
             // Detect invalid unicode sequence in string and raise appropriate exception
-            if (utf8 && !utf8::is_valid(value.begin(), value.end()))
+            if (utf8 && !MaNGOS::Utf8IsValid(value.data(), value.size()))
                 throw ByteBufferException(false, _rpos, value.length(), size());
         }
 
@@ -333,6 +336,7 @@ class ByteBuffer
         const uint8* contents() const { return &_storage[0]; }
 
         size_t size() const { return _storage.size(); }
+        size_t capacity() const { return _storage.capacity(); }
         bool empty() const { return _storage.empty(); }
 
         void resize(size_t newsize)
@@ -433,7 +437,7 @@ class ByteBuffer
 
     protected:
         size_t _rpos, _wpos;
-        std::vector<uint8> _storage;
+        std::vector<uint8, BufferAllocator<uint8>> _storage;
 };
 
 template <typename T>
@@ -22,16 +22,70 @@
 
 #include "DBCFileLoader.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 DBCFileLoader::DBCFileLoader()
 {
     data = nullptr;
     fieldsOffset = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
 }
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
+    Unload();
+
+#ifndef _WIN32
+    // map the file read-only, the string block can then be used in place and stays shared between processes
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 20)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                                              // mapping stays valid
+
+    if (map == MAP_FAILED)
+        return false;
+
+    mapping = map;
+    mappingSize = st.st_size;
+
+    uint32 fileHeader[5];
+    memcpy(fileHeader, mapping, sizeof(fileHeader));
+
+    uint32 header = fileHeader[0];
+    recordCount = fileHeader[1];                            // Number of records
+    fieldCount = fileHeader[2];                             // Number of fields
+    recordSize = fileHeader[3];                             // Size of a record
+    stringSize = fileHeader[4];                             // String size
+
+    EndianConvert(header);
+    EndianConvert(recordCount);
+    EndianConvert(fieldCount);
+    EndianConvert(recordSize);
+    EndianConvert(stringSize);
+
+    if (header != 0x43424457 ||                             //'WDBC'
+            sizeof(fileHeader) + size_t(recordSize) * recordCount + stringSize > mappingSize)
+    {
+        Unload();
+        return false;
+    }
+#else
     uint32 header;
-    delete[] data;
 
     FILE* f = fopen(filename, "rb");
     if (!f)
@@ -83,6 +137,7 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
     }
 
     EndianConvert(stringSize);
+#endif
 
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
@@ -95,6 +150,10 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
             fieldsOffset[i] += 4;
     }
 
+#ifndef _WIN32
+    data = static_cast<unsigned char*>(mapping) + 20;
+    stringTable = data + recordSize * recordCount;
+#else
     data = new unsigned char[recordSize * recordCount + stringSize];
     stringTable = data + recordSize * recordCount;
 
@@ -105,13 +164,40 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
     }
 
     fclose(f);
+#endif
     return true;
 }
 
-DBCFileLoader::~DBCFileLoader()
+void DBCFileLoader::Unload()
 {
-    delete[] data;
+#ifndef _WIN32
+    if (mapping)
+        munmap(mapping, mappingSize);
+    else
+#endif
+        delete[] data;
+
     delete[] fieldsOffset;
+
+    data = nullptr;
+    fieldsOffset = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+DBCFileLoader::~DBCFileLoader()
+{
+    Unload();
+}
+
+DBCStringPool::~DBCStringPool()
+{
+#ifndef _WIN32
+    if (m_mapping)
+        munmap(m_mapping, m_mappingSize);
+#endif
+
+    delete[] m_heapData;
 }
 
 DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
@@ -259,13 +345,25 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
+DBCStringPool* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
 {
     if (strlen(format) != fieldCount)
         return nullptr;
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    DBCStringPool* pool;
+    char* stringPool;
+    if (mapping)
+    {
+        // strings are used straight from the mapping, which is handed over to the pool
+        pool = new DBCStringPool(nullptr, mapping, mappingSize);
+        stringPool = reinterpret_cast<char*>(stringTable);
+    }
+    else
+    {
+        stringPool = new char[stringSize];
+        memcpy(stringPool, stringTable, stringSize);
+        pool = new DBCStringPool(stringPool, nullptr, 0);
+    }
 
     uint32 offset = 0;
 
@@ -311,5 +409,21 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         }
     }
 
-    return stringPool;
+#ifndef _WIN32
+    if (mapping)
+    {
+        // record pages are not needed anymore, only keep the string block resident
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        size_t recordBytes = (stringTable - static_cast<unsigned char*>(mapping)) / pageSize * pageSize;
+        if (recordBytes)
+            madvise(mapping, recordBytes, MADV_DONTNEED);
+
+        // ownership moved to the pool
+        mapping = nullptr;
+        mappingSize = 0;
+        data = nullptr;
+    }
+#endif
+
+    return pool;
 }
@@ -38,6 +38,23 @@ enum FieldFormat
     FT_64BITINT = 'L'                                       // uint64
 };
 
+// Owns the string block that loaded records point into. When the DBC file was memory mapped this is
+// the read-only file mapping itself, so its pages are shared with every process using the same file.
+class DBCStringPool
+{
+    public:
+        ~DBCStringPool();
+
+    private:
+        DBCStringPool(char* heapData, void* mapping, size_t mappingSize) : m_heapData(heapData), m_mapping(mapping), m_mappingSize(mappingSize) {}
+
+        char* m_heapData;
+        void* m_mapping;
+        size_t m_mappingSize;
+
+        friend class DBCFileLoader;
+};
+
 class DBCFileLoader
 {
     public:
@@ -94,9 +111,10 @@ class DBCFileLoader
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
         char* AutoProduceData(const char* format, uint32& records, char**& indexTable);
-        char* AutoProduceStrings(const char* format, char* dataTable);
+        DBCStringPool* AutoProduceStrings(const char* format, char* dataTable);
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = nullptr);
     private:
+        void Unload();
 
         uint32 recordSize;
         uint32 recordCount;
@@ -105,5 +123,8 @@ class DBCFileLoader
         uint32* fieldsOffset;
         unsigned char* data;
         unsigned char* stringTable;
+
+        void* mapping;                                      // whole file, if loaded by mmap (data points into it)
+        size_t mappingSize;
 };
 #endif
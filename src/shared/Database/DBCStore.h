@@ -21,15 +21,36 @@
 
 #include "DBCFileLoader.h"
 
+#include <vector>
+
+#define DBC_INDEX_PAGE_BITS     8
+#define DBC_INDEX_PAGE_SIZE     (1 << DBC_INDEX_PAGE_BITS)
+#define DBC_INDEX_PAGE_MASK     (DBC_INDEX_PAGE_SIZE - 1)
+#define DBC_SPARSE_INDEX_RATIO  4                           // ids per row above which the index is paged
+
+/**
+ * Records of a DBC file indexed by id. Dense ids use one flat pointer table sized to the max id.
+ * When the ids are sparse, fewer than one row per DBC_SPARSE_INDEX_RATIO ids, the table is split
+ * in pages of DBC_INDEX_PAGE_SIZE ids and only the pages holding rows are kept, in one block, so a
+ * lookup stays two loads instead of a search.
+ */
 template<class T>
 class DBCStorage
 {
-        typedef std::list<char*> StringPoolList;
+        typedef std::vector<DBCStringPool*> StringPoolList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_indexPages(nullptr), m_indexPageBlock(nullptr), m_dataTable(nullptr) { }
         ~DBCStorage() { Clear(); }
 
-        T const* LookupEntry(uint32 id) const { return (id >= nCount) ? nullptr : indexTable[id]; }
+        T const* LookupEntry(uint32 id) const
+        {
+            if (id >= nCount)
+                return nullptr;
+            if (indexTable)
+                return indexTable[id];
+            T* const* page = m_indexPages[id >> DBC_INDEX_PAGE_BITS];
+            return page ? page[id & DBC_INDEX_PAGE_MASK] : nullptr;
+        }
         uint32  GetNumRows() const { return nCount; }
         char const* GetFormat() const { return fmt; }
         uint32 GetFieldCount() const { return fieldCount; }
@@ -46,17 +67,21 @@ class DBCStorage
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
-            // load strings from dbc data
+            // error in dbc file at loading if nullptr
+            if (!indexTable)
+                return false;
+
+            // load strings from dbc data, the pools of the locales follow in LoadStringsFrom
             m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
 
-            // error in dbc file at loading if nullptr
-            return indexTable != nullptr;
+            PageIndexIfSparse();
+            return true;
         }
 
         bool LoadStringsFrom(char const* fn)
         {
             // DBC must be already loaded using Load
-            if (!indexTable)
+            if (!m_dataTable)
                 return false;
 
             DBCFileLoader dbc;
@@ -72,32 +97,104 @@ class DBCStorage
 
         void Clear()
         {
-            if (!indexTable)
+            if (!m_dataTable)
                 return;
 
             delete[]((char*)indexTable);
             indexTable = nullptr;
+            delete[] m_indexPages;
+            m_indexPages = nullptr;
+            delete[] m_indexPageBlock;
+            m_indexPageBlock = nullptr;
             delete[]((char*)m_dataTable);
             m_dataTable = nullptr;
 
-            while (!m_stringPoolList.empty())
-            {
-                delete[] m_stringPoolList.front();
-                m_stringPoolList.pop_front();
-            }
+            for (DBCStringPool* pool : m_stringPoolList)
+                delete pool;
+            m_stringPoolList.clear();
             nCount = 0;
         }
 
-        void EraseEntry(uint32 id) { assert(id < nCount && "To be erased entry must be in bounds!") ; indexTable[id] = nullptr; }
-        void InsertEntry(T* entry, uint32 id) { assert(id < nCount && "To be inserted entry must be in bounds!"); indexTable[id] = entry; }
+        bool IsPagedIndex() const { return m_indexPages != nullptr; }
+
+        void EraseEntry(uint32 id)
+        {
+            assert(id < nCount && "To be erased entry must be in bounds!");
+            if (T** slot = GetIndexSlot(id))
+                *slot = nullptr;
+        }
+        void InsertEntry(T* entry, uint32 id)
+        {
+            assert(id < nCount && "To be inserted entry must be in bounds!");
+            T** slot = GetIndexSlot(id);
+            assert(slot && "To be inserted entry must be in a page of the paged index!");
+            *slot = entry;
+        }
 
     private:
+        T** GetIndexSlot(uint32 id)
+        {
+            if (indexTable)
+                return &indexTable[id];
+            T** page = m_indexPages[id >> DBC_INDEX_PAGE_BITS];
+            return page ? &page[id & DBC_INDEX_PAGE_MASK] : nullptr;
+        }
+
+        void PageIndexIfSparse()
+        {
+            uint32 rows = 0;
+            for (uint32 id = 0; id < nCount; ++id)
+                if (indexTable[id])
+                    ++rows;
+
+            // a few pages are not worth the indirection
+            if (nCount < DBC_INDEX_PAGE_SIZE * DBC_SPARSE_INDEX_RATIO || uint64(rows) * DBC_SPARSE_INDEX_RATIO >= nCount)
+                return;
+
+            uint32 pageCount = (nCount + DBC_INDEX_PAGE_MASK) >> DBC_INDEX_PAGE_BITS;
+            uint32 usedPages = 0;
+            for (uint32 page = 0; page < pageCount; ++page)
+            {
+                for (uint32 id = page << DBC_INDEX_PAGE_BITS; id < nCount && id < ((page + 1) << DBC_INDEX_PAGE_BITS); ++id)
+                {
+                    if (indexTable[id])
+                    {
+                        ++usedPages;
+                        break;
+                    }
+                }
+            }
+
+            m_indexPages = new T**[pageCount]();
+            m_indexPageBlock = new T*[usedPages * DBC_INDEX_PAGE_SIZE]();
+
+            T** nextPage = m_indexPageBlock;
+            for (uint32 id = 0; id < nCount; ++id)
+            {
+                if (!indexTable[id])
+                    continue;
+
+                T**& page = m_indexPages[id >> DBC_INDEX_PAGE_BITS];
+                if (!page)
+                {
+                    page = nextPage;
+                    nextPage += DBC_INDEX_PAGE_SIZE;
+                }
+                page[id & DBC_INDEX_PAGE_MASK] = indexTable[id];
+            }
+
+            delete[]((char*)indexTable);
+            indexTable = nullptr;
+        }
+
         uint32 nCount;
         uint32 fieldCount;
         char const* fmt;
-        T** indexTable;
+        T** indexTable;                                     // flat index, nullptr if paged
+        T*** m_indexPages;                                  // paged index, nullptr for pages without rows
+        T** m_indexPageBlock;                               // storage of all pages of the paged index
         T* m_dataTable;
-        StringPoolList m_stringPoolList;
+        StringPoolList m_stringPoolList;                    // one block per loaded locale
 };
 
 #endif
@@ -20,11 +20,13 @@
 #include "Config/Config.h"
 #include "Database/SqlOperations.h"
 
+#include <chrono>
 #include <ctime>
 #include <iostream>
 #include <fstream>
 #include <memory>
 #include <cstdarg>
+#include <thread>
 
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
@@ -35,6 +37,13 @@ SqlPreparedStatement* SqlConnection::CreateStatement(const std::string& fmt)
     return new SqlPlainPreparedStatement(fmt, *this);
 }
 
+QueryResult* SqlConnection::QueryStreamed(const char* sql)
+{
+    QueryResult* result = QueryTyped(sql);
+    m_db.ReturnStreamConnection(this);
+    return result;
+}
+
 void SqlConnection::FreePreparedStatements()
 {
     SqlConnection::Lock guard(this);
@@ -97,7 +106,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nHolderConns /*= 0*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -111,7 +120,11 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    int batchSize = sConfig.GetIntDefault("DatabaseBatchSize", 100);
+    m_asyncBatchSize = batchSize > 1 ? uint32(batchSize) : 1;
+
     // create DB connections
+    m_connectionInfo = infoString;
 
     // setup connection pool size
     if (nConns < MIN_CONNECTION_POOL_SIZE)
@@ -139,7 +152,20 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
-    m_pResultQueue = new SqlResultQueue;
+    // create connections for the holder threads
+    for (int i = 0; i < std::min(nHolderConns, MAX_CONNECTION_POOL_SIZE); ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pHolderConnections.push_back(pConn);
+    }
+
+    m_pResultQueue = std::make_shared<SqlResultQueue>();
 
     InitDelayThread();
     return true;
@@ -149,22 +175,32 @@ void Database::StopServer()
 {
     HaltDelayThread();
 
-    delete m_pResultQueue;
+    m_pResultQueue.reset();
     delete m_pAsyncConn;
 
-    m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
 
+    for (auto& m_pHolderConnection : m_pHolderConnections)
+        delete m_pHolderConnection;
+
+    m_pHolderConnections.clear();
+
     for (auto& m_pQueryConnection : m_pQueryConnections)
         delete m_pQueryConnection;
 
     m_pQueryConnections.clear();
+
+    std::lock_guard<std::mutex> guard(m_streamConnLock);
+    for (auto& m_pStreamConnection : m_pStreamConnections)
+        delete m_pStreamConnection;
+
+    m_pStreamConnections.clear();
 }
 
 SqlDelayThread* Database::CreateDelayThread()
 {
     assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    return new SqlDelayThread(this, m_pAsyncConn, m_asyncBatchSize);
 }
 
 void Database::InitDelayThread()
@@ -174,12 +210,31 @@ void Database::InitDelayThread()
     // New delay thread for delay execute
     m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
     m_delayThread = new MaNGOS::Thread(m_threadBody);
+
+    // holder threads only run single holders, no batching
+    for (SqlConnection* pConn : m_pHolderConnections)
+    {
+        SqlDelayThread* threadBody = new SqlDelayThread(this, pConn);
+        m_holderThreadBodies.push_back(threadBody);
+        m_holderThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
     if (!m_threadBody || !m_delayThread) return;
 
+    // holders wait for the delay thread, so it has to run until they are done
+    for (SqlDelayThread* threadBody : m_holderThreadBodies)
+        threadBody->Stop();
+    for (MaNGOS::Thread* thread : m_holderThreads)
+    {
+        thread->wait();
+        delete thread;                                      // This also deletes its thread body
+    }
+    m_holderThreads.clear();
+    m_holderThreadBodies.clear();
+
     m_threadBody->Stop();                                   // Stop event
     m_delayThread->wait();                                  // Wait for flush to DB
     delete m_delayThread;                                   // This also deletes m_threadBody
@@ -225,6 +280,44 @@ SqlConnection* Database::getQueryConnection()
     return m_pQueryConnections[nCount % m_nQueryConnPoolSize];
 }
 
+SqlConnection* Database::TakeStreamConnection()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_streamConnLock);
+        if (!m_pStreamConnections.empty())
+        {
+            SqlConnection* pConn = m_pStreamConnections.back();
+            m_pStreamConnections.pop_back();
+            return pConn;
+        }
+    }
+
+    SqlConnection* pConn = CreateConnection();
+    if (!pConn->Initialize(m_connectionInfo.c_str()))
+    {
+        delete pConn;
+        return nullptr;
+    }
+
+    return pConn;
+}
+
+void Database::ReturnStreamConnection(SqlConnection* conn)
+{
+    std::lock_guard<std::mutex> guard(m_streamConnLock);
+    m_pStreamConnections.push_back(conn);
+}
+
+QueryResult* Database::QueryStreamed(const char* sql)
+{
+    // a connection of its own, so that the caller can run other queries while reading the rows
+    SqlConnection* pConn = TakeStreamConnection();
+    if (!pConn)
+        return QueryTyped(sql);
+
+    return pConn->QueryStreamed(sql);
+}
+
 void Database::Ping()
 {
     const char* sql = "SELECT 1";
@@ -239,6 +332,46 @@ void Database::Ping()
         SqlConnection::Lock guard(m_pQueryConnections[i]);
         delete guard->Query(sql);
     }
+
+    for (SqlConnection* pConn : m_pHolderConnections)
+    {
+        SqlConnection::Lock guard(pConn);
+        delete guard->Query(sql);
+    }
+
+    std::lock_guard<std::mutex> guard(m_streamConnLock);
+    for (SqlConnection* pConn : m_pStreamConnections)
+        delete pConn->Query(sql);
+}
+
+bool Database::DelayHolder(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback)
+{
+    if (m_holderThreadBodies.empty())
+        return holder->Execute(callback, m_threadBody, GetResultQueue());
+
+    // the holder threads read on their own connections, so wait for what the async connection was asked to write before
+    SqlDelayThread* thread = m_holderThreadBodies[m_holderCounter++ % m_holderThreadBodies.size()];
+    return holder->Execute(callback, thread, GetResultQueue(), m_threadBody);
+}
+
+size_t Database::GetHolderQueueSize() const
+{
+    size_t size = 0;
+    for (SqlDelayThread const* threadBody : m_holderThreadBodies)
+        size += threadBody->GetQueueSize();
+    return size;
+}
+
+void Database::BeginParallelCommits()
+{
+    if (m_holderThreadBodies.empty() || !m_allowAsyncTransactions)
+        return;
+
+    uint64 const delayed = m_threadBody->GetDelayedCount();
+    while (m_threadBody->GetExecutedCount() < delayed)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    m_parallelCommits = true;
 }
 
 bool Database::PExecuteLog(const char* format, ...)
@@ -321,6 +454,44 @@ QueryNamedResult* Database::PQueryNamed(const char* format, ...)
     return QueryNamed(szQuery);
 }
 
+QueryResult* Database::PQueryTyped(const char* format, ...)
+{
+    if (!format) return nullptr;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return nullptr;
+    }
+
+    return QueryTyped(szQuery);
+}
+
+QueryResult* Database::PQueryStreamed(const char* format, ...)
+{
+    if (!format) return nullptr;
+
+    va_list ap;
+    char szQuery [MAX_QUERY_LEN];
+    va_start(ap, format);
+    int res = vsnprintf(szQuery, MAX_QUERY_LEN, format, ap);
+    va_end(ap);
+
+    if (res == -1)
+    {
+        sLog.outError("SQL Query truncated (and not execute) for format: %s", format);
+        return nullptr;
+    }
+
+    return QueryStreamed(szQuery);
+}
+
 bool Database::Execute(const char* sql)
 {
     if (!m_pAsyncConn)
@@ -407,11 +578,27 @@ bool Database::CommitTransaction()
     if (!m_allowAsyncTransactions)
         return CommitTransactionDirect();
 
+    if (m_parallelCommits && !m_holderThreadBodies.empty())
+    {
+        // a thread keeps its holder thread, so its own transactions are still written in order
+        static std::atomic<uint32> threadCounter(0);
+        static thread_local uint32 const threadSlot = threadCounter++;
+        m_holderThreadBodies[threadSlot % m_holderThreadBodies.size()]->Delay(m_currentTransaction.release());
+        return true;
+    }
+
     // add SqlTransaction to the async queue
     m_threadBody->Delay(m_currentTransaction.release());
     return true;
 }
 
+void Database::GetTransactionStats(size_t& statements, size_t& bytes) const
+{
+    SqlTransaction const* pTrans = m_currentTransaction.get();
+    statements = pTrans ? pTrans->GetStatementCount() : 0;
+    bytes = pTrans ? pTrans->GetDataSize() : 0;
+}
+
 bool Database::CommitTransactionDirect()
 {
     if (!m_pAsyncConn)
@@ -48,6 +48,11 @@ class SqlConnection
         // public methods for making queries
         virtual QueryResult* Query(const char* sql) = 0;
         virtual QueryNamedResult* QueryNamed(const char* sql) = 0;
+        // result with the numbers already converted, for the big loads; same as Query where not supported
+        virtual QueryResult* QueryTyped(const char* sql) { return Query(sql); }
+        // only on a stream connection: result read row by row, it gives the connection back to the database
+        // when done; where not supported the rows are read at once and the connection given back right away
+        virtual QueryResult* QueryStreamed(const char* sql);
 
         // public methods for making requests
         virtual bool Execute(const char* sql) = 0;
@@ -60,6 +65,8 @@ class SqlConnection
         virtual bool CommitTransaction() { return true; }
         // can't rollback without transaction support
         virtual bool RollbackTransaction() { return true; }
+        // true if the last failed statement lost a lock conflict (deadlock or lock wait timeout) and may pass if retried
+        virtual bool IsLockConflict() const { return false; }
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
@@ -104,7 +111,8 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        // nHolderConns: extra connections, each with its own thread, running the query holders in parallel
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nHolderConns = 0);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -123,8 +131,24 @@ class Database
             return guard->QueryNamed(sql);
         }
 
+        /// Same results as Query, but the numbers are read from the binary protocol: for the loads of many rows
+        inline QueryResult* QueryTyped(const char* sql)
+        {
+            SqlConnection::Lock guard(getQueryConnection());
+            return guard->QueryTyped(sql);
+        }
+
+        /// Typed result read row by row on a connection of its own, for the loads too big to keep in memory at once.
+        /// The row count is unknown (0), the result has to be read and deleted by the calling thread.
+        QueryResult* QueryStreamed(const char* sql);
+
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
+        QueryResult* PQueryTyped(const char* format, ...) ATTR_PRINTF(2, 3);
+        QueryResult* PQueryStreamed(const char* format, ...) ATTR_PRINTF(2, 3);
+
+        // called by the streamed results once they do not use their connection anymore
+        void ReturnStreamConnection(SqlConnection* conn);
 
         bool DirectExecute(const char* sql) const
         {
@@ -188,6 +212,10 @@ class Database
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // statements and approximate data size queued so far in the transaction open in this thread
+        void GetTransactionStats(size_t& statements, size_t& bytes) const;
+        // true while this thread has a transaction open, to join it instead of nesting one
+        bool IsInTransaction() const { return m_currentTransaction.get() != nullptr; }
 
         // PREPARED STATEMENT API
 
@@ -208,10 +236,24 @@ class Database
 
         // set database-wide result queue. also we should use object-bases and not thread-based result queues
         void ProcessResultQueue();
+        std::shared_ptr<SqlResultQueue> const& GetDefaultResultQueue() const { return m_pResultQueue; }
 
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
+        // statements waiting in the delay thread and how long (ms) the oldest of them had to wait
+        size_t GetAsyncQueueSize() const { return m_threadBody ? m_threadBody->GetQueueSize() : 0; }
+        uint32 GetAsyncQueueLag() const { return m_threadBody ? m_threadBody->GetQueueLag() : 0; }
+        // query holders and parallel commits waiting in the holder threads
+        size_t GetHolderQueueSize() const;
+
+        // for mass saves: while on, the transactions are committed on the holder connections, those of a thread always
+        // on the same one, instead of all on the async connection. Waits first until the async connection wrote what it
+        // was asked to before, so no older write lands over a save. The transactions committed in parallel must not
+        // touch the same rows, the ones still queued when turned off are counted by GetHolderQueueSize()
+        void BeginParallelCommits();
+        void EndParallelCommits() { m_parallelCommits = false; }
+
         // function to ping database connections
         void Ping();
 
@@ -222,9 +264,9 @@ class Database
 
     protected:
         Database() :
-            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
-            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
+            m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr),
+            m_threadBody(nullptr), m_delayThread(nullptr), m_holderCounter(0), m_parallelCommits(false), m_allowAsyncTransactions(false),
+            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0), m_asyncBatchSize(1)
         {
             m_nQueryCounter = -1;
         }
@@ -243,8 +285,17 @@ class Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
+        // an idle stream connection, a new one if all are in use
+        SqlConnection* TakeStreamConnection();
         // for now return one single connection for async requests
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // delays the queries of a holder on the next holder thread, or on the delay thread without holder threads
+        bool DelayHolder(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback);
+        // queue receiving results of async queries started by the calling thread
+        std::shared_ptr<SqlResultQueue> const& GetResultQueue() const
+        {
+            return SqlResultQueueScope::Current() ? SqlResultQueueScope::Current() : m_pResultQueue;
+        }
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
@@ -263,10 +314,22 @@ class Database
         // only one single DB connection for transactions
         SqlConnection* m_pAsyncConn;
 
-        SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
+        std::shared_ptr<SqlResultQueue> m_pResultQueue;     ///< Transaction queues from diff. threads
         SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
         MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
 
+        // connections and threads running query holders, which only read, in parallel to the async connection
+        SqlConnectionContainer m_pHolderConnections;
+        std::vector<SqlDelayThread*> m_holderThreadBodies;  ///< owned by m_holderThreads
+        std::vector<MaNGOS::Thread*> m_holderThreads;
+        std::atomic<uint32> m_holderCounter;                ///< round-robin holder thread selection
+        std::atomic<bool> m_parallelCommits;                ///< transactions go to the holder threads, see BeginParallelCommits
+
+        // connections of the streamed results, the idle ones; each is used by one result at a time
+        std::mutex m_streamConnLock;
+        SqlConnectionContainer m_pStreamConnections;
+        std::string m_connectionInfo;                       ///< to open stream connections on demand
+
         std::atomic<bool> m_allowAsyncTransactions;         ///< flag which specifies if async transactions are enabled
 
         // PREPARED STATEMENT REGISTRY
@@ -285,5 +348,6 @@ class Database
         bool m_logSQL;
         std::string m_logsDir;
         uint32 m_pingIntervallms;
+        uint32 m_asyncBatchSize;
 };
 #endif
@@ -240,6 +240,92 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     return new QueryNamedResult(queryResult, names);
 }
 
+QueryResult* MySQLConnection::QueryTyped(const char* sql)
+{
+    if (!mMysql)
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+        return Query(sql);
+
+    // statements without result set or that can not be prepared are run as plain query
+    MYSQL_RES* metadata = nullptr;
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) || !(metadata = mysql_stmt_result_metadata(stmt)))
+    {
+        mysql_stmt_close(stmt);
+        return Query(sql);
+    }
+
+    // the sizes of the text buffers
+    MysqlBool updateMaxLength = 1;
+    mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    if (mysql_stmt_execute(stmt) || mysql_stmt_store_result(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    QueryResultMysqlTyped* queryResult = nullptr;
+    if (uint64 rowCount = mysql_stmt_num_rows(stmt))
+    {
+        queryResult = new QueryResultMysqlTyped(stmt, mysql_fetch_fields(metadata), rowCount, mysql_num_fields(metadata));
+        if (!queryResult->NextRow())
+        {
+            delete queryResult;
+            queryResult = nullptr;
+        }
+    }
+
+    // all rows are copied, the statement is closed while the connection is still locked
+    mysql_free_result(metadata);
+    mysql_stmt_close(stmt);
+    return queryResult;
+}
+
+QueryResult* MySQLConnection::QueryStreamed(const char* sql)
+{
+    uint32 _s = WorldTimer::getMSTime();
+
+    MYSQL_STMT* stmt = mMysql ? mysql_stmt_init(mMysql) : nullptr;
+    MYSQL_RES* metadata = nullptr;
+    if (!stmt || mysql_stmt_prepare(stmt, sql, strlen(sql)) || !(metadata = mysql_stmt_result_metadata(stmt)))
+    {
+        if (stmt)
+            mysql_stmt_close(stmt);
+        return SqlConnection::QueryStreamed(sql);
+    }
+
+    // without mysql_stmt_store_result the rows stay on the server until fetched
+    if (mysql_stmt_execute(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        mysql_free_result(metadata);
+        mysql_stmt_close(stmt);
+        m_db.ReturnStreamConnection(this);
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    // the result gives the connection back once it is done
+    QueryResultMysqlStreamed* queryResult = new QueryResultMysqlStreamed(this, stmt, metadata);
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    return queryResult;
+}
+
 bool MySQLConnection::Execute(const char* sql)
 {
     if (!mMysql)
@@ -288,6 +374,13 @@ bool MySQLConnection::RollbackTransaction()
     return _TransactionCmd("ROLLBACK");
 }
 
+bool MySQLConnection::IsLockConflict() const
+{
+    // ER_LOCK_DEADLOCK and ER_LOCK_WAIT_TIMEOUT, the prepared statements report their errors on the connection as well
+    unsigned int const error = mMysql ? mysql_errno(mMysql) : 0;
+    return error == 1213 || error == 1205;
+}
+
 unsigned long MySQLConnection::escape_string(char* to, const char* from, unsigned long length)
 {
     if (!mMysql || !to || !from || !length)
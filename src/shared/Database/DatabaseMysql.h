@@ -71,6 +71,8 @@ class MySQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryTyped(const char* sql) override;
+        QueryResult* QueryStreamed(const char* sql) override;
         bool Execute(const char* sql) override;
 
         unsigned long escape_string(char* to, const char* from, unsigned long length);
@@ -78,6 +80,7 @@ class MySQLConnection : public SqlConnection
         bool BeginTransaction() override;
         bool CommitTransaction() override;
         bool RollbackTransaction() override;
+        bool IsLockConflict() const override;
 
     protected:
         SqlPreparedStatement* CreateStatement(const std::string& fmt) override;
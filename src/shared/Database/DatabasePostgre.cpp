@@ -150,6 +150,34 @@ QueryResult* PostgreSQLConnection::Query(const char* sql)
     return queryResult;
 }
 
+QueryResult* PostgreSQLConnection::QueryStreamed(const char* sql)
+{
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (!mPGconn || !PQsendQuery(mPGconn, sql))
+    {
+        sLog.outErrorDb("SQL : %s", sql);
+        if (mPGconn)
+            sLog.outErrorDb("SQL %s", PQerrorMessage(mPGconn));
+        m_db.ReturnStreamConnection(this);
+        return nullptr;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    // without the mode the result is still read correctly, just at once
+    PQsetSingleRowMode(mPGconn);
+
+    // the result gives the connection back once it is done
+    QueryResultPostgreStreamed* queryResult = new QueryResultPostgreStreamed(this, mPGconn);
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    return queryResult;
+}
+
 QueryNamedResult* PostgreSQLConnection::QueryNamed(const char* sql)
 {
     if (!mPGconn)
@@ -42,6 +42,7 @@ class PostgreSQLConnection : public SqlConnection
 
         QueryResult* Query(const char* sql) override;
         QueryNamedResult* QueryNamed(const char* sql) override;
+        QueryResult* QueryStreamed(const char* sql) override;
         bool Execute(const char* sql) override;
 
         unsigned long escape_string(char* to, const char* from, unsigned long length);
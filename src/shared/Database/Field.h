@@ -34,31 +34,73 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN), mStorage(STORAGE_TEXT) {}
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mStorage(STORAGE_TEXT) {}
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
-        bool IsNULL() const { return mValue == nullptr; }
+        bool IsNULL() const { return mStorage == STORAGE_TEXT && mValue == nullptr; }
 
         const char* GetString() const
         {
+            if (mStorage != STORAGE_TEXT)
+                return FormatNative();
             return mValue ? mValue : ""; // We need this null check as we do not always null check what we get back from the database everywhere
         }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            return GetString();                             // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<float>(GetNativeDouble());
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return GetNativeInteger() > 0;
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        int32 GetInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int32>(GetNativeInteger());
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
+        uint8 GetUInt8() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint8>(GetNativeInteger());
+            return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0);
+        }
+        uint16 GetUInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint16>(GetNativeInteger());
+            return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0);
+        }
+        int16 GetInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int16>(GetNativeInteger());
+            return mValue ? static_cast<int16>(atol(mValue)) : int16(0);
+        }
+        uint32 GetUInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint32>(GetNativeInteger());
+            return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0);
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mStorage == STORAGE_UINT64)
+                return mNative.u;
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint64>(GetNativeInteger());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -69,13 +111,63 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mStorage = STORAGE_TEXT; }
+        // typed results store the numbers themselves, the getters then convert without parsing
+        void SetInt64Value(int64 value) { mNative.i = value; mStorage = STORAGE_INT64; }
+        void SetUInt64Value(uint64 value) { mNative.u = value; mStorage = STORAGE_UINT64; }
+        void SetDoubleValue(double value) { mNative.d = value; mStorage = STORAGE_DOUBLE; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        enum Storage
+        {
+            STORAGE_TEXT,                                   // mValue, nullptr for NULL
+            STORAGE_INT64,
+            STORAGE_UINT64,
+            STORAGE_DOUBLE
+        };
+
+        // same results as the conversion of the text of the number
+        int64 GetNativeInteger() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_UINT64: return static_cast<int64>(mNative.u);
+                case STORAGE_DOUBLE: return static_cast<int64>(mNative.d);
+                default:             return mNative.i;
+            }
+        }
+        double GetNativeDouble() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_UINT64: return static_cast<double>(mNative.u);
+                case STORAGE_DOUBLE: return mNative.d;
+                default:             return static_cast<double>(mNative.i);
+            }
+        }
+        const char* FormatNative() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_UINT64: snprintf(mText, sizeof(mText), UI64FMTD, mNative.u); break;
+                case STORAGE_DOUBLE: snprintf(mText, sizeof(mText), "%.17g", mNative.d); break;
+                default:             snprintf(mText, sizeof(mText), SI64FMTD, mNative.i); break;
+            }
+            return mText;
+        }
+
         const char* mValue;
+        union
+        {
+            int64 i;
+            uint64 u;
+            double d;
+        } mNative;
         enum DataTypes mType;
+        Storage mStorage;
+        mutable char mText[32];                             // GetString of a typed number
 };
 #endif
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Errors.h"
 #include "Field.h"
+#include "Utilities/MemoryAccounting.h"
 
 class QueryResult
 {
@@ -31,6 +32,9 @@ class QueryResult
 
         virtual ~QueryResult() {}
 
+        static void* operator new(size_t size) { return MemoryAccounting::Allocate(MEMORY_TAG_DB_RESULTS, size); }
+        static void operator delete(void* ptr, size_t size) { MemoryAccounting::Deallocate(MEMORY_TAG_DB_RESULTS, ptr, size); }
+
         virtual bool NextRow() = 0;
 
         Field* Fetch() const { return mCurrentRow; }
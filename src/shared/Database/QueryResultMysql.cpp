@@ -21,6 +21,8 @@
 #include "DatabaseEnv.h"
 #include "Errors.h"
 
+#include <memory>
+
 QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
     QueryResult(rowCount, fieldCount), mResult(result)
 {
@@ -66,7 +68,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -96,4 +98,286 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+MysqlRowBuffer::MysqlRowBuffer(MYSQL_FIELD* fields, uint32 fieldCount) : m_fieldCount(fieldCount),
+    m_storages(fieldCount), m_binds(fieldCount), m_numbers(fieldCount), m_texts(fieldCount), m_lengths(fieldCount),
+    m_nulls(new MysqlBool[fieldCount]()), m_errors(new MysqlBool[fieldCount]())
+{
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        MYSQL_BIND& bind = m_binds[i];
+        memset(&bind, 0, sizeof(MYSQL_BIND));
+
+        // decimals stay text, a double would not keep all their digits
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+                m_storages[i] = (fields[i].flags & UNSIGNED_FLAG) ? COLUMN_UINT64 : COLUMN_INT64;
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = m_storages[i] == COLUMN_UINT64;
+                bind.buffer = &m_numbers[i];
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                m_storages[i] = COLUMN_DOUBLE;
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &m_numbers[i];
+                break;
+            default:
+                // max_length is only known for stored results, else start small, longer texts are fetched again
+                m_storages[i] = COLUMN_TEXT;
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                BindText(i, fields[i].max_length ? fields[i].max_length : std::min<unsigned long>(fields[i].length, 1024));
+                break;
+        }
+
+        bind.length = &m_lengths[i];
+        bind.is_null = &m_nulls[i];
+        bind.error = &m_errors[i];
+    }
+}
+
+void MysqlRowBuffer::BindText(uint32 i, unsigned long length)
+{
+    m_texts[i].resize(length + 1);
+    m_binds[i].buffer = m_texts[i].data();
+    m_binds[i].buffer_length = length;
+}
+
+bool MysqlRowBuffer::Bind(MYSQL_STMT* stmt)
+{
+    if (mysql_stmt_bind_result(stmt, m_binds.data()))
+    {
+        sLog.outErrorDb("SQL: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(stmt));
+        return false;
+    }
+    return true;
+}
+
+int MysqlRowBuffer::Fetch(MYSQL_STMT* stmt)
+{
+    int fetched = mysql_stmt_fetch(stmt);
+    if (fetched == MYSQL_NO_DATA)
+        return fetched;
+
+    if (fetched != 0 && fetched != MYSQL_DATA_TRUNCATED)
+    {
+        sLog.outErrorDb("SQL: mysql_stmt_fetch() failed: %s", mysql_stmt_error(stmt));
+        return 1;
+    }
+
+    bool rebind = false;
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        if (m_storages[i] != COLUMN_TEXT || m_nulls[i])
+            continue;
+
+        if (m_lengths[i] > m_binds[i].buffer_length)
+        {
+            unsigned long length = m_lengths[i];
+            BindText(i, length);
+            if (mysql_stmt_fetch_column(stmt, &m_binds[i], i, 0))
+                m_lengths[i] = 0;
+            m_lengths[i] = std::min(m_lengths[i], length);
+            rebind = true;
+        }
+
+        m_texts[i][m_lengths[i]] = '\0';
+    }
+
+    // the grown buffers for the next rows
+    if (rebind && !Bind(stmt))
+        return 1;
+
+    return 0;
+}
+
+void MysqlRowBuffer::SetField(uint32 i, Field& field) const
+{
+    if (m_nulls[i])
+    {
+        field.SetValue(nullptr);
+        return;
+    }
+
+    switch (m_storages[i])
+    {
+        case COLUMN_TEXT:
+            field.SetValue(m_texts[i].data());
+            break;
+        case COLUMN_INT64:
+            field.SetInt64Value(static_cast<int64>(m_numbers[i]));
+            break;
+        case COLUMN_UINT64:
+            field.SetUInt64Value(m_numbers[i]);
+            break;
+        case COLUMN_DOUBLE:
+        {
+            double number;
+            memcpy(&number, &m_numbers[i], sizeof(number));
+            field.SetDoubleValue(number);
+            break;
+        }
+    }
+}
+
+QueryResultMysqlTyped::QueryResultMysqlTyped(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mColumns(fieldCount), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    MysqlRowBuffer row(fields, mFieldCount);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+        mColumns[i].storage = row.GetStorage(i);
+        mColumns[i].values.reserve(rowCount);
+        mColumns[i].nulls.reserve(rowCount);
+    }
+
+    uint64 rowIdx = 0;
+    if (row.Bind(stmt))
+    {
+        for (; rowIdx < rowCount && row.Fetch(stmt) == 0; ++rowIdx)
+        {
+            for (uint32 i = 0; i < mFieldCount; ++i)
+            {
+                Column& column = mColumns[i];
+                column.nulls.push_back(row.IsNull(i));
+
+                if (row.IsNull(i))
+                    column.values.push_back(0);
+                else if (column.storage != MysqlRowBuffer::COLUMN_TEXT)
+                    column.values.push_back(row.GetNumber(i));
+                else
+                {
+                    column.values.push_back(mText.size());
+                    mText.insert(mText.end(), row.GetText(i), row.GetText(i) + row.GetTextLength(i) + 1);
+                }
+            }
+        }
+    }
+
+    mRowCount = rowIdx;
+}
+
+QueryResultMysqlTyped::~QueryResultMysqlTyped()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlTyped::NextRow()
+{
+    if (!mCurrentRow)
+        return false;
+
+    if (mNextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Column const& column = mColumns[i];
+        uint64 value = column.values[mNextRow];
+
+        if (column.nulls[mNextRow])
+        {
+            mCurrentRow[i].SetValue(nullptr);
+            continue;
+        }
+
+        switch (column.storage)
+        {
+            case MysqlRowBuffer::COLUMN_TEXT:
+                mCurrentRow[i].SetValue(&mText[value]);
+                break;
+            case MysqlRowBuffer::COLUMN_INT64:
+                mCurrentRow[i].SetInt64Value(static_cast<int64>(value));
+                break;
+            case MysqlRowBuffer::COLUMN_UINT64:
+                mCurrentRow[i].SetUInt64Value(value);
+                break;
+            case MysqlRowBuffer::COLUMN_DOUBLE:
+            {
+                double number;
+                memcpy(&number, &value, sizeof(number));
+                mCurrentRow[i].SetDoubleValue(number);
+                break;
+            }
+        }
+    }
+
+    ++mNextRow;
+    return true;
+}
+
+void QueryResultMysqlTyped::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    std::vector<Column>().swap(mColumns);
+    std::vector<char>().swap(mText);
+}
+
+QueryResultMysqlStreamed::QueryResultMysqlStreamed(SqlConnection* conn, MYSQL_STMT* stmt, MYSQL_RES* metadata) :
+    QueryResult(0, mysql_num_fields(metadata)), mConnection(conn), mStmt(stmt), mMetadata(metadata),
+    mRow(mysql_fetch_fields(metadata), mysql_num_fields(metadata))
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+
+    if (!mRow.Bind(mStmt))
+        EndQuery();
+}
+
+QueryResultMysqlStreamed::~QueryResultMysqlStreamed()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStreamed::NextRow()
+{
+    if (!mStmt)
+        return false;
+
+    if (mRow.Fetch(mStmt) != 0)
+    {
+        EndQuery();
+        return false;
+    }
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mRow.SetField(i, mCurrentRow[i]);
+
+    return true;
+}
+
+void QueryResultMysqlStreamed::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    if (!mStmt)
+        return;
+
+    // closing reads the rows not fetched yet, the connection is free for the next stream afterwards
+    mysql_free_result(mMetadata);
+    mysql_stmt_close(mStmt);
+    mMetadata = nullptr;
+    mStmt = nullptr;
+
+    mConnection->DB().ReturnStreamConnection(mConnection);
+}
 #endif
@@ -28,6 +28,12 @@
 #endif
 
 #include <mysql.h>
+#include <memory>
+
+class SqlConnection;
+
+// my_bool in older client libraries, bool since MySQL 8
+typedef decltype(MYSQL_BIND::is_null_value) MysqlBool;
 
 class QueryResultMysql : public QueryResult
 {
@@ -38,11 +44,113 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES* mResult;
 };
+
+/**
+ * Typed buffers for one row of a prepared statement: integers and floats are fetched as numbers in
+ * the binary protocol, everything else as null terminated text.
+ */
+class MysqlRowBuffer
+{
+    public:
+        enum ColumnStorage
+        {
+            COLUMN_TEXT,
+            COLUMN_INT64,
+            COLUMN_UINT64,
+            COLUMN_DOUBLE
+        };
+
+        MysqlRowBuffer(MYSQL_FIELD* fields, uint32 fieldCount);
+
+        bool Bind(MYSQL_STMT* stmt);
+        // 0 for a row, MYSQL_NO_DATA after the last one, 1 on error; texts longer than their buffer are fetched again
+        int Fetch(MYSQL_STMT* stmt);
+
+        ColumnStorage GetStorage(uint32 i) const { return m_storages[i]; }
+        bool IsNull(uint32 i) const { return m_nulls[i] != 0; }
+        uint64 GetNumber(uint32 i) const { return m_numbers[i]; } // the bits of the double for COLUMN_DOUBLE
+        char const* GetText(uint32 i) const { return m_texts[i].data(); }
+        unsigned long GetTextLength(uint32 i) const { return m_lengths[i]; }
+
+        // the value of the current row, valid until the next fetch
+        void SetField(uint32 i, Field& field) const;
+
+    private:
+        void BindText(uint32 i, unsigned long length);
+
+        uint32 m_fieldCount;
+        std::vector<ColumnStorage> m_storages;
+        std::vector<MYSQL_BIND> m_binds;
+        std::vector<uint64> m_numbers;
+        std::vector<std::vector<char>> m_texts;             // one more byte than bound, for the terminator
+        std::vector<unsigned long> m_lengths;
+        std::unique_ptr<MysqlBool[]> m_nulls;               // not vectors, bound by address and MysqlBool may be bool
+        std::unique_ptr<MysqlBool[]> m_errors;
+};
+
+/**
+ * Result of a query run as prepared statement. The rows arrive in the binary protocol and are copied
+ * into typed column buffers, so the numbers reach the fields without being printed and parsed again.
+ *
+ * All rows are copied in the constructor; the statement can be closed right after, the result does
+ * not use the connection anymore and may be read and deleted by any thread.
+ */
+class QueryResultMysqlTyped : public QueryResult
+{
+    public:
+        // stmt has to be executed with its result stored
+        QueryResultMysqlTyped(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlTyped();
+
+        bool NextRow() override;
+
+    private:
+        struct Column
+        {
+            MysqlRowBuffer::ColumnStorage storage;
+            std::vector<uint64> values;                     // per row the bits of the number, or the offset of the text
+            std::vector<bool> nulls;
+        };
+
+        void EndQuery();
+
+        std::vector<Column> mColumns;
+        std::vector<char> mText;                            // null terminated texts of all text columns
+        uint64 mNextRow;
+};
+
+/**
+ * Result of a prepared statement read row by row from the server, without holding the whole result
+ * in memory. The row count is unknown, GetRowCount returns 0.
+ *
+ * The statement runs on a stream connection of the database, which is given back when the last row
+ * was read or the result is deleted. Read and delete it on the thread that ran the query.
+ */
+class QueryResultMysqlStreamed : public QueryResult
+{
+    public:
+        // stmt has to be executed without storing its result
+        QueryResultMysqlStreamed(SqlConnection* conn, MYSQL_STMT* stmt, MYSQL_RES* metadata);
+
+        ~QueryResultMysqlStreamed();
+
+        bool NextRow() override;
+
+    private:
+        void EndQuery();
+
+        SqlConnection* mConnection;
+        MYSQL_STMT* mStmt;
+        MYSQL_RES* mMetadata;
+        MysqlRowBuffer mRow;
+};
 #endif
 #endif
@@ -74,7 +74,7 @@ void QueryResultPostgre::EndQuery()
 }
 
 // see types in #include <postgre/pg_type.h>
-enum Field::DataTypes QueryResultPostgre::ConvertNativeType(Oid  pOid) const
+enum Field::DataTypes QueryResultPostgre::ConvertNativeType(Oid  pOid)
 {
     switch (pOid)
     {
@@ -130,4 +130,81 @@ enum Field::DataTypes QueryResultPostgre::ConvertNativeType(Oid  pOid) const
     }
     return Field::DB_TYPE_UNKNOWN;
 }
+
+QueryResultPostgreStreamed::QueryResultPostgreStreamed(SqlConnection* conn, PGconn* pgConn) :
+    QueryResult(0, 0), mConnection(conn), mPGconn(pgConn), mResult(nullptr), mRowIndex(0)
+{
+}
+
+QueryResultPostgreStreamed::~QueryResultPostgreStreamed()
+{
+    EndQuery();
+}
+
+bool QueryResultPostgreStreamed::NextRow()
+{
+    if (!mPGconn)
+        return false;
+
+    // a result per row in single row mode, an empty one at the end; all rows at once if the mode was refused
+    while (!mResult || mRowIndex >= PQntuples(mResult))
+    {
+        PQclear(mResult);
+        mResult = PQgetResult(mPGconn);
+        mRowIndex = 0;
+
+        if (!mResult)
+        {
+            EndQuery();
+            return false;
+        }
+
+        ExecStatusType status = PQresultStatus(mResult);
+        if (status != PGRES_SINGLE_TUPLE && status != PGRES_TUPLES_OK)
+        {
+            sLog.outErrorDb("SQL %s", PQerrorMessage(mPGconn));
+            EndQuery();
+            return false;
+        }
+
+        if (!mCurrentRow)
+        {
+            mFieldCount = PQnfields(mResult);
+            mCurrentRow = new Field[mFieldCount];
+            for (uint32 i = 0; i < mFieldCount; ++i)
+                mCurrentRow[i].SetType(QueryResultPostgre::ConvertNativeType(PQftype(mResult, i)));
+        }
+    }
+
+    for (uint32 j = 0; j < mFieldCount; ++j)
+    {
+        char* pPQgetvalue = PQgetvalue(mResult, mRowIndex, j);
+        if (pPQgetvalue && !(*pPQgetvalue))
+            pPQgetvalue = nullptr;
+
+        mCurrentRow[j].SetValue(pPQgetvalue);
+    }
+    ++mRowIndex;
+
+    return true;
+}
+
+void QueryResultPostgreStreamed::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    if (!mPGconn)
+        return;
+
+    // the connection only takes the next query once all results are read
+    PQclear(mResult);
+    while (PGresult* result = PQgetResult(mPGconn))
+        PQclear(result);
+
+    mResult = nullptr;
+    mPGconn = nullptr;
+
+    mConnection->DB().ReturnStreamConnection(mConnection);
+}
 #endif
@@ -80,11 +80,40 @@ class QueryResultPostgre : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(Oid pOid);
+
     private:
-        enum Field::DataTypes ConvertNativeType(Oid pOid) const;
         void EndQuery();
 
         PGresult* mResult;
         uint32 mTableIndex;
 };
+
+class SqlConnection;
+
+/**
+ * Result of a query sent in single row mode, read row by row from the server without holding the
+ * whole result in memory. The row count is unknown, GetRowCount returns 0.
+ *
+ * The query runs on a stream connection of the database, which is given back when the last row
+ * was read or the result is deleted. Read and delete it on the thread that ran the query.
+ */
+class QueryResultPostgreStreamed : public QueryResult
+{
+    public:
+        // the query has to be sent already
+        QueryResultPostgreStreamed(SqlConnection* conn, PGconn* pgConn);
+
+        ~QueryResultPostgreStreamed();
+
+        bool NextRow() override;
+
+    private:
+        void EndQuery();
+
+        SqlConnection* mConnection;
+        PGconn* mPGconn;
+        PGresult* mResult;                                  // one row in single row mode
+        int mRowIndex;
+};
 #endif
@@ -17,9 +17,21 @@
  */
 
 #include "SQLStorage.h"
+#include "revision.h"
+
+#include <cstdio>
+
+#ifndef REVISION_ID
+#define REVISION_ID "unknown"
+#endif
 
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
+#define SQL_STORAGE_CACHE_MAGIC   0x43535153                // "SQSC"
+#define SQL_STORAGE_CACHE_VERSION 1
+
+std::string SQLStorageBase::m_cacheDirectory;
+
 SQLStorageBase::SQLStorageBase() :
     m_tableName(nullptr),
     m_entry_field(nullptr),
@@ -120,6 +132,222 @@ void SQLStorageBase::Free()
     m_recordCount = 0;
 }
 
+std::vector<uint32> SQLStorageBase::GetStringFieldOffsets() const
+{
+    std::vector<uint32> offsets;
+
+    uint32 offset = 0;
+    for (uint32 x = 0; x < m_dstFieldCount; ++x)
+    {
+        switch (m_dst_format[x])
+        {
+            case FT_LOGIC:
+                offset += sizeof(bool);
+                break;
+            case FT_STRING:
+                offsets.push_back(offset);
+                offset += sizeof(char*);
+                break;
+            case FT_NA:
+            case FT_INT:
+                offset += sizeof(uint32);
+                break;
+            case FT_BYTE:
+            case FT_NA_BYTE:
+                offset += sizeof(char);
+                break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:
+                offset += sizeof(float);
+                break;
+            case FT_NA_POINTER:
+                offset += sizeof(char*);
+                break;
+            case FT_64BITINT:
+                offset += sizeof(uint64);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return offsets;
+}
+
+std::string SQLStorageBase::GetCacheFileName() const
+{
+    return m_cacheDirectory + m_tableName + ".cache";
+}
+
+bool SQLStorageBase::CanUseCache() const
+{
+    if (m_cacheDirectory.empty())
+        return false;
+
+    // default filled pointers are set up by the loader itself, they can not be restored from file
+    return strchr(m_dst_format, FT_NA_POINTER) == nullptr;
+}
+
+// Cache file layout: header, record ids, raw record block (string slots zeroed), then all strings
+// (length prefixed, record by record). Any mismatch in header means the file is outdated.
+struct SQLStorageCacheHeader
+{
+    uint32 magic;
+    uint32 version;
+    char revision[64];
+    char format[256];
+    uint64 checksum;
+    uint32 maxEntry;
+    uint32 recordCount;
+    uint32 recordSize;
+};
+
+static void FillCacheHeader(SQLStorageCacheHeader& header, char const* format, uint64 checksum, uint32 recordSize)
+{
+    memset(&header, 0, sizeof(header));
+    header.magic = SQL_STORAGE_CACHE_MAGIC;
+    header.version = SQL_STORAGE_CACHE_VERSION;
+    strncpy(header.revision, REVISION_ID, sizeof(header.revision) - 1);
+    strncpy(header.format, format, sizeof(header.format) - 1);
+    header.checksum = checksum;
+    header.recordSize = recordSize;
+}
+
+bool SQLStorageBase::LoadFromCache(uint64 checksum, uint32 recordSize)
+{
+    std::string fileName = GetCacheFileName();
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    SQLStorageCacheHeader expected;
+    FillCacheHeader(expected, m_dst_format, checksum, recordSize);
+
+    SQLStorageCacheHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+            header.magic != expected.magic || header.version != expected.version ||
+            memcmp(header.revision, expected.revision, sizeof(header.revision)) != 0 ||
+            memcmp(header.format, expected.format, sizeof(header.format)) != 0 ||
+            header.checksum != expected.checksum || header.recordSize != expected.recordSize)
+    {
+        fclose(file);
+        return false;
+    }
+
+    std::vector<uint32> recordIds(header.recordCount);
+    if (header.recordCount && fread(recordIds.data(), sizeof(uint32), header.recordCount, file) != header.recordCount)
+    {
+        fclose(file);
+        return false;
+    }
+
+    prepareToLoad(header.maxEntry, header.recordCount, recordSize);
+
+    bool ok = !header.recordCount || fread(m_data, recordSize, header.recordCount, file) == header.recordCount;
+
+    // stored pointers are meaningless, clear them before anything can try to free them
+    std::vector<uint32> stringOffsets = GetStringFieldOffsets();
+    char* const noString = nullptr;
+    for (uint32 recordItr = 0; recordItr < header.recordCount; ++recordItr)
+        for (uint32 offset : stringOffsets)
+            memcpy(m_data + recordItr * recordSize + offset, &noString, sizeof(char*));
+
+    for (uint32 recordId : recordIds)
+        createRecord(recordId);
+
+    for (uint32 recordItr = 0; ok && recordItr < m_recordCount; ++recordItr)
+    {
+        for (uint32 offset : stringOffsets)
+        {
+            uint32 length;
+            if (fread(&length, sizeof(length), 1, file) != 1)
+            {
+                ok = false;
+                break;
+            }
+
+            char* str = new char[length + 1];
+            memcpy(m_data + recordItr * recordSize + offset, &str, sizeof(char*));
+            if (length && fread(str, 1, length, file) != length)
+            {
+                ok = false;
+                break;
+            }
+            str[length] = 0;
+        }
+    }
+
+    fclose(file);
+
+    if (!ok)
+    {
+        sLog.outError("Cache file %s is damaged, loading table %s from database.", fileName.c_str(), m_tableName);
+        Free();
+        return false;
+    }
+
+    sLog.outDetail("Table %s loaded from cache file %s", m_tableName, fileName.c_str());
+    return true;
+}
+
+void SQLStorageBase::SaveToCache(uint64 checksum, std::vector<uint32> const& recordIds) const
+{
+    std::string fileName = GetCacheFileName();
+    std::string tmpFileName = fileName + ".tmp";
+
+    FILE* file = fopen(tmpFileName.c_str(), "wb");
+    if (!file)
+    {
+        sLog.outError("Can't create cache file %s for table %s", tmpFileName.c_str(), m_tableName);
+        return;
+    }
+
+    SQLStorageCacheHeader header;
+    FillCacheHeader(header, m_dst_format, checksum, m_recordSize);
+    header.maxEntry = m_maxEntry;
+    header.recordCount = m_recordCount;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && m_recordCount)
+        ok = fwrite(recordIds.data(), sizeof(uint32), m_recordCount, file) == m_recordCount;
+
+    std::vector<uint32> stringOffsets = GetStringFieldOffsets();
+    std::vector<char> record(m_recordSize);
+    char* const noString = nullptr;
+    for (uint32 recordItr = 0; ok && recordItr < m_recordCount; ++recordItr)
+    {
+        memcpy(record.data(), m_data + recordItr * m_recordSize, m_recordSize);
+        for (uint32 offset : stringOffsets)
+            memcpy(record.data() + offset, &noString, sizeof(char*));
+
+        ok = fwrite(record.data(), m_recordSize, 1, file) == 1;
+    }
+
+    for (uint32 recordItr = 0; ok && recordItr < m_recordCount; ++recordItr)
+    {
+        for (uint32 offset : stringOffsets)
+        {
+            char const* str;
+            memcpy(&str, m_data + recordItr * m_recordSize + offset, sizeof(char*));
+            uint32 length = str ? strlen(str) : 0;
+
+            ok = fwrite(&length, sizeof(length), 1, file) == 1 && (!length || fwrite(str, 1, length, file) == length);
+            if (!ok)
+                break;
+        }
+    }
+
+    if (fclose(file) != 0)
+        ok = false;
+
+    remove(fileName.c_str());                               // rename does not replace existing files on all platforms
+    if (!ok || rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    {
+        sLog.outError("Can't write cache file %s for table %s", fileName.c_str(), m_tableName);
+        remove(tmpFileName.c_str());
+    }
+}
+
 // -----------------------------------  SQLStorage  -------------------------------------------- //
 
 void SQLStorage::EraseEntry(uint32 id)
@@ -64,6 +64,9 @@ class SQLStorageBase
         template<typename T>
         SQLSIterator<T> getDataEnd() const { return SQLSIterator<T>(m_data + m_recordCount * m_recordSize, m_recordSize); }
 
+        // Directory for binary snapshots of loaded tables, empty string disables the cache
+        static void SetCacheDirectory(std::string const& dir) { m_cacheDirectory = dir; }
+
     protected:
         SQLStorageBase();
         virtual ~SQLStorageBase() { Free(); }
@@ -78,8 +81,14 @@ class SQLStorageBase
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
         virtual void Free();
 
+        bool CanUseCache() const;
+        bool LoadFromCache(uint64 checksum, uint32 recordSize);
+        void SaveToCache(uint64 checksum, std::vector<uint32> const& recordIds) const;
+
     private:
         char* createRecord(uint32 recordId);
+        std::string GetCacheFileName() const;
+        std::vector<uint32> GetStringFieldOffsets() const;
 
         // Information about the table
         const char* m_tableName;
@@ -96,6 +105,8 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data;
+
+        static std::string m_cacheDirectory;
 };
 
 class SQLStorage : public SQLStorageBase
@@ -248,6 +259,9 @@ template <class DerivedLoader, class StorageClass>
 class SQLStorageLoaderBase
 {
     public:
+        // loaders whose conversions depend on other runtime state (script names, ...) must not use the table cache
+        static bool const cacheable = false;
+
         void Load(StorageClass& store, bool error_at_empty = true);
 
         template<class S, class D>
@@ -273,6 +287,7 @@ class SQLStorageLoaderBase
         template<class V>
         void storeValue(V value, StorageClass& store, char* p, uint32 x, uint32& offset);
         void storeValue(char const* value, StorageClass& store, char* p, uint32 x, uint32& offset);
+        bool GetTableChecksum(StorageClass const& store, uint64& checksum) const;
 
         // trap, no body
         void storeValue(char* value, StorageClass& store, char* record, uint32 field_pos, uint32& offset);
@@ -280,14 +295,20 @@ class SQLStorageLoaderBase
 
 class SQLStorageLoader : public SQLStorageLoaderBase<SQLStorageLoader, SQLStorage>
 {
+    public:
+        static bool const cacheable = true;
 };
 
 class SQLHashStorageLoader : public SQLStorageLoaderBase<SQLHashStorageLoader, SQLHashStorage>
 {
+    public:
+        static bool const cacheable = true;
 };
 
 class SQLMultiStorageLoader : public SQLStorageLoaderBase<SQLMultiStorageLoader, SQLMultiStorage>
 {
+    public:
+        static bool const cacheable = true;
 };
 
 #include "SQLStorageImpl.h"
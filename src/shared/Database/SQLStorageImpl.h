@@ -213,6 +213,49 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::storeValue(char const* v
 template<class DerivedLoader, class StorageClass>
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    uint32 recordsize = 0;
+
+    // get struct size
+    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
+    {
+        switch (store.GetDstFormat(x))
+        {
+            case FT_LOGIC:
+                recordsize += sizeof(bool);   break;
+            case FT_BYTE:
+                recordsize += sizeof(char);   break;
+            case FT_INT:
+                recordsize += sizeof(uint32); break;
+            case FT_FLOAT:
+                recordsize += sizeof(float);  break;
+            case FT_STRING:
+                recordsize += sizeof(char*);  break;
+            case FT_NA:
+                recordsize += sizeof(uint32); break;
+            case FT_NA_BYTE:
+                recordsize += sizeof(char);   break;
+            case FT_NA_FLOAT:
+                recordsize += sizeof(float);  break;
+            case FT_NA_POINTER:
+                recordsize += sizeof(char*);  break;
+            case FT_64BITINT:
+                recordsize += sizeof(uint64);  break;
+            case FT_IND:
+            case FT_SORT:
+                assert(false && "SQL storage not have sort field types");
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+
+    // unchanged table from a previous run, take the stored snapshot instead of parsing all rows again
+    uint64 checksum = 0;
+    bool useCache = DerivedLoader::cacheable && store.CanUseCache() && GetTableChecksum(store, checksum);
+    if (useCache && store.LoadFromCache(checksum, recordsize))
+        return;
+
     Field* fields = nullptr;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(%s) FROM %s", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -224,7 +267,6 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
 
     uint32 maxRecordId = (*result)[0].GetUInt32() + 1;
     uint32 recordCount = 0;
-    uint32 recordsize = 0;
     delete result;
 
     result = WorldDatabase.PQuery("SELECT COUNT(*) FROM %s", store.GetTableName());
@@ -235,7 +277,7 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    result = WorldDatabase.PQueryTyped("SELECT * FROM %s", store.GetTableName());
 
     if (!result)
     {
@@ -257,53 +299,25 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         exit(1);                                            // Stop server at loading broken or non-compatible table.
     }
 
-    // get struct size
-    uint32 offset = 0;
-    for (uint32 x = 0; x < store.GetDstFieldCount(); ++x)
-    {
-        switch (store.GetDstFormat(x))
-        {
-            case FT_LOGIC:
-                recordsize += sizeof(bool);   break;
-            case FT_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_INT:
-                recordsize += sizeof(uint32); break;
-            case FT_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_STRING:
-                recordsize += sizeof(char*);  break;
-            case FT_NA:
-                recordsize += sizeof(uint32); break;
-            case FT_NA_BYTE:
-                recordsize += sizeof(char);   break;
-            case FT_NA_FLOAT:
-                recordsize += sizeof(float);  break;
-            case FT_NA_POINTER:
-                recordsize += sizeof(char*);  break;
-            case FT_64BITINT:
-                recordsize += sizeof(uint64);  break;
-            case FT_IND:
-            case FT_SORT:
-                assert(false && "SQL storage not have sort field types");
-                break;
-            default:
-                assert(false && "unknown format character");
-                break;
-        }
-    }
-
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
+    std::vector<uint32> recordIds;
+    if (useCache)
+        recordIds.reserve(recordCount);
+
     BarGoLink bar(recordCount);
     do
     {
         fields = result->Fetch();
         bar.step();
 
-        char* record = store.createRecord(fields[0].GetUInt32());
-        offset = 0;
+        uint32 recordId = fields[0].GetUInt32();
+        char* record = store.createRecord(recordId);
+        uint32 offset = 0;
+
+        if (useCache)
+            recordIds.push_back(recordId);
 
         // dependend on dest-size
         // iterate two indexes: x over dest, y over source
@@ -353,6 +367,25 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    if (useCache)
+        store.SaveToCache(checksum, recordIds);
+}
+
+template<class DerivedLoader, class StorageClass>
+bool SQLStorageLoaderBase<DerivedLoader, StorageClass>::GetTableChecksum(StorageClass const& store, uint64& checksum) const
+{
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", store.GetTableName());
+    if (!result)
+        return false;
+
+    Field* fields = result->Fetch();
+    bool found = !fields[1].IsNULL();
+    if (found)
+        checksum = fields[1].GetUInt64();
+
+    delete result;
+    return found;
 }
 
 #endif
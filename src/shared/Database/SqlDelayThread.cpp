@@ -19,8 +19,11 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "ThreadAffinity.h"
+#include "TraceRecorder.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, uint32 batchSize) : m_dbEngine(db), m_dbConnection(conn), m_running(true),
+    m_batchSize(batchSize), m_queueSize(0), m_delayedCount(0), m_executedCount(0), m_queueLag(0)
 {
 }
 
@@ -36,6 +39,9 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
+    TraceRecorder::SetThreadName("sql delay");
+    ThreadAffinity::PinCurrentThread(THREAD_CLASS_DATABASE);
+
     const uint32 loopSleepms = 10;
 
     const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
@@ -69,18 +75,83 @@ void SqlDelayThread::Stop()
 void SqlDelayThread::ProcessRequests()
 {
     std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    Clock::time_point oldestQueued;
 
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
     {
         std::lock_guard<std::mutex> guard(m_queueMutex);
         sqlQueue = std::move(m_sqlQueue);
+        oldestQueued = m_oldestQueued;
+    }
+
+    if (sqlQueue.empty())
+    {
+        m_queueLag = 0;
+        return;
     }
 
+    m_queueLag = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - oldestQueued).count());
+
+    TraceScope trace("db", "SqlDelayThread::ProcessRequests");
+    if (trace.IsActive())
+        trace.SetDetail(std::to_string(sqlQueue.size()) + " operations");
+
+    // consecutive single statements are committed together, everything else runs alone in queue order
+    std::vector<std::unique_ptr<SqlOperation>> batch;
     while (!sqlQueue.empty())
     {
-        auto const s = std::move(sqlQueue.front());
+        auto s = std::move(sqlQueue.front());
         sqlQueue.pop();
+
+        if (m_batchSize > 1 && s->IsBatchable())
+        {
+            batch.push_back(std::move(s));
+            if (batch.size() >= m_batchSize)
+                ExecuteBatch(batch);
+            continue;
+        }
+
+        if (!batch.empty())
+            ExecuteBatch(batch);
+
         s->Execute(m_dbConnection);
+        --m_queueSize;
+        ++m_executedCount;
+    }
+
+    if (!batch.empty())
+        ExecuteBatch(batch);
+}
+
+void SqlDelayThread::ExecuteBatch(std::vector<std::unique_ptr<SqlOperation>>& batch)
+{
+    const size_t count = batch.size();
+
+    if (count == 1)
+        batch.front()->Execute(m_dbConnection);
+    else
+    {
+        SqlConnection::Lock guard(m_dbConnection);
+
+        bool success = guard->BeginTransaction();
+        for (auto itr = batch.begin(); success && itr != batch.end(); ++itr)
+            success = (*itr)->Execute(m_dbConnection);
+
+        if (success)
+            success = guard->CommitTransaction();
+
+        // statements are independent of each other, so a failure must not take the rest of the batch with it.
+        // roll back and retry them one by one, exactly as they would have run without batching
+        if (!success)
+        {
+            guard->RollbackTransaction();
+            for (auto& s : batch)
+                s->Execute(m_dbConnection);
+        }
     }
+
+    batch.clear();
+    m_queueSize -= count;
+    m_executedCount += count;
 }
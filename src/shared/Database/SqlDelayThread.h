@@ -23,9 +23,11 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 class Database;
 class SqlOperation;
@@ -34,27 +36,48 @@ class SqlConnection;
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
+        typedef std::chrono::steady_clock Clock;
+
         std::mutex m_queueMutex;
         std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        Clock::time_point m_oldestQueued;                       ///< Time the oldest statement in m_sqlQueue was delayed
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
         std::atomic<bool> m_running;
 
+        uint32 m_batchSize;                                     ///< Max statements committed together, 1 disables batching
+        std::atomic<size_t> m_queueSize;                        ///< Statements delayed but not executed yet
+        std::atomic<uint64> m_delayedCount;                     ///< Statements delayed since start
+        std::atomic<uint64> m_executedCount;                    ///< Statements executed since start, in delay order
+        std::atomic<uint32> m_queueLag;                         ///< Wait time in ms of the oldest statement of the last processed queue
+
         // process all enqueued requests
         void ProcessRequests();
+        // execute collected statements in a single transaction
+        void ExecuteBatch(std::vector<std::unique_ptr<SqlOperation>>& batch);
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, uint32 batchSize = 1);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
+            if (m_sqlQueue.empty())
+                m_oldestQueued = Clock::now();
             m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            ++m_queueSize;
+            ++m_delayedCount;
             return true;
         }
 
+        size_t GetQueueSize() const { return m_queueSize; }
+        // all statements delayed before GetDelayedCount() returned n are executed once GetExecutedCount() reaches n
+        uint64 GetDelayedCount() const { return m_delayedCount; }
+        uint64 GetExecutedCount() const { return m_executedCount; }
+        uint32 GetQueueLag() const { return m_queueLag; }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
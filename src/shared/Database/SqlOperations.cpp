@@ -21,9 +21,12 @@
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
 
+#include <chrono>
 #include <cstdarg>
+#include <thread>
 
 #define LOCK_DB_CONN(conn) SqlConnection::Lock guard(conn)
+#define MAX_TRANSACTION_RETRIES 2
 
 /// ---- ASYNC STATEMENTS / TRANSACTIONS ----
 
@@ -50,21 +53,43 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
     LOCK_DB_CONN(conn);
 
-    conn->BeginTransaction();
-
-    const int nItems = m_queue.size();
-    for (int i = 0; i < nItems; ++i)
+    // transactions committed in parallel on several connections can deadlock each other, the loser is run again
+    for (int attempt = 0; ; ++attempt)
     {
-        SqlOperation* pStmt = m_queue[i];
+        conn->BeginTransaction();
 
-        if (!pStmt->Execute(conn))
+        bool failed = false;
+        const int nItems = m_queue.size();
+        for (int i = 0; i < nItems; ++i)
         {
-            conn->RollbackTransaction();
-            return false;
+            SqlOperation* pStmt = m_queue[i];
+
+            if (!pStmt->Execute(conn))
+            {
+                failed = true;
+                break;
+            }
         }
+
+        if (!failed)
+            return conn->CommitTransaction();
+
+        bool const retry = attempt < MAX_TRANSACTION_RETRIES && conn->IsLockConflict();
+        conn->RollbackTransaction();
+        if (!retry)
+            return false;
+
+        sLog.outErrorDb("Transaction lost a lock conflict, running it again (%d of %d)", attempt + 1, MAX_TRANSACTION_RETRIES);
     }
+}
+
+size_t SqlTransaction::GetDataSize() const
+{
+    size_t size = 0;
+    for (SqlOperation const* pStmt : m_queue)
+        size += pStmt->GetDataSize();
 
-    return conn->CommitTransaction();
+    return size;
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
@@ -82,6 +107,15 @@ bool SqlPreparedRequest::Execute(SqlConnection* conn)
     return conn->ExecuteStmt(m_nIndex, *m_param);
 }
 
+size_t SqlPreparedRequest::GetDataSize() const
+{
+    size_t size = 0;
+    for (SqlStmtFieldData const& data : m_param->params())
+        size += data.size();
+
+    return size;
+}
+
 /// ---- ASYNC QUERIES ----
 
 bool SqlQuery::Execute(SqlConnection* conn)
@@ -114,17 +148,50 @@ void SqlResultQueue::Update()
 void SqlResultQueue::Add(MaNGOS::IQueryCallback* callback)
 {
     std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_forward)
+    {
+        m_forward->Add(callback);
+        return;
+    }
+
     m_queue.push(std::unique_ptr<MaNGOS::IQueryCallback>(callback));
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+void SqlResultQueue::Forward(std::shared_ptr<SqlResultQueue> const& target)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_forward = target;
+
+    if (!m_forward)
+        return;
+
+    while (!m_queue.empty())
+    {
+        m_forward->Add(m_queue.front().release());
+        m_queue.pop();
+    }
+}
+
+thread_local std::shared_ptr<SqlResultQueue> SqlResultQueueScope::m_current;
+
+SqlResultQueueScope::SqlResultQueueScope(std::shared_ptr<SqlResultQueue> queue) : m_previous(std::move(m_current))
+{
+    m_current = std::move(queue);
+}
+
+SqlResultQueueScope::~SqlResultQueueScope()
+{
+    m_current = std::move(m_previous);
+}
+
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, std::shared_ptr<SqlResultQueue> const& queue, SqlDelayThread const* after /*= nullptr*/)
 {
     if (!callback || !thread || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
-    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
+    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue, after, after ? after->GetDelayedCount() : 0);
     thread->Delay(holderEx);
     return true;
 }
@@ -220,6 +287,11 @@ bool SqlQueryHolderEx::Execute(SqlConnection* conn)
     if (!m_holder || !m_callback || !m_queue)
         return false;
 
+    /// the queries must see what was written before them, e.g. the save of a character logging in again
+    if (m_after)
+        while (m_after->GetExecutedCount() < m_afterCount)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
     LOCK_DB_CONN(conn);
     /// we can do this, we are friends
     std::vector<SqlQueryHolder::SqlResultPair>& queries = m_holder->m_queries;
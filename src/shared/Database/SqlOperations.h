@@ -39,6 +39,10 @@ class SqlOperation
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // single statement without result which can share a transaction with its neighbours
+        virtual bool IsBatchable() const { return false; }
+        // approximate amount of data sent to the DB server
+        virtual size_t GetDataSize() const { return 0; }
         virtual ~SqlOperation() {}
 };
 
@@ -52,6 +56,8 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char* sql) : m_sql(mangos_strdup(sql)) {}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
+        bool IsBatchable() const override { return true; }
+        size_t GetDataSize() const override { return strlen(m_sql); }
 };
 
 class SqlTransaction : public SqlOperation
@@ -66,6 +72,8 @@ class SqlTransaction : public SqlOperation
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
 
         bool Execute(SqlConnection* conn) override;
+        size_t GetDataSize() const override;
+        size_t GetStatementCount() const { return m_queue.size(); }
 };
 
 class SqlPreparedRequest : public SqlOperation
@@ -75,6 +83,8 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection* conn) override;
+        bool IsBatchable() const override { return true; }
+        size_t GetDataSize() const override;
 
     private:
         const int m_nIndex;
@@ -93,10 +103,32 @@ class SqlResultQueue
     private:
         std::mutex m_mutex;
         std::queue<std::unique_ptr<MaNGOS::IQueryCallback>> m_queue;
+        std::shared_ptr<SqlResultQueue> m_forward;          ///< set when the owner is gone, callbacks go there instead
 
     public:
         void Update();
         void Add(MaNGOS::IQueryCallback*);
+
+        // owner of this queue stops updating it, pending and still running queries are delivered to target
+        void Forward(std::shared_ptr<SqlResultQueue> const& target);
+};
+
+// while in scope, async queries started by this thread deliver their results to queue
+// instead of the database-wide result queue processed by the world thread
+class SqlResultQueueScope
+{
+    public:
+        explicit SqlResultQueueScope(std::shared_ptr<SqlResultQueue> queue);
+        ~SqlResultQueueScope();
+
+        SqlResultQueueScope(SqlResultQueueScope const&) = delete;
+        SqlResultQueueScope& operator=(SqlResultQueueScope const&) = delete;
+
+        static std::shared_ptr<SqlResultQueue> const& Current() { return m_current; }
+
+    private:
+        std::shared_ptr<SqlResultQueue> m_previous;
+        static thread_local std::shared_ptr<SqlResultQueue> m_current;
 };
 
 class SqlQuery : public SqlOperation
@@ -104,11 +136,11 @@ class SqlQuery : public SqlOperation
     private:
         std::vector<char> m_sql;
         MaNGOS::IQueryCallback* const m_callback;
-        SqlResultQueue* const m_queue;
+        std::shared_ptr<SqlResultQueue> const m_queue;
 
     public:
-        SqlQuery(const char* sql, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
-            : m_sql(strlen(sql) + 1), m_callback(callback), m_queue(queue)
+        SqlQuery(const char* sql, MaNGOS::IQueryCallback* callback, std::shared_ptr<SqlResultQueue> queue)
+            : m_sql(strlen(sql) + 1), m_callback(callback), m_queue(std::move(queue))
         {
             memcpy(&m_sql[0], sql, m_sql.size());
         }
@@ -130,7 +162,8 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        // after: the delay thread whose statements delayed so far have to be executed before the queries run on thread
+        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, std::shared_ptr<SqlResultQueue> const& queue, SqlDelayThread const* after = nullptr);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -138,10 +171,12 @@ class SqlQueryHolderEx : public SqlOperation
     private:
         SqlQueryHolder* m_holder;
         MaNGOS::IQueryCallback* m_callback;
-        SqlResultQueue* m_queue;
+        std::shared_ptr<SqlResultQueue> m_queue;
+        SqlDelayThread const* m_after;
+        uint64 m_afterCount;
     public:
-        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, SqlResultQueue* queue)
-            : m_holder(holder), m_callback(callback), m_queue(queue) {}
+        SqlQueryHolderEx(SqlQueryHolder* holder, MaNGOS::IQueryCallback* callback, std::shared_ptr<SqlResultQueue> queue, SqlDelayThread const* after, uint64 afterCount)
+            : m_holder(holder), m_callback(callback), m_queue(std::move(queue)), m_after(after), m_afterCount(afterCount) {}
         bool Execute(SqlConnection* conn) override;
 };
 #endif                                                      //__SQLOPERATIONS_H
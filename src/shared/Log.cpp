@@ -25,6 +25,7 @@
 #include "ProgressBar.h"
 
 #include <stdarg.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -33,6 +34,8 @@
 
 INSTANTIATE_SINGLETON_1(Log);
 
+thread_local std::shared_ptr<Log::LogQueue> Log::t_logQueue;
+
 LogFilterData logFilterData[LOG_FILTER_COUNT] =
 {
     { "transport_moves",     "LogFilter_TransportMoves",     true  },
@@ -58,19 +61,12 @@ LogFilterData logFilterData[LOG_FILTER_COUNT] =
     { "db_scripts_dev",      "LogFilter_DbScriptDev",        true  },
 };
 
-enum LogType
-{
-    LogNormal = 0,
-    LogDetails,
-    LogDebug,
-    LogError
-};
-
 const int LogType_count = int(LogError) + 1;
 
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr),
+    m_asyncBufferSize(0), m_asyncOverflow(LOG_OVERFLOW_DROP), m_asyncRunning(false), m_asyncSequence(0), m_droppedLines(0), m_reportedDroppedLines(0)
 {
     Initialize();
 }
@@ -220,6 +216,9 @@ void Log::SetLogFileLevel(char* level)
 
 void Log::Initialize()
 {
+    // the writer must not use the files while they are reopened
+    StopAsync();
+
     /// Common log files data
     m_logsDir = sConfig.GetStringDefault("LogsDir");
     if (!m_logsDir.empty())
@@ -285,6 +284,16 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // Async writer settings, the buffers of the threads are rings of a power of 2 lines
+    m_asyncBufferSize = 64;
+    while (m_asyncBufferSize < uint32(sConfig.GetIntDefault("LogAsync.BufferSize", 8192)) && m_asyncBufferSize < (1u << 20))
+        m_asyncBufferSize <<= 1;
+    m_asyncOverflow = LogOverflow(sConfig.GetIntDefault("LogAsync.Overflow", LOG_OVERFLOW_COUNT));
+    if (m_asyncOverflow > LOG_OVERFLOW_COUNT)
+        m_asyncOverflow = LOG_OVERFLOW_COUNT;
+    if (sConfig.GetBoolDefault("LogAsync", false))
+        StartAsync();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -317,7 +326,11 @@ FILE* Log::openGmlogPerAccount(uint32 account)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(nullptr);
+    outTimestamp(file, time(nullptr));
+}
+
+void Log::outTimestamp(FILE* file, time_t t)
+{
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -330,7 +343,11 @@ void Log::outTimestamp(FILE* file)
 
 void Log::outTime() const
 {
-    time_t t = time(nullptr);
+    outTime(time(nullptr));
+}
+
+void Log::outTime(time_t t) const
+{
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -356,376 +373,400 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+namespace
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
+    // most lines fit the stack buffer, longer ones are formatted a second time into their own string
+    std::string FormatLogText(char const* format, va_list ap)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        char buffer[512];
+        va_list copy;
+        va_copy(copy, ap);
+        int const length = vsnprintf(buffer, sizeof(buffer), format, copy);
+        va_end(copy);
+
+        if (length < 0)
+            return std::string();
+        if (size_t(length) < sizeof(buffer))
+            return std::string(buffer, length);
+
+        std::string text(length, '\0');
+        vsnprintf(&text[0], length + 1, format, ap);
+        return text;
     }
-
-    fflush(stdout);
 }
 
-void Log::outString(const char* str, ...)
+void Log::WriteConsole(LogRecord const& record, bool stdout_stream, LogType type)
 {
-    if (!str)
-        return;
-
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
     if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
+        SetColor(stdout_stream, m_colors[type]);
 
     if (m_includeTime)
-        outTime();
+        outTime(record.time);
 
-    va_list ap;
-
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+    utf8printf(stdout_stream ? stdout : stderr, "%s", record.text.c_str());
 
     if (m_colored)
-        ResetColor(true);
+        ResetColor(stdout_stream);
+
+    fprintf(stdout_stream ? stdout : stderr, "\n");
+}
 
-    printf("\n");
+void Log::WriteFile(FILE* file, LogRecord const& record, char const* prefix /*= ""*/)
+{
+    outTimestamp(file, record.time);
+    fprintf(file, "%s%s\n", prefix, record.text.c_str());
+}
 
-    if (logfile)
+// expects m_worldLogMtx to be locked, the streams are flushed by the caller
+void Log::WriteRecord(LogRecord const& record)
+{
+    switch (record.type)
     {
-        outTimestamp(logfile);
+        case LOG_RECORD_STRING:
+            WriteConsole(record, true, LogNormal);
+            if (logfile)
+                WriteFile(logfile, record);
+            break;
+        case LOG_RECORD_ERROR:
+            WriteConsole(record, false, LogError);
+            if (logfile)
+                WriteFile(logfile, record, "ERROR:");
+            break;
+        case LOG_RECORD_BASIC:
+        case LOG_RECORD_DETAIL:
+        case LOG_RECORD_DEBUG:
+        case LOG_RECORD_COMMAND:
+        {
+            LogLevel const level = record.type == LOG_RECORD_BASIC ? LOG_LVL_BASIC : (record.type == LOG_RECORD_DEBUG ? LOG_LVL_DEBUG : LOG_LVL_DETAIL);
+            if (m_logLevel >= level)
+                WriteConsole(record, true, record.type == LOG_RECORD_DEBUG ? LogDebug : LogDetails);
+            if (logfile && m_logFileLevel >= level)
+                WriteFile(logfile, record);
 
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+            if (record.type != LOG_RECORD_COMMAND)
+                break;
 
-        fflush(logfile);
+            if (m_gmlog_per_account)
+            {
+                if (FILE* per_file = openGmlogPerAccount(record.account))
+                {
+                    WriteFile(per_file, record);
+                    fclose(per_file);
+                }
+            }
+            else if (gmLogfile)
+                WriteFile(gmLogfile, record);
+            break;
+        }
+        case LOG_RECORD_ERROR_DB:
+            WriteConsole(record, false, LogError);
+            if (logfile)
+                WriteFile(logfile, record, "ERROR:");
+            if (dberLogfile)
+                WriteFile(dberLogfile, record);
+            break;
+        case LOG_RECORD_ERROR_EVENTAI:
+            WriteConsole(record, false, LogError);
+            if (logfile)
+                WriteFile(logfile, record, "ERROR CreatureEventAI: ");
+            if (eventAiErLogfile)
+                WriteFile(eventAiErLogfile, record);
+            break;
+        case LOG_RECORD_ERROR_SCRIPTLIB:
+            WriteConsole(record, false, LogError);
+            if (logfile)
+            {
+                outTimestamp(logfile, record.time);
+                if (m_scriptLibName)
+                    fprintf(logfile, "<%s ERROR>: %s\n", m_scriptLibName, record.text.c_str());
+                else
+                    fprintf(logfile, "<Scripting Library ERROR>: %s\n", record.text.c_str());
+            }
+            if (scriptErrLogFile)
+                WriteFile(scriptErrLogFile, record);
+            break;
+        case LOG_RECORD_CHAR:
+            if (charLogfile)
+                WriteFile(charLogfile, record);
+            break;
+        case LOG_RECORD_CHAR_DUMP:
+            if (charLogfile)
+                fprintf(charLogfile, "%s", record.text.c_str());
+            break;
+        case LOG_RECORD_WORLD_PACKET:
+            if (worldLogfile)
+            {
+                outTimestamp(worldLogfile, record.time);
+                fprintf(worldLogfile, "%s", record.text.c_str());
+            }
+            break;
+        case LOG_RECORD_RA:
+            if (raLogfile)
+                WriteFile(raLogfile, record);
+            break;
+        case LOG_RECORD_CUSTOM:
+            if (customLogFile)
+                WriteFile(customLogFile, record);
+            break;
     }
+}
+
+void Log::FlushFiles()
+{
+    for (FILE* file : { logfile, gmLogfile, charLogfile, dberLogfile, eventAiErLogfile, scriptErrLogFile, raLogfile, worldLogfile, customLogFile })
+        if (file)
+            fflush(file);
 
     fflush(stdout);
+    fflush(stderr);
 }
 
-void Log::outError(const char* err, ...)
+void Log::Write(LogRecord&& record)
 {
-    if (!err)
+    if (m_asyncRunning.load(std::memory_order_acquire) && Enqueue(record))
         return;
 
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    WriteRecord(record);
+    FlushFiles();
+}
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+void Log::Write(LogRecordType type, char const* format, va_list ap, uint32 account /*= 0*/)
+{
+    LogRecord record;
+    record.type = type;
+    record.account = account;
+    record.time = time(nullptr);
+    record.text = FormatLogText(format, ap);
+    Write(std::move(record));
+}
 
-    if (m_colored)
-        ResetColor(false);
+void Log::Write(LogRecordType type, std::string&& text)
+{
+    LogRecord record;
+    record.type = type;
+    record.account = 0;
+    record.time = time(nullptr);
+    record.text = std::move(text);
+    Write(std::move(record));
+}
 
-    fprintf(stderr, "\n");
-    if (logfile)
+Log::LogQueue& Log::GetThreadQueue()
+{
+    if (!t_logQueue)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+        std::shared_ptr<LogQueue> queue = std::make_shared<LogQueue>(m_asyncBufferSize);
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        std::lock_guard<std::mutex> guard(m_asyncQueuesLock);
+        m_asyncQueues.push_back(queue);
+        t_logQueue = queue;
     }
-
-    fflush(stderr);
+    return *t_logQueue;
 }
 
-void Log::outErrorDb()
+bool Log::Enqueue(LogRecord& record)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
+    LogQueue& queue = GetThreadQueue();
+    uint32 const tail = queue.tail.load(std::memory_order_relaxed);
+    while (tail - queue.head.load(std::memory_order_acquire) >= queue.records.size())
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+        if (m_asyncOverflow != LOG_OVERFLOW_BLOCK)
+        {
+            ++m_droppedLines;
+            return true;
+        }
+
+        // the writer went away meanwhile, the line is written by the caller
+        if (!m_asyncRunning.load(std::memory_order_acquire))
+            return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
     }
 
-    if (dberLogfile)
+    record.sequence = m_asyncSequence.fetch_add(1, std::memory_order_relaxed);
+    queue.records[tail & (queue.records.size() - 1)] = std::move(record);
+    queue.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+void Log::CollectRecords(std::vector<LogRecord>& batch)
+{
+    std::lock_guard<std::mutex> guard(m_asyncQueuesLock);
+    for (auto itr = m_asyncQueues.begin(); itr != m_asyncQueues.end();)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        LogQueue& queue = **itr;
+        uint32 const head = queue.head.load(std::memory_order_relaxed);
+        uint32 const tail = queue.tail.load(std::memory_order_acquire);
+        for (uint32 i = head; i != tail; ++i)
+            batch.push_back(std::move(queue.records[i & (queue.records.size() - 1)]));
+        queue.head.store(tail, std::memory_order_release);
+
+        // only the list holds the queue of a finished thread
+        if (head == tail && itr->use_count() == 1)
+            itr = m_asyncQueues.erase(itr);
+        else
+            ++itr;
     }
 
-    fflush(stderr);
+    // every thread keeps its order, lines of different threads are ordered within the batch
+    std::sort(batch.begin(), batch.end(), [](LogRecord const& left, LogRecord const& right) { return left.sequence < right.sequence; });
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::WriteRecords(std::vector<LogRecord>& batch)
 {
-    if (!err)
-        return;
-
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    for (LogRecord const& record : batch)
+        WriteRecord(record);
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
+    uint64 const dropped = m_droppedLines;
+    if (m_asyncOverflow == LOG_OVERFLOW_COUNT && dropped != m_reportedDroppedLines)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        LogRecord record;
+        record.type = LOG_RECORD_ERROR;
+        record.account = 0;
+        record.time = time(nullptr);
+        record.text = "Log: " + std::to_string(dropped - m_reportedDroppedLines) + " lines dropped, LogAsync.BufferSize is too small";
+        WriteRecord(record);
+        m_reportedDroppedLines = dropped;
     }
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
+    FlushFiles();
+    batch.clear();
+}
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+void Log::AsyncWriter()
+{
+    std::vector<LogRecord> batch;
+    while (m_asyncRunning.load(std::memory_order_acquire))
+    {
+        CollectRecords(batch);
+        if (batch.empty())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        WriteRecords(batch);
     }
 
-    fflush(stderr);
+    CollectRecords(batch);
+    if (!batch.empty())
+        WriteRecords(batch);
 }
 
-void Log::outErrorEventAI()
+void Log::StartAsync()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (m_asyncRunning)
+        return;
 
-    if (m_includeTime)
-        outTime();
+    m_asyncRunning = true;
+    m_asyncThread = std::thread(&Log::AsyncWriter, this);
+}
 
-    fprintf(stderr, "\n");
+void Log::StopAsync()
+{
+    if (!m_asyncRunning)
+        return;
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+    m_asyncRunning = false;
+    m_asyncThread.join();
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    // lines queued while the writer was leaving
+    std::vector<LogRecord> batch;
+    CollectRecords(batch);
+    if (!batch.empty())
+        WriteRecords(batch);
+}
 
-    fflush(stderr);
+void Log::outString()
+{
+    Write(LOG_RECORD_STRING, std::string());
 }
 
-void Log::outErrorEventAI(const char* err, ...)
+void Log::outString(const char* str, ...)
 {
-    if (!err)
+    if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_STRING, str, ap);
+    va_end(ap);
+}
 
-    if (m_includeTime)
-        outTime();
+void Log::outError(const char* err, ...)
+{
+    if (!err)
+        return;
 
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    Write(LOG_RECORD_ERROR, err, ap);
     va_end(ap);
+}
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+void Log::outErrorDb()
+{
+    Write(LOG_RECORD_ERROR_DB, std::string());
+}
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+void Log::outErrorDb(const char* err, ...)
+{
+    if (!err)
+        return;
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
+    va_list ap;
+    va_start(ap, err);
+    Write(LOG_RECORD_ERROR_DB, err, ap);
+    va_end(ap);
+}
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
+void Log::outErrorEventAI()
+{
+    Write(LOG_RECORD_ERROR_EVENTAI, std::string());
+}
 
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+void Log::outErrorEventAI(const char* err, ...)
+{
+    if (!err)
+        return;
 
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, err);
+    Write(LOG_RECORD_ERROR_EVENTAI, err, ap);
+    va_end(ap);
 }
 
 void Log::outBasic(const char* str, ...)
 {
-    if (!str)
+    if (!str || !HasLogLevelOrHigher(LOG_LVL_BASIC))
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_BASIC, str, ap);
+    va_end(ap);
 }
 
 void Log::outDetail(const char* str, ...)
 {
-    if (!str)
+    if (!str || !HasLogLevelOrHigher(LOG_LVL_DETAIL))
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_DETAIL, str, ap);
+    va_end(ap);
 }
 
 void Log::outDebug(const char* str, ...)
 {
-    if (!str)
+    if (!str || !HasLogLevelOrHigher(LOG_LVL_DEBUG))
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
-    {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_DEBUG, str, ap);
+    va_end(ap);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -733,108 +774,26 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-            ResetColor(true);
-
-        printf("\n");
-    }
-
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
-
-    if (m_gmlog_per_account)
-    {
-        if (FILE* per_file = openGmlogPerAccount(account))
-        {
-            va_list ap;
-            outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
-            fclose(per_file);
-        }
-    }
-    else if (gmLogfile)
-    {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_COMMAND, str, ap, account);
+    va_end(ap);
 }
 
 void Log::outChar(const char* str, ...)
 {
-    if (!str)
+    if (!str || !charLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_CHAR, str, ap);
+    va_end(ap);
 }
 
 void Log::outErrorScriptLib()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+    Write(LOG_RECORD_ERROR_SCRIPTLIB, std::string());
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -842,54 +801,10 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    Write(LOG_RECORD_ERROR_SCRIPTLIB, err, ap);
     va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
 }
 
 void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
@@ -897,76 +812,58 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    std::string text(buffer);
+    text.reserve(text.size() + packet.size() * 3 + packet.size() / 16 + 3);
 
     size_t p = 0;
     while (p < packet.size())
     {
         for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+        {
+            snprintf(buffer, sizeof(buffer), "%.2X ", packet[p++]);
+            text += buffer;
+        }
 
-        fprintf(worldLogfile, "\n");
+        text += '\n';
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    text += "\n\n";
+    Write(LOG_RECORD_WORLD_PACKET, std::move(text));
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!charLogfile)
+        return;
 
-    if (charLogfile)
-    {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
-    }
+    Write(LOG_RECORD_CHAR_DUMP, "== START DUMP == (account: " + std::to_string(account_id) + " guid: " + std::to_string(guid) + " name: " + name + " )\n" + str + "\n== END DUMP ==\n");
 }
 
 void Log::outRALog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !raLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_RA, str, ap);
+    va_end(ap);
 }
 
 void Log::outCustomLog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !customLogFile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (customLogFile)
-    {
-        va_list ap;
-        outTimestamp(customLogFile);
-        va_start(ap, str);
-        vfprintf(customLogFile, str, ap);
-        fprintf(customLogFile, "\n");
-        va_end(ap);
-        fflush(customLogFile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    Write(LOG_RECORD_CUSTOM, str, ap);
+    va_end(ap);
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -994,6 +891,7 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     m_scriptLibName = libName;
 
     if (scriptErrLogFile)
@@ -22,7 +22,13 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <atomic>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 class Config;
 class ByteBuffer;
@@ -93,6 +99,22 @@ enum Color
 
 const int Color_count = int(WHITE) + 1;
 
+// what happens to a line when the buffer of its thread is full (LogAsync.Overflow)
+enum LogOverflow
+{
+    LOG_OVERFLOW_DROP  = 0,                                 // dropped, only counted
+    LOG_OVERFLOW_BLOCK = 1,                                 // the thread waits for the writer
+    LOG_OVERFLOW_COUNT = 2,                                 // dropped, the count is written to the log
+};
+
+enum LogType
+{
+    LogNormal = 0,
+    LogDetails,
+    LogDebug,
+    LogError
+};
+
 class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::mutex> >
 {
         friend class MaNGOS::OperatorNew<Log>;
@@ -100,6 +122,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            StopAsync();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -178,13 +202,19 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         void SetColor(bool stdout_stream, Color color);
         void ResetColor(bool stdout_stream);
         void outTime() const;
+        void outTime(time_t t) const;
         static void outTimestamp(FILE* file);
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
+        std::string const& GetLogsDir() const { return m_logsDir; }
         bool HasLogFilter(uint32 filter) const { return (m_logFilter & filter) != 0; }
         void SetLogFilter(LogFilters filter, bool on) { if (on) m_logFilter |= filter; else m_logFilter &= ~filter; }
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        bool IsAsync() const { return m_asyncRunning; }
+        // lines lost to full buffers of the threads since the start
+        uint64 GetDroppedLines() const { return m_droppedLines; }
         std::string GetTraceLog();
 
         static void WaitBeforeContinueIfNeed();
@@ -195,6 +225,60 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         void traceLog();
 
     private:
+        enum LogRecordType
+        {
+            LOG_RECORD_STRING,
+            LOG_RECORD_ERROR,
+            LOG_RECORD_BASIC,
+            LOG_RECORD_DETAIL,
+            LOG_RECORD_DEBUG,
+            LOG_RECORD_COMMAND,
+            LOG_RECORD_ERROR_DB,
+            LOG_RECORD_ERROR_EVENTAI,
+            LOG_RECORD_ERROR_SCRIPTLIB,
+            LOG_RECORD_CHAR,
+            LOG_RECORD_CHAR_DUMP,
+            LOG_RECORD_WORLD_PACKET,
+            LOG_RECORD_RA,
+            LOG_RECORD_CUSTOM,
+        };
+
+        // one formatted line, written at once or by the async writer
+        struct LogRecord
+        {
+            LogRecordType type;
+            uint32 account;                                 // gm log of LOG_RECORD_COMMAND
+            time_t time;
+            std::string text;
+            uint64 sequence;                                // orders the lines of different threads
+        };
+
+        // single producer (its thread), single consumer (the writer) ring
+        struct LogQueue
+        {
+            explicit LogQueue(uint32 size) : records(size), head(0), tail(0) {}
+
+            std::vector<LogRecord> records;                 // size is a power of 2
+            std::atomic<uint32> head;                       // next record to write
+            std::atomic<uint32> tail;                       // next free slot
+        };
+
+        void Write(LogRecord&& record);
+        void Write(LogRecordType type, char const* format, va_list ap, uint32 account = 0);
+        void Write(LogRecordType type, std::string&& text);
+        void WriteRecord(LogRecord const& record);
+        void WriteConsole(LogRecord const& record, bool stdout_stream, LogType type);
+        void WriteFile(FILE* file, LogRecord const& record, char const* prefix = "");
+        void FlushFiles();
+
+        void StartAsync();
+        void StopAsync();
+        void AsyncWriter();
+        LogQueue& GetThreadQueue();
+        bool Enqueue(LogRecord& record);
+        void CollectRecords(std::vector<LogRecord>& batch);
+        void WriteRecords(std::vector<LogRecord>& batch);
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -231,6 +315,19 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         std::string m_gmlog_filename_format;
 
         char const* m_scriptLibName;
+
+        // async writer (see LogAsync)
+        uint32 m_asyncBufferSize;
+        LogOverflow m_asyncOverflow;
+        std::atomic<bool> m_asyncRunning;
+        std::thread m_asyncThread;
+        std::mutex m_asyncQueuesLock;
+        std::vector<std::shared_ptr<LogQueue>> m_asyncQueues;
+        std::atomic<uint64> m_asyncSequence;
+        std::atomic<uint64> m_droppedLines;
+        uint64 m_reportedDroppedLines;                      // by the writer, for LOG_OVERFLOW_COUNT
+
+        static thread_local std::shared_ptr<LogQueue> t_logQueue;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
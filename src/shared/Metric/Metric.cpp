@@ -17,7 +17,9 @@
  */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <functional>
+#include <limits>
 
 #include "Config/Config.h"
 #include "Log.h"
@@ -74,6 +76,58 @@ void metric::measurement::set_condition(std::function<bool()> condition)
     m_condition = std::move(condition);
 }
 
+void metric::series_slot::reset()
+{
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<int64>::max(), std::memory_order_relaxed);
+    max.store(std::numeric_limits<int64>::min(), std::memory_order_relaxed);
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+metric::series::series(series_type type, std::string name, std::map<std::string, std::string> tags)
+    : m_enabled(metric::instance().is_enabled()), m_type(type), m_name(std::move(name)), m_tags(std::move(tags)), m_id(0)
+{
+    if (m_enabled)
+        m_id = metric::instance().register_series(this);
+}
+
+metric::series::~series()
+{
+    if (m_enabled)
+        metric::instance().unregister_series(this);
+}
+
+metric::series_slot* metric::series::local_slot() const
+{
+    if (!m_enabled)
+        return nullptr;
+
+    return metric::instance().get_thread_slot(m_id);
+}
+
+void metric::histogram::sample(int64 value)
+{
+    series_slot* slot = local_slot();
+    if (!slot)
+        return;
+
+    slot->count.fetch_add(1, std::memory_order_relaxed);
+    slot->sum.fetch_add(value, std::memory_order_relaxed);
+
+    // only the send thread competes for the slot, and only to take the values out
+    int64 current = slot->min.load(std::memory_order_relaxed);
+    while (value < current && !slot->min.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    current = slot->max.load(std::memory_order_relaxed);
+    while (value > current && !slot->max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+
+    uint32 bucket = 0;
+    for (uint64 bits = value > 0 ? uint64(value) : 0; bits && bucket < HISTOGRAM_BUCKETS - 1; bits >>= 1)
+        ++bucket;
+    slot->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
 metric::metric::metric()
 {
     initialize();
@@ -147,6 +201,140 @@ void metric::metric::report(std::string measurement, std::map<std::string, boost
     });
 }
 
+uint32 metric::metric::register_series(series* entry)
+{
+    std::lock_guard<std::mutex> guard(m_seriesLock);
+    for (uint32 id = 0; id < m_series.size(); ++id)
+    {
+        if (!m_series[id])
+        {
+            m_series[id] = entry;
+            return id;
+        }
+    }
+
+    m_series.push_back(entry);
+    return m_series.size() - 1;
+}
+
+void metric::metric::unregister_series(series* entry)
+{
+    std::lock_guard<std::mutex> guard(m_seriesLock);
+    // sends what was sampled since the last send, which also leaves the slots clean for the next owner of the id
+    collect_series(*entry);
+    m_series[entry->get_id()] = nullptr;
+}
+
+metric::series_slot* metric::metric::get_thread_slot(uint32 id)
+{
+    thread_local std::shared_ptr<thread_slots> local;
+    if (!local)
+    {
+        local = std::make_shared<thread_slots>();
+        std::lock_guard<std::mutex> guard(m_seriesLock);
+        m_threadSlots.push_back(local);
+    }
+
+    if (id >= local->slots.size() || !local->slots[id])
+    {
+        std::lock_guard<std::mutex> guard(local->lock);
+        if (id >= local->slots.size())
+            local->slots.resize(id + 1);
+        local->slots[id].reset(new series_slot());
+    }
+
+    return local->slots[id].get();
+}
+
+void metric::metric::collect_series()
+{
+    std::lock_guard<std::mutex> guard(m_seriesLock);
+    for (series* entry : m_series)
+        if (entry)
+            collect_series(*entry);
+
+    // the values of exited threads are collected above, nothing can add to them any more
+    m_threadSlots.erase(std::remove_if(m_threadSlots.begin(), m_threadSlots.end(), [](std::shared_ptr<thread_slots> const& slots)
+    {
+        return slots.use_count() == 1;
+    }), m_threadSlots.end());
+}
+
+void metric::metric::collect_series(series const& entry)
+{
+    int64 count = 0;
+    int64 sum = 0;
+    int64 min = std::numeric_limits<int64>::max();
+    int64 max = std::numeric_limits<int64>::min();
+    uint64 buckets[HISTOGRAM_BUCKETS] = {};
+
+    for (auto const& thread : m_threadSlots)
+    {
+        std::lock_guard<std::mutex> guard(thread->lock);
+        if (entry.get_id() >= thread->slots.size() || !thread->slots[entry.get_id()])
+            continue;
+
+        series_slot& slot = *thread->slots[entry.get_id()];
+        count += slot.count.exchange(0, std::memory_order_relaxed);
+        sum += slot.sum.exchange(0, std::memory_order_relaxed);
+        min = std::min(min, slot.min.exchange(std::numeric_limits<int64>::max(), std::memory_order_relaxed));
+        max = std::max(max, slot.max.exchange(std::numeric_limits<int64>::min(), std::memory_order_relaxed));
+        for (uint32 i = 0; i < HISTOGRAM_BUCKETS; ++i)
+            buckets[i] += slot.buckets[i].exchange(0, std::memory_order_relaxed);
+    }
+
+
+    std::map<std::string, boost::any> fields;
+    switch (entry.get_type())
+    {
+        case SERIES_COUNTER:
+        {
+            if (!sum)
+                return;
+            fields["count"] = sum;
+            break;
+        }
+        case SERIES_GAUGE:
+        {
+            int64 value;
+            if (!static_cast<gauge const&>(entry).get(value))
+                return;
+            fields["value"] = value;
+            break;
+        }
+        case SERIES_HISTOGRAM:
+        {
+            if (!count)
+                return;
+            fields["count"] = count;
+            fields["sum"] = sum;
+            fields["min"] = min;
+            fields["max"] = max;
+
+            // upper bound of the bucket holding the percentile, within the sampled range
+            std::pair<char const*, int64> const percentiles[] = { { "p50", 50 }, { "p95", 95 }, { "p99", 99 } };
+            for (auto const& percentile : percentiles)
+            {
+                int64 const target = (count * percentile.second + 99) / 100;
+                int64 seen = 0;
+                uint32 bucket = 0;
+                for (; bucket < HISTOGRAM_BUCKETS - 1; ++bucket)
+                {
+                    seen += buckets[bucket];
+                    if (seen >= target)
+                        break;
+                }
+                int64 const bound = bucket ? (int64(1) << bucket) - 1 : 0;
+                fields[percentile.first] = std::max(min, std::min(max, bound));
+            }
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_queueWriteLock);
+    m_measurementQueue.push_back(std::unique_ptr<Measurement>(new Measurement(entry.get_name(), entry.get_tags(), fields)));
+}
+
 void metric::metric::schedule_timer()
 {
     using namespace std::placeholders;
@@ -168,6 +356,7 @@ void metric::metric::prepare_send(const boost::system::error_code& ec)
         return;
     }
 
+    collect_series();
     send();
     schedule_timer();
 }
@@ -21,10 +21,13 @@
 
 #include <boost/any.hpp>
 #include <boost/asio.hpp>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -105,6 +108,115 @@ namespace metric
             std::chrono::high_resolution_clock::time_point m_startTime;
     };
 
+    /*
+     * Pre-registered series for hot paths. Name and tags are given once at construction, samples only
+     * add to slots owned by the sampling thread and are aggregated into one measurement per series at
+     * every send. A series must not be sampled any more once its destruction started.
+     */
+    enum series_type
+    {
+        SERIES_COUNTER,                                     // sum of the added values since the last send
+        SERIES_GAUGE,                                       // last set value
+        SERIES_HISTOGRAM,                                   // count, sum, min, max and percentiles of the samples
+    };
+
+    static const uint32 HISTOGRAM_BUCKETS = 32;             // bucket n holds values below 2^n
+
+    struct series_slot
+    {
+        series_slot() { reset(); }
+        void reset();
+
+        std::atomic<int64> count;
+        std::atomic<int64> sum;
+        std::atomic<int64> min;
+        std::atomic<int64> max;
+        std::atomic<uint32> buckets[HISTOGRAM_BUCKETS];
+    };
+
+    class series
+    {
+        public:
+            series(series_type type, std::string name, std::map<std::string, std::string> tags = {});
+            virtual ~series();
+
+            series(series const&) = delete;
+            series& operator=(series const&) = delete;
+
+            series_type get_type() const { return m_type; }
+            std::string const& get_name() const { return m_name; }
+            std::map<std::string, std::string> const& get_tags() const { return m_tags; }
+            uint32 get_id() const { return m_id; }
+
+        protected:
+            series_slot* local_slot() const;
+
+            bool m_enabled;
+
+        private:
+            series_type m_type;
+            std::string m_name;
+            std::map<std::string, std::string> m_tags;
+            uint32 m_id;
+    };
+
+    class counter : public series
+    {
+        public:
+            counter(std::string name, std::map<std::string, std::string> tags = {}) : series(SERIES_COUNTER, std::move(name), std::move(tags)) {}
+
+            void add(int64 value = 1)
+            {
+                if (series_slot* slot = local_slot())
+                    slot->sum.fetch_add(value, std::memory_order_relaxed);
+            }
+    };
+
+    class gauge : public series
+    {
+        public:
+            gauge(std::string name, std::map<std::string, std::string> tags = {}) : series(SERIES_GAUGE, std::move(name), std::move(tags)), m_value(0), m_set(false) {}
+
+            void set(int64 value)
+            {
+                if (!m_enabled)
+                    return;
+                m_value.store(value, std::memory_order_relaxed);
+                m_set.store(true, std::memory_order_relaxed);
+            }
+
+            bool get(int64& value) const
+            {
+                value = m_value.load(std::memory_order_relaxed);
+                return m_set.load(std::memory_order_relaxed);
+            }
+
+        private:
+            std::atomic<int64> m_value;
+            std::atomic<bool> m_set;
+    };
+
+    class histogram : public series
+    {
+        public:
+            histogram(std::string name, std::map<std::string, std::string> tags = {}) : series(SERIES_HISTOGRAM, std::move(name), std::move(tags)) {}
+
+            void sample(int64 value);
+
+            // samples the time until it goes out of scope
+            template <class precision>
+            class timer
+            {
+                public:
+                    explicit timer(histogram& target) : m_target(target), m_startTime(std::chrono::steady_clock::now()) {}
+                    ~timer() { m_target.sample(std::chrono::duration_cast<precision>(std::chrono::steady_clock::now() - m_startTime).count()); }
+
+                private:
+                    histogram& m_target;
+                    std::chrono::steady_clock::time_point m_startTime;
+            };
+    };
+
     class metric
     {
         public:
@@ -117,7 +229,19 @@ namespace metric
             void report(std::string measurement, std::string key, boost::any value, std::map<std::string, std::string> tags = {});
             void report(std::string measurement, std::map<std::string, boost::any> fields, std::map<std::string, std::string> tags = {});
 
+            bool is_enabled() const { return m_enabled; }
+
+            uint32 register_series(series* entry);
+            void unregister_series(series* entry);
+            series_slot* get_thread_slot(uint32 id);
+
         private:
+            struct thread_slots
+            {
+                std::mutex lock;                            // taken by the owning thread only to add slots
+                std::vector<std::unique_ptr<series_slot>> slots;
+            };
+
             boost::asio::io_service m_queueService;
             boost::asio::io_service m_writeService;
 
@@ -133,6 +257,12 @@ namespace metric
             std::mutex m_queueWriteLock;
             std::vector<std::unique_ptr<Measurement>> m_measurementQueue;
 
+            std::mutex m_seriesLock;
+            std::vector<series*> m_series;                  // by id, nullptr for free ids
+            std::vector<std::shared_ptr<thread_slots>> m_threadSlots;
+
+            void collect_series();
+            void collect_series(series const& entry);
             void schedule_timer();
             void prepare_send(const boost::system::error_code& ec);
             void send();
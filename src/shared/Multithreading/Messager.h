@@ -19,34 +19,90 @@
 #ifndef MANGOS_MESSAGER_H
 #define MANGOS_MESSAGER_H
 
-#include <vector>
-#include <mutex>
+#include <atomic>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
+// Multiple producers, single consumer mailbox
+// producers push lock-free on top of an intrusive stack, the consumer takes the whole stack at once
+// in Execute and runs it in the order messages were added
+// every message is a single allocation holding the callable itself, no std::function wrapping
 template <class T>
 class Messager
 {
+    private:
+        struct MessageBase
+        {
+            MessageBase() : next(nullptr) {}
+            virtual ~MessageBase() = default;
+            virtual void Execute(T* object) = 0;
+
+            MessageBase* next;
+        };
+
+        template <class F>
+        struct Message : public MessageBase
+        {
+            template <class U>
+            explicit Message(U&& callable) : m_callable(std::forward<U>(callable)) {}
+            void Execute(T* object) override { m_callable(object); }
+
+            F m_callable;
+        };
+
     public:
-        void AddMessage(const std::function<void(T*)>& message)
+        Messager() : m_head(nullptr) {}
+        Messager(const Messager&) = delete;
+        Messager& operator=(const Messager&) = delete;
+
+        ~Messager()
+        {
+            MessageBase* message = m_head.exchange(nullptr, std::memory_order_acquire);
+            while (message)
+            {
+                MessageBase* next = message->next;
+                delete message;
+                message = next;
+            }
+        }
+
+        template <class F>
+        void AddMessage(F&& message)
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            m_messageVector.push_back(message);
+            MessageBase* node = new Message<typename std::decay<F>::type>(std::forward<F>(message));
+            node->next = m_head.load(std::memory_order_relaxed);
+            while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
         }
+
         void Execute(T* object)
         {
-            std::vector<std::function<void(T*)>> messageVectorCopy;
+            MessageBase* message = m_head.exchange(nullptr, std::memory_order_acquire);
+            if (!message)
+                return;
+
+            // stack holds newest message first, restore adding order
+            MessageBase* ordered = nullptr;
+            while (message)
             {
-                std::lock_guard<std::mutex> guard(m_messageMutex);
-                std::swap(m_messageVector, messageVectorCopy);
+                MessageBase* next = message->next;
+                message->next = ordered;
+                ordered = message;
+                message = next;
             }
-            for (auto& message : messageVectorCopy)
-                message(object);
 
-            messageVectorCopy.clear();
+            // messages added while executing are kept for next call, same as before
+            while (ordered)
+            {
+                MessageBase* next = ordered->next;
+                ordered->Execute(object);
+                delete ordered;
+                ordered = next;
+            }
         }
+
     private:
-        std::vector<std::function<void(T*)>> m_messageVector;
-        std::mutex m_messageMutex;  
+        std::atomic<MessageBase*> m_head;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -21,8 +21,13 @@
 
 #include "NetworkThread.hpp"
 
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
 #include <boost/asio.hpp>
 
+#include <future>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -33,8 +38,14 @@ namespace MaNGOS
     class Listener
     {
         private:
+            typedef boost::asio::ip::tcp::acceptor Acceptor;
+
             boost::asio::io_service m_service;
-            boost::asio::ip::tcp::acceptor m_acceptor;
+
+            // a single acceptor run by m_acceptorThread, or with SO_REUSEPORT one acceptor per worker
+            // thread, each bound to the same endpoint and run by the service of that worker
+            std::vector<std::unique_ptr<Acceptor>> m_acceptors;
+            bool m_reusePort;
 
             std::thread m_acceptorThread;
             std::vector<std::unique_ptr<NetworkThread<SocketType>>> m_workerThreads;
@@ -42,6 +53,7 @@ namespace MaNGOS
             // the time in milliseconds to sleep a worker thread at the end of each tick
             const int SleepInterval = 100;
 
+            // least loaded worker by live socket count, sockets still waiting in accept included
             NetworkThread<SocketType> *SelectWorker() const
             {
                 int minIndex = 0;
@@ -61,62 +73,142 @@ namespace MaNGOS
                 return m_workerThreads[minIndex].get();
             }
 
-            void BeginAccept();
-            void OnAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
+            static std::unique_ptr<Acceptor> CreateReusePortAcceptor(boost::asio::io_service& service, boost::asio::ip::tcp::endpoint const& endpoint);
+
+            void BeginAccept(Acceptor* acceptor);
+            void OnAccept(Acceptor* acceptor, NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec);
 
         public:
-            Listener(std::string const& address, int port, int workerThreads);
+            Listener(std::string const& address, int port, int workerThreads, bool reusePort = false);
             ~Listener();
     };
 
     template <typename SocketType>
-    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads)
-    : m_service(), m_acceptor(m_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(address), port))
+    Listener<SocketType>::Listener(std::string const& address, int port, int workerThreads, bool reusePort)
+    : m_service(), m_reusePort(false)
     {
         m_workerThreads.reserve(workerThreads);
         for (auto i = 0; i < workerThreads; ++i)
             m_workerThreads.push_back(std::unique_ptr<NetworkThread<SocketType>>(new NetworkThread<SocketType>));
 
-        BeginAccept();
+        boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address::from_string(address), port);
+
+#ifdef SO_REUSEPORT
+        // only worth it when several threads can accept at once
+        m_reusePort = reusePort && workerThreads > 1;
+#else
+        (void)reusePort;
+#endif
+
+        if (m_reusePort)
+        {
+            for (auto& worker : m_workerThreads)
+                m_acceptors.push_back(CreateReusePortAcceptor(worker->GetService(), endpoint));
+
+            for (size_t i = 0; i < m_acceptors.size(); ++i)
+            {
+                Acceptor* acceptorPtr = m_acceptors[i].get();
+                m_workerThreads[i]->GetService().post([this, acceptorPtr]() { BeginAccept(acceptorPtr); });
+            }
+        }
+        else
+        {
+            m_acceptors.push_back(std::unique_ptr<Acceptor>(new Acceptor(m_service, endpoint)));
+
+            BeginAccept(m_acceptors.front().get());
 
-        m_acceptorThread = std::thread([this]() { m_service.run(); });
+            m_acceptorThread = std::thread([this]() { m_service.run(); });
+        }
     }
 
     template <typename SocketType>
     Listener<SocketType>::~Listener()
     {
-        // Close the acceptor. This will cancel any asynchronous accept
+        // Close the acceptors. This will cancel any asynchronous accept
         // operation and should stop the acceptor thread. Note that closing
-        // the acceptor needs to be done in the acceptor thread, because
-        // using the m_acceptor object from multiple threads is unsafe!
-        m_service.post( [this]() { m_acceptor.close(); } );
-        m_acceptorThread.join();
+        // an acceptor needs to be done in the thread running it, because
+        // using an acceptor object from multiple threads is unsafe!
+        if (m_reusePort)
+        {
+            // per worker acceptors are closed by their own worker thread. the cancelled accept handler
+            // is queued by close() so signalling through a second post means it has already run
+            std::vector<std::future<void>> closed;
+            closed.reserve(m_acceptors.size());
+            for (size_t i = 0; i < m_acceptors.size(); ++i)
+            {
+                auto done = std::make_shared<std::promise<void>>();
+                closed.push_back(done->get_future());
+                Acceptor* acceptorPtr = m_acceptors[i].get();
+                boost::asio::io_service& service = m_workerThreads[i]->GetService();
+                service.post([acceptorPtr, &service, done]()
+                {
+                    acceptorPtr->close();
+                    service.post([done]() { done->set_value(); });
+                });
+            }
+
+            for (auto& future : closed)
+                future.wait();
+
+            // the acceptors belong to the services of the workers, which are destroyed before them
+            m_acceptors.clear();
+        }
+        else
+        {
+            Acceptor* acceptorPtr = m_acceptors.front().get();
+            m_service.post([acceptorPtr]() { acceptorPtr->close(); });
+            m_acceptorThread.join();
+        }
     }
 
     template <typename SocketType>
-    void Listener<SocketType>::BeginAccept()
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> Listener<SocketType>::CreateReusePortAcceptor(boost::asio::io_service& service, boost::asio::ip::tcp::endpoint const& endpoint)
+    {
+        std::unique_ptr<Acceptor> acceptor(new Acceptor(service));
+        acceptor->open(endpoint.protocol());
+        acceptor->set_option(Acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+        // kernel spreads incoming connections between all acceptors bound with this option
+        acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+#endif
+        acceptor->bind(endpoint);
+        acceptor->listen();
+        return acceptor;
+    }
+
+    template <typename SocketType>
+    void Listener<SocketType>::BeginAccept(Acceptor* acceptor)
     {
         auto worker = SelectWorker();
         auto socket = worker->CreateSocket();
 
-        m_acceptor.async_accept(socket->GetAsioSocket(),
-            [this, worker, socket] (const boost::system::error_code &ec)
+        acceptor->async_accept(socket->GetAsioSocket(),
+            [this, acceptor, worker, socket] (const boost::system::error_code &ec)
         {
-            this->OnAccept(worker, socket, ec);
+            this->OnAccept(acceptor, worker, socket, ec);
         });
     }
 
     template <typename SocketType>
-    void Listener<SocketType>::OnAccept(NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec)
+    void Listener<SocketType>::OnAccept(Acceptor* acceptor, NetworkThread<SocketType> *worker, std::shared_ptr<SocketType> const& socket, const boost::system::error_code &ec)
     {
-        // an error has occurred
-        if (ec)
-            worker->RemoveSocket(socket.get());
-        else
-            socket->Open();
-
-        if (m_acceptor.is_open())
-            BeginAccept();
+        {
+#ifdef BUILD_METRICS
+            // time needed to get an accepted connection going, grows when the accept path is congested
+            metric::duration<std::chrono::microseconds> meas("network.accept", { { "reuseport", m_reusePort ? "1" : "0" } });
+            if (ec)
+                meas.add_tag("error", "1");
+#endif
+
+            // an error has occurred
+            if (ec)
+                worker->RemoveSocket(socket.get());
+            else
+                socket->Open();
+        }
+
+        if (acceptor->is_open())
+            BeginAccept(acceptor);
     }
 }
 
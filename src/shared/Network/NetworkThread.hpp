@@ -20,9 +20,12 @@
 #define __NETWORK_THREAD_HPP_
 
 #include "Socket.hpp"
+#include "ThreadAffinity.h"
+#include "TraceRecorder.h"
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <unordered_set>
@@ -37,6 +40,7 @@ namespace MaNGOS
 
             std::mutex m_socketLock;
             std::unordered_set<std::shared_ptr<SocketType>> m_sockets;
+            std::atomic<size_t> m_socketCount;                  // size of m_sockets, readable without the lock
 
             // note that the work member *must* be declared after the service member for the work constructor to function correctly
             std::unique_ptr<boost::asio::io_service::work> m_work;
@@ -44,7 +48,7 @@ namespace MaNGOS
             std::thread m_serviceThread;
 
         public:
-            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
+            NetworkThread() : m_socketCount(0), m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { TraceRecorder::SetThreadName("network"); ThreadAffinity::PinCurrentThread(THREAD_CLASS_NETWORK); boost::system::error_code ec; this->m_service.run(ec); })
             {
                 m_serviceThread.detach();
             }
@@ -65,14 +69,17 @@ namespace MaNGOS
                 }
             }
 
-            size_t Size() const { return m_sockets.size(); }
+            size_t Size() const { return m_socketCount.load(std::memory_order_relaxed); }
+
+            boost::asio::io_service& GetService() { return m_service; }
 
             std::shared_ptr<SocketType> CreateSocket();
 
             void RemoveSocket(Socket *socket)
             {
                 std::lock_guard<std::mutex> guard(m_socketLock);
-                m_sockets.erase(socket->shared<SocketType>());
+                if (m_sockets.erase(socket->shared<SocketType>()))
+                    m_socketCount.fetch_sub(1, std::memory_order_relaxed);
             }
     };
 
@@ -85,6 +92,8 @@ namespace MaNGOS
 
         MANGOS_ASSERT(i.second);
 
+        m_socketCount.fetch_add(1, std::memory_order_relaxed);
+
         return *i.first;
     }
 }
@@ -18,6 +18,7 @@
 
 #include "Socket.hpp"
 #include "Log.h"
+#include "TraceRecorder.h"
 
 #include <boost/asio.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -52,8 +53,6 @@ namespace MaNGOS
             return false;
         }
 
-        m_outBuffer.reset(new PacketBuffer);
-        m_secondaryOutBuffer.reset(new PacketBuffer);
         m_inBuffer.reset(new PacketBuffer);
 
         StartAsyncRead();
@@ -92,6 +91,8 @@ namespace MaNGOS
 
     void Socket::OnRead(const boost::system::error_code& error, size_t length)
     {
+        TraceScope trace("network", "Socket::OnRead");
+
         if (error)
         {
             m_readState = ReadState::Idle;
@@ -170,31 +171,48 @@ namespace MaNGOS
 
     void Socket::Write(const char* header, int headerSize, const char* content, int contentSize)
     {
-        std::lock_guard<std::mutex> guard(m_mutex);
-
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        std::shared_ptr<ByteBuffer> buffer = std::make_shared<ByteBuffer>(contentSize);
+        buffer->append(content, contentSize);
 
-        // write the header
-        outBuffer->Write(header, headerSize);
+        Write(header, headerSize, std::move(buffer));
+    }
 
-        // write the content
-        outBuffer->Write(content, contentSize);
+    void Socket::Write(const char* header, int headerSize, std::shared_ptr<const ByteBuffer> content)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
 
-        // flush data if need
-        if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+        QueueChunk(header, headerSize, std::move(content));
     }
 
     void Socket::Write(const char* buffer, int length)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        // small writes fit in the chunk itself
+        if (size_t(length) <= MaxInlineSize)
+        {
+            QueueChunk(buffer, length, nullptr);
+            return;
+        }
+
+        std::shared_ptr<ByteBuffer> content = std::make_shared<ByteBuffer>(length);
+        content->append(buffer, length);
+
+        QueueChunk(nullptr, 0, std::move(content));
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::QueueChunk(const char* header, int headerSize, std::shared_ptr<const ByteBuffer> content)
+    {
+        assert(size_t(headerSize) <= MaxInlineSize);
 
-        // write the header
-        outBuffer->Write(buffer, length);
+        m_outQueue.emplace_back();
+        OutChunk& chunk = m_outQueue.back();
+        chunk.headerSize = headerSize;
+        if (headerSize > 0)
+            memcpy(chunk.header.data(), header, headerSize);
+        if (content && content->size() > 0)
+            chunk.content = std::move(content);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
@@ -223,6 +241,8 @@ namespace MaNGOS
 
     void Socket::FlushOut()
     {
+        TraceScope trace("network", "Socket::FlushOut");
+
         // if the socket is closed, silently fail
         if (IsClosed())
         {
@@ -234,12 +254,30 @@ namespace MaNGOS
 
         assert(m_writeState == WriteState::Buffering);
 
-        // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
+        // at this point we are guarunteed that there is data to send in the queue.  send it.
         m_writeState = WriteState::Sending;
 
+        m_sendingQueue.swap(m_outQueue);
+        StartAsyncWrite();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::StartAsyncWrite()
+    {
+        m_sendBuffers.clear();
+        m_sendBuffers.reserve(m_sendingQueue.size() * 2);
+        for (OutChunk const& chunk : m_sendingQueue)
+        {
+            if (chunk.headerSize > 0)
+                m_sendBuffers.emplace_back(chunk.header.data(), chunk.headerSize);
+            if (chunk.content)
+                m_sendBuffers.emplace_back(chunk.content->contents(), chunk.content->size());
+        }
+
+        // async_write keeps going until the whole sequence is sent, so no partial writes have to be handled here
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                  make_custom_alloc_handler(m_allocator,
+        boost::asio::async_write(m_socket, m_sendBuffers,
+                                 make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
 
@@ -251,7 +289,7 @@ namespace MaNGOS
         m_outBufferFlushTimer.cancel();
     }
 
-    void Socket::OnWriteComplete(const boost::system::error_code& error, size_t length)
+    void Socket::OnWriteComplete(const boost::system::error_code& error, size_t /*length*/)
     {
         // we must check this before locking the mutex because the connection will be closed,
         // which leads to a locked mutex being destroyed.  not good!
@@ -270,37 +308,16 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
 
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
+        // everything in flight has been sent, release the shared contents
+        m_sendingQueue.clear();
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
+        // if anything was queued meanwhile, send it immediately
+        if (!m_outQueue.empty())
         {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
-
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
-
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
+            m_sendingQueue.swap(m_outQueue);
+            StartAsyncWrite();
         }
-
-        std::shared_ptr<Socket> ptr = shared<Socket>();
-        // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
         else
             m_writeState = WriteState::Idle;
     }
@@ -20,14 +20,17 @@
 #define __SOCKET_HPP_
 
 #include "PacketBuffer.hpp"
+#include "ByteBuffer.h"
 
 #include "Platform/Define.h"
 
 #include <boost/asio.hpp>
 
+#include <array>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <functional>
 
 namespace MaNGOS
@@ -39,6 +42,9 @@ namespace MaNGOS
             // ingame but increase bandwidth efficiency by reducing tcp overhead.
             static const int BufferTimeout = 50;
 
+            // largest header (or small raw write) stored inline in a queued chunk
+            static const size_t MaxInlineSize = 16;
+
             enum class WriteState
             {
                 Idle,       // no write operation is currently underway
@@ -59,9 +65,20 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // one queued write: the (already encrypted) header is kept inline and the content is
+            // shared with whoever created it, so it is handed to the kernel without further copies
+            struct OutChunk
+            {
+                std::array<uint8, MaxInlineSize> header;
+                size_t headerSize;
+                std::shared_ptr<const ByteBuffer> content;
+            };
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
-            std::unique_ptr<PacketBuffer> m_outBuffer;
-            std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+
+            std::vector<OutChunk> m_outQueue;                       // chunks waiting for the next flush
+            std::vector<OutChunk> m_sendingQueue;                   // chunks owned by the running async_write
+            std::vector<boost::asio::const_buffer> m_sendBuffers;   // buffer sequence built over m_sendingQueue
 
             std::mutex m_mutex;
             std::mutex m_closeMutex;
@@ -73,6 +90,8 @@ namespace MaNGOS
             void StartWriteFlushTimer();
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
+            void StartAsyncWrite();
+            void QueueChunk(const char *header, int headerSize, std::shared_ptr<const ByteBuffer> content);
 
             void OnError(const boost::system::error_code &error);
 
@@ -105,6 +124,8 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            // content is shared instead of copied, it must not be modified once passed here
+            void Write(const char *header, int headerSize, std::shared_ptr<const ByteBuffer> content);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
@@ -160,7 +160,8 @@ void SRP6::HashSessionKey(void)
 
 bool SRP6::Proof(uint8* lp_M, int l)
 {
-    if (!memcmp(M.AsByteArray(), lp_M, l))
+    // a digest starting with zeros must still be compared in full
+    if (!memcmp(M.AsByteArray(l), lp_M, l))
         return false;
 
     return true;
@@ -0,0 +1,98 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ThreadAffinity.h"
+#include "Config/Config.h"
+#include "Log.h"
+#include "Util.h"
+
+#if PLATFORM == PLATFORM_WINDOWS
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+char const* ThreadAffinity::GetConfigName(ThreadClass threadClass)
+{
+    switch (threadClass)
+    {
+        case THREAD_CLASS_WORLD:    return "Affinity.WorldThreads";
+        case THREAD_CLASS_MAP:      return "Affinity.MapThreads";
+        case THREAD_CLASS_NETWORK:  return "Affinity.NetworkThreads";
+        case THREAD_CLASS_DATABASE: return "Affinity.DatabaseThreads";
+    }
+    return "";
+}
+
+bool ThreadAffinity::ParseCpuList(std::string const& text, std::vector<uint32>& cpus)
+{
+    cpus.clear();
+
+    Tokens ranges = StrSplit(text, ",");
+    for (std::string const& range : ranges)
+    {
+        uint32 first, last;
+        char dash;
+        int fields = sscanf(range.c_str(), " %u %c %u", &first, &dash, &last);
+        if (fields == 1)
+            last = first;
+        else if (fields != 3 || dash != '-' || last < first)
+            return false;
+
+        for (uint32 cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    return !cpus.empty();
+}
+
+void ThreadAffinity::PinCurrentThread(ThreadClass threadClass)
+{
+    std::string text = sConfig.GetStringDefault(GetConfigName(threadClass), "");
+    if (text.empty())
+        return;
+
+    std::vector<uint32> cpus;
+    if (!ParseCpuList(text, cpus))
+    {
+        sLog.outError("ThreadAffinity: %s = \"%s\" is not a list of cpus like \"0-7,16-23\", thread not pinned.", GetConfigName(threadClass), text.c_str());
+        return;
+    }
+
+#if PLATFORM == PLATFORM_WINDOWS
+    DWORD_PTR mask = 0;
+    for (uint32 cpu : cpus)
+        if (cpu < sizeof(DWORD_PTR) * 8)
+            mask |= DWORD_PTR(1) << cpu;
+
+    if (!mask || !SetThreadAffinityMask(GetCurrentThread(), mask))
+        sLog.outError("ThreadAffinity: can't pin a thread to %s = \"%s\".", GetConfigName(threadClass), text.c_str());
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (uint32 cpu : cpus)
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+
+    if (int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+        sLog.outError("ThreadAffinity: can't pin a thread to %s = \"%s\" (error %i).", GetConfigName(threadClass), text.c_str(), error);
+#else
+    sLog.outError("ThreadAffinity: %s is not supported on this platform.", GetConfigName(threadClass));
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_THREAD_AFFINITY_H
+#define MANGOS_THREAD_AFFINITY_H
+
+#include "Common.h"
+
+#include <string>
+#include <vector>
+
+enum ThreadClass
+{
+    THREAD_CLASS_WORLD      = 0,                            // world thread and the session update workers
+    THREAD_CLASS_MAP        = 1,                            // map and grid cell update workers
+    THREAD_CLASS_NETWORK    = 2,                            // socket io threads
+    THREAD_CLASS_DATABASE   = 3,                            // async database threads
+};
+
+#define MAX_THREAD_CLASS 4
+
+/**
+ * Pins threads to the cpus configured for their class (Affinity.* settings), so that for example the
+ * map workers of a two socket host stay on one socket and keep the continent data in its cache and memory.
+ * Memory is placed on the node of the thread first touching it, so grids loaded by pinned map workers
+ * end up local to them as well. Nothing is pinned while the setting of the class is empty.
+ */
+class ThreadAffinity
+{
+    public:
+        // pins the calling thread, call it first thing in the thread
+        static void PinCurrentThread(ThreadClass threadClass);
+
+        // "0-7,16-23" to the listed cpus, false if malformed
+        static bool ParseCpuList(std::string const& text, std::vector<uint32>& cpus);
+
+        static char const* GetConfigName(ThreadClass threadClass);
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "TraceRecorder.h"
+#include "Log.h"
+
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(TraceRecorder);
+
+std::atomic<bool> TraceRecorder::s_recording(false);
+
+thread_local std::shared_ptr<TraceRecorder::ThreadBuffer> TraceRecorder::t_threadBuffer;
+thread_local std::string TraceRecorder::t_threadName;
+
+namespace
+{
+    // names are literals of the core, the detail may hold anything
+    void WriteJsonString(FILE* file, char const* str)
+    {
+        fputc('"', file);
+        for (; *str; ++str)
+        {
+            char const c = *str;
+            if (c == '"' || c == '\\')
+            {
+                fputc('\\', file);
+                fputc(c, file);
+            }
+            else if (uint8(c) < 0x20)
+                fprintf(file, "\\u%04x", uint32(uint8(c)));
+            else
+                fputc(c, file);
+        }
+        fputc('"', file);
+    }
+}
+
+TraceRecorder::TraceRecorder() : m_generation(0), m_nextThreadId(1), m_writing(false)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    if (m_writer.joinable())
+        m_writer.join();
+}
+
+bool TraceRecorder::Start(std::string const& fileName, uint32 seconds)
+{
+    if (IsRecording() || m_writing)
+        return false;
+
+    if (m_writer.joinable())
+        m_writer.join();
+
+    {
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        m_fileName = fileName;
+    }
+
+    // events of an earlier recording are thrown away by the threads when they add the next one
+    ++m_generation;
+    m_start = Clock::now();
+    m_end = m_start + std::chrono::seconds(seconds);
+    s_recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::Stop()
+{
+    if (!IsRecording())
+        return;
+
+    s_recording = false;
+
+    std::vector<ThreadEvents> threads;
+    std::string fileName;
+    {
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        fileName = m_fileName;
+        threads.reserve(m_threads.size());
+        for (auto& buffer : m_threads)
+        {
+            std::lock_guard<std::mutex> bufferGuard(buffer->lock);
+            if (buffer->generation != m_generation)
+                continue;
+
+            ThreadEvents thread;
+            thread.threadId = buffer->thread.threadId;
+            thread.threadName = buffer->thread.threadName;
+            thread.events.swap(buffer->thread.events);
+            thread.dropped = buffer->thread.dropped;
+            buffer->thread.dropped = 0;
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    // the file can take a few hundred MB, the world thread must not wait for it
+    m_writing = true;
+    m_writer = std::thread([this, fileName, threads = std::move(threads)]() mutable
+    {
+        Write(std::move(fileName), std::move(threads));
+        m_writing = false;
+    });
+}
+
+void TraceRecorder::Update()
+{
+    if (IsRecording() && Clock::now() >= m_end)
+        Stop();
+}
+
+std::string TraceRecorder::GetFileName() const
+{
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    return m_fileName;
+}
+
+void TraceRecorder::SetThreadName(char const* name)
+{
+    t_threadName = name;
+    if (t_threadBuffer)
+    {
+        std::lock_guard<std::mutex> guard(t_threadBuffer->lock);
+        t_threadBuffer->thread.threadName = name;
+    }
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer()
+{
+    if (!t_threadBuffer)
+    {
+        std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+        buffer->thread.threadName = t_threadName;
+        buffer->thread.dropped = 0;
+        buffer->generation = 0;
+
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        buffer->thread.threadId = m_nextThreadId++;
+        m_threads.push_back(buffer);
+        t_threadBuffer = buffer;
+    }
+    return *t_threadBuffer;
+}
+
+void TraceRecorder::AddEvent(char const* category, char const* name, Clock::time_point begin, Clock::time_point end, std::string&& detail)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint32 const generation = m_generation;
+
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    if (buffer.generation != generation)
+    {
+        buffer.thread.events.clear();
+        buffer.thread.dropped = 0;
+        buffer.generation = generation;
+    }
+
+    if (buffer.thread.events.size() >= TRACE_MAX_EVENTS_PER_THREAD)
+    {
+        ++buffer.thread.dropped;
+        return;
+    }
+
+    buffer.thread.events.push_back({ category, name,
+        std::chrono::duration_cast<std::chrono::microseconds>(begin - m_start).count(),
+        uint32(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()),
+        std::move(detail) });
+}
+
+void TraceRecorder::Write(std::string fileName, std::vector<ThreadEvents> threads)
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("TraceRecorder: can not open %s for writing", fileName.c_str());
+        return;
+    }
+
+    uint32 count = 0;
+    uint32 dropped = 0;
+    bool first = true;
+    fputs("[\n", file);
+    for (ThreadEvents const& thread : threads)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", thread.threadId);
+        if (thread.threadName.empty())
+            fprintf(file, "\"thread %u\"", thread.threadId);
+        else
+            WriteJsonString(file, thread.threadName.c_str());
+        fputs("}}", file);
+        first = false;
+
+        for (Event const& event : thread.events)
+        {
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":" SI64FMTD ",\"dur\":%u,\"pid\":1,\"tid\":%u",
+                    event.name, event.category, event.begin, event.duration, thread.threadId);
+            if (!event.detail.empty())
+            {
+                fputs(",\"args\":{\"detail\":", file);
+                WriteJsonString(file, event.detail.c_str());
+                fputc('}', file);
+            }
+            fputc('}', file);
+        }
+
+        count += thread.events.size();
+        dropped += thread.dropped;
+    }
+    fputs("\n]\n", file);
+    fclose(file);
+
+    sLog.outString("TraceRecorder: %u events of %u threads written to %s (%u dropped)", count, uint32(threads.size()), fileName.c_str(), dropped);
+}
@@ -0,0 +1,143 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TRACE_RECORDER_H
+#define MANGOS_TRACE_RECORDER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// events kept per thread during one recording, the later ones are counted as dropped
+#define TRACE_MAX_EVENTS_PER_THREAD 262144
+
+/**
+ * Records begin/end spans of the threads for a few seconds and writes them as a Chrome trace
+ * (JSON array format), which chrome://tracing and ui.perfetto.dev both open.
+ */
+class TraceRecorder : public MaNGOS::Singleton<TraceRecorder, MaNGOS::ClassLevelLockable<TraceRecorder, std::mutex> >
+{
+        friend class MaNGOS::OperatorNew<TraceRecorder>;
+        TraceRecorder();
+        ~TraceRecorder();
+
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        // false while a recording is running or its file is still being written
+        bool Start(std::string const& fileName, uint32 seconds);
+        // ends the recording, the file is written by a background thread
+        void Stop();
+        // stops the recording once its time is over, called by the world thread
+        void Update();
+
+        // static so the threads never race the creation of the instance
+        static bool IsRecording() { return s_recording.load(std::memory_order_acquire); }
+        std::string GetFileName() const;
+
+        // name shown for the calling thread, kept for later recordings too
+        static void SetThreadName(char const* name);
+
+        // name and category must be string literals, detail is shown as argument of the event
+        void AddEvent(char const* category, char const* name, Clock::time_point begin, Clock::time_point end, std::string&& detail);
+
+    private:
+        struct Event
+        {
+            char const* category;
+            char const* name;
+            int64 begin;                                        // microseconds since the recording started
+            uint32 duration;                                    // microseconds
+            std::string detail;
+        };
+
+        struct ThreadEvents
+        {
+            uint32 threadId;
+            std::string threadName;
+            std::vector<Event> events;
+            uint32 dropped;
+        };
+
+        struct ThreadBuffer
+        {
+            std::mutex lock;                                    // only contended while the recording is collected
+            ThreadEvents thread;
+            uint32 generation;                                  // recording the events belong to
+        };
+
+        ThreadBuffer& GetThreadBuffer();
+
+        static thread_local std::shared_ptr<ThreadBuffer> t_threadBuffer;  // also owned by m_threads
+        static thread_local std::string t_threadName;
+        static void Write(std::string fileName, std::vector<ThreadEvents> threads);
+
+        static std::atomic<bool> s_recording;
+        std::atomic<uint32> m_generation;
+        Clock::time_point m_start;
+        Clock::time_point m_end;
+        std::string m_fileName;
+
+        mutable std::mutex m_threadsLock;                  // also guards m_fileName
+        std::vector<std::shared_ptr<ThreadBuffer>> m_threads;
+        uint32 m_nextThreadId;
+
+        std::thread m_writer;
+        std::atomic<bool> m_writing;
+};
+
+#define sTraceRecorder MaNGOS::Singleton<TraceRecorder>::Instance()
+
+/**
+ * Adds a span from its construction to its destruction while a trace is recorded.
+ */
+class TraceScope
+{
+    public:
+        TraceScope(char const* category, char const* name) : m_category(category), m_name(name), m_active(TraceRecorder::IsRecording())
+        {
+            if (m_active)
+                m_begin = TraceRecorder::Clock::now();
+        }
+        ~TraceScope()
+        {
+            if (m_active)
+                sTraceRecorder.AddEvent(m_category, m_name, m_begin, TraceRecorder::Clock::now(), std::move(m_detail));
+        }
+        TraceScope(const TraceScope&) = delete;
+
+        // building the detail is only worth it while recording
+        bool IsActive() const { return m_active; }
+        void SetDetail(std::string&& detail) { m_detail = std::move(detail); }
+
+    private:
+        char const* m_category;
+        char const* m_name;
+        bool m_active;
+        TraceRecorder::Clock::time_point m_begin;
+        std::string m_detail;
+};
+
+#endif
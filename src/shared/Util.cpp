@@ -18,25 +18,58 @@
 
 #include "Util.h"
 #include "Timer.h"
+#include "Utilities/Utf8Scan.h"
 #include <utf8.h>
-#include "TSS.h"
 
 #include <boost/asio.hpp>
 
 #include <chrono>
 #include <cstdarg>
+#include <thread>
 
-std::mt19937* initRand()
+void RandomEngine::Seed(uint64 seed)
 {
-    std::seed_seq seq = { size_t(std::time(nullptr)), size_t(std::clock()) };
-    return new std::mt19937(seq);
+    // splitmix64 spreads any seed, also 0, over the whole state
+    for (int i = 0; i < 4; i += 2)
+    {
+        uint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        m_state[i] = uint32(z);
+        m_state[i + 1] = uint32(z >> 32);
+    }
 }
 
-static MaNGOS::thread_local_ptr<std::mt19937> mtRand(&initRand);
+static RandomEngine& GetThreadGenerator()
+{
+    thread_local RandomEngine generator(
+        (uint64(std::random_device()()) << 32) ^ uint64(std::time(nullptr)) ^ uint64(std::hash<std::thread::id>()(std::this_thread::get_id())));
+    return generator;
+}
 
-std::mt19937* GetRandomGenerator()
+static thread_local RandomEngine* scopeGenerator = nullptr;
+
+RandomEngine* GetRandomGenerator()
 {
-    return mtRand.get();
+    return scopeGenerator ? scopeGenerator : &GetThreadGenerator();
+}
+
+RandomGeneratorScope::RandomGeneratorScope(RandomEngine* generator) : m_previous(scopeGenerator), m_active(generator != nullptr)
+{
+    if (m_active)
+        scopeGenerator = generator;
+}
+
+RandomGeneratorScope::~RandomGeneratorScope()
+{
+    if (m_active)
+        scopeGenerator = m_previous;
+}
+
+void rand_fill(uint32* values, size_t count)
+{
+    GetRandomGenerator()->Fill(values, count);
 }
 
 uint32 WorldTimer::m_iTime = 0;
@@ -67,56 +100,54 @@ uint32 WorldTimer::getMSTime()
 //////////////////////////////////////////////////////////////////////////
 int32 irand(int32 min, int32 max)
 {
-    std::uniform_int_distribution<int32> dist(min, max);
-    return dist(*mtRand.get());
+    uint32 const range = uint32(int64(max) - int64(min) + 1);
+    RandomEngine& generator = *GetRandomGenerator();
+    return int32(int64(min) + (range ? generator.Below(range) : generator()));
 }
 
 uint32 urand(uint32 min, uint32 max)
 {
-    std::uniform_int_distribution<uint32> dist(min, max);
-    return dist(*mtRand.get());
+    uint32 const range = max - min + 1;
+    RandomEngine& generator = *GetRandomGenerator();
+    return min + (range ? generator.Below(range) : generator());
 }
 
 float frand(float min, float max)
 {
-    std::uniform_real_distribution<float> dist(min, max);
-    return dist(*mtRand.get());
+    return min + (max - min) * rand_norm_f();
 }
 
 int32 irand()
 {
-    std::uniform_int_distribution<int32> dist;
-    return dist(*mtRand.get());
+    return int32((*GetRandomGenerator())() >> 1);
 }
 
 uint32 urand()
 {
-    std::uniform_int_distribution<uint32> dist;
-    return dist(*mtRand.get());
+    return (*GetRandomGenerator())();
 }
 
 double rand_norm()
 {
-    std::uniform_real_distribution<double> dist(0, 1.0f);
-    return dist(*mtRand.get());
+    RandomEngine& generator = *GetRandomGenerator();
+    uint64 const bits = (uint64(generator()) << 21) ^ (generator() >> 11);
+    return double(bits) * (1.0 / 9007199254740992.0);     // 53 bits, all a double holds
 }
 
 float rand_norm_f()
 {
-    std::uniform_real_distribution<float> dist(0, 1.0f);
-    return dist(*mtRand.get());
+    return float((*GetRandomGenerator())() >> 8) * (1.0f / 16777216.0f);
 }
 
 double rand_chance()
 {
-    std::uniform_real_distribution<double> dist(0, 100.0);
-    return dist(*mtRand.get());
+    return double((*GetRandomGenerator())()) * (100.0 / 4294967296.0);
 }
 
 float rand_chance_f()
 {
-    std::uniform_real_distribution<double> dist(0, 100.0);
-    return float(dist(*mtRand.get()));
+    // 23 bits, so the largest roll does not round up to 100 as a float
+    return float(double((*GetRandomGenerator())() >> 9) * (100.0 / 8388608.0));
 }
 
 Tokens StrSplit(const std::string& src, const std::string& sep)
@@ -311,46 +342,59 @@ bool Utf8toWStr(const std::string& utf8str, std::wstring& wstr, size_t max_len)
         return true;
     }
 
-    try
-    {
-        // A UTF8 string can have a maximum of 4 octets per character
-        // A 4 octet char can take up to two UTF16 characters (4*8 = 32 / 16 = 2)
-        // The UTF8 string may also actually be ASCII, in which case no truncation
-        // takes place! The final string length is therefore unknown. Reserve
-        // as long as the OG string, and back-insert
-        wstr.resize(utf8str.size());
-
-        auto end = utf8::utf8to16(utf8str.cbegin(), utf8str.cend(), wstr.begin());
-
-        if (end != wstr.end())
-            wstr.erase(end, wstr.end());
-
-        // truncate to max len
-        if (!!max_len && wstr.size() > max_len)
+    // A UTF8 string can have a maximum of 4 octets per character
+    // A 4 octet char can take up to two UTF16 characters (4*8 = 32 / 16 = 2)
+    // The UTF8 string may also actually be ASCII, in which case no truncation
+    // takes place! The final string length is therefore unknown. Reserve
+    // as long as the OG string, and back-insert
+    wstr.resize(utf8str.size());
+
+    // the ascii runs are widened as they are, only the other characters are decoded
+    wchar_t* out = &wstr[0];
+    bool valid = MaNGOS::Utf8Scan(utf8str.data(), utf8str.size(),
+        [&out](char const* ascii, size_t count)
         {
-            wstr.resize(max_len);
-        }
-    }
-    catch (const std::exception&)
+            out = std::copy(ascii, ascii + count, out);
+        },
+        [&out](uint32_t codePoint)
+        {
+            if (codePoint > 0xFFFF)                         // surrogate pair, as utf8::utf8to16
+            {
+                *out++ = wchar_t((codePoint >> 10) + 0xD7C0);
+                *out++ = wchar_t((codePoint & 0x3FF) + 0xDC00);
+            }
+            else
+                *out++ = wchar_t(codePoint);
+        });
+
+    if (!valid)
     {
         wstr = L"";
         return false;
     }
 
+    wstr.resize(out - wstr.data());
+
+    // truncate to max len
+    if (!!max_len && wstr.size() > max_len)
+    {
+        wstr.resize(max_len);
+    }
+
     return true;
 }
 
 size_t utf8length(std::string& utf8str)
 {
-    try
-    {
-        return utf8::distance(utf8str.c_str(), utf8str.c_str() + utf8str.size());
-    }
-    catch (const std::exception&)
-    {
-        utf8str = "";
-    }
+    size_t length = 0;
+    bool valid = MaNGOS::Utf8Scan(utf8str.data(), utf8str.size(),
+        [&length](char const*, size_t count) { length += count; },
+        [&length](uint32_t) { ++length; });
 
+    if (valid)
+        return length;
+
+    utf8str = "";
     return 0;
 }
 
@@ -358,6 +402,14 @@ size_t utf8limit(std::string& utf8str, size_t bytes)
 {
     if (utf8str.size() > bytes)
     {
+        // ascii up to the limit, no character is cut
+        if (MaNGOS::Utf8AsciiPrefix(utf8str.data(), bytes) == bytes)
+        {
+            utf8str.resize(bytes);
+            utf8str.shrink_to_fit();
+            return bytes;
+        }
+
         try
         {
             auto end = (utf8str.cbegin() + bytes);
@@ -499,6 +551,18 @@ bool consoleToUtf8(const std::string& conStr, std::string& utf8str)
 
 bool Utf8FitTo(const std::string& str, const std::wstring& search)
 {
+    // an ascii name is compared as it is, wcharToLower only folds A-Z of it
+    if (MaNGOS::Utf8IsAscii(str.data(), str.size()))
+    {
+        if (search.empty())
+            return true;
+
+        return std::search(str.begin(), str.end(), search.begin(), search.end(), [](char c, wchar_t wchar)
+        {
+            return wchar_t(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c) == wchar;
+        }) != str.end();
+    }
+
     std::wstring temp;
 
     if (!Utf8toWStr(str, temp))
@@ -44,7 +44,84 @@ inline uint32 secsToTimeBitFields(time_t secs)
     return (lt->tm_year - 100) << 24 | lt->tm_mon  << 20 | (lt->tm_mday - 1) << 14 | lt->tm_wday << 11 | lt->tm_hour << 6 | lt->tm_min;
 }
 
-std::mt19937* GetRandomGenerator();
+/**
+ * xoshiro128++, a small and fast generator for the gameplay rolls, usable with the <random>
+ * distributions and std::shuffle. Each thread has its own, so no roll shares state with another thread.
+ */
+class RandomEngine
+{
+    public:
+        typedef uint32 result_type;
+
+        explicit RandomEngine(uint64 seed = 0) { Seed(seed); }
+
+        void Seed(uint64 seed);
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return 0xFFFFFFFF; }
+
+        result_type operator()()
+        {
+            uint32 const result = Rotl(m_state[0] + m_state[3], 7) + m_state[0];
+            uint32 const t = m_state[1] << 9;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = Rotl(m_state[3], 11);
+
+            return result;
+        }
+
+        // uniform in 0..range-1, range must not be 0
+        uint32 Below(uint32 range)
+        {
+            uint64 scaled = uint64((*this)()) * range;
+            if (uint32(scaled) < range)
+            {
+                // drop the few numbers that would favour the low values
+                uint32 const threshold = uint32(-range) % range;
+                while (uint32(scaled) < threshold)
+                    scaled = uint64((*this)()) * range;
+            }
+            return uint32(scaled >> 32);
+        }
+
+        void Fill(uint32* values, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+                values[i] = (*this)();
+        }
+
+    private:
+        static uint32 Rotl(uint32 value, int shift) { return (value << shift) | (value >> (32 - shift)); }
+
+        uint32 m_state[4];
+};
+
+/* Return the generator of the calling thread, or the one of the current RandomGeneratorScope. */
+RandomEngine* GetRandomGenerator();
+
+/* Makes all rolls of the calling thread use the given generator until the scope ends, e.g. the
+ * one of a map to repeat its rolls whichever thread updates it. Does nothing for a nullptr. */
+class RandomGeneratorScope
+{
+    public:
+        explicit RandomGeneratorScope(RandomEngine* generator);
+        ~RandomGeneratorScope();
+
+        RandomGeneratorScope(RandomGeneratorScope const&) = delete;
+        RandomGeneratorScope& operator=(RandomGeneratorScope const&) = delete;
+
+    private:
+        RandomEngine* m_previous;
+        bool m_active;
+};
+
+/* Fill the array with random numbers in the range 0 .. RAND32_MAX, for batches of rolls. */
+void rand_fill(uint32* values, size_t count);
 
 /* Return a random number in the range min..max; (max-min) must be smaller than 32768. */
 int32 irand(int32 min, int32 max);
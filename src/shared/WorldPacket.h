@@ -23,26 +23,45 @@
 #include "ByteBuffer.h"
 #include "Server/Opcodes.h"
 
+#include <memory>
+
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
 class WorldPacket : public ByteBuffer
 {
     public:
         // just container for later use
-        WorldPacket()                                       : ByteBuffer(0), m_opcode(MSG_NULL_ACTION)
+        WorldPacket()                                       : ByteBuffer(0), m_opcode(MSG_NULL_ACTION), m_prepared(false)
         {
         }
-        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode) { }
+        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(GetReserveSize(opcode, res)), m_opcode(opcode), m_prepared(false) { }
         // copy constructor
-        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
+        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_prepared(packet.m_prepared)
+        {
+        }
+
+        ~WorldPacket()
         {
+            // quick to grow up to big packets, slow to forget them so that they are rarely reallocated
+            if (size_t size = wpos())
+            {
+                std::atomic<uint16>& hint = opcodeSizeHints[m_opcode];
+                uint16 const current = hint.load(std::memory_order_relaxed);
+                size = std::min<size_t>(size, 0xFFFF);
+                if (size > current)
+                    hint.store(uint16(size), std::memory_order_relaxed);
+                else if (size < current)
+                    hint.store(uint16(current - (current - size + 15) / 16), std::memory_order_relaxed);
+            }
         }
 
         void Initialize(Opcodes opcode, size_t newres = 200)
         {
             clear();
-            _storage.reserve(newres);
+            _storage.reserve(GetReserveSize(opcode, newres));
             m_opcode = opcode;
+            m_receivedTime = std::chrono::steady_clock::time_point();
+            m_prepared = false;
         }
 
         Opcodes GetOpcode() const { return m_opcode; }
@@ -52,8 +71,38 @@ class WorldPacket : public ByteBuffer
         std::chrono::steady_clock::time_point GetReceivedTime() const { return m_receivedTime; }
         void SetReceivedTime(std::chrono::steady_clock::time_point receivedTime) { m_receivedTime = receivedTime; }
 
+        // the network thread already made the checks of the received packet that need nothing of the world
+        bool IsPrepared() const { return m_prepared; }
+        void SetPrepared() { m_prepared = true; }
+
     protected:
+        static size_t GetReserveSize(Opcodes opcode, size_t res) { return std::max<size_t>(res, opcodeSizeHints[opcode].load(std::memory_order_relaxed)); }
+
         Opcodes m_opcode;
         std::chrono::steady_clock::time_point m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
+        bool m_prepared;
+};
+
+// packet sent unchanged to many sessions. the first send takes a single copy of it, then every socket
+// queues a reference to that copy and only its header is built and encrypted per socket
+class SharedWorldPacket
+{
+    public:
+        explicit SharedWorldPacket(WorldPacket const& packet) : m_packet(packet) {}
+        // for packets kept shared between sends, like cached responses
+        explicit SharedWorldPacket(std::shared_ptr<WorldPacket const> const& packet) : m_packet(*packet), m_shared(packet) {}
+        SharedWorldPacket(SharedWorldPacket const&) = delete;
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+        std::shared_ptr<WorldPacket const> const& Get() const
+        {
+            if (!m_shared)
+                m_shared = std::make_shared<WorldPacket const>(m_packet);
+            return m_shared;
+        }
+
+    private:
+        WorldPacket const& m_packet;
+        mutable std::shared_ptr<WorldPacket const> m_shared;
 };
 #endif
@@ -1,6 +1,6 @@
 #ifndef __REVISION_SQL_H__
 #define __REVISION_SQL_H__
  #define REVISION_DB_REALMD "required_14028_01_realmd_account_locale_agnostic"
- #define REVISION_DB_CHARACTERS "required_14030_01_characters_item_instance_duration_default"
- #define REVISION_DB_MANGOS "required_14034_01_mangos_column_fix"
+ #define REVISION_DB_CHARACTERS "required_14035_01_characters_calendar_archive"
+ #define REVISION_DB_MANGOS "required_14036_01_mangos_pdump_command"
 #endif // __REVISION_SQL_H__